@@ -43,6 +43,12 @@ METRIC_DEFINE_histogram(cdc, rpc_payload_bytes_responded, "CDC Bytes Responded",
 METRIC_DEFINE_counter(cdc, rpc_heartbeats_responded, "CDC Rpc Heartbeat Count",
   yb::MetricUnit::kRequests,
   "Number of responses to CDC GetChanges requests without a record payload.");
+METRIC_DEFINE_counter(cdc, records_cache_hits, "CDC Records Cache Hits",
+  yb::MetricUnit::kRequests,
+  "Number of CDC GetChanges requests whose records were already decoded for the tablet.");
+METRIC_DEFINE_counter(cdc, records_cache_misses, "CDC Records Cache Misses",
+  yb::MetricUnit::kRequests,
+  "Number of CDC GetChanges requests with records that had to be decoded from the log.");
 METRIC_DEFINE_gauge_int64(cdc, last_read_opid_term, "CDC Last Read OpId (Term)",
   yb::MetricUnit::kOperations,
   "ID of the Last Read Producer Operation from a CDC GetChanges request. Format = term.index");
@@ -62,6 +68,18 @@ METRIC_DEFINE_gauge_int64(cdc, last_readable_opid_index, "CDC Last Readable OpId
   yb::MetricUnit::kOperations,
   "Index of the Last Producer Operation that a CDC GetChanges request COULD read.");
 
+// CDC Consumer Stream Metrics.
+METRIC_DEFINE_counter(cdc_consumer_stream, apply_records, "CDC Applied Records",
+  yb::MetricUnit::kEntries,
+  "Number of records of the stream applied by the CDC Consumer.");
+METRIC_DEFINE_counter(cdc_consumer_stream, apply_write_rpcs, "CDC Apply Write Rpcs",
+  yb::MetricUnit::kRequests,
+  "Number of write requests that the CDC Consumer applied the records of the stream with.");
+METRIC_DEFINE_gauge_int64(cdc_consumer_stream, apply_lag_micros, "CDC Apply Lag",
+  yb::MetricUnit::kMicroseconds,
+  "Time between writing the last applied record of the stream on the producer and applying it "
+  "on the CDC Consumer.");
+
 // CDC Server Metrics
 METRIC_DEFINE_counter(server, cdc_rpc_proxy_count, "CDC Rpc Proxy Count", yb::MetricUnit::kRequests,
   "Number of CDC GetChanges requests that required proxy forwarding");
@@ -74,6 +92,8 @@ namespace cdc {
 CDCTabletMetrics::CDCTabletMetrics(const scoped_refptr<MetricEntity>& entity)
     : MINIT(rpc_payload_bytes_responded),
       MINIT(rpc_heartbeats_responded),
+      MINIT(records_cache_hits),
+      MINIT(records_cache_misses),
       GINIT(last_read_opid_term),
       GINIT(last_read_opid_index),
       GINIT(last_checkpoint_opid_index),
@@ -82,6 +102,12 @@ CDCTabletMetrics::CDCTabletMetrics(const scoped_refptr<MetricEntity>& entity)
       GINIT(last_readable_opid_index),
       entity_(entity) {}
 
+CDCConsumerStreamMetrics::CDCConsumerStreamMetrics(const scoped_refptr<MetricEntity>& entity)
+    : MINIT(apply_records),
+      MINIT(apply_write_rpcs),
+      GINIT(apply_lag_micros),
+      entity_(entity) {}
+
 CDCServerMetrics::CDCServerMetrics(const scoped_refptr<MetricEntity>& entity)
     : MINIT(cdc_rpc_proxy_count),
       entity_(entity) { }
@@ -58,6 +58,11 @@ class CDCTabletMetrics {
   scoped_refptr<Counter> rpc_heartbeats_responded;
   // For rpc_latency & rpcs_responded_count, use 'handler_latency_yb_cdc_CDCService_GetChanges'.
 
+  // Requests that read operations, by whether their records were found in the records cache of
+  // the tablet.
+  scoped_refptr<Counter> records_cache_hits;
+  scoped_refptr<Counter> records_cache_misses;
+
   // Info about ID last read by CDC Consumer.
   scoped_refptr<AtomicGauge<int64_t> > last_read_opid_term;
   scoped_refptr<AtomicGauge<int64_t> > last_read_opid_index;
@@ -73,6 +78,20 @@ class CDCTabletMetrics {
   scoped_refptr<MetricEntity> entity_;
 };
 
+// Metrics of applying the changes of a stream on the CDC Consumer.
+class CDCConsumerStreamMetrics {
+ public:
+  explicit CDCConsumerStreamMetrics(const scoped_refptr<MetricEntity>& metric_entity_stream);
+
+  scoped_refptr<Counter> apply_records;
+  scoped_refptr<Counter> apply_write_rpcs;
+  // Time since the last applied record was written on the producer when it is applied.
+  scoped_refptr<AtomicGauge<int64_t> > apply_lag_micros;
+
+ private:
+  scoped_refptr<MetricEntity> entity_;
+};
+
 class CDCServerMetrics {
  public:
   explicit CDCServerMetrics(const scoped_refptr<MetricEntity>& metric_entity_server);
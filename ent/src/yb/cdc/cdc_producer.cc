@@ -12,7 +12,16 @@
 
 #include "yb/cdc/cdc_producer.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include <boost/optional/optional.hpp>
+
+#include <gflags/gflags.h>
+
 #include "yb/cdc/cdc_service.pb.h"
+#include "yb/common/ql_value.h"
 #include "yb/common/transaction.h"
 #include "yb/common/wire_protocol.h"
 
@@ -27,6 +36,23 @@
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/background_io_limiter.h"
+#include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(cdc_records_cache_max_batches, 8,
+             "Maximum number of batches of decoded CDC records that are cached per tablet, to be "
+             "shared by the streams of the tablet and the retries of their consumers. 0 to not "
+             "cache them.");
+TAG_FLAG(cdc_records_cache_max_batches, advanced);
+TAG_FLAG(cdc_records_cache_max_batches, runtime);
+
+DEFINE_int32(cdc_txn_status_cache_max_entries, 10000,
+             "Maximum number of resolved transaction statuses that are cached per CDC stream of a "
+             "tablet, so the transactions that span several GetChanges batches are not looked up "
+             "again on every poll. 0 to not cache them.");
+TAG_FLAG(cdc_txn_status_cache_max_entries, advanced);
+TAG_FLAG(cdc_txn_status_cache_max_entries, runtime);
 
 namespace yb {
 namespace cdc {
@@ -45,6 +71,53 @@ typedef boost::unordered_map<
     TransactionId, TransactionStatusResult, TransactionIdHash> TxnStatusMap;
 typedef std::pair<uint64_t, size_t> RecordTimeIndex;
 
+// Final statuses of the transactions that were looked up for the writes read by a stream. A
+// transaction is forgotten once the stream checkpoint is past its last write that was read, since
+// the writes before the checkpoint are not read again.
+class TxnStatusCache {
+ public:
+  // Returns the cached status of the transaction, written at op_index again.
+  boost::optional<TransactionStatusResult> Find(const TransactionId& txn_id, int64_t op_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(txn_id);
+    if (it == entries_.end()) {
+      return boost::none;
+    }
+    it->second.last_op_index = std::max(it->second.last_op_index, op_index);
+    return it->second.status;
+  }
+
+  void Insert(const TransactionId& txn_id, const TransactionStatusResult& status,
+              int64_t op_index) {
+    const auto max_entries = static_cast<size_t>(
+        std::max(FLAGS_cdc_txn_status_cache_max_entries, 0));
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() < max_entries) {
+      entries_.emplace(txn_id, Entry{status, op_index});
+    }
+  }
+
+  void Evict(int64_t checkpoint_index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      if (it->second.last_op_index <= checkpoint_index) {
+        it = entries_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+ private:
+  struct Entry {
+    TransactionStatusResult status;
+    int64_t last_op_index;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<TransactionId, Entry, TransactionIdHash> entries_ GUARDED_BY(mutex_);
+};
+
 void AddColumnToMap(const ColumnSchema& col_schema,
                     const docdb::PrimitiveValue& col,
                     cdc::KeyValuePairPB* kv_pair) {
@@ -201,10 +274,13 @@ Result<TransactionStatusResult> GetTransactionStatus(
 }
 
 // Build transaction status as of hybrid_time.
+// The statuses of committed and aborted transactions are taken from txn_status_cache, if
+// specified, and the ones looked up are added to it.
 Result<TxnStatusMap> BuildTxnStatusMap(const ReplicateMsgs& messages,
                                        bool more_replicate_msgs,
                                        const HybridTime& hybrid_time,
-                                       TransactionParticipant* txn_participant) {
+                                       TransactionParticipant* txn_participant,
+                                       TxnStatusCache* txn_status_cache) {
   TxnStatusMap txn_map;
   // First go through all APPLYING records and mark transaction as committed.
   for (const auto& msg : messages) {
@@ -228,6 +304,15 @@ Result<TxnStatusMap> BuildTxnStatusMap(const ReplicateMsgs& messages,
           msg->write_request().write_batch().transaction().transaction_id()));
 
       if (!txn_map.count(txn_id)) {
+        const auto op_index = msg->id().index();
+        if (txn_status_cache) {
+          auto cached_status = txn_status_cache->Find(txn_id, op_index);
+          if (cached_status) {
+            txn_map.emplace(txn_id, *cached_status);
+            continue;
+          }
+        }
+
         TransactionStatusResult txn_status(TransactionStatus::PENDING, HybridTime::kMin);
 
         auto result = GetTransactionStatus(txn_id, hybrid_time, txn_participant);
@@ -248,6 +333,13 @@ Result<TxnStatusMap> BuildTxnStatusMap(const ReplicateMsgs& messages,
           }
         } else {
           txn_status = *result;
+          // Pending transactions are looked up again, and the transactions that were not found
+          // could be committed in the messages that were not read yet, so only the statuses that
+          // the participant resolved as final are cached.
+          if (txn_status_cache && (txn_status.status == TransactionStatus::COMMITTED ||
+                                   txn_status.status == TransactionStatus::ABORTED)) {
+            txn_status_cache->Insert(txn_id, txn_status, op_index);
+          }
         }
         txn_map.emplace(txn_id, txn_status);
       }
@@ -348,6 +440,39 @@ CHECKED_STATUS PopulateWriteRecord(const ReplicateMsgPtr& msg,
   return Status::OK();
 }
 
+// Records of aborted transactions are skipped, but a transaction could have been only considered
+// aborted because it was not found, so such records are not cached.
+bool HasAbortedTransactions(const TxnStatusMap& txn_map) {
+  for (const auto& entry : txn_map) {
+    if (entry.second.status == TransactionStatus::ABORTED) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::shared_ptr<CDCRecordsCache> GetRecordsCache(tablet::Tablet* tablet) {
+  static const std::string kKey = "CDCRecordsCache";
+  auto cache = tablet->GetAdditionalMetadata(kKey);
+  if (!cache) {
+    tablet->AddAdditionalMetadata(kKey, std::make_shared<CDCRecordsCache>());
+    // Another stream could have added the cache concurrently, so the one that was added is used.
+    cache = tablet->GetAdditionalMetadata(kKey);
+  }
+  return std::static_pointer_cast<CDCRecordsCache>(cache);
+}
+
+std::shared_ptr<TxnStatusCache> GetTxnStatusCache(
+    tablet::Tablet* tablet, const std::string& stream_id) {
+  const std::string key = "CDCTxnStatusCache::" + stream_id;
+  auto cache = tablet->GetAdditionalMetadata(key);
+  if (!cache) {
+    tablet->AddAdditionalMetadata(key, std::make_shared<TxnStatusCache>());
+    cache = tablet->GetAdditionalMetadata(key);
+  }
+  return std::static_pointer_cast<TxnStatusCache>(cache);
+}
+
 // Populate CDC record corresponding to WAL UPDATE_TRANSACTION_OP entry.
 CHECKED_STATUS PopulateTransactionRecord(const ReplicateMsgPtr& msg,
                                          CDCRecordPB* record) {
@@ -360,6 +485,32 @@ CHECKED_STATUS PopulateTransactionRecord(const ReplicateMsgPtr& msg,
 
 } // namespace
 
+CDCRecordsCache::BatchPtr CDCRecordsCache::Find(
+    const OpId& first_op_id, const OpId& last_op_id, CDCRecordFormat record_format,
+    uint32_t schema_version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = batches_.begin(); it != batches_.end(); ++it) {
+    const auto& batch = **it;
+    if (batch.first_op_id == first_op_id && batch.last_op_id == last_op_id &&
+        batch.record_format == record_format && batch.schema_version == schema_version) {
+      auto result = *it;
+      batches_.erase(it);
+      batches_.push_back(result);
+      return result;
+    }
+  }
+  return nullptr;
+}
+
+void CDCRecordsCache::Insert(BatchPtr batch) {
+  const auto max_batches = static_cast<size_t>(std::max(FLAGS_cdc_records_cache_max_batches, 0));
+  std::lock_guard<std::mutex> lock(mutex_);
+  batches_.push_back(std::move(batch));
+  while (batches_.size() > max_batches) {
+    batches_.pop_front();
+  }
+}
+
 Status GetChanges(const std::string& stream_id,
                   const std::string& tablet_id,
                   const OpId& from_op_id,
@@ -368,7 +519,8 @@ Status GetChanges(const std::string& stream_id,
                   const MemTrackerPtr& mem_tracker,
                   consensus::ReplicateMsgsHolder* msgs_holder,
                   GetChangesResponsePB* resp,
-                  int64_t* last_readable_opid_index) {
+                  int64_t* last_readable_opid_index,
+                  bool* records_cache_hit) {
   // Request scope on transaction participant so that transactions are not removed from participant
   // while RequestScope is active.
   RequestScope request_scope;
@@ -379,31 +531,76 @@ Status GetChanges(const std::string& stream_id,
 
   auto read_ops = VERIFY_RESULT(tablet_peer->consensus()->
     ReadReplicatedMessagesForCDC(from_op_id, last_readable_opid_index));
+  // Catching up from the log on disk competes with the foreground reads.
+  BackgroundIoLimiter::Default().Request(BackgroundIoClass::kCdc, read_ops.read_from_disk_size);
   ScopedTrackedConsumption consumption;
   if (read_ops.read_from_disk_size && mem_tracker) {
     consumption = ScopedTrackedConsumption(mem_tracker, read_ops.read_from_disk_size);
   }
 
-  TxnStatusMap txn_map = VERIFY_RESULT(BuildTxnStatusMap(
-      read_ops.messages, read_ops.have_more_messages, tablet_peer->Now(), txn_participant));
+  // The batches read from the log cache are shared by the streams of the tablet, so the records
+  // decoded from them are cached and shared as well.
+  std::shared_ptr<CDCRecordsCache> records_cache;
+  OpId first_op_id;
+  OpId last_op_id;
+  const auto schema_version = tablet_peer->tablet()->metadata()->schema_version();
+  CDCRecordsCache::BatchPtr cached_batch;
+  if (FLAGS_cdc_records_cache_max_batches > 0 && !read_ops.messages.empty()) {
+    records_cache = GetRecordsCache(tablet_peer->tablet());
+    first_op_id = OpId::FromPB(read_ops.messages.front()->id());
+    last_op_id = OpId::FromPB(read_ops.messages.back()->id());
+    cached_batch = records_cache->Find(
+        first_op_id, last_op_id, stream_metadata.record_format, schema_version);
+  }
+  if (records_cache_hit) {
+    *records_cache_hit = cached_batch != nullptr;
+  }
 
   OpId checkpoint;
-  auto ordered_messages = VERIFY_RESULT(SortWrites(read_ops.messages, txn_map, &checkpoint));
-
-  for (const auto& msg : ordered_messages) {
-    switch (msg->op_type()) {
-      case consensus::OperationType::UPDATE_TRANSACTION_OP:
-        RETURN_NOT_OK(PopulateTransactionRecord(msg, resp->add_records()));
-        break;
-
-      case consensus::OperationType::WRITE_OP:
-        RETURN_NOT_OK(PopulateWriteRecord(msg, txn_map, stream_metadata,
-                                          *tablet_peer->tablet()->schema(), resp));
-        break;
-
-      default:
-        // Nothing to do for other operation types.
-        break;
+  ReplicateMsgs ordered_messages;
+  if (cached_batch) {
+    *resp->mutable_records() = cached_batch->records;
+    checkpoint = last_op_id;
+    ordered_messages = std::move(read_ops.messages);
+  } else {
+    std::shared_ptr<TxnStatusCache> txn_status_cache;
+    if (txn_participant && FLAGS_cdc_txn_status_cache_max_entries > 0) {
+      txn_status_cache = GetTxnStatusCache(tablet_peer->tablet(), stream_id);
+      // The writes up to the checkpoint that the consumer sent are not read again.
+      txn_status_cache->Evict(from_op_id.index);
+    }
+    TxnStatusMap txn_map = VERIFY_RESULT(BuildTxnStatusMap(
+        read_ops.messages, read_ops.have_more_messages, tablet_peer->Now(), txn_participant,
+        txn_status_cache.get()));
+
+    ordered_messages = VERIFY_RESULT(SortWrites(read_ops.messages, txn_map, &checkpoint));
+
+    for (const auto& msg : ordered_messages) {
+      switch (msg->op_type()) {
+        case consensus::OperationType::UPDATE_TRANSACTION_OP:
+          RETURN_NOT_OK(PopulateTransactionRecord(msg, resp->add_records()));
+          break;
+
+        case consensus::OperationType::WRITE_OP:
+          RETURN_NOT_OK(PopulateWriteRecord(msg, txn_map, stream_metadata,
+                                            *tablet_peer->tablet()->schema(), resp));
+          break;
+
+        default:
+          // Nothing to do for other operation types.
+          break;
+      }
+    }
+
+    // The records are final only when no operations were held back by pending transactions.
+    if (records_cache && checkpoint == last_op_id && !HasAbortedTransactions(txn_map)) {
+      auto batch = std::make_shared<CDCRecordsCache::Batch>();
+      batch->first_op_id = first_op_id;
+      batch->last_op_id = last_op_id;
+      batch->record_format = stream_metadata.record_format;
+      batch->schema_version = schema_version;
+      batch->records = resp->records();
+      records_cache->Insert(std::move(batch));
     }
   }
 
@@ -417,5 +614,99 @@ Status GetChanges(const std::string& stream_id,
   return Status::OK();
 }
 
+namespace {
+
+void SetBit(size_t index, std::string* bitmap) {
+  (*bitmap)[index / 8] |= 1 << (index % 8);
+}
+
+class ColumnarRecordsEncoder {
+ public:
+  ColumnarRecordsEncoder(const Schema& schema, size_t num_records, CDCColumnarRecordsPB* out)
+      : schema_(schema), bitmap_size_((num_records + 7) / 8), out_(out) {
+    out_->mutable_has_transaction_state()->assign(bitmap_size_, 0);
+  }
+
+  CHECKED_STATUS Add(size_t index, const CDCRecordPB& record) {
+    out_->add_time(record.time());
+    out_->add_operation(record.operation());
+    if (record.has_transaction_state()) {
+      SetBit(index, out_->mutable_has_transaction_state());
+      *out_->add_transaction_states() = record.transaction_state();
+    }
+    for (const auto& kv_pair : record.key()) {
+      RETURN_NOT_OK(AddValue(index, kv_pair, /* is_key= */ true));
+    }
+    for (const auto& kv_pair : record.changes()) {
+      RETURN_NOT_OK(AddValue(index, kv_pair, /* is_key= */ false));
+    }
+    return Status::OK();
+  }
+
+  void Finish() {
+    for (auto& column : columns_) {
+      column.pb->set_values(column.values.data(), column.values.size());
+    }
+  }
+
+ private:
+  struct Column {
+    std::shared_ptr<QLType> type;
+    CDCColumnarRecordsPB::ColumnPB* pb;
+    faststring values;
+  };
+
+  CHECKED_STATUS AddValue(size_t index, const KeyValuePairPB& kv_pair, bool is_key) {
+    auto& columns_by_name = is_key ? key_columns_ : changed_columns_;
+    auto it = columns_by_name.find(kv_pair.key());
+    if (it == columns_by_name.end()) {
+      const auto column_idx = schema_.find_column(kv_pair.key());
+      if (column_idx == Schema::kColumnNotFound) {
+        return STATUS_FORMAT(IllegalState, "Column $0 of CDC record not found", kv_pair.key());
+      }
+      // Columns are not movable because of the values buffer, so they are kept in a deque.
+      columns_.emplace_back();
+      columns_.back().type = schema_.column(column_idx).type();
+      columns_.back().pb = out_->add_columns();
+      auto& pb = *columns_.back().pb;
+      pb.set_name(kv_pair.key());
+      pb.set_is_key(is_key);
+      pb.mutable_present()->assign(bitmap_size_, 0);
+      pb.mutable_nulls()->assign(bitmap_size_, 0);
+      it = columns_by_name.emplace(kv_pair.key(), columns_.size() - 1).first;
+    }
+    auto& column = columns_[it->second];
+    SetBit(index, column.pb->mutable_present());
+    if (IsNull(kv_pair.value())) {
+      SetBit(index, column.pb->mutable_nulls());
+    } else {
+      QLValue::Serialize(column.type, YQL_CLIENT_CQL, kv_pair.value(), &column.values);
+    }
+    return Status::OK();
+  }
+
+  const Schema& schema_;
+  const size_t bitmap_size_;
+  CDCColumnarRecordsPB* const out_;
+  std::deque<Column> columns_;
+  std::unordered_map<std::string, size_t> key_columns_;
+  std::unordered_map<std::string, size_t> changed_columns_;
+};
+
+} // namespace
+
+Status EncodeColumnarRecords(const Schema& schema, uint32_t schema_version,
+                             GetChangesResponsePB* resp) {
+  auto& columnar_records = *resp->mutable_columnar_records();
+  columnar_records.set_schema_version(schema_version);
+  ColumnarRecordsEncoder encoder(schema, resp->records_size(), &columnar_records);
+  for (int i = 0; i != resp->records_size(); ++i) {
+    RETURN_NOT_OK(encoder.Add(i, resp->records(i)));
+  }
+  encoder.Finish();
+  resp->clear_records();
+  return Status::OK();
+}
+
 }  // namespace cdc
 }  // namespace yb
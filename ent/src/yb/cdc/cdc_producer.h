@@ -13,7 +13,9 @@
 #ifndef ENT_SRC_YB_CDC_CDC_PRODUCER_H
 #define ENT_SRC_YB_CDC_CDC_PRODUCER_H
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include <boost/functional/hash.hpp>
@@ -25,6 +27,7 @@
 #include "yb/consensus/consensus_fwd.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/docdb/docdb.pb.h"
+#include "yb/gutil/thread_annotations.h"
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/util/opid.h"
 
@@ -43,6 +46,34 @@ struct StreamMetadata {
   }
 };
 
+// Decoded CDC records of the batches of operations of a tablet that were read recently, so that
+// the streams of the tablet, and the retries of their consumers, share the decoding of a batch.
+// Only batches whose records are final are cached, i.e. that have no pending transactions.
+class CDCRecordsCache {
+ public:
+  struct Batch {
+    OpId first_op_id;
+    OpId last_op_id;
+    CDCRecordFormat record_format;
+    uint32_t schema_version;
+    google::protobuf::RepeatedPtrField<CDCRecordPB> records;
+  };
+  typedef std::shared_ptr<const Batch> BatchPtr;
+
+  // Returns the records of the operations from first_op_id to last_op_id, or nullptr if they are
+  // not cached.
+  BatchPtr Find(const OpId& first_op_id, const OpId& last_op_id, CDCRecordFormat record_format,
+                uint32_t schema_version);
+
+  // Caches the batch, evicting the least recently used batch over cdc_records_cache_max_batches.
+  void Insert(BatchPtr batch);
+
+ private:
+  std::mutex mutex_;
+  // Least recently used batch first.
+  std::deque<BatchPtr> batches_ GUARDED_BY(mutex_);
+};
+
 CHECKED_STATUS GetChanges(const std::string& stream_id,
                           const std::string& tablet_id,
                           const OpId& op_id,
@@ -51,7 +82,13 @@ CHECKED_STATUS GetChanges(const std::string& stream_id,
                           const std::shared_ptr<MemTracker>& mem_tracker,
                           consensus::ReplicateMsgsHolder* msgs_holder,
                           GetChangesResponsePB* resp,
-                          int64_t* last_readable_opid_index = nullptr);
+                          int64_t* last_readable_opid_index = nullptr,
+                          bool* records_cache_hit = nullptr);
+
+// Moves the records of the response to its columnar_records, with the columns of the records
+// looked up in schema.
+CHECKED_STATUS EncodeColumnarRecords(const Schema& schema, uint32_t schema_version,
+                                     GetChangesResponsePB* resp);
 
 }  // namespace cdc
 }  // namespace yb
@@ -12,6 +12,8 @@
 
 #include "yb/cdc/cdc_service.h"
 
+#include <algorithm>
+#include <iterator>
 #include <shared_mutex>
 #include <chrono>
 #include <memory>
@@ -75,6 +77,12 @@ DEFINE_int32(update_min_cdc_indices_interval_secs, 60,
              "replicated index across all streams is sent to the other peers in the configuration. "
              "If flag enable_log_retention_by_op_idx is disabled, this flag has no effect.");
 
+DEFINE_int32(cdc_max_wait_for_changes_ms, 5000,
+             "Maximum time to hold a GetChanges request that asks to wait for new changes when "
+             "there are none. 0 to always respond right away.");
+TAG_FLAG(cdc_max_wait_for_changes_ms, advanced);
+TAG_FLAG(cdc_max_wait_for_changes_ms, runtime);
+
 DECLARE_bool(enable_log_retention_by_op_idx);
 
 DECLARE_int32(cdc_checkpoint_opid_interval_ms);
@@ -110,9 +118,13 @@ CDCServiceImpl::CDCServiceImpl(TSTabletManager* tablet_manager,
 
   get_minimum_checkpoints_and_update_peers_thread_.reset(new std::thread(
       &CDCServiceImpl::ReadCdcMinReplicatedIndexForAllTabletsAndUpdatePeers, this));
+
+  CHECK_OK(ThreadPoolBuilder("cdc_changes_waiters").Build(&changes_waiters_pool_));
+  changes_waiters_thread_.reset(new std::thread(&CDCServiceImpl::RunChangesWaiters, this));
 }
 
 CDCServiceImpl::~CDCServiceImpl() {
+  StopChangesWaiters();
   if (get_minimum_checkpoints_and_update_peers_thread_) {
     cdc_service_stopped_.store(true, std::memory_order_release);
     get_minimum_checkpoints_and_update_peers_thread_->join();
@@ -316,27 +328,54 @@ void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
   s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
 
   // If we we can't serve this tablet...
-  if (s.IsNotFound() || tablet_peer->LeaderStatus() != consensus::LeaderStatus::LEADER_AND_READY) {
-    if (req->serve_as_proxy()) {
-      // Forward GetChanges() to tablet leader. This commonly happens in Kubernetes setups.
-      auto context_ptr = std::make_shared<RpcContext>(std::move(context));
-      TabletLeaderGetChanges(req, resp, context_ptr, tablet_peer);
-    // Otherwise, figure out the proper return code.
-    } else if (s.IsNotFound()) {
-      SetupErrorAndRespond(resp->mutable_error(), s, CDCErrorPB::TABLET_NOT_FOUND, &context);
-    } else if (tablet_peer->LeaderStatus() == consensus::LeaderStatus::NOT_LEADER) {
-      // TODO: we may be able to get some changes, even if we're not the leader.
-      SetupErrorAndRespond(resp->mutable_error(),
-          STATUS(NotFound, Format("Not leader for $0", req->tablet_id())),
-          CDCErrorPB::TABLET_NOT_FOUND, &context);
-    } else {
-      SetupErrorAndRespond(resp->mutable_error(),
-          STATUS(LeaderNotReadyToServe, "Not ready to serve"),
-          CDCErrorPB::LEADER_NOT_READY, &context);
-    }
+  if (req->serve_as_proxy() &&
+      (s.IsNotFound() ||
+       tablet_peer->LeaderStatus() != consensus::LeaderStatus::LEADER_AND_READY)) {
+    // Forward GetChanges() to tablet leader. This commonly happens in Kubernetes setups.
+    auto context_ptr = std::make_shared<RpcContext>(std::move(context));
+    TabletLeaderGetChanges(req, resp, context_ptr, tablet_peer);
+    return;
+  }
+
+  const auto wait_deadline = GetChangesWaitDeadline(*req, context);
+  DoGetChanges(req, resp, std::make_shared<RpcContext>(std::move(context)), wait_deadline);
+}
+
+void CDCServiceImpl::DoGetChanges(const GetChangesRequestPB* req,
+                                  GetChangesResponsePB* resp,
+                                  std::shared_ptr<RpcContext> context_ptr,
+                                  CoarseTimePoint wait_deadline) {
+  auto& context = *context_ptr;
+  ProducerTabletInfo producer_tablet = {"" /* UUID */, req->stream_id(), req->tablet_id()};
+
+  std::shared_ptr<tablet::TabletPeer> tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+
+  // If we we can't serve this tablet, figure out the proper return code.
+  if (s.IsNotFound()) {
+    SetupErrorAndRespond(resp->mutable_error(), s, CDCErrorPB::TABLET_NOT_FOUND, &context);
+    return;
+  }
+  const auto leader_status = tablet_peer->LeaderStatus();
+  if (leader_status == consensus::LeaderStatus::NOT_LEADER) {
+    // TODO: we may be able to get some changes, even if we're not the leader.
+    SetupErrorAndRespond(resp->mutable_error(),
+        STATUS(NotFound, Format("Not leader for $0", req->tablet_id())),
+        CDCErrorPB::TABLET_NOT_FOUND, &context);
+    return;
+  }
+  if (leader_status != consensus::LeaderStatus::LEADER_AND_READY) {
+    SetupErrorAndRespond(resp->mutable_error(),
+        STATUS(LeaderNotReadyToServe, "Not ready to serve"),
+        CDCErrorPB::LEADER_NOT_READY, &context);
     return;
   }
 
+  // The listener is installed before reading the changes, so the operations replicated after
+  // the read are noticed by the notifications number.
+  const bool may_wait = CoarseMonoClock::Now() < wait_deadline;
+  const uint64_t notifications = may_wait ? ListenChanges(tablet_peer) : 0;
+
   auto session = async_client_init_->client()->NewSession();
   OpId op_id;
 
@@ -354,19 +393,28 @@ void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
                              CDCErrorPB::INTERNAL_ERROR, context);
 
   int64_t last_readable_index;
+  bool records_cache_hit = false;
   consensus::ReplicateMsgsHolder msgs_holder;
   MemTrackerPtr mem_tracker = GetMemTracker(tablet_peer, producer_tablet);
   s = cdc::GetChanges(
       req->stream_id(), req->tablet_id(), op_id, *record->get(), tablet_peer, mem_tracker,
-      &msgs_holder, resp, &last_readable_index);
+      &msgs_holder, resp, &last_readable_index, &records_cache_hit);
   RPC_STATUS_RETURN_ERROR(
       s,
       resp->mutable_error(),
       s.IsNotFound() ? CDCErrorPB::CHECKPOINT_TOO_OLD : CDCErrorPB::UNKNOWN_ERROR,
       context);
 
-  uint64_t last_record_hybrid_time = resp->records_size() > 0 ?
-      resp->records(resp->records_size() - 1).time() : 0;
+  // Nothing was read, hold the request until new changes are replicated.
+  if (may_wait && resp->records_size() == 0 &&
+      OpId::FromPB(resp->checkpoint().op_id()) == op_id &&
+      AddChangesWaiter(req, resp, context_ptr, wait_deadline, notifications)) {
+    return;
+  }
+
+  const int num_records = resp->records_size();
+  uint64_t last_record_hybrid_time = num_records > 0 ?
+      resp->records(num_records - 1).time() : 0;
 
   s = UpdateCheckpoint(producer_tablet, OpId::FromPB(resp->checkpoint().op_id()), op_id, session,
                        last_record_hybrid_time);
@@ -384,6 +432,16 @@ void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
     shared_consensus->UpdateCDCConsumerOpId(GetMinSentCheckpointForTablet(req->tablet_id()));
   }
 
+  if (req->columnar_records()) {
+    RPC_CHECK_AND_RETURN_ERROR(
+        record->get()->record_format != CDCRecordFormat::WAL,
+        STATUS(InvalidArgument, "Columnar records are not supported for WAL format streams"),
+        resp->mutable_error(), CDCErrorPB::INVALID_REQUEST, context);
+    const auto& tablet = *tablet_peer->tablet();
+    s = EncodeColumnarRecords(*tablet.schema(), tablet.metadata()->schema_version(), resp);
+    RPC_STATUS_RETURN_ERROR(s, resp->mutable_error(), CDCErrorPB::INTERNAL_ERROR, context);
+  }
+
   // Update relevant GetChanges metrics before handing off the Response.
   auto tablet_metric = GetCDCTabletMetrics(producer_tablet, tablet_peer);
   if (tablet_metric) {
@@ -392,11 +450,15 @@ void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
     tablet_metric->last_read_opid_index->set_value(lid.index());
     tablet_metric->last_readable_opid_index->set_value(last_readable_index);
     tablet_metric->last_checkpoint_opid_index->set_value(op_id.index);
-    if (resp->records_size() > 0) {
-      auto& last_record = resp->records(resp->records_size()-1);
-      tablet_metric->last_read_hybridtime->set_value(last_record.time());
+    if (records_cache_hit) {
+      tablet_metric->records_cache_hits->Increment();
+    } else if (num_records > 0) {
+      tablet_metric->records_cache_misses->Increment();
+    }
+    if (num_records > 0) {
+      tablet_metric->last_read_hybridtime->set_value(last_record_hybrid_time);
       tablet_metric->last_read_physicaltime->set_value(
-          HybridTime(last_record.time()).GetPhysicalValueMicros());
+          HybridTime(last_record_hybrid_time).GetPhysicalValueMicros());
       // Only count bytes responded if we are including a response payload.
       tablet_metric->rpc_payload_bytes_responded->Increment(resp->ByteSize());
     } else {
@@ -407,6 +469,179 @@ void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
   context.RespondSuccess();
 }
 
+CoarseTimePoint CDCServiceImpl::GetChangesWaitDeadline(const GetChangesRequestPB& req,
+                                                       const RpcContext& context) {
+  const int64_t wait_ms = std::min<int64_t>(
+      req.wait_for_changes_ms(), FLAGS_cdc_max_wait_for_changes_ms);
+  if (wait_ms <= 0) {
+    return CoarseTimePoint::min();
+  }
+  const auto now = CoarseMonoClock::Now();
+  auto result = now + wait_ms * 1ms;
+  // Leave the client at least half of its remaining time to get the changes read after waiting.
+  const auto client_deadline = context.GetClientDeadline();
+  if (client_deadline != CoarseTimePoint::max()) {
+    result = std::min(result, now + (client_deadline - now) / 2);
+  }
+  return result;
+}
+
+uint64_t CDCServiceImpl::ListenChanges(const std::shared_ptr<tablet::TabletPeer>& tablet_peer) {
+  const auto& tablet_id = tablet_peer->tablet_id();
+  std::lock_guard<std::mutex> listeners_lock(changes_listeners_mutex_);
+  std::shared_ptr<tablet::TabletPeer> old_peer;
+  {
+    std::lock_guard<std::mutex> lock(changes_waiters_mutex_);
+    if (changes_waiters_stopped_) {
+      return 0;
+    }
+    auto& tablet_waiters = changes_waiters_[tablet_id];
+    old_peer = tablet_waiters.peer.lock();
+    if (old_peer == tablet_peer) {
+      return tablet_waiters.notifications;
+    }
+    tablet_waiters.peer = tablet_peer;
+  }
+
+  // The listener is called under the consensus lock, so it is not installed under
+  // changes_waiters_mutex_, that the listener locks.
+  if (old_peer) {
+    old_peer->ListenMajorityReplicated(nullptr);
+  }
+  tablet_peer->ListenMajorityReplicated(
+      std::bind(&CDCServiceImpl::ChangesReplicated, this, tablet_id));
+
+  std::lock_guard<std::mutex> lock(changes_waiters_mutex_);
+  return changes_waiters_[tablet_id].notifications;
+}
+
+bool CDCServiceImpl::AddChangesWaiter(const GetChangesRequestPB* req,
+                                      GetChangesResponsePB* resp,
+                                      const std::shared_ptr<RpcContext>& context,
+                                      CoarseTimePoint wait_deadline,
+                                      uint64_t notifications) {
+  {
+    std::lock_guard<std::mutex> lock(changes_waiters_mutex_);
+    if (changes_waiters_stopped_) {
+      return false;
+    }
+    auto& tablet_waiters = changes_waiters_[req->tablet_id()];
+    tablet_waiters.waiters.push_back(ChangesWaiter{req, resp, context, wait_deadline});
+    if (tablet_waiters.notifications != notifications) {
+      // Operations were replicated while the changes were read.
+      changed_tablets_.insert(req->tablet_id());
+    }
+  }
+  changes_waiters_cond_.notify_one();
+  return true;
+}
+
+void CDCServiceImpl::ChangesReplicated(const TabletId& tablet_id) {
+  {
+    std::lock_guard<std::mutex> lock(changes_waiters_mutex_);
+    auto it = changes_waiters_.find(tablet_id);
+    if (it == changes_waiters_.end()) {
+      return;
+    }
+    ++it->second.notifications;
+    if (it->second.waiters.empty() || !changed_tablets_.insert(tablet_id).second) {
+      return;
+    }
+  }
+  changes_waiters_cond_.notify_one();
+}
+
+void CDCServiceImpl::RunChangesWaiters() {
+  std::vector<ChangesWaiter> ready;
+  std::unique_lock<std::mutex> lock(changes_waiters_mutex_);
+  while (!changes_waiters_stopped_) {
+    const auto now = CoarseMonoClock::Now();
+    auto next_deadline = CoarseTimePoint::max();
+    for (auto it = changes_waiters_.begin(); it != changes_waiters_.end();) {
+      auto& waiters = it->second.waiters;
+      const bool changed = changed_tablets_.count(it->first) != 0;
+      auto ready_begin = std::partition(
+          waiters.begin(), waiters.end(),
+          [changed, now, &next_deadline](const ChangesWaiter& waiter) {
+            if (changed || waiter.deadline <= now) {
+              return false;
+            }
+            next_deadline = std::min(next_deadline, waiter.deadline);
+            return true;
+          });
+      std::move(ready_begin, waiters.end(), std::back_inserter(ready));
+      waiters.erase(ready_begin, waiters.end());
+      // Forget the tablets that are no longer served by this server.
+      if (waiters.empty() && it->second.peer.expired()) {
+        it = changes_waiters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    changed_tablets_.clear();
+
+    if (ready.empty()) {
+      if (next_deadline == CoarseTimePoint::max()) {
+        changes_waiters_cond_.wait(lock);
+      } else {
+        changes_waiters_cond_.wait_for(lock, next_deadline - now);
+      }
+      continue;
+    }
+
+    lock.unlock();
+    for (auto& waiter : ready) {
+      waiter.resp->Clear();
+      auto s = changes_waiters_pool_->SubmitFunc(std::bind(
+          &CDCServiceImpl::DoGetChanges, this, waiter.req, waiter.resp, waiter.context,
+          waiter.deadline));
+      if (!s.ok()) {
+        SetupErrorAndRespond(
+            waiter.resp->mutable_error(), s, CDCErrorPB::INTERNAL_ERROR, waiter.context.get());
+      }
+    }
+    ready.clear();
+    lock.lock();
+  }
+}
+
+void CDCServiceImpl::StopChangesWaiters() {
+  std::vector<std::shared_ptr<tablet::TabletPeer>> peers;
+  {
+    std::lock_guard<std::mutex> listeners_lock(changes_listeners_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(changes_waiters_mutex_);
+      if (changes_waiters_stopped_) {
+        return;
+      }
+      changes_waiters_stopped_ = true;
+      for (const auto& tablet_and_waiters : changes_waiters_) {
+        auto peer = tablet_and_waiters.second.peer.lock();
+        if (peer) {
+          peers.push_back(std::move(peer));
+        }
+      }
+    }
+    for (const auto& peer : peers) {
+      peer->ListenMajorityReplicated(nullptr);
+    }
+  }
+  changes_waiters_cond_.notify_all();
+  changes_waiters_thread_->join();
+  // Waits for the resumed requests, that are not held again after the stop.
+  changes_waiters_pool_->Shutdown();
+
+  std::lock_guard<std::mutex> lock(changes_waiters_mutex_);
+  for (auto& tablet_and_waiters : changes_waiters_) {
+    for (auto& waiter : tablet_and_waiters.second.waiters) {
+      SetupErrorAndRespond(waiter.resp->mutable_error(),
+                           STATUS(ServiceUnavailable, "CDC service is shutting down"),
+                           CDCErrorPB::NOT_RUNNING, waiter.context.get());
+    }
+  }
+  changes_waiters_.clear();
+}
+
 void CDCServiceImpl::UpdatePeersCdcMinReplicatedIndex(const TabletId& tablet_id,
                                                       int64_t min_index) {
   std::vector<client::internal::RemoteTabletServer *> servers;
@@ -761,7 +996,8 @@ void CDCServiceImpl::UpdateCdcReplicatedIndex(const UpdateCdcReplicatedIndexRequ
   context.RespondSuccess();
 }
 
-  Result<OpId> CDCServiceImpl::TabletLeaderLatestEntryOpId(const TabletId& tablet_id) {
+  Result<OpId> CDCServiceImpl::TabletLeaderLatestEntryOpId(
+      const TabletId& tablet_id, HybridTime* hybrid_time) {
     auto ts_leader = VERIFY_RESULT(GetLeaderTServer(tablet_id));
 
     auto cdc_proxy = GetCDCServiceProxy(ts_leader);
@@ -785,12 +1021,14 @@ void CDCServiceImpl::UpdateCdcReplicatedIndex(const UpdateCdcReplicatedIndexRequ
         auto follower_cdc_proxy = GetCDCServiceProxy(server);
         status = follower_cdc_proxy->GetLatestEntryOpId(req, &resp, &rpc);
         if (status.ok()) {
-          return OpId::FromPB(resp.op_id());
+          break;
         }
       }
-      DCHECK(!status.ok());
-      return status;
+      if (!status.ok()) {
+        return status;
+      }
     }
+    *hybrid_time = resp.has_hybrid_time() ? HybridTime(resp.hybrid_time()) : HybridTime::kInvalid;
     return OpId::FromPB(resp.op_id());
   }
 
@@ -814,6 +1052,7 @@ void CDCServiceImpl::GetLatestEntryOpId(const GetLatestEntryOpIdRequestPB* req,
   }
   OpId op_id = tablet_peer->log()->GetLatestEntryOpId();
   op_id.ToPB(resp->mutable_op_id());
+  resp->set_hybrid_time(tablet_manager_->server()->Clock()->Now().ToUint64());
   context.RespondSuccess();
 }
 
@@ -846,6 +1085,11 @@ void CDCServiceImpl::BootstrapProducer(const BootstrapProducerRequestPB* req,
 
   std::vector<CDCStreamId> bootstrap_ids;
 
+  // Every operation up to the bootstrap op ids has hybrid time not after the bootstrap time, so
+  // reading at it includes them. The bootstrap time is the latest of the hybrid times read after
+  // the op ids on the servers that assigned or replicated those operations.
+  HybridTime bootstrap_time = HybridTime::kMin;
+
   for (const auto& table_id : req->table_ids()) {
     std::shared_ptr<client::YBTable> table;
     Status s = async_client_init_->client()->OpenTable(table_id, &table);
@@ -865,7 +1109,7 @@ void CDCServiceImpl::BootstrapProducer(const BootstrapProducerRequestPB* req,
     std::unordered_map<std::string, std::string> options;
     options.reserve(2);
     options.emplace(cdc::kRecordType, CDCRecordType_Name(cdc::CDCRecordType::CHANGE));
-    options.emplace(cdc::kRecordFormat, CDCRecordFormat_Name(cdc::CDCRecordFormat::WAL));
+    options.emplace(cdc::kRecordFormat, CDCRecordFormat_Name(req->record_format()));
 
     auto result = async_client_init_->client()->CreateCDCStream(table_id, options);
     RPC_CHECK_AND_RETURN_ERROR(result.ok(), result.status(), resp->mutable_error(),
@@ -888,9 +1132,10 @@ void CDCServiceImpl::BootstrapProducer(const BootstrapProducerRequestPB* req,
       std::shared_ptr<tablet::TabletPeer> tablet_peer;
       OpId op_id;
 
+      HybridTime op_id_hybrid_time;
       s = tablet_manager_->GetTabletPeer(tablet.tablet_id(), &tablet_peer);
       if (!s.ok()) {
-        auto result = TabletLeaderLatestEntryOpId(tablet.tablet_id());
+        auto result = TabletLeaderLatestEntryOpId(tablet.tablet_id(), &op_id_hybrid_time);
         RPC_CHECK_AND_RETURN_ERROR(result.ok(), result.status(), resp->mutable_error(),
             CDCErrorPB::INTERNAL_ERROR, context);
         op_id = *result;
@@ -907,6 +1152,12 @@ void CDCServiceImpl::BootstrapProducer(const BootstrapProducerRequestPB* req,
           return;
         }
         op_id = tablet_peer->log()->GetLatestEntryOpId();
+        op_id_hybrid_time = tablet_manager_->server()->Clock()->Now();
+      }
+      if (!op_id_hybrid_time.is_valid()) {
+        bootstrap_time = HybridTime::kInvalid;
+      } else if (bootstrap_time.is_valid()) {
+        bootstrap_time.MakeAtLeast(op_id_hybrid_time);
       }
 
       const auto op = cdc_state_table.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
@@ -935,12 +1186,16 @@ void CDCServiceImpl::BootstrapProducer(const BootstrapProducerRequestPB* req,
   for (const auto& bootstrap_id : bootstrap_ids) {
     resp->add_cdc_bootstrap_ids(bootstrap_id);
   }
+  if (bootstrap_time.is_valid()) {
+    resp->set_bootstrap_time(bootstrap_time.ToUint64());
+  }
   // Clear this vector so no streams are deleted by scope_exit since we succeeded.
   created_cdc_streams.clear();
   context.RespondSuccess();
 }
 
 void CDCServiceImpl::Shutdown() {
+  StopChangesWaiters();
   async_client_init_->Shutdown();
   rpcs_.Shutdown();
 }
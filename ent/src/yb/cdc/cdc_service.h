@@ -15,6 +15,10 @@
 
 #include "yb/cdc/cdc_service.service.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <unordered_set>
+
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/member.hpp>
@@ -37,6 +41,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/service_util.h"
+#include "yb/util/threadpool.h"
 
 namespace yb {
 
@@ -137,6 +142,36 @@ class CDCServiceImpl : public CDCServiceIf {
 
   CHECKED_STATUS CheckTabletValidForStream(const ProducerTabletInfo& producer_info);
 
+  // Serves GetChanges for the tablet led by this server. When there are no new changes, holds the
+  // request until more operations of the tablet are majority replicated or wait_deadline passes.
+  void DoGetChanges(const GetChangesRequestPB* req,
+                    GetChangesResponsePB* resp,
+                    std::shared_ptr<rpc::RpcContext> context,
+                    CoarseTimePoint wait_deadline);
+
+  // Returns the deadline to hold the request until when there are no new changes.
+  CoarseTimePoint GetChangesWaitDeadline(const GetChangesRequestPB& req,
+                                         const rpc::RpcContext& context);
+
+  // Makes the peer notify the waiting requests about replicated operations, returns the number of
+  // the notifications so far.
+  uint64_t ListenChanges(const std::shared_ptr<tablet::TabletPeer>& tablet_peer);
+
+  // Holds the request until there are operations replicated after the specified number of the
+  // notifications. Returns false when the service is stopped, so the request is not held.
+  bool AddChangesWaiter(const GetChangesRequestPB* req,
+                        GetChangesResponsePB* resp,
+                        const std::shared_ptr<rpc::RpcContext>& context,
+                        CoarseTimePoint wait_deadline,
+                        uint64_t notifications);
+
+  void ChangesReplicated(const TabletId& tablet_id);
+
+  // Resumes the waiting requests that got new changes or reached their deadlines.
+  void RunChangesWaiters();
+
+  void StopChangesWaiters();
+
   void TabletLeaderGetChanges(const GetChangesRequestPB* req,
                               GetChangesResponsePB* resp,
                               std::shared_ptr<rpc::RpcContext> context,
@@ -147,7 +182,9 @@ class CDCServiceImpl : public CDCServiceIf {
                                  rpc::RpcContext* context,
                                  const std::shared_ptr<tablet::TabletPeer>& peer);
 
-  Result<OpId> TabletLeaderLatestEntryOpId(const TabletId& tablet_id);
+  // Returns the latest entry op id of the tablet, and fills hybrid_time with the hybrid time
+  // that the tablet server read after it, or invalid if the server did not report it.
+  Result<OpId> TabletLeaderLatestEntryOpId(const TabletId& tablet_id, HybridTime* hybrid_time);
 
   Result<client::internal::RemoteTabletPtr> GetRemoteTablet(const TabletId& tablet_id);
   Result<client::internal::RemoteTabletServer *> GetLeaderTServer(const TabletId& tablet_id);
@@ -258,6 +295,36 @@ class CDCServiceImpl : public CDCServiceIf {
   // True when this service is stopped. Used to inform
   // get_minimum_checkpoints_and_update_peers_thread_ that it should exit.
   std::atomic<bool> cdc_service_stopped_{false};
+
+  // GetChanges request held until new changes are replicated.
+  struct ChangesWaiter {
+    const GetChangesRequestPB* req;
+    GetChangesResponsePB* resp;
+    std::shared_ptr<rpc::RpcContext> context;
+    CoarseTimePoint deadline;
+  };
+
+  struct TabletChangesWaiters {
+    // The peer that notifies about replicated operations.
+    std::weak_ptr<tablet::TabletPeer> peer;
+    // Number of the notifications, the waiter is resumed when it changes after reading changes.
+    uint64_t notifications = 0;
+    std::vector<ChangesWaiter> waiters;
+  };
+
+  // Serializes installing the listeners of the peers with stopping the waiters.
+  std::mutex changes_listeners_mutex_;
+  std::mutex changes_waiters_mutex_;
+  std::condition_variable changes_waiters_cond_;
+  std::unordered_map<TabletId, TabletChangesWaiters> changes_waiters_
+      GUARDED_BY(changes_waiters_mutex_);
+  // Tablets with waiters that got new changes.
+  std::unordered_set<TabletId> changed_tablets_ GUARDED_BY(changes_waiters_mutex_);
+  bool changes_waiters_stopped_ GUARDED_BY(changes_waiters_mutex_) = false;
+
+  std::unique_ptr<std::thread> changes_waiters_thread_;
+  // Pool that the held requests are resumed on.
+  std::unique_ptr<ThreadPool> changes_waiters_pool_;
 };
 
 }  // namespace cdc
@@ -401,6 +401,10 @@ TEST_F(CDCServiceTest, TestBootstrapProducer) {
   ASSERT_FALSE(resp.has_error());
 
   ASSERT_EQ(resp.cdc_bootstrap_ids().size(), 1);
+  // The rows written before the bootstrap are read at the bootstrap time.
+  ASSERT_TRUE(resp.has_bootstrap_time());
+  ASSERT_LE(HybridTime(resp.bootstrap_time()),
+            cluster_->mini_tablet_server(0)->server()->Clock()->Now());
 
   string bootstrap_id = resp.cdc_bootstrap_ids(0);
 
@@ -545,6 +549,15 @@ TEST_F(CDCServiceTest, TestGetChanges) {
     ASSERT_EQ(metrics->last_read_opid_index->value(), metrics->last_readable_opid_index->value());
     ASSERT_EQ(metrics->last_read_opid_index->value(), change_resp.records_size() + 1 /* checkpt */);
     ASSERT_EQ(metrics->rpc_payload_bytes_responded->TotalCount(), 1);
+    ASSERT_EQ(metrics->records_cache_misses->value(), 1);
+
+    // A retry of the same request gets the records decoded for the first one.
+    GetChangesResponsePB retry_resp;
+    RpcController retry_rpc;
+    ASSERT_OK(cdc_proxy_->GetChanges(change_req, &retry_resp, &retry_rpc));
+    ASSERT_FALSE(retry_resp.has_error());
+    ASSERT_EQ(retry_resp.ShortDebugString(), change_resp.ShortDebugString());
+    ASSERT_EQ(metrics->records_cache_hits->value(), 1);
   }
 
   // Insert another row.
@@ -611,6 +624,80 @@ TEST_F(CDCServiceTest, TestGetChanges) {
   }
 }
 
+TEST_F(CDCServiceTest, TestGetChangesColumnar) {
+  CDCStreamId stream_id;
+  CreateCDCStream(cdc_proxy_, table_.table()->id(), &stream_id);
+
+  std::string tablet_id;
+  GetTablet(&tablet_id);
+
+  const auto& proxy = cluster_->mini_tablet_server(0)->server()->proxy();
+  {
+    tserver::WriteRequestPB write_req;
+    tserver::WriteResponsePB write_resp;
+    write_req.set_tablet_id(tablet_id);
+    AddTestRowInsert(1, 11, "key1", &write_req);
+    AddTestRowInsert(2, 22, "key2", &write_req);
+
+    RpcController rpc;
+    ASSERT_OK(proxy->Write(write_req, &write_resp, &rpc));
+    ASSERT_FALSE(write_resp.has_error());
+  }
+
+  GetChangesRequestPB change_req;
+  GetChangesResponsePB change_resp;
+  change_req.set_tablet_id(tablet_id);
+  change_req.set_stream_id(stream_id);
+  change_req.mutable_from_checkpoint()->mutable_op_id()->set_index(0);
+  change_req.mutable_from_checkpoint()->mutable_op_id()->set_term(0);
+  change_req.set_columnar_records(true);
+
+  RpcController rpc;
+  ASSERT_OK(cdc_proxy_->GetChanges(change_req, &change_resp, &rpc));
+  SCOPED_TRACE(change_resp.DebugString());
+  ASSERT_FALSE(change_resp.has_error());
+  ASSERT_EQ(change_resp.records_size(), 0);
+
+  const auto& columnar = change_resp.columnar_records();
+  ASSERT_EQ(columnar.time_size(), 2);
+  ASSERT_EQ(columnar.operation(0), CDCRecordPB::WRITE);
+  ASSERT_EQ(columnar.operation(1), CDCRecordPB::WRITE);
+  ASSERT_EQ(columnar.columns_size(), 3);
+
+  const std::pair<const char*, bool> expected_columns[] = {
+      {"key", true}, {"int_val", false}, {"string_val", false}};
+  for (int i = 0; i != columnar.columns_size(); ++i) {
+    const auto& column = columnar.columns(i);
+    ASSERT_EQ(column.name(), expected_columns[i].first);
+    ASSERT_EQ(column.is_key(), expected_columns[i].second);
+    ASSERT_EQ(column.present(), std::string(1, 3));
+    ASSERT_EQ(column.nulls(), std::string(1, 0));
+  }
+
+  // Decode the values of each column in a pass.
+  auto decode = [&columnar](int column_idx, DataType type) {
+    std::vector<QLValue> result;
+    Slice data(columnar.columns(column_idx).values());
+    while (!data.empty()) {
+      result.emplace_back();
+      CHECK_OK(result.back().Deserialize(QLType::Create(type), YQL_CLIENT_CQL, &data));
+    }
+    return result;
+  };
+  auto keys = decode(0, DataType::INT32);
+  auto ints = decode(1, DataType::INT32);
+  auto strings = decode(2, DataType::STRING);
+  ASSERT_EQ(keys.size(), 2);
+  ASSERT_EQ(ints.size(), 2);
+  ASSERT_EQ(strings.size(), 2);
+  ASSERT_EQ(keys[0].int32_value(), 1);
+  ASSERT_EQ(keys[1].int32_value(), 2);
+  ASSERT_EQ(ints[0].int32_value(), 11);
+  ASSERT_EQ(ints[1].int32_value(), 22);
+  ASSERT_EQ(strings[0].string_value(), "key1");
+  ASSERT_EQ(strings[1].string_value(), "key2");
+}
+
 TEST_F(CDCServiceTest, TestGetChangesInvalidStream) {
   std::string tablet_id;
   GetTablet(&tablet_id);
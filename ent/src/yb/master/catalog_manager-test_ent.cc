@@ -109,6 +109,10 @@ class TestLoadBalancerEnterprise : public TestLoadBalancerBase<ClusterLoadBalanc
     PrepareAffinitizedLeaders({"b", "c"});
     TestBalancingTwoAffinitizedLeaders();
 
+    PrepareTestState(ts_descs);
+    PrepareAffinitizedLeaders({"a"});
+    TestBalancingTableAffinitizedLeaders();
+
     PrepareTestState(ts_descs);
     TestReadOnlyLoadBalancing();
 
@@ -323,6 +327,42 @@ class TestLoadBalancerEnterprise : public TestLoadBalancerBase<ClusterLoadBalanc
     LOG(INFO) << "Finishing TestLeaderBalancingWithReadOnly";
   }
 
+  void TestBalancingTableAffinitizedLeaders() {
+    LOG(INFO) << "Starting TestBalancingTableAffinitizedLeaders";
+    // The table prefers its leaders in zone b, over zone a preferred by the cluster.
+    SetTableAffinitizedLeaders({"b"});
+    for (const auto tablet : tablets_) {
+      MoveTabletLeader(tablet.get(), ts_descs_[0]);
+    }
+    LOG(INFO) << "Leader distribution: 4 0 0";
+
+    AnalyzeTablets();
+    string placeholder, tablet_id, from_ts, to_ts;
+    for (int i = 0; i < tablets_.size(); ++i) {
+      ASSERT_TRUE(ASSERT_RESULT(HandleLeaderMoves(&tablet_id, &from_ts, &to_ts)));
+      ASSERT_EQ(from_ts, ts_descs_[0]->permanent_uuid());
+      ASSERT_EQ(to_ts, ts_descs_[1]->permanent_uuid());
+    }
+    LOG(INFO) << "Leader distribution: 0 4 0";
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    SetTableAffinitizedLeaders({});
+    LOG(INFO) << "Finishing TestBalancingTableAffinitizedLeaders";
+  }
+
+  void SetTableAffinitizedLeaders(const vector<string>& zones) {
+    auto l = table_map_[cur_table_uuid_]->LockForWrite();
+    auto* replication_info = l->mutable_data()->pb.mutable_replication_info();
+    replication_info->clear_affinitized_leaders();
+    for (const string& zone : zones) {
+      CloudInfoPB* ci = replication_info->add_affinitized_leaders();
+      ci->set_placement_cloud(default_cloud);
+      ci->set_placement_region(default_region);
+      ci->set_placement_zone(zone);
+    }
+    l->Commit();
+  }
+
   void PrepareAffinitizedLeaders(const vector<string>& zones) {
     for (const string& zone : zones) {
       CloudInfoPB ci;
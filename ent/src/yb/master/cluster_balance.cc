@@ -11,6 +11,10 @@
 // under the License.
 
 #include "yb/master/cluster_balance.h"
+
+#include <algorithm>
+
+#include "yb/master/catalog_manager_util.h"
 #include "yb/master/cluster_balance_util.h"
 
 using std::set;
@@ -31,7 +35,17 @@ Result<bool> ClusterLoadBalancer::HandleLeaderMoves(
 
 Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   ClusterLoadState* ent_state = GetEntState();
-  GetAllAffinitizedZones(&ent_state->affinitized_zones_);
+  // The preferred zones of the table leaders override the cluster ones.
+  auto table = GetTableInfo(table_uuid);
+  if (table) {
+    auto l = table->LockForRead();
+    for (const auto& ci : l->data().pb.replication_info().affinitized_leaders()) {
+      ent_state->affinitized_zones_.insert(ci);
+    }
+  }
+  if (ent_state->affinitized_zones_.empty()) {
+    GetAllAffinitizedZones(&ent_state->affinitized_zones_);
+  }
   return super::AnalyzeTablets(table_uuid);
 }
 
@@ -92,10 +106,11 @@ void ClusterLoadBalancer::PopulatePlacementInfo(TabletInfo* tablet, PlacementInf
       l->data().pb.has_replication_info() &&
       l->data().pb.replication_info().has_live_replicas()) {
     pb->CopyFrom(l->data().pb.replication_info().live_replicas());
-  } else if (options_ent->type == READ_ONLY &&
-      l->data().pb.has_replication_info() &&
-      !l->data().pb.replication_info().read_replicas().empty()) {
-    pb->CopyFrom(GetReadOnlyPlacementFromUuid(l->data().pb.replication_info()));
+  } else if (options_ent->type == READ_ONLY) {
+    // The table gets no replicas in the read only clusters it is not placed in.
+    pb->CopyFrom(GetReadOnlyPlacementFromUuid(CatalogManagerUtil::TableReplicationInfo(
+        GetClusterReplicationInfo(), l->data().pb.replication_info())));
+    pb->set_placement_uuid(options_ent->placement_uuid);
   } else {
     pb->CopyFrom(GetClusterPlacementInfo());
   }
@@ -115,6 +130,31 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
   return state_->UpdateTablet(tablet);
 }
 
+ReplicationInfoPB ClusterLoadBalancer::GetClusterReplicationInfo() const {
+  auto l = down_cast<CatalogManager*>(catalog_manager_)->GetClusterConfigInfo()->LockForRead();
+  return l->data().pb.replication_info();
+}
+
+std::vector<std::string> ClusterLoadBalancer::GetReadOnlyPlacementUuids(
+    const ReplicationInfoPB& replication_info) const {
+  std::vector<std::string> result;
+  auto add_placements = [&result](const ReplicationInfoPB& info) {
+    for (const auto& placement : info.read_replicas()) {
+      if (std::find(result.begin(), result.end(), placement.placement_uuid()) == result.end()) {
+        result.push_back(placement.placement_uuid());
+      }
+    }
+  };
+  add_placements(replication_info);
+
+  SharedLock<CatalogManager::LockType> l(down_cast<CatalogManager*>(catalog_manager_)->lock_);
+  for (const auto& table : GetTableMap()) {
+    auto table_lock = table.second->LockForRead();
+    add_placements(table_lock->data().pb.replication_info());
+  }
+  return result;
+}
+
 const PlacementInfoPB& ClusterLoadBalancer::GetLiveClusterPlacementInfo() const {
   auto l = down_cast<CatalogManager*>(catalog_manager_)->GetClusterConfigInfo()->LockForRead();
   return l->data().pb.replication_info().live_replicas();
@@ -149,11 +189,10 @@ void ClusterLoadBalancer::RunLoadBalancer(yb::master::Options* options) {
   }
   super::RunLoadBalancer(options_ent);
 
-  // Then, we balance all read-only clusters.
+  // Then, we balance all read-only clusters, of the cluster config and of the tables.
   options_ent->type = READ_ONLY;
-  for (int i = 0; i < config.replication_info().read_replicas_size(); i++) {
-    const PlacementInfoPB& read_only_cluster = config.replication_info().read_replicas(i);
-    options_ent->placement_uuid = read_only_cluster.placement_uuid();
+  for (const auto& placement_uuid : GetReadOnlyPlacementUuids(config.replication_info())) {
+    options_ent->placement_uuid = placement_uuid;
     super::RunLoadBalancer(options_ent);
   }
 }
@@ -168,10 +207,8 @@ const PlacementInfoPB& ClusterLoadBalancer::GetReadOnlyPlacementFromUuid(
       return read_only_placement;
     }
   }
-  // Should never get here.
-  LOG(ERROR) << "Could not find read only cluster with placement uuid: "
-             << options_ent->placement_uuid;
-  return replication_info.read_replicas(0);
+  // The read only cluster was only set for other tables.
+  return PlacementInfoPB::default_instance();
 }
 
 consensus::RaftPeerPB::MemberType ClusterLoadBalancer::GetDefaultMemberType() {
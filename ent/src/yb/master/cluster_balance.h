@@ -59,10 +59,18 @@ class ClusterLoadBalancer : public yb::master::ClusterLoadBalancer {
   // Populates pb with the placement info in tablet's config at cluster placement_uuid_.
   void PopulatePlacementInfo(TabletInfo* tablet, PlacementInfoPB* pb);
 
-  // Returns the read only placement info from placement_uuid_.
+  // Returns the read only placement info from placement_uuid_, an empty placement without
+  // replicas if replication_info has no placement with this uuid.
   const PlacementInfoPB& GetReadOnlyPlacementFromUuid(
       const ReplicationInfoPB& replication_info) const;
 
+  ReplicationInfoPB GetClusterReplicationInfo() const;
+
+  // Returns the placement uuids of the read only clusters of the given cluster replication info,
+  // followed by the ones that only the tables are placed in.
+  std::vector<std::string> GetReadOnlyPlacementUuids(
+      const ReplicationInfoPB& replication_info) const;
+
   virtual const PlacementInfoPB& GetLiveClusterPlacementInfo() const;
 
 
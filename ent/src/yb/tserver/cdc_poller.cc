@@ -21,6 +21,7 @@
 #include "yb/client/client.h"
 
 #include "yb/consensus/opid_util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/threadpool.h"
 
@@ -31,6 +32,12 @@ DEFINE_int32(replication_failure_delay_exponent, 16 /* ~ 2^16/1000 ~= 65 sec */,
 DEFINE_bool(cdc_consumer_use_proxy_forwarding, false,
             "When enabled, read requests from the CDC Consumer that go to the wrong node are "
             "forwarded to the correct node by the Producer.");
+DEFINE_int32(cdc_consumer_wait_for_changes_ms, 1000,
+             "How long the CDC Producer could hold a read request of the CDC Consumer when there "
+             "are no new changes, so the changes are sent once they are replicated instead of on "
+             "the next poll. 0 to poll without waiting.");
+TAG_FLAG(cdc_consumer_wait_for_changes_ms, advanced);
+TAG_FLAG(cdc_consumer_wait_for_changes_ms, runtime);
 
 DECLARE_int32(cdc_read_rpc_timeout_ms);
 
@@ -58,7 +65,8 @@ CDCPoller::CDCPoller(const cdc::ProducerTabletInfo& producer_tablet_info,
         consumer_tablet_info,
         local_client,
         std::bind(&CDCPoller::HandleApplyChanges, this, std::placeholders::_1),
-        use_local_tserver)),
+        use_local_tserver,
+        cdc_consumer->GetStreamMetrics(producer_tablet_info.stream_id))),
     producer_client_(producer_client),
     thread_pool_(thread_pool),
     cdc_consumer_(cdc_consumer) {}
@@ -103,6 +111,9 @@ void CDCPoller::DoPoll() {
   req.set_stream_id(producer_tablet_info_.stream_id);
   req.set_tablet_id(producer_tablet_info_.tablet_id);
   req.set_serve_as_proxy(FLAGS_cdc_consumer_use_proxy_forwarding);
+  if (FLAGS_cdc_consumer_wait_for_changes_ms > 0) {
+    req.set_wait_for_changes_ms(FLAGS_cdc_consumer_wait_for_changes_ms);
+  }
 
   cdc::CDCCheckpointPB checkpoint;
   *checkpoint.mutable_op_id() = op_id_;
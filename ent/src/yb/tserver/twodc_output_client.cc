@@ -12,13 +12,17 @@
 
 #include "yb/tserver/twodc_output_client.h"
 
+#include <algorithm>
 #include <shared_mutex>
 
+#include "yb/cdc/cdc_metrics.h"
 #include "yb/cdc/cdc_util.h"
 #include "yb/cdc/cdc_rpc.h"
 #include "yb/client/client.h"
 #include "yb/client/meta_cache.h"
+#include "yb/common/hybrid_time.h"
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/walltime.h"
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/tserver/cdc_consumer.h"
@@ -26,6 +30,7 @@
 #include "yb/tserver/twodc_write_interface.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/net/net_util.h"
 
 DECLARE_int32(cdc_write_rpc_timeout_ms);
@@ -34,6 +39,13 @@ DEFINE_bool(cdc_force_remote_tserver, false,
             "Avoid local tserver apply optimization for CDC and force remote RPCs.");
 TAG_FLAG(cdc_force_remote_tserver, runtime);
 
+DEFINE_int32(cdc_max_apply_concurrent_writes, 16,
+             "Maximum number of CDC write requests in flight for a producer tablet. The requests "
+             "to the same consumer tablet are still sent one at a time, to apply its records in "
+             "order.");
+TAG_FLAG(cdc_max_apply_concurrent_writes, advanced);
+TAG_FLAG(cdc_max_apply_concurrent_writes, runtime);
+
 DECLARE_int32(cdc_read_rpc_timeout_ms);
 
 namespace yb {
@@ -49,19 +61,21 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
       const cdc::ConsumerTabletInfo& consumer_tablet_info,
       const std::shared_ptr<CDCClient>& local_client,
       std::function<void(const cdc::OutputClientResponse& response)> apply_changes_clbk,
-      bool use_local_tserver) :
+      bool use_local_tserver,
+      std::shared_ptr<cdc::CDCConsumerStreamMetrics> stream_metrics) :
       cdc_consumer_(cdc_consumer),
       consumer_tablet_info_(consumer_tablet_info),
       local_client_(local_client),
       apply_changes_clbk_(std::move(apply_changes_clbk)),
-      use_local_tserver_(use_local_tserver) {}
+      use_local_tserver_(use_local_tserver),
+      stream_metrics_(std::move(stream_metrics)) {}
 
   ~TwoDCOutputClient() = default;
 
   CHECKED_STATUS ApplyChanges(const cdc::GetChangesResponsePB* resp) override;
 
   void WriteCDCRecordDone(const Status& status, const WriteResponsePB& response,
-                          rpc::Rpcs::Handle handle);
+                          const std::string& tablet_id, rpc::Rpcs::Handle handle);
 
  private:
   void TabletLookupCallback(
@@ -71,7 +85,12 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
 
   void WriteIfAllRecordsProcessed();
 
-  void SendNextCDCWriteToTablet();
+  // Sends the writes that could be sent while the ones sent before are in flight.
+  void SendNextCDCWrites();
+
+  void SendCDCWrite(std::unique_ptr<WriteRequestPB> write_request);
+
+  void HandleWriteDone(const Status& status, const std::string& tablet_id);
 
   // Increment processed record count.
   // Returns true if all records are processed, false if there are still some pending records.
@@ -89,9 +108,11 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
 
   bool use_local_tserver_;
 
+  std::shared_ptr<cdc::CDCConsumerStreamMetrics> stream_metrics_;
+
   std::shared_ptr<client::YBTable> table_;
 
-  // Used to protect error_status_, op_id_, done_processing_ and record counts.
+  // Used to protect error_status_, op_id_, done_processing_, record counts and writes.
   mutable rw_spinlock lock_;
   Status error_status_ GUARDED_BY(lock_);
   OpIdPB op_id_ GUARDED_BY(lock_) = consensus::MinimumOpId();
@@ -103,7 +124,13 @@ class TwoDCOutputClient : public cdc::CDCOutputClient {
   // This will cache the response to an ApplyChanges() request.
   cdc::GetChangesResponsePB twodc_resp_copy_;
 
-  std::unique_ptr<TwoDCWriteInterface> write_strategy_;
+  // Consumer tablets of the records in twodc_resp_copy_, filled by the tablet lookups, that could
+  // finish in any order. The records are passed to the write strategy in their order once all the
+  // tablets are found.
+  std::vector<std::string> record_tablet_ids_;
+
+  std::unique_ptr<TwoDCWriteInterface> write_strategy_ GUARDED_BY(lock_);
+  size_t writes_in_flight_ GUARDED_BY(lock_) = 0;
 };
 
 Status TwoDCOutputClient::ApplyChanges(const cdc::GetChangesResponsePB* poller_resp) {
@@ -127,6 +154,7 @@ Status TwoDCOutputClient::ApplyChanges(const cdc::GetChangesResponsePB* poller_r
     processed_record_count_ = 0;
     record_count_ = poller_resp->records_size();
     ResetWriteInterface(&write_strategy_);
+    writes_in_flight_ = 0;
   }
 
   // Ensure we have records.
@@ -154,6 +182,7 @@ Status TwoDCOutputClient::ApplyChanges(const cdc::GetChangesResponsePB* poller_r
       twodc_resp_copy_.add_records()->CopyFrom(poller_resp->records(i));
     }
   }
+  record_tablet_ids_.assign(twodc_resp_copy_.records_size(), std::string());
 
   for (int i = 0; i < twodc_resp_copy_.records_size(); i++) {
     // All KV-pairs within a single CDC record will be for the same row.
@@ -199,8 +228,14 @@ void TwoDCOutputClient::WriteIfAllRecordsProcessed() {
       // Return error, if any, without applying records.
       HandleResponse();
     } else {
+      {
+        std::lock_guard<decltype(lock_)> l(lock_);
+        for (int i = 0; i < twodc_resp_copy_.records_size(); i++) {
+          write_strategy_->ProcessRecord(record_tablet_ids_[i], twodc_resp_copy_.records(i));
+        }
+      }
       // Apply the writes on consumer.
-      SendNextCDCWriteToTablet();
+      SendNextCDCWrites();
     }
   }
 }
@@ -214,21 +249,37 @@ void TwoDCOutputClient::TabletLookupCallback(
     return;
   }
 
-  write_strategy_->ProcessRecord(tablet->get()->tablet_id(), twodc_resp_copy_.records(record_idx));
+  record_tablet_ids_[record_idx] = tablet->get()->tablet_id();
 
   WriteIfAllRecordsProcessed();
 }
 
 void TwoDCOutputClient::TabletLookupCallbackFastTrack(const size_t record_idx) {
-  write_strategy_->ProcessRecord(consumer_tablet_info_.tablet_id,
-      twodc_resp_copy_.records(record_idx));
+  record_tablet_ids_[record_idx] = consumer_tablet_info_.tablet_id;
 
   WriteIfAllRecordsProcessed();
 }
 
-void TwoDCOutputClient::SendNextCDCWriteToTablet() {
-  auto write_request = write_strategy_->GetNextWriteRequest();
+void TwoDCOutputClient::SendNextCDCWrites() {
+  std::vector<std::unique_ptr<WriteRequestPB>> write_requests;
+  {
+    std::lock_guard<decltype(lock_)> l(lock_);
+    const size_t max_writes = std::max(FLAGS_cdc_max_apply_concurrent_writes, 1);
+    while (error_status_.ok() && writes_in_flight_ < max_writes) {
+      auto write_request = write_strategy_->GetNextWriteRequest();
+      if (!write_request) {
+        break;
+      }
+      ++writes_in_flight_;
+      write_requests.push_back(std::move(write_request));
+    }
+  }
+  for (auto& write_request : write_requests) {
+    SendCDCWrite(std::move(write_request));
+  }
+}
 
+void TwoDCOutputClient::SendCDCWrite(std::unique_ptr<WriteRequestPB> write_request) {
   auto deadline = CoarseMonoClock::Now() +
                   MonoDelta::FromMilliseconds(FLAGS_cdc_write_rpc_timeout_ms);
   auto write_rpc_handle = local_client_->rpcs->Prepare();
@@ -240,32 +291,56 @@ void TwoDCOutputClient::SendNextCDCWriteToTablet() {
         local_client_->client.get(),
         write_request.get(),
         std::bind(&TwoDCOutputClient::WriteCDCRecordDone, this,
-                  std::placeholders::_1, std::placeholders::_2, write_rpc_handle),
+                  std::placeholders::_1, std::placeholders::_2, write_request->tablet_id(),
+                  write_rpc_handle),
         UseLocalTserver());
     (**write_rpc_handle).SendRpc();
   } else {
     LOG(WARNING) << "Invalid handle for CDC write, tablet ID: " << write_request->tablet_id();
+    HandleWriteDone(STATUS(Aborted, "Invalid handle for CDC write"), write_request->tablet_id());
   }
 }
 
 void TwoDCOutputClient::WriteCDCRecordDone(const Status& status, const WriteResponsePB& response,
+                                           const std::string& tablet_id,
                                            rpc::Rpcs::Handle handle) {
   auto retained = local_client_->rpcs->Unregister(handle);
+  if (status.ok() && response.has_error()) {
+    HandleWriteDone(StatusFromPB(response.error().status()), tablet_id);
+  } else {
+    HandleWriteDone(status, tablet_id);
+  }
+}
+
+void TwoDCOutputClient::HandleWriteDone(const Status& status, const std::string& tablet_id) {
   if (!status.ok()) {
-    HandleError(status, true /* done */);
-    return;
-  } else if (response.has_error()) {
-    HandleError(StatusFromPB(response.error().status()), true /* done */);
-    return;
+    LOG(ERROR) << "Error while applying replicated record: " << status
+               << ", consumer tablet: " << tablet_id;
+  } else {
+    cdc_consumer_->IncrementNumSuccessfulWriteRpcs();
+    if (stream_metrics_) {
+      stream_metrics_->apply_write_rpcs->Increment();
+    }
   }
 
-  cdc_consumer_->IncrementNumSuccessfulWriteRpcs();
+  bool done;
+  {
+    std::lock_guard<decltype(lock_)> l(lock_);
+    --writes_in_flight_;
+    if (status.ok()) {
+      write_strategy_->WriteDone(tablet_id);
+    } else if (error_status_.ok()) {
+      error_status_ = status;
+    }
+    // After an error, the writes in flight are waited for, but no more writes are sent.
+    done = writes_in_flight_ == 0 && (!error_status_.ok() || !write_strategy_->HasMoreWrites());
+  }
 
-  if (!write_strategy_->HasMoreWrites()) {
+  if (done) {
     // Last record, return response to caller.
     HandleResponse();
-  } else {
-    SendNextCDCWriteToTablet();
+  } else if (status.ok()) {
+    SendNextCDCWrites();
   }
 }
 
@@ -291,6 +366,13 @@ void TwoDCOutputClient::HandleResponse() {
     }
     op_id_ = consensus::MinimumOpId();
   }
+  if (response.status.ok() && stream_metrics_ && twodc_resp_copy_.records_size() > 0) {
+    const auto& last_record = twodc_resp_copy_.records(twodc_resp_copy_.records_size() - 1);
+    stream_metrics_->apply_records->IncrementBy(twodc_resp_copy_.records_size());
+    // Clocks of the clusters are not synchronized, so the lag is approximate.
+    stream_metrics_->apply_lag_micros->set_value(std::max<int64_t>(
+        GetCurrentTimeMicros() - HybridTime(last_record.time()).GetPhysicalValueMicros(), 0));
+  }
   apply_changes_clbk_(response);
 }
 
@@ -309,9 +391,11 @@ std::unique_ptr<cdc::CDCOutputClient> CreateTwoDCOutputClient(
     const cdc::ConsumerTabletInfo& consumer_tablet_info,
     const std::shared_ptr<CDCClient>& local_client,
     std::function<void(const cdc::OutputClientResponse& response)> apply_changes_clbk,
-    bool use_local_tserver) {
+    bool use_local_tserver,
+    std::shared_ptr<cdc::CDCConsumerStreamMetrics> stream_metrics) {
   return std::make_unique<TwoDCOutputClient>(cdc_consumer, consumer_tablet_info, local_client,
-                                             std::move(apply_changes_clbk), use_local_tserver);
+                                             std::move(apply_changes_clbk), use_local_tserver,
+                                             std::move(stream_metrics));
 }
 
 } // namespace enterprise
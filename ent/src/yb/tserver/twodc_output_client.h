@@ -20,6 +20,12 @@ namespace yb {
 
 class ThreadPool;
 
+namespace cdc {
+
+class CDCConsumerStreamMetrics;
+
+} // namespace cdc
+
 namespace tserver {
 namespace enterprise {
 
@@ -31,7 +37,8 @@ std::unique_ptr<cdc::CDCOutputClient> CreateTwoDCOutputClient(
     const cdc::ConsumerTabletInfo& consumer_tablet_info,
     const std::shared_ptr<CDCClient>& local_client,
     std::function<void(const cdc::OutputClientResponse& response)> apply_changes_clbk,
-    bool use_local_tserver);
+    bool use_local_tserver,
+    std::shared_ptr<cdc::CDCConsumerStreamMetrics> stream_metrics);
 
 } // namespace enterprise
 } // namespace tserver
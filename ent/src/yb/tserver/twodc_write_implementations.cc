@@ -11,6 +11,7 @@
 // under the License.
 
 #include <deque>
+#include <unordered_set>
 
 #include "yb/tserver/twodc_write_interface.h"
 #include "yb/tserver/tserver.pb.h"
@@ -73,17 +74,26 @@ class SequentialWriteImplementation : public TwoDCWriteInterface {
   }
 
   std::unique_ptr <WriteRequestPB> GetNextWriteRequest() override {
+    if (write_in_flight_ || records_.empty()) {
+      return nullptr;
+    }
     auto next_req = std::move(records_.front());
     records_.pop_front();
+    write_in_flight_ = true;
     return next_req;
   }
 
+  void WriteDone(const std::string& tablet_id) override {
+    write_in_flight_ = false;
+  }
+
   bool HasMoreWrites() override {
     return records_.size() > 0;
   }
 
  private:
   std::deque <std::unique_ptr<WriteRequestPB>> records_;
+  bool write_in_flight_ = false;
 
 };
 
@@ -91,7 +101,8 @@ class SequentialWriteImplementation : public TwoDCWriteInterface {
 // Max number of records in a request is cdc_max_apply_batch_num_records, and max size of a request
 // is cdc_max_apply_batch_size_kb. Batches are not sent by opid order, since a GetChangesResponse
 // can contain interleaved records to multiple tablets. Rather, we send batches to each tablet
-// in order for that tablet, before moving on to the next tablet.
+// in order for that tablet, one at a time, while the batches to different tablets are sent
+// concurrently.
 class BatchedWriteImplementation : public TwoDCWriteInterface {
   ~BatchedWriteImplementation() = default;
 
@@ -135,13 +146,24 @@ class BatchedWriteImplementation : public TwoDCWriteInterface {
   }
 
   std::unique_ptr <WriteRequestPB> GetNextWriteRequest() override {
-    auto& queue = records_.begin()->second;
-    auto next_req = std::move(queue.front());
-    queue.pop_front();
-    if (queue.size() == 0) {
-      records_.erase(next_req->tablet_id());
+    for (auto it = records_.begin(); it != records_.end(); ++it) {
+      if (tablets_in_flight_.count(it->first)) {
+        continue;
+      }
+      auto& queue = it->second;
+      auto next_req = std::move(queue.front());
+      queue.pop_front();
+      if (queue.size() == 0) {
+        records_.erase(it);
+      }
+      tablets_in_flight_.insert(next_req->tablet_id());
+      return next_req;
     }
-    return next_req;
+    return nullptr;
+  }
+
+  void WriteDone(const std::string& tablet_id) override {
+    tablets_in_flight_.erase(tablet_id);
   }
 
   bool HasMoreWrites() override {
@@ -151,6 +173,8 @@ class BatchedWriteImplementation : public TwoDCWriteInterface {
  private:
   std::map <std::string, std::deque<std::unique_ptr < WriteRequestPB>>>
   records_;
+  // Tablets with a write in flight, the next write to them waits for it to keep the order.
+  std::unordered_set<std::string> tablets_in_flight_;
 };
 
 void ResetWriteInterface(std::unique_ptr<TwoDCWriteInterface>* write_strategy) {
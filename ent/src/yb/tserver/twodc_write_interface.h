@@ -31,7 +31,11 @@ namespace enterprise {
 class TwoDCWriteInterface {
  public:
   virtual ~TwoDCWriteInterface() {}
+  // Returns the next write request that could be sent while the requests returned before are in
+  // flight, or nullptr if there is none until some of them are done.
   virtual std::unique_ptr <WriteRequestPB> GetNextWriteRequest() = 0;
+  // Called when the write request returned for the tablet is successfully done.
+  virtual void WriteDone(const std::string& tablet_id) = 0;
   virtual void ProcessRecord(const std::string& tablet_id, const cdc::CDCRecordPB& record) = 0;
   virtual bool HasMoreWrites() = 0;
 };
@@ -1400,6 +1400,15 @@ void ybcIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 
 	ybcCostEstimate(baserel, *selectivity, startup_cost, total_cost);
 
+	/*
+	 * Unless the scan is index-only, the rows found in a secondary index are read again from the
+	 * base table, in another round trip. Account for it, so that an index that covers all the
+	 * columns of the query, or the primary key, wins over an index with the same search conditions
+	 * that needs the base table.
+	 */
+	if (!isprimary && path->path.pathtype != T_IndexOnlyScan)
+		*total_cost += YBC_BASE_TABLE_LOOKUP_COST_FACTOR * cpu_tuple_cost * path->path.rows;
+
 	if (relation)
 		RelationClose(relation);
 
@@ -40,6 +40,8 @@
 #include "utils/typcache.h"
 #include "utils/xml.h"
 
+#include "pg_yb_utils.h"
+
 
 /* Hook for plugins to get control in ExplainOneQuery() */
 ExplainOneQuery_hook_type ExplainOneQuery_hook = NULL;
@@ -61,6 +63,7 @@ static void ExplainOneQuery(Query *query, int cursorOptions,
 static void report_triggers(ResultRelInfo *rInfo, bool show_relname,
 				ExplainState *es);
 static double elapsed_time(instr_time *starttime);
+static void YbExplainPrintStorageMetrics(ExplainState *es);
 static bool ExplainPreScanNode(PlanState *planstate, Bitmapset **rels_used);
 static void ExplainNode(PlanState *planstate, List *ancestors,
 			const char *relationship, const char *plan_name,
@@ -164,6 +167,8 @@ ExplainQuery(ParseState *pstate, ExplainStmt *stmt, const char *queryString,
 			es->costs = defGetBoolean(opt);
 		else if (strcmp(opt->defname, "buffers") == 0)
 			es->buffers = defGetBoolean(opt);
+		else if (strcmp(opt->defname, "dist") == 0)
+			es->dist = defGetBoolean(opt);
 		else if (strcmp(opt->defname, "timing") == 0)
 		{
 			timing_set = true;
@@ -206,6 +211,15 @@ ExplainQuery(ParseState *pstate, ExplainStmt *stmt, const char *queryString,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 				 errmsg("EXPLAIN option BUFFERS requires ANALYZE")));
 
+	if (es->dist && !es->analyze)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("EXPLAIN option DIST requires ANALYZE")));
+
+	/* There is no distributed storage to report on without YugaByte */
+	if (!IsYugaByteEnabled())
+		es->dist = false;
+
 	/* if the timing was not set explicitly, set default value */
 	es->timing = (timing_set) ? es->timing : es->analyze;
 
@@ -531,11 +545,31 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 		else
 			dir = ForwardScanDirection;
 
-		/* run the plan */
-		ExecutorRun(queryDesc, dir, 0L, true);
+		/*
+		 * Collect the storage metrics of the reads the plan does, and make
+		 * sure the collection stops if it fails.
+		 */
+		if (es->dist)
+			YBCPgSetStorageMetricsEnabled(true);
+
+		PG_TRY();
+		{
+			/* run the plan */
+			ExecutorRun(queryDesc, dir, 0L, true);
+
+			/* run cleanup too */
+			ExecutorFinish(queryDesc);
+		}
+		PG_CATCH();
+		{
+			if (es->dist)
+				YBCPgSetStorageMetricsEnabled(false);
+			PG_RE_THROW();
+		}
+		PG_END_TRY();
 
-		/* run cleanup too */
-		ExecutorFinish(queryDesc);
+		if (es->dist)
+			YBCPgSetStorageMetricsEnabled(false);
 
 		/* We can't run ExecutorEnd 'till we're done printing the stats... */
 		totaltime += elapsed_time(&starttime);
@@ -557,6 +591,9 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 	if (es->analyze)
 		ExplainPrintTriggers(es, queryDesc);
 
+	if (es->dist)
+		YbExplainPrintStorageMetrics(es);
+
 	/*
 	 * Print info about JITing. Tied to es->costs because we don't want to
 	 * display this in regression tests, as it'd cause output differences
@@ -912,6 +949,53 @@ elapsed_time(instr_time *starttime)
 	return INSTR_TIME_GET_DOUBLE(endtime);
 }
 
+/*
+ * YbExplainPrintStorageMetrics -
+ *	  print the work done by the DocDB storage for the reads of the query,
+ *	  summed up over all the read requests and the tablets they went to
+ */
+static void
+YbExplainPrintStorageMetrics(ExplainState *es)
+{
+	YBCPgStorageMetrics metrics;
+
+	YBCPgGetStorageMetrics(&metrics);
+
+	ExplainOpenGroup("Storage", "Storage", true, es);
+	ExplainPropertyInteger("Storage Read Requests", NULL,
+						   metrics.read_requests, es);
+	ExplainPropertyInteger("Storage Seeks", NULL, metrics.seeks, es);
+	ExplainPropertyInteger("Storage Nexts", NULL, metrics.nexts, es);
+	ExplainPropertyInteger("Storage Prevs", NULL, metrics.prevs, es);
+	ExplainPropertyInteger("Storage Intents", NULL, metrics.intents, es);
+	ExplainPropertyInteger("Storage Internal Keys Skipped", NULL,
+						   metrics.internal_keys_skipped, es);
+	ExplainPropertyInteger("Storage Block Cache Hits", NULL,
+						   metrics.block_cache_hits, es);
+	ExplainPropertyInteger("Storage Block Reads", NULL,
+						   metrics.block_reads, es);
+	ExplainPropertyInteger("Storage Block Read Bytes", "bytes",
+						   metrics.block_read_bytes, es);
+	ExplainPropertyInteger("Storage Bloom Filter Checks", NULL,
+						   metrics.bloom_checks, es);
+	ExplainPropertyInteger("Storage Bloom Filter Skips", NULL,
+						   metrics.bloom_skips, es);
+	if (es->timing)
+	{
+		ExplainPropertyFloat("Storage Read Time", "ms",
+							 metrics.total_nanos / 1000000.0, 3, es);
+		ExplainPropertyFloat("Storage Seek Time", "ms",
+							 metrics.seek_nanos / 1000000.0, 3, es);
+		ExplainPropertyFloat("Storage Next Time", "ms",
+							 metrics.next_nanos / 1000000.0, 3, es);
+		ExplainPropertyFloat("Storage Block Read Time", "ms",
+							 metrics.block_read_nanos / 1000000.0, 3, es);
+		ExplainPropertyFloat("Storage Block Decompress Time", "ms",
+							 metrics.block_decompress_nanos / 1000000.0, 3, es);
+	}
+	ExplainCloseGroup("Storage", "Storage", true, es);
+}
+
 /*
  * ExplainPreScanNode -
  *	  Prescan the planstate tree to identify which RTEs are referenced
@@ -750,6 +750,38 @@ nextval_internal(Oid relid, bool check_permissions)
 	cycle = pgsform->seqcycle;
 	ReleaseSysCache(pgstuple);
 
+	if (IsYugaByteEnabled())
+	{
+		/*
+		 * Try to get the values from the node-wide cache of the local tablet server first, so
+		 * backends of the node do not contend on the sequence row. If it does not hand out any
+		 * values, e.g. because the sequence reached its bound, update the sequence below.
+		 */
+		int64_t first_val;
+		int64_t last_val;
+		bool allocated = false;
+		HandleYBStatus(YBCAllocateSequenceValues(MyDatabaseId,
+												 relid,
+												 yb_catalog_cache_version,
+												 incby,
+												 minv,
+												 maxv,
+												 cache,
+												 &first_val,
+												 &last_val,
+												 &allocated));
+		if (allocated)
+		{
+			elm->increment = incby;
+			elm->last = first_val;
+			elm->cached = last_val;
+			elm->last_valid = true;
+			last_used_seq = elm;
+			relation_close(seqrel, NoLock);
+			return first_val;
+		}
+	}
+
 retry:
 	rescnt = 0;
 	if (IsYugaByteEnabled())
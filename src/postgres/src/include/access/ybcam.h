@@ -141,6 +141,12 @@ void ybcEndScan(YbScanDesc ybScan);
 #define YBC_HASH_SCAN_SELECTIVITY	(10.0 / YBC_DEFAULT_NUM_ROWS)
 #define YBC_FULL_SCAN_SELECTIVITY	1.0
 
+/*
+ * Cost of reading a row of the base table by its ybctid after reading it from a secondary index,
+ * in units of cpu_tuple_cost.
+ */
+#define YBC_BASE_TABLE_LOOKUP_COST_FACTOR	1.0
+
 extern void ybcCostEstimate(RelOptInfo *baserel, Selectivity selectivity,
 							Cost *startup_cost, Cost *total_cost);
 extern void ybcIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
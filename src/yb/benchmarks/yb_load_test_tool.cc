@@ -14,6 +14,7 @@
 #include <queue>
 #include <set>
 #include <atomic>
+#include <iostream>
 
 #include <glog/logging.h>
 #include <boost/bind.hpp>
@@ -23,6 +24,7 @@
 #include "yb/client/meta_cache.h"
 #include "yb/client/table_creator.h"
 #include "yb/client/table_handle.h"
+#include "yb/client/transaction_manager.h"
 #include "yb/common/partition.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
@@ -33,6 +35,7 @@
 #include "yb/master/master.h"
 #include "yb/master/master.pb.h"
 #include "yb/master/master_util.h"
+#include "yb/server/hybrid_clock.h"
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
 #include "yb/util/flags.h"
@@ -41,7 +44,10 @@
 #include "yb/util/subprocess.h"
 #include "yb/util/threadpool.h"
 
+#include "yb/benchmarks/ysql_open_loop.h"
+
 #include "yb/integration-tests/load_generator.h"
+#include "yb/integration-tests/open_loop_load.h"
 
 DEFINE_int32(rpc_timeout_sec, 30, "Timeout for RPC calls, in seconds");
 
@@ -129,6 +135,49 @@ using yb::YBPartialRow;
 using yb::TableType;
 using yb::YQLDatabase;
 
+DEFINE_double(open_loop_requests_per_sec, 0,
+              "If positive, issue the requests at this fixed rate instead of running the closed "
+              "loop writers and readers, and report the latencies measured from the times the "
+              "requests were scheduled.");
+
+DEFINE_int32(open_loop_duration_sec, 60, "Duration of the open loop load.");
+
+DEFINE_int32(open_loop_threads, 32,
+             "Number of threads issuing the open loop requests, each with its own session or "
+             "connection.");
+
+DEFINE_int32(open_loop_read_weight, 80, "Relative frequency of the open loop reads.");
+DEFINE_int32(open_loop_write_weight, 20, "Relative frequency of the open loop writes.");
+DEFINE_int32(open_loop_scan_weight, 0, "Relative frequency of the open loop scans.");
+DEFINE_int32(open_loop_transaction_weight, 0,
+             "Relative frequency of the open loop multi-key transactions. For YCQL the table is "
+             "created transactional.");
+
+DEFINE_string(open_loop_key_distribution, "zipfian",
+              "Distribution of the keys of the open loop requests over num_rows keys: uniform, "
+              "zipfian, hotspot or latest.");
+
+DEFINE_double(open_loop_zipfian_constant, 0.99,
+              "Skew of the zipfian and latest key distributions.");
+
+DEFINE_double(open_loop_hotspot_key_fraction, 0.2,
+              "Fraction of the keys that are hot for the hotspot key distribution.");
+
+DEFINE_double(open_loop_hotspot_access_fraction, 0.8,
+              "Fraction of the requests that go to the hot keys for the hotspot key distribution.");
+
+DEFINE_int32(open_loop_scan_length, 100, "Number of rows read by an open loop scan.");
+
+DEFINE_int32(open_loop_transaction_keys, 2, "Number of keys written by an open loop transaction.");
+
+DEFINE_int32(open_loop_report_interval_sec, 1,
+             "Period of the open loop latency time series written to stdout.");
+
+DEFINE_string(open_loop_driver, "ycql", "API the open loop load uses: ycql or ysql.");
+
+DEFINE_string(open_loop_ysql_address, "127.0.0.1:5433",
+              "Address of the postgres server used by the ysql open loop driver.");
+
 using strings::Substitute;
 
 using yb::load_generator::KeyIndexSet;
@@ -141,6 +190,41 @@ using yb::load_generator::MultiThreadedReader;
 using yb::load_generator::MultiThreadedWriter;
 using yb::load_generator::SingleThreadedScanner;
 using yb::load_generator::FormatHexForLoadTestKey;
+using yb::load_generator::OpenLoopLoad;
+using yb::load_generator::OpenLoopOptions;
+using yb::load_generator::OpenLoopOpType;
+using yb::load_generator::OpenLoopSessionFactory;
+
+namespace {
+
+yb::Result<yb::HostPort> YsqlAddress() {
+  return yb::HostPort::FromString(FLAGS_open_loop_ysql_address, 5433);
+}
+
+OpenLoopOptions OpenLoopOptionsFromFlags() {
+  OpenLoopOptions options;
+  options.requests_per_sec = FLAGS_open_loop_requests_per_sec;
+  options.duration = MonoDelta::FromSeconds(FLAGS_open_loop_duration_sec);
+  options.num_threads = FLAGS_open_loop_threads;
+  options.num_keys = FLAGS_num_rows;
+  options.value_size = FLAGS_value_size_bytes;
+  options.weights[yb::to_underlying(OpenLoopOpType::read)] = FLAGS_open_loop_read_weight;
+  options.weights[yb::to_underlying(OpenLoopOpType::write)] = FLAGS_open_loop_write_weight;
+  options.weights[yb::to_underlying(OpenLoopOpType::scan)] = FLAGS_open_loop_scan_weight;
+  options.weights[yb::to_underlying(OpenLoopOpType::transaction)] =
+      FLAGS_open_loop_transaction_weight;
+  options.key_distribution = CHECK_RESULT(
+      yb::load_generator::ParseOpenLoopKeyDistribution(FLAGS_open_loop_key_distribution));
+  options.zipfian_constant = FLAGS_open_loop_zipfian_constant;
+  options.hotspot_key_fraction = FLAGS_open_loop_hotspot_key_fraction;
+  options.hotspot_access_fraction = FLAGS_open_loop_hotspot_access_fraction;
+  options.scan_length = FLAGS_open_loop_scan_length;
+  options.transaction_keys = FLAGS_open_loop_transaction_keys;
+  options.report_interval = MonoDelta::FromSeconds(FLAGS_open_loop_report_interval_sec);
+  return options;
+}
+
+} // namespace
 
 // ------------------------------------------------------------------------------------------------
 
@@ -150,6 +234,8 @@ void CreateYBTable(const YBTableName &table_name, YBClient* client);
 
 void LaunchYBLoadTest(SessionFactory *session_factory);
 
+void LaunchOpenLoopLoadTest(YBClient* client);
+
 std::unique_ptr<YBClient> CreateYBClient();
 
 void SetupYBTable(YBClient* client);
@@ -183,7 +269,9 @@ int main(int argc, char *argv[]) {
 
   for (int i = 0; i < FLAGS_num_iter; ++i) {
     auto client = CreateYBClient();
-    if (!use_redis_table) {
+    if (FLAGS_open_loop_requests_per_sec > 0 && !use_redis_table) {
+      LaunchOpenLoopLoadTest(client.get());
+    } else if (!use_redis_table) {
       const YBTableName table_name(yb::YQL_DATABASE_CQL, "my_keyspace", FLAGS_table_name);
       SetupYBTable(client.get());
 
@@ -289,6 +377,11 @@ void CreateYBTable(const YBTableName &table_name, YBClient* client) {
   YBSchemaBuilder schemaBuilder;
   schemaBuilder.AddColumn("k")->PrimaryKey()->Type(yb::BINARY)->NotNull();
   schemaBuilder.AddColumn("v")->Type(yb::BINARY)->NotNull();
+  if (FLAGS_open_loop_requests_per_sec > 0 && FLAGS_open_loop_transaction_weight > 0) {
+    yb::TableProperties table_properties;
+    table_properties.SetTransactional(true);
+    schemaBuilder.SetTableProperties(table_properties);
+  }
   YBSchema schema;
   CHECK_OK(schemaBuilder.Build(&schema));
 
@@ -364,3 +457,36 @@ void LaunchYBLoadTest(SessionFactory *session_factory) {
     reader.WaitForCompletion();
   }
 }
+
+void LaunchOpenLoopLoadTest(YBClient* client) {
+  LOG(INFO) << "Starting open loop load test at " << FLAGS_open_loop_requests_per_sec
+            << " requests per second";
+
+  const auto options = OpenLoopOptionsFromFlags();
+  OpenLoopSessionFactory session_factory;
+  yb::client::TableHandle table;
+  yb::server::ClockPtr clock;
+  std::unique_ptr<yb::client::TransactionManager> transaction_manager;
+  if (FLAGS_open_loop_driver == "ysql") {
+    const auto host_port = CHECK_RESULT(YsqlAddress());
+    CHECK_OK(yb::load_generator::CreateYsqlOpenLoopTable(host_port, FLAGS_table_name));
+    session_factory = yb::load_generator::YsqlOpenLoopSessionFactory(host_port, FLAGS_table_name);
+  } else if (FLAGS_open_loop_driver == "ycql") {
+    SetupYBTable(client);
+    const YBTableName table_name(yb::YQL_DATABASE_CQL, "my_keyspace", FLAGS_table_name);
+    CHECK_OK(table.Open(table_name, client));
+    if (options.weights[yb::to_underlying(OpenLoopOpType::transaction)] > 0) {
+      clock.reset(new yb::server::HybridClock());
+      CHECK_OK(clock->Init());
+      transaction_manager = std::make_unique<yb::client::TransactionManager>(
+          client, clock, yb::client::LocalTabletFilter());
+    }
+    session_factory = yb::load_generator::YcqlOpenLoopSessionFactory(
+        client, &table, transaction_manager.get());
+  } else {
+    LOG(FATAL) << "Unknown open loop driver: " << FLAGS_open_loop_driver;
+  }
+
+  OpenLoopLoad load(options, std::move(session_factory));
+  CHECK_OK(load.Run(&std::cout));
+}
@@ -0,0 +1,490 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+// Runs the standard workloads against a local ExternalMiniCluster for a fixed duration and writes
+// a JSON baseline with the throughput and latency percentiles of each workload, and the CPU time
+// and memory of each server process, so the consecutive builds could be compared.
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/benchmarks/ysql_open_loop.h"
+
+#include "yb/client/client.h"
+#include "yb/client/schema.h"
+#include "yb/client/table_creator.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/transaction_manager.h"
+
+#include "yb/gutil/strings/split.h"
+
+#include "yb/integration-tests/external_mini_cluster.h"
+#include "yb/integration-tests/open_loop_load.h"
+
+#include "yb/server/hybrid_clock.h"
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/env.h"
+#include "yb/util/flags.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/logging.h"
+#include "yb/util/path_util.h"
+
+DEFINE_string(perf_workloads, "ycql_read_write,ycql_transaction,ysql_read_write",
+              "Comma separated workloads to run one after another: ycql_read_write, ycql_write, "
+              "ycql_scan, ycql_transaction, ysql_read_write, ysql_write, ysql_scan or "
+              "ysql_transaction.");
+DEFINE_int32(perf_num_masters, 1, "Number of masters of the cluster.");
+DEFINE_int32(perf_num_tablet_servers, 3, "Number of tablet servers of the cluster.");
+DEFINE_int32(perf_num_tablets, 0,
+             "Number of tablets of the tables of the workloads, 0 to use the default of the "
+             "master.");
+DEFINE_string(perf_master_flags, "",
+              "Space separated extra flags of the masters, e.g. "
+              "\"--enable_load_balancing=false\".");
+DEFINE_string(perf_tserver_flags, "", "Space separated extra flags of the tablet servers.");
+DEFINE_double(perf_requests_per_sec, 1000, "Total rate of the requests of each workload.");
+DEFINE_int32(perf_duration_sec, 60, "Duration of each workload, after the preload.");
+DEFINE_int32(perf_threads, 32, "Number of threads issuing the requests of each workload.");
+DEFINE_int64(perf_num_keys, 100000, "Number of keys the workloads write and read.");
+DEFINE_int32(perf_value_size, 16, "Size of the values written by the workloads.");
+DEFINE_string(perf_key_distribution, "zipfian",
+              "Distribution of the keys of the requests: uniform, zipfian, hotspot or latest.");
+DEFINE_string(perf_label, "",
+              "Label of the run written to the baseline, e.g. the commit it was built from.");
+DEFINE_string(perf_output_file, "",
+              "File to write the JSON baseline to, the standard output if empty.");
+DEFINE_string(perf_time_series_dir, "",
+              "If set, the per second CSV time series of each workload is written to "
+              "<dir>/<workload>.csv.");
+DEFINE_string(perf_data_root, "",
+              "Data directory of the cluster, a new directory in the test directory if empty.");
+
+namespace yb {
+namespace load_generator {
+
+namespace {
+
+constexpr auto kCqlKeyspace = "perf";
+const MonoDelta kProcessSampleInterval = MonoDelta::FromSeconds(1);
+
+// A standard workload, i.e. a mix of the requests of an open loop load through a driver.
+struct PerfWorkload {
+  const char* name;
+  bool ysql;
+  int weights[kElementsInOpenLoopOpType];
+};
+
+const PerfWorkload kPerfWorkloads[] = {
+  {"ycql_read_write", false, {80, 20, 0, 0}},
+  {"ycql_write", false, {0, 100, 0, 0}},
+  {"ycql_scan", false, {0, 0, 100, 0}},
+  {"ycql_transaction", false, {0, 0, 0, 100}},
+  {"ysql_read_write", true, {80, 20, 0, 0}},
+  {"ysql_write", true, {0, 100, 0, 0}},
+  {"ysql_scan", true, {0, 0, 100, 0}},
+  {"ysql_transaction", true, {0, 0, 0, 100}},
+};
+
+Result<std::vector<const PerfWorkload*>> ParseWorkloads(const std::string& names) {
+  std::vector<const PerfWorkload*> result;
+  for (const auto& name : strings::Split(names, ",", strings::SkipEmpty())) {
+    auto it = std::find_if(std::begin(kPerfWorkloads), std::end(kPerfWorkloads),
+                           [&name](const PerfWorkload& workload) {
+      return name == workload.name;
+    });
+    if (it == std::end(kPerfWorkloads)) {
+      return STATUS_FORMAT(InvalidArgument, "Unknown workload: $0", name.ToString());
+    }
+    result.push_back(&*it);
+  }
+  if (result.empty()) {
+    return STATUS(InvalidArgument, "No workloads specified");
+  }
+  return result;
+}
+
+std::vector<std::string> SplitFlags(const std::string& flags) {
+  return strings::Split(flags, " ", strings::SkipEmpty());
+}
+
+struct ProcessSample {
+  double cpu_sec = 0;
+  uint64_t rss_bytes = 0;
+};
+
+// Reads the CPU time the process used so far and its resident set size.
+Result<ProcessSample> SampleProcess(pid_t pid) {
+#if defined(__linux__)
+  std::string stat;
+  RETURN_NOT_OK(ReadFileToString(Env::Default(), Format("/proc/$0/stat", pid), &stat));
+  // The command could contain spaces, so the fields are counted from its closing parenthesis,
+  // the state being the third field, and the user and system CPU time the 14th and 15th.
+  const auto command_end = stat.rfind(')');
+  if (command_end == std::string::npos) {
+    return STATUS_FORMAT(Corruption, "Unexpected stat of $0: $1", pid, stat);
+  }
+  std::vector<std::string> fields = strings::Split(
+      GStringPiece(stat).substr(command_end + 1), " ", strings::SkipEmpty());
+  if (fields.size() < 13) {
+    return STATUS_FORMAT(Corruption, "Unexpected stat of $0: $1", pid, stat);
+  }
+  std::string statm;
+  RETURN_NOT_OK(ReadFileToString(Env::Default(), Format("/proc/$0/statm", pid), &statm));
+  std::vector<std::string> statm_fields = strings::Split(statm, " ", strings::SkipEmpty());
+  if (statm_fields.size() < 2) {
+    return STATUS_FORMAT(Corruption, "Unexpected statm of $0: $1", pid, statm);
+  }
+
+  ProcessSample result;
+  result.cpu_sec = static_cast<double>(std::stoull(fields[11]) + std::stoull(fields[12])) /
+                   sysconf(_SC_CLK_TCK);
+  result.rss_bytes = std::stoull(statm_fields[1]) * sysconf(_SC_PAGESIZE);
+  return result;
+#else
+  return STATUS(NotSupported, "Process stats are only read from procfs");
+#endif
+}
+
+// Samples the CPU time and memory of the server processes while a workload runs.
+class ProcessMonitor {
+ public:
+  struct Process {
+    std::string name;
+    pid_t pid;
+    ProcessSample start;
+    ProcessSample end;
+    uint64_t peak_rss_bytes = 0;
+    bool sampled = false;
+  };
+
+  explicit ProcessMonitor(const ExternalMiniCluster& cluster) {
+    for (int i = 0; i != cluster.num_masters(); ++i) {
+      processes_.push_back(Process{cluster.master(i)->id(), cluster.master(i)->pid()});
+    }
+    for (int i = 0; i != cluster.num_tablet_servers(); ++i) {
+      processes_.push_back(
+          Process{cluster.tablet_server(i)->id(), cluster.tablet_server(i)->pid()});
+    }
+  }
+
+  ~ProcessMonitor() {
+    Stop();
+  }
+
+  void Start() {
+    for (auto& process : processes_) {
+      auto sample = SampleProcess(process.pid);
+      if (!sample.ok()) {
+        LOG(WARNING) << "Failed to sample " << process.name << ": " << sample.status();
+        continue;
+      }
+      process.start = process.end = *sample;
+      process.peak_rss_bytes = sample->rss_bytes;
+      process.sampled = true;
+    }
+    start_ = MonoTime::Now();
+    thread_ = std::thread([this] {
+      while (!stop_latch_.WaitFor(kProcessSampleInterval)) {
+        Sample();
+      }
+    });
+  }
+
+  void Stop() {
+    if (!thread_.joinable()) {
+      return;
+    }
+    stop_latch_.CountDown();
+    thread_.join();
+    Sample();
+    end_ = MonoTime::Now();
+  }
+
+  const std::vector<Process>& processes() const {
+    return processes_;
+  }
+
+  MonoDelta elapsed() const {
+    return end_ - start_;
+  }
+
+ private:
+  void Sample() {
+    for (auto& process : processes_) {
+      if (!process.sampled) {
+        continue;
+      }
+      auto sample = SampleProcess(process.pid);
+      if (!sample.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 10) << "Failed to sample " << process.name << ": "
+                                         << sample.status();
+        continue;
+      }
+      process.end = *sample;
+      process.peak_rss_bytes = std::max(process.peak_rss_bytes, sample->rss_bytes);
+    }
+  }
+
+  std::vector<Process> processes_;
+  CountDownLatch stop_latch_{1};
+  std::thread thread_;
+  MonoTime start_;
+  MonoTime end_;
+};
+
+CHECKED_STATUS CreateYcqlTable(
+    client::YBClient* client, const client::YBTableName& table_name, bool transactional) {
+  client::YBSchemaBuilder schema_builder;
+  schema_builder.AddColumn("k")->PrimaryKey()->Type(BINARY)->NotNull();
+  schema_builder.AddColumn("v")->Type(BINARY)->NotNull();
+  if (transactional) {
+    TableProperties table_properties;
+    table_properties.SetTransactional(true);
+    schema_builder.SetTableProperties(table_properties);
+  }
+  client::YBSchema schema;
+  RETURN_NOT_OK(schema_builder.Build(&schema));
+
+  std::unique_ptr<client::YBTableCreator> table_creator(client->NewTableCreator());
+  table_creator->table_name(table_name)
+      .schema(&schema)
+      .table_type(client::YBTableType::YQL_TABLE_TYPE);
+  if (FLAGS_perf_num_tablets > 0) {
+    table_creator->num_tablets(FLAGS_perf_num_tablets);
+  }
+  return table_creator->Create();
+}
+
+void WriteLatencies(const HdrHistogram& histogram, JsonWriter* jw) {
+  const bool empty = histogram.TotalCount() == 0;
+  jw->String("mean_us");
+  jw->Double(empty ? 0 : histogram.MeanValue());
+  const std::pair<const char*, double> kPercentiles[] = {
+      {"p50_us", 50}, {"p90_us", 90}, {"p99_us", 99}, {"p99.9_us", 99.9}};
+  for (const auto& percentile : kPercentiles) {
+    jw->String(percentile.first);
+    jw->Uint64(empty ? 0 : histogram.ValueAtPercentile(percentile.second));
+  }
+  jw->String("max_us");
+  jw->Uint64(empty ? 0 : histogram.MaxValue());
+}
+
+CHECKED_STATUS RunWorkload(
+    const PerfWorkload& workload, ExternalMiniCluster* cluster, client::YBClient* client,
+    JsonWriter* jw) {
+  LOG(INFO) << "Running " << workload.name;
+
+  OpenLoopOptions options;
+  options.requests_per_sec = FLAGS_perf_requests_per_sec;
+  options.duration = MonoDelta::FromSeconds(FLAGS_perf_duration_sec);
+  options.num_threads = FLAGS_perf_threads;
+  options.num_keys = FLAGS_perf_num_keys;
+  options.value_size = FLAGS_perf_value_size;
+  std::copy(std::begin(workload.weights), std::end(workload.weights), options.weights);
+  options.key_distribution = VERIFY_RESULT(
+      ParseOpenLoopKeyDistribution(FLAGS_perf_key_distribution));
+  const bool transactional = workload.weights[to_underlying(OpenLoopOpType::transaction)] > 0;
+
+  const auto table_name = Format("perf_$0", workload.name);
+  OpenLoopSessionFactory session_factory;
+  client::TableHandle table;
+  server::ClockPtr clock;
+  std::unique_ptr<client::TransactionManager> transaction_manager;
+  if (workload.ysql) {
+    RETURN_NOT_OK(CreateYsqlOpenLoopTable(cluster->pgsql_hostport(0), table_name));
+    // The connections are spread over the postgres servers of all the nodes.
+    std::vector<OpenLoopSessionFactory> node_factories;
+    for (int i = 0; i != cluster->num_tablet_servers(); ++i) {
+      node_factories.push_back(
+          YsqlOpenLoopSessionFactory(cluster->pgsql_hostport(i), table_name));
+    }
+    session_factory = [node_factories, next = std::make_shared<size_t>(0)] {
+      return node_factories[(*next)++ % node_factories.size()]();
+    };
+  } else {
+    const client::YBTableName ycql_table_name(YQL_DATABASE_CQL, kCqlKeyspace, table_name);
+    RETURN_NOT_OK(CreateYcqlTable(client, ycql_table_name, transactional));
+    RETURN_NOT_OK(table.Open(ycql_table_name, client));
+    if (transactional) {
+      clock.reset(new server::HybridClock());
+      RETURN_NOT_OK(clock->Init());
+      transaction_manager = std::make_unique<client::TransactionManager>(
+          client, clock, client::LocalTabletFilter());
+    }
+    session_factory = YcqlOpenLoopSessionFactory(client, &table, transaction_manager.get());
+  }
+
+  ProcessMonitor monitor(*cluster);
+  options.on_start = [&monitor] { monitor.Start(); };
+  OpenLoopLoad load(options, std::move(session_factory));
+  if (FLAGS_perf_time_series_dir.empty()) {
+    std::ostringstream time_series;
+    RETURN_NOT_OK(load.Run(&time_series));
+  } else {
+    const auto path = JoinPathSegments(FLAGS_perf_time_series_dir,
+                                       Format("$0.csv", workload.name));
+    std::ofstream time_series(path);
+    if (!time_series) {
+      return STATUS_FORMAT(IOError, "Failed to open $0", path);
+    }
+    RETURN_NOT_OK(load.Run(&time_series));
+  }
+  monitor.Stop();
+  const auto elapsed_sec = monitor.elapsed().ToSeconds();
+
+  jw->StartObject();
+  jw->String("name");
+  jw->String(workload.name);
+  jw->String("ops");
+  jw->StartArray();
+  for (auto op_type : kOpenLoopOpTypeList) {
+    if (workload.weights[to_underlying(op_type)] <= 0) {
+      continue;
+    }
+    jw->StartObject();
+    jw->String("op");
+    jw->String(ToString(op_type));
+    jw->String("requests");
+    jw->Int64(load.num_requests(op_type));
+    jw->String("errors");
+    jw->Int64(load.num_errors(op_type));
+    jw->String("requests_per_sec");
+    jw->Double((load.num_requests(op_type) - load.num_errors(op_type)) / elapsed_sec);
+    WriteLatencies(load.latencies(op_type), jw);
+    jw->EndObject();
+  }
+  jw->EndArray();
+  jw->String("processes");
+  jw->StartArray();
+  for (const auto& process : monitor.processes()) {
+    if (!process.sampled) {
+      continue;
+    }
+    const auto cpu_sec = process.end.cpu_sec - process.start.cpu_sec;
+    jw->StartObject();
+    jw->String("name");
+    jw->String(process.name);
+    jw->String("cpu_sec");
+    jw->Double(cpu_sec);
+    jw->String("cpu_utilization");
+    jw->Double(cpu_sec / elapsed_sec);
+    jw->String("rss_bytes");
+    jw->Uint64(process.end.rss_bytes);
+    jw->String("peak_rss_bytes");
+    jw->Uint64(process.peak_rss_bytes);
+    jw->EndObject();
+  }
+  jw->EndArray();
+  jw->EndObject();
+  return Status::OK();
+}
+
+CHECKED_STATUS RunPerfHarness() {
+  const auto workloads = VERIFY_RESULT(ParseWorkloads(FLAGS_perf_workloads));
+
+  ExternalMiniClusterOptions opts;
+  opts.num_masters = FLAGS_perf_num_masters;
+  opts.num_tablet_servers = FLAGS_perf_num_tablet_servers;
+  opts.data_root = FLAGS_perf_data_root;
+  if (opts.data_root.empty()) {
+    opts.data_root = JoinPathSegments(VERIFY_RESULT(Env::Default()->GetTestDirectory()),
+                                      Format("yb_perf_harness.$0", getpid()));
+  }
+  // Flags given explicitly go last, so they override the defaults.
+  opts.extra_master_flags.push_back(
+      Format("--replication_factor=$0", std::min(opts.num_tablet_servers, 3)));
+  for (auto& flag : SplitFlags(FLAGS_perf_master_flags)) {
+    opts.extra_master_flags.push_back(std::move(flag));
+  }
+  opts.extra_tserver_flags = SplitFlags(FLAGS_perf_tserver_flags);
+  opts.enable_ysql = std::any_of(workloads.begin(), workloads.end(),
+                                 [](const PerfWorkload* workload) { return workload->ysql; });
+
+  ExternalMiniCluster cluster(opts);
+  RETURN_NOT_OK(cluster.Start());
+  auto client = VERIFY_RESULT(cluster.CreateClient());
+  RETURN_NOT_OK(client->CreateNamespaceIfNotExists(kCqlKeyspace, YQL_DATABASE_CQL));
+
+  std::stringstream out;
+  {
+    JsonWriter jw(&out, JsonWriter::PRETTY);
+    jw.StartObject();
+    jw.String("label");
+    jw.String(FLAGS_perf_label);
+    jw.String("num_masters");
+    jw.Int(opts.num_masters);
+    jw.String("num_tablet_servers");
+    jw.Int(opts.num_tablet_servers);
+    jw.String("master_flags");
+    jw.String(FLAGS_perf_master_flags);
+    jw.String("tserver_flags");
+    jw.String(FLAGS_perf_tserver_flags);
+    jw.String("target_requests_per_sec");
+    jw.Double(FLAGS_perf_requests_per_sec);
+    jw.String("duration_sec");
+    jw.Int(FLAGS_perf_duration_sec);
+    jw.String("threads");
+    jw.Int(FLAGS_perf_threads);
+    jw.String("num_keys");
+    jw.Int64(FLAGS_perf_num_keys);
+    jw.String("key_distribution");
+    jw.String(FLAGS_perf_key_distribution);
+    jw.String("workloads");
+    jw.StartArray();
+    for (const auto* workload : workloads) {
+      RETURN_NOT_OK_PREPEND(RunWorkload(*workload, &cluster, client.get(), &jw),
+                            Format("Workload $0 failed", workload->name));
+    }
+    jw.EndArray();
+    jw.EndObject();
+  }
+  cluster.Shutdown();
+
+  out << std::endl;
+  if (FLAGS_perf_output_file.empty()) {
+    std::cout << out.str();
+    return Status::OK();
+  }
+  return WriteStringToFile(Env::Default(), out.str(), FLAGS_perf_output_file);
+}
+
+} // namespace
+} // namespace load_generator
+} // namespace yb
+
+int main(int argc, char** argv) {
+  gflags::SetUsageMessage(
+      "Usage:\n"
+      "    yb_perf_harness --perf_workloads ycql_read_write,ysql_read_write "
+      "--perf_output_file baseline.json");
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+
+  auto status = yb::load_generator::RunPerfHarness();
+  if (!status.ok()) {
+    LOG(ERROR) << "Perf harness failed: " << status;
+    return 1;
+  }
+  return 0;
+}
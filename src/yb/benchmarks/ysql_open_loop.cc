@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/benchmarks/ysql_open_loop.h"
+
+#include "yb/yql/pgwrapper/libpq_utils.h"
+
+namespace yb {
+namespace load_generator {
+
+namespace {
+
+// Open loop session of a YSQL connection.
+class YsqlOpenLoopSession : public OpenLoopSession {
+ public:
+  YsqlOpenLoopSession(pgwrapper::PGConn conn, const std::string& table_name)
+      : conn_(std::move(conn)), table_name_(table_name) {}
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    return conn_.FetchFormat("SELECT k, v FROM $0 WHERE k = '$1'", table_name_, key).status();
+  }
+
+  CHECKED_STATUS Write(const std::string& key, const std::string& value) override {
+    return conn_.ExecuteFormat(
+        "INSERT INTO $0 (k, v) VALUES ('$1', '$2') ON CONFLICT (k) DO UPDATE SET v = EXCLUDED.v",
+        table_name_, key, value);
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int limit) override {
+    return conn_.FetchFormat("SELECT k, v FROM $0 WHERE k >= '$1' LIMIT $2",
+                             table_name_, start_key, limit).status();
+  }
+
+  CHECKED_STATUS Transaction(
+      const std::vector<std::pair<std::string, std::string>>& key_values) override {
+    RETURN_NOT_OK(conn_.StartTransaction(IsolationLevel::SNAPSHOT_ISOLATION));
+    auto status = [this, &key_values]() -> Status {
+      for (const auto& key_value : key_values) {
+        RETURN_NOT_OK(Write(key_value.first, key_value.second));
+      }
+      return conn_.CommitTransaction();
+    }();
+    if (!status.ok()) {
+      WARN_NOT_OK(conn_.RollbackTransaction(), "Failed to roll back");
+    }
+    return status;
+  }
+
+ private:
+  pgwrapper::PGConn conn_;
+  const std::string table_name_;
+};
+
+} // namespace
+
+Status CreateYsqlOpenLoopTable(const HostPort& host_port, const std::string& table_name) {
+  auto conn = VERIFY_RESULT(pgwrapper::PGConn::Connect(host_port));
+  return conn.ExecuteFormat("CREATE TABLE IF NOT EXISTS $0 (k TEXT PRIMARY KEY, v TEXT)",
+                            table_name);
+}
+
+OpenLoopSessionFactory YsqlOpenLoopSessionFactory(
+    const HostPort& host_port, const std::string& table_name) {
+  return [host_port, table_name]() -> Result<std::unique_ptr<OpenLoopSession>> {
+    return std::unique_ptr<OpenLoopSession>(new YsqlOpenLoopSession(
+        VERIFY_RESULT(pgwrapper::PGConn::Connect(host_port)), table_name));
+  };
+}
+
+} // namespace load_generator
+} // namespace yb
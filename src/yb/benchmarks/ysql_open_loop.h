@@ -0,0 +1,39 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_BENCHMARKS_YSQL_OPEN_LOOP_H
+#define YB_BENCHMARKS_YSQL_OPEN_LOOP_H
+
+#include <string>
+
+#include "yb/integration-tests/open_loop_load.h"
+
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+namespace load_generator {
+
+// Creates the YSQL table with the same columns as the YCQL table of the load test tool, a text
+// primary key k and a text column v, if it does not exist.
+CHECKED_STATUS CreateYsqlOpenLoopTable(const HostPort& host_port, const std::string& table_name);
+
+// Creates the sessions of the table above, each with its own connection to the given postgres
+// server.
+OpenLoopSessionFactory YsqlOpenLoopSessionFactory(
+    const HostPort& host_port, const std::string& table_name);
+
+} // namespace load_generator
+} // namespace yb
+
+#endif // YB_BENCHMARKS_YSQL_OPEN_LOOP_H
@@ -12,12 +12,17 @@
 //
 
 #include "yb/client/async_rpc.h"
+
+#include <atomic>
+#include <mutex>
+
 #include "yb/client/batcher.h"
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
 #include "yb/client/table.h"
+#include "yb/client/write_combiner.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/common/pgsql_error.h"
@@ -27,9 +32,15 @@
 
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/master/sys_catalog_constants.h"
+
 #include "yb/util/cast.h"
+#include "yb/rpc/messenger.h"
+
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/trace_span.h"
 #include "yb/util/yb_pg_errcodes.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -50,6 +61,20 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, hedged_read_rpcs, "Hedged read RPCs", yb::MetricUnit::kRequests,
+    "Number of read requests copied to another replica because the first replica was slow to "
+    "respond");
+METRIC_DEFINE_counter(
+    server, hedged_read_rpcs_won, "Hedged read RPCs won", yb::MetricUnit::kRequests,
+    "Number of hedged read requests that were responded before the original request");
+METRIC_DEFINE_histogram(
+    server, batcher_ops_per_rpc, "Operations per batcher RPC", yb::MetricUnit::kOperations,
+    "Number of operations sent to a tablet in a single RPC by the batcher", 100000LU, 2);
+METRIC_DEFINE_histogram(
+    server, batcher_lookup_wait_time, "Batcher tablet lookup wait time",
+    yb::MetricUnit::kMicroseconds,
+    "Microseconds a flushed batch waited for tablet lookups of its operations", 60000000LU, 2);
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -63,6 +88,34 @@ DEFINE_bool(detect_duplicates_for_retryable_requests, true,
             "Enable tracking of write requests that prevents the same write from being applied "
                 "twice.");
 
+DEFINE_bool(enable_hedged_reads, false,
+            "Whether a consistent prefix read, that was not responded in time by the selected "
+            "replica, should also be sent to another replica. The first response wins.");
+TAG_FLAG(enable_hedged_reads, advanced);
+TAG_FLAG(enable_hedged_reads, runtime);
+
+DEFINE_double(hedged_read_delay_percentile, 95,
+              "Percentile of remote read latency, after which a hedged read is sent.");
+TAG_FLAG(hedged_read_delay_percentile, advanced);
+TAG_FLAG(hedged_read_delay_percentile, runtime);
+
+DEFINE_int32(hedged_read_min_delay_ms, 5,
+             "Min delay before sending a hedged read, also used while there are not enough "
+             "remote reads to estimate the latency percentile.");
+TAG_FLAG(hedged_read_min_delay_ms, advanced);
+TAG_FLAG(hedged_read_min_delay_ms, runtime);
+
+DEFINE_int32(hedged_reads_max_in_flight, 100,
+             "Max number of hedged reads waiting for response, further reads are not hedged.");
+TAG_FLAG(hedged_reads_max_in_flight, advanced);
+TAG_FLAG(hedged_reads_max_in_flight, runtime);
+
+DEFINE_bool(follower_reads_see_session_writes, true,
+            "Whether reads with CONSISTENT_PREFIX consistency level served by followers should "
+            "see the writes previously done by the same session.");
+TAG_FLAG(follower_reads_see_session_writes, advanced);
+TAG_FLAG(follower_reads_see_session_writes, runtime);
+
 DEFINE_CAPABILITY(PickReadTimeAtTabletServer, 0x8284d67b);
 
 using namespace std::placeholders;
@@ -102,7 +155,11 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      hedged_read_rpcs(METRIC_hedged_read_rpcs.Instantiate(entity)),
+      hedged_read_rpcs_won(METRIC_hedged_read_rpcs_won.Instantiate(entity)),
+      batcher_ops_per_rpc(METRIC_batcher_ops_per_rpc.Instantiate(entity)),
+      batcher_lookup_wait_time(METRIC_batcher_lookup_wait_time.Instantiate(entity)) {
 }
 
 AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
@@ -124,10 +181,21 @@ AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
       data->allow_local_calls_in_curr_thread);
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    auto* parent_span = Trace::CurrentTrace()->span();
+    if (parent_span) {
+      // Times the tablet RPC with all its retries, the attempts are child spans of outbound calls.
+      auto span = TraceSpan::StartChild(parent_span, "TabletRpc");
+      span->SetAttribute("tablet_id", data->tablet->tablet_id());
+      span->SetAttribute("ops", std::to_string(ops_.size()));
+      trace_->set_span(std::move(span));
+    }
   }
 }
 
 AsyncRpc::~AsyncRpc() {
+  if (trace_->span()) {
+    trace_->span()->End();
+  }
   if (PREDICT_FALSE(FLAGS_rpc_dump_all_traces)) {
     LOG(INFO) << ToString() << " took "
               << MonoTime::Now().GetDeltaSince(start_).ToMicroseconds()
@@ -397,8 +465,11 @@ WriteRpc::WriteRpc(AsyncRpcData* data)
             << req_.ShortDebugString();
   }
 
+  // Combined writes are sent without the retryable request id, so it is not allocated for them.
+  const bool combine = WriteCombiner::Enabled() && WriteCombiner::CanCombine(req_);
+
   const auto& client_id = batcher_->client_id();
-  if (!client_id.IsNil() && FLAGS_detect_duplicates_for_retryable_requests) {
+  if (!combine && !client_id.IsNil() && FLAGS_detect_duplicates_for_retryable_requests) {
     auto temp = client_id.ToUInt64Pair();
     req_.set_client_id1(temp.first);
     req_.set_client_id2(temp.second);
@@ -431,9 +502,15 @@ void WriteRpc::CallRemoteMethod() {
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
 
-  tablet_invoker_.proxy()->WriteAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&WriteRpc::Finished, this, Status::OK()));
+  if (WriteCombiner::Enabled() && WriteCombiner::CanCombine(req_)) {
+    batcher_->write_combiner()->Write(
+        tablet_invoker_.proxy(), &req_, &resp_, PrepareController(),
+        std::bind(&WriteRpc::Finished, this, Status::OK()));
+  } else {
+    tablet_invoker_.proxy()->WriteAsync(
+        req_, &resp_, PrepareController(),
+        std::bind(&WriteRpc::Finished, this, Status::OK()));
+  }
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
@@ -574,6 +651,18 @@ ReadRpc::ReadRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
   TRACE_TO(trace_, "ReadRpc initiated to $0", data->tablet->tablet_id());
   req_.set_consistency_level(yb_consistency_level);
   req_.set_proxy_uuid(data->batcher->proxy_uuid());
+  if (yb_consistency_level == YBConsistencyLevel::CONSISTENT_PREFIX) {
+    const auto& staleness_bound = data->batcher->follower_read_staleness_bound();
+    if (staleness_bound.Initialized() && staleness_bound > MonoDelta::kZero) {
+      req_.set_max_staleness_ms(staleness_bound.ToMilliseconds());
+    }
+    if (FLAGS_follower_reads_see_session_writes) {
+      const auto last_write_ht = data->batcher->session_last_write_hybrid_time();
+      if (last_write_ht != HybridTime::kMin) {
+        req_.set_min_safe_time(last_write_ht.ToUint64());
+      }
+    }
+  }
 
   int ctr = 0;
   for (auto& op : ops_) {
@@ -638,18 +727,198 @@ ReadRpc::~ReadRpc() {
   }
 }
 
+namespace {
+
+// Returns whether the read is a read of the YSQL system catalog that the local tablet server
+// could serve from its node-wide catalog cache. Should match tserver::PgCatalogCache::IsCacheable.
+bool IsNodeCachedCatalogRead(const tserver::ReadRequestPB& req) {
+  return req.tablet_id() == master::kSysCatalogTabletId && !req.has_transaction() &&
+         req.pgsql_batch_size() == 1 && req.pgsql_batch(0).ysql_catalog_version() != 0 &&
+         !req.pgsql_batch(0).has_paging_state();
+}
+
+} // namespace
+
 void ReadRpc::CallRemoteMethod() {
   auto trace = trace_; // It is possible that we receive reply before returning from ReadAsync.
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
 
-  tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, PrepareController(),
-      std::bind(&ReadRpc::Finished, this, Status::OK()));
+  auto* controller = PrepareController();
+  const auto& catalog_reads_proxy = batcher_->catalog_reads_proxy();
+  if (catalog_reads_proxy && IsNodeCachedCatalogRead(req_)) {
+    // The local tablet server forwards the read to the master leader on cache miss, and passes
+    // its errors back, so they are handled as if the read was sent to the master directly.
+    catalog_reads_proxy->ReadAsync(
+        req_, &resp_, controller, std::bind(&ReadRpc::Finished, this, Status::OK()));
+    TRACE_TO(trace, "RpcDispatched Asynchronously");
+    return;
+  }
+  auto hedge_delay = HedgeDelay(controller->timeout());
+  if (hedge_delay) {
+    CallRemoteMethodHedged(hedge_delay);
+  } else {
+    tablet_invoker_.proxy()->ReadAsync(
+        req_, &resp_, controller,
+        std::bind(&ReadRpc::Finished, this, Status::OK()));
+  }
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+namespace {
+
+// Number of remote reads required to use their latency for calculating hedge delay.
+constexpr uint64_t kMinReadsForHedgeDelay = 100;
+
+constexpr size_t kPrimaryAttempt = 0;
+constexpr size_t kHedgedAttempt = 1;
+
+// Number of hedged reads waiting for response in this process, used to limit the extra load that
+// hedging could put on the cluster.
+std::atomic<int64_t> hedged_reads_in_flight{0};
+
+} // namespace
+
+// Read that could be sent to two replicas: the primary attempt goes to the replica selected by
+// the tablet invoker, while the hedged one goes to another replica. Responses are received to
+// separate buffers, and the winning one is moved to the ReadRpc, so the losing call could safely
+// complete after the ReadRpc is finished.
+struct ReadRpc::HedgedCall {
+  struct Attempt {
+    RemoteTabletServer* ts = nullptr;
+    rpc::RpcController controller;
+    tserver::ReadResponsePB resp;
+  };
+
+  std::mutex mutex;
+  // Number of attempts waiting for response.
+  size_t in_flight = 0;
+  // Set when the attempt that provides the outcome of the read is picked.
+  bool finished = false;
+  MonoDelta hedge_timeout;
+  // Copy of the request for the hedged attempt, since the original one is modified when the read
+  // is finished.
+  tserver::ReadRequestPB hedged_req;
+  Attempt attempts[2];
+};
+
+MonoDelta ReadRpc::HedgeDelay(MonoDelta timeout) const {
+  if (!FLAGS_enable_hedged_reads || !async_rpc_metrics_ || !tablet_invoker_.hedging_allowed()) {
+    return MonoDelta();
+  }
+
+  auto result = MonoDelta::FromMilliseconds(FLAGS_hedged_read_min_delay_ms);
+  const auto* histogram = async_rpc_metrics_->remote_read_rpc_time->histogram();
+  if (histogram->TotalCount() >= kMinReadsForHedgeDelay) {
+    result = std::max(result, MonoDelta::FromMicroseconds(
+        histogram->ValueAtPercentile(FLAGS_hedged_read_delay_percentile)));
+  }
+  return result < timeout ? result : MonoDelta();
+}
+
+void ReadRpc::CallRemoteMethodHedged(MonoDelta delay) {
+  auto call = std::make_shared<HedgedCall>();
+  auto timeout = retrier().controller().timeout();
+  call->hedge_timeout = timeout - delay;
+  call->in_flight = 1;
+  auto& primary = call->attempts[kPrimaryAttempt];
+  primary.controller.set_timeout(timeout);
+
+  // The read could be finished and destroyed as soon as it is sent, so prepare everything that is
+  // required to schedule the hedged attempt in advance.
+  auto* messenger = batcher_->messenger();
+  auto callback = HedgedAttemptCallback(call, kPrimaryAttempt);
+  std::weak_ptr<ReadRpc> weak_self = std::static_pointer_cast<ReadRpc>(shared_from_this());
+
+  tablet_invoker_.proxy()->ReadAsync(req_, &primary.resp, &primary.controller, callback);
+
+  auto task_id = messenger->ScheduleOnReactor(
+      [call, weak_self](const Status& status) {
+        auto self = weak_self.lock();
+        if (status.ok() && self) {
+          self->SendHedgedRequest(call);
+        }
+      },
+      delay, SOURCE_LOCATION(), messenger);
+  if (task_id == rpc::kInvalidTaskId) {
+    VLOG(1) << "Failed to schedule hedged read";
+  }
+}
+
+void ReadRpc::SendHedgedRequest(const std::shared_ptr<HedgedCall>& call) {
+  std::shared_ptr<tserver::TabletServerServiceProxy> proxy;
+  {
+    std::lock_guard<std::mutex> lock(call->mutex);
+    if (call->finished) {
+      return;
+    }
+    auto* ts = tablet_invoker_.SelectHedgeTabletServer();
+    if (!ts) {
+      return;
+    }
+    if (hedged_reads_in_flight.fetch_add(1, std::memory_order_acq_rel) >=
+            FLAGS_hedged_reads_max_in_flight) {
+      hedged_reads_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+      return;
+    }
+    TRACE_TO(trace_, "Send hedged read to $0", ts->ToString());
+    async_rpc_metrics_->hedged_read_rpcs->Increment();
+    ++call->in_flight;
+    call->attempts[kHedgedAttempt].ts = ts;
+    call->attempts[kHedgedAttempt].controller.set_timeout(call->hedge_timeout);
+    call->hedged_req = req_;
+    proxy = ts->proxy();
+  }
+
+  // Sent outside of the lock, since the callback could be invoked synchronously on failure.
+  auto& hedged = call->attempts[kHedgedAttempt];
+  proxy->ReadAsync(
+      call->hedged_req, &hedged.resp, &hedged.controller,
+      HedgedAttemptCallback(call, kHedgedAttempt));
+}
+
+rpc::ResponseCallback ReadRpc::HedgedAttemptCallback(
+    const std::shared_ptr<HedgedCall>& call, size_t attempt_idx) {
+  std::weak_ptr<ReadRpc> weak_self = std::static_pointer_cast<ReadRpc>(shared_from_this());
+  return [call, attempt_idx, weak_self] {
+    if (attempt_idx == kHedgedAttempt) {
+      hedged_reads_in_flight.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    {
+      std::lock_guard<std::mutex> lock(call->mutex);
+      --call->in_flight;
+      if (call->finished) {
+        return;
+      }
+      const auto& attempt = call->attempts[attempt_idx];
+      // A failed attempt lets the other one, if it is still in flight, provide the outcome.
+      if ((!attempt.controller.status().ok() || attempt.resp.has_error()) &&
+          call->in_flight != 0) {
+        return;
+      }
+      call->finished = true;
+    }
+    // The read is not finished until the outcome is picked, so it should be alive here.
+    auto self = weak_self.lock();
+    if (self) {
+      self->HedgedCallFinished(call.get(), attempt_idx);
+    }
+  };
+}
+
+void ReadRpc::HedgedCallFinished(HedgedCall* call, size_t attempt_idx) {
+  auto& attempt = call->attempts[attempt_idx];
+  if (attempt_idx == kHedgedAttempt) {
+    TRACE_TO(trace_, "Hedged read won");
+    async_rpc_metrics_->hedged_read_rpcs_won->Increment();
+    tablet_invoker_.HedgedRequestWon(attempt.ts);
+  }
+  resp_.Swap(&attempt.resp);
+  mutable_retrier()->mutable_controller()->ShareFinishedCall(attempt.controller);
+  Finished(Status::OK());
+}
+
 void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
   size_t redis_idx = 0;
   size_t ql_idx = 0;
@@ -44,6 +44,10 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Counter> hedged_read_rpcs;
+  scoped_refptr<Counter> hedged_read_rpcs_won;
+  scoped_refptr<Histogram> batcher_ops_per_rpc;
+  scoped_refptr<Histogram> batcher_lookup_wait_time;
 };
 
 struct AsyncRpcData {
@@ -169,9 +173,23 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   virtual ~ReadRpc();
 
  private:
+  struct HedgedCall;
+
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  // Returns delay after which a copy of the read should be sent to another replica, or
+  // uninitialized MonoDelta if the read should not be hedged.
+  MonoDelta HedgeDelay(MonoDelta timeout) const;
+
+  // Sends the read to the current replica, and schedules sending its copy to another replica after
+  // the delay, the first response wins.
+  void CallRemoteMethodHedged(MonoDelta delay);
+  void SendHedgedRequest(const std::shared_ptr<HedgedCall>& call);
+  rpc::ResponseCallback HedgedAttemptCallback(
+      const std::shared_ptr<HedgedCall>& call, size_t attempt_idx);
+  void HedgedCallFinished(HedgedCall* call, size_t attempt_idx);
 };
 
 }  // namespace internal
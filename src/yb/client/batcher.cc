@@ -70,6 +70,13 @@
 DEFINE_test_flag(bool, combine_batcher_errors, false,
                  "Whether combine errors into batcher status.");
 
+DEFINE_bool(batcher_send_resolved_ops_early, true,
+            "When a non transactional batch is flushed while tablet lookups of some of its "
+            "operations are still in progress, send operations whose tablets are already "
+            "resolved, instead of waiting for all lookups to finish.");
+TAG_FLAG(batcher_send_resolved_ops_early, advanced);
+TAG_FLAG(batcher_send_resolved_ops_early, runtime);
+
 using std::pair;
 using std::set;
 using std::unique_ptr;
@@ -254,6 +261,7 @@ void Batcher::FlushAsync(StatusFunctor callback) {
     state_ = BatcherState::kResolvingTablets;
     flush_callback_ = std::move(callback);
     deadline_ = ComputeDeadlineUnlocked();
+    flush_time_ = CoarseMonoClock::Now();
     operations_count = ops_.size();
   }
 
@@ -456,47 +464,121 @@ void Batcher::TransactionReady(const Status& status, const BatcherPtr& self) {
   }
 }
 
+namespace {
+
+// Sorts ops by tablet and group, keeping the user's order of ops within a group.
+void SortOps(InFlightOps* ops) {
+  std::sort(ops->begin(),
+            ops->end(),
+            [](const InFlightOpPtr& lhs, const InFlightOpPtr& rhs) {
+    if (lhs->tablet.get() == rhs->tablet.get()) {
+      auto lgroup = lhs->yb_op->group();
+      auto rgroup = rhs->yb_op->group();
+      if (lgroup != rgroup) {
+        return lgroup < rgroup;
+      }
+      return lhs->sequence_number_ < rhs->sequence_number_;
+    }
+    return lhs->tablet.get() < rhs->tablet.get();
+  });
+}
+
+} // namespace
+
 void Batcher::FlushBuffersIfReady() {
   // We're only ready to flush if both of the following conditions are true:
   // 1. The batcher is in the "resolving tablets" state (i.e. FlushAsync was called).
   // 2. All outstanding ops have finished lookup. Why? To avoid a situation
   //    where ops are flushed one by one as they finish lookup.
+  //
+  // But a single slow lookup should not delay the whole batch, so in a non transactional batch ops
+  // resolved by the time of flush are sent right away, and the rest when all lookups finished.
 
+  InFlightOps resolved_ops;
+  bool all_resolved = false;
   {
     std::lock_guard<decltype(mutex_)> lock(mutex_);
     if (outstanding_lookups_ != 0) {
       // FlushBuffersIfReady is also invoked when all lookups finished, so it ok to just return
       // here.
       VLOG(3) << "FlushBuffersIfReady: " << outstanding_lookups_ << " ops still in lookup";
+      if (state_ == BatcherState::kResolvingTablets && CanSendResolvedOpsUnlocked()) {
+        ExtractResolvedOpsUnlocked(&resolved_ops);
+      }
+    } else if (state_ != BatcherState::kResolvingTablets) {
       return;
+    } else {
+      state_ = BatcherState::kTransactionPrepare;
+      all_resolved = true;
+      if (async_rpc_metrics_) {
+        async_rpc_metrics_->batcher_lookup_wait_time->Increment(
+            ToMicroseconds(CoarseMonoClock::Now() - flush_time_));
+      }
     }
+  }
 
-    if (state_ != BatcherState::kResolvingTablets) {
-      return;
+  if (!all_resolved) {
+    if (!resolved_ops.empty()) {
+      SendResolvedOps(&resolved_ops);
     }
-
-    state_ = BatcherState::kTransactionPrepare;
+    return;
   }
 
   // All operations were added, and tablets for them were resolved.
   // So we could sort them.
-  std::sort(ops_queue_.begin(),
-            ops_queue_.end(),
-            [](const InFlightOpPtr& lhs, const InFlightOpPtr& rhs) {
-    if (lhs->tablet.get() == rhs->tablet.get()) {
-      auto lgroup = lhs->yb_op->group();
-      auto rgroup = rhs->yb_op->group();
-      if (lgroup != rgroup) {
-        return lgroup < rgroup;
-      }
-      return lhs->sequence_number_ < rhs->sequence_number_;
-    }
-    return lhs->tablet.get() < rhs->tablet.get();
-  });
+  SortOps(&ops_queue_);
 
   ExecuteOperations(Initial::kTrue);
 }
 
+bool Batcher::CanSendResolvedOpsUnlocked() const {
+  return FLAGS_batcher_send_resolved_ops_early && !transaction_ && !force_consistent_read_ &&
+         !sent_resolved_ops_ && !ops_queue_.empty();
+}
+
+void Batcher::ExtractResolvedOpsUnlocked(InFlightOps* ops) {
+  std::vector<const InFlightOp*> unresolved_ops;
+  for (const auto& op : ops_) {
+    if (op->state.load(std::memory_order_acquire) == InFlightOpState::kLookingUpTablet) {
+      unresolved_ops.push_back(op.get());
+    }
+  }
+
+  auto w = ops_queue_.begin();
+  for (auto& op : ops_queue_) {
+    const auto& partition = op->tablet->partition();
+    const auto& table_id = op->yb_op->table()->id();
+    bool keep = std::any_of(
+        unresolved_ops.begin(), unresolved_ops.end(),
+        [&partition, &table_id](const InFlightOp* unresolved_op) {
+      return unresolved_op->yb_op->table()->id() == table_id &&
+             partition.ContainsKey(unresolved_op->partition_key);
+    });
+    if (keep) {
+      *w++ = std::move(op);
+    } else {
+      ops->push_back(std::move(op));
+    }
+  }
+  ops_queue_.erase(w, ops_queue_.end());
+
+  if (!ops->empty()) {
+    sent_resolved_ops_ = true;
+  }
+}
+
+void Batcher::SendResolvedOps(InFlightOps* ops) {
+  VLOG(3) << "Sending " << ops->size() << " resolved ops before all lookups finished";
+  SortOps(ops);
+
+  boost::container::small_vector<std::shared_ptr<AsyncRpc>, 40> rpcs;
+  // The rest of the batch is sent by other RPCs, so the read should be consistent.
+  CreateRpcs(*ops, /* force_consistent_read= */ true, &rpcs);
+  for (const auto& rpc : rpcs) {
+    rpc->SendRpc();
+  }
+}
+
 void Batcher::ExecuteOperations(Initial initial) {
   auto transaction = this->transaction();
   if (transaction) {
@@ -531,26 +613,40 @@ void Batcher::ExecuteOperations(Initial initial) {
     return;
   }
 
-  const bool force_consistent_read = force_consistent_read_ || this->transaction();
+  const bool force_consistent_read =
+      force_consistent_read_ || this->transaction() || sent_resolved_ops_;
 
   const size_t ops_number = ops_queue_.size();
 
   // Use big enough value for preallocated storage, to avoid unnecessary allocations.
   boost::container::small_vector<std::shared_ptr<AsyncRpc>, 40> rpcs;
+  CreateRpcs(ops_queue_, force_consistent_read, &rpcs);
+
+  LOG_IF(DFATAL, ops_number != ops_queue_.size())
+    << "Ops queue was modified while creating RPCs";
+  ops_queue_.clear();
 
+  for (const auto& rpc : rpcs) {
+    rpc->SendRpc();
+  }
+}
+
+void Batcher::CreateRpcs(
+    const InFlightOps& ops, bool force_consistent_read,
+    boost::container::small_vector_base<std::shared_ptr<AsyncRpc>>* rpcs) {
   // Now flush the ops for each tablet.
-  auto start = ops_queue_.begin();
+  auto start = ops.begin();
   auto start_group = (**start).yb_op->group();
-  for (auto it = start; it != ops_queue_.end(); ++it) {
+  for (auto it = start; it != ops.end(); ++it) {
     auto it_group = (**it).yb_op->group();
     // Aggregate and flush the ops so far if either:
     //   - we reached the next tablet or group
     if ((**it).tablet.get() != (**start).tablet.get() ||
         start_group != it_group) {
       // Consistent read is not required when whole batch fits into one command.
-      bool need_consistent_read = force_consistent_read || start != ops_queue_.begin() ||
-                                  it != ops_queue_.end();
-      rpcs.push_back(CreateRpc(
+      bool need_consistent_read = force_consistent_read || start != ops.begin() ||
+                                  it != ops.end();
+      rpcs->push_back(CreateRpc(
           start->get()->tablet.get(), start, it, /* allow_local_calls_in_curr_thread */ false,
           need_consistent_read));
       start = it;
@@ -559,18 +655,10 @@ void Batcher::ExecuteOperations(Initial initial) {
   }
 
   // Consistent read is not required when whole batch fits into one command.
-  bool need_consistent_read = force_consistent_read || start != ops_queue_.begin();
-  rpcs.push_back(CreateRpc(
-      start->get()->tablet.get(), start, ops_queue_.end(),
+  bool need_consistent_read = force_consistent_read || start != ops.begin();
+  rpcs->push_back(CreateRpc(
+      start->get()->tablet.get(), start, ops.end(),
       allow_local_calls_in_curr_thread_, need_consistent_read));
-
-  LOG_IF(DFATAL, ops_number != ops_queue_.size())
-    << "Ops queue was modified while creating RPCs";
-  ops_queue_.clear();
-
-  for (const auto& rpc : rpcs) {
-    rpc->SendRpc();
-  }
 }
 
 rpc::Messenger* Batcher::messenger() const {
@@ -581,6 +669,14 @@ rpc::ProxyCache& Batcher::proxy_cache() const {
   return client_->proxy_cache();
 }
 
+WriteCombiner* Batcher::write_combiner() const {
+  return client_->data_->write_combiner_.get();
+}
+
+const std::shared_ptr<tserver::TabletServerServiceProxy>& Batcher::catalog_reads_proxy() const {
+  return client_->data_->catalog_reads_proxy_;
+}
+
 YBTransactionPtr Batcher::transaction() const {
   return transaction_;
 }
@@ -619,6 +715,9 @@ std::shared_ptr<AsyncRpc> Batcher::CreateRpc(
   // Split the read operations according to consistency levels since based on consistency
   // levels the read algorithm would differ.
   InFlightOps ops(begin, end);
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->batcher_ops_per_rpc->Increment(ops.size());
+  }
   auto op_group = (**begin).yb_op->group();
   AsyncRpcData data{this, tablet, allow_local_calls_in_curr_thread, need_consistent_read,
                     write_with_hybrid_time_, std::move(ops)};
@@ -688,6 +787,10 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
 
   if (s.ok() && rpc.resp().has_propagated_hybrid_time()) {
     client_->data_->UpdateLatestObservedHybridTime(rpc.resp().propagated_hybrid_time());
+    auto session = weak_session_.lock();
+    if (session) {
+      session->UpdateLastWriteHybridTime(HybridTime(rpc.resp().propagated_hybrid_time()));
+    }
   }
 
   // Check individual row errors.
@@ -710,6 +813,11 @@ void Batcher::ProcessWriteResponse(const WriteRpc &rpc, const Status &s) {
   }
 }
 
+HybridTime Batcher::session_last_write_hybrid_time() const {
+  auto session = weak_session_.lock();
+  return session ? session->last_write_hybrid_time() : HybridTime::kMin;
+}
+
 double Batcher::RejectionScore(int attempt_num) {
   if (!rejection_score_source_) {
     return 0.0;
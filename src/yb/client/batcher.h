@@ -36,6 +36,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 #include "yb/client/async_rpc.h"
 #include "yb/client/transaction.h"
 
@@ -54,6 +56,10 @@
 
 namespace yb {
 
+namespace tserver {
+class TabletServerServiceProxy;
+}
+
 namespace client {
 
 class YBClient;
@@ -154,6 +160,10 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   rpc::ProxyCache& proxy_cache() const;
 
+  WriteCombiner* write_combiner() const;
+
+  const std::shared_ptr<tserver::TabletServerServiceProxy>& catalog_reads_proxy() const;
+
   const std::shared_ptr<AsyncRpcMetrics>& async_rpc_metrics() const {
     return async_rpc_metrics_;
   }
@@ -192,6 +202,18 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
     rejection_score_source_ = rejection_score_source;
   }
 
+  void SetFollowerReadStalenessBound(MonoDelta value) {
+    follower_read_staleness_bound_ = value;
+  }
+
+  const MonoDelta& follower_read_staleness_bound() const {
+    return follower_read_staleness_bound_;
+  }
+
+  // Returns the max hybrid time of the writes of the session, see
+  // YBSession::last_write_hybrid_time.
+  HybridTime session_last_write_hybrid_time() const;
+
   double RejectionScore(int attempt_num);
 
   // This is a status error string used when there are multiple errors that need to be fetched
@@ -232,6 +254,21 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
       RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
       bool allow_local_calls_in_curr_thread, bool need_consistent_read);
 
+  // Creates RPCs for ops, that should be sorted by tablet and group, one RPC per tablet and group.
+  void CreateRpcs(
+      const InFlightOps& ops, bool force_consistent_read,
+      boost::container::small_vector_base<std::shared_ptr<AsyncRpc>>* rpcs);
+
+  // Whether ops whose tablets are resolved could be sent before lookups of all ops finished.
+  bool CanSendResolvedOpsUnlocked() const REQUIRES(mutex_);
+
+  // Moves resolved ops from ops_queue_ to ops, except ops to tablets that could also be the
+  // destination of ops still looking up their tablet, so ops to the same row stay ordered.
+  void ExtractResolvedOpsUnlocked(InFlightOps* ops) REQUIRES(mutex_);
+
+  // Sends the resolved ops, while lookups of other ops are still in progress.
+  void SendResolvedOps(InFlightOps* ops);
+
   // Calls/Schedules flush_callback_ and resets it to free resources.
   void RunCallback(const Status& s);
 
@@ -298,6 +335,13 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // After flushing, the absolute deadline for all in-flight ops.
   CoarseTimePoint deadline_;
 
+  // Time when the batch was flushed.
+  CoarseTimePoint flush_time_;
+
+  // Set when some ops were sent before lookups of all ops finished, so the rest of the ops should
+  // use the consistent read.
+  bool sent_resolved_ops_ = false;
+
   // Number of outstanding lookups across all in-flight ops.
   int outstanding_lookups_ = 0;
 
@@ -321,6 +365,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   RejectionScoreSourcePtr rejection_score_source_;
 
+  // Bound on staleness of reads served by followers, see YBSession::SetFollowerReadStalenessBound.
+  MonoDelta follower_read_staleness_bound_;
+
   DISALLOW_COPY_AND_ASSIGN(Batcher);
 };
 
@@ -73,6 +73,7 @@
 #include "yb/util/flags.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/thread_restrictions.h"
 
@@ -85,6 +86,13 @@ DEFINE_test_flag(bool, assert_local_tablet_server_selected, false, "Verify that
 DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "", "Verify that SelectTServer "
                  "selected a talet server in the AZ specified by this flag.");
 
+DEFINE_bool(load_aware_replica_selection, true,
+            "When a request could be served by any of several equally close replicas, send it to "
+            "the less loaded of two random ones, as estimated from latency of recent responses "
+            "and the number of requests in flight.");
+TAG_FLAG(load_aware_replica_selection, advanced);
+TAG_FLAG(load_aware_replica_selection, runtime);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -315,6 +323,25 @@ YBClient::Data::~Data() {
   rpcs_.Shutdown();
 }
 
+namespace {
+
+// Picks the less loaded of two random candidates, so load is spread between replicas without
+// herding all clients to the one that looked least loaded a moment ago.
+RemoteTabletServer* PickLessLoadedTServer(const vector<RemoteTabletServer*>& candidates) {
+  if (candidates.size() <= 1) {
+    return candidates.empty() ? nullptr : candidates.front();
+  }
+  const size_t first = RandomUniformInt<size_t>(0, candidates.size() - 1);
+  size_t second = RandomUniformInt<size_t>(0, candidates.size() - 2);
+  if (second >= first) {
+    ++second;
+  }
+  return candidates[first]->LoadScore() <= candidates[second]->LoadScore()
+      ? candidates[first] : candidates[second];
+}
+
+} // namespace
+
 RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
                                                   const ReplicaSelection selection,
                                                   const set<string>& blacklist,
@@ -361,7 +388,8 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
         }
       } else if (selection == CLOSEST_REPLICA) {
         // Choose the closest replica.
-        bool local_zone_ts = false;
+        vector<RemoteTabletServer*> zone_local;
+        vector<RemoteTabletServer*> region_local;
         for (RemoteTabletServer* rts : filtered) {
           if (IsTabletServerLocal(*rts)) {
             ret = rts;
@@ -372,22 +400,25 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
                      cloud_info_pb_.placement_region() == rts->cloud_info().placement_region()) {
             if (cloud_info_pb_.has_placement_zone() && rts->cloud_info().has_placement_zone() &&
                 cloud_info_pb_.placement_zone() == rts->cloud_info().placement_zone()) {
-              // Note down that we have found a zone local tserver and continue looking for node
-              // local tserver.
-              ret = rts;
-              local_zone_ts = true;
-            } else if (!local_zone_ts) {
-              // Look for a region local tserver only if we haven't found a zone local tserver yet.
-              ret = rts;
+              zone_local.push_back(rts);
+            } else {
+              region_local.push_back(rts);
             }
           }
         }
 
-        // If ret is not null here, it should point to the closest replica from the client.
-
-        // Fallback to a random replica if none are local.
-        if (ret == nullptr && !filtered.empty()) {
-          ret = filtered[rand() % filtered.size()];
+        // If ret is not null here, it points to the local tserver. Otherwise choose among zone
+        // local tservers, then region local ones, falling back to any replica if none are local.
+        if (ret == nullptr) {
+          const auto& closest = !zone_local.empty() ? zone_local
+                              : !region_local.empty() ? region_local : filtered;
+          if (FLAGS_load_aware_replica_selection) {
+            ret = PickLessLoadedTServer(closest);
+          } else if (&closest == &filtered) {
+            ret = filtered.empty() ? nullptr : filtered[rand() % filtered.size()];
+          } else {
+            ret = closest.back();
+          }
         }
       }
       break;
@@ -1205,6 +1236,99 @@ void GetTableSchemaRpc::Finished(const Status& status) {
   user_cb_.Run(new_status);
 }
 
+// Gets locations of all tablets of a table from the leader master, retrying until all tablets of
+// the table are running.
+class GetTableLocationsRpc : public ClientMasterRpc {
+ public:
+  GetTableLocationsRpc(YBClient* client,
+                       StdStatusCallback user_cb,
+                       const TableId& table_id,
+                       master::GetTableLocationsResponsePB* resp,
+                       CoarseTimePoint deadline,
+                       rpc::Messenger* messenger,
+                       rpc::ProxyCache* proxy_cache);
+
+  void SendRpc() override;
+
+  string ToString() const override;
+
+  virtual ~GetTableLocationsRpc();
+
+ private:
+  void Finished(const Status& status) override;
+
+  YBClient* const client_;
+  StdStatusCallback user_cb_;
+  master::GetTableLocationsRequestPB req_;
+  master::GetTableLocationsResponsePB* resp_;
+  rpc::Rpcs::Handle retained_self_;
+};
+
+GetTableLocationsRpc::GetTableLocationsRpc(YBClient* client,
+                                           StdStatusCallback user_cb,
+                                           const TableId& table_id,
+                                           master::GetTableLocationsResponsePB* resp,
+                                           CoarseTimePoint deadline,
+                                           rpc::Messenger* messenger,
+                                           rpc::ProxyCache* proxy_cache)
+    : ClientMasterRpc(client, deadline, messenger, proxy_cache),
+      client_(DCHECK_NOTNULL(client)),
+      user_cb_(std::move(user_cb)),
+      resp_(DCHECK_NOTNULL(resp)),
+      retained_self_(client->data_->rpcs_.InvalidHandle()) {
+  req_.mutable_table()->set_table_id(table_id);
+  req_.set_max_returned_locations(std::numeric_limits<int32_t>::max());
+  req_.set_require_tablets_running(true);
+}
+
+GetTableLocationsRpc::~GetTableLocationsRpc() {
+}
+
+void GetTableLocationsRpc::SendRpc() {
+  client_->data_->rpcs_.Register(shared_from_this(), &retained_self_);
+
+  auto now = CoarseMonoClock::Now();
+  if (retrier().deadline() < now) {
+    Finished(STATUS(TimedOut, "GetTableLocations timed out after deadline expired"));
+    return;
+  }
+
+  // See YBClient::Data::SyncLeaderMasterRpc().
+  auto rpc_deadline = now + client_->default_rpc_timeout();
+  mutable_retrier()->mutable_controller()->set_deadline(
+      std::min(rpc_deadline, retrier().deadline()));
+
+  client_->data_->master_proxy()->GetTableLocationsAsync(
+      req_, resp_, mutable_retrier()->mutable_controller(),
+      std::bind(&GetTableLocationsRpc::Finished, this, Status::OK()));
+}
+
+string GetTableLocationsRpc::ToString() const {
+  return Substitute("GetTableLocationsRpc(table_id: $0, num_attempts: $1)",
+                    req_.table().table_id(), num_attempts());
+}
+
+void GetTableLocationsRpc::Finished(const Status& status) {
+  bool finished;
+  Status new_status = HandleFinished(status, *resp_, &finished);
+  if (!finished) {
+    return;
+  }
+
+  if (new_status.ok() && resp_->tablet_locations_size() == 0) {
+    // Tablets of the table are not running yet.
+    ScheduleRetry(STATUS(TryAgain, "Tablets are not running yet"));
+    return;
+  }
+
+  auto retained_self = client_->data_->rpcs_.Unregister(&retained_self_);
+
+  if (!new_status.ok()) {
+    LOG(WARNING) << ToString() << " failed: " << new_status.ToString();
+  }
+  user_cb_(new_status);
+}
+
 class CreateCDCStreamRpc : public ClientMasterRpc {
  public:
   CreateCDCStreamRpc(YBClient* client,
@@ -1529,6 +1653,21 @@ Status YBClient::Data::GetTableSchemaById(YBClient* client,
   return Status::OK();
 }
 
+void YBClient::Data::GetTableLocations(YBClient* client,
+                                       const TableId& table_id,
+                                       CoarseTimePoint deadline,
+                                       master::GetTableLocationsResponsePB* resp,
+                                       StdStatusCallback callback) {
+  rpc::StartRpc<internal::GetTableLocationsRpc>(
+      client,
+      std::move(callback),
+      table_id,
+      resp,
+      deadline,
+      messenger_,
+      proxy_cache_.get());
+}
+
 void YBClient::Data::CreateCDCStream(YBClient* client,
                                      const TableId& table_id,
                                      const std::unordered_map<std::string, std::string>& options,
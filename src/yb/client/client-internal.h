@@ -187,6 +187,14 @@ class YBClient::Data {
                                     std::shared_ptr<YBTableInfo> info,
                                     StatusCallback callback);
 
+  // Fetches locations of all tablets of the table, retrying until all of them are running.
+  // resp should be valid until the callback is invoked.
+  void GetTableLocations(YBClient* client,
+                         const TableId& table_id,
+                         CoarseTimePoint deadline,
+                         master::GetTableLocationsResponsePB* resp,
+                         StdStatusCallback callback);
+
   void CreateCDCStream(YBClient* client,
                        const TableId& table_id,
                        const std::unordered_map<std::string, std::string>& options,
@@ -312,6 +320,10 @@ class YBClient::Data {
   std::unique_ptr<rpc::ProxyCache> proxy_cache_;
   gscoped_ptr<DnsResolver> dns_resolver_;
   scoped_refptr<internal::MetaCache> meta_cache_;
+  std::shared_ptr<internal::WriteCombiner> write_combiner_;
+  // Proxy to the local tablet server, that serves reads of the YSQL system catalog from its
+  // node-wide cache. Not set if such reads are sent to the master.
+  std::shared_ptr<tserver::TabletServerServiceProxy> catalog_reads_proxy_;
   scoped_refptr<MetricEntity> metric_entity_;
 
   // Set of hostnames and IPs on the local host.
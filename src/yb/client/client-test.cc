@@ -110,6 +110,8 @@ DECLARE_int32(replication_factor);
 DEFINE_int32(test_scan_num_rows, 1000, "Number of rows to insert and scan");
 DECLARE_int32(min_backoff_ms_exponent);
 DECLARE_int32(max_backoff_ms_exponent);
+DECLARE_bool(meta_cache_lock_free_lookups);
+DECLARE_int32(client_write_combining_window_us);
 
 METRIC_DECLARE_counter(rpcs_queue_overflow);
 
@@ -515,6 +517,17 @@ TEST_F(ClientTest, TestBadTable) {
   ASSERT_STR_CONTAINS(s.ToString(false), "Not found: The object does not exist");
 }
 
+TEST_F(ClientTest, OpenTableAsync) {
+  auto table = ASSERT_RESULT(client_->OpenTableFuture(client_table_->id()).get());
+  ASSERT_EQ(client_table_->id(), table->id());
+  ASSERT_EQ(client_table_->GetPartitions(), table->GetPartitions());
+  ASSERT_EQ(client_table_->table_type(), table->table_type());
+
+  auto result = client_->OpenTableFuture("xxx-does-not-exist").get();
+  ASSERT_NOK(result);
+  ASSERT_TRUE(result.status().IsNotFound()) << result.status();
+}
+
 // Test that, if the master is down, we experience a network error talking
 // to it (no "find the new leader master" since there's only one master).
 TEST_F(ClientTest, TestMasterDown) {
@@ -929,6 +942,55 @@ TEST_F(ClientTest, TestWriteTimeout) {
   }
 }
 
+// Operations whose tablets are already resolved should not wait for a slow lookup of another
+// operation of the same batch.
+TEST_F(ClientTest, ResolvedOpsNotDelayedBySlowLookup) {
+  // Populate the meta cache with tablets of the first table.
+  ASSERT_NO_FATALS(InsertTestRows(client_table_, 100));
+
+  {
+    google::FlagSaver saver;
+    FLAGS_master_inject_latency_on_tablet_lookups_ms = 2000;
+    auto session = CreateSession();
+    session->SetTimeout(1s);
+    ASSERT_OK(ApplyInsertToSession(session.get(), client_table_, 1000, 1, "row"));
+    ASSERT_OK(ApplyInsertToSession(session.get(), client_table2_, 1000, 1, "row"));
+    Status s = session->Flush();
+    ASSERT_TRUE(s.IsIOError()) << "unexpected status: " << s;
+    auto error = GetSingleErrorFromSession(session.get());
+    ASSERT_EQ(client_table2_->id(), error->failed_op().table()->id());
+    ASSERT_TRUE(error->status().IsTimedOut()) << error->status();
+  }
+
+  ASSERT_EQ(1, CountRowsFromClient(client_table_, 1000, 1000));
+}
+
+// Idempotent writes of different sessions to the same tablet could be combined into a single
+// Write RPC, each session should still get the outcome of its own writes.
+TEST_F(ClientTest, WriteCombining) {
+  FLAGS_client_write_combining_window_us = 2000;
+
+  constexpr int kSessions = 20;
+  constexpr int kRowsPerSession = 10;
+  std::vector<YBSessionPtr> sessions;
+  std::vector<Synchronizer> synchronizers(kSessions);
+  for (int i = 0; i != kSessions; ++i) {
+    sessions.push_back(CreateSession());
+    for (int j = 0; j != kRowsPerSession; ++j) {
+      const int key = i * kRowsPerSession + j;
+      ASSERT_OK(ApplyInsertToSession(sessions.back().get(), client_table_, key, key, "row"));
+    }
+  }
+  for (int i = 0; i != kSessions; ++i) {
+    sessions[i]->FlushAsync(synchronizers[i].AsStatusFunctor());
+  }
+  for (auto& synchronizer : synchronizers) {
+    ASSERT_OK(synchronizer.Wait());
+  }
+
+  ASSERT_EQ(kSessions * kRowsPerSession, CountRowsFromClient(client_table_));
+}
+
 // Test which does an async flush and then drops the reference
 // to the Session. This should still call the callback.
 TEST_F(ClientTest, TestAsyncFlushResponseAfterSessionDropped) {
@@ -1754,6 +1816,55 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+// Compares lookups of cached tablets by key using the lock free snapshot of the meta cache with
+// lookups taking the meta cache lock.
+TEST_F(ClientTest, LookupTabletByKeyPerf) {
+  constexpr int kNumThreads = 8;
+  constexpr int kLookupsPerThread = 100000;
+
+  auto* meta_cache = client_->data_->meta_cache_.get();
+  auto* table = client_table_.get();
+  const auto& partitions = table->GetPartitions();
+  ASSERT_EQ(kNumTablets, static_cast<int>(partitions.size()));
+
+  // Populate the cache.
+  for (const auto& partition : partitions) {
+    ASSERT_OK(meta_cache->LookupTabletByKeyFuture(
+        table, partition, CoarseMonoClock::Now() + 10s).get());
+  }
+
+  for (bool lock_free : {false, true}) {
+    FLAGS_meta_cache_lock_free_lookups = lock_free;
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    Stopwatch sw(Stopwatch::ALL_THREADS);
+    sw.start();
+    for (int i = 0; i != kNumThreads; ++i) {
+      threads.emplace_back([meta_cache, table, &partitions, &failures] {
+        const auto deadline = CoarseMonoClock::Now() + 60s;
+        for (int j = 0; j != kLookupsPerThread; ++j) {
+          meta_cache->LookupTabletByKey(
+              table, partitions[j % partitions.size()], deadline,
+              [&failures](const Result<internal::RemoteTabletPtr>& result) {
+                if (!result.ok()) {
+                  ++failures;
+                }
+              });
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    sw.stop();
+    ASSERT_EQ(0, failures.load());
+    LOG(INFO) << (lock_free ? "Lock free" : "Locked") << " lookups: "
+              << kNumThreads * kLookupsPerThread << " in " << sw.elapsed().wall_millis()
+              << " ms, cpu: " << sw.elapsed().user_cpu_seconds() << "s user, "
+              << sw.elapsed().system_cpu_seconds() << "s system";
+  }
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 
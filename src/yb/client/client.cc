@@ -50,6 +50,7 @@
 #include "yb/client/namespace_alterer.h"
 #include "yb/client/table_creator.h"
 #include "yb/client/tablet_server.h"
+#include "yb/client/write_combiner.h"
 
 #include "yb/common/common.pb.h"
 #include "yb/common/entity_ids.h"
@@ -71,6 +72,7 @@
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/oid_generator.h"
 #include "yb/util/tsan_util.h"
+#include "yb/util/async_util.h"
 #include "yb/util/crypt.h"
 
 using yb::master::AlterTableRequestPB;
@@ -370,6 +372,7 @@ Status YBClientBuilder::DoBuild(rpc::Messenger* messenger, std::unique_ptr<YBCli
       "Could not locate the leader master");
 
   c->data_->meta_cache_.reset(new MetaCache(c.get()));
+  c->data_->write_combiner_ = std::make_shared<internal::WriteCombiner>(c->data_->messenger_);
   c->data_->dns_resolver_.reset(new DnsResolver());
 
   // Init local host names used for locality decisions.
@@ -1076,6 +1079,11 @@ void YBClient::SetLocalTabletServer(const string& ts_uuid,
   data_->meta_cache_->SetLocalTabletServer(ts_uuid, proxy, local_tserver);
 }
 
+void YBClient::SetCatalogReadsProxy(
+    const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy) {
+  data_->catalog_reads_proxy_ = proxy;
+}
+
 Result<bool> YBClient::IsLoadBalanced(uint32_t num_servers) {
   IsLoadBalancedRequestPB req;
   IsLoadBalancedResponsePB resp;
@@ -1383,6 +1391,51 @@ Status YBClient::OpenTable(const TableId& table_id, shared_ptr<YBTable>* table)
   return Status::OK();
 }
 
+namespace {
+
+void InvokeStdStatusCallback(const StdStatusCallback& callback, const Status& status) {
+  callback(status);
+}
+
+} // namespace
+
+void YBClient::OpenTableAsync(const TableId& table_id, const OpenTableAsyncCallback& callback) {
+  auto deadline = CoarseMonoClock::Now() + default_admin_operation_timeout();
+  auto info = std::make_shared<YBTableInfo>();
+  StdStatusCallback schema_fetched = [this, deadline, info, callback](const Status& status) {
+    if (!status.ok()) {
+      callback(status);
+      return;
+    }
+    std::shared_ptr<YBTable> table(new YBTable(this, *info));
+    auto resp = std::make_shared<master::GetTableLocationsResponsePB>();
+    data_->GetTableLocations(
+        this, info->table_id, deadline, resp.get(), [table, resp, callback](const Status& status) {
+      if (!status.ok()) {
+        callback(status);
+        return;
+      }
+      auto process_status = table->ProcessTableLocations(*resp);
+      if (!process_status.ok()) {
+        callback(process_status);
+        return;
+      }
+      callback(table);
+    });
+  };
+  auto status = data_->GetTableSchemaById(
+      this, table_id, deadline, info, Bind(&InvokeStdStatusCallback, schema_fetched));
+  if (!status.ok()) {
+    callback(status);
+  }
+}
+
+std::future<Result<YBTablePtr>> YBClient::OpenTableFuture(const TableId& table_id) {
+  return MakeFuture<Result<YBTablePtr>>([this, &table_id](auto callback) {
+    this->OpenTableAsync(table_id, std::move(callback));
+  });
+}
+
 shared_ptr<YBSession> YBClient::NewSession() {
   return std::make_shared<YBSession>(this);
 }
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -476,6 +477,10 @@ class YBClient {
                             const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy,
                             const tserver::LocalTabletServer* local_tserver);
 
+  // Sends reads of the YSQL system catalog via the proxy to the local tablet server, which serves
+  // them from its node-wide catalog cache. Should be called before the client is used.
+  void SetCatalogReadsProxy(const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy);
+
   // List only those tables whose names pass a substring match on 'filter'.
   //
   // 'tables' is appended to only on success.
@@ -524,11 +529,15 @@ class YBClient {
   // Open the table with the given name or id. This will do an RPC to ensure that
   // the table exists and look up its schema.
   //
-  // TODO: should we offer an async version of this as well?
   // TODO: probably should have a configurable timeout in YBClientBuilder?
   CHECKED_STATUS OpenTable(const YBTableName& table_name, std::shared_ptr<YBTable>* table);
   CHECKED_STATUS OpenTable(const TableId& table_id, std::shared_ptr<YBTable>* table);
 
+  // Same as OpenTable, but does not block the calling thread. The callback is invoked from a
+  // reactor thread once the schema and partitions of the table were fetched from the master.
+  void OpenTableAsync(const TableId& table_id, const OpenTableAsyncCallback& callback);
+  std::future<Result<YBTablePtr>> OpenTableFuture(const TableId& table_id);
+
   Result<YBTablePtr> OpenTable(const TableId& table_id) {
     YBTablePtr result;
     RETURN_NOT_OK(OpenTable(table_id, &result));
@@ -91,6 +91,7 @@ namespace internal {
 class AsyncRpc;
 class MetaCache;
 class TabletInvoker;
+class WriteCombiner;
 
 struct InFlightOp;
 typedef std::shared_ptr<InFlightOp> InFlightOpPtr;
@@ -111,6 +112,7 @@ typedef std::shared_ptr<AsyncRpcMetrics> AsyncRpcMetricsPtr;
 
 typedef std::function<void(const Result<internal::RemoteTabletPtr>&)> LookupTabletCallback;
 typedef std::function<void(const Result<CDCStreamId>&)> CreateCDCStreamCallback;
+typedef std::function<void(const Result<YBTablePtr>&)> OpenTableAsyncCallback;
 
 class AsyncClientInitialiser;
 
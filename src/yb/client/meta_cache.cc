@@ -32,8 +32,10 @@
 
 #include "yb/client/meta_cache.h"
 
+#include <algorithm>
 #include <shared_mutex>
 #include <mutex>
+#include <unordered_set>
 
 #include <glog/logging.h>
 
@@ -72,6 +74,18 @@ DEFINE_test_flag(bool, verify_all_replicas_alive, false,
 DEFINE_int32(retry_failed_replica_ms, 60 * 1000,
              "Time in milliseconds to wait for before retrying a failed replica");
 
+DEFINE_int32(replica_selection_busy_penalty_ms, 100,
+             "Latency added to the load estimate of a tablet server each time it rejects a "
+             "request because it is overloaded.");
+TAG_FLAG(replica_selection_busy_penalty_ms, advanced);
+TAG_FLAG(replica_selection_busy_penalty_ms, runtime);
+
+DEFINE_bool(meta_cache_lock_free_lookups, true,
+            "Whether lookups of cached tablets by partition key should use the read-copy-update "
+            "snapshot of the meta cache, instead of taking the meta cache lock.");
+TAG_FLAG(meta_cache_lock_free_lookups, advanced);
+TAG_FLAG(meta_cache_lock_free_lookups, runtime);
+
 METRIC_DEFINE_histogram(
   server, dns_resolve_latency_during_init_proxy,
   "yb.client.MetaCache.InitProxy DNS Resolve",
@@ -241,6 +255,32 @@ bool RemoteTabletServer::HasCapability(CapabilityId capability) const {
   return std::binary_search(capabilities_.begin(), capabilities_.end(), capability);
 }
 
+void RemoteTabletServer::RequestStarted() {
+  requests_in_flight_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void RemoteTabletServer::RequestFinished(MonoDelta latency, bool busy) {
+  requests_in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+  auto sample = latency.ToMicroseconds();
+  if (busy) {
+    sample += FLAGS_replica_selection_busy_penalty_ms * 1000;
+  }
+  auto current = latency_ewma_us_.load(std::memory_order_acquire);
+  for (;;) {
+    const auto updated = current == 0 ? std::max<int64_t>(sample, 1)
+                                      : current + (sample - current) / 8;
+    if (latency_ewma_us_.compare_exchange_weak(current, updated, std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+}
+
+double RemoteTabletServer::LoadScore() const {
+  const auto in_flight = std::max(requests_in_flight_.load(std::memory_order_acquire), 0);
+  return static_cast<double>(latency_ewma_us_.load(std::memory_order_acquire) + 1) *
+         (in_flight + 1);
+}
+
 ////////////////////////////////////////////////////////////
 
 RemoteTablet::~RemoteTablet() {
@@ -691,8 +731,10 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
 
   {
     std::lock_guard<decltype(mutex_)> l(mutex_);
+    std::unordered_set<TableId> updated_tables;
     for (const TabletLocationsPB& loc : locations) {
       for (const std::string& table_id : loc.table_ids()) {
+        updated_tables.insert(table_id);
         auto& table_data = tables_[table_id];
         auto& tablets_by_key = table_data.tablets_by_partition;
         // First, update the tserver cache, needed for the Refresh calls below.
@@ -753,6 +795,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         }
       }
     }
+    UpdateTabletsSnapshotUnlocked(updated_tables);
   }
 
   for (const auto& callback_and_remote_tablet : to_notify) {
@@ -763,6 +806,26 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
   return result;
 }
 
+void MetaCache::UpdateTabletsSnapshotUnlocked(const std::unordered_set<TableId>& tables) {
+  if (tables.empty()) {
+    return;
+  }
+
+  TabletsSnapshotMap new_snapshot(*tablets_snapshot_.get());
+  for (const auto& table_id : tables) {
+    const auto& tablets_by_partition = tables_[table_id].tablets_by_partition;
+    auto tablets = std::make_shared<TabletsSnapshot>(
+        tablets_by_partition.begin(), tablets_by_partition.end());
+    std::sort(tablets->begin(), tablets->end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first < rhs.first;
+    });
+    new_snapshot[table_id] = std::move(tablets);
+  }
+
+  // Waits for readers of the previous version, they never take mutex_ so there is no deadlock.
+  tablets_snapshot_.Set(std::move(new_snapshot));
+}
+
 void MetaCache::LookupFailed(
     const YBTable* table, const std::string& partition_group_start, const Status& status) {
   VLOG(1) << "Lookup for table " << table->id() << " and partition "
@@ -977,6 +1040,36 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
   return nullptr;
 }
 
+RemoteTabletPtr MetaCache::LookupTabletByKeyLockFree(const YBTable* table,
+                                                     const std::string& partition_start) {
+  RemoteTabletPtr result;
+  {
+    auto snapshot = tablets_snapshot_.get();
+    auto it = snapshot->find(table->id());
+    if (PREDICT_FALSE(it == snapshot->end())) {
+      return nullptr;
+    }
+    const auto& tablets = *it->second;
+    auto tablet_it = std::lower_bound(
+        tablets.begin(), tablets.end(), partition_start,
+        [](const auto& entry, const std::string& key) { return entry.first < key; });
+    if (PREDICT_FALSE(tablet_it == tablets.end() || tablet_it->first != partition_start)) {
+      return nullptr;
+    }
+    result = tablet_it->second;
+  }
+
+  // Same checks as in LookupTabletByKeyFastPathUnlocked.
+  if (result->stale()) {
+    return nullptr;
+  }
+  const auto& partition_end = result->partition().partition_key_end();
+  if (partition_end.empty() || partition_end.compare(partition_start) > 0) {
+    return result;
+  }
+  return nullptr;
+}
+
 // We disable thread safety analysis in this function due to manual conditional locking.
 template <class Lock>
 bool MetaCache::FastLookupTabletByKeyUnlocked(
@@ -1003,6 +1096,15 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
                                   LookupTabletCallback callback) NO_THREAD_SAFETY_ANALYSIS {
   const auto& partition_start = table->FindPartitionStart(partition_key);
 
+  if (FLAGS_meta_cache_lock_free_lookups) {
+    auto result = LookupTabletByKeyLockFree(table, partition_start);
+    if (result && result->HasLeader()) {
+      VLOG(3) << "Lock free lookup: found tablet " << result->tablet_id();
+      callback(result);
+      return;
+    }
+  }
+
   rpc::Rpcs::Handle rpc;
   {
     std::shared_lock<boost::shared_mutex> lock(mutex_);
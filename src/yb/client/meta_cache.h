@@ -33,10 +33,12 @@
 #ifndef YB_CLIENT_META_CACHE_H
 #define YB_CLIENT_META_CACHE_H
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
@@ -58,6 +60,7 @@
 
 #include "yb/util/async_util.h"
 #include "yb/util/capabilities.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/semaphore.h"
@@ -157,10 +160,24 @@ class RemoteTabletServer {
 
   bool HasCapability(CapabilityId capability) const;
 
+  // Called when a request is sent to this server and when its response is received, to track the
+  // load of the server as observed by this client. busy is set when the server rejected the
+  // request because it is overloaded.
+  void RequestStarted();
+  void RequestFinished(MonoDelta latency, bool busy);
+
+  // Returns the expected time to serve a request by this server: the moving average of its
+  // response latency scaled by the number of requests in flight. Lower is better.
+  double LoadScore() const;
+
  private:
   mutable rw_spinlock mutex_;
   const std::string uuid_;
 
+  std::atomic<int> requests_in_flight_{0};
+  // Exponentially weighted moving average of response latency.
+  std::atomic<int64_t> latency_ewma_us_{0};
+
   google::protobuf::RepeatedPtrField<HostPortPB> public_rpc_hostports_;
   google::protobuf::RepeatedPtrField<HostPortPB> private_rpc_hostports_;
   yb::CloudInfoPB cloud_info_pb_;
@@ -397,6 +414,10 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
       const YBTable* table,
       const std::string& partition_key) REQUIRES_SHARED(mutex_);
 
+  // Lookup the given tablet by partition start in tablets_snapshot_, without taking mutex_.
+  RemoteTabletPtr LookupTabletByKeyLockFree(
+      const YBTable* table, const std::string& partition_start);
+
   RemoteTabletPtr LookupTabletByIdFastPath(const TabletId& tablet_id);
 
   // Update our information about the given tablet server.
@@ -456,6 +477,18 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   std::unordered_map<TableId, TableData> tables_ GUARDED_BY(mutex_);
 
+  // Immutable copy of tablets_by_partition of a table, sorted by partition start.
+  typedef std::vector<std::pair<PartitionKey, RemoteTabletPtr>> TabletsSnapshot;
+  typedef std::unordered_map<TableId, std::shared_ptr<const TabletsSnapshot>> TabletsSnapshotMap;
+
+  // Rebuilds snapshots of the specified tables and publishes them to tablets_snapshot_.
+  void UpdateTabletsSnapshotUnlocked(const std::unordered_set<TableId>& tables) REQUIRES(mutex_);
+
+  // Snapshot of tablets_by_partition of all tables, used to lookup tablets by key without
+  // taking mutex_. Updated, under mutex_, on each change of tablets_by_partition, while readers
+  // only have to pin the current version.
+  ConcurrentValue<TabletsSnapshotMap> tablets_snapshot_;
+
   // Cache of tablets, keyed by tablet ID.
   std::unordered_map<std::string, RemoteTabletPtr> tablets_by_id_ GUARDED_BY(mutex_);
 
@@ -17,9 +17,25 @@
 #include "yb/client/table.h"
 #include "yb/client/yb_table_name.h"
 
+#include "yb/util/flag_tags.h"
+
 DEFINE_int32(update_permissions_cache_msecs, 2000,
              "How often the roles' permissions cache should be updated. 0 means never update it");
 
+DEFINE_int32(table_metadata_cache_absent_ttl_ms, 0,
+             "For how long a table name that was not found is remembered by the metadata cache, "
+             "so statements referencing it fail without asking the master. Cleared when a table is "
+             "created. 0 to disable.");
+TAG_FLAG(table_metadata_cache_absent_ttl_ms, advanced);
+TAG_FLAG(table_metadata_cache_absent_ttl_ms, runtime);
+
+METRIC_DEFINE_counter(
+    server, table_metadata_cache_hits, "Table metadata cache hits", yb::MetricUnit::kRequests,
+    "Number of table lookups served by the table metadata cache");
+METRIC_DEFINE_counter(
+    server, table_metadata_cache_misses, "Table metadata cache misses", yb::MetricUnit::kRequests,
+    "Number of table lookups that had to fetch the table from the master");
+
 namespace yb {
 namespace client {
 
@@ -60,8 +76,28 @@ Status GenerateUnauthorizedError(const std::string& canonical_resource,
   }
 }
 
+void IncrementCounter(const scoped_refptr<Counter>& counter) {
+  if (counter) {
+    counter->Increment();
+  }
+}
+
 } // namespace
 
+YBMetaDataCache::YBMetaDataCache(client::YBClient* client, bool create_roles_permissions_cache)
+    : client_(client) {
+  if (create_roles_permissions_cache) {
+    permissions_cache_ = std::make_shared<client::internal::PermissionsCache>(client);
+  } else {
+    LOG(INFO) << "Creating a metadata cache without a permissions cache";
+  }
+  const auto& metric_entity = client->metric_entity();
+  if (metric_entity) {
+    table_cache_hits_ = METRIC_table_metadata_cache_hits.Instantiate(metric_entity);
+    table_cache_misses_ = METRIC_table_metadata_cache_misses.Instantiate(metric_entity);
+  }
+}
+
 Status YBMetaDataCache::GetTable(const YBTableName& table_name,
                                  std::shared_ptr<YBTable>* table,
                                  bool* cache_used) {
@@ -71,11 +107,30 @@ Status YBMetaDataCache::GetTable(const YBTableName& table_name,
     if (itr != cached_tables_by_name_.end()) {
       *table = itr->second;
       *cache_used = true;
+      IncrementCounter(table_cache_hits_);
       return Status::OK();
     }
+    auto absent_itr = absent_tables_.find(table_name);
+    if (absent_itr != absent_tables_.end()) {
+      if (absent_itr->second > CoarseMonoClock::Now()) {
+        IncrementCounter(table_cache_hits_);
+        return STATUS_FORMAT(NotFound, "Table $0 not found", table_name);
+      }
+      absent_tables_.erase(absent_itr);
+    }
   }
 
-  RETURN_NOT_OK(client_->OpenTable(table_name, table));
+  IncrementCounter(table_cache_misses_);
+  Status s = client_->OpenTable(table_name, table);
+  if (!s.ok()) {
+    const auto absent_ttl_ms = FLAGS_table_metadata_cache_absent_ttl_ms;
+    if (s.IsNotFound() && absent_ttl_ms > 0) {
+      std::lock_guard<std::mutex> lock(cached_tables_mutex_);
+      absent_tables_[table_name] =
+          CoarseMonoClock::Now() + MonoDelta::FromMilliseconds(absent_ttl_ms);
+    }
+    return s;
+  }
   {
     std::lock_guard<std::mutex> lock(cached_tables_mutex_);
     cached_tables_by_name_[(*table)->name()] = *table;
@@ -94,10 +149,12 @@ Status YBMetaDataCache::GetTable(const TableId& table_id,
     if (itr != cached_tables_by_id_.end()) {
       *table = itr->second;
       *cache_used = true;
+      IncrementCounter(table_cache_hits_);
       return Status::OK();
     }
   }
 
+  IncrementCounter(table_cache_misses_);
   RETURN_NOT_OK(client_->OpenTable(table_id, table));
   {
     std::lock_guard<std::mutex> lock(cached_tables_mutex_);
@@ -110,6 +167,7 @@ Status YBMetaDataCache::GetTable(const TableId& table_id,
 
 void YBMetaDataCache::RemoveCachedTable(const YBTableName& table_name) {
   std::lock_guard<std::mutex> lock(cached_tables_mutex_);
+  absent_tables_.erase(table_name);
   const auto itr = cached_tables_by_name_.find(table_name);
   if (itr != cached_tables_by_name_.end()) {
     const auto table_id = itr->second->id();
@@ -128,6 +186,27 @@ void YBMetaDataCache::RemoveCachedTable(const TableId& table_id) {
   }
 }
 
+void YBMetaDataCache::ProcessTableChanges(
+    const std::vector<TableId>& changed_tables, bool table_created, bool invalidate_all) {
+  std::lock_guard<std::mutex> lock(cached_tables_mutex_);
+  if (invalidate_all) {
+    cached_tables_by_name_.clear();
+    cached_tables_by_id_.clear();
+    absent_tables_.clear();
+    return;
+  }
+  if (table_created) {
+    absent_tables_.clear();
+  }
+  for (const auto& table_id : changed_tables) {
+    const auto itr = cached_tables_by_id_.find(table_id);
+    if (itr != cached_tables_by_id_.end()) {
+      cached_tables_by_name_.erase(itr->second->name());
+      cached_tables_by_id_.erase(itr);
+    }
+  }
+}
+
 Status YBMetaDataCache::GetUDType(const string& keyspace_name,
                                   const string& type_name,
                                   std::shared_ptr<QLType> *type,
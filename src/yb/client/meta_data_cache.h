@@ -15,6 +15,7 @@
 #define YB_CLIENT_META_DATA_CACHE_H
 
 #include <unordered_map>
+#include <vector>
 
 #include <boost/container_hash/hash.hpp>
 
@@ -25,6 +26,9 @@
 #include "yb/common/common_fwd.h"
 #include "yb/common/common.pb.h"
 
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+
 #include "yb/yql/cql/ql/ptree/pt_option.h"
 
 namespace yb {
@@ -32,14 +36,8 @@ namespace client {
 
 class YBMetaDataCache {
  public:
-  YBMetaDataCache(client::YBClient* client,
-                  bool create_roles_permissions_cache = false) : client_(client)  {
-    if (create_roles_permissions_cache) {
-      permissions_cache_ = std::make_shared<client::internal::PermissionsCache>(client);
-    } else {
-      LOG(INFO) << "Creating a metadata cache without a permissions cache";
-    }
-  }
+  explicit YBMetaDataCache(client::YBClient* client,
+                           bool create_roles_permissions_cache = false);
 
   // Opens the table with the given name or id. If the table has been opened before, returns the
   // previously opened table from cached_tables_. If the table has not been opened before
@@ -55,6 +53,11 @@ class YBMetaDataCache {
   void RemoveCachedTable(const YBTableName& table_name);
   void RemoveCachedTable(const TableId& table_id);
 
+  // Applies table changes pushed by the master: removes the changed tables from the cache, and
+  // forgets absent tables if a table was created. All tables are removed if invalidate_all is set.
+  void ProcessTableChanges(const std::vector<TableId>& changed_tables, bool table_created,
+                           bool invalidate_all);
+
   // Opens the type with the given name. If the type has been opened before, returns the
   // previously opened type from cached_types_. If the type has not been opened before
   // in this client, this will do an RPC to ensure that the type exists and look up its info.
@@ -106,8 +109,17 @@ class YBMetaDataCache {
                              boost::hash<TableId>> YBTableByIdMap;
   YBTableByIdMap cached_tables_by_id_;
 
+  // Table names that were not found, with the time until which this result is cached.
+  typedef std::unordered_map<YBTableName,
+                             CoarseTimePoint,
+                             boost::hash<YBTableName>> AbsentTablesMap;
+  AbsentTablesMap absent_tables_;
+
   std::mutex cached_tables_mutex_;
 
+  scoped_refptr<Counter> table_cache_hits_;
+  scoped_refptr<Counter> table_cache_misses_;
+
   std::shared_ptr<client::internal::PermissionsCache> permissions_cache_;
 
   // Map from type-name to QLType instances.
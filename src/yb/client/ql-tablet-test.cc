@@ -25,6 +25,7 @@
 #include "yb/client/table_handle.h"
 
 #include "yb/common/ql_value.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
@@ -320,6 +321,55 @@ class QLTabletTest : public QLDmlTestBase {
     return Status::OK();
   }
 
+  // Imports source tablets through replicated operations submitted to leaders of destination
+  // tablets. All replicas import files from the source tablet dir on the leader's tablet server.
+  CHECKED_STATUS ImportReplicated() {
+    std::this_thread::sleep_for(1s); // Wait until all tablets a synced and flushed.
+    RETURN_NOT_OK(cluster_->FlushTablets());
+
+    auto source_infos = GetTabletInfos(kTable1Name);
+    auto dest_infos = GetTabletInfos(kTable2Name);
+    for (size_t j = 0; j != dest_infos.size(); ++j) {
+      bool imported = false;
+      for (int i = 0; i != cluster_->num_tablet_servers() && !imported; ++i) {
+        auto* tserver = cluster_->mini_tablet_server(i)->server();
+        tablet::TabletPeerPtr source_peer, dest_peer;
+        tserver->tablet_manager()->LookupTablet(dest_infos[j]->id(), &dest_peer);
+        if (!dest_peer || dest_peer->LeaderStatus() != consensus::LeaderStatus::LEADER_AND_READY) {
+          continue;
+        }
+        tserver->tablet_manager()->LookupTablet(source_infos[j]->id(), &source_peer);
+        if (!source_peer) {
+          return STATUS_FORMAT(NotFound, "No source tablet $0 on leader of $1",
+                               source_infos[j]->id(), dest_infos[j]->id());
+        }
+
+        auto endpoint = tserver->rpc_server()->GetBoundAddresses().front();
+        tserver::TabletServerServiceProxy proxy(
+            &tserver->proxy_cache(), HostPort::FromBoundEndpoint(endpoint));
+        tserver::ImportDataRequestPB req;
+        req.set_tablet_id(dest_infos[j]->id());
+        req.set_source_dir(source_peer->tablet()->metadata()->rocksdb_dir());
+        req.set_replicated(true);
+        tserver::ImportDataResponsePB resp;
+        rpc::RpcController controller;
+        controller.set_timeout(MonoDelta::FromSeconds(30));
+        RETURN_NOT_OK(proxy.ImportData(req, &resp, &controller));
+        if (resp.has_error()) {
+          auto status = StatusFromPB(resp.error().status());
+          if (!status.IsNotFound()) {
+            return status;
+          }
+        }
+        imported = true;
+      }
+      if (!imported) {
+        return STATUS_FORMAT(IllegalState, "No leader for $0", dest_infos[j]->id());
+      }
+    }
+    return Status::OK();
+  }
+
   scoped_refptr<master::TableInfo> GetTableInfo(const YBTableName& table_name) {
     auto* catalog_manager = cluster_->leader_mini_master()->master()->catalog_manager();
     std::vector<scoped_refptr<master::TableInfo>> all_tables;
@@ -425,6 +475,47 @@ TEST_F(QLTabletTest, OverlappedImport) {
   ASSERT_NOK(Import());
 }
 
+TEST_F(QLTabletTest, ReplicatedImportAndRestart) {
+  CreateTables(0, kBigSeqNo);
+
+  FillTable(0, kTotalKeys, table1_);
+  FillTable(kTotalKeys, 2 * kTotalKeys, table2_);
+
+  ASSERT_OK(ImportReplicated());
+  VerifyTable(0, 2 * kTotalKeys, table2_);
+  // Followers should import the same files.
+  ASSERT_OK(WaitSync(0, 2 * kTotalKeys, table2_));
+
+  // Import is recorded in the flushed frontier, so it should not be replayed at bootstrap.
+  ASSERT_OK(cluster_->RestartSync());
+  VerifyTable(0, kTotalKeys, table1_);
+  VerifyTable(0, 2 * kTotalKeys, table2_);
+}
+
+TEST_F(QLTabletTest, ImportOutOfPartition) {
+  CreateTables(0, kBigSeqNo);
+
+  FillTable(0, kTotalKeys, table1_);
+  std::this_thread::sleep_for(1s); // Wait until all tablets a synced and flushed.
+  ASSERT_OK(cluster_->FlushTablets());
+
+  auto source_infos = GetTabletInfos(kTable1Name);
+  auto dest_infos = GetTabletInfos(kTable2Name);
+  ASSERT_GT(dest_infos.size(), 1U);
+  auto* tablet_manager = cluster_->mini_tablet_server(0)->server()->tablet_manager();
+  tablet::TabletPeerPtr source_peer, dest_peer;
+  ASSERT_TRUE(tablet_manager->LookupTablet(source_infos[0]->id(), &source_peer));
+  ASSERT_TRUE(tablet_manager->LookupTablet(dest_infos[1]->id(), &dest_peer));
+  auto status = dest_peer->tablet()->ImportData(source_peer->tablet()->metadata()->rocksdb_dir());
+  ASSERT_TRUE(status.IsInvalidArgument()) << status;
+
+  // Nothing should be imported.
+  auto session = CreateSession();
+  for (int i = 0; i != kTotalKeys; ++i) {
+    ASSERT_FALSE(GetValue(session, i, table2_).is_initialized()) << "i: " << i;
+  }
+}
+
 // Test expected number of tablets for transactions table - added for #2293.
 TEST_F(QLTabletTest, TransactionsTableTablets) {
   YBSchemaBuilder builder;
@@ -714,6 +805,27 @@ TEST_F(QLTabletTest, SkewedClocks) {
   cluster_.reset();
 }
 
+// Reads served by followers should see previous writes of the same session.
+TEST_F(QLTabletTest, FollowerReadSeesSessionWrites) {
+  constexpr int kNumKeys = 100;
+
+  TableHandle table;
+  CreateTable(kTable1Name, &table);
+  auto session = CreateSession();
+
+  for (int i = 0; i != kNumKeys; ++i) {
+    SetValue(session, i, ValueForKey(i), table);
+
+    const auto op = CreateReadOp(i, table);
+    op->set_yb_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
+    ASSERT_OK(session->ApplyAndFlush(op));
+    ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+    auto rowblock = RowsResult(op.get()).GetRowBlock();
+    ASSERT_EQ(1, rowblock->row_count()) << "i: " << i;
+    ASSERT_EQ(ValueForKey(i), rowblock->row(0).column(0).int32_value()) << "i: " << i;
+  }
+}
+
 TEST_F(QLTabletTest, LeaderChange) {
   const int32_t kKey = 1;
   const int32_t kValue1 = 2;
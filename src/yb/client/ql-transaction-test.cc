@@ -24,10 +24,15 @@
 
 #include "yb/consensus/consensus.h"
 
+#include "yb/master/master_defaults.h"
+
 #include "yb/rpc/rpc.h"
 
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tablet/tablet_retention_policy.h"
 #include "yb/tablet/transaction_coordinator.h"
+#include "yb/tablet/transaction_participant.h"
 
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
@@ -58,10 +63,14 @@ DECLARE_uint64(aborted_intent_cleanup_ms);
 DECLARE_int32(remote_bootstrap_max_chunk_size);
 DECLARE_int32(master_inject_latency_on_transactional_tablet_lookups_ms);
 DECLARE_int64(transaction_rpc_timeout_ms);
+
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_HeartbeatTransactions);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(delay_init_tablet_peer_ms);
 DECLARE_bool(fail_in_apply_if_no_metadata);
 DECLARE_bool(delete_intents_sst_files);
+DECLARE_int32(timestamp_history_retention_interval_sec);
+DECLARE_int32(timestamp_history_retention_floor_sec);
 
 namespace yb {
 namespace client {
@@ -428,6 +437,89 @@ TEST_F(QLTransactionTest, Heartbeat) {
   CheckNoRunningTransactions();
 }
 
+TEST_F(QLTransactionTest, BatchedHeartbeats) {
+  constexpr size_t kTransactions = 20;
+
+  auto count_heartbeat_rpcs = [this] {
+    uint64_t result = 0;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto metric_map =
+          cluster_->mini_tablet_server(i)->server()->metric_entity()->UnsafeMetricsMapForTests();
+      auto it = metric_map.find(
+          &METRIC_handler_latency_yb_tserver_TabletServerService_HeartbeatTransactions);
+      if (it != metric_map.end()) {
+        result += down_cast<Histogram*>(it->second.get())->TotalCount();
+      }
+    }
+    return result;
+  };
+
+  std::vector<YBTransactionPtr> transactions;
+  for (size_t i = 0; i != kTransactions; ++i) {
+    transactions.push_back(CreateTransaction());
+    ASSERT_OK(WriteRows(CreateSession(transactions.back()), i));
+  }
+
+  auto rpcs_before = count_heartbeat_rpcs();
+  const auto wait = GetTransactionTimeout() * 2;
+  std::this_thread::sleep_for(wait);
+  auto rpcs = count_heartbeat_rpcs() - rpcs_before;
+
+  for (const auto& txn : transactions) {
+    ASSERT_OK(txn->CommitFuture().get());
+  }
+  VerifyData(kTransactions);
+  CheckNoRunningTransactions();
+
+  std::vector<TabletId> status_tablets;
+  ASSERT_OK(client_->GetTablets(
+      YBTableName(YQL_DATABASE_CQL, master::kSystemNamespaceName, kTransactionsTableName),
+      0, &status_tablets, /* ranges */ nullptr));
+  // Each status tablet receives one heartbeat RPC per interval for all its transactions.
+  const uint64_t periods =
+      std::chrono::duration_cast<std::chrono::microseconds>(wait).count() /
+          FLAGS_transaction_heartbeat_usec + 2;
+  LOG(INFO) << "Heartbeat RPCs: " << rpcs << ", status tablets: " << status_tablets.size()
+            << ", periods: " << periods;
+  ASSERT_GT(rpcs, 0);
+  ASSERT_LE(rpcs, std::min<uint64_t>(status_tablets.size(), kTransactions) * periods);
+}
+
+TEST_F(QLTransactionTest, AdaptiveHistoryRetention) {
+  FLAGS_timestamp_history_retention_floor_sec = 0;
+
+  auto txn = CreateTransaction();
+  ASSERT_OK(WriteRows(CreateSession(txn)));
+  size_t tablets_with_transaction = 0;
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+    auto* participant = peer->tablet()->transaction_participant();
+    if (!participant || participant->MinRunningHybridTime() == HybridTime::kMax) {
+      continue;
+    }
+    SCOPED_TRACE(peer->LogPrefix());
+    ++tablets_with_transaction;
+    // The running transaction keeps the history it could read.
+    ASSERT_LE(peer->tablet()->RetentionPolicy()->GetRetentionDirective().history_cutoff,
+              participant->MinRunningHybridTime());
+  }
+  ASSERT_GT(tablets_with_transaction, 0);
+
+  ASSERT_OK(txn->CommitFuture().get());
+  VerifyData();
+  CheckNoRunningTransactions();
+  for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+    if (!peer->tablet() || peer->table_type() != TableType::YQL_TABLE_TYPE) {
+      continue;
+    }
+    SCOPED_TRACE(peer->LogPrefix());
+    // Without running transactions and pending reads the history is not retained for the fixed
+    // interval.
+    ASSERT_GT(peer->tablet()->RetentionPolicy()->GetRetentionDirective().history_cutoff,
+              peer->clock_ptr()->Now().AddDelta(
+                  -FLAGS_timestamp_history_retention_interval_sec * 1s / 2));
+  }
+}
+
 TEST_F(QLTransactionTest, Expire) {
   SetDisableHeartbeatInTests(true);
   auto txn = CreateTransaction();
@@ -571,6 +663,44 @@ TEST_F(QLTransactionTest, SimpleWriteConflict) {
   ASSERT_NOK(transaction->CommitFuture().get());
 }
 
+// Transaction of lower priority that waits on conflicts should write the same key after the
+// transaction of higher priority commits, instead of failing with a conflict. The write is retried
+// many times while it waits, but the conflict is counted once.
+TEST_F(QLTransactionTest, WaitOnConflict) {
+  auto sum_metric = [this](scoped_refptr<Counter> tablet::TabletMetrics::*metric) {
+    int64_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      if (peer->tablet() && peer->table_type() == TableType::YQL_TABLE_TYPE) {
+        result += (peer->tablet()->metrics()->*metric)->value();
+      }
+    }
+    return result;
+  };
+  const auto initial_conflicts = sum_metric(&tablet::TabletMetrics::transaction_conflicts);
+  const auto initial_waits = sum_metric(&tablet::TabletMetrics::write_conflict_waits);
+
+  auto blocker = CreateTransaction();
+  blocker->SetPriority(std::numeric_limits<uint64_t>::max());
+  ASSERT_OK(WriteRow(CreateSession(blocker), 1 /* key */, 1 /* value */));
+
+  auto waiter = CreateTransaction();
+  waiter->SetPriority(0);
+  waiter->SetWaitOnConflict(true);
+  auto write_future = std::async(std::launch::async, [this, waiter] {
+    return WriteRow(CreateSession(waiter), 1 /* key */, 2 /* value */);
+  });
+
+  ASSERT_EQ(std::future_status::timeout, write_future.wait_for(500ms));
+  ASSERT_OK(blocker->CommitFuture().get());
+  ASSERT_OK(write_future.get());
+  ASSERT_OK(waiter->CommitFuture().get());
+  ASSERT_EQ(initial_conflicts + 1, sum_metric(&tablet::TabletMetrics::transaction_conflicts));
+  ASSERT_GT(sum_metric(&tablet::TabletMetrics::write_conflict_waits), initial_waits);
+
+  auto value = ASSERT_RESULT(SelectRow(CreateSession(), 1 /* key */));
+  ASSERT_EQ(2, value);
+}
+
 void QLTransactionTest::TestReadOnlyTablets(IsolationLevel isolation_level,
                                             bool perform_write,
                                             bool written_intents_expected) {
@@ -81,6 +81,24 @@ void YBSession::SetRejectionScoreSource(RejectionScoreSourcePtr rejection_score_
   rejection_score_source_ = std::move(rejection_score_source);
 }
 
+void YBSession::SetFollowerReadStalenessBound(MonoDelta value) {
+  if (batcher_) {
+    batcher_->SetFollowerReadStalenessBound(value);
+  }
+  follower_read_staleness_bound_ = value;
+}
+
+HybridTime YBSession::last_write_hybrid_time() const {
+  return HybridTime(last_write_hybrid_time_.load(std::memory_order_acquire));
+}
+
+void YBSession::UpdateLastWriteHybridTime(HybridTime value) {
+  auto current = last_write_hybrid_time_.load(std::memory_order_acquire);
+  while (value.ToUint64() > current &&
+         !last_write_hybrid_time_.compare_exchange_weak(current, value.ToUint64())) {
+  }
+}
+
 YBSession::~YBSession() {
   WARN_NOT_OK(Close(true), "Closed Session with pending operations.");
 }
@@ -202,6 +220,7 @@ internal::Batcher& YBSession::Batcher() {
       batcher_->SetTimeout(timeout_);
     }
     batcher_->SetRejectionScoreSource(rejection_score_source_);
+    batcher_->SetFollowerReadStalenessBound(follower_read_staleness_bound_);
     if (hybrid_time_for_write_.is_valid()) {
       batcher_->WriteWithHybridTime(hybrid_time_for_write_);
     }
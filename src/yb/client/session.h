@@ -14,6 +14,7 @@
 #ifndef YB_CLIENT_SESSION_H
 #define YB_CLIENT_SESSION_H
 
+#include <atomic>
 #include <unordered_set>
 
 #include "yb/client/client_fwd.h"
@@ -249,6 +250,19 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   void SetRejectionScoreSource(RejectionScoreSourcePtr rejection_score_source);
 
+  // Sets the bound on staleness of data returned by reads with CONSISTENT_PREFIX consistency level.
+  // Such reads are served by the closest replica, and a follower whose safe time is older than
+  // the bound rejects the read, so it is retried on the leader. Zero means no bound.
+  void SetFollowerReadStalenessBound(MonoDelta value);
+
+  // Returns the max hybrid time propagated by responses to writes of this session. Reads with
+  // CONSISTENT_PREFIX consistency level send it to the tablet server, so a follower serves them
+  // only after it has replicated the writes of this session.
+  HybridTime last_write_hybrid_time() const;
+
+  // Called by Batcher when a write of this session has finished.
+  void UpdateLastWriteHybridTime(HybridTime value);
+
  private:
   friend class YBClient;
   friend class internal::Batcher;
@@ -292,6 +306,11 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   RejectionScoreSourcePtr rejection_score_source_;
 
+  MonoDelta follower_read_staleness_bound_;
+
+  // Updated by batchers from reactor threads, so it is atomic, unlike the rest of the session.
+  std::atomic<uint64_t> last_write_hybrid_time_{HybridTime::kMin.ToUint64()};
+
   DISALLOW_COPY_AND_ASSIGN(YBSession);
 };
 
@@ -265,13 +265,6 @@ Status YBTable::Open() {
     if (!s.ok()) {
       YB_LOG_EVERY_N_SECS(WARNING, 10) << "Error getting table locations: " << s << ", retrying.";
     } else if (resp.tablet_locations_size() > 0) {
-      DCHECK(partitions_.empty());
-      partitions_.clear();
-      partitions_.reserve(resp.tablet_locations().size());
-      for (const auto& tablet_location : resp.tablet_locations()) {
-        partitions_.push_back(tablet_location.partition().partition_key_start());
-      }
-      std::sort(partitions_.begin(), partitions_.end());
       break;
     }
 
@@ -282,6 +275,17 @@ Status YBTable::Open() {
     }
   }
 
+  return ProcessTableLocations(resp);
+}
+
+Status YBTable::ProcessTableLocations(const master::GetTableLocationsResponsePB& resp) {
+  DCHECK(partitions_.empty());
+  partitions_.clear();
+  partitions_.reserve(resp.tablet_locations().size());
+  for (const auto& tablet_location : resp.tablet_locations()) {
+    partitions_.push_back(tablet_location.partition().partition_key_start());
+  }
+  std::sort(partitions_.begin(), partitions_.end());
 
   RETURN_NOT_OK_PREPEND(PBToClientTableType(resp.table_type(), &table_type_),
     strings::Substitute("Invalid table type for table '$0'", info_.table_name.ToString()));
@@ -24,6 +24,11 @@
 DECLARE_int32(max_num_tablets_for_table);
 
 namespace yb {
+
+namespace master {
+class GetTableLocationsResponsePB;
+}
+
 namespace client {
 
 // This must match TableType in common.proto.
@@ -131,6 +136,9 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
 
   CHECKED_STATUS Open();
 
+  // Fills partitions and table type from the locations of all tablets of the table.
+  CHECKED_STATUS ProcessTableLocations(const master::GetTableLocationsResponsePB& resp);
+
   client::YBClient* const client_;
   YBTableType table_type_;
   YBTableInfo info_;
@@ -108,6 +108,26 @@ TEST_F(TabletRpcTest, TabletInvokerSelectTabletServerRace) {
   replicas_refresher.join();
 }
 
+TEST_F(TabletRpcTest, RemoteTabletServerLoadScore) {
+  RemoteTabletServer fast("fast-uuid", nullptr, nullptr);
+  RemoteTabletServer slow("slow-uuid", nullptr, nullptr);
+
+  for (int i = 0; i != 10; ++i) {
+    fast.RequestStarted();
+    fast.RequestFinished(MonoDelta::FromMilliseconds(1), false /* busy */);
+    slow.RequestStarted();
+    slow.RequestFinished(MonoDelta::FromMilliseconds(10), false /* busy */);
+  }
+  ASSERT_LT(fast.LoadScore(), slow.LoadScore());
+
+  // Requests in flight and rejections make the server look more loaded.
+  const auto idle_score = fast.LoadScore();
+  fast.RequestStarted();
+  ASSERT_GT(fast.LoadScore(), idle_score);
+  fast.RequestFinished(MonoDelta::FromMilliseconds(1), true /* busy */);
+  ASSERT_GT(fast.LoadScore(), idle_score);
+}
+
 } // namespace internal
 } // namespace client
 } // namespace yb
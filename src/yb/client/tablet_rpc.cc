@@ -54,7 +54,11 @@ TabletInvoker::TabletInvoker(const bool local_tserver_only,
         local_tserver_only_(local_tserver_only),
         consistent_prefix_(consistent_prefix) {}
 
-TabletInvoker::~TabletInvoker() {}
+TabletInvoker::~TabletInvoker() {
+  if (sent_ts_) {
+    sent_ts_->RequestFinished(CoarseMonoClock::Now() - sent_time_, false /* busy */);
+  }
+}
 
 void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
   TRACE_TO(trace_, "SelectTabletServerWithConsistentPrefix()");
@@ -153,6 +157,8 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
     return;
   }
 
+  hedging_allowed_ = consistent_prefix_ && !leader_only && !local_tserver_only_;
+
   // Sets current_ts_.
   if (local_tserver_only_) {
     SelectLocalTabletServer();
@@ -211,9 +217,34 @@ void TabletInvoker::Execute(const std::string& tablet_id, bool leader_only) {
   VLOG(2) << "Tablet " << tablet_id_ << ": Writing batch to replica "
           << current_ts_->ToString();
 
+  sent_ts_ = current_ts_;
+  sent_time_ = CoarseMonoClock::Now();
+  sent_ts_->RequestStarted();
   rpc_->SendRpcToTserver(retrier_->attempt_num());
 }
 
+RemoteTabletServer* TabletInvoker::SelectHedgeTabletServer() {
+  if (!hedging_allowed_ || !tablet_ || !current_ts_) {
+    return nullptr;
+  }
+
+  std::vector<RemoteTabletServer*> candidates;
+  auto* result = client_->data_->SelectTServer(
+      tablet_.get(), YBClient::ReplicaSelection::CLOSEST_REPLICA,
+      {current_ts_->permanent_uuid()}, &candidates);
+  if (!result || result == current_ts_) {
+    return nullptr;
+  }
+
+  auto status = result->InitProxy(client_);
+  if (!status.ok()) {
+    VLOG(1) << "Failed to init proxy to " << result->ToString() << " for hedged request: "
+            << status;
+    return nullptr;
+  }
+  return result;
+}
+
 Status TabletInvoker::FailToNewReplica(const Status& reason,
                                        const tserver::TabletServerErrorPB* error_code) {
   if (ErrorCode(error_code) == tserver::TabletServerErrorPB::STALE_FOLLOWER) {
@@ -243,6 +274,15 @@ bool TabletInvoker::Done(Status* status) {
   TRACE_TO(trace_, "Done($0)", status->ToString(false));
   ADOPT_TRACE(trace_);
 
+  if (sent_ts_) {
+    const auto* error = retrier_->controller().error_response();
+    const bool busy =
+        status->IsServiceUnavailable() ||
+        (error && error->code() == rpc::ErrorStatusPB::ERROR_SERVER_TOO_BUSY);
+    sent_ts_->RequestFinished(CoarseMonoClock::Now() - sent_time_, busy);
+    sent_ts_ = nullptr;
+  }
+
   if (status->IsAborted() || retrier_->finished()) {
     return true;
   }
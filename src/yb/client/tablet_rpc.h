@@ -79,6 +79,18 @@ class TabletInvoker {
   const RemoteTabletServer& current_ts() { return *current_ts_; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
+  // Whether a copy of the request could be sent to another replica if the current one is slow to
+  // respond, i.e. the request could be served by any replica of the tablet.
+  bool hedging_allowed() const { return hedging_allowed_; }
+
+  // Selects a replica, other than the current one, to send a hedged copy of the request to.
+  // Returns nullptr if there is no such replica.
+  RemoteTabletServer* SelectHedgeTabletServer();
+
+  // Called when the response to the hedged copy of the request sent to ts arrived first, so the
+  // outcome of the request should be attributed to ts.
+  void HedgedRequestWon(RemoteTabletServer* ts) { current_ts_ = ts; }
+
  private:
   friend class TabletRpcTest;
   FRIEND_TEST(TabletRpcTest, TabletInvokerSelectTabletServerRace);
@@ -139,10 +151,18 @@ class TabletInvoker {
 
   const bool consistent_prefix_;
 
+  // Set by Execute, see hedging_allowed().
+  bool hedging_allowed_ = false;
+
   // The TS receiving the write. May change if the write is retried.
   // RemoteTabletServer is taken from YBClient cache, so it is guaranteed that those objects are
   // alive while YBClient is alive. Because we don't delete them, but only add and update.
   RemoteTabletServer* current_ts_ = nullptr;
+
+  // The TS the last attempt was sent to and when, to track its load. Reset when the response is
+  // received.
+  RemoteTabletServer* sent_ts_ = nullptr;
+  CoarseTimePoint sent_time_;
 };
 
 CHECKED_STATUS ErrorStatus(const tserver::TabletServerErrorPB* error);
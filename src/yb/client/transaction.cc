@@ -47,6 +47,7 @@ DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat du
 DEFINE_bool(transaction_disable_proactive_cleanup_in_tests, false,
             "Disable cleanup of intents in abort path.");
 DECLARE_uint64(max_clock_skew_usec);
+DECLARE_uint64(transaction_heartbeat_batch_window_usec);
 
 DEFINE_test_flag(int32, TEST_transaction_inject_flushed_delay_ms, 0,
                  "Inject delay before processing flushed operations by transaction.");
@@ -126,6 +127,10 @@ class YBTransaction::Impl final {
     metadata_.priority = priority;
   }
 
+  void SetWaitOnConflict(bool wait_on_conflict) {
+    metadata_.wait_on_conflict = wait_on_conflict;
+  }
+
   YBTransactionPtr CreateSimilarTransaction() {
     return std::make_shared<YBTransaction>(manager_);
   }
@@ -172,6 +177,7 @@ class YBTransaction::Impl final {
       other->read_point_ = std::move(read_point_);
       other->read_point_.Restart();
       other->metadata_.isolation = metadata_.isolation;
+      other->metadata_.wait_on_conflict = metadata_.wait_on_conflict;
       if (metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
         other->metadata_.start_time = other->read_point_.GetReadTime().read;
       } else {
@@ -243,6 +249,11 @@ class YBTransaction::Impl final {
       // For snapshot isolation, if read time was not yet picked, we have to choose it now, if there
       // multiple tablets that will process first request.
       SetReadTimeIfNeeded(num_tablets > 1 || force_consistent_read);
+
+      if (initial && !ops.empty() && !first_write_recorded_) {
+        first_write_recorded_ = true;
+        IncrementHistogramSince(&TransactionMetrics::first_write_time, init_time_);
+      }
     }
 
     VLOG_WITH_PREFIX(3) << "Prepare, has_tablets_without_metadata: "
@@ -550,6 +561,7 @@ class YBTransaction::Impl final {
   }
 
   void CompleteInit(IsolationLevel isolation) {
+    init_time_ = CoarseMonoClock::Now();
     metadata_.isolation = isolation;
     if (read_point_.GetReadTime()) {
       metadata_.start_time = read_point_.GetReadTime().read;
@@ -558,6 +570,15 @@ class YBTransaction::Impl final {
     }
   }
 
+  // Adds the microseconds passed since start to the histogram of the manager's metrics.
+  void IncrementHistogramSince(
+      scoped_refptr<Histogram> TransactionMetrics::*histogram, CoarseTimePoint start) {
+    auto* metrics = manager_->metrics();
+    if (metrics && start != CoarseTimePoint()) {
+      (metrics->*histogram)->Increment(ToMicroseconds(CoarseMonoClock::Now() - start));
+    }
+  }
+
   void SetReadTimeIfNeeded(bool do_it) {
     if (!read_point_.GetReadTime() && do_it &&
         metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
@@ -613,6 +634,7 @@ class YBTransaction::Impl final {
       }
     }
 
+    commit_rpc_start_ = CoarseMonoClock::Now();
     manager_->rpcs().RegisterAndStart(
         UpdateTransaction(
             deadline,
@@ -671,6 +693,7 @@ class YBTransaction::Impl final {
                   const YBTransactionPtr& transaction) {
     VLOG_WITH_PREFIX(1) << "Committed: " << status;
 
+    IncrementHistogramSince(&TransactionMetrics::commit_rpc_time, commit_rpc_start_);
     UpdateClock(response, manager_);
     manager_->rpcs().Unregister(&commit_handle_);
 
@@ -776,6 +799,7 @@ class YBTransaction::Impl final {
       if (status.ok()) {
         DCHECK(!ready_);
         ready_ = true;
+        IncrementHistogramSince(&TransactionMetrics::begin_time, create_time_);
       } else {
         SetError(status, &lock);
       }
@@ -805,15 +829,18 @@ class YBTransaction::Impl final {
 
     VLOG_WITH_PREFIX(4) << __func__ << "(" << TransactionStatus_Name(status) << ")";
 
-    MonoDelta timeout;
     if (status != TransactionStatus::CREATED) {
       if (GetAtomicFlag(&FLAGS_transaction_disable_heartbeat_in_tests)) {
         HeartbeatDone(Status::OK(), tserver::UpdateTransactionResponsePB(), status, transaction);
         return;
       }
-      timeout = std::chrono::microseconds(FLAGS_transaction_heartbeat_usec);
-    } else {
-      timeout = TransactionRpcTimeout();
+      // Heartbeats of pending transactions are batched by status tablet, the clock is updated
+      // by the batch response.
+      manager_->SendHeartbeat(
+          status_tablet_, metadata_.transaction_id,
+          std::bind(&Impl::HeartbeatDone, this, _1, tserver::UpdateTransactionResponsePB(), status,
+                    transaction));
+      return;
     }
 
     tserver::UpdateTransactionRequestPB req;
@@ -824,7 +851,7 @@ class YBTransaction::Impl final {
     state.set_status(status);
     manager_->rpcs().RegisterAndStart(
         UpdateTransaction(
-            CoarseMonoClock::now() + timeout,
+            CoarseMonoClock::now() + TransactionRpcTimeout(),
             status_tablet_.get(),
             manager_->client(),
             &req,
@@ -832,6 +859,14 @@ class YBTransaction::Impl final {
         &heartbeat_handle_);
   }
 
+  // The heartbeat waits transaction_heartbeat_batch_window_usec in the batch before it is sent,
+  // so this wait is excluded from the interval between heartbeats.
+  static std::chrono::microseconds NextHeartbeatDelay() {
+    const auto interval = GetAtomicFlag(&FLAGS_transaction_heartbeat_usec);
+    const auto window = GetAtomicFlag(&FLAGS_transaction_heartbeat_batch_window_usec);
+    return std::chrono::microseconds(interval > window ? interval - window : 0);
+  }
+
   static bool AllowHeartbeat(TransactionState current_state, TransactionStatus status) {
     switch (current_state) {
       case TransactionState::kRunning:
@@ -865,7 +900,7 @@ class YBTransaction::Impl final {
           [this, weak_transaction, id = metadata_.transaction_id](const Status&) {
               SendHeartbeat(TransactionStatus::PENDING, id, weak_transaction);
           },
-          std::chrono::microseconds(FLAGS_transaction_heartbeat_usec));
+          NextHeartbeatDelay());
     } else {
       LOG_WITH_PREFIX(WARNING) << "Send heartbeat failed: " << status;
       if (status.IsAborted()) {
@@ -982,6 +1017,11 @@ class YBTransaction::Impl final {
   size_t running_requests_ = 0;
   // Set to true after commit record is replicated. Used only during transaction sealing.
   bool commit_replicated_ = false;
+  bool first_write_recorded_ = false;
+
+  const CoarseTimePoint create_time_ = CoarseMonoClock::Now();
+  CoarseTimePoint init_time_;
+  CoarseTimePoint commit_rpc_start_;
 };
 
 CoarseTimePoint AdjustDeadline(CoarseTimePoint deadline) {
@@ -1011,6 +1051,10 @@ void YBTransaction::SetPriority(uint64_t priority) {
   impl_->SetPriority(priority);
 }
 
+void YBTransaction::SetWaitOnConflict(bool wait_on_conflict) {
+  impl_->SetWaitOnConflict(wait_on_conflict);
+}
+
 Status YBTransaction::Init(IsolationLevel isolation, const ReadHybridTime& read_time) {
   return impl_->Init(isolation, read_time);
 }
@@ -79,6 +79,11 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
 
   void SetPriority(uint64_t priority);
 
+  // Makes writes of this transaction that conflict with a pending transaction of higher priority
+  // wait for it to commit or abort, instead of failing with a conflict to be retried by the client.
+  // Should be invoked before the first write.
+  void SetWaitOnConflict(bool wait_on_conflict);
+
   // Should be invoked to complete transaction creation.
   // Transaction is unusable before Init is called.
   CHECKED_STATUS Init(
@@ -15,22 +15,83 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <unordered_map>
+
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
 #include "yb/client/client.h"
+#include "yb/client/meta_cache.h"
+#include "yb/client/transaction_rpc.h"
 
 #include "yb/common/transaction.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/master/master_defaults.h"
+#include "yb/master/master.pb.h"
+
+#include "yb/tserver/tserver_service.pb.h"
+
+using namespace std::placeholders;
+
+DECLARE_uint64(transaction_heartbeat_usec);
+
+DEFINE_bool(prefer_local_zone_status_tablets, true,
+            "Pick transaction status tablets whose leader is in the same zone as the client, "
+            "when there are such tablets.");
+TAG_FLAG(prefer_local_zone_status_tablets, advanced);
+TAG_FLAG(prefer_local_zone_status_tablets, runtime);
+
+DEFINE_uint64(transaction_heartbeat_batch_window_usec, 50000,
+              "Time the heartbeat of a transaction waits for the heartbeats of the other "
+              "transactions of the client with the same status tablet, to be sent with them in "
+              "one RPC. It is a part of transaction_heartbeat_usec, i.e. does not make the "
+              "heartbeats less frequent.");
+TAG_FLAG(transaction_heartbeat_batch_window_usec, advanced);
+TAG_FLAG(transaction_heartbeat_batch_window_usec, runtime);
+
+METRIC_DEFINE_histogram(
+    server, transaction_begin_time, "Transaction begin time",
+    yb::MetricUnit::kMicroseconds,
+    "Microseconds from creation of a transaction until it is registered at its status tablet",
+    60000000LU, 2);
+METRIC_DEFINE_histogram(
+    server, transaction_first_write_time, "Transaction first write time",
+    yb::MetricUnit::kMicroseconds,
+    "Microseconds from initialization of a transaction until its first write is sent",
+    60000000LU, 2);
+METRIC_DEFINE_histogram(
+    server, transaction_commit_rpc_time, "Transaction commit RPC time",
+    yb::MetricUnit::kMicroseconds,
+    "Microseconds spent in the RPC that commits a transaction at its status tablet",
+    60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, transaction_heartbeat_rpcs, "Transaction heartbeat RPCs",
+    yb::MetricUnit::kRequests,
+    "Number of RPCs sent to the status tablets with the heartbeats of the pending transactions");
+METRIC_DEFINE_counter(
+    server, transaction_heartbeats, "Transaction heartbeats",
+    yb::MetricUnit::kTransactions,
+    "Number of heartbeats of the pending transactions sent to their status tablets");
 
 namespace yb {
 namespace client {
 
+TransactionMetrics::TransactionMetrics(const scoped_refptr<MetricEntity>& metric_entity)
+    : begin_time(METRIC_transaction_begin_time.Instantiate(metric_entity)),
+      first_write_time(METRIC_transaction_first_write_time.Instantiate(metric_entity)),
+      commit_rpc_time(METRIC_transaction_commit_rpc_time.Instantiate(metric_entity)),
+      heartbeat_rpcs(METRIC_transaction_heartbeat_rpcs.Instantiate(metric_entity)),
+      heartbeats(METRIC_transaction_heartbeats.Instantiate(metric_entity)) {
+}
+
 namespace {
 
 const YBTableName kTransactionTableName(
@@ -41,7 +102,15 @@ const YBTableName kTransactionTableName(
 // Resolved - final state, when all tablets are resolved and written to cache.
 YB_DEFINE_ENUM(TransactionTableStatus, (kExists)(kUpdating)(kResolved));
 
+bool SameZone(const CloudInfoPB& lhs, const CloudInfoPB& rhs) {
+  return lhs.has_placement_zone() && rhs.has_placement_zone() &&
+         lhs.placement_cloud() == rhs.placement_cloud() &&
+         lhs.placement_region() == rhs.placement_region() &&
+         lhs.placement_zone() == rhs.placement_zone();
+}
+
 void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+                    const std::vector<TabletId>& local_zone_tablets,
                     const PickStatusTabletCallback& callback) {
   if (filter) {
     std::vector<const TabletId*> ids;
@@ -55,6 +124,10 @@ void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>
       return;
     }
     LOG(WARNING) << "No local transaction status tablet";
+  } else if (!local_zone_tablets.empty() &&
+             GetAtomicFlag(&FLAGS_prefer_local_zone_status_tablets)) {
+    callback(RandomElement(local_zone_tablets));
+    return;
   }
   callback(RandomElement(tablets));
 }
@@ -63,6 +136,8 @@ struct TransactionTableState {
   LocalTabletFilter local_tablet_filter;
   std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
   std::vector<TabletId> tablets;
+  // Tablets whose leader was in the same zone as the client when tablets were resolved.
+  std::vector<TabletId> local_zone_tablets;
 };
 
 // Picks status tablet for transaction.
@@ -78,7 +153,9 @@ class PickStatusTabletTask {
   void Run() {
     // TODO(dtxn) async
     std::vector<TabletId> tablets;
-    auto status = client_->GetTablets(kTransactionTableName, 0, &tablets, /* ranges */ nullptr);
+    std::vector<master::TabletLocationsPB> locations;
+    auto status = client_->GetTablets(
+        kTransactionTableName, 0, &tablets, /* ranges */ nullptr, &locations);
     if (!status.ok()) {
       VLOG(1) << "Failed to get tablets of txn status table: " << status;
       callback_(status);
@@ -90,14 +167,28 @@ class PickStatusTabletTask {
       callback_(s);
       return;
     }
+    std::vector<TabletId> local_zone_tablets;
+    for (const auto& tablet : locations) {
+      for (const auto& replica : tablet.replicas()) {
+        if (replica.role() == consensus::RaftPeerPB::LEADER &&
+            SameZone(replica.ts_info().cloud_info(), client_->cloud_info())) {
+          local_zone_tablets.push_back(tablet.tablet_id());
+          break;
+        }
+      }
+    }
+    VLOG(1) << "Status tablets: " << tablets.size() << ", in local zone: "
+            << local_zone_tablets.size();
+
     auto expected = TransactionTableStatus::kExists;
     if (table_state_->status.compare_exchange_strong(
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
       table_state_->tablets = tablets;
+      table_state_->local_zone_tablets = local_zone_tablets;
       table_state_->status.store(TransactionTableStatus::kResolved, std::memory_order_release);
     }
 
-    InvokeCallback(table_state_->local_tablet_filter, tablets, callback_);
+    InvokeCallback(table_state_->local_tablet_filter, tablets, local_zone_tablets, callback_);
   }
 
   void Done(const Status& status) {
@@ -123,7 +214,8 @@ class InvokeCallbackTask {
   }
 
   void Run() {
-    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets, callback_);
+    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets,
+                   table_state_->local_zone_tablets, callback_);
   }
 
   void Done(const Status& status) {
@@ -138,6 +230,150 @@ class InvokeCallbackTask {
   PickStatusTabletCallback callback_;
 };
 
+// Collects the heartbeats of the pending transactions by their status tablets, and sends the
+// heartbeats of each status tablet in one RPC.
+// Scheduled sends refer to it by weak pointer, so they could outlive the transaction manager.
+class HeartbeatBatcher : public std::enable_shared_from_this<HeartbeatBatcher> {
+ public:
+  HeartbeatBatcher(YBClient* client, const scoped_refptr<ClockBase>& clock,
+                   const TransactionMetrics* metrics)
+      : client_(client), clock_(clock) {
+    if (metrics) {
+      heartbeat_rpcs_ = metrics->heartbeat_rpcs;
+      heartbeats_ = metrics->heartbeats;
+    }
+  }
+
+  void Add(const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+           StdStatusCallback callback) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (closed_) {
+        lock.unlock();
+        callback(STATUS(Aborted, "Transaction manager shutting down"));
+        return;
+      }
+      auto& batch = batches_[status_tablet->tablet_id()];
+      batch.tablet = status_tablet;
+      batch.ids.push_back(id);
+      batch.callbacks.push_back(std::move(callback));
+      if (batch.ids.size() != 1) {
+        // Send of this batch is already scheduled.
+        return;
+      }
+    }
+    std::weak_ptr<HeartbeatBatcher> weak_self(shared_from_this());
+    client_->messenger()->scheduler().Schedule(
+        [weak_self, tablet_id = status_tablet->tablet_id()](const Status& status) {
+          auto self = weak_self.lock();
+          if (self) {
+            self->Send(tablet_id, status);
+          }
+        },
+        std::chrono::microseconds(GetAtomicFlag(&FLAGS_transaction_heartbeat_batch_window_usec)));
+  }
+
+  void UpdateClock(HybridTime time) {
+    clock_->Update(time);
+  }
+
+  void Shutdown() {
+    std::unordered_map<TabletId, Batch> batches;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      batches.swap(batches_);
+    }
+    for (auto& tablet_and_batch : batches) {
+      Fail(tablet_and_batch.second.callbacks, STATUS(Aborted, "Transaction manager shutting down"));
+    }
+    rpcs_.Shutdown();
+  }
+
+ private:
+  struct Batch {
+    internal::RemoteTabletPtr tablet;
+    std::vector<TransactionId> ids;
+    std::vector<StdStatusCallback> callbacks;
+  };
+
+  void Send(const TabletId& tablet_id, Status status) {
+    Batch batch;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = batches_.find(tablet_id);
+      if (it == batches_.end()) {
+        return;
+      }
+      batch = std::move(it->second);
+      batches_.erase(it);
+    }
+    if (!status.ok()) {
+      Fail(batch.callbacks, status);
+      return;
+    }
+
+    tserver::HeartbeatTransactionsRequestPB req;
+    req.set_tablet_id(tablet_id);
+    req.set_propagated_hybrid_time(clock_->Now().ToUint64());
+    for (const auto& id : batch.ids) {
+      req.add_transaction_id(id.data(), id.size());
+    }
+    IncrementCounter(heartbeat_rpcs_);
+    IncrementCounterBy(heartbeats_, batch.ids.size());
+    VLOG(4) << "Send " << batch.ids.size() << " heartbeats to " << tablet_id;
+
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      Fail(batch.callbacks, STATUS(Aborted, "Transaction manager shutting down"));
+      return;
+    }
+    *handle = HeartbeatTransactions(
+        CoarseMonoClock::now() + std::chrono::microseconds(FLAGS_transaction_heartbeat_usec),
+        batch.tablet.get(),
+        client_,
+        &req,
+        std::bind(&HeartbeatBatcher::Done, shared_from_this(), _1, _2, handle,
+                  std::move(batch.callbacks)));
+    (**handle).SendRpc();
+  }
+
+  void Done(const Status& status, const tserver::HeartbeatTransactionsResponsePB& response,
+            rpc::Rpcs::Handle handle, const std::vector<StdStatusCallback>& callbacks) {
+    client::UpdateClock(response, this);
+    rpcs_.Unregister(handle);
+
+    if (!status.ok()) {
+      Fail(callbacks, status);
+      return;
+    }
+    if (static_cast<size_t>(response.status().size()) != callbacks.size()) {
+      Fail(callbacks, STATUS_FORMAT(
+          IllegalState, "Wrong number of heartbeat results: $0, expected: $1",
+          response.status().size(), callbacks.size()));
+      return;
+    }
+    for (size_t i = 0; i != callbacks.size(); ++i) {
+      callbacks[i](StatusFromPB(response.status(i)));
+    }
+  }
+
+  static void Fail(const std::vector<StdStatusCallback>& callbacks, const Status& status) {
+    for (const auto& callback : callbacks) {
+      callback(status);
+    }
+  }
+
+  YBClient* const client_;
+  scoped_refptr<ClockBase> clock_;
+  scoped_refptr<Counter> heartbeat_rpcs_;
+  scoped_refptr<Counter> heartbeats_;
+  std::mutex mutex_;
+  bool closed_ = false;
+  std::unordered_map<TabletId, Batch> batches_;
+  rpc::Rpcs rpcs_;
+};
+
 constexpr size_t kQueueLimit = 150;
 constexpr size_t kMaxWorkers = 50;
 
@@ -154,12 +390,17 @@ class TransactionManager::Impl {
         tasks_pool_(kQueueLimit),
         invoke_callback_tasks_(kQueueLimit) {
     CHECK(clock);
+    if (client && client->metric_entity()) {
+      metrics_.reset(new TransactionMetrics(client->metric_entity()));
+    }
+    heartbeat_batcher_ = std::make_shared<HeartbeatBatcher>(client, clock, metrics_.get());
   }
 
   void PickStatusTablet(PickStatusTabletCallback callback) {
     if (table_state_.status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
       if (ThreadRestrictions::IsWaitAllowed()) {
-        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets, callback);
+        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets,
+                       table_state_.local_zone_tablets, callback);
       } else if (!invoke_callback_tasks_.Enqueue(&thread_pool_, &table_state_, callback)) {
         callback(STATUS_FORMAT(ServiceUnavailable,
                               "Invoke callback queue overflow, number of tasks: $0",
@@ -172,6 +413,11 @@ class TransactionManager::Impl {
     }
   }
 
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+                     StdStatusCallback callback) {
+    heartbeat_batcher_->Add(status_tablet, id, std::move(callback));
+  }
+
   const scoped_refptr<ClockBase>& clock() const {
     return clock_;
   }
@@ -196,7 +442,12 @@ class TransactionManager::Impl {
     clock_->Update(time);
   }
 
+  const TransactionMetrics* metrics() const {
+    return metrics_.get();
+  }
+
   void Shutdown() {
+    heartbeat_batcher_->Shutdown();
     rpcs_.Shutdown();
     thread_pool_.Shutdown();
   }
@@ -210,6 +461,8 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+  std::unique_ptr<TransactionMetrics> metrics_;
+  std::shared_ptr<HeartbeatBatcher> heartbeat_batcher_;
 };
 
 TransactionManager::TransactionManager(
@@ -229,6 +482,12 @@ YBClient* TransactionManager::client() const {
   return impl_->client();
 }
 
+void TransactionManager::SendHeartbeat(
+    const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+    StdStatusCallback callback) {
+  impl_->SendHeartbeat(status_tablet, id, std::move(callback));
+}
+
 rpc::Rpcs& TransactionManager::rpcs() {
   return impl_->rpcs();
 }
@@ -249,5 +508,9 @@ void TransactionManager::UpdateClock(HybridTime time) {
   impl_->UpdateClock(time);
 }
 
+const TransactionMetrics* TransactionManager::metrics() const {
+  return impl_->metrics();
+}
+
 } // namespace client
 } // namespace yb
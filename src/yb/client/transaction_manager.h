@@ -23,14 +23,33 @@
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
+#include "yb/util/metrics.h"
 #include "yb/util/result.h"
+#include "yb/util/status_callback.h"
 
 namespace yb {
 namespace client {
 
+// Latencies of the phases of transactions, as seen by the client.
+struct TransactionMetrics {
+  explicit TransactionMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+
+  // From creation of the transaction until it is registered at its status tablet.
+  scoped_refptr<Histogram> begin_time;
+  // From initialization of the transaction until its first write is sent.
+  scoped_refptr<Histogram> first_write_time;
+  // Of the RPC that commits the transaction at its status tablet.
+  scoped_refptr<Histogram> commit_rpc_time;
+  // RPCs sent to the status tablets with the heartbeats of the pending transactions.
+  scoped_refptr<Counter> heartbeat_rpcs;
+  // Heartbeats of the pending transactions, several of them could be sent in one RPC.
+  scoped_refptr<Counter> heartbeats;
+};
+
 typedef std::function<void(const Result<std::string>&)> PickStatusTabletCallback;
 
 // TransactionManager manages multiple transactions. It lives at the YQL engine layer.
@@ -42,6 +61,12 @@ class TransactionManager {
 
   void PickStatusTablet(PickStatusTabletCallback callback);
 
+  // Sends heartbeat of the pending transaction to its status tablet. The heartbeats of the
+  // transactions of this manager that have the same status tablet are collected during
+  // transaction_heartbeat_batch_window_usec and sent in one RPC.
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet, const TransactionId& id,
+                     StdStatusCallback callback);
+
   rpc::Rpcs& rpcs();
   YBClient* client() const;
 
@@ -51,6 +76,9 @@ class TransactionManager {
 
   void UpdateClock(HybridTime time);
 
+  // Returns nullptr when the client has no metric entity.
+  const TransactionMetrics* metrics() const;
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
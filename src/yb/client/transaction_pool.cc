@@ -87,6 +87,7 @@ class TransactionPool::Impl {
 
   YBTransactionPtr Take() {
     YBTransactionPtr result, new_txn;
+    bool result_prepared = true;
     uint64_t old_taken;
     IncrementCounter(cache_queries_);
     {
@@ -97,9 +98,11 @@ class TransactionPool::Impl {
       // newly created or not. So number of transactions in pool will near average number of take
       // requests during transaction preparation.
       if (transactions_.empty()) {
-        // Transaction is automatically prepared when batcher is executed, so we don't have to
-        // prepare newly created transaction, since it is anyway too late.
+        // Transaction is automatically prepared when batcher is executed, but the caller usually
+        // does some work before its first write. So we start registering the transaction at its
+        // status tablet right away, to overlap it with this work.
         result = std::make_shared<YBTransaction>(&manager_);
+        result_prepared = false;
         IncrementHistogram(cache_histogram_, 0);
       } else {
         result = Pop();
@@ -118,6 +121,11 @@ class TransactionPool::Impl {
         nullptr /* metadata */)) {
       TransactionReady(Status::OK(), new_txn, old_taken);
     }
+    if (!result_prepared) {
+      result->Prepare(
+          /* ops= */{}, ForceConsistentRead::kFalse, TransactionRpcDeadline(), Initial::kFalse,
+          /* waiter= */ nullptr, nullptr /* metadata */);
+    }
     return result;
   }
 
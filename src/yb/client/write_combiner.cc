@@ -0,0 +1,224 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/write_combiner.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/rpc/messenger.h"
+
+#include "yb/tserver/tserver_service.proxy.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(client_write_combining_window_us, 0,
+             "Max time a non-transactional idempotent write could wait to be combined with writes "
+             "of other sessions to the same tablet in a single Write RPC. 0 to disable write "
+             "combining.");
+TAG_FLAG(client_write_combining_window_us, advanced);
+TAG_FLAG(client_write_combining_window_us, runtime);
+
+DEFINE_int32(client_write_combining_max_ops, 1000,
+             "Max number of ops in a Write RPC combined from writes of different sessions. "
+             "A combined RPC is sent right away when it reaches this size.");
+TAG_FLAG(client_write_combining_max_ops, advanced);
+TAG_FLAG(client_write_combining_max_ops, runtime);
+
+namespace yb {
+namespace client {
+namespace internal {
+
+namespace {
+
+bool IsValueExpr(const QLExpressionPB& expr) {
+  return expr.expr_case() == QLExpressionPB::kValue;
+}
+
+// Returns whether applying the write twice has the same effect as applying it once, so it could
+// be sent without the retryable request id.
+bool IsIdempotent(const QLWriteRequestPB& write) {
+  if (write.has_if_expr() || write.has_where_expr() || write.else_error() ||
+      write.returns_status() || write.is_backfilling() || write.has_child_transaction_data() ||
+      write.update_index_ids_size() != 0) {
+    return false;
+  }
+  for (const auto& value : write.hashed_column_values()) {
+    if (!IsValueExpr(value)) {
+      return false;
+    }
+  }
+  for (const auto& value : write.range_column_values()) {
+    if (!IsValueExpr(value)) {
+      return false;
+    }
+  }
+  // Only plain column assignments: counter increments, list appends and subscripted or json
+  // updates depend on the current value.
+  for (const auto& column_value : write.column_values()) {
+    if (column_value.subscript_args_size() != 0 || column_value.json_args_size() != 0 ||
+        !IsValueExpr(column_value.expr())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+WriteCombiner::WriteCombiner(rpc::Messenger* messenger) : messenger_(messenger) {}
+
+WriteCombiner::~WriteCombiner() {}
+
+bool WriteCombiner::Enabled() {
+  return FLAGS_client_write_combining_window_us > 0;
+}
+
+bool WriteCombiner::CanCombine(const tserver::WriteRequestPB& request) {
+  if (request.has_write_batch() || request.has_external_hybrid_time() ||
+      request.has_read_time() || request.has_client_id1() || request.include_trace() ||
+      request.redis_write_batch_size() != 0 || request.pgsql_write_batch_size() != 0 ||
+      request.ql_write_batch_size() == 0) {
+    return false;
+  }
+  for (const auto& write : request.ql_write_batch()) {
+    if (!IsIdempotent(write)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WriteCombiner::Write(const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy,
+                          const tserver::WriteRequestPB* request,
+                          tserver::WriteResponsePB* response,
+                          rpc::RpcController* controller,
+                          rpc::ResponseCallback callback) {
+  BatchKey key(proxy.get(), request->tablet_id());
+  BatchPtr new_batch;
+  BatchPtr full_batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& batch = batches_[key];
+    if (!batch) {
+      batch = std::make_shared<Batch>();
+      batch->key = key;
+      batch->proxy = proxy;
+      batch->request.set_tablet_id(request->tablet_id());
+      batch->timeout = controller->timeout();
+      new_batch = batch;
+    }
+    auto& combined = batch->request;
+    if (request->has_propagated_hybrid_time()) {
+      combined.set_propagated_hybrid_time(
+          std::max(combined.propagated_hybrid_time(), request->propagated_hybrid_time()));
+    }
+    if (request->has_rejection_score()) {
+      combined.set_rejection_score(
+          std::max(combined.rejection_score(), request->rejection_score()));
+    }
+    for (const auto& write : request->ql_write_batch()) {
+      *combined.add_ql_write_batch() = write;
+    }
+    batch->timeout = std::min(batch->timeout, controller->timeout());
+    batch->callbacks.push_back({request, response, controller, std::move(callback)});
+    if (combined.ql_write_batch_size() >= FLAGS_client_write_combining_max_ops) {
+      full_batch = batch;
+    }
+  }
+
+  if (full_batch) {
+    FlushBatch(full_batch);
+    return;
+  }
+  if (!new_batch) {
+    return;
+  }
+
+  auto task_id = messenger_->ScheduleOnReactor(
+      [self = shared_from_this(), new_batch](const Status& status) {
+        self->FlushBatch(new_batch);
+      },
+      MonoDelta::FromMicroseconds(FLAGS_client_write_combining_window_us), SOURCE_LOCATION(),
+      messenger_);
+  if (task_id == rpc::kInvalidTaskId) {
+    FlushBatch(new_batch);
+  }
+}
+
+void WriteCombiner::FlushBatch(const BatchPtr& batch) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = batches_.find(batch->key);
+    if (it == batches_.end() || it->second != batch) {
+      return;
+    }
+    batches_.erase(it);
+  }
+
+  VLOG(4) << "Sending " << batch->request.ql_write_batch_size() << " writes of "
+          << batch->callbacks.size() << " requests to " << batch->key.second;
+  batch->controller.set_timeout(batch->timeout);
+  batch->proxy->WriteAsync(
+      batch->request, &batch->response, &batch->controller,
+      std::bind(&WriteCombiner::WriteResponseCallback, shared_from_this(), batch));
+}
+
+void WriteCombiner::WriteResponseCallback(const BatchPtr& batch) {
+  const auto status = batch->controller.status();
+  auto& combined = batch->response;
+  auto& responses = *combined.mutable_ql_response_batch();
+  auto& row_errors = combined.per_row_errors();
+  if (status.ok() && !combined.has_error() &&
+      responses.size() != batch->request.ql_write_batch_size()) {
+    LOG(DFATAL) << "Wrong number of responses for combined write to " << batch->key.second
+                << ": " << responses.size() << ", while " << batch->request.ql_write_batch_size()
+                << " expected";
+  }
+
+  int begin = 0;
+  for (auto& data : batch->callbacks) {
+    const int end = begin + data.request->ql_write_batch_size();
+    if (status.ok()) {
+      auto* response = data.response;
+      response->Clear();
+      if (combined.has_error()) {
+        *response->mutable_error() = combined.error();
+      }
+      for (int i = begin; i < std::min(end, responses.size()); ++i) {
+        response->add_ql_response_batch()->Swap(&responses[i]);
+      }
+      for (const auto& row_error : row_errors) {
+        if (row_error.row_index() >= begin && row_error.row_index() < end) {
+          auto* error = response->add_per_row_errors();
+          *error->mutable_error() = row_error.error();
+          error->set_row_index(row_error.row_index() - begin);
+        }
+      }
+      if (combined.has_propagated_hybrid_time()) {
+        response->set_propagated_hybrid_time(combined.propagated_hybrid_time());
+      }
+      if (combined.has_used_read_time()) {
+        *response->mutable_used_read_time() = combined.used_read_time();
+      }
+    }
+    data.controller->ShareFinishedCall(batch->controller);
+    data.callback();
+    begin = end;
+  }
+}
+
+} // namespace internal
+} // namespace client
+} // namespace yb
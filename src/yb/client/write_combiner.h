@@ -0,0 +1,114 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains WriteCombiner, which combines non-transactional writes of different sessions
+// to the same tablet into a single Write RPC.
+
+#ifndef YB_CLIENT_WRITE_COMBINER_H
+#define YB_CLIENT_WRITE_COMBINER_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/rpc/response_callback.h"
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+}
+
+namespace tserver {
+class TabletServerServiceProxy;
+}
+
+namespace client {
+namespace internal {
+
+// Many sessions writing small batches to the same tablet would otherwise send a Write RPC each,
+// and the tablet would replicate each of them separately. Writes that are safe to apply more than
+// once are instead collected for up to client_write_combining_window_us and sent to the tablet
+// together, in a single WriteRequestPB, whose response is then split between the callers.
+//
+// Since the combined request has no retryable request id, only idempotent writes are combined,
+// see CanCombine.
+class WriteCombiner : public std::enable_shared_from_this<WriteCombiner> {
+ public:
+  explicit WriteCombiner(rpc::Messenger* messenger);
+  ~WriteCombiner();
+
+  // Returns whether write combining is enabled.
+  static bool Enabled();
+
+  // Returns whether the request could be combined with requests of other sessions, i.e. it is not
+  // transactional, does not use the retryable request id, and all its writes are idempotent.
+  static bool CanCombine(const tserver::WriteRequestPB& request);
+
+  // Adds the request to the batch of requests to the same tablet via the same proxy. The request
+  // and response should be valid until the callback is invoked. After that the controller has the
+  // status of the call that carried the request, and the response is filled as if the request was
+  // sent alone.
+  void Write(const std::shared_ptr<tserver::TabletServerServiceProxy>& proxy,
+             const tserver::WriteRequestPB* request,
+             tserver::WriteResponsePB* response,
+             rpc::RpcController* controller,
+             rpc::ResponseCallback callback);
+
+ private:
+  struct ResponseCallbackData {
+    const tserver::WriteRequestPB* request;
+    tserver::WriteResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+
+  typedef std::pair<tserver::TabletServerServiceProxy*, TabletId> BatchKey;
+
+  struct Batch {
+    BatchKey key;
+    std::shared_ptr<tserver::TabletServerServiceProxy> proxy;
+    tserver::WriteRequestPB request;
+    tserver::WriteResponsePB response;
+    rpc::RpcController controller;
+    MonoDelta timeout;
+    std::vector<ResponseCallbackData> callbacks;
+  };
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  // Sends the batch, if it is still the current one for its key.
+  void FlushBatch(const BatchPtr& batch);
+
+  void WriteResponseCallback(const BatchPtr& batch);
+
+  rpc::Messenger* const messenger_;
+
+  std::mutex mutex_;
+  std::map<BatchKey, BatchPtr> batches_;
+
+  DISALLOW_COPY_AND_ASSIGN(WriteCombiner);
+};
+
+} // namespace internal
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_WRITE_COMBINER_H
@@ -562,6 +562,11 @@ YBPgsqlReadOp::YBPgsqlReadOp(const shared_ptr<YBTable>& table)
       yb_consistency_level_(YBConsistencyLevel::STRONG) {
 }
 
+OpGroup YBPgsqlReadOp::group() {
+  return yb_consistency_level_ == YBConsistencyLevel::CONSISTENT_PREFIX
+      ? OpGroup::kConsistentPrefixRead : OpGroup::kLeaderRead;
+}
+
 std::unique_ptr<YBPgsqlReadOp> YBPgsqlReadOp::NewSelect(const shared_ptr<YBTable>& table) {
   std::unique_ptr<YBPgsqlReadOp> op(new YBPgsqlReadOp(table));
   PgsqlReadRequestPB *req = op->mutable_request();
@@ -503,6 +503,7 @@ class YBPgsqlReadOp : public YBPgsqlOp {
 
  protected:
   virtual Type type() const override { return PGSQL_READ; }
+  OpGroup group() override;
 
  private:
   friend class YBTable;
@@ -54,6 +54,10 @@ using RedisConfigKey = std::string;
 static const uint32_t kPgSequencesDataTableOid = 0xFFFF;
 static const uint32_t kPgSequencesDataDatabaseOid = 0xFFFF;
 
+// Indexes of the value columns of the sequences data table.
+static const size_t kPgSequenceLastValueColIdx = 2;
+static const size_t kPgSequenceIsCalledColIdx = 3;
+
 extern const TableId kPgProcTableId;
 
 // Get YB namespace id for a Postgres database.
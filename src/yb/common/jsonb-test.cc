@@ -15,8 +15,10 @@
 #include <rapidjson/prettywriter.h>
 
 #include "yb/common/jsonb.h"
+#include "yb/common/ql_value.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
+#include "yb/util/varint.h"
 
 using std::to_string;
 using std::numeric_limits;
@@ -151,5 +153,71 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+namespace {
+
+void AddJsonOperation(JsonOperatorPB json_operator, const std::string& key,
+                      QLJsonColumnOperationsPB* json_ops) {
+  auto* json_op = json_ops->add_json_operations();
+  json_op->set_json_operator(json_operator);
+  json_op->mutable_operand()->mutable_value()->set_string_value(key);
+}
+
+void AddJsonOperation(JsonOperatorPB json_operator, int64_t index,
+                      QLJsonColumnOperationsPB* json_ops) {
+  auto* json_op = json_ops->add_json_operations();
+  json_op->set_json_operator(json_operator);
+  json_op->mutable_operand()->mutable_value()->set_varint_value(
+      util::VarInt(index).EncodeToComparable());
+}
+
+} // namespace
+
+TEST(JsonbTest, TestApplyJsonbOperators) {
+  Jsonb jsonb;
+  ASSERT_OK(jsonb.FromString(R"#(
+        { "a" : { "b" : [10, "x", { "c" : "deep" }] }, "z" : 1 }
+      )#"));
+  const Slice serialized(jsonb.SerializedJsonb());
+
+  // a->'b'->2->>'c'
+  QLJsonColumnOperationsPB json_ops;
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "a", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "b", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, 2, &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_TEXT, "c", &json_ops);
+  QLValue result;
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(serialized, json_ops, &result));
+  ASSERT_EQ(result.string_value(), "deep");
+
+  // a->'b'->1 is a jsonb scalar.
+  json_ops.Clear();
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "a", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "b", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, 1, &json_ops);
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(serialized, json_ops, &result));
+  std::string json;
+  ASSERT_OK(Jsonb(result.jsonb_value()).ToJsonString(&json));
+  ASSERT_EQ(json, "\"x\"");
+
+  // Missing keys, out of bounds indexes and paths through scalars are null.
+  for (const auto& key : {"b", "zz", "0"}) {
+    json_ops.Clear();
+    AddJsonOperation(JsonOperatorPB::JSON_OBJECT, key, &json_ops);
+    ASSERT_OK(Jsonb::ApplyJsonbOperators(serialized, json_ops, &result));
+    ASSERT_TRUE(result.IsNull());
+  }
+  json_ops.Clear();
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "z", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "a", &json_ops);
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(serialized, json_ops, &result));
+  ASSERT_TRUE(result.IsNull());
+  json_ops.Clear();
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "a", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, "b", &json_ops);
+  AddJsonOperation(JsonOperatorPB::JSON_OBJECT, 3, &json_ops);
+  ASSERT_OK(Jsonb::ApplyJsonbOperators(serialized, json_ops, &result));
+  ASSERT_TRUE(result.IsNull());
+}
+
 }  // namespace common
 }  // namespace yb
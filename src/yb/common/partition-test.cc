@@ -39,6 +39,7 @@
 #include "yb/common/crc16.h"
 #include "yb/common/partial_row.h"
 #include "yb/common/partition.h"
+#include "yb/common/ql_value.h"
 #include "yb/common/row.h"
 #include "yb/common/schema.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
@@ -116,4 +117,19 @@ TEST(PartitionTest, TestRedisEncoding) {
   ASSERT_EQ(pk1, pk2);
 }
 
+TEST(PartitionTest, TestHashColumnValues) {
+  for (size_t string_size : {0, 10, 10000, 20}) {
+    google::protobuf::RepeatedPtrField<QLExpressionPB> values;
+    values.Add()->mutable_value()->set_int32_value(static_cast<int32_t>(string_size));
+    values.Add()->mutable_value()->set_string_value(std::string(string_size, 'x'));
+
+    string compound;
+    for (const auto& value : values) {
+      AppendToKey(value.value(), &compound);
+    }
+    ASSERT_EQ(PartitionSchema::HashColumnCompoundValue(compound),
+              PartitionSchema::HashColumnValues(values));
+  }
+}
+
 } // namespace yb
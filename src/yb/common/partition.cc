@@ -45,6 +45,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/common/ql_value.h"
+#include "yb/util/size_literals.h"
 
 namespace yb {
 
@@ -253,6 +254,37 @@ Status PartitionSchema::EncodeRedisKey(const Slice& slice, string* buf) const {
   return Status::OK();
 }
 
+namespace {
+
+// Compound values of larger keys are not kept in the per-thread buffer.
+constexpr size_t kMaxRetainedHashBufferSize = 4_KB;
+
+template <class Collection>
+uint16_t DoHashColumnValues(const Collection& hash_col_values) {
+  static thread_local std::string buffer;
+  buffer.clear();
+  for (const auto& col_expr_pb : hash_col_values) {
+    AppendToKey(col_expr_pb.value(), &buffer);
+  }
+  const uint16_t result = PartitionSchema::HashColumnCompoundValue(Slice(buffer));
+  if (buffer.capacity() > kMaxRetainedHashBufferSize) {
+    std::string().swap(buffer);
+  }
+  return result;
+}
+
+} // namespace
+
+uint16_t PartitionSchema::HashColumnValues(
+    const RepeatedPtrField<QLExpressionPB>& hash_col_values) {
+  return DoHashColumnValues(hash_col_values);
+}
+
+uint16_t PartitionSchema::HashColumnValues(
+    const RepeatedPtrField<PgsqlExpressionPB>& hash_col_values) {
+  return DoHashColumnValues(hash_col_values);
+}
+
 Status PartitionSchema::EncodeKey(const RepeatedPtrField<QLExpressionPB>& hash_col_values,
                                   string* buf) const {
   if (!hash_schema_) {
@@ -260,15 +292,9 @@ Status PartitionSchema::EncodeKey(const RepeatedPtrField<QLExpressionPB>& hash_c
   }
 
   switch (*hash_schema_) {
-    case YBHashSchema::kMultiColumnHash: {
-      string tmp;
-      for (const auto &col_expr_pb : hash_col_values) {
-        AppendToKey(col_expr_pb.value(), &tmp);
-      }
-      const uint16_t hash_value = YBPartition::HashColumnCompoundValue(tmp);
-      *buf = EncodeMultiColumnHashValue(hash_value);
+    case YBHashSchema::kMultiColumnHash:
+      *buf = EncodeMultiColumnHashValue(HashColumnValues(hash_col_values));
       return Status::OK();
-    }
     case YBHashSchema::kPgsqlHash:
       DLOG(FATAL) << "Illegal code path. PGSQL hash cannot be computed from CQL expression";
       break;
@@ -290,12 +316,7 @@ Status PartitionSchema::EncodeKey(const RepeatedPtrField<PgsqlExpressionPB>& has
     case YBHashSchema::kPgsqlHash: {
       // TODO(neil) Discussion is needed. PGSQL hash should be done appropriately.
       // For now, let's not doing anything. Just borrow code from multi column hashing style.
-      string tmp;
-      for (const auto &col_expr_pb : hash_col_values) {
-        AppendToKey(col_expr_pb.value(), &tmp);
-      }
-      const uint16_t hash_value = YBPartition::HashColumnCompoundValue(tmp);
-      *buf = EncodeMultiColumnHashValue(hash_value);
+      *buf = EncodeMultiColumnHashValue(HashColumnValues(hash_col_values));
       return Status::OK();
     }
 
@@ -993,6 +1014,10 @@ Status PartitionSchema::EncodeColumns(const YBPartialRow& row,
 }
 
 uint16_t PartitionSchema::HashColumnCompoundValue(const string& compound) {
+  return HashColumnCompoundValue(Slice(compound));
+}
+
+uint16_t PartitionSchema::HashColumnCompoundValue(const Slice& compound) {
   // In the future, if you wish to change the hashing behavior, you must introduce a new hashing
   // method for your newly-created tables.  Existing tables must continue to use their hashing
   // methods that was define by their PartitionSchema.
@@ -1001,7 +1026,8 @@ uint16_t PartitionSchema::HashColumnCompoundValue(const string& compound) {
   // as the default hashing behavior. Constant 'kseed" cannot be changed as it'd yield a different
   // hashing result.
   static const int kseed = 97;
-  const uint64_t hash_value = Hash64StringWithSeed(compound, kseed);
+  const uint64_t hash_value = Hash64StringWithSeed(
+      compound.cdata(), static_cast<uint32>(compound.size()), kseed);
 
   // Convert the 64-bit hash value to 16 bit integer.
   const uint64_t h1 = hash_value >> 48;
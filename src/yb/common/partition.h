@@ -184,6 +184,14 @@ class PartitionSchema {
   CHECKED_STATUS EncodeKey(const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& hash_values,
                            std::string* buf) const WARN_UNUSED_RESULT;
 
+  // Returns the 16-bit multi column hash of the hash column values, i.e. the value encoded in the
+  // partition key by EncodeKey. The compound value is built in a per-thread buffer, so no memory
+  // is allocated for each key.
+  static uint16_t HashColumnValues(
+      const google::protobuf::RepeatedPtrField<QLExpressionPB>& hash_values);
+  static uint16_t HashColumnValues(
+      const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& hash_values);
+
   // Appends the row's encoded partition key into the provided buffer.
   // On failure, the buffer may have data partially appended.
   CHECKED_STATUS EncodeKey(const YBPartialRow& row, std::string* buf) const WARN_UNUSED_RESULT;
@@ -280,6 +288,7 @@ class PartitionSchema {
 
   // Hashes a compound string of all columns into a 16-bit integer.
   static uint16_t HashColumnCompoundValue(const string& compound);
+  static uint16_t HashColumnCompoundValue(const Slice& compound);
 
   // Encodes the specified columns of a row into 2-byte partition key using the multi column
   // hashing scheme.
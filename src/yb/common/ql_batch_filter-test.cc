@@ -0,0 +1,168 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_batch_filter.h"
+#include "yb/common/ql_expr.h"
+#include "yb/common/ql_value.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+constexpr ColumnIdRep kIntColumn = 10;
+constexpr ColumnIdRep kDoubleColumn = 20;
+constexpr ColumnIdRep kStringColumn = 30;
+
+PgsqlConditionPB* AddComparison(
+    PgsqlConditionPB* and_condition, QLOperator op, ColumnIdRep column_id, QLValuePB value,
+    bool column_first = true) {
+  auto* condition = and_condition->add_operands()->mutable_condition();
+  condition->set_op(op);
+  if (column_first) {
+    condition->add_operands()->set_column_id(column_id);
+    *condition->add_operands()->mutable_value() = value;
+  } else {
+    *condition->add_operands()->mutable_value() = value;
+    condition->add_operands()->set_column_id(column_id);
+  }
+  return condition;
+}
+
+QLValuePB Int64Value(int64_t value) {
+  QLValuePB result;
+  result.set_int64_value(value);
+  return result;
+}
+
+QLValuePB DoubleValue(double value) {
+  QLValuePB result;
+  result.set_double_value(value);
+  return result;
+}
+
+} // namespace
+
+class QLBatchFilterTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    batch_.Reset({ColumnId(kIntColumn), ColumnId(kDoubleColumn), ColumnId(kStringColumn)});
+    // Row i has int column i and double column i / 2.0, every third row has null int column.
+    for (int i = 0; i != 20; ++i) {
+      const size_t row_idx = batch_.AddRow();
+      if (i % 3 != 0) {
+        batch_.mutable_value(0, row_idx)->set_int64_value(i);
+      }
+      batch_.mutable_value(1, row_idx)->set_double_value(i / 2.0);
+      batch_.mutable_value(2, row_idx)->set_string_value("row");
+    }
+    where_expr_.mutable_condition()->set_op(QL_OP_AND);
+  }
+
+  PgsqlConditionPB* condition() {
+    return where_expr_.mutable_condition();
+  }
+
+  // Checks that the batch filter matches the same rows as the row by row evaluation.
+  void CheckSameAsRowByRow() {
+    QLBatchFilter filter;
+    ASSERT_TRUE(filter.Init(where_expr_, batch_));
+    std::vector<uint8_t> selection;
+    ASSERT_OK(filter.Evaluate(batch_, &selection));
+    ASSERT_EQ(batch_.num_rows(), selection.size());
+
+    QLExprExecutor executor;
+    for (size_t row_idx = 0; row_idx != batch_.num_rows(); ++row_idx) {
+      QLTableRow row;
+      for (size_t column_idx = 0; column_idx != batch_.num_columns(); ++column_idx) {
+        row.AllocColumn(batch_.column_ids()[column_idx], batch_.value(column_idx, row_idx));
+      }
+      bool match = false;
+      ASSERT_OK(executor.EvalCondition(where_expr_.condition(), row, &match));
+      ASSERT_EQ(match, selection[row_idx] != 0) << "Row: " << row_idx;
+    }
+  }
+
+  QLColumnBatch batch_;
+  PgsqlExpressionPB where_expr_;
+};
+
+TEST_F(QLBatchFilterTest, TestComparisons) {
+  for (auto op : {QL_OP_EQUAL, QL_OP_NOT_EQUAL, QL_OP_LESS_THAN, QL_OP_LESS_THAN_EQUAL,
+                  QL_OP_GREATER_THAN, QL_OP_GREATER_THAN_EQUAL}) {
+    for (bool column_first : {true, false}) {
+      condition()->clear_operands();
+      AddComparison(condition(), op, kIntColumn, Int64Value(10), column_first);
+      ASSERT_NO_FATALS(CheckSameAsRowByRow()) << "Op: " << op << ", column first: "
+                                              << column_first;
+
+      condition()->clear_operands();
+      AddComparison(condition(), op, kDoubleColumn, DoubleValue(4.5), column_first);
+      ASSERT_NO_FATALS(CheckSameAsRowByRow()) << "Op: " << op << ", column first: "
+                                              << column_first;
+    }
+  }
+}
+
+TEST_F(QLBatchFilterTest, TestConjunction) {
+  AddComparison(condition(), QL_OP_GREATER_THAN_EQUAL, kIntColumn, Int64Value(4));
+  AddComparison(condition(), QL_OP_LESS_THAN, kDoubleColumn, DoubleValue(8));
+  AddComparison(condition(), QL_OP_NOT_EQUAL, kIntColumn, Int64Value(11));
+  ASSERT_NO_FATALS(CheckSameAsRowByRow());
+
+  QLBatchFilter filter;
+  ASSERT_TRUE(filter.Init(where_expr_, batch_));
+  ASSERT_EQ(3, filter.num_comparisons());
+  std::vector<uint8_t> selection;
+  ASSERT_OK(filter.Evaluate(batch_, &selection));
+  std::vector<size_t> matched_rows;
+  for (size_t row_idx = 0; row_idx != selection.size(); ++row_idx) {
+    if (selection[row_idx]) {
+      matched_rows.push_back(row_idx);
+    }
+  }
+  ASSERT_EQ((std::vector<size_t>{4, 5, 7, 8, 10, 13, 14}), matched_rows);
+}
+
+TEST_F(QLBatchFilterTest, TestUnsupported) {
+  QLBatchFilter filter;
+
+  // Strings are not supported.
+  QLValuePB string_value;
+  string_value.set_string_value("row");
+  AddComparison(condition(), QL_OP_EQUAL, kStringColumn, string_value);
+  ASSERT_FALSE(filter.Init(where_expr_, batch_));
+
+  // OR is not supported.
+  condition()->clear_operands();
+  condition()->set_op(QL_OP_OR);
+  AddComparison(condition(), QL_OP_EQUAL, kIntColumn, Int64Value(1));
+  ASSERT_FALSE(filter.Init(where_expr_, batch_));
+
+  // Columns missing from the batch are not supported.
+  condition()->clear_operands();
+  condition()->set_op(QL_OP_AND);
+  AddComparison(condition(), QL_OP_EQUAL, 40, Int64Value(1));
+  ASSERT_FALSE(filter.Init(where_expr_, batch_));
+
+  // Comparing with a value of another type fails as in row by row evaluation.
+  condition()->clear_operands();
+  AddComparison(condition(), QL_OP_EQUAL, kIntColumn, DoubleValue(1));
+  ASSERT_TRUE(filter.Init(where_expr_, batch_));
+  std::vector<uint8_t> selection;
+  ASSERT_NOK(filter.Evaluate(batch_, &selection));
+}
+
+} // namespace yb
@@ -0,0 +1,230 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_batch_filter.h"
+
+#include "yb/common/ql_value.h"
+
+namespace yb {
+
+namespace {
+
+bool IsIntegerType(InternalType type) {
+  switch (type) {
+    case InternalType::kInt8Value: FALLTHROUGH_INTENDED;
+    case InternalType::kInt16Value: FALLTHROUGH_INTENDED;
+    case InternalType::kInt32Value: FALLTHROUGH_INTENDED;
+    case InternalType::kInt64Value: FALLTHROUGH_INTENDED;
+    case InternalType::kTimestampValue:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsFloatingPointType(InternalType type) {
+  return type == InternalType::kFloatValue || type == InternalType::kDoubleValue;
+}
+
+template <class T>
+T GetNumericValue(const QLValuePB& value) {
+  switch (value.value_case()) {
+    case InternalType::kInt8Value:
+      return value.int8_value();
+    case InternalType::kInt16Value:
+      return value.int16_value();
+    case InternalType::kInt32Value:
+      return value.int32_value();
+    case InternalType::kInt64Value:
+      return value.int64_value();
+    case InternalType::kTimestampValue:
+      return value.timestamp_value();
+    case InternalType::kFloatValue:
+      return value.float_value();
+    case InternalType::kDoubleValue:
+      return value.double_value();
+    default:
+      break;
+  }
+  LOG(FATAL) << "Unexpected value type: " << value.value_case();
+  return T();
+}
+
+// Returns the operator to use when operands of the comparison are swapped.
+QLOperator SwapOperands(QLOperator op) {
+  switch (op) {
+    case QL_OP_LESS_THAN:
+      return QL_OP_GREATER_THAN;
+    case QL_OP_LESS_THAN_EQUAL:
+      return QL_OP_GREATER_THAN_EQUAL;
+    case QL_OP_GREATER_THAN:
+      return QL_OP_LESS_THAN;
+    case QL_OP_GREATER_THAN_EQUAL:
+      return QL_OP_LESS_THAN_EQUAL;
+    default:
+      return op;
+  }
+}
+
+// Clears selection of rows that do not match. null_matches is the result of the comparison for a
+// null column value. Written without branches on the values, so that the loop is vectorized.
+template <class T, class Op>
+void ApplyKernel(const T* values, const uint8_t* not_null, T constant, bool null_matches,
+                 size_t num_rows, const Op& op, uint8_t* selection) {
+  const uint8_t null_result = null_matches;
+  for (size_t i = 0; i != num_rows; ++i) {
+    selection[i] &= not_null[i] ? static_cast<uint8_t>(op(values[i], constant)) : null_result;
+  }
+}
+
+// Relational operators follow QLValuePB comparison: values are equal when neither is less than the
+// other (which matters for NaN), null values are equal only with null and not ordered.
+template <class T>
+void ApplyComparison(QLOperator op, const T* values, const uint8_t* not_null, T constant,
+                     size_t num_rows, uint8_t* selection) {
+  switch (op) {
+    case QL_OP_EQUAL:
+      ApplyKernel(values, not_null, constant, false, num_rows,
+                  [](T lhs, T rhs) { return !(lhs < rhs) & !(lhs > rhs); }, selection);
+      return;
+    case QL_OP_NOT_EQUAL:
+      ApplyKernel(values, not_null, constant, true, num_rows,
+                  [](T lhs, T rhs) { return (lhs < rhs) | (lhs > rhs); }, selection);
+      return;
+    case QL_OP_LESS_THAN:
+      ApplyKernel(values, not_null, constant, false, num_rows,
+                  [](T lhs, T rhs) { return lhs < rhs; }, selection);
+      return;
+    case QL_OP_LESS_THAN_EQUAL:
+      ApplyKernel(values, not_null, constant, false, num_rows,
+                  [](T lhs, T rhs) { return !(lhs > rhs); }, selection);
+      return;
+    case QL_OP_GREATER_THAN:
+      ApplyKernel(values, not_null, constant, false, num_rows,
+                  [](T lhs, T rhs) { return lhs > rhs; }, selection);
+      return;
+    case QL_OP_GREATER_THAN_EQUAL:
+      ApplyKernel(values, not_null, constant, false, num_rows,
+                  [](T lhs, T rhs) { return !(lhs < rhs); }, selection);
+      return;
+    default:
+      break;
+  }
+  LOG(FATAL) << "Unexpected operator: " << op;
+}
+
+} // namespace
+
+bool QLBatchFilter::Init(const PgsqlExpressionPB& where_expr, const QLColumnBatch& batch) {
+  comparisons_.clear();
+  if (!where_expr.has_condition() || !AddCondition(where_expr.condition(), batch)) {
+    comparisons_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool QLBatchFilter::AddCondition(const PgsqlConditionPB& condition, const QLColumnBatch& batch) {
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_AND:
+      if (operands.empty()) {
+        return false;
+      }
+      for (const auto& operand : operands) {
+        if (!operand.has_condition() || !AddCondition(operand.condition(), batch)) {
+          return false;
+        }
+      }
+      return true;
+
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL: {
+      if (operands.size() != 2) {
+        return false;
+      }
+      QLOperator op = condition.op();
+      const PgsqlExpressionPB* column = &operands.Get(0);
+      const PgsqlExpressionPB* constant = &operands.Get(1);
+      if (column->has_value() && constant->has_column_id()) {
+        std::swap(column, constant);
+        op = SwapOperands(op);
+      }
+      if (!column->has_column_id() || column->column_id() < 0 || !constant->has_value()) {
+        return false;
+      }
+      const int column_idx = batch.FindColumn(ColumnId(column->column_id()));
+      if (column_idx == QLColumnBatch::kColumnNotFound) {
+        return false;
+      }
+      const QLValuePB& value = constant->value();
+      Comparison comparison = { column_idx, op, value.value_case(), 0, 0 };
+      if (IsIntegerType(comparison.type)) {
+        comparison.int_value = GetNumericValue<int64_t>(value);
+      } else if (IsFloatingPointType(comparison.type)) {
+        comparison.double_value = GetNumericValue<double>(value);
+      } else {
+        return false;
+      }
+      comparisons_.push_back(comparison);
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+template <class T>
+Status QLBatchFilter::Unpack(
+    const QLColumnBatch& batch, const Comparison& comparison, std::vector<T>* values) {
+  const size_t num_rows = batch.num_rows();
+  values->resize(num_rows);
+  not_null_.resize(num_rows);
+  for (size_t row_idx = 0; row_idx != num_rows; ++row_idx) {
+    const QLValuePB& value = batch.value(comparison.column_idx, row_idx);
+    if (value.value_case() == comparison.type) {
+      (*values)[row_idx] = GetNumericValue<T>(value);
+      not_null_[row_idx] = 1;
+    } else if (QLValue::IsNull(value)) {
+      (*values)[row_idx] = T();
+      not_null_[row_idx] = 0;
+    } else {
+      return STATUS(RuntimeError, "values not comparable");
+    }
+  }
+  return Status::OK();
+}
+
+Status QLBatchFilter::Evaluate(const QLColumnBatch& batch, std::vector<uint8_t>* selection) {
+  const size_t num_rows = batch.num_rows();
+  selection->assign(num_rows, 1);
+  for (const auto& comparison : comparisons_) {
+    if (IsIntegerType(comparison.type)) {
+      RETURN_NOT_OK(Unpack(batch, comparison, &int_values_));
+      ApplyComparison(comparison.op, int_values_.data(), not_null_.data(), comparison.int_value,
+                      num_rows, selection->data());
+    } else {
+      RETURN_NOT_OK(Unpack(batch, comparison, &double_values_));
+      ApplyComparison(comparison.op, double_values_.data(), not_null_.data(),
+                      comparison.double_value, num_rows, selection->data());
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace yb
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains QLBatchFilter, which evaluates a WHERE condition over all rows of a
+// QLColumnBatch at once.
+
+#ifndef YB_COMMON_QL_BATCH_FILTER_H
+#define YB_COMMON_QL_BATCH_FILTER_H
+
+#include <vector>
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/ql_column_batch.h"
+#include "yb/common/ql_datatype.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+// A WHERE condition compiled into a flat list of comparisons of a numeric column with a constant,
+// all of which should hold for a row to match. Each comparison is evaluated over the whole batch:
+// column values are unpacked into a contiguous array once and compared in a tight loop that the
+// compiler vectorizes, instead of walking the expression tree and boxing values for every row.
+//
+// Only conjunctions of =, !=, <, <=, >, >= between an integer, timestamp, float or double column
+// and a non-null constant of the same type are supported. Other conditions are rejected by Init and
+// should be evaluated row by row with QLExprExecutor. The result is the same as the one of
+// QLExprExecutor for the supported conditions.
+class QLBatchFilter {
+ public:
+  QLBatchFilter() {}
+
+  // Compiles the condition for batches with the layout of the given batch. Returns false if the
+  // condition is not supported.
+  bool Init(const PgsqlExpressionPB& where_expr, const QLColumnBatch& batch);
+
+  // Sets (*selection)[row_idx] to 1 for rows of the batch that match the condition, and to 0 for
+  // the rest.
+  CHECKED_STATUS Evaluate(const QLColumnBatch& batch, std::vector<uint8_t>* selection);
+
+  size_t num_comparisons() const {
+    return comparisons_.size();
+  }
+
+ private:
+  struct Comparison {
+    int column_idx;
+    QLOperator op;
+    InternalType type;
+    // Constant to compare with, integer types and timestamps use int_value, floating point types
+    // use double_value.
+    int64_t int_value;
+    double double_value;
+  };
+
+  bool AddCondition(const PgsqlConditionPB& condition, const QLColumnBatch& batch);
+
+  // Unpacks values of the comparison column into values, sets not_null_ for non-null values.
+  template <class T>
+  CHECKED_STATUS Unpack(
+      const QLColumnBatch& batch, const Comparison& comparison, std::vector<T>* values);
+
+  std::vector<Comparison> comparisons_;
+
+  // Buffers reused across Evaluate calls.
+  std::vector<int64_t> int_values_;
+  std::vector<double> double_values_;
+  std::vector<uint8_t> not_null_;
+
+  DISALLOW_COPY_AND_ASSIGN(QLBatchFilter);
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_BATCH_FILTER_H
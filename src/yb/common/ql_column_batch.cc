@@ -0,0 +1,80 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_column_batch.h"
+
+namespace yb {
+
+void QLColumnBatch::Reset(const std::vector<ColumnId>& column_ids) {
+  if (column_ids != column_ids_) {
+    column_ids_ = column_ids;
+    columns_.clear();
+    columns_.resize(column_ids_.size());
+  }
+  num_rows_ = 0;
+}
+
+void QLColumnBatch::Reset(const Schema& schema, const Schema& projection) {
+  std::vector<ColumnId> column_ids;
+  column_ids.reserve(
+      schema.num_key_columns() + projection.num_columns() - projection.num_key_columns());
+  for (size_t i = 0; i < schema.num_key_columns(); i++) {
+    column_ids.push_back(schema.column_id(i));
+  }
+  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+    column_ids.push_back(projection.column_id(i));
+  }
+  Reset(column_ids);
+}
+
+size_t QLColumnBatch::AddRow() {
+  const size_t row_idx = num_rows_++;
+  for (auto& column : columns_) {
+    if (column.size() < num_rows_) {
+      column.emplace_back();
+    } else {
+      column[row_idx].Clear();
+    }
+  }
+  return row_idx;
+}
+
+int QLColumnBatch::FindColumn(ColumnId column_id) const {
+  for (size_t i = 0; i != column_ids_.size(); ++i) {
+    if (column_ids_[i] == column_id) {
+      return i;
+    }
+  }
+  return kColumnNotFound;
+}
+
+std::string QLColumnBatch::ToString() const {
+  std::string result = "{ ";
+  for (size_t row_idx = 0; row_idx != num_rows_; ++row_idx) {
+    if (row_idx > 0) {
+      result += ", ";
+    }
+    result += "{ ";
+    for (size_t col_idx = 0; col_idx != columns_.size(); ++col_idx) {
+      if (col_idx > 0) {
+        result += ", ";
+      }
+      result += columns_[col_idx][row_idx].ShortDebugString();
+    }
+    result += " }";
+  }
+  result += " }";
+  return result;
+}
+
+} // namespace yb
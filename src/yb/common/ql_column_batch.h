@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains QLColumnBatch, a column-major block of rows filled by
+// YQLRowwiseIteratorIf::NextBatch.
+
+#ifndef YB_COMMON_QL_COLUMN_BATCH_H
+#define YB_COMMON_QL_COLUMN_BATCH_H
+
+#include <vector>
+
+#include "yb/common/common.pb.h"
+#include "yb/common/schema.h"
+
+namespace yb {
+
+// A batch of rows stored column by column. Every column holds exactly num_rows() values, a missing
+// column value is stored as a null QLValuePB. Values are kept across Clear() calls so that
+// repeated scans into the same batch reuse protobuf allocations instead of creating new ones for
+// every row.
+class QLColumnBatch {
+ public:
+  static constexpr int kColumnNotFound = -1;
+
+  QLColumnBatch() {}
+
+  // Sets the columns of the batch and removes all rows. Allocated values are kept for reuse when
+  // the columns did not change.
+  void Reset(const std::vector<ColumnId>& column_ids);
+
+  // Sets the columns of the batch to the key columns of the schema followed by the non-key columns
+  // of the projection, which is the layout produced by YQLRowwiseIteratorIf::NextBatch.
+  void Reset(const Schema& schema, const Schema& projection);
+
+  // Removes all rows, keeping allocated values for reuse.
+  void Clear() {
+    num_rows_ = 0;
+  }
+
+  // Appends a row with all columns set to null and returns its index.
+  size_t AddRow();
+
+  size_t num_rows() const {
+    return num_rows_;
+  }
+
+  size_t num_columns() const {
+    return column_ids_.size();
+  }
+
+  const std::vector<ColumnId>& column_ids() const {
+    return column_ids_;
+  }
+
+  // Returns index of the column with the given id in this batch, or kColumnNotFound.
+  int FindColumn(ColumnId column_id) const;
+
+  const QLValuePB& value(size_t column_idx, size_t row_idx) const {
+    DCHECK_LT(row_idx, num_rows_);
+    return columns_[column_idx][row_idx];
+  }
+
+  QLValuePB* mutable_value(size_t column_idx, size_t row_idx) {
+    DCHECK_LT(row_idx, num_rows_);
+    return &columns_[column_idx][row_idx];
+  }
+
+  std::string ToString() const;
+
+ private:
+  std::vector<ColumnId> column_ids_;
+  std::vector<std::vector<QLValuePB>> columns_;
+  size_t num_rows_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(QLColumnBatch);
+};
+
+} // namespace yb
+
+#endif // YB_COMMON_QL_COLUMN_BATCH_H
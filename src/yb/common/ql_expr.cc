@@ -37,9 +37,9 @@ CHECKED_STATUS QLExprExecutor::EvalExpr(const QLExpressionPB& ql_expr,
       QLExprResult temp;
       const QLJsonColumnOperationsPB& json_ops = ql_expr.json_column();
       RETURN_NOT_OK(table_row.ReadColumn(json_ops.column_id(), temp.Writer()));
-      common::Jsonb jsonb;
-      temp.MoveToJsonb(&jsonb);
-      RETURN_NOT_OK(jsonb.ApplyJsonbOperators(json_ops, &result_writer.NewValue()));
+      // The operators navigate the serialized document of the column, which is not copied.
+      RETURN_NOT_OK(common::Jsonb::ApplyJsonbOperators(
+          temp.Value().jsonb_value(), json_ops, &result_writer.NewValue()));
       break;
     }
 
@@ -732,15 +732,6 @@ std::string QLTableRow::ToString(const Schema& schema) const {
   return ret;
 }
 
-void QLExprResult::MoveToJsonb(common::Jsonb* out) {
-  if (existing_value_) {
-    out->Assign(existing_value_->jsonb_value());
-    existing_value_ = nullptr;
-  } else {
-    out->Assign(std::move(*value_.mutable_value()->mutable_jsonb_value()));
-  }
-}
-
 const QLValuePB& QLExprResult::Value() const {
   if (existing_value_) {
     return *existing_value_;
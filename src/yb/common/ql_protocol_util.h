@@ -71,11 +71,7 @@ void QLAddNullColumnValue(QLWriteRequestPB* req, int column_id);
 
 template <class RequestPB>
 void QLSetHashCode(RequestPB* req) {
-  std::string tmp;
-  for (const auto& column : req->hashed_column_values()) {
-    AppendToKey(column.value(), &tmp);
-  }
-  req->set_hash_code(YBPartition::HashColumnCompoundValue(tmp));
+  req->set_hash_code(YBPartition::HashColumnValues(req->hashed_column_values()));
 }
 
 QLValuePB* QLPrepareColumn(QLWriteRequestPB* req, int column_id);
@@ -174,6 +174,20 @@ Status QLRowBlock::AppendRowsData(const QLClient client, const string& src, stri
   return Status::OK();
 }
 
+Status QLRowBlock::AppendRowsData(const QLClient client, string&& src, string* dst) {
+  CHECK_EQ(client, YQL_CLIENT_CQL);
+  Slice src_slice(src);
+  const int32_t src_cnt = VERIFY_RESULT(CQLDecodeLength(&src_slice));
+  if (src_cnt > 0) {
+    Slice dst_slice(*dst);
+    if (VERIFY_RESULT(CQLDecodeLength(&dst_slice)) == 0) {
+      *dst = std::move(src);
+      return Status::OK();
+    }
+  }
+  return AppendRowsData(client, src, dst);
+}
+
 string QLRowBlock::ZeroRowsData(const QLClient client) {
   CHECK_EQ(client, YQL_CLIENT_CQL);
   return string(sizeof(int32_t), 0); // Encode 32-bit 0 length.
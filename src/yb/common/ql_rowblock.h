@@ -118,6 +118,9 @@ class QLRowBlock {
   // Append rows data. Caller should ensure the column schemas are the same.
   static CHECKED_STATUS AppendRowsData(QLClient client, const std::string& src, std::string* dst);
 
+  // Same as above, but moves src to dst instead of copying it, when dst has no rows yet.
+  static CHECKED_STATUS AppendRowsData(QLClient client, std::string&& src, std::string* dst);
+
   // Return rows data of 0 (empty) rows.
   static std::string ZeroRowsData(QLClient client);
 
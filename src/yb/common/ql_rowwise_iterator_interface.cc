@@ -0,0 +1,41 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_rowwise_iterator_interface.h"
+
+#include "yb/common/ql_column_batch.h"
+#include "yb/common/ql_expr.h"
+
+namespace yb {
+namespace common {
+
+Result<size_t> YQLRowwiseIteratorIf::NextBatch(
+    const Schema& projection, size_t max_rows, QLColumnBatch* batch) {
+  batch->Reset(schema(), projection);
+  QLTableRow row;
+  while (batch->num_rows() < max_rows && VERIFY_RESULT(HasNext())) {
+    row.Clear();
+    RETURN_NOT_OK(NextRow(projection, &row));
+    const size_t row_idx = batch->AddRow();
+    for (size_t col_idx = 0; col_idx != batch->num_columns(); ++col_idx) {
+      auto value = row.GetValue(batch->column_ids()[col_idx]);
+      if (value) {
+        *batch->mutable_value(col_idx, row_idx) = *value;
+      }
+    }
+  }
+  return batch->num_rows();
+}
+
+}  // namespace common
+}  // namespace yb
@@ -16,6 +16,7 @@
 
 #include <memory>
 
+#include "yb/util/monotime.h"
 #include "yb/util/result.h"
 #include "yb/util/status.h"
 #include "yb/docdb/doc_key.h"
@@ -25,6 +26,7 @@ namespace yb {
 class HybridTime;
 class PgsqlReadRequestPB;
 class PgsqlResponsePB;
+class QLColumnBatch;
 class QLReadRequestPB;
 class QLResponsePB;
 class QLTableRow;
@@ -80,6 +82,9 @@ class YQLRowwiseIteratorIf {
     return STATUS(NotSupported, "This iterator cannot seek by tuple id");
   }
 
+  // Updates the deadline, used when the iterator is kept to continue the scan in another request.
+  virtual void SetDeadline(CoarseTimePoint deadline) {}
+
   //------------------------------------------------------------------------------------------------
   // Common API methods.
   //------------------------------------------------------------------------------------------------
@@ -92,6 +97,13 @@ class YQLRowwiseIteratorIf {
     return DoNextRow(schema(), table_row);
   }
 
+  // Reads up to max_rows next rows into the batch using the specified projection. The batch is
+  // reset to the key columns followed by the non-key projection columns. Only column values are
+  // read: TTL and write time are not available through the batch. Returns the number of rows read,
+  // zero means that the iterator is exhausted.
+  virtual Result<size_t> NextBatch(
+      const Schema& projection, size_t max_rows, QLColumnBatch* batch);
+
  private:
   virtual CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) = 0;
 };
@@ -97,6 +97,15 @@ class YQLStorageIf {
                                      const ReadHybridTime& read_time,
                                      const QLValuePB& ybctid,
                                      common::YQLRowwiseIteratorIf::UniPtr* iter) const = 0;
+
+  // Create iterator for querying multiple rows by ybctid with SeekTuple. The same iterator is
+  // reused for all rows, so tuples should be sought in increasing ybctid order.
+  virtual CHECKED_STATUS GetTupleIterator(const Schema& projection,
+                                          const Schema& schema,
+                                          const TransactionOperationContextOpt& txn_op_context,
+                                          CoarseTimePoint deadline,
+                                          const ReadHybridTime& read_time,
+                                          common::YQLRowwiseIteratorIf::UniPtr* iter) const = 0;
 };
 
 }  // namespace common
@@ -97,6 +97,9 @@ void TableProperties::ToTablePropertiesPB(TablePropertiesPB *pb) const {
   }
   pb->set_is_ysql_catalog_table(is_ysql_catalog_table_);
   pb->set_is_backfilling(is_backfilling_);
+  if (in_memory_image_) {
+    pb->set_in_memory_image(in_memory_image_);
+  }
 }
 
 TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB& pb) {
@@ -128,6 +131,9 @@ TableProperties TableProperties::FromTablePropertiesPB(const TablePropertiesPB&
   if (pb.has_is_backfilling()) {
     table_properties.SetIsBackfilling(pb.is_backfilling());
   }
+  if (pb.has_in_memory_image()) {
+    table_properties.SetInMemoryImage(pb.in_memory_image());
+  }
   return table_properties;
 }
 
@@ -156,6 +162,9 @@ void TableProperties::AlterFromTablePropertiesPB(const TablePropertiesPB& pb) {
   if (pb.has_is_backfilling()) {
     SetIsBackfilling(pb.is_backfilling());
   }
+  if (pb.has_in_memory_image()) {
+    SetInMemoryImage(pb.in_memory_image());
+  }
 }
 
 void TableProperties::Reset() {
@@ -168,6 +177,7 @@ void TableProperties::Reset() {
   num_tablets_ = 0;
   is_ysql_catalog_table_ = false;
   is_backfilling_ = false;
+  in_memory_image_ = false;
 }
 
 string TableProperties::ToString() const {
@@ -458,6 +458,10 @@ class TableProperties {
 
   void SetIsBackfilling(bool is_backfilling) { is_backfilling_ = is_backfilling; }
 
+  bool in_memory_image() const { return in_memory_image_; }
+
+  void SetInMemoryImage(bool in_memory_image) { in_memory_image_ = in_memory_image; }
+
   void ToTablePropertiesPB(TablePropertiesPB *pb) const;
 
   static TableProperties FromTablePropertiesPB(const TablePropertiesPB& pb);
@@ -480,6 +484,7 @@ class TableProperties {
   bool use_mangled_column_name_ = false;
   int num_tablets_ = 0;
   bool is_ysql_catalog_table_ = false;
+  bool in_memory_image_ = false;
 };
 
 typedef uint32_t PgTableOid;
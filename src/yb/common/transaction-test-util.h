@@ -16,6 +16,9 @@
 #ifndef YB_COMMON_TRANSACTION_TEST_UTIL_H
 #define YB_COMMON_TRANSACTION_TEST_UTIL_H
 
+#include <map>
+#include <string>
+
 #include <gtest/gtest.h>
 
 #include "yb/common/hybrid_time.h"
@@ -57,8 +60,15 @@ class TransactionStatusManagerMock : public TransactionStatusManager {
   void FillPriorities(
       boost::container::small_vector_base<std::pair<TransactionId, uint64_t>>* inout) override {}
 
+  // Number of the status requests received with the given reason.
+  size_t NumStatusRequests(const std::string& reason) const {
+    auto it = num_status_requests_.find(reason);
+    return it == num_status_requests_.end() ? 0 : it->second;
+  }
+
  private:
   std::unordered_map<TransactionId, HybridTime, TransactionIdHash> txn_commit_time_;
+  std::map<std::string, size_t> num_status_requests_;
 };
 
 } // namespace yb
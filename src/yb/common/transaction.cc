@@ -43,6 +43,7 @@ Result<TransactionMetadata> TransactionMetadata::FromPB(const TransactionMetadat
     result.status_tablet = source.status_tablet();
     result.priority = source.priority();
     result.start_time = HybridTime(source.start_hybrid_time());
+    result.wait_on_conflict = source.wait_on_conflict();
   }
   return result;
 }
@@ -61,6 +62,9 @@ void TransactionMetadata::ForceToPB(TransactionMetadataPB* dest) const {
   dest->set_status_tablet(status_tablet);
   dest->set_priority(priority);
   dest->set_start_hybrid_time(start_time.ToUint64());
+  if (wait_on_conflict) {
+    dest->set_wait_on_conflict(true);
+  }
 }
 
 bool operator==(const TransactionMetadata& lhs, const TransactionMetadata& rhs) {
@@ -68,7 +72,8 @@ bool operator==(const TransactionMetadata& lhs, const TransactionMetadata& rhs)
          lhs.isolation == rhs.isolation &&
          lhs.status_tablet == rhs.status_tablet &&
          lhs.priority == rhs.priority &&
-         lhs.start_time == rhs.start_time;
+         lhs.start_time == rhs.start_time &&
+         lhs.wait_on_conflict == rhs.wait_on_conflict;
 }
 
 std::ostream& operator<<(std::ostream& out, const TransactionMetadata& metadata) {
@@ -25,6 +25,7 @@
 #include "yb/common/common.pb.h"
 #include "yb/common/entity_ids.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/read_hybrid_time.h"
 
 #include "yb/util/async_util.h"
 #include "yb/util/enums.h"
@@ -189,6 +190,54 @@ class RequestScope {
   int64_t request_id_;
 };
 
+// Commit times of other transactions resolved while reading intents at the given read time.
+// Shared by all intent aware iterators created for a single read operation, so a transaction seen
+// by several iterators (e.g. a multi-key read, or an index scan and its base table lookups) is
+// resolved only once. Not thread safe, a read operation uses its iterators from one thread.
+class TransactionCommitTimeCache {
+ public:
+  explicit TransactionCommitTimeCache(const ReadHybridTime& read_time) : read_time_(read_time) {}
+
+  // Cached commit times are valid only for reads that would resolve them the same way.
+  bool Matches(const ReadHybridTime& read_time) const {
+    return read_time.read == read_time_.read && read_time.global_limit == read_time_.global_limit;
+  }
+
+  // Returns cached commit time of the transaction, or HybridTime::kInvalid if it is not cached.
+  HybridTime Get(const TransactionId& transaction_id) {
+    auto it = commit_times_.find(transaction_id);
+    if (it == commit_times_.end()) {
+      ++misses_;
+      return HybridTime::kInvalid;
+    }
+    ++hits_;
+    return it->second;
+  }
+
+  // Unlike Get, does not account hits and misses.
+  bool Contains(const TransactionId& transaction_id) const {
+    return commit_times_.count(transaction_id) != 0;
+  }
+
+  void Put(const TransactionId& transaction_id, HybridTime commit_time) {
+    commit_times_.emplace(transaction_id, commit_time);
+  }
+
+  size_t hits() const {
+    return hits_;
+  }
+
+  size_t misses() const {
+    return misses_;
+  }
+
+ private:
+  const ReadHybridTime read_time_;
+  std::unordered_map<TransactionId, HybridTime, TransactionIdHash> commit_times_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+};
+
 struct TransactionOperationContext {
   TransactionOperationContext(
       const TransactionId& transaction_id_, TransactionStatusManager* txn_status_manager_)
@@ -199,6 +248,9 @@ struct TransactionOperationContext {
 
   TransactionId transaction_id;
   TransactionStatusManager& txn_status_manager;
+
+  // Optional commit time cache shared by the iterators of one read operation.
+  std::shared_ptr<TransactionCommitTimeCache> commit_time_cache;
 };
 
 typedef boost::optional<TransactionOperationContext> TransactionOperationContextOpt;
@@ -224,6 +276,10 @@ struct TransactionMetadata {
   // start_time is used only for backward compability during rolling update.
   HybridTime start_time;
 
+  // Whether a write conflicting with a pending transaction of higher priority should wait for it
+  // to complete, instead of failing with a conflict.
+  bool wait_on_conflict = false;
+
   static Result<TransactionMetadata> FromPB(const TransactionMetadataPB& source);
 
   void ToPB(TransactionMetadataPB* dest) const;
@@ -233,8 +289,10 @@ struct TransactionMetadata {
 
   std::string ToString() const {
     return Format(
-        "{ transaction_id: $0 isolation: $1 status_tablet: $2 priority: $3 start_time: $4 }",
-        transaction_id, IsolationLevel_Name(isolation), status_tablet, priority, start_time);
+        "{ transaction_id: $0 isolation: $1 status_tablet: $2 priority: $3 start_time: $4 "
+            "wait_on_conflict: $5 }",
+        transaction_id, IsolationLevel_Name(isolation), status_tablet, priority, start_time,
+        wait_on_conflict);
   }
 };
 
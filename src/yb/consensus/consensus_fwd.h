@@ -53,6 +53,9 @@ typedef scoped_refptr<LeaderElection> LeaderElectionPtr;
 class PeerProxy;
 typedef std::unique_ptr<PeerProxy> PeerProxyPtr;
 
+class MultiRaftHeartbeatBatcher;
+typedef std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcherPtr;
+
 struct LeaderElectionData;
 
 // The elected Leader (this peer) can be in not-ready state because it's not yet synced.
@@ -48,6 +48,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/map-util.h"
@@ -83,6 +84,12 @@ DEFINE_int32(max_wait_for_processresponse_before_closing_ms,
              "finish before returning proceding to close the Peer and return");
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, true,
+            "Whether heartbeats from leaders of different tablets to the same server should be "
+            "combined into a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, runtime);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -306,12 +313,28 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   processing_lock.unlock();
   performing_lock.release();
 
+  // Send the wire form of ops shared with requests to other peers, instead of serializing the ops
+  // as a part of this request.
+  if (msgs_holder.has_serialized_ops() && proxy_->SupportsSerializedOps()) {
+    auto serialized_ops = msgs_holder.TakeSerializedOps();
+    DCHECK_EQ(serialized_ops.size(), request_.ops_size());
+    for (auto& serialized_op : serialized_ops) {
+      controller_.AddSerializedRequestField(std::move(serialized_op));
+    }
+    request_.mutable_ops()->ExtractSubrange(0, request_.ops_size(), nullptr /* elements */);
+  }
+
   // We will cleanup ops from request in ProcessResponse, because otherwise there could be race
   // condition. When rest of this function is running in parallel to ProcessResponse.
   msgs_holder.ReleaseOps();
 
-  proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
-                      std::bind(&Peer::ProcessResponse, retain_self));
+  if (req_has_ops) {
+    proxy_->UpdateAsync(&request_, trigger_mode, &response_, &controller_,
+                        std::bind(&Peer::ProcessResponse, retain_self));
+  } else {
+    proxy_->HeartbeatAsync(&request_, &response_, &controller_,
+                           std::bind(&Peer::ProcessResponse, retain_self));
+  }
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -499,8 +522,10 @@ Peer::~Peer() {
   CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           MultiRaftHeartbeatBatcherPtr multi_raft_batcher)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      multi_raft_batcher_(std::move(multi_raft_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -512,6 +537,19 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
 
+void RpcPeerProxy::HeartbeatAsync(const ConsensusRequestPB* request,
+                                  ConsensusResponsePB* response,
+                                  rpc::RpcController* controller,
+                                  const rpc::ResponseCallback& callback) {
+  if (!multi_raft_batcher_ || !FLAGS_enable_multi_raft_heartbeat_batcher ||
+      !controller->serialized_request_fields().empty()) {
+    UpdateAsync(request, RequestTriggerMode::kAlwaysSend, response, controller, callback);
+    return;
+  }
+  controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  multi_raft_batcher_->AddRequestToBatch(request, response, controller, callback);
+}
+
 void RpcPeerProxy::RequestConsensusVoteAsync(const VoteRequestPB* request,
                                              VoteResponsePB* response,
                                              rpc::RpcController* controller,
@@ -550,7 +588,12 @@ RpcPeerProxyFactory::RpcPeerProxyFactory(
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  MultiRaftHeartbeatBatcherPtr multi_raft_batcher;
+  if (messenger_) {
+    multi_raft_batcher = MultiRaftHeartbeatBatcher::ForHost(messenger_, proxy_cache_, hostport);
+  }
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(multi_raft_batcher));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
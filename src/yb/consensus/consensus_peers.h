@@ -263,6 +263,16 @@ class PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) = 0;
 
+  // Sends a request without ops, which only maintains the leadership and informs the peer about
+  // the leader state. Such requests could be delayed for a short time, to be combined with requests
+  // of other tablets.
+  virtual void HeartbeatAsync(const ConsensusRequestPB* request,
+                              ConsensusResponsePB* response,
+                              rpc::RpcController* controller,
+                              const rpc::ResponseCallback& callback) {
+    UpdateAsync(request, RequestTriggerMode::kAlwaysSend, response, controller, callback);
+  }
+
   // Sends a RequestConsensusVote to a remote peer.
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
@@ -292,6 +302,10 @@ class PeerProxy {
     LOG(DFATAL) << "Not implemented";
   }
 
+  // Whether the proxy sends requests over the wire, so ops could be attached to the request in
+  // their wire form, using RpcController::AddSerializedRequestField.
+  virtual bool SupportsSerializedOps() const { return false; }
+
   virtual ~PeerProxy() {}
 };
 
@@ -313,7 +327,8 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               MultiRaftHeartbeatBatcherPtr multi_raft_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -321,11 +336,18 @@ class RpcPeerProxy : public PeerProxy {
                            rpc::RpcController* controller,
                            const rpc::ResponseCallback& callback) override;
 
+  void HeartbeatAsync(const ConsensusRequestPB* request,
+                      ConsensusResponsePB* response,
+                      rpc::RpcController* controller,
+                      const rpc::ResponseCallback& callback) override;
+
   virtual void RequestConsensusVoteAsync(const VoteRequestPB* request,
                                          VoteResponsePB* response,
                                          rpc::RpcController* controller,
                                          const rpc::ResponseCallback& callback) override;
 
+  bool SupportsSerializedOps() const override { return true; }
+
   virtual void StartRemoteBootstrap(const StartRemoteBootstrapRequestPB* request,
                                     StartRemoteBootstrapResponsePB* response,
                                     rpc::RpcController* controller,
@@ -346,6 +368,7 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  MultiRaftHeartbeatBatcherPtr multi_raft_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
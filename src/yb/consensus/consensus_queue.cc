@@ -85,6 +85,12 @@ DEFINE_int32(consensus_max_batch_size_bytes, 4_MB,
 TAG_FLAG(consensus_max_batch_size_bytes, advanced);
 TAG_FLAG(consensus_max_batch_size_bytes, runtime);
 
+DEFINE_bool(consensus_share_serialized_ops, true,
+            "Serialize each operation sent to peers only once and keep its wire form in the log "
+            "cache, so requests to all peers share it instead of serializing the operation again.");
+TAG_FLAG(consensus_share_serialized_ops, advanced);
+TAG_FLAG(consensus_share_serialized_ops, runtime);
+
 DEFINE_int32(follower_unavailable_considered_failed_sec, 900,
              "Seconds that a leader is unable to successfully heartbeat to a "
              "follower after which the follower is considered to be failed and "
@@ -535,8 +541,16 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     if (result->read_from_disk_size) {
       consumption = ScopedTrackedConsumption(operations_mem_tracker_, result->read_from_disk_size);
     }
+    const bool share_serialized_ops =
+        FLAGS_consensus_share_serialized_ops && !result->messages.empty();
+    if (share_serialized_ops) {
+      log_cache_.SerializeOps(&*result);
+    }
     *msgs_holder = ReplicateMsgsHolder(
         request->mutable_ops(), std::move(result->messages), std::move(consumption));
+    if (share_serialized_ops) {
+      msgs_holder->SetSerializedOps(std::move(result->serialized_ops));
+    }
 
     if (propagated_safe_time && !result->have_more_messages) {
       // Get the current local safe time on the leader and propagate it to the follower.
@@ -39,6 +39,7 @@
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <glog/stl_logging.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log-test-base.h"
@@ -51,6 +52,7 @@
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
+DECLARE_int32(log_max_recycled_segments);
 DECLARE_int32(log_min_segments_to_retain);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
@@ -771,6 +773,59 @@ TEST_F(LogTest, TestLogReopenAndGC) {
   ASSERT_OK(log_anchor_registry_->Unregister(anchors[3]));
 }
 
+TEST_F(LogTest, TestRecycleSegments) {
+  FLAGS_log_max_recycled_segments = 2;
+  BuildLog();
+
+  vector<LogAnchor*> anchors;
+  ElementDeleter deleter(&anchors);
+
+  const int kNumOpsPerSegment = 5;
+  int num_gced_segments;
+  OpId op_id = MakeOpId(1, 1);
+
+  auto count_recycled_files = [this] {
+    vector<string> files;
+    CHECK_OK(env_->GetChildren(tablet_wal_path_, &files));
+    return std::count_if(files.begin(), files.end(), [](const string& file) {
+      return HasPrefixString(file, ".recycled.");
+    });
+  };
+
+  ASSERT_OK(AppendMultiSegmentSequence(4, kNumOpsPerSegment, &op_id, nullptr));
+  ASSERT_OK(log_->GC(op_id.index(), &num_gced_segments));
+  ASSERT_EQ(2, num_gced_segments);
+  ASSERT_EQ(2, count_recycled_files());
+  CheckRightNumberOfSegmentFiles(2);
+
+  // The next two segments are written to the recycled files, leftovers of the previous segments
+  // should not be read.
+  ASSERT_OK(RollLog());
+  ASSERT_OK(AppendMultiSegmentSequence(2, kNumOpsPerSegment, &op_id, nullptr));
+  ASSERT_EQ(0, count_recycled_files());
+  CheckRightNumberOfSegmentFiles(4);
+
+  SegmentSequence segments;
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(4, segments.size()) << DumpSegmentsToString(segments);
+  ASSERT_EQ(0, segments[1]->header().recycle_epoch());
+  ASSERT_EQ(1, segments[2]->header().recycle_epoch());
+  ASSERT_EQ(1, segments[3]->header().recycle_epoch());
+  segments.clear();
+  ASSERT_OK(log_->Close());
+
+  BuildLog();
+  ASSERT_OK(log_->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(5, segments.size()) << DumpSegmentsToString(segments);
+  size_t num_entries = 0;
+  for (const auto& segment : segments) {
+    auto read_result = segment->ReadEntries();
+    ASSERT_OK(read_result.status);
+    num_entries += read_result.entries.size();
+  }
+  ASSERT_EQ(4 * kNumOpsPerSegment, num_entries);
+}
+
 // Helper to measure the performance of the log.
 TEST_F(LogTest, TestWriteManyBatches) {
   uint64_t num_batches = 10;
@@ -1140,5 +1195,38 @@ TEST_F(LogTest, TestReadReplicatesHighIndex) {
   ASSERT_EQ(kSequenceLength, repls.size());
 }
 
+// Test that the wire form of replicates is taken from the log segment.
+TEST_F(LogTest, TestReadSerializedReplicates) {
+  const int kSequenceLength = 10;
+
+  BuildLog();
+  OpId op_id = MakeOpId(1, 1);
+  ASSERT_OK(AppendNoOps(&op_id, kSequenceLength));
+
+  // Use the tag of ConsensusRequestPB::ops, as it is done when sending ops to peers.
+  const uint32_t kTag = google::protobuf::internal::WireFormatLite::MakeTag(
+      consensus::ConsensusRequestPB::kOpsFieldNumber,
+      google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  auto* reader = log_->GetLogReader();
+  ReplicateMsgs repls;
+  std::vector<RefCntBuffer> serialized;
+  ASSERT_OK(reader->ReadReplicatesInRange(
+      1, kSequenceLength, LogReader::kNoSizeLimit, kTag, &repls, &serialized));
+  ASSERT_EQ(kSequenceLength, repls.size());
+  ASSERT_EQ(kSequenceLength, serialized.size());
+
+  std::string data;
+  for (const auto& buffer : serialized) {
+    ASSERT_TRUE(buffer);
+    data.append(buffer.data(), buffer.size());
+  }
+  consensus::ConsensusRequestPB request;
+  ASSERT_TRUE(request.ParsePartialFromString(data));
+  ASSERT_EQ(kSequenceLength, request.ops_size());
+  for (int i = 0; i != kSequenceLength; ++i) {
+    ASSERT_EQ(repls[i]->SerializeAsString(), request.ops(i).SerializeAsString());
+  }
+}
+
 } // namespace log
 } // namespace yb
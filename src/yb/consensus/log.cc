@@ -44,13 +44,16 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/stl_util.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/gutil/walltime.h"
 #include "yb/util/coding.h"
 #include "yb/util/countdown_latch.h"
@@ -144,6 +147,32 @@ DEFINE_int32(taskstream_queue_max_size, 100000,
 DEFINE_int32(taskstream_queue_max_wait_ms, 1000,
              "Maximum time in ms to wait for items in the taskstream queue to arrive.");
 
+DEFINE_bool(log_sync_across_tablets, false,
+            "When WAL writes are not durable on every append, do the periodic WAL syncs of all "
+            "tablets with WALs on the same file system together, with a single sync of the file "
+            "system instead of an fsync per tablet. Best suited for WALs on a dedicated volume, "
+            "since other dirty data of the file system is synced as well.");
+TAG_FLAG(log_sync_across_tablets, advanced);
+
+DEFINE_int32(log_group_commit_max_wait_us, 0,
+             "With durable_wal_write, the maximum time in microseconds the log appender waits for "
+             "more entry batches to join a group before syncing it. The actual wait is tuned "
+             "online: it grows up to half of the observed sync latency while batches arrive "
+             "concurrently and shrinks when waiting does not pay off. 0 to sync groups as soon "
+             "as the queue is drained.");
+TAG_FLAG(log_group_commit_max_wait_us, runtime);
+TAG_FLAG(log_group_commit_max_wait_us, advanced);
+
+DEFINE_int32(log_max_recycled_segments, 0,
+             "The maximum number of files of garbage collected log segments each tablet keeps to "
+             "be overwritten by new segments, instead of deleting old segment files and creating "
+             "new ones. Recycling avoids file system metadata updates at rollover, at the cost of "
+             "the disk space taken by the kept files. Segments written to recycled files can't be "
+             "read by versions without support for recycling. Not used with durable_wal_write. "
+             "0 to disable recycling.");
+TAG_FLAG(log_max_recycled_segments, runtime);
+TAG_FLAG(log_max_recycled_segments, advanced);
+
 // Validate that log_min_segments_to_retain >= 1
 static bool ValidateLogsToRetain(const char* flagname, int value) {
   if (value >= 1) {
@@ -157,6 +186,9 @@ static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
+// Files of recycled segments are named .recycled.<epoch>.<name of the GC'd segment>, so they are
+// ignored by the log reader.
+static const char kRecycledSegmentPrefix[] = ".recycled.";
 
 namespace yb {
 namespace log {
@@ -199,6 +231,12 @@ class Log::Appender {
   void ProcessBatch(LogEntryBatch* entry_batch);
   void GroupWork();
 
+  // Returns how long to wait for more entry batches to join the current group before syncing it.
+  MonoDelta GroupWait(size_t group_size);
+
+  // Tunes group_wait_budget_us_ after a group of group_size batches was synced in sync_time.
+  void UpdateGroupWaitBudget(size_t group_size, MonoDelta sync_time);
+
   Log* const log_;
 
   // Lock to protect access to thread_ during shutdown.
@@ -210,6 +248,15 @@ class Log::Appender {
 
   // Time at which current group was started
   MonoTime time_started_;
+
+  // Time at which the appender started waiting for more batches to join the current group.
+  MonoTime wait_started_;
+
+  // Exponentially weighted moving average of the sync latency, in microseconds.
+  double avg_sync_us_ = 0;
+
+  // Current budget for waiting for more batches to join a group, in microseconds.
+  int64_t group_wait_budget_us_ = 0;
 };
 
 Log::Appender::Appender(Log *log, ThreadPool* append_thread_pool)
@@ -217,7 +264,8 @@ Log::Appender::Appender(Log *log, ThreadPool* append_thread_pool)
       task_stream_(new TaskStream<LogEntryBatch>(
           std::bind(&Log::Appender::ProcessBatch, this, _1), append_thread_pool,
           FLAGS_taskstream_queue_max_size,
-          MonoDelta::FromMilliseconds(FLAGS_taskstream_queue_max_wait_ms))) {
+          MonoDelta::FromMilliseconds(FLAGS_taskstream_queue_max_wait_ms),
+          std::bind(&Log::Appender::GroupWait, this, _1))) {
   DCHECK(dummy);
 }
 
@@ -266,15 +314,59 @@ void Log::Appender::ProcessBatch(LogEntryBatch* entry_batch) {
   sync_batch_.emplace_back(entry_batch);
 }
 
+MonoDelta Log::Appender::GroupWait(size_t group_size) {
+  // Waiting pays off only when every group is synced.
+  if (!log_->durable_wal_write_ || log_->sync_disabled_ || group_wait_budget_us_ <= 0 ||
+      sync_batch_.empty()) {
+    return MonoDelta::kZero;
+  }
+  auto now = MonoTime::Now();
+  if (!wait_started_) {
+    wait_started_ = now;
+  }
+  return time_started_ + MonoDelta::FromMicroseconds(group_wait_budget_us_) - now;
+}
+
+void Log::Appender::UpdateGroupWaitBudget(size_t group_size, MonoDelta sync_time) {
+  // Minimal budget, used when batches start to arrive concurrently.
+  constexpr int64_t kMinGroupWaitUs = 10;
+  constexpr double kSyncLatencySmoothingFactor = 0.2;
+
+  const int64_t max_wait_us = GetAtomicFlag(&FLAGS_log_group_commit_max_wait_us);
+  if (max_wait_us <= 0 || !log_->durable_wal_write_) {
+    group_wait_budget_us_ = 0;
+    return;
+  }
+  const double sync_us = sync_time.ToMicroseconds();
+  avg_sync_us_ = avg_sync_us_ == 0
+      ? sync_us : avg_sync_us_ + kSyncLatencySmoothingFactor * (sync_us - avg_sync_us_);
+  // Waiting for at most half of the sync latency bounds the added latency, while letting the
+  // batches that arrive meanwhile share the sync.
+  const int64_t target_us = std::min<int64_t>(max_wait_us, avg_sync_us_ / 2);
+  if (group_size > 1) {
+    group_wait_budget_us_ = std::min(target_us, std::max(group_wait_budget_us_ * 2,
+                                                         kMinGroupWaitUs));
+  } else {
+    // Nobody joined the group, waiting only adds latency.
+    group_wait_budget_us_ /= 2;
+  }
+}
+
 void Log::Appender::GroupWork() {
   if (sync_batch_.empty()) {
     Status s = log_->Sync();
     return;
   }
+  const size_t group_size = sync_batch_.size();
   if (log_->metrics_) {
-    log_->metrics_->entry_batches_per_group->Increment(sync_batch_.size());
+    log_->metrics_->entry_batches_per_group->Increment(group_size);
+    if (wait_started_) {
+      log_->metrics_->group_commit_wait_time->Increment(
+          MonoTime::Now().GetDeltaSince(wait_started_).ToMicroseconds());
+    }
   }
-  TRACE_EVENT1("log", "batch", "batch_size", sync_batch_.size());
+  wait_started_ = MonoTime();
+  TRACE_EVENT1("log", "batch", "batch_size", group_size);
 
   auto se = ScopeExit([this] {
     if (log_->metrics_) {
@@ -285,7 +377,9 @@ void Log::Appender::GroupWork() {
     sync_batch_.clear();
   });
 
+  const auto sync_start = MonoTime::Now();
   Status s = log_->Sync();
+  UpdateGroupWaitBudget(group_size, MonoTime::Now().GetDeltaSince(sync_start));
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX(DFATAL) << "Error syncing log: " << s;
     for (std::unique_ptr<LogEntryBatch>& entry_batch : sync_batch_) {
@@ -402,6 +496,7 @@ Status Log::Init() {
                                 peer_uuid_,
                                 metric_entity_.get(),
                                 &reader_));
+  RETURN_NOT_OK(LoadRecycledSegments());
 
   // The case where we are continuing an existing log.  We must pick up where the previous WAL left
   // off in terms of sequence numbers.
@@ -427,6 +522,18 @@ Status Log::Init() {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned off. Buffered IO will be used for WAL.";
   }
 
+  // With durable_wal_write entries are written with O_DIRECT and O_SYNC, so there is nothing to
+  // sync in a group.
+  if (FLAGS_log_sync_across_tablets && !durable_wal_write_ && get_env() == Env::Default()) {
+    auto sync_group = LogSyncGroup::ForDir(log_dir_);
+    if (sync_group.ok()) {
+      sync_group_ = std::move(*sync_group);
+    } else {
+      LOG_WITH_PREFIX(WARNING) << "Syncing WAL separately from other tablets: "
+                               << sync_group.status();
+    }
+  }
+
   // We always create a new segment when the log starts.
   RETURN_NOT_OK(AsyncAllocateSegment());
   RETURN_NOT_OK(allocation_status_.Get());
@@ -707,7 +814,11 @@ Status Log::Sync() {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+        if (sync_group_) {
+          RETURN_NOT_OK(sync_group_->Sync());
+        } else {
+          RETURN_NOT_OK(active_segment_->Sync());
+        }
       }
     }
   }
@@ -888,9 +999,17 @@ Status Log::GC(int64_t min_op_idx, int32_t* num_gced) {
           segments_to_delete[segments_to_delete.size() - 1]->header().sequence_number()));
     }
 
-    // Now that they are no longer referenced by the Log, delete the files.
+    // Now that they are no longer referenced by the Log, delete or recycle the files.
     *num_gced = 0;
     for (const scoped_refptr<ReadableLogSegment>& segment : segments_to_delete) {
+      auto recycled = RecycleSegment(segment);
+      if (!recycled.ok()) {
+        LOG_WITH_PREFIX(WARNING) << "Failed to recycle log segment " << segment->path() << ": "
+                                 << recycled.status();
+      } else if (*recycled) {
+        (*num_gced)++;
+        continue;
+      }
       LOG_WITH_PREFIX(INFO) << "Deleting log segment in path: " << segment->path()
                             << " (GCed ops < " << min_op_idx << ")";
       RETURN_NOT_OK(get_env()->DeleteFile(segment->path()));
@@ -1052,22 +1171,115 @@ uint64_t Log::NextSegmentDesiredSize() {
   return std::min(cur_max_segment_size_ * 2, max_segment_size_);
 }
 
+bool Log::ShouldRecycleSegments() const {
+  // Files can't be overwritten in place with O_DIRECT, and other envs, e.g. with encryption, may
+  // not support overwriting.
+  return FLAGS_log_max_recycled_segments > 0 && !durable_wal_write_ &&
+         options_.env == Env::Default();
+}
+
+Status Log::LoadRecycledSegments() {
+  vector<string> children;
+  RETURN_NOT_OK(get_env()->GetChildren(log_dir_, &children));
+  std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+  for (const auto& child : children) {
+    if (!HasPrefixString(child, kRecycledSegmentPrefix)) {
+      continue;
+    }
+    const auto path = JoinPathSegments(log_dir_, child);
+    const auto epoch_str = child.substr(
+        strlen(kRecycledSegmentPrefix),
+        child.find('.', strlen(kRecycledSegmentPrefix)) - strlen(kRecycledSegmentPrefix));
+    uint32 epoch = 0;
+    auto size = get_env()->GetFileSize(path);
+    if (!ShouldRecycleSegments() ||
+        recycled_segments_.size() >= static_cast<size_t>(FLAGS_log_max_recycled_segments) ||
+        !safe_strtou32(epoch_str, &epoch) || !size.ok()) {
+      LOG_WITH_PREFIX(INFO) << "Deleting recycled log segment: " << path;
+      RETURN_NOT_OK(get_env()->DeleteFile(path));
+      continue;
+    }
+    recycled_segments_.push_back(RecycledSegment{path, epoch, *size});
+  }
+  return Status::OK();
+}
+
+Result<bool> Log::RecycleSegment(const scoped_refptr<ReadableLogSegment>& segment) {
+  // With other references the segment could still be read, so it should not be overwritten.
+  if (!ShouldRecycleSegments() || !segment->HasOneRef() || !segment->IsInitialized()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+  if (recycled_segments_.size() >= static_cast<size_t>(FLAGS_log_max_recycled_segments)) {
+    return false;
+  }
+
+  const uint32_t epoch = segment->header().recycle_epoch() + 1;
+  const auto path = JoinPathSegments(
+      log_dir_, Format("$0$1.$2", kRecycledSegmentPrefix, epoch, BaseName(segment->path())));
+  RETURN_NOT_OK(WipeLogSegmentMagics(get_env(), segment->path()));
+  RETURN_NOT_OK(get_env()->RenameFile(segment->path(), path));
+  LOG_WITH_PREFIX(INFO) << "Recycled log segment " << segment->path() << " to " << path;
+  recycled_segments_.push_back(RecycledSegment{path, epoch, segment->file_size()});
+  return true;
+}
+
+Result<bool> Log::OpenRecycledSegment(const WritableFileOptions& opts, uint64_t* existing_size) {
+  RecycledSegment recycled;
+  {
+    std::lock_guard<std::mutex> lock(recycled_segments_mutex_);
+    if (recycled_segments_.empty()) {
+      return false;
+    }
+    recycled = std::move(recycled_segments_.back());
+    recycled_segments_.pop_back();
+  }
+
+  WritableFileOptions overwrite_opts = opts;
+  overwrite_opts.mode = Env::OPEN_EXISTING_OVERWRITE;
+  std::unique_ptr<WritableFile> segment_file;
+  Status s = get_env()->NewWritableFile(overwrite_opts, recycled.path, &segment_file);
+  if (!s.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to open recycled log segment " << recycled.path << ": "
+                             << s;
+    WARN_NOT_OK(get_env()->DeleteFile(recycled.path), "Failed to delete recycled log segment");
+    return false;
+  }
+
+  VLOG_WITH_PREFIX(1) << "Reusing recycled log segment " << recycled.path << " for next segment";
+  next_segment_path_ = recycled.path;
+  next_segment_file_.reset(segment_file.release());
+  next_segment_recycle_epoch_ = recycled.recycle_epoch;
+  *existing_size = recycled.size;
+  if (metrics_) {
+    metrics_->segments_recycled->Increment();
+  }
+  return true;
+}
+
 Status Log::PreAllocateNewSegment() {
   TRACE_EVENT1("log", "PreAllocateNewSegment", "file", next_segment_path_);
+  SCOPED_LATENCY_METRIC(metrics_, segment_allocation_latency);
   CHECK_EQ(allocation_state(), kAllocationInProgress);
 
   WritableFileOptions opts;
   // We always want to sync on close: https://github.com/yugabyte/yugabyte-db/issues/3490
   opts.sync_on_close = true;
   opts.o_direct = durable_wal_write_;
-  RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  next_segment_recycle_epoch_ = 0;
+  uint64_t existing_size = 0;
+  if (!ShouldRecycleSegments() || !VERIFY_RESULT(OpenRecycledSegment(opts, &existing_size))) {
+    RETURN_NOT_OK(CreatePlaceholderSegment(opts, &next_segment_path_, &next_segment_file_));
+  }
 
-  if (options_.preallocate_segments) {
-    uint64_t next_segment_size = NextSegmentDesiredSize();
+  uint64_t next_segment_size = NextSegmentDesiredSize();
+  if (options_.preallocate_segments && next_segment_size > existing_size) {
     TRACE("Preallocating $0 byte segment in $1", next_segment_size, next_segment_path_);
     // TODO (perf) zero the new segments -- this could result in additional performance
     // improvements.
-    RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size));
+    // Space of a recycled file is already allocated, so only its extension is preallocated.
+    RETURN_NOT_OK(next_segment_file_->PreAllocate(next_segment_size - existing_size));
   }
 
   {
@@ -1098,6 +1310,9 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  if (next_segment_recycle_epoch_ != 0) {
+    header.set_recycle_epoch(next_segment_recycle_epoch_);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
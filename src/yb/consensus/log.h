@@ -36,6 +36,7 @@
 #include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -55,6 +56,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/promise.h"
+#include "yb/util/result.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/shared_lock.h"
@@ -75,6 +77,7 @@ struct LogMetrics;
 class LogEntryBatch;
 class LogIndex;
 class LogReader;
+class LogSyncGroup;
 
 // Log interface, inspired by Raft's (logcabin) Log. Provides durability to YugaByte as a normal
 // Write Ahead Log and also plays the role of persistent storage for the consensus state machine.
@@ -349,6 +352,19 @@ class Log : public RefCountedThreadSafe<Log> {
   // Returns the desired size for the next log segment to be created.
   uint64_t NextSegmentDesiredSize();
 
+  // Picks up files of recycled segments left in the log dir by a previous incarnation of the log.
+  CHECKED_STATUS LoadRecycledSegments();
+
+  // Returns true if files of GC'd segments should be kept for reuse instead of being deleted.
+  bool ShouldRecycleSegments() const;
+
+  // Moves the file of a GC'd segment to the pool of recycled segments. Returns false if the pool
+  // is full, in which case the file should be deleted.
+  Result<bool> RecycleSegment(const scoped_refptr<ReadableLogSegment>& segment);
+
+  // Opens the file of a recycled segment for the next segment. Returns false if the pool is empty.
+  Result<bool> OpenRecycledSegment(const WritableFileOptions& opts, uint64_t* existing_size);
+
   // Writes serialized contents of 'entry' to the log. Called inside AppenderThread. If
   // 'caller_owns_operation' is true, then the 'operation' field of the entry will be released after
   // the entry is appended. If skip_wal_write is true, only update consensus metadata and LogIndex,
@@ -413,6 +429,20 @@ class Log : public RefCountedThreadSafe<Log> {
   // The path for the next allocated segment.
   std::string next_segment_path_;
 
+  // The recycle epoch of the next allocated segment, 0 if it is a new file.
+  uint32_t next_segment_recycle_epoch_ = 0;
+
+  // A file of a GC'd segment, kept to be overwritten by a future segment.
+  struct RecycledSegment {
+    std::string path;
+    uint32_t recycle_epoch;
+    uint64_t size;
+  };
+
+  // Protects recycled_segments_, which is updated by GC and by segment allocation.
+  std::mutex recycled_segments_mutex_;
+  std::vector<RecycledSegment> recycled_segments_ GUARDED_BY(recycled_segments_mutex_);
+
   // Lock to protect mutations to log_state_ and other shared state variables.
   mutable percpu_rwlock state_lock_;
 
@@ -476,6 +506,10 @@ class Log : public RefCountedThreadSafe<Log> {
   // bootstrap.
   bool sync_disabled_;
 
+  // If set, periodic syncs are done by syncing the whole WAL file system together with the logs of
+  // other tablets, instead of syncing the active segment.
+  std::shared_ptr<LogSyncGroup> sync_group_;
+
   // The status of the most recent log-allocation action.
   Promise<Status> allocation_status_;
 
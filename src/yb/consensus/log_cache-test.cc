@@ -202,6 +202,45 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
 }
 
 
+// Test that the wire form of cached messages is computed once and shared between reads.
+TEST_F(LogCacheTest, TestSerializeOps) {
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumMessages));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumMessages, read_result.serialized_ops.size());
+  for (const auto& serialized_op : read_result.serialized_ops) {
+    ASSERT_FALSE(serialized_op);
+  }
+
+  const int64_t size_before = cache_->metrics_.size->value();
+  cache_->SerializeOps(&read_result);
+  ASSERT_GT(cache_->metrics_.size->value(), size_before);
+
+  // Concatenated wire forms should be parsed as the ops of the request.
+  std::string serialized;
+  for (const auto& serialized_op : read_result.serialized_ops) {
+    ASSERT_TRUE(serialized_op);
+    serialized.append(serialized_op.data(), serialized_op.size());
+  }
+  ConsensusRequestPB request;
+  ASSERT_TRUE(request.ParsePartialFromString(serialized));
+  ASSERT_EQ(kNumMessages, request.ops_size());
+  for (int i = 0; i != kNumMessages; ++i) {
+    ASSERT_EQ(read_result.messages[i]->SerializeAsString(), request.ops(i).SerializeAsString());
+  }
+
+  // The next read returns the same buffers.
+  auto next_read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumMessages, next_read_result.serialized_ops.size());
+  for (int i = 0; i != kNumMessages; ++i) {
+    ASSERT_EQ(read_result.serialized_ops[i].data(), next_read_result.serialized_ops[i].data());
+  }
+  const int64_t size_after = cache_->metrics_.size->value();
+  cache_->SerializeOps(&next_read_result);
+  ASSERT_EQ(size_after, cache_->metrics_.size->value());
+}
+
 // Ensure that the cache always yields at least one message,
 // even if that message is larger than the batch size. This ensures
 // that we don't get "stuck" in the case that a large message enters
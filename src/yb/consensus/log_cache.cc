@@ -272,6 +272,11 @@ int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
   return msg_size;
 }
 
+// Tag of ReplicateMsg as an element of ConsensusRequestPB::ops.
+const uint32_t kOpsTag = google::protobuf::internal::WireFormatLite::MakeTag(
+    ConsensusRequestPB::kOpsFieldNumber,
+    google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+
 } // anonymous namespace
 
 Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
@@ -312,23 +317,29 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
 
       l.unlock();
 
+      // Messages read from disk come with their wire form taken from the log segment, so they
+      // are not serialized again when sent to the peer.
       ReplicateMsgs raw_replicate_ptrs;
+      std::vector<RefCntBuffer> serialized_replicates;
       RETURN_NOT_OK_PREPEND(
         log_->GetLogReader()->ReadReplicatesInRange(
-            next_index, up_to, remaining_space, &raw_replicate_ptrs),
+            next_index, up_to, remaining_space, kOpsTag, &raw_replicate_ptrs,
+            &serialized_replicates),
         Substitute("Failed to read ops $0..$1", next_index, up_to));
       metrics_.disk_reads->IncrementBy(raw_replicate_ptrs.size());
       LOG_WITH_PREFIX_UNLOCKED(INFO)
           << "Successfully read " << raw_replicate_ptrs.size() << " ops from disk.";
       l.lock();
 
-      for (auto& msg : raw_replicate_ptrs) {
+      for (size_t i = 0; i != raw_replicate_ptrs.size(); ++i) {
+        auto& msg = raw_replicate_ptrs[i];
         CHECK_EQ(next_index, msg->id().index());
 
         auto current_message_size = TotalByteSizeForMessage(*msg);
         remaining_space -= current_message_size;
         if (remaining_space >= 0 || result.messages.empty()) {
           result.messages.push_back(msg);
+          result.serialized_ops.push_back(std::move(serialized_replicates[i]));
           result.read_from_disk_size += current_message_size;
           next_index++;
         } else {
@@ -356,6 +367,7 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
         }
 
         result.messages.push_back(msg);
+        result.serialized_ops.push_back(iter->second.serialized_op);
         next_index++;
       }
     }
@@ -364,6 +376,61 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
   return result;
 }
 
+void LogCache::SerializeOps(ReadOpsResult* result) {
+  using google::protobuf::io::CodedOutputStream;
+
+  DCHECK_EQ(result->messages.size(), result->serialized_ops.size());
+
+  // Serialize outside of the lock, so concurrent requests to several peers could serialize the
+  // same message. In this case the first serialized buffer is kept.
+  bool has_new_ops = false;
+  for (size_t i = 0; i != result->messages.size(); ++i) {
+    auto& serialized_op = result->serialized_ops[i];
+    if (serialized_op) {
+      continue;
+    }
+    const auto& msg = *result->messages[i];
+    const uint32_t msg_size = msg.ByteSize();
+    serialized_op = RefCntBuffer(
+        CodedOutputStream::VarintSize32(kOpsTag) + CodedOutputStream::VarintSize32(msg_size) +
+        msg_size);
+    auto* dst = CodedOutputStream::WriteTagToArray(kOpsTag, serialized_op.udata());
+    dst = CodedOutputStream::WriteVarint32ToArray(msg_size, dst);
+    dst = msg.SerializeWithCachedSizesToArray(dst);
+    DCHECK_EQ(dst, serialized_op.udata() + serialized_op.size());
+    has_new_ops = true;
+  }
+
+  if (!has_new_ops) {
+    return;
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  int64_t mem_required = 0;
+  for (size_t i = 0; i != result->messages.size(); ++i) {
+    const auto& msg = result->messages[i];
+    auto it = cache_.find(msg->id().index());
+    if (it == cache_.end() || it->second.msg != msg) {
+      continue;
+    }
+    auto& entry = it->second;
+    if (entry.serialized_op) {
+      result->serialized_ops[i] = entry.serialized_op;
+      continue;
+    }
+    entry.serialized_op = result->serialized_ops[i];
+    const int64_t size = entry.serialized_op.size();
+    entry.mem_usage += size;
+    metrics_.size->IncrementBy(size);
+    if (entry.tracked) {
+      mem_required += size;
+    }
+  }
+  if (mem_required) {
+    tracker_->Consume(mem_required);
+  }
+}
+
 size_t LogCache::EvictThroughOp(int64_t index, int64_t bytes_to_evict) {
   std::lock_guard<simple_spinlock> lock(lock_);
   return EvictSomeUnlocked(index, bytes_to_evict);
@@ -47,6 +47,7 @@
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/opid.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/result.h"
 
@@ -66,6 +67,9 @@ class ReplicateMsg;
 
 struct ReadOpsResult {
   ReplicateMsgs messages;
+  // Wire form of each of the messages, see LogCache::SerializeOps. Null for messages that were not
+  // serialized yet.
+  std::vector<RefCntBuffer> serialized_ops;
   yb::OpId preceding_op;
   bool have_more_messages = false;
   int64_t read_from_disk_size = 0;
@@ -119,6 +123,11 @@ class LogCache {
                                 int64_t to_op_index,
                                 int max_size_bytes);
 
+  // Fills serialized_ops of the result with the wire form of each message as an element of
+  // ConsensusRequestPB::ops. The wire form of a cached message is computed once and then kept in
+  // the cache, so requests to all peers share the same buffer.
+  void SerializeOps(ReadOpsResult* result);
+
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
   //
@@ -174,6 +183,7 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestAppendAndGetMessages);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimit);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, TestSerializeOps);
   friend class LogCacheTest;
 
   // An entry in the cache.
@@ -183,6 +193,10 @@ class LogCache {
     // to compute, so we compute it only once upon insertion.
     int64_t mem_usage;
 
+    // The wire form of msg as an element of ConsensusRequestPB::ops, computed when the message is
+    // sent to a peer for the first time. Included in mem_usage.
+    RefCntBuffer serialized_op;
+
     // Did we start memory tracking for this entry.
     bool tracked = false;
   };
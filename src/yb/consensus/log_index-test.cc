@@ -36,6 +36,8 @@
 #include "yb/fs/fs_manager.h"
 #include "yb/util/test_util.h"
 
+DECLARE_int32(log_index_max_mapped_chunks);
+
 namespace yb {
 namespace log {
 
@@ -93,6 +95,25 @@ TEST_F(LogIndexTest, TestBasic) {
   VerifyEntry(MakeOpId(5, 1), 1, 50000);
 }
 
+TEST_F(LogIndexTest, TestMappedChunksLimit) {
+  FLAGS_log_index_max_mapped_chunks = 1;
+
+  // Entries are in different chunks, so only one chunk stays mapped while the others are mapped
+  // again on access.
+  ASSERT_OK(AddEntry(MakeOpId(1, 1), 1, 12345));
+  ASSERT_OK(AddEntry(MakeOpId(1, 1500000), 2, 999));
+  ASSERT_OK(AddEntry(MakeOpId(1, 2500000), 3, 54321));
+  for (int i = 0; i != 3; ++i) {
+    VerifyEntry(MakeOpId(1, 1), 1, 12345);
+    VerifyEntry(MakeOpId(1, 1500000), 2, 999);
+    VerifyEntry(MakeOpId(1, 2500000), 3, 54321);
+  }
+
+  ASSERT_OK(AddEntry(MakeOpId(2, 1), 4, 50000));
+  VerifyEntry(MakeOpId(1, 2500000), 3, 54321);
+  VerifyEntry(MakeOpId(2, 1), 4, 50000);
+}
+
 // This test relies on kEntriesPerIndexChunk being 1000000, and that's no longer
 // the case after D1719 (2fe27d886390038bc734ea28638a1b1435e7d0d4) on Mac.
 #if !defined(__APPLE__)
@@ -40,6 +40,10 @@
 //
 // When the log is GCed, we remove any index chunks which are no longer needed, and
 // unmap them.
+//
+// Tablets retaining WAL for a long time keep many chunks, so the number of chunks mapped by the
+// server is bounded by log_index_max_mapped_chunks. A chunk over the limit is unmapped; its file
+// stays, and is mapped again when an entry in it is accessed.
 
 #include "yb/consensus/log_index.h"
 
@@ -49,15 +53,28 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <list>
 #include <mutex>
 #include <string>
 #include <vector>
 
+#include <gflags/gflags.h>
+
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
+#include "yb/util/scope_exit.h"
+
+DEFINE_int32(log_index_max_mapped_chunks, 2048,
+             "Max number of log index chunks mapped by the server. Chunks over this limit, that "
+             "were not accessed recently, are unmapped and mapped again on the next access. "
+             "Non-positive value means no limit.");
+TAG_FLAG(log_index_max_mapped_chunks, advanced);
+TAG_FLAG(log_index_max_mapped_chunks, runtime);
 
 using std::string;
 using strings::Substitute;
@@ -107,21 +124,88 @@ static const int64_t kChunkFileSize = kEntriesPerIndexChunk * sizeof(PhysicalEnt
 ////////////////////////////////////////////////////////////
 
 // A single chunk of the index, representing a fixed number of entries.
-// This class maintains the open file descriptor and mapped memory.
+// This class maintains the mapped memory of the chunk file. The file descriptor is closed right
+// after mapping, and the chunk could be unmapped when too many chunks are mapped by the server,
+// in which case it is mapped again on the next access.
 class LogIndex::IndexChunk : public RefCountedThreadSafe<LogIndex::IndexChunk> {
  public:
   explicit IndexChunk(string path);
   ~IndexChunk();
 
-  // Open and map the memory.
+  // Create the file and map the memory.
   Status Open();
-  void GetEntry(int entry_index, PhysicalEntry* ret);
-  void SetEntry(int entry_index, const PhysicalEntry& entry);
+  Status GetEntry(int entry_index, PhysicalEntry* ret);
+  Status SetEntry(int entry_index, const PhysicalEntry& entry);
 
  private:
+  friend class LogIndex::MappedChunks;
+
+  // Maps the chunk file, creating it if requested.
+  Status MapUnlocked(bool create);
+  Status EnsureMappedUnlocked();
+  void UnmapUnlocked();
+
+  // Unmaps the chunk unless it is being accessed right now. Returns true if unmapped.
+  // Invoked by MappedChunks, that removes the chunk from its list.
+  bool TryUnmap();
+
+  // Returns whether the chunk was accessed since the last call, and clears the flag.
+  bool TestAndClearReferenced() {
+    return referenced_.exchange(false, std::memory_order_acq_rel);
+  }
+
   const string path_;
-  int fd_;
-  uint8_t* mapping_;
+  std::mutex mutex_;
+  uint8_t* mapping_ = nullptr;
+  std::atomic<bool> referenced_{false};
+  // Position in the list of mapped chunks, valid while the chunk is mapped.
+  std::list<IndexChunk*>::iterator mapped_chunks_position_;
+};
+
+// All mapped index chunks of the server, used to keep the number of mapped chunks under
+// log_index_max_mapped_chunks. Evicted chunks are picked with the clock algorithm, so accessing a
+// chunk does not need a global lock.
+//
+// Lock order is chunk mutex, then mapped chunks mutex. While holding the latter, the chunk mutex
+// is only tried, so chunks being accessed are never unmapped.
+class LogIndex::MappedChunks {
+ public:
+  static MappedChunks& Instance() {
+    static MappedChunks instance;
+    return instance;
+  }
+
+  // Adds just mapped chunk and unmaps other chunks if there are too many of them.
+  // Invoked with the mutex of the chunk held.
+  void Add(IndexChunk* chunk) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunk->mapped_chunks_position_ = chunks_.insert(chunks_.end(), chunk);
+
+    const auto limit = FLAGS_log_index_max_mapped_chunks;
+    if (limit <= 0) {
+      return;
+    }
+    size_t chunks_to_check = chunks_.size();
+    while (chunks_.size() > static_cast<size_t>(limit) && chunks_to_check-- > 0) {
+      auto* candidate = chunks_.front();
+      if (candidate != chunk && !candidate->TestAndClearReferenced() && candidate->TryUnmap()) {
+        chunks_.pop_front();
+      } else {
+        chunks_.splice(chunks_.end(), chunks_, chunks_.begin());
+      }
+    }
+  }
+
+  // Removes the chunk unmapped by its owner. Invoked with the mutex of the chunk held.
+  void Remove(IndexChunk* chunk) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunks_.erase(chunk->mapped_chunks_position_);
+  }
+
+ private:
+  std::mutex mutex_;
+  // Mapped chunks, from the earliest mapped or checked one.
+  std::list<IndexChunk*> chunks_;
 };
 
 namespace  {
@@ -133,48 +217,85 @@ Status CheckError(int rc, const char* operation) {
 }
 } // anonymous namespace
 
-LogIndex::IndexChunk::IndexChunk(std::string path)
-    : path_(std::move(path)), fd_(-1), mapping_(nullptr) {}
+LogIndex::IndexChunk::IndexChunk(std::string path) : path_(std::move(path)) {}
 
 LogIndex::IndexChunk::~IndexChunk() {
-  if (mapping_ != nullptr) {
-    munmap(mapping_, kChunkFileSize);
-  }
-
-  if (fd_ >= 0) {
-    close(fd_);
-  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  UnmapUnlocked();
 }
 
 Status LogIndex::IndexChunk::Open() {
-  RETRY_ON_EINTR(fd_, open(path_.c_str(), O_CLOEXEC | O_CREAT | O_RDWR, 0666));
-  RETURN_NOT_OK(CheckError(fd_, "open"));
+  std::lock_guard<std::mutex> lock(mutex_);
+  return MapUnlocked(true /* create */);
+}
 
-  int err;
-  RETRY_ON_EINTR(err, ftruncate(fd_, kChunkFileSize));
-  RETURN_NOT_OK(CheckError(fd_, "truncate"));
+Status LogIndex::IndexChunk::MapUnlocked(bool create) {
+  DCHECK(mapping_ == nullptr);
 
-  mapping_ = static_cast<uint8_t*>(mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE,
-                                        MAP_SHARED, fd_, 0));
-  if (mapping_ == nullptr) {
-    return STATUS(IOError, "Unable to mmap()", Errno(err));
+  int fd;
+  RETRY_ON_EINTR(fd, open(path_.c_str(), O_CLOEXEC | O_RDWR | (create ? O_CREAT : 0), 0666));
+  RETURN_NOT_OK(CheckError(fd, "open"));
+  // The mapping stays valid after the file is closed, so don't keep the file descriptor.
+  auto se = ScopeExit([fd] { close(fd); });
+
+  if (create) {
+    int err;
+    RETRY_ON_EINTR(err, ftruncate(fd, kChunkFileSize));
+    RETURN_NOT_OK(CheckError(err, "truncate"));
+  }
+
+  void* mapping = mmap(nullptr, kChunkFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    return STATUS(IOError, "Unable to mmap()", Errno(errno));
   }
+  mapping_ = static_cast<uint8_t*>(mapping);
+  MappedChunks::Instance().Add(this);
 
   return Status::OK();
 }
 
-void LogIndex::IndexChunk::GetEntry(int entry_index, PhysicalEntry* ret) {
-  DCHECK_GE(fd_, 0) << "Must Open() first";
+Status LogIndex::IndexChunk::EnsureMappedUnlocked() {
+  referenced_.store(true, std::memory_order_relaxed);
+  if (PREDICT_TRUE(mapping_ != nullptr)) {
+    return Status::OK();
+  }
+  return MapUnlocked(false /* create */);
+}
+
+void LogIndex::IndexChunk::UnmapUnlocked() {
+  if (mapping_ != nullptr) {
+    MappedChunks::Instance().Remove(this);
+    munmap(mapping_, kChunkFileSize);
+    mapping_ = nullptr;
+  }
+}
+
+bool LogIndex::IndexChunk::TryUnmap() {
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return false;
+  }
+  munmap(mapping_, kChunkFileSize);
+  mapping_ = nullptr;
+  return true;
+}
+
+Status LogIndex::IndexChunk::GetEntry(int entry_index, PhysicalEntry* ret) {
   DCHECK_LT(entry_index, kEntriesPerIndexChunk);
 
+  std::lock_guard<std::mutex> lock(mutex_);
+  RETURN_NOT_OK(EnsureMappedUnlocked());
   memcpy(ret, mapping_ + sizeof(PhysicalEntry) * entry_index, sizeof(PhysicalEntry));
+  return Status::OK();
 }
 
-void LogIndex::IndexChunk::SetEntry(int entry_index, const PhysicalEntry& phys) {
-  DCHECK_GE(fd_, 0) << "Must Open() first";
+Status LogIndex::IndexChunk::SetEntry(int entry_index, const PhysicalEntry& phys) {
   DCHECK_LT(entry_index, kEntriesPerIndexChunk);
 
+  std::lock_guard<std::mutex> lock(mutex_);
+  RETURN_NOT_OK(EnsureMappedUnlocked());
   memcpy(mapping_ + sizeof(PhysicalEntry) * entry_index, &phys, sizeof(PhysicalEntry));
+  return Status::OK();
 }
 
 ////////////////////////////////////////////////////////////
@@ -244,7 +365,7 @@ Status LogIndex::AddEntry(const LogIndexEntry& entry) {
   phys.segment_sequence_number = entry.segment_sequence_number;
   phys.offset_in_segment = entry.offset_in_segment;
 
-  chunk->SetEntry(index_in_chunk, phys);
+  RETURN_NOT_OK(chunk->SetEntry(index_in_chunk, phys));
   VLOG(3) << "Added log index entry " << entry.ToString();
 
   return Status::OK();
@@ -255,7 +376,7 @@ Status LogIndex::GetEntry(int64_t index, LogIndexEntry* entry) {
   RETURN_NOT_OK(GetChunkForIndex(index, false /* do not create */, &chunk));
   int index_in_chunk = index % kEntriesPerIndexChunk;
   PhysicalEntry phys;
-  chunk->GetEntry(index_in_chunk, &phys);
+  RETURN_NOT_OK(chunk->GetEntry(index_in_chunk, &phys));
 
   // We never write any real entries to offset 0, because there's a header
   // in each log segment. So, this indicates an entry that was never written.
@@ -67,7 +67,8 @@ struct LogIndexEntry {
 //
 // This structure is on-disk but *not durable*. We use mmap()ed IO to write it out, and
 // never sync it to disk. Its only purpose is to allow random-reading earlier entries from
-// the log to serve to Raft followers.
+// the log to serve to Raft followers. Chunks of the index are unmapped when the server maps
+// too many of them, and are mapped again on access.
 //
 // This class is thread-safe, but doesn't provide a memory barrier between writers and
 // readers. In other words, if a reader is expected to see an index entry written by a
@@ -95,6 +96,7 @@ class LogIndex : public RefCountedThreadSafe<LogIndex> {
   ~LogIndex();
 
   class IndexChunk;
+  class MappedChunks;
 
   // Open the on-disk chunk with the given index.
   // Note: 'chunk_idx' is the index of the index chunk, not the index of a log _entry_.
@@ -58,11 +58,27 @@ METRIC_DEFINE_histogram(tablet, log_roll_latency, "Log Roll Latency",
                         "Microseconds spent on rolling over to a new log segment file",
                         60000000LU, 2);
 
+METRIC_DEFINE_histogram(tablet, log_segment_allocation_latency, "Log Segment Allocation Latency",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent on allocating the file for the next log segment",
+                        60000000LU, 2);
+
+METRIC_DEFINE_counter(tablet, log_segments_recycled, "Log Segments Recycled",
+                      yb::MetricUnit::kUnits,
+                      "Number of log segments written to files of garbage collected segments "
+                      "instead of newly allocated files");
+
 METRIC_DEFINE_histogram(tablet, log_entry_batches_per_group, "Log Group Commit Batch Size",
                         yb::MetricUnit::kRequests,
                         "Number of log entry batches in a group commit group",
                         1024, 2);
 
+METRIC_DEFINE_histogram(tablet, log_group_commit_wait_time, "Log Group Commit Wait Time",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent waiting for more log entry batches to join a group "
+                        "commit group before syncing it",
+                        60000000LU, 2);
+
 namespace yb {
 namespace log {
 
@@ -73,7 +89,10 @@ LogMetrics::LogMetrics(const scoped_refptr<MetricEntity>& metric_entity)
       MINIT(append_latency),
       MINIT(group_commit_latency),
       MINIT(roll_latency),
-      MINIT(entry_batches_per_group) {
+      MINIT(segment_allocation_latency),
+      MINIT(segments_recycled),
+      MINIT(entry_batches_per_group),
+      MINIT(group_commit_wait_time) {
 }
 #undef MINIT
 
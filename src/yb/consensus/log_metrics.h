@@ -55,7 +55,10 @@ struct LogMetrics {
   scoped_refptr<Histogram> append_latency;
   scoped_refptr<Histogram> group_commit_latency;
   scoped_refptr<Histogram> roll_latency;
+  scoped_refptr<Histogram> segment_allocation_latency;
+  scoped_refptr<Counter> segments_recycled;
   scoped_refptr<Histogram> entry_batches_per_group;
+  scoped_refptr<Histogram> group_commit_wait_time;
 };
 
 // TODO extract and generalize this for all histogram metrics
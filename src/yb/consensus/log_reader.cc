@@ -37,6 +37,9 @@
 #include <algorithm>
 #include <mutex>
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/opid_util.h"
@@ -54,6 +57,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/size_literals.h"
 
 DEFINE_bool(enable_log_retention_by_op_idx, false,
             "If true, logs will be retained based on an op id passed by the cdc service");
@@ -67,6 +71,14 @@ DEFINE_int64(log_stop_retaining_min_disk_mb, 100 * 1024, "Stop retaining logs if
              "available for the logs falls below this limit. This flag is ignored if a log segment "
              "contains unflushed entries.");
 
+DEFINE_int64(log_max_cdc_retained_mb, 0, "Oldest log files that are retained only for cdc "
+             "unreplicated entries are deleted when such files of a tablet take more than this, so "
+             "a lagging cdc consumer does not make the log grow unbounded. The consumer then has "
+             "to be bootstrapped again. If 0, this flag will be ignored. This flag is ignored if a "
+             "log segment contains unflushed entries.");
+TAG_FLAG(log_max_cdc_retained_mb, advanced);
+TAG_FLAG(log_max_cdc_retained_mb, runtime);
+
 METRIC_DEFINE_counter(tablet, log_reader_bytes_read, "Bytes Read From Log",
                       yb::MetricUnit::kBytes,
                       "Data read from the WAL since tablet start");
@@ -98,13 +110,93 @@ struct LogSegmentSeqnoComparator {
     return a->header().sequence_number() < b->header().sequence_number();
   }
 };
+
+// Finds the serialized replicate of each entry in the raw log entry batch, so it could be sent
+// without encoding the message again. Entries without a replicate get an empty slice.
+// Returns false if the batch has an unexpected layout.
+bool FindSerializedReplicates(const Slice& batch_data, std::vector<Slice>* replicates) {
+  using google::protobuf::internal::WireFormatLite;
+  static const uint32_t kEntryTag = WireFormatLite::MakeTag(
+      LogEntryBatchPB::kEntryFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  static const uint32_t kReplicateTag = WireFormatLite::MakeTag(
+      LogEntryPB::kReplicateFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+
+  replicates->clear();
+  google::protobuf::io::CodedInputStream input(batch_data.data(), batch_data.size());
+  input.SetTotalBytesLimit(batch_data.size(), -1);
+  for (;;) {
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      return input.ConsumedEntireMessage();
+    }
+    if (tag != kEntryTag) {
+      if (!WireFormatLite::SkipField(&input, tag)) {
+        return false;
+      }
+      continue;
+    }
+
+    uint32_t entry_size;
+    if (!input.ReadVarint32(&entry_size)) {
+      return false;
+    }
+    auto limit = input.PushLimit(entry_size);
+    Slice replicate;
+    for (;;) {
+      const uint32_t entry_tag = input.ReadTag();
+      if (entry_tag == 0) {
+        if (!input.ConsumedEntireMessage()) {
+          return false;
+        }
+        break;
+      }
+      if (entry_tag != kReplicateTag) {
+        if (!WireFormatLite::SkipField(&input, entry_tag)) {
+          return false;
+        }
+        continue;
+      }
+      // The parser merges repeated occurrences of the replicate, so they could not be sent as is.
+      uint32_t replicate_size;
+      if (!replicate.empty() || !input.ReadVarint32(&replicate_size)) {
+        return false;
+      }
+      const void* data;
+      int size;
+      if (!input.GetDirectBufferPointer(&data, &size) || static_cast<uint32_t>(size) < replicate_size) {
+        return false;
+      }
+      replicate = Slice(static_cast<const uint8_t*>(data), replicate_size);
+      if (!input.Skip(replicate_size)) {
+        return false;
+      }
+    }
+    input.PopLimit(limit);
+    replicates->push_back(replicate);
+  }
+}
+
+// Returns the serialized replicate as a length-delimited field with the specified tag.
+RefCntBuffer SerializedReplicateField(uint32_t field_tag, const Slice& replicate) {
+  using google::protobuf::io::CodedOutputStream;
+  RefCntBuffer result(
+      CodedOutputStream::VarintSize32(field_tag) +
+      CodedOutputStream::VarintSize32(replicate.size()) + replicate.size());
+  auto* dst = CodedOutputStream::WriteTagToArray(field_tag, result.udata());
+  dst = CodedOutputStream::WriteVarint32ToArray(replicate.size(), dst);
+  memcpy(dst, replicate.data(), replicate.size());
+  return result;
 }
 
+} // namespace
+
 using consensus::OpId;
 using consensus::ReplicateMsg;
 using env_util::ReadFully;
 using strings::Substitute;
 
+using namespace yb::size_literals;
+
 const int64_t LogReader::kNoSizeLimit = -1;
 
 Status LogReader::Open(Env *env,
@@ -273,6 +365,18 @@ bool LogReader::ViolatesMinSpacePolicy(const scoped_refptr<ReadableLogSegment>&
   return false;
 }
 
+bool LogReader::ViolatesMaxCdcRetainedSizePolicy(const scoped_refptr<ReadableLogSegment>& segment,
+                                                 int64_t cdc_retained_bytes) const {
+  if (FLAGS_log_max_cdc_retained_mb <= 0 ||
+      cdc_retained_bytes / 1_MB <= FLAGS_log_max_cdc_retained_mb) {
+    return false;
+  }
+  LOG_WITH_PREFIX(WARNING) << "Segment " << segment->path() << " violates max cdc retained size "
+                           << "policy. Retained size: " << cdc_retained_bytes << " bytes. "
+                           << "log_max_cdc_retained_mb: " << FLAGS_log_max_cdc_retained_mb;
+  return true;
+}
+
 Status LogReader::GetSegmentPrefixNotIncluding(int64_t index, SegmentSequence* segments) const {
   return GetSegmentPrefixNotIncluding(index, index, segments);
 }
@@ -286,6 +390,19 @@ Status LogReader::GetSegmentPrefixNotIncluding(int64_t index, int64_t cdc_max_re
   std::lock_guard<simple_spinlock> lock(lock_);
   CHECK_EQ(state_, kLogReaderReading);
 
+  // Size of the segments that are retained only because of cdc unreplicated entries.
+  int64_t cdc_retained_bytes = 0;
+  if (FLAGS_enable_log_retention_by_op_idx && FLAGS_log_max_cdc_retained_mb > 0) {
+    for (const scoped_refptr<ReadableLogSegment>& segment : segments_) {
+      if (!segment->HasFooter() || segment->footer().max_replicate_index() >= index) {
+        break;
+      }
+      if (segment->footer().max_replicate_index() >= cdc_max_replicated_index) {
+        cdc_retained_bytes += segment->file_size();
+      }
+    }
+  }
+
   int64_t reclaimed_space = 0;
   for (const scoped_refptr<ReadableLogSegment>& segment : segments_) {
     // The last segment doesn't have a footer. Never include that one.
@@ -307,11 +424,14 @@ Status LogReader::GetSegmentPrefixNotIncluding(int64_t index, int64_t cdc_max_re
       // Since this log file contains cdc unreplicated entries, we don't want to GC it unless
       // it's too old, or we don't have enough space to store log files.
 
-      if (!ViolatesMaxTimePolicy(segment) && !ViolatesMinSpacePolicy(segment, &reclaimed_space)) {
+      if (!ViolatesMaxTimePolicy(segment) &&
+          !ViolatesMaxCdcRetainedSizePolicy(segment, cdc_retained_bytes) &&
+          !ViolatesMinSpacePolicy(segment, &reclaimed_space)) {
         // We exit the loop since this log segment already contains cdc unreplicated entries and so
         // do all subsequent files.
         break;
       }
+      cdc_retained_bytes -= segment->file_size();
     }
 
     // TODO: tests for edge cases here with backwards ordered replicates.
@@ -384,7 +504,8 @@ scoped_refptr<ReadableLogSegment> LogReader::GetSegmentBySequenceNumber(int64_t
 
 Status LogReader::ReadBatchUsingIndexEntry(const LogIndexEntry& index_entry,
                                            faststring* tmp_buf,
-                                           LogEntryBatchPB* batch) const {
+                                           LogEntryBatchPB* batch,
+                                           Slice* batch_data) const {
   const int64_t index = index_entry.op_id.index;
 
   scoped_refptr<ReadableLogSegment> segment = GetSegmentBySequenceNumber(
@@ -398,7 +519,7 @@ Status LogReader::ReadBatchUsingIndexEntry(const LogIndexEntry& index_entry,
   CHECK_GT(index_entry.offset_in_segment, 0);
   int64_t offset = index_entry.offset_in_segment;
   ScopedLatencyMetric scoped(read_batch_latency_.get());
-  RETURN_NOT_OK_PREPEND(segment->ReadEntryHeaderAndBatch(&offset, tmp_buf, batch),
+  RETURN_NOT_OK_PREPEND(segment->ReadEntryHeaderAndBatch(&offset, tmp_buf, batch, batch_data),
                         Substitute("Failed to read LogEntry for index $0 from log segment "
                                    "$1 offset $2",
                                    index,
@@ -418,11 +539,24 @@ Status LogReader::ReadReplicatesInRange(
     const int64_t up_to,
     int64_t max_bytes_to_read,
     ReplicateMsgs* replicates) const {
+  return ReadReplicatesInRange(
+      starting_at, up_to, max_bytes_to_read, 0 /* field_tag */, replicates,
+      nullptr /* serialized_replicates */);
+}
+
+Status LogReader::ReadReplicatesInRange(
+    const int64_t starting_at,
+    const int64_t up_to,
+    int64_t max_bytes_to_read,
+    uint32_t field_tag,
+    ReplicateMsgs* replicates,
+    std::vector<RefCntBuffer>* serialized_replicates) const {
   DCHECK_GT(starting_at, 0);
   DCHECK_GE(up_to, starting_at);
   DCHECK(log_index_) << "Require an index to random-read logs";
 
   ReplicateMsgs replicates_tmp;
+  std::vector<RefCntBuffer> serialized_replicates_tmp;
   LogIndexEntry prev_index_entry;
   prev_index_entry.segment_sequence_number = -1;
   prev_index_entry.offset_in_segment = -1;
@@ -431,6 +565,9 @@ Status LogReader::ReadReplicatesInRange(
   bool limit_exceeded = false;
   faststring tmp_buf;
   LogEntryBatchPB batch;
+  Slice batch_data;
+  // Serialized replicate of each entry of the batch, empty if it could not be found.
+  std::vector<Slice> batch_replicates;
   for (int64_t index = starting_at; index <= up_to && !limit_exceeded; index++) {
     LogIndexEntry index_entry;
     RETURN_NOT_OK_PREPEND(log_index_->GetEntry(index, &index_entry),
@@ -443,7 +580,13 @@ Status LogReader::ReadReplicatesInRange(
     if (index == starting_at ||
         index_entry.segment_sequence_number != prev_index_entry.segment_sequence_number ||
         index_entry.offset_in_segment != prev_index_entry.offset_in_segment) {
-      RETURN_NOT_OK(ReadBatchUsingIndexEntry(index_entry, &tmp_buf, &batch));
+      RETURN_NOT_OK(ReadBatchUsingIndexEntry(
+          index_entry, &tmp_buf, &batch, serialized_replicates ? &batch_data : nullptr));
+      if (serialized_replicates &&
+          (!FindSerializedReplicates(batch_data, &batch_replicates) ||
+           batch_replicates.size() != static_cast<size_t>(batch.entry_size()))) {
+        batch_replicates.clear();
+      }
 
       // Sanity-check the property that a batch should only have increasing indexes.
       int64_t prev_index = 0;
@@ -476,6 +619,11 @@ Status LogReader::ReadReplicatesInRange(
           total_size + space_required < max_bytes_to_read) {
         total_size += space_required;
         replicates_tmp.emplace_back(entry->release_replicate());
+        if (serialized_replicates) {
+          serialized_replicates_tmp.push_back(
+              batch_replicates.empty() ? RefCntBuffer()
+                                       : SerializedReplicateField(field_tag, batch_replicates[i]));
+        }
       } else {
         limit_exceeded = true;
       }
@@ -489,6 +637,9 @@ Status LogReader::ReadReplicatesInRange(
   }
 
   replicates->swap(replicates_tmp);
+  if (serialized_replicates) {
+    serialized_replicates->swap(serialized_replicates_tmp);
+  }
   return Status::OK();
 }
 
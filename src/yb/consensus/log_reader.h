@@ -46,6 +46,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/spinlock.h"
 #include "yb/util/locks.h"
+#include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
 
@@ -126,6 +127,18 @@ class LogReader {
       const int64_t up_to,
       int64_t max_bytes_to_read,
       ReplicateMsgs* replicates) const;
+
+  // Same as above, but also fills 'serialized_replicates' with the wire form of each read
+  // replicate, as a length-delimited field with 'field_tag'. It is copied from the raw entry batch
+  // read from the segment, so the message does not have to be serialized again to be sent to a
+  // peer. A buffer is null when the serialized replicate could not be located in the batch.
+  CHECKED_STATUS ReadReplicatesInRange(
+      int64_t starting_at,
+      int64_t up_to,
+      int64_t max_bytes_to_read,
+      uint32_t field_tag,
+      ReplicateMsgs* replicates,
+      std::vector<RefCntBuffer>* serialized_replicates) const;
   static const int64_t kNoSizeLimit;
 
   // Look up the OpId for the given operation index.
@@ -191,9 +204,12 @@ class LogReader {
 
   // Read the LogEntryBatch pointed to by the provided index entry.
   // 'tmp_buf' is used as scratch space to avoid extra allocation.
+  // If 'batch_data' is not null, it is set to the raw serialized batch, valid until 'tmp_buf' is
+  // modified.
   CHECKED_STATUS ReadBatchUsingIndexEntry(const LogIndexEntry& index_entry,
                                           faststring* tmp_buf,
-                                          LogEntryBatchPB* batch) const;
+                                          LogEntryBatchPB* batch,
+                                          Slice* batch_data = nullptr) const;
 
   LogReader(Env* env, const scoped_refptr<LogIndex>& index,
             std::string tablet_name, std::string peer_uuid,
@@ -214,6 +230,11 @@ class LogReader {
   bool ViolatesMinSpacePolicy(const scoped_refptr<ReadableLogSegment>& segment,
                               int64_t *potential_reclaimed_space) const;
 
+  // Return true if the segments retained only for cdc, starting from this one, are larger than
+  // FLAGS_log_max_cdc_retained_mb. cdc_retained_bytes is the size of these segments.
+  bool ViolatesMaxCdcRetainedSizePolicy(const scoped_refptr<ReadableLogSegment>& segment,
+                                        int64_t cdc_retained_bytes) const;
+
   Env *env_;
 
   const scoped_refptr<LogIndex> log_index_;
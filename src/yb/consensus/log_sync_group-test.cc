@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "yb/consensus/log_sync_group.h"
+#include "yb/util/path_util.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace log {
+
+class LogSyncGroupTest : public YBTest {
+};
+
+#if defined(__linux__)
+TEST_F(LogSyncGroupTest, TestSharedByFileSystem) {
+  const auto dir1 = JoinPathSegments(GetTestDataDirectory(), "wal1");
+  const auto dir2 = JoinPathSegments(GetTestDataDirectory(), "wal2");
+  ASSERT_OK(env_->CreateDir(dir1));
+  ASSERT_OK(env_->CreateDir(dir2));
+
+  auto group1 = ASSERT_RESULT(LogSyncGroup::ForDir(dir1));
+  auto group2 = ASSERT_RESULT(LogSyncGroup::ForDir(dir2));
+  ASSERT_EQ(group1, group2);
+
+  ASSERT_NOK(LogSyncGroup::ForDir(JoinPathSegments(GetTestDataDirectory(), "missing")));
+}
+
+TEST_F(LogSyncGroupTest, TestConcurrentSyncs) {
+  auto group = ASSERT_RESULT(LogSyncGroup::ForDir(GetTestDataDirectory()));
+  const uint64_t initial_syncs = group->num_syncs();
+
+  constexpr int kThreads = 8;
+  constexpr int kSyncsPerThread = 50;
+  std::vector<std::thread> threads;
+  std::atomic<int> failures{0};
+  for (int i = 0; i != kThreads; ++i) {
+    threads.emplace_back([&group, &failures] {
+      for (int j = 0; j != kSyncsPerThread; ++j) {
+        if (!group->Sync().ok()) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_EQ(0, failures.load());
+  const uint64_t syncs = group->num_syncs() - initial_syncs;
+  ASSERT_GE(syncs, kSyncsPerThread);
+  ASSERT_LE(syncs, kThreads * kSyncsPerThread);
+  LOG(INFO) << "Syncs issued for " << kThreads * kSyncsPerThread << " requests: " << syncs;
+}
+#endif
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/errno.h"
+#include "yb/util/thread_restrictions.h"
+
+DECLARE_bool(never_fsync);
+
+namespace yb {
+namespace log {
+
+Result<std::shared_ptr<LogSyncGroup>> LogSyncGroup::ForDir(const std::string& dir) {
+#if defined(__linux__)
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0) {
+    return STATUS(IOError, dir, Errno(errno));
+  }
+
+  static std::mutex groups_mutex;
+  static std::unordered_map<dev_t, std::weak_ptr<LogSyncGroup>> groups;
+
+  std::lock_guard<std::mutex> lock(groups_mutex);
+  auto& weak_group = groups[st.st_dev];
+  auto group = weak_group.lock();
+  if (!group) {
+    int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+      return STATUS(IOError, dir, Errno(errno));
+    }
+    group = std::make_shared<LogSyncGroup>(fd, dir);
+    weak_group = group;
+  }
+  return group;
+#else
+  return STATUS(NotSupported, "Sync of a whole file system is not supported on this platform");
+#endif
+}
+
+LogSyncGroup::LogSyncGroup(int fd, std::string path) : fd_(fd), path_(std::move(path)) {}
+
+LogSyncGroup::~LogSyncGroup() {
+  close(fd_);
+}
+
+Status LogSyncGroup::Sync() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Only a sync started after this point is guaranteed to cover the data written by the caller.
+  const uint64_t required_sync = started_syncs_ + 1;
+  for (;;) {
+    if (completed_syncs_ >= required_sync) {
+      return last_status_;
+    }
+    if (started_syncs_ == completed_syncs_) {
+      // No sync in progress, issue one on behalf of all waiting callers.
+      const uint64_t sync = ++started_syncs_;
+      lock.unlock();
+      Status status = DoSync();
+      lock.lock();
+      completed_syncs_ = sync;
+      last_status_ = status;
+      cond_.notify_all();
+      return status;
+    }
+    cond_.wait(lock);
+  }
+}
+
+uint64_t LogSyncGroup::num_syncs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return completed_syncs_;
+}
+
+Status LogSyncGroup::DoSync() {
+  ThreadRestrictions::AssertIOAllowed();
+  if (FLAGS_never_fsync) {
+    return Status::OK();
+  }
+#if defined(__linux__)
+  if (syncfs(fd_) != 0) {
+    return STATUS(IOError, "Failed to sync file system of " + path_, Errno(errno));
+  }
+#endif
+  return Status::OK();
+}
+
+} // namespace log
+} // namespace yb
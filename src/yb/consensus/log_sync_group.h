@@ -0,0 +1,76 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains LogSyncGroup, which makes the WALs of all tablets on a file system durable
+// with a shared sync, instead of an fsync per tablet.
+
+#ifndef YB_CONSENSUS_LOG_SYNC_GROUP_H
+#define YB_CONSENSUS_LOG_SYNC_GROUP_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/gutil/macros.h"
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace log {
+
+// Group commit of WAL syncs across tablets. A tablet server hosting many tablets would otherwise
+// issue an fsync per tablet WAL, and on devices limited by IOPS rather than bandwidth those small
+// fsyncs dominate. Instead, logs of all tablets whose WALs are on the same file system share a
+// group, and a sync of the group flushes all data written to the file system with a single
+// syncfs call.
+//
+// Concurrent Sync calls are combined: while a sync is in progress the callers queue up, and the
+// next sync, issued by one of them, serves all of them.
+class LogSyncGroup {
+ public:
+  // Returns the group for the file system containing the dir. Logs in the same file system share
+  // the same group. Returns NotSupported on platforms without syncfs.
+  static Result<std::shared_ptr<LogSyncGroup>> ForDir(const std::string& dir);
+
+  LogSyncGroup(int fd, std::string path);
+  ~LogSyncGroup();
+
+  // Makes all data written to files of the file system before the call durable.
+  CHECKED_STATUS Sync();
+
+  // Number of syncs issued to the file system.
+  uint64_t num_syncs() const;
+
+ private:
+  CHECKED_STATUS DoSync();
+
+  // Descriptor of a directory in the file system, used for syncfs.
+  const int fd_;
+  const std::string path_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  // Number of started and completed syncs.
+  uint64_t started_syncs_ = 0;
+  uint64_t completed_syncs_ = 0;
+  // Status of the last completed sync.
+  Status last_status_;
+
+  DISALLOW_COPY_AND_ASSIGN(LogSyncGroup);
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_SYNC_GROUP_H
@@ -742,10 +742,10 @@ Status ReadableLogSegment::MakeCorruptionStatus(
 }
 
 Status ReadableLogSegment::ReadEntryHeaderAndBatch(int64_t* offset, faststring* tmp_buf,
-                                                   LogEntryBatchPB* batch) {
+                                                   LogEntryBatchPB* batch, Slice* batch_data) {
   EntryHeader header;
   RETURN_NOT_OK(ReadEntryHeader(offset, &header));
-  RETURN_NOT_OK(ReadEntryBatch(offset, header, tmp_buf, batch));
+  RETURN_NOT_OK(ReadEntryBatch(offset, header, tmp_buf, batch, batch_data));
   return Status::OK();
 }
 
@@ -769,7 +769,7 @@ Status ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* hea
   header->header_crc = DecodeFixed32(data.data() + 8);
 
   // Verify the header.
-  uint32_t computed_crc = crc::Crc32c(data.data(), 8);
+  uint32_t computed_crc = crc::Crc32c(data.data(), 8) ^ header_.recycle_epoch();
   if (computed_crc != header->header_crc) {
     return STATUS_FORMAT(
         Corruption, "Invalid checksum in log entry head header: found=$0, computed=$1",
@@ -782,7 +782,8 @@ Status ReadableLogSegment::DecodeEntryHeader(const Slice& data, EntryHeader* hea
 Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
                                           const EntryHeader& header,
                                           faststring *tmp_buf,
-                                          LogEntryBatchPB* entry_batch) {
+                                          LogEntryBatchPB* entry_batch,
+                                          Slice* batch_data) {
   TRACE_EVENT2("log", "ReadableLogSegment::ReadEntryBatch",
                "path", path_,
                "range", Substitute("offset=$0 entry_len=$1",
@@ -832,6 +833,9 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
 
   *offset += entry_batch_slice.size();
   entry_batch->Swap(&read_entry_batch);
+  if (batch_data) {
+    *batch_data = entry_batch_slice;
+  }
   return Status::OK();
 }
 
@@ -909,8 +913,9 @@ Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
   uint32_t msg_crc = crc::Crc32c(data.data(), data.size());
   InlineEncodeFixed32(&header_buf[4], msg_crc);
 
-  // Then the CRC of the header
-  uint32_t header_crc = crc::Crc32c(&header_buf, 8);
+  // Then the CRC of the header, mixed with the recycle epoch, so entries left from previous uses of
+  // a recycled file don't pass the check.
+  uint32_t header_crc = crc::Crc32c(&header_buf, 8) ^ header_.recycle_epoch();
   InlineEncodeFixed32(&header_buf[8], header_crc);
 
   // Write the header to the file, followed by the batch data itself.
@@ -962,6 +967,26 @@ bool IsLogFileName(const string& fname) {
   return true;
 }
 
+Status WipeLogSegmentMagics(Env* env, const std::string& path) {
+  const uint64_t file_size = VERIFY_RESULT(env->GetFileSize(path));
+  if (file_size < kLogSegmentHeaderMagicAndHeaderLength + kLogSegmentFooterMagicAndFooterLength) {
+    return STATUS_FORMAT(Corruption, "Log segment $0 is too small: $1", path, file_size);
+  }
+
+  RWFileOptions opts;
+  opts.mode = Env::OPEN_EXISTING;
+  std::unique_ptr<RWFile> file;
+  RETURN_NOT_OK(env->NewRWFile(opts, path, &file));
+
+  static const uint8_t kZeros[std::max(kLogSegmentHeaderMagicAndHeaderLength,
+                                       kLogSegmentFooterMagicAndFooterLength)] = {0};
+  RETURN_NOT_OK(file->Write(0, Slice(kZeros, kLogSegmentHeaderMagicAndHeaderLength)));
+  RETURN_NOT_OK(file->Write(file_size - kLogSegmentFooterMagicAndFooterLength,
+                            Slice(kZeros, kLogSegmentFooterMagicAndFooterLength)));
+  RETURN_NOT_OK(file->Sync());
+  return file->Close();
+}
+
 std::vector<std::string> ParseDirFlags(string flag_dirs, string flag_name) {
   std::vector<std::string> paths = strings::Split(flag_dirs, ",", strings::SkipEmpty());
   return paths;
@@ -312,9 +312,12 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
                               const std::vector<std::unique_ptr<LogEntryPB>>& entries,
                               const Status& status) const;
 
+  // If 'batch_data' is not null, it is set to the raw serialized batch, which stays valid until
+  // 'tmp_buf' is modified.
   CHECKED_STATUS ReadEntryHeaderAndBatch(int64_t* offset,
                                          faststring* tmp_buf,
-                                         LogEntryBatchPB* batch);
+                                         LogEntryBatchPB* batch,
+                                         Slice* batch_data = nullptr);
 
   // Reads a log entry header from the segment.
   // Also increments the passed offset* by the length of the entry.
@@ -332,7 +335,8 @@ class ReadableLogSegment : public RefCountedThreadSafe<ReadableLogSegment> {
   CHECKED_STATUS ReadEntryBatch(int64_t *offset,
                                 const EntryHeader& header,
                                 faststring* tmp_buf,
-                                LogEntryBatchPB* entry_batch);
+                                LogEntryBatchPB* entry_batch,
+                                Slice* batch_data = nullptr);
 
   void UpdateReadableToOffset(int64_t readable_to_offset);
 
@@ -475,6 +479,11 @@ LogEntryBatchPB CreateBatchFromAllocatedOperations(const ReplicateMsgs& msgs);
 // Checks if 'fname' is a correctly formatted name of log segment file.
 bool IsLogFileName(const std::string& fname);
 
+// Prepares a no longer used segment file for reuse: wipes the header and footer magics, so until
+// a new header is written the file is treated as a blank preallocated segment, and leftovers of
+// the previous footer are not taken for the footer of the new segment.
+CHECKED_STATUS WipeLogSegmentMagics(Env* env, const std::string& path);
+
 CHECKED_STATUS CheckPathsAreODirectWritable(const std::vector<std::string>& paths);
 CHECKED_STATUS CheckRelevantPathsAreODirectWritable();
 
@@ -0,0 +1,161 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <map>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_header.pb.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(multi_raft_batch_window_ms, 50,
+             "Max time a heartbeat to a follower could wait to be combined with heartbeats of "
+             "other tablets to the same server in a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(multi_raft_batch_window_ms, advanced);
+TAG_FLAG(multi_raft_batch_window_ms, runtime);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+MultiRaftHeartbeatBatcherPtr MultiRaftHeartbeatBatcher::ForHost(
+    rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport) {
+  typedef std::pair<rpc::ProxyCache*, HostPort> Key;
+  static std::mutex batchers_mutex;
+  static std::map<Key, std::weak_ptr<MultiRaftHeartbeatBatcher>> batchers;
+
+  std::lock_guard<std::mutex> lock(batchers_mutex);
+  auto& weak_batcher = batchers[Key(proxy_cache, hostport)];
+  auto batcher = weak_batcher.lock();
+  if (!batcher) {
+    batcher = std::make_shared<MultiRaftHeartbeatBatcher>(messenger, proxy_cache, hostport);
+    weak_batcher = batcher;
+  }
+  return batcher;
+}
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport)
+    : messenger_(messenger),
+      hostport_(hostport),
+      consensus_proxy_(std::make_unique<ConsensusServiceProxy>(proxy_cache, hostport)) {}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {}
+
+void MultiRaftHeartbeatBatcher::AddRequestToBatch(const ConsensusRequestPB* request,
+                                                  ConsensusResponsePB* response,
+                                                  rpc::RpcController* controller,
+                                                  rpc::ResponseCallback callback) {
+  if (multi_raft_update_not_supported_.load(std::memory_order_acquire)) {
+    consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
+    return;
+  }
+
+  BatchPtr new_batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!current_batch_) {
+      current_batch_ = std::make_shared<Batch>();
+      new_batch = current_batch_;
+    }
+    *current_batch_->request.add_consensus_request() = *request;
+    current_batch_->callbacks.push_back({request, response, controller, std::move(callback)});
+  }
+
+  if (!new_batch) {
+    return;
+  }
+
+  auto task_id = messenger_->ScheduleOnReactor(
+      [self = shared_from_this(), new_batch](const Status& status) {
+        self->FlushBatch(new_batch);
+      },
+      MonoDelta::FromMilliseconds(FLAGS_multi_raft_batch_window_ms), SOURCE_LOCATION(),
+      messenger_);
+  if (task_id == rpc::kInvalidTaskId) {
+    FlushBatch(new_batch);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::FlushBatch(const BatchPtr& batch) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_batch_ != batch) {
+      return;
+    }
+    current_batch_.reset();
+  }
+
+  batch->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
+  consensus_proxy_->MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      std::bind(&MultiRaftHeartbeatBatcher::MultiRaftUpdateHeartbeatResponseCallback,
+                shared_from_this(), batch));
+}
+
+void MultiRaftHeartbeatBatcher::MultiRaftUpdateHeartbeatResponseCallback(const BatchPtr& batch) {
+  const auto status = batch->controller.status();
+  if (status.IsRemoteError()) {
+    const auto* error = batch->controller.error_response();
+    if (error && error->code() == rpc::ErrorStatusPB::ERROR_NO_SUCH_METHOD) {
+      LOG(INFO) << "MultiRaftUpdateConsensus is not supported by " << hostport_
+                << ", sending heartbeats separately";
+      multi_raft_update_not_supported_.store(true, std::memory_order_release);
+      SendRequestsSeparately(batch);
+      return;
+    }
+  }
+
+  auto& responses = *batch->response.mutable_consensus_response();
+  if (status.ok() && static_cast<size_t>(responses.size()) != batch->callbacks.size()) {
+    LOG(DFATAL) << "Wrong number of responses from " << hostport_ << ": "
+                << responses.size() << ", while " << batch->callbacks.size() << " expected";
+  }
+
+  for (size_t i = 0; i != batch->callbacks.size(); ++i) {
+    auto& data = batch->callbacks[i];
+    if (status.ok()) {
+      if (i < static_cast<size_t>(responses.size())) {
+        data.response->Swap(&responses[i]);
+      } else {
+        StatusToPB(STATUS(IllegalState, "Missing response in MultiRaftUpdateConsensus"),
+                   data.response->mutable_error()->mutable_status());
+        data.response->mutable_error()->set_code(tserver::TabletServerErrorPB::UNKNOWN_ERROR);
+      }
+    }
+    data.controller->ShareFinishedCall(batch->controller);
+    data.callback();
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendRequestsSeparately(const BatchPtr& batch) {
+  for (auto& data : batch->callbacks) {
+    consensus_proxy_->UpdateConsensusAsync(
+        *data.request, data.response, data.controller, std::move(data.callback));
+  }
+}
+
+} // namespace consensus
+} // namespace yb
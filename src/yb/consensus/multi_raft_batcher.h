@@ -0,0 +1,112 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This file contains MultiRaftHeartbeatBatcher, which combines heartbeats sent by leaders of
+// different tablets to followers on the same server into a single RPC.
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus_fwd.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/rpc/response_callback.h"
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+
+namespace rpc {
+class Messenger;
+class ProxyCache;
+}
+
+namespace consensus {
+
+// A server hosting many tablets would otherwise send a heartbeat RPC for each tablet it leads to
+// each of its followers every raft_heartbeat_interval_ms. Heartbeats to the same server are
+// instead collected for up to multi_raft_batch_window_ms and sent together with a single
+// MultiRaftUpdateConsensus RPC, whose response is then demultiplexed to the callers.
+//
+// Only requests without ops are batched, requests replicating ops are sent right away, so
+// batching does not delay replication.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  // Returns the batcher for heartbeats to the server at the hostport. Peers of all tablets
+  // talking to the same server via the same proxy cache share the batcher.
+  static std::shared_ptr<MultiRaftHeartbeatBatcher> ForHost(
+      rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport);
+
+  MultiRaftHeartbeatBatcher(
+      rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport);
+  ~MultiRaftHeartbeatBatcher();
+
+  // Adds the request to the current batch. The request and response should be valid until the
+  // callback is invoked. After that the controller has the status of the call that carried the
+  // request, and the response is filled as if the request was sent with UpdateConsensus.
+  void AddRequestToBatch(const ConsensusRequestPB* request,
+                         ConsensusResponsePB* response,
+                         rpc::RpcController* controller,
+                         rpc::ResponseCallback callback);
+
+ private:
+  struct ResponseCallbackData {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+
+  struct Batch {
+    MultiRaftConsensusRequestPB request;
+    MultiRaftConsensusResponsePB response;
+    rpc::RpcController controller;
+    std::vector<ResponseCallbackData> callbacks;
+  };
+  typedef std::shared_ptr<Batch> BatchPtr;
+
+  // Sends the batch, if it is still the current one.
+  void FlushBatch(const BatchPtr& batch);
+
+  void MultiRaftUpdateHeartbeatResponseCallback(const BatchPtr& batch);
+
+  // Sends requests of the batch one by one, used when the remote server does not support
+  // MultiRaftUpdateConsensus.
+  void SendRequestsSeparately(const BatchPtr& batch);
+
+  rpc::Messenger* const messenger_;
+  const HostPort hostport_;
+  const ConsensusServiceProxyPtr consensus_proxy_;
+
+  std::mutex mutex_;
+  BatchPtr current_batch_;
+
+  // Set when the remote server responded that it does not support MultiRaftUpdateConsensus.
+  std::atomic<bool> multi_raft_update_not_supported_{false};
+
+  DISALLOW_COPY_AND_ASSIGN(MultiRaftHeartbeatBatcher);
+};
+
+} // namespace consensus
+} // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
@@ -36,6 +36,8 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/optional.hpp>
 #include <gflags/gflags.h>
@@ -53,6 +55,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/periodic.h"
 #include "yb/server/clock.h"
 #include "yb/server/metadata.h"
@@ -60,6 +63,7 @@
 
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/debug/long_operation_tracker.h"
+#include "yb/util/debug-util.h"
 #include "yb/util/enums.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
@@ -199,6 +203,20 @@ DEFINE_bool(quick_leader_election_on_create, true, "Do we trigger quick leader e
 TAG_FLAG(quick_leader_election_on_create, advanced);
 TAG_FLAG(quick_leader_election_on_create, hidden);
 
+DEFINE_bool(share_leader_failure_detection, true,
+            "When a tablet detects failure of its leader, start elections in other tablets on "
+            "this server led by the same server, that also did not hear from their leader "
+            "recently, instead of waiting for their own failure detectors. Only used with pre "
+            "elections, so tablets with a live leader are not disrupted.");
+TAG_FLAG(share_leader_failure_detection, advanced);
+TAG_FLAG(share_leader_failure_detection, runtime);
+
+DEFINE_int32(shared_leader_failure_election_stagger_ms, 200,
+             "Elections started because other tablet detected failure of the same leader are "
+             "spread randomly over this interval, to avoid starting all of them at once.");
+TAG_FLAG(shared_leader_failure_election_stagger_ms, advanced);
+TAG_FLAG(shared_leader_failure_election_stagger_ms, runtime);
+
 namespace yb {
 namespace consensus {
 
@@ -210,6 +228,77 @@ using std::weak_ptr;
 using strings::Substitute;
 using tserver::TabletServerErrorPB;
 
+namespace {
+
+// Consensus instances of the tablets of each server, identified by the server messenger. Used to
+// share detection of a failed leader between tablets led by the same server.
+class ServerConsensusRegistry {
+ public:
+  static ServerConsensusRegistry& Instance() {
+    static ServerConsensusRegistry instance;
+    return instance;
+  }
+
+  void Register(rpc::Messenger* messenger, const std::shared_ptr<RaftConsensus>& consensus) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    servers_[messenger].consensuses.emplace(consensus.get(), consensus);
+  }
+
+  void Unregister(rpc::Messenger* messenger, RaftConsensus* consensus) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servers_.find(messenger);
+    if (it == servers_.end()) {
+      return;
+    }
+    it->second.consensuses.erase(consensus);
+    if (it->second.consensuses.empty()) {
+      servers_.erase(it);
+    }
+  }
+
+  // Returns consensus instances of the server, except the source, that should be notified about
+  // the failure of the leader. Returns nothing if the failure of this leader was already reported
+  // during the last election timeout.
+  std::vector<std::shared_ptr<RaftConsensus>> ConsensusesToNotify(
+      rpc::Messenger* messenger, const std::string& leader_uuid, RaftConsensus* source,
+      MonoDelta election_timeout) {
+    std::vector<std::shared_ptr<RaftConsensus>> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = servers_.find(messenger);
+    if (it == servers_.end()) {
+      return result;
+    }
+    auto now = MonoTime::Now();
+    auto& reported_at = it->second.leader_failure_reported_at[leader_uuid];
+    if (reported_at.Initialized() && now < reported_at + election_timeout) {
+      return result;
+    }
+    reported_at = now;
+    result.reserve(it->second.consensuses.size());
+    for (const auto& entry : it->second.consensuses) {
+      if (entry.first == source) {
+        continue;
+      }
+      auto consensus = entry.second.lock();
+      if (consensus) {
+        result.push_back(std::move(consensus));
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct ServerConsensuses {
+    std::unordered_map<RaftConsensus*, std::weak_ptr<RaftConsensus>> consensuses;
+    std::unordered_map<std::string, MonoTime> leader_failure_reported_at;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<rpc::Messenger*, ServerConsensuses> servers_;
+};
+
+} // namespace
+
 shared_ptr<RaftConsensus> RaftConsensus::Create(
     const ConsensusOptions& options,
     std::unique_ptr<ConsensusMetadata> cmeta,
@@ -353,6 +442,11 @@ Status RaftConsensus::Start(const ConsensusBootstrapInfo& info) {
       },
       MinimumElectionTimeout());
 
+  if (peer_proxy_factory_->messenger()) {
+    ServerConsensusRegistry::Instance().Register(
+        peer_proxy_factory_->messenger(), shared_from_this());
+  }
+
   {
     ReplicaState::UniqueLock lock;
     RETURN_NOT_OK(state_->LockForStart(&lock));
@@ -397,9 +491,24 @@ Status RaftConsensus::Start(const ConsensusBootstrapInfo& info) {
         // more likely to fail due to uninitialized peers or conflicting elections, which could
         // have unforseen consequences.
         if (FLAGS_quick_leader_election_on_create) {
-          initial_delta = (state_->GetCommittedConfigUnlocked().peers_size() == 1) ?
-              MonoDelta::kZero :
-              MonoDelta::FromMilliseconds(rng_.Uniform(FLAGS_raft_heartbeat_interval_ms));
+          const auto& config = state_->GetCommittedConfigUnlocked();
+          if (config.peers_size() == 1) {
+            initial_delta = MonoDelta::kZero;
+          } else {
+            // The first voter of the config is meant to be the initial leader: the other peers
+            // wait an extra heartbeat interval, so they only run for leader if it does not, and
+            // new tablets rarely go through conflicting elections.
+            auto delay_ms = rng_.Uniform(FLAGS_raft_heartbeat_interval_ms);
+            auto designated_leader = std::find_if(
+                config.peers().begin(), config.peers().end(), [](const RaftPeerPB& peer) {
+                  return peer.member_type() == RaftPeerPB::VOTER;
+                });
+            if (designated_leader != config.peers().end() &&
+                designated_leader->permanent_uuid() != state_->GetPeerUuid()) {
+              delay_ms += FLAGS_raft_heartbeat_interval_ms;
+            }
+            initial_delta = MonoDelta::FromMilliseconds(delay_ms);
+          }
         }
       }
     }
@@ -819,12 +928,83 @@ void RaftConsensus::ReportFailureDetectedTask() {
     }
   }
 
+  std::string leader_uuid;
+  {
+    auto lock = state_->LockForRead();
+    if (state_->GetActiveRoleUnlocked() == RaftPeerPB::FOLLOWER) {
+      leader_uuid = state_->GetLeaderUuidUnlocked();
+    }
+  }
+
   // Start an election.
   LOG_WITH_PREFIX(INFO) << "ReportFailDetected: Starting NORMAL_ELECTION...";
   Status s = StartElection({ElectionMode::NORMAL_ELECTION});
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX(WARNING) << "Failed to trigger leader election: " << s.ToString();
   }
+
+  if (!leader_uuid.empty()) {
+    NotifyOtherTabletsOfLeaderFailure(leader_uuid);
+  }
+}
+
+void RaftConsensus::NotifyOtherTabletsOfLeaderFailure(const std::string& leader_uuid) {
+  auto* messenger = peer_proxy_factory_->messenger();
+  if (!messenger || !FLAGS_use_preelection ||
+      !GetAtomicFlag(&FLAGS_share_leader_failure_detection)) {
+    return;
+  }
+
+  auto consensuses = ServerConsensusRegistry::Instance().ConsensusesToNotify(
+      messenger, leader_uuid, this, MinimumElectionTimeout());
+  if (consensuses.empty()) {
+    return;
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Notifying " << consensuses.size()
+                        << " other tablets about failure of leader " << leader_uuid;
+  const auto stagger_ms = GetAtomicFlag(&FLAGS_shared_leader_failure_election_stagger_ms);
+  for (const auto& consensus : consensuses) {
+    consensus->LeaderFailureDetectedByOtherTablet(
+        leader_uuid, MonoDelta::FromMilliseconds(RandomUniformInt(0, std::max(stagger_ms, 0))));
+  }
+}
+
+void RaftConsensus::LeaderFailureDetectedByOtherTablet(
+    const std::string& leader_uuid, MonoDelta delay) {
+  if (!ShouldStartElectionOnLeaderFailure(leader_uuid)) {
+    return;
+  }
+
+  std::weak_ptr<RaftConsensus> weak_self = shared_from_this();
+  auto* messenger = peer_proxy_factory_->messenger();
+  auto task_id = messenger->ScheduleOnReactor(
+      [weak_self, leader_uuid](const Status& status) {
+        auto consensus = weak_self.lock();
+        if (status.ok() && consensus &&
+            consensus->ShouldStartElectionOnLeaderFailure(leader_uuid)) {
+          consensus->ReportFailureDetected();
+        }
+      },
+      delay, SOURCE_LOCATION(), messenger);
+  if (task_id == rpc::kInvalidTaskId) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to schedule election on failure of leader " << leader_uuid;
+  }
+}
+
+bool RaftConsensus::ShouldStartElectionOnLeaderFailure(const std::string& leader_uuid) {
+  if (!GetAtomicFlag(&FLAGS_enable_leader_failure_detection)) {
+    return false;
+  }
+  auto lock = state_->LockForRead();
+  if (state_->GetActiveRoleUnlocked() != RaftPeerPB::FOLLOWER ||
+      state_->GetLeaderUuidUnlocked() != leader_uuid) {
+    return false;
+  }
+  // The leader is still alive for this tablet, so its failure was specific to the other tablet.
+  auto heartbeat_interval = MonoDelta::FromMilliseconds(FLAGS_raft_heartbeat_interval_ms);
+  return !last_message_from_leader_time_.Initialized() ||
+         MonoTime::Now() - last_message_from_leader_time_ >= heartbeat_interval * 2;
 }
 
 void RaftConsensus::ReportFailureDetected() {
@@ -2274,6 +2454,9 @@ void RaftConsensus::Shutdown() {
   // We might not have run Start yet, so make sure we have a FD.
   if (failure_detector_) {
     DisableFailureDetector();
+    if (peer_proxy_factory_->messenger()) {
+      ServerConsensusRegistry::Instance().Unregister(peer_proxy_factory_->messenger(), this);
+    }
   }
 
   CHECK_OK(ExecuteHook(POST_SHUTDOWN));
@@ -290,12 +290,23 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
     return last_message_from_leader_time_;
   }
 
+  // Called when another tablet on this server detected failure of the leader with the specified
+  // uuid. If this tablet is led by the same server, and did not hear from it recently, an election
+  // is started after the delay, without waiting for the failure detector.
+  void LeaderFailureDetectedByOtherTablet(const std::string& leader_uuid, MonoDelta delay);
+
  private:
   friend class ReplicaState;
   friend class RaftConsensusQuorumTest;
 
   CHECKED_STATUS DoStartElection(const LeaderElectionData& data, PreElected preelected);
 
+  // Lets other tablets of this server led by the same leader start elections, see
+  // LeaderFailureDetectedByOtherTablet.
+  void NotifyOtherTabletsOfLeaderFailure(const std::string& leader_uuid);
+
+  bool ShouldStartElectionOnLeaderFailure(const std::string& leader_uuid);
+
   Result<LeaderElectionPtr> CreateElectionUnlocked(
       const LeaderElectionData& data,
       MonoDelta timeout,
@@ -627,7 +627,8 @@ bool ShouldAllowOpAfterSplitTablet(const OperationType& op_type) {
     case UPDATE_TRANSACTION_OP: FALLTHROUGH_INTENDED;
     case SNAPSHOT_OP: FALLTHROUGH_INTENDED;
     case TRUNCATE_OP: FALLTHROUGH_INTENDED;
-    case SPLIT_OP:
+    case SPLIT_OP: FALLTHROUGH_INTENDED;
+    case IMPORT_DATA_OP:
       return false;
   }
   FATAL_INVALID_ENUM_VALUE(OperationType, op_type);
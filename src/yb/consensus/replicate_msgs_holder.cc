@@ -24,6 +24,7 @@ ReplicateMsgsHolder::ReplicateMsgsHolder(
 
 ReplicateMsgsHolder::ReplicateMsgsHolder(ReplicateMsgsHolder&& rhs)
     : ops_(rhs.ops_), messages_(std::move(rhs.messages_)),
+      serialized_ops_(std::move(rhs.serialized_ops_)),
       consumption_(std::move(rhs.consumption_)) {
   rhs.ops_ = nullptr;
 }
@@ -32,6 +33,7 @@ void ReplicateMsgsHolder::operator=(ReplicateMsgsHolder&& rhs) {
   Reset();
   ops_ = rhs.ops_;
   messages_ = std::move(rhs.messages_);
+  serialized_ops_ = std::move(rhs.serialized_ops_);
   consumption_ = std::move(rhs.consumption_);
   rhs.ops_ = nullptr;
 }
@@ -47,6 +49,7 @@ void ReplicateMsgsHolder::Reset() {
   }
 
   messages_.clear();
+  serialized_ops_.clear();
   consumption_ = ScopedTrackedConsumption();
 }
 
@@ -19,6 +19,7 @@
 #include "yb/consensus/consensus_fwd.h"
 
 #include "yb/util/mem_tracker.h"
+#include "yb/util/ref_cnt_buffer.h"
 
 namespace yb {
 namespace consensus {
@@ -46,6 +47,19 @@ class ReplicateMsgsHolder {
     ops_ = nullptr;
   }
 
+  // Sets the wire form of the ops, each element corresponds to the op with the same index.
+  void SetSerializedOps(std::vector<RefCntBuffer> serialized_ops) {
+    serialized_ops_ = std::move(serialized_ops);
+  }
+
+  bool has_serialized_ops() const {
+    return !serialized_ops_.empty();
+  }
+
+  std::vector<RefCntBuffer> TakeSerializedOps() {
+    return std::move(serialized_ops_);
+  }
+
  private:
   google::protobuf::RepeatedPtrField<ReplicateMsg>* ops_;
 
@@ -55,6 +69,9 @@ class ReplicateMsgsHolder {
   // them.
   ReplicateMsgs messages_;
 
+  // Wire form of the ops, shared with the log cache and requests to other peers.
+  std::vector<RefCntBuffer> serialized_ops_;
+
   ScopedTrackedConsumption consumption_;
 };
 
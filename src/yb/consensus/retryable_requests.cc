@@ -22,6 +22,7 @@
 #include "yb/consensus/consensus.h"
 
 #include "yb/util/atomic.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/opid.h"
 
@@ -233,7 +234,7 @@ class RetryableRequests::Impl {
     }
 
     auto& replicated_indexed_by_last_id = client_retryable_requests.replicated.get<LastIdIndex>();
-    auto it = replicated_indexed_by_last_id.lower_bound(data.request_id());
+    auto it = LowerBound(data.request_id(), &replicated_indexed_by_last_id);
     if (it != replicated_indexed_by_last_id.end() && it->first_id <= data.request_id()) {
       round->NotifyReplicationFinished(
           STATUS(AlreadyPresent, "Duplicate request"), round->bound_term(),
@@ -250,9 +251,7 @@ class RetryableRequests::Impl {
     }
 
     VLOG_WITH_PREFIX(4) << "Running added " << data;
-    if (running_requests_gauge_) {
-      running_requests_gauge_->Increment();
-    }
+    RunningChanged(1);
 
     return true;
   }
@@ -271,9 +270,7 @@ class RetryableRequests::Impl {
         ++it;
         ++count;
       }
-      if (replicated_request_ranges_gauge_) {
-        replicated_request_ranges_gauge_->DecrementBy(count);
-      }
+      ReplicatedRangesChanged(-count);
       if (it != op_id_index.end()) {
         result = std::min(result, it->min_op_id);
         op_id_index.erase(op_id_index.begin(), it);
@@ -292,6 +289,7 @@ class RetryableRequests::Impl {
       }
       ++ci;
     }
+    UpdateMemoryUsage();
 
     return result;
   }
@@ -325,9 +323,7 @@ class RetryableRequests::Impl {
     }
     auto entry_time = running_it->time;
     running_indexed_by_request_id.erase(running_it);
-    if (running_requests_gauge_) {
-      running_requests_gauge_->Decrement();
-    }
+    RunningChanged(-1);
 
     if (status.ok()) {
       AddReplicated(
@@ -366,9 +362,14 @@ class RetryableRequests::Impl {
   }
 
   void SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity) {
-    running_requests_gauge_ = METRIC_running_retryable_requests.Instantiate(metric_entity, 0);
+    running_requests_gauge_ = METRIC_running_retryable_requests.Instantiate(
+        metric_entity, num_running_);
     replicated_request_ranges_gauge_ = METRIC_replicated_retryable_request_ranges.Instantiate(
-        metric_entity, 0);
+        metric_entity, num_replicated_ranges_);
+  }
+
+  void SetMemTracker(const MemTrackerPtr& mem_tracker) {
+    mem_tracker_consumption_ = ScopedTrackedConsumption(mem_tracker, EstimatedMemoryUsage());
   }
 
   RetryableRequestsCounts TEST_Counts() {
@@ -397,10 +398,7 @@ class RetryableRequests::Impl {
           it->first_id < new_min_running_request_id) {
         it->first_id = new_min_running_request_id;
       }
-      if (replicated_request_ranges_gauge_) {
-        replicated_request_ranges_gauge_->DecrementBy(
-            std::distance(replicated_indexed_by_last_id.begin(), it));
-      }
+      ReplicatedRangesChanged(-std::distance(replicated_indexed_by_last_id.begin(), it));
       // Remove all intervals that has ids below write_request.min_running_request_id().
       replicated_indexed_by_last_id.erase(replicated_indexed_by_last_id.begin(), it);
       client_retryable_requests->min_running_request_id = new_min_running_request_id;
@@ -411,7 +409,7 @@ class RetryableRequests::Impl {
                      ClientRetryableRequests* client) {
     auto request_id = data.request_id();
     auto& replicated_indexed_by_last_id = client->replicated.get<LastIdIndex>();
-    auto request_it = replicated_indexed_by_last_id.lower_bound(request_id);
+    auto request_it = LowerBound(request_id, &replicated_indexed_by_last_id);
     if (request_it != replicated_indexed_by_last_id.end() && request_it->first_id <= request_id) {
 #ifndef NDEBUG
       LOG_WITH_PREFIX(ERROR)
@@ -442,8 +440,58 @@ class RetryableRequests::Impl {
     }
 
     client->replicated.emplace(request_id, op_id, time);
+    ReplicatedRangesChanged(1);
+  }
+
+  // Same as lower_bound, but O(1) for ids above all replicated ids, as the ids of a client mostly
+  // grow.
+  ReplicatedRetryableRequestRangesByLastId::iterator LowerBound(
+      RetryableRequestId request_id,
+      ReplicatedRetryableRequestRangesByLastId* replicated_indexed_by_last_id) {
+    if (replicated_indexed_by_last_id->empty() ||
+        replicated_indexed_by_last_id->rbegin()->last_id < request_id) {
+      return replicated_indexed_by_last_id->end();
+    }
+    return replicated_indexed_by_last_id->lower_bound(request_id);
+  }
+
+  void RunningChanged(int64_t delta) {
+    num_running_ += delta;
+    if (running_requests_gauge_) {
+      running_requests_gauge_->IncrementBy(delta);
+    }
+    UpdateMemoryUsage();
+  }
+
+  void ReplicatedRangesChanged(int64_t delta) {
+    if (delta == 0) {
+      return;
+    }
+    num_replicated_ranges_ += delta;
     if (replicated_request_ranges_gauge_) {
-      replicated_request_ranges_gauge_->Increment();
+      replicated_request_ranges_gauge_->IncrementBy(delta);
+    }
+    UpdateMemoryUsage();
+  }
+
+  // Approximation of the memory used by the containers, including their nodes.
+  int64_t EstimatedMemoryUsage() const {
+    constexpr int64_t kClientSize =
+        sizeof(std::pair<const ClientId, ClientRetryableRequests>) + 2 * sizeof(void*);
+    constexpr int64_t kRunningSize = sizeof(RunningRetryableRequest) + 5 * sizeof(void*);
+    constexpr int64_t kReplicatedRangeSize =
+        sizeof(ReplicatedRetryableRequestRange) + 6 * sizeof(void*);
+    return clients_.size() * kClientSize + num_running_ * kRunningSize +
+           num_replicated_ranges_ * kReplicatedRangeSize;
+  }
+
+  void UpdateMemoryUsage() {
+    if (!mem_tracker_consumption_) {
+      return;
+    }
+    auto usage = EstimatedMemoryUsage();
+    if (usage != mem_tracker_consumption_.consumption()) {
+      mem_tracker_consumption_.Reset(usage);
     }
   }
 
@@ -483,9 +531,7 @@ class RetryableRequests::Impl {
     min_op_id = std::min(min_op_id, request_prev_it->min_op_id);
     request_it->PrepareJoinWithPrev(*request_prev_it);
     replicated_indexed_by_last_id->erase(request_prev_it);
-    if (replicated_request_ranges_gauge_) {
-      replicated_request_ranges_gauge_->Decrement();
-    }
+    ReplicatedRangesChanged(-1);
     UpdateMinOpId(request_it, min_op_id, replicated_indexed_by_last_id);
 
     return true;
@@ -532,6 +578,9 @@ class RetryableRequests::Impl {
   RestartSafeCoarseMonoClock clock_;
   scoped_refptr<AtomicGauge<int64_t>> running_requests_gauge_;
   scoped_refptr<AtomicGauge<int64_t>> replicated_request_ranges_gauge_;
+  int64_t num_running_ = 0;
+  int64_t num_replicated_ranges_ = 0;
+  ScopedTrackedConsumption mem_tracker_consumption_;
 };
 
 RetryableRequests::RetryableRequests(std::string log_prefix)
@@ -578,5 +627,9 @@ void RetryableRequests::SetMetricEntity(const scoped_refptr<MetricEntity>& metri
   impl_->SetMetricEntity(metric_entity);
 }
 
+void RetryableRequests::SetMemTracker(const MemTrackerPtr& mem_tracker) {
+  impl_->SetMemTracker(mem_tracker);
+}
+
 } // namespace consensus
 } // namespace yb
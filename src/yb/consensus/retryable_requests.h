@@ -14,15 +14,20 @@
 #ifndef YB_CONSENSUS_RETRYABLE_REQUESTS_H
 #define YB_CONSENSUS_RETRYABLE_REQUESTS_H
 
+#include <memory>
+
 #include "yb/consensus/consensus_fwd.h"
 
 #include "yb/util/restart_safe_clock.h"
 
 namespace yb {
 
+class MemTracker;
 class MetricEntity;
 struct OpId;
 
+typedef std::shared_ptr<MemTracker> MemTrackerPtr;
+
 namespace consensus {
 
 struct RetryableRequestsCounts {
@@ -62,6 +67,9 @@ class RetryableRequests {
 
   void SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity);
 
+  // Sets the tracker to account the estimated memory usage of the requests to.
+  void SetMemTracker(const MemTrackerPtr& mem_tracker);
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
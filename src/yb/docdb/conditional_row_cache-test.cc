@@ -0,0 +1,98 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/docdb/conditional_row_cache.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+const Schema kSchema({
+        ColumnSchema("k", DataType::INT64, /* is_nullable = */ false),
+        ColumnSchema("v1", DataType::INT64, true),
+        ColumnSchema("v2", DataType::INT64, true)
+    }, {
+        10_ColId,
+        20_ColId,
+        30_ColId
+    }, 1);
+
+Schema Projection(const std::vector<ColumnId>& column_ids) {
+  Schema projection;
+  CHECK_OK(kSchema.CreateProjectionByIdsIgnoreMissing(column_ids, &projection));
+  return projection;
+}
+
+ConditionalRowCache::Entry ExistingRow(int64_t v1) {
+  ConditionalRowCache::Entry entry;
+  entry.exists = true;
+  entry.row.AllocColumn(10_ColId).value.set_int64_value(1);
+  entry.row.AllocColumn(20_ColId).value.set_int64_value(v1);
+  entry.columns.push_back(20_ColId);
+  return entry;
+}
+
+} // namespace
+
+class ConditionalRowCacheTest : public YBTest {
+};
+
+TEST_F(ConditionalRowCacheTest, Find) {
+  ConditionalRowCache cache(10);
+  QLTableRow row;
+  ASSERT_FALSE(cache.Find("a", 1, Projection({20_ColId}), &row));
+
+  cache.Insert("a", 1, ExistingRow(5));
+  ASSERT_TRUE(cache.Find("a", 1, Projection({20_ColId}), &row));
+  ASSERT_EQ(row.GetValue(20_ColId)->int64_value(), 5);
+
+  // Columns that are not known, and entries of another term, are not found.
+  ASSERT_FALSE(cache.Find("a", 1, Projection({20_ColId, 30_ColId}), &row));
+  ASSERT_FALSE(cache.Find("a", 2, Projection({20_ColId}), &row));
+
+  // All columns of a row that does not exist are known.
+  cache.Insert("a", 2, ConditionalRowCache::Entry());
+  ASSERT_TRUE(cache.Find("a", 2, Projection({20_ColId, 30_ColId}), &row));
+  ASSERT_TRUE(row.IsEmpty());
+  ASSERT_EQ(cache.size(), 1);
+
+  cache.Erase("a");
+  ASSERT_FALSE(cache.Find("a", 2, Projection({20_ColId}), &row));
+  ASSERT_EQ(cache.size(), 0);
+}
+
+TEST_F(ConditionalRowCacheTest, Eviction) {
+  ConditionalRowCache cache(2);
+  QLTableRow row;
+  cache.Insert("a", 1, ExistingRow(1));
+  cache.Insert("b", 1, ExistingRow(2));
+  // Lookup makes "a" the most recently used row.
+  ASSERT_TRUE(cache.Find("a", 1, Projection({20_ColId}), &row));
+  cache.Insert("c", 1, ExistingRow(3));
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_TRUE(cache.Find("a", 1, Projection({20_ColId}), &row));
+  ASSERT_FALSE(cache.Find("b", 1, Projection({20_ColId}), &row));
+  ASSERT_TRUE(cache.Find("c", 1, Projection({20_ColId}), &row));
+
+  cache.Clear();
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_FALSE(cache.Find("a", 1, Projection({20_ColId}), &row));
+}
+
+}  // namespace docdb
+}  // namespace yb
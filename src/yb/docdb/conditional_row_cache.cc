@@ -0,0 +1,105 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/conditional_row_cache.h"
+
+#include <algorithm>
+
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace docdb {
+
+ConditionalRowCache::ConditionalRowCache(size_t capacity, Counter* hits, Counter* misses)
+    : capacity_(capacity), hits_(hits), misses_(misses) {
+}
+
+ConditionalRowCache::~ConditionalRowCache() {
+}
+
+bool ConditionalRowCache::Find(
+    const Slice& key, int64_t term, const Schema& projection, QLTableRow* row) {
+  const bool found = DoFind(key, term, projection, row);
+  Counter* counter = found ? hits_ : misses_;
+  if (counter) {
+    counter->Increment();
+  }
+  return found;
+}
+
+bool ConditionalRowCache::DoFind(
+    const Slice& key, int64_t term, const Schema& projection, QLTableRow* row) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = map_.find(key);
+  if (it == map_.end() || it->second->term != term) {
+    return false;
+  }
+  const Entry& entry = it->second->entry;
+  if (entry.exists) {
+    for (size_t i = projection.num_key_columns(); i < projection.num_columns(); ++i) {
+      if (!std::binary_search(
+              entry.columns.begin(), entry.columns.end(), projection.column_id(i))) {
+        return false;
+      }
+    }
+  }
+  *row = entry.row;
+  nodes_.splice(nodes_.begin(), nodes_, it->second);
+  return true;
+}
+
+void ConditionalRowCache::Insert(const Slice& key, int64_t term, Entry entry) {
+  std::sort(entry.columns.begin(), entry.columns.end());
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = map_.find(key);
+  if (it != map_.end()) {
+    it->second->term = term;
+    it->second->entry = std::move(entry);
+    nodes_.splice(nodes_.begin(), nodes_, it->second);
+    return;
+  }
+  if (capacity_ == 0) {
+    return;
+  }
+  if (nodes_.size() >= capacity_) {
+    map_.erase(Slice(nodes_.back().key));
+    nodes_.pop_back();
+  }
+  nodes_.push_front(Node{key.ToBuffer(), term, std::move(entry)});
+  map_.emplace(Slice(nodes_.front().key), nodes_.begin());
+}
+
+void ConditionalRowCache::Erase(const Slice& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = map_.find(key);
+  if (it == map_.end()) {
+    return;
+  }
+  auto node = it->second;
+  map_.erase(it);
+  nodes_.erase(node);
+}
+
+void ConditionalRowCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  map_.clear();
+  nodes_.clear();
+}
+
+size_t ConditionalRowCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nodes_.size();
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_CONDITIONAL_ROW_CACHE_H_
+#define YB_DOCDB_CONDITIONAL_ROW_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/schema.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class Counter;
+
+namespace docdb {
+
+// Per-tablet cache of the latest values of rows written by conditional QL writes (IF clause), so
+// the precondition of the next conditional write of a hot row can be checked without reading the
+// row from RocksDB.
+//
+// Entries are keyed by the encoded primary key of the row, and hold the values of the columns, that
+// are known, of the row as last written by a conditional write. An entry is only valid in the Raft
+// term it was written in. Leader writes of a term are serialized by the row locks, so the entry
+// is up to date as long as every other write of the row erases it. Entries are added when a write
+// is applied, before its locks are released.
+//
+// The cache is an LRU of fixed capacity. This class is thread-safe.
+class ConditionalRowCache {
+ public:
+  struct Entry {
+    // Whether the row exists. All columns of a row that does not exist are known to be null.
+    bool exists = false;
+    // Values of the key columns and of the known columns of the row.
+    QLTableRow row;
+    // Sorted ids of the known non-key columns.
+    std::vector<ColumnId> columns;
+  };
+
+  // Lookups that found the row, or not, are counted in hits and misses, if given.
+  ConditionalRowCache(size_t capacity, Counter* hits = nullptr, Counter* misses = nullptr);
+  ~ConditionalRowCache();
+
+  // Looks up the row with the given key written in term. Returns true and fills row, if the
+  // values of all columns of projection are known.
+  bool Find(const Slice& key, int64_t term, const Schema& projection, QLTableRow* row);
+
+  void Insert(const Slice& key, int64_t term, Entry entry);
+
+  void Erase(const Slice& key);
+
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  struct Node {
+    std::string key;
+    int64_t term;
+    Entry entry;
+  };
+
+  typedef std::list<Node> Nodes;
+
+  bool DoFind(const Slice& key, int64_t term, const Schema& projection, QLTableRow* row);
+
+  const size_t capacity_;
+  Counter* const hits_;
+  Counter* const misses_;
+
+  mutable std::mutex mutex_;
+  // Nodes in the order of use, most recently used first.
+  Nodes nodes_ GUARDED_BY(mutex_);
+  // Keys point to the keys of nodes_.
+  std::unordered_map<Slice, Nodes::iterator, Slice::Hash> map_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(ConditionalRowCache);
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_CONDITIONAL_ROW_CACHE_H_
@@ -66,7 +66,9 @@ struct TransactionData {
 
 CHECKED_STATUS MakeConflictStatus(const TransactionId& our_id, const TransactionId& other_id,
                                   const char* reason, Counter* conflicts_metric) {
-  conflicts_metric->Increment();
+  if (conflicts_metric) {
+    conflicts_metric->Increment();
+  }
   return (STATUS(TryAgain, Format("$0 Conflicts with $1 transaction: $2", our_id, reason, other_id),
                  Slice(), TransactionError(TransactionErrorCode::kConflict)));
 }
@@ -494,13 +496,15 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
                                      const KeyValueWriteBatchPB& write_batch,
                                      HybridTime resolution_ht,
                                      HybridTime read_time,
-                                     Counter* conflicts_metric)
+                                     Counter* conflicts_metric,
+                                     bool* blocked_by_higher_priority)
       : doc_ops_(doc_ops),
         write_batch_(write_batch),
         resolution_ht_(resolution_ht),
         read_time_(read_time),
         transaction_id_(FullyDecodeTransactionId(write_batch.transaction().transaction_id())),
-        conflicts_metric_(conflicts_metric)
+        conflicts_metric_(conflicts_metric),
+        blocked_by_higher_priority_(blocked_by_higher_priority)
   {}
 
   virtual ~TransactionConflictResolverContext() {}
@@ -595,6 +599,11 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
     for (auto& transaction : *transactions) {
       auto their_priority = transaction.priority;
       if (our_priority < their_priority) {
+        // Waiting only for transactions of higher priority, while transactions of lower priority
+        // are aborted, could not form a cycle of waiting transactions, even across tablets.
+        if (metadata_.wait_on_conflict && blocked_by_higher_priority_) {
+          *blocked_by_higher_priority_ = true;
+        }
         return MakeConflictStatus(
             metadata_.transaction_id, transaction.id, "higher priority", conflicts_metric_);
       }
@@ -658,6 +667,7 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
   Status result_ = Status::OK();
   bool fetched_metadata_for_transactions_ = false;
   Counter* conflicts_metric_ = nullptr;
+  bool* blocked_by_higher_priority_ = nullptr;
 };
 
 class OperationConflictResolverContext : public ConflictResolverContext {
@@ -742,10 +752,14 @@ Status ResolveTransactionConflicts(const DocOperations& doc_ops,
                                    const DocDB& doc_db,
                                    PartialRangeKeyIntents partial_range_key_intents,
                                    TransactionStatusManager* status_manager,
-                                   Counter* conflicts_metric) {
+                                   Counter* conflicts_metric,
+                                   bool* blocked_by_higher_priority) {
   DCHECK(hybrid_time.is_valid());
+  if (blocked_by_higher_priority) {
+    *blocked_by_higher_priority = false;
+  }
   TransactionConflictResolverContext context(
-      doc_ops, write_batch, hybrid_time, read_time, conflicts_metric);
+      doc_ops, write_batch, hybrid_time, read_time, conflicts_metric, blocked_by_higher_priority);
   ConflictResolver resolver(doc_db, status_manager, partial_range_key_intents, &context);
   return resolver.Resolve();
 }
@@ -45,7 +45,10 @@ namespace docdb {
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
-// conflicts_metric - transaction_conflicts metric to update.
+// conflicts_metric - transaction_conflicts metric to update, could be null.
+// blocked_by_higher_priority - if not null, set to true when the transaction asked to wait on
+//     conflicts and the error is caused by a pending transaction of higher priority. The write
+//     could be retried after releasing its locks, once the conflicting transaction completes.
 CHECKED_STATUS ResolveTransactionConflicts(const DocOperations& doc_ops,
                                            const KeyValueWriteBatchPB& write_batch,
                                            HybridTime resolution_ht,
@@ -53,7 +56,8 @@ CHECKED_STATUS ResolveTransactionConflicts(const DocOperations& doc_ops,
                                            const DocDB& doc_db,
                                            PartialRangeKeyIntents partial_range_key_intents,
                                            TransactionStatusManager* status_manager,
-                                           Counter* conflicts_metric);
+                                           Counter* conflicts_metric,
+                                           bool* blocked_by_higher_priority = nullptr);
 
 // Resolves conflicts for doc operations.
 // Read all intents that could conflict with provided doc_ops.
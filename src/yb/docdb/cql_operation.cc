@@ -28,6 +28,7 @@
 
 #include "yb/util/bfpg/tserver_opcodes.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/scope_exit.h"
 #include "yb/util/trace.h"
 
 #include "yb/yql/cql/ql/util/errcodes.h"
@@ -42,6 +43,12 @@ DEFINE_bool(ycql_consistent_transactional_paging, false,
             "be stale. The latter is preferable for long scans. The data returned for the first "
             "page of results is never stale regardless of this flag.");
 
+DEFINE_bool(ycql_skip_unchanged_index_writes, true,
+            "Whether writes of a YCQL row, that change neither the indexed nor the covering "
+            "columns of an index, skip the write of the unchanged entry to the index table.");
+TAG_FLAG(ycql_skip_unchanged_index_writes, advanced);
+TAG_FLAG(ycql_skip_unchanged_index_writes, runtime);
+
 DECLARE_bool(trace_docdb_calls);
 
 namespace yb {
@@ -383,6 +390,11 @@ Status QLWriteOperation::ReadColumns(const DocOperationApplyData& data,
     data.restart_read_ht->MakeAtLeast(iterator.RestartReadHt());
   }
   if (pk_doc_key_) {
+    if (UseConditionalRowCache() &&
+        row_cache_->Find(encoded_pk_doc_key_.as_slice(), row_cache_term_, *non_static_projection,
+                         table_row)) {
+      return Status::OK();
+    }
     DocQLScanSpec spec(*non_static_projection, *pk_doc_key_, request_.query_id());
     DocRowwiseIterator iterator(*non_static_projection, schema_, txn_op_context_,
                                 data.doc_write_batch->doc_db(),
@@ -408,6 +420,50 @@ Status QLWriteOperation::ReadColumns(const DocOperationApplyData& data,
   return Status::OK();
 }
 
+bool QLWriteOperation::UseConditionalRowCache() const {
+  return row_cache_ != nullptr && request_.has_if_expr() && pk_doc_key_ && !hashed_doc_key_ &&
+         !update_indexes_ && !insert_into_unique_index_ && !request_.has_ttl() &&
+         !request_.has_user_timestamp_usec();
+}
+
+void QLWriteOperation::SetUnchangedRowCacheEntry(
+    const QLTableRow& existing_row, const Schema& projection) {
+  ConditionalRowCache::Entry entry;
+  if (!existing_row.IsEmpty()) {
+    // The values read must not expire, and the row must exist because of a value read, since the
+    // TTL of the liveness column is not known.
+    bool has_value = false;
+    for (size_t i = projection.num_key_columns(); i < projection.num_columns(); ++i) {
+      const auto& column_id = projection.column_id(i);
+      const auto& type = projection.column(i).type();
+      if (type->IsParametric() || type->IsJson()) {
+        return;
+      }
+      int64_t ttl_seconds = -1;
+      if (existing_row.GetTTL(column_id, &ttl_seconds).ok()) {
+        if (ttl_seconds != -1) {
+          return;
+        }
+        has_value = has_value || !IsNull(*existing_row.GetValue(column_id));
+      }
+      entry.columns.push_back(column_id);
+    }
+    if (!has_value) {
+      return;
+    }
+    entry.exists = true;
+    entry.row = existing_row;
+  }
+  row_cache_entry_ = std::move(entry);
+}
+
+void QLWriteOperation::UpdateConditionalRowCache(int64_t term) {
+  if (row_cache_ != nullptr && row_cache_entry_) {
+    row_cache_->Insert(encoded_pk_doc_key_.as_slice(), term, std::move(*row_cache_entry_));
+    row_cache_entry_ = boost::none;
+  }
+}
+
 Status QLWriteOperation::PopulateConditionalDmlRow(const DocOperationApplyData& data,
                                                    const bool should_apply,
                                                    const QLTableRow& table_row,
@@ -758,13 +814,28 @@ Status QLWriteOperation::ApplyForRegularColumns(const QLColumnValuePB& column_va
       break;
   }
 
-  if (update_indexes_) {
+  if (update_indexes_ || collect_new_row_) {
     new_row->AllocColumn(column_id, expr_result.Value());
   }
   return Status::OK();
 }
 
 Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
+  row_cache_entry_ = boost::none;
+  collect_new_row_ = false;
+  // Any write of a row invalidates its cached values. The entry prepared by a conditional write is
+  // added back once the write is applied.
+  auto erase_cached_row = ScopeExit([this] {
+    if (row_cache_ == nullptr) {
+      return;
+    }
+    if (encoded_pk_doc_key_) {
+      row_cache_->Erase(encoded_pk_doc_key_.as_slice());
+    } else {
+      row_cache_->Clear();
+    }
+  });
+
   QLTableRow existing_row;
   if (request_.has_if_expr()) {
     // Check if the if-condition is satisfied.
@@ -772,6 +843,9 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
     Schema static_projection, non_static_projection;
     RETURN_NOT_OK(ReadColumns(data, &static_projection, &non_static_projection, &existing_row));
     RETURN_NOT_OK(EvalCondition(request_.if_expr().condition(), existing_row, &should_apply));
+    if (UseConditionalRowCache()) {
+      SetUnchangedRowCacheEntry(existing_row, non_static_projection);
+    }
     // Set the response accordingly.
     response_->set_applied(should_apply);
     if (!should_apply && request_.else_error()) {
@@ -832,6 +906,7 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
     }
   }
 
+  collect_new_row_ = row_cache_entry_.is_initialized();
   switch (request_.type()) {
     // QL insert == update (upsert) to be consistent with Cassandra's semantics. In either
     // INSERT or UPDATE, if non-key columns are specified, they will be inserted which will cause
@@ -866,6 +941,12 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
                 encoded_hashed_doc_key_.as_slice() : encoded_pk_doc_key_.as_slice(),
             PrimitiveValue(column_id));
 
+        // Only plain values of elementary columns are tracked in the conditional row cache.
+        if (!column_value.json_args().empty() || !column_value.subscript_args().empty() ||
+            column.type()->IsParametric() || column.type()->IsJson()) {
+          collect_new_row_ = false;
+        }
+
         QLValue expr_result;
         if (!column_value.json_args().empty()) {
           RETURN_NOT_OK(ApplyForJsonOperators(column_value, data, sub_path, ttl,
@@ -882,6 +963,36 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
       if (update_indexes_) {
         RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
       }
+
+      if (collect_new_row_) {
+        auto& entry = *row_cache_entry_;
+        if (!entry.exists) {
+          // All columns of a row that did not exist are null, unless written now.
+          entry.columns.clear();
+          for (size_t i = schema_.num_key_columns(); i < schema_.num_columns(); ++i) {
+            if (!schema_.column(i).is_static()) {
+              entry.columns.push_back(schema_.column_id(i));
+            }
+          }
+        }
+        for (const auto& column_value : request_.column_values()) {
+          const ColumnId column_id(column_value.column_id());
+          // An update that sets a column to null could remove a row that has no liveness column.
+          const auto value = new_row.GetValue(column_id);
+          if (!is_insert && (!value || IsNull(*value))) {
+            collect_new_row_ = false;
+            break;
+          }
+          // Values written by the operation do not expire.
+          new_row.AllocColumn(column_id).ttl_seconds = -1;
+          entry.columns.push_back(column_id);
+        }
+        entry.exists = true;
+        entry.row = std::move(new_row);
+      }
+      if (!collect_new_row_) {
+        row_cache_entry_ = boost::none;
+      }
       break;
     }
     case QLWriteRequestPB::QL_STMT_DELETE: {
@@ -911,6 +1022,7 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         if (update_indexes_) {
           RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
         }
+        row_cache_entry_ = boost::none;
       } else if (IsRangeOperation(request_, schema_)) {
         // If the range columns are not specified, we read everything and delete all rows for
         // which the where condition matches.
@@ -973,6 +1085,9 @@ Status QLWriteOperation::Apply(const DocOperationApplyData& data) {
         if (update_indexes_) {
           RETURN_NOT_OK(UpdateIndexes(existing_row, new_row));
         }
+        if (row_cache_entry_) {
+          row_cache_entry_ = ConditionalRowCache::Entry();
+        }
       }
       break;
     }
@@ -1059,6 +1174,31 @@ bool QLWriteOperation::IsRowDeleted(const QLTableRow& existing_row,
   return false;
 }
 
+bool QLWriteOperation::IsIndexEntryUnchanged(const IndexInfo& index,
+                                             const QLTableRow& existing_row,
+                                             const QLTableRow& new_row) const {
+  if (!FLAGS_ycql_skip_unchanged_index_writes || !index.AllowReads() || existing_row.IsEmpty()) {
+    return false;
+  }
+  // The non-key columns of the index are read before the DML. A value of a non-static one shows
+  // that the row exists, as only static columns are read otherwise.
+  bool row_exists = false;
+  for (const IndexInfo::IndexColumn& index_column : index.columns()) {
+    const ColumnId column_id = index_column.indexed_column_id;
+    const int column_idx = schema_.find_column_by_id(column_id);
+    if (column_idx == Schema::kColumnNotFound || schema_.is_key_column(column_idx)) {
+      continue;
+    }
+    if (new_row.IsColumnSpecified(column_id) && !new_row.MatchColumn(column_id, existing_row)) {
+      return false;
+    }
+    if (!schema_.column(column_idx).is_static() && existing_row.IsColumnSpecified(column_id)) {
+      row_exists = true;
+    }
+  }
+  return row_exists;
+}
+
 namespace {
 
 QLExpressionPB* NewKeyColumn(QLWriteRequestPB* request, const IndexInfo& index, const size_t idx) {
@@ -1095,6 +1235,12 @@ Status QLWriteOperation::UpdateIndexes(const QLTableRow& existing_row, const QLT
                                 : nullptr);
       RETURN_NOT_OK(PrepareIndexWriteAndCheckIfIndexKeyChanged(
           this, existing_row, new_row, index, index_request, &index_key_changed));
+      // Rewriting the unchanged index entry of an existing row is a no-op, so the write to the
+      // index table and the transaction it would need are saved.
+      if (index_request && !index_key_changed &&
+          IsIndexEntryUnchanged(*index, existing_row, new_row)) {
+        index_requests_.pop_back();
+      }
     }
 
     // If the index key is changed, delete the current key.
@@ -1238,6 +1384,15 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   RETURN_NOT_OK(ql_storage.BuildYQLScanSpec(
       request_, read_time, schema, read_static_columns, static_projection, &spec,
       &static_row_spec));
+  if (table_image_ && !read_static_columns &&
+      VERIFY_RESULT(ExecuteFromImage(schema, spec, row_count_limit, resultset))) {
+    if (FLAGS_trace_docdb_calls) {
+      TRACE("Fetched $0 rows from table image.", resultset->rsrow_count());
+    }
+    // No rows were written after the image, so there is nothing to restart the read for.
+    *restart_read_ht = HybridTime::kInvalid;
+    return Status::OK();
+  }
   RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
                                        deadline, read_time, *spec, &iter));
   if (FLAGS_trace_docdb_calls) {
@@ -1359,6 +1514,48 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   return Status::OK();
 }
 
+Result<bool> QLReadOperation::ExecuteFromImage(const Schema& schema,
+                                               const std::unique_ptr<common::QLScanSpec>& spec,
+                                               const size_t row_count_limit,
+                                               QLResultSet* resultset) {
+  // Only the reads of all rows of a partition in the key order are answered from the image, the
+  // others need the iterator to continue from, or to return, the paging state.
+  if (request_.has_paging_state() || request_.has_offset() || request_.distinct() ||
+      !request_.is_forward_scan() || !request_.has_hash_code() ||
+      schema.num_hash_key_columns() == 0 ||
+      static_cast<size_t>(request_.hashed_column_values().size()) !=
+          schema.num_hash_key_columns()) {
+    return false;
+  }
+
+  std::vector<PrimitiveValue> hashed_components;
+  RETURN_NOT_OK(QLKeyColumnValuesToPrimitiveValues(
+      request_.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
+      &hashed_components));
+  KeyBytes hash_part;
+  DocKeyEncoder(&hash_part).Schema(schema).Hash(
+      static_cast<uint16_t>(request_.hash_code()), hashed_components);
+  const auto* rows = table_image_->Find(hash_part.AsSlice());
+  if (rows == nullptr) {
+    return true;
+  }
+  // A read that could stop before the end of the partition should return the paging state.
+  if (!request_.is_aggregate() && rows->size() >= row_count_limit) {
+    return false;
+  }
+
+  int match_count = 0;
+  size_t num_rows_skipped = 0;
+  for (const auto& row : *rows) {
+    RETURN_NOT_OK(AddRowToResult(
+        spec, row, row_count_limit, 0 /* offset */, resultset, &match_count, &num_rows_skipped));
+  }
+  if (request_.is_aggregate() && match_count > 0) {
+    RETURN_NOT_OK(PopulateAggregate(rows->back(), resultset));
+  }
+  return true;
+}
+
 Status QLReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                                   const QLResultSet* resultset,
                                                   const size_t row_count_limit,
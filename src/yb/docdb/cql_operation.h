@@ -17,11 +17,13 @@
 #include "yb/common/ql_protocol.pb.h"
 #include "yb/common/typedefs.h"
 
+#include "yb/docdb/conditional_row_cache.h"
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/table_image.h"
 
 namespace yb {
 
@@ -98,6 +100,25 @@ class QLWriteOperation :
   // Rowblock to return the "[applied]" status for conditional DML.
   const QLRowBlock* rowblock() const { return rowblock_.get(); }
 
+  // Uses the cache of rows written by conditional writes of the tablet, in the given leader term.
+  // The operation erases its row from the cache when applied.
+  void SetConditionalRowCache(ConditionalRowCache* cache, int64_t term) {
+    row_cache_ = cache;
+    row_cache_term_ = term;
+  }
+
+  // The encoded primary key of the row written, if the full primary key is specified.
+  const RefCntPrefix& encoded_pk_doc_key() const { return encoded_pk_doc_key_; }
+
+  // Whether the row written by this operation is to be added to the conditional row cache.
+  bool has_row_cache_entry() const { return row_cache_entry_.is_initialized(); }
+
+  void DiscardRowCacheEntry() { row_cache_entry_ = boost::none; }
+
+  // Adds the row written by this operation to the conditional row cache, once the operation is
+  // applied in the given term.
+  void UpdateConditionalRowCache(int64_t term);
+
  private:
   void ClearResponse() override {
     if (response_) {
@@ -134,11 +155,24 @@ class QLWriteOperation :
       IntentAwareIterator* iter, const SubDocKey& sub_doc_key,
       HybridTime min_hybrid_time);
 
+  // Whether the row of this conditional write could be read from, and added to, the conditional
+  // row cache.
+  bool UseConditionalRowCache() const;
+
+  // Prepares the entry of the conditional row cache for the row that is left unchanged, because
+  // the condition of the write is not satisfied.
+  void SetUnchangedRowCacheEntry(const QLTableRow& existing_row, const Schema& projection);
+
   CHECKED_STATUS DeleteRow(const DocPath& row_path, DocWriteBatch* doc_write_batch,
                            const ReadHybridTime& read_ht, CoarseTimePoint deadline);
 
   bool IsRowDeleted(const QLTableRow& current_row, const QLTableRow& new_row) const;
 
+  // Whether the entry of the current row in the index stays the same after the DML, because the
+  // row exists and none of the indexed and covering columns is changed.
+  bool IsIndexEntryUnchanged(const IndexInfo& index, const QLTableRow& current_row,
+                             const QLTableRow& new_row) const;
+
   CHECKED_STATUS UpdateIndexes(const QLTableRow& current_row, const QLTableRow& new_row);
 
   QLWriteRequestPB* NewIndexRequest(const IndexInfo* index,
@@ -182,6 +216,16 @@ class QLWriteOperation :
 
   // Does the liveness column exist before the write operation?
   bool liveness_column_exists_ = false;
+
+  // Cache of rows written by conditional writes, and the term it is valid in.
+  ConditionalRowCache* row_cache_ = nullptr;
+  int64_t row_cache_term_ = 0;
+
+  // Are the values written to be collected in the new row, for the conditional row cache?
+  bool collect_new_row_ = false;
+
+  // The entry to add to the conditional row cache once the write is applied.
+  boost::optional<ConditionalRowCache::Entry> row_cache_entry_;
 };
 
 CHECKED_STATUS PrepareIndexWriteAndCheckIfIndexKeyChanged(QLExprExecutor* expr_executor,
@@ -225,7 +269,20 @@ class QLReadOperation : public DocExprExecutor {
 
   QLResponsePB& response() { return response_; }
 
+  // Reads of a single partition that could be answered from the rows of the given image are
+  // answered from it instead of reading RocksDB. The image must be as of the read time: no rows of
+  // the table could be written after the hybrid time of the image and up to the read time.
+  void SetTableImage(std::shared_ptr<const TableImage> table_image) {
+    table_image_ = std::move(table_image);
+  }
+
  private:
+  // Adds the rows of the read partition from table_image_ to the result set. Returns false when
+  // the read should be answered from RocksDB instead.
+  Result<bool> ExecuteFromImage(const Schema& schema,
+                                const std::unique_ptr<common::QLScanSpec>& spec,
+                                const size_t row_count_limit,
+                                QLResultSet* resultset);
 
   // Checks whether we have processed enough rows for a page and sets the appropriate paging
   // state in the response object.
@@ -237,6 +294,7 @@ class QLReadOperation : public DocExprExecutor {
 
   const QLReadRequestPB& request_;
   const TransactionOperationContextOpt txn_op_context_;
+  std::shared_ptr<const TableImage> table_image_;
   QLResponsePB response_;
 };
 
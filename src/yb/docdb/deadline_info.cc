@@ -27,24 +27,28 @@ DEFINE_test_flag(bool, test_tserver_timeout, false,
 namespace yb {
 namespace docdb {
 
-DeadlineInfo::DeadlineInfo(CoarseTimePoint deadline) : deadline_(deadline) {}
+DeadlineInfo::DeadlineInfo(
+    CoarseTimePoint deadline, const CancellationToken* cancellation_token)
+    : deadline_(deadline), cancellation_token_(cancellation_token) {}
 
-// Every 1024 iterations, check whether the deadline passed and if so, change deadline_passed_
-// before returning.
+// Every 1024 iterations, check whether the deadline passed or the operation was cancelled, and if
+// so, change deadline_passed_ before returning.
 bool DeadlineInfo::CheckAndSetDeadlinePassed() {
   if (deadline_passed_) {
     return true;
   }
-  if ((PREDICT_FALSE(FLAGS_test_tserver_timeout) || (++counter_ & 1023) == 0)
-      && CoarseMonoClock::now() > deadline_) {
+  if ((PREDICT_FALSE(FLAGS_test_tserver_timeout) || (++counter_ & 1023) == 0) &&
+      (CoarseMonoClock::now() > deadline_ ||
+       (cancellation_token_ && cancellation_token_->cancelled()))) {
     deadline_passed_ = true;
   }
   return deadline_passed_;
 }
 
 std::string DeadlineInfo::ToString() const {
-  return Format("{ now: $0 deadline: $1 counter: $2 }",
-                CoarseMonoClock::now(), deadline_, counter_);
+  return Format("{ now: $0 deadline: $1 counter: $2 cancelled: $3 }",
+                CoarseMonoClock::now(), deadline_, counter_,
+                cancellation_token_ && cancellation_token_->cancelled());
 }
 
 void SimulateTimeoutIfTesting(CoarseTimePoint* deadline) {
@@ -14,19 +14,26 @@
 #ifndef YB_DOCDB_DEADLINE_INFO_H
 #define YB_DOCDB_DEADLINE_INFO_H
 
+#include "yb/util/cancellation_token.h"
 #include "yb/util/monotime.h"
 
 namespace yb {
 namespace docdb {
 
+// Tracks whether a long running operation, like a scan, should stop because its deadline passed
+// or it was cancelled, for instance because the client that requested it has disconnected.
+// By default the cancellation token adopted by the current thread is used.
 class DeadlineInfo {
  public:
-  explicit DeadlineInfo(CoarseTimePoint deadline);
+  explicit DeadlineInfo(
+      CoarseTimePoint deadline,
+      const CancellationToken* cancellation_token = CancellationToken::Current());
   bool CheckAndSetDeadlinePassed();
   std::string ToString() const;
 
  private:
   CoarseTimePoint deadline_;
+  const CancellationToken* cancellation_token_;
   uint32_t counter_ = 0;
   bool deadline_passed_ = false;
 };
@@ -13,10 +13,17 @@
 //
 //
 
+#include <limits>
+
 #include "yb/rocksdb/db/dbformat.h"
 
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_ttl_util.h"
+#include "yb/docdb/docdb_expiration_index.h"
+#include "yb/docdb/value.h"
+
+#include "yb/gutil/endian.h"
 
 namespace yb {
 namespace docdb {
@@ -30,6 +37,7 @@ Status GetPrimitiveValue(const rocksdb::UserBoundaryValues& values,
 namespace {
 
 constexpr rocksdb::UserBoundaryTag kDocHybridTimeTag = 1;
+constexpr rocksdb::UserBoundaryTag kExpirationTag = 2;
 // Here we reserve some tags for future use.
 // Because Tag is persistent.
 constexpr rocksdb::UserBoundaryTag kRangeComponentsStart = 10;
@@ -80,6 +88,74 @@ class DocHybridTimeValue : public rocksdb::UserBoundaryValue {
   Slice encoded_;
 };
 
+// Wrapper for UserBoundaryValue that stores the physical time, in microseconds, at which an entry
+// expires by its own TTL. Entries that expire by the TTL of the table have kExpiresByTableTtl and
+// entries that never expire have kNeverExpires, so the largest value of a file tells when all of
+// its entries with a TTL of their own expire.
+class ExpirationValue : public rocksdb::UserBoundaryValue {
+ public:
+  static constexpr uint64_t kExpiresByTableTtl = 0;
+  static constexpr uint64_t kNeverExpires = std::numeric_limits<uint64_t>::max();
+
+  explicit ExpirationValue(uint64_t expiration_micros) {
+    BigEndian::Store64(buffer_, expiration_micros);
+  }
+
+  static CHECKED_STATUS Create(Slice data, rocksdb::UserBoundaryValuePtr* value) {
+    CHECK_NOTNULL(value);
+    if (data.size() != sizeof(uint64_t)) {
+      return STATUS_SUBSTITUTE(Corruption, "Wrong size of encoded expiration: $0", data.size());
+    }
+
+    *value = std::make_shared<ExpirationValue>(BigEndian::Load64(data.data()));
+    return Status::OK();
+  }
+
+  // Expiration of the entry with the given write time and value.
+  static uint64_t Of(Slice doc_ht_slice, Slice value) {
+    ValueType value_type;
+    uint64_t merge_flags = 0;
+    MonoDelta ttl;
+    DocHybridTime doc_ht;
+    // Merge records only extend the TTL of the entries they are applied to, and a delete marker
+    // could shadow entries of newer files with older hybrid times, so neither of them is said to
+    // expire.
+    if (!Value::DecodePrimitiveValueType(value, &value_type, &merge_flags, &ttl).ok() ||
+        merge_flags != 0 || value_type == ValueType::kTombstone || ttl.Equals(Value::kResetTtl) ||
+        !doc_ht.FullyDecodeFrom(doc_ht_slice).ok()) {
+      return kNeverExpires;
+    }
+    if (ttl.Equals(Value::kMaxTtl)) {
+      return kExpiresByTableTtl;
+    }
+    return doc_ht.hybrid_time().GetPhysicalValueMicros() + ttl.ToMicroseconds();
+  }
+
+  virtual ~ExpirationValue() {}
+
+  rocksdb::UserBoundaryTag Tag() override {
+    return kExpirationTag;
+  }
+
+  Slice Encode() override {
+    return Slice(buffer_, sizeof(buffer_));
+  }
+
+  int CompareTo(const UserBoundaryValue& pre_rhs) override {
+    const auto* rhs = down_cast<const ExpirationValue*>(&pre_rhs);
+    const auto lhs_value = value();
+    const auto rhs_value = rhs->value();
+    return lhs_value < rhs_value ? -1 : (lhs_value > rhs_value ? 1 : 0);
+  }
+
+  uint64_t value() const {
+    return BigEndian::Load64(buffer_);
+  }
+
+ private:
+  char buffer_[sizeof(uint64_t)];
+};
+
 // Wrapper for UserBoundaryValue that stores PrimitiveValue with index.
 class PrimitiveBoundaryValue : public rocksdb::UserBoundaryValue {
  public:
@@ -147,6 +223,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     if (tag == kDocHybridTimeTag) {
       return DocHybridTimeValue::Create(data, value);
     }
+    if (tag == kExpirationTag) {
+      return ExpirationValue::Create(data, value);
+    }
     if (tag >= kRangeComponentsStart) {
       return PrimitiveBoundaryValue::Create(tag - kRangeComponentsStart, data, value);
     }
@@ -177,6 +256,9 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
     RETURN_NOT_OK(DocHybridTimeValue::Create(slices.back(), &temp));
     values->push_back(std::move(temp));
 
+    values->push_back(std::make_shared<ExpirationValue>(
+        ExpirationValue::Of(slices.back(), value)));
+
     for (size_t i = 0; i != size; ++i) {
       RETURN_NOT_OK(PrimitiveBoundaryValue::Create(i, slices[i], &temp));
       values->push_back(std::move(temp));
@@ -252,6 +334,36 @@ Status GetDocHybridTime(const rocksdb::UserBoundaryValues& values, DocHybridTime
   return time_value->value(out);
 }
 
+bool FileDataExpired(const rocksdb::FileBoundaryValuesBase& smallest,
+                     const rocksdb::FileBoundaryValuesBase& largest,
+                     MonoDelta table_ttl,
+                     HybridTime history_cutoff) {
+  auto min_value = rocksdb::UserValueWithTag(smallest.user_values, kExpirationTag);
+  auto max_value = rocksdb::UserValueWithTag(largest.user_values, kExpirationTag);
+  if (!min_value || !max_value) {
+    // Written before the expiration was recorded.
+    return false;
+  }
+  const auto min_expiration = down_cast<ExpirationValue*>(min_value.get())->value();
+  const auto max_expiration = down_cast<ExpirationValue*>(max_value.get())->value();
+  if (max_expiration >= history_cutoff.GetPhysicalValueMicros()) {
+    return false;
+  }
+  if (min_expiration != ExpirationValue::kExpiresByTableTtl) {
+    return true;
+  }
+  // Some entries expire by the table TTL, the latest of them is not written after the file's
+  // largest hybrid time.
+  if (table_ttl.Equals(Value::kMaxTtl) || table_ttl.Equals(Value::kResetTtl)) {
+    return false;
+  }
+  DocHybridTime max_doc_ht;
+  bool expired = false;
+  return GetDocHybridTime(largest.user_values, &max_doc_ht).ok() &&
+         HasExpiredTTL(max_doc_ht.hybrid_time(), table_ttl, history_cutoff, &expired).ok() &&
+         expired;
+}
+
 rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
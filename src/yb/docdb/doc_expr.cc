@@ -20,7 +20,6 @@
 namespace yb {
 namespace docdb {
 
-using yb::util::Decimal;
 
 //--------------------------------------------------------------------------------------------------
 
@@ -302,7 +301,8 @@ CHECKED_STATUS DocExprExecutor::EvalSum(const QLValuePB& val, QLValue *aggr_sum)
       aggr_sum->set_int64_value(aggr_sum->int64_value() + val.int64_value());
       break;
     case InternalType::kVarintValue:
-      aggr_sum->set_varint_value(aggr_sum->varint_value() + QLValue::varint_value(val));
+      *aggr_sum->mutable_varint_value() = VERIFY_RESULT(util::AddComparableVarInts(
+          aggr_sum->value().varint_value(), val.varint_value()));
       break;
     case InternalType::kFloatValue:
       aggr_sum->set_float_value(aggr_sum->float_value() + val.float_value());
@@ -310,14 +310,10 @@ CHECKED_STATUS DocExprExecutor::EvalSum(const QLValuePB& val, QLValue *aggr_sum)
     case InternalType::kDoubleValue:
       aggr_sum->set_double_value(aggr_sum->double_value() + val.double_value());
       break;
-    case InternalType::kDecimalValue: {
-      Decimal sum, value;
-      RETURN_NOT_OK(sum.DecodeFromComparable(aggr_sum->decimal_value()));
-      RETURN_NOT_OK(value.DecodeFromComparable(val.decimal_value()));
-      sum = sum + value;
-      aggr_sum->set_decimal_value(sum.EncodeToComparable());
+    case InternalType::kDecimalValue:
+      aggr_sum->set_decimal_value(VERIFY_RESULT(util::AddComparableDecimals(
+          aggr_sum->decimal_value(), val.decimal_value())));
       break;
-    }
     default:
       return STATUS(RuntimeError, "Cannot find SUM of this column");
   }
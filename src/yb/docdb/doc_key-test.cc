@@ -22,6 +22,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -724,5 +725,58 @@ TEST_F(DocKeyTest, TestEnumerateIntents) {
   }
 }
 
+// Measures encoding, decoding and skipping of keys with string components, that are escaped in
+// the key encoding.
+TEST_F(DocKeyTest, YB_DISABLE_TEST_IN_TSAN(EncodingPerformance)) {
+  constexpr int kNumKeys = 1000;
+  constexpr int kNumIterations = 100;
+
+  RandomNumberGenerator rng;  // Use the default seed to keep it deterministic.
+  std::vector<DocKey> keys;
+  for (int i = 0; i != kNumKeys; ++i) {
+    std::string str(8 + rng() % 120, 'x');
+    for (auto& c : str) {
+      c = static_cast<char>(rng());
+    }
+    keys.emplace_back(
+        kAsciiFriendlyHash,
+        PrimitiveValues(str, static_cast<int64_t>(i)),
+        std::vector<PrimitiveValue>{
+            PrimitiveValue(str.substr(0, 16)),
+            PrimitiveValue(str, SortOrder::kDescending),
+            PrimitiveValue(static_cast<int64_t>(rng()))});
+  }
+
+  std::vector<KeyBytes> encoded_keys;
+  LOG_TIMING(INFO, Substitute("encoding $0 keys", kNumKeys * kNumIterations)) {
+    for (int iteration = 0; iteration != kNumIterations; ++iteration) {
+      encoded_keys.clear();
+      for (const auto& key : keys) {
+        encoded_keys.push_back(key.Encode());
+      }
+    }
+  }
+
+  LOG_TIMING(INFO, Substitute("decoding $0 keys", kNumKeys * kNumIterations)) {
+    for (int iteration = 0; iteration != kNumIterations; ++iteration) {
+      for (size_t i = 0; i != encoded_keys.size(); ++i) {
+        DocKey decoded_key;
+        ASSERT_OK(decoded_key.FullyDecodeFrom(encoded_keys[i].AsSlice()));
+        ASSERT_EQ(keys[i].range_group().size(), decoded_key.range_group().size());
+      }
+    }
+  }
+
+  LOG_TIMING(INFO, Substitute("skipping $0 keys", kNumKeys * kNumIterations)) {
+    for (int iteration = 0; iteration != kNumIterations; ++iteration) {
+      for (const auto& encoded_key : encoded_keys) {
+        auto size = ASSERT_RESULT(
+            DocKey::EncodedSize(encoded_key.AsSlice(), DocKeyPart::WHOLE_DOC_KEY));
+        ASSERT_EQ(encoded_key.size(), size);
+      }
+    }
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
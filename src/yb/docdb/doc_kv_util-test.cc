@@ -115,6 +115,33 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345); // initialize with a fixed seed
+  for (int i = 0; i < 1000; ++i) {
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      // Make the special characters frequent, so runs between them are short.
+      const auto r = rng.Next() % 4;
+      s.push_back(r == 0 ? '\0' : (r == 1 ? '\xff' : static_cast<char>(rng.Next())));
+    }
+    string encoded_str;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+    encoded_str += "suffix";
+    rocksdb::Slice slice(encoded_str);
+    string decoded_str;
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+    ASSERT_EQ(s, decoded_str);
+    ASSERT_EQ("suffix", slice.ToBuffer());
+
+    // Skipping the string without decoding it.
+    slice = rocksdb::Slice(encoded_str);
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, nullptr));
+    ASSERT_EQ("suffix", slice.ToBuffer());
+  }
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
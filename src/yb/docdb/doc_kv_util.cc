@@ -13,6 +13,8 @@
 
 #include "yb/docdb/doc_kv_util.h"
 
+#include <string.h>
+
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/value.h"
@@ -74,22 +76,46 @@ Status CheckHybridTimeSizeAndValueType(
   return Status::OK();
 }
 
+namespace {
+
+// Appends the characters of [begin, end) xored with END_OF_STRING, i.e. copies them for '\0' and
+// complements them for '\xff'. The complement loop is vectorized by the compiler.
+template <char END_OF_STRING>
+inline void AppendXoredRun(const char* begin, const char* end, string* dest) {
+  const size_t old_size = dest->size();
+  dest->append(begin, end - begin);
+  if (END_OF_STRING != '\0') {
+    char* out = &(*dest)[old_size];
+    for (char* out_end = out + (end - begin); out != out_end; ++out) {
+      *out ^= END_OF_STRING;
+    }
+  }
+}
+
+// Returns the first occurrence of c in [begin, end) or end. memchr is vectorized by libc with
+// SSE2/AVX2, so the runs between the special characters are scanned many bytes at a time.
+inline const char* FindChar(const char* begin, const char* end, char c) {
+  const void* found = memchr(begin, c, end - begin);
+  return found ? static_cast<const char*>(found) : end;
+}
+
+} // namespace
+
 template <char END_OF_STRING>
 void AppendEncodedStrToKey(const string &s, string *dest) {
   static_assert(END_OF_STRING == '\0' || END_OF_STRING == '\xff',
                 "Only characters '\0' and '\xff' allowed as a template parameter");
-  if (END_OF_STRING == '\0' && s.find('\0') == string::npos) {
-    // Fast path: no zero characters, nothing to encode.
-    dest->append(s);
-  } else {
-    for (char c : s) {
-      if (c == '\0') {
-        dest->push_back(END_OF_STRING);
-        dest->push_back(END_OF_STRING ^ 1);
-      } else {
-        dest->push_back(END_OF_STRING ^ c);
-      }
+  const char* p = s.data();
+  const char* const end = p + s.size();
+  for (;;) {
+    const char* zero = FindChar(p, end, '\0');
+    AppendXoredRun<END_OF_STRING>(p, zero, dest);
+    if (zero == end) {
+      break;
     }
+    dest->push_back(END_OF_STRING);
+    dest->push_back(END_OF_STRING ^ 1);
+    p = zero + 1;
   }
 }
 
@@ -124,7 +150,13 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   const char* end = p + slice->size();
 
   while (p != end) {
-    if (*p == END_OF_STRING) {
+    // The run up to the next END_OF_STRING does not need unescaping.
+    const char* special = FindChar(p, end, END_OF_STRING);
+    if (result != nullptr) {
+      AppendXoredRun<END_OF_STRING>(p, special, result);
+    }
+    p = special;
+    if (p != end) {
       ++p;
       if (p == end) {
         return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
@@ -147,11 +179,6 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
             R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
             END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
       }
-    } else {
-      if (result != nullptr) {
-        result->push_back((*p) ^ END_OF_STRING);
-      }
-      ++p;
     }
   }
   if (result != nullptr) {
@@ -78,6 +78,11 @@ class DocPath {
     return subkeys_.back();
   }
 
+  void RemoveLastSubKey() {
+    assert(!subkeys_.empty());
+    subkeys_.pop_back();
+  }
+
   // Note: the hash is supposed to be uint16_t, but protobuf only supports uint32.
   // So this function takes in uint32_t.
   // TODO (akashnil): Add uint16 data type in docdb.
@@ -24,6 +24,9 @@ namespace docdb {
 
 //--------------------------------------------------------------------------------------------------
 extern rocksdb::UserBoundaryTag TagForRangeComponent(size_t index);
+extern bool RangeOptionsUsable(const Schema& schema,
+                               const common::QLScanRange& range_bounds,
+                               const std::vector<std::vector<PrimitiveValue>>& range_options);
 
 // TODO(neil) The following implementation is just a prototype. Need to complete the implementation
 // and test accordingly.
@@ -135,12 +138,8 @@ DocPgsqlScanSpec::DocPgsqlScanSpec(const Schema& schema,
         std::make_shared<std::vector<std::vector<PrimitiveValue>>>(schema_.num_range_key_columns());
     InitRangeOptions(*condition);
 
-    // Range options are only valid if all range columns are set (i.e. have one or more options).
-    for (int i = 0; i < schema_.num_range_key_columns(); i++) {
-      if ((*range_options_)[i].empty()) {
-        range_options_ = nullptr;
-        break;
-      }
+    if (!RangeOptionsUsable(schema_, *range_bounds_, *range_options_)) {
+      range_options_ = nullptr;
     }
   }
 }
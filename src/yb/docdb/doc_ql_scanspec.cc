@@ -18,11 +18,42 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/rocksdb/db/compaction.h"
 
+#include "yb/util/flag_tags.h"
+
 using std::vector;
 
+DEFINE_bool(docdb_enable_skip_scan, false,
+            "Whether a scan with EQ/IN conditions on some range columns may enumerate the values "
+            "of the unrestricted range columns preceding them (skip scan), instead of reading "
+            "every row within the hash key.");
+TAG_FLAG(docdb_enable_skip_scan, advanced);
+
 namespace yb {
 namespace docdb {
 
+// Range options are usable if all range columns are set (i.e. have one or more options). With skip
+// scan, range columns that have no options and no range bound are allowed too: the scan enumerates
+// their distinct values and seeks to the options of the following columns for each of them.
+bool RangeOptionsUsable(const Schema& schema,
+                        const common::QLScanRange& range_bounds,
+                        const std::vector<std::vector<PrimitiveValue>>& range_options) {
+  bool has_options = false;
+  for (size_t i = 0; i < schema.num_range_key_columns(); i++) {
+    if (!range_options[i].empty()) {
+      has_options = true;
+      continue;
+    }
+    if (!FLAGS_docdb_enable_skip_scan) {
+      return false;
+    }
+    const auto range = range_bounds.RangeFor(schema.column_id(schema.num_hash_key_columns() + i));
+    if (!IsNull(range.min_value) || !IsNull(range.max_value)) {
+      return false;
+    }
+  }
+  return has_options;
+}
+
 DocQLScanSpec::DocQLScanSpec(const Schema& schema,
                              const DocKey& doc_key,
                              const rocksdb::QueryId query_id,
@@ -67,12 +98,8 @@ DocQLScanSpec::DocQLScanSpec(const Schema& schema,
         std::make_shared<std::vector<std::vector<PrimitiveValue>>>(schema_.num_range_key_columns());
     InitRangeOptions(*condition);
 
-    // Range options are only valid if all range columns are set (i.e. have one or more options).
-    for (int i = 0; i < schema_.num_range_key_columns(); i++) {
-      if ((*range_options_)[i].empty()) {
-        range_options_ = nullptr;
-        break;
-      }
+    if (!RangeOptionsUsable(schema_, *range_bounds_, *range_options_)) {
+      range_options_ = nullptr;
     }
   }
 }
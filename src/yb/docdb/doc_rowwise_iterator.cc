@@ -14,6 +14,7 @@
 #include "yb/docdb/doc_rowwise_iterator.h"
 
 #include "yb/common/partition.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/transaction.h"
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_scanspec.h"
@@ -30,6 +31,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/trace.h"
 
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
@@ -66,10 +68,14 @@ class ScanChoices {
   // current target.
   virtual CHECKED_STATUS SeekToCurrentTarget(IntentAwareIterator* db_iter) = 0;
 
+  // Number of seeks done to reach scan targets.
+  size_t num_seeks() const { return num_seeks_; }
+
  protected:
   const bool is_forward_scan_;
   KeyBytes current_scan_target_;
   bool finished_ = false;
+  size_t num_seeks_ = 0;
 };
 
 class DiscreteScanChoices : public ScanChoices {
@@ -79,6 +85,7 @@ class DiscreteScanChoices : public ScanChoices {
       : ScanChoices(doc_spec.is_forward_scan()) {
     range_cols_scan_options_ = doc_spec.range_options();
     current_scan_target_idxs_.resize(range_cols_scan_options_->size());
+    open_column_values_.resize(range_cols_scan_options_->size());
     for (int i = 0; i < range_cols_scan_options_->size(); i++) {
       current_scan_target_idxs_[i] = range_cols_scan_options_->at(i).begin();
     }
@@ -102,6 +109,7 @@ class DiscreteScanChoices : public ScanChoices {
       : ScanChoices(doc_spec.is_forward_scan()) {
     range_cols_scan_options_ = doc_spec.range_options();
     current_scan_target_idxs_.resize(range_cols_scan_options_->size());
+    open_column_values_.resize(range_cols_scan_options_->size());
     for (int i = 0; i < range_cols_scan_options_->size(); i++) {
       current_scan_target_idxs_[i] = range_cols_scan_options_->at(i).begin();
     }
@@ -129,8 +137,22 @@ class DiscreteScanChoices : public ScanChoices {
   // index for one column. Will handle overflow by setting current column index to 0 and
   // incrementing the previous column instead. If it overflows at first column it means we are done,
   // so it clears the scan target idxs array.
+  // Open columns cannot be incremented to a known value, so when the increment reaches one the
+  // target is set right past all keys having the current value of this column, and the next
+  // existing value is picked up by SkipTargetsUpTo once the iterator lands on it.
   CHECKED_STATUS IncrementScanTargetAtColumn(size_t start_col);
 
+  // Skip scan: an open column has no options and matches any value, its distinct values are
+  // enumerated by jumping over each of them.
+  bool IsOpenColumn(size_t col_idx) const {
+    return (*range_cols_scan_options_)[col_idx].empty();
+  }
+
+  // Appends the value used by an open column before any value is known.
+  void AppendOpenColumnStart(KeyBytes* key) const {
+    PrimitiveValue(is_forward_scan_ ? ValueType::kLowest : ValueType::kHighest).AppendToKey(key);
+  }
+
   // Utility function for (multi)key scans to initialize the range portion of the current scan
   // target, scan target with the first option.
   // Only needed for scans that include the static row, otherwise Init will take care of this.
@@ -146,8 +168,11 @@ class DiscreteScanChoices : public ScanChoices {
   //  current_scan_target_       goes from [1][2,4,6] up to [1][3,5,6] -- is the doc key containing,
   //                             for each range column, the value (option) referenced by the
   //                             corresponding index (updated along with current_scan_target_idxs_).
+  // For a skip scan, e.g. "h = 1 and r2 in (4,5)", the options of r1 are empty and
+  // open_column_values_ holds the r1 value of the current target, taken from the scanned keys.
   std::shared_ptr<std::vector<std::vector<PrimitiveValue>>> range_cols_scan_options_;
   mutable std::vector<std::vector<PrimitiveValue>::const_iterator> current_scan_target_idxs_;
+  std::vector<PrimitiveValue> open_column_values_;
 };
 
 Status DiscreteScanChoices::IncrementScanTargetAtColumn(size_t start_col) {
@@ -156,6 +181,9 @@ Status DiscreteScanChoices::IncrementScanTargetAtColumn(size_t start_col) {
   // Increment start col, move backwards in case of overflow.
   int col_idx = start_col;
   for (; col_idx >= 0; col_idx--) {
+    if (IsOpenColumn(col_idx)) {
+      break;
+    }
     const auto& choices = range_cols_scan_options_->at(col_idx);
     auto& it = current_scan_target_idxs_[col_idx];
 
@@ -180,6 +208,15 @@ Status DiscreteScanChoices::IncrementScanTargetAtColumn(size_t start_col) {
   current_scan_target_.mutable_data()->resize(
       decoder.left_input().cdata() - current_scan_target_.data().data());
 
+  if (IsOpenColumn(col_idx)) {
+    // Jump out of the current value of the open column: past it for forward scans and before it
+    // for reverse scans (SeekToCurrentTarget goes to the doc key preceding the target).
+    open_column_values_[col_idx].AppendToKey(&current_scan_target_);
+    PrimitiveValue(is_forward_scan_ ? ValueType::kHighest : ValueType::kLowest).AppendToKey(
+        &current_scan_target_);
+    return Status::OK();
+  }
+
   for (size_t i = col_idx; i <= start_col; ++i) {
     current_scan_target_idxs_[i]->AppendToKey(&current_scan_target_);
   }
@@ -195,7 +232,11 @@ Result<bool> DiscreteScanChoices::InitScanTargetRangeGroupIfNeeded() {
   if (!VERIFY_RESULT(decoder.HasPrimitiveValue())) {
     current_scan_target_.mutable_data()->pop_back();
     for (size_t col_idx = 0; col_idx < range_cols_scan_options_->size(); col_idx++) {
-      current_scan_target_idxs_[col_idx]->AppendToKey(&current_scan_target_);
+      if (IsOpenColumn(col_idx)) {
+        AppendOpenColumnStart(&current_scan_target_);
+      } else {
+        current_scan_target_idxs_[col_idx]->AppendToKey(&current_scan_target_);
+      }
     }
     current_scan_target_.AppendValueType(ValueType::kGroupEnd);
     return true;
@@ -209,7 +250,13 @@ Status DiscreteScanChoices::DoneWithCurrentTarget() {
 
   // Initialize the first target/option if not done already, otherwise go to the next one.
   if (!VERIFY_RESULT(InitScanTargetRangeGroupIfNeeded())) {
-    RETURN_NOT_OK(IncrementScanTargetAtColumn(range_cols_scan_options_->size() - 1));
+    const size_t last_col = range_cols_scan_options_->size() - 1;
+    if (is_forward_scan_ && IsOpenColumn(last_col)) {
+      // Any value of the last column matches and the forward iterator is already positioned right
+      // after the current row, so keep the target and let the next key update it.
+      return Status::OK();
+    }
+    RETURN_NOT_OK(IncrementScanTargetAtColumn(last_col));
     current_scan_target_.AppendValueType(ValueType::kGroupEnd);
   }
   return Status::OK();
@@ -227,6 +274,15 @@ Status DiscreteScanChoices::SkipTargetsUpTo(const Slice& new_target) {
   PrimitiveValue target_value;
   while (col_idx < range_cols_scan_options_->size()) {
     RETURN_NOT_OK(decoder.DecodePrimitiveValue(&target_value));
+
+    // Any value matches an open column, use it as is.
+    if (IsOpenColumn(col_idx)) {
+      target_value.AppendToKey(&current_scan_target_);
+      open_column_values_[col_idx] = std::move(target_value);
+      col_idx++;
+      continue;
+    }
+
     const auto& choices = (*range_cols_scan_options_)[col_idx];
     auto& it = current_scan_target_idxs_[col_idx];
 
@@ -268,7 +324,11 @@ Status DiscreteScanChoices::SkipTargetsUpTo(const Slice& new_target) {
   // leftover columns (i.e. set all following indexes to 0).
   for (size_t i = col_idx; i < current_scan_target_idxs_.size(); i++) {
     current_scan_target_idxs_[i] = (*range_cols_scan_options_)[i].begin();
-    current_scan_target_idxs_[i]->AppendToKey(&current_scan_target_);
+    if (IsOpenColumn(i)) {
+      AppendOpenColumnStart(&current_scan_target_);
+    } else {
+      current_scan_target_idxs_[i]->AppendToKey(&current_scan_target_);
+    }
   }
 
   current_scan_target_.AppendValueType(ValueType::kGroupEnd);
@@ -280,6 +340,7 @@ Status DiscreteScanChoices::SeekToCurrentTarget(IntentAwareIterator* db_iter) {
   VLOG(2) << __PRETTY_FUNCTION__ << " Advancing iterator towards target";
   // Seek to the current target doc key if needed.
   if (!FinishedWithScanChoices()) {
+    ++num_seeks_;
     if (is_forward_scan_) {
       VLOG(2) << __PRETTY_FUNCTION__ << " Seeking to " << current_scan_target_;
       db_iter->Seek(current_scan_target_);
@@ -441,6 +502,7 @@ Status RangeBasedScanChoices::SeekToCurrentTarget(IntentAwareIterator* db_iter)
   VLOG(2) << __PRETTY_FUNCTION__ << " Advancing iterator towards target";
 
   if (!FinishedWithScanChoices()) {
+    ++num_seeks_;
     if (!current_scan_target_.empty()) {
       VLOG(3) << __PRETTY_FUNCTION__ << " current_scan_target_ is non-empty. "
               << current_scan_target_;
@@ -490,6 +552,9 @@ DocRowwiseIterator::DocRowwiseIterator(
 }
 
 DocRowwiseIterator::~DocRowwiseIterator() {
+  if (scan_choices_) {
+    TRACE("Scan choices: $0 seeks, $1 rows scanned", scan_choices_->num_seeks(), num_rows_scanned_);
+  }
 }
 
 Status DocRowwiseIterator::Init() {
@@ -706,6 +771,7 @@ Result<bool> DocRowwiseIterator::HasNext() const {
       // SubDocument.
     }
 
+    ++num_rows_scanned_;
     GetSubDocumentData data = {
       sub_doc_key,
       &row_,
@@ -768,6 +834,23 @@ CHECKED_STATUS SetQLPrimaryKeyColumnValues(const Schema& schema,
   return decoder->ConsumeGroupEnd();
 }
 
+// Same as SetQLPrimaryKeyColumnValues, but stores values in the given row of a column batch whose
+// leading columns are the key columns of the schema.
+CHECKED_STATUS SetBatchPrimaryKeyColumnValues(const Schema& schema,
+                                              const size_t begin_index,
+                                              const size_t column_count,
+                                              const size_t row_idx,
+                                              DocKeyDecoder* decoder,
+                                              QLColumnBatch* batch) {
+  PrimitiveValue primitive_value;
+  for (size_t j = begin_index; j < begin_index + column_count; j++) {
+    RETURN_NOT_OK(decoder->DecodePrimitiveValue(&primitive_value));
+    PrimitiveValue::ToQLValuePB(
+        primitive_value, schema.column(j).type(), batch->mutable_value(j, row_idx));
+  }
+  return decoder->ConsumeGroupEnd();
+}
+
 } // namespace
 
 void DocRowwiseIterator::SkipRow() {
@@ -837,6 +920,49 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
   return Status::OK();
 }
 
+Result<size_t> DocRowwiseIterator::NextBatch(
+    const Schema& projection, size_t max_rows, QLColumnBatch* batch) {
+  batch->Reset(schema_, projection);
+
+  const size_t num_key_columns = schema_.num_key_columns();
+  const size_t num_value_columns = projection.num_columns() - projection.num_key_columns();
+  std::vector<PrimitiveValue> value_subkeys;
+  value_subkeys.reserve(num_value_columns);
+  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+    value_subkeys.emplace_back(projection.column_id(i));
+  }
+
+  while (batch->num_rows() < max_rows && VERIFY_RESULT(HasNext())) {
+    const size_t row_idx = batch->AddRow();
+
+    DocKeyDecoder decoder(row_key_);
+    RETURN_NOT_OK(decoder.DecodeCotableId());
+    RETURN_NOT_OK(decoder.DecodePgtableId());
+    if (VERIFY_RESULT(decoder.DecodeHashCode())) {
+      RETURN_NOT_OK(SetBatchPrimaryKeyColumnValues(
+          schema_, 0, schema_.num_hash_key_columns(), row_idx, &decoder, batch));
+    }
+    if (!decoder.GroupEnded()) {
+      RETURN_NOT_OK(SetBatchPrimaryKeyColumnValues(
+          schema_, schema_.num_hash_key_columns(), schema_.num_range_key_columns(), row_idx,
+          &decoder, batch));
+    }
+
+    for (size_t i = 0; i != num_value_columns; ++i) {
+      const SubDocument* column_value = row_.GetChild(value_subkeys[i]);
+      if (column_value != nullptr) {
+        SubDocument::ToQLValuePB(
+            *column_value, projection.column(projection.num_key_columns() + i).type(),
+            batch->mutable_value(num_key_columns + i, row_idx));
+      }
+    }
+
+    row_ready_ = false;
+  }
+
+  return batch->num_rows();
+}
+
 bool DocRowwiseIterator::LivenessColumnExists() const {
   const SubDocument* subdoc = row_.GetChild(
       PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
@@ -861,6 +987,13 @@ CHECKED_STATUS DocRowwiseIterator::GetNextReadSubDocKey(SubDocKey* sub_doc_key)
   return Status::OK();
 }
 
+void DocRowwiseIterator::SetDeadline(CoarseTimePoint deadline) {
+  deadline_info_.emplace(deadline);
+  if (db_iter_) {
+    db_iter_->SetDeadline(deadline);
+  }
+}
+
 Result<Slice> DocRowwiseIterator::GetTupleId() const {
   // Return tuple id without cotable id / pgtable id if any.
   Slice tuple_id = row_key_;
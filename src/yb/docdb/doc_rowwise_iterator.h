@@ -110,6 +110,13 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Retrieves the next key to read after the iterator finishes for the given page.
   CHECKED_STATUS GetNextReadSubDocKey(SubDocKey* sub_doc_key) const override;
 
+  void SetDeadline(CoarseTimePoint deadline) override;
+
+  // Decodes up to max_rows rows directly into the column vectors of the batch, without building
+  // an intermediate QLTableRow for each of them.
+  Result<size_t> NextBatch(
+      const Schema& projection, size_t max_rows, QLColumnBatch* batch) override;
+
  private:
   template <class T>
   CHECKED_STATUS DoInit(const T& spec);
@@ -222,6 +229,10 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
 
   // Hybrid time of the table tombstone, if found.
   mutable DocHybridTime table_tombstone_time_ = DocHybridTime::kInvalid;
+
+  // Number of rows read from DocDB, used to compare with the number of seeks done by
+  // scan_choices_.
+  mutable size_t num_rows_scanned_ = 0;
 };
 
 }  // namespace docdb
@@ -88,7 +88,7 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, bool has_an
   if (has_expired) {
     current_entry_.value_type = ValueType::kTombstone;
     current_entry_.doc_hybrid_time = key_data.write_time;
-    cache_.Put(key_prefix_, current_entry_);
+    cache_.PutRead(key_prefix_, current_entry_);
     return Status::OK();
   }
 
@@ -141,7 +141,7 @@ Status DocWriteBatch::SeekToKeyPrefix(IntentAwareIterator* doc_iter, bool has_an
       // therefore we can't create "a.y.x", which would be incorrect.
       subdoc_exists_ = false;
     } else {
-      cache_.Put(key_prefix_, current_entry_);
+      cache_.PutRead(key_prefix_, current_entry_);
       subdoc_exists_ = current_entry_.value_type != ValueType::kTombstone;
     }
   }
@@ -380,12 +380,18 @@ Status DocWriteBatch::ExtendSubDocument(
     UserTimeMicros user_timestamp) {
   if (IsObjectType(value.value_type())) {
     const auto& map = value.object_container();
+    // The path is copied once per object, not once per child.
+    DocPath child_doc_path = doc_path;
     for (const auto& ent : map) {
-      DocPath child_doc_path = doc_path;
-      if (ent.first.value_type() != ValueType::kArray)
-          child_doc_path.AddSubKey(ent.first);
+      const bool add_subkey = ent.first.value_type() != ValueType::kArray;
+      if (add_subkey) {
+        child_doc_path.AddSubKey(ent.first);
+      }
       RETURN_NOT_OK(ExtendSubDocument(child_doc_path, ent.second,
                                       read_ht, deadline, query_id, ttl, user_timestamp));
+      if (add_subkey) {
+        child_doc_path.RemoveLastSubKey();
+      }
     }
   } else if (value.value_type() == ValueType::kArray) {
     RETURN_NOT_OK(ExtendList(
@@ -587,6 +593,82 @@ Status DocWriteBatch::ReplaceInList(
   }
 }
 
+Status DocWriteBatch::PopFromRedisList(
+    const DocPath& doc_path,
+    Direction dir,
+    const boost::optional<int64_t>& start_index,
+    const ReadHybridTime& read_ht,
+    CoarseTimePoint deadline,
+    rocksdb::QueryId query_id,
+    std::string* value,
+    int64_t* array_index) {
+  SubDocKey sub_doc_key;
+  RETURN_NOT_OK(sub_doc_key.FromDocPath(doc_path));
+  const KeyBytes doc_prefix = sub_doc_key.Encode();
+
+  auto iter = yb::docdb::CreateIntentAwareIterator(
+      doc_db_,
+      BloomFilterMode::USE_BLOOM_FILTER,
+      doc_prefix.AsSlice(),
+      query_id,
+      /*txn_op_context*/ boost::none,
+      deadline,
+      read_ht);
+
+  KeyBytes elements_prefix = doc_prefix;
+  elements_prefix.AppendValueType(ValueType::kArrayIndex);
+  KeyBytes seek_key = doc_prefix;
+  if (dir == Direction::kForward) {
+    if (start_index) {
+      PrimitiveValue::ArrayIndex(*start_index).AppendToKey(&seek_key);
+    } else {
+      seek_key.AppendValueType(ValueType::kArrayIndex);
+    }
+    iter->Seek(seek_key.AsSlice());
+  } else {
+    // Go backwards from the first key past the start index, or past the entire list.
+    if (start_index) {
+      PrimitiveValue::ArrayIndex(*start_index + 1).AppendToKey(&seek_key);
+    } else {
+      seek_key.AppendValueType(ValueType::kMaxByte);
+    }
+    iter->PrevSubDocKey(seek_key);
+  }
+
+  SubDocKey found_key;
+  while (true) {
+    if (!iter->valid()) {
+      return STATUS(NotFound, "Reached the end of the list");
+    }
+    auto key_data = VERIFY_RESULT(iter->FetchKey());
+    if (!key_data.key.starts_with(elements_prefix.AsSlice())) {
+      return STATUS(NotFound, "Reached the end of the list");
+    }
+
+    ValueType value_type;
+    RETURN_NOT_OK(Value::DecodePrimitiveValueType(iter->value(), &value_type));
+    // Redis lists do not have element-level TTL, the popped elements are tombstones.
+    if (value_type != ValueType::kTombstone) {
+      RETURN_NOT_OK(found_key.FullyDecodeFrom(key_data.key, HybridTimeRequired::kFalse));
+      Value element;
+      RETURN_NOT_OK(element.Decode(iter->value()));
+      *value = element.primitive_value().GetString();
+
+      const auto& index_subkey = found_key.subkeys()[sub_doc_key.num_subkeys()];
+      *array_index = index_subkey.GetArrayIndex();
+      DocPath child_doc_path = doc_path;
+      child_doc_path.AddSubKey(index_subkey);
+      return DeleteSubDoc(child_doc_path, read_ht, deadline, query_id);
+    }
+
+    if (dir == Direction::kForward) {
+      iter->SeekPastSubKey(key_data.key);
+    } else {
+      iter->PrevSubDocKey(KeyBytes(key_data.key));
+    }
+  }
+}
+
 void DocWriteBatch::Clear() {
   put_batch_.clear();
   cache_.Clear();
@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_H
 #define YB_DOCDB_DOC_WRITE_BATCH_H
 
+#include <boost/optional.hpp>
+
 #include "yb/util/enums.h"
 
 #include "yb/common/read_hybrid_time.h"
@@ -178,6 +180,20 @@ class DocWriteBatch {
                          default_ttl, write_ttl, /* is_cql */ true);
   }
 
+  // Deletes the first element of the Redis list at doc_path, from its head for kForward and from
+  // its tail for kBackward, and returns the value and the array index of the element. The search
+  // starts at start_index when it is set, no element should precede it in the direction. Returns
+  // NotFound if the list has no elements.
+  CHECKED_STATUS PopFromRedisList(
+      const DocPath& doc_path,
+      Direction dir,
+      const boost::optional<int64_t>& start_index,
+      const ReadHybridTime& read_ht,
+      CoarseTimePoint deadline,
+      rocksdb::QueryId query_id,
+      std::string* value,
+      int64_t* array_index);
+
   CHECKED_STATUS DeleteSubDoc(
       const DocPath& doc_path,
       const ReadHybridTime& read_ht = ReadHybridTime::Max(),
@@ -213,6 +229,8 @@ class DocWriteBatch {
     return cache_.Get(encoded_key_prefix);
   }
 
+  const DocWriteBatchCache& cache() const { return cache_; }
+
  private:
   // This member function performs the necessary operations to set a primitive value for a given
   // docpath assuming the appropriate operations have been taken care of for subkeys with index <
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_write_batch_cache.h"
+
+#include "yb/util/test_util.h"
+
+DECLARE_int64(doc_write_batch_cache_max_memory_bytes);
+
+namespace yb {
+namespace docdb {
+
+class DocWriteBatchCacheTest : public YBTest {
+};
+
+TEST_F(DocWriteBatchCacheTest, TestPutGet) {
+  DocWriteBatchCache cache;
+  const DocHybridTime ht(HybridTime(1000), 1);
+  ASSERT_FALSE(cache.Get(KeyBytes("a")));
+  cache.Put(KeyBytes("a"), ht, ValueType::kObject);
+  cache.PutRead(KeyBytes("ab"), {ht, ValueType::kTombstone});
+
+  auto entry = cache.Get(KeyBytes("a"));
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(ht, entry->doc_hybrid_time);
+  ASSERT_EQ(ValueType::kObject, entry->value_type);
+  entry = cache.Get(KeyBytes("ab"));
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(ValueType::kTombstone, entry->value_type);
+
+  // Put overwrites the existing entry.
+  cache.Put(KeyBytes("ab"), ht, ValueType::kInt64);
+  ASSERT_EQ(ValueType::kInt64, cache.Get(KeyBytes("ab"))->value_type);
+  ASSERT_FALSE(cache.Get(KeyBytes("b")));
+  ASSERT_EQ(4, cache.hits());
+  ASSERT_EQ(2, cache.misses());
+
+  cache.Clear();
+  ASSERT_FALSE(cache.Get(KeyBytes("a")));
+  ASSERT_EQ(0, cache.memory_usage());
+}
+
+TEST_F(DocWriteBatchCacheTest, TestMemoryLimit) {
+  FLAGS_doc_write_batch_cache_max_memory_bytes = 1024;
+  DocWriteBatchCache cache;
+  const DocHybridTime ht(HybridTime(1000), 1);
+  int num_read = 0;
+  for (;; ++num_read) {
+    const KeyBytes key(Format("read_$0", num_read));
+    cache.PutRead(key, {ht, ValueType::kObject});
+    if (!cache.Get(key)) {
+      break;
+    }
+    ASSERT_LT(num_read, 1024);
+  }
+  ASSERT_GT(num_read, 0);
+  ASSERT_GE(cache.memory_usage(), 1024);
+
+  // Entries for writes are kept over the limit.
+  for (int i = 0; i != 100; ++i) {
+    const KeyBytes key(Format("written_$0", i));
+    cache.Put(key, ht, ValueType::kObject);
+    ASSERT_TRUE(cache.Get(key));
+  }
+  for (int i = 0; i != num_read; ++i) {
+    ASSERT_TRUE(cache.Get(KeyBytes(Format("read_$0", i))));
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -21,6 +21,8 @@
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/memory/arena.h"
 
 using std::back_inserter;
 using std::copy;
@@ -34,22 +36,64 @@ using std::vector;
 
 using yb::FormatBytesAsStr;
 
+DEFINE_int64(doc_write_batch_cache_max_memory_bytes, 8 * 1024 * 1024,
+             "Memory limit of the cache of key prefixes read from RocksDB by a single write "
+             "operation. Prefixes written by the operation are cached regardless of the limit.");
+TAG_FLAG(doc_write_batch_cache_max_memory_bytes, advanced);
+TAG_FLAG(doc_write_batch_cache_max_memory_bytes, runtime);
+
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Approximate memory used by a hash table node apart from the key bytes.
+constexpr size_t kEntryOverhead = sizeof(Slice) + sizeof(DocWriteBatchCache::Entry) +
+                                  4 * sizeof(void*);
+
+} // namespace
+
+DocWriteBatchCache::DocWriteBatchCache() {}
+
+DocWriteBatchCache::~DocWriteBatchCache() {}
+
 void DocWriteBatchCache::Put(const KeyBytes& key_bytes, const DocWriteBatchCache::Entry& entry) {
+  DoPut(key_bytes, entry, false /* drop_if_full */);
+}
+
+void DocWriteBatchCache::PutRead(
+    const KeyBytes& key_bytes, const DocWriteBatchCache::Entry& entry) {
+  DoPut(key_bytes, entry, true /* drop_if_full */);
+}
+
+void DocWriteBatchCache::DoPut(
+    const KeyBytes& key_bytes, const DocWriteBatchCache::Entry& entry, bool drop_if_full) {
     DOCDB_DEBUG_LOG(
       "Writing to DocWriteBatchCache: encoded_key_prefix=$0, gen_ht=$1, value_type=$2",
       BestEffortDocDBKeyToStr(key_bytes),
       entry.doc_hybrid_time.ToString(),
       ToString(entry.value_type));
 
-  prefix_to_gen_ht_[key_bytes.AsStringRef()] = entry;
+  auto iter = prefix_to_gen_ht_.find(key_bytes.AsSlice());
+  if (iter != prefix_to_gen_ht_.end()) {
+    iter->second = entry;
+    return;
+  }
+  if (drop_if_full &&
+      memory_usage_ >= static_cast<size_t>(FLAGS_doc_write_batch_cache_max_memory_bytes)) {
+    return;
+  }
+  if (!arena_) {
+    arena_ = std::make_unique<Arena>();
+  }
+  const Slice key(arena_->AddSlice(key_bytes.AsSlice()), key_bytes.size());
+  prefix_to_gen_ht_.emplace(key, entry);
+  memory_usage_ += key.size() + kEntryOverhead;
 }
 
 boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
     const KeyBytes& encoded_key_prefix) {
-  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsStringRef());
+  auto iter = prefix_to_gen_ht_.find(encoded_key_prefix.AsSlice());
 #ifdef DOCDB_DEBUG
   if (iter == prefix_to_gen_ht_.end()) {
     DOCDB_DEBUG_LOG("DocWriteBatchCache contained no entry for $0",
@@ -59,12 +103,20 @@ boost::optional<DocWriteBatchCache::Entry> DocWriteBatchCache::Get(
                     BestEffortDocDBKeyToStr(encoded_key_prefix), EntryToStr(iter->second));
   }
 #endif
-  return iter == prefix_to_gen_ht_.end() ? boost::optional<Entry>() : iter->second;
+  if (iter == prefix_to_gen_ht_.end()) {
+    ++misses_;
+    return boost::none;
+  }
+  ++hits_;
+  return iter->second;
 }
 
 string DocWriteBatchCache::ToDebugString() {
   vector<pair<string, Entry>> sorted_contents;
-  copy(prefix_to_gen_ht_.begin(), prefix_to_gen_ht_.end(), back_inserter(sorted_contents));
+  sorted_contents.reserve(prefix_to_gen_ht_.size());
+  for (const auto& kv : prefix_to_gen_ht_) {
+    sorted_contents.emplace_back(kv.first.ToBuffer(), kv.second);
+  }
   sort(sorted_contents.begin(), sorted_contents.end());
   ostringstream ss;
   ss << "DocWriteBatchCache[" << endl;
@@ -91,6 +143,10 @@ string DocWriteBatchCache::EntryToStr(const Entry& entry) {
 
 void DocWriteBatchCache::Clear() {
   prefix_to_gen_ht_.clear();
+  if (arena_) {
+    arena_->Reset();
+  }
+  memory_usage_ = 0;
 }
 
 }  // namespace docdb
@@ -14,6 +14,7 @@
 #ifndef YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 #define YB_DOCDB_DOC_WRITE_BATCH_CACHE_H_
 
+#include <memory>
 #include <unordered_map>
 #include <string>
 
@@ -24,16 +25,27 @@
 #include "yb/docdb/value_type.h"
 #include "yb/docdb/value.h"
 
+#include "yb/util/memory/arena_fwd.h"
+#include "yb/util/slice.h"
+
 namespace yb {
 namespace docdb {
 
 // A utility used by DocWriteBatch. Caches generation hybrid_times (hybrid_times of full overwrite
 // or deletion) for key prefixes that were read from RocksDB or created by previous operations
-// performed on the DocWriteBatch.
+// performed on the DocWriteBatch. A single DocWriteBatch, and so a single cache, is used for all
+// DocOperations of a write operation.
+//
+// Keys are stored in an arena. Entries recorded for writes performed on the batch are always
+// kept, since later operations of the batch could not find them in RocksDB. Entries for data read
+// from RocksDB are not added once the cache uses more than doc_write_batch_cache_max_memory_bytes.
 //
 // This class is not thread-safe.
 class DocWriteBatchCache {
  public:
+  DocWriteBatchCache();
+  ~DocWriteBatchCache();
+
   struct Entry {
     DocHybridTime doc_hybrid_time;
     ValueType value_type;
@@ -53,6 +65,10 @@ class DocWriteBatchCache {
   // assumed not to include the hybrid_time at the end.
   void Put(const KeyBytes& key_bytes, const Entry& entry);
 
+  // Same as Put, but for an entry read from RocksDB, that is dropped when the memory limit is
+  // reached.
+  void PutRead(const KeyBytes& key_bytes, const Entry& entry);
+
   // Same thing, but doesn't use an already created entry.
   void Put(const KeyBytes& key_bytes,
            DocHybridTime gen_ht,
@@ -73,8 +89,28 @@ class DocWriteBatchCache {
 
   void Clear();
 
+  // Number of Get calls that found an entry, i.e. RocksDB lookups avoided.
+  size_t hits() const {
+    return hits_;
+  }
+
+  size_t misses() const {
+    return misses_;
+  }
+
+  size_t memory_usage() const {
+    return memory_usage_;
+  }
+
  private:
-  std::unordered_map<std::string, Entry> prefix_to_gen_ht_;
+  void DoPut(const KeyBytes& key_bytes, const Entry& entry, bool drop_if_full);
+
+  // Keys of prefix_to_gen_ht_ point to memory of arena_, that is allocated on first Put.
+  std::unique_ptr<Arena> arena_;
+  std::unordered_map<Slice, Entry, Slice::Hash> prefix_to_gen_ht_;
+  size_t memory_usage_ = 0;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
 };
 
 
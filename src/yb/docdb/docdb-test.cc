@@ -34,6 +34,7 @@
 #include "yb/tablet/tablet_options.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/docdb_expiration_index.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 
 #include "yb/util/minmax.h"
@@ -245,12 +246,15 @@ SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey_b", "subkey_d"; HT{ physica
 
   // Checks bloom filter useful counter increment to be in range [1;expected_max_increment] and
   // table iterators number increment to be expected_num_iterators_increment.
+  // Files skipped by the key range check before looking into the bloom filter are also counted as
+  // bloom filter useful.
   // Updates total_useful, total_iterators
   void CheckBloom(const int expected_max_increment, int *total_useful,
       const int expected_num_iterators_increment, int *total_iterators) {
     if (FLAGS_use_docdb_aware_bloom_filter) {
       const auto total_useful_updated =
-          options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+          options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL) +
+          options().statistics->getTickerCount(rocksdb::SST_FILES_SKIPPED_BY_KEY_RANGE);
       const auto total_iterators_updated =
           options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
       if (expected_max_increment > 0) {
@@ -2549,6 +2553,43 @@ TEST_F_EX(DocDBTest, BoundaryValuesMultiFiles, DocDBTestBoundaryValues) {
   TestBoundaryValues(350);
 }
 
+TEST_F(DocDBTest, FileDataExpired) {
+  KeyBytes encoded_doc_key(DocKey(PrimitiveValues("k1")).Encode());
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("c1")),
+                         Value(PrimitiveValue("v1"), MonoDelta::FromMicroseconds(1000)),
+                         1000_usec_ht));
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("c2")),
+                         Value(PrimitiveValue("v2"), MonoDelta::FromMicroseconds(2000)),
+                         2000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  // Expires by the table TTL.
+  ASSERT_OK(SetPrimitive(DocPath(encoded_doc_key, PrimitiveValue("c3")), PrimitiveValue("v3"),
+                         3000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key, PrimitiveValue("c3")), 4000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  auto files = rocksdb()->GetLiveFilesMetaData();
+  ASSERT_EQ(3u, files.size());
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.name < rhs.name;
+  });
+  auto expired = [&files](size_t index, MonoDelta table_ttl, HybridTime history_cutoff) {
+    return FileDataExpired(files[index].smallest, files[index].largest, table_ttl, history_cutoff);
+  };
+
+  // The last entry of the first file expires at 4000.
+  ASSERT_FALSE(expired(0, Value::kMaxTtl, 4000_usec_ht));
+  ASSERT_TRUE(expired(0, Value::kMaxTtl, 4001_usec_ht));
+
+  ASSERT_FALSE(expired(1, Value::kMaxTtl, 1000000_usec_ht));
+  ASSERT_FALSE(expired(1, MonoDelta::FromMicroseconds(1000), 3500_usec_ht));
+  ASSERT_TRUE(expired(1, MonoDelta::FromMicroseconds(1000), 4500_usec_ht));
+
+  // Delete markers never expire.
+  ASSERT_FALSE(expired(2, MonoDelta::FromMicroseconds(1000), 1000000_usec_ht));
+}
+
 TEST_F(DocDBTest, BloomFilterTest) {
   // Turn off "next instead of seek" optimization, because this test rely on DocDB to do seeks.
   FLAGS_max_nexts_to_avoid_seek = 0;
@@ -2646,6 +2687,12 @@ TEST_F(DocDBTest, BloomFilterTest) {
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
   ASSERT_NO_FATALS(get_doc(key3));
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
+
+  if (FLAGS_use_docdb_aware_bloom_filter) {
+    // key3 is after the key range of file2, and key1 is before the key range of file3, so these
+    // files are skipped without reading their bloom filters.
+    ASSERT_GT(options().statistics->getTickerCount(rocksdb::SST_FILES_SKIPPED_BY_KEY_RANGE), 0);
+  }
 }
 
 TEST_F(DocDBTest, MergingIterator) {
@@ -34,6 +34,7 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
@@ -302,14 +303,14 @@ Result<PrepareDocWriteOperationResult> PrepareDocWriteOperation(
   result.need_read_snapshot = determine_keys_to_lock_result.need_read_snapshot;
 
   FilterKeysToLock(&determine_keys_to_lock_result.lock_batch);
-  const MonoTime start_time = (write_lock_latency != nullptr) ? MonoTime::Now() : MonoTime();
+  const MonoTime start_time = MonoTime::Now();
   result.lock_batch = LockBatch(
       lock_manager, std::move(determine_keys_to_lock_result.lock_batch), deadline);
   RETURN_NOT_OK_PREPEND(
       result.lock_batch.status(), Format("Timeout: $0", deadline - ToCoarse(start_time)));
+  result.lock_wait_time = MonoTime::Now().GetDeltaSince(start_time);
   if (write_lock_latency != nullptr) {
-    const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
-    write_lock_latency->Increment(elapsed_time.ToMicroseconds());
+    write_lock_latency->Increment(result.lock_wait_time.ToMicroseconds());
   }
 
   return result;
@@ -345,7 +346,8 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
                                 InitMarkerBehavior init_marker_behavior,
                                 std::atomic<int64_t>* monotonic_counter,
                                 HybridTime* restart_read_ht,
-                                const string& table_name) {
+                                const string& table_name,
+                                Counter* cache_hits_metric) {
   DCHECK_ONLY_NOTNULL(restart_read_ht);
   DocWriteBatch doc_write_batch(doc_db, init_marker_behavior, monotonic_counter);
   DocOperationApplyData data = {&doc_write_batch, deadline, read_time, restart_read_ht};
@@ -368,6 +370,9 @@ Status ExecuteDocWriteOperation(const vector<unique_ptr<DocOperation>>& doc_writ
 
     RETURN_NOT_OK(s);
   }
+  if (cache_hits_metric) {
+    cache_hits_metric->IncrementBy(doc_write_batch.cache().hits());
+  }
   doc_write_batch.MoveToWriteBatchPB(write_batch);
   return Status::OK();
 }
@@ -781,6 +786,58 @@ void SeekToLowerBound(const SliceKeyBound& lower_bound, IntentAwareIterator* ite
   }
 }
 
+// Decodes the value of the column at the given index of a packed row written at write_time.
+CHECKED_STATUS DecodePackedColumn(
+    const PackedRowDecoder& packed_row, size_t idx, DocHybridTime write_time,
+    SubDocument* result) {
+  PrimitiveValue value;
+  RETURN_NOT_OK(packed_row.DecodeColumn(idx, &value));
+  value.SetTtl(-1);
+  value.SetWriteTime(write_time.hybrid_time().GetPhysicalValueMicros());
+  *result = SubDocument(std::move(value));
+  return Status::OK();
+}
+
+// Sets the columns of a packed row as children of result.
+CHECKED_STATUS UnpackRow(
+    const PrimitiveValue& packed_value, DocHybridTime write_time, SubDocument* result) {
+  PackedRowDecoder packed_row;
+  RETURN_NOT_OK(packed_row.Init(packed_value.GetPackedRow()));
+  *result = SubDocument();
+  result->ReserveChildren(packed_row.num_columns());
+  for (size_t idx = 0; idx != packed_row.num_columns(); ++idx) {
+    SubDocument column;
+    RETURN_NOT_OK(DecodePackedColumn(packed_row, idx, write_time, &column));
+    result->SetChild(PrimitiveValue(packed_row.column_id(idx)), std::move(column));
+  }
+  return Status::OK();
+}
+
+// Fills the value of a projected column from the packed row, result is left untouched when the
+// column is not present in the packed row.
+CHECKED_STATUS GetPackedColumn(
+    const PackedRowDecoder& packed_row, const PrimitiveValue& subkey, DocHybridTime write_time,
+    SubDocument* result) {
+  if (subkey.value_type() != ValueType::kColumnId) {
+    return Status::OK();
+  }
+  const int idx = packed_row.FindColumn(subkey.GetColumnId());
+  if (idx == PackedRowDecoder::kColumnNotFound) {
+    return Status::OK();
+  }
+  return DecodePackedColumn(packed_row, idx, write_time, result);
+}
+
+// Returns true if the iterator is positioned at a record within the key prefix that was written
+// not earlier than the given time.
+Result<bool> HasRecordSince(IntentAwareIterator* iter, const Slice& prefix, DocHybridTime time) {
+  if (!iter->valid()) {
+    return false;
+  }
+  auto key_data = VERIFY_RESULT(iter->FetchKey());
+  return key_data.key.starts_with(prefix) && key_data.write_time >= time;
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -803,6 +860,8 @@ CHECKED_STATUS BuildSubDocument(
     int64* num_values_observed) {
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
+  // Whether data.result was filled from a packed row of this subdocument.
+  bool unpacked_row = false;
   while (iter->valid()) {
     if (data.deadline_info && data.deadline_info->CheckAndSetDeadlinePassed()) {
       return STATUS(Expired, "Deadline for query passed.");
@@ -867,6 +926,19 @@ CHECKED_STATUS BuildSubDocument(
         value_type = ValueType::kTombstone;
       }
 
+      if (value_type == ValueType::kPackedRow) {
+        // The packed row overwrites older column records of the row, while column records written
+        // after it are applied on top of the packed values below.
+        if (low_ts < write_time) {
+          low_ts = write_time;
+        }
+        RETURN_NOT_OK(UnpackRow(doc_value.primitive_value(), write_time, data.result));
+        unpacked_row = true;
+        VLOG(3) << "SeekPastSubKey: " << SubDocKey::DebugSliceToString(key);
+        iter->SeekPastSubKey(key);
+        continue;
+      }
+
       const bool is_collection = IsCollectionType(value_type);
       // We have found some key that matches our entire subdocument_key, i.e. we didn't skip ahead
       // to a lower level key (with optional object init markers).
@@ -895,6 +967,17 @@ CHECKED_STATUS BuildSubDocument(
           return STATUS_FORMAT(Corruption,
               "Expected primitive value type, got $0", value_type);
         }
+        if (!data.high_index->CanInclude(current_values_observed)) {
+          iter->SeekOutOfSubDoc(&key_copy);
+          return Status::OK();
+        }
+        // Values before the low index, like the members a rank range query skips, are only
+        // counted.
+        if (!data.low_index->CanInclude(*num_values_observed)) {
+          (*num_values_observed)++;
+          iter->SeekOutOfSubDoc(&key_copy);
+          return Status::OK();
+        }
         // TODO: the ttl_seconds in primitive value is currently only in use for CQL. At some
         // point streamline by refactoring CQL to use the mutable Expiration in GetSubDocumentData.
         if (data.exp.ttl == Value::kMaxTtl) {
@@ -915,13 +998,7 @@ CHECKED_STATUS BuildSubDocument(
             user_timestamp == Value::kInvalidUserTimestamp
             ? write_time.hybrid_time().GetPhysicalValueMicros()
             : doc_value.user_timestamp());
-        if (!data.high_index->CanInclude(current_values_observed)) {
-          iter->SeekOutOfSubDoc(&key_copy);
-          return Status::OK();
-        }
-        if (data.low_index->CanInclude(*num_values_observed)) {
-          *data.result = SubDocument(doc_value.primitive_value());
-        }
+        *data.result = SubDocument(doc_value.primitive_value());
         (*num_values_observed)++;
         VLOG(3) << "SeekOutOfSubDoc: " << SubDocKey::DebugSliceToString(key);
         iter->SeekOutOfSubDoc(&key_copy);
@@ -940,6 +1017,16 @@ CHECKED_STATUS BuildSubDocument(
     }
     if (descendant.value_type() == ValueType::kInvalid) {
       // The document was not found in this level (maybe a tombstone was encountered).
+      if (unpacked_row) {
+        // The column was deleted after the packed row was written, so drop its packed value.
+        Slice temp = key;
+        temp.remove_prefix(data.subdocument_key.size());
+        PrimitiveValue child;
+        RETURN_NOT_OK(child.DecodeFromKey(&temp));
+        if (temp.empty()) {
+          data.result->DeleteChild(child);
+        }
+      }
       continue;
     }
 
@@ -1225,6 +1312,24 @@ yb::Status GetSubDocument(
   // Seed key_bytes with the subdocument key. For each subkey in the projection, build subdocument
   // and reuse key_bytes while appending the subkey.
   *data.result = SubDocument();
+  PackedRowDecoder packed_row;
+  const bool has_packed_row = value_type == ValueType::kPackedRow;
+  if (has_packed_row) {
+    RETURN_NOT_OK(packed_row.Init(doc_value.primitive_value().GetPackedRow()));
+    // The row exists as long as its packed row is not deleted.
+    *data.doc_found = true;
+    // When no column record of the row follows the packed row, all projected columns are read from
+    // the packed row without seeking to each column.
+    db_iter->SeekPastSubKey(key_slice);
+    if (!db_iter->valid()) {
+      for (const PrimitiveValue& subkey : *projection) {
+        SubDocument descendant(ValueType::kInvalid);
+        RETURN_NOT_OK(GetPackedColumn(packed_row, subkey, max_overwrite_ht, &descendant));
+        data.result->SetChild(subkey, std::move(descendant));
+      }
+      return Status::OK();
+    }
+  }
   KeyBytes key_bytes;
   // Preallocate some extra space to avoid allocation for small subkeys.
   key_bytes.Reserve(data.subdocument_key.size() + kMaxBytesPerEncodedHybridTime + 32);
@@ -1240,11 +1345,17 @@ yb::Status GetSubDocument(
     IntentAwareIteratorPrefixScope prefix_scope(key_bytes, db_iter);
     db_iter->SeekForward(&key_bytes);
     SubDocument descendant(ValueType::kInvalid);
-    int64 num_values_observed = 0;
-    RETURN_NOT_OK(BuildSubDocument(
-        db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
-        &num_values_observed));
-    *data.doc_found = descendant.value_type() != ValueType::kInvalid;
+    if (has_packed_row &&
+        !VERIFY_RESULT(HasRecordSince(db_iter, key_bytes.AsSlice(), max_overwrite_ht))) {
+      // The column was not written after the packed row, so the packed value is the latest one.
+      RETURN_NOT_OK(GetPackedColumn(packed_row, subkey, max_overwrite_ht, &descendant));
+    } else {
+      int64 num_values_observed = 0;
+      RETURN_NOT_OK(BuildSubDocument(
+          db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
+          &num_values_observed));
+      *data.doc_found = has_packed_row || descendant.value_type() != ValueType::kInvalid;
+    }
     data.result->SetChild(subkey, std::move(descendant));
 
     // Restore subdocument key by truncating the appended subkey.
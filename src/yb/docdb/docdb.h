@@ -80,6 +80,7 @@
 
 namespace yb {
 
+class Counter;
 class Histogram;
 
 namespace docdb {
@@ -109,6 +110,8 @@ class DocOperation;
 struct PrepareDocWriteOperationResult {
   LockBatch lock_batch;
   bool need_read_snapshot = false;
+  // Time spent waiting for the locks.
+  MonoDelta lock_wait_time;
 };
 
 Result<PrepareDocWriteOperationResult> PrepareDocWriteOperation(
@@ -129,6 +132,8 @@ Result<PrepareDocWriteOperationResult> PrepareDocWriteOperation(
 // Input: doc_write_ops, read snapshot hybrid_time if requested in PrepareDocWriteOperation().
 // Context: rocksdb
 // Outputs: keys_locked, write_batch
+// cache_hits_metric, if specified, is incremented by the number of RocksDB lookups that were
+// avoided thanks to the DocWriteBatchCache.
 // TODO: rename this to something other than "apply" to avoid confusing it with the "apply"
 // operation that happens after Raft replication.
 CHECKED_STATUS ExecuteDocWriteOperation(
@@ -140,7 +145,8 @@ CHECKED_STATUS ExecuteDocWriteOperation(
     InitMarkerBehavior init_marker_behavior,
     std::atomic<int64_t>* monotonic_counter,
     HybridTime* restart_read_ht,
-    const std::string& table_name);
+    const std::string& table_name,
+    Counter* cache_hits_metric = nullptr);
 
 void PrepareNonTransactionWriteBatch(
     const docdb::KeyValueWriteBatchPB& put_batch,
@@ -0,0 +1,446 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Microbenchmarks of the DocDB hot paths, on top of a RocksDB instance in the test directory:
+//
+//   dockey_encode           - encoding of DocKeys with a hash and dockey_range_components range
+//                             components.
+//   dockey_decode           - decoding of the same DocKeys.
+//   doc_write_batch         - generation of the DocWriteBatch of a row of num_columns columns and
+//                             of its RocksDB write batch.
+//   intent_aware_iterator   - point seeks with IntentAwareIterator over num_rows rows, with
+//                             num_intents intents of transactions pending at the read time.
+//   rowwise_iterator        - full scans with DocRowwiseIterator, projecting projection_columns
+//                             of the num_columns columns.
+//   conflict_resolution     - conflict resolution of single row writes against num_intents
+//                             intents of committed transactions.
+//   load_generator          - random document writes and reads of DocDBLoadGenerator, verified
+//                             against the in-memory DocDB as in randomized_docdb-test.
+//
+// Each benchmark is run repetitions times of num_ops operations, and its result is written to
+// stdout as a line of JSON, e.g.
+//
+//   {"benchmark":"rowwise_iterator","num_ops":100000,...,"ns_per_op":[151.2,148.9,149.3],
+//    "best_ns_per_op":148.9,"best_ops_per_sec":6715916.7}
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/ql_expr.h"
+#include "yb/common/transaction-test-util.h"
+
+#include "yb/docdb/conflict_resolution.h"
+#include "yb/docdb/doc_operation.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/intent_aware_iterator.h"
+
+#include "yb/gutil/strings/split.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/logging.h"
+#include "yb/util/monotime.h"
+
+DEFINE_string(benchmarks,
+              "dockey_encode,dockey_decode,doc_write_batch,intent_aware_iterator,"
+              "rowwise_iterator,conflict_resolution,load_generator",
+              "Comma separated list of the benchmarks to run.");
+DEFINE_int32(num_ops, 100000,
+             "Number of operations of each repetition. For rowwise_iterator it is the number of "
+             "rows scanned, rounded up to whole scans.");
+DEFINE_int32(repetitions, 3, "Number of times each benchmark is run.");
+DEFINE_int32(num_rows, 10000, "Number of rows written for the iterator and conflict benchmarks.");
+DEFINE_int32(num_columns, 10, "Number of non-key columns of a row.");
+DEFINE_int32(projection_columns, 3,
+             "Number of the columns read by rowwise_iterator, the first ones of the row.");
+DEFINE_int32(num_intents, 1000,
+             "Number of transactions that wrote an intent to a random row for the "
+             "intent_aware_iterator and conflict_resolution benchmarks.");
+DEFINE_int32(dockey_range_components, 3, "Number of range components of the encoded DocKeys.");
+DEFINE_uint64(random_seed, 23874297385L, "Seed of the generated keys and values.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr int32_t kFirstColumnId = 10;
+// Regular records are written at this time, intents after it.
+constexpr uint64_t kWriteTimeMicros = 1000;
+constexpr uint64_t kIntentTimeMicros = 2000;
+// Transactions that wrote intents are pending when reading at kReadTimeMicros and committed when
+// resolving conflicts at kResolutionTimeMicros.
+constexpr uint64_t kReadTimeMicros = 1000000;
+constexpr uint64_t kCommitTimeMicros = 2000000;
+constexpr uint64_t kResolutionTimeMicros = 3000000;
+// Number of rows written to RocksDB in a single batch while loading.
+constexpr int kLoadBatchRows = 1000;
+
+// Write operation of a whole row, that only provides its doc path for conflict resolution.
+class RowWriteOperation : public DocOperation {
+ public:
+  explicit RowWriteOperation(const DocKey& doc_key)
+      : encoded_doc_key_(doc_key.EncodeAsRefCntPrefix()) {}
+
+  bool RequireReadSnapshot() const override {
+    return false;
+  }
+
+  CHECKED_STATUS GetDocPaths(
+      GetDocPathsMode mode, DocPathsToLock *paths, IsolationLevel *level) const override {
+    paths->push_back(encoded_doc_key_);
+    *level = IsolationLevel::SERIALIZABLE_ISOLATION;
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Apply(const DocOperationApplyData& data) override {
+    return STATUS(NotSupported, "Only conflict resolution is benchmarked");
+  }
+
+  Type OpType() override {
+    return Type::QL_WRITE_OPERATION;
+  }
+
+  void ClearResponse() override {}
+
+  std::string ToString() const override {
+    return "RowWriteOperation";
+  }
+
+ private:
+  RefCntPrefix encoded_doc_key_;
+};
+
+class DocDBBench : public DocDBRocksDBFixture {
+ public:
+  DocDBBench() : rng_(FLAGS_random_seed) {
+    std::vector<ColumnSchema> columns = { ColumnSchema("k", DataType::STRING, false) };
+    std::vector<ColumnId> column_ids = { ColumnId(kFirstColumnId - 1) };
+    for (int i = 0; i != FLAGS_num_columns; ++i) {
+      columns.emplace_back(Format("c$0", i), DataType::INT64, true);
+      column_ids.emplace_back(kFirstColumnId + i);
+    }
+    schema_ = Schema(columns, column_ids, 1);
+  }
+
+  CHECKED_STATUS Open() {
+    RETURN_NOT_OK(InitRocksDBOptions());
+    RETURN_NOT_OK(InitRocksDBDir());
+    RETURN_NOT_OK(OpenRocksDB());
+    ResetMonotonicCounter();
+    return Status::OK();
+  }
+
+  // Prepares the data of the named benchmark, that is not a part of the measured time.
+  CHECKED_STATUS SetUp(const std::string& name) {
+    if (name == "dockey_encode" || name == "dockey_decode") {
+      const int num_keys = std::min(FLAGS_num_ops, 10000);
+      for (int i = 0; i != num_keys; ++i) {
+        std::vector<PrimitiveValue> range_components;
+        range_components.emplace_back(RowKey(i));
+        for (int j = 1; j < FLAGS_dockey_range_components; ++j) {
+          range_components.emplace_back(static_cast<int64_t>(rng_()));
+        }
+        doc_keys_.emplace_back(
+            static_cast<DocKeyHash>(i), std::vector<PrimitiveValue>{PrimitiveValue(RowKey(i))},
+            std::move(range_components));
+        encoded_doc_keys_.push_back(doc_keys_.back().Encode());
+      }
+    } else if (name == "intent_aware_iterator" || name == "rowwise_iterator" ||
+               name == "conflict_resolution") {
+      RETURN_NOT_OK(LoadRows());
+      if (name != "rowwise_iterator") {
+        RETURN_NOT_OK(WriteIntents());
+      }
+    } else if (name == "load_generator") {
+      load_generator_ = std::make_unique<DocDBLoadGenerator>(
+          this, FLAGS_num_rows, /* num_unique_subkeys */ 100, UseHash::kTrue,
+          ResolveIntentsDuringRead::kFalse, /* deletion_chance */ 100,
+          /* max_nesting_level */ 3, FLAGS_random_seed,
+          /* verification_frequency */ std::numeric_limits<int>::max());
+    } else if (name != "doc_write_batch") {
+      return STATUS_FORMAT(InvalidArgument, "Unknown benchmark: $0", name);
+    }
+    return Status::OK();
+  }
+
+  // Runs a repetition of the named benchmark, returns the number of the operations done.
+  Result<int64_t> Run(const std::string& name) {
+    if (name == "dockey_encode") {
+      return DocKeyEncode();
+    } else if (name == "dockey_decode") {
+      return DocKeyDecode();
+    } else if (name == "doc_write_batch") {
+      return DocWriteBatchGeneration();
+    } else if (name == "intent_aware_iterator") {
+      return IntentAwareIteratorSeeks();
+    } else if (name == "rowwise_iterator") {
+      return RowwiseIteratorScans();
+    } else if (name == "conflict_resolution") {
+      return ConflictResolution();
+    } else if (name == "load_generator") {
+      return LoadGeneratorOperations();
+    }
+    return STATUS_FORMAT(InvalidArgument, "Unknown benchmark: $0", name);
+  }
+
+ private:
+  static std::string RowKey(int64_t index) {
+    return Format("row$0", index);
+  }
+
+  static DocKey RowDocKey(int64_t index) {
+    return DocKey(std::vector<PrimitiveValue>{PrimitiveValue(RowKey(index))});
+  }
+
+  static DocPath ColumnPath(const KeyBytes& encoded_doc_key, int column) {
+    return DocPath(encoded_doc_key, PrimitiveValue(ColumnId(kFirstColumnId + column)));
+  }
+
+  int64_t RandomRow() {
+    return rng_() % FLAGS_num_rows;
+  }
+
+  CHECKED_STATUS AddRow(int64_t index, DocWriteBatch* dwb) {
+    const KeyBytes encoded_doc_key(RowDocKey(index).Encode());
+    for (int column = 0; column != FLAGS_num_columns; ++column) {
+      RETURN_NOT_OK(dwb->SetPrimitive(
+          ColumnPath(encoded_doc_key, column), PrimitiveValue(static_cast<int64_t>(rng_()))));
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS LoadRows() {
+    LOG(INFO) << "Writing " << FLAGS_num_rows << " rows";
+    auto dwb = MakeDocWriteBatch();
+    for (int64_t index = 0; index != FLAGS_num_rows; ++index) {
+      RETURN_NOT_OK(AddRow(index, &dwb));
+      if ((index + 1) % kLoadBatchRows == 0 || index + 1 == FLAGS_num_rows) {
+        RETURN_NOT_OK(WriteToRocksDBAndClear(&dwb, HybridTime::FromMicros(kWriteTimeMicros)));
+      }
+    }
+    return FlushRocksDbAndWait();
+  }
+
+  CHECKED_STATUS WriteIntents() {
+    LOG(INFO) << "Writing intents of " << FLAGS_num_intents << " transactions";
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    for (int i = 0; i != FLAGS_num_intents; ++i) {
+      const auto txn_id = TransactionId::GenerateRandom();
+      SetCurrentTransactionId(txn_id);
+      RETURN_NOT_OK(SetPrimitive(
+          ColumnPath(RowDocKey(RandomRow()).Encode(), 0),
+          PrimitiveValue(static_cast<int64_t>(rng_())), HybridTime::FromMicros(kIntentTimeMicros)));
+      txn_status_manager_.Commit(txn_id, HybridTime::FromMicros(kCommitTimeMicros));
+    }
+    ResetCurrentTransactionId();
+    return Status::OK();
+  }
+
+  int64_t DocKeyEncode() {
+    size_t total_size = 0;
+    KeyBytes key_bytes;
+    for (int i = 0; i != FLAGS_num_ops; ++i) {
+      key_bytes = doc_keys_[i % doc_keys_.size()].Encode();
+      total_size += key_bytes.size();
+    }
+    VLOG(1) << "Encoded " << total_size << " bytes";
+    return FLAGS_num_ops;
+  }
+
+  Result<int64_t> DocKeyDecode() {
+    DocKey doc_key;
+    for (int i = 0; i != FLAGS_num_ops; ++i) {
+      RETURN_NOT_OK(doc_key.FullyDecodeFrom(encoded_doc_keys_[i % encoded_doc_keys_.size()]));
+    }
+    return FLAGS_num_ops;
+  }
+
+  Result<int64_t> DocWriteBatchGeneration() {
+    auto dwb = MakeDocWriteBatch();
+    rocksdb::WriteBatch rocksdb_write_batch;
+    for (int i = 0; i != FLAGS_num_ops; ++i) {
+      RETURN_NOT_OK(AddRow(i, &dwb));
+      RETURN_NOT_OK(PopulateRocksDBWriteBatch(
+          dwb, &rocksdb_write_batch, HybridTime::FromMicros(kWriteTimeMicros)));
+      dwb.Clear();
+      rocksdb_write_batch.Clear();
+    }
+    return FLAGS_num_ops;
+  }
+
+  Result<int64_t> IntentAwareIteratorSeeks() {
+    const TransactionOperationContext txn_op_context(
+        TransactionId::GenerateRandom(), &txn_status_manager_);
+    auto iter = CreateIntentAwareIterator(
+        doc_db(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+        txn_op_context, CoarseTimePoint::max(), ReadHybridTime::FromMicros(kReadTimeMicros));
+    int64_t found = 0;
+    for (int i = 0; i != FLAGS_num_ops; ++i) {
+      iter->Seek(RowDocKey(RandomRow()));
+      if (iter->valid()) {
+        RETURN_NOT_OK(iter->FetchKey());
+        ++found;
+      }
+    }
+    if (found != FLAGS_num_ops) {
+      return STATUS_FORMAT(IllegalState, "Found $0 of $1 rows", found, FLAGS_num_ops);
+    }
+    return FLAGS_num_ops;
+  }
+
+  Result<int64_t> RowwiseIteratorScans() {
+    std::vector<GStringPiece> names;
+    for (int i = 0; i != std::min(FLAGS_projection_columns, FLAGS_num_columns); ++i) {
+      names.push_back(schema_.column(i + 1).name());
+    }
+    Schema projection;
+    RETURN_NOT_OK(schema_.CreateProjectionByNames(names, &projection));
+
+    int64_t rows = 0;
+    QLTableRow row;
+    while (rows < FLAGS_num_ops) {
+      DocRowwiseIterator iter(
+          projection, schema_, kNonTransactionalOperationContext, doc_db(),
+          CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(kReadTimeMicros));
+      RETURN_NOT_OK(iter.Init());
+      while (VERIFY_RESULT(iter.HasNext())) {
+        RETURN_NOT_OK(iter.NextRow(&row));
+        ++rows;
+      }
+      if (rows == 0) {
+        return STATUS(IllegalState, "No rows found");
+      }
+    }
+    return rows;
+  }
+
+  Result<int64_t> ConflictResolution() {
+    const auto resolution_ht = HybridTime::FromMicros(kResolutionTimeMicros);
+    for (int i = 0; i != FLAGS_num_ops; ++i) {
+      DocOperations doc_ops;
+      doc_ops.emplace_back(new RowWriteOperation(RowDocKey(RandomRow())));
+      RETURN_NOT_OK(ResolveOperationConflicts(
+          doc_ops, resolution_ht, doc_db(), PartialRangeKeyIntents::kTrue,
+          &txn_status_manager_));
+    }
+    return FLAGS_num_ops;
+  }
+
+  int64_t LoadGeneratorOperations() {
+    for (int i = 0; i != FLAGS_num_ops; ++i) {
+      load_generator_->PerformOperation();
+    }
+    return FLAGS_num_ops;
+  }
+
+  std::mt19937_64 rng_;
+  std::vector<DocKey> doc_keys_;
+  std::vector<KeyBytes> encoded_doc_keys_;
+  TransactionStatusManagerMock txn_status_manager_;
+  std::unique_ptr<DocDBLoadGenerator> load_generator_;
+};
+
+CHECKED_STATUS RunBenchmark(const std::string& name) {
+  DocDBBench bench;
+  RETURN_NOT_OK(bench.Open());
+  auto status = bench.SetUp(name);
+
+  std::vector<double> ns_per_op;
+  int64_t num_ops = 0;
+  for (int i = 0; status.ok() && i != FLAGS_repetitions; ++i) {
+    const auto start = MonoTime::Now();
+    auto result = bench.Run(name);
+    const auto elapsed = MonoTime::Now() - start;
+    if (!result.ok()) {
+      status = result.status();
+      break;
+    }
+    num_ops = *result;
+    ns_per_op.push_back(static_cast<double>(elapsed.ToNanoseconds()) / num_ops);
+    LOG(INFO) << name << " repetition " << i + 1 << ": " << num_ops << " ops in " << elapsed;
+  }
+  WARN_NOT_OK(bench.DestroyRocksDB(), "Failed to destroy RocksDB");
+  RETURN_NOT_OK_PREPEND(status, Format("Benchmark $0 failed", name));
+
+  const double best = *std::min_element(ns_per_op.begin(), ns_per_op.end());
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::COMPACT);
+  writer.StartObject();
+  writer.String("benchmark");
+  writer.String(name);
+  writer.String("num_ops");
+  writer.Int64(num_ops);
+  writer.String("num_rows");
+  writer.Int(FLAGS_num_rows);
+  writer.String("num_columns");
+  writer.Int(FLAGS_num_columns);
+  writer.String("projection_columns");
+  writer.Int(FLAGS_projection_columns);
+  writer.String("num_intents");
+  writer.Int(FLAGS_num_intents);
+  writer.String("dockey_range_components");
+  writer.Int(FLAGS_dockey_range_components);
+  writer.String("ns_per_op");
+  writer.StartArray();
+  for (auto value : ns_per_op) {
+    writer.Double(value);
+  }
+  writer.EndArray();
+  writer.String("best_ns_per_op");
+  writer.Double(best);
+  writer.String("best_ops_per_sec");
+  writer.Double(1e9 / best);
+  writer.EndObject();
+  std::cout << out.str() << std::endl;
+  return Status::OK();
+}
+
+} // namespace
+
+} // namespace docdb
+} // namespace yb
+
+int main(int argc, char** argv) {
+  gflags::SetUsageMessage(
+      "Usage:\n"
+      "    docdb_bench --benchmarks=rowwise_iterator,conflict_resolution --num_rows=100000");
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+
+  if (FLAGS_num_ops <= 0 || FLAGS_repetitions <= 0 || FLAGS_num_rows <= 0 ||
+      FLAGS_num_columns <= 0 || FLAGS_dockey_range_components <= 0) {
+    LOG(ERROR) << "The number of operations, repetitions, rows, columns and range components "
+               << "should be positive";
+    return 1;
+  }
+
+  bool failed = false;
+  std::vector<std::string> names = strings::Split(FLAGS_benchmarks, ",", strings::SkipEmpty());
+  for (const auto& name : names) {
+    auto status = yb::docdb::RunBenchmark(name);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+      failed = true;
+    }
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/docdb_expiration_index.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr uint64_t kBucket = ExpirationIndex::kExpirationIndexBucketMicros;
+
+std::string EncodedKey(const std::string& key, HybridTime write_time) {
+  return SubDocKey(DocKey({PrimitiveValue(key)}), write_time).Encode().data();
+}
+
+} // namespace
+
+class ExpirationIndexTest : public YBTest {
+};
+
+TEST_F(ExpirationIndexTest, ExpiredBytes) {
+  ExpirationIndex index;
+  const auto write_time = HybridTime::FromMicros(10 * kBucket);
+  const auto with_ttl = EncodedKey("with_ttl", write_time);
+  const auto without_ttl = EncodedKey("without_ttl", write_time);
+  const auto value_with_ttl = Value(PrimitiveValue("v"), MonoDelta::FromSeconds(60)).Encode();
+  index.Add(with_ttl, value_with_ttl);
+  index.Add(without_ttl, Value(PrimitiveValue("v")).Encode());
+  // Bad keys are ignored.
+  index.Add("bad key", value_with_ttl);
+  ASSERT_EQ(index.buckets().size(), 1);
+
+  const auto bytes = with_ttl.size() + value_with_ttl.size();
+  ASSERT_EQ(index.ExpiredBytes(write_time), 0);
+  ASSERT_EQ(index.ExpiredBytes(HybridTime::FromMicros(12 * kBucket)), bytes);
+
+  auto decoded = ASSERT_RESULT(ExpirationIndex::Decode(index.Encode()));
+  ASSERT_EQ(decoded.buckets(), index.buckets());
+  ASSERT_NOK(ExpirationIndex::Decode(Slice("\xff", 1)));
+}
+
+TEST_F(ExpirationIndexTest, OverwrittenVersions) {
+  ExpirationIndex index;
+  const auto newest = EncodedKey("key", HybridTime::FromMicros(20 * kBucket));
+  const auto older = EncodedKey("key", HybridTime::FromMicros(15 * kBucket));
+  const auto oldest = EncodedKey("key", HybridTime::FromMicros(10 * kBucket));
+  const auto other = EncodedKey("other", HybridTime::FromMicros(5 * kBucket));
+  const auto value = Value(PrimitiveValue("v")).Encode();
+  for (const auto& key : {newest, older, oldest, other}) {
+    index.Add(key, value);
+  }
+
+  // Each older version expires once the history cutoff passes the version that overwrites it.
+  const auto oldest_bytes = oldest.size() + value.size();
+  ASSERT_EQ(index.ExpiredBytes(HybridTime::FromMicros(15 * kBucket)), 0);
+  ASSERT_EQ(index.ExpiredBytes(HybridTime::FromMicros(16 * kBucket)), oldest_bytes);
+  ASSERT_EQ(index.ExpiredBytes(HybridTime::FromMicros(21 * kBucket)),
+            oldest_bytes + older.size() + value.size());
+
+  // A merge record does not overwrite the older version.
+  ExpirationIndex merged;
+  merged.Add(newest, value);
+  merged.AddNonValue();
+  merged.Add(older, value);
+  ASSERT_TRUE(merged.buckets().empty());
+}
+
+TEST_F(ExpirationIndexTest, Shrink) {
+  ExpirationIndex index;
+  for (uint64_t i = 0; i <= ExpirationIndex::kMaxBuckets; ++i) {
+    index.Add(i * kBucket, 1);
+  }
+  ASSERT_LE(index.buckets().size(), ExpirationIndex::kMaxBuckets);
+  // Merged buckets expire with the later one, so no data is counted as expired too early.
+  for (uint64_t i = 0; i <= ExpirationIndex::kMaxBuckets; ++i) {
+    ASSERT_LE(index.ExpiredBytes(HybridTime::FromMicros(i * kBucket + kBucket)), i + 1);
+  }
+  const auto last_expiration = (ExpirationIndex::kMaxBuckets + 1) * kBucket;
+  ASSERT_EQ(index.ExpiredBytes(HybridTime::FromMicros(last_expiration)),
+            ExpirationIndex::kMaxBuckets + 1);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,193 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/docdb_expiration_index.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <glog/logging.h>
+
+#include "yb/common/doc_hybrid_time.h"
+
+#include "yb/docdb/value.h"
+
+#include "yb/rocksdb/util/coding.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+const char* const ExpirationIndex::kPropertyName = "yb.expiration_index";
+
+void ExpirationIndex::Add(const Slice& key, const Slice& value) {
+  Slice key_without_ht = key;
+  auto write_time = DocHybridTime::DecodeFromEnd(&key_without_ht);
+  if (!write_time.ok()) {
+    AddNonValue();
+    return;
+  }
+  const auto write_micros = write_time->hybrid_time().GetPhysicalValueMicros();
+  auto expiration_micros = std::numeric_limits<uint64_t>::max();
+  if (key_without_ht == Slice(last_key_without_ht_)) {
+    // Overwritten by the previous entry, the newer version of the same key.
+    expiration_micros = last_write_micros_;
+  } else {
+    last_key_without_ht_.assign(key_without_ht.cdata(), key_without_ht.size());
+  }
+  last_write_micros_ = write_micros;
+
+  ValueType value_type;
+  MonoDelta ttl;
+  if (Value::DecodePrimitiveValueType(value, &value_type, nullptr, &ttl).ok() &&
+      !ttl.Equals(Value::kMaxTtl) && !ttl.Equals(Value::kResetTtl)) {
+    expiration_micros = std::min(
+        expiration_micros, write_time->hybrid_time().AddDelta(ttl).GetPhysicalValueMicros());
+  }
+  if (expiration_micros != std::numeric_limits<uint64_t>::max()) {
+    Add(expiration_micros, key.size() + value.size());
+  }
+}
+
+void ExpirationIndex::AddNonValue() {
+  last_key_without_ht_.clear();
+}
+
+void ExpirationIndex::Add(uint64_t expiration_micros, uint64_t bytes) {
+  const auto bucket =
+      (expiration_micros / kExpirationIndexBucketMicros + 1) * kExpirationIndexBucketMicros;
+  buckets_[bucket] += bytes;
+  if (buckets_.size() > kMaxBuckets) {
+    Shrink();
+  }
+}
+
+void ExpirationIndex::Shrink() {
+  Buckets result;
+  for (auto it = buckets_.begin(); it != buckets_.end();) {
+    auto bytes = it->second;
+    if (++it == buckets_.end()) {
+      result.emplace_hint(result.end(), std::prev(it)->first, bytes);
+      break;
+    }
+    result.emplace_hint(result.end(), it->first, bytes + it->second);
+    ++it;
+  }
+  buckets_.swap(result);
+}
+
+std::string ExpirationIndex::Encode() const {
+  std::string result;
+  for (const auto& bucket : buckets_) {
+    rocksdb::PutVarint64(&result, bucket.first);
+    rocksdb::PutVarint64(&result, bucket.second);
+  }
+  return result;
+}
+
+Result<ExpirationIndex> ExpirationIndex::Decode(const Slice& encoded) {
+  ExpirationIndex result;
+  Slice input = encoded;
+  while (!input.empty()) {
+    uint64_t expiration, bytes;
+    if (!rocksdb::GetVarint64(&input, &expiration) || !rocksdb::GetVarint64(&input, &bytes)) {
+      return STATUS(Corruption, "Bad expiration index", encoded.ToDebugHexString());
+    }
+    result.buckets_.emplace_hint(result.buckets_.end(), expiration, bytes);
+  }
+  return result;
+}
+
+uint64_t ExpirationIndex::ExpiredBytes(HybridTime time) const {
+  const auto now_micros = time.GetPhysicalValueMicros();
+  uint64_t result = 0;
+  for (const auto& bucket : buckets_) {
+    if (bucket.first > now_micros) {
+      break;
+    }
+    result += bucket.second;
+  }
+  return result;
+}
+
+namespace {
+
+class ExpirationIndexCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  Status AddUserKey(const Slice& key, const Slice& value, rocksdb::EntryType type,
+                    rocksdb::SequenceNumber /* seq */, uint64_t /* file_size */) override {
+    if (type == rocksdb::kEntryPut) {
+      index_.Add(key, value);
+    } else {
+      index_.AddNonValue();
+    }
+    return Status::OK();
+  }
+
+  Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    if (!index_.buckets().empty()) {
+      properties->emplace(ExpirationIndex::kPropertyName, index_.Encode());
+    }
+    return Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    uint64_t bytes = 0;
+    for (const auto& bucket : index_.buckets()) {
+      bytes += bucket.second;
+    }
+    return {{ExpirationIndex::kPropertyName, std::to_string(bytes) + " bytes that expire"}};
+  }
+
+  const char* Name() const override {
+    return "ExpirationIndexCollector";
+  }
+
+ private:
+  ExpirationIndex index_;
+};
+
+class ExpirationIndexCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context /* context */) override {
+    return new ExpirationIndexCollector();
+  }
+
+  const char* Name() const override {
+    return "ExpirationIndexCollectorFactory";
+  }
+};
+
+} // namespace
+
+std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> CreateExpirationIndexCollectorFactory() {
+  return std::make_shared<ExpirationIndexCollectorFactory>();
+}
+
+uint64_t ExpiredBytes(const rocksdb::TableProperties& properties, HybridTime time) {
+  auto it = properties.user_collected_properties.find(ExpirationIndex::kPropertyName);
+  if (it == properties.user_collected_properties.end()) {
+    return 0;
+  }
+  auto index = ExpirationIndex::Decode(it->second);
+  if (!index.ok()) {
+    LOG(WARNING) << index.status();
+    return 0;
+  }
+  return index->ExpiredBytes(time);
+}
+
+} // namespace docdb
+} // namespace yb
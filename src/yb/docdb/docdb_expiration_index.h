@@ -0,0 +1,105 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOCDB_EXPIRATION_INDEX_H_
+#define YB_DOCDB_DOCDB_EXPIRATION_INDEX_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "yb/common/hybrid_time.h"
+
+#include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/table_properties.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Every SST file of the regular DB gets an expiration index in its table properties: the number
+// of bytes of its entries with a TTL, keyed by the physical time at which they expire, rounded up
+// to kExpirationIndexBucketMicros. It tells how much of the file would be dropped by a compaction
+// at a given history cutoff, without reading the file, so that files with mostly expired data can
+// be compacted before they would be compacted for their size.
+//
+// Expiration is computed from the hybrid time of the entry and its own TTL, so the index does not
+// know about data that expires by a TTL of its parent or of the table, and it only serves to decide
+// when to compact. An older version of a key, that is overwritten by a newer version in the same
+// file, expires at the hybrid time of the newer version, since the compaction drops it once the
+// history cutoff passes that time. Overwrites by a newer version of a parent are not accounted.
+class ExpirationIndex {
+ public:
+  // Bytes of the entries by the end of the bucket of their expiration, in microseconds.
+  typedef std::map<uint64_t, uint64_t> Buckets;
+
+  static constexpr uint64_t kExpirationIndexBucketMicros = 60 * 1000 * 1000;
+  // Adjacent buckets are merged, into the later one, when there are more than that.
+  static constexpr size_t kMaxBuckets = 256;
+
+  static const char* const kPropertyName;
+
+  // Accounts for the entry with the given key and value. The entries should be added in the order
+  // of their keys, so that the older versions of a key follow the version that overwrites them.
+  void Add(const Slice& key, const Slice& value);
+
+  // Accounts for an entry that is not a value, e.g. a TTL merge record. It does not expire on its
+  // own, and does not overwrite the older versions of its key.
+  void AddNonValue();
+
+  // Adds bytes that expire at the physical time.
+  void Add(uint64_t expiration_micros, uint64_t bytes);
+
+  std::string Encode() const;
+  static Result<ExpirationIndex> Decode(const Slice& encoded);
+
+  // Returns the number of bytes that expired by the time.
+  uint64_t ExpiredBytes(HybridTime time) const;
+
+  const Buckets& buckets() const { return buckets_; }
+
+ private:
+  // Halves the number of buckets, merging pairs of adjacent buckets into the later one.
+  void Shrink();
+
+  Buckets buckets_;
+
+  // The key of the last added value without its hybrid time, and the physical time it was written
+  // at, in microseconds.
+  std::string last_key_without_ht_;
+  uint64_t last_write_micros_ = 0;
+};
+
+// Returns the collector of the expiration index, that should be used for the regular DB.
+std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> CreateExpirationIndexCollectorFactory();
+
+// Returns the number of bytes of the SST file with the given properties, that expired by the time.
+// Files without an expiration index have no expired data.
+uint64_t ExpiredBytes(const rocksdb::TableProperties& properties, HybridTime time);
+
+// Returns whether every entry of the SST file with the given boundary values expired by the
+// history cutoff, so the file could be dropped without compacting it. Unlike the expiration index,
+// the boundary values account for the TTL of the table, but not for the TTL of the parents, and
+// files with merge records, delete markers or entries without an expiration never pass.
+bool FileDataExpired(const rocksdb::FileBoundaryValuesBase& smallest,
+                     const rocksdb::FileBoundaryValuesBase& largest,
+                     MonoDelta table_ttl,
+                     HybridTime history_cutoff);
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DOCDB_EXPIRATION_INDEX_H_
@@ -13,6 +13,7 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <atomic>
 #include <thread>
 #include <memory>
 
@@ -32,11 +33,16 @@
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/storage_metrics.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/background_io_limiter.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/path_util.h"
 #include "yb/util/priority_thread_pool.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/gutil/sysinfo.h"
 
@@ -51,6 +57,11 @@ DEFINE_int32(rocksdb_base_background_compactions, -1,
 DEFINE_int32(rocksdb_max_background_compactions, -1,
              "Increased number of threads to do background compactions (used when compactions need "
              "to catch up.)");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of key ranges a single compaction is split into, each processed by "
+             "its own thread. Limited by rocksdb_max_background_compactions. Each subcompaction "
+             "writes its own output file, so the number of files after a compaction grows.");
+TAG_FLAG(rocksdb_max_subcompactions, advanced);
 DEFINE_int32(rocksdb_level0_file_num_compaction_trigger, 5,
              "Number of files to trigger level-0 compaction. -1 if compaction should not be "
              "triggered by number of files at all.");
@@ -98,6 +109,11 @@ DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
 DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
+DEFINE_bool(db_pin_top_level_index, true,
+            "Whether to keep the top level of multi-level data index of each SST file in memory, "
+            "instead of loading it through the block cache. Lower index levels and filter blocks "
+            "are loaded through the block cache in any case.");
+TAG_FLAG(db_pin_top_level_index, advanced);
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
@@ -107,11 +123,73 @@ DEFINE_int32(num_reserved_small_compaction_threads, -1, "Number of reserved smal
 DEFINE_bool(enable_ondisk_compression, true,
             "Determines whether SSTable compression is enabled or not.");
 
+DEFINE_int32(rocksdb_compression_dict_max_bytes, 0,
+             "Maximum size of the compression dictionary, that is built from the first data blocks "
+             "of each SST file and used to compress the rest of its data blocks. Snappy does not "
+             "support dictionaries, so zlib is used for on-disk compression when this is positive. "
+             "0 disables dictionary compression.");
+TAG_FLAG(rocksdb_compression_dict_max_bytes, advanced);
+
 DEFINE_int32(priority_thread_pool_size, -1,
              "Max running workers in compaction thread pool. "
              "If -1 and max_background_compactions is specified - use max_background_compactions. "
              "If -1 and max_background_compactions is not specified - use sqrt(num_cpus).");
 
+DEFINE_int32(priority_thread_pool_reserved_for_flushes, -1,
+             "Number of workers in compaction thread pool that only run flushes, and compactions "
+             "of DBs that are shutting down, so that flushes do not wait for large compactions to "
+             "be preempted. If -1 - use 1 when use_priority_thread_pool_for_flushes is set and "
+             "the pool has more than one worker, otherwise 0.");
+TAG_FLAG(priority_thread_pool_reserved_for_flushes, advanced);
+
+DEFINE_uint64(rocksdb_iterator_readahead_size, 2_MB,
+              "Number of bytes to read ahead of a DocDB iterator once it reads data blocks of an "
+              "SST file sequentially. The readahead is an asynchronous OS hint, so it does not "
+              "block the reader and is not charged to the compaction/flush rate limiter. "
+              "0 disables readahead.");
+TAG_FLAG(rocksdb_iterator_readahead_size, advanced);
+DEFINE_uint64(rocksdb_iterator_readahead_trigger_reads, 4,
+              "Number of sequential data block reads from an SST file after which DocDB "
+              "iterator starts readahead.");
+TAG_FLAG(rocksdb_iterator_readahead_trigger_reads, advanced);
+
+DEFINE_string(rocksdb_cold_data_dir, "",
+              "Directory for SST files of large universal compaction outputs, usually on a slower "
+              "and larger volume. Each tablet uses a subdirectory of it. Empty to keep all SST "
+              "files in the tablet data directory.");
+TAG_FLAG(rocksdb_cold_data_dir, advanced);
+DEFINE_uint64(rocksdb_hot_data_target_size_bytes, 10_GB,
+              "Target total size of SST files of a tablet kept in the tablet data directory when "
+              "rocksdb_cold_data_dir is set. Compaction outputs that would not fit are written to "
+              "the cold data directory.");
+TAG_FLAG(rocksdb_hot_data_target_size_bytes, advanced);
+
+DEFINE_int32(rocksdb_memtable_insert_threads_per_batch, 1,
+             "Maximum number of threads inserting entries of one large write batch into the "
+             "memtable of a regular RocksDB in parallel. 1 to insert them by the writing thread.");
+TAG_FLAG(rocksdb_memtable_insert_threads_per_batch, advanced);
+DEFINE_int32(rocksdb_memtable_insert_min_entries_per_thread, 256,
+             "Minimum number of write batch entries inserted into the memtable by each thread, "
+             "when rocksdb_memtable_insert_threads_per_batch is greater than 1.");
+TAG_FLAG(rocksdb_memtable_insert_min_entries_per_thread, advanced);
+
+DEFINE_string(db_block_cache_type, "lru",
+              "Eviction policy of the shared RocksDB block cache: 'lru' for the LRU cache with "
+              "single and multi touch pools, 'clock' for the CLOCK cache with frequency based "
+              "admission, whose lookups don't contend with each other.");
+TAG_FLAG(db_block_cache_type, advanced);
+
+DEFINE_bool(rocksdb_use_direct_reads, false,
+            "Read SST files with O_DIRECT, bypassing the OS page cache, so that data is cached only "
+            "in the block cache.");
+TAG_FLAG(rocksdb_use_direct_reads, advanced);
+DEFINE_bool(rocksdb_use_direct_io_for_flush_and_compaction, false,
+            "Write SST files produced by flushes and compactions with O_DIRECT, so that they do "
+            "not evict useful pages from the OS page cache.");
+TAG_FLAG(rocksdb_use_direct_io_for_flush_and_compaction, advanced);
+
+DECLARE_bool(use_priority_thread_pool_for_flushes);
+
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
@@ -141,7 +219,13 @@ KeyBytes AppendDocHt(const Slice& key, const DocHybridTime& doc_ht) {
 }
 
 void SeekPastSubKey(const Slice& key, rocksdb::Iterator* iter) {
-  SeekForward(AppendDocHt(key, DocHybridTime::kMin), iter);
+  const auto seek_key = AppendDocHt(key, DocHybridTime::kMin);
+  if (!iter->Valid() || iter->key().compare(seek_key.AsSlice()) >= 0) {
+    return;
+  }
+  // Everything before the seek key is an older version of the key.
+  docdb_perf_context.versions_skipped +=
+      PerformRocksDBSeek(iter, seek_key.AsSlice(), __FILE__, __LINE__);
 }
 
 void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter) {
@@ -150,13 +234,14 @@ void SeekOutOfSubKey(KeyBytes* key_bytes, rocksdb::Iterator* iter) {
   key_bytes->RemoveValueTypeSuffix(ValueType::kMaxByte);
 }
 
-void PerformRocksDBSeek(
+int PerformRocksDBSeek(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &seek_key,
     const char* file_name,
     int line) {
   int next_count = 0;
   int seek_count = 0;
+  int skipped_count = 0;
   if (seek_key.size() == 0) {
     iter->SeekToFirst();
     ++seek_count;
@@ -171,6 +256,10 @@ void PerformRocksDBSeek(
         }
         break;
       }
+      if (nexts > 0) {
+        // Next() got to an entry that is still before the seek key.
+        ++skipped_count;
+      }
       if (nexts < FLAGS_max_nexts_to_avoid_seek) {
         iter->Next();
         ++next_count;
@@ -200,6 +289,7 @@ void PerformRocksDBSeek(
       iter->Valid() ? FormatSliceAsStr(iter->value()) : "N/A",
       next_count,
       seek_count);
+  return skipped_count;
 }
 
 namespace {
@@ -221,6 +311,8 @@ rocksdb::ReadOptions PrepareReadOptions(
   }
   read_opts.file_filter = std::move(file_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
+  read_opts.readahead_size = FLAGS_rocksdb_iterator_readahead_size;
+  read_opts.readahead_trigger_reads = FLAGS_rocksdb_iterator_readahead_trigger_reads;
   return read_opts;
 }
 
@@ -330,6 +422,13 @@ void AutoInitRocksDBFlags(rocksdb::Options* options) {
     LOG(INFO) << "Auto setting FLAGS_priority_thread_pool_size to "
               << FLAGS_priority_thread_pool_size;
   }
+
+  if (FLAGS_priority_thread_pool_reserved_for_flushes == -1) {
+    FLAGS_priority_thread_pool_reserved_for_flushes =
+        FLAGS_use_priority_thread_pool_for_flushes && FLAGS_priority_thread_pool_size > 1 ? 1 : 0;
+    LOG(INFO) << "Auto setting FLAGS_priority_thread_pool_reserved_for_flushes to "
+              << FLAGS_priority_thread_pool_reserved_for_flushes;
+  }
 }
 
 class HybridTimeFilteringIterator : public rocksdb::FilteringIterator {
@@ -373,8 +472,103 @@ rocksdb::InternalIterator* WrapIterator(
   return iterator;
 }
 
+// Threads shared by all regular RocksDB instances to insert entries of large write batches into
+// memtables.
+ThreadPool* MemTableInsertThreadPool() {
+  static std::unique_ptr<ThreadPool> thread_pool = [] {
+    std::unique_ptr<ThreadPool> result;
+    CHECK_OK(ThreadPoolBuilder("memtable_insert")
+                 .set_max_threads(base::NumCPUs())
+                 .Build(&result));
+    return result;
+  }();
+  return thread_pool.get();
+}
+
+// Accounts the flush and compaction writes of a RocksDB instance in the background I/O limiter of
+// the process, after the rate limiter of the instance, if any.
+class BackgroundIoRateLimiter : public rocksdb::RateLimiter {
+ public:
+  explicit BackgroundIoRateLimiter(std::unique_ptr<rocksdb::RateLimiter> instance_limiter)
+      : instance_limiter_(std::move(instance_limiter)) {}
+
+  void SetBytesPerSecond(int64_t bytes_per_second) override {
+    if (instance_limiter_) {
+      instance_limiter_->SetBytesPerSecond(bytes_per_second);
+    }
+  }
+
+  void Request(const int64_t bytes, const rocksdb::Env::IOPriority pri) override {
+    if (instance_limiter_) {
+      instance_limiter_->Request(bytes, pri);
+    }
+    BackgroundIoLimiter::Default().Request(BackgroundIoClass::kCompaction, bytes);
+    total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    total_requests_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  int64_t GetSingleBurstBytes() const override {
+    return instance_limiter_ ? instance_limiter_->GetSingleBurstBytes() : 1_MB;
+  }
+
+  int64_t GetTotalBytesThrough(const rocksdb::Env::IOPriority pri) const override {
+    return instance_limiter_ ? instance_limiter_->GetTotalBytesThrough(pri)
+                             : total_bytes_.load(std::memory_order_relaxed);
+  }
+
+  int64_t GetTotalRequests(const rocksdb::Env::IOPriority pri) const override {
+    return instance_limiter_ ? instance_limiter_->GetTotalRequests(pri)
+                             : total_requests_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::unique_ptr<rocksdb::RateLimiter> instance_limiter_;
+  std::atomic<int64_t> total_bytes_{0};
+  std::atomic<int64_t> total_requests_{0};
+};
+
 } // namespace
 
+void InitConcurrentMemTableInserts(rocksdb::Options* options) {
+  if (FLAGS_rocksdb_memtable_insert_threads_per_batch <= 1) {
+    return;
+  }
+  options->allow_concurrent_memtable_write = true;
+  options->memtable_factory = std::make_shared<rocksdb::SkipListFactory>(
+      0 /* lookahead */, rocksdb::ConcurrentWrites::kTrue);
+  options->memtable_insert_thread_pool = MemTableInsertThreadPool();
+  options->max_memtable_insert_threads_per_batch = FLAGS_rocksdb_memtable_insert_threads_per_batch;
+  options->min_memtable_insert_entries_per_thread =
+      std::max(FLAGS_rocksdb_memtable_insert_min_entries_per_thread, 1);
+}
+
+std::shared_ptr<rocksdb::Cache> CreateBlockCache(size_t capacity, int num_shard_bits) {
+  if (FLAGS_db_block_cache_type == "clock") {
+    return rocksdb::NewClockCache(capacity, num_shard_bits);
+  }
+  LOG_IF(DFATAL, FLAGS_db_block_cache_type != "lru")
+      << "Unknown block cache type: " << FLAGS_db_block_cache_type << ", using LRU cache";
+  return rocksdb::NewLRUCache(capacity, num_shard_bits);
+}
+
+std::string ColdRocksDBDir(const std::string& db_dir) {
+  if (FLAGS_rocksdb_cold_data_dir.empty()) {
+    return std::string();
+  }
+  // Keep the table-<id>/tablet-<id> layout of the tablet data directory.
+  return JoinPathSegments(FLAGS_rocksdb_cold_data_dir, BaseName(DirName(db_dir)), BaseName(db_dir));
+}
+
+void InitRocksDBDataPaths(const std::string& db_dir, rocksdb::Options* options) {
+  const auto cold_dir = ColdRocksDBDir(db_dir);
+  if (cold_dir.empty()) {
+    return;
+  }
+  options->db_paths.clear();
+  options->db_paths.emplace_back(db_dir, FLAGS_rocksdb_hot_data_target_size_bytes);
+  options->db_paths.emplace_back(cold_dir, std::numeric_limits<uint64_t>::max());
+}
+
 void InitRocksDBOptions(
     rocksdb::Options* options, const string& log_prefix,
     const shared_ptr<rocksdb::Statistics>& statistics,
@@ -388,6 +582,9 @@ void InitRocksDBOptions(
   options->initial_seqno = FLAGS_initial_seqno;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->compaction_measure_io_stats = FLAGS_rocksdb_compaction_measure_io_stats;
+  options->use_direct_reads = FLAGS_rocksdb_use_direct_reads;
+  options->use_direct_io_for_flush_and_compaction =
+      FLAGS_rocksdb_use_direct_io_for_flush_and_compaction;
   options->memory_monitor = tablet_options.memory_monitor;
   if (FLAGS_db_write_buffer_size != -1) {
     options->write_buffer_size = FLAGS_db_write_buffer_size;
@@ -397,7 +594,8 @@ void InitRocksDBOptions(
   options->env = tablet_options.rocksdb_env;
   options->checkpoint_env = rocksdb::Env::Default();
   static PriorityThreadPool priority_thread_pool_for_compactions_and_flushes(
-      FLAGS_priority_thread_pool_size);
+      FLAGS_priority_thread_pool_size, std::max(FLAGS_priority_thread_pool_reserved_for_flushes, 0),
+      rocksdb::kFlushPriority);
   options->priority_thread_pool_for_compactions_and_flushes =
       &priority_thread_pool_for_compactions_and_flushes;
 
@@ -407,6 +605,11 @@ void InitRocksDBOptions(
 
   options->compression = rocksdb::Snappy_Supported() && FLAGS_enable_ondisk_compression
       ? rocksdb::kSnappyCompression : rocksdb::kNoCompression;
+  if (FLAGS_enable_ondisk_compression && FLAGS_rocksdb_compression_dict_max_bytes > 0 &&
+      rocksdb::CompressionTypeSupportsDictionary(rocksdb::kZlibCompression)) {
+    options->compression = rocksdb::kZlibCompression;
+    options->compression_opts.max_dict_bytes = FLAGS_rocksdb_compression_dict_max_bytes;
+  }
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -416,6 +619,7 @@ void InitRocksDBOptions(
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
     table_options.block_cache = tablet_options.block_cache;
+    table_options.block_cache_compressed = tablet_options.block_cache_compressed;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
   } else {
@@ -435,6 +639,7 @@ void InitRocksDBOptions(
 
   if (FLAGS_use_multi_level_index) {
     table_options.index_type = rocksdb::IndexType::kMultiLevelBinarySearch;
+    table_options.pin_top_level_index = FLAGS_db_pin_top_level_index;
   } else {
     table_options.index_type = rocksdb::IndexType::kBinarySearch;
   }
@@ -467,11 +672,20 @@ void InitRocksDBOptions(
         FLAGS_rocksdb_universal_compaction_always_include_size_threshold;
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
+    // Subcompactions run on threads of their own, so do not let a compaction use more threads than
+    // the number of background compactions allowed.
+    options->max_subcompactions = static_cast<uint32_t>(std::max(1, std::min(
+        FLAGS_rocksdb_max_subcompactions, options->max_background_compactions)));
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
+    std::unique_ptr<rocksdb::RateLimiter> rate_limiter;
     if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
-      options->rate_limiter.reset(
+      rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
     }
+    if (BackgroundIoLimiter::Default().enabled()) {
+      rate_limiter = std::make_unique<BackgroundIoRateLimiter>(std::move(rate_limiter));
+    }
+    options->rate_limiter = std::move(rate_limiter);
   } else {
     options->level0_slowdown_writes_trigger = std::numeric_limits<int>::max();
     options->level0_stop_writes_trigger = std::numeric_limits<int>::max();
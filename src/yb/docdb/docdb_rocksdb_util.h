@@ -56,8 +56,9 @@ KeyBytes AppendDocHt(const Slice& key, const DocHybridTime& doc_ht);
 
 // A wrapper around the RocksDB seek operation that uses Next() up to the configured number of
 // times to avoid invalidating iterator state. In debug mode it also allows printing detailed
-// information about RocksDB seeks.
-void PerformRocksDBSeek(
+// information about RocksDB seeks. Returns the number of the entries before the seek key, that
+// Next() stepped over.
+int PerformRocksDBSeek(
     rocksdb::Iterator *iter,
     const rocksdb::Slice &seek_key,
     const char* file_name,
@@ -105,6 +106,24 @@ std::unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
 // Request RocksDB compaction and wait until it completes.
 void ForceRocksDBCompact(rocksdb::DB* db);
 
+// Creates the block cache shared by RocksDB instances, of the type selected by
+// FLAGS_db_block_cache_type.
+std::shared_ptr<rocksdb::Cache> CreateBlockCache(size_t capacity, int num_shard_bits);
+
+// Returns the directory for cold SST files of the regular RocksDB in db_dir, or an empty string if
+// FLAGS_rocksdb_cold_data_dir is not set.
+std::string ColdRocksDBDir(const std::string& db_dir);
+
+// Sets DB paths of the regular RocksDB in db_dir, so that large compaction outputs are placed in
+// the cold data directory. Does nothing if FLAGS_rocksdb_cold_data_dir is not set.
+void InitRocksDBDataPaths(const std::string& db_dir, rocksdb::Options* options);
+
+// Enables parallel memtable inserts of large write batches, if
+// FLAGS_rocksdb_memtable_insert_threads_per_batch is greater than 1. Should not be used for the
+// intents RocksDB, since intents are erased from its memtable, which requires a memtable without
+// concurrent inserts.
+void InitConcurrentMemTableInserts(rocksdb::Options* options);
+
 // Initialize the RocksDB 'options'.
 // The 'statistics' object provided by the caller will be used by RocksDB to maintain the stats for
 // the tablet.
@@ -11,9 +11,11 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/ql_expr.h"
 #include "yb/common/ql_value.h"
 #include "yb/common/transaction-test-util.h"
@@ -24,6 +26,7 @@
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -31,7 +34,9 @@
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
+DECLARE_bool(docdb_enable_skip_scan);
 DECLARE_bool(docdb_sort_weak_intents_in_tests);
+DECLARE_int32(intents_status_prefetch_max_transactions);
 
 namespace yb {
 namespace docdb {
@@ -58,6 +63,39 @@ class DocRowwiseIteratorTest : public DocDBTestBase {
     ASSERT_OK(kSchemaForIteratorTests.CreateProjectionByNames({"c", "d", "e"},
         &kProjectionForIteratorTests));
   }
+
+  // Writes a separate row by each of num_transactions transactions, leaving the writes as intents,
+  // and commits the transactions at commit_time.
+  void WriteRowsInTransactions(
+      int num_transactions, HybridTime commit_time,
+      TransactionStatusManagerMock* txn_status_manager) {
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    for (int i = 0; i != num_transactions; ++i) {
+      auto txn = TransactionId::GenerateRandom();
+      SetCurrentTransactionId(txn);
+      ASSERT_OK(SetPrimitive(
+          DocPath(DocKey(PrimitiveValues(Format("row$0", i), i)).Encode(),
+                  PrimitiveValue(30_ColId)),
+          PrimitiveValue(Format("value$0", i)), HybridTime::FromMicros(1000)));
+      ResetCurrentTransactionId();
+      txn_status_manager->Commit(txn, commit_time);
+    }
+  }
+
+  Result<std::string> ScanRows(
+      const TransactionOperationContext& txn_context, const ReadHybridTime& read_time) {
+    DocRowwiseIterator iter(
+        kProjectionForIteratorTests, kSchemaForIteratorTests, txn_context, doc_db(),
+        CoarseTimePoint::max() /* deadline */, read_time);
+    RETURN_NOT_OK(iter.Init());
+    std::string result;
+    QLTableRow row;
+    while (VERIFY_RESULT(iter.HasNext())) {
+      RETURN_NOT_OK(iter.NextRow(&row));
+      result += row.ToString(kProjectionForIteratorTests) + "\n";
+    }
+    return result;
+  }
 };
 
 const KeyBytes DocRowwiseIteratorTest::kEncodedDocKey1(
@@ -278,6 +316,85 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorDeletedDocumentTest) {
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorPackedRowTest) {
+  // Column record older than the packed row, it is overwritten by the packed row.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c_old"), HybridTime::FromMicros(500)));
+
+  PackedRowEncoder encoder;
+  encoder.AddColumn(30_ColId, PrimitiveValue("row1_c"));
+  encoder.AddColumn(40_ColId, PrimitiveValue(10000));
+  encoder.AddColumn(50_ColId, PrimitiveValue("row1_e"));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1), encoder.Finish(), HybridTime::FromMicros(1000)));
+  encoder.AddColumn(40_ColId, PrimitiveValue(20000));
+  ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey2), encoder.Finish(), HybridTime::FromMicros(1000)));
+
+  // Column updates after the packed row.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(30000), HybridTime::FromMicros(2000)));
+  ASSERT_OK(DeleteSubDoc(
+      DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)), HybridTime::FromMicros(2000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(1500));
+    ASSERT_OK(iter.Init());
+
+    QLTableRow row;
+    QLValue value;
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("row1_c", value.string_value());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(10000, value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_EQ("row1_e", value.string_value());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_TRUE(value.IsNull());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(20000, value.int64_value());
+
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2500));
+    ASSERT_OK(iter.Init());
+
+    QLTableRow row;
+    QLValue value;
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("row1_c", value.string_value());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(30000, value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(20000, value.int64_value());
+
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTestRowDeletes) {
   auto dwb = MakeDocWriteBatch();
 
@@ -1218,5 +1335,295 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
 }
 
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorNextBatch) {
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000), HybridTime::FromMicros(2000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row2_e"), HybridTime::FromMicros(2000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(3000));
+  ASSERT_OK(iter.Init());
+
+  // Key columns come first, followed by the projection columns.
+  QLColumnBatch batch;
+  ASSERT_EQ(1, ASSERT_RESULT(iter.NextBatch(projection, 1, &batch)));
+  ASSERT_EQ(5, batch.num_columns());
+  ASSERT_EQ(0, batch.FindColumn(10_ColId));
+  ASSERT_EQ(2, batch.FindColumn(30_ColId));
+  ASSERT_EQ("row1", batch.value(0, 0).string_value());
+  ASSERT_EQ(11111, batch.value(1, 0).int64_value());
+  ASSERT_EQ("row1_c", batch.value(2, 0).string_value());
+  ASSERT_EQ(10000, batch.value(3, 0).int64_value());
+  ASSERT_TRUE(QLValue::IsNull(batch.value(4, 0)));
+
+  // The second batch reuses the values allocated by the first one.
+  ASSERT_EQ(1, ASSERT_RESULT(iter.NextBatch(projection, 10, &batch)));
+  ASSERT_EQ("row2", batch.value(0, 0).string_value());
+  ASSERT_EQ(22222, batch.value(1, 0).int64_value());
+  ASSERT_TRUE(QLValue::IsNull(batch.value(2, 0)));
+  ASSERT_EQ(20000, batch.value(3, 0).int64_value());
+  ASSERT_EQ("row2_e", batch.value(4, 0).string_value());
+
+  ASSERT_EQ(0, ASSERT_RESULT(iter.NextBatch(projection, 10, &batch)));
+  ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+}
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorSeekTuple) {
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(40_ColId)),
+      PrimitiveValue(10000), HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(40_ColId)),
+      PrimitiveValue(20000), HybridTime::FromMicros(1000)));
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+  QLValue value;
+
+  // The same iterator is used to fetch several rows by tuple id, as in batched YSQL reads.
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTuple(kEncodedDocKey1.AsSlice())));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(40_ColId, &value));
+  ASSERT_EQ(10000, value.int64_value());
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.SeekTuple(kEncodedDocKey2.AsSlice())));
+  row.Clear();
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(40_ColId, &value));
+  ASSERT_EQ(20000, value.int64_value());
+
+  const KeyBytes missing_key(DocKey(PrimitiveValues("row1", 11112)).Encode());
+  ASSERT_FALSE(ASSERT_RESULT(iter.SeekTuple(missing_key.AsSlice())));
+}
+
+// Compares forward and reverse scan throughput, and checks that both return the same rows.
+TEST_F(DocRowwiseIteratorTest, ForwardAndReverseScanPerf) {
+  constexpr int kNumRows = 2000;
+  for (int i = 0; i != kNumRows; ++i) {
+    const KeyBytes doc_key(DocKey(PrimitiveValues("row", i)).Encode());
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key, PrimitiveValue(30_ColId)), PrimitiveValue("c"),
+        HybridTime::FromMicros(1000)));
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key, PrimitiveValue(40_ColId)), PrimitiveValue(int64_t{i}),
+        HybridTime::FromMicros(1000)));
+  }
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  for (bool is_forward_scan : {true, false}) {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(DocQLScanSpec(
+        schema, boost::none /* hash_code */, boost::none /* max_hash_code */,
+        {} /* hashed_components */, nullptr /* req */, nullptr /* if_req */,
+        rocksdb::kDefaultQueryId, is_forward_scan)));
+
+    const MonoTime start = MonoTime::Now();
+    QLTableRow row;
+    QLValue value;
+    int num_rows = 0;
+    while (ASSERT_RESULT(iter.HasNext())) {
+      row.Clear();
+      ASSERT_OK(iter.NextRow(&row));
+      ASSERT_OK(row.GetValue(40_ColId, &value));
+      ASSERT_EQ(is_forward_scan ? num_rows : kNumRows - 1 - num_rows, value.int64_value());
+      ++num_rows;
+    }
+    const MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
+    ASSERT_EQ(kNumRows, num_rows);
+    LOG(INFO) << (is_forward_scan ? "Forward" : "Reverse") << " scan of " << num_rows
+              << " rows took " << elapsed << ", "
+              << num_rows / std::max(elapsed.ToSeconds(), 1e-6) << " rows/s";
+  }
+}
+
+// Checks that a skip scan, i.e. a scan with IN conditions on all range columns but one, returns the
+// same rows as a full scan of the hash key filtered by these conditions. Without skip scan the
+// iterator would return every row of the hash key.
+TEST_F(DocRowwiseIteratorTest, SkipScan) {
+  FLAGS_docdb_enable_skip_scan = true;
+
+  constexpr int32_t kNumValues = 4;
+  constexpr DocKeyHash kHashCode = 0;
+  const Schema schema({
+          ColumnSchema("h", DataType::INT32, false, true),
+          ColumnSchema("r1", DataType::INT32, false, false, false, false, 1,
+                       ColumnSchema::SortingType::kAscending),
+          ColumnSchema("r2", DataType::INT32, false, false, false, false, 2,
+                       ColumnSchema::SortingType::kAscending),
+          ColumnSchema("r3", DataType::INT32, false, false, false, false, 3,
+                       ColumnSchema::SortingType::kAscending),
+          // Non-key column
+          ColumnSchema("v", DataType::INT32, true)
+      }, {
+          10_ColId,
+          20_ColId,
+          30_ColId,
+          40_ColId,
+          50_ColId
+      }, 4);
+  const std::vector<ColumnId> range_column_ids = {20_ColId, 30_ColId, 40_ColId};
+  const std::vector<PrimitiveValue> hashed_components = {PrimitiveValue::Int32(1)};
+
+  // Row (r1, r2, r3) has v = r1 * 100 + r2 * 10 + r3.
+  for (int32_t r1 = 0; r1 != kNumValues; ++r1) {
+    for (int32_t r2 = 0; r2 != kNumValues; ++r2) {
+      for (int32_t r3 = 0; r3 != kNumValues; ++r3) {
+        const KeyBytes doc_key(DocKey(kHashCode, hashed_components, PrimitiveValues(
+            PrimitiveValue::Int32(r1), PrimitiveValue::Int32(r2),
+            PrimitiveValue::Int32(r3))).Encode());
+        ASSERT_OK(SetPrimitive(
+            DocPath(doc_key, PrimitiveValue(50_ColId)),
+            PrimitiveValue::Int32(r1 * 100 + r2 * 10 + r3), HybridTime::FromMicros(1000)));
+      }
+    }
+  }
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  auto scan = [&](const QLConditionPB* condition, bool is_forward_scan)
+      -> Result<std::vector<int32_t>> {
+    DocQLScanSpec spec(
+        schema, kHashCode, kHashCode, hashed_components, condition, nullptr /* if_req */,
+        rocksdb::kDefaultQueryId, is_forward_scan);
+    DocRowwiseIterator iter(
+        schema, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    RETURN_NOT_OK(iter.Init(spec));
+    std::vector<int32_t> result;
+    QLTableRow row;
+    QLValue value;
+    while (VERIFY_RESULT(iter.HasNext())) {
+      row.Clear();
+      RETURN_NOT_OK(iter.NextRow(&row));
+      RETURN_NOT_OK(row.GetValue(50_ColId, &value));
+      result.push_back(value.int32_value());
+    }
+    return result;
+  };
+
+  // 7 has no rows, so the scan also has to skip over missing options.
+  const std::vector<int32_t> options = {1, 3, 7};
+  for (bool is_forward_scan : {true, false}) {
+    const auto all_rows = ASSERT_RESULT(scan(nullptr /* condition */, is_forward_scan));
+    ASSERT_EQ(static_cast<size_t>(kNumValues * kNumValues * kNumValues), all_rows.size());
+
+    // The open column is the first, the middle and the last range column.
+    for (size_t open_column = 0; open_column != range_column_ids.size(); ++open_column) {
+      QLConditionPB condition;
+      condition.set_op(QL_OP_AND);
+      for (size_t i = 0; i != range_column_ids.size(); ++i) {
+        if (i == open_column) {
+          continue;
+        }
+        auto* in_condition = condition.add_operands()->mutable_condition();
+        in_condition->set_op(QL_OP_IN);
+        in_condition->add_operands()->set_column_id(range_column_ids[i]);
+        auto* list = in_condition->add_operands()->mutable_value()->mutable_list_value();
+        for (int32_t option : options) {
+          list->add_elems()->set_int32_value(option);
+        }
+      }
+
+      std::vector<int32_t> expected_rows;
+      for (int32_t v : all_rows) {
+        const int32_t column_values[] = {v / 100, v / 10 % 10, v % 10};
+        bool matches = true;
+        for (size_t i = 0; i != range_column_ids.size(); ++i) {
+          if (i != open_column && std::find(options.begin(), options.end(), column_values[i]) ==
+                                      options.end()) {
+            matches = false;
+          }
+        }
+        if (matches) {
+          expected_rows.push_back(v);
+        }
+      }
+      ASSERT_EQ(static_cast<size_t>(kNumValues * 2 * 2), expected_rows.size());
+
+      ASSERT_EQ(expected_rows, ASSERT_RESULT(scan(&condition, is_forward_scan)))
+          << "Forward: " << is_forward_scan << ", open column: " << open_column;
+    }
+  }
+}
+
+TEST_F(DocRowwiseIteratorTest, SharedCommitTimeCache) {
+  constexpr int kTransactions = 5;
+  TransactionStatusManagerMock txn_status_manager;
+  ASSERT_NO_FATALS(WriteRowsInTransactions(
+      kTransactions, HybridTime::FromMicros(2000), &txn_status_manager));
+  const auto read_time = ReadHybridTime::FromMicros(3000);
+
+  const TransactionOperationContext txn_context(
+      TransactionId::GenerateRandom(), &txn_status_manager);
+  const auto expected = ASSERT_RESULT(ScanRows(txn_context, read_time));
+  ASSERT_EQ(kTransactions, std::count(expected.begin(), expected.end(), '\n'));
+
+  auto shared_context = txn_context;
+  shared_context.commit_time_cache = std::make_shared<TransactionCommitTimeCache>(read_time);
+  const auto requests = [&txn_status_manager] {
+    return txn_status_manager.NumStatusRequests("get commit time") +
+           txn_status_manager.NumStatusRequests("prefetch commit time");
+  };
+  auto requests_before = requests();
+  ASSERT_EQ(expected, ASSERT_RESULT(ScanRows(shared_context, read_time)));
+  ASSERT_EQ(requests() - requests_before, kTransactions);
+
+  // The second iterator of the same read resolves the transactions from the shared cache.
+  requests_before = requests();
+  ASSERT_EQ(expected, ASSERT_RESULT(ScanRows(shared_context, read_time)));
+  ASSERT_EQ(requests(), requests_before);
+  ASSERT_GE(shared_context.commit_time_cache->hits(), kTransactions);
+
+  // The cache is not used by a read at another time.
+  requests_before = requests();
+  ASSERT_EQ("", ASSERT_RESULT(ScanRows(shared_context, ReadHybridTime::FromMicros(1500))));
+  ASSERT_EQ(requests() - requests_before, kTransactions);
+}
+
+TEST_F(DocRowwiseIteratorTest, PrefetchTransactionStatuses) {
+  constexpr int kTransactions = 5;
+  TransactionStatusManagerMock txn_status_manager;
+  ASSERT_NO_FATALS(WriteRowsInTransactions(
+      kTransactions, HybridTime::FromMicros(2000), &txn_status_manager));
+  const auto read_time = ReadHybridTime::FromMicros(3000);
+  const TransactionOperationContext txn_context(
+      TransactionId::GenerateRandom(), &txn_status_manager);
+
+  FLAGS_intents_status_prefetch_max_transactions = 0;
+  const auto expected = ASSERT_RESULT(ScanRows(txn_context, read_time));
+  ASSERT_EQ(kTransactions, std::count(expected.begin(), expected.end(), '\n'));
+  ASSERT_EQ(txn_status_manager.NumStatusRequests("get commit time"), kTransactions);
+  ASSERT_EQ(txn_status_manager.NumStatusRequests("prefetch commit time"), 0);
+
+  // The first intent of a transaction with unknown status prefetches the statuses of all the
+  // transactions met ahead, so none of them is requested on its own.
+  FLAGS_intents_status_prefetch_max_transactions = 64;
+  ASSERT_EQ(expected, ASSERT_RESULT(ScanRows(txn_context, read_time)));
+  ASSERT_EQ(txn_status_manager.NumStatusRequests("get commit time"), kTransactions);
+  ASSERT_EQ(txn_status_manager.NumStatusRequests("prefetch commit time"), kTransactions);
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -26,17 +26,38 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/storage_metrics.h"
 #include "yb/docdb/value.h"
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/util/backoff_waiter.h"
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/trace.h"
 
 using namespace std::literals;
 
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
 
+DEFINE_int32(max_prevs_to_avoid_seek, 16,
+             "Number of Prev() calls on the regular RocksDB iterator a reverse scan makes to move "
+             "to the previous row before falling back to a Seek.");
+TAG_FLAG(max_prevs_to_avoid_seek, advanced);
+
+DEFINE_int32(intents_status_prefetch_max_transactions, 64,
+             "Maximum number of transactions whose statuses a scan requests at once when it meets "
+             "an intent of a transaction with unknown status. 0 disables the prefetch.");
+TAG_FLAG(intents_status_prefetch_max_transactions, advanced);
+TAG_FLAG(intents_status_prefetch_max_transactions, runtime);
+
+DEFINE_int32(intents_status_prefetch_max_intents, 1024,
+             "Maximum number of intents a scan looks ahead through to find transactions whose "
+             "statuses to prefetch.");
+TAG_FLAG(intents_status_prefetch_max_intents, advanced);
+TAG_FLAG(intents_status_prefetch_max_intents, runtime);
+
 namespace yb {
 namespace docdb {
 
@@ -72,18 +93,106 @@ HybridTime TransactionStatusCache::GetLocalCommitTime(const TransactionId& trans
 }
 
 Result<HybridTime> TransactionStatusCache::GetCommitTime(const TransactionId& transaction_id) {
-  auto it = cache_.find(transaction_id);
-  if (it != cache_.end()) {
-    return it->second;
+  if (shared_cache_) {
+    auto commit_time = shared_cache_->Get(transaction_id);
+    if (commit_time.is_valid()) {
+      return commit_time;
+    }
+  } else {
+    auto it = cache_.find(transaction_id);
+    if (it != cache_.end()) {
+      return it->second;
+    }
   }
 
   auto result = DoGetCommitTime(transaction_id);
   if (result.ok()) {
-    cache_.emplace(transaction_id, *result);
+    Put(transaction_id, *result);
   }
   return result;
 }
 
+bool TransactionStatusCache::Contains(const TransactionId& transaction_id) const {
+  return shared_cache_ ? shared_cache_->Contains(transaction_id)
+                       : cache_.count(transaction_id) != 0;
+}
+
+void TransactionStatusCache::Put(const TransactionId& transaction_id, HybridTime commit_time) {
+  if (shared_cache_) {
+    shared_cache_->Put(transaction_id, commit_time);
+  } else {
+    cache_.emplace(transaction_id, commit_time);
+  }
+}
+
+void TransactionStatusCache::Prefetch(const std::vector<TransactionId>& transaction_ids) {
+  std::vector<const TransactionId*> requested;
+  requested.reserve(transaction_ids.size());
+  for (const auto& transaction_id : transaction_ids) {
+    if (Contains(transaction_id)) {
+      continue;
+    }
+    HybridTime local_commit_time = GetLocalCommitTime(transaction_id);
+    if (local_commit_time.is_valid()) {
+      Put(transaction_id, local_commit_time);
+    } else {
+      requested.push_back(&transaction_id);
+    }
+  }
+  if (requested.empty()) {
+    return;
+  }
+
+  static const std::string kRequestReason = "prefetch commit time"s;
+  std::vector<Result<TransactionStatusResult>> results(
+      requested.size(), STATUS(Incomplete, "Status not received"));
+  CountDownLatch latch(requested.size());
+  for (size_t i = 0; i != requested.size(); ++i) {
+    auto callback = [&results, &latch, i](Result<TransactionStatusResult> result) {
+      results[i] = std::move(result);
+      latch.CountDown();
+    };
+    txn_status_manager_->RequestStatusAt(
+        {requested[i], read_time_.read, read_time_.global_limit, read_time_.serial_no,
+              &kRequestReason,
+              TransactionLoadFlags{TransactionLoadFlag::kMustExist, TransactionLoadFlag::kCleanup},
+              callback});
+  }
+  latch.Wait();
+
+  for (size_t i = 0; i != requested.size(); ++i) {
+    const auto& transaction_id = *requested[i];
+    auto& result = results[i];
+    if (result.ok()) {
+      Put(transaction_id, StatusToCommitTime(transaction_id, *result));
+    } else if (result.status().IsNotFound()) {
+      LOG(WARNING) << "Intent for transaction w/o metadata: " << transaction_id;
+      Put(transaction_id, HybridTime::kMin);
+    } else {
+      // Left for GetCommitTime to retry.
+      VLOG(4) << "Failed to prefetch transaction " << transaction_id << " status: "
+              << result.status();
+    }
+  }
+}
+
+HybridTime TransactionStatusCache::StatusToCommitTime(
+    const TransactionId& transaction_id, const TransactionStatusResult& txn_status) {
+  VLOG(4) << "Transaction_id " << transaction_id << " at " << read_time_
+          << ": status: " << TransactionStatus_Name(txn_status.status)
+          << ", status_time: " << txn_status.status_time;
+  // There could be case when transaction was committed and applied between previous call to
+  // GetLocalCommitTime, in this case coordinator does not know transaction and will respond
+  // with ABORTED status. So we recheck whether it was committed locally.
+  if (txn_status.status == TransactionStatus::ABORTED) {
+    auto local_commit_time = GetLocalCommitTime(transaction_id);
+    return local_commit_time.is_valid() ? local_commit_time : HybridTime::kMin;
+  } else {
+    return txn_status.status == TransactionStatus::COMMITTED ? txn_status.status_time
+        : HybridTime::kMin;
+  }
+}
+
 Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId& transaction_id) {
   HybridTime local_commit_time = GetLocalCommitTime(transaction_id);
   if (local_commit_time.is_valid()) {
@@ -127,19 +236,7 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
       return STATUS(TimedOut, "");
     }
   }
-  VLOG(4) << "Transaction_id " << transaction_id << " at " << read_time_
-          << ": status: " << TransactionStatus_Name(txn_status.status)
-          << ", status_time: " << txn_status.status_time;
-  // There could be case when transaction was committed and applied between previous call to
-  // GetLocalCommitTime, in this case coordinator does not know transaction and will respond
-  // with ABORTED status. So we recheck whether it was committed locally.
-  if (txn_status.status == TransactionStatus::ABORTED) {
-    local_commit_time = GetLocalCommitTime(transaction_id);
-    return local_commit_time.is_valid() ? local_commit_time : HybridTime::kMin;
-  } else {
-    return txn_status.status == TransactionStatus::COMMITTED ? txn_status.status_time
-        : HybridTime::kMin;
-  }
+  return StatusToCommitTime(transaction_id, txn_status);
 }
 
 namespace {
@@ -165,15 +262,25 @@ std::ostream& operator<<(std::ostream& out, const DecodeStrongWriteIntentResult&
   return out << result.ToString();
 }
 
+struct NoStatusMissHandler {
+  bool operator()(const TransactionId&) const {
+    return false;
+  }
+};
+
 // Decodes intent based on intent_iterator and its transaction commit time if intent is a strong
 // write intent, intent is not for row locking, and transaction is already committed at specified
 // time or is current transaction.
 // Returns HybridTime::kMin as value_time otherwise.
 // For current transaction returns intent record hybrid time as value_time.
 // Consumes intent from value_slice leaving only value itself.
+// When status of the transaction is not cached yet, calls on_status_miss with its id before
+// resolving it. on_status_miss returns whether it moved intent_iter, it should return it back to
+// the same entry in this case.
+template <class OnStatusMiss>
 Result<DecodeStrongWriteIntentResult> DecodeStrongWriteIntent(
     TransactionOperationContext txn_op_context, rocksdb::Iterator* intent_iter,
-    TransactionStatusCache* transaction_status_cache) {
+    TransactionStatusCache* transaction_status_cache, const OnStatusMiss& on_status_miss) {
   DecodeStrongWriteIntentResult result;
   auto decoded_intent_key = VERIFY_RESULT(DecodeIntentKey(intent_iter->key()));
   result.intent_prefix = decoded_intent_key.intent_prefix;
@@ -195,6 +302,11 @@ Result<DecodeStrongWriteIntentResult> DecodeStrongWriteIntent(
     } else if (result.same_transaction) {
       result.value_time = decoded_intent_key.doc_ht;
     } else {
+      if (!transaction_status_cache->Contains(txn_id) && on_status_miss(txn_id)) {
+        // Moving intent_iter invalidates slices of the current entry, so decode it again.
+        return DecodeStrongWriteIntent(
+            txn_op_context, intent_iter, transaction_status_cache, NoStatusMissHandler());
+      }
       auto commit_ht = VERIFY_RESULT(transaction_status_cache->GetCommitTime(txn_id));
       result.value_time = DocHybridTime(
           commit_ht, commit_ht != HybridTime::kMin ? in_txn_write_id : 0);
@@ -245,10 +357,17 @@ IntentAwareIterator::IntentAwareIterator(
           DocHybridTime(read_time_.global_limit, kMaxWriteId).EncodedInDocDbFormat()),
       txn_op_context_(txn_op_context),
       transaction_status_cache_(
-          txn_op_context ? &txn_op_context->txn_status_manager : nullptr, read_time, deadline) {
+          txn_op_context ? &txn_op_context->txn_status_manager : nullptr, read_time, deadline,
+          txn_op_context ? txn_op_context->commit_time_cache.get() : nullptr) {
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
           << ", txn_op_context: " << txn_op_context_;
 
+  span_ = TraceSpan::StartChild(Trace::CurrentSpan(), "IntentAwareIterator");
+  if (span_) {
+    span_->SetAttribute("read_time", read_time.ToString());
+    span_->SetAttribute("transactional", txn_op_context.is_initialized() ? "true" : "false");
+  }
+
   if (txn_op_context.is_initialized()) {
     intent_iter_ = docdb::CreateRocksDBIterator(doc_db.intents,
                                                 doc_db.key_bounds,
@@ -449,19 +568,37 @@ Status IntentAwareIterator::NextFullValue(
   return status_;
 }
 
-bool IntentAwareIterator::PreparePrev(const Slice& key) {
-  ROCKSDB_SEEK(&iter_, key);
-
-  if (iter_.Valid()) {
+bool IntentAwareIterator::PrevRegularWithoutSeek(const Slice& key) {
+  if (!iter_.Valid() || iter_.key().compare(key) < 0) {
+    return false;
+  }
+  for (int prevs = 0; prevs < FLAGS_max_prevs_to_avoid_seek; ++prevs) {
     iter_.Prev();
-  } else {
-    iter_.SeekToLast();
+    if (!iter_.Valid() || iter_.key().compare(key) < 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IntentAwareIterator::PreparePrev(const Slice& key) {
+  // The regular iterator is usually positioned right after the row that was just read, so it is
+  // cheaper to step back to the previous row than to seek.
+  prev_key_buffer_.Reset(key);
+  if (!PrevRegularWithoutSeek(prev_key_buffer_.AsSlice())) {
+    ROCKSDB_SEEK(&iter_, prev_key_buffer_.AsSlice());
+
+    if (iter_.Valid()) {
+      iter_.Prev();
+    } else {
+      iter_.SeekToLast();
+    }
   }
   SkipFutureRecords(Direction::kBackward);
 
   if (intent_iter_.Initialized()) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(&intent_iter_, GetIntentPrefixForKeyWithoutHt(key));
+    ROCKSDB_SEEK(&intent_iter_, GetIntentPrefixForKeyWithoutHt(prev_key_buffer_.AsSlice()));
     if (intent_iter_.Valid()) {
       intent_iter_.Prev();
     } else {
@@ -521,7 +658,29 @@ void IntentAwareIterator::SeekToLatestDocKeyInternal() {
     status_ = dockey_size.status();
     return;
   }
-  Seek(Slice(subdockey_slice.data(), *dockey_size));
+  SeekBackward(Slice(subdockey_slice.data(), *dockey_size));
+}
+
+void IntentAwareIterator::SeekBackward(const Slice& key) {
+  VLOG(4) << "SeekBackward(" << SubDocKey::DebugSliceToString(key) << ")";
+  if (!status_.ok()) {
+    return;
+  }
+
+  // The key could point into the current entry of the regular iterator, so copy it before moving.
+  prev_key_buffer_.Reset(key);
+  const Slice key_copy = prev_key_buffer_.AsSlice();
+  if (PrevRegularWithoutSeek(key_copy) && iter_.Valid()) {
+    iter_.Next();
+  } else {
+    ROCKSDB_SEEK(&iter_, key_copy);
+  }
+  skip_future_records_needed_ = true;
+
+  if (intent_iter_.Initialized()) {
+    seek_intent_iter_needed_ = SeekIntentIterNeeded::kSeek;
+    GetIntentPrefixForKeyWithoutHt(key_copy, &seek_key_buffer_);
+  }
 }
 
 void IntentAwareIterator::SeekIntentIterIfNeeded() {
@@ -616,8 +775,12 @@ bool IntentAwareIterator::SatisfyBounds(const Slice& slice) {
 }
 
 void IntentAwareIterator::ProcessIntent() {
+  ++docdb_perf_context.intents;
   auto decode_result = DecodeStrongWriteIntent(
-      txn_op_context_.get(), &intent_iter_, &transaction_status_cache_);
+      txn_op_context_.get(), &intent_iter_, &transaction_status_cache_,
+      [this](const TransactionId& transaction_id) {
+        return PrefetchTransactionStatuses(transaction_id);
+      });
   if (!decode_result.ok()) {
     status_ = decode_result.status();
     return;
@@ -669,6 +832,51 @@ void IntentAwareIterator::ProcessIntent() {
   resolved_intent_value_.Reset(decode_result->intent_value);
 }
 
+bool IntentAwareIterator::PrefetchTransactionStatuses(const TransactionId& transaction_id) {
+  const size_t max_transactions = std::max(FLAGS_intents_status_prefetch_max_transactions, 0);
+  if (max_transactions <= 1) {
+    return false;
+  }
+  std::vector<TransactionId> transaction_ids;
+  transaction_ids.push_back(transaction_id);
+
+  // Intents of the following keys are resolved by the same scan unless it stops earlier, so look
+  // ahead through them and return intent_iter_ back afterwards.
+  prefetch_key_buffer_.Reset(intent_iter_.key());
+  auto prefix = prefix_stack_.empty() ? Slice() : prefix_stack_.back();
+  int intents_left = FLAGS_intents_status_prefetch_max_intents;
+  for (intent_iter_.Next();
+       intent_iter_.Valid() && intents_left > 0 && transaction_ids.size() < max_transactions;
+       intent_iter_.Next(), --intents_left) {
+    auto intent_key = intent_iter_.key();
+    if (intent_key[0] == ValueTypeAsChar::kTransactionId ||
+        !intent_key.starts_with(prefix) || !SatisfyBounds(intent_key)) {
+      break;
+    }
+    auto decoded_intent_key = DecodeIntentKey(intent_key);
+    if (!decoded_intent_key.ok() ||
+        !decoded_intent_key->intent_types.Test(IntentType::kStrongWrite)) {
+      continue;
+    }
+    auto intent_value = intent_iter_.value();
+    auto txn_id = DecodeTransactionIdFromIntentValue(&intent_value);
+    if (!txn_id.ok() || *txn_id == txn_op_context_->transaction_id ||
+        transaction_status_cache_.Contains(*txn_id) ||
+        std::find(transaction_ids.begin(), transaction_ids.end(), *txn_id) !=
+            transaction_ids.end()) {
+      continue;
+    }
+    transaction_ids.push_back(*txn_id);
+  }
+  ROCKSDB_SEEK(&intent_iter_, prefetch_key_buffer_.AsSlice());
+
+  if (transaction_ids.size() > 1) {
+    VLOG(4) << "Prefetching statuses of " << transaction_ids.size() << " transactions";
+    transaction_status_cache_.Prefetch(transaction_ids);
+  }
+  return true;
+}
+
 void IntentAwareIterator::UpdateResolvedIntentSubDocKeyEncoded() {
   resolved_intent_sub_doc_key_encoded_.Reset(resolved_intent_key_prefix_.AsSlice());
   resolved_intent_sub_doc_key_encoded_.AppendValueType(ValueType::kHybridTime);
@@ -998,6 +1206,7 @@ void IntentAwareIterator::SkipFutureRecords(const Direction direction) {
     }
     VLOG(4) << "Skipping because of time: " << SubDocKey::DebugSliceToString(iter_.key())
             << ", read time: " << read_time_;
+    ++docdb_perf_context.versions_skipped;
     switch (direction) {
       case Direction::kForward:
         iter_.Next(); // TODO(dtxn) use seek with the same key, but read limit as doc hybrid time.
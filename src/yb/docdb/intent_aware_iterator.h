@@ -25,6 +25,8 @@
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/options.h"
 
+#include "yb/util/trace_span.h"
+
 namespace yb {
 
 class DocHybridTime;
@@ -45,20 +47,41 @@ class TransactionStatusCache {
  public:
   TransactionStatusCache(TransactionStatusManager* txn_status_manager,
                          const ReadHybridTime& read_time,
-                         CoarseTimePoint deadline)
-      : txn_status_manager_(txn_status_manager), read_time_(read_time), deadline_(deadline) {}
+                         CoarseTimePoint deadline,
+                         TransactionCommitTimeCache* shared_cache = nullptr)
+      : txn_status_manager_(txn_status_manager), read_time_(read_time), deadline_(deadline),
+        shared_cache_(shared_cache && shared_cache->Matches(read_time) ? shared_cache : nullptr) {}
 
   // Returns transaction commit time if already committed by the specified time or HybridTime::kMin
   // otherwise.
   Result<HybridTime> GetCommitTime(const TransactionId& transaction_id);
 
+  // Whether commit time of the transaction is already cached.
+  bool Contains(const TransactionId& transaction_id) const;
+
+  // Requests statuses of all specified transactions that are not cached yet at once and waits for
+  // all of them, so resolving them costs a single round trip instead of one per transaction.
+  // Resolved commit times are cached, failed requests are not, so GetCommitTime retries them.
+  void Prefetch(const std::vector<TransactionId>& transaction_ids);
+
+  void SetDeadline(CoarseTimePoint deadline) {
+    deadline_ = deadline;
+  }
+
  private:
   HybridTime GetLocalCommitTime(const TransactionId& transaction_id);
   Result<HybridTime> DoGetCommitTime(const TransactionId& transaction_id);
+  // Converts received transaction status to commit time at read time.
+  HybridTime StatusToCommitTime(
+      const TransactionId& transaction_id, const TransactionStatusResult& txn_status);
+  void Put(const TransactionId& transaction_id, HybridTime commit_time);
 
   TransactionStatusManager* txn_status_manager_;
   ReadHybridTime read_time_;
   CoarseTimePoint deadline_;
+  // Cache shared with other iterators of the same read operation, used instead of cache_ when
+  // present.
+  TransactionCommitTimeCache* shared_cache_;
   std::unordered_map<TransactionId, HybridTime, TransactionIdHash> cache_;
 };
 
@@ -96,6 +119,11 @@ class IntentAwareIterator {
   IntentAwareIterator(const IntentAwareIterator& other) = delete;
   void operator=(const IntentAwareIterator& other) = delete;
 
+  // Updates the deadline for resolving statuses of transactions.
+  void SetDeadline(CoarseTimePoint deadline) {
+    transaction_status_cache_.SetDeadline(deadline);
+  }
+
   // Seek to the smallest key which is greater or equal than doc_key.
   void Seek(const DocKey& doc_key);
 
@@ -189,6 +217,15 @@ class IntentAwareIterator {
 
   // Seek to latest doc key among regular and intent iterator.
   void SeekToLatestDocKeyInternal();
+
+  // Same as Seek, but expects the regular iterator to be positioned a few records after the key,
+  // and moves it back with Prev() instead of seeking when possible.
+  void SeekBackward(const Slice& key);
+
+  // Moves the regular iterator to the last record before key with at most max_prevs_to_avoid_seek
+  // Prev() calls. Returns false when the iterator was not positioned at or after key or the record
+  // was not reached, in which case seek should be used.
+  bool PrevRegularWithoutSeek(const Slice& key);
   // Seek to latest subdoc key among regular and intent iterator.
   void SeekToLatestSubDocKeyInternal();
 
@@ -240,6 +277,13 @@ class IntentAwareIterator {
   // calling UpdateResolvedIntentSubDocKeyEncoded.
   void ProcessIntent();
 
+  // Called when status of the transaction that wrote intent at intent_iter_ position is not cached.
+  // Looks ahead through the following intents within the scan bounds and prefetches statuses of
+  // all other transactions found there together with this one, so a scan over intents of many
+  // transactions does not wait for a separate status round trip per transaction.
+  // Returns true if intent_iter_ was moved, it is positioned back to the same intent then.
+  bool PrefetchTransactionStatuses(const TransactionId& transaction_id);
+
   void UpdateResolvedIntentSubDocKeyEncoded();
 
   // Seeks to the appropriate intent-prefix and returns the associated
@@ -324,6 +368,16 @@ class IntentAwareIterator {
 
   // Reusable buffer to prepare seek key to avoid reallocating temporary buffers in critical paths.
   KeyBytes seek_key_buffer_;
+
+  // Key of the intent to return intent_iter_ to after looking ahead for status prefetch.
+  KeyBytes prefetch_key_buffer_;
+
+  // Copy of the target key of a backward move, since it could point into the current entry.
+  KeyBytes prev_key_buffer_;
+
+  // Times the iteration when the read is done for a sampled request, ends when the iterator is
+  // destroyed.
+  TraceSpanPtr span_;
 };
 
 // Utility class that controls stack of prefixes in IntentAwareIterator.
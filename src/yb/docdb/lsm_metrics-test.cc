@@ -0,0 +1,58 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/lsm_metrics.h"
+
+#include "yb/rocksdb/metadata.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+rocksdb::SstFileMetaData File(uint64_t size) {
+  rocksdb::SstFileMetaData result;
+  result.total_size = size;
+  return result;
+}
+
+} // namespace
+
+class LsmMetricsTest : public YBTest {
+};
+
+TEST_F(LsmMetricsTest, Shape) {
+  std::vector<rocksdb::LevelMetaData> levels;
+  levels.emplace_back(0, 30, std::vector<rocksdb::SstFileMetaData>{File(10), File(20)});
+  levels.emplace_back(1, 0, std::vector<rocksdb::SstFileMetaData>{});
+  levels.emplace_back(2, 70, std::vector<rocksdb::SstFileMetaData>{File(30), File(40)});
+  rocksdb::ColumnFamilyMetaData metadata("default", 100, std::move(levels));
+
+  auto shape = LsmShapeOf(metadata);
+  // Each file of level 0 is a run, the empty level is not.
+  ASSERT_EQ(3u, shape.sorted_runs.size());
+  ASSERT_EQ(100u, shape.total_bytes);
+  ASSERT_EQ(0, shape.sorted_runs[1].level);
+  ASSERT_EQ(20u, shape.sorted_runs[1].size_bytes);
+  ASSERT_EQ(2, shape.sorted_runs[2].level);
+  ASSERT_EQ(2u, shape.sorted_runs[2].num_files);
+  ASSERT_EQ(70u, shape.sorted_runs[2].size_bytes);
+  ASSERT_DOUBLE_EQ(100.0 / 70, shape.SpaceAmplification());
+
+  ASSERT_DOUBLE_EQ(1, LsmShape().SpaceAmplification());
+}
+
+} // namespace docdb
+} // namespace yb
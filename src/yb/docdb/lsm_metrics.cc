@@ -0,0 +1,170 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/lsm_metrics.h"
+
+#include "yb/gutil/bind.h"
+#include "yb/gutil/strings/human_readable.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/metadata.h"
+
+#include "yb/util/format.h"
+
+METRIC_DEFINE_counter(tablet, rocksdb_lsm_flush_bytes, "LSM Flushed Bytes",
+                      yb::MetricUnit::kBytes,
+                      "Bytes of SST files written by the flushes of the regular RocksDB");
+METRIC_DEFINE_counter(tablet, rocksdb_lsm_compaction_input_bytes, "LSM Compaction Input Bytes",
+                      yb::MetricUnit::kBytes,
+                      "Bytes of SST files read by the compactions of the regular RocksDB");
+METRIC_DEFINE_counter(tablet, rocksdb_lsm_compaction_output_bytes, "LSM Compaction Output Bytes",
+                      yb::MetricUnit::kBytes,
+                      "Bytes of SST files written by the compactions of the regular RocksDB");
+METRIC_DEFINE_gauge_double(tablet, rocksdb_lsm_write_amplification, "LSM Write Amplification",
+                           yb::MetricUnit::kUnits,
+                           "Ratio of the bytes written by the flushes and compactions of the "
+                           "regular RocksDB to the bytes written by its flushes");
+METRIC_DEFINE_gauge_uint64(tablet, rocksdb_lsm_sorted_runs, "LSM Sorted Runs",
+                           yb::MetricUnit::kUnits,
+                           "Number of sorted runs of the regular RocksDB, i.e. the number of the "
+                           "files a point read consults before the bloom filters");
+METRIC_DEFINE_gauge_double(tablet, rocksdb_lsm_space_amplification, "LSM Space Amplification",
+                           yb::MetricUnit::kUnits,
+                           "Ratio of the size of the regular RocksDB to the size of its oldest "
+                           "sorted run");
+
+namespace yb {
+namespace docdb {
+
+double LsmShape::SpaceAmplification() const {
+  if (sorted_runs.empty() || sorted_runs.back().size_bytes == 0) {
+    return 1;
+  }
+  return static_cast<double>(total_bytes) / sorted_runs.back().size_bytes;
+}
+
+std::string LsmShape::ToString() const {
+  std::string result;
+  for (const auto& run : sorted_runs) {
+    if (!result.empty()) {
+      result += ", ";
+    }
+    result += Format("L$0", run.level);
+    if (run.num_files != 1) {
+      result += Format(" ($0 files)", run.num_files);
+    }
+    result += ": " + HumanReadableNumBytes::ToString(run.size_bytes);
+  }
+  return result;
+}
+
+LsmShape LsmShapeOf(const rocksdb::ColumnFamilyMetaData& metadata) {
+  LsmShape result;
+  for (const auto& level : metadata.levels) {
+    if (level.files.empty()) {
+      continue;
+    }
+    if (level.level == 0) {
+      // Each file of level 0 is a sorted run, the newest files go first.
+      for (const auto& file : level.files) {
+        result.sorted_runs.push_back(LsmSortedRun{0, 1, file.total_size});
+        result.total_bytes += file.total_size;
+      }
+      continue;
+    }
+    LsmSortedRun run{level.level, level.files.size(), 0};
+    for (const auto& file : level.files) {
+      run.size_bytes += file.total_size;
+    }
+    result.total_bytes += run.size_bytes;
+    result.sorted_runs.push_back(run);
+  }
+  return result;
+}
+
+LsmMetricsListener::LsmMetricsListener(const scoped_refptr<MetricEntity>& metric_entity) {
+  if (!metric_entity) {
+    return;
+  }
+  flush_bytes_counter_ = METRIC_rocksdb_lsm_flush_bytes.Instantiate(metric_entity);
+  compaction_input_bytes_counter_ =
+      METRIC_rocksdb_lsm_compaction_input_bytes.Instantiate(metric_entity);
+  compaction_output_bytes_counter_ =
+      METRIC_rocksdb_lsm_compaction_output_bytes.Instantiate(metric_entity);
+  METRIC_rocksdb_lsm_write_amplification.InstantiateFunctionGauge(
+      metric_entity, Bind(&LsmMetricsListener::WriteAmplification, Unretained(this)))
+    ->AutoDetachToLastValue(&metric_detacher_);
+  METRIC_rocksdb_lsm_sorted_runs.InstantiateFunctionGauge(
+      metric_entity, Bind(&LsmMetricsListener::NumSortedRuns, Unretained(this)))
+    ->AutoDetachToLastValue(&metric_detacher_);
+  METRIC_rocksdb_lsm_space_amplification.InstantiateFunctionGauge(
+      metric_entity, Bind(&LsmMetricsListener::SpaceAmplification, Unretained(this)))
+    ->AutoDetachToLastValue(&metric_detacher_);
+}
+
+LsmMetricsListener::~LsmMetricsListener() {}
+
+void LsmMetricsListener::OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) {
+  const auto& properties = info.table_properties;
+  const auto bytes = properties.data_size + properties.data_index_size + properties.filter_size +
+                     properties.filter_index_size;
+  flushed_bytes_.fetch_add(bytes, std::memory_order_acq_rel);
+  IncrementCounterBy(flush_bytes_counter_, bytes);
+  UpdateShape(db);
+}
+
+void LsmMetricsListener::OnCompactionCompleted(
+    rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) {
+  if (!info.status.ok()) {
+    return;
+  }
+  compaction_input_bytes_.fetch_add(info.stats.total_input_bytes, std::memory_order_acq_rel);
+  compaction_output_bytes_.fetch_add(info.stats.total_output_bytes, std::memory_order_acq_rel);
+  IncrementCounterBy(compaction_input_bytes_counter_, info.stats.total_input_bytes);
+  IncrementCounterBy(compaction_output_bytes_counter_, info.stats.total_output_bytes);
+  UpdateShape(db);
+}
+
+void LsmMetricsListener::UpdateShape(rocksdb::DB* db) {
+  rocksdb::ColumnFamilyMetaData metadata;
+  db->GetColumnFamilyMetaData(&metadata);
+  auto shape = LsmShapeOf(metadata);
+  std::lock_guard<std::mutex> lock(mutex_);
+  shape_ = std::move(shape);
+}
+
+LsmShape LsmMetricsListener::shape() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return shape_;
+}
+
+double LsmMetricsListener::WriteAmplification() const {
+  const auto flushed = flushed_bytes();
+  if (flushed == 0) {
+    return 1;
+  }
+  return static_cast<double>(flushed + compaction_output_bytes()) / flushed;
+}
+
+uint64_t LsmMetricsListener::NumSortedRuns() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return shape_.sorted_runs.size();
+}
+
+double LsmMetricsListener::SpaceAmplification() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return shape_.SpaceAmplification();
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,112 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_LSM_METRICS_H
+#define YB_DOCDB_LSM_METRICS_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/listener.h"
+
+#include "yb/util/metrics.h"
+
+namespace rocksdb {
+
+struct ColumnFamilyMetaData;
+
+} // namespace rocksdb
+
+namespace yb {
+namespace docdb {
+
+// A sorted run of the LSM tree, i.e. a file of level 0 or a whole lower level. A point read
+// consults a file of each sorted run, unless it is skipped by its key range or bloom filter.
+struct LsmSortedRun {
+  int level = 0;
+  size_t num_files = 0;
+  uint64_t size_bytes = 0;
+};
+
+// Shape of the LSM tree of a RocksDB instance, the newest sorted runs first.
+struct LsmShape {
+  std::vector<LsmSortedRun> sorted_runs;
+  uint64_t total_bytes = 0;
+
+  // Ratio of the total size to the size of the oldest sorted run, that has all the data after a
+  // full compaction. 1 if there is no data.
+  double SpaceAmplification() const;
+
+  std::string ToString() const;
+};
+
+LsmShape LsmShapeOf(const rocksdb::ColumnFamilyMetaData& metadata);
+
+// Feeds the metrics of the health of the LSM tree of a RocksDB instance to the metric entity of
+// its tablet on each flush and compaction: the write amplification by the compactions, the number
+// of sorted runs, bounding the number of files a point read consults, and the space amplification.
+class LsmMetricsListener : public rocksdb::EventListener {
+ public:
+  // The metric entity could be null, e.g. in tests, then only the accessors are updated.
+  explicit LsmMetricsListener(const scoped_refptr<MetricEntity>& metric_entity);
+  ~LsmMetricsListener();
+
+  void OnFlushCompleted(rocksdb::DB* db, const rocksdb::FlushJobInfo& info) override;
+
+  void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo& info) override;
+
+  // Updates the shape from the current files of the db, e.g. after it was opened.
+  void UpdateShape(rocksdb::DB* db);
+
+  LsmShape shape() const;
+
+  // Ratio of the bytes written by the flushes and compactions to the bytes written by the
+  // flushes, since the listener was created. 1 if nothing was flushed.
+  double WriteAmplification() const;
+
+  uint64_t NumSortedRuns() const;
+
+  double SpaceAmplification() const;
+
+  uint64_t flushed_bytes() const {
+    return flushed_bytes_.load(std::memory_order_acquire);
+  }
+
+  uint64_t compaction_input_bytes() const {
+    return compaction_input_bytes_.load(std::memory_order_acquire);
+  }
+
+  uint64_t compaction_output_bytes() const {
+    return compaction_output_bytes_.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::atomic<uint64_t> flushed_bytes_{0};
+  std::atomic<uint64_t> compaction_input_bytes_{0};
+  std::atomic<uint64_t> compaction_output_bytes_{0};
+
+  mutable std::mutex mutex_;
+  LsmShape shape_;
+
+  scoped_refptr<Counter> flush_bytes_counter_;
+  scoped_refptr<Counter> compaction_input_bytes_counter_;
+  scoped_refptr<Counter> compaction_output_bytes_counter_;
+  FunctionGaugeDetacher metric_detacher_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_LSM_METRICS_H
@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/value.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class PackedRowTest : public YBTest {
+};
+
+TEST_F(PackedRowTest, TestEncodeDecode) {
+  PackedRowEncoder encoder;
+  encoder.AddColumn(ColumnId(30), PrimitiveValue("thirty"));
+  encoder.AddColumn(ColumnId(10), PrimitiveValue::Int32(10));
+  encoder.AddColumn(ColumnId(20), PrimitiveValue(int64_t{2000}));
+  const PrimitiveValue packed_row = encoder.Finish();
+  ASSERT_EQ(ValueType::kPackedRow, packed_row.value_type());
+
+  // Packed row should survive the value encoding round trip.
+  Value decoded_value;
+  ASSERT_OK(decoded_value.Decode(Value(packed_row).Encode()));
+  ASSERT_EQ(packed_row, decoded_value.primitive_value());
+
+  PackedRowDecoder decoder;
+  ASSERT_OK(decoder.Init(decoded_value.primitive_value().GetPackedRow()));
+  ASSERT_EQ(3, decoder.num_columns());
+  ASSERT_EQ(ColumnId(10), decoder.column_id(0));
+  ASSERT_EQ(ColumnId(20), decoder.column_id(1));
+  ASSERT_EQ(ColumnId(30), decoder.column_id(2));
+  ASSERT_EQ(PackedRowDecoder::kColumnNotFound, decoder.FindColumn(ColumnId(15)));
+  ASSERT_EQ(PackedRowDecoder::kColumnNotFound, decoder.FindColumn(ColumnId(40)));
+
+  PrimitiveValue value;
+  ASSERT_OK(decoder.DecodeColumn(decoder.FindColumn(ColumnId(10)), &value));
+  ASSERT_EQ(PrimitiveValue::Int32(10), value);
+  ASSERT_OK(decoder.DecodeColumn(decoder.FindColumn(ColumnId(20)), &value));
+  ASSERT_EQ(PrimitiveValue(int64_t{2000}), value);
+  ASSERT_OK(decoder.DecodeColumn(decoder.FindColumn(ColumnId(30)), &value));
+  ASSERT_EQ(PrimitiveValue("thirty"), value);
+}
+
+TEST_F(PackedRowTest, TestEmptyAndCorrupted) {
+  PackedRowEncoder encoder;
+  const PrimitiveValue packed_row = encoder.Finish();
+  PackedRowDecoder decoder;
+  ASSERT_OK(decoder.Init(packed_row.GetPackedRow()));
+  ASSERT_EQ(0, decoder.num_columns());
+
+  encoder.AddColumn(ColumnId(10), PrimitiveValue("ten"));
+  const std::string packed = encoder.Finish().GetPackedRow();
+  ASSERT_NOK(decoder.Init(Slice(packed.data(), 2)));
+  ASSERT_NOK(decoder.Init(Slice(packed.data(), packed.size() - 1)));
+}
+
+}  // namespace docdb
+}  // namespace yb
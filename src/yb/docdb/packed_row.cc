@@ -0,0 +1,122 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include <algorithm>
+
+#include "yb/gutil/endian.h"
+#include "yb/util/kv_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr size_t kHeaderEntrySize = 2 * sizeof(uint32_t);
+
+} // namespace
+
+void PackedRowEncoder::AddColumn(ColumnId column_id, const PrimitiveValue& value) {
+  columns_.emplace_back(column_id, value.ToValue());
+}
+
+PrimitiveValue PackedRowEncoder::Finish() {
+  std::sort(columns_.begin(), columns_.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+  size_t data_size = 0;
+  for (const auto& column : columns_) {
+    data_size += column.second.size();
+  }
+
+  std::string result;
+  result.reserve(sizeof(uint32_t) + columns_.size() * kHeaderEntrySize + data_size);
+  util::AppendBigEndianUInt32(columns_.size(), &result);
+  uint32_t end_offset = 0;
+  for (const auto& column : columns_) {
+    end_offset += column.second.size();
+    util::AppendBigEndianUInt32(column.first.rep(), &result);
+    util::AppendBigEndianUInt32(end_offset, &result);
+  }
+  for (const auto& column : columns_) {
+    result.append(column.second);
+  }
+  columns_.clear();
+  return PrimitiveValue::PackedRow(std::move(result));
+}
+
+Status PackedRowDecoder::Init(const Slice& packed_row) {
+  if (packed_row.size() < sizeof(uint32_t)) {
+    return STATUS_FORMAT(Corruption, "Packed row is too short: $0", packed_row.size());
+  }
+  num_columns_ = BigEndian::Load32(packed_row.data());
+  const size_t header_size = num_columns_ * kHeaderEntrySize;
+  if (packed_row.size() < sizeof(uint32_t) + header_size) {
+    return STATUS_FORMAT(
+        Corruption, "Packed row header of $0 columns does not fit into $1 bytes", num_columns_,
+        packed_row.size());
+  }
+  header_ = Slice(packed_row.data() + sizeof(uint32_t), header_size);
+  data_ = Slice(header_.end(), packed_row.end());
+  if (num_columns_ > 0 && EndOffset(num_columns_ - 1) != data_.size()) {
+    return STATUS_FORMAT(
+        Corruption, "Packed row data size mismatch: $0 vs. $1", EndOffset(num_columns_ - 1),
+        data_.size());
+  }
+  return Status::OK();
+}
+
+ColumnId PackedRowDecoder::column_id(size_t idx) const {
+  DCHECK_LT(idx, num_columns_);
+  return ColumnId(static_cast<ColumnIdRep>(
+      BigEndian::Load32(header_.data() + idx * kHeaderEntrySize)));
+}
+
+size_t PackedRowDecoder::EndOffset(size_t idx) const {
+  return BigEndian::Load32(header_.data() + idx * kHeaderEntrySize + sizeof(uint32_t));
+}
+
+int PackedRowDecoder::FindColumn(ColumnId column_id) const {
+  // Header is sorted by column id, so use binary search.
+  size_t lower = 0;
+  size_t upper = num_columns_;
+  while (lower < upper) {
+    const size_t middle = lower + (upper - lower) / 2;
+    const ColumnId middle_id = this->column_id(middle);
+    if (middle_id == column_id) {
+      return middle;
+    }
+    if (middle_id < column_id) {
+      lower = middle + 1;
+    } else {
+      upper = middle;
+    }
+  }
+  return kColumnNotFound;
+}
+
+Status PackedRowDecoder::DecodeColumn(size_t idx, PrimitiveValue* value) const {
+  DCHECK_LT(idx, num_columns_);
+  const size_t begin = idx == 0 ? 0 : EndOffset(idx - 1);
+  const size_t end = EndOffset(idx);
+  if (begin > end || end > data_.size()) {
+    return STATUS_FORMAT(
+        Corruption, "Bad packed row offsets for column $0: $1-$2 of $3", column_id(idx), begin,
+        end, data_.size());
+  }
+  return value->DecodeFromValue(Slice(data_.data() + begin, end - begin));
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Packed row encoding: all non-key columns of a row stored in a single value of the DocKey, so that
+// the row could be read with a single seek instead of one seek per column.
+//
+// The packed row is stored as a kPackedRow primitive value with the following layout:
+//
+//   num_columns  : big-endian uint32
+//   header       : num_columns entries of (column id, end offset), both big-endian uint32,
+//                  sorted by column id. The end offset is relative to the start of the data.
+//   data         : value encoding of each column (PrimitiveValue::ToValue) in header order.
+//
+// Columns that are not present in the packed row are null. Column level records of the same row
+// written after the packed row take precedence over the packed values, while older column records
+// are overwritten by the packed row.
+
+#ifndef YB_DOCDB_PACKED_ROW_H_
+#define YB_DOCDB_PACKED_ROW_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/schema.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+class PackedRowEncoder {
+ public:
+  // Adds a column value. Columns could be added in any order, but each column at most once.
+  void AddColumn(ColumnId column_id, const PrimitiveValue& value);
+
+  // Returns the packed row value for the added columns and resets the encoder.
+  PrimitiveValue Finish();
+
+ private:
+  std::vector<std::pair<ColumnId, std::string>> columns_;
+};
+
+// Decodes columns of a packed row lazily, only the header is parsed by Init.
+class PackedRowDecoder {
+ public:
+  static constexpr int kColumnNotFound = -1;
+
+  // The packed row data should outlive the decoder.
+  CHECKED_STATUS Init(const Slice& packed_row);
+
+  size_t num_columns() const {
+    return num_columns_;
+  }
+
+  ColumnId column_id(size_t idx) const;
+
+  // Returns index of the column with the given id, or kColumnNotFound.
+  int FindColumn(ColumnId column_id) const;
+
+  // Decodes value of the column at the given index.
+  CHECKED_STATUS DecodeColumn(size_t idx, PrimitiveValue* value) const;
+
+ private:
+  size_t EndOffset(size_t idx) const;
+
+  Slice header_;
+  Slice data_;
+  size_t num_columns_ = 0;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H_
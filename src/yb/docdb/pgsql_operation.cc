@@ -13,15 +13,20 @@
 
 #include "yb/docdb/pgsql_operation.h"
 
+#include <numeric>
+
 #include <boost/optional/optional_io.hpp>
 
 #include "yb/common/partition.h"
+#include "yb/common/ql_batch_filter.h"
+#include "yb/common/ql_column_batch.h"
 #include "yb/common/ql_storage_interface.h"
 #include "yb/common/ql_value.h"
 #include "yb/common/pg_system_attr.h"
 
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value_util.h"
 
 #include "yb/util/flag_tags.h"
@@ -36,6 +41,30 @@ DECLARE_int64(retryable_rpc_single_call_timeout_ms);
 DEFINE_double(ysql_scan_timeout_multiplier, 0.5,
               "YSQL read scan timeout multipler of retryable_rpc_single_call_timeout_ms.");
 
+DEFINE_int32(ysql_scan_batch_rows, 1024,
+             "Maximum number of rows decoded at once into a column batch by YSQL scans that "
+             "select plain columns. 0 disables batched scans.");
+TAG_FLAG(ysql_scan_batch_rows, advanced);
+
+DEFINE_bool(ysql_scan_batch_filter, true,
+            "Evaluate simple WHERE conditions of batched YSQL scans over the whole column batch "
+            "instead of row by row.");
+TAG_FLAG(ysql_scan_batch_filter, advanced);
+TAG_FLAG(ysql_scan_batch_filter, runtime);
+
+DEFINE_bool(ysql_enable_packed_row, false,
+            "Write all non-key columns of a row inserted by YSQL into a single packed value, so "
+            "that the row could be read with a single seek.");
+TAG_FLAG(ysql_enable_packed_row, advanced);
+TAG_FLAG(ysql_enable_packed_row, runtime);
+
+DEFINE_int32(ysql_batch_read_shared_iterator_min_rows, 4,
+             "Minimum number of ybctids in a batched YSQL read for the rows to be fetched in key "
+             "order with a single iterator. Smaller batches use a separate iterator with bloom "
+             "filter per row. 0 disables the shared iterator.");
+TAG_FLAG(ysql_batch_read_shared_iterator_min_rows, advanced);
+TAG_FLAG(ysql_batch_read_shared_iterator_min_rows, runtime);
+
 DEFINE_test_flag(int32, TEST_slowdown_pgsql_aggregate_read_ms, 0,
                  "If set > 0, slows down the response to pgsql aggregate read by this amount.");
 
@@ -60,6 +89,66 @@ CHECKED_STATUS CreateProjection(const Schema& schema,
   return schema.CreateProjectionByIdsIgnoreMissing(column_ids, projection);
 }
 
+// Finds the batch column for every target of the request. Returns false when some target is not a
+// plain column reference present in the batch, i.e. it has to be evaluated against a QLTableRow.
+bool GetBatchTargetColumns(const PgsqlReadRequestPB& request,
+                           const QLColumnBatch& batch,
+                           std::vector<int>* target_columns) {
+  target_columns->clear();
+  target_columns->reserve(request.targets_size());
+  for (const PgsqlExpressionPB& expr : request.targets()) {
+    if (!expr.has_column_id() || expr.column_id() < 0) {
+      return false;
+    }
+    const int column_idx = batch.FindColumn(ColumnId(expr.column_id()));
+    if (column_idx == QLColumnBatch::kColumnNotFound) {
+      return false;
+    }
+    target_columns->push_back(column_idx);
+  }
+  return !target_columns->empty();
+}
+
+// Writes the selected rows of the batch as a chunk of columnar rows data, see
+// PgsqlResponsePB::columnar_rows_data. Returns the number of written rows.
+Result<size_t> WriteColumnarChunk(const QLColumnBatch& batch,
+                                  const std::vector<int>& target_columns,
+                                  const std::vector<uint8_t>& selection,
+                                  size_t num_rows,
+                                  faststring* result_buffer) {
+  std::vector<size_t> row_indexes;
+  row_indexes.reserve(num_rows);
+  for (size_t row_idx = 0; row_idx != num_rows; ++row_idx) {
+    if (selection.empty() || selection[row_idx]) {
+      row_indexes.push_back(row_idx);
+    }
+  }
+  if (row_indexes.empty()) {
+    return 0;
+  }
+
+  pggate::PgWire::WriteUint32(row_indexes.size(), result_buffer);
+  std::vector<bool> nulls(row_indexes.size());
+  for (int column_idx : target_columns) {
+    const size_t size_offset = result_buffer->size();
+    pggate::PgWire::WriteUint32(0, result_buffer);
+    for (size_t i = 0; i != row_indexes.size(); ++i) {
+      nulls[i] = QLValue::IsNull(batch.value(column_idx, row_indexes[i]));
+    }
+    pggate::WriteNullBitmap(nulls, result_buffer);
+    for (size_t i = 0; i != row_indexes.size(); ++i) {
+      if (!nulls[i]) {
+        RETURN_NOT_OK(pggate::WriteColumnValue(
+            batch.value(column_idx, row_indexes[i]), result_buffer));
+      }
+    }
+    NetworkByteOrder::Store32(
+        result_buffer->data() + size_offset,
+        result_buffer->size() - size_offset - sizeof(uint32_t));
+  }
+  return row_indexes.size();
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -97,6 +186,22 @@ Status PgsqlWriteOperation::Init(PgsqlWriteRequestPB* request, PgsqlResponsePB*
   return Status::OK();
 }
 
+bool PgsqlWriteOperation::RequireReadSnapshot() const {
+  switch (request_.stmt_type()) {
+    case PgsqlWriteRequestPB::PGSQL_UPSERT: FALLTHROUGH_INTENDED;
+    case PgsqlWriteRequestPB::PGSQL_TRUNCATE_COLOCATED:
+      // Blind writes, Apply does not read the current row for them, so there is no need for a read
+      // snapshot and they are locked in serializable isolation, without conflicting with one
+      // another.
+      return false;
+    case PgsqlWriteRequestPB::PGSQL_INSERT: FALLTHROUGH_INTENDED;
+    case PgsqlWriteRequestPB::PGSQL_UPDATE: FALLTHROUGH_INTENDED;
+    case PgsqlWriteRequestPB::PGSQL_DELETE:
+      break;
+  }
+  return request_.has_column_refs();
+}
+
 Status PgsqlWriteOperation::Apply(const DocOperationApplyData& data) {
   VLOG(4) << "Write, read time: " << data.read_time << ", txn: " << txn_op_context_;
 
@@ -138,14 +243,23 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     }
   }
 
-  // Add the liveness column.
-  static const PrimitiveValue kLivenessColumnId =
-      PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn);
-
-  RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
-      DocPath(encoded_doc_key_.as_slice(), kLivenessColumnId),
-      Value(PrimitiveValue()),
-      data.read_time, data.deadline, request_.stmt_id()));
+  // An upsert keeps the existing values of the columns it does not set, so it could not overwrite
+  // the whole row with a packed row.
+  const bool pack_row = FLAGS_ysql_enable_packed_row && !is_upsert;
+  PackedRowEncoder packed_row;
+  // Columns that could not be packed, they are written after the packed row.
+  std::vector<std::pair<ColumnId, SubDocument>> unpacked_columns;
+
+  if (!pack_row) {
+    // Add the liveness column. A packed row marks the row as live by itself.
+    static const PrimitiveValue kLivenessColumnId =
+        PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn);
+
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath(encoded_doc_key_.as_slice(), kLivenessColumnId),
+        Value(PrimitiveValue()),
+        data.read_time, data.deadline, request_.stmt_id()));
+  }
 
   for (const auto& column_value : request_.column_values()) {
     // Get the column.
@@ -165,12 +279,35 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     const SubDocument sub_doc =
         SubDocument::FromQLValuePB(expr_result.Value(), column.sorting_type());
 
+    if (pack_row) {
+      if (!sub_doc.IsPrimitive()) {
+        unpacked_columns.emplace_back(column_id, sub_doc);
+      } else if (!IsNull(expr_result.Value())) {
+        // Null columns are not stored in the packed row.
+        packed_row.AddColumn(column_id, sub_doc);
+      }
+      continue;
+    }
+
     // Inserting into specified column.
     DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_id));
     RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
         sub_path, sub_doc, data.read_time, data.deadline, request_.stmt_id()));
   }
 
+  if (pack_row) {
+    // The packed row overwrites older column records of the row, so it has to be added to the
+    // write batch before the column records that were not packed.
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath(encoded_doc_key_.as_slice()), Value(packed_row.Finish()),
+        data.read_time, data.deadline, request_.stmt_id()));
+    for (const auto& column : unpacked_columns) {
+      DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column.first));
+      RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
+          sub_path, column.second, data.read_time, data.deadline, request_.stmt_id()));
+    }
+  }
+
   RETURN_NOT_OK(PopulateResultSet(table_row));
 
   response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
@@ -438,13 +575,25 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
   // the WHERE condition. When DocRowwiseIterator::NextRow() populates the value map, it uses this
   // projection only to scan sub-documents. The query schema is used to select only referenced
   // columns and key columns.
-  Schema projection;
+  Schema local_projection;
   Schema index_projection;
   common::YQLRowwiseIteratorIf *iter;
 
-  RETURN_NOT_OK(CreateProjection(schema, request_.column_refs(), &projection));
-  RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
-                                       deadline, read_time, &table_iter_));
+  if (CanUseCursor() && !cursor_) {
+    cursor_ = std::make_unique<PgsqlReadCursor>();
+  }
+  // The iterator references the projection, so it is owned by the cursor when the iterator could
+  // outlive this operation.
+  Schema& projection = cursor_ ? cursor_->projection : local_projection;
+  if (cursor_ && cursor_->iter) {
+    table_iter_ = std::move(cursor_->iter);
+    table_iter_->SetDeadline(deadline);
+    VLOG(4) << "Continue scan with cursor iterator: " << table_iter_->ToString();
+  } else {
+    RETURN_NOT_OK(CreateProjection(schema, request_.column_refs(), &projection));
+    RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
+                                         deadline, read_time, &table_iter_));
+  }
 
   ColumnId ybbasectid_id;
   if (request_.has_index_request()) {
@@ -470,10 +619,59 @@ Result<size_t> PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storag
     FLAGS_retryable_rpc_single_call_timeout_ms * FLAGS_ysql_scan_timeout_multiplier;
   const MonoTime start_time = MonoTime::Now();
 
+  // Plain column selects are decoded a batch of rows at a time and written to the result buffer
+  // straight from the column vectors. The WHERE condition, if any, should be supported by
+  // QLBatchFilter.
+  std::vector<int> target_columns;
+  QLColumnBatch batch;
+  QLBatchFilter batch_filter;
+  std::vector<uint8_t> selection;
+  bool use_column_batch = false;
+  if (FLAGS_ysql_scan_batch_rows > 0 && !request_.has_index_request() &&
+      !request_.is_aggregate() &&
+      (!request_.has_where_expr() || FLAGS_ysql_scan_batch_filter)) {
+    batch.Reset(schema, projection);
+    use_column_batch = GetBatchTargetColumns(request_, batch, &target_columns) &&
+                       (!request_.has_where_expr() ||
+                        batch_filter.Init(request_.where_expr(), batch));
+  }
+  const bool columnar = use_column_batch && request_.columnar_rows_data();
+  if (columnar) {
+    response_.set_columnar_rows_data(true);
+  }
+  while (use_column_batch && fetched_rows < row_count_limit && !scan_time_exceeded) {
+    const size_t max_rows = std::min<size_t>(
+        row_count_limit - fetched_rows, FLAGS_ysql_scan_batch_rows);
+    const size_t num_rows = VERIFY_RESULT(iter->NextBatch(projection, max_rows, &batch));
+    if (num_rows == 0) {
+      break;
+    }
+    if (request_.has_where_expr()) {
+      RETURN_NOT_OK(batch_filter.Evaluate(batch, &selection));
+    }
+    if (columnar) {
+      fetched_rows += VERIFY_RESULT(WriteColumnarChunk(
+          batch, target_columns, selection, num_rows, result_buffer));
+    } else {
+      for (size_t row_idx = 0; row_idx != num_rows; ++row_idx) {
+        if (!selection.empty() && !selection[row_idx]) {
+          continue;
+        }
+        for (int column_idx : target_columns) {
+          RETURN_NOT_OK(pggate::WriteColumn(batch.value(column_idx, row_idx), result_buffer));
+        }
+        ++fetched_rows;
+      }
+    }
+
+    const MonoDelta elapsed_time = MonoTime::Now().GetDeltaSince(start_time);
+    scan_time_exceeded = elapsed_time.ToMilliseconds() > scan_time_limit;
+  }
+
   // Fetching data.
   int match_count = 0;
   QLTableRow row;
-  while (fetched_rows < row_count_limit && VERIFY_RESULT(iter->HasNext()) &&
+  while (!use_column_batch && fetched_rows < row_count_limit && VERIFY_RESULT(iter->HasNext()) &&
          !scan_time_exceeded) {
 
     row.Clear();
@@ -548,9 +746,16 @@ Result<size_t> PgsqlReadOperation::ExecuteBatch(const common::YQLStorageIf& ql_s
   Schema projection;
   RETURN_NOT_OK(CreateProjection(schema, request_.column_refs(), &projection));
 
+  const auto& batch_arguments = request_.batch_arguments();
+  if (FLAGS_ysql_batch_read_shared_iterator_min_rows > 0 &&
+      batch_arguments.size() >= FLAGS_ysql_batch_read_shared_iterator_min_rows) {
+    return ExecuteBatchWithSharedIterator(
+        ql_storage, deadline, read_time, schema, projection, result_buffer);
+  }
+
   QLTableRow row;
   size_t row_count = 0;
-  for (const PgsqlBatchArgumentPB& batch_argument : request_.batch_arguments()) {
+  for (const PgsqlBatchArgumentPB& batch_argument : batch_arguments) {
     // Get the row.
     RETURN_NOT_OK(ql_storage.GetIterator(request_, projection, schema, txn_op_context_,
                                          deadline, read_time, batch_argument.ybctid().value(),
@@ -572,6 +777,52 @@ Result<size_t> PgsqlReadOperation::ExecuteBatch(const common::YQLStorageIf& ql_s
   return row_count;
 }
 
+Result<size_t> PgsqlReadOperation::ExecuteBatchWithSharedIterator(
+    const common::YQLStorageIf& ql_storage,
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time,
+    const Schema& schema,
+    const Schema& projection,
+    faststring *result_buffer) {
+  const auto& batch_arguments = request_.batch_arguments();
+
+  // Visit the rows in ybctid order, so that one iterator moves forward through all of them, but
+  // return them in the request order.
+  std::vector<int> order(batch_arguments.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&batch_arguments](int lhs, int rhs) {
+    return batch_arguments.Get(lhs).ybctid().value().binary_value() <
+           batch_arguments.Get(rhs).ybctid().value().binary_value();
+  });
+
+  RETURN_NOT_OK(ql_storage.GetTupleIterator(
+      projection, schema, txn_op_context_, deadline, read_time, &table_iter_));
+  std::vector<QLTableRow> rows(batch_arguments.size());
+  for (int idx : order) {
+    SCHECK(VERIFY_RESULT(table_iter_->SeekTuple(
+               batch_arguments.Get(idx).ybctid().value().binary_value())),
+           Corruption, "Given ybctid is not associated with any row in table");
+    RETURN_NOT_OK(table_iter_->NextRow(projection, &rows[idx]));
+  }
+
+  for (const auto& row : rows) {
+    RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
+  }
+
+  // Set status for this batch.
+  response_.set_batch_arg_count(rows.size());
+
+  return rows.size();
+}
+
+PgsqlReadCursorPtr PgsqlReadOperation::ReleaseCursor() {
+  if (!cursor_ || !table_iter_) {
+    return nullptr;
+  }
+  cursor_->iter = std::move(table_iter_);
+  return std::move(cursor_);
+}
+
 Status PgsqlReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                                      size_t fetched_rows,
                                                      const size_t row_count_limit,
@@ -15,6 +15,7 @@
 #define YB_DOCDB_PGSQL_OPERATION_H
 
 #include "yb/common/ql_rowwise_iterator_interface.h"
+#include "yb/common/schema.h"
 
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_key.h"
@@ -46,7 +47,7 @@ class PgsqlWriteOperation :
 
   // Initialize PgsqlWriteOperation. Content of request will be swapped out by the constructor.
   CHECKED_STATUS Init(PgsqlWriteRequestPB* request, PgsqlResponsePB* response);
-  bool RequireReadSnapshot() const override { return request_.has_column_refs(); }
+  bool RequireReadSnapshot() const override;
   const PgsqlWriteRequestPB& request() const { return request_; }
   PgsqlResponsePB* response() const { return response_; }
 
@@ -107,6 +108,16 @@ class PgsqlWriteOperation :
   faststring result_buffer_;
 };
 
+// State of a plain scan that could be kept between fetches of the same read, so the next fetch
+// continues with the iterator already positioned at the next row.
+struct PgsqlReadCursor {
+  // Projection referenced by the iterator.
+  Schema projection;
+  common::YQLRowwiseIteratorIf::UniPtr iter;
+};
+
+typedef std::unique_ptr<PgsqlReadCursor> PgsqlReadCursorPtr;
+
 class PgsqlReadOperation : public DocExprExecutor {
  public:
   // Construct and access methods.
@@ -130,6 +141,21 @@ class PgsqlReadOperation : public DocExprExecutor {
 
   CHECKED_STATUS GetIntents(const Schema& schema, KeyValueWriteBatchPB* out);
 
+  // Whether the request is a plain scan whose iterator could be kept in a cursor.
+  bool CanUseCursor() const {
+    return !request_.has_index_request() && request_.batch_arguments_size() == 0;
+  }
+
+  // Continues the scan with the iterator of the cursor, instead of creating a new one positioned
+  // at the paging state. Should be called before Execute, only when CanUseCursor().
+  void SetCursor(PgsqlReadCursorPtr cursor) {
+    cursor_ = std::move(cursor);
+  }
+
+  // Returns the cursor with the iterator positioned after the last fetched row, or nullptr if the
+  // request could not use a cursor.
+  PgsqlReadCursorPtr ReleaseCursor();
+
  private:
   Result<size_t> ExecuteBatch(const common::YQLStorageIf& ql_storage,
                               CoarseTimePoint deadline,
@@ -138,6 +164,14 @@ class PgsqlReadOperation : public DocExprExecutor {
                               faststring *result_buffer,
                               HybridTime *restart_read_ht);
 
+  // Fetches rows of all batch arguments using one iterator.
+  Result<size_t> ExecuteBatchWithSharedIterator(const common::YQLStorageIf& ql_storage,
+                                                CoarseTimePoint deadline,
+                                                const ReadHybridTime& read_time,
+                                                const Schema& schema,
+                                                const Schema& projection,
+                                                faststring *result_buffer);
+
   CHECKED_STATUS PopulateResultSet(const QLTableRow& table_row,
                                    faststring *result_buffer);
 
@@ -159,6 +193,8 @@ class PgsqlReadOperation : public DocExprExecutor {
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
+  // Owns the projection of table_iter_ for requests that could use a cursor.
+  PgsqlReadCursorPtr cursor_;
 };
 
 }  // namespace docdb
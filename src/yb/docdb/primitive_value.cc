@@ -110,6 +110,10 @@ string PrimitiveValue::ToString() const {
       return "SSforward";
     case ValueType::kSSReverse:
       return "SSreverse";
+    case ValueType::kRedisListHead:
+      return "RedisListHead";
+    case ValueType::kRedisListTail:
+      return "RedisListTail";
     case ValueType::kFalse: FALLTHROUGH_INTENDED;
     case ValueType::kFalseDescending:
       return "false";
@@ -121,6 +125,8 @@ string PrimitiveValue::ToString() const {
     case ValueType::kStringDescending:
     case ValueType::kString:
       return FormatBytesAsStr(str_val_);
+    case ValueType::kPackedRow:
+      return Format("PackedRow($0)", FormatBytesAsStr(str_val_));
     case ValueType::kInt32Descending: FALLTHROUGH_INTENDED;
     case ValueType::kInt32:
       return std::to_string(int32_val_);
@@ -253,6 +259,8 @@ void PrimitiveValue::AppendToKey(KeyBytes* key_bytes) const {
     case ValueType::kCounter: return;
     case ValueType::kSSForward: return;
     case ValueType::kSSReverse: return;
+    case ValueType::kRedisListHead: return;
+    case ValueType::kRedisListTail: return;
     case ValueType::kFalse: return;
     case ValueType::kTrue: return;
     case ValueType::kFalseDescending: return;
@@ -412,6 +420,7 @@ void PrimitiveValue::AppendToKey(KeyBytes* key_bytes) const {
       key_bytes->AppendIntentTypeSet(IntentTypeSet(uint16_val_));
       return;
 
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
   }
   FATAL_INVALID_ENUM_VALUE(ValueType, type_);
@@ -426,6 +435,8 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kCounter: FALLTHROUGH_INTENDED;
     case ValueType::kSSForward: FALLTHROUGH_INTENDED;
     case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListHead: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListTail: FALLTHROUGH_INTENDED;
     case ValueType::kFalse: FALLTHROUGH_INTENDED;
     case ValueType::kTrue: FALLTHROUGH_INTENDED;
     case ValueType::kFalseDescending: FALLTHROUGH_INTENDED;
@@ -439,6 +450,7 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kRedisSet: return result;
 
     case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kString:
       // No zero encoding necessary when storing the string in a value.
       result.append(str_val_);
@@ -602,6 +614,8 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
     case ValueType::kCounter: FALLTHROUGH_INTENDED;
     case ValueType::kSSForward: FALLTHROUGH_INTENDED;
     case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListHead: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListTail: FALLTHROUGH_INTENDED;
     case ValueType::kFalse: FALLTHROUGH_INTENDED;
     case ValueType::kTrue: FALLTHROUGH_INTENDED;
     case ValueType::kFalseDescending: FALLTHROUGH_INTENDED;
@@ -938,7 +952,8 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
       type_ref = value_type;
       return Status::OK();
     }
-    case ValueType::kMaxByte:
+    case ValueType::kMaxByte: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow:
       break;
 
     IGNORE_NON_PRIMITIVE_VALUE_TYPES_IN_SWITCH;
@@ -969,6 +984,8 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kCounter: FALLTHROUGH_INTENDED;
     case ValueType::kSSForward: FALLTHROUGH_INTENDED;
     case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListHead: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListTail: FALLTHROUGH_INTENDED;
     case ValueType::kFalse: FALLTHROUGH_INTENDED;
     case ValueType::kTrue: FALLTHROUGH_INTENDED;
     case ValueType::kFalseDescending: FALLTHROUGH_INTENDED;
@@ -1014,6 +1031,11 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
       type_ = ValueType::kString;
       return Status::OK();
 
+    case ValueType::kPackedRow:
+      new(&str_val_) string(slice.cdata(), slice.size());
+      type_ = ValueType::kPackedRow;
+      return Status::OK();
+
     case ValueType::kInt32: FALLTHROUGH_INTENDED;
     case ValueType::kInt32Descending: FALLTHROUGH_INTENDED;
     case ValueType::kFloatDescending: FALLTHROUGH_INTENDED;
@@ -1282,6 +1304,13 @@ PrimitiveValue PrimitiveValue::PgTableOid(const yb::PgTableOid pgtable_id) {
   return primitive_value;
 }
 
+PrimitiveValue PrimitiveValue::PackedRow(std::string packed_row) {
+  PrimitiveValue primitive_value;
+  primitive_value.type_ = ValueType::kPackedRow;
+  new(&primitive_value.str_val_) string(std::move(packed_row));
+  return primitive_value;
+}
+
 PrimitiveValue PrimitiveValue::Jsonb(const std::string& json) {
   PrimitiveValue primitive_value;
   primitive_value.type_ = ValueType::kJsonb;
@@ -1307,6 +1336,8 @@ bool PrimitiveValue::operator==(const PrimitiveValue& other) const {
     case ValueType::kFalseDescending: FALLTHROUGH_INTENDED;
     case ValueType::kSSForward: FALLTHROUGH_INTENDED;
     case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListHead: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListTail: FALLTHROUGH_INTENDED;
     case ValueType::kTrue: FALLTHROUGH_INTENDED;
     case ValueType::kTrueDescending: FALLTHROUGH_INTENDED;
     case ValueType::kLowest: FALLTHROUGH_INTENDED;
@@ -1314,6 +1345,7 @@ bool PrimitiveValue::operator==(const PrimitiveValue& other) const {
     case ValueType::kMaxByte: return true;
 
     case ValueType::kStringDescending: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kString: return str_val_ == other.str_val_;
 
     case ValueType::kFrozenDescending: FALLTHROUGH_INTENDED;
@@ -1385,6 +1417,8 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
     case ValueType::kCounter: FALLTHROUGH_INTENDED;
     case ValueType::kSSForward: FALLTHROUGH_INTENDED;
     case ValueType::kSSReverse: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListHead: FALLTHROUGH_INTENDED;
+    case ValueType::kRedisListTail: FALLTHROUGH_INTENDED;
     case ValueType::kFalse: FALLTHROUGH_INTENDED;
     case ValueType::kTrue: FALLTHROUGH_INTENDED;
     case ValueType::kFalseDescending: FALLTHROUGH_INTENDED;
@@ -1395,6 +1429,7 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
       return 0;
     case ValueType::kStringDescending:
       return other.str_val_.compare(str_val_);
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kString:
       return str_val_.compare(other.str_val_);
     case ValueType::kInt64Descending:
@@ -1484,7 +1519,8 @@ int PrimitiveValue::CompareTo(const PrimitiveValue& other) const {
 PrimitiveValue::PrimitiveValue(ValueType value_type)
     : type_(value_type) {
   complex_data_structure_ = nullptr;
-  if (value_type == ValueType::kString || value_type == ValueType::kStringDescending) {
+  if (value_type == ValueType::kString || value_type == ValueType::kStringDescending ||
+      value_type == ValueType::kPackedRow) {
     new(&str_val_) std::string();
   } else if (value_type == ValueType::kInetaddress
       || value_type == ValueType::kInetaddressDescending) {
@@ -64,7 +64,8 @@ class PrimitiveValue {
   explicit PrimitiveValue(ValueType value_type);
 
   PrimitiveValue(const PrimitiveValue& other) {
-    if (other.type_ == ValueType::kString || other.type_ == ValueType::kStringDescending) {
+    if (other.type_ == ValueType::kString || other.type_ == ValueType::kStringDescending ||
+        other.type_ == ValueType::kPackedRow) {
       type_ = other.type_;
       new(&str_val_) std::string(other.str_val_);
     } else if (other.type_ == ValueType::kJsonb) {
@@ -206,7 +207,8 @@ class PrimitiveValue {
   std::string ToString() const;
 
   ~PrimitiveValue() {
-    if (type_ == ValueType::kString || type_ == ValueType::kStringDescending) {
+    if (type_ == ValueType::kString || type_ == ValueType::kStringDescending ||
+        type_ == ValueType::kPackedRow) {
       str_val_.~basic_string();
     } else if (type_ == ValueType::kJsonb) {
       json_val_.~basic_string();
@@ -248,6 +250,8 @@ class PrimitiveValue {
   static PrimitiveValue TableId(Uuid table_id);
   static PrimitiveValue PgTableOid(const PgTableOid pgtable_id);
   static PrimitiveValue Jsonb(const std::string& json);
+  // Packed row value built by PackedRowEncoder. Could only be stored in a value, not in a key.
+  static PrimitiveValue PackedRow(std::string packed_row);
 
   KeyBytes ToKeyBytes() const;
 
@@ -298,6 +302,12 @@ class PrimitiveValue {
     return str_val_;
   }
 
+  // Moves the string out of this value, that should only be destroyed or assigned to afterwards.
+  std::string ReleaseString() {
+    DCHECK(IsString());
+    return std::move(str_val_);
+  }
+
   int32_t GetInt32() const {
     DCHECK(ValueType::kInt32 == type_ || ValueType::kInt32Descending == type_);
     return int32_val_;
@@ -313,6 +323,11 @@ class PrimitiveValue {
     return int64_val_;
   }
 
+  int64_t GetArrayIndex() const {
+    DCHECK_EQ(ValueType::kArrayIndex, type_);
+    return int64_val_;
+  }
+
   uint64_t GetUInt64() const {
     DCHECK(ValueType::kUInt64 == type_ || ValueType::kUInt64Descending == type_);
     return uint64_val_;
@@ -361,6 +376,11 @@ class PrimitiveValue {
     return json_val_;
   }
 
+  const std::string& GetPackedRow() const {
+    DCHECK(type_ == ValueType::kPackedRow);
+    return str_val_;
+  }
+
   const Uuid& GetUuid() const {
     DCHECK(type_ == ValueType::kUuid || type_ == ValueType::kUuidDescending ||
            type_ == ValueType::kTransactionId || type_ == ValueType::kTableId);
@@ -472,7 +492,8 @@ class PrimitiveValue {
 
     ttl_seconds_ = other->ttl_seconds_;
     write_time_ = other->write_time_;
-    if (other->type_ == ValueType::kString || other->type_ == ValueType::kStringDescending) {
+    if (other->type_ == ValueType::kString || other->type_ == ValueType::kStringDescending ||
+        other->type_ == ValueType::kPackedRow) {
       type_ = other->type_;
       new(&str_val_) std::string(std::move(other->str_val_));
       // The moved-from object should now be in a "valid but unspecified" state as per the standard.
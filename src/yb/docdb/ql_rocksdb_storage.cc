@@ -145,6 +145,20 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
   return Status::OK();
 }
 
+Status QLRocksDBStorage::GetTupleIterator(const Schema& projection,
+                                          const Schema& schema,
+                                          const TransactionOperationContextOpt& txn_op_context,
+                                          CoarseTimePoint deadline,
+                                          const ReadHybridTime& read_time,
+                                          common::YQLRowwiseIteratorIf::UniPtr* iter) const {
+  // Bloom filter is not used, since the iterator is shared by rows with different hash keys.
+  auto doc_iter = std::make_unique<DocRowwiseIterator>(
+      projection, schema, txn_op_context, doc_db_, deadline, read_time);
+  RETURN_NOT_OK(doc_iter->Init());
+  *iter = std::move(doc_iter);
+  return Status::OK();
+}
+
 Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
                                      const Schema& projection,
                                      const Schema& schema,
@@ -20,6 +20,8 @@
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/subdocument.h"
 
+#include "yb/gutil/strings/numbers.h"
+
 #include "yb/util/stol_utils.h"
 #include "yb/util/redis_util.h"
 
@@ -260,8 +262,7 @@ Result<RedisValue> GetRedisValue(
     }
   }
 
-  auto val = RedisValue{REDIS_TYPE_STRING, doc.GetString(), data.exp};
-  return val;
+  return RedisValue{REDIS_TYPE_STRING, doc.ReleaseString(), data.exp};
 }
 
 YB_STRONGLY_TYPED_BOOL(VerifySuccessIfMissing);
@@ -415,17 +416,28 @@ void SetOptionalInt(RedisDataType type, int64_t value, RedisResponsePB* response
   SetOptionalInt(type, value, 0, response);
 }
 
-Result<int64_t> GetCardinality(IntentAwareIterator* iterator, const RedisKeyValuePB& kv) {
-  auto encoded_key_card = DocKey::EncodedFromRedisKey(kv.hash_code(), kv.key());
-  PrimitiveValue(ValueType::kCounter).AppendToKey(&encoded_key_card);
-  SubDocument subdoc_card;
+// Returns the integer stored in the subkey of the given type of a collection, like its
+// cardinality or the bounds of a list.
+Result<boost::optional<int64_t>> GetCollectionInt(
+    IntentAwareIterator* iterator, const RedisKeyValuePB& kv, ValueType subkey_type) {
+  auto encoded_subkey = DocKey::EncodedFromRedisKey(kv.hash_code(), kv.key());
+  PrimitiveValue(subkey_type).AppendToKey(&encoded_subkey);
+  SubDocument subdoc;
 
-  bool subdoc_card_found = false;
-  GetSubDocumentData data = { encoded_key_card, &subdoc_card, &subdoc_card_found };
+  bool subdoc_found = false;
+  GetSubDocumentData data = { encoded_subkey, &subdoc, &subdoc_found };
 
   RETURN_NOT_OK(GetSubDocument(iterator, data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
 
-  return subdoc_card_found ? subdoc_card.GetInt64() : 0;
+  if (!subdoc_found) {
+    return boost::none;
+  }
+  return subdoc.GetInt64();
+}
+
+Result<int64_t> GetCardinality(IntentAwareIterator* iterator, const RedisKeyValuePB& kv) {
+  auto card = VERIFY_RESULT(GetCollectionInt(iterator, kv, ValueType::kCounter));
+  return card ? *card : 0;
 }
 
 template <typename AddResponseValues>
@@ -484,6 +496,99 @@ void GetNormalizedBounds(int64 low_idx, int64 high_idx, int64 card, bool reverse
   }
 }
 
+// Returns the start of the bucket of the timestamp, for buckets of the size starting at 0.
+int64_t TimeSeriesBucket(int64_t timestamp, int64_t bucket_size) {
+  const int64_t remainder = ((timestamp % bucket_size) + bucket_size) % bucket_size;
+  return static_cast<int64_t>(static_cast<uint64_t>(timestamp) - remainder);
+}
+
+// Adds a pair of the bucket start and the aggregate of its values to the response array, for
+// every bucket of the time series entries that has at least one entry.
+template <typename T>
+void AggregateTimeSeriesInternal(T iter,
+                                 const T& iter_end,
+                                 const RedisTimeSeriesAggregationPB& aggregation,
+                                 RedisResponsePB* response) {
+  auto* array = response->mutable_array_response();
+  const auto type = aggregation.type();
+  bool has_bucket = false;
+  int64_t bucket = 0;
+  int64_t count = 0;
+  long double result = 0;
+
+  auto add_bucket = [&] {
+    if (!has_bucket) {
+      return;
+    }
+    array->add_elements(std::to_string(bucket));
+    switch (type) {
+      case RedisTimeSeriesAggregationPB::COUNT:
+        array->add_elements(std::to_string(count));
+        return;
+      case RedisTimeSeriesAggregationPB::AVG:
+        array->add_elements(SimpleDtoa(static_cast<double>(result / count)));
+        return;
+      default:
+        array->add_elements(SimpleDtoa(static_cast<double>(result)));
+        return;
+    }
+  };
+
+  for (; iter != iter_end; iter++) {
+    long double value = 0;
+    if (type != RedisTimeSeriesAggregationPB::COUNT) {
+      Result<long double> parsed = STATUS(InvalidArgument, "Value is not a string");
+      if (iter->second.IsString()) {
+        parsed = CheckedStold(iter->second.GetString());
+      }
+      if (!parsed.ok()) {
+        array->clear_elements();
+        response->set_code(RedisResponsePB::WRONG_TYPE);
+        response->set_error_message("ERR value is not a valid float");
+        return;
+      }
+      value = *parsed;
+    }
+    const int64_t entry_bucket =
+        TimeSeriesBucket(iter->first.GetInt64(), aggregation.bucket_size());
+    if (!has_bucket || entry_bucket != bucket) {
+      add_bucket();
+      has_bucket = true;
+      bucket = entry_bucket;
+      count = 1;
+      result = value;
+      continue;
+    }
+    ++count;
+    switch (type) {
+      case RedisTimeSeriesAggregationPB::MIN:
+        result = std::min(result, value);
+        break;
+      case RedisTimeSeriesAggregationPB::MAX:
+        result = std::max(result, value);
+        break;
+      case RedisTimeSeriesAggregationPB::AVG: FALLTHROUGH_INTENDED;
+      case RedisTimeSeriesAggregationPB::SUM:
+        result += value;
+        break;
+      case RedisTimeSeriesAggregationPB::COUNT:
+        break;
+    }
+  }
+  add_bucket();
+}
+
+void AggregateTimeSeries(const SubDocument::ObjectContainer& entries,
+                         const RedisTimeSeriesAggregationPB& aggregation,
+                         bool reverse,
+                         RedisResponsePB* response) {
+  if (reverse) {
+    AggregateTimeSeriesInternal(entries.rbegin(), entries.rend(), aggregation, response);
+  } else {
+    AggregateTimeSeriesInternal(entries.begin(), entries.end(), aggregation, response);
+  }
+}
+
 } // anonymous namespace
 
 void RedisWriteOperation::InitializeIterator(const DocOperationApplyData& data) {
@@ -866,7 +971,7 @@ Status RedisWriteOperation::ApplyGetSet(const DocOperationApplyData& data) {
     // We've already set the error code in the response.
     return Status::OK();
   }
-  response_.set_string_response(value->value);
+  response_.set_string_response(std::move(value->value));
 
   return data.doc_write_batch->SetPrimitive(
       DocPath::DocPathFromRedisKey(kv.hash_code(), kv.key()),
@@ -1133,12 +1238,18 @@ Status RedisWriteOperation::ApplyPush(const DocOperationApplyData& data) {
   int64_t card = VERIFY_RESULT(GetCardinality(iterator_.get(), kv)) + kv.value_size();
   list.SetChild(PrimitiveValue(ValueType::kCounter), SubDocument(PrimitiveValue(card)));
 
-  SubDocument elements(request_.push_request().side() == REDIS_SIDE_LEFT ?
-                   ListExtendOrder::PREPEND : ListExtendOrder::APPEND);
+  const bool left = request_.push_request().side() == REDIS_SIDE_LEFT;
+  SubDocument elements(left ? ListExtendOrder::PREPEND : ListExtendOrder::APPEND);
   for (auto val : kv.value()) {
     elements.AddListElement(SubDocument(PrimitiveValue(val)));
   }
   list.SetChild(PrimitiveValue(ValueType::kArray), std::move(elements));
+  if (data_type == REDIS_TYPE_LIST) {
+    // New elements get array indexes below the head or above the tail of the list, pops from that
+    // side have to start at the new elements.
+    list.SetChild(PrimitiveValue(left ? ValueType::kRedisListHead : ValueType::kRedisListTail),
+                  SubDocument(ValueType::kTombstone));
+  }
   RETURN_NOT_OK(list.ConvertToRedisList());
 
   if (data_type == REDIS_TYPE_NONE) {
@@ -1178,30 +1289,30 @@ Status RedisWriteOperation::ApplyPop(const DocOperationApplyData& data) {
     return Status::OK();
   }
 
-  std::vector<int> indices;
-  std::vector<SubDocument> new_value = {SubDocument(PrimitiveValue(ValueType::kTombstone))};
-  std::vector<std::string> value;
+  // Popped elements stay as tombstones until they are compacted away, so the pop starts at the
+  // head or tail of the list, past the elements popped before, instead of skipping over them.
+  const bool left = request_.pop_request().side() == REDIS_SIDE_LEFT;
+  const auto bound_type = left ? ValueType::kRedisListHead : ValueType::kRedisListTail;
+  const auto bound = VERIFY_RESULT(GetCollectionInt(iterator_.get(), kv, bound_type));
 
-  if (request_.pop_request().side() == REDIS_SIDE_LEFT) {
-    indices.push_back(1);
-    RETURN_NOT_OK(data.doc_write_batch->ReplaceInList(doc_path, indices, new_value,
-        data.read_time, data.deadline, redis_query_id(), Direction::kForward, 0, &value));
-  } else {
-    indices.push_back(card);
-    RETURN_NOT_OK(data.doc_write_batch->ReplaceInList(doc_path, indices, new_value,
-        data.read_time, data.deadline, redis_query_id(), Direction::kBackward, card + 1, &value));
+  std::string value;
+  int64_t array_index = 0;
+  auto status = data.doc_write_batch->PopFromRedisList(
+      doc_path, left ? Direction::kForward : Direction::kBackward, bound, data.read_time,
+      data.deadline, redis_query_id(), &value, &array_index);
+  if (status.IsNotFound()) {
+    return STATUS_SUBSTITUTE(Corruption, "No element to pop from list of size $0", card);
   }
+  RETURN_NOT_OK(status);
 
   list.SetChild(PrimitiveValue(ValueType::kCounter), SubDocument(PrimitiveValue(--card)));
+  list.SetChild(PrimitiveValue(bound_type),
+                SubDocument(PrimitiveValue(left ? array_index + 1 : array_index - 1)));
   RETURN_NOT_OK(list.ConvertToRedisList());
   RETURN_NOT_OK(data.doc_write_batch->ExtendSubDocument(
         doc_path, list, data.read_time, data.deadline, redis_query_id()));
 
-  if (value.size() != 1)
-    return STATUS_SUBSTITUTE(Corruption,
-                             "Expected one popped value, got $0", value.size());
-
-  response_.set_string_response(value[0]);
+  response_.set_string_response(std::move(value));
   response_.set_code(RedisResponsePB::OK);
   return Status::OK();
 }
@@ -1480,6 +1591,24 @@ Status RedisReadOperation::ExecuteCollectionGetRangeByBounds(
       // If reverse is false, newest element is the first element returned.
       is_reverse = false;
     }
+    const auto& range_request = request_.get_collection_range_request();
+    if (range_request.has_aggregation()) {
+      // Only the aggregate of every bucket is sent back, instead of all entries of the range.
+      if (range_request.aggregation().bucket_size() <= 0) {
+        return STATUS_FORMAT(InvalidArgument, "Invalid bucket size: $0",
+                             range_request.aggregation().bucket_size());
+      }
+      RETURN_NOT_OK(GetSubDocument(
+          iterator_.get(), data, /* projection */ nullptr, SeekFwdSuffices::kFalse));
+      response_.set_allocated_array_response(new RedisArrayPB());
+      if (!doc_found) {
+        response_.set_code(RedisResponsePB::NIL);
+      } else if (VerifyTypeAndSetCode(ValueType::kRedisTS, doc.value_type(), &response_)) {
+        AggregateTimeSeries(doc.object_container(), range_request.aggregation(), is_reverse,
+                            &response_);
+      }
+      return Status::OK();
+    }
     RETURN_NOT_OK(GetAndPopulateResponseValues(
         iterator_.get(), AddResponseValuesGeneric, data, ValueType::kRedisTS, request_, &response_,
         /* add_keys */ true, /* add_values */ true, is_reverse));
@@ -1715,7 +1844,7 @@ Status RedisReadOperation::ExecuteGet(const RedisGetRequestPB& get_request) {
         RETURN_NOT_OK(value);
         if (VerifyTypeAndSetCode(RedisDataType::REDIS_TYPE_STRING, value->type, &response_,
             VerifySuccessIfMissing::kTrue)) {
-          response_.set_string_response(value->value);
+          response_.set_string_response(std::move(value->value));
         }
       }
       return Status::OK();
@@ -1805,7 +1934,14 @@ Status RedisReadOperation::ExecuteGet(const RedisGetRequestPB& get_request) {
             current_value = ""; // Empty string is nil response.
           }
         }
-        *response_.mutable_array_response()->mutable_elements(indices[i]) = current_value;
+        if (i + 1 < num_subkeys &&
+            req_kv.subkey(indices[i]).string_subkey() ==
+            req_kv.subkey(indices[i + 1]).string_subkey()) {
+          *response_.mutable_array_response()->mutable_elements(indices[i]) = current_value;
+        } else {
+          // The value is not needed for the next subkey.
+          response_.mutable_array_response()->mutable_elements(indices[i])->swap(current_value);
+        }
       }
 
       response_.set_code(RedisResponsePB::OK);
@@ -159,6 +159,42 @@ TEST_F(SharedLockManagerTest, QuickLockUnlock) {
   }
 }
 
+// Measures lock/unlock throughput for different number of threads. Each batch takes a weak lock
+// on a key shared by all threads, like a lock on a parent document, and a strong lock on a key
+// that is private to the thread. Runs as a benchmark only when slow tests are allowed.
+TEST_F(SharedLockManagerTest, LockUnlockThroughput) {
+  const int kBatchesPerThread = AllowSlowTests() ? 100000 : 1000;
+  const std::vector<size_t> kNumThreads = AllowSlowTests() ? std::vector<size_t>{1, 2, 4, 8, 16, 32}
+                                                           : std::vector<size_t>{1, 4};
+  const RefCntPrefix shared_key("shared");
+
+  for (size_t num_threads : kNumThreads) {
+    std::vector<std::thread> threads;
+    auto start = CoarseMonoClock::now();
+    while (threads.size() != num_threads) {
+      size_t thread_idx = threads.size();
+      threads.emplace_back([this, &shared_key, thread_idx, kBatchesPerThread] {
+        for (int i = 0; i != kBatchesPerThread; ++i) {
+          RefCntPrefix key(Format("key_$0_$1", thread_idx, i % 64));
+          LockBatch lb(&lm_, {
+              {shared_key, IntentTypeSet({IntentType::kWeakWrite})},
+              {key, IntentTypeSet({IntentType::kStrongWrite})}},
+              CoarseTimePoint::max());
+          ASSERT_OK(lb.status());
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    auto elapsed = CoarseMonoClock::now() - start;
+    LOG(INFO) << num_threads << " threads: "
+              << num_threads * kBatchesPerThread * 1000 / std::max<int64_t>(
+                     1, ToMilliseconds(elapsed))
+              << " batches/s";
+  }
+}
+
 TEST_F(SharedLockManagerTest, LockConflicts) {
   rpc::ThreadPool tp(rpc::ThreadPoolOptions{"test_pool"s, 10, 1});
 
@@ -13,11 +13,14 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <array>
 #include <vector>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <glog/logging.h>
 
+#include "yb/gutil/port.h"
+
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
@@ -107,9 +110,10 @@ struct LockedBatchEntry {
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and the same for all LockBatchEntries.
-  size_t ref_count = 0;
+  // Refcounting for garbage collection. Incremented only while the mutex of the shard that
+  // contains this entry is locked. Decremented without it, the shard mutex is taken only when the
+  // count drops to zero and the entry could be released.
+  std::atomic<size_t> ref_count{0};
 
   // Number of holders for each type
   std::atomic<LockState> num_holding{0};
@@ -123,7 +127,8 @@ struct LockedBatchEntry {
   std::string ToString() const {
     std::lock_guard<std::mutex> lock(mutex);
     return Format("{ ref_count: $0 num_holding: $1 num_waiters: $2 }",
-                  ref_count, num_holding.load(std::memory_order_acquire),
+                  ref_count.load(std::memory_order_acquire),
+                  num_holding.load(std::memory_order_acquire),
                   num_waiters.load(std::memory_order_acquire));
   }
 };
@@ -134,28 +139,44 @@ class SharedLockManager::Impl {
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
   ~Impl() {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      LOG_IF(DFATAL, !shard.locks.empty()) << "Locks not empty in dtor: "
+                                           << yb::ToString(shard.locks);
+    }
   }
 
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
+  // Number of shards in the lock table. Keys are distributed between shards by hash, so that
+  // batches locking different keys do not contend on a single mutex.
+  static constexpr size_t kNumShards = 32;
+
+  struct Shard {
+    // The shard mutex should be taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  } CACHELINE_ALIGNED;
+
+  static size_t ShardIndex(const RefCntPrefix& key) {
+    // The lower bits of the hash are used by the bucket index of the shard map, so use the upper
+    // ones for the shard index.
+    return (RefCntPrefixHash()(key) >> 32) % kNumShards;
+  }
+
+  // Make sure the entries exist in the lock table and store pointers to them in the batch, so we
+  // can access them without holding the shard mutexes.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
-
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  std::array<Shard, kNumShards> shards_;
 };
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetMask = GenerateByMask(
@@ -274,19 +295,31 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
 }
 
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  // Adjacent keys of a batch frequently reside in the same shard, so keep the shard mutex locked
+  // while the shard does not change.
+  Shard* locked_shard = nullptr;
+  std::unique_lock<std::mutex> lock;
   for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
+    auto& shard = shards_[ShardIndex(key_and_intent_type.key)];
+    if (&shard != locked_shard) {
+      // Never hold two shard mutexes at once, since the shard order is arbitrary.
+      if (lock.owns_lock()) {
+        lock.unlock();
+      }
+      lock = std::unique_lock<std::mutex>(shard.mutex);
+      locked_shard = &shard;
+    }
+    auto& value = shard.locks[key_and_intent_type.key];
     if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
+      if (!shard.free_lock_entries.empty()) {
+        value = shard.free_lock_entries.back();
+        shard.free_lock_entries.pop_back();
       } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+        shard.lock_entries.emplace_back(std::make_unique<LockedBatchEntry>());
+        value = shard.lock_entries.back().get();
       }
     }
-    value->ref_count++;
+    value->ref_count.fetch_add(1, std::memory_order_acq_rel);
     key_and_intent_type.locked = value;
   }
 }
@@ -302,12 +335,23 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
   for (const auto& item : key_to_intent_type) {
-    if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+    // Fast path, the entry is still referenced by other batches.
+    if (item.locked->ref_count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      continue;
+    }
+    auto& shard = shards_[ShardIndex(item.key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // The entry could be reserved again, or already released by another batch that reserved and
+    // cleaned it up after our decrement. Entries are never deallocated while the lock manager is
+    // alive, so it is safe to access it here.
+    auto it = shard.locks.find(item.key);
+    if (it == shard.locks.end() || it->second != item.locked ||
+        item.locked->ref_count.load(std::memory_order_acquire) != 0) {
+      continue;
     }
+    shard.locks.erase(it);
+    shard.free_lock_entries.push_back(item.locked);
   }
 }
 
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/storage_metrics.h"
+
+#include "yb/common/ql_protocol.pb.h"
+
+#include "yb/rocksdb/perf_context.h"
+
+#include "yb/util/logging.h"
+
+namespace yb {
+namespace docdb {
+
+__thread DocDBPerfContext docdb_perf_context;
+
+StorageMetricsCollector::StorageMetricsCollector(bool enabled, PerfLevel level)
+    : enabled_(enabled) {
+  if (!enabled_) {
+    return;
+  }
+  prev_perf_level_ = GetPerfLevel();
+  SetPerfLevel(level);
+  rocksdb::perf_context.Reset();
+  docdb_perf_context.Reset();
+  start_ = MonoTime::Now();
+}
+
+StorageMetricsCollector::~StorageMetricsCollector() {
+  if (enabled_) {
+    SetPerfLevel(prev_perf_level_);
+  }
+}
+
+void StorageMetricsCollector::Fill(StorageMetricsPB* metrics) const {
+  DCHECK(enabled_);
+  const auto& context = rocksdb::perf_context;
+  metrics->set_seeks(context.iter_seek_count);
+  metrics->set_nexts(context.iter_next_count);
+  metrics->set_prevs(context.iter_prev_count);
+  metrics->set_intents(docdb_perf_context.intents);
+  metrics->set_versions_skipped(docdb_perf_context.versions_skipped);
+  metrics->set_internal_keys_skipped(
+      context.internal_key_skipped_count + context.internal_delete_skipped_count);
+  metrics->set_block_cache_hits(context.block_cache_hit_count);
+  metrics->set_block_reads(context.block_read_count);
+  metrics->set_block_read_bytes(context.block_read_byte);
+  metrics->set_bloom_checks(context.bloom_filter_checked_count);
+  metrics->set_bloom_skips(context.bloom_filter_useful_count);
+  metrics->set_total_nanos((MonoTime::Now() - start_).ToNanoseconds());
+  metrics->set_seek_nanos(context.seek_internal_seek_time);
+  metrics->set_next_nanos(context.find_next_user_entry_time);
+  metrics->set_block_read_nanos(context.block_read_time);
+  metrics->set_block_decompress_nanos(context.block_decompress_time);
+}
+
+void AddStorageMetrics(const StorageMetricsPB& source, StorageMetricsPB* dest) {
+  dest->set_seeks(dest->seeks() + source.seeks());
+  dest->set_nexts(dest->nexts() + source.nexts());
+  dest->set_prevs(dest->prevs() + source.prevs());
+  dest->set_intents(dest->intents() + source.intents());
+  dest->set_versions_skipped(dest->versions_skipped() + source.versions_skipped());
+  dest->set_internal_keys_skipped(dest->internal_keys_skipped() + source.internal_keys_skipped());
+  dest->set_block_cache_hits(dest->block_cache_hits() + source.block_cache_hits());
+  dest->set_block_reads(dest->block_reads() + source.block_reads());
+  dest->set_block_read_bytes(dest->block_read_bytes() + source.block_read_bytes());
+  dest->set_bloom_checks(dest->bloom_checks() + source.bloom_checks());
+  dest->set_bloom_skips(dest->bloom_skips() + source.bloom_skips());
+  dest->set_total_nanos(dest->total_nanos() + source.total_nanos());
+  dest->set_seek_nanos(dest->seek_nanos() + source.seek_nanos());
+  dest->set_next_nanos(dest->next_nanos() + source.next_nanos());
+  dest->set_block_read_nanos(dest->block_read_nanos() + source.block_read_nanos());
+  dest->set_block_decompress_nanos(
+      dest->block_decompress_nanos() + source.block_decompress_nanos());
+}
+
+} // namespace docdb
+} // namespace yb
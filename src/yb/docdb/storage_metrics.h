@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_STORAGE_METRICS_H
+#define YB_DOCDB_STORAGE_METRICS_H
+
+#include <stdint.h>
+
+#include "yb/util/monotime.h"
+#include "yb/util/stats/perf_level.h"
+
+namespace yb {
+
+class StorageMetricsPB;
+
+namespace docdb {
+
+// Per thread counters of the work done by DocDB, in addition to the ones of rocksdb::PerfContext.
+struct DocDBPerfContext {
+  // Number of the intents examined by the intent aware iterators.
+  uint64_t intents = 0;
+  // Number of the versions of the keys the regular DB iterators stepped over: the ones newer than
+  // the read time, and the older versions of a key, when moving past it with Next() instead of a
+  // seek. The versions jumped over by a seek are not counted.
+  uint64_t versions_skipped = 0;
+
+  void Reset() {
+    intents = 0;
+    versions_skipped = 0;
+  }
+};
+
+extern __thread DocDBPerfContext docdb_perf_context;
+
+// Collects the storage metrics of a read executed by the current thread, while in scope. Does
+// nothing if not enabled, so reads that did not ask for the metrics do not pay for the timers.
+// With PerfLevel::kEnableCount only the counts are collected, and the times are 0.
+class StorageMetricsCollector {
+ public:
+  explicit StorageMetricsCollector(bool enabled, PerfLevel level = PerfLevel::kEnableTime);
+  ~StorageMetricsCollector();
+
+  StorageMetricsCollector(const StorageMetricsCollector&) = delete;
+  void operator=(const StorageMetricsCollector&) = delete;
+
+  bool enabled() const { return enabled_; }
+
+  // Fills the metrics of the work done since the collector was created. Only if enabled.
+  void Fill(StorageMetricsPB* metrics) const;
+
+ private:
+  const bool enabled_;
+  PerfLevel prev_perf_level_ = PerfLevel::kDisable;
+  MonoTime start_;
+};
+
+// Adds the metrics of another read, e.g. of another tablet of the same query.
+void AddStorageMetrics(const StorageMetricsPB& source, StorageMetricsPB* dest);
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_STORAGE_METRICS_H
@@ -15,6 +15,7 @@
 
 #include <string>
 
+#include "yb/util/stopwatch.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -164,5 +165,48 @@ TEST(SubDocumentTest, TestCopyMove) {
   ASSERT_EQ(ValueType::kNullLow, s2.value_type());
 }
 
+TEST(SubDocumentTest, SetAndDeleteChildren) {
+  SubDocument d;
+  for (int i : {5, 1, 3, 2, 4}) {
+    d.SetChildPrimitive(PrimitiveValue(i), PrimitiveValue(i * 10));
+  }
+  d.SetChildPrimitive(PrimitiveValue(3), PrimitiveValue("three"));
+  ASSERT_TRUE(d.DeleteChild(PrimitiveValue(4)));
+  ASSERT_FALSE(d.DeleteChild(PrimitiveValue(4)));
+  ASSERT_EQ(4, d.object_num_keys());
+  ASSERT_FALSE(d.GetChild(PrimitiveValue(4)));
+  ASSERT_EQ("three", d.GetChild(PrimitiveValue(3))->GetString());
+  ASSERT_STR_EQ_VERBOSE_TRIMMED(R"#(
+{
+  1: 10,
+  2: 20,
+  3: "three",
+  5: 50
+}
+)#", d.ToString());
+}
+
+// Builds wide rows, the way DocDB reads fill them, and looks up all their columns.
+TEST(SubDocumentTest, YB_DISABLE_TEST_IN_TSAN(WideRowPerformance)) {
+  constexpr int kNumRows = 20000;
+  constexpr int kNumColumns = 50;
+
+  int64_t sum = 0;
+  LOG_TIMING(INFO, Format("Building and reading $0 rows of $1 columns", kNumRows, kNumColumns)) {
+    for (int row = 0; row != kNumRows; ++row) {
+      SubDocument doc;
+      for (int column = 0; column != kNumColumns; ++column) {
+        doc.SetChildPrimitive(PrimitiveValue(ColumnId(column)), PrimitiveValue(row + column));
+      }
+      for (int column = 0; column != kNumColumns; ++column) {
+        sum += doc.GetChild(PrimitiveValue(ColumnId(column)))->GetInt64();
+      }
+    }
+  }
+  ASSERT_EQ(static_cast<int64_t>(kNumRows) * kNumColumns * (kNumRows - 1) / 2 +
+                static_cast<int64_t>(kNumRows) * kNumColumns * (kNumColumns - 1) / 2,
+            sum);
+}
+
 } // namespace docdb
 } // namespace yb
@@ -210,16 +210,21 @@ pair<SubDocument*, bool> SubDocument::GetOrAddChild(const PrimitiveValue& key) {
   DCHECK(IsObjectType(type_));
   EnsureContainerAllocated();
   auto& obj_container = object_container();
-  auto iter = obj_container.find(key);
-  if (iter == obj_container.end()) {
-    auto ret = obj_container.insert(make_pair(key, SubDocument()));
-    CHECK(ret.second);
-    return make_pair(&ret.first->second, true);  // New subdocument created.
+  auto iter = obj_container.lower_bound(key);
+  if (iter == obj_container.end() || key < iter->first) {
+    iter = obj_container.emplace_hint(iter, key, SubDocument());
+    return make_pair(&iter->second, true);  // New subdocument created.
   } else {
     return make_pair(&iter->second, false);  // No new subdocument created.
   }
 }
 
+void SubDocument::ReserveChildren(size_t num_children) {
+  DCHECK(IsObjectType(type_));
+  EnsureContainerAllocated();
+  object_container().reserve(num_children);
+}
+
 void SubDocument::AddListElement(SubDocument&& value) {
   DCHECK_EQ(ValueType::kArray, type_);
   EnsureContainerAllocated();
@@ -230,10 +235,11 @@ void SubDocument::SetChild(const PrimitiveValue& key, SubDocument&& value) {
   type_ = ValueType::kObject;
   EnsureContainerAllocated();
   auto& obj_container = object_container();
-  auto existing_element = obj_container.find(key);
-  if (existing_element == obj_container.end()) {
-    const bool inserted_value = obj_container.emplace(key, std::move(value)).second;
-    CHECK(inserted_value);
+  // The children usually come in the key order, so the hint is the end and the insertion does not
+  // move the other children.
+  auto existing_element = obj_container.lower_bound(key);
+  if (existing_element == obj_container.end() || key < existing_element->first) {
+    obj_container.emplace_hint(existing_element, key, std::move(value));
   } else {
     existing_element->second = std::move(value);
   }
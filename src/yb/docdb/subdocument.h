@@ -14,11 +14,12 @@
 #ifndef YB_DOCDB_SUBDOCUMENT_H_
 #define YB_DOCDB_SUBDOCUMENT_H_
 
-#include <map>
 #include <vector>
 #include <ostream>
 #include <initializer_list>
 
+#include <boost/container/flat_map.hpp>
+
 #include "yb/docdb/primitive_value.h"
 #include "yb/util/bfql/tserver_opcodes.h"
 
@@ -96,7 +97,10 @@ class SubDocument : public PrimitiveValue {
   bool operator!=(const SubDocument& other) const { return !(*this == other); }
 
   // "using" did not let us use the alias when instantiating these classes, so we're using typedef.
-  typedef std::map<PrimitiveValue, SubDocument> ObjectContainer;
+  // Children of an object are kept in a vector sorted by the key, instead of a tree with a node
+  // per child. DocDB returns the children in the key order, so they are just appended, and the
+  // lookups of the columns of a row do a binary search over contiguous memory.
+  typedef boost::container::flat_map<PrimitiveValue, SubDocument> ObjectContainer;
   typedef std::vector<SubDocument> ArrayContainer;
 
   ObjectContainer& object_container() const {
@@ -140,6 +144,9 @@ class SubDocument : public PrimitiveValue {
   //         new child subdocument has been added.
   std::pair<SubDocument*, bool> GetOrAddChild(const PrimitiveValue& key);
 
+  // Preallocates space for the given number of children of an object.
+  void ReserveChildren(size_t num_children);
+
   // Add a list element child of the given value.
   void AddListElement(SubDocument&& value);
 
@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/common/ql_value.h"
+
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/docdb_test_util.h"
+#include "yb/docdb/table_image.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class TableImageTest : public DocDBTestBase {
+ protected:
+  static const Schema kSchema;
+
+  static KeyBytes RowKey(uint16_t hash, const std::string& h, int64_t r) {
+    return DocKey(hash, PrimitiveValues(h), PrimitiveValues(r)).Encode();
+  }
+
+  static KeyBytes HashPart(uint16_t hash, const std::string& h) {
+    KeyBytes result;
+    DocKeyEncoder(&result).Schema(kSchema).Hash(hash, PrimitiveValues(h));
+    return result;
+  }
+};
+
+const Schema TableImageTest::kSchema({
+        ColumnSchema("h", DataType::STRING, /* is_nullable = */ false, /* is_hash_key = */ true),
+        ColumnSchema("r", DataType::INT64, false),
+        // Non-key columns
+        ColumnSchema("v", DataType::STRING, true)
+    }, {
+        10_ColId,
+        20_ColId,
+        30_ColId
+    }, 2);
+
+TEST_F(TableImageTest, Build) {
+  ASSERT_OK(SetPrimitive(
+      DocPath(RowKey(1, "a", 1), PrimitiveValue(30_ColId)), PrimitiveValue("a1"),
+      HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(RowKey(1, "a", 2), PrimitiveValue(30_ColId)), PrimitiveValue("a2"),
+      HybridTime::FromMicros(1000)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(RowKey(2, "b", 1), PrimitiveValue(30_ColId)), PrimitiveValue("b1"),
+      HybridTime::FromMicros(1000)));
+  // Written after the image time, so not in the image.
+  ASSERT_OK(SetPrimitive(
+      DocPath(RowKey(1, "a", 2), PrimitiveValue(30_ColId)), PrimitiveValue("a2_prime"),
+      HybridTime::FromMicros(3000)));
+
+  auto image = ASSERT_RESULT(TableImage::Build(
+      kSchema, doc_db(), HybridTime::FromMicros(2000), 1_MB));
+  ASSERT_NE(image, nullptr);
+  ASSERT_EQ(3u, image->num_rows());
+  ASSERT_EQ(HybridTime::FromMicros(2000), image->hybrid_time());
+
+  const auto* rows = image->Find(HashPart(1, "a").AsSlice());
+  ASSERT_NE(rows, nullptr);
+  ASSERT_EQ(2u, rows->size());
+  QLValue value;
+  ASSERT_OK((*rows)[0].GetValue(20_ColId, &value));
+  ASSERT_EQ(1, value.int64_value());
+  ASSERT_OK((*rows)[1].GetValue(30_ColId, &value));
+  ASSERT_EQ("a2", value.string_value());
+
+  rows = image->Find(HashPart(2, "b").AsSlice());
+  ASSERT_NE(rows, nullptr);
+  ASSERT_EQ(1u, rows->size());
+  ASSERT_EQ(nullptr, image->Find(HashPart(3, "c").AsSlice()));
+
+  // Too big.
+  image = ASSERT_RESULT(TableImage::Build(kSchema, doc_db(), HybridTime::FromMicros(2000), 10));
+  ASSERT_EQ(image, nullptr);
+}
+
+TEST_F(TableImageTest, RowWithTtl) {
+  ASSERT_OK(SetPrimitive(
+      DocPath(RowKey(1, "a", 1), PrimitiveValue(30_ColId)),
+      Value(PrimitiveValue("a1"), MonoDelta::FromSeconds(1000)), HybridTime::FromMicros(1000)));
+
+  // The value would expire while the image is used.
+  auto image = ASSERT_RESULT(TableImage::Build(
+      kSchema, doc_db(), HybridTime::FromMicros(2000), 1_MB));
+  ASSERT_EQ(image, nullptr);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/table_image.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_rowwise_iterator.h"
+
+namespace yb {
+namespace docdb {
+
+Result<std::unique_ptr<TableImage>> TableImage::Build(
+    const Schema& schema, const DocDB& doc_db, HybridTime hybrid_time, size_t max_bytes) {
+  if (schema.num_hash_key_columns() == 0 || schema.has_statics() ||
+      schema.table_properties().HasDefaultTimeToLive()) {
+    return std::unique_ptr<TableImage>();
+  }
+  for (const auto& column : schema.columns()) {
+    if (column.type()->IsCollection()) {
+      return std::unique_ptr<TableImage>();
+    }
+  }
+
+  DocRowwiseIterator iter(
+      schema, schema, boost::none /* txn_op_context */, doc_db, CoarseTimePoint::max(),
+      ReadHybridTime::SingleTime(hybrid_time));
+  RETURN_NOT_OK(iter.Init());
+
+  std::unique_ptr<TableImage> image(new TableImage(hybrid_time));
+  Rows* rows = nullptr;
+  while (VERIFY_RESULT(iter.HasNext())) {
+    const Slice row_key = iter.row_key();
+    const auto sizes = VERIFY_RESULT(DocKey::EncodedHashPartAndDocKeySizes(row_key));
+    const Slice hash_part(row_key.data(), sizes.first);
+    // Rows of a partition are adjacent, so a new partition starts when the hash part changes.
+    if (rows == nullptr || hash_part != image->hash_parts_.back()) {
+      image->hash_parts_.push_back(hash_part.ToBuffer());
+      rows = &image->partitions_[image->hash_parts_.back()];
+    }
+
+    QLTableRow row;
+    RETURN_NOT_OK(iter.NextRow(&row));
+    image->bytes_ += sizes.second;
+    for (size_t idx = schema.num_key_columns(); idx < schema.num_columns(); ++idx) {
+      const auto column_id = schema.column_id(idx);
+      int64_t ttl_seconds = -1;
+      if (row.GetTTL(column_id, &ttl_seconds).ok() && ttl_seconds != -1) {
+        return std::unique_ptr<TableImage>();
+      }
+      const auto* value = row.GetColumn(column_id);
+      if (value != nullptr) {
+        image->bytes_ += value->ByteSize();
+      }
+    }
+    if (image->bytes_ > max_bytes) {
+      return std::unique_ptr<TableImage>();
+    }
+    rows->push_back(std::move(row));
+    ++image->num_rows_;
+  }
+  return image;
+}
+
+const TableImage::Rows* TableImage::Find(const Slice& hash_part) const {
+  auto it = partitions_.find(hash_part);
+  return it != partitions_.end() ? &it->second : nullptr;
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,85 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_DOCDB_TABLE_IMAGE_H_
+#define YB_DOCDB_TABLE_IMAGE_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/common/ql_expr.h"
+#include "yb/common/schema.h"
+
+#include "yb/docdb/docdb_fwd.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Memory-resident image of all rows of a small YCQL table, as of a hybrid time, so the reads of
+// a single partition of the table are answered without reading RocksDB. Used for the reference
+// tables that are read on almost every request and rarely updated, i.e. tables created with
+// caching = {'rows_per_partition': 'ALL'}.
+//
+// The rows of each partition are kept in the order of their primary keys, keyed by the encoded
+// hash part of their DocKeys. The image holds only the rows as of its hybrid time, so it should be
+// dropped as soon as a newer write is applied to the table.
+//
+// The image is immutable after it is built, so it could be shared by concurrent reads.
+class TableImage {
+ public:
+  typedef std::vector<QLTableRow> Rows;
+
+  // Reads all rows of the table at hybrid_time. Returns nullptr when the table could not be
+  // imaged: when it has static or collection columns, no hash columns, a default TTL, rows with a
+  // TTL of their own, or when the rows take more than max_bytes.
+  static Result<std::unique_ptr<TableImage>> Build(
+      const Schema& schema, const DocDB& doc_db, HybridTime hybrid_time, size_t max_bytes);
+
+  // Rows of the partition with the given encoded hash part of the DocKey, nullptr if there are no
+  // rows in the partition.
+  const Rows* Find(const Slice& hash_part) const;
+
+  HybridTime hybrid_time() const { return hybrid_time_; }
+
+  size_t num_rows() const { return num_rows_; }
+
+  // Approximate size of the values of the rows.
+  size_t bytes() const { return bytes_; }
+
+ private:
+  explicit TableImage(HybridTime hybrid_time) : hybrid_time_(hybrid_time) {}
+
+  const HybridTime hybrid_time_;
+  size_t num_rows_ = 0;
+  size_t bytes_ = 0;
+  // Encoded hash parts of the partitions, the keys of partitions_ point to them.
+  std::deque<std::string> hash_parts_;
+  std::unordered_map<Slice, Rows, Slice::Hash> partitions_;
+
+  DISALLOW_COPY_AND_ASSIGN(TableImage);
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_TABLE_IMAGE_H_
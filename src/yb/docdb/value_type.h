@@ -70,11 +70,14 @@ namespace docdb {
     ((kSSReverse, '\'')) /* ASCII code 39 */ \
     ((kRedisSet, '(')) /* ASCII code 40 */ \
     ((kRedisList, ')')) /* ASCII code 41*/ \
+    /* No live element of a redis list has an array index below the head or above the tail. */ \
+    ((kRedisListHead, '*')) /* ASCII code 42 */ \
     /* This is the redis timeseries type. */ \
     ((kRedisTS, '+')) /* ASCII code 43 */ \
     ((kRedisSortedSet, ',')) /* ASCII code 44 */ \
     ((kInetaddress, '-'))  /* ASCII code 45 */ \
     ((kInetaddressDescending, '.'))  /* ASCII code 46 */ \
+    ((kRedisListTail, '/')) /* ASCII code 47 */ \
     ((kPgTableOid, '0')) /* ASCII code 48 */ \
     ((kJsonb, '2')) /* ASCII code 50 */ \
     ((kFrozen, '<')) /* ASCII code 60 */ \
@@ -128,6 +131,8 @@ namespace docdb {
     ((kWriteId, 'w')) /* ASCII code 119 */ \
     ((kTransactionId, 'x')) /* ASCII code 120 */ \
     ((kTableId, 'y')) /* ASCII code 121 */ \
+    /* All non-key columns of a row packed into a single value, see packed_row.h. */ \
+    ((kPackedRow, 'z')) /* ASCII code 122 */ \
     \
     ((kObject, '{'))  /* ASCII code 123 */ \
     \
@@ -1999,6 +1999,40 @@ TEST_F_EX(CppCassandraDriverTest, TestIndexUpdateConcurrentTxn, CppCassandraDriv
   EXPECT_EQ(main_table_size, index_table_size);
 }
 
+TEST_F_EX(CppCassandraDriverTest, UpdateUnindexedColumns, CppCassandraDriverTestIndex) {
+  TestTable<cass_int32_t, cass_int32_t, cass_int32_t, cass_int32_t> table;
+  ASSERT_OK(table.CreateTable(
+      &session_, "test.test_table", {"k", "v", "c", "x"}, {"(k)"}, true, 60s));
+  ASSERT_OK(session_.ExecuteQuery(
+      "create index test_table_index_by_v on test_table (v) include (c);"));
+  WaitUntilIndexPermissionIsAtLeast(
+      client_.get(), YBTableName(YQL_DATABASE_CQL, "test", "test_table"),
+      YBTableName(YQL_DATABASE_CQL, "test", "test_table_index_by_v"),
+      IndexPermissions::INDEX_PERM_READ_WRITE_AND_DELETE);
+  ASSERT_OK(session_.ExecuteQuery("insert into test_table (k, v, c, x) values (1, 10, 100, 0);"));
+
+  // Writes that change neither the indexed nor the covering columns leave the index entry as it is.
+  ASSERT_OK(session_.ExecuteQuery("update test_table set x = 1 where k = 1;"));
+  ASSERT_OK(session_.ExecuteQuery("update test_table set v = 10, x = 2 where k = 1;"));
+  ASSERT_OK(session_.ExecuteQuery("update test_table set c = 101 where k = 1;"));
+  ASSERT_OK(session_.ExecuteQuery("update test_table set v = 11 where k = 1;"));
+
+  auto result = ASSERT_RESULT(session_.ExecuteWithResult(
+      "select k, v, c, x from test_table where v = 11;"));
+  auto iterator = result.CreateIterator();
+  ASSERT_TRUE(iterator.Next());
+  auto row = iterator.Row();
+  ASSERT_EQ(row.Value(0).As<int>(), 1);
+  ASSERT_EQ(row.Value(2).As<int>(), 101);
+  ASSERT_EQ(row.Value(3).As<int>(), 2);
+  ASSERT_FALSE(iterator.Next());
+
+  auto main_table_size = ASSERT_RESULT(GetTableSize(&session_, "test_table"));
+  auto index_table_size = ASSERT_RESULT(GetTableSize(&session_, "test_table_index_by_v"));
+  ASSERT_EQ(main_table_size, 1);
+  ASSERT_EQ(index_table_size, 1);
+}
+
 TEST_F_EX(CppCassandraDriverTest, ConcurrentIndexUpdate, CppCassandraDriverTestIndex) {
   constexpr int kLoops = 20;
   constexpr int kKeys = 30;
@@ -2307,6 +2341,40 @@ TEST_F(CppCassandraDriverTest, TestInsertLocality) {
   ASSERT_GT(delta_metrics.local_write*10, total_keys*7);
 }
 
+TEST_F(CppCassandraDriverTest, BatchWritesOfSameRow) {
+  ASSERT_OK(session_.ExecuteQuery(
+      "CREATE TABLE test.batch_rows (h INT, r INT, v1 INT, v2 INT, PRIMARY KEY ((h), r))"));
+
+  // Writes of the same row in a batch are merged, the result is the same as when they are applied
+  // one after another.
+  CassandraStatement insert1("INSERT INTO test.batch_rows (h, r, v1, v2) VALUES (1, 1, 10, 20)");
+  CassandraStatement update1("UPDATE test.batch_rows SET v2 = 21 WHERE h = 1 AND r = 1");
+  CassandraStatement insert2("INSERT INTO test.batch_rows (h, r, v1) VALUES (1, 1, 11)");
+  CassandraStatement insert3("INSERT INTO test.batch_rows (h, r, v1, v2) VALUES (1, 2, 30, 40)");
+  CassandraStatement delete3("DELETE FROM test.batch_rows WHERE h = 1 AND r = 2");
+  CassandraStatement update3("UPDATE test.batch_rows SET v1 = 31 WHERE h = 1 AND r = 2");
+  CassandraBatch batch(CassBatchType::CASS_BATCH_TYPE_UNLOGGED);
+  for (auto* statement : {&insert1, &update1, &insert2, &insert3, &delete3, &update3}) {
+    batch.Add(statement);
+  }
+  ASSERT_OK(session_.ExecuteBatch(batch));
+
+  auto result = ASSERT_RESULT(session_.ExecuteWithResult(
+      "SELECT r, v1, v2 FROM test.batch_rows WHERE h = 1"));
+  auto iterator = result.CreateIterator();
+  ASSERT_TRUE(iterator.Next());
+  auto row = iterator.Row();
+  ASSERT_EQ(row.Value(0).As<int>(), 1);
+  ASSERT_EQ(row.Value(1).As<int>(), 11);
+  ASSERT_EQ(row.Value(2).As<int>(), 21);
+  // The delete is not merged with the writes of the row around it.
+  ASSERT_TRUE(iterator.Next());
+  row = iterator.Row();
+  ASSERT_EQ(row.Value(0).As<int>(), 2);
+  ASSERT_EQ(row.Value(1).As<int>(), 31);
+  ASSERT_FALSE(iterator.Next());
+}
+
 class CppCassandraDriverLowSoftLimitTest : public CppCassandraDriverTest {
  public:
   std::vector<std::string> ExtraTServerFlags() override {
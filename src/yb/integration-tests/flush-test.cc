@@ -31,6 +31,7 @@
 using namespace std::literals;
 
 DECLARE_bool(flush_rocksdb_on_shutdown);
+DECLARE_bool(global_memstore_flush_by_size_and_age);
 DECLARE_int64(global_memstore_size_percentage);
 DECLARE_int64(global_memstore_size_mb_max);
 DECLARE_int32(memstore_size_mb);
@@ -252,6 +253,9 @@ TEST_F(FlushITest, TestFlushHappens) {
 }
 
 void FlushITest::TestFlushPicksOldestInactiveTabletAfterCompaction(bool with_restart) {
+  // Checks the order of flushes by the oldest write.
+  FLAGS_global_memstore_flush_by_size_and_age = false;
+
   // Trigger compaction early.
   FLAGS_rocksdb_level0_file_num_compaction_trigger = 2;
 
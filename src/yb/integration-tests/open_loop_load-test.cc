@@ -0,0 +1,226 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <sstream>
+
+#include "yb/gutil/strings/split.h"
+
+#include "yb/integration-tests/open_loop_load.h"
+
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace load_generator {
+
+namespace {
+
+class FakeSession : public OpenLoopSession {
+ public:
+  explicit FakeSession(MonoDelta latency) : latency_(latency) {}
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    return Wait();
+  }
+
+  CHECKED_STATUS Write(const std::string& key, const std::string& value) override {
+    return Wait();
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int limit) override {
+    RETURN_NOT_OK(Wait());
+    return STATUS(NotSupported, "Scans are not supported");
+  }
+
+  CHECKED_STATUS Transaction(
+      const std::vector<std::pair<std::string, std::string>>& key_values) override {
+    return Wait();
+  }
+
+ private:
+  CHECKED_STATUS Wait() {
+    if (latency_ > MonoDelta::kZero) {
+      SleepFor(latency_);
+    }
+    return Status::OK();
+  }
+
+  const MonoDelta latency_;
+};
+
+OpenLoopSessionFactory FakeSessionFactory(MonoDelta latency) {
+  return [latency]() -> Result<std::unique_ptr<OpenLoopSession>> {
+    return std::unique_ptr<OpenLoopSession>(new FakeSession(latency));
+  };
+}
+
+// Returns the fields of the total line of the given operation type in the output.
+std::vector<std::string> TotalLine(const std::string& output, OpenLoopOpType op_type) {
+  std::vector<std::string> lines = strings::Split(output, "\n");
+  for (const auto& line : lines) {
+    std::vector<std::string> fields = strings::Split(line, ",");
+    if (fields.size() == 10 && fields[0] == "total" && fields[1] == ToString(op_type)) {
+      return fields;
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+class OpenLoopLoadTest : public YBTest {
+};
+
+TEST_F(OpenLoopLoadTest, KeyDistributions) {
+  constexpr int kNumKeys = 1000;
+  constexpr int kSamples = 100000;
+  std::mt19937_64 rng(GetRandomSeed32());
+
+  OpenLoopOptions options;
+  options.num_keys = kNumKeys;
+
+  options.key_distribution = OpenLoopKeyDistribution::zipfian;
+  {
+    OpenLoopKeyGenerator generator(options);
+    std::vector<int> counts(kNumKeys);
+    for (int i = 0; i != kSamples; ++i) {
+      auto key = generator.Next(&rng);
+      ASSERT_GE(key, 0);
+      ASSERT_LT(key, kNumKeys);
+      ++counts[key];
+    }
+    // With the constant of 0.99 the most popular key takes more than 10% of the requests, while
+    // the less popular half of the keys together take less than 15%.
+    ASSERT_GT(counts[0], kSamples / 10);
+    ASSERT_GT(counts[0], counts[1]);
+    int tail = 0;
+    for (int key = kNumKeys / 2; key != kNumKeys; ++key) {
+      tail += counts[key];
+    }
+    ASSERT_LT(tail, kSamples * 15 / 100);
+  }
+
+  options.key_distribution = OpenLoopKeyDistribution::hotspot;
+  {
+    OpenLoopKeyGenerator generator(options);
+    int hot = 0;
+    for (int i = 0; i != kSamples; ++i) {
+      auto key = generator.Next(&rng);
+      ASSERT_GE(key, 0);
+      ASSERT_LT(key, kNumKeys);
+      if (key < kNumKeys * options.hotspot_key_fraction) {
+        ++hot;
+      }
+    }
+    ASSERT_NEAR(options.hotspot_access_fraction, static_cast<double>(hot) / kSamples, 0.02);
+  }
+
+  options.key_distribution = OpenLoopKeyDistribution::latest;
+  {
+    OpenLoopKeyGenerator generator(options);
+    for (int i = 0; i != kNumKeys; ++i) {
+      ASSERT_EQ(kNumKeys + i, generator.NextToWrite(&rng));
+    }
+    int recent = 0;
+    for (int i = 0; i != kSamples; ++i) {
+      auto key = generator.Next(&rng);
+      ASSERT_LT(key, 2 * kNumKeys);
+      if (key >= 2 * kNumKeys - 10) {
+        ++recent;
+      }
+    }
+    ASSERT_GT(recent, kSamples / 3);
+  }
+
+  options.key_distribution = OpenLoopKeyDistribution::uniform;
+  {
+    OpenLoopKeyGenerator generator(options);
+    for (int i = 0; i != kSamples; ++i) {
+      auto key = generator.Next(&rng);
+      ASSERT_GE(key, 0);
+      ASSERT_LT(key, kNumKeys);
+    }
+  }
+
+  ASSERT_EQ(OpenLoopKeyDistribution::hotspot,
+            ASSERT_RESULT(ParseOpenLoopKeyDistribution("hotspot")));
+  ASSERT_NOK(ParseOpenLoopKeyDistribution("pareto"));
+}
+
+// Requests are issued at the requested rate and mix, with the failures counted.
+TEST_F(OpenLoopLoadTest, Rate) {
+  OpenLoopOptions options;
+  options.requests_per_sec = 2000;
+  options.duration = 2s;
+  options.num_threads = 4;
+  options.num_keys = 100;
+  options.weights[to_underlying(OpenLoopOpType::read)] = 2;
+  options.weights[to_underlying(OpenLoopOpType::write)] = 1;
+  options.weights[to_underlying(OpenLoopOpType::scan)] = 1;
+  options.weights[to_underlying(OpenLoopOpType::transaction)] = 0;
+  bool started = false;
+  options.on_start = [&started] { started = true; };
+
+  OpenLoopLoad load(options, FakeSessionFactory(MonoDelta::kZero));
+  std::stringstream out;
+  ASSERT_OK(load.Run(&out));
+  ASSERT_TRUE(started);
+  LOG(INFO) << "Output:\n" << out.str();
+
+  int64_t total = 0;
+  for (auto op_type : kOpenLoopOpTypeList) {
+    total += load.num_requests(op_type);
+  }
+  // The schedule has exactly this number of requests.
+  ASSERT_EQ(4000, total);
+  ASSERT_NEAR(2000, load.num_requests(OpenLoopOpType::read), 200);
+  ASSERT_NEAR(1000, load.num_requests(OpenLoopOpType::write), 200);
+  ASSERT_EQ(0, load.num_requests(OpenLoopOpType::transaction));
+  ASSERT_EQ(0, load.num_errors(OpenLoopOpType::read));
+  ASSERT_EQ(load.num_requests(OpenLoopOpType::scan), load.num_errors(OpenLoopOpType::scan));
+  ASSERT_EQ(10u, TotalLine(out.str(), OpenLoopOpType::read).size());
+  ASSERT_TRUE(TotalLine(out.str(), OpenLoopOpType::transaction).empty());
+}
+
+// When the requests take longer than the interval between them, the following requests wait, and
+// the time they waited is a part of the measured latency.
+TEST_F(OpenLoopLoadTest, LatencyIncludesQueueing) {
+  OpenLoopOptions options;
+  options.requests_per_sec = 100;
+  options.duration = 1s;
+  options.num_threads = 1;
+  options.preload = false;
+  options.weights[to_underlying(OpenLoopOpType::write)] = 0;
+
+  OpenLoopLoad load(options, FakeSessionFactory(20ms));
+  std::stringstream out;
+  ASSERT_OK(load.Run(&out));
+  LOG(INFO) << "Output:\n" << out.str();
+
+  ASSERT_EQ(100, load.num_requests(OpenLoopOpType::read));
+  auto fields = TotalLine(out.str(), OpenLoopOpType::read);
+  ASSERT_EQ(10u, fields.size());
+  // A closed loop would have measured 20ms for each request. Here the last request was scheduled
+  // at 990ms, but started after the previous 99 requests took 1980ms.
+  const auto max_latency_us = std::stoll(fields[9]);
+  ASSERT_GT(max_latency_us, 900000);
+  ASSERT_EQ(100u, load.latencies(OpenLoopOpType::read).TotalCount());
+  ASSERT_EQ(static_cast<uint64_t>(max_latency_us), load.latencies(OpenLoopOpType::read).MaxValue());
+}
+
+} // namespace load_generator
+} // namespace yb
@@ -0,0 +1,499 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/integration-tests/open_loop_load.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+#include <glog/logging.h>
+
+#include "yb/client/error.h"
+#include "yb/client/session.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/transaction.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/common/ql_protocol_util.h"
+
+#include "yb/gutil/stringprintf.h"
+
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/logging.h"
+#include "yb/util/random_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace load_generator {
+
+namespace {
+
+// Latencies above it are recorded as it.
+constexpr int64_t kMaxLatencyUs = 600LL * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+double Zeta(int64_t n, double theta) {
+  double result = 0;
+  for (int64_t i = 1; i <= n; ++i) {
+    result += 1 / std::pow(static_cast<double>(i), theta);
+  }
+  return result;
+}
+
+std::string RandomValue(size_t size, std::mt19937_64* rng) {
+  static const char kChars[] = "0123456789abcdef";
+  std::string result(size, 0);
+  for (auto& c : result) {
+    c = kChars[(*rng)() & 0xf];
+  }
+  return result;
+}
+
+class YcqlOpenLoopSession : public OpenLoopSession {
+ public:
+  YcqlOpenLoopSession(
+      client::YBClient* client, client::TableHandle* table,
+      client::TransactionManager* transaction_manager)
+      : table_(table), transaction_manager_(transaction_manager),
+        session_(client->NewSession()) {
+    session_->SetTimeout(60s);
+  }
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    auto op = table_->NewReadOp();
+    QLAddStringHashValue(op->mutable_request(), key);
+    table_->AddColumns({"k", "v"}, op->mutable_request());
+    return ApplyAndFlush(op);
+  }
+
+  CHECKED_STATUS Write(const std::string& key, const std::string& value) override {
+    auto op = NewWriteOp(key, value);
+    return ApplyAndFlush(op);
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int limit) override {
+    // Rows of a hash partitioned table are ordered by the hash, so the scan reads the rows starting
+    // from the hash of the key, in the tablet of the key.
+    auto op = table_->NewReadOp();
+    auto* req = op->mutable_request();
+    QLAddStringHashValue(req, start_key);
+    QLSetHashCode(req);
+    req->clear_hashed_column_values();
+    req->set_limit(limit);
+    table_->AddColumns({"k", "v"}, req);
+    return ApplyAndFlush(op);
+  }
+
+  CHECKED_STATUS Transaction(
+      const std::vector<std::pair<std::string, std::string>>& key_values) override {
+    if (!transaction_manager_) {
+      return STATUS(NotSupported, "Transactions need a transactional table");
+    }
+    auto transaction = std::make_shared<client::YBTransaction>(transaction_manager_);
+    RETURN_NOT_OK(transaction->Init(IsolationLevel::SNAPSHOT_ISOLATION));
+    session_->SetTransaction(transaction);
+    std::vector<client::YBqlWriteOpPtr> ops;
+    for (const auto& key_value : key_values) {
+      ops.push_back(NewWriteOp(key_value.first, key_value.second));
+    }
+    auto status = Flush(ops);
+    session_->SetTransaction(nullptr);
+    if (!status.ok()) {
+      transaction->Abort();
+      return status;
+    }
+    return transaction->CommitFuture().get();
+  }
+
+ private:
+  client::YBqlWriteOpPtr NewWriteOp(const std::string& key, const std::string& value) {
+    auto op = table_->NewInsertOp();
+    QLAddStringHashValue(op->mutable_request(), key);
+    table_->AddStringColumnValue(op->mutable_request(), "v", value);
+    return op;
+  }
+
+  template <class Op>
+  CHECKED_STATUS ApplyAndFlush(const std::shared_ptr<Op>& op) {
+    return Flush(std::vector<std::shared_ptr<Op>>{op});
+  }
+
+  template <class Op>
+  CHECKED_STATUS Flush(const std::vector<std::shared_ptr<Op>>& ops) {
+    for (const auto& op : ops) {
+      RETURN_NOT_OK(session_->Apply(op));
+    }
+    auto status = session_->Flush();
+    if (!status.ok()) {
+      auto errors = session_->GetPendingErrors();
+      return errors.empty() ? status : errors.front()->status();
+    }
+    for (const auto& op : ops) {
+      if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+        return STATUS_FORMAT(RemoteError, "$0 failed: $1", op->ToString(),
+                             op->response().error_message());
+      }
+    }
+    return Status::OK();
+  }
+
+  client::TableHandle* const table_;
+  client::TransactionManager* const transaction_manager_;
+  const client::YBSessionPtr session_;
+};
+
+} // namespace
+
+Result<OpenLoopKeyDistribution> ParseOpenLoopKeyDistribution(const std::string& name) {
+  for (auto distribution : kOpenLoopKeyDistributionList) {
+    if (name == ToCString(distribution)) {
+      return distribution;
+    }
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", name);
+}
+
+std::string OpenLoopKey(int64_t key_index) {
+  return Format("key$0", key_index);
+}
+
+OpenLoopKeyGenerator::OpenLoopKeyGenerator(const OpenLoopOptions& options)
+    : distribution_(options.key_distribution),
+      num_keys_(std::max<int64_t>(options.num_keys, 1)),
+      hotspot_keys_(std::max(1.0, options.hotspot_key_fraction * num_keys_)),
+      hotspot_access_fraction_(options.hotspot_access_fraction),
+      next_insert_(num_keys_) {
+  if (distribution_ == OpenLoopKeyDistribution::zipfian ||
+      distribution_ == OpenLoopKeyDistribution::latest) {
+    theta_ = options.zipfian_constant;
+    zeta_n_ = Zeta(num_keys_, theta_);
+    alpha_ = 1 / (1 - theta_);
+    eta_ = (1 - std::pow(2.0 / num_keys_, 1 - theta_)) / (1 - Zeta(2, theta_) / zeta_n_);
+  }
+}
+
+int64_t OpenLoopKeyGenerator::NextZipfian(std::mt19937_64* rng) const {
+  const double u = std::uniform_real_distribution<double>()(*rng);
+  const double uz = u * zeta_n_;
+  if (uz < 1) {
+    return 0;
+  }
+  if (uz < 1 + std::pow(0.5, theta_)) {
+    return std::min<int64_t>(1, num_keys_ - 1);
+  }
+  const auto result = static_cast<int64_t>(num_keys_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+  return std::min(result, num_keys_ - 1);
+}
+
+int64_t OpenLoopKeyGenerator::Next(std::mt19937_64* rng) const {
+  switch (distribution_) {
+    case OpenLoopKeyDistribution::uniform:
+      return std::uniform_int_distribution<int64_t>(0, num_keys_ - 1)(*rng);
+    case OpenLoopKeyDistribution::zipfian:
+      // The rank is used as the key index. The hot keys are still spread over the tablets, since
+      // the tables are hash partitioned.
+      return NextZipfian(rng);
+    case OpenLoopKeyDistribution::hotspot: {
+      const auto hot_keys = std::min(static_cast<int64_t>(hotspot_keys_), num_keys_);
+      if (hot_keys == num_keys_ ||
+          std::uniform_real_distribution<double>()(*rng) < hotspot_access_fraction_) {
+        return std::uniform_int_distribution<int64_t>(0, hot_keys - 1)(*rng);
+      }
+      return std::uniform_int_distribution<int64_t>(hot_keys, num_keys_ - 1)(*rng);
+    }
+    case OpenLoopKeyDistribution::latest: {
+      const auto latest = next_insert_.load(std::memory_order_acquire) - 1;
+      return std::max<int64_t>(latest - NextZipfian(rng), 0);
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(OpenLoopKeyDistribution, distribution_);
+}
+
+int64_t OpenLoopKeyGenerator::NextToWrite(std::mt19937_64* rng) {
+  if (distribution_ == OpenLoopKeyDistribution::latest) {
+    return next_insert_.fetch_add(1, std::memory_order_acq_rel);
+  }
+  return Next(rng);
+}
+
+class OpenLoopLoad::Impl {
+ public:
+  Impl(const OpenLoopOptions& options, OpenLoopSessionFactory session_factory)
+      : options_(options), session_factory_(std::move(session_factory)),
+        key_generator_(options) {
+    for (auto op_type : kOpenLoopOpTypeList) {
+      auto& stats = stats_[to_underlying(op_type)];
+      stats.total.reset(new HdrHistogram(kMaxLatencyUs, kLatencySignificantDigits));
+      stats.interval.reset(new HdrHistogram(kMaxLatencyUs, kLatencySignificantDigits));
+      total_weight_ += std::max(options_.weights[to_underlying(op_type)], 0);
+    }
+  }
+
+  CHECKED_STATUS Run(std::ostream* out) {
+    if (options_.requests_per_sec <= 0 || options_.num_threads <= 0 || total_weight_ <= 0 ||
+        options_.report_interval <= MonoDelta::kZero) {
+      return STATUS(InvalidArgument,
+                    "The rate, number of threads, weights and report interval should be positive");
+    }
+    if (options_.zipfian_constant <= 0 || options_.zipfian_constant >= 1) {
+      return STATUS_FORMAT(InvalidArgument, "The zipfian constant should be in (0, 1): $0",
+                           options_.zipfian_constant);
+    }
+
+    std::vector<std::unique_ptr<OpenLoopSession>> sessions;
+    for (int i = 0; i != options_.num_threads; ++i) {
+      sessions.push_back(VERIFY_RESULT(session_factory_()));
+    }
+
+    if (options_.preload) {
+      RETURN_NOT_OK(Preload(&sessions));
+    }
+
+    *out << "time_sec,op,requests,errors,mean_us,p50_us,p90_us,p99_us,p99.9_us,max_us"
+         << std::endl;
+
+    if (options_.on_start) {
+      options_.on_start();
+    }
+    start_ = MonoTime::Now();
+    end_ = start_ + options_.duration;
+    std::vector<std::thread> threads;
+    for (int i = 0; i != options_.num_threads; ++i) {
+      threads.emplace_back([this, i, session = sessions[i].get()] {
+        RunThread(i, session);
+      });
+    }
+
+    for (int interval = 1;; ++interval) {
+      const auto report_time = start_ + options_.report_interval * interval;
+      const bool last = report_time >= end_;
+      SleepUntil(std::min(report_time, end_));
+      const double time_sec = (std::min(report_time, end_) - start_).ToSeconds();
+      for (auto op_type : kOpenLoopOpTypeList) {
+        auto& stats = stats_[to_underlying(op_type)];
+        if (options_.weights[to_underlying(op_type)] <= 0) {
+          continue;
+        }
+        // The requests recorded between the copy and the reset are only lost for the time series.
+        HdrHistogram interval_histogram(*stats.interval);
+        stats.interval->ResetPercentiles();
+        Report(StringPrintf("%.1f", time_sec), op_type, interval_histogram,
+               stats.interval_errors.exchange(0, std::memory_order_acq_rel), out);
+      }
+      if (last) {
+        break;
+      }
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (auto op_type : kOpenLoopOpTypeList) {
+      if (options_.weights[to_underlying(op_type)] <= 0) {
+        continue;
+      }
+      const auto& stats = stats_[to_underlying(op_type)];
+      Report("total", op_type, *stats.total, stats.errors.load(std::memory_order_acquire), out);
+    }
+    if (max_lag_us_.load() > 0) {
+      LOG(WARNING) << "The requests were issued up to " << max_lag_us_.load() << "us late, "
+                   << "consider using more threads";
+    }
+    return Status::OK();
+  }
+
+  int64_t num_requests(OpenLoopOpType op_type) const {
+    return stats_[to_underlying(op_type)].total->TotalCount();
+  }
+
+  int64_t num_errors(OpenLoopOpType op_type) const {
+    return stats_[to_underlying(op_type)].errors.load(std::memory_order_acquire);
+  }
+
+  const HdrHistogram& latencies(OpenLoopOpType op_type) const {
+    return *stats_[to_underlying(op_type)].total;
+  }
+
+ private:
+  struct OpStats {
+    std::unique_ptr<HdrHistogram> total;
+    std::unique_ptr<HdrHistogram> interval;
+    std::atomic<int64_t> errors{0};
+    std::atomic<int64_t> interval_errors{0};
+  };
+
+  static void SleepUntil(MonoTime time) {
+    const auto now = MonoTime::Now();
+    if (time > now) {
+      SleepFor(time - now);
+    }
+  }
+
+  CHECKED_STATUS Preload(std::vector<std::unique_ptr<OpenLoopSession>>* sessions) {
+    LOG(INFO) << "Writing " << options_.num_keys << " keys";
+    std::atomic<int64_t> failed{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i != sessions->size(); ++i) {
+      threads.emplace_back([this, i, &failed, session = (*sessions)[i].get(),
+                            num_threads = sessions->size()] {
+        std::mt19937_64 rng(GetRandomSeed32() + i);
+        for (int64_t key = i; key < options_.num_keys; key += num_threads) {
+          auto status = session->Write(OpenLoopKey(key), RandomValue(options_.value_size, &rng));
+          if (!status.ok()) {
+            YB_LOG_EVERY_N_SECS(WARNING, 5) << "Failed to write key " << key << ": " << status;
+            failed.fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    if (failed.load() > 0) {
+      return STATUS_FORMAT(RuntimeError, "Failed to write $0 of $1 keys", failed.load(),
+                           options_.num_keys);
+    }
+    return Status::OK();
+  }
+
+  OpenLoopOpType PickOpType(std::mt19937_64* rng) const {
+    int value = std::uniform_int_distribution<int>(0, total_weight_ - 1)(*rng);
+    for (auto op_type : kOpenLoopOpTypeList) {
+      value -= std::max(options_.weights[to_underlying(op_type)], 0);
+      if (value < 0) {
+        return op_type;
+      }
+    }
+    LOG(DFATAL) << "Weight out of range: " << value;
+    return OpenLoopOpType::read;
+  }
+
+  CHECKED_STATUS Execute(OpenLoopOpType op_type, OpenLoopSession* session, std::mt19937_64* rng) {
+    switch (op_type) {
+      case OpenLoopOpType::read:
+        return session->Read(OpenLoopKey(key_generator_.Next(rng)));
+      case OpenLoopOpType::write:
+        return session->Write(OpenLoopKey(key_generator_.NextToWrite(rng)),
+                              RandomValue(options_.value_size, rng));
+      case OpenLoopOpType::scan:
+        return session->Scan(OpenLoopKey(key_generator_.Next(rng)), options_.scan_length);
+      case OpenLoopOpType::transaction: {
+        std::vector<std::pair<std::string, std::string>> key_values;
+        for (int i = 0; i != options_.transaction_keys; ++i) {
+          key_values.emplace_back(OpenLoopKey(key_generator_.NextToWrite(rng)),
+                                  RandomValue(options_.value_size, rng));
+        }
+        return session->Transaction(key_values);
+      }
+    }
+    FATAL_INVALID_ENUM_VALUE(OpenLoopOpType, op_type);
+  }
+
+  void RunThread(int index, OpenLoopSession* session) {
+    std::mt19937_64 rng(GetRandomSeed32() + index);
+    // Each thread takes every num_threads request of the schedule.
+    const auto request_interval = MonoDelta::FromNanoseconds(
+        static_cast<int64_t>(1e9 / options_.requests_per_sec));
+    const auto thread_interval = request_interval * options_.num_threads;
+    for (auto scheduled = start_ + request_interval * index; scheduled < end_;
+         scheduled += thread_interval) {
+      const auto now = MonoTime::Now();
+      if (scheduled > now) {
+        SleepFor(scheduled - now);
+      } else {
+        UpdateMaxLag((now - scheduled).ToMicroseconds());
+      }
+
+      const auto op_type = PickOpType(&rng);
+      auto status = Execute(op_type, session, &rng);
+      // The latency is measured from the scheduled time, to account for the time the request
+      // waited for the previous request of this thread.
+      const auto latency_us = std::min((MonoTime::Now() - scheduled).ToMicroseconds(),
+                                       kMaxLatencyUs);
+      auto& stats = stats_[to_underlying(op_type)];
+      stats.total->Increment(latency_us);
+      stats.interval->Increment(latency_us);
+      if (!status.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 5) << op_type << " failed: " << status;
+        stats.errors.fetch_add(1, std::memory_order_acq_rel);
+        stats.interval_errors.fetch_add(1, std::memory_order_acq_rel);
+      }
+    }
+  }
+
+  void UpdateMaxLag(int64_t lag_us) {
+    auto current = max_lag_us_.load(std::memory_order_acquire);
+    while (lag_us > current && !max_lag_us_.compare_exchange_weak(current, lag_us)) {}
+  }
+
+  static void Report(const std::string& time, OpenLoopOpType op_type,
+                     const HdrHistogram& histogram, int64_t errors, std::ostream* out) {
+    const bool empty = histogram.CurrentCount() == 0;
+    *out << time << "," << op_type << "," << histogram.CurrentCount() << "," << errors << ","
+         << StringPrintf("%.1f", empty ? 0.0 : histogram.MeanValue()) << ","
+         << (empty ? 0 : histogram.ValueAtPercentile(50)) << ","
+         << (empty ? 0 : histogram.ValueAtPercentile(90)) << ","
+         << (empty ? 0 : histogram.ValueAtPercentile(99)) << ","
+         << (empty ? 0 : histogram.ValueAtPercentile(99.9)) << ","
+         << (empty ? 0 : histogram.MaxValue()) << std::endl;
+  }
+
+  const OpenLoopOptions options_;
+  const OpenLoopSessionFactory session_factory_;
+  OpenLoopKeyGenerator key_generator_;
+  int total_weight_ = 0;
+  OpStats stats_[kElementsInOpenLoopOpType];
+  MonoTime start_;
+  MonoTime end_;
+  std::atomic<int64_t> max_lag_us_{0};
+};
+
+OpenLoopLoad::OpenLoopLoad(const OpenLoopOptions& options, OpenLoopSessionFactory session_factory)
+    : impl_(new Impl(options, std::move(session_factory))) {
+}
+
+OpenLoopLoad::~OpenLoopLoad() {
+}
+
+Status OpenLoopLoad::Run(std::ostream* out) {
+  return impl_->Run(out);
+}
+
+int64_t OpenLoopLoad::num_requests(OpenLoopOpType op_type) const {
+  return impl_->num_requests(op_type);
+}
+
+int64_t OpenLoopLoad::num_errors(OpenLoopOpType op_type) const {
+  return impl_->num_errors(op_type);
+}
+
+const HdrHistogram& OpenLoopLoad::latencies(OpenLoopOpType op_type) const {
+  return impl_->latencies(op_type);
+}
+
+OpenLoopSessionFactory YcqlOpenLoopSessionFactory(
+    client::YBClient* client, client::TableHandle* table,
+    client::TransactionManager* transaction_manager) {
+  return [client, table, transaction_manager]() -> Result<std::unique_ptr<OpenLoopSession>> {
+    return std::unique_ptr<OpenLoopSession>(
+        new YcqlOpenLoopSession(client, table, transaction_manager));
+  };
+}
+
+} // namespace load_generator
+} // namespace yb
@@ -0,0 +1,171 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_INTEGRATION_TESTS_OPEN_LOOP_LOAD_H
+#define YB_INTEGRATION_TESTS_OPEN_LOOP_LOAD_H
+
+#include <atomic>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+
+class HdrHistogram;
+
+namespace load_generator {
+
+// The names are the values of the load test tool flags.
+YB_DEFINE_ENUM(OpenLoopKeyDistribution, (uniform)(zipfian)(hotspot)(latest));
+YB_DEFINE_ENUM(OpenLoopOpType, (read)(write)(scan)(transaction));
+
+Result<OpenLoopKeyDistribution> ParseOpenLoopKeyDistribution(const std::string& name);
+
+struct OpenLoopOptions {
+  // Requests are issued at this total rate, whether or not the previous requests completed.
+  double requests_per_sec = 1000;
+  MonoDelta duration = MonoDelta::FromSeconds(60);
+  // Number of threads issuing the requests. The rate could only be kept if there are enough of
+  // them to cover the time the requests take.
+  int num_threads = 32;
+
+  // Keys are picked from [0, num_keys), or for the latest distribution, from the last num_keys
+  // inserted keys.
+  int64_t num_keys = 100000;
+  // Write all the keys before the run, so the reads find them.
+  bool preload = true;
+  size_t value_size = 16;
+
+  // Relative frequencies of the operation types.
+  int weights[kElementsInOpenLoopOpType] = {80, 20, 0, 0};
+
+  OpenLoopKeyDistribution key_distribution = OpenLoopKeyDistribution::zipfian;
+  // The skew of the zipfian and latest distributions, 0.99 as in YCSB.
+  double zipfian_constant = 0.99;
+  // For the hotspot distribution, hotspot_access_fraction of the requests go to the first
+  // hotspot_key_fraction of the keys.
+  double hotspot_key_fraction = 0.2;
+  double hotspot_access_fraction = 0.8;
+
+  // Number of rows read by a scan.
+  int scan_length = 100;
+  // Number of keys written by a transaction.
+  int transaction_keys = 2;
+
+  // Period of the time series reported while running.
+  MonoDelta report_interval = MonoDelta::FromSeconds(1);
+
+  // If set, called after the preload, right before the requests start to be issued.
+  std::function<void()> on_start;
+};
+
+// Driver of a single thread of the load, e.g. a YCQL session or a YSQL connection.
+class OpenLoopSession {
+ public:
+  virtual ~OpenLoopSession() {}
+
+  virtual CHECKED_STATUS Read(const std::string& key) = 0;
+  // Inserts the key or overwrites its value.
+  virtual CHECKED_STATUS Write(const std::string& key, const std::string& value) = 0;
+  // Reads up to limit rows starting from the key, in the order of the table.
+  virtual CHECKED_STATUS Scan(const std::string& start_key, int limit) = 0;
+  // Writes all the pairs in a single distributed transaction.
+  virtual CHECKED_STATUS Transaction(
+      const std::vector<std::pair<std::string, std::string>>& key_values) = 0;
+};
+
+typedef std::function<Result<std::unique_ptr<OpenLoopSession>>()> OpenLoopSessionFactory;
+
+// Returns the key string of the key with the given index.
+std::string OpenLoopKey(int64_t key_index);
+
+// Picks the indexes of the keys of the requests. Next is thread-safe, when each thread uses its
+// own random number generator.
+class OpenLoopKeyGenerator {
+ public:
+  explicit OpenLoopKeyGenerator(const OpenLoopOptions& options);
+
+  // Returns the index of a key to read or update.
+  int64_t Next(std::mt19937_64* rng) const;
+
+  // Returns the index of a key to write. For the latest distribution it is a new key, the
+  // following reads are skewed to, otherwise the same as Next.
+  int64_t NextToWrite(std::mt19937_64* rng);
+
+ private:
+  // Returns a rank in [0, num_keys_) from the zipfian distribution, the lower ranks being the more
+  // frequent ones. Uses the algorithm from "Quickly Generating Billion-Record Synthetic
+  // Databases" by Gray et al, the same as YCSB.
+  int64_t NextZipfian(std::mt19937_64* rng) const;
+
+  const OpenLoopKeyDistribution distribution_;
+  const int64_t num_keys_;
+  const double hotspot_keys_;
+  const double hotspot_access_fraction_;
+
+  double theta_ = 0;
+  double zeta_n_ = 0;
+  double alpha_ = 0;
+  double eta_ = 0;
+
+  // The keys are [0, next_insert_) for the latest distribution.
+  std::atomic<int64_t> next_insert_;
+};
+
+// Issues the requests at a fixed rate, i.e. the requests are not delayed when the previous ones
+// take time, as a closed loop load does. The latencies are measured from the time a request should
+// have been issued, so they also include the time it waited for an available thread, and are not
+// affected by the coordinated omission.
+//
+// While running, writes a CSV time series per report_interval and operation type, with the number
+// of the requests issued in the interval and their latencies, and the totals when done.
+class OpenLoopLoad {
+ public:
+  OpenLoopLoad(const OpenLoopOptions& options, OpenLoopSessionFactory session_factory);
+  ~OpenLoopLoad();
+
+  CHECKED_STATUS Run(std::ostream* out);
+
+  // Total number of the requests of the given type that were issued and failed.
+  int64_t num_requests(OpenLoopOpType op_type) const;
+  int64_t num_errors(OpenLoopOpType op_type) const;
+
+  // Latencies of all the requests of the given type, in microseconds.
+  const HdrHistogram& latencies(OpenLoopOpType op_type) const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+// Creates the sessions of a YCQL table with the schema created by the load test tool, a string
+// hash key column k and a string column v. Transactions are only supported if the table is
+// transactional and transaction_manager is not null.
+OpenLoopSessionFactory YcqlOpenLoopSessionFactory(
+    client::YBClient* client, client::TableHandle* table,
+    client::TransactionManager* transaction_manager);
+
+} // namespace load_generator
+} // namespace yb
+
+#endif // YB_INTEGRATION_TESTS_OPEN_LOOP_LOAD_H
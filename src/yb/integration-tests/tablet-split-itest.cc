@@ -20,11 +20,15 @@
 #include "yb/consensus/consensus.h"
 
 #include "yb/master/catalog_manager.h"
+#include "yb/master/master.h"
+#include "yb/master/mini_master.h"
+#include "yb/master/tablet_split_manager.h"
 
 #include "yb/rpc/messenger.h"
 
 #include "yb/tablet/tablet_peer.h"
 
+#include "yb/tserver/heartbeater.h"
 #include "yb/tserver/mini_tablet_server.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tserver_admin.proxy.h"
@@ -38,6 +42,8 @@ using namespace std::literals;  // NOLINT
 DECLARE_int64(db_write_buffer_size);
 DECLARE_int32(rocksdb_level0_file_num_compaction_trigger);
 DECLARE_bool(do_not_start_election_test_only);
+DECLARE_bool(reject_split_tablet);
+DECLARE_bool(skip_complete_tablet_split);
 
 namespace yb {
 
@@ -78,6 +84,18 @@ class TabletSplitITest : public client::KeyValueTableTest {
   // - It should reject reads and writes.
   void CheckSourceTabletAfterSplit(const TabletId& source_tablet_id);
 
+  // Asks the leader master to split the single tablet of the test table in the middle of its
+  // hash range. Returns the source tablet and the ids of the new tablets.
+  Result<std::pair<scoped_refptr<master::TabletInfo>, std::array<TabletId, 2>>>
+      SplitSingleTabletByMaster();
+
+  // Waits for the leader master to replace the source tablet with the new tablets in the table.
+  void WaitForSplitCompletedByMaster(
+      const TabletId& source_tablet_id, const std::array<TabletId, 2>& new_tablet_ids);
+
+  // Waits for each replica set of the tablets to have `num_rows` rows in total.
+  void WaitForRowsInReplicas(const std::array<TabletId, 2>& tablet_ids, size_t num_rows);
+
  protected:
   std::unique_ptr<rpc::ProxyCache> proxy_cache_;
 };
@@ -432,4 +450,163 @@ TEST_F(TabletSplitITest, SplitSingleTablet) {
   CheckSourceTabletAfterSplit(source_tablet_id);
 }
 
+Result<std::pair<scoped_refptr<master::TabletInfo>, std::array<TabletId, 2>>>
+    TabletSplitITest::SplitSingleTabletByMaster() {
+  auto& leader_master = *cluster_->leader_mini_master()->master();
+  auto source_tablet_info = VERIFY_RESULT(GetSingleTestTabletInfo(leader_master));
+  const auto split_hash_code = master::TabletSplitManager::SplitHashCode(
+      source_tablet_info->LockForRead()->data().pb.partition());
+  SCHECK(split_hash_code, IllegalState, "Test tablet has a single hash code");
+  auto new_tablet_ids = VERIFY_RESULT(
+      leader_master.catalog_manager()->SplitTablet(source_tablet_info, *split_hash_code));
+  return std::make_pair(source_tablet_info, new_tablet_ids);
+}
+
+void TabletSplitITest::WaitForSplitCompletedByMaster(
+    const TabletId& source_tablet_id, const std::array<TabletId, 2>& new_tablet_ids) {
+  ASSERT_OK(WaitFor([this, &source_tablet_id, &new_tablet_ids]() -> Result<bool> {
+    auto* catalog_mgr = cluster_->leader_mini_master()->master()->catalog_manager();
+    const auto source_tablet_state =
+        catalog_mgr->TEST_GetTabletInfo(source_tablet_id)->LockForRead()->data().pb.state();
+    if (source_tablet_state != master::SysTabletsEntryPB::REPLACED) {
+      return false;
+    }
+    master::TabletInfos tablet_infos;
+    catalog_mgr->GetTableInfo(table_->id())->GetAllTablets(&tablet_infos);
+    std::vector<TabletId> tablet_ids;
+    for (const auto& tablet_info : tablet_infos) {
+      tablet_ids.push_back(tablet_info->tablet_id());
+    }
+    return tablet_ids == std::vector<TabletId>(new_tablet_ids.begin(), new_tablet_ids.end());
+  }, 30s * kTimeMultiplier, "Wait for master to complete tablet split"));
+}
+
+void TabletSplitITest::WaitForRowsInReplicas(
+    const std::array<TabletId, 2>& tablet_ids, size_t num_rows) {
+  const size_t replication_factor = cluster_->num_tablet_servers();
+  ASSERT_OK(WaitFor([this, &tablet_ids, num_rows, replication_factor]() -> Result<bool> {
+    size_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kAll)) {
+      const auto* tablet = peer->tablet();
+      if (!tablet ||
+          std::find(tablet_ids.begin(), tablet_ids.end(), peer->tablet_id()) == tablet_ids.end()) {
+        continue;
+      }
+      auto client_schema = tablet->metadata()->schema().CopyWithoutColumnIds();
+      auto iter = VERIFY_RESULT(tablet->NewRowIterator(client_schema, boost::none));
+      QLTableRow row;
+      while (VERIFY_RESULT(iter->HasNext())) {
+        RETURN_NOT_OK(iter->NextRow(&row));
+        ++result;
+      }
+    }
+    LOG(INFO) << "Rows in replicas of " << AsString(tablet_ids) << ": " << result;
+    return result == num_rows * replication_factor;
+  }, 30s * kTimeMultiplier, "Wait for rows in replicas of new tablets"));
+}
+
+// Tests that the master splits a tablet: the new tablets are created by the replicas of the
+// tablet, have all its rows and replace it in the partitions of the table.
+TEST_F(TabletSplitITest, SplitTabletByMaster) {
+  constexpr auto kNumRows = 1000;
+
+  CreateTable(client::Transactional::kFalse, 1 /* num_tablets */, client_.get(), &table_);
+  ASSERT_RESULT(WriteRows(kNumRows));
+
+  auto split = ASSERT_RESULT(SplitSingleTabletByMaster());
+  ASSERT_NO_FATALS(WaitForSplitCompletedByMaster(split.first->tablet_id(), split.second));
+
+  ASSERT_NO_FATALS(WaitForRowsInReplicas(split.second, kNumRows));
+}
+
+// Tests that a split refused by the leader of the tablet is rolled back, so that the tablet could
+// be split later.
+TEST_F(TabletSplitITest, AbortTabletSplit) {
+  CreateTable(client::Transactional::kFalse, 1 /* num_tablets */, client_.get(), &table_);
+  ASSERT_RESULT(WriteRows(100 /* num_rows */));
+
+  FLAGS_reject_split_tablet = true;
+  auto split = ASSERT_RESULT(SplitSingleTabletByMaster());
+  const auto& source_tablet_info = split.first;
+  auto* catalog_mgr = cluster_->leader_mini_master()->master()->catalog_manager();
+  ASSERT_OK(WaitFor([catalog_mgr, &split] {
+    for (const auto& new_tablet_id : split.second) {
+      if (!catalog_mgr->TEST_GetTabletInfo(new_tablet_id)->LockForRead()->data().is_deleted()) {
+        return false;
+      }
+    }
+    return true;
+  }, 30s * kTimeMultiplier, "Wait for tablet split to be aborted"));
+
+  ASSERT_EQ(source_tablet_info->LockForRead()->data().pb.split_tablet_ids_size(), 0);
+  ASSERT_TRUE(source_tablet_info->LockForRead()->data().is_running());
+  auto table_tablet_info = ASSERT_RESULT(
+      GetSingleTestTabletInfo(*cluster_->leader_mini_master()->master()));
+  ASSERT_EQ(table_tablet_info->tablet_id(), source_tablet_info->tablet_id());
+
+  FLAGS_reject_split_tablet = false;
+  split = ASSERT_RESULT(SplitSingleTabletByMaster());
+  ASSERT_NO_FATALS(WaitForSplitCompletedByMaster(split.first->tablet_id(), split.second));
+}
+
+// Tests that a split that is not complete when the master restarts is loaded from the sys catalog
+// and completed by the new tablets reports.
+TEST_F(TabletSplitITest, SplitTabletMasterRestart) {
+  constexpr auto kNumRows = 500;
+
+  CreateTable(client::Transactional::kFalse, 1 /* num_tablets */, client_.get(), &table_);
+  ASSERT_RESULT(WriteRows(kNumRows));
+
+  FLAGS_skip_complete_tablet_split = true;
+  auto split = ASSERT_RESULT(SplitSingleTabletByMaster());
+  const auto source_tablet_id = split.first->tablet_id();
+  const auto& new_tablet_ids = split.second;
+
+  auto wait_new_tablets_running = [this, &new_tablet_ids] {
+    ASSERT_OK(WaitFor([this, &new_tablet_ids] {
+      auto* catalog_mgr = cluster_->leader_mini_master()->master()->catalog_manager();
+      for (const auto& new_tablet_id : new_tablet_ids) {
+        auto new_tablet_info = catalog_mgr->TEST_GetTabletInfo(new_tablet_id);
+        if (!new_tablet_info || !new_tablet_info->LockForRead()->data().is_running()) {
+          return false;
+        }
+      }
+      return true;
+    }, 30s * kTimeMultiplier, "Wait for new tablets to be running"));
+  };
+  // Checks that the source tablet still serves the partitions of the table.
+  auto check_split_in_progress = [this, &source_tablet_id] {
+    auto& leader_master = *cluster_->leader_mini_master()->master();
+    auto tablet_info = ASSERT_RESULT(GetSingleTestTabletInfo(leader_master));
+    ASSERT_EQ(tablet_info->tablet_id(), source_tablet_id);
+    auto tablet_lock = tablet_info->LockForRead();
+    ASSERT_TRUE(tablet_lock->data().is_running());
+    ASSERT_EQ(tablet_lock->data().pb.split_tablet_ids_size(), 2);
+  };
+
+  ASSERT_NO_FATALS(wait_new_tablets_running());
+  ASSERT_NO_FATALS(check_split_in_progress());
+
+  ASSERT_OK(cluster_->leader_mini_master()->Restart());
+  ASSERT_OK(cluster_->leader_mini_master()->master()->
+      WaitUntilCatalogManagerIsLeaderAndReadyForTests());
+  ASSERT_NO_FATALS(wait_new_tablets_running());
+  ASSERT_NO_FATALS(check_split_in_progress());
+
+  // The new tablets are reported again to complete the split.
+  FLAGS_skip_complete_tablet_split = false;
+  for (auto* mini_ts : cluster_->mini_tablet_servers()) {
+    auto* ts = mini_ts->server();
+    for (const auto& new_tablet_id : new_tablet_ids) {
+      ts->tablet_manager()->MarkTabletDirty(
+          new_tablet_id, std::make_shared<consensus::StateChangeContext>(
+              consensus::StateChangeReason::INVALID_REASON));
+    }
+    ts->heartbeater()->TriggerASAP();
+  }
+  ASSERT_NO_FATALS(WaitForSplitCompletedByMaster(source_tablet_id, new_tablet_ids));
+
+  ASSERT_NO_FATALS(WaitForRowsInReplicas(new_tablet_ids, kNumRows));
+}
+
 }  // namespace yb
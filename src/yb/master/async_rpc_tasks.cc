@@ -12,6 +12,9 @@
 //
 #include "yb/master/async_rpc_tasks.h"
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus_meta.h"
@@ -408,6 +411,30 @@ bool RetryingTSRpcTask::TransitionToWaitingState(MonitoredTaskState expected) {
 // ============================================================================
 //  Class AsyncCreateReplica.
 // ============================================================================
+namespace {
+
+void FillCreateTabletRequest(const string& permanent_uuid, TabletInfo* tablet,
+                             tserver::CreateTabletRequestPB* req) {
+  auto table_lock = tablet->table()->LockForRead();
+  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
+
+  req->set_dest_uuid(permanent_uuid);
+  req->set_table_id(tablet->table()->id());
+  req->set_tablet_id(tablet->tablet_id());
+  req->set_table_type(tablet->table()->metadata().state().pb.table_type());
+  req->mutable_partition()->CopyFrom(tablet_pb.partition());
+  req->set_table_name(table_lock->data().pb.name());
+  req->mutable_schema()->CopyFrom(table_lock->data().pb.schema());
+  req->mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
+  req->mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
+  req->set_colocated(tablet_pb.colocated());
+  if (table_lock->data().pb.has_index_info()) {
+    req->mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
+  }
+}
+
+} // namespace
+
 AsyncCreateReplica::AsyncCreateReplica(Master *master,
                                        ThreadPool *callback_pool,
                                        const string& permanent_uuid,
@@ -417,22 +444,7 @@ AsyncCreateReplica::AsyncCreateReplica(Master *master,
   deadline_ = start_ts_;
   deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
 
-  auto table_lock = tablet->table()->LockForRead();
-  const SysTabletsEntryPB& tablet_pb = tablet->metadata().dirty().pb;
-
-  req_.set_dest_uuid(permanent_uuid);
-  req_.set_table_id(tablet->table()->id());
-  req_.set_tablet_id(tablet->tablet_id());
-  req_.set_table_type(tablet->table()->metadata().state().pb.table_type());
-  req_.mutable_partition()->CopyFrom(tablet_pb.partition());
-  req_.set_table_name(table_lock->data().pb.name());
-  req_.mutable_schema()->CopyFrom(table_lock->data().pb.schema());
-  req_.mutable_partition_schema()->CopyFrom(table_lock->data().pb.partition_schema());
-  req_.mutable_config()->CopyFrom(tablet_pb.committed_consensus_state().config());
-  req_.set_colocated(tablet_pb.colocated());
-  if (table_lock->data().pb.has_index_info()) {
-    req_.mutable_index_info()->CopyFrom(table_lock->data().pb.index_info());
-  }
+  FillCreateTabletRequest(permanent_uuid, tablet.get(), &req_);
 }
 
 void AsyncCreateReplica::HandleResponse(int attempt) {
@@ -460,6 +472,72 @@ bool AsyncCreateReplica::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncCreateReplicas.
+// ============================================================================
+AsyncCreateReplicas::AsyncCreateReplicas(Master *master,
+                                         ThreadPool *callback_pool,
+                                         const string& permanent_uuid,
+                                         const std::vector<TabletInfo*>& tablets)
+  : RetrySpecificTSRpcTask(master, callback_pool, permanent_uuid, tablets.front()->table().get()) {
+  deadline_ = start_ts_;
+  deadline_.AddDelta(MonoDelta::FromMilliseconds(FLAGS_tablet_creation_timeout_ms));
+
+  req_.set_dest_uuid(permanent_uuid);
+  for (TabletInfo* tablet : tablets) {
+    FillCreateTabletRequest(permanent_uuid, tablet, req_.add_tablets());
+  }
+}
+
+std::string AsyncCreateReplicas::description() const {
+  return Format("CreateTablets RPC for $0 tablets starting with $1 on TS $2",
+                req_.tablets_size(), tablet_id(), permanent_uuid_);
+}
+
+TabletId AsyncCreateReplicas::tablet_id() const {
+  return req_.tablets_size() > 0 ? req_.tablets(0).tablet_id() : TabletId();
+}
+
+void AsyncCreateReplicas::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    LOG(WARNING) << description() << " failed: " << StatusFromPB(resp_.error().status());
+    return;
+  }
+
+  // Only the tablets that failed are retried.
+  std::unordered_set<TabletId> failed_tablet_ids;
+  for (const auto& tablet_error : resp_.tablet_errors()) {
+    Status s = StatusFromPB(tablet_error.error().status());
+    if (s.IsAlreadyPresent()) {
+      LOG(INFO) << "CreateTablets RPC for tablet " << tablet_error.tablet_id()
+                << " on TS " << permanent_uuid_ << " returned already present: "
+                << s.ToString();
+    } else {
+      LOG(WARNING) << "CreateTablets RPC for tablet " << tablet_error.tablet_id()
+                   << " on TS " << permanent_uuid_ << " failed: " << s.ToString();
+      failed_tablet_ids.insert(tablet_error.tablet_id());
+    }
+  }
+  if (failed_tablet_ids.empty()) {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    return;
+  }
+  auto* tablets = req_.mutable_tablets();
+  tablets->erase(std::remove_if(tablets->begin(), tablets->end(),
+                                [&failed_tablet_ids](const tserver::CreateTabletRequestPB& req) {
+                                  return failed_tablet_ids.count(req.tablet_id()) == 0;
+                                }),
+                 tablets->end());
+}
+
+bool AsyncCreateReplicas::SendRequest(int attempt) {
+  resp_.Clear();
+  ts_admin_proxy_->CreateTabletsAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send create tablets request to " << permanent_uuid_
+          << " (attempt " << attempt << ") for " << req_.tablets_size() << " tablets";
+  return true;
+}
+
 // ============================================================================
 //  Class AsyncDeleteReplica.
 // ============================================================================
@@ -1067,6 +1145,82 @@ bool AsyncAddTableToTablet::SendRequest(int attempt) {
   return true;
 }
 
+// ============================================================================
+//  Class AsyncSplitTablet.
+// ============================================================================
+AsyncSplitTablet::AsyncSplitTablet(
+    Master* master, ThreadPool* callback_pool, const scoped_refptr<TabletInfo>& tablet,
+    const std::array<TabletId, 2>& new_tablet_ids, const std::string& split_encoded_key,
+    const std::string& split_partition_key)
+    : RetryingTSRpcTask(
+          master, callback_pool, gscoped_ptr<TSPicker>(new PickLeaderReplica(tablet)),
+          tablet->table().get()),
+      tablet_(tablet) {
+  req_.set_tablet_id(tablet->tablet_id());
+  req_.set_new_tablet1_id(new_tablet_ids[0]);
+  req_.set_new_tablet2_id(new_tablet_ids[1]);
+  req_.set_split_encoded_key(split_encoded_key);
+  req_.set_split_partition_key(split_partition_key);
+}
+
+string AsyncSplitTablet::description() const {
+  return Format(
+      "SplitTablet RPC for tablet $0 into $1 and $2", tablet_->ToString(), req_.new_tablet1_id(),
+      req_.new_tablet2_id());
+}
+
+void AsyncSplitTablet::HandleResponse(int attempt) {
+  if (!rpc_.status().ok()) {
+    // The split could still be applied, so it is retried until the deadline.
+    LOG_WITH_PREFIX(WARNING) << "SplitTablet RPC failed, attempt " << attempt << ": "
+                             << rpc_.status();
+    return;
+  }
+  if (resp_.has_error()) {
+    const Status s = StatusFromPB(resp_.error().status());
+    switch (resp_.error().code()) {
+      case TabletServerErrorPB::TABLET_SPLIT:
+        // The split was applied by an earlier attempt, that we did not get the response to.
+        TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+        return;
+      case TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE: FALLTHROUGH_INTENDED;
+      case TabletServerErrorPB::NOT_THE_LEADER: FALLTHROUGH_INTENDED;
+      case TabletServerErrorPB::TABLET_NOT_RUNNING:
+        LOG_WITH_PREFIX(INFO) << "SplitTablet will be retried: " << s;
+        TransitionToWaitingState(MonitoredTaskState::kRunning);
+        return;
+      default:
+        LOG_WITH_PREFIX(WARNING) << "SplitTablet failed with error code "
+                                 << TabletServerErrorPB::Code_Name(resp_.error().code())
+                                 << ": " << s;
+        rejected_ = true;
+        TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kFailed);
+        return;
+    }
+  }
+  LOG_WITH_PREFIX(INFO) << "Tablet split";
+  TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+  server::UpdateClock(resp_, master_->clock());
+}
+
+bool AsyncSplitTablet::SendRequest(int attempt) {
+  req_.set_dest_uuid(target_ts_desc_->permanent_uuid());
+  req_.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  ts_admin_proxy_->SplitTabletAsync(req_, &resp_, &rpc_, BindRpcCallback());
+  VLOG_WITH_PREFIX(1) << "Send SplitTablet request (attempt " << attempt << "):\n"
+                      << req_.DebugString();
+  return true;
+}
+
+void AsyncSplitTablet::UnregisterAsyncTaskCallback() {
+  // Only a split that the leader refused is known not to be applied, if the task failed otherwise
+  // the new tablets are kept, to complete the split when they are reported.
+  if (rejected_) {
+    WARN_NOT_OK(master_->catalog_manager()->AbortTabletSplit(tablet_),
+                Format("Failed to abort split of tablet $0", tablet_->tablet_id()));
+  }
+}
+
 // ============================================================================
 //  Class AsyncRemoveTableFromTablet.
 // ============================================================================
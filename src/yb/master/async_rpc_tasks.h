@@ -13,8 +13,10 @@
 #ifndef YB_MASTER_ASYNC_RPC_TASKS_H
 #define YB_MASTER_ASYNC_RPC_TASKS_H
 
+#include <array>
 #include <atomic>
 #include <string>
+#include <vector>
 
 #include <boost/optional/optional.hpp>
 
@@ -279,6 +281,32 @@ class AsyncCreateReplica : public RetrySpecificTSRpcTask {
   tserver::CreateTabletResponsePB resp_;
 };
 
+// Fire off the async creation of several tablets of the same table on a tablet server.
+// Has the same requirements as AsyncCreateReplica for each of the tablets.
+class AsyncCreateReplicas : public RetrySpecificTSRpcTask {
+ public:
+  AsyncCreateReplicas(Master *master,
+                      ThreadPool *callback_pool,
+                      const std::string& permanent_uuid,
+                      const std::vector<TabletInfo*>& tablets);
+
+  Type type() const override { return ASYNC_CREATE_REPLICA; }
+
+  std::string type_name() const override { return "Create Tablets"; }
+
+  std::string description() const override;
+
+ protected:
+  TabletId tablet_id() const override;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+ private:
+  tserver::CreateTabletsRequestPB req_;
+  tserver::CreateTabletsResponsePB resp_;
+};
+
 // Send a DeleteTablet() RPC request.
 class AsyncDeleteReplica : public RetrySpecificTSRpcTask {
  public:
@@ -593,6 +621,35 @@ class AsyncRemoveTableFromTablet : public RetryingTSRpcTask {
   tserver::RemoveTableFromTabletResponsePB resp_;
 };
 
+// Task to split a tablet into two new tablets, that are already registered in the catalog. Catalog
+// Manager uses this task to send the request to the leader of the tablet.
+class AsyncSplitTablet : public RetryingTSRpcTask {
+ public:
+  AsyncSplitTablet(
+      Master* master, ThreadPool* callback_pool, const scoped_refptr<TabletInfo>& tablet,
+      const std::array<TabletId, 2>& new_tablet_ids, const std::string& split_encoded_key,
+      const std::string& split_partition_key);
+
+  Type type() const override { return ASYNC_SPLIT_TABLET; }
+
+  std::string type_name() const override { return "Split Tablet"; }
+
+  std::string description() const override;
+
+ private:
+  TabletId tablet_id() const override { return tablet_->tablet_id(); }
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+  void UnregisterAsyncTaskCallback() override;
+
+  const scoped_refptr<TabletInfo> tablet_;
+  tserver::SplitTabletRequestPB req_;
+  tserver::SplitTabletResponsePB resp_;
+  // Whether the leader refused to split the tablet, so the new tablets could be dropped.
+  bool rejected_ = false;
+};
+
 } // namespace master
 } // namespace yb
 
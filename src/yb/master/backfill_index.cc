@@ -128,6 +128,12 @@ DEFINE_int32(index_backfill_rpc_max_delay_ms, 10 * 60 * 1000, // 10 min.
 TAG_FLAG(index_backfill_rpc_max_delay_ms, advanced);
 TAG_FLAG(index_backfill_rpc_max_delay_ms, runtime);
 
+DEFINE_int32(index_backfill_max_parallel_tablets, 0,
+             "Maximum number of tablets of a table that the master backfills indexes of at the "
+             "same time. 0 to backfill all the tablets at once.");
+TAG_FLAG(index_backfill_max_parallel_tablets, advanced);
+TAG_FLAG(index_backfill_max_parallel_tablets, runtime);
+
 DEFINE_int32(index_backfill_wait_for_alter_table_completion_ms, 100,
              "Delay before retrying to see if an in-progress alter table has "
              "completed, during index backfill.");
@@ -467,10 +473,33 @@ std::string BackfillTable::description() const {
       "Backfill Index Table(s) $0 : $1", index_ids_,
       (timestamp_chosen()
            ? (done() ? Format("Backfill $0/$1 tablets done", num_pending, num_tablets)
-                     : Format("Backfilling $0/$1 tablets", num_pending, num_tablets))
+                     : Format("Backfilling $0/$1 tablets$2", num_pending, num_tablets,
+                              ProgressDescription(num_pending, num_tablets)))
            : Format("Waiting to GetSafeTime from $0/$1 tablets", num_pending, num_tablets)));
 }
 
+std::string BackfillTable::ProgressDescription(size_t num_pending, size_t num_tablets) const {
+  auto result = Format(", $0 rows backfilled",
+                       num_rows_processed_.load(std::memory_order_acquire));
+  CoarseTimePoint start_time;
+  size_t num_in_progress;
+  {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    start_time = backfill_start_time_;
+    num_in_progress = num_tablets_in_progress_;
+  }
+  if (num_in_progress < num_pending) {
+    result += Format(", $0 tablets in progress", num_in_progress);
+  }
+  // The remaining tablets are assumed to take as long as the ones done so far.
+  const auto num_done = num_tablets - std::min(num_pending, num_tablets);
+  if (num_done > 0 && start_time != CoarseTimePoint()) {
+    const auto elapsed = CoarseMonoClock::Now() - start_time;
+    result += Format(", ETA $0", MonoDelta(elapsed * num_pending / num_done));
+  }
+  return result;
+}
+
 Status BackfillTable::UpdateSafeTime(const Status& s, HybridTime ht) {
   if (!s.ok()) {
     // Move on to ABORTED permission.
@@ -528,8 +557,41 @@ void BackfillTable::LaunchBackfill() {
 
   num_tablets_.store(tablets.size(), std::memory_order_release);
   tablets_pending_.store(tablets.size(), std::memory_order_release);
-  for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-    auto backfill_tablet = std::make_shared<BackfillTablet>(shared_from_this(), tablet);
+  {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    backfill_start_time_ = CoarseMonoClock::Now();
+    for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+      tablets_to_launch_.push_back(std::make_shared<BackfillTablet>(shared_from_this(), tablet));
+    }
+  }
+  LaunchNextTablets();
+}
+
+void BackfillTable::LaunchNextTablets() {
+  {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    // Tablets that are already backfilled complete within Launch, the outer call launches the
+    // tablets after them.
+    if (launching_tablets_) {
+      return;
+    }
+    launching_tablets_ = true;
+  }
+  for (;;) {
+    std::shared_ptr<BackfillTablet> backfill_tablet;
+    {
+      std::lock_guard<simple_spinlock> l(mutex_);
+      const auto max_parallel_tablets = FLAGS_index_backfill_max_parallel_tablets;
+      if (tablets_to_launch_.empty() ||
+          (max_parallel_tablets > 0 &&
+           num_tablets_in_progress_ >= static_cast<size_t>(max_parallel_tablets))) {
+        launching_tablets_ = false;
+        return;
+      }
+      backfill_tablet = std::move(tablets_to_launch_.front());
+      tablets_to_launch_.pop_front();
+      ++num_tablets_in_progress_;
+    }
     backfill_tablet->Launch();
   }
 }
@@ -539,6 +601,10 @@ void BackfillTable::Done(const Status& s) {
     // Move on to ABORTED permission.
     LOG_WITH_PREFIX(ERROR) << "Failed to backfill the index " << s;
     if (!done_.exchange(true)) {
+      {
+        std::lock_guard<simple_spinlock> l(mutex_);
+        tablets_to_launch_.clear();
+      }
       WARN_NOT_OK(AlterTableStateToAbort(),
                   "Failed to mark backfill as failed.");
     } else {
@@ -548,6 +614,14 @@ void BackfillTable::Done(const Status& s) {
     return;
   }
 
+  {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    --num_tablets_in_progress_;
+  }
+  if (!done()) {
+    LaunchNextTablets();
+  }
+
   // If OK then move on to READ permissions.
   if (!done() && --tablets_pending_ == 0) {
     LOG_WITH_PREFIX(INFO) << "Completed backfilling the index table.";
@@ -739,7 +813,9 @@ void BackfillTablet::LaunchNextChunkOrDone() {
   }
 }
 
-void BackfillTablet::Done(const Status& status, const string& next_row_key) {
+void BackfillTablet::Done(
+    const Status& status, const string& next_row_key, uint64_t number_rows_processed) {
+  backfill_table_->AddRowsProcessed(number_rows_processed);
   if (!status.ok()) {
     LOG(INFO) << "Failed to backfill the tablet " << yb::ToString(tablet_) << status;
     backfill_table_->Done(status);
@@ -948,7 +1024,7 @@ void BackfillChunk::UnregisterAsyncTaskCallback() {
     status = STATUS_SUBSTITUTE(InternalError, "$0 in state $1", description(),
                                ToString(state()));
   }
-  backfill_tablet_->Done(status, resp_.backfilled_until());
+  backfill_tablet_->Done(status, resp_.backfilled_until(), resp_.number_rows_processed());
 }
 
 }  // namespace master
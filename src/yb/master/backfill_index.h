@@ -14,6 +14,7 @@
 #ifndef YB_MASTER_BACKFILL_INDEX_H
 #define YB_MASTER_BACKFILL_INDEX_H
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -80,6 +81,11 @@ class BackfillTable : public std::enable_shared_from_this<BackfillTable> {
 
   void Done(const Status& s);
 
+  // Accounts for the rows backfilled by a chunk of a tablet, for the progress of the backfill.
+  void AddRowsProcessed(uint64_t number_rows) {
+    num_rows_processed_.fetch_add(number_rows, std::memory_order_acq_rel);
+  }
+
   Master* master() { return master_; }
 
   ThreadPool* threadpool() { return callback_pool_; }
@@ -118,6 +124,13 @@ class BackfillTable : public std::enable_shared_from_this<BackfillTable> {
 
   void LaunchBackfill();
 
+  // Returns the rows backfilled so far and the estimated time to backfill the remaining tablets.
+  std::string ProgressDescription(size_t num_pending, size_t num_tablets) const;
+
+  // Launches the backfill of the queued tablets, while fewer than
+  // index_backfill_max_parallel_tablets of them are in progress.
+  void LaunchNextTablets();
+
   CHECKED_STATUS AlterTableStateToSuccess();
 
   CHECKED_STATUS AlterTableStateToAbort();
@@ -151,9 +164,15 @@ class BackfillTable : public std::enable_shared_from_this<BackfillTable> {
   std::atomic_bool timestamp_chosen_{false};
   std::atomic<size_t> tablets_pending_;
   std::atomic<size_t> num_tablets_;
+  std::atomic<uint64_t> num_rows_processed_{0};
   std::shared_ptr<BackfillTableJob> backfill_job_;
   mutable simple_spinlock mutex_;
   HybridTime read_time_for_backfill_ GUARDED_BY(mutex_){HybridTime::kMin};
+  // Tablets that wait for a free slot to start their backfill.
+  std::deque<std::shared_ptr<BackfillTablet>> tablets_to_launch_ GUARDED_BY(mutex_);
+  size_t num_tablets_in_progress_ GUARDED_BY(mutex_) = 0;
+  bool launching_tablets_ GUARDED_BY(mutex_) = false;
+  CoarseTimePoint backfill_start_time_ GUARDED_BY(mutex_);
 };
 
 class BackfillTableJob : public MonitoredTask {
@@ -204,7 +223,8 @@ class BackfillTablet : public std::enable_shared_from_this<BackfillTablet> {
   void Launch() { LaunchNextChunkOrDone(); }
 
   void LaunchNextChunkOrDone();
-  void Done(const Status& status, const std::string& optional_next_row);
+  void Done(const Status& status, const std::string& optional_next_row,
+            uint64_t number_rows_processed);
 
   Master* master() { return backfill_table_->master(); }
 
@@ -118,6 +118,7 @@ void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
   LeaderChangeReporter leader_change_reporter(this);
   last_update_time_ = MonoTime::Now();
   replica_locations_ = std::move(replica_locations);
+  ++replica_locations_version_;
 }
 
 Result<TSDescriptor*> TabletInfo::GetLeader() const {
@@ -150,6 +151,7 @@ void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
 void TabletInfo::UpdateReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
   LeaderChangeReporter leader_change_reporter(this);
+  ++replica_locations_version_;
   auto it = replica_locations_.find(replica.ts_desc->permanent_uuid());
   if (it == replica_locations_.end()) {
     replica_locations_.emplace(replica.ts_desc->permanent_uuid(), replica);
@@ -158,6 +160,11 @@ void TabletInfo::UpdateReplicaLocations(const TabletReplica& replica) {
   it->second.UpdateFrom(replica);
 }
 
+uint64_t TabletInfo::replica_locations_version() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return replica_locations_version_;
+}
+
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = ts;
@@ -201,6 +201,10 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // Replaces a replica in replica_locations_ map if it exists. Otherwise, it adds it to the map.
   void UpdateReplicaLocations(const TabletReplica& replica);
 
+  // Incremented every time the replica locations are set or updated, so that the data built from
+  // the locations could be reused while it does not change.
+  uint64_t replica_locations_version() const;
+
   // Accessors for the last time the replica locations were updated.
   void set_last_update_time(const MonoTime& ts);
   MonoTime last_update_time() const;
@@ -248,6 +252,7 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // The locations in the latest Raft config where this tablet has been
   // reported. The map is keyed by tablet server UUID.
   ReplicaMap replica_locations_;
+  uint64_t replica_locations_version_ = 0;
 
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
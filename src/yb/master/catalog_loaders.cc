@@ -36,6 +36,13 @@
 namespace yb {
 namespace master {
 
+namespace {
+
+// Maximum number of tablets updated in the sys catalog with a single write while loading.
+constexpr size_t kMaxTabletsPerUpdate = 1000;
+
+} // namespace
+
 ////////////////////////////////////////////////////////////
 // Table Loader
 ////////////////////////////////////////////////////////////
@@ -101,14 +108,10 @@ Status TabletLoader::Visit(const TabletId& tablet_id, const SysTabletsEntryPB& m
   // This is for backwards compatibility: we want to ensure that the table_ids
   // list contains the first table that created the tablet. If the table_ids field
   // was empty, we "upgrade" the master to support this new invariant.
+  bool needs_update = false;
   if (metadata.table_ids_size() == 0) {
     l->mutable_data()->pb.add_table_ids(metadata.table_id());
-    Status s = catalog_manager_->sys_catalog_->UpdateItem(
-        tablet, catalog_manager_->leader_ready_term_);
-    if (PREDICT_FALSE(!s.ok())) {
-      return STATUS_FORMAT(
-          IllegalState, "An error occurred while inserting to sys-tablets: $0", s);
-    }
+    needs_update = true;
     table_ids.push_back(metadata.table_id());
   }
 
@@ -139,8 +142,9 @@ Status TabletLoader::Visit(const TabletId& tablet_id, const SysTabletsEntryPB& m
       return STATUS(Corruption, "Missing table for tablet: ", tablet_id);
     }
 
-    // Add the tablet to the Table.
-    if (!tablet_deleted) {
+    // Add the tablet to the Table. The tablets of a split that is not complete yet do not serve
+    // their partitions, the split tablet does.
+    if (!tablet_deleted && !metadata.has_split_parent_tablet_id()) {
       table->AddTablet(tablet);
     }
 
@@ -157,24 +161,57 @@ Status TabletLoader::Visit(const TabletId& tablet_id, const SysTabletsEntryPB& m
     LOG(WARNING) << "Deleting tablet " << tablet->id() << " for table " << first_table->ToString();
     string deletion_msg = "Tablet deleted at " + LocalTimeAsString();
     l->mutable_data()->set_state(SysTabletsEntryPB::DELETED, deletion_msg);
-    RETURN_NOT_OK_PREPEND(catalog_manager_->sys_catalog()->UpdateItem(tablet, term_),
-                          strings::Substitute("Error deleting tablet $0", tablet->id()));
+    needs_update = true;
   }
 
-  l->Commit();
-
   // Add the tablet to colocated_tablet_ids_map_ if the tablet is colocated.
   if (catalog_manager_->IsColocatedParentTable(*first_table)) {
     catalog_manager_->colocated_tablet_ids_map_[first_table->namespace_id()] =
         catalog_manager_->tablet_map_->find(tablet_id)->second;
   }
 
-  LOG(INFO) << "Loaded metadata for " << (tablet_deleted ? "deleted " : "")
-            << "tablet " << tablet_id
-            << " (first table " << first_table->ToString() << ")";
+  // Loading a large catalog would log a line per tablet otherwise, Finish logs the totals.
+  VLOG(1) << "Loaded metadata for " << (tablet_deleted ? "deleted " : "")
+          << "tablet " << tablet_id
+          << " (first table " << first_table->ToString() << ")";
 
   VLOG(1) << "Metadata for tablet " << tablet_id << ": " << metadata.ShortDebugString();
 
+  ++num_loaded_;
+  if (tablet_deleted) {
+    ++num_deleted_;
+  }
+  if (!needs_update) {
+    l->Commit();
+    return Status::OK();
+  }
+  tablets_to_update_.push_back(tablet);
+  tablet_locks_.push_back(std::move(l));
+  if (tablets_to_update_.size() >= kMaxTabletsPerUpdate) {
+    return FlushUpdates();
+  }
+  return Status::OK();
+}
+
+Status TabletLoader::Finish() {
+  RETURN_NOT_OK(FlushUpdates());
+  LOG(INFO) << "Loaded metadata for " << num_loaded_ << " tablets, " << num_deleted_
+            << " of them deleted";
+  return Status::OK();
+}
+
+Status TabletLoader::FlushUpdates() {
+  if (tablets_to_update_.empty()) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK_PREPEND(
+      catalog_manager_->sys_catalog()->UpdateItems(tablets_to_update_, term_),
+      Format("Error updating $0 tablets", tablets_to_update_.size()));
+  for (auto& lock : tablet_locks_) {
+    lock->Commit();
+  }
+  tablets_to_update_.clear();
+  tablet_locks_.clear();
   return Status::OK();
 }
 
@@ -33,6 +33,9 @@
 #ifndef YB_MASTER_CATALOG_LOADERS_H
 #define YB_MASTER_CATALOG_LOADERS_H
 
+#include <memory>
+#include <vector>
+
 #include "yb/master/catalog_entity_info.h"
 #include "yb/master/sys_catalog-internal.h"
 
@@ -83,7 +86,6 @@ namespace master {
 // SysYSQLCatalogConfigEntryPB
 
 DECLARE_LOADER_CLASS(Table,         TableId,     SysTablesEntryPB);
-DECLARE_LOADER_CLASS(Tablet,        TabletId,    SysTabletsEntryPB);
 DECLARE_LOADER_CLASS(Namespace,     NamespaceId, SysNamespaceEntryPB);
 DECLARE_LOADER_CLASS(UDType,        UDTypeId,    SysUDTypeEntryPB);
 DECLARE_LOADER_CLASS(ClusterConfig, std::string, SysClusterConfigEntryPB);
@@ -93,6 +95,35 @@ DECLARE_LOADER_CLASS(SysConfig,     std::string, SysConfigEntryPB);
 
 #undef DECLARE_LOADER_CLASS
 
+// Loads the tablets. The tablets that have to be updated in the sys catalog while they are loaded
+// are written in batches, instead of with a write per tablet.
+class TabletLoader : public Visitor<PersistentTabletInfo> {
+ public:
+  explicit TabletLoader(CatalogManager* catalog_manager, int64_t term = OpId::kUnknownTerm)
+      : catalog_manager_(catalog_manager), term_(term) {}
+
+  CHECKED_STATUS Finish() override;
+
+ private:
+  CHECKED_STATUS Visit(const TabletId& tablet_id, const SysTabletsEntryPB& metadata) override;
+
+  // Writes the tablets to update and commits their mutations.
+  CHECKED_STATUS FlushUpdates();
+
+  CatalogManager *catalog_manager_;
+
+  int64_t term_;
+
+  // Tablets to write to the sys catalog, with their mutations in progress.
+  std::vector<TabletInfo*> tablets_to_update_;
+  std::vector<std::unique_ptr<TabletInfo::lock_type>> tablet_locks_;
+
+  size_t num_loaded_ = 0;
+  size_t num_deleted_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TabletLoader);
+};
+
 }  // namespace master
 }  // namespace yb
 
@@ -31,6 +31,8 @@
 //
 
 #include "yb/master/catalog_manager-test_base.h"
+#include "yb/master/table_changes_log.h"
+#include "yb/master/table_locations_cache.h"
 
 namespace yb {
 namespace master {
@@ -260,6 +262,101 @@ TEST(TestCatalogManager, TestLeaderLoadBalanced) {
   ASSERT_OK(CatalogManagerUtil::AreLeadersOnPreferredOnly(ts_descs, replication_info));
 }
 
+TEST(TestCatalogManager, TestTableReplicationInfo) {
+  ReplicationInfoPB cluster_info;
+  SetupClusterConfig({"a", "b", "c"}, &cluster_info);
+  auto* cluster_read_only = cluster_info.add_read_replicas();
+  cluster_read_only->set_placement_uuid("read_only_1");
+  cluster_read_only->set_num_replicas(1);
+
+  // Without table level placements, the cluster ones are used.
+  auto result = CatalogManagerUtil::TableReplicationInfo(cluster_info, ReplicationInfoPB());
+  ASSERT_EQ(1, result.read_replicas_size());
+  ASSERT_EQ(kNumReplicas, result.live_replicas().num_replicas());
+
+  ReplicationInfoPB table_info;
+  auto* table_read_only = table_info.add_read_replicas();
+  table_read_only->set_placement_uuid("read_only_1");
+  table_read_only->set_num_replicas(2);
+  table_read_only = table_info.add_read_replicas();
+  table_read_only->set_placement_uuid("read_only_2");
+  table_read_only->set_num_replicas(1);
+
+  // The placement of the table overrides the cluster one with the same uuid, the other is added.
+  result = CatalogManagerUtil::TableReplicationInfo(cluster_info, table_info);
+  ASSERT_EQ(2, result.read_replicas_size());
+  ASSERT_EQ("read_only_1", result.read_replicas(0).placement_uuid());
+  ASSERT_EQ(2, result.read_replicas(0).num_replicas());
+  ASSERT_EQ("read_only_2", result.read_replicas(1).placement_uuid());
+  ASSERT_EQ(kNumReplicas, result.live_replicas().num_replicas());
+}
+
+TEST(TableChangesLogTest, TestHeartbeatResponse) {
+  TableChangesLog log;
+  TSHeartbeatRequestPB req;
+  TSHeartbeatResponsePB resp;
+
+  // First heartbeat only receives the current version.
+  log.TableCreated("t1");
+  log.FillHeartbeatResponse(req, &resp);
+  ASSERT_EQ(0, resp.table_changes_size());
+  ASSERT_FALSE(resp.invalidate_all_tables());
+  req.set_table_changes_epoch(resp.table_changes_epoch());
+  req.set_table_changes_version(resp.table_changes_version());
+
+  log.TableChanged("t1");
+  log.TableCreated("t2");
+  resp.Clear();
+  log.FillHeartbeatResponse(req, &resp);
+  ASSERT_FALSE(resp.invalidate_all_tables());
+  ASSERT_EQ(2, resp.table_changes_size());
+  ASSERT_EQ("t1", resp.table_changes(0).table_id());
+  ASSERT_FALSE(resp.table_changes(0).created());
+  ASSERT_EQ("t2", resp.table_changes(1).table_id());
+  ASSERT_TRUE(resp.table_changes(1).created());
+  req.set_table_changes_version(resp.table_changes_version());
+
+  resp.Clear();
+  log.FillHeartbeatResponse(req, &resp);
+  ASSERT_EQ(0, resp.table_changes_size());
+  ASSERT_FALSE(resp.invalidate_all_tables());
+
+  // Changes of the previous leader are not known after reset.
+  log.Reset();
+  resp.Clear();
+  log.FillHeartbeatResponse(req, &resp);
+  ASSERT_TRUE(resp.invalidate_all_tables());
+  ASSERT_NE(req.table_changes_epoch(), resp.table_changes_epoch());
+}
+
+TEST(TableLocationsCacheTest, TestVersion) {
+  TableLocationsCache cache;
+  GetTableLocationsRequestPB req;
+  req.set_partition_key_start("a");
+  GetTableLocationsResponsePB resp;
+  resp.add_tablet_locations()->set_tablet_id("tablet");
+
+  GetTableLocationsResponsePB found;
+  ASSERT_FALSE(cache.Find("t1", req, 1, &found));
+  cache.Insert("t1", req, 1, resp);
+  ASSERT_TRUE(cache.Find("t1", req, 1, &found));
+  ASSERT_EQ(1, found.tablet_locations_size());
+  ASSERT_EQ("tablet", found.tablet_locations(0).tablet_id());
+
+  // Other tables and ranges are not found.
+  ASSERT_FALSE(cache.Find("t2", req, 1, &found));
+  GetTableLocationsRequestPB other_req = req;
+  other_req.set_partition_key_end("b");
+  ASSERT_FALSE(cache.Find("t1", other_req, 1, &found));
+
+  // A response built before the last change is not cached.
+  ASSERT_FALSE(cache.Find("t1", req, 2, &found));
+  ASSERT_EQ(0, cache.size());
+  cache.Insert("t1", req, 1, resp);
+  ASSERT_EQ(0, cache.size());
+  cache.Insert("t1", req, 2, resp);
+  ASSERT_TRUE(cache.Find("t1", req, 2, &found));
+}
 
 } // namespace master
 } // namespace yb
@@ -58,6 +58,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <functional>
 #include <mutex>
@@ -78,6 +79,7 @@
 #include "yb/consensus/consensus.proxy.h"
 #include "yb/consensus/consensus_peers.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/mathlimits.h"
@@ -103,6 +105,7 @@
 #include "yb/master/sys_catalog_initialization.h"
 #include "yb/master/sys_catalog.h"
 #include "yb/master/system_tablet.h"
+#include "yb/master/tablet_split_manager.h"
 #include "yb/master/tasks_tracker.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
@@ -194,8 +197,16 @@ DEFINE_int32(max_create_tablets_per_ts, 50,
              "The number of tablets per TS that can be requested for a new table.");
 TAG_FLAG(max_create_tablets_per_ts, advanced);
 
-DEFINE_int32(catalog_manager_report_batch_size, 1,
-            "The max number of tablets evaluated in the heartbeat as a single SysCatalog update.");
+DEFINE_int32(tablet_creation_batch_size, 1,
+             "Maximum number of replicas of new tablets of a table that the master creates on a "
+             "tablet server with a single request. 1 to create every replica with its own "
+             "CreateTablet request, for tablet servers that do not support CreateTablets.");
+TAG_FLAG(tablet_creation_batch_size, advanced);
+TAG_FLAG(tablet_creation_batch_size, runtime);
+
+DEFINE_int32(catalog_manager_report_batch_size, 100,
+            "The max number of tablets evaluated in the heartbeat as a single SysCatalog update. "
+            "The updates of all tablets of a batch are written to the SysCatalog in one write.");
 TAG_FLAG(catalog_manager_report_batch_size, advanced);
 
 DEFINE_int32(master_failover_catchup_timeout_ms, 30 * 1000,  // 30 sec
@@ -228,6 +239,23 @@ METRIC_DEFINE_gauge_uint32(cluster, num_tablet_servers_dead,
                            "heartbeat in the time interval defined by the gflag "
                            "FLAGS_tserver_unresponsive_timeout_ms.");
 
+METRIC_DEFINE_histogram(server, catalog_maps_snapshot_wait,
+                        "Time waiting for catalog maps snapshots", yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent to get fresh snapshots of the table and tablet maps "
+                        "of the catalog manager, including waiting for their writers.",
+                        60000000LU, 2);
+
+METRIC_DEFINE_histogram(server, tablet_report_processing_time,
+                        "Time processing tablet reports", yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent processing tablet reports sent by tablet servers, "
+                        "from the start of processing until all their updates were written.",
+                        60000000LU, 2);
+
+METRIC_DEFINE_counter(server, tablet_report_unchanged_tablets,
+                      "Unchanged tablets in tablet reports", yb::MetricUnit::kUnits,
+                      "Number of tablets in incremental tablet reports that were skipped, because "
+                      "they were reported the same way before.");
+
 DEFINE_test_flag(uint64, inject_latency_during_remote_bootstrap_secs, 0,
                  "Number of seconds to sleep during a remote bootstrap.");
 
@@ -274,6 +302,9 @@ DEFINE_test_flag(bool, return_error_if_namespace_not_found, false,
 DEFINE_test_flag(bool, simulate_crash_after_table_marked_deleting, false,
     "Crash yb-master after table's state is set to DELETING. This skips tablets deletion.");
 
+DEFINE_test_flag(bool, skip_complete_tablet_split, false,
+    "Do not replace a split tablet with its new tablets when they are reported running.");
+
 namespace yb {
 namespace master {
 
@@ -486,6 +517,7 @@ CatalogManager::CatalogManager(Master* master)
       leader_ready_term_(-1),
       leader_lock_(RWMutex::Priority::PREFER_WRITING),
       load_balance_policy_(new enterprise::ClusterLoadBalancer(this)),
+      tablet_split_manager_(std::make_unique<TabletSplitManager>(this)),
       permissions_manager_(std::make_unique<PermissionsManager>(this)),
       tasks_tracker_(new TasksTracker(IsUserInitiated::kFalse)),
       jobs_tracker_(new TasksTracker(IsUserInitiated::kTrue)),
@@ -520,6 +552,15 @@ Status CatalogManager::Init(bool is_first_run) {
   metric_num_tablet_servers_dead_ =
     METRIC_num_tablet_servers_dead.Instantiate(master_->metric_entity_cluster(), 0);
 
+  metric_catalog_maps_snapshot_wait_ =
+    METRIC_catalog_maps_snapshot_wait.Instantiate(master_->metric_entity());
+
+  metric_tablet_report_processing_time_ =
+    METRIC_tablet_report_processing_time.Instantiate(master_->metric_entity());
+
+  metric_tablet_report_unchanged_tablets_ =
+    METRIC_tablet_report_unchanged_tablets.Instantiate(master_->metric_entity());
+
   RETURN_NOT_OK_PREPEND(InitSysCatalogAsync(is_first_run),
                         "Failed to initialize sys tables async");
 
@@ -672,6 +713,11 @@ Status CatalogManager::VisitSysCatalog(int64_t term) {
   AppendValuesFromMap(*table_ids_map_, &tables);
   AbortAndWaitForAllTasks(tables);
 
+  // Changes done by the previous leader are not known, so tablet servers should invalidate all
+  // cached tables.
+  table_changes_log_.Reset();
+  table_locations_cache_.Clear();
+
   // Clear internal maps and run data loaders.
   RETURN_NOT_OK(RunLoaders(term));
 
@@ -772,9 +818,12 @@ template <class Loader>
 Status CatalogManager::Load(const std::string& title, const int64_t term) {
   LOG(INFO) << __func__ << ": Loading " << title << " into memory.";
   std::unique_ptr<Loader> loader = std::make_unique<Loader>(this, term);
+  auto start = CoarseMonoClock::Now();
   RETURN_NOT_OK_PREPEND(
       sys_catalog_->Visit(loader.get()),
       "Failed while visiting " + title + " in sys catalog");
+  LOG(INFO) << __func__ << ": Loaded " << title << " in "
+            << MonoDelta(CoarseMonoClock::Now() - start);
   return Status::OK();
 }
 
@@ -1417,13 +1466,24 @@ Status CatalogManager::ValidateTableReplicationInfo(const ReplicationInfoPB& rep
   const auto& live_placement_info = replication_info.live_replicas();
   if (!(live_placement_info.placement_blocks().empty() &&
         live_placement_info.num_replicas() <= 0 &&
-        live_placement_info.placement_uuid().empty()) ||
-      !replication_info.read_replicas().empty() ||
-      !replication_info.affinitized_leaders().empty()) {
+        live_placement_info.placement_uuid().empty())) {
     return STATUS(
         InvalidArgument,
-        "Unsupported: cannot set table level replication info yet.");
+        "Unsupported: cannot set table level live replicas yet.");
   }
+  // The read only placements of a table add observer replicas of its tablets to the read only
+  // clusters. They do not take part in the quorums of the tablets.
+  for (const auto& placement_info : replication_info.read_replicas()) {
+    if (placement_info.placement_uuid().empty()) {
+      return STATUS(InvalidArgument, "Table level read replicas must have a placement uuid");
+    }
+    if (placement_info.num_replicas() <= 0) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Table level read replicas in $0 must have a positive number of "
+          "replicas", placement_info.placement_uuid());
+    }
+  }
+  // The preferred zones of the leaders of a table override the cluster ones.
   return Status::OK();
 }
 
@@ -2011,6 +2071,20 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
   if (PREDICT_FALSE(!s.ok())) {
     return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
   }
+  for (const auto& placement_info : req.replication_info().read_replicas()) {
+    if (placement_info.placement_uuid() == replication_info.live_replicas().placement_uuid()) {
+      s = STATUS_FORMAT(InvalidArgument, "Placement uuid $0 of read replicas is the live one",
+                        placement_info.placement_uuid());
+      return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
+    }
+  }
+  for (const auto& cloud_info : req.replication_info().affinitized_leaders()) {
+    s = CatalogManagerUtil::DoesPlacementInfoContainCloudInfo(replication_info.live_replicas(),
+                                                              cloud_info);
+    if (PREDICT_FALSE(!s.ok())) {
+      return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA, s);
+    }
+  }
 
   // For index table, populate the index info.
   IndexInfoPB index_info;
@@ -2052,7 +2126,9 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
   LOG(INFO) << "CreateTable with IndexInfo " << yb::ToString(index_info);
   TSDescriptorVector all_ts_descs;
   master_->ts_manager()->GetAllLiveDescriptors(&all_ts_descs);
-  s = CheckValidReplicationInfo(replication_info, all_ts_descs, partitions, resp);
+  s = CheckValidReplicationInfo(
+      CatalogManagerUtil::TableReplicationInfo(replication_info, req.replication_info()),
+      all_ts_descs, partitions, resp);
   if (!s.ok()) {
     return s;
   }
@@ -2202,6 +2278,8 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
         resp));
   }
 
+  table_changes_log_.TableCreated(table->id());
+
   LOG(INFO) << "Successfully created " << object_type << " " << table->ToString()
             << " per request from " << RequestorString(rpc);
   background_tasks_->Wake();
@@ -2595,7 +2673,15 @@ scoped_refptr<TableInfo> CatalogManager::CreateTableInfo(const CreateTableReques
   metadata->set_namespace_id(namespace_id);
   metadata->set_version(0);
   metadata->set_next_column_id(ColumnId(schema.max_col_id() + 1));
-  // TODO(bogdan): add back in replication_info once we allow overrides!
+  // TODO(bogdan): add back in the rest of replication_info once we allow overrides!
+  if (!req.replication_info().affinitized_leaders().empty()) {
+    *metadata->mutable_replication_info()->mutable_affinitized_leaders() =
+        req.replication_info().affinitized_leaders();
+  }
+  if (!req.replication_info().read_replicas().empty()) {
+    *metadata->mutable_replication_info()->mutable_read_replicas() =
+        req.replication_info().read_replicas();
+  }
   // Use the Schema object passed in, since it has the column IDs already assigned,
   // whereas the user request PB does not.
   SchemaToPB(schema, metadata->mutable_schema());
@@ -2671,13 +2757,57 @@ Status CatalogManager::RemoveTableIdsFromTabletInfo(
   return Status::OK();
 }
 
+template <class Map>
+std::shared_ptr<const Map> CatalogManager::FreshSnapshot(const VersionTracker<Map>& map) const {
+  auto start = MonoTime::Now();
+  auto result = map.Snapshot(&lock_);
+  if (metric_catalog_maps_snapshot_wait_) {
+    metric_catalog_maps_snapshot_wait_->Increment((MonoTime::Now() - start).ToMicroseconds());
+  }
+  return result;
+}
+
+namespace {
+
+template <class Map>
+typename Map::mapped_type FindInLastSnapshot(
+    const VersionTracker<Map>& map, const typename Map::key_type& key, bool* fresh) {
+  size_t version = 0;
+  auto snapshot = map.LastSnapshot(&version);
+  *fresh = snapshot && version == map.Version();
+  return snapshot ? FindPtrOrNull(*snapshot, key) : nullptr;
+}
+
+} // namespace
+
+scoped_refptr<TableInfo> CatalogManager::FindTableInSnapshot(const TableId& table_id) const {
+  bool fresh = false;
+  auto result = FindInLastSnapshot(table_ids_map_, table_id, &fresh);
+  if (result || fresh) {
+    return result;
+  }
+  return FindPtrOrNull(*FreshSnapshot(table_ids_map_), table_id);
+}
+
+scoped_refptr<TabletInfo> CatalogManager::FindTabletInSnapshot(const TabletId& tablet_id) const {
+  bool fresh = false;
+  auto result = FindInLastSnapshot(tablet_map_, tablet_id, &fresh);
+  if (result || fresh) {
+    return result;
+  }
+  return FindPtrOrNull(*FreshSnapshot(tablet_map_), tablet_id);
+}
+
 Status CatalogManager::FindTable(const TableIdentifierPB& table_identifier,
                                  scoped_refptr<TableInfo> *table_info) {
+  if (table_identifier.has_table_id()) {
+    *table_info = FindTableInSnapshot(table_identifier.table_id());
+    return Status::OK();
+  }
+
   SharedLock<LockType> l(lock_);
 
-  if (table_identifier.has_table_id()) {
-    *table_info = FindPtrOrNull(*table_ids_map_, table_identifier.table_id());
-  } else if (table_identifier.has_table_name()) {
+  if (table_identifier.has_table_name()) {
     NamespaceId namespace_id;
 
     if (table_identifier.has_namespace_()) {
@@ -2964,6 +3094,7 @@ Status CatalogManager::DeleteTable(const DeleteTableRequestPB* req,
   }
 
   for (const scoped_refptr<TableInfo> &table : tables) {
+    table_changes_log_.TableChanged(table->id());
     // Send a DeleteTablet() request to each tablet replica in the table.
     DeleteTabletsAndSendRequests(table);
     // Send a RemoveTableFromTablet() request to each colocated parent tablet replica in the table.
@@ -3487,6 +3618,7 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   l->Commit();
 
   SendAlterTableRequest(table);
+  table_changes_log_.TableChanged(table->id());
 
   LOG(INFO) << "Successfully initiated ALTER TABLE (pending tablet schema updates) for "
             << table->ToString() << " per request from " << RequestorString(rpc);
@@ -3544,6 +3676,209 @@ Result<TabletInfo*> CatalogManager::TEST_RegisterNewTablet(
   return new_tablet;
 }
 
+Result<std::array<TabletId, 2>> CatalogManager::SplitTablet(
+    const scoped_refptr<TabletInfo>& tablet, uint16_t split_hash_code) {
+  const auto& table = tablet->table();
+  const auto split_partition_key = PartitionSchema::EncodeMultiColumnHashValue(split_hash_code);
+  docdb::KeyBytes split_encoded_key;
+  docdb::DocKeyEncoderAfterTableIdStep(&split_encoded_key)
+      .Hash(split_hash_code, std::vector<docdb::PrimitiveValue>());
+
+  std::array<TabletId, 2> new_tablet_ids;
+  std::vector<scoped_refptr<TabletInfo>> new_tablets;
+  {
+    auto tablet_lock = tablet->LockForWrite();
+    if (!tablet_lock->data().is_running() || tablet_lock->data().pb.split_tablet_ids_size() > 0) {
+      return STATUS_FORMAT(
+          IllegalState, "Tablet $0 is not running or already split", tablet->tablet_id());
+    }
+    const auto& partition = tablet_lock->data().pb.partition();
+    if (split_partition_key <= partition.partition_key_start() ||
+        (!partition.partition_key_end().empty() &&
+            split_partition_key >= partition.partition_key_end())) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Split hash code $0 is out of the partition of tablet $1",
+          split_hash_code, tablet->tablet_id());
+    }
+
+    // The new tablets are persisted before the split is applied, so that their reports are
+    // accepted, and are created on the replicas of the tablet when they apply the split.
+    std::array<PartitionPB, 2> new_partitions = {partition, partition};
+    new_partitions[0].set_partition_key_end(split_partition_key);
+    new_partitions[1].set_partition_key_start(split_partition_key);
+    std::vector<TabletInfo*> new_tablet_ptrs;
+    for (const auto& new_partition : new_partitions) {
+      scoped_refptr<TabletInfo> new_tablet(CreateTabletInfo(table.get(), new_partition));
+      auto& pb = new_tablet->mutable_metadata()->mutable_dirty()->pb;
+      pb.set_state(SysTabletsEntryPB::CREATING);
+      pb.set_split_parent_tablet_id(tablet->tablet_id());
+      *pb.mutable_committed_consensus_state() = tablet_lock->data().pb.committed_consensus_state();
+      new_tablet_ids[new_tablets.size()] = new_tablet->tablet_id();
+      tablet_lock->mutable_data()->pb.add_split_tablet_ids(new_tablet->tablet_id());
+      new_tablet_ptrs.push_back(new_tablet.get());
+      new_tablets.push_back(std::move(new_tablet));
+    }
+
+    Status s = sys_catalog_->AddAndUpdateItems(
+        new_tablet_ptrs, std::vector<TabletInfo*>{tablet.get()}, leader_ready_term_);
+    if (!s.ok()) {
+      for (const auto& new_tablet : new_tablets) {
+        new_tablet->mutable_metadata()->AbortMutation();
+      }
+      return s.CloneAndPrepend(
+          Format("An error occurred while registering the split of tablet $0", tablet->id()));
+    }
+    for (const auto& new_tablet : new_tablets) {
+      new_tablet->mutable_metadata()->CommitMutation();
+    }
+    tablet_lock->Commit();
+  }
+
+  // lock_ is taken after the tablet lock is released, since ExtractTabletsToProcess locks
+  // tablets while holding lock_. The new tablets are only looked up after the split is applied.
+  {
+    std::lock_guard<LockType> l(lock_);
+    auto tablet_map_checkout = tablet_map_.CheckOut();
+    for (const auto& new_tablet : new_tablets) {
+      (*tablet_map_checkout)[new_tablet->tablet_id()] = new_tablet;
+    }
+  }
+
+  LOG(INFO) << "Splitting tablet " << tablet->ToString() << " of table " << table->ToString()
+            << " at hash code " << split_hash_code << " into " << yb::ToString(new_tablet_ids);
+  auto call = std::make_shared<AsyncSplitTablet>(
+      master_, worker_pool_.get(), tablet, new_tablet_ids, split_encoded_key.data(),
+      split_partition_key);
+  table->AddTask(call);
+  RETURN_NOT_OK(call->Run());
+  return new_tablet_ids;
+}
+
+Result<CatalogManager::SplitTablets> CatalogManager::LockSplitTablets(
+    const scoped_refptr<TabletInfo>& tablet) {
+  SplitTablets result;
+  std::vector<TabletId> new_tablet_ids;
+  {
+    auto tablet_lock = tablet->LockForRead();
+    for (const auto& new_tablet_id : tablet_lock->data().pb.split_tablet_ids()) {
+      new_tablet_ids.push_back(new_tablet_id);
+    }
+  }
+  {
+    SharedLock<LockType> l(lock_);
+    for (const auto& new_tablet_id : new_tablet_ids) {
+      auto new_tablet = FindPtrOrNull(*tablet_map_, new_tablet_id);
+      if (!new_tablet) {
+        return STATUS_FORMAT(
+            NotFound, "Tablet $0 of the split of $1 not found", new_tablet_id, tablet->id());
+      }
+      result.new_tablets.push_back(std::move(new_tablet));
+    }
+  }
+  // Tablets are locked in the order of their ids, as the tablet reports lock them.
+  std::map<TabletId, TabletInfo*> to_lock;
+  to_lock.emplace(tablet->tablet_id(), tablet.get());
+  for (const auto& new_tablet : result.new_tablets) {
+    to_lock.emplace(new_tablet->tablet_id(), new_tablet.get());
+  }
+  for (const auto& entry : to_lock) {
+    result.locks[entry.first] = entry.second->LockForWrite();
+  }
+  // The split could have been aborted or completed while the tablet was not locked.
+  auto& tablet_lock = *result.locks[tablet->tablet_id()];
+  if (static_cast<size_t>(tablet_lock.data().pb.split_tablet_ids_size()) !=
+          new_tablet_ids.size()) {
+    return STATUS_FORMAT(IllegalState, "Split of tablet $0 changed", tablet->id());
+  }
+  return result;
+}
+
+Status CatalogManager::AbortTabletSplit(const scoped_refptr<TabletInfo>& tablet) {
+  auto split = VERIFY_RESULT(LockSplitTablets(tablet));
+  if (split.new_tablets.empty()) {
+    return Status::OK();
+  }
+  std::vector<TabletInfo*> to_update = {tablet.get()};
+  for (const auto& new_tablet : split.new_tablets) {
+    auto& new_tablet_data = *split.locks[new_tablet->tablet_id()]->mutable_data();
+    if (new_tablet_data.pb.state() != SysTabletsEntryPB::CREATING) {
+      return STATUS_FORMAT(
+          IllegalState, "Tablet $0 of the split of $1 is $2", new_tablet->tablet_id(),
+          tablet->tablet_id(), SysTabletsEntryPB::State_Name(new_tablet_data.pb.state()));
+    }
+    new_tablet_data.set_state(
+        SysTabletsEntryPB::DELETED,
+        Format("Split of $0 aborted at $1", tablet->tablet_id(), LocalTimeAsString()));
+    to_update.push_back(new_tablet.get());
+  }
+  split.locks[tablet->tablet_id()]->mutable_data()->pb.clear_split_tablet_ids();
+  RETURN_NOT_OK(sys_catalog_->UpdateItems(to_update, leader_ready_term_));
+  for (auto& lock : split.locks) {
+    lock.second->Commit();
+  }
+  LOG(INFO) << "Aborted split of tablet " << tablet->ToString();
+  return Status::OK();
+}
+
+Status CatalogManager::CompleteTabletSplit(const scoped_refptr<TabletInfo>& new_tablet) {
+  const TabletId tablet_id = new_tablet->LockForRead()->data().pb.split_parent_tablet_id();
+  if (tablet_id.empty() || FLAGS_skip_complete_tablet_split) {
+    return Status::OK();
+  }
+  scoped_refptr<TabletInfo> tablet;
+  {
+    SharedLock<LockType> l(lock_);
+    tablet = FindPtrOrNull(*tablet_map_, tablet_id);
+  }
+  if (!tablet) {
+    return STATUS_FORMAT(NotFound, "Split tablet of $0 not found", new_tablet->tablet_id());
+  }
+
+  auto split = VERIFY_RESULT(LockSplitTablets(tablet));
+  std::vector<TabletInfo*> to_update = {tablet.get()};
+  std::vector<TabletInfo*> new_tablets;
+  for (const auto& split_tablet : split.new_tablets) {
+    auto& new_tablet_data = *split.locks[split_tablet->tablet_id()]->mutable_data();
+    if (!new_tablet_data.pb.has_split_parent_tablet_id()) {
+      // Completed for the other tablet of the split.
+      return Status::OK();
+    }
+    // Both tablets replace the split tablet at once, so that the partitions of the table do not
+    // have gaps.
+    if (!new_tablet_data.is_running()) {
+      VLOG(1) << "Split of tablet " << tablet->tablet_id() << " is waiting for tablet "
+              << split_tablet->tablet_id() << " to run";
+      return Status::OK();
+    }
+    new_tablet_data.pb.clear_split_parent_tablet_id();
+    to_update.push_back(split_tablet.get());
+    new_tablets.push_back(split_tablet.get());
+  }
+  if (new_tablets.size() != 2) {
+    return STATUS_FORMAT(
+        IllegalState, "Split of tablet $0 has $1 tablets", tablet->tablet_id(), new_tablets.size());
+  }
+
+  // The split tablet is replaced, so its replicas are deleted when they are reported.
+  split.locks[tablet->tablet_id()]->mutable_data()->set_state(
+      SysTabletsEntryPB::REPLACED,
+      Format("Split into $0 and $1 at $2", new_tablets[0]->tablet_id(),
+             new_tablets[1]->tablet_id(), LocalTimeAsString()));
+  RETURN_NOT_OK(sys_catalog_->UpdateItems(to_update, leader_ready_term_));
+  // The first new tablet starts at the same partition key, so it takes the place of the split
+  // tablet in the table.
+  tablet->table()->AddTablets(new_tablets);
+  for (auto& lock : split.locks) {
+    lock.second->Commit();
+  }
+  tablet_locations_version_.fetch_add(1, std::memory_order_acq_rel);
+  // The partitions of the table changed, so clients should not use the ones they cached.
+  table_changes_log_.TableChanged(tablet->table()->id());
+  LOG(INFO) << "Completed split of tablet " << tablet->ToString() << " into "
+            << new_tablets[0]->tablet_id() << " and " << new_tablets[1]->tablet_id();
+  return Status::OK();
+}
+
 Status CatalogManager::GetTableSchema(const GetTableSchemaRequestPB* req,
                                       GetTableSchemaResponsePB* resp) {
   VLOG(1) << "Servicing GetTableSchema request for " << req->ShortDebugString();
@@ -3885,6 +4220,23 @@ void CatalogManager::NotifyTabletDeleteFinished(const TabletServerId& tserver_uu
   }
 }
 
+namespace {
+
+uint64_t ReportFingerprint(const ReportedTabletPB& report) {
+  return std::hash<std::string>()(report.SerializeAsString());
+}
+
+// Returns whether the master knows the replica of the tablet on the TS in the reported state.
+bool ReplicaMatchesReport(
+    const TabletInfo& tablet, const TSDescriptor& ts_desc, const ReportedTabletPB& report) {
+  TabletInfo::ReplicaMap locations;
+  tablet.GetReplicaLocations(&locations);
+  auto it = locations.find(ts_desc.permanent_uuid());
+  return it != locations.end() && it->second.state == report.state();
+}
+
+} // namespace
+
 Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
                                            const TabletReportPB& full_report,
                                            TabletReportUpdatesPB* full_report_update,
@@ -3923,9 +4275,22 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   // Tablet Deletes to process after the catalog lock below.
   set<TabletId> tablets_to_delete;
 
+  // Fingerprints of the reports in 'reports', remembered once their processing is done, so
+  // incremental reports that repeat them could be skipped.
+  map<TabletId, uint64_t> fingerprints;
+
+  const auto start_time = MonoTime::Now();
+  const int64_t term = leader_ready_term();
+  if (!full_report.is_incremental()) {
+    ts_desc->ClearTabletReportFingerprints();
+  }
+
   {
-    // Lock the catalog to iterate over tablet_ids_map_ & table_ids_map_.
-    SharedLock<LockType> catalog_lock(lock_);
+    // Use snapshots of tablet_map_ & table_ids_map_, so a large report does not block writers of
+    // the catalog maps. The tables are taken after the tablets, since tables are added before
+    // their tablets, so a tablet is only reported as orphaned if its table was deleted.
+    const auto tablet_map = FreshSnapshot(tablet_map_);
+    const auto table_ids_map = FreshSnapshot(table_ids_map_);
 
     // Fill the above variables before processing
     full_report_update->mutable_tablets()->Reserve(num_tablets);
@@ -3938,7 +4303,7 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
       update->set_tablet_id(tablet_id);
 
       // 1b. Find the tablet, deleting/skipping it if it can't be found.
-      scoped_refptr<TabletInfo> tablet = FindPtrOrNull(*tablet_map_, tablet_id);
+      scoped_refptr<TabletInfo> tablet = FindPtrOrNull(*tablet_map, tablet_id);
       if (!tablet) {
         // It'd be unsafe to ask the tserver to delete this tablet without first
         // replicating something to our followers (i.e. to guarantee that we're
@@ -3951,18 +4316,33 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
         LOG(WARNING) << "Ignoring report from unknown tablet " << tablet_id;
         continue;
       }
-      if (!tablet->table() || FindOrNull(*table_ids_map_, tablet->table()->id()) == nullptr) {
+      if (!tablet->table() || FindOrNull(*table_ids_map, tablet->table()->id()) == nullptr) {
         auto table_id = tablet->table() == nullptr ? "(null)" : tablet->table()->id();
         LOG(INFO) << "Got report from an orphaned tablet " << tablet_id << " on table " << table_id;
         tablets_to_delete.insert(tablet_id);
         continue;
       }
 
-      // 1c. Found the tablet, update local state. If multiple tablets with the
+      // 1c. Skip the tablet if this TS already reported it the same way, and the master still
+      // knows the replica in the reported state. E.g. tablets being remote bootstrapped are in
+      // every incremental report, and reports are sent again when their response was lost.
+      const uint64_t fingerprint = ReportFingerprint(report);
+      if (full_report.is_incremental() &&
+          ts_desc->IsTabletReportUnchanged(tablet_id, term, fingerprint) &&
+          ReplicaMatchesReport(*tablet, *ts_desc, report)) {
+        VLOG(3) << "Skipping unchanged report of " << tablet_id;
+        if (metric_tablet_report_unchanged_tablets_) {
+          metric_tablet_report_unchanged_tablets_->Increment();
+        }
+        continue;
+      }
+
+      // 1d. Found the tablet, update local state. If multiple tablets with the
       // same ID are in the report, all but the last one will be ignored.
       reports[tablet_id] = &report;
       updates[tablet_id] = update;
       tablet_infos[tablet_id] = tablet;
+      fingerprints[tablet_id] = fingerprint;
     }
   }
 
@@ -3972,6 +4352,9 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
         "Report from an orphaned tablet");
   }
 
+  // Running tablets of splits that did not replace the split tablet yet.
+  vector<scoped_refptr<TabletInfo>> running_split_tablets;
+
   // Doing batched processing with inner 'for' loops.  Ensure we iterate all tablets with 'while'.
   auto tablet_iter = tablet_infos.begin();
   while (tablet_iter != tablet_infos.end()) {
@@ -4000,6 +4383,9 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
     // 2b. Second Pass.  Process each tablet. This may not be in the order that the tablets
     // appear in 'full_report', but that has no bearing on correctness.
     vector<TabletInfo*> mutated_tablets; // refcount protected by 'tablet_infos'
+    // Tablets that were processed without sending any RPCs for them, so their reports are not
+    // needed again unless they change.
+    vector<TabletId> settled_tablets;
     auto tablet_iter_for_schema_changes = tablet_iter;
     for (auto i = 0;
          i < FLAGS_catalog_manager_report_batch_size && tablet_iter != tablet_infos.end();
@@ -4009,6 +4395,7 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
       const scoped_refptr<TableInfo>& table = tablet->table();
       const ReportedTabletPB& report = *FindOrDie(reports, tablet_id);
       ReportedTabletUpdatesPB* update = FindOrDie(updates, tablet_id);
+      const size_t num_rpcs = rpcs.size();
       // Get tablet lock on demand.  This works in the batch case because the loop is ordered.
       tablet_write_locks[tablet_id] = tablet->LockForWrite();
       auto& table_lock = table_read_locks[table->id()];
@@ -4130,6 +4517,12 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
           tablet_was_mutated = true;
         }
 
+        // A tablet of a split is checked for completing the split for as long as it is running.
+        if (tablet_lock->mutable_data()->is_running() &&
+            tablet_lock->mutable_data()->pb.has_split_parent_tablet_id()) {
+          running_split_tablets.push_back(tablet);
+        }
+
         // 6d. Update the consensus state if:
         // - A config change operation was committed (reflected by a change to
         //   the committed config's opid_index).
@@ -4253,6 +4646,9 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
         // tablets are being remote bootstrapped at once, so only process incremental reports here.
         UpdateTabletReplicaInLocalMemory(ts_desc, nullptr /* consensus */, report.state(), tablet);
       }
+      if (rpcs.size() == num_rpcs) {
+        settled_tablets.push_back(tablet_id);
+      }
     } // Finished one round of batch processing.
 
     // 9. Unlock the tables; we no longer need to access their state.
@@ -4279,6 +4675,9 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
       l.second->Commit();
     }
     tablet_write_locks.clear();
+    for (const auto& tablet_id : settled_tablets) {
+      ts_desc->SetTabletReportFingerprint(tablet_id, term, FindOrDie(fingerprints, tablet_id));
+    }
 
     // 12. Third Pass. Process all tablet schema version changes.
     // (This is separate from tablet state mutations because only table on-disk state is changed.)
@@ -4306,6 +4705,11 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
     rpcs.clear();
   } // Loop to process the next batch until fully iterated.
 
+  for (const auto& tablet : running_split_tablets) {
+    WARN_NOT_OK(CompleteTabletSplit(tablet),
+                Format("Failed to complete split into tablet $0", tablet->tablet_id()));
+  }
+
   if (!full_report.is_incremental()) {
     if (full_report.updated_tablets_size() == 0) {
       LOG(INFO) << ts_desc->permanent_uuid() << " sent full tablet report with 0 tablets.";
@@ -4322,6 +4726,11 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
     background_tasks_->WakeIfHasPendingUpdates();
   }
 
+  if (metric_tablet_report_processing_time_) {
+    metric_tablet_report_processing_time_->Increment(
+        (MonoTime::Now() - start_time).ToMicroseconds());
+  }
+
   return Status::OK();
 }
 
@@ -5666,6 +6075,11 @@ void CatalogManager::ExtractTabletsToProcess(
       continue;
     }
 
+    // Tablets of a split are created by the tablet servers that apply it, not assigned.
+    if (tablet_lock->data().pb.has_split_parent_tablet_id()) {
+      continue;
+    }
+
     // Tablets not yet assigned or with a report just received.
     tablets_to_process->push_back(tablet);
   }
@@ -5800,6 +6214,7 @@ Status CatalogManager::HandleTabletSchemaVersionReport(TabletInfo *tablet, uint3
     }
 
     l->Commit();
+    table_changes_log_.TableChanged(table->id());
     LOG_WITH_PREFIX(INFO) << table->ToString() << " - Alter table completed version="
                           << current_version;
   }
@@ -5988,11 +6403,12 @@ Status CatalogManager::SelectReplicasForTablet(const TSDescriptorVector& ts_desc
   // Validate that we do not have placement blocks in both cluster and table data.
   RETURN_NOT_OK(ValidateTableReplicationInfo(table_guard->data().pb.replication_info()));
 
-  // Default to the cluster placement object.
+  // Default to the cluster placement object, with the read only placements of the table.
   ReplicationInfoPB replication_info;
   {
     auto l = cluster_config_->LockForRead();
-    replication_info = l->data().pb.replication_info();
+    replication_info = CatalogManagerUtil::TableReplicationInfo(
+        l->data().pb.replication_info(), table_guard->data().pb.replication_info());
   }
 
   // Select the set of replicas for the tablet.
@@ -6117,19 +6533,44 @@ Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB&
 }
 
 void CatalogManager::SendCreateTabletRequests(const vector<TabletInfo*>& tablets) {
+  const size_t batch_size = std::max(FLAGS_tablet_creation_batch_size, 1);
+  // Replicas to create with a single request, by table and tablet server.
+  std::map<std::pair<TableInfo*, TabletServerId>, vector<TabletInfo*>> batches;
   for (TabletInfo *tablet : tablets) {
     const consensus::RaftConfigPB& config =
         tablet->metadata().dirty().pb.committed_consensus_state().config();
     tablet->set_last_update_time(MonoTime::Now());
     for (const RaftPeerPB& peer : config.peers()) {
-      auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
-          peer.permanent_uuid(), tablet);
-      tablet->table()->AddTask(task);
-      WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
+      if (batch_size == 1) {
+        auto task = std::make_shared<AsyncCreateReplica>(master_, worker_pool_.get(),
+            peer.permanent_uuid(), tablet);
+        tablet->table()->AddTask(task);
+        WARN_NOT_OK(task->Run(), "Failed to send new tablet request");
+        continue;
+      }
+      auto& batch = batches[std::make_pair(tablet->table().get(), peer.permanent_uuid())];
+      batch.push_back(tablet);
+      if (batch.size() >= batch_size) {
+        SendCreateTabletsRequest(peer.permanent_uuid(), batch);
+        batch.clear();
+      }
+    }
+  }
+  for (const auto& batch : batches) {
+    if (!batch.second.empty()) {
+      SendCreateTabletsRequest(batch.first.second, batch.second);
     }
   }
 }
 
+void CatalogManager::SendCreateTabletsRequest(const TabletServerId& permanent_uuid,
+                                              const vector<TabletInfo*>& tablets) {
+  auto task = std::make_shared<AsyncCreateReplicas>(master_, worker_pool_.get(),
+      permanent_uuid, tablets);
+  tablets.front()->table()->AddTask(task);
+  WARN_NOT_OK(task->Run(), "Failed to send new tablets request");
+}
+
 shared_ptr<TSDescriptor> CatalogManager::PickBetterReplicaLocation(
     const TSDescriptorVector& two_choices) {
   DCHECK_EQ(two_choices.size(), 2);
@@ -6349,12 +6790,9 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id, TabletLocat
   RETURN_NOT_OK(CheckOnline());
 
   locs_pb->mutable_replicas()->Clear();
-  scoped_refptr<TabletInfo> tablet_info;
-  {
-    SharedLock<LockType> l(lock_);
-    if (!FindCopy(*tablet_map_, tablet_id, &tablet_info)) {
-      return STATUS_SUBSTITUTE(NotFound, "Unknown tablet $0", tablet_id);
-    }
+  scoped_refptr<TabletInfo> tablet_info = FindTabletInSnapshot(tablet_id);
+  if (!tablet_info) {
+    return STATUS_SUBSTITUTE(NotFound, "Unknown tablet $0", tablet_id);
   }
 
   Status s = BuildLocationsForTablet(tablet_info, locs_pb);
@@ -6395,10 +6833,19 @@ Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
   auto l = table->LockForRead();
   RETURN_NOT_OK(CheckIfTableDeletedOrNotRunning(l.get(), resp));
 
+  // Taken before building the locations, so that changes while they are built are not missed.
+  const uint64_t version = tablets_version() + tablet_locations_version();
+  if (table_locations_cache_.Find(table->id(), *req, version, resp)) {
+    return Status::OK();
+  }
+
   vector<scoped_refptr<TabletInfo>> tablets_in_range;
   table->GetTabletsInRange(req, &tablets_in_range);
 
   bool require_tablets_runnings = req->require_tablets_running();
+  // Only complete responses are cached, tablets that are not running or have no known replicas
+  // could be reported without bumping the version.
+  bool cacheable = true;
   for (const scoped_refptr<TabletInfo>& tablet : tablets_in_range) {
     auto status = BuildLocationsForTablet(tablet, resp->add_tablet_locations());
     if (!status.ok()) {
@@ -6408,10 +6855,16 @@ Status CatalogManager::GetTableLocations(const GetTableLocationsRequestPB* req,
         return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, status);
       }
       resp->mutable_tablet_locations()->RemoveLast();
+      cacheable = false;
+    } else if (resp->tablet_locations().rbegin()->stale()) {
+      cacheable = false;
     }
   }
 
   resp->set_table_type(table->metadata().state().pb.table_type());
+  if (cacheable) {
+    table_locations_cache_.Insert(table->id(), *req, version, *resp);
+  }
   return Status::OK();
 }
 
@@ -33,6 +33,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <array>
 #include <list>
 #include <map>
 #include <set>
@@ -59,6 +60,8 @@
 #include "yb/master/permissions_manager.h"
 #include "yb/master/sys_catalog_initialization.h"
 #include "yb/master/scoped_leader_shared_lock.h"
+#include "yb/master/table_changes_log.h"
+#include "yb/master/table_locations_cache.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/yql_virtual_table.h"
@@ -78,6 +81,8 @@
 
 namespace yb {
 
+class Counter;
+class Histogram;
 class Schema;
 class ThreadPool;
 
@@ -112,6 +117,7 @@ class TSDescriptor;
 class ChangeEncryptionInfoRequestPB;
 class ChangeEncryptionInfoResponsePB;
 class TasksTracker;
+class TabletSplitManager;
 
 struct DeferredAssignmentActions;
 
@@ -388,6 +394,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
 
   uint64_t GetYsqlCatalogVersion();
 
+  const TableChangesLog& table_changes_log() const {
+    return table_changes_log_;
+  }
+
   virtual CHECKED_STATUS FillHeartbeatResponse(const TSHeartbeatRequestPB* req,
                                                TSHeartbeatResponsePB* resp);
 
@@ -628,6 +638,16 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
     return *encryption_manager_;
   }
 
+  // Splits the tablet of a hash partitioned table at the hash code: registers the two tablets it
+  // is split into and asks the leader of the tablet to split it. The new tablets replace the
+  // tablet in the partitions of the table once both are running. Returns their ids.
+  // Takes the write lock of the tablet and releases it before taking lock_.
+  Result<std::array<TabletId, 2>> SplitTablet(
+      const scoped_refptr<TabletInfo>& tablet, uint16_t split_hash_code);
+
+  // Drops the tablets of a split of the tablet, that was refused by the leader of the tablet.
+  CHECKED_STATUS AbortTabletSplit(const scoped_refptr<TabletInfo>& tablet);
+
   // Registers new tablet with `partition` for the same table as `source_tablet_id` tablet.
   // Does not change any other tablets and their partitions.
   // Returns TabetInfo for registered tablet.
@@ -864,6 +884,20 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // This method is called by "ProcessPendingAssignments()".
   CHECKED_STATUS SelectReplicasForTablet(const TSDescriptorVector& ts_descs, TabletInfo* tablet);
 
+  // A split tablet and the tablets it is split into, locked for write.
+  struct SplitTablets {
+    std::vector<scoped_refptr<TabletInfo>> new_tablets;
+    std::map<TabletId, std::unique_ptr<TabletInfo::lock_type>> locks;
+  };
+
+  // Locks the tablet and the tablets it is split into, if any. Must not be called with lock_
+  // held, it is taken briefly to look up the new tablets before they are locked.
+  Result<SplitTablets> LockSplitTablets(const scoped_refptr<TabletInfo>& tablet);
+
+  // Replaces the split tablet with the tablets of the split, once both are running. Called for
+  // the reported running tablets of splits.
+  CHECKED_STATUS CompleteTabletSplit(const scoped_refptr<TabletInfo>& new_tablet);
+
   // Select N Replicas from the online tablet servers that have been chosen to respect the
   // placement information provided. Populate the consensus configuration object with choices and
   // also update the set of selected tablet servers, to not place several replicas on the same TS.
@@ -900,6 +934,10 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // CREATING to ensure coherent state after Master failover.
   void SendCreateTabletRequests(const std::vector<TabletInfo*>& tablets);
 
+  // Send a request to create replicas of the tablets, of the same table, on the tablet server.
+  void SendCreateTabletsRequest(const TabletServerId& permanent_uuid,
+                                const std::vector<TabletInfo*>& tablets);
+
   // Send the "alter table request" to all tablets of the specified table.
   //
   // Also, initiates the required AlterTable requests to backfill the Index.
@@ -1034,6 +1072,17 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   template <class Loader>
   CHECKED_STATUS Load(const std::string& title, const int64_t term);
 
+  // Returns the snapshot of the current version of the map, waiting for writers of the catalog
+  // maps if the map was modified since the last snapshot. Should not be called with lock_ held.
+  template <class Map>
+  std::shared_ptr<const Map> FreshSnapshot(const VersionTracker<Map>& map) const;
+
+  // Looks the table or tablet up in the last snapshot of table_ids_map_ or tablet_map_, so lookups
+  // of existing entries do not wait for writers of the catalog maps. A fresh snapshot is only
+  // taken when the entry is missing from a stale one. Should not be called with lock_ held.
+  scoped_refptr<TableInfo> FindTableInSnapshot(const TableId& table_id) const;
+  scoped_refptr<TabletInfo> FindTabletInSnapshot(const TabletId& tablet_id) const;
+
   // ----------------------------------------------------------------------------------------------
   // Private member fields
   // ----------------------------------------------------------------------------------------------
@@ -1152,11 +1201,21 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Number of dead tservers metric.
   scoped_refptr<AtomicGauge<uint32_t>> metric_num_tablet_servers_dead_;
 
+  // Time spent waiting for fresh snapshots of the catalog maps.
+  scoped_refptr<Histogram> metric_catalog_maps_snapshot_wait_;
+
+  // Time spent processing tablet reports, and tablets skipped in them since they did not change.
+  scoped_refptr<Histogram> metric_tablet_report_processing_time_;
+  scoped_refptr<Counter> metric_tablet_report_unchanged_tablets_;
+
   friend class ClusterLoadBalancer;
 
   // Policy for load balancing tablets on tablet servers.
   std::unique_ptr<ClusterLoadBalancer> load_balance_policy_;
 
+  // Decides which tablets to split.
+  std::unique_ptr<TabletSplitManager> tablet_split_manager_;
+
   // Tablet peer for the sys catalog tablet's peer.
   const std::shared_ptr<tablet::TabletPeer> tablet_peer() const;
 
@@ -1175,6 +1234,11 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
 
   std::unique_ptr<PermissionsManager> permissions_manager_;
 
+  // Recent table changes sent to tablet servers with heartbeat responses.
+  TableChangesLog table_changes_log_;
+
+  TableLocationsCache table_locations_cache_;
+
   // This is used for tracking that initdb has started running previously.
   std::atomic<bool> pg_proc_exists_{false};
 
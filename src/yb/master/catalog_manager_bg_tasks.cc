@@ -140,6 +140,7 @@ void CatalogManagerBgTasks::Run() {
         }
       } else {
         catalog_manager_->load_balance_policy_->RunLoadBalancer();
+        catalog_manager_->tablet_split_manager_->MaybeSplitTablets();
       }
 
       if (!to_delete.empty() || catalog_manager_->AreTablesDeleting()) {
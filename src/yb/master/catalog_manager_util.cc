@@ -13,6 +13,8 @@
 
 #include "yb/master/catalog_manager_util.h"
 
+#include <algorithm>
+
 #include <gflags/gflags.h>
 
 #include "yb/util/flag_tags.h"
@@ -104,5 +106,26 @@ Status CatalogManagerUtil::DoesPlacementInfoContainCloudInfo(const PlacementInfo
                            placement_info.DebugString(), cloud_info_string);
 }
 
+ReplicationInfoPB CatalogManagerUtil::TableReplicationInfo(const ReplicationInfoPB& cluster_info,
+                                                           const ReplicationInfoPB& table_info) {
+  ReplicationInfoPB result = cluster_info;
+  for (const auto& table_placement : table_info.read_replicas()) {
+    auto* placements = result.mutable_read_replicas();
+    auto it = std::find_if(
+        placements->begin(), placements->end(), [&table_placement](const PlacementInfoPB& pb) {
+          return pb.placement_uuid() == table_placement.placement_uuid();
+        });
+    if (it != placements->end()) {
+      *it = table_placement;
+    } else {
+      *placements->Add() = table_placement;
+    }
+  }
+  if (!table_info.affinitized_leaders().empty()) {
+    *result.mutable_affinitized_leaders() = table_info.affinitized_leaders();
+  }
+  return result;
+}
+
 } // namespace master
 } // namespace yb
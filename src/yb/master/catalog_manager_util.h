@@ -47,6 +47,12 @@ class CatalogManagerUtil {
   static CHECKED_STATUS DoesPlacementInfoContainCloudInfo(const PlacementInfoPB& placement_info,
                                                           const CloudInfoPB& cloud_info);
 
+  // Returns the replication info of a table with the given table level replication info. The read
+  // only placements of the table override the cluster ones with the same placement uuid, and are
+  // added to them otherwise. The preferred leader zones of the table override the cluster ones.
+  static ReplicationInfoPB TableReplicationInfo(const ReplicationInfoPB& cluster_info,
+                                                const ReplicationInfoPB& table_info);
+
  private:
   CatalogManagerUtil();
 
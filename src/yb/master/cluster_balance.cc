@@ -76,6 +76,18 @@ DEFINE_test_flag(bool, load_balancer_handle_under_replicated_tablets_only, false
 DEFINE_bool(load_balancer_skip_leader_as_remove_victim, true,
             "Should the LB skip a leader as a possible remove candidate.");
 
+DEFINE_bool(load_balancer_cost_based, false,
+            "Balance the sum of the costs of the tablets on each tablet server, computed from the "
+            "operations per second and SST files size the tablets reported, rather than their "
+            "number.");
+TAG_FLAG(load_balancer_cost_based, advanced);
+
+DEFINE_double(load_balancer_cost_load_weight, 0.5,
+              "In cost based load balancing, the share of the cost of a tablet replica that is "
+              "proportional to its load, the rest is the same for all replicas. 0 balances the "
+              "number of tablets, 1 only their load.");
+TAG_FLAG(load_balancer_cost_load_weight, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -393,6 +405,9 @@ Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
     }
   }
 
+  // With all the leaders known, compute the costs of the tablets from their reported loads.
+  state_->ComputeTabletCosts();
+
   // After updating the tablets and tablet servers, adjust the configured threshold if it is too
   // low for the given configuration.
   state_->AdjustLeaderBalanceThreshold();
@@ -582,7 +597,8 @@ Result<bool> ClusterLoadBalancer::GetLoadToMove(
       int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
 
       // Check for state change or end conditions.
-      if (left == right || load_variance < state_->options_->kMinLoadVarianceToBalance) {
+      if (left == right ||
+          load_variance < state_->options_->kMinLoadVarianceToBalance * state_->CostUnit()) {
         // Either both left and right are at the end, or our load_variance is already too small,
         // which means it will be too small for any TSs between left and right, so we can return.
         if (right == last_pos) {
@@ -593,7 +609,8 @@ Result<bool> ClusterLoadBalancer::GetLoadToMove(
       }
 
       // If we don't find a tablet_id to move between these two TSs, advance the state.
-      if (VERIFY_RESULT(GetTabletToMove(high_load_uuid, low_load_uuid, moving_tablet_id))) {
+      if (VERIFY_RESULT(GetTabletToMove(
+              high_load_uuid, low_load_uuid, load_variance, moving_tablet_id))) {
         // If we got this far, we have the candidate we want, so fill in the output params and
         // return. The tablet_id is filled in from GetTabletToMove.
         *from_ts = high_load_uuid;
@@ -614,7 +631,7 @@ Result<bool> ClusterLoadBalancer::ShouldSkipLeaderAsVictim(const TabletId& table
   {
     auto l = tablet->table()->LockForRead();
     // If we have a custom per-table placement policy, use that.
-    if (l->data().pb.has_replication_info()) {
+    if (l->data().pb.replication_info().has_live_replicas()) {
       num_replicas = l->data().pb.replication_info().live_replicas().num_replicas();
     } else {
       // Otherwise, default to cluster policy.
@@ -631,7 +648,8 @@ Result<bool> ClusterLoadBalancer::ShouldSkipLeaderAsVictim(const TabletId& table
 }
 
 Result<bool> ClusterLoadBalancer::GetTabletToMove(
-    const TabletServerId& from_ts, const TabletServerId& to_ts, TabletId* moving_tablet_id) {
+    const TabletServerId& from_ts, const TabletServerId& to_ts, int load_variance,
+    TabletId* moving_tablet_id) {
   const auto& from_ts_meta = state_->per_ts_meta_[from_ts];
   set<TabletId> non_over_replicated_tablets;
   set<TabletId> all_tablets;
@@ -660,7 +678,19 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
   // prioritize moving from non-leaders, keep iterating until we find such a move. Otherwise,
   // return the move from the leader.
   bool found_tablet_move_from_leader = false;
+  // In cost based balancing, moving a tablet that costs as much as the load variance would not
+  // make the loads closer, otherwise the costliest tablet is moved, to balance in fewer moves.
+  const bool cost_based = state_->cost_based_;
+  int leader_move_cost = 0;
+  int non_leader_move_cost = 0;
+  bool found_tablet_move_from_non_leader = false;
+  TabletId leader_move_tablet_id;
   for (const auto& tablet_id : non_over_replicated_tablets) {
+    const int cost = state_->per_tablet_meta_[tablet_id].cost;
+    if (cost_based && cost >= load_variance) {
+      continue;
+    }
+
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
     // leaving us with more than the minimum.
@@ -677,8 +707,16 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
 
     if (!moving_from_leader) {
       // If we're not moving from a leader, choose this tablet and return true.
-      *moving_tablet_id = tablet_id;
-      return true;
+      if (!cost_based) {
+        *moving_tablet_id = tablet_id;
+        return true;
+      }
+      if (!found_tablet_move_from_non_leader || cost > non_leader_move_cost) {
+        *moving_tablet_id = tablet_id;
+        non_leader_move_cost = cost;
+        found_tablet_move_from_non_leader = true;
+      }
+      continue;
     }
 
     // We are trying to move a leader.
@@ -686,15 +724,23 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
       continue;
     }
 
-    if (!found_tablet_move_from_leader) {
+    if (!found_tablet_move_from_leader || (cost_based && cost > leader_move_cost)) {
       // We haven't found a previous leader move, so this is our best move until we find a move
       // from a non-leader.
-      *moving_tablet_id = tablet_id;
+      leader_move_tablet_id = tablet_id;
+      leader_move_cost = cost;
       found_tablet_move_from_leader = true;
     }
   }
 
+  if (found_tablet_move_from_non_leader) {
+    return true;
+  }
+
   // We couldn't find any moves from a non-leader, so return true if we found a move from a leader.
+  if (found_tablet_move_from_leader) {
+    *moving_tablet_id = leader_move_tablet_id;
+  }
   return found_tablet_move_from_leader;
 }
 
@@ -769,8 +815,9 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
           state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
-      if (left == right || (load_variance < state_->options_->kMinLeaderLoadVarianceToBalance &&
-            !high_leader_blacklisted)) {
+      const double min_load_variance =
+          state_->options_->kMinLeaderLoadVarianceToBalance * state_->CostUnit();
+      if (left == right || (load_variance < min_load_variance && !high_leader_blacklisted)) {
         // Either both left and right are at the end, or our load_variance is already too small,
         // which means it will be too small for any TSs between left and right, so we can return.
         if (right == last_pos) {
@@ -789,6 +836,11 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
       for (const auto& tablet_id : intersection) {
+        // Moving a leader that costs as much as the load variance would not make the loads closer.
+        if (state_->cost_based_ && !high_leader_blacklisted &&
+            state_->per_tablet_meta_[tablet_id].leader_cost >= load_variance) {
+          continue;
+        }
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
@@ -815,8 +867,7 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
         }
 
         // Leader movement solely due to leader blacklist.
-        if (load_variance < state_->options_->kMinLeaderLoadVarianceToBalance &&
-            high_leader_blacklisted) {
+        if (load_variance < min_load_variance && high_leader_blacklisted) {
           state_->LogSortedLeaderLoad();
           LOG(INFO) << "Move tablet " << tablet_id << " leader from leader blacklisted TS "
             << *from_ts << " to TS " << *to_ts;
@@ -48,6 +48,10 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_bool(load_balancer_cost_based);
+
+DECLARE_double(load_balancer_cost_load_weight);
+
 namespace yb {
 namespace master {
 
@@ -121,6 +125,10 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Cost of a replica and of the leader of this tablet, used as the load in cost based balancing.
+  int cost = 1;
+  int leader_cost = 1;
+
   std::string ToString() const {
     return Format("{ running: $0 starting: $1 is_under_replicated: $2 "
                       "under_replicated_placements: $3 is_over_replicated: $4 "
@@ -187,6 +195,7 @@ class ClusterLoadState {
  public:
   ClusterLoadState()
       : leader_balance_threshold_(FLAGS_leader_balance_threshold),
+        cost_based_(FLAGS_load_balancer_cost_based),
         current_time_(MonoTime::Now()) {}
   virtual ~ClusterLoadState() {}
 
@@ -242,12 +251,78 @@ class ClusterLoadState {
   // Get the load for a certain TS.
   int GetLoad(const TabletServerId& ts_uuid) const {
     const auto& ts_meta = per_ts_meta_.at(ts_uuid);
+    if (cost_based_) {
+      return SumCosts(ts_meta.starting_tablets, &CBTabletMetadata::cost) +
+             SumCosts(ts_meta.running_tablets, &CBTabletMetadata::cost);
+    }
     return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
   }
 
   // Get the load for a certain TS.
   int GetLeaderLoad(const TabletServerId& ts_uuid) const {
-    return per_ts_meta_.at(ts_uuid).leaders.size();
+    const auto& leaders = per_ts_meta_.at(ts_uuid).leaders;
+    if (cost_based_) {
+      return SumCosts(leaders, &CBTabletMetadata::leader_cost);
+    }
+    return leaders.size();
+  }
+
+  // The load of a tablet replica with an average load. The load variance thresholds are in these
+  // units.
+  int CostUnit() const {
+    return cost_based_ ? kCostUnit : 1;
+  }
+
+  // In cost based balancing, computes the costs of the tablets of the table from the loads their
+  // leaders reported. A replica costs kCostUnit when the tablet has the mean load of the table,
+  // load_balancer_cost_load_weight says how much of it grows with the load of the tablet, the rest
+  // is the same for all tablets. The load is the mean of the ratios of the operations per second
+  // and of the SST files size of the tablet to the table means, the leader cost only counts the
+  // operations, that leaders serve.
+  void ComputeTabletCosts() {
+    if (!cost_based_) {
+      return;
+    }
+    struct Load {
+      double ops;
+      double size;
+    };
+    std::unordered_map<TabletId, Load> loads;
+    Load total = {0, 0};
+    for (const auto& entry : per_tablet_meta_) {
+      auto ts_it = per_ts_meta_.find(entry.second.leader_uuid);
+      if (ts_it == per_ts_meta_.end() || !ts_it->second.descriptor) {
+        // Tablets without a known leader keep the cost of an average tablet.
+        continue;
+      }
+      TSDescriptor::TabletLoad tablet_load;
+      Load load = {0, 0};
+      if (ts_it->second.descriptor->GetTabletLoad(entry.first, &tablet_load)) {
+        load.ops = tablet_load.read_ops_per_sec + tablet_load.write_ops_per_sec;
+        load.size = tablet_load.sst_file_size;
+      }
+      total.ops += load.ops;
+      total.size += load.size;
+      loads.emplace(entry.first, load);
+    }
+    if (loads.empty()) {
+      return;
+    }
+    const double mean_ops = total.ops / loads.size();
+    const double mean_size = total.size / loads.size();
+    const double weight = std::min(std::max(FLAGS_load_balancer_cost_load_weight, 0.0), 1.0);
+    auto cost = [weight](double ratio) {
+      return std::max(1, static_cast<int>(std::round(kCostUnit * (1 - weight + weight * ratio))));
+    };
+    for (const auto& entry : loads) {
+      const double ops_ratio = mean_ops > 0 ? entry.second.ops / mean_ops : 1;
+      const double size_ratio = mean_size > 0 ? entry.second.size / mean_size : 1;
+      auto& tablet_meta = per_tablet_meta_[entry.first];
+      tablet_meta.cost = cost((ops_ratio + size_ratio) / 2);
+      tablet_meta.leader_cost = cost(ops_ratio);
+      VLOG(3) << "Tablet " << entry.first << " cost: " << tablet_meta.cost
+              << ", leader cost: " << tablet_meta.leader_cost;
+    }
   }
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
@@ -633,8 +708,10 @@ class ClusterLoadState {
   }
 
   inline bool IsLeaderLoadBelowThreshold(const TabletServerId& ts_uuid) {
+    // The threshold is a number of leaders, also in cost based balancing.
     return ((leader_balance_threshold_ > 0) &&
-            (GetLeaderLoad(ts_uuid) <= leader_balance_threshold_));
+            (static_cast<int>(per_ts_meta_[ts_uuid].leaders.size()) <=
+                leader_balance_threshold_));
   }
 
   void AdjustLeaderBalanceThreshold() {
@@ -711,6 +788,9 @@ class ClusterLoadState {
   // Number of leaders per each tablet server to balance below.
   int leader_balance_threshold_ = 0;
 
+  // Whether the load is the sum of the tablet costs, rather than the number of tablets.
+  const bool cost_based_;
+
   // List of table server ids sorted by whether leader blacklisted and their leader load.
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
@@ -726,6 +806,18 @@ class ClusterLoadState {
   Options* options_;
 
  private:
+  // The cost of a replica of a tablet with the mean load of its table.
+  static constexpr int kCostUnit = 10;
+
+  int SumCosts(const std::set<TabletId>& tablets, int CBTabletMetadata::*cost) const {
+    int result = 0;
+    for (const auto& tablet_id : tablets) {
+      auto it = per_tablet_meta_.find(tablet_id);
+      result += it != per_tablet_meta_.end() ? it->second.*cost : 1;
+    }
+    return result;
+  }
+
   DISALLOW_COPY_AND_ASSIGN(ClusterLoadState);
 }; // ClusterLoadState
 
@@ -37,10 +37,12 @@
 #include <functional>
 #include <map>
 #include <iomanip>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "yb/common/partition.h"
 #include "yb/common/schema.h"
+#include "yb/common/snapshot.h"
 #include "yb/consensus/consensus.pb.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stringprintf.h"
@@ -49,6 +51,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/master/master.h"
 #include "yb/master/master.pb.h"
+#include "yb/master/master_backup.pb.h"
 #include "yb/master/master_util.h"
 #include "yb/master/sys_catalog.h"
 #include "yb/master/ts_descriptor.h"
@@ -986,6 +989,154 @@ void MasterPathHandlers::HandleTasksPage(const Webserver::WebRequest& req,
   *output << "</table>\n";
 }
 
+void MasterPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                           stringstream* output) {
+  size_t limit = 20;
+  auto limit_arg = req.parsed_args.find("limit");
+  if (limit_arg != req.parsed_args.end()) {
+    limit = std::max(atoi(limit_arg->second.c_str()), 1);
+  }
+
+  std::unordered_map<TabletId, std::string> tablet_tables;
+  vector<scoped_refptr<TableInfo>> tables;
+  master_->catalog_manager()->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+  for (const auto& table : tables) {
+    TabletInfos tablets;
+    table->GetAllTablets(&tablets);
+    const auto table_name = table->name();
+    for (const auto& tablet : tablets) {
+      tablet_tables[tablet->tablet_id()] = table_name;
+    }
+  }
+  auto table_name = [&tablet_tables](const TabletId& tablet_id) {
+    auto it = tablet_tables.find(tablet_id);
+    return EscapeForHtmlToString(it != tablet_tables.end() ? it->second : std::string());
+  };
+
+  struct Replica {
+    TSDescriptorPtr ts_desc;
+    TabletId tablet_id;
+    TSDescriptor::TabletLoad load;
+  };
+  std::vector<Replica> replicas;
+  TSDescriptorVector descs;
+  master_->ts_manager()->GetAllDescriptors(&descs);
+  for (const auto& desc : descs) {
+    for (auto& tablet_id_and_load : desc->GetTabletLoads()) {
+      replicas.push_back(
+          Replica{desc, tablet_id_and_load.first, std::move(tablet_id_and_load.second)});
+    }
+  }
+
+  *output << "<h1>Hot Tablets and Keys</h1>\n";
+  *output << "<p>The rates of the tablets are of the last metrics the tablet servers sent, and the "
+             "rates of the keys are estimated from a sample of the operations in the last one or "
+             "two windows of --tablet_hot_keys_window_sec.</p>\n";
+
+  std::sort(replicas.begin(), replicas.end(), [](const Replica& lhs, const Replica& rhs) {
+    return lhs.load.read_ops_per_sec + lhs.load.write_ops_per_sec >
+           rhs.load.read_ops_per_sec + rhs.load.write_ops_per_sec;
+  });
+  *output << "<h3>Hottest Tablets</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table Name</th><th>Tablet ID</th><th>Tablet Server</th>"
+             "<th>Reads per Second</th><th>Writes per Second</th></tr>\n";
+  for (size_t i = 0; i != std::min(limit, replicas.size()); ++i) {
+    const auto& replica = replicas[i];
+    *output << Substitute(
+        "  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+        table_name(replica.tablet_id), EscapeForHtmlToString(replica.tablet_id),
+        TSDescriptorToHtml(*replica.ts_desc, replica.tablet_id),
+        StringPrintf("%.1f", replica.load.read_ops_per_sec),
+        StringPrintf("%.1f", replica.load.write_ops_per_sec));
+  }
+  *output << "</table>\n";
+
+  std::vector<std::pair<const Replica*, const TSDescriptor::HotKey*>> hot_keys;
+  for (const auto& replica : replicas) {
+    for (const auto& hot_key : replica.load.hot_keys) {
+      hot_keys.emplace_back(&replica, &hot_key);
+    }
+  }
+  std::sort(hot_keys.begin(), hot_keys.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second->ops_per_sec > rhs.second->ops_per_sec;
+  });
+  *output << "<h3>Hottest Keys</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table Name</th><th>Tablet ID</th><th>Tablet Server</th><th>Key</th>"
+             "<th>Operations per Second</th></tr>\n";
+  for (size_t i = 0; i != std::min(limit, hot_keys.size()); ++i) {
+    const auto& replica = *hot_keys[i].first;
+    const auto& hot_key = *hot_keys[i].second;
+    *output << Substitute(
+        "  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+        table_name(replica.tablet_id), EscapeForHtmlToString(replica.tablet_id),
+        TSDescriptorToHtml(*replica.ts_desc, replica.tablet_id),
+        EscapeForHtmlToString(hot_key.key),
+        StringPrintf("%.1f &plusmn; %.1f", hot_key.ops_per_sec, hot_key.error_ops_per_sec));
+  }
+  *output << "</table>\n";
+}
+
+void MasterPathHandlers::HandleSnapshotsPage(const Webserver::WebRequest& req,
+                                             stringstream* output) {
+  ListSnapshotsRequestPB list_req;
+  ListSnapshotsResponsePB list_resp;
+  Status s = master_->catalog_manager()->ListSnapshots(&list_req, &list_resp);
+  if (s.ok() && list_resp.has_error()) {
+    s = StatusFromPB(list_resp.error().status());
+  }
+  if (!s.ok()) {
+    *output << "<div class=\"alert alert-warning\">" << EscapeForHtmlToString(s.ToString())
+            << "</div>";
+    return;
+  }
+
+  // Transaction aware snapshots have binary ids.
+  auto snapshot_id_to_string = [](const std::string& id) {
+    auto txn_snapshot_id = TryFullyDecodeTxnSnapshotId(id);
+    return txn_snapshot_id ? txn_snapshot_id.ToString() : id;
+  };
+
+  *output << "<h1>Snapshots</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Snapshot ID</th><th>State</th><th>Tablets</th></tr>\n";
+  for (const auto& snapshot : list_resp.snapshots()) {
+    std::map<SysSnapshotEntryPB::State, int> tablet_states;
+    for (const auto& tablet : snapshot.entry().tablet_snapshots()) {
+      ++tablet_states[tablet.state()];
+    }
+    *output << "  <tr><td>" << EscapeForHtmlToString(snapshot_id_to_string(snapshot.id()))
+            << "</td><td>" << SysSnapshotEntryPB::State_Name(snapshot.entry().state())
+            << "</td><td>";
+    for (const auto& state_and_count : tablet_states) {
+      *output << SysSnapshotEntryPB::State_Name(state_and_count.first) << ": "
+              << state_and_count.second << "<br>";
+    }
+    *output << "</td></tr>\n";
+  }
+  *output << "</table>\n";
+
+  // Tablets of the snapshots that are being created, restored or deleted, with their progress.
+  *output << "<h3>Tablets of Snapshots in Progress</h3>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Snapshot ID</th><th>Tablet ID</th><th>State</th></tr>\n";
+  for (const auto& snapshot : list_resp.snapshots()) {
+    const auto state = snapshot.entry().state();
+    if (state != SysSnapshotEntryPB::CREATING && state != SysSnapshotEntryPB::RESTORING &&
+        state != SysSnapshotEntryPB::DELETING) {
+      continue;
+    }
+    const auto snapshot_id = EscapeForHtmlToString(snapshot_id_to_string(snapshot.id()));
+    for (const auto& tablet : snapshot.entry().tablet_snapshots()) {
+      *output << "  <tr><td>" << snapshot_id << "</td><td>"
+              << EscapeForHtmlToString(tablet.id()) << "</td><td>"
+              << SysSnapshotEntryPB::State_Name(tablet.state()) << "</td></tr>\n";
+    }
+  }
+  *output << "</table>\n";
+}
+
 void MasterPathHandlers::RootHandler(const Webserver::WebRequest& req,
                                      stringstream* output) {
 
@@ -1458,6 +1609,16 @@ Status MasterPathHandlers::Register(Webserver* server) {
       "/tasks", "Tasks",
       std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
       false);
+  cb = std::bind(&MasterPathHandlers::HandleSnapshotsPage, this, _1, _2);
+  server->RegisterPathHandler(
+      "/snapshots", "Snapshots",
+      std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
+      false);
+  cb = std::bind(&MasterPathHandlers::HandleHotKeysPage, this, _1, _2);
+  server->RegisterPathHandler(
+      "/hot-keys", "Hot Keys",
+      std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
+      false);
 
   // JSON Endpoints
   cb = std::bind(&MasterPathHandlers::HandleGetTserverStatus, this, _1, _2);
@@ -161,6 +161,8 @@ class MasterPathHandlers {
                           std::stringstream* output);
   void HandleGetClusterConfig(const Webserver::WebRequest& req, std::stringstream* output);
   void HandleHealthCheck(const Webserver::WebRequest& req, std::stringstream* output);
+  void HandleSnapshotsPage(const Webserver::WebRequest& req, std::stringstream* output);
+  void HandleHotKeysPage(const Webserver::WebRequest& req, std::stringstream* output);
 
   // Calcuates number of leaders/followers per table.
   void CalculateTabletMap(TabletCountMap* tablet_map);
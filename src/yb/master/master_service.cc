@@ -207,6 +207,12 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
   uint64_t version = server_->catalog_manager()->GetYsqlCatalogVersion();
   resp->set_ysql_catalog_version(version);
 
+  server_->catalog_manager()->table_changes_log().FillHeartbeatResponse(*req, resp);
+
+  resp->set_ycql_partitions_version(
+      server_->catalog_manager()->tablets_version() +
+      server_->catalog_manager()->tablet_locations_version());
+
   rpc.RespondSuccess();
 }
 
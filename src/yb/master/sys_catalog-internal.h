@@ -36,6 +36,11 @@ class VisitorBase {
 
   virtual CHECKED_STATUS Visit(Slice id, Slice data) = 0;
 
+  // Called after all the entries were visited.
+  virtual CHECKED_STATUS Finish() {
+    return Status::OK();
+  }
+
  protected:
 };
 
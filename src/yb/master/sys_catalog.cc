@@ -709,6 +709,7 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(metadata_col_idx), &metadata));
     RETURN_NOT_OK(visitor->Visit(entry_id.binary_value(), metadata.binary_value()));
   }
+  RETURN_NOT_OK(visitor->Finish());
   auto duration = CoarseMonoClock::Now() - start;
   string id = Format("num_entries_with_type_$0_loaded", std::to_string(tables_entry));
   if (visitor_duration_metrics_.find(id) == visitor_duration_metrics_.end()) {
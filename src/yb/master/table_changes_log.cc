@@ -0,0 +1,85 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/table_changes_log.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+
+DEFINE_int32(master_table_changes_log_size, 1000,
+             "Number of recent table changes kept by the master leader to be sent to tablet "
+             "servers with heartbeat responses, so they invalidate cached table metadata. "
+             "0 to disable.");
+TAG_FLAG(master_table_changes_log_size, advanced);
+TAG_FLAG(master_table_changes_log_size, runtime);
+
+namespace yb {
+namespace master {
+
+TableChangesLog::TableChangesLog() : epoch_(RandomUniformInt<uint64_t>()) {}
+
+void TableChangesLog::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  epoch_ = RandomUniformInt<uint64_t>();
+  first_version_ = 0;
+  changes_.clear();
+}
+
+void TableChangesLog::TableCreated(const TableId& table_id) {
+  Add(table_id, true /* created */);
+}
+
+void TableChangesLog::TableChanged(const TableId& table_id) {
+  Add(table_id, false /* created */);
+}
+
+void TableChangesLog::Add(const TableId& table_id, bool created) {
+  const size_t max_size = std::max(FLAGS_master_table_changes_log_size, 0);
+  std::lock_guard<std::mutex> lock(mutex_);
+  changes_.emplace_back();
+  changes_.back().set_table_id(table_id);
+  if (created) {
+    changes_.back().set_created(true);
+  }
+  while (changes_.size() > max_size) {
+    changes_.pop_front();
+    ++first_version_;
+  }
+}
+
+void TableChangesLog::FillHeartbeatResponse(
+    const TSHeartbeatRequestPB& req, TSHeartbeatResponsePB* resp) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t last_version = first_version_ + changes_.size();
+  resp->set_table_changes_epoch(epoch_);
+  resp->set_table_changes_version(last_version);
+  if (!req.has_table_changes_epoch()) {
+    // The tablet server did not receive any changes yet, so there is nothing to invalidate.
+    return;
+  }
+  const auto version = req.table_changes_version();
+  if (req.table_changes_epoch() != epoch_ || version < first_version_ || version > last_version) {
+    resp->set_invalidate_all_tables(true);
+    return;
+  }
+  for (auto i = version - first_version_; i < changes_.size(); ++i) {
+    *resp->add_table_changes() = changes_[i];
+  }
+}
+
+} // namespace master
+} // namespace yb
@@ -0,0 +1,66 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_MASTER_TABLE_CHANGES_LOG_H
+#define YB_MASTER_TABLE_CHANGES_LOG_H
+
+#include <deque>
+#include <mutex>
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/master/master.pb.h"
+
+namespace yb {
+namespace master {
+
+// In-memory log of recent table creations, schema changes and deletions.
+//
+// Tablet servers receive the changes they have not seen yet with heartbeat responses, and
+// invalidate table metadata cached by their clients, instead of finding out that a cached schema
+// is stale from failed requests. Each change gets the next version. The log keeps only the last
+// master_table_changes_log_size changes; a tablet server that is further behind, or whose version
+// is from another epoch, is told to invalidate all tables.
+class TableChangesLog {
+ public:
+  TableChangesLog();
+
+  // Forgets all changes and starts a new epoch. Should be called when the master becomes the
+  // leader, since it does not know the changes done by the previous leader.
+  void Reset();
+
+  void TableCreated(const TableId& table_id);
+  void TableChanged(const TableId& table_id);
+
+  // Fills the changes after the version in the request.
+  void FillHeartbeatResponse(const TSHeartbeatRequestPB& req, TSHeartbeatResponsePB* resp) const;
+
+ private:
+  void Add(const TableId& table_id, bool created);
+
+  mutable std::mutex mutex_;
+  uint64_t epoch_ GUARDED_BY(mutex_);
+  // Version of the change preceding the first change in changes_.
+  uint64_t first_version_ GUARDED_BY(mutex_) = 0;
+  std::deque<TableChangePB> changes_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(TableChangesLog);
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_TABLE_CHANGES_LOG_H
@@ -0,0 +1,111 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/table_locations_cache.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/strings/escaping.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+
+DEFINE_int32(master_table_locations_cache_size, 1000,
+             "Maximum number of GetTableLocations responses cached by the master leader. "
+             "0 to disable.");
+TAG_FLAG(master_table_locations_cache_size, advanced);
+TAG_FLAG(master_table_locations_cache_size, runtime);
+
+namespace yb {
+namespace master {
+
+namespace {
+
+std::string CacheKey(const TableId& table_id, const GetTableLocationsRequestPB& req) {
+  return Format("$0/$1/$2/$3/$4/$5/$6",
+                table_id, req.has_partition_key_start(), b2a_hex(req.partition_key_start()),
+                req.has_partition_key_end(), b2a_hex(req.partition_key_end()),
+                req.max_returned_locations(), req.require_tablets_running());
+}
+
+} // namespace
+
+bool TableLocationsCache::Find(
+    const TableId& table_id, const GetTableLocationsRequestPB& req, uint64_t version,
+    GetTableLocationsResponsePB* resp) {
+  if (FLAGS_master_table_locations_cache_size <= 0) {
+    return false;
+  }
+  const auto key = CacheKey(table_id, req);
+  std::shared_ptr<const GetTableLocationsResponsePB> entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!CheckVersion(version)) {
+      return false;
+    }
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    entry = it->second;
+  }
+  resp->CopyFrom(*entry);
+  return true;
+}
+
+void TableLocationsCache::Insert(
+    const TableId& table_id, const GetTableLocationsRequestPB& req, uint64_t version,
+    const GetTableLocationsResponsePB& resp) {
+  const size_t max_size = std::max(FLAGS_master_table_locations_cache_size, 0);
+  if (max_size == 0) {
+    return;
+  }
+  auto key = CacheKey(table_id, req);
+  auto entry = std::make_shared<const GetTableLocationsResponsePB>(resp);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!CheckVersion(version)) {
+    return;
+  }
+  if (entries_.size() >= max_size) {
+    entries_.clear();
+  }
+  entries_[std::move(key)] = std::move(entry);
+}
+
+void TableLocationsCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+size_t TableLocationsCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+bool TableLocationsCache::CheckVersion(uint64_t version) {
+  if (version == version_) {
+    return true;
+  }
+  if (version < version_) {
+    // Built before the last change, while another request already saw it.
+    return false;
+  }
+  entries_.clear();
+  version_ = version;
+  return true;
+}
+
+} // namespace master
+} // namespace yb
@@ -0,0 +1,69 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_MASTER_TABLE_LOCATIONS_CACHE_H
+#define YB_MASTER_TABLE_LOCATIONS_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/master/master.pb.h"
+
+namespace yb {
+namespace master {
+
+// Cache of the responses to GetTableLocations, so that the lookups clients repeat after restarts
+// and splits are answered without building the locations of every tablet again.
+//
+// Responses are cached for the version of the tablets and their locations they were built at,
+// and the whole cache is dropped once the version changes.
+class TableLocationsCache {
+ public:
+  TableLocationsCache() = default;
+
+  // Returns whether the response to the request for the table was found at the version, and
+  // copies it to resp.
+  bool Find(const TableId& table_id, const GetTableLocationsRequestPB& req, uint64_t version,
+            GetTableLocationsResponsePB* resp);
+
+  void Insert(const TableId& table_id, const GetTableLocationsRequestPB& req, uint64_t version,
+              const GetTableLocationsResponsePB& resp);
+
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  // Drops the entries if they are not for the version. Returns whether the version is older than
+  // the one of the entries.
+  bool CheckVersion(uint64_t version) REQUIRES(mutex_);
+
+  mutable std::mutex mutex_;
+  uint64_t version_ GUARDED_BY(mutex_) = 0;
+  std::unordered_map<std::string, std::shared_ptr<const GetTableLocationsResponsePB>> entries_
+      GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(TableLocationsCache);
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_TABLE_LOCATIONS_CACHE_H
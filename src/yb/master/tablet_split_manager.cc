@@ -0,0 +1,234 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/tablet_split_manager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/common/partition.h"
+
+#include "yb/master/catalog_entity_info.h"
+#include "yb/master/catalog_manager.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int64(tablet_split_size_threshold_bytes, 0,
+             "Split the tablets whose SST files are larger than this. 0 to not split tablets by "
+             "size.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+TAG_FLAG(tablet_split_size_threshold_bytes, runtime);
+
+DEFINE_double(tablet_split_ops_per_sec_threshold, 0,
+              "Split the tablets whose leaders serve more read and write operations per second "
+              "than this. 0 to not split tablets by load.");
+TAG_FLAG(tablet_split_ops_per_sec_threshold, advanced);
+TAG_FLAG(tablet_split_ops_per_sec_threshold, runtime);
+
+DEFINE_double(tablet_split_hot_key_load_fraction, 0.5,
+              "Do not split a tablet because of its load, when a single row takes more than this "
+              "fraction of the operations of the tablet, since a split would not spread the load "
+              "of the row. 0 to split such tablets too.");
+TAG_FLAG(tablet_split_hot_key_load_fraction, advanced);
+TAG_FLAG(tablet_split_hot_key_load_fraction, runtime);
+
+DEFINE_int32(tablet_split_max_outstanding, 1,
+             "Maximum number of tablet splits in progress across the cluster.");
+TAG_FLAG(tablet_split_max_outstanding, advanced);
+TAG_FLAG(tablet_split_max_outstanding, runtime);
+
+DEFINE_int32(tablet_split_max_tablets_per_table, 256,
+             "Tablets of tables with this many tablets are not split.");
+TAG_FLAG(tablet_split_max_tablets_per_table, advanced);
+TAG_FLAG(tablet_split_max_tablets_per_table, runtime);
+
+DEFINE_int32(tablet_split_check_interval_ms, 10000,
+             "How often the master leader checks for tablets to split.");
+TAG_FLAG(tablet_split_check_interval_ms, advanced);
+TAG_FLAG(tablet_split_check_interval_ms, runtime);
+
+using namespace std::literals;
+
+namespace yb {
+namespace master {
+
+namespace {
+
+bool Enabled() {
+  return FLAGS_tablet_split_size_threshold_bytes > 0 ||
+         FLAGS_tablet_split_ops_per_sec_threshold > 0;
+}
+
+// Redis tables are hash partitioned too, but their tablets are not split for now.
+bool IsHashPartitioned(const SysTablesEntryPB& pb) {
+  if (!pb.partition_schema().has_hash_schema()) {
+    return false;
+  }
+  switch (pb.partition_schema().hash_schema()) {
+    case PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA: FALLTHROUGH_INTENDED;
+    case PartitionSchemaPB::PGSQL_HASH_SCHEMA:
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
+TabletSplitManager::TabletSplitManager(CatalogManager* catalog_manager)
+    : catalog_manager_(catalog_manager) {
+}
+
+boost::optional<uint16_t> TabletSplitManager::SplitHashCode(const PartitionPB& partition) {
+  const uint32_t start = partition.partition_key_start().empty()
+      ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+  const uint32_t end = partition.partition_key_end().empty()
+      ? PartitionSchema::kMaxPartitionKey + 1
+      : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end());
+  if (end < start + 2) {
+    return boost::none;
+  }
+  return static_cast<uint16_t>((start + end) / 2);
+}
+
+double TabletSplitManager::Overload(
+    const TabletId& tablet_id, const TSDescriptor::TabletLoad& load) {
+  double result = 0;
+  if (FLAGS_tablet_split_ops_per_sec_threshold > 0) {
+    const double ops_per_sec = load.read_ops_per_sec + load.write_ops_per_sec;
+    // The lower bound of the rate of the hottest row.
+    const double hottest_key_ops_per_sec = load.hot_keys.empty()
+        ? 0 : load.hot_keys[0].ops_per_sec - load.hot_keys[0].error_ops_per_sec;
+    if (FLAGS_tablet_split_hot_key_load_fraction <= 0 ||
+        hottest_key_ops_per_sec <= ops_per_sec * FLAGS_tablet_split_hot_key_load_fraction) {
+      result = ops_per_sec / FLAGS_tablet_split_ops_per_sec_threshold;
+    } else {
+      VLOG(1) << "Not splitting " << tablet_id << " by load, its hottest row "
+              << load.hot_keys[0].key << " takes " << hottest_key_ops_per_sec << " of "
+              << ops_per_sec << " operations per second";
+    }
+  }
+  if (FLAGS_tablet_split_size_threshold_bytes > 0) {
+    auto it = inherited_sst_file_sizes_.find(tablet_id);
+    if (it != inherited_sst_file_sizes_.end() && load.sst_file_size < it->second) {
+      inherited_sst_file_sizes_.erase(it);
+      it = inherited_sst_file_sizes_.end();
+    }
+    if (it == inherited_sst_file_sizes_.end()) {
+      result = std::max(
+          result, static_cast<double>(load.sst_file_size) /
+                  FLAGS_tablet_split_size_threshold_bytes);
+    }
+  }
+  return result;
+}
+
+void TabletSplitManager::MaybeSplitTablets() {
+  if (!Enabled()) {
+    return;
+  }
+  const auto now = CoarseMonoClock::Now();
+  if (now < next_check_time_) {
+    return;
+  }
+  next_check_time_ = now + std::max(FLAGS_tablet_split_check_interval_ms, 0) * 1ms;
+
+  struct Candidate {
+    scoped_refptr<TabletInfo> tablet;
+    uint16_t split_hash_code;
+    double overload;
+    uint64_t sst_file_size;
+  };
+  std::vector<Candidate> candidates;
+  int outstanding = 0;
+
+  std::vector<scoped_refptr<TableInfo>> tables;
+  catalog_manager_->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+  for (const auto& table : tables) {
+    if (table->colocated() || !catalog_manager_->IsUserCreatedTable(*table) ||
+        !IsHashPartitioned(table->LockForRead()->data().pb)) {
+      continue;
+    }
+    TabletInfos tablets;
+    table->GetAllTablets(&tablets);
+    std::vector<Candidate> table_candidates;
+    bool splitting = false;
+    for (const auto& tablet : tablets) {
+      PartitionPB partition;
+      {
+        auto tablet_lock = tablet->LockForRead();
+        if (tablet_lock->data().pb.split_tablet_ids_size() > 0) {
+          splitting = true;
+          continue;
+        }
+        if (!tablet_lock->data().is_running()) {
+          continue;
+        }
+        partition = tablet_lock->data().pb.partition();
+      }
+      auto leader = tablet->GetLeader();
+      TSDescriptor::TabletLoad load;
+      if (!leader.ok() || !(*leader)->GetTabletLoad(tablet->tablet_id(), &load)) {
+        continue;
+      }
+      const auto overload = Overload(tablet->tablet_id(), load);
+      if (overload <= 1) {
+        continue;
+      }
+      const auto split_hash_code = SplitHashCode(partition);
+      if (split_hash_code) {
+        table_candidates.push_back({tablet, *split_hash_code, overload, load.sst_file_size});
+      }
+    }
+    if (splitting) {
+      // Tablets of a table are split one at a time.
+      ++outstanding;
+      continue;
+    }
+    if (table_candidates.empty() ||
+        tablets.size() >= static_cast<size_t>(FLAGS_tablet_split_max_tablets_per_table)) {
+      continue;
+    }
+    candidates.push_back(*std::max_element(
+        table_candidates.begin(), table_candidates.end(),
+        [](const Candidate& lhs, const Candidate& rhs) { return lhs.overload < rhs.overload; }));
+  }
+
+  // The most overloaded tablets are split first.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& lhs, const Candidate& rhs) { return lhs.overload > rhs.overload; });
+  for (const auto& candidate : candidates) {
+    if (outstanding >= FLAGS_tablet_split_max_outstanding) {
+      VLOG(1) << "Not splitting " << candidates.size() << " tablets, " << outstanding
+              << " splits are in progress";
+      break;
+    }
+    auto new_tablet_ids = catalog_manager_->SplitTablet(
+        candidate.tablet, candidate.split_hash_code);
+    if (!new_tablet_ids.ok()) {
+      LOG(WARNING) << "Failed to split tablet " << candidate.tablet->tablet_id() << ": "
+                   << new_tablet_ids.status();
+      continue;
+    }
+    for (const auto& new_tablet_id : *new_tablet_ids) {
+      inherited_sst_file_sizes_[new_tablet_id] = candidate.sst_file_size;
+    }
+    ++outstanding;
+  }
+}
+
+} // namespace master
+} // namespace yb
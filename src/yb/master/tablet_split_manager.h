@@ -0,0 +1,70 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_MASTER_TABLET_SPLIT_MANAGER_H
+#define YB_MASTER_TABLET_SPLIT_MANAGER_H
+
+#include <unordered_map>
+
+#include <boost/optional/optional.hpp>
+
+#include "yb/common/common.pb.h"
+#include "yb/common/entity_ids.h"
+
+#include "yb/master/ts_descriptor.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace master {
+
+class CatalogManager;
+
+// Decides which tablets to split, from the SST files sizes and the operations per second that the
+// leaders of the tablets report with their heartbeats.
+//
+// Only the tablets of hash partitioned user tables are split, in the middle of their hash range,
+// that hashing spreads the keys uniformly over. The number of splits in progress across the
+// cluster is limited by tablet_split_max_outstanding.
+class TabletSplitManager {
+ public:
+  explicit TabletSplitManager(CatalogManager* catalog_manager);
+
+  // Starts the splits of the tablets that are over the thresholds. Called by the catalog manager
+  // background tasks, does nothing until tablet_split_check_interval_ms passed since the last
+  // check.
+  void MaybeSplitTablets();
+
+  // Returns the hash code to split the partition at, or none if it has a single hash code.
+  static boost::optional<uint16_t> SplitHashCode(const PartitionPB& partition);
+
+ private:
+  // Returns by how much the load of the tablet is over the thresholds, <= 1 when it is not.
+  double Overload(const TabletId& tablet_id, const TSDescriptor::TabletLoad& load);
+
+  CatalogManager* const catalog_manager_;
+
+  CoarseTimePoint next_check_time_;
+
+  // SST files size of the tablets that the tablets of the splits started here were split from.
+  // The new tablets share the files of the split tablet until they are compacted, so they are not
+  // split by size until their files are smaller than that.
+  std::unordered_map<TabletId, uint64_t> inherited_sst_file_sizes_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabletSplitManager);
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_TABLET_SPLIT_MANAGER_H
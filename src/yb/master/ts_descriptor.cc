@@ -106,6 +106,7 @@ Status TSDescriptor::RegisterUnlocked(
   latest_seqno = instance.instance_seqno();
   // After re-registering, make the TS re-report its tablets.
   has_tablet_report_ = false;
+  tablet_report_fingerprints_.clear();
 
   ts_information_ = std::make_shared<TSInformationPB>();
   ts_information_->mutable_registration()->CopyFrom(registration);
@@ -167,6 +168,31 @@ void TSDescriptor::set_has_tablet_report(bool has_report) {
   has_tablet_report_ = has_report;
 }
 
+bool TSDescriptor::IsTabletReportUnchanged(
+    const TabletId& tablet_id, int64_t term, uint64_t fingerprint) const {
+  SharedLock<decltype(lock_)> l(lock_);
+  if (term != tablet_report_fingerprints_term_) {
+    return false;
+  }
+  auto it = tablet_report_fingerprints_.find(tablet_id);
+  return it != tablet_report_fingerprints_.end() && it->second == fingerprint;
+}
+
+void TSDescriptor::SetTabletReportFingerprint(
+    const TabletId& tablet_id, int64_t term, uint64_t fingerprint) {
+  std::lock_guard<decltype(lock_)> l(lock_);
+  if (term != tablet_report_fingerprints_term_) {
+    tablet_report_fingerprints_.clear();
+    tablet_report_fingerprints_term_ = term;
+  }
+  tablet_report_fingerprints_[tablet_id] = fingerprint;
+}
+
+void TSDescriptor::ClearTabletReportFingerprints() {
+  std::lock_guard<decltype(lock_)> l(lock_);
+  tablet_report_fingerprints_.clear();
+}
+
 void TSDescriptor::DecayRecentReplicaCreationsUnlocked() {
   // In most cases, we won't have any recent replica creations, so
   // we don't need to bother calling the clock, etc.
@@ -257,6 +283,18 @@ void TSDescriptor::UpdateMetrics(const TServerMetricsPB& metrics) {
   ts_metrics_.read_ops_per_sec = metrics.read_ops_per_sec();
   ts_metrics_.write_ops_per_sec = metrics.write_ops_per_sec();
   ts_metrics_.uptime_seconds = metrics.uptime_seconds();
+  ts_metrics_.cpu_usage = metrics.cpu_usage();
+  ts_metrics_.tablet_loads.clear();
+  for (const auto& tablet_load : metrics.tablet_loads()) {
+    auto& load = ts_metrics_.tablet_loads[tablet_load.tablet_id()];
+    load.read_ops_per_sec = tablet_load.read_ops_per_sec();
+    load.write_ops_per_sec = tablet_load.write_ops_per_sec();
+    load.sst_file_size = tablet_load.sst_file_size();
+    for (const auto& hot_key : tablet_load.hot_keys()) {
+      load.hot_keys.push_back(
+          HotKey{hot_key.key(), hot_key.ops_per_sec(), hot_key.error_ops_per_sec()});
+    }
+  }
 }
 
 void TSDescriptor::GetMetrics(TServerMetricsPB* metrics) {
@@ -269,6 +307,22 @@ void TSDescriptor::GetMetrics(TServerMetricsPB* metrics) {
   metrics->set_read_ops_per_sec(ts_metrics_.read_ops_per_sec);
   metrics->set_write_ops_per_sec(ts_metrics_.write_ops_per_sec);
   metrics->set_uptime_seconds(ts_metrics_.uptime_seconds);
+  metrics->set_cpu_usage(ts_metrics_.cpu_usage);
+}
+
+bool TSDescriptor::GetTabletLoad(const TabletId& tablet_id, TabletLoad* load) const {
+  SharedLock<decltype(lock_)> l(lock_);
+  auto it = ts_metrics_.tablet_loads.find(tablet_id);
+  if (it == ts_metrics_.tablet_loads.end()) {
+    return false;
+  }
+  *load = it->second;
+  return true;
+}
+
+std::unordered_map<TabletId, TSDescriptor::TabletLoad> TSDescriptor::GetTabletLoads() const {
+  SharedLock<decltype(lock_)> l(lock_);
+  return ts_metrics_.tablet_loads;
 }
 
 bool TSDescriptor::HasTabletDeletePending() const {
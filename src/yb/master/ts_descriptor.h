@@ -37,6 +37,10 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/entity_ids.h"
 
 #include "yb/gutil/gscoped_ptr.h"
 
@@ -111,6 +115,16 @@ class TSDescriptor {
   bool has_tablet_report() const;
   void set_has_tablet_report(bool has_report);
 
+  // Returns whether the tablet was last reported by this TS with the same fingerprint, and the
+  // report was processed in the same leader term, so processing it again would change nothing.
+  bool IsTabletReportUnchanged(const TabletId& tablet_id, int64_t term, uint64_t fingerprint) const;
+
+  // Remembers the fingerprint of the processed report of the tablet.
+  void SetTabletReportFingerprint(const TabletId& tablet_id, int64_t term, uint64_t fingerprint);
+
+  // Forgets the fingerprints of the processed reports, so all tablets are processed again.
+  void ClearTabletReportFingerprints();
+
   // Returns TSRegistrationPB for this TSDescriptor.
   TSRegistrationPB GetRegistration() const;
 
@@ -238,6 +252,33 @@ class TSDescriptor {
     return ts_metrics_.uptime_seconds;
   }
 
+  double cpu_usage() {
+    SharedLock<decltype(lock_)> l(lock_);
+    return ts_metrics_.cpu_usage;
+  }
+
+  // Load of a tablet replica on this TS, as reported in the last heartbeat with metrics.
+  struct HotKey {
+    std::string key;
+    double ops_per_sec = 0;
+    double error_ops_per_sec = 0;
+  };
+
+  struct TabletLoad {
+    double read_ops_per_sec = 0;
+    double write_ops_per_sec = 0;
+    uint64_t sst_file_size = 0;
+    // The hottest rows of the replica, the hottest first.
+    std::vector<HotKey> hot_keys;
+  };
+
+  // Fills the load of the replica of the tablet. Returns false if the TS did not report it, i.e.
+  // the replica neither served operations nor had data.
+  bool GetTabletLoad(const TabletId& tablet_id, TabletLoad* load) const;
+
+  // Returns the loads of all the replicas the TS reported.
+  std::unordered_map<TabletId, TabletLoad> GetTabletLoads() const;
+
   void UpdateMetrics(const TServerMetricsPB& metrics);
 
   void GetMetrics(TServerMetricsPB* metrics);
@@ -306,6 +347,10 @@ class TSDescriptor {
 
     uint64_t uptime_seconds = 0;
 
+    double cpu_usage = 0;
+
+    std::unordered_map<TabletId, TabletLoad> tablet_loads;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
@@ -314,6 +359,8 @@ class TSDescriptor {
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
       uptime_seconds = 0;
+      cpu_usage = 0;
+      tablet_loads.clear();
     }
   };
 
@@ -330,6 +377,11 @@ class TSDescriptor {
   // Set to true once this instance has reported all of its tablets.
   bool has_tablet_report_;
 
+  // Fingerprints of the last processed reports of the tablets, and the leader term they were
+  // processed in.
+  std::unordered_map<TabletId, uint64_t> tablet_report_fingerprints_;
+  int64_t tablet_report_fingerprints_term_ = -1;
+
   // The number of times this tablet server has recently been selected to create a
   // tablet replica. This value decays back to 0 over time.
   double recent_replica_creations_;
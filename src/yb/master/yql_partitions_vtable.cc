@@ -62,24 +62,43 @@ Result<std::shared_ptr<QLRowBlock>> YQLPartitionsVTable::RetrieveData(
   }
 
   auto vtable = std::make_shared<QLRowBlock>(schema_);
+  std::unordered_map<TabletId, TabletRow> new_tablet_rows;
   std::vector<scoped_refptr<TableInfo> > tables;
   catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
   for (const scoped_refptr<TableInfo>& table : tables) {
+    // Skip non-YQL tables.
+    if (!CatalogManager::IsYcqlTable(*table)) {
+      continue;
+    }
+
     // Get namespace for table.
     NamespaceIdentifierPB nsId;
     nsId.set_id(table->namespace_id());
     scoped_refptr<NamespaceInfo> nsInfo;
     RETURN_NOT_OK(catalog_manager->FindNamespace(nsId, &nsInfo));
-
-    // Skip non-YQL tables.
-    if (!CatalogManager::IsYcqlTable(*table)) {
-      continue;
-    }
+    const auto namespace_name = nsInfo->name();
+    const auto table_name = table->name();
 
     // Get tablets for table.
     std::vector<scoped_refptr<TabletInfo> > tablets;
     table->GetAllTablets(&tablets);
     for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+      // The version is taken before the locations, so that a row built from older locations is
+      // rebuilt the next time.
+      const auto replica_locations_version = tablet->replica_locations_version();
+      const auto state = tablet->LockForRead()->data().pb.state();
+      if (FLAGS_use_cache_for_partitions_vtable) {
+        auto it = tablet_rows_.find(tablet->id());
+        if (it != tablet_rows_.end() &&
+            it->second.replica_locations_version == replica_locations_version &&
+            it->second.state == state && it->second.namespace_name == namespace_name &&
+            it->second.table_name == table_name) {
+          vtable->Extend() = it->second.row;
+          new_tablet_rows.emplace(tablet->id(), std::move(it->second));
+          continue;
+        }
+      }
+
       TabletLocationsPB tabletLocationsPB;
       Status s = catalog_manager->GetTabletLocations(tablet->id(), &tabletLocationsPB);
       // Skip not-found tablets: they might not be running yet or have been deleted.
@@ -88,36 +107,17 @@ Result<std::shared_ptr<QLRowBlock>> YQLPartitionsVTable::RetrieveData(
       }
 
       QLRow& row = vtable->Extend();
-      RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
-      RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
-
-      const PartitionPB& partition = tabletLocationsPB.partition();
-      RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), &row));
-      RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), &row));
-
-      // Note: tablet id is in host byte order.
-      Uuid uuid;
-      RETURN_NOT_OK(uuid.FromHexString(tablet->id()));
-      RETURN_NOT_OK(SetColumnValue(kId, uuid, &row));
-
-      // Get replicas for tablet.
-      QLValuePB replica_addresses;
-      QLMapValuePB *map_value = replica_addresses.mutable_map_value();
-      for (const auto& replica : tabletLocationsPB.replicas()) {
-        InetAddress addr;
-        RETURN_NOT_OK(addr.FromString(DesiredHostPort(replica.ts_info(), CloudInfoPB()).host()));
-        QLValue elem_key;
-        elem_key.set_inetaddress_value(addr);
-        *map_value->add_keys() = elem_key.value();
-
-        const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
-        QLValue elem_value;
-        elem_value.set_string_value(role);
-        *map_value->add_values() = elem_value.value();
+      RETURN_NOT_OK(BuildTabletRow(namespace_name, table_name, tabletLocationsPB, &row));
+      // Rows of the tablets without known replicas are built from the committed consensus state,
+      // that could change without the locations version, so they are not reused.
+      if (FLAGS_use_cache_for_partitions_vtable && !tabletLocationsPB.stale()) {
+        new_tablet_rows.emplace(
+            tablet->id(),
+            TabletRow{replica_locations_version, state, namespace_name, table_name, row});
       }
-      RETURN_NOT_OK(SetColumnValue(kReplicaAddresses, replica_addresses, &row));
     }
   }
+  tablet_rows_ = std::move(new_tablet_rows);
 
   if (new_tablets_version == catalog_manager->tablets_version() &&
       new_tablet_locations_version == catalog_manager->tablet_locations_version()) {
@@ -131,6 +131,40 @@ Result<std::shared_ptr<QLRowBlock>> YQLPartitionsVTable::RetrieveData(
   return vtable;
 }
 
+Status YQLPartitionsVTable::BuildTabletRow(const NamespaceName& namespace_name,
+                                           const TableName& table_name,
+                                           const TabletLocationsPB& locations,
+                                           QLRow* row) const {
+  RETURN_NOT_OK(SetColumnValue(kKeyspaceName, namespace_name, row));
+  RETURN_NOT_OK(SetColumnValue(kTableName, table_name, row));
+
+  const PartitionPB& partition = locations.partition();
+  RETURN_NOT_OK(SetColumnValue(kStartKey, partition.partition_key_start(), row));
+  RETURN_NOT_OK(SetColumnValue(kEndKey, partition.partition_key_end(), row));
+
+  // Note: tablet id is in host byte order.
+  Uuid uuid;
+  RETURN_NOT_OK(uuid.FromHexString(locations.tablet_id()));
+  RETURN_NOT_OK(SetColumnValue(kId, uuid, row));
+
+  // Get replicas for tablet.
+  QLValuePB replica_addresses;
+  QLMapValuePB *map_value = replica_addresses.mutable_map_value();
+  for (const auto& replica : locations.replicas()) {
+    InetAddress addr;
+    RETURN_NOT_OK(addr.FromString(DesiredHostPort(replica.ts_info(), CloudInfoPB()).host()));
+    QLValue elem_key;
+    elem_key.set_inetaddress_value(addr);
+    *map_value->add_keys() = elem_key.value();
+
+    const string& role = consensus::RaftPeerPB::Role_Name(replica.role());
+    QLValue elem_value;
+    elem_value.set_string_value(role);
+    *map_value->add_values() = elem_value.value();
+  }
+  return SetColumnValue(kReplicaAddresses, replica_addresses, row);
+}
+
 Schema YQLPartitionsVTable::CreateSchema() const {
   SchemaBuilder builder;
   CHECK_OK(builder.AddHashKeyColumn(kKeyspaceName, QLType::Create(DataType::STRING)));
@@ -14,6 +14,8 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <unordered_map>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
@@ -28,10 +30,26 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
 
+  // Row of a tablet, with what it was built from, so that only the rows of the tablets that
+  // changed are rebuilt when the cache is outdated.
+  struct TabletRow {
+    uint64_t replica_locations_version;
+    SysTabletsEntryPB::State state;
+    std::string namespace_name;
+    std::string table_name;
+    QLRow row;
+  };
+
+  CHECKED_STATUS BuildTabletRow(const NamespaceName& namespace_name,
+                                const TableName& table_name,
+                                const TabletLocationsPB& locations,
+                                QLRow* row) const;
+
   mutable boost::shared_mutex mutex_;
   mutable std::shared_ptr<QLRowBlock> cache_;
   mutable int cached_tablets_version_ = -1;
   mutable int cached_tablet_locations_version_ = -1;
+  mutable std::unordered_map<TabletId, TabletRow> tablet_rows_;
 };
 
 }  // namespace master
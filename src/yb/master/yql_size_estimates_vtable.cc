@@ -52,18 +52,21 @@ Result<std::shared_ptr<QLRowBlock>> YQLSizeEstimatesVTable::RetrieveData(
     std::vector<scoped_refptr<TabletInfo> > tablets;
     table->GetAllTablets(&tablets);
     for (const scoped_refptr<TabletInfo>& tablet : tablets) {
-      TabletLocationsPB tabletLocationsPB;
-      Status s = catalog_manager->GetTabletLocations(tablet->id(), &tabletLocationsPB);
-      // Skip not-found tablets: they might not be running yet or have been deleted.
-      if (!s.ok()) {
-        continue;
+      // Only the partition of the tablet is needed, so its locations are not built.
+      PartitionPB partition;
+      {
+        auto l = tablet->LockForRead();
+        // Skip tablets that are not running yet or have been deleted.
+        if (!l->data().is_running()) {
+          continue;
+        }
+        partition = l->data().pb.partition();
       }
 
       QLRow &row = vtable->Extend();
       RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
       RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
 
-      const PartitionPB &partition = tabletLocationsPB.partition();
       uint16_t yb_start_hash = !partition.partition_key_start().empty() ?
           PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start()) : 0;
       string cql_start_hash = std::to_string(YBPartition::YBToCqlHashCode(yb_start_hash));
@@ -108,6 +108,16 @@ class YQLVirtualTable : public common::YQLStorageIf {
     return Status::OK();
   }
 
+  CHECKED_STATUS GetTupleIterator(const Schema& projection,
+                                  const Schema& schema,
+                                  const TransactionOperationContextOpt& txn_op_context,
+                                  CoarseTimePoint deadline,
+                                  const ReadHybridTime& read_time,
+                                  common::YQLRowwiseIteratorIf::UniPtr* iter) const override {
+    LOG(FATAL) << "Postgresql virtual tables are not yet implemented";
+    return Status::OK();
+  }
+
  protected:
   // Finds the given column name in the schema and updates the specified column in the given row
   // with the provided value.
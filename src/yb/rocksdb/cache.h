@@ -66,6 +66,14 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Create a new cache with CLOCK eviction and frequency based admission, sharded the same way as
+// the LRU cache. Lookups hold the shard lock in shared mode only, so concurrent lookups don't
+// contend. When the cache is full, a new entry is only admitted if its key was requested more
+// often than the key of the entry it would evict, which protects the cache from large scans.
+extern shared_ptr<Cache> NewClockCache(size_t capacity);
+extern shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                       bool strict_capacity_limit = false);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
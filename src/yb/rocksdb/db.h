@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
@@ -105,6 +106,19 @@ struct Range {
 
 YB_DEFINE_ENUM(FlushAbility, (kNoNewData)(kHasNewData)(kAlreadyFlushing))
 
+// Checks the smallest and the largest user keys of a file imported from another database.
+typedef std::function<Status(const Slice& smallest, const Slice& largest)> ImportKeyRangeValidator;
+
+// Options that control import of files from another database.
+struct ImportOptions {
+  // Invoked for every imported file. Nothing is imported if it returns an error for any of them.
+  ImportKeyRangeValidator key_range_validator;
+
+  // If set, updates the flushed frontier in the same version edit that adds imported files, so
+  // the import and its frontier are applied atomically.
+  UserFrontierPtr flushed_frontier;
+};
+
 // A collections of table properties objects, where
 //  key: is the table's file name.
 //  value: the table properties object of the given table.
@@ -806,6 +820,10 @@ class DB {
   // Returns number of memtables not flushed in default column family memtable list.
   virtual int GetCfdImmNumNotFlushed() { return 0; }
 
+  // Returns how close writes to default column family are to being stopped, from 0 (no write
+  // stall is expected) to 1 (writes are stopped).
+  virtual double GetWriteStallPressure() { return 0; }
+
   // Returns a list of all table files for the current version with their level, start key and end
   // key.
   virtual void GetLiveFilesMetaData(std::vector<LiveFileMetaData>* /*metadata*/) {}
@@ -896,7 +914,11 @@ class DB {
   // Needed for StackableDB
   virtual DB* GetRootDB() { return this; }
 
-  virtual CHECKED_STATUS Import(const std::string& source_dir) {
+  CHECKED_STATUS Import(const std::string& source_dir) {
+    return Import(source_dir, ImportOptions());
+  }
+
+  virtual CHECKED_STATUS Import(const std::string& source_dir, const ImportOptions& options) {
     return STATUS(NotSupported, "");
   }
 
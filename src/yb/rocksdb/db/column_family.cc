@@ -52,6 +52,12 @@
 
 DEFINE_int32(memstore_arena_size_kb, 128, "Size of each arena allocation for the memstore");
 
+DEFINE_int32(rocksdb_write_stall_prediction_horizon_ms, 10000,
+             "Number of level 0 files and pending compaction bytes are predicted this far ahead "
+             "from recent flush and compaction rates. Writes are delayed gradually when the "
+             "prediction exceeds slowdown limits, before the limits are actually reached. 0 "
+             "disables the prediction.");
+
 namespace rocksdb {
 
 ColumnFamilyHandleImpl::ColumnFamilyHandleImpl(
@@ -510,7 +516,9 @@ std::unique_ptr<WriteControllerToken> SetupDelay(
     bool auto_comapctions_disabled) {
   const uint64_t kMinWriteRate = 1024u;  // Minimum write rate 1KB/s.
 
-  uint64_t write_rate = write_controller->delayed_write_rate();
+  // Predicted write stalls could set rate above max_write_rate, which should not be used once the
+  // slowdown limits are actually reached.
+  uint64_t write_rate = std::min(write_controller->delayed_write_rate(), max_write_rate);
 
   if (auto_comapctions_disabled) {
     // When auto compaction is disabled, always use the value user gave.
@@ -569,6 +577,37 @@ int GetL0ThresholdSpeedupCompaction(int level0_file_num_compaction_trigger,
                               level0_file_num_compaction_trigger64) / 4);
   return static_cast<int>(std::min<int64_t>(result, std::numeric_limits<int>::max()));
 }
+// Returns position of value between slowdown and stop limits: 0 below the slowdown limit, 1 at the
+// stop limit or above.
+double WriteStallPressure(double value, double slowdown_limit, double stop_limit) {
+  if (value < slowdown_limit) {
+    return 0;
+  }
+  if (value >= stop_limit) {
+    return 1;
+  }
+  return (value - slowdown_limit) / (stop_limit - slowdown_limit);
+}
+
+double WriteStallPressure(
+    double num_l0_files, double pending_compaction_bytes,
+    const MutableCFOptions& mutable_cf_options) {
+  double result = 0;
+  if (mutable_cf_options.level0_slowdown_writes_trigger >= 0) {
+    result = WriteStallPressure(
+        num_l0_files, mutable_cf_options.level0_slowdown_writes_trigger,
+        mutable_cf_options.level0_stop_writes_trigger);
+  }
+  if (mutable_cf_options.soft_pending_compaction_bytes_limit > 0 &&
+      mutable_cf_options.hard_pending_compaction_bytes_limit >
+          mutable_cf_options.soft_pending_compaction_bytes_limit) {
+    result = std::max(result, WriteStallPressure(
+        pending_compaction_bytes, mutable_cf_options.soft_pending_compaction_bytes_limit,
+        mutable_cf_options.hard_pending_compaction_bytes_limit));
+  }
+  return result;
+}
+
 }  // namespace
 
 void ColumnFamilyData::RecalculateWriteStallConditions(
@@ -580,7 +619,24 @@ void ColumnFamilyData::RecalculateWriteStallConditions(
     uint64_t compaction_needed_bytes =
         vstorage->estimated_compaction_needed_bytes();
 
+    const int num_l0_files = vstorage->l0_delay_trigger_count();
+    write_stall_predictor_.Update(
+        ioptions_.env->NowMicros(), num_l0_files, compaction_needed_bytes);
+    double predicted_pressure = 0;
+    const auto horizon_ms = FLAGS_rocksdb_write_stall_prediction_horizon_ms;
+    if (horizon_ms > 0 && !mutable_cf_options.disable_auto_compactions) {
+      const uint64_t horizon_micros = horizon_ms * 1000ULL;
+      predicted_pressure = WriteStallPressure(
+          write_stall_predictor_.PredictNumL0Files(horizon_micros),
+          write_stall_predictor_.PredictPendingCompactionBytes(horizon_micros),
+          mutable_cf_options);
+    }
+    double pressure = std::max(
+        predicted_pressure,
+        WriteStallPressure(num_l0_files, compaction_needed_bytes, mutable_cf_options));
+
     if (imm()->NumNotFlushed() >= mutable_cf_options.max_write_buffer_number) {
+      pressure = 1;
       write_controller_token_ = write_controller->GetStopToken();
       internal_stats_->AddCFStats(InternalStats::MEMTABLE_COMPACTION, 1);
       RLOG(InfoLogLevel::WARN_LEVEL, ioptions_.info_log,
@@ -590,6 +646,7 @@ void ColumnFamilyData::RecalculateWriteStallConditions(
           mutable_cf_options.max_write_buffer_number);
     } else if (vstorage->l0_delay_trigger_count() >=
                mutable_cf_options.level0_stop_writes_trigger) {
+      pressure = 1;
       write_controller_token_ = write_controller->GetStopToken();
       internal_stats_->AddCFStats(InternalStats::LEVEL0_NUM_FILES_TOTAL, 1);
       if (compaction_picker_->IsLevel0CompactionInProgress()) {
@@ -602,6 +659,7 @@ void ColumnFamilyData::RecalculateWriteStallConditions(
     } else if (mutable_cf_options.hard_pending_compaction_bytes_limit > 0 &&
                compaction_needed_bytes >=
                    mutable_cf_options.hard_pending_compaction_bytes_limit) {
+      pressure = 1;
       write_controller_token_ = write_controller->GetStopToken();
       internal_stats_->AddCFStats(
           InternalStats::HARD_PENDING_COMPACTION_BYTES_LIMIT, 1);
@@ -655,6 +713,19 @@ void ColumnFamilyData::RecalculateWriteStallConditions(
           "bytes %" PRIu64 " rate %" PRIu64,
           name_.c_str(), vstorage->estimated_compaction_needed_bytes(),
           write_controller->delayed_write_rate());
+    } else if (predicted_pressure > 0) {
+      // Slowdown limits are not reached yet, but would be soon at the current flush and compaction
+      // rates. Delay writes in proportion to how close the prediction is to stop limits, so
+      // the write rate is lowered smoothly instead of dropping at the slowdown limits.
+      const auto write_rate = static_cast<uint64_t>(
+          ioptions_.delayed_write_rate / std::max(predicted_pressure, 0.01));
+      write_controller_token_ = write_controller->GetDelayToken(write_rate);
+      RLOG(InfoLogLevel::WARN_LEVEL, ioptions_.info_log,
+          "[%s] Stalling writes because we predict %.1f level-0 files and %.0f pending "
+          "compaction bytes in %d ms, rate %" PRIu64,
+          name_.c_str(), write_stall_predictor_.PredictNumL0Files(horizon_ms * 1000ULL),
+          write_stall_predictor_.PredictPendingCompactionBytes(horizon_ms * 1000ULL), horizon_ms,
+          write_rate);
     } else if (vstorage->l0_delay_trigger_count() >=
                GetL0ThresholdSpeedupCompaction(
                    mutable_cf_options.level0_file_num_compaction_trigger,
@@ -682,6 +753,7 @@ void ColumnFamilyData::RecalculateWriteStallConditions(
       write_controller_token_.reset();
     }
     prev_compaction_needed_bytes_ = compaction_needed_bytes;
+    write_stall_pressure_.store(pressure, std::memory_order_release);
   }
 }
 
@@ -338,6 +338,14 @@ class ColumnFamilyData {
   void RecalculateWriteStallConditions(
       const MutableCFOptions& mutable_cf_options);
 
+  // Returns how close writes to this column family are to being stopped: 0 when neither actual
+  // nor predicted number of level 0 files and pending compaction bytes reached slowdown limits,
+  // 1 when writes are stopped, and proportional position between slowdown and stop limits
+  // otherwise. Could be called without DB mutex.
+  double write_stall_pressure() const {
+    return write_stall_pressure_.load(std::memory_order_acquire);
+  }
+
  private:
   friend class ColumnFamilySet;
   ColumnFamilyData(uint32_t id, const std::string& name,
@@ -408,6 +416,9 @@ class ColumnFamilyData {
   bool pending_compaction_;
 
   uint64_t prev_compaction_needed_bytes_;
+
+  WriteStallPredictor write_stall_predictor_;
+  std::atomic<double> write_stall_pressure_{0.0};
 };
 
 // ColumnFamilySet has interesting thread-safety requirements
@@ -40,6 +40,7 @@
 #include "yb/rocksdb/utilities/merge_operators.h"
 
 DECLARE_int32(memstore_arena_size_kb);
+DECLARE_int32(rocksdb_write_stall_prediction_horizon_ms);
 
 using std::atomic;
 
@@ -62,8 +63,17 @@ class EnvCounter : public EnvWrapper {
     return EnvWrapper::NewWritableFile(f, r, soptions);
   }
 
+  uint64_t NowMicros() override {
+    return EnvWrapper::NowMicros() + time_offset_micros_.load();
+  }
+
+  void AdvanceTime(uint64_t micros) {
+    time_offset_micros_.fetch_add(micros);
+  }
+
  private:
   atomic<int> num_new_writable_file_;
+  atomic<uint64_t> time_offset_micros_{0};
 };
 
 class ColumnFamilyTest : public testing::Test {
@@ -75,6 +85,8 @@ class ColumnFamilyTest : public testing::Test {
     db_options_.fail_if_options_file_error = true;
     db_options_.env = env_;
     DestroyDB(dbname_, Options(db_options_, column_family_options_));
+    // Write stall tests check exact stall conditions, that should not depend on timing.
+    FLAGS_rocksdb_write_stall_prediction_horizon_ms = 0;
   }
 
   ~ColumnFamilyTest() {
@@ -2355,6 +2367,53 @@ TEST_F(ColumnFamilyTest, WriteStallSingleColumnFamily) {
             dbfull()->TEST_write_controler().delayed_write_rate());
 }
 
+TEST_F(ColumnFamilyTest, WriteStallPrediction) {
+  FLAGS_rocksdb_write_stall_prediction_horizon_ms = 10000;
+  const uint64_t kBaseRate = 810000u;
+  db_options_.delayed_write_rate = kBaseRate;
+  Open({"default"});
+  ColumnFamilyData* cfd =
+      static_cast<ColumnFamilyHandleImpl*>(db_->DefaultColumnFamily())->cfd();
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  MutableCFOptions mutable_cf_options(
+      Options(db_options_, column_family_options_),
+      ImmutableCFOptions(Options(db_options_, column_family_options_)));
+  mutable_cf_options.soft_pending_compaction_bytes_limit = 1000;
+  mutable_cf_options.hard_pending_compaction_bytes_limit = 3000;
+  const auto& write_controller = dbfull()->TEST_write_controler();
+
+  // Pending compaction bytes grow slowly and are not predicted to reach the soft limit.
+  env_->AdvanceTime(2 * WriteStallPredictor::kMinSampleIntervalMicros);
+  vstorage->TEST_set_estimated_compaction_needed_bytes(200);
+  cfd->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_FALSE(write_controller.NeedsDelay());
+  ASSERT_EQ(0, cfd->write_stall_pressure());
+
+  // Pending compaction bytes are still below the soft limit, but grow fast enough to reach it in
+  // the prediction horizon. Writes are delayed less than at the soft limit.
+  env_->AdvanceTime(2 * WriteStallPredictor::kMinSampleIntervalMicros);
+  vstorage->TEST_set_estimated_compaction_needed_bytes(700);
+  cfd->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_FALSE(write_controller.IsStopped());
+  ASSERT_TRUE(write_controller.NeedsDelay());
+  ASSERT_GT(write_controller.delayed_write_rate(), kBaseRate);
+  ASSERT_GT(cfd->write_stall_pressure(), 0);
+  ASSERT_LT(cfd->write_stall_pressure(), 1);
+
+  // Compactions catch up.
+  env_->AdvanceTime(2 * WriteStallPredictor::kMinSampleIntervalMicros);
+  vstorage->TEST_set_estimated_compaction_needed_bytes(300);
+  cfd->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_FALSE(write_controller.NeedsDelay());
+  ASSERT_EQ(0, cfd->write_stall_pressure());
+
+  // Soft limit is reached, the usual delay is used.
+  vstorage->TEST_set_estimated_compaction_needed_bytes(1100);
+  cfd->RecalculateWriteStallConditions(mutable_cf_options);
+  ASSERT_TRUE(write_controller.NeedsDelay());
+  ASSERT_EQ(kBaseRate, write_controller.delayed_write_rate());
+}
+
 TEST_F(ColumnFamilyTest, CompactionSpeedupSingleColumnFamily) {
   db_options_.base_background_compactions = 2;
   db_options_.max_background_compactions = 6;
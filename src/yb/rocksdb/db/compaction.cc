@@ -544,7 +544,9 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level all sorted runs live in level 0 and the output is written back to it as
+    // a set of files with disjoint key ranges, so the key range could be split as well.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
@@ -121,6 +121,9 @@ struct CompactionJob::SubcompactionState {
   uint64_t num_output_records;
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size;
+  uint64_t micros = 0;
+  // Frontier reported by the compaction filter of this subcompaction.
+  UserFrontierPtr largest_user_frontier;
 
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
@@ -153,6 +156,8 @@ struct CompactionJob::SubcompactionState {
     num_output_records = std::move(o.num_output_records);
     compaction_job_stats = std::move(o.compaction_job_stats);
     approx_size = std::move(o.approx_size);
+    micros = o.micros;
+    largest_user_frontier = std::move(o.largest_user_frontier);
     return *this;
   }
 
@@ -443,9 +448,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
 
   // Group the ranges into subcompactions
   const double min_file_fill_percent = 4.0 / 5;
-  uint64_t max_output_files = static_cast<uint64_t>(std::ceil(
-      sum / min_file_fill_percent /
-      cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
+  // Universal compaction does not split its output by file size, so only the number of ranges and
+  // max_subcompactions limit the number of subcompactions.
+  uint64_t max_output_files = c->IsCompactionStyleUniversal()
+      ? std::numeric_limits<uint64_t>::max()
+      : static_cast<uint64_t>(std::ceil(
+            sum / min_file_fill_percent /
+            cfd->GetCurrentMutableCFOptions()->MaxFileSizeForLevel(out_lvl)));
   uint64_t subcompactions =
       std::min({static_cast<uint64_t>(ranges.size()),
                 static_cast<uint64_t>(db_options_.max_subcompactions),
@@ -631,6 +640,7 @@ void CompactionJob::ProcessKeyValueCompaction(
 
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_PROCESS_KV);
+  const uint64_t start_micros = env_->NowMicros();
 
   // I/O measurement variables
   PerfLevel prev_perf_level = PerfLevel::kEnableTime;
@@ -659,8 +669,8 @@ void CompactionJob::ProcessKeyValueCompaction(
 
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
-    // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    // filter. Each subcompaction has its own filter, so frontiers are merged on install.
+    sub_compact->largest_user_frontier = compaction_filter->GetLargestUserFrontier();
   }
 
   MergeHelper merge(
@@ -799,6 +809,19 @@ void CompactionJob::ProcessKeyValueCompaction(
   sub_compact->c_iter.reset();
   input.reset();
   sub_compact->status = status;
+  sub_compact->micros = env_->NowMicros() - start_micros;
+
+  if (compact_->sub_compact_states.size() > 1) {
+    RLOG(InfoLogLevel::INFO_LEVEL, db_options_.info_log,
+        "[%s] [JOB %d] Subcompaction %" ROCKSDB_PRIszt " of %" ROCKSDB_PRIszt " finished in %"
+        PRIu64 " us: %" PRIu64 " input records, %" PRIu64 " output records, %" ROCKSDB_PRIszt
+        " output files, %" PRIu64 " approximate input bytes, status: %s",
+        cfd->GetName().c_str(), job_id_,
+        static_cast<size_t>(sub_compact - compact_->sub_compact_states.data()) + 1,
+        compact_->sub_compact_states.size(), sub_compact->micros, sub_compact->num_input_records,
+        sub_compact->num_output_records, sub_compact->outputs.size(), sub_compact->approx_size,
+        status.ToString().c_str());
+  }
 }
 
 void CompactionJob::RecordDroppedKeys(
@@ -976,6 +999,10 @@ Status CompactionJob::InstallCompactionResults(
     for (const auto& out : sub_compact.outputs) {
       compaction->edit()->AddFile(compaction->output_level(), out.meta);
     }
+    if (sub_compact.largest_user_frontier) {
+      UpdateUserFrontier(
+          &largest_user_frontier_, sub_compact.largest_user_frontier, UpdateUserValueType::kLargest);
+    }
   }
   if (largest_user_frontier_) {
     compaction->edit()->UpdateFlushedFrontier(largest_user_frontier_);
@@ -151,7 +151,7 @@ class CompactionJob {
   // DBImpl state
   const std::string& dbname_;
   const DBOptions& db_options_;
-  const EnvOptions& env_options_;
+  const EnvOptions env_options_;
   Env* env_;
   VersionSet* versions_;
   std::atomic<bool>* shutting_down_;
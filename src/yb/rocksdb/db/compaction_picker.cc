@@ -1225,7 +1225,25 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
-  for (FileMetaData* f : vstorage.LevelFiles(0)) {
+  const auto& level0_files = vstorage.LevelFiles(0);
+  auto level0_end = level0_files.end();
+  // The oldest files of level 0 whose data expired are deleted instead of being compacted, when
+  // there is no older data in the other levels, so leave them out.
+  if (ioptions.expired_file_filter) {
+    bool other_levels_empty = true;
+    for (int level = 1; level < vstorage.num_levels(); level++) {
+      other_levels_empty = other_levels_empty && vstorage.NumLevelFiles(level) == 0;
+    }
+    while (other_levels_empty && level0_end != level0_files.begin()) {
+      const FileMetaData* f = *(level0_end - 1);
+      if (f->being_compacted || !(*ioptions.expired_file_filter)(f->smallest, f->largest)) {
+        break;
+      }
+      --level0_end;
+    }
+  }
+  for (auto it = level0_files.begin(); it != level0_end; ++it) {
+    FileMetaData* f = *it;
     if (f->fd.GetTotalFileSize() <= max_file_size) {
       ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
@@ -185,6 +185,71 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   }
 }
 
+TEST_F(DBBlockCacheTest, SequentialReadahead) {
+  constexpr int kNumKeys = 100;
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  options.compression = kNoCompression;
+  Reopen(options);
+  std::string value(kValueSize, 'a');
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+
+  ReadOptions read_options;
+  read_options.readahead_size = 10 * kValueSize;
+  read_options.readahead_trigger_reads = 4;
+
+  // Each key has its own block, so a full scan reads data blocks sequentially.
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    int num_keys = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++num_keys;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, num_keys);
+  }
+  const auto used = TestGetTickerCount(options, READAHEAD_BYTES_USED);
+  const auto wasted = TestGetTickerCount(options, READAHEAD_BYTES_WASTED);
+  // Only the first readahead_trigger_reads blocks are read before readahead starts.
+  ASSERT_GT(used, (kNumKeys - 2 * read_options.readahead_trigger_reads) * kValueSize);
+  ASSERT_LE(wasted, read_options.readahead_size);
+
+  // Seeks over every other block are not sequential reads and do not read ahead.
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    for (int i = 0; i < kNumKeys; i += 2) {
+      iter->Seek(Key(i));
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(Key(i), iter->key().ToString());
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(used, TestGetTickerCount(options, READAHEAD_BYTES_USED));
+  ASSERT_EQ(wasted, TestGetTickerCount(options, READAHEAD_BYTES_WASTED));
+
+  // Without readahead_size nothing is read ahead.
+  read_options.readahead_size = 0;
+  table_options.block_cache = NewLRUCache(8 << 20);
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    }
+    ASSERT_OK(iter->status());
+  }
+  ASSERT_EQ(used, TestGetTickerCount(options, READAHEAD_BYTES_USED));
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
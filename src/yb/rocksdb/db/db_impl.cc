@@ -54,6 +54,7 @@
 #include "yb/util/logging.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/fault_injection.h"
+#include "yb/util/mem_attribution.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/priority_thread_pool.h"
 
@@ -235,9 +236,6 @@ class DBImpl::ThreadPoolTask : public yb::PriorityThreadPoolTask {
   DBImpl* const db_impl_;
 };
 
-constexpr int kShuttingDownPriority = 200;
-constexpr int kFlushPriority = 100;
-
 class DBImpl::CompactionTask : public ThreadPoolTask {
  public:
   CompactionTask(DBImpl* db_impl, DBImpl::ManualCompaction* manual_compaction)
@@ -1773,7 +1771,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
         s = BuildTable(dbname_,
                        env_,
                        *cfd->ioptions(),
-                       env_options_,
+                       env_->OptimizeForCompactionTableWrite(env_options_, db_options_),
                        cfd->table_cache(),
                        iter.get(),
                        &meta,
@@ -1848,7 +1846,8 @@ Result<FileNumbersHolder> DBImpl::FlushMemTableToOutputFile(
   }
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options,
+      env_->OptimizeForCompactionTableWrite(env_options_, db_options_),
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, mem_table_flush_filter, pending_outputs_.get(),
       job_context, log_buffer, directories_.GetDbDir(), directories_.GetDataDir(0U),
@@ -1934,6 +1933,11 @@ uint64_t DBImpl::GetCurrentVersionNumSSTFiles() {
   return default_cf_handle_->cfd()->current()->storage_info()->NumFiles();
 }
 
+double DBImpl::GetWriteStallPressure() {
+  // Write stall pressure is atomic, so DB mutex is not necessary.
+  return default_cf_handle_->cfd()->write_stall_pressure();
+}
+
 void DBImpl::SetSSTFileTickers() {
   if (stats_) {
     auto sst_files_size = GetCurrentVersionSstFilesSize();
@@ -2264,7 +2268,8 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_,
+      env_->OptimizeForCompactionTableWrite(env_options_, db_options_), versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, pending_outputs_.get(), table_cache_,
@@ -3260,6 +3265,7 @@ void DBImpl::BackgroundJobComplete(
 }
 
 void DBImpl::BackgroundCallFlush(ColumnFamilyData* cfd) {
+  yb::ScopedAllocationTag allocation_tag("rocksdb_flush");
   bool made_progress = false;
   JobContext job_context(next_job_id_.fetch_add(1), true);
 
@@ -3293,6 +3299,7 @@ void DBImpl::BackgroundCallFlush(ColumnFamilyData* cfd) {
 
 void DBImpl::BackgroundCallCompaction(ManualCompaction* m, std::unique_ptr<Compaction> compaction,
                                       CompactionTask* compaction_task) {
+  yb::ScopedAllocationTag allocation_tag("rocksdb_compaction");
   bool made_progress = false;
   JobContext job_context(next_job_id_.fetch_add(1), true);
   MaybeDumpStats();
@@ -3582,7 +3589,8 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_,
+        env_->OptimizeForCompactionTableWrite(env_options_, db_options_),
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
@@ -5133,7 +5141,24 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
         }
       }
 
-      if (!parallel) {
+      // A single large batch could be split into ranges of entries inserted in parallel.
+      size_t batch_insert_threads = 1;
+      if (!parallel && db_options_.allow_concurrent_memtable_write &&
+          db_options_.memtable_insert_thread_pool != nullptr && write_group.size() == 1 &&
+          !write_group[0]->CallbackFailed() && !write_group[0]->batch->HasMerge() &&
+          !write_group[0]->batch->HasSingleDelete()) {
+        batch_insert_threads = std::min(
+            db_options_.max_memtable_insert_threads_per_batch,
+            total_count / std::max<size_t>(db_options_.min_memtable_insert_entries_per_thread, 1));
+      }
+
+      if (batch_insert_threads > 1) {
+        w.status = WriteBatchInternal::InsertIntoParallel(
+            w.batch, current_sequence, column_family_memtables_.get(), &flush_scheduler_,
+            write_options.ignore_missing_column_families, this,
+            db_options_.memtable_insert_thread_pool, batch_insert_threads);
+        status = w.FinalStatus();
+      } else if (!parallel) {
         InsertFlags insert_flags{InsertFlag::kFilterDeletes};
         status = WriteBatchInternal::InsertInto(
             write_group, current_sequence, column_family_memtables_.get(),
@@ -5626,15 +5651,18 @@ ColumnFamilyHandle* DBImpl::GetColumnFamilyHandleUnlocked(
   return cf_memtables->GetColumnFamilyHandle();
 }
 
-Status DBImpl::Import(const std::string& source_dir) {
+Status DBImpl::Import(const std::string& source_dir, const ImportOptions& options) {
   const auto seqno = versions_->LastSequence();
-  FlushOptions options;
-  RETURN_NOT_OK(Flush(options));
+  FlushOptions flush_options;
+  RETURN_NOT_OK(Flush(flush_options));
   VersionEdit edit;
-  auto status = versions_->Import(source_dir, seqno, &edit);
+  auto status = versions_->Import(source_dir, seqno, options.key_range_validator, &edit);
   if (!status.ok()) {
     return status;
   }
+  if (options.flushed_frontier) {
+    edit.UpdateFlushedFrontier(options.flushed_frontier);
+  }
   return ApplyVersionEdit(&edit);
 }
 
@@ -75,6 +75,11 @@ class FileNumbersProvider;
 struct JobContext;
 struct ExternalSstFileInfo;
 
+// Priorities of the tasks submitted to priority_thread_pool_for_compactions_and_flushes. Compaction
+// tasks of a DB that is not shutting down get lower priorities than flush tasks.
+constexpr int kShuttingDownPriority = 200;
+constexpr int kFlushPriority = 100;
+
 class DBImpl : public DB {
  public:
   DBImpl(const DBOptions& options, const std::string& dbname);
@@ -469,7 +474,10 @@ class DBImpl : public DB {
   // Checks that source database has appropriate seqno.
   // I.e. seqno ranges of imported database does not overlap with seqno ranges of destination db.
   // And max seqno of imported database is less that active seqno of destination db.
-  CHECKED_STATUS Import(const std::string& source_dir) override;
+  // Files are hard linked when possible and copied otherwise, e.g. when source database resides
+  // on another file system.
+  using DB::Import;
+  CHECKED_STATUS Import(const std::string& source_dir, const ImportOptions& options) override;
 
   bool AreWritesStopped();
   bool NeedsDelay() override;
@@ -636,6 +644,8 @@ class DBImpl : public DB {
 
   int GetCfdImmNumNotFlushed() override;
 
+  double GetWriteStallPressure() override;
+
   // Updates stats_ object with SST files size metrics.
   void SetSSTFileTickers();
 
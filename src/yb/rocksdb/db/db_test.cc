@@ -86,6 +86,7 @@
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/util/mock_env.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 #include "yb/rocksdb/util/xfunc.h"
 #include "yb/util/tsan_util.h"
@@ -5322,6 +5323,51 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, ParallelBatchMemtableInsert) {
+  std::unique_ptr<yb::ThreadPool> thread_pool;
+  ASSERT_OK(yb::ThreadPoolBuilder("memtable_insert").set_max_threads(3).Build(&thread_pool));
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.memtable_factory.reset(new SkipListFactory);
+  options.memtable_insert_thread_pool = thread_pool.get();
+  options.max_memtable_insert_threads_per_batch = 4;
+  options.min_memtable_insert_entries_per_thread = 100;
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  const int kNumKeys = 1000;
+  WriteBatch batch;
+  for (int i = 0; i < kNumKeys; ++i) {
+    batch.Put(Key(i), "v1_" + ToString(i));
+  }
+  // Later entries for the same key are inserted by other threads and should still win.
+  for (int i = 0; i < kNumKeys; i += 2) {
+    batch.Put(Key(i), "v2_" + ToString(i));
+  }
+  for (int i = 0; i < kNumKeys; i += 3) {
+    batch.Delete(Key(i));
+  }
+  const SequenceNumber start_sequence = db_->GetLatestSequenceNumber();
+  ASSERT_OK(db_->Write(WriteOptions(), &batch));
+  ASSERT_EQ(start_sequence + WriteBatchInternal::Count(&batch), db_->GetLatestSequenceNumber());
+
+  auto check = [this] {
+    for (int i = 0; i < kNumKeys; ++i) {
+      if (i % 3 == 0) {
+        ASSERT_EQ("NOT_FOUND", Get(Key(i)));
+      } else if (i % 2 == 0) {
+        ASSERT_EQ("v2_" + ToString(i), Get(Key(i)));
+      } else {
+        ASSERT_EQ("v1_" + ToString(i), Get(Key(i)));
+      }
+    }
+  };
+  ASSERT_NO_FATAL_FAILURE(check());
+  ASSERT_OK(Flush());
+  ASSERT_NO_FATAL_FAILURE(check());
+  Close();
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(DBTest, SanitizeNumThreads) {
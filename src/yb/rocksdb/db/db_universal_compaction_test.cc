@@ -1269,6 +1269,52 @@ TEST_P(DBTestUniversalCompactionWithParam, UniversalCompactionSecondPathRatio) {
   Destroy(options);
 }
 
+TEST_P(DBTestUniversalCompactionWithParam, UniversalCompactionSubcompactions) {
+  Options options;
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = num_levels_;
+  options.write_buffer_size = 100 << 10;  // 100KB
+  options.level0_file_num_compaction_trigger = 100;
+  options.max_subcompactions = 4;
+  options.compression = kNoCompression;
+  options = CurrentOptions(options);
+  DestroyAndReopen(options);
+
+  std::atomic<int> num_subcompactions(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():Inprogress",
+      [&](void* arg) { num_subcompactions.fetch_add(1); });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  // Files with overlapping key ranges, so that each of them provides boundaries.
+  const int kNumKeys = 10000;
+  const int kNumFiles = 8;
+  for (int file = 0; file < kNumFiles; file++) {
+    for (int i = file; i < kNumKeys; i += kNumFiles / 2) {
+      ASSERT_OK(Put(Key(i), Key(i + file)));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  CompactRangeOptions compact_options;
+  compact_options.exclusive_manual_compaction = exclusive_manual_compaction_;
+  ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+  dbfull()->TEST_WaitForCompact();
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GT(num_subcompactions.load(), 1);
+  ASSERT_LE(num_subcompactions.load(), 4);
+  for (int i = 0; i < kNumKeys; i++) {
+    // The latest file that contains the key.
+    int file = i % (kNumFiles / 2) + kNumFiles / 2;
+    if (file > i) {
+      file = i;
+    }
+    ASSERT_EQ(Key(i + file), Get(Key(i)));
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(UniversalCompactionNumLevels, DBTestUniversalCompactionWithParam,
                         ::testing::Combine(::testing::Values(1, 3, 5),
                                            ::testing::Bool()));
@@ -251,6 +251,10 @@ class VersionEdit {
     return new_files_;
   }
 
+  std::vector<std::pair<int, FileMetaData>>* mutable_new_files() {
+    return &new_files_;
+  }
+
   std::string DebugString(bool hex_key = false) const;
 
   std::string ToString() const {
@@ -809,22 +809,34 @@ void Version::AddIterators(const ReadOptions& read_options,
 
   auto* arena = merge_iter_builder->GetArena();
 
+  const auto* table_aware_file_filter = read_options.table_aware_file_filter.get();
+  Statistics* statistics = cfd_->ioptions()->statistics;
+  size_t num_skipped_files = 0;
+
   // Merge all level zero files together since they may overlap
   for (size_t i = 0; i < storage_info_.LevelFilesBrief(0).num_files; i++) {
     const auto& file = storage_info_.LevelFilesBrief(0).files[i];
     if (!read_options.file_filter || read_options.file_filter->Filter(file)) {
+      // Check the key range before obtaining the table reader, which could require opening the
+      // file and reading its filter block.
+      if (table_aware_file_filter && !table_aware_file_filter->KeyRangeMayMatch(
+              file.smallest.user_key(), file.largest.user_key())) {
+        RecordTick(statistics, SST_FILES_SKIPPED_BY_KEY_RANGE);
+        ++num_skipped_files;
+        continue;
+      }
       InternalIterator *file_iter;
       TableCache::TableReaderWithHandle trwh;
       Status s = cfd_->table_cache()->GetTableReaderForIterator(read_options, soptions,
           cfd_->internal_comparator(), file.fd, &trwh, cfd_->internal_stats()->GetFileReadHist(0),
           false);
       if (s.ok()) {
-        if (!read_options.table_aware_file_filter ||
-            read_options.table_aware_file_filter->Filter(trwh.table_reader)) {
+        if (!table_aware_file_filter || table_aware_file_filter->Filter(trwh.table_reader)) {
           file_iter = cfd_->table_cache()->NewIterator(
               read_options, &trwh, storage_info_.LevelFiles(0)[i]->UserFilter(), false, arena);
         } else {
           file_iter = nullptr;
+          ++num_skipped_files;
         }
       } else {
         file_iter = NewErrorInternalIterator(s, arena);
@@ -834,6 +846,9 @@ void Version::AddIterators(const ReadOptions& read_options,
       }
     }
   }
+  if (table_aware_file_filter) {
+    MeasureTime(statistics, SST_FILES_SKIPPED_PER_READ, num_skipped_files);
+  }
 
   // For levels > 0, we can use a concatenating iterator that sequentially
   // walks through the non-overlapping files in the level, opening them
@@ -2554,6 +2569,26 @@ class ManifestReader {
 
 } // namespace
 
+void VersionSet::FixupFilePaths(VersionEdit* edit) {
+  const auto& db_paths = db_options_->db_paths;
+  if (db_paths.size() <= 1) {
+    return;
+  }
+  for (auto& new_file : *edit->mutable_new_files()) {
+    auto& fd = new_file.second.fd;
+    const uint32_t path_id = fd.GetPathId();
+    if (path_id == 0 ||
+        env_->FileExists(TableFileName(db_paths, fd.GetNumber(), path_id)).ok() ||
+        !env_->FileExists(TableFileName(db_paths, fd.GetNumber(), 0)).ok()) {
+      continue;
+    }
+    RLOG(InfoLogLevel::INFO_LEVEL, db_options_->info_log,
+        "Table file %" PRIu64 " is not found in path %" PRIu32 ", using %s",
+        fd.GetNumber(), path_id, db_paths[0].path.c_str());
+    fd.packed_number_and_path_id = PackFileNumberAndPathId(fd.GetNumber(), 0);
+  }
+}
+
 Status VersionSet::Recover(
     const std::vector<ColumnFamilyDescriptor>& column_families,
     bool read_only) {
@@ -2683,6 +2718,7 @@ Status VersionSet::Recover(
         // to builder
         auto builder = builders.find(edit.column_family_);
         assert(builder != builders.end());
+        FixupFilePaths(&edit);
         builder->second->version_builder()->Apply(&edit);
       }
 
@@ -2830,8 +2866,20 @@ Status VersionSet::Recover(
   return s;
 }
 
+Status VersionSet::LinkOrCopyFile(const std::string& source, const std::string& dest) {
+  auto status = env_->LinkFile(source, dest);
+  if (status.ok()) {
+    return status;
+  }
+  // Hard link is not possible across file systems, so fall back to copying the file.
+  LOG(INFO) << "Failed to link " << source << " => " << dest << ": " << status
+            << ", copying it instead";
+  return CopyFile(env_, source, dest);
+}
+
 Status VersionSet::Import(const std::string& source_dir,
                           SequenceNumber seqno,
+                          const ImportKeyRangeValidator& key_range_validator,
                           VersionEdit* edit) {
   ManifestReader manifest_reader(env_, db_options_->get_checkpoint_env(), env_options_,
                                  db_options_->boundary_extractor.get(), source_dir);
@@ -2861,6 +2909,14 @@ Status VersionSet::Import(const std::string& source_dir,
                              filemeta.largest.seqno,
                              seqno);
       }
+      if (key_range_validator) {
+        status = key_range_validator(filemeta.smallest.key.user_key(),
+                                     filemeta.largest.key.user_key());
+        if (!status.ok()) {
+          return status.CloneAndPrepend(Format(
+              "Imported file $0 has keys out of range", filemeta.fd.GetNumber()));
+        }
+      }
       files.push_back(filemeta);
       segments.emplace_back(filemeta.smallest.seqno, filemeta.largest.seqno);
     }
@@ -2904,12 +2960,12 @@ Status VersionSet::Import(const std::string& source_dir,
     auto dest_base = MakeTableFileName(dbname_, new_number);
     auto dest_data = TableBaseToDataFileName(dest_base);
     LOG(INFO) << "Importing: " << source_base << " => " << dest_base;
-    status = env_->LinkFile(source_base, dest_base);
+    status = LinkOrCopyFile(source_base, dest_base);
     if (!status.ok()) {
       break;
     }
     revert_list.push_back(dest_base);
-    status = env_->LinkFile(source_data, dest_data);
+    status = LinkOrCopyFile(source_data, dest_data);
     if (!status.ok()) {
       break;
     }
@@ -747,7 +747,10 @@ class VersionSet {
   ColumnFamilySet* GetColumnFamilySet() { return column_family_set_.get(); }
   const EnvOptions& env_options() { return env_options_; }
 
-  CHECKED_STATUS Import(const std::string& source_dir, SequenceNumber seqno, VersionEdit* edit);
+  CHECKED_STATUS Import(const std::string& source_dir,
+                        SequenceNumber seqno,
+                        const ImportKeyRangeValidator& key_range_validator,
+                        VersionEdit* edit);
 
   void UnrefFile(ColumnFamilyData* cfd, FileMetaData* f);
 
@@ -776,6 +779,13 @@ class VersionSet {
 
   void AppendVersion(ColumnFamilyData* column_family_data, Version* v);
 
+  // Table files of a DB restored from a checkpoint are all placed in the first DB path, while the
+  // manifest could refer to other paths. Switches such files of the edit to the first path.
+  void FixupFilePaths(VersionEdit* edit);
+
+  // Hard links source file to dest, copies it if linking fails.
+  CHECKED_STATUS LinkOrCopyFile(const std::string& source, const std::string& dest);
+
   ColumnFamilyData* CreateColumnFamily(const ColumnFamilyOptions& cf_options,
                                        VersionEdit* edit);
 
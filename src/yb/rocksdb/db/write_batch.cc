@@ -43,6 +43,7 @@
 
 #include "yb/rocksdb/write_batch.h"
 
+#include <algorithm>
 #include <stack>
 #include <stdexcept>
 #include <vector>
@@ -62,6 +63,9 @@
 
 #include "yb/gutil/macros.h"
 
+#include "yb/util/countdown_latch.h"
+#include "yb/util/threadpool.h"
+
 namespace rocksdb {
 
 // anon namespace for file-local types
@@ -853,6 +857,47 @@ class MemTableInserter : public WriteBatch::Handler {
   }
 };
 
+// Forwards to the inserter only entries with indexes in the [begin, end) range of the batch.
+class RangeMemTableInserter : public WriteBatch::Handler {
+ public:
+  RangeMemTableInserter(MemTableInserter* inserter, size_t begin, size_t end)
+      : inserter_(inserter), begin_(begin), end_(end) {}
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key,
+                       const Slice& value) override {
+    return InRange() ? inserter_->PutCF(column_family_id, key, value) : Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return InRange() ? inserter_->DeleteCF(column_family_id, key) : Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return InRange() ? inserter_->SingleDeleteCF(column_family_id, key) : Status::OK();
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t column_family_id, const Slice& key,
+                         const Slice& value) override {
+    return InRange() ? inserter_->MergeCF(column_family_id, key, value) : Status::OK();
+  }
+
+  // Frontiers are applied once per batch, by the inserter of its first range.
+  CHECKED_STATUS Frontiers(const UserFrontiers& frontiers) override {
+    return begin_ == 0 ? inserter_->Frontiers(frontiers) : Status::OK();
+  }
+
+ private:
+  bool InRange() {
+    const size_t index = index_++;
+    return index >= begin_ && index < end_;
+  }
+
+  MemTableInserter* const inserter_;
+  const size_t begin_;
+  const size_t end_;
+  size_t index_ = 0;
+};
+
 }  // namespace
 
 // This function can only be called in these conditions:
@@ -892,6 +937,55 @@ Status WriteBatchInternal::InsertInto(const WriteBatch* batch,
   return batch->Iterate(&inserter);
 }
 
+Status WriteBatchInternal::InsertIntoParallel(const WriteBatch* batch,
+                                              SequenceNumber sequence,
+                                              ColumnFamilyMemTablesImpl* memtables,
+                                              FlushScheduler* flush_scheduler,
+                                              bool ignore_missing_column_families,
+                                              DB* db,
+                                              yb::ThreadPool* thread_pool,
+                                              size_t num_threads) {
+  DCHECK(!batch->HasMerge() && !batch->HasSingleDelete());
+  const size_t count = Count(batch);
+  num_threads = std::max<size_t>(std::min<size_t>(num_threads, count), 1);
+  std::vector<Status> statuses(num_threads);
+  yb::CountDownLatch latch(num_threads - 1);
+
+  // Every thread scans the whole batch, which is cheap compared to inserting into the skip list,
+  // and inserts entries of its range, taking sequence numbers starting from the one of the first
+  // entry of the range.
+  auto insert_range = [&](size_t idx) {
+    const size_t begin = count * idx / num_threads;
+    const size_t end = count * (idx + 1) / num_threads;
+    ColumnFamilyMemTablesImpl thread_memtables(memtables);
+    MemTableInserter inserter(
+        sequence + begin, &thread_memtables, flush_scheduler, ignore_missing_column_families,
+        0 /* log_number */, db, InsertFlags{InsertFlag::kConcurrentMemtableWrites});
+    RangeMemTableInserter range_inserter(&inserter, begin, end);
+    statuses[idx] = batch->Iterate(&range_inserter);
+  };
+
+  for (size_t idx = 1; idx < num_threads; ++idx) {
+    auto status = thread_pool->SubmitFunc([&insert_range, &latch, idx] {
+      insert_range(idx);
+      latch.CountDown();
+    });
+    if (!status.ok()) {
+      insert_range(idx);
+      latch.CountDown();
+    }
+  }
+  insert_range(0);
+  latch.Wait();
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+  return Status::OK();
+}
+
 void WriteBatchInternal::SetContents(WriteBatch* b, const Slice& contents) {
   DCHECK_GE(contents.size(), kHeader);
   b->rep_.assign(contents.cdata(), contents.size());
@@ -40,6 +40,7 @@ namespace rocksdb {
 class MemTable;
 class FlushScheduler;
 class ColumnFamilyData;
+class ColumnFamilyMemTablesImpl;
 
 class ColumnFamilyMemTables {
  public:
@@ -176,6 +177,20 @@ class WriteBatchInternal {
                            uint64_t log_number = 0, DB* db = nullptr,
                            InsertFlags insert_flags = InsertFlags());
 
+  // Inserts entries of the batch into memtables using num_threads threads: the calling one and
+  // threads of thread_pool. Each thread inserts a contiguous range of entries of the batch with
+  // concurrent memtable writes, using its own copy of memtables.
+  //
+  // REQUIRES: memtables support concurrent inserts, the batch has no merges and single deletes.
+  static Status InsertIntoParallel(const WriteBatch* batch,
+                                   SequenceNumber sequence,
+                                   ColumnFamilyMemTablesImpl* memtables,
+                                   FlushScheduler* flush_scheduler,
+                                   bool ignore_missing_column_families,
+                                   DB* db,
+                                   yb::ThreadPool* thread_pool,
+                                   size_t num_threads);
+
   static void Append(WriteBatch* dst, const WriteBatch* src);
 
   // Returns the byte size of appending a WriteBatch with ByteSize
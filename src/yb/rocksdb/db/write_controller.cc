@@ -20,6 +20,7 @@
 
 #include "yb/rocksdb/db/write_controller.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 
@@ -141,4 +142,39 @@ CompactionPressureToken::~CompactionPressureToken() {
   assert(controller_->total_compaction_pressure_ >= 0);
 }
 
+constexpr uint64_t WriteStallPredictor::kMinSampleIntervalMicros;
+
+void WriteStallPredictor::Update(
+    uint64_t now_micros, uint64_t num_l0_files, uint64_t pending_compaction_bytes) {
+  num_l0_files_ = num_l0_files;
+  pending_compaction_bytes_ = pending_compaction_bytes;
+  if (sample_time_micros_ != 0 && now_micros < sample_time_micros_ + kMinSampleIntervalMicros) {
+    return;
+  }
+  if (sample_time_micros_ != 0) {
+    const double interval = now_micros - sample_time_micros_;
+    const double num_l0_files_rate =
+        (static_cast<double>(num_l0_files) - sample_num_l0_files_) / interval;
+    const double pending_compaction_bytes_rate =
+        (static_cast<double>(pending_compaction_bytes) - sample_pending_compaction_bytes_) /
+        interval;
+    num_l0_files_rate_ =
+        kSmoothingFactor * num_l0_files_rate + (1 - kSmoothingFactor) * num_l0_files_rate_;
+    pending_compaction_bytes_rate_ =
+        kSmoothingFactor * pending_compaction_bytes_rate +
+        (1 - kSmoothingFactor) * pending_compaction_bytes_rate_;
+  }
+  sample_time_micros_ = now_micros;
+  sample_num_l0_files_ = num_l0_files;
+  sample_pending_compaction_bytes_ = pending_compaction_bytes;
+}
+
+double WriteStallPredictor::PredictNumL0Files(uint64_t horizon_micros) const {
+  return num_l0_files_ + std::max(num_l0_files_rate_, 0.0) * horizon_micros;
+}
+
+double WriteStallPredictor::PredictPendingCompactionBytes(uint64_t horizon_micros) const {
+  return pending_compaction_bytes_ + std::max(pending_compaction_bytes_rate_, 0.0) * horizon_micros;
+}
+
 }  // namespace rocksdb
@@ -127,4 +127,37 @@ class CompactionPressureToken : public WriteControllerToken {
   virtual ~CompactionPressureToken();
 };
 
+// Predicts the number of level 0 files and pending compaction bytes of a column family from the
+// rates they changed with recently, i.e. from the balance between flush and compaction rates. It
+// allows to slow down writes gradually before write stall limits are actually hit.
+// Not thread safe, used under DB mutex.
+class WriteStallPredictor {
+ public:
+  // Records values observed at now_micros. Rates are sampled at most once per
+  // kMinSampleIntervalMicros, so bursts of flushes and compactions do not produce spikes.
+  void Update(uint64_t now_micros, uint64_t num_l0_files, uint64_t pending_compaction_bytes);
+
+  // Return values predicted horizon_micros after the last update. Values are never predicted to
+  // decrease, since they are only compared with stall limits.
+  double PredictNumL0Files(uint64_t horizon_micros) const;
+  double PredictPendingCompactionBytes(uint64_t horizon_micros) const;
+
+  static constexpr uint64_t kMinSampleIntervalMicros = 1000000;
+
+ private:
+  // Weight of the most recent sample in exponentially smoothed rates.
+  static constexpr double kSmoothingFactor = 0.5;
+
+  uint64_t num_l0_files_ = 0;
+  uint64_t pending_compaction_bytes_ = 0;
+
+  uint64_t sample_time_micros_ = 0;
+  uint64_t sample_num_l0_files_ = 0;
+  uint64_t sample_pending_compaction_bytes_ = 0;
+
+  // Rates of change per microsecond.
+  double num_l0_files_rate_ = 0;
+  double pending_compaction_bytes_rate_ = 0;
+};
+
 }  // namespace rocksdb
@@ -137,6 +137,34 @@ TEST_F(WriteControllerTest, SanityTest) {
   ASSERT_FALSE(controller.IsStopped());
 }
 
+TEST_F(WriteControllerTest, WriteStallPredictor) {
+  constexpr uint64_t kSecond = 1000000;
+  WriteStallPredictor predictor;
+  uint64_t now = kSecond;
+  predictor.Update(now, 4, 1000);
+  // No rates are known after the first sample.
+  ASSERT_DOUBLE_EQ(4, predictor.PredictNumL0Files(10 * kSecond));
+  ASSERT_DOUBLE_EQ(1000, predictor.PredictPendingCompactionBytes(10 * kSecond));
+
+  // Samples more frequent than once a second only update the current values.
+  predictor.Update(now + kSecond / 2, 5, 1500);
+  ASSERT_DOUBLE_EQ(5, predictor.PredictNumL0Files(10 * kSecond));
+  ASSERT_DOUBLE_EQ(1500, predictor.PredictPendingCompactionBytes(10 * kSecond));
+
+  // Flushes outpace compactions: one L0 file and 1000 pending bytes per second. Half of the rate
+  // is taken into account after the first interval.
+  now += 2 * kSecond;
+  predictor.Update(now, 6, 3000);
+  ASSERT_DOUBLE_EQ(6 + 0.5 * 10, predictor.PredictNumL0Files(10 * kSecond));
+  ASSERT_DOUBLE_EQ(3000 + 500 * 10, predictor.PredictPendingCompactionBytes(10 * kSecond));
+
+  // Compactions catch up, so values are not predicted to grow anymore.
+  now += 2 * kSecond;
+  predictor.Update(now, 2, 1000);
+  ASSERT_DOUBLE_EQ(2, predictor.PredictNumL0Files(10 * kSecond));
+  ASSERT_DOUBLE_EQ(1000, predictor.PredictPendingCompactionBytes(10 * kSecond));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -102,6 +102,10 @@ struct EnvOptions : public yb::FileSystemOptions {
   // If true, then use mmap to write data
   bool use_mmap_writes = true;
 
+  // If true, then write data with O_DIRECT, bypassing the OS page cache. Ignored when
+  // use_mmap_writes is set.
+  bool use_direct_writes = false;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
@@ -460,6 +464,11 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for writing SST files produced by flushes and
+  // compactions.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -46,6 +46,7 @@ namespace yb {
 
 class MemTracker;
 class PriorityThreadPool;
+class ThreadPool;
 
 }
 
@@ -76,6 +77,7 @@ class InternalKeyComparator;
 class WalFilter;
 class MemoryMonitor;
 
+struct FileBoundaryValuesBase;
 struct FileMetaData;
 
 typedef std::shared_ptr<const InternalKeyComparator> InternalKeyComparatorPtr;
@@ -168,9 +170,21 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of dictionary used to prime the compression library. The dictionary is built
+  // from the first data blocks of each SST file and stored in a meta block of that file, so
+  // following blocks could reference data repeated across rows. Only used by compression types
+  // that support dictionaries (zlib, LZ4 and ZSTD). Default: 0, i.e. no dictionary.
+  uint32_t max_dict_bytes;
+  // Amount of data sampled for training the dictionary with zstd trainer. Used only with ZSTD
+  // compression and zstd v1.1.3+, when 0 samples are used as the dictionary as is.
+  // Default: 0.
+  uint32_t zstd_max_train_bytes;
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), zstd_max_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _zstd_max_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        zstd_max_train_bytes(_zstd_max_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -829,6 +843,9 @@ struct ColumnFamilyOptions {
 typedef std::function<yb::Result<bool>(const MemTable&)> MemTableFilter;
 using IteratorReplacer =
     std::function<InternalIterator*(InternalIterator*, Arena*, const Slice&)>;
+// Takes the smallest and the largest boundary values of an SST file.
+using ExpiredFileFilter =
+    std::function<bool(const FileBoundaryValuesBase&, const FileBoundaryValuesBase&)>;
 
 struct DBOptions {
   // Some functions that make it easier to optimize RocksDB
@@ -876,6 +893,17 @@ struct DBOptions {
 
   yb::PriorityThreadPool* priority_thread_pool_for_compactions_and_flushes = nullptr;
 
+  // Thread pool used to insert entries of a large write batch into the memtable in parallel with
+  // the writing thread, requires allow_concurrent_memtable_write. Only the writing thread inserts
+  // entries if nullptr.
+  yb::ThreadPool* memtable_insert_thread_pool = nullptr;
+
+  // Maximum number of threads, including the writing one, inserting entries of one write batch.
+  size_t max_memtable_insert_threads_per_batch = 4;
+
+  // Minimum number of write batch entries inserted by each of the threads.
+  size_t min_memtable_insert_entries_per_thread = 256;
+
   // Use to control write rate of flush and compaction. Flush has higher
   // priority than compaction. Rate limiting is disabled if nullptr.
   // If rate limiter is enabled, bytes_per_sync is set to 1MB by default.
@@ -1106,6 +1134,16 @@ struct DBOptions {
   // Default: false
   bool allow_mmap_writes;
 
+  // Read SST files with O_DIRECT, bypassing the OS page cache, so that data is cached only once,
+  // in the block cache. Ignored when allow_mmap_reads is set.
+  // Default: false
+  bool use_direct_reads;
+
+  // Write SST files produced by flushes and compactions with O_DIRECT, so that writing them does
+  // not evict useful pages from the OS page cache.
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction;
+
   // If false, fallocate() calls are bypassed
   bool allow_fallocate;
 
@@ -1350,6 +1388,11 @@ struct DBOptions {
   // Adds ability to modify iterator created for SST file.
   // For instance some additional filtering could be added.
   std::shared_ptr<IteratorReplacer> iterator_replacer;
+
+  // Tells whether all the data of the SST file expired, so the file would be deleted instead of
+  // being compacted. The oldest files of level 0 that pass it are not picked by the universal
+  // compaction.
+  std::shared_ptr<ExpiredFileFilter> expired_file_filter;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1406,6 +1449,13 @@ class TableAwareReadFileFilter {
  public:
   virtual bool Filter(TableReader*) const = 0;
 
+  // Checks whether a file with the given user key range could pass the filter. It is called with
+  // file metadata only, before the table reader is obtained, so it is a cheap way to skip a file.
+  virtual bool KeyRangeMayMatch(const Slice& smallest_user_key,
+                                const Slice& largest_user_key) const {
+    return true;
+  }
+
  protected:
   virtual ~TableAwareReadFileFilter() {}
 };
@@ -1515,6 +1565,13 @@ struct ReadOptions {
 
   std::shared_ptr<ReadFileFilter> file_filter;
 
+  // Adaptive readahead for sequential scans. Once an iterator has read readahead_trigger_reads
+  // adjacent data blocks of an SST file that were not in the block cache, it asks the file system
+  // to asynchronously read ahead the next readahead_size bytes of that file.
+  // Default: 0, readahead is disabled.
+  size_t readahead_size = 0;
+  size_t readahead_trigger_reads = 4;
+
   static const ReadOptions kDefault;
 
   ReadOptions();
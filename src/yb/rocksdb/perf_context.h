@@ -106,6 +106,14 @@ struct PerfContext {
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
   uint64_t bloom_sst_miss_count;
+  // total number of seeks, nexts and prevs of the DB iterators
+  uint64_t iter_seek_count;
+  uint64_t iter_next_count;
+  uint64_t iter_prev_count;
+  // total number of SST bloom filter checks, and of the checks that excluded the SST file,
+  // the same as the BLOOM_FILTER_CHECKED and BLOOM_FILTER_USEFUL tickers
+  uint64_t bloom_filter_checked_count;
+  uint64_t bloom_filter_useful_count;
 };
 
 #if defined(NPERF_CONTEXT) || defined(IOS_CROSS_COMPILE)
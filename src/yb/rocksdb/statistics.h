@@ -207,6 +207,23 @@ enum Tickers : uint32_t {
   BLOCK_CACHE_MULTI_TOUCH_BYTES_READ,
   BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE,
 
+  // Bytes read ahead by sequential scans that were later read by the scan, and the ones that were
+  // not read because the scan stopped or jumped elsewhere.
+  READAHEAD_BYTES_USED,
+  READAHEAD_BYTES_WASTED,
+
+  // Number of SST files skipped by point reads because their key range does not contain the
+  // filter key.
+  SST_FILES_SKIPPED_BY_KEY_RANGE,
+
+  // Bytes of SST files read with direct I/O, bypassing the OS page cache, and the ones read through
+  // the page cache, which compete with the block cache for memory.
+  SST_DIRECT_READ_BYTES,
+  SST_BUFFERED_READ_BYTES,
+
+  // Time spent computing and verifying checksums of SST blocks.
+  BLOCK_CHECKSUM_NANOS,
+
   // End of ticker enum.
   TICKER_ENUM_MAX,
 };
@@ -311,7 +328,13 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
     {BLOCK_CACHE_MULTI_TOUCH_HIT, "rocksdb_block_cache_multi_touch_hit"},
     {BLOCK_CACHE_MULTI_TOUCH_ADD, "rocksdb_block_cache_multi_touch_add"},
     {BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, "rocksdb_block_cache_multi_touch_bytes_read"},
-    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"}
+    {BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, "rocksdb_block_cache_multi_touch_bytes_write"},
+    {READAHEAD_BYTES_USED, "rocksdb_readahead_bytes_used"},
+    {READAHEAD_BYTES_WASTED, "rocksdb_readahead_bytes_wasted"},
+    {SST_FILES_SKIPPED_BY_KEY_RANGE, "rocksdb_sst_files_skipped_by_key_range"},
+    {SST_DIRECT_READ_BYTES, "rocksdb_sst_direct_read_bytes"},
+    {SST_BUFFERED_READ_BYTES, "rocksdb_sst_buffered_read_bytes"},
+    {BLOCK_CHECKSUM_NANOS, "rocksdb_block_checksum_time_nanos"}
 };
 
 /**
@@ -351,6 +374,9 @@ enum Histograms : uint32_t {
   BYTES_PER_READ,
   BYTES_PER_WRITE,
   BYTES_PER_MULTIGET,
+  // Number of SST files skipped by key range or bloom filter checks when creating an iterator for
+  // a point read.
+  SST_FILES_SKIPPED_PER_READ,
   HISTOGRAM_ENUM_MAX,  // TODO(ldemailly): enforce HistogramsNameMap match
 };
 
@@ -381,6 +407,7 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {BYTES_PER_READ, "rocksdb_bytes_per_read"},
     {BYTES_PER_WRITE, "rocksdb_bytes_per_write"},
     {BYTES_PER_MULTIGET, "rocksdb_bytes_per_multiget"},
+    {SST_FILES_SKIPPED_PER_READ, "rocksdb_sst_files_skipped_per_read"},
 };
 
 struct HistogramData {
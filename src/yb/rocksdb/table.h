@@ -96,6 +96,13 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If true, the top level of a kMultiLevelBinarySearch index is kept in the table reader for the
+  // lifetime of the table, even when cache_index_and_filter_blocks is set. Lower index levels and
+  // filter blocks are still loaded on demand through the block cache. The top level is small,
+  // since index levels are split by index_block_size, so memory per table stays bounded while an
+  // index lookup never has to reload it after eviction.
+  bool pin_top_level_index = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
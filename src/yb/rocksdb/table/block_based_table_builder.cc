@@ -27,11 +27,13 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "yb/rocksdb/db/dbformat.h"
 
@@ -107,9 +109,11 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 }
 
 // format_version is the block format as defined in include/rocksdb/table.h
+// compression_dict is used by compression types that support dictionaries, when not empty.
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const Slice& compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -129,7 +133,7 @@ Slice CompressBlock(const Slice& raw,
       if (Zlib_Compress(
               compression_options,
               GetCompressFormatForVersion(kZlibCompression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -147,7 +151,7 @@ Slice CompressBlock(const Slice& raw,
       if (LZ4_Compress(
               compression_options,
               GetCompressFormatForVersion(kLZ4Compression, format_version),
-              raw.cdata(), raw.size(), compressed_output) &&
+              raw.cdata(), raw.size(), compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -163,7 +167,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -291,6 +295,15 @@ struct BlockBasedTableBuilder::Rep {
   const CompressionOptions compression_opts;
   TableProperties props;
 
+  // Dictionary used to compress data blocks starting at compression_dict_offset of the data file,
+  // see CompressionOptions::max_dict_bytes. Built from the raw contents of the first data blocks,
+  // that are collected in compression_dict_samples while compression_dict_pending is true.
+  std::string compression_dict;
+  uint64_t compression_dict_offset = 0;
+  bool compression_dict_pending = false;
+  std::string compression_dict_samples;
+  std::vector<size_t> compression_dict_sample_lens;
+
   bool closed = false;  // Either Finish() or Abandon() has been called.
 
   BlockHandle data_pending_handle;    // Handle to add to data index block
@@ -376,6 +389,9 @@ BlockBasedTableBuilder::Rep::Rep(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
   }
 
+  compression_dict_pending = compression_opts.max_dict_bytes > 0 &&
+                             CompressionTypeSupportsDictionary(compression_type);
+
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
   if (data_file != nullptr) {
@@ -489,8 +505,13 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   size_t data_block_size = 0;
 
   if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+    const Slice raw_block_contents = r->data_block_builder.Finish();
+    data_block_size = WriteBlock(raw_block_contents, &r->data_pending_handle,
+        r->data_writer.get(), r->compression_dict);
+    if (r->compression_dict_pending && ok()) {
+      SampleForCompressionDict(raw_block_contents);
+    }
+    r->data_block_builder.Reset();
   }
   if (!ok()) return;
 
@@ -569,9 +590,40 @@ size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
   return block_size;
 }
 
+void BlockBasedTableBuilder::SampleForCompressionDict(const Slice& raw_block_contents) {
+  Rep* r = rep_;
+  const bool train = r->compression_type == kZSTDNotFinalCompression &&
+                     r->compression_opts.zstd_max_train_bytes > 0;
+  const size_t target_bytes = train ? r->compression_opts.zstd_max_train_bytes
+                                    : r->compression_opts.max_dict_bytes;
+  r->compression_dict_samples.append(raw_block_contents.cdata(), raw_block_contents.size());
+  r->compression_dict_sample_lens.push_back(raw_block_contents.size());
+  if (r->compression_dict_samples.size() < target_bytes) {
+    return;
+  }
+
+  if (train) {
+    r->compression_dict = ZSTD_TrainDictionary(
+        r->compression_dict_samples, r->compression_dict_sample_lens,
+        r->compression_opts.max_dict_bytes);
+  }
+  if (r->compression_dict.empty()) {
+    // Use the most recent samples, since the end of the dictionary is the cheapest to reference.
+    const size_t dict_size =
+        std::min<size_t>(r->compression_dict_samples.size(), r->compression_opts.max_dict_bytes);
+    r->compression_dict.assign(
+        r->compression_dict_samples, r->compression_dict_samples.size() - dict_size, dict_size);
+  }
+  r->compression_dict_offset = r->data_writer->offset;
+  r->compression_dict_pending = false;
+  std::string().swap(r->compression_dict_samples);
+  std::vector<size_t>().swap(r->compression_dict_sample_lens);
+}
+
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const Slice& compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -584,7 +636,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict, &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -609,6 +661,7 @@ size_t BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
     char trailer[kBlockTrailerSize];
     trailer[0] = type;
     char* trailer_without_type = trailer + 1;
+    StopWatchNano checksum_timer(r->ioptions.env, r->ioptions.statistics != nullptr);
     switch (r->table_options.checksum) {
       case kNoChecksum:
         // we don't support no checksum yet
@@ -634,6 +687,9 @@ size_t BlockBasedTableBuilder::WriteRawBlock(const Slice& block_contents,
         break;
       }
     }
+    if (r->ioptions.statistics) {
+      RecordTick(r->ioptions.statistics, BLOCK_CHECKSUM_NANOS, checksum_timer.ElapsedNanos());
+    }
 
     r->status = writer_info->writer->Append(Slice(trailer, kBlockTrailerSize));
     if (r->status.ok()) {
@@ -721,8 +777,9 @@ Status BlockBasedTableBuilder::Finish() {
   // Write meta blocks and metaindex block with the following order.
   //    1. [meta block: filter]
   //    2. [other meta blocks]
-  //    3. [meta block: properties]
-  //    4. [metaindex block]
+  //    3. [meta block: compression dictionary]
+  //    4. [meta block: properties]
+  //    5. [metaindex block]
   // write meta blocks
   MetaIndexBuilder meta_index_builder;
   for (const auto& item : r->data_index_blocks.meta_blocks) {
@@ -731,6 +788,18 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && !r->compression_dict.empty()) {
+    // Compression dictionary block is not compressed and contains offset of the first data block
+    // compressed with the dictionary, followed by the dictionary itself.
+    std::string compression_dict_block;
+    PutFixed64(&compression_dict_block, r->compression_dict_offset);
+    compression_dict_block.append(r->compression_dict);
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(compression_dict_block, kNoCompression, &compression_dict_block_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
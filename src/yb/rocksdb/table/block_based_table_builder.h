@@ -111,8 +111,10 @@ class BlockBasedTableBuilder : public TableBuilder {
   size_t WriteBlock(BlockBuilder* block, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
+  // compression_dict is used for compression when not empty.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const Slice& compression_dict = Slice());
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -130,6 +132,11 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Adds raw contents of the data block just written to the samples for the compression
+  // dictionary, and builds the dictionary once enough data is collected. Data blocks written after
+  // that are compressed with the dictionary.
+  void SampleForCompressionDict(const Slice& raw_block_contents);
+
   // Flush the current filter block into disk. next_block_first_key should be nullptr if this is the
   // last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
@@ -198,7 +198,9 @@ const BlockBasedTableOptions& BlockBasedTableFactory::table_options() const {
 }
 std::shared_ptr<TableAwareReadFileFilter> BlockBasedTableFactory::NewTableAwareReadFileFilter(
     const ReadOptions &read_options, const Slice &user_key) const {
-  return std::make_shared<BloomFilterAwareFileFilter>(read_options, user_key);
+  return std::make_shared<BloomFilterAwareFileFilter>(
+      read_options, user_key,
+      table_options_.filter_policy ? table_options_.filter_policy->GetKeyTransformer() : nullptr);
 }
 
 TableFactory* NewBlockBasedTableFactory(
@@ -236,12 +236,54 @@ struct BlockBasedTable::Rep {
   // block to extract prefix without knowing if a key is internal or not.
   unique_ptr<SliceTransform> internal_prefix_transform;
   DataIndexLoadMode data_index_load_mode;
+  // Whether data index reader is stored in data_index_reader instead of the block cache, see
+  // BlockBasedTableOptions::pin_top_level_index.
+  bool pin_data_index = false;
   yb::MemTrackerPtr mem_tracker;
+
+  // Dictionary that data blocks starting at compression_dict_offset of the data file are
+  // compressed with, see CompressionOptions::max_dict_bytes.
+  std::string compression_dict;
+  uint64_t compression_dict_offset = 0;
+
+  // Returns the dictionary to uncompress the block with the specified type and handle.
+  Slice CompressionDictFor(BlockType block_type, const BlockHandle& handle) const {
+    if (block_type != BlockType::kData || handle.offset() < compression_dict_offset) {
+      return Slice();
+    }
+    return compression_dict;
+  }
+
+  // Some old version of block-based tables don't have index type present in
+  // table properties. If that's the case we can safely use the kBinarySearch.
+  IndexType IndexTypeOnFile() const {
+    if (table_properties) {
+      auto& props = table_properties->user_collected_properties;
+      auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
+      if (pos != props.end()) {
+        return static_cast<IndexType>(DecodeFixed32(pos->second.c_str()));
+      }
+    }
+    return IndexType::kBinarySearch;
+  }
+};
+
+struct BlockBasedTable::ReadaheadState {
+  // Offset right after the last data block read from the file.
+  uint64_t next_block_offset = 0;
+  // Number of adjacent data blocks read from the file up to next_block_offset.
+  size_t num_sequential_reads = 0;
+  // Readahead was requested for the file range [readahead_start, readahead_end).
+  uint64_t readahead_start = 0;
+  uint64_t readahead_end = 0;
+  // Size of the data file, 0 until the first readahead.
+  uint64_t file_size = 0;
 };
 
-// BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
-// to BlockBasedTable. It is used by TwoLevelIterator and MultiLevelIterator to call BlockBasedTable
-// functions in order to check if prefix may match or to create a secondary iterator.
+// BlockEntryIteratorState is used as an adapter to BlockBasedTable. It is used by TwoLevelIterator
+// and MultiLevelIterator to call BlockBasedTable functions in order to check if prefix may match or
+// to create a secondary iterator. The only iterator state it keeps is the readahead state of data
+// block iterators.
 class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
  public:
   BlockEntryIteratorState(
@@ -251,10 +293,21 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         table_(table),
         read_options_(read_options),
         skip_filters_(skip_filters),
-        block_type_(block_type) {}
+        block_type_(block_type) {
+    if (block_type == BlockType::kData && read_options.readahead_size > 0) {
+      readahead_ = std::make_unique<ReadaheadState>();
+    }
+  }
+
+  ~BlockEntryIteratorState() {
+    if (readahead_) {
+      table_->FinishReadahead(readahead_.get());
+    }
+  }
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
-    return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
+    return table_->NewDataBlockIterator(
+        read_options_, index_value, block_type_, nullptr /* input_iter */, readahead_.get());
   }
 
   bool PrefixMayMatch(const Slice& internal_key) override {
@@ -272,6 +325,7 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+  std::unique_ptr<ReadaheadState> readahead_;
 };
 
 
@@ -320,8 +374,22 @@ BlockBasedTable::FileReaderWithCachePrefix* BlockBasedTable::GetBlockReader(Bloc
 }
 
 BloomFilterAwareFileFilter::BloomFilterAwareFileFilter(
-    const ReadOptions& read_options, const Slice& user_key)
-    : read_options_(read_options), user_key_(user_key.ToBuffer()) {}
+    const ReadOptions& read_options, const Slice& user_key,
+    const FilterPolicy::KeyTransformer* filter_key_transformer)
+    : read_options_(read_options),
+      user_key_(user_key.ToBuffer()),
+      filter_key_(filter_key_transformer ? filter_key_transformer->Transform(user_key).ToBuffer()
+                                         : user_key_) {}
+
+bool BloomFilterAwareFileFilter::KeyRangeMayMatch(
+    const Slice& smallest_user_key, const Slice& largest_user_key) const {
+  // Keys with the filter_key_ prefix form a contiguous range that starts at filter_key_.
+  const Slice filter_key(filter_key_);
+  if (largest_user_key.compare(filter_key) < 0) {
+    return false;
+  }
+  return smallest_user_key.compare(filter_key) <= 0 || smallest_user_key.starts_with(filter_key);
+}
 
 bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   auto table = down_cast<BlockBasedTable*>(reader);
@@ -335,6 +403,7 @@ bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
     if (!use_file) {
       // Record that the bloom filter was useful.
       RecordTick(table->rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+      PERF_COUNTER_ADD(bloom_filter_useful_count, 1);
     }
     filter_entry.Release(table->rep_->table_options.block_cache.get());
     return use_file;
@@ -438,6 +507,26 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the compression dictionary, data blocks compressed with it could not be read without it.
+  {
+    BlockHandle compression_dict_handle;
+    if (FindMetaBlock(meta_iter.get(), kCompressionDictBlock, &compression_dict_handle).ok()) {
+      BlockContents compression_dict_block;
+      s = ReadBlockContents(
+          rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+          compression_dict_handle, &compression_dict_block, rep->ioptions.env, rep->mem_tracker,
+          false /* do_uncompress */);
+      if (!s.ok()) {
+        return s;
+      }
+      Slice input = compression_dict_block.data;
+      if (!GetFixed64(&input, &rep->compression_dict_offset)) {
+        return STATUS(Corruption, "Bad compression dictionary block");
+      }
+      rep->compression_dict = input.ToBuffer();
+    }
+  }
+
   // Read the properties
   bool found_properties_block = true;
   s = SeekToPropertiesBlock(meta_iter.get(), &found_properties_block);
@@ -478,9 +567,12 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
         BlockBasedTablePropertyNames::kPrefixFiltering, rep->ioptions.info_log);
   }
 
+  rep->pin_data_index = table_options.pin_top_level_index &&
+                        rep->IndexTypeOnFile() == IndexType::kMultiLevelBinarySearch;
+
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
     // Will use block cache for data index access?
-    if (table_options.cache_index_and_filter_blocks) {
+    if (table_options.cache_index_and_filter_blocks && !rep->pin_data_index) {
       DCHECK_ONLY_NOTNULL(table_options.block_cache.get());
       // Hack: Call NewIndexIterator() to implicitly add index to the
       // block_cache
@@ -688,7 +780,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -732,7 +824,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -760,7 +852,7 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -769,7 +861,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -1024,7 +1116,7 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
   Cache* const block_cache = rep_->table_options.block_cache.get();
 
   if (block_cache && (rep_->data_index_load_mode == DataIndexLoadMode::USE_CACHE ||
-      rep_->table_options.cache_index_and_filter_blocks)) {
+      (rep_->table_options.cache_index_and_filter_blocks && !rep_->pin_data_index))) {
     char cache_key[block_based_table::kCacheKeyBufferSize];
     auto key = GetCacheKey(rep_->base_reader_with_cache_prefix->cache_key_prefix,
         rep_->footer.index_handle(), cache_key);
@@ -1096,8 +1188,66 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
 // into an iterator over the contents of the corresponding block.
 // If input_iter is null, new a iterator
 // If input_iter is not null, update this iter and return it
+void BlockBasedTable::ReadaheadIfSequential(
+    const ReadOptions& ro, const BlockHandle& handle, RandomAccessFileReader* reader,
+    ReadaheadState* state) {
+  const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+  if (state->num_sequential_reads > 0 && block_end == state->next_block_offset) {
+    // Same block as the last one, it was already counted.
+    return;
+  }
+  if (handle.offset() != state->next_block_offset) {
+    // Not a sequential read, previous readahead will not be used anymore.
+    FinishReadahead(state);
+    state->num_sequential_reads = 0;
+    state->readahead_start = state->readahead_end = 0;
+  }
+  ++state->num_sequential_reads;
+  state->next_block_offset = block_end;
+
+  Statistics* statistics = rep_->ioptions.statistics;
+  if (handle.offset() < state->readahead_end) {
+    RecordTick(statistics, READAHEAD_BYTES_USED,
+               std::min(block_end, state->readahead_end) -
+                   std::max(handle.offset(), state->readahead_start));
+  }
+
+  // Keep at least half of the readahead window in front of the reads, so that the window is not
+  // requested again for every block.
+  if (state->num_sequential_reads < ro.readahead_trigger_reads ||
+      state->readahead_end >= block_end + ro.readahead_size / 2) {
+    return;
+  }
+  if (state->file_size == 0) {
+    auto file_size = reader->file()->Size();
+    if (!file_size.ok()) {
+      return;
+    }
+    state->file_size = *file_size;
+  }
+  const uint64_t start = std::max(block_end, state->readahead_end);
+  const uint64_t end = std::min<uint64_t>(block_end + ro.readahead_size, state->file_size);
+  if (start >= end) {
+    return;
+  }
+  reader->file()->Readahead(start, end - start);
+  if (start != state->readahead_end) {
+    state->readahead_start = start;
+  }
+  state->readahead_end = end;
+}
+
+void BlockBasedTable::FinishReadahead(ReadaheadState* state) {
+  const uint64_t read_end = std::max(state->next_block_offset, state->readahead_start);
+  if (state->readahead_end > read_end) {
+    RecordTick(rep_->ioptions.statistics, READAHEAD_BYTES_WASTED,
+               state->readahead_end - read_end);
+  }
+}
+
 InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
-    const Slice& index_value, BlockType block_type, BlockIter* input_iter) {
+    const Slice& index_value, BlockType block_type, BlockIter* input_iter,
+    ReadaheadState* readahead) {
   PERF_TIMER_GUARD(new_table_block_iter_nanos);
 
   const bool no_io = (ro.read_tier == kBlockCacheTier);
@@ -1122,6 +1272,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  const Slice compression_dict = rep_->CompressionDictFor(block_type, handle);
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1142,21 +1293,25 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, block_type, rep_->mem_tracker, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
+      if (readahead) {
+        ReadaheadIfSequential(ro, handle, reader->reader.get(), readahead);
+      }
       std::unique_ptr<Block> raw_block;
       {
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            rep_->mem_tracker, block_cache_compressed == nullptr, compression_dict);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                rep_->table_options.format_version, rep_->mem_tracker,
+                                compression_dict);
       }
     }
   }
@@ -1172,10 +1327,13 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         return NewErrorInternalIterator(STATUS(Incomplete, "no blocking io"));
       }
     }
+    if (readahead) {
+      ReadaheadIfSequential(ro, handle, reader->reader.get(), readahead);
+    }
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, true /* do_uncompress */, compression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1320,6 +1478,7 @@ bool BlockBasedTable::NonBlockBasedFilterKeyMayMatch(FilterBlockReader* filter,
     return true;
   }
   RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_CHECKED);
+  PERF_COUNTER_ADD(bloom_filter_checked_count, 1);
   if (!filter->KeyMayMatch(filter_key)) {
     return false;
   }
@@ -1350,6 +1509,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
   // First check non block-based filter.
   if (!is_block_based_filter && !NonBlockBasedFilterKeyMayMatch(filter, filter_key)) {
     RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+    PERF_COUNTER_ADD(bloom_filter_useful_count, 1);
   } else {
 
     // Either filter is block-based or key may match.
@@ -1365,6 +1525,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
 
         if (!skip_filters && is_block_based_filter) {
           RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_CHECKED);
+          PERF_COUNTER_ADD(bloom_filter_checked_count, 1);
           BlockHandle data_block_handle;
           const bool absent_from_filter =
               data_block_handle.DecodeFrom(&data_block_handle_encoded).ok()
@@ -1375,6 +1536,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
             // TODO: think about interaction with Merge. If a user key cannot
             // cross one data block, we should be fine.
             RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+            PERF_COUNTER_ADD(bloom_filter_useful_count, 1);
             break;
           }
         }
@@ -1482,7 +1644,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
   Slice ckey;
 
   s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker);
+      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker,
+      Slice() /* compression_dict */);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1499,17 +1662,7 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
 //  5. index_type
 Status BlockBasedTable::CreateDataBlockIndexReader(
     std::unique_ptr<IndexReader>* index_reader, InternalIterator* preloaded_meta_index_iter) {
-  // Some old version of block-based tables don't have index type present in
-  // table properties. If that's the case we can safely use the kBinarySearch.
-  auto index_type_on_file = IndexType::kBinarySearch;
-  if (rep_->table_properties) {
-    auto& props = rep_->table_properties->user_collected_properties;
-    auto pos = props.find(BlockBasedTablePropertyNames::kIndexType);
-    if (pos != props.end()) {
-      index_type_on_file = static_cast<IndexType>(
-          DecodeFixed32(pos->second.c_str()));
-    }
-  }
+  auto index_type_on_file = rep_->IndexTypeOnFile();
 
   auto file = rep_->base_reader_with_cache_prefix->reader.get();
   auto env = rep_->ioptions.env;
@@ -86,15 +86,24 @@ YB_DEFINE_ENUM(BlockType, (kData)(kIndex));
 // hashed components of key for filtering.
 // BloomFilterAwareFileFilter ignores an SST file completely if there are no keys with the same
 // hashed components as the key specified in constructor.
+// Files whose key range does not include any key with the same filter key (the hashed components
+// prefix for DocDB) are ignored without looking into the bloom filter.
 class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
  public:
-  BloomFilterAwareFileFilter(const ReadOptions& read_options, const Slice& user_key);
+  BloomFilterAwareFileFilter(
+      const ReadOptions& read_options, const Slice& user_key,
+      const FilterPolicy::KeyTransformer* filter_key_transformer);
 
   bool Filter(TableReader* reader) const override;
 
+  bool KeyRangeMayMatch(
+      const Slice& smallest_user_key, const Slice& largest_user_key) const override;
+
  private:
   const ReadOptions read_options_;
   const std::string user_key_;
+  // Prefix of user_key_ that is shared by all keys with the same filter key.
+  const std::string filter_key_;
 };
 
 // A Table is a sorted map from strings to strings.  Tables are
@@ -178,10 +187,14 @@ class BlockBasedTable : public TableReader {
   // convert SST file to a human readable form
   Status DumpTable(WritableFile* out_file) override;
 
+  // Sequential read tracking of a data block iterator, used for readahead.
+  struct ReadaheadState;
+
   // input_iter: if it is not null, update this one and return it as Iterator
+  // readahead: if it is not null, used to read ahead when data blocks are read sequentially.
   InternalIterator* NewDataBlockIterator(
       const ReadOptions& ro, const Slice& index_value, BlockType block_type,
-      BlockIter* input_iter = nullptr);
+      BlockIter* input_iter = nullptr, ReadaheadState* readahead = nullptr);
 
   const ImmutableCFOptions& ioptions();
 
@@ -247,7 +260,7 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -262,7 +275,7 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker, const Slice& compression_dict);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -283,6 +296,15 @@ class BlockBasedTable : public TableReader {
 
   bool NonBlockBasedFilterKeyMayMatch(FilterBlockReader* filter, const Slice& filter_key) const;
 
+  // Called before reading the data block with the given handle from the file. Reads ahead when
+  // enough adjacent blocks were read from the file. Calling it again for the last block is a no-op.
+  void ReadaheadIfSequential(
+      const ReadOptions& ro, const BlockHandle& handle, RandomAccessFileReader* reader,
+      ReadaheadState* state);
+
+  // Accounts readahead bytes that were not read, when the sequential read stops.
+  void FinishReadahead(ReadaheadState* state);
+
   // Read the meta block from sst.
   static Status ReadMetaBlock(Rep* rep, std::unique_ptr<Block>* meta_block,
                               std::unique_ptr<InternalIterator>* iter);
@@ -298,7 +298,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -1681,6 +1681,83 @@ TEST_F(BlockBasedTableTest, BlockCacheDisabledTest) {
 
 // Due to the difficulities of the intersaction between statistics, this test
 // only tests the case when "index block is put to block cache"
+TEST_F(BlockBasedTableTest, PinnedTopLevelIndex) {
+  Options options;
+  options.create_if_missing = true;
+  options.statistics = CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1024 / FLAGS_cache_single_touch_ratio);
+  table_options.cache_index_and_filter_blocks = true;
+  table_options.index_type = IndexType::kMultiLevelBinarySearch;
+  table_options.pin_top_level_index = true;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+
+  TableConstructor c(BytewiseComparator());
+  c.Add("key", "value");
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+  auto* reader = dynamic_cast<BlockBasedTable*>(c.GetTableReader());
+  ASSERT_FALSE(reader->TEST_index_reader_loaded());
+
+  // Top level index is loaded into the table reader on first access, bypassing the block cache.
+  for (int i = 0; i != 2; ++i) {
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    iter->SeekToFirst();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_TRUE(reader->TEST_index_reader_loaded());
+    BlockCachePropertiesSnapshot props(options.statistics.get());
+    props.AssertIndexBlockStat(0, 0);
+  }
+}
+
+TEST_F(BlockBasedTableTest, CompressionDictionary) {
+  if (!Zlib_Supported()) {
+    fprintf(stderr, "skipping zlib compression tests\n");
+    return;
+  }
+  Random rnd(301);
+  // Values share a random prefix, that is repeated only a few times per data block, so blocks
+  // compressed with a dictionary built from the first blocks should be smaller.
+  const std::string common_prefix = RandomString(&rnd, 200);
+  std::vector<uint64_t> data_sizes;
+  for (uint32_t max_dict_bytes : {0U, 4096U}) {
+    Options options;
+    options.compression = kZlibCompression;
+    options.compression_opts.max_dict_bytes = max_dict_bytes;
+    BlockBasedTableOptions table_options;
+    table_options.block_size = 1024;
+    options.table_factory.reset(new BlockBasedTableFactory(table_options));
+
+    TableConstructor c(BytewiseComparator());
+    for (int i = 0; i != 1000; ++i) {
+      c.Add("k" + std::to_string(10000 + i), common_prefix + std::to_string(i));
+    }
+    std::vector<std::string> keys;
+    stl_wrappers::KVMap kvmap;
+    const ImmutableCFOptions ioptions(options);
+    c.Finish(options, ioptions, table_options,
+             GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+    // Check that all blocks could be read back, including ones compressed with the dictionary.
+    unique_ptr<InternalIterator> iter(c.NewIterator());
+    iter->SeekToFirst();
+    for (const auto& kv : kvmap) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(kv.first, iter->key().ToBuffer());
+      ASSERT_EQ(kv.second, iter->value().ToBuffer());
+      iter->Next();
+    }
+    ASSERT_FALSE(iter->Valid());
+    ASSERT_OK(iter->status());
+    data_sizes.push_back(c.GetTableProperties().data_size);
+  }
+  ASSERT_LT(data_sizes[1], data_sizes[0] * 3 / 4);
+}
+
 TEST_F(BlockBasedTableTest, FilterBlockInBlockCache) {
   // -- Table construction
   Options options;
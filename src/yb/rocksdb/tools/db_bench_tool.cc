@@ -74,6 +74,7 @@
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/rocksdb/util/statistics.h"
 #include "yb/rocksdb/util/testutil.h"
 #include "yb/rocksdb/util/xxhash.h"
@@ -652,6 +653,14 @@ DEFINE_uint64(delayed_write_rate, 8388608u,
 DEFINE_bool(allow_concurrent_memtable_write, false,
             "Allow multi-writers to update mem tables in parallel.");
 
+DEFINE_uint64(memtable_insert_threads_per_batch, 1,
+              "Maximum number of threads inserting entries of one write batch into the memtable, "
+              "requires allow_concurrent_memtable_write. Use with a large batch_size to measure "
+              "parallel memtable insert of a single writer.");
+
+DEFINE_uint64(memtable_insert_min_entries_per_thread, 256,
+              "Minimum number of write batch entries inserted by each memtable insert thread.");
+
 DEFINE_bool(enable_write_thread_adaptive_yield, false,
             "Use a yielding spin loop for brief writer thread waits.");
 
@@ -1566,6 +1575,7 @@ class Benchmark {
  private:
   std::shared_ptr<Cache> cache_;
   std::shared_ptr<Cache> compressed_cache_;
+  std::unique_ptr<yb::ThreadPool> memtable_insert_thread_pool_;
   std::shared_ptr<const FilterPolicy> filter_policy_;
   const SliceTransform* prefix_extractor_;
   DBWithColumnFamilies db_;
@@ -2578,6 +2588,17 @@ class Benchmark {
     options.delayed_write_rate = FLAGS_delayed_write_rate;
     options.allow_concurrent_memtable_write =
         FLAGS_allow_concurrent_memtable_write;
+    if (FLAGS_memtable_insert_threads_per_batch > 1) {
+      if (!memtable_insert_thread_pool_) {
+        CHECK_OK(yb::ThreadPoolBuilder("memtable_insert")
+                     .set_max_threads(static_cast<int>(FLAGS_memtable_insert_threads_per_batch))
+                     .Build(&memtable_insert_thread_pool_));
+      }
+      options.memtable_insert_thread_pool = memtable_insert_thread_pool_.get();
+      options.max_memtable_insert_threads_per_batch = FLAGS_memtable_insert_threads_per_batch;
+      options.min_memtable_insert_entries_per_thread =
+          FLAGS_memtable_insert_min_entries_per_thread;
+    }
     options.enable_write_thread_adaptive_yield =
         FLAGS_enable_write_thread_adaptive_yield;
     options.write_thread_max_yield_usec = FLAGS_write_thread_max_yield_usec;
@@ -675,6 +675,126 @@ TEST_F(CacheTest, ApplyToAllCacheEntiresTest) {
   ASSERT_TRUE(inserted == callback_state);
 }
 
+TEST_F(CacheTest, ClockCacheHitAndMiss) {
+  auto cache = NewClockCache(kCacheSize, kNumShardBits);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+
+  ASSERT_OK(Insert(cache, 100, 101));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(-1, Lookup(cache, 200));
+
+  ASSERT_OK(Insert(cache, 200, 201));
+  ASSERT_EQ(101, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+
+  ASSERT_OK(Insert(cache, 100, 102));
+  ASSERT_EQ(102, Lookup(cache, 100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(100, deleted_keys_[0]);
+  ASSERT_EQ(101, deleted_values_[0]);
+
+  Erase(cache, 100);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+  ASSERT_EQ(201, Lookup(cache, 200));
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(1U, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockCacheEntriesArePinned) {
+  auto cache = NewClockCache(kCacheSize, 0);
+  ASSERT_OK(Insert(cache, 100, 101));
+  Cache::Handle* h1 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(101, DecodeValue(cache->Value(h1)));
+  ASSERT_EQ(1U, cache->GetPinnedUsage());
+
+  // Replaced and erased entries are out of the cache, but are kept until released.
+  ASSERT_OK(Insert(cache, 100, 102));
+  Cache::Handle* h2 = cache->Lookup(EncodeKey(100), kTestQueryId);
+  ASSERT_EQ(102, DecodeValue(cache->Value(h2)));
+  Erase(cache, 100);
+  ASSERT_EQ(-1, Lookup(cache, 100));
+  ASSERT_EQ(0U, deleted_keys_.size());
+  ASSERT_EQ(0U, cache->GetUsage());
+
+  cache->Release(h1);
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(101, deleted_values_[0]);
+  cache->Release(h2);
+  ASSERT_EQ(2U, deleted_keys_.size());
+  ASSERT_EQ(102, deleted_values_[1]);
+}
+
+TEST_F(CacheTest, ClockCacheScanResistance) {
+  constexpr int kCapacity = 10;
+  constexpr QueryId kScanQueryId = kTestQueryId + 1;
+  auto cache = NewClockCache(kCapacity, 0);
+
+  // Fill the cache with entries that are read by several queries.
+  for (int i = 0; i != kCapacity; ++i) {
+    ASSERT_OK(Insert(cache, i, i + 1));
+    for (int j = 0; j != 5; ++j) {
+      ASSERT_EQ(i + 1, Lookup(cache, i, kTestQueryId + 2 + j));
+    }
+  }
+
+  // A scan reads each block once, the blocks it brings are not admitted to the full cache.
+  for (int i = 100; i != 100 + 10 * kCapacity; ++i) {
+    ASSERT_EQ(-1, Lookup(cache, i, kScanQueryId));
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(cache->Insert(EncodeKey(i), kScanQueryId, EncodeValue(i + 1), 1,
+                            &CacheTest::Deleter, &handle));
+    // Not admitted entry is still returned to the caller.
+    ASSERT_NE(nullptr, handle);
+    ASSERT_EQ(i + 1, DecodeValue(cache->Value(handle)));
+    cache->Release(handle);
+  }
+  ASSERT_EQ(100U, deleted_keys_.size());
+
+  for (int i = 0; i != kCapacity; ++i) {
+    ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, i, i + 1));
+  }
+  ASSERT_EQ(10U, cache->GetUsage());
+}
+
+TEST_F(CacheTest, ClockCacheAdmitsFrequentKeys) {
+  constexpr int kCapacity = 10;
+  auto cache = NewClockCache(kCapacity, 0);
+  for (int i = 0; i != kCapacity; ++i) {
+    ASSERT_OK(Insert(cache, i, i + 1));
+  }
+
+  // Keys that were requested more often than the cached ones replace them.
+  for (int i = 100; i != 100 + kCapacity; ++i) {
+    ASSERT_EQ(-1, Lookup(cache, i));
+    ASSERT_EQ(-1, Lookup(cache, i));
+    ASSERT_OK(Insert(cache, i, i + 1));
+    ASSERT_LE(cache->GetUsage(), 10U);
+  }
+  for (int i = 100; i != 100 + kCapacity; ++i) {
+    ASSERT_EQ(i + 1, Lookup(cache, i));
+  }
+  ASSERT_EQ(10U, deleted_keys_.size());
+}
+
+TEST_F(CacheTest, ClockCacheReplaceInFullCache) {
+  constexpr int kCapacity = 10;
+  auto cache = NewClockCache(kCapacity, 0);
+  for (int i = 0; i != kCapacity; ++i) {
+    ASSERT_OK(Insert(cache, i, i + 1));
+  }
+
+  // The replaced entry is the next one to be evicted, it should be removed only once.
+  ASSERT_OK(Insert(cache, 0, 100));
+  ASSERT_EQ(1U, deleted_keys_.size());
+  ASSERT_EQ(0, deleted_keys_[0]);
+  ASSERT_EQ(1, deleted_values_[0]);
+  ASSERT_EQ(100, Lookup(cache, 0));
+  for (int i = 1; i != kCapacity; ++i) {
+    ASSERT_EQ(i + 1, Lookup(cache, i));
+  }
+  ASSERT_EQ(10U, cache->GetUsage());
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
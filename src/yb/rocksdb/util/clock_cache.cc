@@ -0,0 +1,823 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+
+#include <glog/logging.h>
+
+#include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/autovector.h"
+#include "yb/rocksdb/util/hash.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/statistics.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
+
+namespace rocksdb {
+
+namespace {
+
+// CLOCK cache implementation with TinyLFU admission.
+//
+// Each shard keeps its entries in a hash table and on a circular list walked by the clock hand.
+// Lookups take the shard lock in shared mode and only modify atomic fields of the entry, so they
+// don't serialize with each other. Insertions, erasures and evictions take the lock in exclusive
+// mode.
+//
+// An entry is referenced by the cache while it is in the hash table, and by every handle returned
+// to the caller. Since a lookup could only obtain a new reference to an entry that is in the hash
+// table, an entry that is out of the table is freed by whoever drops its last reference, without
+// taking the lock.
+//
+// Scan resistance: the clock usage counter of an entry is only raised by lookups of queries other
+// than the one that inserted it, such lookups also move the entry to the multi touch pool. So a
+// scan touching a block many times still leaves it as the first candidate for eviction. In
+// addition, when the shard is full, a new entry is only admitted if it was requested more
+// frequently than the entry it would evict, according to an approximate frequency sketch of recent
+// lookups. Rejected entries are still returned to the caller, but are not added to the cache and
+// are freed on release.
+
+constexpr uint8_t kMaxUsage = 3;
+
+struct ClockHandle {
+  void* value;
+  void (*deleter)(const Slice&, void* value);
+  ClockHandle* next_hash;
+  // Neighbours in the clock list, only modified under the exclusive lock.
+  ClockHandle* next;
+  ClockHandle* prev;
+  size_t charge;
+  size_t key_length;
+  uint32_t hash;
+  // Number of references, the cache itself is counted as 1 while the entry is in the hash table.
+  std::atomic<uint32_t> refs;
+  // Modified only under the exclusive lock.
+  bool in_cache;
+  std::atomic<uint8_t> usage;
+  // Query id that added the value to the cache, or kInMultiTouchId.
+  std::atomic<QueryId> query_id;
+  char key_data[1];
+
+  Slice key() const {
+    return Slice(key_data, key_length);
+  }
+
+  SubCacheType GetSubCacheType() const {
+    return query_id.load(std::memory_order_relaxed) == kInMultiTouchId ? MULTI_TOUCH
+                                                                        : SINGLE_TOUCH;
+  }
+
+  void Free(yb::CacheMetrics* metrics) {
+    (*deleter)(key(), value);
+    if (metrics != nullptr) {
+      if (GetSubCacheType() == MULTI_TOUCH) {
+        metrics->multi_touch_cache_usage->DecrementBy(charge);
+      } else {
+        metrics->single_touch_cache_usage->DecrementBy(charge);
+      }
+      metrics->cache_usage->DecrementBy(charge);
+    }
+    this->~ClockHandle();
+    delete[] reinterpret_cast<char*>(this);
+  }
+};
+
+// Count-min sketch of 4 bit counters, used to estimate how often a key was looked up recently.
+// Counters are halved after a number of increments proportional to the sketch size, so old
+// accesses are forgotten. Updates are racy by design, an occasionally lost increment does not
+// matter for admission decisions.
+class FrequencySketch {
+ public:
+  FrequencySketch() {
+    for (auto& counter : counters_) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void Increment(uint32_t hash) {
+    for (size_t row = 0; row != kRows; ++row) {
+      auto& counter = counters_[Index(hash, row)];
+      auto value = counter.load(std::memory_order_relaxed);
+      if (value < kMaxCounter) {
+        counter.store(value + 1, std::memory_order_relaxed);
+      }
+    }
+    if (additions_.fetch_add(1, std::memory_order_relaxed) + 1 == kSampleSize) {
+      additions_.store(0, std::memory_order_relaxed);
+      for (auto& counter : counters_) {
+        counter.store(counter.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  uint8_t Estimate(uint32_t hash) const {
+    uint8_t result = kMaxCounter;
+    for (size_t row = 0; row != kRows; ++row) {
+      result = std::min(result, counters_[Index(hash, row)].load(std::memory_order_relaxed));
+    }
+    return result;
+  }
+
+ private:
+  static constexpr size_t kRows = 4;
+  static constexpr size_t kWidthBits = 12;
+  static constexpr size_t kWidth = 1 << kWidthBits;
+  static constexpr uint8_t kMaxCounter = 15;
+  static constexpr size_t kSampleSize = 10 * kWidth;
+
+  static size_t Index(uint32_t hash, size_t row) {
+    // Derive a separate hash for each row by rehashing with a row specific multiplier.
+    static constexpr uint64_t kSeeds[kRows] = {
+        0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+        0xcbf29ce484222325ULL };
+    const uint64_t h = (hash + 1) * kSeeds[row];
+    return row * kWidth + ((h >> 32) & (kWidth - 1));
+  }
+
+  std::atomic<uint8_t> counters_[kRows * kWidth];
+  std::atomic<size_t> additions_{0};
+};
+
+class ClockHandleTable {
+ public:
+  ClockHandleTable() { Resize(); }
+
+  ~ClockHandleTable() {
+    delete[] list_;
+  }
+
+  ClockHandle* Lookup(const Slice& key, uint32_t hash) const {
+    return *FindPointer(key, hash);
+  }
+
+  // Inserts h into the table, returns the replaced entry with the same key if any.
+  ClockHandle* Insert(ClockHandle* h) {
+    ClockHandle** ptr = FindPointer(h->key(), h->hash);
+    ClockHandle* old = *ptr;
+    h->next_hash = (old == nullptr ? nullptr : old->next_hash);
+    *ptr = h;
+    if (old == nullptr) {
+      ++elems_;
+      if (elems_ > length_) {
+        Resize();
+      }
+    }
+    return old;
+  }
+
+  ClockHandle* Remove(const Slice& key, uint32_t hash) {
+    ClockHandle** ptr = FindPointer(key, hash);
+    ClockHandle* result = *ptr;
+    if (result != nullptr) {
+      *ptr = result->next_hash;
+      --elems_;
+    }
+    return result;
+  }
+
+ private:
+  ClockHandle** FindPointer(const Slice& key, uint32_t hash) const {
+    ClockHandle** ptr = &list_[hash & (length_ - 1)];
+    while (*ptr != nullptr && ((*ptr)->hash != hash || key != (*ptr)->key())) {
+      ptr = &(*ptr)->next_hash;
+    }
+    return ptr;
+  }
+
+  void Resize() {
+    uint32_t new_length = 16;
+    while (new_length < elems_ * 1.5) {
+      new_length *= 2;
+    }
+    ClockHandle** new_list = new ClockHandle*[new_length];
+    memset(new_list, 0, sizeof(new_list[0]) * new_length);
+    for (uint32_t i = 0; i < length_; i++) {
+      ClockHandle* h = list_[i];
+      while (h != nullptr) {
+        ClockHandle* next = h->next_hash;
+        ClockHandle** ptr = &new_list[h->hash & (new_length - 1)];
+        h->next_hash = *ptr;
+        *ptr = h;
+        h = next;
+      }
+    }
+    delete[] list_;
+    list_ = new_list;
+    length_ = new_length;
+  }
+
+  uint32_t length_ = 0;
+  uint32_t elems_ = 0;
+  ClockHandle** list_ = nullptr;
+};
+
+class ClockHandleDeleter {
+ public:
+  explicit ClockHandleDeleter(yb::CacheMetrics* metrics) : metrics_(metrics) {}
+
+  void Add(ClockHandle* handle) {
+    total_charge_ += handle->charge;
+    handles_.push_back(handle);
+  }
+
+  size_t TotalCharge() const {
+    return total_charge_;
+  }
+
+  ~ClockHandleDeleter() {
+    for (ClockHandle* handle : handles_) {
+      handle->Free(metrics_);
+    }
+  }
+
+ private:
+  yb::CacheMetrics* metrics_;
+  size_t total_charge_ = 0;
+  autovector<ClockHandle*> handles_;
+};
+
+// A single shard of sharded cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard() {}
+  ~ClockCacheShard();
+
+  void SetCapacity(size_t capacity);
+  void SetStrictCapacityLimit(bool strict_capacity_limit);
+
+  void SetMetrics(std::shared_ptr<yb::CacheMetrics> metrics) {
+    metrics_ = std::move(metrics);
+  }
+
+  Status Insert(const Slice& key, uint32_t hash, QueryId query_id,
+                void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
+                Cache::Handle** handle, Statistics* statistics);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash, QueryId query_id,
+                        Statistics* statistics);
+  void Release(Cache::Handle* handle);
+  void Erase(const Slice& key, uint32_t hash);
+  size_t Evict(size_t required);
+
+  size_t GetUsage() const {
+    return usage_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetPinnedUsage() const;
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe);
+
+ private:
+  void ClockAppend(ClockHandle* e);
+  void ClockRemove(ClockHandle* e);
+
+  // Removes e from the table and the clock list and drops the reference of the cache.
+  // Adds e to deleted if it was the last reference.
+  void RemoveFromCache(ClockHandle* e, ClockHandleDeleter* deleted);
+
+  // Moves the clock hand until it points to an entry that could be evicted, decrementing usage
+  // counters of entries it passes. Returns nullptr if all entries are referenced externally.
+  ClockHandle* FindVictim();
+
+  // Evicts entries until usage + charge fits into the capacity, or all remaining entries are
+  // referenced externally.
+  void EvictToFit(size_t charge, ClockHandleDeleter* deleted);
+
+  void RecordInsertStatistics(Statistics* statistics, SubCacheType subcache_type, size_t charge);
+
+  size_t capacity_ = 0;
+  bool strict_capacity_limit_ = false;
+
+  // mutex_ protects the table, the clock list and in_cache flags of entries.
+  mutable port::RWMutex mutex_;
+  ClockHandleTable table_;
+  ClockHandle* hand_ = nullptr;
+  size_t num_entries_ = 0;
+
+  // Total charge of entries in the table.
+  std::atomic<size_t> usage_{0};
+
+  FrequencySketch sketch_;
+
+  std::shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+ClockCacheShard::~ClockCacheShard() {
+  ClockHandleDeleter deleted(metrics_.get());
+  WriteLock l(&mutex_);
+  while (hand_ != nullptr) {
+    RemoveFromCache(hand_, &deleted);
+  }
+}
+
+void ClockCacheShard::ClockAppend(ClockHandle* e) {
+  if (hand_ == nullptr) {
+    e->next = e->prev = e;
+    hand_ = e;
+  } else {
+    // Insert just behind the hand, so the new entry is the last one to be visited.
+    e->next = hand_;
+    e->prev = hand_->prev;
+    e->prev->next = e;
+    hand_->prev = e;
+  }
+  ++num_entries_;
+}
+
+void ClockCacheShard::ClockRemove(ClockHandle* e) {
+  if (e->next == e) {
+    hand_ = nullptr;
+  } else {
+    if (hand_ == e) {
+      hand_ = e->next;
+    }
+    e->prev->next = e->next;
+    e->next->prev = e->prev;
+  }
+  e->next = e->prev = nullptr;
+  --num_entries_;
+}
+
+void ClockCacheShard::RemoveFromCache(ClockHandle* e, ClockHandleDeleter* deleted) {
+  DCHECK(e->in_cache);
+  table_.Remove(e->key(), e->hash);
+  ClockRemove(e);
+  e->in_cache = false;
+  usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+  if (e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    deleted->Add(e);
+  }
+}
+
+ClockHandle* ClockCacheShard::FindVictim() {
+  // Each full turn of the hand decrements usage of every entry, so after kMaxUsage + 1 turns
+  // without finding a victim all entries are referenced externally.
+  for (size_t steps = (kMaxUsage + 1) * num_entries_ + 1; hand_ != nullptr && steps > 0;
+       --steps) {
+    ClockHandle* e = hand_;
+    hand_ = e->next;
+    if (e->refs.load(std::memory_order_acquire) > 1) {
+      continue;
+    }
+    auto usage = e->usage.load(std::memory_order_relaxed);
+    if (usage > 0) {
+      e->usage.store(usage - 1, std::memory_order_relaxed);
+      continue;
+    }
+    return e;
+  }
+  return nullptr;
+}
+
+void ClockCacheShard::EvictToFit(size_t charge, ClockHandleDeleter* deleted) {
+  while (GetUsage() + charge > capacity_) {
+    ClockHandle* victim = FindVictim();
+    if (victim == nullptr) {
+      break;
+    }
+    RemoveFromCache(victim, deleted);
+  }
+}
+
+void ClockCacheShard::SetCapacity(size_t capacity) {
+  ClockHandleDeleter deleted(metrics_.get());
+  WriteLock l(&mutex_);
+  capacity_ = capacity;
+  EvictToFit(0, &deleted);
+}
+
+void ClockCacheShard::SetStrictCapacityLimit(bool strict_capacity_limit) {
+  WriteLock l(&mutex_);
+  strict_capacity_limit_ = strict_capacity_limit;
+}
+
+size_t ClockCacheShard::GetPinnedUsage() const {
+  ReadLock l(&mutex_);
+  size_t result = 0;
+  ClockHandle* e = hand_;
+  for (size_t i = 0; i != num_entries_; ++i, e = e->next) {
+    if (e->refs.load(std::memory_order_relaxed) > 1) {
+      result += e->charge;
+    }
+  }
+  return result;
+}
+
+void ClockCacheShard::ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) {
+  if (thread_safe) {
+    mutex_.ReadLock();
+  }
+  ClockHandle* e = hand_;
+  for (size_t i = 0; i != num_entries_; ++i, e = e->next) {
+    callback(e->value, e->charge);
+  }
+  if (thread_safe) {
+    mutex_.ReadUnlock();
+  }
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash, QueryId query_id,
+                                       Statistics* statistics) {
+  sketch_.Increment(hash);
+  ClockHandle* e;
+  {
+    ReadLock l(&mutex_);
+    e = table_.Lookup(key, hash);
+    if (e != nullptr) {
+      e->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (e != nullptr) {
+    auto inserted_by = e->query_id.load(std::memory_order_relaxed);
+    if (inserted_by == kInMultiTouchId) {
+      auto usage = e->usage.load(std::memory_order_relaxed);
+      if (usage < kMaxUsage) {
+        e->usage.store(usage + 1, std::memory_order_relaxed);
+      }
+    } else if (inserted_by != query_id &&
+               e->query_id.compare_exchange_strong(inserted_by, kInMultiTouchId)) {
+      // Touched by another query, so move it to the multi touch pool.
+      e->usage.store(1, std::memory_order_relaxed);
+      if (metrics_) {
+        metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
+        metrics_->single_touch_cache_usage->DecrementBy(e->charge);
+      }
+    }
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_HIT);
+      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+      if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+      } else {
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      }
+    }
+  } else if (statistics != nullptr) {
+    RecordTick(statistics, BLOCK_CACHE_MISS);
+  }
+
+  if (metrics_ != nullptr) {
+    metrics_->lookups->Increment();
+    if (e != nullptr) {
+      metrics_->cache_hits->Increment();
+    } else {
+      metrics_->cache_misses->Increment();
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::Release(Cache::Handle* handle) {
+  if (handle == nullptr) {
+    return;
+  }
+  ClockHandle* e = reinterpret_cast<ClockHandle*>(handle);
+  // Only an entry that is out of the table could lose its last reference here, and such an entry
+  // could not be found by lookups anymore. So it is safe to free it without the lock.
+  if (e->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    e->Free(metrics_.get());
+  }
+}
+
+size_t ClockCacheShard::Evict(size_t required) {
+  ClockHandleDeleter evicted(metrics_.get());
+  WriteLock l(&mutex_);
+  EvictToFit(required, &evicted);
+  return evicted.TotalCharge();
+}
+
+void ClockCacheShard::RecordInsertStatistics(
+    Statistics* statistics, SubCacheType subcache_type, size_t charge) {
+  if (statistics == nullptr) {
+    return;
+  }
+  RecordTick(statistics, BLOCK_CACHE_ADD);
+  RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
+  if (subcache_type == SubCacheType::SINGLE_TOUCH) {
+    RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_ADD);
+    RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_WRITE, charge);
+  } else {
+    RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_ADD);
+    RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_WRITE, charge);
+  }
+}
+
+Status ClockCacheShard::Insert(const Slice& key, uint32_t hash, QueryId query_id,
+                               void* value, size_t charge,
+                               void (*deleter)(const Slice& key, void* value),
+                               Cache::Handle** handle, Statistics* statistics) {
+  // Allocate the memory here outside of the mutex.
+  char* memory = new char[sizeof(ClockHandle) - 1 + key.size()];
+  ClockHandle* e = new (memory) ClockHandle;
+  e->value = value;
+  e->deleter = deleter;
+  e->next_hash = e->next = e->prev = nullptr;
+  e->charge = charge;
+  e->key_length = key.size();
+  e->hash = hash;
+  // One reference from the cache, one for the returned handle.
+  e->refs.store(handle == nullptr ? 1 : 2, std::memory_order_relaxed);
+  e->in_cache = false;
+  e->usage.store(0, std::memory_order_relaxed);
+  e->query_id.store(query_id, std::memory_order_relaxed);
+  memcpy(e->key_data, key.data(), key.size());
+
+  ClockHandleDeleter deleted(metrics_.get());
+  Status s;
+  bool admitted = true;
+  {
+    WriteLock l(&mutex_);
+    ClockHandle* old = table_.Lookup(key, hash);
+    // Replacing an entry that is already cached, or inserting an entry touched by another query,
+    // puts the value into the multi touch pool.
+    if (old != nullptr &&
+        (old->GetSubCacheType() == MULTI_TOUCH ||
+         old->query_id.load(std::memory_order_relaxed) != query_id)) {
+      e->query_id.store(kInMultiTouchId, std::memory_order_relaxed);
+    }
+    const bool multi_touch = e->GetSubCacheType() == MULTI_TOUCH;
+
+    if (GetUsage() + charge > capacity_ && !multi_touch) {
+      // TinyLFU admission: only replace the entry the clock would evict next if the new key is
+      // requested more often.
+      ClockHandle* victim = FindVictim();
+      if (victim != nullptr && victim != old &&
+          sketch_.Estimate(hash) <= sketch_.Estimate(victim->hash)) {
+        admitted = false;
+      }
+      if (victim != nullptr) {
+        // FindVictim moved the hand past the victim, move it back so the victim is considered
+        // first by the eviction below.
+        hand_ = victim;
+      }
+    }
+
+    if (admitted) {
+      EvictToFit(charge, &deleted);
+      if (strict_capacity_limit_ && GetUsage() + charge > capacity_) {
+        s = STATUS(Incomplete, "Insert failed due to CLOCK cache being full.");
+      } else {
+        // The old entry could already be evicted by EvictToFit, it is still alive because it was
+        // added to deleted.
+        if (old != nullptr && old->in_cache) {
+          RemoveFromCache(old, &deleted);
+        }
+        table_.Insert(e);
+        ClockAppend(e);
+        e->in_cache = true;
+        usage_.fetch_add(charge, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  if (!s.ok()) {
+    if (handle == nullptr) {
+      (*deleter)(key, value);
+    } else {
+      *handle = nullptr;
+    }
+    e->~ClockHandle();
+    delete[] memory;
+    if (statistics != nullptr) {
+      RecordTick(statistics, BLOCK_CACHE_ADD_FAILURES);
+    }
+    return s;
+  }
+
+  if (metrics_ != nullptr) {
+    if (e->GetSubCacheType() == MULTI_TOUCH) {
+      metrics_->multi_touch_cache_usage->IncrementBy(charge);
+    } else {
+      metrics_->single_touch_cache_usage->IncrementBy(charge);
+    }
+    metrics_->cache_usage->IncrementBy(charge);
+  }
+
+  if (admitted) {
+    RecordInsertStatistics(statistics, e->GetSubCacheType(), charge);
+    if (handle != nullptr) {
+      *handle = reinterpret_cast<Cache::Handle*>(e);
+    }
+  } else if (handle != nullptr) {
+    // Not admitted entry is still usable by the caller, it is freed when the handle is released.
+    e->refs.store(1, std::memory_order_relaxed);
+    *handle = reinterpret_cast<Cache::Handle*>(e);
+  } else {
+    deleted.Add(e);
+  }
+  return Status::OK();
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  ClockHandleDeleter deleted(metrics_.get());
+  WriteLock l(&mutex_);
+  ClockHandle* e = table_.Lookup(key, hash);
+  if (e != nullptr) {
+    RemoveFromCache(e, &deleted);
+  }
+}
+
+constexpr int kDefaultNumShardBits = 4;
+
+class ShardedClockCache : public Cache {
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits, bool strict_capacity_limit)
+      : num_shard_bits_(num_shard_bits),
+        capacity_(capacity),
+        strict_capacity_limit_(strict_capacity_limit),
+        shards_(new ClockCacheShard[NumShards()]) {
+    const size_t per_shard = PerShardCapacity(capacity);
+    for (size_t s = 0; s != NumShards(); ++s) {
+      shards_[s].SetCapacity(per_shard);
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+  }
+
+  virtual ~ShardedClockCache() {
+    delete[] shards_;
+  }
+
+  Status Insert(const Slice& key, QueryId query_id, void* value, size_t charge,
+                void (*deleter)(const Slice& key, void* value),
+                Handle** handle, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    // Queries with no cache query ids are not cached.
+    if (query_id == kNoCacheQueryId) {
+      return Status::OK();
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Insert(
+        key, hash, query_id, value, charge, deleter, handle, statistics);
+  }
+
+  Handle* Lookup(const Slice& key, QueryId query_id, Statistics* statistics) override {
+    DCHECK(IsValidQueryId(query_id));
+    if (query_id == kNoCacheQueryId) {
+      return nullptr;
+    }
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash, query_id, statistics);
+  }
+
+  void Release(Handle* handle) override {
+    if (handle == nullptr) {
+      return;
+    }
+    ClockHandle* h = reinterpret_cast<ClockHandle*>(handle);
+    shards_[Shard(h->hash)].Release(handle);
+  }
+
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  void SetCapacity(size_t capacity) override {
+    MutexLock l(&capacity_mutex_);
+    const size_t per_shard = PerShardCapacity(capacity);
+    for (size_t s = 0; s != NumShards(); ++s) {
+      shards_[s].SetCapacity(per_shard);
+    }
+    capacity_ = capacity;
+  }
+
+  void SetStrictCapacityLimit(bool strict_capacity_limit) override {
+    for (size_t s = 0; s != NumShards(); ++s) {
+      shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+    }
+    strict_capacity_limit_ = strict_capacity_limit;
+  }
+
+  bool HasStrictCapacityLimit() const override {
+    return strict_capacity_limit_;
+  }
+
+  size_t GetCapacity() const override {
+    return capacity_;
+  }
+
+  size_t GetUsage() const override {
+    size_t usage = 0;
+    for (size_t s = 0; s != NumShards(); ++s) {
+      usage += shards_[s].GetUsage();
+    }
+    return usage;
+  }
+
+  size_t GetUsage(Handle* handle) const override {
+    return reinterpret_cast<ClockHandle*>(handle)->charge;
+  }
+
+  size_t GetPinnedUsage() const override {
+    size_t usage = 0;
+    for (size_t s = 0; s != NumShards(); ++s) {
+      usage += shards_[s].GetPinnedUsage();
+    }
+    return usage;
+  }
+
+  SubCacheType GetSubCacheType(Handle* e) const override {
+    return reinterpret_cast<ClockHandle*>(e)->GetSubCacheType();
+  }
+
+  void DisownData() override {
+    shards_ = nullptr;
+  }
+
+  void ApplyToAllCacheEntries(void (*callback)(void*, size_t), bool thread_safe) override {
+    for (size_t s = 0; s != NumShards(); ++s) {
+      shards_[s].ApplyToAllCacheEntries(callback, thread_safe);
+    }
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    metrics_ = std::make_shared<yb::CacheMetrics>(entity);
+    for (size_t s = 0; s != NumShards(); ++s) {
+      shards_[s].SetMetrics(metrics_);
+    }
+  }
+
+  size_t Evict(size_t bytes_to_evict) override {
+    size_t total_evicted = 0;
+    // Start at random shard.
+    auto index = Shard(yb::RandomUniformInt<uint32_t>());
+    for (size_t i = 0; bytes_to_evict > total_evicted && i != NumShards(); ++i) {
+      total_evicted += shards_[index].Evict(bytes_to_evict - total_evicted);
+      index = (index + 1) & (NumShards() - 1);
+    }
+    return total_evicted;
+  }
+
+ private:
+  static uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  static bool IsValidQueryId(QueryId query_id) {
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+  }
+
+  size_t NumShards() const {
+    return static_cast<size_t>(1) << num_shard_bits_;
+  }
+
+  size_t PerShardCapacity(size_t capacity) const {
+    return (capacity + (NumShards() - 1)) / NumShards();
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    // Note, hash >> 32 yields hash in gcc, not the zero we expect!
+    return (num_shard_bits_ > 0) ? (hash >> (32 - num_shard_bits_)) : 0;
+  }
+
+  const int num_shard_bits_;
+  port::Mutex capacity_mutex_;
+  size_t capacity_;
+  bool strict_capacity_limit_;
+  std::atomic<uint64_t> last_id_{0};
+  ClockCacheShard* shards_;
+  std::shared_ptr<yb::CacheMetrics> metrics_;
+};
+
+}  // namespace
+
+shared_ptr<Cache> NewClockCache(size_t capacity) {
+  return NewClockCache(capacity, kDefaultNumShardBits, false);
+}
+
+shared_ptr<Cache> NewClockCache(size_t capacity, int num_shard_bits,
+                                bool strict_capacity_limit) {
+  if (num_shard_bits >= 20) {
+    return nullptr;  // the cache cannot be sharded into too many fine pieces
+  }
+  return std::make_shared<ShardedClockCache>(capacity, num_shard_bits, strict_capacity_limit);
+}
+
+}  // namespace rocksdb
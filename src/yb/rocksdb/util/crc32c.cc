@@ -345,7 +345,75 @@ static inline void Fast_CRC32(uint64_t* l, uint8_t const **p) {
 #endif
 }
 
-template<void (*CRC32)(uint64_t*, uint8_t const**)>
+// Returns a * b modulo the CRC32C polynomial, in the reflected bit order of the CRC.
+static uint32_t MultiplyModP(uint32_t a, uint32_t b) {
+  constexpr uint32_t kPolynomial = 0x82f63b78;
+  uint32_t product = 0;
+  for (uint32_t m = 1U << 31; m != 0; m >>= 1) {
+    if (a & m) {
+      product ^= b;
+    }
+    b = (b & 1) ? (b >> 1) ^ kPolynomial : b >> 1;
+  }
+  return product;
+}
+
+// Returns x^(8 * n) modulo the CRC32C polynomial, i.e. the factor that shifts a CRC register
+// over n zero bytes.
+static uint32_t ShiftFactor(size_t n) {
+  uint32_t factor = 1U << 31; // x^0
+  uint32_t power = 1U << 30; // x^1, squared to x^(2^k) in the loop below.
+  for (size_t bits = n * 8; bits != 0; bits >>= 1) {
+    if (bits & 1) {
+      factor = MultiplyModP(power, factor);
+    }
+    power = MultiplyModP(power, power);
+  }
+  return factor;
+}
+
+uint32_t Combine(uint32_t crc1, uint32_t crc2, size_t size2) {
+  return MultiplyModP(ShiftFactor(size2), crc1) ^ crc2;
+}
+
+#if defined(__SSE4_2__) && defined(__LP64__)
+
+// The crc32 instruction has a latency of 3 cycles and a throughput of one per cycle, so a single
+// dependency chain uses a third of it. Large buffers are processed as 3 interleaved streams of
+// kStripeSize bytes, whose registers are then combined. Combining costs about as much as
+// processing a few hundred bytes, so the stripes are large.
+constexpr size_t kStripeSize = 4096;
+static const uint32_t kStripeShift = ShiftFactor(kStripeSize);
+
+static inline void ThreeWayCRC32(uint64_t* l, uint8_t const **p, const uint8_t* e) {
+  while (static_cast<size_t>(e - *p) >= 3 * kStripeSize) {
+    const uint8_t* a = *p;
+    const uint8_t* b = a + kStripeSize;
+    const uint8_t* c = b + kStripeSize;
+    uint64_t la = *l;
+    uint64_t lb = 0;
+    uint64_t lc = 0;
+    for (const uint8_t* a_end = b; a != a_end; a += 8, b += 8, c += 8) {
+      la = _mm_crc32_u64(la, LE_LOAD64(a));
+      lb = _mm_crc32_u64(lb, LE_LOAD64(b));
+      lc = _mm_crc32_u64(lc, LE_LOAD64(c));
+    }
+    // The register is linear in its initial value, so the register after a, b and c is the one
+    // after a shifted over b and c, xored with the ones of b and c started from 0.
+    *l = MultiplyModP(kStripeShift, MultiplyModP(kStripeShift, static_cast<uint32_t>(la)) ^
+                                    static_cast<uint32_t>(lb)) ^ static_cast<uint32_t>(lc);
+    *p = c;
+  }
+}
+
+#else
+
+static inline void ThreeWayCRC32(uint64_t* l, uint8_t const **p, const uint8_t* e) {
+}
+
+#endif
+
+template<void (*CRC32)(uint64_t*, uint8_t const**), bool kThreeWay>
 uint32_t ExtendImpl(uint32_t crc, const char* buf, size_t size) {
   const uint8_t *p = reinterpret_cast<const uint8_t *>(buf);
   const uint8_t *e = p + size;
@@ -370,6 +438,9 @@ uint32_t ExtendImpl(uint32_t crc, const char* buf, size_t size) {
       STEP1;
     }
   }
+  if (kThreeWay) {
+    ThreeWayCRC32(&l, &p, e);
+  }
   // Process bytes 16 at a time
   while ((e-p) >= 16) {
     CRC32(&l, &p);
@@ -403,7 +474,7 @@ static bool isSSE42() {
 typedef uint32_t (*Function)(uint32_t, const char*, size_t);
 
 static inline Function Choose_Extend() {
-  return isSSE42() ? ExtendImpl<Fast_CRC32> : ExtendImpl<Slow_CRC32>;
+  return isSSE42() ? ExtendImpl<Fast_CRC32, true> : ExtendImpl<Slow_CRC32, false>;
 }
 
 bool IsFastCrc32Supported() {
@@ -22,6 +22,10 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #include "yb/rocksdb/util/crc32c.h"
+
+#include <string>
+
+#include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testharness.h"
 
 namespace rocksdb {
@@ -75,6 +79,34 @@ TEST(CRC, Extend) {
             Extend(Value("hello ", 6), "world", 5));
 }
 
+// Large buffers are processed as interleaved stripes, that should give the same result as one
+// byte at a time, for any alignment and any size around the stripe boundaries.
+TEST(CRC, LargeBuffers) {
+  std::string data(100000, 0);
+  Random rnd(301);
+  for (auto& c : data) {
+    c = static_cast<char>(rnd.Next());
+  }
+  for (size_t size : {12287, 12288, 12289, 24576 + 100, 99990}) {
+    for (size_t offset = 0; offset != 8; ++offset) {
+      uint32_t expected = 0;
+      for (size_t i = 0; i != size; ++i) {
+        expected = Extend(expected, data.data() + offset + i, 1);
+      }
+      ASSERT_EQ(expected, Value(data.data() + offset, size)) << size << ", " << offset;
+    }
+  }
+}
+
+TEST(CRC, Combine) {
+  const std::string data = "hello world, this crc is computed in two parts";
+  for (size_t split = 0; split <= data.size(); ++split) {
+    ASSERT_EQ(Value(data.data(), data.size()),
+              Combine(Value(data.data(), split), Value(data.data() + split, data.size() - split),
+                      data.size() - split));
+  }
+}
+
 TEST(CRC, Mask) {
   uint32_t crc = Value("foo", 3);
   ASSERT_NE(crc, Mask(crc));
@@ -78,6 +78,7 @@
 #endif
 
 #include "yb/util/file_system_posix.h"
+#include "yb/util/logging.h"
 
 #define STATUS_IO_ERROR(context, err_number) STATUS(IOError, (context), strerror(err_number))
 
@@ -137,6 +138,29 @@ void SetFD_CLOEXEC(int fd, const EnvOptions* options) {
   }
 }
 
+// Opens the file, with O_DIRECT if *direct is set. Falls back to buffered I/O and resets *direct
+// when the file system does not support O_DIRECT.
+int OpenMaybeDirect(const std::string& fname, int flags, mode_t mode, bool* direct) {
+  int fd = -1;
+#ifdef O_DIRECT
+  if (*direct) {
+    do {
+      fd = open(fname.c_str(), flags | O_DIRECT, mode);
+    } while (fd < 0 && errno == EINTR);
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+    YB_LOG_EVERY_N_SECS(WARNING, 60)
+        << "O_DIRECT is not supported for " << fname << ", falling back to buffered I/O";
+  }
+#endif
+  *direct = false;
+  do {
+    fd = open(fname.c_str(), flags, mode);
+  } while (fd < 0 && errno == EINTR);
+  return fd;
+}
+
 class PosixFileLock : public FileLock {
  public:
   int fd_;
@@ -613,9 +637,10 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     result->reset();
     Status s;
     int fd;
+    bool direct = options.use_direct_reads && !options.use_mmap_reads;
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = OpenMaybeDirect(fname, O_RDONLY, 0, &direct);
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
@@ -636,7 +661,9 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
       }
       close(fd);
     } else {
-      *result = std::make_unique<yb::PosixRandomAccessFile>(fname, fd, options);
+      EnvOptions random_access_options = options;
+      random_access_options.use_direct_reads = direct;
+      *result = std::make_unique<yb::PosixRandomAccessFile>(fname, fd, random_access_options);
     }
     return s;
   }
@@ -647,10 +674,11 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     result->reset();
     Status s;
     int fd = -1;
-    do {
+    bool direct = options.use_direct_writes && !options.use_mmap_writes;
+    {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
-    } while (fd < 0 && errno == EINTR);
+      fd = OpenMaybeDirect(fname, O_CREAT | O_RDWR | O_TRUNC, 0644, &direct);
+    }
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
     } else {
@@ -667,6 +695,8 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
       }
       if (options.use_mmap_writes && !forceMmapOff) {
         *result = std::make_unique<PosixMmapFile>(fname, fd, page_size_, options);
+      } else if (direct) {
+        *result = std::make_unique<PosixDirectIOWritableFile>(fname, fd, options);
       } else {
         // disable mmap writes
         EnvOptions no_mmap_writes_options = options;
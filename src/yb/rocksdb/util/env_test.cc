@@ -808,6 +808,53 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   // Delete the file
   ASSERT_OK(env_->DeleteFile(fname));
 }
+
+TEST_F(EnvPosixTest, DirectIO) {
+  EnvOptions soptions;
+  soptions.use_mmap_writes = false;
+  soptions.use_direct_writes = true;
+  soptions.use_direct_reads = true;
+  soptions.writable_file_max_buffer_size = 2 * yb::kDirectIOAlignment;
+  const std::string fname = test::TmpDir() + "/" + "testfile";
+
+  Random rnd(301);
+  std::string data;
+  {
+    unique_ptr<WritableFile> wfile;
+    ASSERT_OK(env_->NewWritableFile(fname, &wfile, soptions));
+    // Unaligned appends, some of them larger than the buffer, with syncs of partial blocks.
+    for (int i = 0; i != 20; ++i) {
+      std::string chunk = RandomString(&rnd, rnd.Uniform(3 * yb::kDirectIOAlignment) + 1);
+      ASSERT_OK(wfile->Append(chunk));
+      data += chunk;
+      if (i % 5 == 0) {
+        ASSERT_OK(wfile->Sync());
+      }
+    }
+    ASSERT_EQ(data.size(), wfile->GetFileSize());
+    ASSERT_OK(wfile->Close());
+  }
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  {
+    unique_ptr<RandomAccessFile> file;
+    ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+    std::string scratch(data.size(), 0);
+    Slice result;
+    for (size_t offset : {size_t(0), size_t(1), yb::kDirectIOAlignment - 1,
+                          yb::kDirectIOAlignment, data.size() / 3}) {
+      const size_t n = std::min<size_t>(yb::kDirectIOAlignment + 7, data.size() - offset);
+      ASSERT_OK(file->Read(offset, n, &result, &scratch[0]));
+      ASSERT_EQ(data.substr(offset, n), result.ToBuffer());
+    }
+    // Read past the end of file.
+    ASSERT_OK(file->Read(data.size() - 5, 100, &result, &scratch[0]));
+    ASSERT_EQ(data.substr(data.size() - 5), result.ToBuffer());
+  }
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // not TRAVIS
 #endif  // __linux__
 
@@ -30,6 +30,7 @@
 #include "yb/rocksdb/util/histogram.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/rate_limiter.h"
+#include "yb/rocksdb/util/statistics.h"
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/util/stats/iostats_context_imp.h"
@@ -50,6 +51,13 @@ Status SequentialFileReader::Read(size_t n, Slice* result, uint8_t* scratch) {
 
 Status SequentialFileReader::Skip(uint64_t n) { return file_->Skip(n); }
 
+void RandomAccessFileReader::RecordReadBytes(size_t bytes) const {
+  if (stats_ != nullptr && bytes > 0) {
+    RecordTick(stats_, file_->UseDirectIO() ? SST_DIRECT_READ_BYTES : SST_BUFFERED_READ_BYTES,
+               bytes);
+  }
+}
+
 Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
                                     char* scratch) const {
   Status s;
@@ -64,6 +72,7 @@ Status RandomAccessFileReader::Read(uint64_t offset, size_t n, Slice* result,
   if (stats_ != nullptr && file_read_hist_ != nullptr) {
     file_read_hist_->Add(elapsed);
   }
+  RecordReadBytes(result->size());
   return s;
 }
 
@@ -81,6 +90,7 @@ Status RandomAccessFileReader::ReadAndValidate(
   if (stats_ != nullptr && file_read_hist_ != nullptr) {
     file_read_hist_->Add(elapsed);
   }
+  RecordReadBytes(result->size());
   return s;
 }
 
@@ -112,6 +112,12 @@ class RandomAccessFileReader {
       uint64_t offset, size_t n, Slice* result, char* scratch, const yb::ReadValidator& validator);
 
   RandomAccessFile* file() { return file_.get(); }
+
+  Statistics* stats() const { return stats_; }
+
+ private:
+  // Records the number of bytes read into the direct or buffered read statistics.
+  void RecordReadBytes(size_t bytes) const;
 };
 
 // Use posix write to write data to a file.
@@ -497,6 +497,99 @@ size_t PosixWritableFile::GetUniqueId(char* id) const {
 }
 #endif
 
+PosixDirectIOWritableFile::PosixDirectIOWritableFile(
+    const std::string& fname, int fd, const EnvOptions& options)
+    : filename_(fname), fd_(fd) {
+  buf_.Alignment(yb::kDirectIOAlignment);
+  buf_.AllocateNewBuffer(std::max(options.writable_file_max_buffer_size, yb::kDirectIOAlignment));
+}
+
+PosixDirectIOWritableFile::~PosixDirectIOWritableFile() {
+  if (fd_ >= 0) {
+    WARN_NOT_OK(PosixDirectIOWritableFile::Close(), "Failed to close direct I/O writable file");
+  }
+}
+
+Status PosixDirectIOWritableFile::Append(const Slice& data) {
+  const char* src = data.cdata();
+  size_t left = data.size();
+  while (left != 0) {
+    const size_t appended = buf_.Append(src, left);
+    left -= appended;
+    src += appended;
+    if (buf_.CurrentSize() == buf_.Capacity()) {
+      RETURN_NOT_OK(WriteBuffer(false /* pad_tail */));
+    }
+  }
+  filesize_ += data.size();
+  return Status::OK();
+}
+
+Status PosixDirectIOWritableFile::WriteBuffer(bool pad_tail) {
+  const size_t size = buf_.CurrentSize();
+  const size_t whole_blocks_size = TruncateToPageBoundary(buf_.Alignment(), size);
+  const size_t tail_size = size - whole_blocks_size;
+  if (pad_tail) {
+    buf_.PadToAlignmentWith(0);
+  }
+  const char* src = buf_.BufferStart();
+  size_t left = pad_tail ? buf_.CurrentSize() : whole_blocks_size;
+  uint64_t offset = write_offset_;
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      buf_.Size(size);
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    offset += done;
+  }
+  buf_.RefitTail(whole_blocks_size, tail_size);
+  write_offset_ += whole_blocks_size;
+  return Status::OK();
+}
+
+Status PosixDirectIOWritableFile::Close() {
+  Status s = WriteBuffer(true /* pad_tail */);
+  // Drop the padding of the last block.
+  if (s.ok() && ftruncate(fd_, filesize_) < 0) {
+    s = STATUS_IO_ERROR(filename_, errno);
+  }
+  if (close(fd_) < 0 && s.ok()) {
+    s = STATUS_IO_ERROR(filename_, errno);
+  }
+  fd_ = -1;
+  return s;
+}
+
+// O_DIRECT does not make the data durable: it could still be in the device cache and the file size
+// is not synced, so the file is synced as usual.
+Status PosixDirectIOWritableFile::Sync() {
+  RETURN_NOT_OK(WriteBuffer(true /* pad_tail */));
+  if (fdatasync(fd_) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  return Status::OK();
+}
+
+Status PosixDirectIOWritableFile::Fsync() {
+  RETURN_NOT_OK(WriteBuffer(true /* pad_tail */));
+  if (fsync(fd_) < 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  return Status::OK();
+}
+
+#ifdef ROCKSDB_FALLOCATE_PRESENT
+size_t PosixDirectIOWritableFile::GetUniqueId(char* id) const {
+  return yb::GetUniqueIdFromFile(fd_, pointer_cast<uint8_t*>(id));
+}
+#endif
+
 PosixDirectory::~PosixDirectory() { close(fd_); }
 
 Status PosixDirectory::Fsync() {
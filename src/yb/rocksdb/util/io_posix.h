@@ -26,6 +26,7 @@
 #pragma once
 #include <unistd.h>
 #include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 
 // For non linux platform, the following macros are used only as place
 // holder.
@@ -74,6 +75,45 @@ class PosixWritableFile : public WritableFile {
 #endif
 };
 
+// A WritableFile opened with O_DIRECT, so that written data bypasses the OS page cache. Appended
+// data is accumulated in an aligned buffer and written in whole blocks once the buffer is full.
+// Sync and Close also write the partially filled last block padded with zeros, it is kept in the
+// buffer and rewritten by the next write. Close truncates the file to the appended size.
+class PosixDirectIOWritableFile : public WritableFile {
+ public:
+  PosixDirectIOWritableFile(const std::string& fname, int fd, const EnvOptions& options);
+  ~PosixDirectIOWritableFile();
+
+  // Close() truncates the file to the appended size.
+  Status Truncate(uint64_t size) override { return Status::OK(); }
+  Status Close() override;
+  Status Append(const Slice& data) override;
+  // Data is kept in the buffer until it is full, since it cannot be written to the page cache.
+  Status Flush() override { return Status::OK(); }
+  Status Sync() override;
+  Status Fsync() override;
+  uint64_t GetFileSize() override { return filesize_; }
+  size_t GetRequiredBufferAlignment() const override { return yb::kDirectIOAlignment; }
+  // Nothing is cached for this file.
+  Status InvalidateCache(size_t offset, size_t length) override { return Status::OK(); }
+#ifdef ROCKSDB_FALLOCATE_PRESENT
+  size_t GetUniqueId(char* id) const override;
+#endif
+
+ private:
+  // Writes whole blocks from the buffer and moves the rest to its beginning. If pad_tail is true,
+  // also writes the partially filled last block padded with zeros.
+  Status WriteBuffer(bool pad_tail);
+
+  const std::string filename_;
+  int fd_;
+  // Number of bytes appended to the file.
+  uint64_t filesize_ = 0;
+  // File offset at which the buffer start is written, always aligned.
+  uint64_t write_offset_ = 0;
+  AlignedBuffer buf_;
+};
+
 class PosixMmapReadableFile : public RandomAccessFile {
  private:
   int fd_;
@@ -93,7 +93,8 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       row_cache(options.row_cache),
       mem_tracker(options.mem_tracker),
       block_based_table_mem_tracker(options.block_based_table_mem_tracker),
-      iterator_replacer(options.iterator_replacer) {}
+      iterator_replacer(options.iterator_replacer),
+      expired_file_filter(options.expired_file_filter) {}
 
 ColumnFamilyOptions::ColumnFamilyOptions()
     : comparator(BytewiseComparator()),
@@ -265,6 +266,8 @@ DBOptions::DBOptions()
       allow_os_buffer(true),
       allow_mmap_reads(false),
       allow_mmap_writes(false),
+      use_direct_reads(false),
+      use_direct_io_for_flush_and_compaction(false),
       allow_fallocate(true),
       is_fd_close_on_exec(true),
       skip_log_error_on_recovery(false),
@@ -357,6 +360,10 @@ void DBOptions::Dump(Logger* log) const {
       allow_mmap_reads);
   RHEADER(log, "                       Options.allow_mmap_writes: %d",
       allow_mmap_writes);
+  RHEADER(log, "                        Options.use_direct_reads: %d",
+      use_direct_reads);
+  RHEADER(log, "  Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(log, "                     Options.is_fd_close_on_exec: %d",
       is_fd_close_on_exec);
   RHEADER(log, "                   Options.stats_dump_period_sec: %u",
@@ -457,6 +464,10 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "  Options.compression_opts.zstd_max_train_bytes: %" PRIu32,
+      compression_opts.zstd_max_train_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -111,20 +111,38 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
     // * if it's kTableFile or kTableSBlockFile, then it's shared
     // * if it's kDescriptorFile, limit the size to manifest_file_size
     // * always copy if cross-device link
+    // Table files could be placed in any of the DB paths, they are all put to the checkpoint
+    // directory. The DB opened from the checkpoint finds them there, see
+    // VersionSet::FixupFilePaths.
     bool is_table_file = type == kTableFile || type == kTableSBlockFile;
-    if (is_table_file && same_fs) {
+    std::string src_dir = db->GetName();
+    bool link_supported = same_fs;
+    if (is_table_file) {
+      for (const auto& db_path : db->GetDBOptions().db_paths) {
+        if (db->GetCheckpointEnv()->FileExists(db_path.path + src_fname).ok()) {
+          src_dir = db_path.path;
+          break;
+        }
+      }
+    }
+    if (is_table_file && link_supported) {
       RLOG(db->GetOptions().info_log, "Hard Linking %s", src_fname.c_str());
-      s = db->GetCheckpointEnv()->LinkFile(db->GetName() + src_fname,
+      s = db->GetCheckpointEnv()->LinkFile(src_dir + src_fname,
                                  full_private_path + src_fname);
       if (s.IsNotSupported()) {
-        same_fs = false;
+        // Other DB paths could be on another file system, so only stop linking files of the DB
+        // directory.
+        if (src_dir == db->GetName()) {
+          same_fs = false;
+        }
+        link_supported = false;
         s = Status::OK();
       }
     }
-    if (!is_table_file || !same_fs) {
+    if (!is_table_file || !link_supported) {
       RLOG(db->GetOptions().info_log, "Copying %s", src_fname.c_str());
       std::string dest_name = full_private_path + src_fname;
-      s = CopyFile(db->GetCheckpointEnv(), db->GetName() + src_fname, dest_name,
+      s = CopyFile(db->GetCheckpointEnv(), src_dir + src_fname, dest_name,
                    type == kDescriptorFile ? manifest_file_size : 0);
     }
   }
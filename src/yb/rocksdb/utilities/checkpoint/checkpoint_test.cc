@@ -281,6 +281,52 @@ TEST_F(DBTest, GetSnapshotLink) {
     dbname_ = test::TmpDir(env_) + "/db_test";
 }
 
+TEST_F(DBTest, CheckpointMultiplePaths) {
+  const std::string snapshot_name = test::TmpDir(env_) + "/snapshot";
+  Options options = CurrentOptions();
+  options.db_paths.emplace_back(dbname_, 0);
+  options.db_paths.emplace_back(dbname_ + "_2", 0);
+  Reopen(options);
+
+  // Put one table file to the second path and keep another one in the first path.
+  ASSERT_OK(Put("foo", "v1"));
+  ASSERT_OK(Flush());
+  CompactRangeOptions compact_options;
+  compact_options.target_path_id = 1;
+  ASSERT_OK(db_->CompactRange(compact_options, nullptr, nullptr));
+  ASSERT_OK(Put("bar", "v2"));
+  ASSERT_OK(Flush());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(2U, files.size());
+  ASSERT_NE(files[0].db_path, files[1].db_path);
+
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, snapshot_name));
+  Close();
+
+  // All table files are in the checkpoint directory, while the manifest refers to the second path
+  // for one of them.
+  Options snapshot_options = CurrentOptions();
+  snapshot_options.create_if_missing = false;
+  snapshot_options.db_paths.emplace_back(snapshot_name, 0);
+  snapshot_options.db_paths.emplace_back(snapshot_name + "_2", 0);
+  DB* snapshot_db = nullptr;
+  for (int i = 0; i != 2; ++i) {
+    ASSERT_OK(DB::Open(snapshot_options, snapshot_name, &snapshot_db));
+    std::string result;
+    ASSERT_OK(snapshot_db->Get(ReadOptions(), "foo", &result));
+    ASSERT_EQ("v1", result);
+    ASSERT_OK(snapshot_db->Get(ReadOptions(), "bar", &result));
+    ASSERT_EQ("v2", result);
+    delete snapshot_db;
+    snapshot_db = nullptr;
+  }
+
+  ASSERT_OK(DestroyDB(snapshot_name, snapshot_options));
+  env_->DeleteDir(snapshot_name + "_2");
+  env_->DeleteDir(snapshot_name);
+}
+
 TEST_F(DBTest, CheckpointCF) {
   Options options = CurrentOptions();
   CreateAndReopenWithCF({"one", "two", "three", "four", "five"}, options);
@@ -225,6 +225,10 @@ void Connection::QueueOutboundCall(const OutboundCallPtr& call) {
 
   auto handle = DoQueueOutboundData(call, true);
 
+  if (call->compressed_body_size() != 0) {
+    CompressedBodySent(call->uncompressed_body_size(), call->compressed_body_size());
+  }
+
   // Set up the timeout timer.
   const MonoDelta& timeout = call->controller()->timeout();
   if (timeout.Initialized()) {
@@ -305,6 +309,10 @@ Status Connection::HandleCallResponse(CallData* call_data) {
   CallResponse resp;
   RETURN_NOT_OK(resp.ParseFrom(call_data));
 
+  if (resp.compressed_body_size() != 0) {
+    CompressedBodyReceived(resp.uncompressed_body_size(), resp.compressed_body_size());
+  }
+
   ++responded_call_count_;
   auto awaiting = awaiting_response_.find(resp.call_id());
   if (awaiting == awaiting_response_.end()) {
@@ -359,6 +367,21 @@ Status Connection::DumpPB(const DumpRunningRpcsRequestPB& req,
     resp->set_processed_call_count(processed_call_count);
   }
 
+  auto sent_after_compression =
+      sent_compression_stats_.bytes_after_compression.load(std::memory_order_relaxed);
+  if (sent_after_compression != 0) {
+    resp->set_sent_bytes_before_compression(
+        sent_compression_stats_.bytes_before_compression.load(std::memory_order_relaxed));
+    resp->set_sent_bytes_after_compression(sent_after_compression);
+  }
+  auto received_after_compression =
+      received_compression_stats_.bytes_after_compression.load(std::memory_order_relaxed);
+  if (received_after_compression != 0) {
+    resp->set_received_bytes_before_compression(
+        received_compression_stats_.bytes_before_compression.load(std::memory_order_relaxed));
+    resp->set_received_bytes_after_compression(received_after_compression);
+  }
+
   context_->DumpPB(req, resp);
 
   if (direction_ == Direction::CLIENT) {
@@ -377,6 +400,20 @@ Status Connection::DumpPB(const DumpRunningRpcsRequestPB& req,
   return Status::OK();
 }
 
+void Connection::CompressedBodySent(size_t uncompressed_size, size_t compressed_size) {
+  sent_compression_stats_.bytes_before_compression.fetch_add(
+      uncompressed_size, std::memory_order_relaxed);
+  sent_compression_stats_.bytes_after_compression.fetch_add(
+      compressed_size, std::memory_order_relaxed);
+}
+
+void Connection::CompressedBodyReceived(size_t uncompressed_size, size_t compressed_size) {
+  received_compression_stats_.bytes_before_compression.fetch_add(
+      uncompressed_size, std::memory_order_relaxed);
+  received_compression_stats_.bytes_after_compression.fetch_add(
+      compressed_size, std::memory_order_relaxed);
+}
+
 void Connection::QueueOutboundDataBatch(const OutboundDataBatch& batch) {
   DCHECK(reactor_->IsCurrentThread());
 
@@ -162,6 +162,10 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   CHECKED_STATUS DumpPB(const DumpRunningRpcsRequestPB& req,
                         RpcConnectionPB* resp);
 
+  // Accounts a message body that was sent or received over the connection compressed.
+  void CompressedBodySent(size_t uncompressed_size, size_t compressed_size);
+  void CompressedBodyReceived(size_t uncompressed_size, size_t compressed_size);
+
   // Do appropriate actions after adding outbound call.
   void OutboundQueued();
 
@@ -271,6 +275,14 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   std::unique_ptr<ConnectionContext> context_;
 
   std::atomic<uint64_t> responded_call_count_{0};
+
+  struct CompressionStats {
+    std::atomic<uint64_t> bytes_before_compression{0};
+    std::atomic<uint64_t> bytes_after_compression{0};
+  };
+
+  CompressionStats sent_compression_stats_;
+  CompressionStats received_compression_stats_;
 };
 
 }  // namespace rpc
@@ -105,11 +105,37 @@ void InboundCall::NotifyTransferred(const Status& status, Connection* conn) {
     YB_LOG_EVERY_N_SECS(WARNING, 10) << LogPrefix() << "Connection torn down before " << ToString()
                                      << " could send its response: " << status.ToString();
   }
+  RecordPhases(status.ok());
   if (call_processed_listener_) {
     call_processed_listener_(this);
   }
 }
 
+void InboundCall::RecordPhases(bool transferred) {
+  auto* histograms = rpc_metrics_->phases.Inbound(service_name(), method_name());
+  if (!histograms) {
+    return;
+  }
+  auto histogram = [histograms](InboundCallPhase phase) -> const scoped_refptr<Histogram>& {
+    return (*histograms)[to_underlying(phase)];
+  };
+  IncrementPhaseHistogram(
+      histogram(InboundCallPhase::kQueue), timing_.time_received, timing_.time_handled);
+  IncrementPhaseHistogram(
+      histogram(InboundCallPhase::kParse), timing_.time_handled, timing_.time_parsed);
+  IncrementPhaseHistogram(
+      histogram(InboundCallPhase::kHandler),
+      timing_.time_parsed.Initialized() ? timing_.time_parsed : timing_.time_handled,
+      timing_.time_completed);
+  IncrementPhaseHistogram(
+      histogram(InboundCallPhase::kSerialize), timing_.time_completed,
+      timing_.time_response_queued);
+  if (transferred) {
+    IncrementPhaseHistogram(
+        histogram(InboundCallPhase::kSend), timing_.time_response_queued, MonoTime::Now());
+  }
+}
+
 const Endpoint& InboundCall::remote_address() const {
   CHECK_NOTNULL(conn_.get());
   return conn_->remote();
@@ -173,8 +199,29 @@ bool InboundCall::ClientTimedOut() const {
   return deadline < CoarseMonoClock::now();
 }
 
+void InboundCall::StartTraceSpan() {
+  auto parent = remote_trace_span();
+  TraceSpanPtr span;
+  if (parent) {
+    span = TraceSpan::StartChild(parent, Format("$0.$1", service_name(), method_name()));
+  } else if (TraceSpan::ShouldSampleRoot()) {
+    span = TraceSpan::StartRoot(Format("$0.$1", service_name(), method_name()));
+  } else {
+    return;
+  }
+  span->SetAttribute("rpc.system", "yb");
+  span->SetAttribute("net.peer", yb::ToString(remote_address()));
+  trace_->set_span(std::move(span));
+}
+
 void InboundCall::QueueResponse(bool is_success) {
+  timing_.time_response_queued = MonoTime::Now();
   TRACE_TO(trace_, is_success ? "Queueing success response" : "Queueing failure response");
+  auto* span = trace_->span();
+  if (span) {
+    span->SetAttribute("success", is_success ? "true" : "false");
+    span->End();
+  }
   LogTrace();
   bool expected = false;
   if (responded_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
@@ -188,6 +235,13 @@ std::string InboundCall::LogPrefix() const {
   return Format("$0: ", this);
 }
 
+void InboundCall::Cancel() {
+  if (!cancellation_token_.cancelled()) {
+    cancellation_token_.Cancel();
+    IncrementCounter(rpc_metrics_->inbound_calls_cancelled);
+  }
+}
+
 bool InboundCall::RespondTimedOutIfPending(const char* message) {
   if (!TryStartProcessing()) {
     return false;
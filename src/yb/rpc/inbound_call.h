@@ -52,10 +52,13 @@
 
 #include "yb/yql/cql/ql/ql_session.h"
 
+#include "yb/util/cancellation_token.h"
 #include "yb/util/faststring.h"
 #include "yb/util/lockfree.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
+#include "yb/util/object_pool.h"
+#include "yb/util/trace_span.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
@@ -79,9 +82,11 @@ class RpcCallDetailsPB;
 class CQLCallDetailsPB;
 
 struct InboundCallTiming {
-  MonoTime time_received;   // Time the call was first accepted.
-  MonoTime time_handled;    // Time the call handler was kicked off.
-  MonoTime time_completed;  // Time the call handler completed.
+  MonoTime time_received;        // Time the call was first accepted.
+  MonoTime time_handled;         // Time the call handler was kicked off.
+  MonoTime time_parsed;          // Time the request parameter was parsed.
+  MonoTime time_completed;       // Time the call handler completed.
+  MonoTime time_response_queued; // Time the serialized response was queued to the reactor.
 };
 
 class InboundCallHandler {
@@ -151,6 +156,15 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // it gets handled.
   MonoDelta GetTimeInQueue() const;
 
+  // Marks the call as not needed anymore, for instance because the connection it was received
+  // on was closed. A queued call is dropped, while a running one could check cancellation_token()
+  // to abort early.
+  void Cancel();
+
+  bool cancelled() const { return cancellation_token_.cancelled(); }
+
+  const CancellationToken& cancellation_token() const { return cancellation_token_; }
+
   ThreadPoolTask* BindTask(InboundCallHandler* handler) {
     auto shared_this = shared_from(this);
     if (!handler->CallQueued()) {
@@ -163,6 +177,17 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   virtual const std::string& method_name() const = 0;
   virtual const std::string& service_name() const = 0;
+
+  // Context of the span of the caller, when the call is done for a sampled request.
+  virtual TraceSpanContext remote_trace_span() const { return TraceSpanContext(); }
+
+  // Starts the span of this call in its trace, when the caller is sampled, or when the call
+  // itself is picked as the root of a new trace. The span ends when the response is queued.
+  void StartTraceSpan();
+
+  // Scheduling priority requested by the client, 0 if it did not request any.
+  virtual uint32_t priority() const { return 0; }
+
   virtual void RespondFailure(ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) = 0;
 
   // Do appropriate actions when call is timed out.
@@ -187,7 +212,7 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   template <class T, class ...Args>
   static std::shared_ptr<T> Create(Args&&... args) {
-    auto result = std::make_shared<T>(std::forward<Args>(args)...);
+    auto result = std::allocate_shared<T>(PooledAllocator<T>(), std::forward<Args>(args)...);
     result->RecordCallReceived();
     return result;
   }
@@ -209,6 +234,10 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   void QueueResponse(bool is_success);
 
+  // Adds the time spent in each of the recorded phases of the call to the phase histograms of its
+  // method, when the response was transferred or failed to.
+  void RecordPhases(bool transferred);
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'request_data_'.
   Slice serialized_request_;
@@ -226,6 +255,8 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   std::atomic<bool> responded_{false};
 
+  CancellationToken cancellation_token_;
+
  private:
   // The connection on which this inbound call arrived. Can be null for LocalYBInboundCall.
   ConnectionPtr conn_ = nullptr;
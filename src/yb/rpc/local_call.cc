@@ -15,6 +15,8 @@
 
 #include "yb/rpc/local_call.h"
 
+#include <google/protobuf/io/coded_stream.h>
+
 #include "yb/rpc/rpc_controller.h"
 #include "yb/util/memory/memory.h"
 
@@ -34,7 +36,23 @@ LocalOutboundCall::LocalOutboundCall(
 
 Status LocalOutboundCall::SetRequestParam(
     const google::protobuf::Message& req, const MemTrackerPtr& mem_tracker) {
-  req_ = &req;
+  const auto& serialized_fields = controller()->serialized_request_fields();
+  if (serialized_fields.empty()) {
+    req_ = &req;
+    return Status::OK();
+  }
+
+  // The local call does not serialize the request, so fields serialized in advance are merged
+  // into a copy of it.
+  merged_req_.reset(req.New());
+  merged_req_->CopyFrom(req);
+  for (const auto& field : serialized_fields) {
+    google::protobuf::io::CodedInputStream input(field.udata(), field.size());
+    if (!merged_req_->MergePartialFromCodedStream(&input)) {
+      return STATUS(InvalidArgument, "Failed to merge serialized request field");
+    }
+  }
+  req_ = merged_req_.get();
   return Status::OK();
 }
 
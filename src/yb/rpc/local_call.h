@@ -49,6 +49,9 @@ class LocalOutboundCall : public OutboundCall {
 
   const google::protobuf::Message* req_ = nullptr;
 
+  // Copy of the request with serialized request fields of the controller merged into it.
+  std::unique_ptr<google::protobuf::Message> merged_req_;
+
   std::shared_ptr<LocalYBInboundCall> inbound_call_;
 };
 
@@ -45,6 +45,7 @@
 #include "yb/rpc/connection.h"
 #include "yb/rpc/constants.h"
 #include "yb/rpc/outbound_call.h"
+#include "yb/rpc/proxy_connections_load.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/rpc_metrics.h"
@@ -56,6 +57,7 @@
 #include "yb/util/memory/memory.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/trace.h"
+#include "yb/util/trace_span.h"
 #include "yb/util/tsan_util.h"
 
 METRIC_DEFINE_histogram(
@@ -82,6 +84,7 @@ DEFINE_int64(
 TAG_FLAG(rpc_callback_max_cycles, advanced);
 TAG_FLAG(rpc_callback_max_cycles, runtime);
 DECLARE_bool(rpc_dump_all_traces);
+DECLARE_bool(enable_rpc_compression);
 
 namespace yb {
 namespace rpc {
@@ -205,6 +208,10 @@ OutboundCall::OutboundCall(const RemoteMethod* remote_method,
 
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    auto* parent_span = Trace::CurrentTrace()->span();
+    if (parent_span) {
+      trace_->set_span(TraceSpan::StartChild(parent_span, remote_method_->ToString()));
+    }
   }
 
   DVLOG(4) << "OutboundCall " << this << " constructed with state_: " << StateName(state_)
@@ -249,6 +256,10 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
 
 void OutboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) {
   output->push_back(std::move(buffer_));
+  for (auto& field : serialized_fields_) {
+    output->push_back(std::move(field));
+  }
+  serialized_fields_.clear();
   buffer_consumption_ = ScopedTrackedConsumption();
 }
 
@@ -257,10 +268,17 @@ Status OutboundCall::SetRequestParam(
   using serialization::SerializeHeader;
   using serialization::SerializeMessage;
 
+  // Fields serialized in advance are sent after the message, and are accounted in its size.
+  serialized_fields_ = controller_->serialized_request_fields();
+  size_t serialized_fields_size = 0;
+  for (const auto& field : serialized_fields_) {
+    serialized_fields_size += field.size();
+  }
+
   size_t message_size = 0;
   auto status = SerializeMessage(message,
                                  /* param_buf */ nullptr,
-                                 /* additional_size */ 0,
+                                 /* additional_size */ serialized_fields_size,
                                  /* use_cached_size */ false,
                                  /* offset */ 0,
                                  &message_size);
@@ -271,8 +289,13 @@ Status OutboundCall::SetRequestParam(
 
   RequestHeader header;
   InitHeader(&header);
-  status = SerializeHeader(header, message_size, &buffer_, message_size, &header_size);
+  auto compressed = SerializeCompressedRequest(message, serialized_fields_size, &header);
+  if (compressed.ok() && !*compressed) {
+    status = SerializeHeader(
+        header, message_size + serialized_fields_size, &buffer_, message_size, &header_size);
+  }
   remote_method_pool_->Release(header.release_remote_method());
+  RETURN_NOT_OK(compressed);
   if (!status.ok()) {
     return status;
   }
@@ -281,13 +304,48 @@ Status OutboundCall::SetRequestParam(
     buffer_consumption_ = ScopedTrackedConsumption(mem_tracker, buffer_.size());
   }
 
+  if (*compressed) {
+    return Status::OK();
+  }
+
   return SerializeMessage(message,
                           &buffer_,
-                          /* additional_size */ 0,
+                          /* additional_size */ serialized_fields_size,
                           /* use_cached_size */ true,
                           header_size);
 }
 
+Result<bool> OutboundCall::SerializeCompressedRequest(
+    const Message& message, size_t serialized_fields_size, RequestHeader* header) {
+  if (!remote_compression_state_ ||
+      !remote_compression_state_->accepts_compressed_body.load(std::memory_order_acquire)) {
+    return false;
+  }
+  // The message size is cached by the SerializeMessage call that calculated the sizes.
+  size_t body_size = message.GetCachedSize() + serialized_fields_size;
+  if (!serialization::ShouldCompressBody(remote_method_->service_name(), body_size)) {
+    return false;
+  }
+
+  RefCntBuffer body(body_size);
+  auto* dst = message.SerializeWithCachedSizesToArray(body.udata());
+  for (const auto& field : serialized_fields_) {
+    memcpy(dst, field.data(), field.size());
+    dst += field.size();
+  }
+  RefCntBuffer compressed;
+  if (!serialization::CompressBody(body.AsSlice(), &compressed)) {
+    return false;
+  }
+
+  header->set_uncompressed_body_size(body_size);
+  RETURN_NOT_OK(serialization::SerializeHeaderAndBody(*header, compressed.AsSlice(), &buffer_));
+  serialized_fields_.clear();
+  uncompressed_body_size_ = body_size;
+  compressed_body_size_ = compressed.size();
+  return true;
+}
+
 Status OutboundCall::status() const {
   std::lock_guard<simple_spinlock> l(lock_);
   return status_;
@@ -363,7 +421,26 @@ bool OutboundCall::SetState(State new_state) {
   }
 }
 
+size_t OutboundCall::AcquireConnection(std::shared_ptr<ProxyConnectionsLoad> connections_load) {
+  connection_load_bytes_ = buffer_.size();
+  for (const auto& field : serialized_fields_) {
+    connection_load_bytes_ += field.size();
+  }
+  connection_idx_ = connections_load->Acquire(connection_load_bytes_);
+  connections_load_ = std::move(connections_load);
+  return connection_idx_;
+}
+
 void OutboundCall::InvokeCallback() {
+  auto* span = trace_->span();
+  if (span) {
+    span->SetAttribute("state", StateName(state()));
+    span->End();
+  }
+  if (connections_load_) {
+    connections_load_->Release(connection_idx_, connection_load_bytes_);
+    connections_load_.reset();
+  }
   if (callback_thread_pool_) {
     callback_task_.SetOutboundCall(shared_from(this));
     callback_thread_pool_->Enqueue(&callback_task_);
@@ -380,6 +457,15 @@ void OutboundCall::InvokeCallbackSync() {
     return;
   }
 
+  // The phases are only recorded for the calls that got a response, since the reactor thread that
+  // set their times is done with them. The histograms are looked up before the callback, which
+  // could destroy the proxy that owns the remote method.
+  const OutboundCallPhaseHistograms* phase_histograms = nullptr;
+  if (state() == FINISHED_SUCCESS) {
+    phase_histograms = rpc_metrics_->phases.Outbound(
+        remote_method_->service_name(), remote_method_->method_name());
+  }
+
   int64_t start_cycles = CycleClock::Now();
   callback_();
   // Clear the callback, since it may be holding onto reference counts
@@ -396,6 +482,19 @@ void OutboundCall::InvokeCallbackSync() {
     LOG(WARNING) << "RPC callback for " << ToString() << " took " << time_spent;
   }
 
+  if (phase_histograms) {
+    auto histogram = [phase_histograms](OutboundCallPhase phase)
+        -> const scoped_refptr<Histogram>& {
+      return (*phase_histograms)[to_underlying(phase)];
+    };
+    IncrementPhaseHistogram(histogram(OutboundCallPhase::kQueue), start_, queued_time_);
+    IncrementPhaseHistogram(histogram(OutboundCallPhase::kSend), queued_time_, sent_time_);
+    IncrementPhaseHistogram(
+        histogram(OutboundCallPhase::kResponse), sent_time_, response_time_);
+    histogram(OutboundCallPhase::kCallback)->Increment(MonoDelta::FromSeconds(
+        static_cast<double>(wait_cycles) / base::CyclesPerSecond()).ToMicroseconds());
+  }
+
   // Could be destroyed during callback. So reset it.
   controller_ = nullptr;
   response_ = nullptr;
@@ -405,6 +504,7 @@ void OutboundCall::SetResponse(CallResponse&& resp) {
   DCHECK(!IsFinished());
 
   auto now = MonoTime::Now();
+  response_time_ = now;
   TRACE_TO_WITH_TIME(trace_, now, "Response received.");
   // Track time taken to be responded.
 
@@ -414,6 +514,11 @@ void OutboundCall::SetResponse(CallResponse&& resp) {
   call_response_ = std::move(resp);
   Slice r(call_response_.serialized_response());
 
+  if (remote_compression_state_) {
+    remote_compression_state_->accepts_compressed_body.store(
+        call_response_.accepts_compressed_body(), std::memory_order_release);
+  }
+
   if (call_response_.is_success()) {
     // TODO: here we're deserializing the call response within the reactor thread,
     // which isn't great, since it would block processing of other RPCs in parallel.
@@ -444,6 +549,7 @@ void OutboundCall::SetResponse(CallResponse&& resp) {
 
 void OutboundCall::SetQueued() {
   auto end_time = MonoTime::Now();
+  queued_time_ = end_time;
   // Track time taken to be queued.
   if (outbound_call_metrics_) {
     outbound_call_metrics_->queue_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
@@ -454,6 +560,7 @@ void OutboundCall::SetQueued() {
 
 void OutboundCall::SetSent() {
   auto end_time = MonoTime::Now();
+  sent_time_ = end_time;
   // Track time taken to be sent
   if (outbound_call_metrics_) {
     outbound_call_metrics_->send_time->Increment(end_time.GetDeltaSince(start_).ToMicroseconds());
@@ -563,8 +670,20 @@ void OutboundCall::InitHeader(RequestHeader* header) {
     if (timeout.Initialized()) {
       header->set_timeout_millis(timeout.ToMilliseconds());
     }
+    if (controller_->priority() != 0) {
+      header->set_priority(controller_->priority());
+    }
   }
   header->set_allocated_remote_method(remote_method_pool_->Take());
+  auto* span = trace_->span();
+  if (span) {
+    auto context = span->context();
+    header->set_trace_id(context.trace_id);
+    header->set_parent_span_id(context.span_id);
+  }
+  if (FLAGS_enable_rpc_compression) {
+    header->set_accepts_compressed_body(true);
+  }
 }
 
 ///
@@ -612,6 +731,15 @@ Status CallResponse::ParseFrom(CallData* call_data) {
   Slice source(response_data_.data(), response_data_.size());
   RETURN_NOT_OK(serialization::ParseYBMessage(source, &header_, &entire_message));
 
+  if (header_.has_uncompressed_body_size()) {
+    CallData decompressed;
+    RETURN_NOT_OK(serialization::DecompressBody(
+        entire_message, header_.uncompressed_body_size(), &decompressed));
+    compressed_body_size_ = entire_message.size();
+    response_data_ = std::move(decompressed);
+    entire_message = Slice(response_data_.data(), response_data_.size());
+  }
+
   // Use information from header to extract the payload slices.
   const size_t sidecars = header_.sidecar_offsets_size();
 
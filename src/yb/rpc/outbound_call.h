@@ -122,6 +122,12 @@ struct OutboundCallMetrics {
   scoped_refptr<Histogram> time_to_response;
 };
 
+// Body compression negotiated with a remote server, shared by calls sent through the same proxy.
+struct RemoteCompressionState {
+  // Whether the last response from the server reported that it accepts compressed requests.
+  std::atomic<bool> accepts_compressed_body{false};
+};
+
 // A response to a call, on the client side.
 // Upon receiving a response, this is allocated in the reactor thread and filled
 // into the OutboundCall instance via OutboundCall::SetResponse.
@@ -162,6 +168,20 @@ class CallResponse {
 
   Result<Slice> GetSidecar(int idx) const;
 
+  // Sizes of the response body before and after compression, zeroes if it was not compressed.
+  size_t uncompressed_body_size() const {
+    return header_.uncompressed_body_size();
+  }
+
+  size_t compressed_body_size() const {
+    return compressed_body_size_;
+  }
+
+  // Whether the server accepts compressed request bodies.
+  bool accepts_compressed_body() const {
+    return header_.accepts_compressed_body();
+  }
+
   size_t DynamicMemoryUsage() const {
     return DynamicMemoryUsageOf(header_, response_data_) +
            GetFlatDynamicMemoryUsageOf(sidecar_bounds_);
@@ -183,9 +203,12 @@ class CallResponse {
   boost::container::small_vector<const uint8_t*, kMinBufferForSidecarSlices> sidecar_bounds_;
 
   // The incoming transfer data - retained because serialized_response_
-  // and sidecar_slices_ refer into its data.
+  // and sidecar_slices_ refer into its data. Contains the decompressed body when the response
+  // was compressed.
   CallData response_data_;
 
+  size_t compressed_body_size_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(CallResponse);
 };
 
@@ -279,6 +302,20 @@ class OutboundCall : public RpcCall {
 
   std::string LogPrefix() const override;
 
+  // Requests are compressed only when the state shows that the server accepts them, see
+  // enable_rpc_compression. Should be called before SetRequestParam.
+  void SetRemoteCompressionState(std::shared_ptr<RemoteCompressionState> state) {
+    remote_compression_state_ = std::move(state);
+  }
+
+  // Picks the connection to send the call over, by the load of the proxy connections. The call is
+  // accounted in the load until it completes. Should be called after SetRequestParam.
+  size_t AcquireConnection(std::shared_ptr<ProxyConnectionsLoad> connections_load);
+
+  // Sizes of the request body before and after compression, zeroes if it was not compressed.
+  size_t uncompressed_body_size() const { return uncompressed_body_size_; }
+  size_t compressed_body_size() const { return compressed_body_size_; }
+
   void SetConnectionId(const ConnectionId& value, const std::string* hostname) {
     conn_id_ = value;
     hostname_ = hostname;
@@ -325,6 +362,10 @@ class OutboundCall : public RpcCall {
   ConnectionId conn_id_;
   const std::string* hostname_;
   MonoTime start_;
+  // Times the call was queued to the reactor, sent and responded, for the phase histograms.
+  MonoTime queued_time_;
+  MonoTime sent_time_;
+  MonoTime response_time_;
   RpcController* controller_;
   // Pointer for the protobuf where the response should be written.
   // Can be used only while callback_ object is alive.
@@ -355,6 +396,12 @@ class OutboundCall : public RpcCall {
 
   void InitHeader(RequestHeader* header);
 
+  // Serializes the request with the body compressed to buffer_, if the body should be compressed
+  // and compression shrinks it. Returns true if the request was serialized.
+  Result<bool> SerializeCompressedRequest(
+      const google::protobuf::Message& message, size_t serialized_fields_size,
+      RequestHeader* header);
+
   // Lock for state_ status_, error_pb_ fields, since they
   // may be mutated by the reactor thread while the client thread
   // reads them.
@@ -383,6 +430,9 @@ class OutboundCall : public RpcCall {
   // Consumption of buffer_.
   ScopedTrackedConsumption buffer_consumption_;
 
+  // Serialized request fields to send after buffer_, shared with other calls.
+  std::vector<RefCntBuffer> serialized_fields_;
+
   // Once a response has been received for this call, contains that response.
   CallResponse call_response_;
 
@@ -395,6 +445,15 @@ class OutboundCall : public RpcCall {
 
   RpcMetrics* rpc_metrics_;
 
+  std::shared_ptr<RemoteCompressionState> remote_compression_state_;
+  size_t uncompressed_body_size_ = 0;
+  size_t compressed_body_size_ = 0;
+
+  // Load the call is accounted in, see AcquireConnection.
+  std::shared_ptr<ProxyConnectionsLoad> connections_load_;
+  size_t connection_idx_ = 0;
+  size_t connection_load_bytes_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(OutboundCall);
 };
 
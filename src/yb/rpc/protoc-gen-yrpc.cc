@@ -509,14 +509,15 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
 
         Print(printer, *subs,
         "  if (call->method_name() == \"$rpc_name$\") {\n"
+        "    auto call_arena = yb_call->IsLocalCall() ? nullptr : ::yb::rpc::MakeCallArena();\n"
         "    auto rpc_context = yb_call->IsLocalCall() ?\n"
         "        ::yb::rpc::RpcContext(\n"
         "            std::static_pointer_cast<::yb::rpc::LocalYBInboundCall>(yb_call), \n"
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::MakeCallMessage<$request$>(call_arena),\n"
+        "            ::yb::rpc::MakeCallMessage<$response$>(call_arena),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
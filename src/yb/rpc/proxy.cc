@@ -45,6 +45,7 @@
 #include "yb/rpc/local_call.h"
 #include "yb/rpc/outbound_call.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/proxy_connections_load.h"
 #include "yb/rpc/remote_method.h"
 #include "yb/rpc/response_callback.h"
 #include "yb/rpc/rpc_header.pb.h"
@@ -54,6 +55,7 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
 
@@ -63,6 +65,12 @@ DEFINE_int32(num_connections_to_server, 8,
 DEFINE_int32(proxy_resolve_cache_ms, 5000,
              "Time in milliseconds to cache resolution result in Proxy");
 
+DEFINE_bool(enable_adaptive_connections_to_server, false,
+            "Send calls of a proxy over the connection with the least bytes in flight, and use "
+            "only as many of num_connections_to_server connections as the load requires, instead "
+            "of spreading calls over all of them in round robin.");
+TAG_FLAG(enable_adaptive_connections_to_server, advanced);
+
 using namespace std::literals;
 
 using google::protobuf::Message;
@@ -84,7 +92,9 @@ Proxy::Proxy(ProxyContext* context, const HostPort& remote, const Protocol* prot
       latency_hist_(ScopedDnsTracker::active_metric()),
       // Use the context->num_connections_to_server() here as opposed to directly reading the
       // FLAGS_num_connections_to_server, because the flag value could have changed since then.
-      num_connections_to_server_(context_->num_connections_to_server()) {
+      num_connections_to_server_(context_->num_connections_to_server()),
+      connections_load_(FLAGS_enable_adaptive_connections_to_server && !call_local_service_
+          ? std::make_shared<ProxyConnectionsLoad>(num_connections_to_server_) : nullptr) {
   VLOG(1) << "Create proxy to " << remote << " with num_connections_to_server="
           << num_connections_to_server_;
   if (context_->parent_mem_tracker()) {
@@ -152,16 +162,20 @@ void Proxy::DoAsyncRequest(const RemoteMethod* method,
                                           controller,
                                           &context_->rpc_metrics(),
                                           std::move(callback)) :
-      std::make_shared<OutboundCall>(method,
-                                     outbound_call_metrics_,
-                                     resp,
-                                     controller,
-                                     &context_->rpc_metrics(),
-                                     std::move(callback),
-                                     GetCallbackThreadPool(
-                                         force_run_callback_on_reactor,
-                                         controller->invoke_callback_mode()));
+      std::allocate_shared<OutboundCall>(PooledAllocator<OutboundCall>(),
+                                         method,
+                                         outbound_call_metrics_,
+                                         resp,
+                                         controller,
+                                         &context_->rpc_metrics(),
+                                         std::move(callback),
+                                         GetCallbackThreadPool(
+                                             force_run_callback_on_reactor,
+                                             controller->invoke_callback_mode()));
   auto call = controller->call_.get();
+  if (!call_local_service_) {
+    call->SetRemoteCompressionState(remote_compression_state_);
+  }
   Status s = call->SetRequestParam(req, mem_tracker_);
   if (PREDICT_FALSE(!s.ok())) {
     // Failed to serialize request: likely the request is missing a required
@@ -272,7 +286,9 @@ void Proxy::ResolveDone(
 }
 
 void Proxy::QueueCall(RpcController* controller, const Endpoint& endpoint) {
-  uint8_t idx = num_calls_.fetch_add(1) % num_connections_to_server_;
+  uint8_t idx = connections_load_
+      ? controller->call_->AcquireConnection(connections_load_)
+      : num_calls_.fetch_add(1) % num_connections_to_server_;
   ConnectionId conn_id(endpoint, idx, protocol_);
   controller->call_->SetConnectionId(conn_id, &remote_.host());
   context_->QueueOutboundCall(controller->call_);
@@ -187,6 +187,9 @@ class Proxy {
   mutable std::atomic<bool> is_started_{false};
   mutable std::atomic<size_t> num_calls_{0};
   std::shared_ptr<OutboundCallMetrics> outbound_call_metrics_;
+  // Compression negotiated with the remote server, see enable_rpc_compression.
+  std::shared_ptr<RemoteCompressionState> remote_compression_state_ =
+      std::make_shared<RemoteCompressionState>();
   const bool call_local_service_;
 
   std::atomic<ResolveState> resolve_state_{ResolveState::kIdle};
@@ -198,6 +201,9 @@ class Proxy {
   // Number of outbound connections to create per each destination server address.
   int num_connections_to_server_;
 
+  // Load of the connections used by this proxy, when enable_adaptive_connections_to_server is set.
+  std::shared_ptr<ProxyConnectionsLoad> connections_load_;
+
   MemTrackerPtr mem_tracker_;
 };
 
@@ -0,0 +1,72 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/rpc/proxy_connections_load.h"
+
+#include "yb/util/test_util.h"
+
+DECLARE_uint64(rpc_connection_grow_threshold_bytes);
+DECLARE_uint64(rpc_connection_grow_threshold_calls);
+
+namespace yb {
+namespace rpc {
+
+class ProxyConnectionsLoadTest : public YBTest {
+};
+
+TEST_F(ProxyConnectionsLoadTest, GrowAndShrink) {
+  constexpr size_t kMaxConnections = 3;
+  constexpr size_t kCallBytes = 100;
+  FLAGS_rpc_connection_grow_threshold_bytes = 1000;
+  FLAGS_rpc_connection_grow_threshold_calls = 1000;
+
+  ProxyConnectionsLoad load(kMaxConnections);
+  ASSERT_EQ(1U, load.active_connections());
+
+  // Calls below the threshold go to the single connection.
+  std::vector<size_t> calls;
+  for (int i = 0; i != 10; ++i) {
+    calls.push_back(load.Acquire(kCallBytes));
+    ASSERT_EQ(0U, calls.back());
+  }
+  ASSERT_EQ(1U, load.active_connections());
+
+  // The first connection is at the threshold, so the next call activates another one, and the
+  // following calls go to the least loaded connection.
+  calls.push_back(load.Acquire(kCallBytes));
+  ASSERT_EQ(1U, calls.back());
+  ASSERT_EQ(2U, load.active_connections());
+  calls.push_back(load.Acquire(kCallBytes));
+  ASSERT_EQ(1U, calls.back());
+
+  // Number of connections is limited.
+  for (int i = 0; i != 100; ++i) {
+    calls.push_back(load.Acquire(kCallBytes));
+  }
+  ASSERT_EQ(kMaxConnections, load.active_connections());
+
+  // Connections are deactivated when idle, starting from the last one.
+  for (auto it = calls.rbegin(); it != calls.rend(); ++it) {
+    load.Release(*it, kCallBytes);
+  }
+  ASSERT_EQ(1U, load.active_connections());
+}
+
+} // namespace rpc
+} // namespace yb
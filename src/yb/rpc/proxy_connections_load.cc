@@ -0,0 +1,112 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+
+#include "yb/rpc/proxy_connections_load.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_uint64(rpc_connection_grow_threshold_bytes, 4_MB,
+              "Bytes of calls in flight over each connection to a server, above which the proxy "
+              "opens another connection to the server, up to num_connections_to_server. Used "
+              "with enable_adaptive_connections_to_server.");
+TAG_FLAG(rpc_connection_grow_threshold_bytes, advanced);
+TAG_FLAG(rpc_connection_grow_threshold_bytes, runtime);
+
+DEFINE_uint64(rpc_connection_grow_threshold_calls, 64,
+              "Number of calls in flight over each connection to a server, above which the proxy "
+              "opens another connection to the server, up to num_connections_to_server. Used "
+              "with enable_adaptive_connections_to_server.");
+TAG_FLAG(rpc_connection_grow_threshold_calls, advanced);
+TAG_FLAG(rpc_connection_grow_threshold_calls, runtime);
+
+namespace yb {
+namespace rpc {
+
+ProxyConnectionsLoad::ProxyConnectionsLoad(size_t max_connections)
+    : max_connections_(std::max<size_t>(max_connections, 1)),
+      loads_(new ConnectionLoad[max_connections_]) {
+}
+
+bool ProxyConnectionsLoad::IsLoaded(const ConnectionLoad& load, size_t divisor) {
+  return load.bytes.load(std::memory_order_relaxed) >=
+             FLAGS_rpc_connection_grow_threshold_bytes / divisor ||
+         load.calls.load(std::memory_order_relaxed) >=
+             FLAGS_rpc_connection_grow_threshold_calls / divisor;
+}
+
+size_t ProxyConnectionsLoad::Acquire(size_t bytes) {
+  auto active = active_connections_.load(std::memory_order_acquire);
+  size_t best = 0;
+  size_t best_bytes = std::numeric_limits<size_t>::max();
+  for (size_t idx = 0; idx != active; ++idx) {
+    auto idx_bytes = loads_[idx].bytes.load(std::memory_order_relaxed);
+    if (idx_bytes < best_bytes) {
+      best = idx;
+      best_bytes = idx_bytes;
+    }
+  }
+
+  if (active < max_connections_ && IsLoaded(loads_[best], 1)) {
+    // Even the least loaded connection is loaded, so add a connection. If another thread added
+    // one concurrently, just use the least loaded one.
+    if (active_connections_.compare_exchange_strong(
+            active, active + 1, std::memory_order_acq_rel)) {
+      VLOG(1) << "Activated connection " << active;
+      best = active;
+    }
+  }
+
+  auto& load = loads_[best];
+  load.calls.fetch_add(1, std::memory_order_relaxed);
+  load.bytes.fetch_add(bytes, std::memory_order_relaxed);
+  return best;
+}
+
+void ProxyConnectionsLoad::Release(size_t idx, size_t bytes) {
+  auto& load = loads_[idx];
+  load.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  load.calls.fetch_sub(1, std::memory_order_relaxed);
+
+  // Deactivate the last active connection while it is idle and the other connections have
+  // spare capacity. Half of the thresholds are used, so connections are not activated and
+  // deactivated back and forth around the thresholds.
+  auto active = active_connections_.load(std::memory_order_acquire);
+  while (active > 1) {
+    if (loads_[active - 1].calls.load(std::memory_order_relaxed) != 0) {
+      return;
+    }
+    for (size_t i = 0; i != active - 1; ++i) {
+      if (IsLoaded(loads_[i], 2)) {
+        return;
+      }
+    }
+    if (active_connections_.compare_exchange_weak(
+            active, active - 1, std::memory_order_acq_rel)) {
+      --active;
+      VLOG(1) << "Deactivated connection " << active;
+    }
+  }
+}
+
+} // namespace rpc
+} // namespace yb
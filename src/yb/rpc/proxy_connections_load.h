@@ -0,0 +1,69 @@
+//
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+#ifndef YB_RPC_PROXY_CONNECTIONS_LOAD_H
+#define YB_RPC_PROXY_CONNECTIONS_LOAD_H
+
+#include <atomic>
+#include <memory>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+namespace rpc {
+
+// Tracks calls in flight over each of the connections a proxy uses to talk to a server, i.e.
+// calls that were queued to a connection and did not complete yet.
+//
+// Calls are sent over the active connection with the least bytes in flight. When all active
+// connections are loaded above rpc_connection_grow_threshold_bytes or
+// rpc_connection_grow_threshold_calls another connection is activated, up to the max number of
+// connections. While the last active connection is idle and the others are loaded below half of
+// the thresholds it is deactivated, and the reactor closes it once it is idle for
+// rpc_connection_timeout_ms.
+class ProxyConnectionsLoad {
+ public:
+  explicit ProxyConnectionsLoad(size_t max_connections);
+
+  // Picks the connection for a call of the specified size, and accounts the call to it.
+  // Returns the index of the connection.
+  size_t Acquire(size_t bytes);
+
+  // Should be invoked when the call accounted by Acquire completes.
+  void Release(size_t idx, size_t bytes);
+
+  size_t active_connections() const {
+    return active_connections_.load(std::memory_order_acquire);
+  }
+
+ private:
+  struct ConnectionLoad {
+    std::atomic<size_t> calls{0};
+    std::atomic<size_t> bytes{0};
+  };
+
+  // Whether the connection load is at or above the thresholds divided by divisor.
+  static bool IsLoaded(const ConnectionLoad& load, size_t divisor);
+
+  const size_t max_connections_;
+  std::unique_ptr<ConnectionLoad[]> loads_;
+  std::atomic<size_t> active_connections_{1};
+
+  DISALLOW_COPY_AND_ASSIGN(ProxyConnectionsLoad);
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_PROXY_CONNECTIONS_LOAD_H
@@ -33,8 +33,13 @@
 #include <string>
 #include <thread>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#ifdef TCMALLOC_ENABLED
+#include <gperftools/malloc_hook.h>
+#endif
+
 #include "yb/rpc/rpc-test-base.h"
 #include "yb/rpc/rtest.proxy.h"
 #include "yb/util/countdown_latch.h"
@@ -45,9 +50,24 @@ using namespace std::literals; // NOLINT
 using std::string;
 using std::shared_ptr;
 
+DECLARE_bool(tcp_stream_stop_io_after_partial_transfer);
+DECLARE_bool(rpc_handle_non_blocking_calls_inline);
+
 namespace yb {
 namespace rpc {
 
+namespace {
+
+#ifdef TCMALLOC_ENABLED
+std::atomic<uint64_t> num_allocations{0};
+
+void CountAllocation(const void* ptr, size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+} // namespace
+
 class RpcBench : public RpcTestBase {
  public:
   RpcBench() {}
@@ -55,6 +75,8 @@ class RpcBench : public RpcTestBase {
  protected:
   friend class ClientThread;
 
+  void RunBenchmark();
+
   HostPort server_hostport_;
   std::atomic<bool> should_run_{true};
 };
@@ -100,8 +122,7 @@ class ClientThread {
 };
 
 
-// Test making successful RPC calls.
-TEST_F(RpcBench, BenchmarkCalls) {
+void RpcBench::RunBenchmark() {
   TestServerOptions options;
   options.n_worker_threads = 1;
 
@@ -114,6 +135,11 @@ TEST_F(RpcBench, BenchmarkCalls) {
   client_options.n_reactors = 2;
   auto client_messenger = CreateAutoShutdownMessengerHolder("Client", client_options);
 
+#ifdef TCMALLOC_ENABLED
+  ASSERT_TRUE(MallocHook::AddNewHook(&CountAllocation));
+  const auto allocations_before = num_allocations.load(std::memory_order_relaxed);
+#endif
+
   Stopwatch sw(Stopwatch::ALL_THREADS);
   sw.start();
 
@@ -140,6 +166,11 @@ TEST_F(RpcBench, BenchmarkCalls) {
   }
   sw.stop();
 
+#ifdef TCMALLOC_ENABLED
+  ASSERT_TRUE(MallocHook::RemoveNewHook(&CountAllocation));
+  const auto allocations = num_allocations.load(std::memory_order_relaxed) - allocations_before;
+#endif
+
   float reqs_per_second = static_cast<float>(total_reqs / sw.elapsed().wall_seconds());
   float user_cpu_micros_per_req = static_cast<float>(sw.elapsed().user / 1000.0 / total_reqs);
   float sys_cpu_micros_per_req = static_cast<float>(sw.elapsed().system / 1000.0 / total_reqs);
@@ -147,6 +178,28 @@ TEST_F(RpcBench, BenchmarkCalls) {
   LOG(INFO) << "Reqs/sec:         " << reqs_per_second;
   LOG(INFO) << "User CPU per req: " << user_cpu_micros_per_req << "us";
   LOG(INFO) << "Sys CPU per req:  " << sys_cpu_micros_per_req << "us";
+#ifdef TCMALLOC_ENABLED
+  LOG(INFO) << "Allocs per req:   " << static_cast<double>(allocations) / total_reqs;
+#endif
+}
+
+// Test making successful RPC calls.
+TEST_F(RpcBench, BenchmarkCalls) {
+  RunBenchmark();
+}
+
+// The same benchmark with streams retrying receives and sends until they fail with EAGAIN, to
+// compare the syscall overhead with BenchmarkCalls.
+TEST_F(RpcBench, BenchmarkCallsWithIoUntilEagain) {
+  FLAGS_tcp_stream_stop_io_after_partial_transfer = false;
+  RunBenchmark();
+}
+
+// The same benchmark with Add, that the test service declares non-blocking, invoked on the
+// reactor thread, to compare the cost of the handoff to worker threads with BenchmarkCalls.
+TEST_F(RpcBench, BenchmarkCallsHandledInline) {
+  FLAGS_rpc_handle_non_blocking_calls_inline = true;
+  RunBenchmark();
 }
 
 } // namespace rpc
@@ -204,6 +204,10 @@ class CalculatorService: public CalculatorServiceIf {
     context.RespondSuccess();
   }
 
+  bool IsNonBlockingMethod(const std::string& method_name) const override {
+    return method_name == CalculatorServiceMethods::kAddMethodName;
+  }
+
   void Sleep(const SleepRequestPB* req, SleepResponsePB* resp, RpcContext context) override {
     if (req->return_app_error()) {
       CalculatorError my_error;
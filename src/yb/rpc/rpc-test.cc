@@ -44,12 +44,16 @@
 
 #if defined(TCMALLOC_ENABLED)
 #include <gperftools/heap-profiler.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 #endif
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 
+#include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/rpc/secure_stream.h"
 #include "yb/rpc/serialization.h"
 #include "yb/rpc/tcp_stream.h"
@@ -58,12 +62,15 @@
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
 #include "yb/util/logging_test_util.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/test_util.h"
 
 #include "yb/util/memory/memory_usage_test_util.h"
 
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
+METRIC_DECLARE_counter(rpc_inbound_calls_cancelled);
 
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
   "Number of iterations in TestRpc.TestConnectionKeepalive");
@@ -75,6 +82,13 @@ DECLARE_int64(memory_limit_hard_bytes);
 DECLARE_bool(TEST_pause_calculator_echo_request);
 DECLARE_bool(binary_call_parser_reject_on_mem_tracker_hard_limit);
 DECLARE_string(vmodule);
+DECLARE_string(rpc_scheduling_classes);
+DECLARE_string(rpc_scheduling_class_methods);
+DECLARE_bool(enable_rpc_compression);
+DECLARE_string(rpc_compressed_services);
+DECLARE_string(rpc_capture_dir);
+DECLARE_string(rpc_capture_methods);
+DECLARE_double(rpc_capture_sample_ratio);
 
 using namespace std::chrono_literals;
 using std::string;
@@ -432,6 +446,117 @@ TEST_F(TestRpc, TestRpcSidecar) {
   DoTestSidecar(&p, sizes);
 }
 
+// Test that serialized request fields are sent as a part of the request.
+TEST_F(TestRpc, TestSerializedRequestFields) {
+  // Set up server.
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  // Set up client.
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const std::string kSerializedData(100_KB, 'S');
+  RefCntBuffer field(
+      1 + google::protobuf::io::CodedOutputStream::VarintSize32(kSerializedData.size()) +
+      kSerializedData.size());
+  auto* dst = google::protobuf::io::CodedOutputStream::WriteTagToArray(
+      google::protobuf::internal::WireFormatLite::MakeTag(
+          rpc_test::EchoRequestPB::kDataFieldNumber,
+          google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED),
+      field.udata());
+  dst = google::protobuf::io::CodedOutputStream::WriteStringWithSizeToArray(kSerializedData, dst);
+  ASSERT_EQ(field.udata() + field.size(), dst);
+
+  // Serialized field follows the message, so it overrides the value set in the message.
+  rpc_test::EchoRequestPB req;
+  req.set_data("data");
+  rpc_test::EchoResponsePB resp;
+  RpcController controller;
+  controller.set_timeout(MonoDelta::FromSeconds(10));
+  controller.AddSerializedRequestField(field);
+  ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+  ASSERT_EQ(kSerializedData, resp.data());
+
+  // Fields are cleared by reset.
+  controller.Reset();
+  ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+  ASSERT_EQ("data", resp.data());
+}
+
+// Test that large bodies are compressed in both directions, once the client learns that the
+// server accepts compressed requests.
+TEST_F(TestRpc, TestCompression) {
+  FLAGS_enable_rpc_compression = true;
+  FLAGS_rpc_compressed_services = rpc_test::CalculatorServiceIf::static_service_name();
+  // Send both calls over the same connection.
+  FLAGS_num_connections_to_server = 1;
+
+  // Set up server.
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+
+  // Set up client.
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  const std::string kData(1_MB, 'C');
+  for (int i = 0; i != 2; ++i) {
+    rpc_test::EchoRequestPB req;
+    req.set_data(kData);
+    rpc_test::EchoResponsePB resp;
+    RpcController controller;
+    controller.set_timeout(MonoDelta::FromSeconds(10));
+    ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+    ASSERT_EQ(kData, resp.data());
+  }
+
+  DumpRunningRpcsRequestPB dump_req;
+  DumpRunningRpcsResponsePB dump_resp;
+  ASSERT_OK(client_messenger->DumpRunningRpcs(dump_req, &dump_resp));
+  ASSERT_EQ(1, dump_resp.outbound_connections_size());
+  const auto& connection = dump_resp.outbound_connections(0);
+  LOG(INFO) << "Client connection: " << connection.ShortDebugString();
+  // Only the second request is compressed, since the first one was sent before the client got
+  // a response from the server.
+  ASSERT_GT(connection.sent_bytes_before_compression(), kData.size());
+  ASSERT_LT(connection.sent_bytes_before_compression(), 2 * kData.size());
+  ASSERT_LT(connection.sent_bytes_after_compression(), kData.size() / 10);
+  ASSERT_GT(connection.received_bytes_before_compression(), 2 * kData.size());
+  ASSERT_LT(connection.received_bytes_after_compression(), kData.size() / 10);
+}
+
+// Test that calls being handled are cancelled when the client disconnects.
+TEST_F(TestRpc, CancelCallsOnDisconnect) {
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  auto cancelled_calls = METRIC_rpc_inbound_calls_cancelled.Instantiate(
+      server_messenger()->metric_entity());
+
+  auto client_messenger = CreateMessenger("Client");
+  rpc_test::SleepRequestPB req;
+  req.set_sleep_micros(2 * 1000 * 1000);
+  rpc_test::SleepResponsePB resp;
+  RpcController controller;
+  controller.set_timeout(MonoDelta::FromSeconds(10));
+  CountDownLatch latch(1);
+  {
+    Proxy p(client_messenger.get(), server_addr);
+    p.AsyncRequest(CalculatorServiceMethods::SleepMethod(), req, &resp, &controller,
+                   [&latch]() { latch.CountDown(); });
+  }
+
+  // Wait until the server starts handling the call, then close the connection.
+  std::this_thread::sleep_for(500ms);
+  ASSERT_EQ(0, cancelled_calls->value());
+  client_messenger->Shutdown();
+  latch.Wait();
+  ASSERT_NOK(controller.status());
+
+  ASSERT_OK(WaitFor([&cancelled_calls] { return cancelled_calls->value() == 1; },
+                    5s, "Call cancelled"));
+}
+
 // Test that timeouts are properly handled.
 TEST_F(TestRpc, TestCallTimeout) {
   HostPort server_addr;
@@ -625,6 +750,129 @@ TEST_F(TestRpc, TestRpcHandlerLatencyMetric) {
   YB_ASSERT_TRUE(FindOrDie(metric_map, &METRIC_rpc_incoming_queue_time));
 }
 
+namespace {
+
+// Returns the number of the calls of the method recorded in the phase, 0 if there is no such
+// method, and stores the median time in p50_us.
+uint64_t PhaseCount(
+    Messenger* messenger, bool inbound, const std::string& method_name, const std::string& phase,
+    uint64_t* p50_us) {
+  DumpRpcPhasesResponsePB resp;
+  messenger->rpc_metrics().phases.Dump(&resp);
+  for (const auto& method : resp.methods()) {
+    if (method.inbound() != inbound || method.method_name() != method_name) {
+      continue;
+    }
+    for (const auto& phase_pb : method.phases()) {
+      if (phase_pb.phase() == phase) {
+        *p50_us = phase_pb.p50_us();
+        return phase_pb.count();
+      }
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+// Test the per method histograms of the call phases, on both the server and the client.
+TEST_F(TestRpc, PhaseMetrics) {
+  const uint64_t sleep_micros = 20 * 1000;
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  RpcController controller;
+  rpc_test::SleepRequestPB req;
+  req.set_sleep_micros(sleep_micros);
+  rpc_test::SleepResponsePB resp;
+  ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::SleepMethod(), req, &resp, &controller));
+
+  // The phases are recorded after the response is transferred and the callback is done, so they
+  // could be not there yet when the synchronous request returns.
+  uint64_t p50_us = 0;
+  ASSERT_OK(WaitFor([this, &p50_us] {
+    return PhaseCount(server_messenger(), true, "Sleep", "send", &p50_us) == 1;
+  }, 10s, "Server phases recorded"));
+  for (const auto* phase : {"queue", "parse", "handler", "serialize"}) {
+    ASSERT_EQ(1, PhaseCount(server_messenger(), true, "Sleep", phase, &p50_us)) << phase;
+    if (phase == std::string("handler")) {
+      // The histograms keep 2 significant digits.
+      ASSERT_GE(p50_us, sleep_micros * 99 / 100);
+    } else {
+      ASSERT_LT(p50_us, sleep_micros);
+    }
+  }
+
+  ASSERT_OK(WaitFor([&client_messenger, &p50_us] {
+    return PhaseCount(client_messenger.get(), false, "Sleep", "callback", &p50_us) == 1;
+  }, 10s, "Client phases recorded"));
+  for (const auto* phase : {"queue", "send"}) {
+    ASSERT_EQ(1, PhaseCount(client_messenger.get(), false, "Sleep", phase, &p50_us)) << phase;
+  }
+  ASSERT_EQ(1, PhaseCount(client_messenger.get(), false, "Sleep", "response", &p50_us));
+  ASSERT_GE(p50_us, sleep_micros * 99 / 100);
+}
+
+TEST_F(TestRpc, Capture) {
+  const auto capture_dir = JoinPathSegments(GetTestDataDirectory(), "capture");
+  ASSERT_OK(env_->CreateDir(capture_dir));
+  FLAGS_rpc_capture_dir = capture_dir;
+  FLAGS_rpc_capture_methods = Format(
+      "$0.Add, yb.tserver.TabletServerService.Read",
+      rpc_test::CalculatorServiceIf::static_service_name());
+  FLAGS_rpc_capture_sample_ratio = 1;
+
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr);
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  constexpr int kNumCalls = 3;
+  for (int i = 0; i != kNumCalls; ++i) {
+    RpcController controller;
+    rpc_test::AddRequestPB req;
+    req.set_x(i);
+    req.set_y(1);
+    rpc_test::AddResponsePB resp;
+    ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::AddMethod(), req, &resp, &controller));
+
+    // Not captured.
+    controller.Reset();
+    rpc_test::EchoRequestPB echo_req;
+    echo_req.set_data("echo");
+    rpc_test::EchoResponsePB echo_resp;
+    ASSERT_OK(p.SyncRequest(
+        CalculatorServiceMethods::EchoMethod(), echo_req, &echo_resp, &controller));
+  }
+  // Closes the capture.
+  server().service_pool().StartShutdown();
+
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(capture_dir, ExcludeDots::kTrue, &files));
+  ASSERT_EQ(1u, files.size());
+  std::unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(JoinPathSegments(capture_dir, files[0]), &file));
+  pb_util::ReadablePBContainerFile reader(std::move(file));
+  ASSERT_OK(reader.Init());
+  uint64_t prev_received_time_us = 0;
+  for (int i = 0; i != kNumCalls; ++i) {
+    CapturedRpcPB captured;
+    ASSERT_OK(reader.ReadNextPB(&captured));
+    ASSERT_EQ(rpc_test::CalculatorServiceIf::static_service_name(), captured.service_name());
+    ASSERT_EQ("Add", captured.method_name());
+    ASSERT_GE(captured.received_time_us(), prev_received_time_us);
+    prev_received_time_us = captured.received_time_us();
+    rpc_test::AddRequestPB req;
+    ASSERT_TRUE(req.ParseFromString(captured.request()));
+    ASSERT_EQ(i, req.x());
+  }
+  CapturedRpcPB captured;
+  ASSERT_TRUE(reader.ReadNextPB(&captured).IsEndOfFile());
+}
+
 TEST_F(TestRpc, TestRpcCallbackDestroysMessenger) {
   auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
   HostPort bad_addr;
@@ -734,6 +982,81 @@ TEST_F(TestRpc, QueueTimeout) {
   ASSERT_EQ(counter->value(), kCalls - 1);
 }
 
+// Send multiple long running calls of a scheduling class that allows a single call to be processed
+// at a time. They should be processed one by one, while calls of other classes are not delayed.
+TEST_F(TestRpc, SchedulingClassConcurrencyLimit) {
+  const MonoDelta kSleep = 200ms;
+  constexpr auto kCalls = 4;
+
+  const std::string service_name = rpc_test::CalculatorServiceIf::static_service_name();
+  FLAGS_rpc_scheduling_classes = "default:1:0,sleep:1:1";
+  FLAGS_rpc_scheduling_class_methods = Format(
+      "$0.$1=sleep", service_name, CalculatorServiceMethods::kSleepMethodName);
+
+  // Set up server.
+  TestServerOptions options;
+  options.n_worker_threads = kCalls;
+  HostPort server_addr;
+  StartTestServerWithGeneratedCode(&server_addr, options);
+
+  // Set up client.
+  auto client_messenger = CreateAutoShutdownMessengerHolder("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  CountDownLatch latch(kCalls);
+
+  struct Call {
+    rpc_test::SleepRequestPB req;
+    rpc_test::SleepResponsePB resp;
+    RpcController controller;
+  };
+  std::vector<Call> calls(kCalls);
+
+  auto start = MonoTime::Now();
+  for (auto& call : calls) {
+    call.req.set_sleep_micros(kSleep.ToMicroseconds());
+    call.controller.set_timeout(kSleep * kCalls * 5);
+    p.AsyncRequest(CalculatorServiceMethods::SleepMethod(), call.req, &call.resp,
+                   &call.controller, [&latch, &call] {
+      ASSERT_OK(call.controller.status());
+      latch.CountDown();
+    });
+  }
+
+  ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+  ASSERT_GE(latch.count(), static_cast<uint64_t>(kCalls - 1));
+
+  latch.Wait();
+  ASSERT_GE(MonoTime::Now() - start, kSleep * kCalls);
+
+  // Priority 2 puts the call to the second class, regardless of its method.
+  {
+    rpc_test::AddRequestPB req;
+    req.set_x(1);
+    req.set_y(2);
+    rpc_test::AddResponsePB resp;
+    RpcController controller;
+    controller.set_priority(2);
+    ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::AddMethod(), req, &resp, &controller));
+    ASSERT_EQ(3, resp.result());
+  }
+
+  auto metric_name = Format("rpc_incoming_queue_time_$0_sleep", service_name);
+  EscapeMetricNameForPrometheus(&metric_name);
+  Histogram* histogram = nullptr;
+  for (const auto& p : metric_entity()->UnsafeMetricsMapForTests()) {
+    if (p.first->name() == metric_name) {
+      histogram = down_cast<Histogram*>(p.second.get());
+      break;
+    }
+  }
+
+  ASSERT_NE(histogram, nullptr);
+  ASSERT_EQ(static_cast<uint64_t>(kCalls + 1), histogram->TotalCount());
+  ASSERT_GE(histogram->MaxValueForTests(),
+            static_cast<uint64_t>(kSleep.ToMicroseconds() * (kCalls - 1) / 2));
+}
+
 struct DisconnectShare {
   Proxy proxy;
   size_t left;
@@ -0,0 +1,147 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/rpc/rpc_capture.h"
+
+#include <unistd.h>
+
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/strings/split.h"
+#include "yb/gutil/strings/util.h"
+#include "yb/gutil/walltime.h"
+
+#include "yb/rpc/inbound_call.h"
+#include "yb/rpc/rpc_introspection.pb.h"
+
+#include "yb/util/env.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
+#include "yb/util/random_util.h"
+
+DEFINE_string(rpc_capture_dir, "",
+              "Directory to capture a sample of the inbound calls to, so they could be replayed "
+              "with yb-rpc-replay. Empty to disable the capture. Only read when the services are "
+              "started.");
+TAG_FLAG(rpc_capture_dir, advanced);
+
+DEFINE_string(rpc_capture_methods,
+              "yb.tserver.TabletServerService.Read,yb.tserver.TabletServerService.Write",
+              "Comma separated list of the <service name>.<method name> of the captured calls.");
+TAG_FLAG(rpc_capture_methods, advanced);
+
+DEFINE_double(rpc_capture_sample_ratio, 0.01,
+              "Fraction of the calls of the captured methods that are captured.");
+TAG_FLAG(rpc_capture_sample_ratio, advanced);
+TAG_FLAG(rpc_capture_sample_ratio, runtime);
+
+DEFINE_int64(rpc_capture_max_bytes, 1024 * 1024 * 1024,
+             "The capture of the calls of a service stops once its file reaches this size.");
+TAG_FLAG(rpc_capture_max_bytes, advanced);
+TAG_FLAG(rpc_capture_max_bytes, runtime);
+
+namespace yb {
+namespace rpc {
+
+std::unique_ptr<RpcCapture> RpcCapture::Create(const std::string& service_name) {
+  if (FLAGS_rpc_capture_dir.empty()) {
+    return nullptr;
+  }
+  const auto prefix = service_name + ".";
+  std::unordered_set<std::string> methods;
+  std::vector<std::string> entries =
+      strings::Split(FLAGS_rpc_capture_methods, ",", strings::SkipWhitespace());
+  for (const auto& entry : entries) {
+    if (HasPrefixString(entry, prefix)) {
+      methods.insert(entry.substr(prefix.size()));
+    }
+  }
+  if (methods.empty()) {
+    return nullptr;
+  }
+  auto path = JoinPathSegments(
+      FLAGS_rpc_capture_dir,
+      Format("$0.$1.$2.rpc_capture", service_name, getpid(), GetCurrentTimeMicros()));
+  return std::unique_ptr<RpcCapture>(
+      new RpcCapture(service_name, std::move(methods), std::move(path)));
+}
+
+RpcCapture::RpcCapture(std::string service_name, std::unordered_set<std::string> methods,
+                       std::string path)
+    : service_name_(std::move(service_name)), methods_(std::move(methods)),
+      path_(std::move(path)) {
+}
+
+RpcCapture::~RpcCapture() {
+  Close();
+}
+
+void RpcCapture::MaybeCapture(const InboundCall& call) {
+  if (stopped_.load(std::memory_order_acquire) || methods_.count(call.method_name()) == 0 ||
+      !RandomActWithProbability(FLAGS_rpc_capture_sample_ratio)) {
+    return;
+  }
+  auto status = DoCapture(call);
+  if (!status.ok()) {
+    LOG(WARNING) << "Stopped capturing the calls of " << service_name_ << " to " << path_
+                 << ": " << status;
+    stopped_.store(true, std::memory_order_release);
+  }
+}
+
+Status RpcCapture::DoCapture(const InboundCall& call) {
+  CapturedRpcPB captured;
+  captured.set_service_name(service_name_);
+  captured.set_method_name(call.method_name());
+  captured.set_received_time_us(
+      GetCurrentTimeMicros() - call.GetTimeInQueue().ToMicroseconds());
+  captured.set_request(call.serialized_request().cdata(), call.serialized_request().size());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopped_.load(std::memory_order_acquire)) {
+    return Status::OK();
+  }
+  if (!file_) {
+    std::unique_ptr<WritableFile> out;
+    RETURN_NOT_OK(Env::Default()->NewWritableFile(path_, &out));
+    file_.reset(new pb_util::WritablePBContainerFile(std::move(out)));
+    RETURN_NOT_OK(file_->Init(captured));
+    LOG(INFO) << "Capturing the calls of " << service_name_ << " to " << path_;
+  }
+  RETURN_NOT_OK(file_->Append(captured));
+  bytes_written_ += captured.ByteSize();
+  if (bytes_written_ >= FLAGS_rpc_capture_max_bytes) {
+    LOG(INFO) << "Captured " << bytes_written_ << " bytes of the calls of " << service_name_
+              << " to " << path_ << ", stopping the capture";
+    stopped_.store(true, std::memory_order_release);
+    return file_->Close();
+  }
+  return Status::OK();
+}
+
+void RpcCapture::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopped_.store(true, std::memory_order_release);
+  if (file_) {
+    WARN_NOT_OK(file_->Close(), "Failed to close " + path_);
+  }
+}
+
+} // namespace rpc
+} // namespace yb
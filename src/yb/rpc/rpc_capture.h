@@ -0,0 +1,79 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_RPC_RPC_CAPTURE_H
+#define YB_RPC_RPC_CAPTURE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+namespace pb_util {
+
+class WritablePBContainerFile;
+
+} // namespace pb_util
+
+namespace rpc {
+
+// Captures a sample of the inbound calls of the methods of a service listed in
+// rpc_capture_methods, to a file of CapturedRpcPB in rpc_capture_dir, so the traffic could be
+// replayed with yb-rpc-replay. The capture stops once the file reaches rpc_capture_max_bytes.
+class RpcCapture {
+ public:
+  // Returns null if the capture is disabled, or no method of the service is captured.
+  static std::unique_ptr<RpcCapture> Create(const std::string& service_name);
+
+  ~RpcCapture();
+
+  // Captures the call if it is of a captured method, and is sampled.
+  void MaybeCapture(const InboundCall& call);
+
+  void Close();
+
+  const std::string& path() const {
+    return path_;
+  }
+
+ private:
+  RpcCapture(std::string service_name, std::unordered_set<std::string> methods,
+             std::string path);
+
+  CHECKED_STATUS DoCapture(const InboundCall& call);
+
+  const std::string service_name_;
+  const std::unordered_set<std::string> methods_;
+  const std::string path_;
+
+  // Set once the capture was stopped, because the file is full, failed or was closed.
+  std::atomic<bool> stopped_{false};
+
+  std::mutex mutex_;
+  // The file is opened on the first captured call.
+  std::unique_ptr<pb_util::WritablePBContainerFile> file_;
+  size_t bytes_written_ = 0;
+};
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_RPC_CAPTURE_H
@@ -45,6 +45,7 @@
 #include "yb/rpc/reactor.h"
 #include "yb/rpc/yb_rpc.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/hdr_histogram.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
@@ -55,6 +56,12 @@
 using google::protobuf::Message;
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_bool(rpc_use_call_arena, false,
+            "Allocate the request and response messages of inbound calls on a protobuf arena "
+            "per call. Only applies to the messages of files with cc_enable_arenas.");
+TAG_FLAG(rpc_use_call_arena, advanced);
+TAG_FLAG(rpc_use_call_arena, runtime);
+
 namespace yb {
 namespace rpc {
 
@@ -197,6 +204,10 @@ CoarseTimePoint RpcContext::GetClientDeadline() const {
   return call_->GetClientDeadline();
 }
 
+bool RpcContext::cancelled() const {
+  return call_->cancelled();
+}
+
 Trace* RpcContext::trace() {
   return call_->trace();
 }
@@ -231,6 +242,21 @@ std::string RpcContext::ToString() const {
   return call_->ToString();
 }
 
+std::shared_ptr<google::protobuf::Arena> MakeCallArena() {
+  // Most requests fit into the first block. Blocks are cached by the threads, so a call handled
+  // by a single thread usually does not call malloc for them.
+  constexpr size_t kStartBlockSize = 4096;
+  constexpr size_t kMaxBlockSize = 64 * 1024;
+
+  if (!FLAGS_rpc_use_call_arena) {
+    return nullptr;
+  }
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = kStartBlockSize;
+  options.max_block_size = kMaxBlockSize;
+  return std::make_shared<google::protobuf::Arena>(options);
+}
+
 void PanicRpc(RpcContext* context, const char* file, int line_number, const std::string& message) {
   if (context) {
     context->Panic(file, line_number, message);
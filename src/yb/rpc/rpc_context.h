@@ -32,7 +32,11 @@
 #ifndef YB_RPC_RPC_CONTEXT_H
 #define YB_RPC_RPC_CONTEXT_H
 
+#include <memory>
 #include <string>
+#include <type_traits>
+
+#include <google/protobuf/arena.h>
 
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/rpc/rpc_header.pb.h"
@@ -198,6 +202,10 @@ class RpcContext {
   // If the client did not specify a deadline, returns MonoTime::Max().
   CoarseTimePoint GetClientDeadline() const;
 
+  // Whether the call was cancelled, for instance because the client disconnected, so the response
+  // would not be received.
+  bool cancelled() const;
+
   // Panic the server. This logs a fatal error with the given message, and
   // also includes the current RPC request, requestor, trace information, etc,
   // to make it easier to debug.
@@ -224,6 +232,40 @@ class RpcContext {
 
 void PanicRpc(RpcContext* context, const char* file, int line_number, const std::string& message);
 
+// Creates the arena for the request and response messages of an inbound call, so their fields are
+// allocated in a few blocks and freed at once when the call is done. Returns null when
+// rpc_use_call_arena is off. Called only from generated code.
+std::shared_ptr<google::protobuf::Arena> MakeCallArena();
+
+namespace detail {
+
+template <class Message>
+std::shared_ptr<Message> MakeCallMessage(
+    const std::shared_ptr<google::protobuf::Arena>& arena, std::true_type) {
+  return std::shared_ptr<Message>(
+      arena, google::protobuf::Arena::CreateMessage<Message>(arena.get()));
+}
+
+template <class Message>
+std::shared_ptr<Message> MakeCallMessage(
+    const std::shared_ptr<google::protobuf::Arena>& arena, std::false_type) {
+  return std::make_shared<Message>();
+}
+
+} // namespace detail
+
+// Creates a message on the arena, the message keeps the arena alive. Messages of the files without
+// cc_enable_arenas cannot be created on an arena, so they are allocated on the heap.
+template <class Message>
+std::shared_ptr<Message> MakeCallMessage(const std::shared_ptr<google::protobuf::Arena>& arena) {
+  if (!arena) {
+    return std::make_shared<Message>();
+  }
+  return detail::MakeCallMessage<Message>(
+      arena, std::integral_constant<
+          bool, google::protobuf::Arena::is_arena_constructable<Message>::value>());
+}
+
 #define PANIC_RPC(rpc_context, message) \
   do { \
     yb::rpc::PanicRpc((rpc_context), __FILE__, __LINE__, (message)); \
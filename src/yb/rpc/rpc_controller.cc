@@ -70,6 +70,17 @@ void RpcController::Swap(RpcController* other) {
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
   std::swap(invoke_callback_mode_, other->invoke_callback_mode_);
+  std::swap(priority_, other->priority_);
+  serialized_request_fields_.swap(other->serialized_request_fields_);
+}
+
+void RpcController::ShareFinishedCall(const RpcController& other) {
+  CHECK(other.finished());
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (call_) {
+    CHECK(finished());
+  }
+  call_ = other.call_;
 }
 
 void RpcController::Reset() {
@@ -78,6 +89,7 @@ void RpcController::Reset() {
     CHECK(finished());
   }
   call_.reset();
+  serialized_request_fields_.clear();
 }
 
 bool RpcController::finished() const {
@@ -33,6 +33,7 @@
 #define YB_RPC_RPC_CONTROLLER_H
 
 #include <memory>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -40,6 +41,7 @@
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -77,6 +79,10 @@ class RpcController {
   // etc) with another one.
   void Swap(RpcController* other);
 
+  // Makes this controller report the result of the finished call made with the other controller.
+  // Used when requests of several callers were combined into a single call.
+  void ShareFinishedCall(const RpcController& other);
+
   // Reset this controller so it may be used with another call.
   // Note that reset doesn't reset controller's properties except the call itself.
   void Reset();
@@ -143,6 +149,26 @@ class RpcController {
 
   InvokeCallbackMode invoke_callback_mode() { return invoke_callback_mode_; }
 
+  // Sets the priority the call is scheduled with by the server, when the service has scheduling
+  // classes configured by rpc_scheduling_classes. Priority N selects the N-th class, 0 (the
+  // default) lets the server pick the class by the method being called.
+  void set_priority(uint32_t priority) { priority_ = priority; }
+  uint32_t priority() const { return priority_; }
+
+  // Appends already serialized fields to the request. They are sent right after the serialized
+  // request message as its part, so the data should be valid wire encoding of request fields,
+  // i.e. tag followed by value. It allows several requests to share the serialized form of large
+  // repeated fields, instead of serializing them for each request.
+  //
+  // Should be called before the request is sent.
+  void AddSerializedRequestField(RefCntBuffer field) {
+    serialized_request_fields_.push_back(std::move(field));
+  }
+
+  const std::vector<RefCntBuffer>& serialized_request_fields() const {
+    return serialized_request_fields_;
+  }
+
   // Return the configured timeout.
   MonoDelta timeout() const;
 
@@ -166,6 +192,8 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
   InvokeCallbackMode invoke_callback_mode_ = InvokeCallbackMode::kThreadPool;
+  uint32_t priority_ = 0;
+  std::vector<RefCntBuffer> serialized_request_fields_;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
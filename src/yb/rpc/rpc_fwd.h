@@ -51,6 +51,7 @@ class GrowableBufferAllocator;
 class MessengerBuilder;
 class Proxy;
 class ProxyCache;
+class ProxyConnectionsLoad;
 class Reactor;
 class ReactorTask;
 class RpcConnectionPB;
@@ -102,8 +103,6 @@ class ErrorStatusPB;
 
 typedef boost::asio::io_service IoService;
 
-typedef std::function<int(const std::string&, const std::string&)> Publisher;
-
 // SteadyTimePoint is something like MonoTime, but 3rd party libraries know it and don't know about
 // our private MonoTime.
 typedef std::chrono::steady_clock::time_point SteadyTimePoint;
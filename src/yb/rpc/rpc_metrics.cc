@@ -13,6 +13,14 @@
 
 #include "yb/rpc/rpc_metrics.h"
 
+#include <cctype>
+#include <mutex>
+
+#include "yb/rpc/rpc_introspection.pb.h"
+
+#include "yb/util/format.h"
+#include "yb/util/hdr_histogram.h"
+
 METRIC_DEFINE_gauge_int64(server, rpc_connections_alive,
                           "Number of alive RPC connections.",
                           yb::MetricUnit::kConnections,
@@ -33,6 +41,12 @@ METRIC_DEFINE_counter(server, rpc_inbound_calls_created,
                       yb::MetricUnit::kRequests,
                       "Number of created RPC inbound calls.");
 
+METRIC_DEFINE_counter(server, rpc_inbound_calls_cancelled,
+                      "Number of cancelled RPC inbound calls.",
+                      yb::MetricUnit::kRequests,
+                      "Number of RPC inbound calls that were cancelled before completion, "
+                      "because the connection they were received on was closed.");
+
 METRIC_DEFINE_gauge_int64(server, rpc_outbound_calls_alive,
                           "Number of alive RPC outbound calls.",
                           yb::MetricUnit::kRequests,
@@ -46,12 +60,118 @@ METRIC_DEFINE_counter(server, rpc_outbound_calls_created,
 namespace yb {
 namespace rpc {
 
-RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
+namespace {
+
+// Returns the name of the phase as used in the metric names, e.g. "handler" for kHandler.
+template <class Phase>
+std::string PhaseName(Phase phase) {
+  auto result = ToString(phase).substr(1);
+  result[0] = std::tolower(result[0]);
+  return result;
+}
+
+} // namespace
+
+void IncrementPhaseHistogram(
+    const scoped_refptr<Histogram>& histogram, MonoTime start, MonoTime end) {
+  if (start.Initialized() && end.Initialized()) {
+    histogram->Increment(end.GetDeltaSince(start).ToMicroseconds());
+  }
+}
+
+RpcPhaseMetrics::RpcPhaseMetrics(const scoped_refptr<MetricEntity>& metric_entity)
+    : metric_entity_(metric_entity) {}
+
+RpcPhaseMetrics::~RpcPhaseMetrics() {}
+
+const InboundCallPhaseHistograms* RpcPhaseMetrics::Inbound(
+    const std::string& service_name, const std::string& method_name) {
+  return FindOrCreate("inbound", service_name, method_name, &inbound_);
+}
+
+const OutboundCallPhaseHistograms* RpcPhaseMetrics::Outbound(
+    const std::string& service_name, const std::string& method_name) {
+  return FindOrCreate("outbound", service_name, method_name, &outbound_);
+}
+
+template <class Phase>
+const CallPhaseHistograms<Phase>* RpcPhaseMetrics::FindOrCreate(
+    const char* direction, const std::string& service_name, const std::string& method_name,
+    MethodsMap<Phase>* map) {
+  if (!metric_entity_) {
+    return nullptr;
+  }
+  {
+    shared_lock<rw_spinlock> lock(mutex_);
+    auto service_it = map->find(service_name);
+    if (service_it != map->end()) {
+      auto method_it = service_it->second.find(method_name);
+      if (method_it != service_it->second.end()) {
+        return method_it->second.get();
+      }
+    }
+  }
+
+  std::lock_guard<rw_spinlock> lock(mutex_);
+  auto& histograms = (*map)[service_name][method_name];
+  if (!histograms) {
+    histograms.reset(new CallPhaseHistograms<Phase>);
+    for (auto phase : List(static_cast<Phase*>(nullptr))) {
+      auto name = PhaseName(phase);
+      auto id = Format("rpc_$0_$1_time_$2_$3", direction, name, service_name, method_name);
+      EscapeMetricNameForPrometheus(&id);
+      auto description = Format(
+          "Microseconds $0 $1.$2() RPC calls spend in the $3 phase", direction, service_name,
+          method_name, name);
+      (*histograms)[to_underlying(phase)] = metric_entity_->FindOrCreateHistogram(
+          std::unique_ptr<HistogramPrototype>(new OwningHistogramPrototype(
+              metric_entity_->prototype().name(), std::move(id), description,
+              MetricUnit::kMicroseconds, description, 60000000LU, 2)));
+    }
+  }
+  return histograms.get();
+}
+
+void RpcPhaseMetrics::Dump(DumpRpcPhasesResponsePB* resp) const {
+  shared_lock<rw_spinlock> lock(mutex_);
+  DumpMethods(true, inbound_, resp);
+  DumpMethods(false, outbound_, resp);
+}
+
+template <class Phase>
+void RpcPhaseMetrics::DumpMethods(
+    bool inbound, const MethodsMap<Phase>& map, DumpRpcPhasesResponsePB* resp) const {
+  for (const auto& service : map) {
+    for (const auto& method : service.second) {
+      auto* method_pb = resp->add_methods();
+      method_pb->set_service_name(service.first);
+      method_pb->set_method_name(method.first);
+      method_pb->set_inbound(inbound);
+      for (auto phase : List(static_cast<Phase*>(nullptr))) {
+        const auto* histogram = (*method.second)[to_underlying(phase)]->histogram();
+        auto* phase_pb = method_pb->add_phases();
+        phase_pb->set_phase(PhaseName(phase));
+        phase_pb->set_count(histogram->TotalCount());
+        if (histogram->TotalCount() == 0) {
+          continue;
+        }
+        phase_pb->set_mean_us(histogram->MeanValue());
+        phase_pb->set_p50_us(histogram->ValueAtPercentile(50));
+        phase_pb->set_p99_us(histogram->ValueAtPercentile(99));
+        phase_pb->set_max_us(histogram->MaxValue());
+      }
+    }
+  }
+}
+
+RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity)
+    : phases(metric_entity) {
   if (metric_entity) {
     connections_alive = METRIC_rpc_connections_alive.Instantiate(metric_entity, 0);
     connections_created = METRIC_rpc_connections_created.Instantiate(metric_entity);
     inbound_calls_alive = METRIC_rpc_inbound_calls_alive.Instantiate(metric_entity, 0);
     inbound_calls_created = METRIC_rpc_inbound_calls_created.Instantiate(metric_entity);
+    inbound_calls_cancelled = METRIC_rpc_inbound_calls_cancelled.Instantiate(metric_entity);
     outbound_calls_alive = METRIC_rpc_outbound_calls_alive.Instantiate(metric_entity, 0);
     outbound_calls_created = METRIC_rpc_outbound_calls_created.Instantiate(metric_entity);
   }
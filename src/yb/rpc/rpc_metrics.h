@@ -14,11 +14,77 @@
 #ifndef YB_RPC_RPC_METRICS_H
 #define YB_RPC_RPC_METRICS_H
 
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "yb/util/enums.h"
+#include "yb/util/locks.h"
 #include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
 
 namespace yb {
 namespace rpc {
 
+class DumpRpcPhasesResponsePB;
+
+// Phases of processing an inbound call, in order: waiting in the service queue, parsing the
+// request, running the handler, serializing the response and sending it by the reactor.
+YB_DEFINE_ENUM(InboundCallPhase, (kQueue)(kParse)(kHandler)(kSerialize)(kSend));
+
+// Phases of an outbound call, in order: queueing to the reactor, sending the request, waiting for
+// the response and running the callback.
+YB_DEFINE_ENUM(OutboundCallPhase, (kQueue)(kSend)(kResponse)(kCallback));
+
+template <class Phase>
+using CallPhaseHistograms =
+    std::array<scoped_refptr<Histogram>, MapSize(static_cast<Phase*>(nullptr))>;
+
+typedef CallPhaseHistograms<InboundCallPhase> InboundCallPhaseHistograms;
+typedef CallPhaseHistograms<OutboundCallPhase> OutboundCallPhaseHistograms;
+
+// Increments the histogram by the time from start to end, if both of them were recorded.
+void IncrementPhaseHistogram(
+    const scoped_refptr<Histogram>& histogram, MonoTime start, MonoTime end);
+
+// Per method histograms of the time the calls spend in each of their phases, exported as the
+// metrics of the messenger entity and at /rpcz/phases. The histograms of a method are created by
+// its first call.
+class RpcPhaseMetrics {
+ public:
+  explicit RpcPhaseMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+  ~RpcPhaseMetrics();
+
+  // Return nullptr if there is no metric entity.
+  const InboundCallPhaseHistograms* Inbound(
+      const std::string& service_name, const std::string& method_name);
+  const OutboundCallPhaseHistograms* Outbound(
+      const std::string& service_name, const std::string& method_name);
+
+  void Dump(DumpRpcPhasesResponsePB* resp) const;
+
+ private:
+  // Histograms keyed by service name and method name.
+  template <class Phase>
+  using MethodsMap = std::unordered_map<
+      std::string, std::unordered_map<std::string, std::unique_ptr<CallPhaseHistograms<Phase>>>>;
+
+  template <class Phase>
+  const CallPhaseHistograms<Phase>* FindOrCreate(
+      const char* direction, const std::string& service_name, const std::string& method_name,
+      MethodsMap<Phase>* map);
+
+  template <class Phase>
+  void DumpMethods(
+      bool inbound, const MethodsMap<Phase>& map, DumpRpcPhasesResponsePB* resp) const;
+
+  scoped_refptr<MetricEntity> metric_entity_;
+  mutable rw_spinlock mutex_;
+  MethodsMap<InboundCallPhase> inbound_;
+  MethodsMap<OutboundCallPhase> outbound_;
+};
+
 struct RpcMetrics {
   explicit RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -26,8 +92,10 @@ struct RpcMetrics {
   scoped_refptr<Counter> connections_created;
   scoped_refptr<AtomicGauge<int64_t>> inbound_calls_alive;
   scoped_refptr<Counter> inbound_calls_created;
+  scoped_refptr<Counter> inbound_calls_cancelled;
   scoped_refptr<AtomicGauge<int64_t>> outbound_calls_alive;
   scoped_refptr<Counter> outbound_calls_created;
+  RpcPhaseMetrics phases;
 };
 
 } // namespace rpc
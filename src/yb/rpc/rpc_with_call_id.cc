@@ -58,6 +58,10 @@ Status ConnectionContextWithCallId::Store(InboundCall* call) {
 }
 
 void ConnectionContextWithCallId::Shutdown(const Status& status) {
+  // Nobody would receive responses to calls being handled, so they could stop early.
+  for (const auto& entry : calls_being_handled_) {
+    entry.second->Cancel();
+  }
 }
 
 void ConnectionContextWithCallId::CallProcessed(InboundCall* call) {
@@ -34,6 +34,8 @@ class ConnectionContextWithCallId : public ConnectionContextBase {
   }
 
   CHECKED_STATUS Store(InboundCall* call);
+  // Cancels calls being handled.
+  void Shutdown(const Status& status) override;
   void DumpPB(const DumpRunningRpcsRequestPB& req, RpcConnectionPB* resp) override;
 
   uint64_t ProcessedCallCount() override {
@@ -43,7 +45,6 @@ class ConnectionContextWithCallId : public ConnectionContextBase {
  private:
   virtual uint64_t ExtractCallId(InboundCall* call) = 0;
   void ListenIdle(IdleListener listener) override { idle_listener_ = std::move(listener); }
-  void Shutdown(const Status& status) override;
 
   bool Idle(std::string* reason_not_idle = nullptr) override;
 
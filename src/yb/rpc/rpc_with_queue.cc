@@ -64,15 +64,27 @@ void ConnectionContextWithQueue::Enqueue(std::shared_ptr<QueueableInboundCall> c
   if (size == replies_being_sent_ + 1) {
     first_without_reply_.store(call.get(), std::memory_order_release);
   }
-  if (size <= max_concurrent_calls_) {
-    reactor->messenger()->QueueInboundCall(call);
+  StartCalls(reactor);
+}
+
+void ConnectionContextWithQueue::StartCalls(Reactor* reactor) {
+  while (started_calls_ < calls_queue_.size() && started_calls_ < max_concurrent_calls_) {
+    // Calls that could not run concurrently are processed alone, so they see the effects of
+    // the calls received before them, and calls received after them see their effects.
+    if (started_calls_ != 0 &&
+        (!calls_queue_.front()->CouldRunConcurrently() ||
+         !calls_queue_[started_calls_]->CouldRunConcurrently())) {
+      break;
+    }
+    reactor->messenger()->QueueInboundCall(calls_queue_[started_calls_]);
+    ++started_calls_;
   }
 }
 
 void ConnectionContextWithQueue::Shutdown(const Status& status) {
   // Could erase calls, that we did not start to process yet.
-  if (calls_queue_.size() > max_concurrent_calls_) {
-    calls_queue_.erase(calls_queue_.begin() + max_concurrent_calls_, calls_queue_.end());
+  if (calls_queue_.size() > started_calls_) {
+    calls_queue_.erase(calls_queue_.begin() + started_calls_, calls_queue_.end());
   }
 
   for (auto& call : calls_queue_) {
@@ -95,10 +107,8 @@ void ConnectionContextWithQueue::CallProcessed(InboundCall* call) {
 
   calls_queue_.pop_front();
   --replies_being_sent_;
-  if (calls_queue_.size() >= max_concurrent_calls_) {
-    auto call_ptr = calls_queue_[max_concurrent_calls_ - 1];
-    reactor->messenger()->QueueInboundCall(call_ptr);
-  }
+  --started_calls_;
+  StartCalls(reactor);
   if (Idle() && idle_listener_) {
     idle_listener_();
   }
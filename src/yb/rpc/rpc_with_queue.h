@@ -53,6 +53,10 @@ class QueueableInboundCall : public InboundCall {
   // `weight_in_bytes` function is used to determine how many bytes consumes this call.
   size_t weight_in_bytes() const { return weight_in_bytes_; }
 
+  // Whether the call could be processed concurrently with other such calls received from the same
+  // connection. Other calls are processed alone, after all calls received before them.
+  virtual bool CouldRunConcurrently() const { return false; }
+
  private:
   std::atomic<bool> has_reply_{false};
   std::atomic<bool> aborted_{false};
@@ -91,20 +95,25 @@ class ConnectionContextWithQueue : public ConnectionContextBase {
   void ListenIdle(IdleListener listener) override { idle_listener_ = std::move(listener); }
 
   void CallProcessed(InboundCall* call);
+
+  // Starts processing of the queued calls that could be processed now.
+  void StartCalls(Reactor* reactor);
   void FlushOutboundQueue(Connection* conn);
   void FlushOutboundQueueAborted(const Status& status);
 
   const size_t max_concurrent_calls_;
   const size_t max_queued_bytes_;
   size_t replies_being_sent_ = 0;
+  size_t started_calls_ = 0;
   size_t queued_bytes_ = 0;
 
   // Calls that are being processed by this connection/context.
   // At the top or queue there are replies_being_sent_ calls, for which we are sending reply.
   // After that there are calls that are being processed.
   // first_without_reply_ points to the first of them.
-  // There are not more than max_concurrent_calls_ entries in first two groups.
-  // After end of queue there are calls that we received but processing did not start for them.
+  // There are started_calls_ entries in first two groups, not more than max_concurrent_calls_, and
+  // only one if the front call could not run concurrently.
+  // After them there are calls that we received but processing did not start for them.
   std::deque<std::shared_ptr<QueueableInboundCall>> calls_queue_;
   std::shared_ptr<ReactorTask> flush_outbound_queue_task_;
 
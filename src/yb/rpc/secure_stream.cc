@@ -24,6 +24,7 @@
 #include "yb/rpc/rpc_util.h"
 
 #include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/logging.h"
 #include "yb/util/scope_exit.h"
@@ -34,6 +35,12 @@ using namespace std::literals;
 
 DEFINE_bool(allow_insecure_connections, true, "Whether we should allow insecure connections.");
 DEFINE_bool(dump_certificate_entries, false, "Whether we should dump certificate entries.");
+DEFINE_int32(ssl_bio_buffer_size, 0,
+             "Size of the buffers used to pass data between the socket and the SSL engine of a "
+             "secure connection. Larger buffers let a big message be encrypted or decrypted in "
+             "fewer passes, each followed by a separate send or SSL_read loop, at the cost of "
+             "memory per connection. 0 means the OpenSSL default, which fits a single TLS record.");
+TAG_FLAG(ssl_bio_buffer_size, advanced);
 
 namespace yb {
 namespace rpc {
@@ -696,7 +703,8 @@ Status SecureStream::Init() {
 
     BIO* int_bio = nullptr;
     BIO* temp_bio = nullptr;
-    BIO_new_bio_pair(&int_bio, 0, &temp_bio, 0);
+    const size_t bio_buffer_size = std::max(FLAGS_ssl_bio_buffer_size, 0);
+    BIO_new_bio_pair(&int_bio, bio_buffer_size, &temp_bio, bio_buffer_size);
     SSL_set_bio(ssl_.get(), int_bio, int_bio);
     bio_.reset(temp_bio);
 
@@ -32,20 +32,47 @@
 
 #include "yb/rpc/serialization.h"
 
+#include <lz4.h>
+
 #include <google/protobuf/message_lite.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <glog/logging.h>
 
 #include "yb/gutil/endian.h"
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/stringprintf.h"
+#include "yb/rpc/call_data.h"
 #include "yb/rpc/constants.h"
 #include "yb/util/faststring.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
+using namespace yb::size_literals;
+
 DECLARE_int32(rpc_max_message_size);
 
+DEFINE_bool(enable_rpc_compression, false,
+            "Compress large bodies of RPC requests and responses of the services listed in "
+            "rpc_compressed_services with LZ4. A body is compressed only when the remote side "
+            "reported that it accepts compressed bodies, which it does when this flag is set "
+            "there.");
+TAG_FLAG(enable_rpc_compression, advanced);
+TAG_FLAG(enable_rpc_compression, runtime);
+
+DEFINE_int32(rpc_compression_min_body_size, 16_KB,
+             "Min size of an RPC message body to compress, smaller bodies are sent as is.");
+TAG_FLAG(rpc_compression_min_body_size, advanced);
+TAG_FLAG(rpc_compression_min_body_size, runtime);
+
+DEFINE_string(rpc_compressed_services,
+              "yb.consensus.ConsensusService,yb.tserver.RemoteBootstrapService,yb.cdc.CDCService",
+              "Comma separated list of services whose RPC bodies are compressed when "
+              "enable_rpc_compression is set.");
+TAG_FLAG(rpc_compressed_services, advanced);
+
 using google::protobuf::MessageLite;
 using google::protobuf::io::CodedInputStream;
 using google::protobuf::io::CodedOutputStream;
@@ -177,6 +204,67 @@ Status ParseYBMessage(const Slice& buf,
   return Status::OK();
 }
 
+bool ShouldCompressBody(const std::string& service_name, size_t body_size) {
+  if (!FLAGS_enable_rpc_compression ||
+      body_size < static_cast<size_t>(FLAGS_rpc_compression_min_body_size)) {
+    return false;
+  }
+  // Only large bodies get here, so splitting the flag is cheap compared to the compression.
+  std::vector<std::string> services = strings::Split(FLAGS_rpc_compressed_services, ",");
+  for (const auto& service : services) {
+    if (service == service_name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CompressBody(const Slice& body, RefCntBuffer* compressed) {
+  if (body.size() > LZ4_MAX_INPUT_SIZE) {
+    return false;
+  }
+  RefCntBuffer buffer(LZ4_compressBound(static_cast<int>(body.size())));
+  int size = LZ4_compress_default(
+      body.cdata(), buffer.data(), static_cast<int>(body.size()),
+      static_cast<int>(buffer.size()));
+  if (size <= 0 || static_cast<size_t>(size) >= body.size()) {
+    return false;
+  }
+  buffer.Shrink(size);
+  *compressed = std::move(buffer);
+  return true;
+}
+
+Status DecompressBody(const Slice& compressed, size_t uncompressed_size, CallData* output) {
+  if (uncompressed_size == 0 ||
+      uncompressed_size > static_cast<size_t>(FLAGS_rpc_max_message_size)) {
+    return STATUS_FORMAT(Corruption, "Bad uncompressed body size: $0", uncompressed_size);
+  }
+  CallData result(uncompressed_size);
+  int size = LZ4_decompress_safe(
+      compressed.cdata(), result.data(), static_cast<int>(compressed.size()),
+      static_cast<int>(uncompressed_size));
+  if (size < 0 || static_cast<size_t>(size) != uncompressed_size) {
+    return STATUS_FORMAT(
+        Corruption, "Failed to decompress body of $0 bytes to $1 bytes: $2",
+        compressed.size(), uncompressed_size, size);
+  }
+  *output = std::move(result);
+  return Status::OK();
+}
+
+Status SerializeHeaderAndBody(const MessageLite& header,
+                              const Slice& body,
+                              RefCntBuffer* buf) {
+  size_t body_with_delim = CodedOutputStream::VarintSize32(body.size()) + body.size();
+  size_t header_size = 0;
+  RETURN_NOT_OK(SerializeHeader(header, body_with_delim, buf, body_with_delim, &header_size));
+  uint8_t* dst = buf->udata() + header_size;
+  dst = CodedOutputStream::WriteVarint32ToArray(body.size(), dst);
+  memcpy(dst, body.data(), body.size());
+  return Status::OK();
+}
+
 }  // namespace serialization
 }  // namespace rpc
 }  // namespace yb
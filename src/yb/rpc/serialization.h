@@ -36,6 +36,8 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include <string>
+
 namespace google {
 namespace protobuf {
 class MessageLite;
@@ -50,6 +52,9 @@ class Slice;
 class Status;
 
 namespace rpc {
+
+struct CallData;
+
 namespace serialization {
 
 // Serialize the request param into a buffer which is allocated by this function.
@@ -95,6 +100,23 @@ Status ParseYBMessage(const Slice& buf,
                       google::protobuf::MessageLite* parsed_header,
                       Slice* parsed_main_message);
 
+// Returns true if a message body of the service, of the specified size, should be compressed,
+// provided that the remote side accepts compressed bodies. See enable_rpc_compression.
+bool ShouldCompressBody(const std::string& service_name, size_t body_size);
+
+// Compresses the message body, i.e. everything after the varint length of the main message, with
+// LZ4. Returns false and leaves 'compressed' untouched if compression would not shrink the body.
+bool CompressBody(const Slice& body, RefCntBuffer* compressed);
+
+// Decompresses the body compressed by CompressBody to 'output', allocated by this function.
+// 'uncompressed_size' is the size of the original body.
+Status DecompressBody(const Slice& compressed, size_t uncompressed_size, CallData* output);
+
+// Serializes the header followed by the varint prefixed body to a single buffer which is
+// allocated by this function.
+Status SerializeHeaderAndBody(const google::protobuf::MessageLite& header,
+                              const Slice& body,
+                              RefCntBuffer* buf);
 
 }  // namespace serialization
 }  // namespace rpc
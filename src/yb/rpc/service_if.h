@@ -68,6 +68,10 @@ class ServiceIf {
 
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
+
+  // Returns true if the handler of the method never blocks and is cheap, so it could be invoked
+  // right on the reactor thread that received the call, see rpc_handle_non_blocking_calls_inline.
+  virtual bool IsNonBlockingMethod(const std::string& method_name) const { return false; }
 };
 
 }  // namespace rpc
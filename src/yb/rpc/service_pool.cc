@@ -32,9 +32,13 @@
 
 #include "yb/rpc/service_pool.h"
 
+#include <algorithm>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <boost/asio/strand.hpp>
@@ -49,15 +53,21 @@
 
 #include "yb/rpc/inbound_call.h"
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_capture.h"
 #include "yb/rpc/scheduler.h"
 #include "yb/rpc/service_if.h"
 
+#include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/cancellation_token.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/lockfree.h"
+#include "yb/util/mem_attribution.h"
 #include "yb/util/metrics.h"
+#include "yb/util/result.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/status.h"
+#include "yb/util/stol_utils.h"
 #include "yb/util/thread.h"
 #include "yb/util/trace.h"
 
@@ -80,6 +90,29 @@ DEFINE_test_flag(bool, enable_backpressure_mode_for_testing, false,
             "For testing purposes. Enables the rpc's to be considered timed out in the queue even "
             "when we have not had any backpressure in the recent past.");
 
+DEFINE_bool(rpc_handle_non_blocking_calls_inline, false,
+            "Invoke handlers of methods declared non-blocking by their services right on the "
+            "reactor thread that received the call, instead of passing the call to a worker "
+            "thread.");
+TAG_FLAG(rpc_handle_non_blocking_calls_inline, advanced);
+TAG_FLAG(rpc_handle_non_blocking_calls_inline, runtime);
+
+DEFINE_string(rpc_scheduling_classes, "",
+              "Scheduling classes of inbound calls, applied to each service separately, as a "
+              "comma separated list of <name>:<weight>:<max_concurrency>. Queued calls of "
+              "different classes are picked for processing in proportion to the class weights, "
+              "and at most max_concurrency calls of a class, 0 for no limit, are processed by "
+              "worker threads at the same time. A call goes to the class selected by the priority "
+              "set by the client, N selecting the N-th class, otherwise to the class of its "
+              "method from rpc_scheduling_class_methods, otherwise to the first class. Empty to "
+              "process calls in the order they were received.");
+TAG_FLAG(rpc_scheduling_classes, advanced);
+DEFINE_string(rpc_scheduling_class_methods, "",
+              "Comma separated list of <service name>.<method name>=<class name>, assigning "
+              "methods to the classes of rpc_scheduling_classes, e.g. "
+              "yb.tserver.TabletServerService.Write=writes.");
+TAG_FLAG(rpc_scheduling_class_methods, advanced);
+
 METRIC_DEFINE_histogram(server, rpc_incoming_queue_time,
                         "RPC Queue Time",
                         yb::MetricUnit::kMicroseconds,
@@ -100,6 +133,13 @@ METRIC_DEFINE_counter(server, rpcs_timed_out_early_in_queue,
                       "in the service queue, and thus were not processed. "
                       "Timeout for those calls were detected before the calls tried to execute.");
 
+METRIC_DEFINE_counter(server, rpcs_cancelled_in_queue,
+                      "RPC Queue Cancellations",
+                      yb::MetricUnit::kRequests,
+                      "Number of RPCs that were cancelled, because the connection they were "
+                      "received on was closed, while waiting in the service queue, and thus "
+                      "were not processed.");
+
 METRIC_DEFINE_counter(server, rpcs_queue_overflow,
                       "RPC Queue Overflows",
                       yb::MetricUnit::kRequests,
@@ -114,6 +154,52 @@ namespace {
 const CoarseDuration kTimeoutCheckGranularity = 100ms;
 const char* const kTimedOutInQueue = "Call waited in the queue past deadline";
 
+struct CallClassOptions {
+  std::string name;
+  size_t weight;
+  size_t max_concurrency;
+};
+
+Result<std::vector<CallClassOptions>> ParseCallClasses(const std::string& input) {
+  std::vector<CallClassOptions> result;
+  std::vector<std::string> entries = strings::Split(input, ",", strings::SkipEmpty());
+  for (const auto& entry : entries) {
+    std::vector<std::string> fields = strings::Split(entry, ":");
+    if (fields.size() != 3 || fields[0].empty()) {
+      return STATUS_FORMAT(InvalidArgument, "Bad scheduling class: $0", entry);
+    }
+    auto weight = VERIFY_RESULT(CheckedStoi(fields[1]));
+    auto max_concurrency = VERIFY_RESULT(CheckedStoi(fields[2]));
+    if (weight <= 0 || max_concurrency < 0) {
+      return STATUS_FORMAT(InvalidArgument, "Bad scheduling class: $0", entry);
+    }
+    result.push_back(CallClassOptions{
+        fields[0], static_cast<size_t>(weight), static_cast<size_t>(max_concurrency)});
+  }
+  return result;
+}
+
+// Returns class names of the methods of the service, keyed by method name.
+Result<std::unordered_map<std::string, std::string>> ParseCallClassMethods(
+    const std::string& input, const std::string& service_name) {
+  std::unordered_map<std::string, std::string> result;
+  std::vector<std::string> entries = strings::Split(input, ",", strings::SkipEmpty());
+  for (const auto& entry : entries) {
+    std::vector<std::string> fields = strings::Split(entry, "=");
+    auto dot = fields[0].rfind('.');
+    if (fields.size() != 2 || dot == std::string::npos) {
+      return STATUS_FORMAT(InvalidArgument, "Bad scheduling class method: $0", entry);
+    }
+    if (fields[0].compare(0, dot, service_name) == 0 && dot == service_name.size()) {
+      result.emplace(fields[0].substr(dot + 1), fields[1]);
+    }
+  }
+  return result;
+}
+
+// Stride of a class with weight 1 in the stride scheduling of the classes.
+constexpr uint64_t kCallClassStride = 1 << 20;
+
 } // namespace
 
 class ServicePoolImpl final : public InboundCallHandler {
@@ -131,8 +217,10 @@ class ServicePoolImpl final : public InboundCallHandler {
         rpcs_timed_out_in_queue_(METRIC_rpcs_timed_out_in_queue.Instantiate(entity)),
         rpcs_timed_out_early_in_queue_(
             METRIC_rpcs_timed_out_early_in_queue.Instantiate(entity)),
+        rpcs_cancelled_in_queue_(METRIC_rpcs_cancelled_in_queue.Instantiate(entity)),
         rpcs_queue_overflow_(METRIC_rpcs_queue_overflow.Instantiate(entity)),
         check_timeout_strand_(scheduler->io_service()),
+        capture_(RpcCapture::Create(service_->service_name())),
         log_prefix_(Format("$0: ", service_->service_name())) {
 
           // Create per service counter for rpcs_in_queue_.
@@ -145,6 +233,8 @@ class ServicePoolImpl final : public InboundCallHandler {
                   description, MetricUnit::kRequests, description)),
               static_cast<int64>(0) /* initial_value */);
 
+          InitCallClasses(entity);
+
           LOG_WITH_PREFIX(INFO) << "yb::rpc::ServicePoolImpl created at " << this;
   }
 
@@ -164,6 +254,9 @@ class ServicePoolImpl final : public InboundCallHandler {
     bool closing_state = false;
     if (closing_.compare_exchange_strong(closing_state, true)) {
       service_->Shutdown();
+      if (capture_) {
+        capture_->Close();
+      }
 
       auto check_timeout_task = check_timeout_task_.load(std::memory_order_acquire);
       if (check_timeout_task != kUninitializedScheduledTaskId) {
@@ -175,6 +268,18 @@ class ServicePoolImpl final : public InboundCallHandler {
         while (pre_check_timeout_queue_.pop(inbound_call_wrapper)) {}
         shutdown_complete_latch_.CountDown();
       });
+
+      // Calls whose classes are at the concurrency limit have no dispatch left in the thread
+      // pool, so fail them here.
+      size_t deferred_dispatches;
+      {
+        std::lock_guard<std::mutex> lock(call_classes_mutex_);
+        deferred_dispatches = deferred_dispatches_;
+        deferred_dispatches_ = 0;
+      }
+      for (; deferred_dispatches != 0; --deferred_dispatches) {
+        FailQueuedCall(STATUS(Aborted, "Service is shutting down"));
+      }
     }
   }
 
@@ -187,12 +292,25 @@ class ServicePoolImpl final : public InboundCallHandler {
       return;
     }
 
+    if (GetAtomicFlag(&FLAGS_rpc_handle_non_blocking_calls_inline) &&
+        service_->IsNonBlockingMethod(call->method_name())) {
+      // Saves the handoff to a worker thread and back to the reactor for the response.
+      task->Run();
+      task->Done(Status::OK());
+      return;
+    }
+
     auto call_deadline = call->GetClientDeadline();
     if (call_deadline != CoarseTimePoint::max()) {
       pre_check_timeout_queue_.push(call);
       ScheduleCheckTimeout(call_deadline);
     }
 
+    if (!call_classes_.empty()) {
+      EnqueueToCallClass(call, task);
+      return;
+    }
+
     thread_pool_.Enqueue(task);
   }
 
@@ -247,11 +365,21 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
   void Handle(InboundCallPtr incoming) override {
+    ScopedAllocationTag allocation_tag("rpc_handler");
     incoming->RecordHandlingStarted(incoming_queue_time_);
+    incoming->StartTraceSpan();
     ADOPT_TRACE(incoming->trace());
 
     const char* error_message;
-    if (PREDICT_FALSE(incoming->ClientTimedOut())) {
+    if (PREDICT_FALSE(incoming->cancelled())) {
+      TRACE_TO(incoming->trace(), "Cancelled in queue");
+      if (incoming->TryStartProcessing()) {
+        rpcs_cancelled_in_queue_->Increment();
+        incoming->RespondFailure(
+            ErrorStatusPB::ERROR_SERVER_TOO_BUSY, STATUS(Aborted, "Call cancelled in queue"));
+      }
+      return;
+    } else if (PREDICT_FALSE(incoming->ClientTimedOut())) {
       error_message = kTimedOutInQueue;
     } else if (PREDICT_FALSE(ShouldDropRequestDuringHighLoad(incoming))) {
       error_message = "The server is overloaded. Call waited in the queue past max_time_in_queue.";
@@ -259,6 +387,13 @@ class ServicePoolImpl final : public InboundCallHandler {
       TRACE_TO(incoming->trace(), "Handling call");
 
       if (incoming->TryStartProcessing()) {
+        // Let long running parts of the handler, like DocDB scans, stop when the call is
+        // cancelled. The call is retained while its token is adopted.
+        auto call = incoming;
+        ScopedAdoptCancellationToken adopt_cancellation_token(&call->cancellation_token());
+        if (capture_) {
+          capture_->MaybeCapture(*call);
+        }
         service_->Handle(std::move(incoming));
       }
       return;
@@ -274,6 +409,181 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
  private:
+  struct QueuedCall {
+    InboundCallPtr call;
+    ThreadPoolTask* task;
+  };
+
+  struct CallClass {
+    std::string name;
+    uint64_t stride;
+    size_t max_concurrency;
+    scoped_refptr<Histogram> queue_time;
+
+    // Protected by call_classes_mutex_.
+    std::deque<QueuedCall> queue;
+    // Virtual time of the class in the stride scheduling, the class with the smallest pass is
+    // picked next, and its pass is advanced by its stride, inversely proportional to its weight.
+    uint64_t pass = 0;
+    // Number of calls of the class being processed.
+    size_t running = 0;
+  };
+
+  // Task that is put to the thread pool for each call queued to a call class. When run it
+  // processes the queued call picked by the class scheduling, which is not necessarily the call
+  // it was enqueued for.
+  class DispatchTask : public ThreadPoolTask {
+   public:
+    explicit DispatchTask(ServicePoolImpl* pool) : pool_(pool) {}
+
+    void Run() override {
+      pool_->RunQueuedCalls();
+    }
+
+    void Done(const Status& status) override {
+      if (!status.ok()) {
+        pool_->FailQueuedCall(status);
+      }
+    }
+
+    virtual ~DispatchTask() = default;
+
+   private:
+    ServicePoolImpl* const pool_;
+  };
+
+  void InitCallClasses(const scoped_refptr<MetricEntity>& entity) {
+    const auto& service_name = service_->service_name();
+    auto classes = ParseCallClasses(FLAGS_rpc_scheduling_classes);
+    auto methods = ParseCallClassMethods(FLAGS_rpc_scheduling_class_methods, service_name);
+    if (!classes.ok() || !methods.ok()) {
+      LOG_WITH_PREFIX(DFATAL)
+          << "Failed to parse scheduling classes, processing calls in FIFO order: "
+          << (classes.ok() ? methods.status() : classes.status());
+      return;
+    }
+
+    call_classes_.reserve(classes->size());
+    for (const auto& options : *classes) {
+      auto id = Format("rpc_incoming_queue_time_$0_$1", service_name, options.name);
+      EscapeMetricNameForPrometheus(&id);
+      string description = Format(
+          "Number of microseconds incoming RPC requests of $0 scheduling class spend in the "
+          "$1 queue", options.name, service_name);
+      CallClass call_class;
+      call_class.name = options.name;
+      call_class.stride = kCallClassStride / options.weight;
+      call_class.max_concurrency = options.max_concurrency;
+      call_class.queue_time = entity->FindOrCreateHistogram(
+          std::unique_ptr<HistogramPrototype>(new OwningHistogramPrototype(
+              entity->prototype().name(), std::move(id), description, MetricUnit::kMicroseconds,
+              description, 60000000LU, 3)));
+      call_classes_.push_back(std::move(call_class));
+    }
+
+    for (const auto& method_and_class : *methods) {
+      auto it = std::find_if(
+          call_classes_.begin(), call_classes_.end(), [&method_and_class](const CallClass& cls) {
+        return cls.name == method_and_class.second;
+      });
+      if (it == call_classes_.end()) {
+        LOG_WITH_PREFIX(DFATAL) << "Unknown scheduling class " << method_and_class.second
+                                << " of " << method_and_class.first;
+        continue;
+      }
+      method_call_classes_.emplace(method_and_class.first, &*it);
+    }
+  }
+
+  CallClass& CallClassOf(const InboundCall& call) {
+    auto priority = call.priority();
+    if (priority != 0) {
+      return call_classes_[std::min<size_t>(priority, call_classes_.size()) - 1];
+    }
+    auto it = method_call_classes_.find(call.method_name());
+    return it != method_call_classes_.end() ? *it->second : call_classes_.front();
+  }
+
+  void EnqueueToCallClass(const InboundCallPtr& call, ThreadPoolTask* task) {
+    auto& call_class = CallClassOf(*call);
+    {
+      std::lock_guard<std::mutex> lock(call_classes_mutex_);
+      if (call_class.queue.empty()) {
+        // Don't let a class that was idle catch up on the time it did not use.
+        call_class.pass = std::max(call_class.pass, global_pass_);
+      }
+      call_class.queue.push_back(QueuedCall{call, task});
+    }
+    thread_pool_.Enqueue(&dispatch_task_);
+  }
+
+  // Returns the class with queued calls and the smallest pass, that is not at its concurrency
+  // limit, or nullptr if there is no such class.
+  CallClass* PickCallClassUnlocked() {
+    CallClass* result = nullptr;
+    for (auto& call_class : call_classes_) {
+      if (call_class.queue.empty() ||
+          (call_class.max_concurrency != 0 &&
+           call_class.running >= call_class.max_concurrency)) {
+        continue;
+      }
+      if (!result || call_class.pass < result->pass) {
+        result = &call_class;
+      }
+    }
+    return result;
+  }
+
+  void RunQueuedCalls() {
+    for (;;) {
+      CallClass* call_class;
+      QueuedCall queued_call;
+      {
+        std::lock_guard<std::mutex> lock(call_classes_mutex_);
+        call_class = PickCallClassUnlocked();
+        if (!call_class) {
+          // All queued calls belong to classes at the concurrency limit. The dispatch is picked up
+          // by the thread that completes a call of such class.
+          ++deferred_dispatches_;
+          return;
+        }
+        queued_call = std::move(call_class->queue.front());
+        call_class->queue.pop_front();
+        ++call_class->running;
+        global_pass_ = call_class->pass;
+        call_class->pass += call_class->stride;
+      }
+
+      call_class->queue_time->Increment(queued_call.call->GetTimeInQueue().ToMicroseconds());
+      queued_call.task->Run();
+      queued_call.task->Done(Status::OK());
+      queued_call.call.reset();
+
+      std::lock_guard<std::mutex> lock(call_classes_mutex_);
+      --call_class->running;
+      if (deferred_dispatches_ == 0 || !PickCallClassUnlocked()) {
+        return;
+      }
+      --deferred_dispatches_;
+    }
+  }
+
+  void FailQueuedCall(const Status& status) {
+    QueuedCall queued_call;
+    {
+      std::lock_guard<std::mutex> lock(call_classes_mutex_);
+      auto it = std::find_if(
+          call_classes_.begin(), call_classes_.end(),
+          [](const CallClass& call_class) { return !call_class.queue.empty(); });
+      if (it == call_classes_.end()) {
+        return;
+      }
+      queued_call = std::move(it->queue.front());
+      it->queue.pop_front();
+    }
+    queued_call.task->Done(status);
+  }
+
   void TimedOut(InboundCall* call, const char* error_message, Counter* metric) {
     if (call->RespondTimedOutIfPending(error_message)) {
       metric->Increment();
@@ -406,6 +716,7 @@ class ServicePoolImpl final : public InboundCallHandler {
   scoped_refptr<Histogram> incoming_queue_time_;
   scoped_refptr<Counter> rpcs_timed_out_in_queue_;
   scoped_refptr<Counter> rpcs_timed_out_early_in_queue_;
+  scoped_refptr<Counter> rpcs_cancelled_in_queue_;
   scoped_refptr<Counter> rpcs_queue_overflow_;
   scoped_refptr<AtomicGauge<int64_t>> rpcs_in_queue_;
   // Have to use CoarseDuration here, since CoarseTimePoint does not work with clang + libstdc++
@@ -448,8 +759,21 @@ class ServicePoolImpl final : public InboundCallHandler {
 
   std::priority_queue<QueuedCheckDeadline> check_timeout_queue_;
 
+  // Scheduling classes of the calls, see rpc_scheduling_classes. Calls are processed in FIFO order
+  // when there are no classes.
+  std::vector<CallClass> call_classes_;
+  std::unordered_map<std::string, CallClass*> method_call_classes_;
+  std::mutex call_classes_mutex_;
+  // Pass of the last picked class.
+  uint64_t global_pass_ = 0;
+  // Number of dispatches that found no class to pick a call from.
+  size_t deferred_dispatches_ = 0;
+  DispatchTask dispatch_task_{this};
+
   std::atomic<bool> closing_ = {false};
   CountDownLatch shutdown_complete_latch_{1};
+  // Null unless calls of the service are captured for replaying, see rpc_capture_dir.
+  std::unique_ptr<RpcCapture> capture_;
   std::string log_prefix_;
 };
 
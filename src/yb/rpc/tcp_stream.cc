@@ -27,13 +27,19 @@ using namespace std::literals;
 DECLARE_uint64(rpc_connection_timeout_ms);
 DEFINE_test_flag(int32, TEST_delay_connect_ms, 0,
                  "Delay connect in tests for specified amount of milliseconds.");
+DEFINE_bool(tcp_stream_stop_io_after_partial_transfer, true,
+            "Wait for the next readiness event after a receive or send transferred less than "
+            "requested, since the socket is drained or its send buffer is full, instead of "
+            "trying the syscall again until it fails with EAGAIN.");
+TAG_FLAG(tcp_stream_stop_io_after_partial_transfer, advanced);
+TAG_FLAG(tcp_stream_stop_io_after_partial_transfer, runtime);
 
 namespace yb {
 namespace rpc {
 
 namespace {
 
-const size_t kMaxIov = 16;
+const size_t kMaxIov = 64;
 
 }
 
@@ -150,6 +156,7 @@ Status TcpStream::TryWrite() {
 TcpStream::FillIovResult TcpStream::FillIov(iovec* out) {
   int index = 0;
   size_t offset = send_position_;
+  size_t total_bytes = 0;
   bool only_heartbeats = true;
   for (auto& data : sending_) {
     const auto wrapped_data = data.data;
@@ -170,14 +177,15 @@ TcpStream::FillIovResult TcpStream::FillIov(iovec* out) {
 
       out[index].iov_base = bytes.data() + offset;
       out[index].iov_len = bytes.size() - offset;
+      total_bytes += out[index].iov_len;
       offset = 0;
       if (++index == kMaxIov) {
-        return FillIovResult{index, only_heartbeats};
+        return FillIovResult{index, total_bytes, only_heartbeats};
       }
     }
   }
 
-  return FillIovResult{index, only_heartbeats};
+  return FillIovResult{index, total_bytes, only_heartbeats};
 }
 
 Status TcpStream::DoWrite() {
@@ -237,6 +245,12 @@ Status TcpStream::DoWrite() {
         context_->Transferred(data, Status::OK());
       }
     }
+
+    // The send buffer is full, so the next writev would fail with EAGAIN.
+    if (static_cast<size_t>(written) < fill_result.bytes &&
+        FLAGS_tcp_stream_stop_io_after_partial_transfer) {
+      break;
+    }
   }
 
   return Status::OK();
@@ -322,6 +336,10 @@ Status TcpStream::ReadHandler() {
     if (!continue_receiving.get()) {
       return Status::OK();
     }
+    // The next receive would fail with EAGAIN, so wait for the next readiness event.
+    if (socket_drained_ && FLAGS_tcp_stream_stop_io_after_partial_transfer) {
+      return Status::OK();
+    }
   }
 }
 
@@ -364,6 +382,7 @@ Result<bool> TcpStream::Receive() {
     return nread.status();
   }
 
+  socket_drained_ = static_cast<size_t>(*nread) < IoVecsFullSize(*iov);
   ReadBuffer().DataAppended(*nread);
   return *nread != 0;
 }
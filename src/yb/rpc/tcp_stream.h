@@ -66,6 +66,8 @@ class TcpStream : public Stream {
  private:
   struct FillIovResult {
     int len;
+    // Total number of bytes in the filled iovecs.
+    size_t bytes;
     bool only_heartbeats;
   };
 
@@ -139,6 +141,10 @@ class TcpStream : public Stream {
 
   bool connected_ = false;
 
+  // Set when the last receive got less data than it asked for, i.e. there is nothing more to read
+  // from the socket at the moment.
+  bool socket_drained_ = false;
+
   bool read_buffer_full_ = false;
 
   std::deque<TcpStreamSendingData> sending_;
@@ -14,16 +14,23 @@
 //
 
 #include <atomic>
+#include <chrono>
 #include <thread>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include "yb/rpc/thread_pool.h"
 
 #include "yb/util/countdown_latch.h"
+#include "yb/util/format.h"
 #include "yb/util/test_util.h"
 #include "yb/util/thread.h"
 
+DECLARE_bool(rpc_thread_pool_work_stealing);
+
+using namespace std::literals;
+
 namespace yb {
 namespace rpc {
 
@@ -253,5 +260,112 @@ TEST_F(ThreadPoolTest, TestOwns) {
   ASSERT_TRUE(pool.Owns(task.thread()));
 }
 
+namespace {
+
+struct FanOutState {
+  ThreadPool* pool;
+  std::atomic<size_t> created{0};
+  std::atomic<size_t> done{0};
+  std::atomic<int64_t> total_latency_ns{0};
+};
+
+// Task that enqueues two tasks of lower depth from the worker, like a read fanning out to
+// tablets, so a tree of 2^(depth + 1) - 1 tasks is run for a root.
+class FanOutTask final : public ThreadPoolTask {
+ public:
+  FanOutTask(FanOutState* state, int depth) : state_(state), depth_(depth) {
+    ++state_->created;
+  }
+
+  void Enqueue() {
+    enqueue_time_ = std::chrono::steady_clock::now();
+    state_->pool->Enqueue(this);
+  }
+
+ private:
+  void Run() override {
+    state_->total_latency_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - enqueue_time_).count();
+    if (depth_ > 0) {
+      for (int i = 0; i != 2; ++i) {
+        (new FanOutTask(state_, depth_ - 1))->Enqueue();
+      }
+    }
+  }
+
+  void Done(const Status& status) override {
+    ++state_->done;
+    delete this;
+  }
+
+  FanOutState* const state_;
+  const int depth_;
+  std::chrono::steady_clock::time_point enqueue_time_;
+};
+
+void EnqueueFanOut(FanOutState* state, size_t producers, size_t roots, int depth) {
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != producers; ++i) {
+    threads.emplace_back([state, producers, roots, depth] {
+      CDSAttacher attacher;
+      for (size_t j = 0; j != roots / producers; ++j) {
+        (new FanOutTask(state, depth))->Enqueue();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace
+
+TEST_F(ThreadPoolTest, TestWorkStealing) {
+  constexpr size_t kTotalWorkers = 4;
+  constexpr size_t kProducers = 4;
+  constexpr size_t kRoots = 1000;
+  constexpr int kDepth = 6;
+
+  FLAGS_rpc_thread_pool_work_stealing = true;
+  ThreadPool pool("test", kRoots, kTotalWorkers);
+  FanOutState state;
+  state.pool = &pool;
+  EnqueueFanOut(&state, kProducers, kRoots, kDepth);
+  const size_t expected = kRoots * ((1 << (kDepth + 1)) - 1);
+  ASSERT_OK(WaitFor([&state, expected] { return state.done == expected; }, 30s, "All tasks done"));
+  ASSERT_EQ(expected, state.created);
+
+  // Shutdown while workers add tasks to their deques. All of them should be done after that.
+  EnqueueFanOut(&state, kProducers, kRoots, kDepth);
+  pool.Shutdown();
+  ASSERT_EQ(state.created, state.done);
+}
+
+// Compares throughput and latency of the thread pool with and without work stealing.
+TEST_F(ThreadPoolTest, YB_DISABLE_TEST_IN_TSAN(FanOutBenchmark)) {
+  constexpr size_t kTotalWorkers = 8;
+  constexpr size_t kProducers = 4;
+  constexpr size_t kRoots = 4000;
+  constexpr int kDepth = 6;
+
+  for (bool work_stealing : {false, true}) {
+    FLAGS_rpc_thread_pool_work_stealing = work_stealing;
+    ThreadPool pool("test", kRoots, kTotalWorkers);
+    FanOutState state;
+    state.pool = &pool;
+    const size_t expected = kRoots * ((1 << (kDepth + 1)) - 1);
+    const auto start = std::chrono::steady_clock::now();
+    EnqueueFanOut(&state, kProducers, kRoots, kDepth);
+    ASSERT_OK(WaitFor(
+        [&state, expected] { return state.done == expected; }, 60s, "All tasks done"));
+    const auto elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    LOG(INFO) << Format(
+        "Work stealing: $0, tasks: $1, throughput: $2 tasks/s, average latency: $3 us",
+        work_stealing, expected, static_cast<int64_t>(expected / elapsed),
+        state.total_latency_ns / expected / 1000.0);
+  }
+}
+
 } // namespace rpc
 } // namespace yb
@@ -15,6 +15,7 @@
 
 #include "yb/rpc/thread_pool.h"
 
+#include <array>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -22,9 +23,26 @@
 #include <cds/container/basket_queue.h>
 #include <cds/gc/dhp.h>
 
+#include <gflags/gflags.h>
+
+#include "yb/gutil/atomicops.h"
+
+#include "yb/util/flag_tags.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/thread.h"
 
+DEFINE_bool(rpc_thread_pool_work_stealing, false,
+            "Give each worker of the RPC thread pools its own deque for the tasks it enqueues, "
+            "that idle workers steal from, and let idle workers spin before going to sleep. "
+            "Applies to the thread pools created after it is set.");
+TAG_FLAG(rpc_thread_pool_work_stealing, advanced);
+
+DEFINE_int32(rpc_thread_pool_spin_iterations, 1000,
+             "Number of times an idle worker of a work stealing RPC thread pool looks for a task "
+             "before going to sleep.");
+TAG_FLAG(rpc_thread_pool_spin_iterations, advanced);
+TAG_FLAG(rpc_thread_pool_spin_iterations, runtime);
+
 namespace yb {
 namespace rpc {
 
@@ -35,13 +53,106 @@ class Worker;
 typedef cds::container::BasketQueue<cds::gc::DHP, ThreadPoolTask*> TaskQueue;
 typedef cds::container::BasketQueue<cds::gc::DHP, Worker*> WaitingWorkers;
 
+// Chase-Lev deque of a fixed capacity (Le et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). Only the owning worker pushes and pops at the bottom, so it gets the tasks it
+// enqueued in LIFO order while they are hot in its cache. Other workers steal from the top.
+class WorkStealingDeque {
+ public:
+  // Returns false when the deque is full.
+  bool Push(ThreadPoolTask* task) {
+    const auto bottom = bottom_.load(std::memory_order_relaxed);
+    const auto top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(kCapacity)) {
+      return false;
+    }
+    tasks_[bottom & kMask].store(task, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  ThreadPoolTask* Pop() {
+    const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto* task = tasks_[bottom & kMask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // The last task, that could be stolen at the same time.
+      if (!top_.compare_exchange_strong(
+              top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  // Could return null while the deque is not empty, when another thread takes the task first.
+  ThreadPoolTask* Steal() {
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    auto* task = tasks_[top & kMask].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return task;
+  }
+
+ private:
+  static constexpr size_t kCapacity = 256;
+  static constexpr size_t kMask = kCapacity - 1;
+
+  // Stealers write top_ and the owner writes bottom_, so they are kept in different cache lines.
+  std::atomic<int64_t> top_ = {0};
+  char padding_[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+  std::atomic<int64_t> bottom_ = {0};
+  std::array<std::atomic<ThreadPoolTask*>, kCapacity> tasks_;
+};
+
 struct ThreadPoolShare {
   ThreadPoolOptions options;
   TaskQueue task_queue;
   WaitingWorkers waiting_workers;
+  // Deques of the workers by index, empty when work stealing is off.
+  std::vector<std::unique_ptr<WorkStealingDeque>> deques;
 
   explicit ThreadPoolShare(ThreadPoolOptions o)
-      : options(std::move(o)) {}
+      : options(std::move(o)) {
+    if (FLAGS_rpc_thread_pool_work_stealing) {
+      deques.reserve(options.max_workers);
+      while (deques.size() != options.max_workers) {
+        deques.emplace_back(new WorkStealingDeque);
+      }
+    }
+  }
+
+  bool work_stealing() const {
+    return !deques.empty();
+  }
+
+  // Takes a task from the shared queue or steals it from the deques, starting with the deque
+  // following the one with the given index.
+  bool StealTask(size_t index, ThreadPoolTask** task) {
+    if (task_queue.pop(*task)) {
+      return true;
+    }
+    for (size_t i = 1; i <= deques.size(); ++i) {
+      *task = deques[(index + i) % deques.size()]->Steal();
+      if (*task) {
+        return true;
+      }
+    }
+    return false;
+  }
 };
 
 namespace {
@@ -50,10 +161,13 @@ const std::string kRpcThreadCategory = "rpc_thread_pool";
 
 } // namespace
 
+thread_local Worker* current_worker = nullptr;
+
 class Worker {
  public:
   explicit Worker(ThreadPoolShare* share, size_t index)
-      : share_(share) {
+      : share_(share), index_(index),
+        deque_(share->work_stealing() ? share->deques[index].get() : nullptr) {
     auto name = strings::Substitute("rpc_tp_$0_$1", share_->options.name, index);
     CHECK_OK(yb::Thread::Create(kRpcThreadCategory, name, &Worker::Execute, this, &thread_));
   }
@@ -86,6 +200,16 @@ class Worker {
     return true;
   }
 
+  ThreadPoolShare* share() const {
+    return share_;
+  }
+
+  // Enqueues a task enqueued by this worker to its deque, when work stealing is on and the deque
+  // is not full.
+  bool PushLocal(ThreadPoolTask* task) {
+    return deque_ && deque_->Push(task);
+  }
+
  private:
   // Our main invariant is empty task queue or empty worker queue.
   // In other words, one of those queues should be empty.
@@ -93,6 +217,7 @@ class Worker {
   // does not have free hands (worker queue empty)
   void Execute() {
     Thread::current_thread()->SetUserData(share_);
+    current_worker = this;
     while (!stop_requested_) {
       ThreadPoolTask* task = nullptr;
       if (PopTask(&task)) {
@@ -102,12 +227,30 @@ class Worker {
     }
   }
 
+  bool TryPopTask(ThreadPoolTask** task) {
+    if (!deque_) {
+      return share_->task_queue.pop(*task);
+    }
+    *task = deque_->Pop();
+    return *task || share_->StealTask(index_, task);
+  }
+
   bool PopTask(ThreadPoolTask** task) {
     // First of all we try to get already queued task, w/o locking.
     // If there is no task, so we could go to waiting state.
-    if (share_->task_queue.pop(*task)) {
+    if (TryPopTask(task)) {
       return true;
     }
+    // Waking up a sleeping worker is much more expensive than a task, so with work stealing
+    // we wait for a new task for a while before going to sleep.
+    if (deque_) {
+      for (int i = FLAGS_rpc_thread_pool_spin_iterations; i > 0 && !stop_requested_; --i) {
+        base::subtle::PauseCPU();
+        if (TryPopTask(task)) {
+          return true;
+        }
+      }
+    }
     std::unique_lock<std::mutex> lock(mutex_);
     waiting_task_ = true;
     auto se = ScopeExit([this] {
@@ -121,7 +264,7 @@ class Worker {
       // the worker queue. So worker queue could be empty in this case, and nobody was notified
       // about new task. So we check there for this case. This technique is similar to
       // double check.
-      if (share_->task_queue.pop(*task)) {
+      if (TryPopTask(task)) {
         return true;
       }
 
@@ -129,7 +272,7 @@ class Worker {
 
       // Sometimes another worker could steal task before we wake up. In this case we will
       // just enqueue ourselves back.
-      if (share_->task_queue.pop(*task)) {
+      if (TryPopTask(task)) {
         return true;
       }
     }
@@ -144,7 +287,9 @@ class Worker {
     }
   }
 
-  ThreadPoolShare* share_;
+  ThreadPoolShare* const share_;
+  const size_t index_;
+  WorkStealingDeque* const deque_;
   scoped_refptr<yb::Thread> thread_;
   std::mutex mutex_;
   std::condition_variable cond_;
@@ -179,8 +324,12 @@ class ThreadPool::Impl {
       task->Done(shutdown_status_);
       return false;
     }
-    bool added = share_.task_queue.push(task);
-    DCHECK(added); // BasketQueue always succeed.
+    // A task enqueued by a worker is likely to use the data this worker just used, so it is
+    // kept on the deque of the worker, unless an idle worker steals it.
+    if (!current_worker || current_worker->share() != &share_ || !current_worker->PushLocal(task)) {
+      bool added = share_.task_queue.push(task);
+      DCHECK(added); // BasketQueue always succeed.
+    }
     Worker* worker = nullptr;
     while (share_.waiting_workers.pop(worker)) {
       if (worker->Notify()) {
@@ -233,6 +382,11 @@ class ThreadPool::Impl {
     while (share_.task_queue.pop(task)) {
       task->Done(shutdown_status_);
     }
+    for (auto& deque : share_.deques) {
+      while ((task = deque->Steal()) != nullptr) {
+        task->Done(shutdown_status_);
+      }
+    }
   }
 
   bool Owns(Thread* thread) {
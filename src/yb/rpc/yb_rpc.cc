@@ -56,6 +56,7 @@ using std::placeholders::_1;
 DECLARE_uint64(rpc_connection_timeout_ms);
 DECLARE_int32(rpc_slow_query_threshold_ms);
 DECLARE_int32(rpc_throttle_threshold_bytes);
+DECLARE_bool(enable_rpc_compression);
 
 namespace yb {
 namespace rpc {
@@ -113,6 +114,8 @@ void YBConnectionContext::SetEventLoop(ev::loop_ref* loop) {
 void YBConnectionContext::Shutdown(const Status& status) {
   timer_.Shutdown();
   loop_ = nullptr;
+
+  ConnectionContextWithCallId::Shutdown(status);
 }
 
 YBConnectionContext::~YBConnectionContext() {}
@@ -280,6 +283,17 @@ Status YBInboundCall::ParseFrom(const MemTrackerPtr& mem_tracker, CallData* call
   consumption_ = ScopedTrackedConsumption(mem_tracker, call_data->size());
   request_data_ = std::move(*call_data);
 
+  if (header_.has_uncompressed_body_size()) {
+    CallData decompressed;
+    RETURN_NOT_OK(serialization::DecompressBody(
+        serialized_request_, header_.uncompressed_body_size(), &decompressed));
+    connection()->CompressedBodyReceived(decompressed.size(), serialized_request_.size());
+    consumption_.Add(
+        static_cast<int64_t>(decompressed.size()) - static_cast<int64_t>(request_data_.size()));
+    request_data_ = std::move(decompressed);
+    serialized_request_ = Slice(request_data_.data(), request_data_.size());
+  }
+
   // Adopt the service/method info from the header as soon as it's available.
   if (PREDICT_FALSE(!header_.has_remote_method())) {
     return STATUS(Corruption, "Non-connection context request header must specify remote_method");
@@ -368,6 +382,9 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
     offset += protobuf_msg_size;
   }
   *resp_hdr.mutable_sidecar_offsets() = std::move(sidecar_offsets_);
+  if (FLAGS_enable_rpc_compression) {
+    resp_hdr.set_accepts_compressed_body(true);
+  }
 
   size_t message_size = 0;
   auto status = SerializeMessage(response,
@@ -379,6 +396,31 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
   if (!status.ok()) {
     return status;
   }
+
+  const size_t body_size = protobuf_msg_size + total_sidecars_size_;
+  if (header_.accepts_compressed_body() &&
+      serialization::ShouldCompressBody(service_name(), body_size)) {
+    RefCntBuffer body(body_size);
+    auto* dst = response.SerializeWithCachedSizesToArray(body.udata());
+    size_t left = total_sidecars_size_;
+    for (const auto& car : sidecar_buffers_) {
+      auto len = std::min(car.size(), left);
+      memcpy(dst, car.data(), len);
+      dst += len;
+      left -= len;
+    }
+    RefCntBuffer compressed;
+    if (serialization::CompressBody(body.AsSlice(), &compressed)) {
+      resp_hdr.set_uncompressed_body_size(body_size);
+      RETURN_NOT_OK(serialization::SerializeHeaderAndBody(
+          resp_hdr, compressed.AsSlice(), &response_buf_));
+      connection()->CompressedBodySent(body_size, compressed.size());
+      // Sidecars are in the compressed body now.
+      ResetRpcSidecars();
+      return Status::OK();
+    }
+  }
+
   size_t header_size = 0;
   status = SerializeHeader(resp_hdr,
                            message_size + total_sidecars_size_,
@@ -468,12 +510,18 @@ Status YBInboundCall::ParseParam(google::protobuf::Message *message) {
     return STATUS(InvalidArgument, err);
   }
   consumption_.Add(message->SpaceUsedLong());
+  timing_.time_parsed = MonoTime::Now();
 
   if (PREDICT_FALSE(FLAGS_TEST_yb_inbound_big_calls_parse_delay_ms > 0 &&
         request_data_.size() > FLAGS_rpc_throttle_threshold_bytes)) {
     std::this_thread::sleep_for(FLAGS_TEST_yb_inbound_big_calls_parse_delay_ms * 1ms);
   }
 
+  // The parsed message has its own copy of all fields, so the received data is not needed anymore.
+  // Free it now instead of keeping both copies until the call is responded.
+  consumption_.Add(-static_cast<int64_t>(request_data_.size()));
+  Clear();
+
   return Status::OK();
 }
 
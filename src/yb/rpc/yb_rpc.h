@@ -174,6 +174,14 @@ class YBInboundCall : public InboundCall {
     return remote_method_.service_name();
   }
 
+  TraceSpanContext remote_trace_span() const override {
+    return TraceSpanContext{header_.trace_id(), header_.parent_span_id()};
+  }
+
+  uint32_t priority() const override {
+    return header_.priority();
+  }
+
   virtual CHECKED_STATUS ParseParam(google::protobuf::Message *message);
 
   void RespondBadMethod();
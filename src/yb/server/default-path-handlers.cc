@@ -45,8 +45,10 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <fstream>
 #include <functional>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -59,18 +61,24 @@
 #endif
 
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/human_readable.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/server/pprof-path-handlers.h"
+#include "yb/server/tcmalloc_metrics.h"
 #include "yb/server/webserver.h"
+#include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/histogram.pb.h"
 #include "yb/util/logging.h"
+#include "yb/util/mem_attribution.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/metrics.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/url-coding.h"
 #include "yb/util/version_info.h"
 #include "yb/util/version_info.pb.h"
 
@@ -208,6 +216,100 @@ static void MemTrackersHandler(const Webserver::WebRequest& req, std::stringstre
   *output << "</table>\n";
 }
 
+// Registered to handle "/mem-trackers/attribution", and prints out the part of the heap that is not
+// tracked, and the sampled allocations by subsystem and call site.
+static void MemAttributionHandler(const Webserver::WebRequest& req, std::stringstream* output) {
+  using tcmalloc::GetTCMallocPropValue;
+
+  const auto allocated = GetTCMallocPropValue("generic.current_allocated_bytes");
+  const auto heap_size = GetTCMallocPropValue("generic.heap_size");
+  const auto unmapped = GetTCMallocPropValue("tcmalloc.pageheap_unmapped_bytes");
+  int64_t tracked = 0;
+  for (const auto& child : MemTracker::GetRootTracker()->ListChildren()) {
+    tracked += child->consumption();
+  }
+  const auto row = [output](const char* name, int64_t bytes) {
+    *output << Format("  <tr><td>$0</td><td>$1</td></tr>\n",
+                      name, HumanReadableNumBytes::ToString(std::max<int64_t>(bytes, 0)));
+  };
+
+  *output << "<h1>Memory attribution</h1>\n";
+  *output << "<table class='table table-striped'>\n";
+  row("Allocated by the application", allocated);
+  row("Tracked by the memory trackers", tracked);
+  row("Not tracked", allocated - tracked);
+  row("Free in the heap, i.e. fragmentation and the thread caches",
+      heap_size - unmapped - allocated);
+  row("Released to the OS", unmapped);
+  *output << "</table>\n";
+
+  if (!AllocationSamplingStarted()) {
+    *output << "<p>Allocation sampling is disabled, start the server with "
+               "--mem_attribution_sample_interval_bytes, e.g. 1048576.</p>\n";
+    return;
+  }
+  if (req.parsed_args.count("reset")) {
+    ResetAllocationSamples();
+  }
+  const size_t top = std::max(
+      ParseLeadingInt32Value(FindWithDefault(req.parsed_args, "top", "10").c_str(), 10), 1);
+
+  auto samples = GetAllocationSamples();
+  std::map<std::string, std::vector<AllocationSite>> sites_by_tag;
+  std::map<std::string, uint64_t> bytes_by_tag;
+  uint64_t total_bytes = 0;
+  for (auto& site : samples.sites) {
+    const std::string tag = site.tag ? site.tag : "untagged";
+    bytes_by_tag[tag] += site.bytes;
+    total_bytes += site.bytes;
+    sites_by_tag[tag].push_back(std::move(site));
+  }
+  std::vector<std::pair<uint64_t, std::string>> tags;
+  for (const auto& tag_and_bytes : bytes_by_tag) {
+    tags.emplace_back(tag_and_bytes.second, tag_and_bytes.first);
+  }
+  std::sort(tags.rbegin(), tags.rend());
+
+  *output << Format("<h2>Sampled allocations</h2>\n<p>An allocation is sampled each $0, the "
+                    "bytes are allocated bytes, not the bytes still in use. $1 samples were "
+                    "dropped. <a href='?reset=1'>Reset</a></p>\n",
+                    HumanReadableNumBytes::ToString(samples.interval_bytes),
+                    samples.dropped_samples);
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Subsystem</th><th>Allocated</th><th>Share</th></tr>\n";
+  for (const auto& bytes_and_tag : tags) {
+    *output << Format("  <tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+                      EscapeForHtmlToString(bytes_and_tag.second),
+                      HumanReadableNumBytes::ToString(bytes_and_tag.first),
+                      StringPrintf("%.1f%%", 100.0 * bytes_and_tag.first / total_bytes));
+  }
+  *output << "</table>\n";
+
+  for (const auto& bytes_and_tag : tags) {
+    auto& sites = sites_by_tag[bytes_and_tag.second];
+    std::sort(sites.begin(), sites.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.bytes > rhs.bytes;
+    });
+    if (sites.size() > top) {
+      sites.resize(top);
+    }
+    *output << Format("<h3>$0</h3>\n", EscapeForHtmlToString(bytes_and_tag.second));
+    *output << "<table class='table table-striped'>\n";
+    *output << "  <tr><th>Allocated</th><th>Samples</th><th>Call site</th></tr>\n";
+    for (const auto& site : sites) {
+      std::string call_site;
+      for (auto* frame : site.frames) {
+        auto line = SymbolizeAddress(frame);
+        boost::trim_right(line);
+        call_site += EscapeForHtmlToString(line) + "\n";
+      }
+      *output << Format("  <tr><td>$0</td><td>$1</td><td><pre>$2</pre></td></tr>\n",
+                        HumanReadableNumBytes::ToString(site.bytes), site.samples, call_site);
+    }
+    *output << "</table>\n";
+  }
+}
+
 static void WriteMetricsAsJson(const MetricRegistry* const metrics,
                                const Webserver::WebRequest& req, std::stringstream* output) {
   const string* requested_metrics_param = FindOrNull(req.parsed_args, "metrics");
@@ -286,6 +388,8 @@ void AddDefaultPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/memz", "Memory (total)", MemUsageHandler, true, false);
   webserver->RegisterPathHandler("/mem-trackers", "Memory (detail)",
                                  MemTrackersHandler, true, false);
+  webserver->RegisterPathHandler("/mem-trackers/attribution", "", MemAttributionHandler, true,
+                                 false);
   webserver->RegisterPathHandler("/api/v1/version-info", "Build Version Info",
                                  HandleGetVersionInfo, false, false);
 
@@ -31,18 +31,24 @@
 //
 
 #include <algorithm>
+#include <thread>
+
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/server/mock_hybrid_clock.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ntp_clock.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
+DECLARE_uint64(max_clock_skew_usec);
 DECLARE_uint64(max_clock_sync_error_usec);
 DECLARE_bool(disable_clock_sync_error);
+DECLARE_int32(ntp_clock_error_refresh_interval_usec);
 
 namespace yb {
 namespace server {
@@ -171,6 +177,69 @@ void HybridClockTest::RunMultiThreadedTest(int num_reads_per_update) {
   }
 }
 
+// Measures the throughput of the clock, when it is read concurrently by many threads, most of the
+// reads getting the same physical time.
+TEST_F(HybridClockTest, YB_DISABLE_TEST_IN_TSAN(NowPerformance)) {
+  constexpr int kReadsPerThread = 1000000;
+
+  for (int num_threads : {1, 4, 16}) {
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed(false);
+    LOG_TIMING(INFO, Format("$0 reads by $1 threads", kReadsPerThread * num_threads,
+                            num_threads)) {
+      for (int i = 0; i != num_threads; ++i) {
+        threads.emplace_back([this, &failed] {
+          HybridTime prev = HybridTime::kMin;
+          for (int j = 0; j != kReadsPerThread; ++j) {
+            auto now = clock_->Now();
+            if (now <= prev) {
+              failed.store(true);
+            }
+            prev = now;
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+    ASSERT_FALSE(failed.load());
+  }
+}
+
+#if !defined(__APPLE__)
+// The error reported by the NTP clock between the kernel queries should not be lower than the one
+// the kernel would report.
+TEST_F(HybridClockTest, NtpClockCachedError) {
+  FLAGS_ntp_clock_error_refresh_interval_usec = 1000000;
+  auto clock = AdjTimeClock();
+  auto first = ASSERT_RESULT(clock->Now());
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  auto cached = ASSERT_RESULT(clock->Now());
+
+  FLAGS_ntp_clock_error_refresh_interval_usec = 0;
+  auto queried = ASSERT_RESULT(clock->Now());
+
+  ASSERT_GE(cached.time_point, first.time_point);
+  ASSERT_GE(queried.time_point, cached.time_point);
+  ASSERT_GE(cached.max_error, first.max_error);
+  ASSERT_GE(cached.max_error, queried.max_error);
+}
+#endif // !defined(__APPLE__)
+
+// The read uncertainty of the NTP clock is twice its error, up to the error plus the max skew.
+TEST_F(HybridClockTest, NtpClockMaxGlobalTime) {
+  MockClock mock_clock;
+  NtpClock clock(mock_clock.AsClock());
+  mock_clock.Set({1000000, 100});
+  auto now = ASSERT_RESULT(clock.Now());
+  ASSERT_EQ(999900u, now.time_point);
+  ASSERT_EQ(1000100u, clock.MaxGlobalTime(now));
+
+  FLAGS_max_clock_skew_usec = 50;
+  ASSERT_EQ(1000050u, clock.MaxGlobalTime(now));
+}
+
 TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
   EXPECT_EQ(1, HybridClock::CompareHybridClocksToDelta(
       HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1000, 10),
@@ -45,6 +45,7 @@
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
+#include "yb/util/ntp_clock.h"
 #include "yb/util/status.h"
 
 DEFINE_bool(use_hybrid_clock, true,
@@ -60,10 +61,16 @@ METRIC_DEFINE_gauge_uint64(server, hybrid_clock_error,
                            "Hybrid Clock Error",
                            yb::MetricUnit::kMicroseconds,
                            "Server clock maximum error.");
+METRIC_DEFINE_gauge_uint64(server, hybrid_clock_read_uncertainty,
+                           "Hybrid Clock Read Uncertainty",
+                           yb::MetricUnit::kMicroseconds,
+                           "Width of the window after the read time, in which the values seen by "
+                           "a read make it restart.");
 
 DEFINE_string(time_source, "",
               "The clock source that HybridClock should use (for tests only). "
-              "Leave empty for WallClock, other values depend on added clock providers and "
+              "Leave empty for WallClock, ntp for the clock that bounds the read uncertainty by "
+              "the errors reported by NTP, other values depend on added clock providers and "
               "specific for appropriate tests, that adds them.");
 TAG_FLAG(time_source, hidden);
 
@@ -88,6 +95,11 @@ PhysicalClockPtr GetClock(const std::string& options) {
   auto pos = options.find(',');
   auto name = pos == std::string::npos ? options : options.substr(0, pos);
   auto arg = pos == std::string::npos ? std::string() : options.substr(pos + 1);
+#if !defined(__APPLE__)
+  if (name == NtpClock::Name()) {
+    return std::make_shared<NtpClock>();
+  }
+#endif
   std::lock_guard<std::mutex> lock(providers_mutex);
   auto it = providers.find(name);
   if (it == providers.end()) {
@@ -140,16 +152,16 @@ void HybridClock::NowWithError(HybridTime *hybrid_time, uint64_t *max_error_usec
         "Status: $0", now.status().ToString());
   }
 
-  // If the current time surpasses the last update just return it
-  HybridClockComponents current_components = components_.load(boost::memory_order_acquire);
-  HybridClockComponents new_components = { now->time_point, 1 };
+  // If the current time surpasses the last issued hybrid time, just return it.
+  const HybridTimeRepr physical_now = HybridTimeFromMicroseconds(now->time_point).ToUint64();
+  HybridTimeRepr next = next_hybrid_time_.load(std::memory_order_acquire);
 
-  VLOG(4) << __func__ << ", new: " << new_components << ", current: " << current_components;
+  VLOG(4) << __func__ << ", now: " << physical_now << ", next: " << next;
 
   // Loop over the check in case of concurrent updates making the CAS fail.
-  while (now->time_point > current_components.last_usec) {
-    if (components_.compare_exchange_weak(current_components, new_components)) {
-      *hybrid_time = HybridTimeFromMicroseconds(new_components.last_usec);
+  while (physical_now >= next) {
+    if (next_hybrid_time_.compare_exchange_weak(next, physical_now + 1)) {
+      *hybrid_time = HybridTime(physical_now);
       *max_error_usec = now->max_error;
       if (PREDICT_FALSE(VLOG_IS_ON(2))) {
         VLOG(2) << "Current clock is higher than the last one. Resetting logical values."
@@ -176,19 +188,18 @@ void HybridClock::NowWithError(HybridTime *hybrid_time, uint64_t *max_error_usec
   // always return: last - (now - e) as the new maximum error.
   // This broadens the error interval for both cases but always returns
   // a correct error interval.
+  //
+  // The physical clock did not advance past the last issued hybrid time, so the next one is issued
+  // by incrementing the logical component. The value could only have grown since it was loaded, so
+  // the result is still ahead of physical_now. It does not need a CAS loop, that would make all
+  // the threads reading the clock within the same microsecond retry each other.
+  *hybrid_time = HybridTime(next_hybrid_time_.fetch_add(1, std::memory_order_acq_rel));
+  if (PREDICT_FALSE(hybrid_time->GetLogicalValue() == HybridTime::kLogicalBitMask)) {
+    YB_LOG_EVERY_N_SECS(WARNING, 5) << "Logical component overflow: " << *hybrid_time;
+  }
 
-  do {
-    new_components.last_usec = current_components.last_usec;
-    new_components.logical = current_components.logical + 1;
-    new_components.HandleLogicalComponentOverflow();
-    // Loop over the check until the CAS succeeds, in case there are concurrent updates.
-  } while (!components_.compare_exchange_weak(current_components, new_components));
-
-  *max_error_usec = new_components.last_usec - (now->time_point - now->max_error);
+  *max_error_usec = hybrid_time->GetPhysicalValueMicros() - (now->time_point - now->max_error);
 
-  // We've already atomically incremented the logical, so subtract 1.
-  *hybrid_time = HybridTimeFromMicrosecondsAndLogicalValue(
-      new_components.last_usec, new_components.logical).Decremented();
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
     VLOG(2) << "Current clock is lower than the last one. Returning last read and incrementing"
         " logical values. Hybrid time: " << *hybrid_time << " Error: " << *max_error_usec;
@@ -200,21 +211,16 @@ void HybridClock::Update(const HybridTime& to_update) {
     return;
   }
 
-  HybridClockComponents current_components = components_.load(boost::memory_order_acquire);
-  HybridClockComponents new_components = {
-    GetPhysicalValueMicros(to_update), GetLogicalValue(to_update) + 1
-  };
+  const HybridTimeRepr new_next = to_update.ToUint64() + 1;
+  HybridTimeRepr next = next_hybrid_time_.load(std::memory_order_acquire);
 
   // VLOG(4) crashes in TSAN mode
   if (VLOG_IS_ON(4)) {
-    LOG(INFO) << __func__ << ", new: " << new_components << ", current: " << current_components;
+    LOG(INFO) << __func__ << ", new next: " << new_next << ", next: " << next;
   }
 
-  new_components.HandleLogicalComponentOverflow();
-
   // Keep trying to CAS until it works or until HT has advanced past this update.
-  while (current_components < new_components &&
-      !components_.compare_exchange_weak(current_components, new_components)) {}
+  while (next < new_next && !next_hybrid_time_.compare_exchange_weak(next, new_next)) {}
 }
 
 // Used to get the hybrid_time for metrics.
@@ -231,27 +237,10 @@ uint64_t HybridClock::ErrorForMetrics() {
   return error;
 }
 
-std::string HybridClockComponents::ToString() const {
-  return Format("{ last_usec: $0 logical: $1 }", last_usec, logical);
-}
-
-std::ostream& operator<<(std::ostream& out, const HybridClockComponents& components) {
-  return out << components.ToString();
-}
-
-void HybridClockComponents::HandleLogicalComponentOverflow() {
-  if (logical > HybridTime::kLogicalBitMask) {
-    static constexpr uint64_t kMaxOverflowValue = 1ULL << HybridTime::kBitsForLogicalComponent;
-    if (logical > kMaxOverflowValue) {
-      LOG(FATAL) << "Logical component is too high: last_usec=" << last_usec
-                 << "logical=" << logical << ", max allowed is " << kMaxOverflowValue;
-    }
-    YB_LOG_EVERY_N_SECS(WARNING, 5) << "Logical component overflow: "
-        << "last_usec=" << last_usec << ", logical=" << logical;
-
-    last_usec += logical >> HybridTime::kBitsForLogicalComponent;
-    logical &= HybridTime::kLogicalBitMask;
-  }
+// Used to get the current read uncertainty, for metrics.
+uint64_t HybridClock::ReadUncertaintyForMetrics() {
+  auto range = NowRange();
+  return range.second.GetPhysicalValueMicros() - range.first.GetPhysicalValueMicros();
 }
 
 void HybridClock::RegisterMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
@@ -263,6 +252,10 @@ void HybridClock::RegisterMetrics(const scoped_refptr<MetricEntity>& metric_enti
       metric_entity,
       Bind(&HybridClock::ErrorForMetrics, Unretained(this)))
     ->AutoDetachToLastValue(&metric_detacher_);
+  METRIC_hybrid_clock_read_uncertainty.InstantiateFunctionGauge(
+      metric_entity,
+      Bind(&HybridClock::ReadUncertaintyForMetrics, Unretained(this)))
+    ->AutoDetachToLastValue(&metric_detacher_);
 }
 
 LogicalTimeComponent HybridClock::GetLogicalValue(const HybridTime& hybrid_time) {
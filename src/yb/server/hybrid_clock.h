@@ -39,8 +39,6 @@
 #include <sys/timex.h>
 #endif // !defined(__APPLE__)
 
-#include <boost/atomic.hpp>
-
 #include "yb/gutil/ref_counted.h"
 #include "yb/server/clock.h"
 #include "yb/util/locks.h"
@@ -50,38 +48,6 @@
 namespace yb {
 namespace server {
 
-struct HybridClockComponents {
-  // The last clock read/update, in microseconds.
-  MicrosTime last_usec = 0;
-
-  // The next logical value to be assigned to a hybrid time.
-  LogicalTimeComponent logical = 0;
-
-  HybridClockComponents() noexcept {}
-
-  HybridClockComponents(MicrosTime last_usec_, LogicalTimeComponent logical_)
-      : last_usec(last_usec_),
-        logical(logical_) {
-  }
-
-  HybridClockComponents(HybridClockComponents&& other) = default;
-  HybridClockComponents(const HybridClockComponents& other) = default;
-
-  bool operator< (const HybridClockComponents& o) const {
-    return last_usec < o.last_usec || (last_usec == o.last_usec && logical < o.logical);
-  }
-
-  bool operator<= (const HybridClockComponents& o) const {
-    return last_usec < o.last_usec || (last_usec == o.last_usec && logical <= o.logical);
-  }
-
-  void HandleLogicalComponentOverflow();
-
-  std::string ToString() const;
-};
-
-std::ostream& operator<<(std::ostream& out, const HybridClockComponents& components);
-
 // The HybridTime clock.
 //
 // HybridTime should not be used on a distributed cluster running on OS X hosts,
@@ -153,8 +119,15 @@ class HybridClock : public Clock {
   // Used to get the current error, for metrics.
   uint64_t ErrorForMetrics();
 
+  // Used to get the current read uncertainty, for metrics.
+  uint64_t ReadUncertaintyForMetrics();
+
   PhysicalClockPtr clock_;
-  boost::atomic<HybridClockComponents> components_{HybridClockComponents(0, 0)};
+  // The smallest hybrid time that could be issued next, i.e. the last issued or updated hybrid
+  // time plus one logical tick. Packed into a single word, so a clock read that does not see the
+  // physical clock advance is a single fetch_add, and a logical overflow just carries into the
+  // physical part.
+  std::atomic<HybridTimeRepr> next_hybrid_time_{0};
   State state_ = kNotInitialized;
 
   // Clock metrics are set to detach to their last value. This means
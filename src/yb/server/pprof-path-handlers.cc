@@ -62,6 +62,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
@@ -206,6 +207,18 @@ static void PprofContentionHandler(const Webserver::WebRequest& req, stringstrea
 #endif // defined(__linux__)
 }
 
+// Stacks sampled by the continuous profiler during the last seconds, in the folded format.
+// Accepts /pprof/continuous?seconds=XX&category=YY, category limits the output to the threads
+// of the category. With by_category=1 only the number of samples per thread category is shown.
+static void PprofContinuousHandler(const Webserver::WebRequest& req, stringstream* output) {
+  ContinuousProfileOptions options;
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  options.window = MonoDelta::FromSeconds(
+      ParseLeadingInt32Value(secs_str.c_str(), static_cast<int32_t>(options.window.ToSeconds())));
+  options.category = FindWithDefault(req.parsed_args, "category", "");
+  options.by_category = FindWithDefault(req.parsed_args, "by_category", "") == "1";
+  DumpContinuousProfile(options, output);
+}
 
 // pprof asks for the url /pprof/symbol to map from hex addresses to variable names.
 // When the server receives a GET request for /pprof/symbol, it should return a line
@@ -269,6 +282,7 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+  webserver->RegisterPathHandler("/pprof/continuous", "", PprofContinuousHandler, false, false);
 }
 
 } // namespace yb
@@ -41,10 +41,12 @@
 #include "yb/gutil/strings/numbers.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_introspection.pb.h"
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/server/webserver.h"
 
 namespace yb {
 
+using yb::rpc::DumpRpcPhasesResponsePB;
 using yb::rpc::DumpRunningRpcsRequestPB;
 using yb::rpc::DumpRunningRpcsResponsePB;
 using yb::rpc::Messenger;
@@ -79,11 +81,25 @@ void RpczPathHandler(Messenger* messenger,
   writer.Protobuf(dump_resp);
 }
 
+// Dumps the statistics of the time the calls of each method spent in the phases of their
+// processing, see RpcPhaseMetrics.
+void RpczPhasesPathHandler(Messenger* messenger,
+                           const Webserver::WebRequest& req, stringstream* output) {
+  DumpRpcPhasesResponsePB dump_resp;
+  messenger->rpc_metrics().phases.Dump(&dump_resp);
+
+  JsonWriter writer(output, JsonWriter::PRETTY);
+  writer.Protobuf(dump_resp);
+}
+
 } // anonymous namespace
 
 void AddRpczPathHandlers(Messenger* messenger, Webserver* webserver) {
   webserver->RegisterPathHandler(
       "/rpcz", "RPCs", std::bind(RpczPathHandler, messenger, _1, _2), false, false);
+  webserver->RegisterPathHandler(
+      "/rpcz/phases", "RPC phases", std::bind(RpczPhasesPathHandler, messenger, _1, _2), false,
+      false);
 }
 
 } // namespace yb
@@ -59,9 +59,11 @@
 #include "yb/server/tracing-path-handlers.h"
 #include "yb/server/webserver.h"
 #include "yb/util/atomic.h"
+#include "yb/util/continuous_profiler.h"
 #include "yb/util/env.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/mem_attribution.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
@@ -90,6 +92,12 @@ DEFINE_int32(generic_svc_queue_length, 50,
              "RPC Queue length for the generic service");
 TAG_FLAG(generic_svc_queue_length, advanced);
 
+DEFINE_int32(continuous_profiling_frequency_hz, 0,
+             "Number of stack samples per second of CPU time used by the process, taken by the "
+             "continuous profiler and shown at /pprof/continuous. Low frequencies, like 19, have "
+             "negligible overhead and could be kept on in production. 0 to disable.");
+TAG_FLAG(continuous_profiling_frequency_hz, advanced);
+
 DEFINE_string(yb_test_name, "",
               "Specifies test name this daemon is running as part of.");
 
@@ -263,6 +271,12 @@ Status RpcServerBase::Init() {
 
   RETURN_NOT_OK(SetStackTraceSignal(SIGUSR2));
 
+  // Continuous profiling is process wide and just helps to diagnose, so its failure does not
+  // prevent the server from starting.
+  WARN_NOT_OK(StartContinuousProfiling(FLAGS_continuous_profiling_frequency_hz),
+              "Failed to start continuous profiling");
+  WARN_NOT_OK(StartAllocationSampling(), "Failed to start the allocation sampling");
+
   // Initialize the clock immediately. This checks that the clock is synchronized
   // so we're less likely to get into a partially initialized state on disk during startup
   // if we're having clock problems.
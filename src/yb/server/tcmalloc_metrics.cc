@@ -87,7 +87,7 @@ METRIC_DEFINE_gauge_uint64(server, tcmalloc_current_total_thread_cache_bytes,
 namespace yb {
 namespace tcmalloc {
 
-static uint64_t GetTCMallocPropValue(const char* prop) {
+uint64_t GetTCMallocPropValue(const char* prop) {
   size_t value = 0;
 #ifdef TCMALLOC_ENABLED
   if (!MallocExtension::instance()->GetNumericProperty(prop, &value)) {
@@ -32,6 +32,8 @@
 #ifndef YB_SERVER_TCMALLOC_METRICS_H_
 #define YB_SERVER_TCMALLOC_METRICS_H_
 
+#include <cstdint>
+
 #include "yb/gutil/ref_counted.h"
 
 namespace yb {
@@ -43,6 +45,9 @@ namespace tcmalloc {
 // metrics will be identical, since the tcmalloc tracking is process-wide.
 void RegisterMetrics(const scoped_refptr<MetricEntity>& entity);
 
+// Returns the value of a numeric tcmalloc property, 0 without tcmalloc.
+uint64_t GetTCMallocPropValue(const char* prop);
+
 } // namespace tcmalloc
 } // namespace yb
 
@@ -43,8 +43,11 @@
 #include <rapidjson/rapidjson.h> // NOLINT
 #include <rapidjson/stringbuffer.h> // NOLINT
 
+#include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/escaping.h"
+#include "yb/gutil/strings/numbers.h"
 #include "yb/util/jsonwriter.h"
+#include "yb/util/trace_span.h"
 #include "yb/util/debug/trace_event_impl.h"
 
 namespace yb {
@@ -70,7 +73,8 @@ enum Handler {
   kBeginRecording,
   kGetBufferPercentFull,
   kEndRecording,
-  kSimpleDump
+  kSimpleDump,
+  kSpans
 };
 
 namespace {
@@ -205,6 +209,24 @@ void HandleTraceJsonPage(const Webserver::ArgumentMap &args,
   *output << TraceResultBuffer::FlushTraceLogToString();
 }
 
+// Writes the ended spans of distributed traces, all of them or only the spans of the trace given
+// by the trace_id argument, in hex as in the output.
+Status GetTraceSpans(const Webserver::WebRequest& req, std::stringstream* out) {
+  uint64_t trace_id = 0;
+  string trace_id_str = FindWithDefault(req.parsed_args, "trace_id", "");
+  if (!trace_id_str.empty()) {
+    // Our trace ids are 64 bit, so the upper half of the OTLP trace id is always zero.
+    if (trace_id_str.size() > 16) {
+      trace_id_str = trace_id_str.substr(trace_id_str.size() - 16);
+    }
+    if (!safe_strtou64_base(trace_id_str, &trace_id, 16)) {
+      return STATUS_FORMAT(InvalidArgument, "Bad trace id: $0", trace_id_str);
+    }
+  }
+  DumpTraceSpansAsOtlpJson(google::ProgramInvocationShortName(), trace_id, out);
+  return Status::OK();
+}
+
 Status DoHandleRequest(Handler handler,
                        const Webserver::WebRequest& req,
                        std::stringstream* output) {
@@ -236,6 +258,9 @@ Status DoHandleRequest(Handler handler,
     case kSimpleDump:
       HandleTraceJsonPage(req.parsed_args, output);
       break;
+    case kSpans:
+      RETURN_NOT_OK(GetTraceSpans(req, output));
+      break;
   }
 
   return Status::OK();
@@ -269,7 +294,8 @@ void TracingPathHandlers::RegisterHandlers(Webserver* server) {
     { "/tracing/json/begin_recording", kBeginRecording },
     { "/tracing/json/get_buffer_percent_full", kGetBufferPercentFull },
     { "/tracing/json/end_recording", kEndRecording },
-    { "/tracing/json/simple_dump", kSimpleDump } };
+    { "/tracing/json/simple_dump", kSimpleDump },
+    { "/tracing/spans", kSpans } };
 
   typedef pair<string, Handler> HandlerPair;
   for (const HandlerPair& e : handlers) {
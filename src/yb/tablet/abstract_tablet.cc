@@ -29,10 +29,14 @@ Status AbstractTablet::HandleQLReadRequest(CoarseTimePoint deadline,
                                            const ReadHybridTime& read_time,
                                            const QLReadRequestPB& ql_read_request,
                                            const TransactionOperationContextOpt& txn_op_context,
-                                           QLReadRequestResult* result) {
+                                           QLReadRequestResult* result,
+                                           std::shared_ptr<const docdb::TableImage> table_image) {
 
   // TODO(Robert): verify that all key column values are provided
   docdb::QLReadOperation doc_op(ql_read_request, txn_op_context);
+  if (table_image) {
+    doc_op.SetTableImage(std::move(table_image));
+  }
 
   // Form a schema of columns that are referenced by this query.
   const Schema &schema = SchemaRef();
@@ -75,9 +79,13 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
                                               const ReadHybridTime& read_time,
                                               const PgsqlReadRequestPB& pgsql_read_request,
                                               const TransactionOperationContextOpt& txn_op_context,
-                                              PgsqlReadRequestResult* result) {
+                                              PgsqlReadRequestResult* result,
+                                              docdb::PgsqlReadCursorPtr* cursor) {
 
   docdb::PgsqlReadOperation doc_op(pgsql_read_request, txn_op_context);
+  if (cursor && *cursor && doc_op.CanUseCursor()) {
+    doc_op.SetCursor(std::move(*cursor));
+  }
 
   // Form a schema of columns that are referenced by this query.
   const Schema &schema = SchemaRef(pgsql_read_request.table_id());
@@ -96,6 +104,9 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
     return Status::OK();
   }
   result->response.Swap(&doc_op.response());
+  if (cursor) {
+    *cursor = doc_op.ReleaseCursor();
+  }
 
   RETURN_NOT_OK(CreatePagingStateForRead(
       pgsql_read_request, *fetched_rows, &result->response));
@@ -23,6 +23,12 @@
 #include "yb/tablet/tablet_fwd.h"
 
 namespace yb {
+
+namespace docdb {
+struct PgsqlReadCursor;
+class TableImage;
+}
+
 namespace tablet {
 
 struct QLReadRequestResult {
@@ -109,22 +115,29 @@ class AbstractTablet {
   // PGSQL support.
   //-----------------------------------------------------------------------------------------------
 
+  // When table_image is specified, the reads of a single partition are answered from it.
   CHECKED_STATUS HandleQLReadRequest(
       CoarseTimePoint deadline,
       const ReadHybridTime& read_time,
       const QLReadRequestPB& ql_read_request,
       const TransactionOperationContextOpt& txn_op_context,
-      QLReadRequestResult* result);
+      QLReadRequestResult* result,
+      std::shared_ptr<const docdb::TableImage> table_image = nullptr);
 
   virtual CHECKED_STATUS CreatePagingStateForRead(const PgsqlReadRequestPB& pgsql_read_request,
                                                   const size_t row_count,
                                                   PgsqlResponsePB* response) const = 0;
 
-  CHECKED_STATUS HandlePgsqlReadRequest(CoarseTimePoint deadline,
-                                        const ReadHybridTime& read_time,
-                                        const PgsqlReadRequestPB& pgsql_read_request,
-                                        const TransactionOperationContextOpt& txn_op_context,
-                                        PgsqlReadRequestResult* result);
+  // When cursor is specified, the scan continues with the iterator of the cursor if present, and
+  // the cursor is replaced with the one positioned after the fetched rows, if the request could
+  // use a cursor.
+  CHECKED_STATUS HandlePgsqlReadRequest(
+      CoarseTimePoint deadline,
+      const ReadHybridTime& read_time,
+      const PgsqlReadRequestPB& pgsql_read_request,
+      const TransactionOperationContextOpt& txn_op_context,
+      PgsqlReadRequestResult* result,
+      std::unique_ptr<docdb::PgsqlReadCursor>* cursor = nullptr);
 
   virtual bool IsTransactionalRequest(bool is_ysql_request) const = 0;
 
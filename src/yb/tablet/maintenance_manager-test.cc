@@ -298,7 +298,34 @@ TEST_F(MaintenanceManagerTest, TestCompletedOpsHistory) {
     ASSERT_GE(kHistorySize, status_pb.completed_operations_size());
     // See that we have the right name, even if we wrap around.
     ASSERT_EQ(name, status_pb.completed_operations(i % 4).name());
+    ASSERT_FALSE(status_pb.completed_operations(i % 4).reason().empty());
   }
 }
 
+// Test that high IO ops are not picked while the maximum number of them is running, so the low
+// IO ones could still run.
+TEST_F(MaintenanceManagerTest, TestHighIOLimit) {
+  manager_->Shutdown();
+
+  TestMaintenanceOp op1("op1", MaintenanceOp::LOW_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op1.set_perf_improvement(1);
+
+  TestMaintenanceOp op2("op2", MaintenanceOp::HIGH_IO_USAGE, OP_RUNNABLE, test_tracker_);
+  op2.set_perf_improvement(10);
+
+  manager_->RegisterOp(&op1);
+  manager_->RegisterOp(&op2);
+
+  std::string reason;
+  ASSERT_EQ(&op2, manager_->FindBestOp(&reason));
+  ASSERT_FALSE(reason.empty());
+
+  manager_->running_high_io_ops_ = manager_->MaxRunningHighIOOps();
+  ASSERT_EQ(&op1, manager_->FindBestOp());
+  manager_->running_high_io_ops_ = 0;
+
+  manager_->UnregisterOp(&op1);
+  manager_->UnregisterOp(&op2);
+}
+
 } // namespace yb
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -45,6 +46,7 @@
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/debug/trace_logging.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
@@ -61,6 +63,13 @@ DEFINE_int32(maintenance_manager_num_threads, 1,
        "not be above the number of devices.");
 TAG_FLAG(maintenance_manager_num_threads, stable);
 
+DEFINE_int32(maintenance_manager_max_concurrent_high_io_ops, 0,
+       "Maximum number of high IO maintenance operations, such as compactions, that run at the "
+       "same time, so that the other threads are left for the operations that free memory or "
+       "logs quickly. 0 to use all the threads but one, or the only thread.");
+TAG_FLAG(maintenance_manager_max_concurrent_high_io_ops, advanced);
+TAG_FLAG(maintenance_manager_max_concurrent_high_io_ops, runtime);
+
 DEFINE_int32(maintenance_manager_polling_interval_ms, 250,
        "Polling interval for the maintenance manager scheduler, "
        "in milliseconds.");
@@ -205,16 +214,22 @@ void MaintenanceManager::RunSchedulerThread() {
   MonoDelta polling_interval = MonoDelta::FromMilliseconds(polling_interval_ms_);
 
   std::unique_lock<Mutex> guard(lock_);
+  bool launched = false;
   while (true) {
-    // Loop until we are shutting down or it is time to run another op.
-    cond_.TimedWait(polling_interval);
+    // Loop until we are shutting down or it is time to run another op. After an op is launched,
+    // the next one is looked for right away, so that all the threads could be busy.
+    if (!launched) {
+      cond_.TimedWait(polling_interval);
+    }
+    launched = false;
     if (shutdown_) {
       VLOG_AND_TRACE("maintenance", 1) << "Shutting down maintenance manager.";
       return;
     }
 
     // Find the best op.
-    MaintenanceOp* op = FindBestOp();
+    std::string reason;
+    MaintenanceOp* op = FindBestOp(&reason);
     if (!op) {
       VLOG_AND_TRACE("maintenance", 2) << "No maintenance operations look worth doing.";
       continue;
@@ -223,6 +238,9 @@ void MaintenanceManager::RunSchedulerThread() {
     // Prepare the maintenance operation.
     op->running_++;
     running_ops_++;
+    if (op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+      running_high_io_ops_++;
+    }
     guard.unlock();
     bool ready = op->Prepare();
     guard.lock();
@@ -230,13 +248,19 @@ void MaintenanceManager::RunSchedulerThread() {
       LOG(INFO) << "Prepare failed for " << op->name()
                 << ".  Re-running scheduler.";
       op->running_--;
+      running_ops_--;
+      if (op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+        running_high_io_ops_--;
+      }
       op->cond_->Signal();
       continue;
     }
 
     // Run the maintenance operation.
-    Status s = thread_pool_->SubmitFunc(std::bind(&MaintenanceManager::LaunchOp, this, op));
+    Status s = thread_pool_->SubmitFunc(
+        std::bind(&MaintenanceManager::LaunchOp, this, op, std::move(reason)));
     CHECK(s.ok());
+    launched = true;
   }
 }
 
@@ -259,7 +283,14 @@ void MaintenanceManager::RunSchedulerThread() {
 // sliding priority between log retention and RAM usage. For example, is an Op that frees
 // 128MB of log retention and 12MB of RAM always better than an op that frees 12MB of log retention
 // and 128MB of RAM? Maybe a more holistic approach would be better.
-MaintenanceOp* MaintenanceManager::FindBestOp() {
+size_t MaintenanceManager::MaxRunningHighIOOps() const {
+  if (FLAGS_maintenance_manager_max_concurrent_high_io_ops > 0) {
+    return FLAGS_maintenance_manager_max_concurrent_high_io_ops;
+  }
+  return std::max(num_threads_ - 1, 1);
+}
+
+MaintenanceOp* MaintenanceManager::FindBestOp(std::string* reason) {
   TRACE_EVENT0("maintenance", "MaintenanceManager::FindBestOp");
   if (!FLAGS_enable_maintenance_manager) {
     VLOG_AND_TRACE("maintenance", 1) << "Maintenance manager is disabled. Doing nothing";
@@ -283,6 +314,7 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
 
   double best_perf_improvement = 0;
   MaintenanceOp* best_perf_improvement_op = nullptr;
+  const bool high_io_ops_allowed = running_high_io_ops_ < MaxRunningHighIOOps();
   for (OpMapTy::value_type &val : ops_) {
     MaintenanceOp* op(val.first);
     MaintenanceOpStats& stats(val.second);
@@ -292,6 +324,9 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     if (!stats.valid() || !stats.runnable()) {
       continue;
     }
+    if (!high_io_ops_allowed && op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+      continue;
+    }
     if (stats.logs_retained_bytes() > low_io_most_logs_retained_bytes &&
         op->io_usage_ == MaintenanceOp::LOW_IO_USAGE) {
       low_io_most_logs_retained_bytes_op = op;
@@ -327,6 +362,10 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
                     << "because it can free up more logs "
                     << "at " << low_io_most_logs_retained_bytes
                     << " bytes with a low IO cost";
+      if (reason) {
+        *reason = Format("Frees $0 bytes of logs with a low IO cost",
+                         low_io_most_logs_retained_bytes);
+      }
       return low_io_most_logs_retained_bytes_op;
     }
   }
@@ -345,6 +384,10 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
     VLOG_AND_TRACE("maintenance", 1) << "we have exceeded our soft memory limit "
             << "(current capacity is " << soft_limit_exceeded_result.current_capacity_pct << "%). "
             << "Running the op which anchors the most memory: " << most_mem_anchored_op->name();
+    if (reason) {
+      *reason = Format("Frees the most memory, $0 bytes, over the soft memory limit",
+                       most_mem_anchored);
+    }
     return most_mem_anchored_op;
   }
 
@@ -353,6 +396,9 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
             << "Performing " << most_logs_retained_bytes_op->name() << ", "
             << "because it can free up more logs " << "at " << most_logs_retained_bytes
             << " bytes";
+    if (reason) {
+      *reason = Format("Frees the most logs, $0 bytes", most_logs_retained_bytes);
+    }
     return most_logs_retained_bytes_op;
   }
 
@@ -361,13 +407,16 @@ MaintenanceOp* MaintenanceManager::FindBestOp() {
       VLOG_AND_TRACE("maintenance", 1) << "Performing " << best_perf_improvement_op->name() << ", "
                  << "because it had the best perf_improvement score, "
                  << "at " << best_perf_improvement;
+      if (reason) {
+        *reason = Format("Best performance improvement, $0", best_perf_improvement);
+      }
       return best_perf_improvement_op;
     }
   }
   return nullptr;
 }
 
-void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
+void MaintenanceManager::LaunchOp(MaintenanceOp* op, const std::string& reason) {
   MonoTime start_time(MonoTime::Now());
   op->RunningGauge()->Increment();
   LOG_TIMING(INFO, Substitute("running $0", op->name())) {
@@ -382,6 +431,7 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
 
   CompletedOp& completed_op = completed_ops_[completed_ops_count_ % completed_ops_.size()];
   completed_op.name = op->name();
+  completed_op.reason = reason;
   completed_op.duration = delta;
   completed_op.start_mono_time = start_time;
   completed_ops_count_++;
@@ -389,8 +439,13 @@ void MaintenanceManager::LaunchOp(MaintenanceOp* op) {
   op->DurationHistogram()->Increment(delta.ToMilliseconds());
 
   running_ops_--;
+  if (op->io_usage_ == MaintenanceOp::HIGH_IO_USAGE) {
+    running_high_io_ops_--;
+  }
   op->running_--;
   op->cond_->Signal();
+  // A thread is free, so the scheduler could launch the next op.
+  cond_.Signal();
 }
 
 void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatusPB* out_pb) {
@@ -424,6 +479,7 @@ void MaintenanceManager::GetMaintenanceManagerStatusDump(MaintenanceManagerStatu
     if (!completed_op.name.empty()) {
       MaintenanceManagerStatusPB_CompletedOpPB* completed_pb = out_pb->add_completed_operations();
       completed_pb->set_name(completed_op.name);
+      completed_pb->set_reason(completed_op.reason);
       completed_pb->set_duration_millis(completed_op.duration.ToMilliseconds());
 
       MonoDelta delta(MonoTime::Now().GetDeltaSince(completed_op.start_mono_time));
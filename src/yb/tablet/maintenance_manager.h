@@ -224,6 +224,8 @@ struct MaintenanceOpComparator {
 // Holds the information regarding a recently completed operation.
 struct CompletedOp {
   std::string name;
+  // Why the scheduler picked the operation.
+  std::string reason;
   MonoDelta duration;
   MonoTime start_mono_time;
 };
@@ -261,15 +263,20 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
 
  private:
   FRIEND_TEST(MaintenanceManagerTest, TestLogRetentionPrioritization);
+  FRIEND_TEST(MaintenanceManagerTest, TestHighIOLimit);
   typedef std::map<MaintenanceOp*, MaintenanceOpStats,
           MaintenanceOpComparator> OpMapTy;
 
   void RunSchedulerThread();
 
-  // find the best op, or null if there is nothing we want to run
-  MaintenanceOp* FindBestOp();
+  // find the best op, or null if there is nothing we want to run. Fills the reason the op was
+  // picked for, when reason is not null.
+  MaintenanceOp* FindBestOp(std::string* reason = nullptr);
 
-  void LaunchOp(MaintenanceOp* op);
+  void LaunchOp(MaintenanceOp* op, const std::string& reason);
+
+  // Maximum number of HIGH_IO_USAGE ops that run at the same time.
+  size_t MaxRunningHighIOOps() const;
 
   const int32_t num_threads_;
   OpMapTy ops_; // registered operations
@@ -279,6 +286,7 @@ class MaintenanceManager : public std::enable_shared_from_this<MaintenanceManage
   ConditionVariable cond_;
   bool shutdown_;
   uint64_t running_ops_;
+  uint64_t running_high_io_ops_ = 0;
   int32_t polling_interval_ms_;
   // Vector used as a circular buffer for recently completed ops. Elements need to be added at
   // the completed_ops_count_ % the vector's size and then the count needs to be incremented.
@@ -37,7 +37,9 @@
 
 #include "yb/server/logical_clock.h"
 #include "yb/tablet/mvcc.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/util/enums.h"
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/util/scope_exit.h"
 #include "yb/util/test_util.h"
@@ -47,6 +49,8 @@ using std::vector;
 
 using yb::server::LogicalClock;
 
+METRIC_DECLARE_entity(tablet);
+
 namespace yb {
 namespace tablet {
 
@@ -334,5 +338,53 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, CoarseMonoClock::now() + 100ms, FixedHybridTimeLease()));
 }
 
+// Microbenchmark of safe time requests served concurrently with operations being replicated.
+TEST_F(MvccTest, SafeTimeThroughput) {
+  constexpr int kReaders = 4;
+  const auto kDuration = 2s;
+
+  MetricRegistry registry;
+  TabletMetrics metrics(METRIC_ENTITY_tablet.Instantiate(&registry, "mvcc-test"));
+  manager_.SetMetrics(
+      metrics.mvcc_lock_contentions.get(), metrics.mvcc_safe_time_waits.get());
+
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> reads(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kReaders; ++i) {
+    threads.emplace_back([this, &stop, &reads] {
+      uint64_t local_reads = 0;
+      HybridTime last;
+      while (!stop.load(std::memory_order_acquire)) {
+        auto safe_time = manager_.SafeTime(FixedHybridTimeLease());
+        ASSERT_GE(safe_time, last);
+        last = safe_time;
+        ++local_reads;
+      }
+      reads += local_reads;
+    });
+  }
+  uint64_t writes = 0;
+  auto deadline = CoarseMonoClock::now() + kDuration;
+  while (CoarseMonoClock::now() < deadline) {
+    HybridTime ht;
+    manager_.AddPending(&ht);
+    manager_.Replicated(ht);
+    ++writes;
+  }
+  stop.store(true, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const double seconds = std::chrono::duration<double>(kDuration).count();
+  LOG(INFO) << "Safe time reads/s: " << reads.load() / seconds
+            << ", replicated operations/s: " << writes / seconds
+            << ", lock contentions: " << metrics.mvcc_lock_contentions->value()
+            << ", safe time waits: " << metrics.mvcc_safe_time_waits->value();
+  ASSERT_GT(reads.load(), 0);
+  ASSERT_GT(writes, 0);
+}
+
 } // namespace tablet
 } // namespace yb
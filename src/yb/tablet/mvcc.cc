@@ -45,6 +45,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/flags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/scope_exit.h"
 
 DEFINE_test_flag(int64, mvcc_op_trace_num_items, 0,
@@ -233,27 +234,62 @@ MvccManager::MvccManager(std::string prefix, server::ClockPtr clock)
 MvccManager::~MvccManager() {
 }
 
-void MvccManager::Replicated(HybridTime ht) {
+void MvccManager::SetMetrics(Counter* lock_contentions, Counter* safe_time_waits) {
+  lock_contentions_metric_ = lock_contentions;
+  safe_time_waits_metric_ = safe_time_waits;
+}
+
+std::unique_lock<std::mutex> MvccManager::LockMutex() const {
+  std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    if (lock_contentions_metric_) {
+      lock_contentions_metric_->Increment();
+    }
+    lock.lock();
+  }
+  return lock;
+}
+
+template <class Predicate>
+bool MvccManager::WaitFor(
+    std::unique_lock<std::mutex>* lock, CoarseTimePoint deadline,
+    const Predicate& predicate) const {
+  if (predicate()) {
+    return true;
+  }
+  if (safe_time_waits_metric_) {
+    safe_time_waits_metric_->Increment();
+  }
+  if (deadline == CoarseTimePoint::max()) {
+    cond_.wait(*lock, predicate);
+    return true;
+  }
+  return cond_.wait_until(*lock, deadline, predicate);
+}
+
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+void MvccManager::Replicated(HybridTime ht) NO_THREAD_SAFETY_ANALYSIS {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     if (op_trace_) {
       op_trace_->Add(ReplicatedTraceItem { .ht = ht });
     }
     CHECK(!queue_.empty()) << LogPrefix();
     CHECK_EQ(queue_.front(), ht) << LogPrefix();
     PopFront(&lock);
-    last_replicated_ = ht;
+    last_replicated_.store(ht, std::memory_order_release);
   }
   cond_.notify_all();
 }
 
-void MvccManager::Aborted(HybridTime ht) {
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+void MvccManager::Aborted(HybridTime ht) NO_THREAD_SAFETY_ANALYSIS {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     if (op_trace_) {
       op_trace_->Add(AbortedTraceItem { .ht = ht });
     }
@@ -268,7 +304,7 @@ void MvccManager::Aborted(HybridTime ht) {
   cond_.notify_all();
 }
 
-void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
+void MvccManager::PopFront(std::unique_lock<std::mutex>* lock) {
   queue_.pop_front();
   CHECK_GE(queue_.size(), aborted_.size()) << LogPrefix();
   while (!aborted_.empty()) {
@@ -281,11 +317,12 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
   }
 }
 
-void MvccManager::AddPending(HybridTime* ht) {
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+void MvccManager::AddPending(HybridTime* ht) NO_THREAD_SAFETY_ANALYSIS {
   const bool is_follower_side = ht->is_valid();
   HybridTime provided_ht = *ht;
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto lock = LockMutex();
 
   if (is_follower_side) {
     // This must be a follower-side transaction with already known hybrid time.
@@ -322,7 +359,7 @@ void MvccManager::AddPending(HybridTime* ht) {
           max_safe_time_returned_with_lease_.safe_time,
           max_safe_time_returned_without_lease_.safe_time,
           max_safe_time_returned_for_follower_.safe_time,
-          last_replicated_,
+          last_replicated_.load(std::memory_order_relaxed),
           last_ht_in_queue});
 
   if (*ht <= sanity_check_lower_bound) {
@@ -341,7 +378,7 @@ void MvccManager::AddPending(HybridTime* ht) {
          << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_without_lease_)
          << LOG_INFO_FOR_HT_LOWER_BOUND(max_safe_time_returned_for_follower_)
          << LOG_INFO_FOR_HT_LOWER_BOUND(
-                (SafeTimeWithSource{last_replicated_, SafeTimeSource::kUnknown}))
+                (SafeTimeWithSource{last_replicated_.load(), SafeTimeSource::kUnknown}))
          << LOG_INFO_FOR_HT_LOWER_BOUND(
                 (SafeTimeWithSource{last_ht_in_queue, SafeTimeSource::kUnknown}))
          << "\n  " << EXPR_VALUE_FOR_LOG(is_follower_side)
@@ -389,24 +426,26 @@ void MvccManager::AddPending(HybridTime* ht) {
   queue_.push_back(*ht);
 }
 
-void MvccManager::SetLastReplicated(HybridTime ht) {
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+void MvccManager::SetLastReplicated(HybridTime ht) NO_THREAD_SAFETY_ANALYSIS {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     if (op_trace_) {
       op_trace_->Add(SetLastReplicatedTraceItem { .ht = ht });
     }
-    last_replicated_ = ht;
+    last_replicated_.store(ht, std::memory_order_release);
   }
   cond_.notify_all();
 }
 
-void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) {
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+void MvccManager::SetPropagatedSafeTimeOnFollower(HybridTime ht) NO_THREAD_SAFETY_ANALYSIS {
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht << ")";
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     if (op_trace_) {
       op_trace_->Add(SetPropagatedSafeTimeOnFollowerTraceItem { .ht = ht });
     }
@@ -428,7 +467,7 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
   VLOG_WITH_PREFIX(1) << __func__ << "(" << ht_lease << ")";
 
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    auto lock = LockMutex();
     auto safe_time = DoGetSafeTime(HybridTime::kMin,       // min_allowed
                                    CoarseTimePoint::max(), // deadline
                                    ht_lease,
@@ -459,8 +498,9 @@ void MvccManager::UpdatePropagatedSafeTimeOnLeader(const FixedHybridTimeLease& h
   cond_.notify_all();
 }
 
-void MvccManager::SetLeaderOnlyMode(bool leader_only) {
-  std::lock_guard<std::mutex> lock(mutex_);
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+void MvccManager::SetLeaderOnlyMode(bool leader_only) NO_THREAD_SAFETY_ANALYSIS {
+  auto lock = LockMutex();
   if (op_trace_) {
     op_trace_->Add(SetLeaderOnlyModeTraceItem {
       .leader_only = leader_only
@@ -472,7 +512,7 @@ void MvccManager::SetLeaderOnlyMode(bool leader_only) {
 // NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
 HybridTime MvccManager::SafeTimeForFollower(
     HybridTime min_allowed, CoarseTimePoint deadline) const NO_THREAD_SAFETY_ANALYSIS {
-  std::unique_lock<std::mutex> lock(mutex_);
+  auto lock = LockMutex();
 
   if (leader_only_mode_) {
     // If there are no followers (RF == 1), use SafeTime() because propagated_safe_time_ might not
@@ -482,9 +522,10 @@ HybridTime MvccManager::SafeTimeForFollower(
 
   SafeTimeWithSource result;
   auto predicate = [this, &result, min_allowed] {
+    const auto last_replicated = last_replicated_.load(std::memory_order_relaxed);
     // last_replicated_ is updated earlier than propagated_safe_time_, so because of concurrency it
     // could be greater than propagated_safe_time_.
-    if (propagated_safe_time_ > last_replicated_) {
+    if (propagated_safe_time_ > last_replicated) {
       if (queue_.empty() || propagated_safe_time_ < queue_.front()) {
         result.safe_time = propagated_safe_time_;
         result.source = SafeTimeSource::kPropagated;
@@ -493,14 +534,12 @@ HybridTime MvccManager::SafeTimeForFollower(
         result.source = SafeTimeSource::kNextInQueue;
       }
     } else {
-      result.safe_time = last_replicated_;
+      result.safe_time = last_replicated;
       result.source = SafeTimeSource::kLastReplicated;
     }
     return result.safe_time >= min_allowed;
   };
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(lock, predicate);
-  } else if (!cond_.wait_until(lock, deadline, predicate)) {
+  if (!WaitFor(&lock, deadline, predicate)) {
     return HybridTime::kInvalid;
   }
   VLOG_WITH_PREFIX(1) << "SafeTimeForFollower(" << min_allowed
@@ -525,7 +564,7 @@ HybridTime MvccManager::SafeTime(
     HybridTime min_allowed,
     CoarseTimePoint deadline,
     const FixedHybridTimeLease& ht_lease) const NO_THREAD_SAFETY_ANALYSIS {
-  std::unique_lock<std::mutex> lock(mutex_);
+  auto lock = LockMutex();
   auto safe_time = DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
   if (op_trace_) {
     op_trace_->Add(SafeTimeTraceItem {
@@ -573,16 +612,14 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
 
     // This function could be invoked at a follower, so it has a very old ht_lease. In this case it
     // is safe to read at least at last_replicated_.
-    result = std::max(result, last_replicated_);
+    result = std::max(result, last_replicated_.load(std::memory_order_relaxed));
 
     return result >= min_allowed;
   };
 
   // In the case of an empty queue, the safe hybrid time to read at is only limited by hybrid time
   // ht_lease, which is by definition higher than min_allowed, so we would not get blocked.
-  if (deadline == CoarseTimePoint::max()) {
-    cond_.wait(*lock, predicate);
-  } else if (!cond_.wait_until(*lock, deadline, predicate)) {
+  if (!WaitFor(lock, deadline, predicate)) {
     return HybridTime::kInvalid;
   }
   VLOG_WITH_PREFIX(1) << "DoGetSafeTime(" << min_allowed << ", "
@@ -595,7 +632,7 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
       << ", " << EXPR_VALUE_FOR_LOG(enforced_min_time.ToUint64() - result.ToUint64())
       << ", " << EXPR_VALUE_FOR_LOG(ht_lease)
       << ", " << EXPR_VALUE_FOR_LOG(max_ht_lease_seen_)
-      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_)
+      << ", " << EXPR_VALUE_FOR_LOG(last_replicated_.load())
       << ", " << EXPR_VALUE_FOR_LOG(clock_->Now())
       << ", " << EXPR_VALUE_FOR_LOG(ToString(deadline))
       << ", " << EXPR_VALUE_FOR_LOG(queue_.size())
@@ -609,15 +646,21 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   return result;
 }
 
-HybridTime MvccManager::LastReplicatedHybridTime() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << last_replicated_;
-  if (op_trace_) {
-    op_trace_->Add(LastReplicatedHybridTimeTraceItem {
-      .last_replicated = last_replicated_
-    });
-  }
-  return last_replicated_;
+// NO_THREAD_SAFETY_ANALYSIS because this analysis does not work with unique_lock.
+HybridTime MvccManager::LastReplicatedHybridTime() const NO_THREAD_SAFETY_ANALYSIS {
+  if (!op_trace_) {
+    // last_replicated_ is only modified under the mutex, but could be read without it.
+    auto result = last_replicated_.load(std::memory_order_acquire);
+    VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+    return result;
+  }
+  auto lock = LockMutex();
+  auto result = last_replicated_.load(std::memory_order_relaxed);
+  VLOG_WITH_PREFIX(1) << __func__ << "(), result = " << result;
+  op_trace_->Add(LastReplicatedHybridTimeTraceItem {
+    .last_replicated = result
+  });
+  return result;
 }
 
 }  // namespace tablet
@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -45,6 +46,9 @@
 #include "yb/gutil/thread_annotations.h"
 
 namespace yb {
+
+class Counter;
+
 namespace tablet {
 
 // Allows us to keep track of how a particular value of safe time was obtained, for sanity
@@ -88,6 +92,11 @@ class MvccManager {
   explicit MvccManager(std::string prefix, server::ClockPtr clock);
   ~MvccManager();
 
+  // Sets counters of contended acquisitions of the internal mutex and of safe time requests that
+  // had to wait for the safe time to advance. Should be called before the manager is used
+  // concurrently.
+  void SetMetrics(Counter* lock_contentions, Counter* safe_time_waits);
+
   // Set special RF==1 mode flag to handle safe time requests correctly in case
   // there are no heartbeats to update internal propagated_safe_time_ correctly.
   void SetLeaderOnlyMode(bool leader_only);
@@ -136,6 +145,9 @@ class MvccManager {
   //
   // Returns invalid hybrid time in case it cannot satisfy provided requirements, for instance
   // because of timeout.
+  //
+  // Acquires the mutex: the result should not be less than the hybrid time of a concurrent
+  // AddPending, which picks its hybrid time under the same mutex.
   HybridTime SafeTime(
       HybridTime min_allowed, CoarseTimePoint deadline, const FixedHybridTimeLease& ht_lease) const;
 
@@ -146,7 +158,8 @@ class MvccManager {
 
   HybridTime SafeTimeForFollower(HybridTime min_allowed, CoarseTimePoint deadline) const;
 
-  // Returns time of last replicated operation.
+  // Returns time of last replicated operation. Does not acquire the mutex, unless operation
+  // tracing is enabled.
   HybridTime LastReplicatedHybridTime() const;
 
  private:
@@ -155,8 +168,18 @@ class MvccManager {
                            const FixedHybridTimeLease& ht_lease,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Acquires mutex_, accounting the acquisition in lock_contentions_metric_ if the mutex was held
+  // by another thread.
+  std::unique_lock<std::mutex> LockMutex() const;
+
+  // Waits on cond_ until predicate is satisfied or deadline passes. Returns false in the latter
+  // case.
+  template <class Predicate>
+  bool WaitFor(std::unique_lock<std::mutex>* lock, CoarseTimePoint deadline,
+               const Predicate& predicate) const;
+
   const std::string& LogPrefix() const { return prefix_; }
-  void PopFront(std::lock_guard<std::mutex>* lock);
+  void PopFront(std::unique_lock<std::mutex>* lock);
 
   std::string prefix_;
   server::ClockPtr clock_;
@@ -170,7 +193,8 @@ class MvccManager {
   // Required because we could abort operations from the middle of the queue.
   std::priority_queue<HybridTime, std::vector<HybridTime>, std::greater<>> aborted_;
 
-  HybridTime last_replicated_ = HybridTime::kMin;
+  // Modified under mutex_, but LastReplicatedHybridTime reads it without the mutex.
+  std::atomic<HybridTime> last_replicated_{HybridTime::kMin};
 
   // If we are a follower, this is the latest safe time sent by the leader to us. If we are the
   // leader, this is a safe time that gets updated every time the majority-replicated watermarks
@@ -188,6 +212,9 @@ class MvccManager {
   mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
 
+  Counter* lock_contentions_metric_ = nullptr;
+  Counter* safe_time_waits_metric_ = nullptr;
+
   class MvccOpTrace;
   std::unique_ptr<MvccOpTrace> op_trace_ GUARDED_BY(mutex_);
 };
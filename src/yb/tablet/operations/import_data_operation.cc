@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/operations/import_data_operation.h"
+
+#include "yb/consensus/consensus.h"
+
+#include "yb/tablet/tablet.h"
+
+namespace yb {
+namespace tablet {
+
+void ImportDataOperationState::UpdateRequestFromConsensusRound() {
+  VLOG_WITH_PREFIX(2) << "UpdateRequestFromConsensusRound";
+
+  UseRequest(&consensus_round()->replicate_msg()->import_data_request());
+}
+
+Status ImportDataOperationState::Replicated(int64_t leader_term, Status* complete_status) {
+  VLOG_WITH_PREFIX(2) << "Import data replicated " << yb::OpId::FromPB(op_id()) << ": "
+                      << request()->source_dir();
+
+  *complete_status = tablet()->ImportData(this);
+  LOG_IF_WITH_PREFIX(WARNING, !complete_status->ok())
+      << "Failed to import data from " << request()->source_dir() << ": " << *complete_status;
+  return Status::OK();
+}
+
+consensus::ReplicateMsgPtr ImportDataOperation::NewReplicateMsg() {
+  auto result = std::make_shared<consensus::ReplicateMsg>();
+  result->set_op_type(consensus::IMPORT_DATA_OP);
+  *result->mutable_import_data_request() = *state()->request();
+  return result;
+}
+
+Status ImportDataOperation::Prepare() {
+  VLOG_WITH_PREFIX(2) << "Prepare";
+  return Status::OK();
+}
+
+void ImportDataOperation::DoStart() {
+  VLOG_WITH_PREFIX(2) << "DoStart";
+
+  state()->TrySetHybridTimeFromClock();
+}
+
+Status ImportDataOperation::DoReplicated(int64_t leader_term, Status* complete_status) {
+  VLOG_WITH_PREFIX(2) << "Replicated";
+
+  return state()->Replicated(leader_term, complete_status);
+}
+
+std::string ImportDataOperation::ToString() const {
+  return Format("ImportDataOperation { state: $0 }", *state());
+}
+
+Status ImportDataOperation::DoAborted(const Status& status) {
+  return status;
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_OPERATIONS_IMPORT_DATA_OPERATION_H
+#define YB_TABLET_OPERATIONS_IMPORT_DATA_OPERATION_H
+
+#include "yb/tablet/operations/operation.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+namespace yb {
+namespace tablet {
+
+// Operation Context for the ImportData operation, that adds SST files of another RocksDB to the
+// regular RocksDB of the tablet on every replica.
+class ImportDataOperationState : public OperationStateBase<tserver::ImportDataRequestPB> {
+ public:
+  template <class... Args>
+  explicit ImportDataOperationState(Args&&... args)
+      : OperationStateBase(std::forward<Args>(args)...) {}
+
+  // Imports the data, failure to import is reported through complete_status, so the rest of the
+  // Raft group is not affected by a replica that could not access the source dir.
+  CHECKED_STATUS Replicated(int64_t leader_term, Status* complete_status);
+
+ private:
+  void UpdateRequestFromConsensusRound() override;
+};
+
+class ImportDataOperation : public Operation {
+ public:
+  explicit ImportDataOperation(std::unique_ptr<ImportDataOperationState> state)
+      : Operation(std::move(state), OperationType::kImportData) {}
+
+  ImportDataOperationState* state() override {
+    return down_cast<ImportDataOperationState*>(Operation::state());
+  }
+
+  const ImportDataOperationState* state() const override {
+    return down_cast<const ImportDataOperationState*>(Operation::state());
+  }
+
+ private:
+  consensus::ReplicateMsgPtr NewReplicateMsg() override;
+  CHECKED_STATUS Prepare() override;
+  void DoStart() override;
+  CHECKED_STATUS DoReplicated(int64_t leader_term, Status* complete_status) override;
+  CHECKED_STATUS DoAborted(const Status& status) override;
+  std::string ToString() const override;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_OPERATIONS_IMPORT_DATA_OPERATION_H
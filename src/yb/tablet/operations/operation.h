@@ -59,7 +59,7 @@ class OperationState;
 YB_DEFINE_ENUM(
     OperationType,
     (kWrite)(kChangeMetadata)(kUpdateTransaction)(kSnapshot)(kTruncate)(kEmpty)(kHistoryCutoff)
-    (kSplit));
+    (kSplit)(kImportData));
 
 // Base class for transactions.  There are different implementations for different types (Write,
 // AlterSchema, etc.) OperationDriver implementations use Operations along with Consensus to execute
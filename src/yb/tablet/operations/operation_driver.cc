@@ -48,6 +48,7 @@
 #include "yb/util/threadpool.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
+#include "yb/util/trace_span.h"
 
 using namespace std::literals;
 
@@ -90,6 +91,7 @@ OperationDriver::OperationDriver(OperationTracker *operation_tracker,
       table_type_(table_type) {
   if (Trace::CurrentTrace()) {
     Trace::CurrentTrace()->AddChildTrace(trace_.get());
+    trace_->set_span(TraceSpan::StartChild(Trace::CurrentTrace()->span(), "Operation"));
   }
   DCHECK(op_id_copy_.is_lock_free());
 }
@@ -99,6 +101,11 @@ Status OperationDriver::Init(std::unique_ptr<Operation>* operation, int64_t term
     operation_ = std::move(*operation);
   }
 
+  auto* span = trace_->span();
+  if (span && operation_) {
+    span->SetAttribute("type", ToString(operation_->operation_type()));
+  }
+
   if (term == OpId::kUnknownTerm) {
     if (operation_) {
       op_id_copy_.store(yb::OpId::FromPB(operation_->state()->op_id()),
@@ -187,6 +194,7 @@ void OperationDriver::HandleConsensusAppend() {
     return;
   }
   ADOPT_TRACE(trace());
+  AddSpanEvent("Appending to log");
   auto* const replicate_msg = operation_->state()->consensus_round()->replicate_msg().get();
   CHECK(!replicate_msg->has_hybrid_time());
   replicate_msg->set_hybrid_time(operation_->state()->hybrid_time().ToUint64());
@@ -227,6 +235,7 @@ Status OperationDriver::PrepareAndStart() {
   if (operation_) {
     RETURN_NOT_OK(operation_->Prepare());
   }
+  AddSpanEvent("Prepared");
 
   // Only take the lock long enough to take a local copy of the
   // replication state and set our prepare state. This ensures that
@@ -328,6 +337,10 @@ void OperationDriver::HandleFailure(Status status) {
   CHECK(!status.ok());
   ADOPT_TRACE(trace());
   TRACE("HandleFailure($0)", status.ToString());
+  if (trace_->span()) {
+    trace_->span()->SetAttribute("status", status.ToString());
+    trace_->span()->End();
+  }
 
   switch (repl_state_copy) {
     case NOT_REPLICATING:
@@ -355,6 +368,8 @@ void OperationDriver::ReplicationFinished(
   DCHECK(!status.ok() || op_id_local.IsInitialized());
   op_id_copy_.store(yb::OpId::FromPB(op_id_local), boost::memory_order_release);
 
+  AddSpanEvent("Replicated");
+
   PrepareState prepare_state_copy;
   {
     std::lock_guard<simple_spinlock> lock(lock_);
@@ -445,10 +460,20 @@ void OperationDriver::ApplyTask(int64_t leader_term, OpIds* applied_op_ids) {
   {
     auto status = operation_->Replicated(leader_term);
     LOG_IF_WITH_PREFIX(FATAL, !status.ok()) << "Apply failed: " << status;
+    if (trace_->span()) {
+      trace_->span()->End();
+    }
     operation_tracker_->Release(this, applied_op_ids);
   }
 }
 
+void OperationDriver::AddSpanEvent(const char* name) {
+  auto* span = trace_->span();
+  if (span) {
+    span->AddEvent(name);
+  }
+}
+
 std::string OperationDriver::StateString(ReplicationState repl_state,
                                            PrepareState prep_state) {
   string state_str;
@@ -243,6 +243,9 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // results from the Apply().
   void ApplyTask(int64_t leader_term, OpIds* applied_op_ids);
 
+  // Adds the event to the span of the operation, when the operation is done for a sampled request.
+  void AddSpanEvent(const char* name);
+
   // Returns the mutable state of the operation being executed by
   // this driver.
   OperationState* mutable_state();
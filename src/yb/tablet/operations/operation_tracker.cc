@@ -92,6 +92,10 @@ METRIC_DEFINE_gauge_uint64(tablet, history_cutoff_operations_inflight,
                            "History Cutoff Operations In Flight",
                            yb::MetricUnit::kOperations,
                            "Number of history cutoff operations currently in-flight");
+METRIC_DEFINE_gauge_uint64(tablet, import_data_operations_inflight,
+                           "Import Data Operations In Flight",
+                           yb::MetricUnit::kOperations,
+                           "Number of import data operations currently in-flight");
 
 METRIC_DEFINE_counter(tablet, operation_memory_pressure_rejections,
                       "Operation Memory Pressure Rejections",
@@ -123,6 +127,7 @@ OperationTracker::Metrics::Metrics(const scoped_refptr<MetricEntity>& entity)
   INSTANTIATE(Truncate, truncate);
   INSTANTIATE(Empty, empty);
   INSTANTIATE(HistoryCutoff, history_cutoff);
+  INSTANTIATE(ImportData, import_data);
   static_assert(8 == kElementsInOperationType, "Init metrics for all operation types");
 }
 #undef INSTANTIATE
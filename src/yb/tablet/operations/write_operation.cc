@@ -40,6 +40,7 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/consensus.h"
 #include "yb/docdb/cql_operation.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/numbers.h"
@@ -49,6 +50,7 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tablet/tablet_slow_ops.h"
 #include "yb/tserver/tserver.pb.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/debug-util.h"
@@ -114,6 +116,7 @@ Status WriteOperation::DoAborted(const Status& status) {
 Status WriteOperation::DoReplicated(int64_t leader_term, Status* complete_status) {
   TRACE_EVENT0("txn", "WriteOperation::Complete");
   TRACE("APPLY: Starting");
+  const auto replicated_time = MonoTime::Now();
 
   auto injected_latency = GetAtomicFlag(&FLAGS_tablet_inject_latency_on_apply_write_txn_ms);
   if (PREDICT_FALSE(injected_latency) > 0) {
@@ -139,10 +142,44 @@ Status WriteOperation::DoReplicated(int64_t leader_term, Status* complete_status
     auto op_duration_usec = MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds();
     metrics->write_op_duration_client_propagated_consistency->Increment(op_duration_usec);
   }
+  // Only the leader knows the whole duration of the write.
+  if (state()->has_completion_callback()) {
+    RecordIfSlow(replicated_time);
+  }
 
   return Status::OK();
 }
 
+void WriteOperation::RecordIfSlow(MonoTime replicated_time) {
+  const auto duration = MonoTime::Now() - start_time_;
+  if (!TabletSlowOps::IsSlow(duration)) {
+    return;
+  }
+  const auto& request = *state()->request();
+  SlowOpPB op;
+  op.set_type(SlowOpPB::WRITE);
+  op.set_start_time_us(GetCurrentTimeMicros() - duration.ToMicroseconds());
+  op.set_duration_us(duration.ToMicroseconds());
+  const auto& write_pairs = request.write_batch().write_pairs();
+  if (!write_pairs.empty()) {
+    const auto& key = write_pairs.Get(0).key();
+    auto size = docdb::DocKey::EncodedSize(key, docdb::DocKeyPart::WHOLE_DOC_KEY);
+    if (size.ok()) {
+      op.set_key_hash(TabletSlowOps::KeyHash(Slice(key.data(), *size)));
+    }
+  }
+  if (request.has_read_time()) {
+    op.set_read_time_ht(ReadHybridTime::FromReadTimePB(request).read.ToUint64());
+  }
+  op.set_rows_written(request.ql_write_batch_size() + request.pgsql_write_batch_size());
+  op.set_lock_wait_us(lock_wait_time_.ToMicroseconds());
+  if (submitted_time_) {
+    op.set_replication_us((replicated_time - submitted_time_).ToMicroseconds());
+  }
+  op.set_request_bytes(request.ByteSizeLong());
+  tablet()->slow_ops().Record(std::move(op));
+}
+
 string WriteOperation::ToString() const {
   MonoTime now(MonoTime::Now());
   MonoDelta d = now.GetDeltaSince(start_time_);
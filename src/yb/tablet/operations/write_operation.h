@@ -207,6 +207,20 @@ class WriteOperationContext {
   virtual ~WriteOperationContext() {}
 };
 
+// State of a write of a transaction that waits on conflicts, kept across its attempts to resolve
+// conflicts.
+struct ConflictWaitState {
+  // Time after which the conflict is returned to the client, set by the first conflict.
+  CoarseTimePoint deadline;
+
+  // Delay before the next attempt.
+  MonoDelta backoff;
+
+  // The write is waiting and should be retried after backoff, instead of being completed with the
+  // conflict.
+  bool waiting = false;
+};
+
 // Executes a write transaction.
 class WriteOperation : public Operation {
  public:
@@ -258,6 +272,11 @@ class WriteOperation : public Operation {
     return deadline_;
   }
 
+  // Leader term the operation was submitted in.
+  int64_t term() const {
+    return term_;
+  }
+
   docdb::DocOperations& doc_ops() {
     return doc_ops_;
   }
@@ -272,6 +291,15 @@ class WriteOperation : public Operation {
     return state()->force_txn_path();
   }
 
+  // Adds the time spent waiting for the locks of the rows, for the slow operations.
+  void AddLockWaitTime(MonoDelta value) {
+    lock_wait_time_ += value;
+  }
+
+  ConflictWaitState& conflict_wait() {
+    return conflict_wait_;
+  }
+
  private:
   friend class DelayedApplyOperation;
 
@@ -305,8 +333,12 @@ class WriteOperation : public Operation {
 
   void SubmittedToPreparer() override {
     preparing_token_ = ScopedOperation();
+    submitted_time_ = MonoTime::Now();
   }
 
+  // Records the write to the slow operations of the tablet, if it took long enough.
+  void RecordIfSlow(MonoTime replicated_time);
+
   const int64_t term_;
   ScopedOperation preparing_token_;
   const CoarseTimePoint deadline_;
@@ -314,9 +346,14 @@ class WriteOperation : public Operation {
 
   // this transaction's start time
   MonoTime start_time_;
+  // When the operation was submitted for the replication, after the locks were taken.
+  MonoTime submitted_time_;
+  MonoDelta lock_wait_time_ = MonoDelta::FromNanoseconds(0);
 
   HybridTime restart_read_ht_;
 
+  ConflictWaitState conflict_wait_;
+
   docdb::DocOperations doc_ops_;
 
   Tablet* tablet() { return state()->tablet(); }
@@ -0,0 +1,114 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/pgsql_read_cursors.h"
+
+#include "yb/util/test_util.h"
+
+DECLARE_int32(ysql_read_cursor_lease_ms);
+DECLARE_int32(ysql_max_read_cursors_per_tablet);
+
+namespace yb {
+namespace tablet {
+
+class PgsqlReadCursorsTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    request_.set_table_id("table");
+    request_.set_limit(10);
+    read_time_ = ReadHybridTime::SingleTime(HybridTime(1000));
+  }
+
+  // Puts a cursor for the request and returns the paging state of the next request.
+  PgsqlPagingStatePB PutCursor(const std::string& next_row_key) {
+    PgsqlPagingStatePB paging_state;
+    paging_state.set_next_row_key(next_row_key);
+    cursors_.Put(request_, read_time_, transaction_, std::make_unique<docdb::PgsqlReadCursor>(),
+                 &paging_state);
+    return paging_state;
+  }
+
+  PgsqlReadRequestPB NextRequest(const PgsqlPagingStatePB& paging_state) {
+    auto result = request_;
+    *result.mutable_paging_state() = paging_state;
+    return result;
+  }
+
+  PgsqlReadCursors cursors_;
+  PgsqlReadRequestPB request_;
+  ReadHybridTime read_time_;
+  TransactionMetadataPB transaction_;
+};
+
+TEST_F(PgsqlReadCursorsTest, TakeMatching) {
+  auto paging_state = PutCursor("key1");
+  ASSERT_TRUE(paging_state.has_cursor_id());
+  ASSERT_EQ(1, cursors_.size());
+
+  // Limit of the page does not matter.
+  auto request = NextRequest(paging_state);
+  request.set_limit(20);
+  ASSERT_NE(nullptr, cursors_.Take(request, read_time_, transaction_));
+  ASSERT_EQ(0, cursors_.size());
+
+  // A cursor could be taken only once.
+  ASSERT_EQ(nullptr, cursors_.Take(request, read_time_, transaction_));
+}
+
+TEST_F(PgsqlReadCursorsTest, TakeMismatching) {
+  auto paging_state = PutCursor("key1");
+  auto request = NextRequest(paging_state);
+  request.mutable_paging_state()->set_next_row_key("key2");
+  ASSERT_EQ(nullptr, cursors_.Take(request, read_time_, transaction_));
+  // Mismatching request drops the cursor.
+  ASSERT_EQ(0, cursors_.size());
+
+  request = NextRequest(PutCursor("key1"));
+  ASSERT_EQ(nullptr, cursors_.Take(
+      request, ReadHybridTime::SingleTime(HybridTime(2000)), transaction_));
+
+  request = NextRequest(PutCursor("key1"));
+  request.set_table_id("other_table");
+  ASSERT_EQ(nullptr, cursors_.Take(request, read_time_, transaction_));
+
+  request = NextRequest(PutCursor("key1"));
+  TransactionMetadataPB other_transaction;
+  other_transaction.set_transaction_id("txn");
+  ASSERT_EQ(nullptr, cursors_.Take(request, read_time_, other_transaction));
+}
+
+TEST_F(PgsqlReadCursorsTest, Limits) {
+  FLAGS_ysql_max_read_cursors_per_tablet = 2;
+  ASSERT_TRUE(PutCursor("key1").has_cursor_id());
+  ASSERT_TRUE(PutCursor("key2").has_cursor_id());
+  ASSERT_FALSE(PutCursor("key3").has_cursor_id());
+  ASSERT_EQ(2, cursors_.size());
+
+  cursors_.Clear();
+  ASSERT_EQ(0, cursors_.size());
+
+  FLAGS_ysql_read_cursor_lease_ms = 1;
+  auto paging_state = PutCursor("key1");
+  ASSERT_TRUE(paging_state.has_cursor_id());
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  ASSERT_EQ(nullptr, cursors_.Take(NextRequest(paging_state), read_time_, transaction_));
+
+  FLAGS_ysql_read_cursor_lease_ms = 0;
+  ASSERT_FALSE(PutCursor("key1").has_cursor_id());
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/pgsql_read_cursors.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+
+DEFINE_int32(ysql_read_cursor_lease_ms, 5000,
+             "For how long the iterator of a YSQL scan is kept on the tablet server after a page "
+             "was fetched, so the next page could continue the scan without seeking to the next "
+             "row again. 0 to disable server-side cursors.");
+TAG_FLAG(ysql_read_cursor_lease_ms, advanced);
+TAG_FLAG(ysql_read_cursor_lease_ms, runtime);
+
+DEFINE_int32(ysql_max_read_cursors_per_tablet, 16,
+             "Max number of YSQL scan iterators kept on the tablet server per tablet.");
+TAG_FLAG(ysql_max_read_cursors_per_tablet, advanced);
+TAG_FLAG(ysql_max_read_cursors_per_tablet, runtime);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+bool SameReadTime(const ReadHybridTime& lhs, const ReadHybridTime& rhs) {
+  return lhs.read == rhs.read && lhs.local_limit == rhs.local_limit &&
+         lhs.global_limit == rhs.global_limit && lhs.in_txn_limit == rhs.in_txn_limit;
+}
+
+} // namespace
+
+PgsqlReadCursors::PgsqlReadCursors() : next_id_(RandomUniformInt<uint64_t>()) {}
+
+PgsqlReadCursors::~PgsqlReadCursors() {}
+
+std::string PgsqlReadCursors::RequestFingerprint(const PgsqlReadRequestPB& request) {
+  PgsqlReadRequestPB copy = request;
+  copy.clear_paging_state();
+  copy.clear_limit();
+  return copy.SerializeAsString();
+}
+
+docdb::PgsqlReadCursorPtr PgsqlReadCursors::Take(
+    const PgsqlReadRequestPB& request, const ReadHybridTime& read_time,
+    const TransactionMetadataPB& transaction) {
+  if (!request.paging_state().has_cursor_id()) {
+    return nullptr;
+  }
+
+  std::vector<Entry> expired;
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cursors_.find(request.paging_state().cursor_id());
+    if (it != cursors_.end()) {
+      entry = std::move(it->second);
+      cursors_.erase(it);
+    }
+    RemoveExpiredUnlocked(CoarseMonoClock::Now(), &expired);
+  }
+
+  if (!entry.cursor) {
+    return nullptr;
+  }
+  if (entry.expiration < CoarseMonoClock::Now() ||
+      entry.next_row_key != request.paging_state().next_row_key() ||
+      !SameReadTime(entry.read_time, read_time) ||
+      entry.transaction_id != transaction.transaction_id() ||
+      entry.request != RequestFingerprint(request)) {
+    VLOG(2) << "Cursor " << request.paging_state().cursor_id() << " does not match request";
+    return nullptr;
+  }
+  return std::move(entry.cursor);
+}
+
+void PgsqlReadCursors::Put(const PgsqlReadRequestPB& request, const ReadHybridTime& read_time,
+                           const TransactionMetadataPB& transaction,
+                           docdb::PgsqlReadCursorPtr cursor, PgsqlPagingStatePB* paging_state) {
+  const auto lease_ms = FLAGS_ysql_read_cursor_lease_ms;
+  const size_t max_cursors = std::max(FLAGS_ysql_max_read_cursors_per_tablet, 0);
+  if (lease_ms <= 0 || max_cursors == 0 || !cursor || paging_state->next_row_key().empty()) {
+    return;
+  }
+
+  const auto now = CoarseMonoClock::Now();
+  Entry entry {
+    RequestFingerprint(request),
+    read_time,
+    transaction.transaction_id(),
+    paging_state->next_row_key(),
+    now + MonoDelta::FromMilliseconds(lease_ms),
+    std::move(cursor)
+  };
+
+  std::vector<Entry> expired;
+  std::lock_guard<std::mutex> lock(mutex_);
+  RemoveExpiredUnlocked(now, &expired);
+  if (cursors_.size() >= max_cursors) {
+    // The new cursor is dropped when the limit is reached, so the scan falls back to seeking.
+    expired.push_back(std::move(entry));
+    return;
+  }
+  const auto id = next_id_++;
+  cursors_.emplace(id, std::move(entry));
+  paging_state->set_cursor_id(id);
+}
+
+void PgsqlReadCursors::RemoveExpiredUnlocked(CoarseTimePoint now, std::vector<Entry>* expired) {
+  for (auto it = cursors_.begin(); it != cursors_.end();) {
+    if (it->second.expiration < now) {
+      expired->push_back(std::move(it->second));
+      it = cursors_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void PgsqlReadCursors::Clear() {
+  std::unordered_map<uint64_t, Entry> cursors;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cursors.swap(cursors_);
+  }
+}
+
+size_t PgsqlReadCursors::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return cursors_.size();
+}
+
+} // namespace tablet
+} // namespace yb
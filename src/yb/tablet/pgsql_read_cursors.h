@@ -0,0 +1,96 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_PGSQL_READ_CURSORS_H
+#define YB_TABLET_PGSQL_READ_CURSORS_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/common.pb.h"
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/read_hybrid_time.h"
+
+#include "yb/docdb/pgsql_operation.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tablet {
+
+// Server-side cursors of YSQL scans of a tablet.
+//
+// A scan that returns its rows in several pages would otherwise create a new DocDB iterator for
+// each page, seek it to the next row key of the paging state and resolve intents from scratch.
+// Instead, after a page is fetched, its iterator is kept here for a short lease, and the id of the
+// cursor is returned in the paging state. The next fetch of the same scan takes the iterator back,
+// already positioned at the next row.
+//
+// Cursors keep RocksDB iterators, so they should be cleared while read/write operations on the
+// tablet are paused, before RocksDB could be destroyed.
+class PgsqlReadCursors {
+ public:
+  PgsqlReadCursors();
+  ~PgsqlReadCursors();
+
+  // Returns the cursor that continues the scan of the request from its paging state, or nullptr
+  // if there is no such cursor. The cursor should have been created by the same request, at the
+  // same read time and in the same transaction.
+  docdb::PgsqlReadCursorPtr Take(
+      const PgsqlReadRequestPB& request, const ReadHybridTime& read_time,
+      const TransactionMetadataPB& transaction);
+
+  // Keeps the cursor to continue the scan from the paging state of the response, and stores its
+  // id in the paging state.
+  void Put(const PgsqlReadRequestPB& request, const ReadHybridTime& read_time,
+           const TransactionMetadataPB& transaction, docdb::PgsqlReadCursorPtr cursor,
+           PgsqlPagingStatePB* paging_state);
+
+  // Destroys all cursors.
+  void Clear();
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    // Request without paging state and limit, to check that the cursor is used by the same scan.
+    std::string request;
+    ReadHybridTime read_time;
+    std::string transaction_id;
+    std::string next_row_key;
+    CoarseTimePoint expiration;
+    docdb::PgsqlReadCursorPtr cursor;
+  };
+
+  static std::string RequestFingerprint(const PgsqlReadRequestPB& request);
+
+  // Removes cursors whose lease has expired, appending them to expired, so they are destroyed
+  // outside of the mutex.
+  void RemoveExpiredUnlocked(CoarseTimePoint now, std::vector<Entry>* expired) REQUIRES(mutex_);
+
+  mutable std::mutex mutex_;
+  uint64_t next_id_ GUARDED_BY(mutex_);
+  std::unordered_map<uint64_t, Entry> cursors_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(PgsqlReadCursors);
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_PGSQL_READ_CURSORS_H
@@ -13,6 +13,13 @@
 
 #include "yb/tablet/remove_intents_task.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_uint64(max_transactions_in_remove_intents_batch, 64,
+              "Intents of at most this number of transactions that are scheduled for removal are "
+              "removed with a single intents DB write batch.");
+TAG_FLAG(max_transactions_in_remove_intents_batch, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -34,12 +41,23 @@ bool RemoveIntentsTask::Prepare(RunningTransactionPtr transaction) {
 }
 
 void RemoveIntentsTask::Run() {
+  // Intents of transactions scheduled for removal while this task was waiting in the queue are
+  // removed together with our intents, using a single write batch. Each scheduled transaction has
+  // its own task and every task takes at least one pending transaction, so all of them are
+  // processed. Tasks that find nothing pending were already served by earlier ones.
+  auto ids = running_transaction_context_.TakePendingRemoveIntents(
+      FLAGS_max_transactions_in_remove_intents_batch);
+  if (ids.empty()) {
+    VLOG_WITH_PREFIX(2) << "Intents already removed for: " << id_;
+    return;
+  }
   RemoveIntentsData data;
   participant_context_.GetLastReplicatedData(&data);
-  auto status = applier_.RemoveIntents(data, id_);
+  auto status = applier_.RemoveIntents(data, ids);
   LOG_IF_WITH_PREFIX(WARNING, !status.ok())
-      << "Failed to remove intents of aborted transaction " << id_ << ": " << status;
-  VLOG_WITH_PREFIX(2) << "Removed intents for: " << id_;
+      << "Failed to remove intents of " << ids.size() << " transactions including " << id_
+      << ": " << status;
+  VLOG_WITH_PREFIX(2) << "Removed intents for: " << yb::ToString(ids);
 }
 
 void RemoveIntentsTask::Done(const Status& status) {
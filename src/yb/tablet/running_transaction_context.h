@@ -67,6 +67,29 @@ class RunningTransactionContext {
 
   virtual const std::string& LogPrefix() const = 0;
 
+  // Adds transaction to the set of transactions whose intents should be removed.
+  void AddPendingRemoveIntents(const TransactionId& id) {
+    std::lock_guard<std::mutex> lock(remove_intents_mutex_);
+    pending_remove_intents_.insert(id);
+  }
+
+  // Takes up to max_transactions transactions from the set of transactions whose intents should be
+  // removed, so their intents could be removed with a single write batch.
+  TransactionIdSet TakePendingRemoveIntents(size_t max_transactions) {
+    TransactionIdSet result;
+    std::lock_guard<std::mutex> lock(remove_intents_mutex_);
+    if (pending_remove_intents_.size() <= max_transactions) {
+      result.swap(pending_remove_intents_);
+      return result;
+    }
+    auto it = pending_remove_intents_.begin();
+    while (result.size() != max_transactions) {
+      result.insert(*it);
+      it = pending_remove_intents_.erase(it);
+    }
+    return result;
+  }
+
   Delayer& delayer() {
     return delayer_;
   }
@@ -80,6 +103,9 @@ class RunningTransactionContext {
   int64_t request_serial_ = 0;
   std::mutex mutex_;
 
+  std::mutex remove_intents_mutex_;
+  TransactionIdSet pending_remove_intents_ GUARDED_BY(remove_intents_mutex_);
+
   // Used only in tests.
   Delayer delayer_;
 };
@@ -38,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -46,9 +47,11 @@
 #include <boost/optional.hpp>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
+#include "yb/rocksdb/table_properties.h"
 #include "yb/rocksdb/utilities/checkpoint.h"
 #include "yb/rocksdb/write_batch.h"
 #include "yb/rocksdb/util/file_util.h"
@@ -68,6 +71,7 @@
 #include "yb/common/row_mark.h"
 #include "yb/common/schema.h"
 #include "yb/common/transaction_error.h"
+#include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus.pb.h"
@@ -75,6 +79,7 @@
 #include "yb/consensus/opid_util.h"
 
 #include "yb/docdb/bounded_rocksdb_iterator.h"
+#include "yb/docdb/conditional_row_cache.h"
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/cql_operation.h"
@@ -83,25 +88,37 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/docdb_compaction_filter_intents.h"
+#include "yb/docdb/docdb_expiration_index.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/key_bytes.h"
 #include "yb/docdb/lock_batch.h"
+#include "yb/docdb/lsm_metrics.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/primitive_value_util.h"
 #include "yb/docdb/redis_operation.h"
+#include "yb/docdb/storage_metrics.h"
+#include "yb/docdb/table_image.h"
 
 #include "yb/gutil/atomicops.h"
+#include "yb/gutil/endian.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/walltime.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/thread_pool.h"
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/maintenance_manager.h"
+#include "yb/tablet/pgsql_read_cursors.h"
+#include "yb/tablet/tablet_hot_keys.h"
+#include "yb/tablet/tablet_slow_ops.h"
 #include "yb/tablet/snapshot_coordinator.h"
 #include "yb/tablet/tablet_snapshots.h"
 #include "yb/tablet/tablet_metrics.h"
@@ -109,6 +126,7 @@
 #include "yb/tablet/transaction_coordinator.h"
 #include "yb/tablet/transaction_participant.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 #include "yb/tablet/operations/snapshot_operation.h"
@@ -121,14 +139,18 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/locks.h"
+#include "yb/util/mem_attribution.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/url-coding.h"
 
+using namespace yb::size_literals;  // NOLINT
+
 DEFINE_bool(tablet_do_dup_key_checks, true,
             "Whether to check primary keys for duplicate on insertion. "
             "Use at your own risk!");
@@ -169,6 +191,42 @@ DEFINE_int32(num_raft_ops_to_force_idle_intents_db_to_flush, 1000,
 DEFINE_bool(delete_intents_sst_files, true,
             "Delete whole intents .SST files when possible.");
 
+DEFINE_int32(intents_db_compaction_deleted_keys_percent, 50,
+             "Compact the intents RocksDB when this percent of the entries of its SST files are "
+             "deletion tombstones. 0 to not compact it because of tombstones.");
+TAG_FLAG(intents_db_compaction_deleted_keys_percent, advanced);
+TAG_FLAG(intents_db_compaction_deleted_keys_percent, runtime);
+
+DEFINE_int64(intents_db_compaction_min_deleted_keys, 100000,
+             "The intents RocksDB is not compacted because of tombstones until its SST files have "
+             "at least this many of them.");
+TAG_FLAG(intents_db_compaction_min_deleted_keys, advanced);
+TAG_FLAG(intents_db_compaction_min_deleted_keys, runtime);
+
+DEFINE_bool(delete_expired_sst_files, true,
+            "Delete the oldest SST files of YCQL tables, whose data all expired by its TTL, "
+            "instead of compacting them.");
+TAG_FLAG(delete_expired_sst_files, advanced);
+TAG_FLAG(delete_expired_sst_files, runtime);
+
+DEFINE_int32(tablet_max_concurrent_reads, 32,
+             "Maximum number of reads of a tablet that are served concurrently. The limit is "
+             "decreased when the reads get much slower than usual, and grows back as they get "
+             "fast again. Reads over the limit are rejected, and retried by the clients after a "
+             "delay. 0 for no limit.");
+TAG_FLAG(tablet_max_concurrent_reads, advanced);
+
+DEFINE_int32(tablet_max_concurrent_writes, 0,
+             "Maximum number of writes of a tablet that are processed concurrently, from the "
+             "request to the response, limited the same way as tablet_max_concurrent_reads. 0 for "
+             "no limit.");
+TAG_FLAG(tablet_max_concurrent_writes, advanced);
+
+DEFINE_int32(tablet_min_concurrent_ops, 4,
+             "The limits of the concurrent reads and writes of a tablet are not decreased below "
+             "this.");
+TAG_FLAG(tablet_min_concurrent_ops, advanced);
+
 DEFINE_int32(backfill_index_write_batch_size, 128, "The batch size for backfilling the index.");
 TAG_FLAG(backfill_index_write_batch_size, advanced);
 TAG_FLAG(backfill_index_write_batch_size, runtime);
@@ -187,6 +245,33 @@ DEFINE_int32(backfill_index_timeout_grace_margin_ms, 50,
 TAG_FLAG(backfill_index_timeout_grace_margin_ms, advanced);
 TAG_FLAG(backfill_index_timeout_grace_margin_ms, runtime);
 
+DEFINE_int32(max_wait_for_conflicting_transaction_ms, 5000,
+             "Max time that a write of a transaction that waits on conflicts is retried on the "
+             "tablet, while it conflicts with a pending transaction of higher priority. After "
+             "that the conflict is returned to the client.");
+TAG_FLAG(max_wait_for_conflicting_transaction_ms, advanced);
+TAG_FLAG(max_wait_for_conflicting_transaction_ms, runtime);
+
+DEFINE_int32(ql_conditional_row_cache_size, 0,
+             "Number of rows per tablet of non-transactional YCQL tables, whose latest values are "
+             "cached by the tablet leader after a conditional write (IF clause), so the condition "
+             "of the next conditional write of the row is checked without reading the row. 0 "
+             "disables the cache. Must not be used with tables that are written USING TIMESTAMP.");
+TAG_FLAG(ql_conditional_row_cache_size, advanced);
+
+DEFINE_int64(ql_table_image_max_bytes, 4_MB,
+             "Max size of the rows of a tablet of a YCQL table with the in_memory_image property, "
+             "i.e. caching = {'rows_per_partition': 'ALL'}, for the rows to be kept in memory to "
+             "answer the reads of single partitions. 0 disables the images.");
+TAG_FLAG(ql_table_image_max_bytes, advanced);
+TAG_FLAG(ql_table_image_max_bytes, runtime);
+
+DEFINE_int32(ql_table_image_min_idle_ms, 10000,
+             "The in-memory image of the rows of a tablet is built after the tablet was not "
+             "written to for this many milliseconds.");
+TAG_FLAG(ql_table_image_min_idle_ms, advanced);
+TAG_FLAG(ql_table_image_min_idle_ms, runtime);
+
 DEFINE_bool(cleanup_intents_sst_files, true,
             "Cleanup intents files that are no more relevant to any running transaction.");
 
@@ -208,6 +293,7 @@ DEFINE_test_flag(
 
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_bool(rocksdb_disable_compactions);
 
 using namespace std::placeholders;
 
@@ -365,6 +451,14 @@ std::string MakeTabletLogPrefix(
   return Format("T $0$1: ", tablet_id, log_prefix_suffix);
 }
 
+ConcurrencyLimiterOptions LimiterOptions(int32_t max_limit) {
+  ConcurrencyLimiterOptions result;
+  result.max_limit = std::max(max_limit, 0);
+  result.min_limit = std::max<size_t>(
+      std::min<size_t>(std::max(FLAGS_tablet_min_concurrent_ops, 1), result.max_limit), 1);
+  return result;
+}
+
 } // namespace
 
 Tablet::Tablet(const TabletInitData& data)
@@ -385,7 +479,9 @@ Tablet::Tablet(const TabletInitData& data)
       log_prefix_suffix_(data.log_prefix_suffix),
       is_sys_catalog_(data.is_sys_catalog),
       txns_enabled_(data.txns_enabled),
-      retention_policy_(std::make_shared<TabletRetentionPolicy>(clock_, metadata_.get())) {
+      retention_policy_(std::make_shared<TabletRetentionPolicy>(clock_, metadata_.get())),
+      read_limiter_(LimiterOptions(FLAGS_tablet_max_concurrent_reads)),
+      write_limiter_(LimiterOptions(FLAGS_tablet_max_concurrent_writes)) {
   CHECK(schema()->has_column_ids());
   LOG_WITH_PREFIX(INFO) << " Schema version for  " << metadata_->table_name() << " is "
                         << metadata_->schema_version();
@@ -415,6 +511,9 @@ Tablet::Tablet(const TabletInitData& data)
     });
 
     metrics_.reset(new TabletMetrics(metric_entity_));
+    mvcc_.SetMetrics(
+        metrics_->mvcc_lock_contentions.get(), metrics_->mvcc_safe_time_waits.get());
+    metadata_->SetFlushLatencyMetric(metrics_->metadata_flush_latency);
 
     mem_tracker_->SetMetricEntity(metric_entity_);
   }
@@ -424,6 +523,7 @@ Tablet::Tablet(const TabletInitData& data)
       (is_sys_catalog_ || data.metadata->schema().table_properties().is_transactional())) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
         data.transaction_participant_context, this, metric_entity_);
+    retention_policy_->SetTransactionParticipant(transaction_participant_.get());
     // Create transaction manager for secondary index update.
     if (!metadata_->index_map().empty()) {
       transaction_manager_.emplace(client_future_.get(),
@@ -450,11 +550,28 @@ Tablet::Tablet(const TabletInitData& data)
     transaction_coordinator_ = std::make_unique<TransactionCoordinator>(
         metadata_->fs_manager()->uuid(),
         data.transaction_coordinator_context,
-        metrics_->expired_transactions.get());
+        metrics_->expired_transactions.get(),
+        metrics_->created_transactions.get());
   }
 
   snapshots_ = std::make_unique<TabletSnapshots>(this);
 
+  pgsql_read_cursors_ = std::make_unique<PgsqlReadCursors>();
+
+  hot_keys_ = std::make_unique<TabletHotKeys>();
+  slow_ops_ = std::make_unique<TabletSlowOps>();
+
+  lsm_metrics_ = std::make_shared<docdb::LsmMetricsListener>(metric_entity_);
+
+  if (FLAGS_ql_conditional_row_cache_size > 0 && table_type_ == TableType::YQL_TABLE_TYPE &&
+      !is_sys_catalog_ && !metadata_->schema().table_properties().is_transactional()) {
+    conditional_row_cache_ = std::make_unique<docdb::ConditionalRowCache>(
+        FLAGS_ql_conditional_row_cache_size,
+        metrics_ ? metrics_->ql_conditional_row_cache_hits.get() : nullptr,
+        metrics_ ? metrics_->ql_conditional_row_cache_misses.get() : nullptr);
+  }
+  table_image_enabled_.store(TableImageSupported(metadata_->schema()), std::memory_order_release);
+
   snapshot_coordinator_ = data.snapshot_coordinator;
 }
 
@@ -503,6 +620,13 @@ Status Tablet::CreateTabletDirectories(const string& db_dir, FsManager* fs) {
   RETURN_NOT_OK_PREPEND(fs->CreateDirIfMissingAndSync(db_dir + kIntentsDBSuffix),
                         Format("Failed to create RocksDB tablet intents directory $0", db_dir));
 
+  const auto cold_dir = docdb::ColdRocksDBDir(db_dir);
+  if (!cold_dir.empty()) {
+    RETURN_NOT_OK_PREPEND(fs->env()->CreateDirs(cold_dir),
+                          Format("Failed to create RocksDB tablet cold data directory $0",
+                                 cold_dir));
+  }
+
   RETURN_NOT_OK(snapshots_->CreateDirectories(db_dir, fs));
 
   return Status::OK();
@@ -606,6 +730,13 @@ Status Tablet::OpenKeyValueTablet() {
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
       retention_policy_, &key_bounds_);
+  rocksdb_options.table_properties_collector_factories.push_back(
+      docdb::CreateExpirationIndexCollectorFactory());
+  if (table_type_ == TableType::YQL_TABLE_TYPE) {
+    // These files are deleted by DeleteExpiredFiles, instead of being compacted.
+    rocksdb_options.expired_file_filter = std::make_shared<rocksdb::ExpiredFileFilter>(
+        std::bind(&Tablet::FileDataExpired, this, _1, _2));
+  }
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
     if (mem_table_flush_filter_factory_) {
@@ -614,6 +745,8 @@ Status Tablet::OpenKeyValueTablet() {
     return rocksdb::MemTableFilter();
   });
 
+  rocksdb_options.listeners.push_back(lsm_metrics_);
+
   rocksdb_options.disable_auto_compactions = true;
   rocksdb_options.level0_slowdown_writes_trigger = std::numeric_limits<int>::max();
   rocksdb_options.level0_stop_writes_trigger = std::numeric_limits<int>::max();
@@ -622,6 +755,10 @@ Status Tablet::OpenKeyValueTablet() {
   RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
 
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
+  docdb::InitRocksDBDataPaths(db_dir, &rocksdb_options);
+  // Options of the intents DB are based on these, so keep its memtable factory.
+  const auto intents_memtable_factory = rocksdb_options.memtable_factory;
+  docdb::InitConcurrentMemTableInserts(&rocksdb_options);
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
   if (!rocksdb_open_status.ok()) {
@@ -634,10 +771,20 @@ Status Tablet::OpenKeyValueTablet() {
   }
   regular_db_.reset(db);
   regular_db_->ListenFilesChanged(std::bind(&Tablet::RegularDbFilesChanged, this));
+  lsm_metrics_->UpdateShape(regular_db_.get());
 
   if (transaction_participant_) {
     LOG_WITH_PREFIX(INFO) << "Opening intents DB at: " << db_dir + kIntentsDBSuffix;
     docdb::SetLogPrefix(&rocksdb_options, LogPrefix(docdb::StorageDbType::kIntents));
+    // Intents are short lived, so they are always kept in the tablet data directory.
+    rocksdb_options.db_paths.clear();
+    rocksdb_options.table_properties_collector_factories.clear();
+    rocksdb_options.expired_file_filter = nullptr;
+    // The LSM metrics are only kept for the regular DB.
+    rocksdb_options.listeners.pop_back();
+    rocksdb_options.allow_concurrent_memtable_write = false;
+    rocksdb_options.memtable_factory = intents_memtable_factory;
+    rocksdb_options.memtable_insert_thread_pool = nullptr;
 
     rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
       return std::bind(&Tablet::IntentsDbFlushFilter, this, _1);
@@ -695,8 +842,7 @@ void Tablet::SetCleanupPool(ThreadPool* thread_pool) {
 
 void Tablet::CleanupIntentFiles() {
   ScopedRWOperation scoped_read_operation(&pending_op_counter_);
-  if (!scoped_read_operation.ok() || state_ != State::kOpen || !FLAGS_delete_intents_sst_files ||
-      !cleanup_intent_files_token_) {
+  if (!scoped_read_operation.ok() || state_ != State::kOpen || !cleanup_intent_files_token_) {
     return;
   }
 
@@ -710,7 +856,7 @@ void Tablet::DoCleanupIntentFiles() {
   std::vector<rocksdb::LiveFileMetaData> files;
   // Stops when there are no more files to delete.
   std::string previous_name;
-  while (GetAtomicFlag(&FLAGS_cleanup_intents_sst_files)) {
+  while (FLAGS_delete_intents_sst_files && GetAtomicFlag(&FLAGS_cleanup_intents_sst_files)) {
     ScopedRWOperation scoped_read_operation(&pending_op_counter_);
     if (!scoped_read_operation.ok()) {
       break;
@@ -761,6 +907,62 @@ void Tablet::DoCleanupIntentFiles() {
   if (best_file_max_ht != HybridTime::kMax) {
     transaction_participant_->WaitMinRunningHybridTime(best_file_max_ht);
   }
+
+  MaybeCompactIntentsTombstones();
+}
+
+void Tablet::MaybeCompactIntentsTombstones() {
+  ScopedRWOperation scoped_read_operation(&pending_op_counter_);
+  if (!scoped_read_operation.ok()) {
+    return;
+  }
+
+  std::vector<rocksdb::LiveFileMetaData> files;
+  intents_db_->GetLiveFilesMetaData(&files);
+  uint64_t total_size = 0;
+  for (const auto& file : files) {
+    total_size += file.total_size;
+  }
+
+  rocksdb::TablePropertiesCollection properties;
+  auto status = intents_db_->GetPropertiesOfAllTables(&properties);
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to get intents SST files properties: " << status;
+    return;
+  }
+  uint64_t num_entries = 0;
+  uint64_t deleted_keys = 0;
+  for (const auto& file_properties : properties) {
+    num_entries += file_properties.second->num_entries;
+    deleted_keys += rocksdb::GetDeletedKeys(file_properties.second->user_collected_properties);
+  }
+
+  if (metrics_) {
+    metrics_->intents_db_sst_files_size->set_value(total_size);
+    metrics_->intents_db_deleted_keys->set_value(deleted_keys);
+  }
+
+  // Intents are removed with single deletes, so the tombstones are dropped together with the
+  // intents they delete once both are compacted into the same file. Files that are deleted as a
+  // whole above do not need this, but a long running transaction keeps all of the files after
+  // it from being deleted, while the tombstones in them slow down the scans of the intents.
+  const auto percent = GetAtomicFlag(&FLAGS_intents_db_compaction_deleted_keys_percent);
+  if (percent <= 0 || num_entries == 0 || FLAGS_rocksdb_disable_compactions ||
+      deleted_keys < static_cast<uint64_t>(
+          std::max<int64_t>(GetAtomicFlag(&FLAGS_intents_db_compaction_min_deleted_keys), 0)) ||
+      deleted_keys * 100 < num_entries * percent) {
+    return;
+  }
+
+  LOG_WITH_PREFIX(INFO)
+      << "Compacting intents DB, " << deleted_keys << " of " << num_entries
+      << " entries are tombstones, SST files size: " << total_size;
+  rocksdb::CompactRangeOptions options;
+  options.exclusive_manual_compaction = false;
+  status = intents_db_->CompactRange(options, /* begin = */ nullptr, /* end = */ nullptr);
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Failed to compact intents DB: " << status;
+  }
 }
 
 Status Tablet::EnableCompactions(ScopedRWOperationPause* pause_operation) {
@@ -889,12 +1091,20 @@ CHECKED_STATUS ResetRocksDB(
 }
 
 Status Tablet::ResetRocksDBs(bool destroy) {
+  if (conditional_row_cache_) {
+    conditional_row_cache_->Clear();
+  }
+  InvalidateTableImage();
+
   rocksdb::Options rocksdb_options;
   if (destroy) {
     InitRocksDBOptions(&rocksdb_options, LogPrefix());
   }
 
   Status intents_status = ResetRocksDB(destroy, rocksdb_options, &intents_db_);
+  if (destroy) {
+    docdb::InitRocksDBDataPaths(metadata()->rocksdb_dir(), &rocksdb_options);
+  }
   Status regular_status = ResetRocksDB(destroy, rocksdb_options, &regular_db_);
   key_bounds_ = docdb::KeyBounds();
 
@@ -968,7 +1178,14 @@ Status Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
     metrics_->rows_inserted->IncrementBy(write_request.write_batch().write_pairs().size());
   }
 
-  return ApplyOperationState(*operation_state, write_request.batch_idx(), put_batch);
+  auto status = ApplyOperationState(*operation_state, write_request.batch_idx(), put_batch);
+  // The rows of the conditional writes are cached before the locks of the operation are released.
+  if (status.ok() && conditional_row_cache_) {
+    for (auto& ql_write_op : *operation_state->ql_write_ops()) {
+      ql_write_op->UpdateConditionalRowCache(operation_state->op_id().term());
+    }
+  }
+  return status;
 }
 
 Status Tablet::ApplyOperationState(
@@ -1030,6 +1247,7 @@ Status Tablet::ApplyKeyValueRowOperations(int64_t batch_idx,
                                           const KeyValueWriteBatchPB& put_batch,
                                           const rocksdb::UserFrontiers* frontiers,
                                           const HybridTime hybrid_time) {
+  ScopedAllocationTag allocation_tag("tablet_apply");
   if (put_batch.write_pairs().empty() && put_batch.read_pairs().empty()) {
     return Status::OK();
   }
@@ -1038,6 +1256,10 @@ Status Tablet::ApplyKeyValueRowOperations(int64_t batch_idx,
   // For instance where aborted transaction intents are written.
   // In all other cases we should crash instead of skipping apply.
 
+  // The image should be dropped before the written rows are visible, so that no read could be
+  // answered from it after the rows were written.
+  InvalidateTableImage();
+
   rocksdb::WriteBatch write_batch;
   if (put_batch.has_transaction()) {
     RequestScope request_scope(transaction_participant_.get());
@@ -1159,6 +1381,134 @@ Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
   return Status::OK();
 }
 
+namespace {
+
+// Attaches a commit time cache shared by all iterators of a read operation to its transaction
+// operation context.
+void ShareCommitTimesForRead(
+    const ReadHybridTime& read_time, TransactionOperationContextOpt* txn_op_context) {
+  if (*txn_op_context) {
+    (**txn_op_context).commit_time_cache =
+        std::make_shared<TransactionCommitTimeCache>(read_time);
+  }
+}
+
+void RecordCommitTimeCacheStats(
+    const TransactionOperationContextOpt& txn_op_context, TabletMetrics* metrics) {
+  if (txn_op_context && txn_op_context->commit_time_cache) {
+    const auto& cache = *txn_op_context->commit_time_cache;
+    if (cache.hits()) {
+      metrics->intent_commit_time_cache_hits->IncrementBy(cache.hits());
+    }
+    if (cache.misses()) {
+      metrics->intent_commit_time_cache_misses->IncrementBy(cache.misses());
+    }
+  }
+}
+
+// Returns the encoded DocKey of the rows of the read, or an empty key if the read is not limited to
+// a single hash key. For the hot keys of the tablet.
+Result<docdb::KeyBytes> ReadDocKey(const QLReadRequestPB& request, const Schema& schema) {
+  if (request.hashed_column_values().empty()) {
+    return docdb::KeyBytes();
+  }
+  std::vector<docdb::PrimitiveValue> hashed_components;
+  RETURN_NOT_OK(docdb::QLKeyColumnValuesToPrimitiveValues(
+      request.hashed_column_values(), schema, 0, schema.num_hash_key_columns(),
+      &hashed_components));
+  return docdb::DocKey(
+      schema, static_cast<docdb::DocKeyHash>(request.hash_code()), std::move(hashed_components))
+      .Encode();
+}
+
+Result<docdb::KeyBytes> ReadDocKey(const PgsqlReadRequestPB& request, const Schema& schema) {
+  if (request.has_ybctid_column_value()) {
+    return docdb::KeyBytes(request.ybctid_column_value().value().binary_value());
+  }
+  if (request.partition_column_values().empty()) {
+    return docdb::KeyBytes();
+  }
+  std::vector<docdb::PrimitiveValue> hashed_components;
+  RETURN_NOT_OK(docdb::InitKeyColumnPrimitiveValues(
+      request.partition_column_values(), schema, 0, &hashed_components));
+  return docdb::DocKey(
+      schema, static_cast<docdb::DocKeyHash>(request.hash_code()), std::move(hashed_components))
+      .Encode();
+}
+
+template <class Request>
+void RecordReadHotKey(const Request& request, const Schema& schema, TabletHotKeys* hot_keys) {
+  if (!TabletHotKeys::ShouldSample()) {
+    return;
+  }
+  auto doc_key = ReadDocKey(request, schema);
+  if (doc_key.ok() && !doc_key->empty()) {
+    hot_keys->Record(doc_key->AsSlice());
+  }
+}
+
+// Records the sampled rows written by the batch. The pairs of a row are next to each other, so
+// a row is sampled once.
+void RecordWrittenHotKeys(const KeyValueWriteBatchPB& write_batch, TabletHotKeys* hot_keys) {
+  Slice prev_doc_key;
+  for (const auto& pair : write_batch.write_pairs()) {
+    auto size = docdb::DocKey::EncodedSize(pair.key(), docdb::DocKeyPart::WHOLE_DOC_KEY);
+    if (!size.ok()) {
+      continue;
+    }
+    Slice doc_key(pair.key().data(), *size);
+    if (doc_key == prev_doc_key) {
+      continue;
+    }
+    prev_doc_key = doc_key;
+    if (TabletHotKeys::ShouldSample()) {
+      hot_keys->Record(doc_key);
+    }
+  }
+}
+
+size_t RowsReturned(const QLReadRequestResult& result) {
+  return result.rows_data.size() >= sizeof(int32_t) ? CQLDecodeLength(result.rows_data.data()) : 0;
+}
+
+size_t RowsReturned(const PgsqlReadRequestResult& result) {
+  return result.rows_data.size() >= sizeof(uint64_t)
+      ? NetworkByteOrder::Load64(result.rows_data.data()) : 0;
+}
+
+// Records the read to the slow operations of the tablet, if it took long enough.
+template <class Request, class Result>
+void RecordSlowRead(
+    SlowOpPB::Type type, const Request& request, const Schema& schema,
+    const ReadHybridTime& read_time, MonoTime start,
+    const docdb::StorageMetricsCollector& storage_metrics, const Result& result,
+    TabletSlowOps* slow_ops) {
+  const auto duration = MonoTime::Now() - start;
+  if (!TabletSlowOps::IsSlow(duration)) {
+    return;
+  }
+  SlowOpPB op;
+  op.set_type(type);
+  op.set_start_time_us(GetCurrentTimeMicros() - duration.ToMicroseconds());
+  op.set_duration_us(duration.ToMicroseconds());
+  auto doc_key = ReadDocKey(request, schema);
+  if (doc_key.ok() && !doc_key->empty()) {
+    op.set_key_hash(TabletSlowOps::KeyHash(doc_key->AsSlice()));
+  }
+  op.set_read_time_ht(read_time.read.ToUint64());
+  op.set_rows_returned(RowsReturned(result));
+  if (storage_metrics.enabled()) {
+    StorageMetricsPB metrics;
+    storage_metrics.Fill(&metrics);
+    op.set_keys_scanned(metrics.seeks() + metrics.nexts() + metrics.prevs());
+    op.set_keys_skipped(metrics.internal_keys_skipped());
+    op.set_intents(metrics.intents());
+  }
+  slow_ops->Record(std::move(op));
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 // CQL Request Processing.
 Status Tablet::HandleQLReadRequest(
@@ -1180,8 +1530,29 @@ Status Tablet::HandleQLReadRequest(
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata, /* is_ysql_catalog_table */ false);
   RETURN_NOT_OK(txn_op_ctx);
-  return AbstractTablet::HandleQLReadRequest(
-      deadline, read_time, ql_read_request, *txn_op_ctx, result);
+  ShareCommitTimesForRead(read_time, &*txn_op_ctx);
+  auto se = ScopeExit([this, &txn_op_ctx] {
+    RecordCommitTimeCacheStats(*txn_op_ctx, metrics_.get());
+  });
+  RecordReadHotKey(ql_read_request, metadata()->schema(), hot_keys_.get());
+  const auto start = MonoTime::Now();
+  // The slow operations only need the counts of the storage work, not the timers.
+  docdb::StorageMetricsCollector storage_metrics(
+      ql_read_request.include_storage_metrics() || TabletSlowOps::Enabled(),
+      ql_read_request.include_storage_metrics() ? PerfLevel::kEnableTime
+                                                : PerfLevel::kEnableCount);
+  const auto versions_skipped = docdb::docdb_perf_context.versions_skipped;
+  RETURN_NOT_OK(AbstractTablet::HandleQLReadRequest(
+      deadline, read_time, ql_read_request, *txn_op_ctx, result, TableImageAt(read_time.read)));
+  metrics_->docdb_versions_skipped_per_read->Increment(
+      docdb::docdb_perf_context.versions_skipped - versions_skipped);
+  if (ql_read_request.include_storage_metrics()) {
+    storage_metrics.Fill(result->response.mutable_storage_metrics());
+  }
+  RecordSlowRead(
+      SlowOpPB::QL_READ, ql_read_request, metadata()->schema(), read_time, start, storage_metrics,
+      *result, slow_ops_.get());
+  return Status::OK();
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const QLReadRequestPB& ql_read_request,
@@ -1271,6 +1642,10 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
         WriteOperation::StartSynchronization(std::move(operation), status);
         return;
       }
+      if (conditional_row_cache_ &&
+          !metadata_->schema().table_properties().HasDefaultTimeToLive()) {
+        write_op->SetConditionalRowCache(conditional_row_cache_.get(), operation->term());
+      }
       doc_ops.emplace_back(std::move(write_op));
     }
   }
@@ -1284,6 +1659,11 @@ void Tablet::KeyValueBatchFromQLWriteBatch(std::unique_ptr<WriteOperation> opera
   auto status = StartDocWriteOperation(operation.get());
   scoped_read_operation.Reset();
 
+  if (operation->conflict_wait().waiting) {
+    WaitOnConflict(std::move(operation));
+    return;
+  }
+
   if (operation->restart_read_ht().is_valid()) {
     WriteOperation::StartSynchronization(std::move(operation), Status::OK());
     return;
@@ -1303,6 +1683,25 @@ void Tablet::CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, con
   }
   auto& doc_ops = operation->doc_ops();
 
+  // Conditions of a batch are checked against the rows before the batch, so the rows written more
+  // than once by the batch are not cached.
+  if (conditional_row_cache_ && doc_ops.size() > 1) {
+    std::unordered_map<Slice, int, Slice::Hash> writes_per_row;
+    for (const auto& doc_op : doc_ops) {
+      const auto& key = down_cast<QLWriteOperation*>(doc_op.get())->encoded_pk_doc_key();
+      if (key) {
+        ++writes_per_row[key.as_slice()];
+      }
+    }
+    for (const auto& doc_op : doc_ops) {
+      auto* ql_write_op = down_cast<QLWriteOperation*>(doc_op.get());
+      if (ql_write_op->has_row_cache_entry() &&
+          writes_per_row[ql_write_op->encoded_pk_doc_key().as_slice()] > 1) {
+        ql_write_op->DiscardRowCacheEntry();
+      }
+    }
+  }
+
   for (size_t i = 0; i < doc_ops.size(); i++) {
     QLWriteOperation* ql_write_op = down_cast<QLWriteOperation*>(doc_ops[i].get());
     if (metadata_->is_unique_index() &&
@@ -1330,6 +1729,8 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
   client::YBSessionPtr session;
   client::YBTransactionPtr txn;
   IndexOps index_ops;
+  // Index tables of the batch, that usually updates the same few indexes for every row.
+  std::unordered_map<TableId, client::YBTablePtr> index_tables;
   const ChildTransactionDataPB* child_transaction_data = nullptr;
   for (auto& doc_op : operation->doc_ops()) {
     auto* write_op = static_cast<QLWriteOperation*>(doc_op.get());
@@ -1369,26 +1770,28 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
 
     // Apply the write ops to update the index
     for (auto& pair : *write_op->index_requests()) {
-      client::YBTablePtr index_table;
-      bool cache_used_ignored = false;
-      if (!metadata_cache_) {
-        WriteOperation::StartSynchronization(
-            std::move(operation),
-            STATUS(Corruption, "Table metadata cache is not present for index update"));
-        return;
-      }
-      // TODO create async version of GetTable.
-      // It is ok to have sync call here, because we use cache and it should not take too long.
-      auto status = metadata_cache_->GetTable(pair.first->table_id(), &index_table,
-                                              &cache_used_ignored);
-      if (!status.ok()) {
-        WriteOperation::StartSynchronization(std::move(operation), status);
-        return;
+      client::YBTablePtr& index_table = index_tables[pair.first->table_id()];
+      if (!index_table) {
+        bool cache_used_ignored = false;
+        if (!metadata_cache_) {
+          WriteOperation::StartSynchronization(
+              std::move(operation),
+              STATUS(Corruption, "Table metadata cache is not present for index update"));
+          return;
+        }
+        // TODO create async version of GetTable.
+        // It is ok to have sync call here, because we use cache and it should not take too long.
+        auto status = metadata_cache_->GetTable(pair.first->table_id(), &index_table,
+                                                &cache_used_ignored);
+        if (!status.ok()) {
+          WriteOperation::StartSynchronization(std::move(operation), status);
+          return;
+        }
       }
       shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
       index_op->mutable_request()->Swap(&pair.second);
       index_op->mutable_request()->MergeFrom(pair.second);
-      status = session->Apply(index_op);
+      auto status = session->Apply(index_op);
       if (!status.ok()) {
         WriteOperation::StartSynchronization(std::move(operation), status);
         return;
@@ -1469,6 +1872,56 @@ Status Tablet::HandlePgsqlReadRequest(
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
 
+  PgsqlReadTxnContexts txn_op_contexts;
+  auto se = ScopeExit([this, &txn_op_contexts] {
+    RecordPgsqlCommitTimeCacheStats(txn_op_contexts);
+  });
+  return DoHandlePgsqlReadRequest(
+      deadline, read_time, pgsql_read_request, transaction_metadata, &txn_op_contexts, result);
+}
+
+Status Tablet::HandlePgsqlReadRequests(
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time,
+    const google::protobuf::RepeatedPtrField<PgsqlReadRequestPB>& pgsql_read_requests,
+    const TransactionMetadataPB& transaction_metadata,
+    std::vector<PgsqlReadRequestResult>* results) {
+  ScopedRWOperation scoped_read_operation(&pending_op_counter_, deadline);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  PgsqlReadTxnContexts txn_op_contexts;
+  auto se = ScopeExit([this, &txn_op_contexts] {
+    RecordPgsqlCommitTimeCacheStats(txn_op_contexts);
+  });
+  results->clear();
+  results->reserve(pgsql_read_requests.size());
+  for (const auto& pgsql_read_request : pgsql_read_requests) {
+    results->emplace_back();
+    RETURN_NOT_OK(DoHandlePgsqlReadRequest(
+        deadline, read_time, pgsql_read_request, transaction_metadata, &txn_op_contexts,
+        &results->back()));
+    if (results->back().restart_read_ht.is_valid()) {
+      break;
+    }
+  }
+  return Status::OK();
+}
+
+void Tablet::RecordPgsqlCommitTimeCacheStats(const PgsqlReadTxnContexts& txn_op_contexts) {
+  for (const auto& txn_op_ctx : txn_op_contexts) {
+    if (txn_op_ctx) {
+      RecordCommitTimeCacheStats(*txn_op_ctx, metrics_.get());
+    }
+  }
+}
+
+Status Tablet::DoHandlePgsqlReadRequest(
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time,
+    const PgsqlReadRequestPB& pgsql_read_request,
+    const TransactionMetadataPB& transaction_metadata,
+    PgsqlReadTxnContexts* txn_op_contexts,
+    PgsqlReadRequestResult* result) {
   const tablet::TableInfo* table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
   // Assert the table is a Postgres table.
@@ -1478,13 +1931,39 @@ Status Tablet::HandlePgsqlReadRequest(
     return Status::OK();
   }
 
-  Result<TransactionOperationContextOpt> txn_op_ctx =
-      CreateTransactionOperationContext(
-          transaction_metadata,
-          table_info->schema.table_properties().is_ysql_catalog_table());
-  RETURN_NOT_OK(txn_op_ctx);
-  return AbstractTablet::HandlePgsqlReadRequest(
-      deadline, read_time, pgsql_read_request, *txn_op_ctx, result);
+  const bool is_ysql_catalog_table = table_info->schema.table_properties().is_ysql_catalog_table();
+  auto& txn_op_ctx = (*txn_op_contexts)[is_ysql_catalog_table];
+  if (!txn_op_ctx) {
+    txn_op_ctx = VERIFY_RESULT(CreateTransactionOperationContext(
+        transaction_metadata, is_ysql_catalog_table));
+    ShareCommitTimesForRead(read_time, &*txn_op_ctx);
+  }
+  RecordReadHotKey(pgsql_read_request, table_info->schema, hot_keys_.get());
+  const auto start = MonoTime::Now();
+  docdb::StorageMetricsCollector storage_metrics(
+      pgsql_read_request.include_storage_metrics() || TabletSlowOps::Enabled(),
+      pgsql_read_request.include_storage_metrics() ? PerfLevel::kEnableTime
+                                                   : PerfLevel::kEnableCount);
+  auto cursor = pgsql_read_cursors_->Take(pgsql_read_request, read_time, transaction_metadata);
+  const auto versions_skipped = docdb::docdb_perf_context.versions_skipped;
+  RETURN_NOT_OK(AbstractTablet::HandlePgsqlReadRequest(
+      deadline, read_time, pgsql_read_request, *txn_op_ctx, result, &cursor));
+  metrics_->docdb_versions_skipped_per_read->Increment(
+      docdb::docdb_perf_context.versions_skipped - versions_skipped);
+  if (pgsql_read_request.include_storage_metrics()) {
+    storage_metrics.Fill(result->response.mutable_storage_metrics());
+  }
+  RecordSlowRead(
+      SlowOpPB::PGSQL_READ, pgsql_read_request, table_info->schema, read_time, start,
+      storage_metrics, *result, slow_ops_.get());
+  // The cursor could only continue from the next row key of the same tablet, and not after a read
+  // restart, since the following pages are read at another time.
+  if (cursor && result->response.has_paging_state() && !result->restart_read_ht.is_valid()) {
+    pgsql_read_cursors_->Put(
+        pgsql_read_request, read_time, transaction_metadata, std::move(cursor),
+        result->response.mutable_paging_state());
+  }
+  return Status::OK();
 }
 
 CHECKED_STATUS Tablet::CreatePagingStateForRead(const PgsqlReadRequestPB& pgsql_read_request,
@@ -1598,7 +2077,7 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
 
   if (!key_value_write_request->redis_write_batch().empty()) {
     auto status = KeyValueBatchFromRedisWriteBatch(operation.get());
-    WriteOperation::StartSynchronization(std::move(operation), status);
+    StartSynchronizationOrWaitOnConflict(std::move(operation), status);
     return;
   }
 
@@ -1609,11 +2088,15 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
 
   if (!key_value_write_request->pgsql_write_batch().empty()) {
     auto status = KeyValueBatchFromPgsqlWriteBatch(operation.get());
-    WriteOperation::StartSynchronization(std::move(operation), status);
+    StartSynchronizationOrWaitOnConflict(std::move(operation), status);
     return;
   }
 
   if (key_value_write_request->has_write_batch()) {
+    // Rows written directly, e.g. by replication from another cluster, are not tracked.
+    if (conditional_row_cache_) {
+      conditional_row_cache_->Clear();
+    }
     Status status;
     if (!key_value_write_request->write_batch().read_pairs().empty()) {
       ScopedRWOperation scoped_operation(&pending_op_counter_);
@@ -1626,7 +2109,7 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
     } else {
       DCHECK(key_value_write_request->has_external_hybrid_time());
     }
-    WriteOperation::StartSynchronization(std::move(operation), status);
+    StartSynchronizationOrWaitOnConflict(std::move(operation), status);
     return;
   }
 
@@ -1637,6 +2120,75 @@ void Tablet::AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation>
   operation->state()->CompleteWithStatus(Status::OK());
 }
 
+namespace {
+
+// Performs a write that waited on a conflict again, in the thread pool of the tablet peer.
+class ConflictRetryTask : public rpc::ThreadPoolTask {
+ public:
+  ConflictRetryTask(Tablet* tablet, std::unique_ptr<WriteOperation> operation)
+      : tablet_(tablet), operation_(std::move(operation)) {
+  }
+
+  virtual ~ConflictRetryTask() = default;
+
+ private:
+  void Run() override {
+    tablet_->AcquireLocksAndPerformDocOperations(std::move(operation_));
+  }
+
+  void Done(const Status& status) override {
+    if (!status.ok() && operation_) {
+      operation_->state()->CompleteWithStatus(status);
+    }
+
+    delete this;
+  }
+
+  Tablet* const tablet_;
+  std::unique_ptr<WriteOperation> operation_;
+};
+
+} // namespace
+
+void Tablet::StartSynchronizationOrWaitOnConflict(
+    std::unique_ptr<WriteOperation> operation, const Status& status) {
+  if (operation->conflict_wait().waiting) {
+    WaitOnConflict(std::move(operation));
+    return;
+  }
+  WriteOperation::StartSynchronization(std::move(operation), status);
+}
+
+void Tablet::WaitOnConflict(std::unique_ptr<WriteOperation> operation) {
+  auto& conflict_wait = operation->conflict_wait();
+  conflict_wait.waiting = false;
+
+  // The write is performed again from the request, so drop what was done by this attempt.
+  operation->doc_ops().clear();
+  auto* response = operation->response();
+  response->clear_redis_response_batch();
+  response->clear_ql_response_batch();
+  response->clear_pgsql_response_batch();
+
+  const auto delay = conflict_wait.backoff;
+  VLOG_WITH_PREFIX(2) << "Waiting " << delay << " on conflict: " << operation->ToString();
+  metrics_->write_conflict_waits->Increment();
+  IncrementGauge(metrics_->write_ops_waiting_on_conflicts);
+  client_future_.get()->messenger()->scheduler().Schedule(
+      [this, op = operation.release()](const Status& status) {
+        std::unique_ptr<WriteOperation> operation(op);
+        DecrementGauge(metrics_->write_ops_waiting_on_conflicts);
+        if (!status.ok()) {
+          operation->state()->CompleteWithStatus(status);
+          return;
+        }
+        // Conflict resolution could block, so it is not done on the scheduler thread.
+        transaction_participant_->context()->Enqueue(
+            new ConflictRetryTask(this, std::move(operation)));
+      },
+      delay.ToSteadyDuration());
+}
+
 Status Tablet::Flush(FlushMode mode, FlushFlags flags, int64_t ignore_if_flushed_after_tick) {
   TRACE_EVENT0("tablet", "Tablet::Flush");
 
@@ -1672,8 +2224,57 @@ Status Tablet::WaitForFlush() {
 }
 
 Status Tablet::ImportData(const std::string& source_dir) {
+  return DoImportData(source_dir, nullptr /* frontier */);
+}
+
+Status Tablet::ImportData(ImportDataOperationState* state) {
+  docdb::ConsensusFrontier frontier;
+  frontier.set_op_id({state->op_id().term(), state->op_id().index()});
+  frontier.set_hybrid_time(state->hybrid_time());
+  return DoImportData(state->request()->source_dir(), frontier.Clone());
+}
+
+Status Tablet::DoImportData(const std::string& source_dir, rocksdb::UserFrontierPtr frontier) {
+  ScopedRWOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  if (conditional_row_cache_) {
+    conditional_row_cache_->Clear();
+  }
+  InvalidateTableImage();
+
   // We import only regular records, so don't have to deal with intents here.
-  return regular_db_->Import(source_dir);
+  rocksdb::ImportOptions options;
+  options.key_range_validator = [this](const Slice& smallest, const Slice& largest) {
+    return CheckKeyRangeBelongsToTablet(smallest, largest);
+  };
+  options.flushed_frontier = std::move(frontier);
+  RETURN_NOT_OK(regular_db_->Import(source_dir, options));
+  LOG_WITH_PREFIX(INFO) << "Imported data from " << source_dir;
+  return Status::OK();
+}
+
+Status Tablet::CheckKeyRangeBelongsToTablet(const Slice& smallest, const Slice& largest) const {
+  if (!key_bounds_.IsWithinBounds(smallest) || !key_bounds_.IsWithinBounds(largest)) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Key range [$0, $1] is out of tablet key bounds $2",
+        smallest.ToDebugHexString(), largest.ToDebugHexString(), key_bounds_);
+  }
+  if (!metadata_->partition_schema().IsHashPartitioning()) {
+    return Status::OK();
+  }
+  // Keys are ordered by hash code first, so it is enough to check the range ends.
+  const auto& partition = metadata_->partition();
+  for (const auto& key : {smallest, largest}) {
+    const auto hash = VERIFY_RESULT(docdb::DocKey::DecodeHash(key));
+    if (!partition.ContainsKey(PartitionSchema::EncodeMultiColumnHashValue(hash))) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Key $0 with hash code $1 does not belong to tablet partition $2",
+          key.ToDebugHexString(), hash,
+          metadata_->partition_schema().PartitionDebugString(partition, *schema()));
+    }
+  }
+  return Status::OK();
 }
 
 template <class Data>
@@ -1823,6 +2424,18 @@ Status Tablet::AlterSchema(ChangeMetadataOperationState *operation_state) {
 
   metadata_->SetSchema(*operation_state->schema(), operation_state->index_map(), deleted_cols,
                        operation_state->schema_version());
+  if (conditional_row_cache_) {
+    conditional_row_cache_->Clear();
+  }
+  table_image_enabled_.store(
+      TableImageSupported(*operation_state->schema()), std::memory_order_release);
+  {
+    // Drops the image even if the images were disabled by this change.
+    std::lock_guard<std::mutex> lock(table_image_mutex_);
+    ++table_image_generation_;
+    table_image_.reset();
+    table_image_invalidation_time_ = CoarseMonoClock::Now();
+  }
   if (operation_state->has_new_table_name()) {
     metadata_->SetTableName(operation_state->new_table_name());
     if (metric_entity_) {
@@ -1865,7 +2478,8 @@ Status Tablet::AlterWalRetentionSecs(ChangeMetadataOperationState* operation_sta
 Result<std::string> Tablet::BackfillIndexes(const std::vector<IndexInfo> &indexes,
                                             const std::string& backfill_from,
                                             const CoarseTimePoint deadline,
-                                            const HybridTime read_time) {
+                                            const HybridTime read_time,
+                                            size_t* number_rows_processed) {
   if (PREDICT_FALSE(FLAGS_TEST_slowdown_backfill_by_ms > 0)) {
     TRACE("Sleeping for $0 ms", FLAGS_TEST_slowdown_backfill_by_ms);
     SleepFor(MonoDelta::FromMilliseconds(FLAGS_TEST_slowdown_backfill_by_ms));
@@ -1940,6 +2554,7 @@ Result<std::string> Tablet::BackfillIndexes(const std::vector<IndexInfo> &indexe
 
   VLOG(1) << "Processed " << num_rows_processed << " rows";
   RETURN_NOT_OK(FlushIndexBatchIfRequired(&index_requests, /* forced */ true));
+  *number_rows_processed += num_rows_processed;
   LOG(INFO) << "Done BackfillIndexes at " << read_time << " for "
             << yb::ToString(index_names) << " until "
             << (resume_from.empty() ? "<end of the tablet>"
@@ -2086,10 +2701,16 @@ Status Tablet::FlushWithRetries(
 ScopedRWOperationPause Tablet::PauseReadWriteOperations(Stop stop) {
   LOG_SLOW_EXECUTION(WARNING, 1000,
                      Substitute("Tablet $0: Waiting for pending ops to complete", tablet_id())) {
-    return ScopedRWOperationPause(
+    ScopedRWOperationPause pause(
         &pending_op_counter_,
         MonoDelta::FromMilliseconds(FLAGS_tablet_rocksdb_ops_quiet_down_timeout_ms),
         stop);
+    if (pause.ok() && pgsql_read_cursors_) {
+      // No read is running, so cursors could not be added until operations are resumed, and their
+      // iterators are destroyed while RocksDB is still alive.
+      pgsql_read_cursors_->Clear();
+    }
+    return pause;
   }
   FATAL_ERROR("Unreachable code -- the previous block must always return");
 }
@@ -2328,6 +2949,38 @@ Result<HybridTime> Tablet::OldestMutableMemtableWriteHybridTime() const {
   return result;
 }
 
+Result<HybridTime> Tablet::NewestMutableMemtableWriteHybridTime() const {
+  ScopedRWOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  HybridTime result = HybridTime::kMin;
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    if (db) {
+      auto mem_frontier = db->GetMutableMemTableFrontier(rocksdb::UpdateUserValueType::kLargest);
+      if (mem_frontier) {
+        const auto hybrid_time =
+            static_cast<const docdb::ConsensusFrontier&>(*mem_frontier).hybrid_time();
+        result = std::max(result, hybrid_time);
+      }
+    }
+  }
+  return result;
+}
+
+Result<uint64_t> Tablet::MutableMemtablesSize() const {
+  ScopedRWOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  uint64_t result = 0;
+  for (auto* db : { regular_db_.get(), intents_db_.get() }) {
+    uint64_t size = 0;
+    if (db && db->GetIntProperty(rocksdb::DB::Properties::kCurSizeActiveMemTable, &size)) {
+      result += size;
+    }
+  }
+  return result;
+}
+
 Status Tablet::DebugDump(vector<string> *lines) {
   switch (table_type_) {
     case TableType::PGSQL_TABLE_TYPE: FALLTHROUGH_INTENDED;
@@ -2374,10 +3027,18 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   }
 
   const auto partial_range_key_intents = UsePartialRangeKeyIntents(metadata_.get());
-  auto prepare_result = VERIFY_RESULT(docdb::PrepareDocWriteOperation(
-      operation->doc_ops(), write_batch->read_pairs(), metrics_->write_lock_latency,
-      isolation_level, operation->state()->kind(), row_mark_type, transactional_table,
-      operation->deadline(), partial_range_key_intents, &shared_lock_manager_));
+  docdb::PrepareDocWriteOperationResult prepare_result;
+  {
+    IncrementGauge(metrics_->write_ops_acquiring_locks);
+    auto se = ScopeExit([this] {
+      DecrementGauge(metrics_->write_ops_acquiring_locks);
+    });
+    prepare_result = VERIFY_RESULT(docdb::PrepareDocWriteOperation(
+        operation->doc_ops(), write_batch->read_pairs(), metrics_->write_lock_latency,
+        isolation_level, operation->state()->kind(), row_mark_type, transactional_table,
+        operation->deadline(), partial_range_key_intents, &shared_lock_manager_));
+  }
+  operation->AddLockWaitTime(prepare_result.lock_wait_time);
 
   RequestScope request_scope;
   if (transaction_participant_) {
@@ -2388,6 +3049,12 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   const bool allow_immediate_read_restart = !read_time;
 
   if (txns_enabled_ && transactional_table) {
+    IncrementGauge(metrics_->write_ops_resolving_conflicts);
+    auto se = ScopeExit([this] {
+      DecrementGauge(metrics_->write_ops_resolving_conflicts);
+    });
+    ScopedTabletMetricsTracker conflict_resolution_tracker(
+        metrics_->write_conflict_resolution_latency);
     if (isolation_level == IsolationLevel::NON_TRANSACTIONAL) {
       auto now = clock_->Now();
       auto result = VERIFY_RESULT(docdb::ResolveOperationConflicts(
@@ -2397,6 +3064,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
         clock_->Update(result);
       }
     } else {
+      const int num_read_pairs = write_batch->read_pairs_size();
       if (isolation_level == IsolationLevel::SERIALIZABLE_ISOLATION &&
           prepare_result.need_read_snapshot) {
         boost::container::small_vector<RefCntPrefix, 16> paths;
@@ -2416,10 +3084,43 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
         }
       }
 
-      RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
+      // Transactions that wait on conflicts are retried while they are blocked by a pending
+      // transaction of higher priority, instead of returning the conflict to the client. The locks
+      // are released when this attempt fails, so the blocking transaction could write the same
+      // keys, and the caller schedules the retry, see WaitOnConflict. The conflict is counted by
+      // the transaction_conflicts metric once per operation.
+      auto& conflict_wait = operation->conflict_wait();
+      const bool first_attempt = conflict_wait.deadline == CoarseTimePoint();
+      bool blocked_by_higher_priority = false;
+      auto status = docdb::ResolveTransactionConflicts(
           operation->doc_ops(), *write_batch, clock_->Now(),
           read_time ? read_time.read : HybridTime::kMax, doc_db(), partial_range_key_intents,
-          transaction_participant_.get(), metrics_->transaction_conflicts.get()));
+          transaction_participant_.get(),
+          first_attempt ? metrics_->transaction_conflicts.get() : nullptr,
+          &blocked_by_higher_priority);
+      if (!status.ok()) {
+        if (blocked_by_higher_priority && client_future_.valid()) {
+          const auto kMinConflictWaitBackoff = 1ms;
+          const auto kMaxConflictWaitBackoff = 100ms;
+          auto now = CoarseMonoClock::now();
+          if (first_attempt) {
+            conflict_wait.deadline = std::min(
+                operation->deadline(),
+                now + FLAGS_max_wait_for_conflicting_transaction_ms * 1ms);
+            conflict_wait.backoff = MonoDelta(kMinConflictWaitBackoff);
+          } else {
+            conflict_wait.backoff = std::min(
+                conflict_wait.backoff * 2, MonoDelta(kMaxConflictWaitBackoff));
+          }
+          if (now + conflict_wait.backoff < conflict_wait.deadline) {
+            conflict_wait.waiting = true;
+            // The read pairs added above are added again by the retry.
+            write_batch->mutable_read_pairs()->DeleteSubrange(
+                num_read_pairs, write_batch->read_pairs_size() - num_read_pairs);
+          }
+        }
+        return status;
+      }
 
       if (!read_time) {
         auto safe_time = SafeTime(RequireLease::kTrue);
@@ -2459,7 +3160,8 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
         table_type_ == TableType::REDIS_TABLE_TYPE
             ? InitMarkerBehavior::kRequired
             : InitMarkerBehavior::kOptional,
-        &monotonic_counter_, &restart_read_ht, metadata_->table_name()));
+        &monotonic_counter_, &restart_read_ht, metadata_->table_name(),
+        metrics_->doc_write_batch_cache_hits.get()));
 
     // For serializable isolation we don't fix read time, so could do read restart locally,
     // instead of failing whole transaction.
@@ -2485,6 +3187,10 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
 
   operation->SetRestartReadHt(restart_read_ht);
 
+  if (!restart_read_ht.is_valid()) {
+    RecordWrittenHotKeys(*write_batch, hot_keys_.get());
+  }
+
   if (allow_immediate_read_restart && isolation_level != IsolationLevel::NON_TRANSACTIONAL &&
       operation->response()) {
     real_read_time.ToPB(operation->response()->mutable_used_read_time());
@@ -2578,14 +3284,14 @@ size_t Tablet::TEST_CountRegularDBRecords() {
 }
 
 template <class Functor>
-uint64_t Tablet::GetRegularDbStat(const Functor& functor) const {
+auto Tablet::GetRegularDbStat(const Functor& functor) const -> decltype(functor()) {
   ScopedRWOperation scoped_operation(&pending_op_counter_);
   std::lock_guard<rw_spinlock> lock(component_lock_);
 
   // In order to get actual stats we would have to wait.
   // This would give us correct stats but would make this request slower.
   if (!scoped_operation.ok() || !regular_db_) {
-    return 0;
+    return decltype(functor())();
   }
   return functor();
 }
@@ -2597,6 +3303,110 @@ uint64_t Tablet::GetCurrentVersionSstFilesSize() const {
   });
 }
 
+std::string Tablet::FindFileWithExpiredData(
+    double min_expired_ratio, uint64_t* expired_bytes) const {
+  return GetRegularDbStat([this, min_expired_ratio, expired_bytes] {
+    rocksdb::TablePropertiesCollection properties;
+    auto status = regular_db_->GetPropertiesOfAllTables(&properties);
+    if (!status.ok()) {
+      LOG_WITH_PREFIX(WARNING) << "Failed to get properties of SST files: " << status;
+      return std::string();
+    }
+    std::unordered_set<uint64_t> being_compacted;
+    for (const auto& file : regular_db_->GetLiveFilesMetaData()) {
+      if (file.being_compacted) {
+        being_compacted.insert(rocksdb::TableFileNameToNumber(file.name));
+      }
+    }
+
+    const auto history_cutoff = retention_policy_->GetRetentionDirective().history_cutoff;
+    std::string result;
+    *expired_bytes = 0;
+    for (const auto& entry : properties) {
+      const auto& file_properties = *entry.second;
+      const auto file_bytes = file_properties.raw_key_size + file_properties.raw_value_size;
+      const auto file_expired_bytes = docdb::ExpiredBytes(file_properties, history_cutoff);
+      if (file_expired_bytes <= *expired_bytes ||
+          file_expired_bytes < min_expired_ratio * file_bytes ||
+          being_compacted.count(rocksdb::TableFileNameToNumber(entry.first))) {
+        continue;
+      }
+      result = entry.first;
+      *expired_bytes = file_expired_bytes;
+    }
+    return result;
+  });
+}
+
+Status Tablet::CompactFile(const std::string& file_name) {
+  ScopedRWOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+  if (!regular_db_) {
+    return STATUS(IllegalState, "Regular DB is not open");
+  }
+  LOG_WITH_PREFIX(INFO) << "Compacting " << file_name << " because of its expired data";
+  // A file is compacted on its own, so that it is contiguous with itself in the order of files.
+  return regular_db_->CompactFiles(rocksdb::CompactionOptions(), {file_name}, /* output_level */ 0);
+}
+
+bool Tablet::FileDataExpired(const rocksdb::FileBoundaryValuesBase& smallest,
+                             const rocksdb::FileBoundaryValuesBase& largest) const {
+  if (!GetAtomicFlag(&FLAGS_delete_expired_sst_files)) {
+    return false;
+  }
+  const auto directive = retention_policy_->GetRetentionDirective();
+  return docdb::FileDataExpired(smallest, largest, directive.table_ttl, directive.history_cutoff);
+}
+
+std::vector<rocksdb::LiveFileMetaData> Tablet::OldestExpiredFiles() const {
+  std::vector<rocksdb::LiveFileMetaData> result;
+  if (table_type_ != TableType::YQL_TABLE_TYPE) {
+    return result;
+  }
+  auto files = regular_db_->GetLiveFilesMetaData();
+  for (const auto& file : files) {
+    // The files of the other levels hold older data than the files of level 0, and only the files
+    // of the last level could be deleted.
+    if (file.level != 0) {
+      return result;
+    }
+  }
+  std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.largest.seqno < rhs.largest.seqno;
+  });
+  for (auto& file : files) {
+    if (file.being_compacted || !FileDataExpired(file.smallest, file.largest)) {
+      break;
+    }
+    result.push_back(std::move(file));
+  }
+  return result;
+}
+
+uint64_t Tablet::ExpiredFilesSize() const {
+  return GetRegularDbStat([this] {
+    uint64_t result = 0;
+    for (const auto& file : OldestExpiredFiles()) {
+      result += file.total_size;
+    }
+    return result;
+  });
+}
+
+Status Tablet::DeleteExpiredFiles() {
+  ScopedRWOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+  if (!regular_db_) {
+    return STATUS(IllegalState, "Regular DB is not open");
+  }
+  // Each file is the oldest one once the previous ones are deleted.
+  for (const auto& file : OldestExpiredFiles()) {
+    LOG_WITH_PREFIX(INFO) << "Deleting " << file.ToString() << " because all of its data expired";
+    RETURN_NOT_OK(regular_db_->DeleteFile(file.name));
+  }
+  return Status::OK();
+}
+
 uint64_t Tablet::GetCurrentVersionSstFilesUncompressedSize() const {
   return GetRegularDbStat([this] {
     return regular_db_->GetCurrentVersionSstFilesUncompressedSize();
@@ -2609,6 +3419,86 @@ uint64_t Tablet::GetCurrentVersionNumSSTFiles() const {
   });
 }
 
+double Tablet::GetWriteStallPressure() const {
+  return GetRegularDbStat([this] {
+    return regular_db_->GetWriteStallPressure();
+  });
+}
+
+bool Tablet::TableImageSupported(const Schema& schema) const {
+  return table_type_ == TableType::YQL_TABLE_TYPE && !is_sys_catalog_ &&
+         !schema.table_properties().is_transactional() &&
+         schema.table_properties().in_memory_image();
+}
+
+void Tablet::InvalidateTableImage() {
+  if (!table_image_enabled_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(table_image_mutex_);
+  ++table_image_generation_;
+  table_image_.reset();
+  table_image_invalidation_time_ = CoarseMonoClock::Now();
+}
+
+std::shared_ptr<const docdb::TableImage> Tablet::TableImageAt(HybridTime read_ht) const {
+  if (!table_image_enabled_.load(std::memory_order_acquire) ||
+      FLAGS_ql_table_image_max_bytes <= 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(table_image_mutex_);
+  if (!table_image_ || read_ht < table_image_->hybrid_time()) {
+    return nullptr;
+  }
+  return table_image_;
+}
+
+bool Tablet::ShouldBuildTableImage() const {
+  if (!table_image_enabled_.load(std::memory_order_acquire) ||
+      FLAGS_ql_table_image_max_bytes <= 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(table_image_mutex_);
+  return !table_image_ && table_image_built_generation_ != table_image_generation_ &&
+         CoarseMonoClock::Now() - table_image_invalidation_time_ >=
+             std::chrono::milliseconds(FLAGS_ql_table_image_min_idle_ms);
+}
+
+Status Tablet::BuildTableImage() {
+  ScopedRWOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(table_image_mutex_);
+    if (table_image_) {
+      return Status::OK();
+    }
+    generation = table_image_generation_;
+  }
+
+  // All writes up to the safe time are applied, and the later writes will drop the image.
+  const Schema schema = metadata_->schema();
+  const auto hybrid_time = SafeTime(RequireLease::kFalse);
+  auto image = VERIFY_RESULT(docdb::TableImage::Build(
+      schema, doc_db(), hybrid_time, FLAGS_ql_table_image_max_bytes));
+
+  std::lock_guard<std::mutex> lock(table_image_mutex_);
+  if (generation != table_image_generation_) {
+    // A write was applied while the image was built, so it would miss the written rows.
+    return Status::OK();
+  }
+  table_image_built_generation_ = generation;
+  if (!image) {
+    LOG_WITH_PREFIX(INFO) << "Rows of the table could not be kept in memory";
+    return Status::OK();
+  }
+  LOG_WITH_PREFIX(INFO) << "Built the in-memory image of " << image->num_rows() << " rows, "
+                        << image->bytes() << " bytes, as of " << hybrid_time;
+  table_image_ = std::move(image);
+  return Status::OK();
+}
+
 std::pair<int, int> Tablet::GetNumMemtables() const {
   int intents_num_memtables = 0;
   int regular_num_memtables = 0;
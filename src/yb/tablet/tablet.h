@@ -32,7 +32,9 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <array>
 #include <iosfwd>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -40,6 +42,7 @@
 #include <vector>
 
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/metadata.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/write_batch.h"
@@ -71,6 +74,7 @@
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/transaction_participant.h"
 
+#include "yb/util/concurrency_limiter.h"
 #include "yb/util/locks.h"
 #include "yb/util/metrics.h"
 #include "yb/util/operation_counter.h"
@@ -96,7 +100,10 @@ class MetricEntity;
 class RowChangeList;
 
 namespace docdb {
+class ConditionalRowCache;
 class ConsensusFrontier;
+class LsmMetricsListener;
+class TableImage;
 }
 
 namespace log {
@@ -114,6 +121,7 @@ class MaintenanceOpStats;
 namespace tablet {
 
 class ChangeMetadataOperationState;
+class ImportDataOperationState;
 class ScopedReadOperation;
 class TabletRetentionPolicy;
 class TransactionCoordinator;
@@ -198,10 +206,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS EnableCompactions(ScopedRWOperationPause* operation_pause);
 
+  // Returns the key of the row to resume the backfill from, or an empty string when the end of the
+  // tablet was reached. The number of backfilled rows is added to number_rows_processed.
   Result<std::string> BackfillIndexes(const std::vector<IndexInfo>& indexes,
                                       const std::string& backfill_from,
                                       const CoarseTimePoint deadline,
-                                      const HybridTime read_time);
+                                      const HybridTime read_time,
+                                      size_t* number_rows_processed);
 
   CHECKED_STATUS UpdateIndexInBatches(
       const QLTableRow& row, const std::vector<IndexInfo>& indexes,
@@ -231,8 +242,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   void CompleteShutdown(IsDropTable is_drop_table = IsDropTable::kFalse);
 
+  // Imports regular records from RocksDB located in source_dir, keys of every imported file should
+  // belong to this tablet.
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
+  // Imports data for a replicated operation. Op id and hybrid time of the operation are recorded
+  // in the flushed frontier together with imported files, so the import is not replayed on
+  // bootstrap once applied.
+  CHECKED_STATUS ImportData(ImportDataOperationState* state);
+
   CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) override;
 
   CHECKED_STATUS RemoveIntents(const RemoveIntentsData& data, const TransactionId& id) override;
@@ -331,6 +349,17 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const TransactionMetadataPB& transaction_metadata,
       PgsqlReadRequestResult* result) override;
 
+  // Handles all reads of a single RPC, which are for different tables when the tablet is shared by
+  // colocated tables, as one pending operation. Reads of the same kind of table (catalog or user)
+  // share the transaction operation context, so they share its intent commit time cache. Stops
+  // after the first read that requires a read restart, which is then the last of the results.
+  CHECKED_STATUS HandlePgsqlReadRequests(
+      CoarseTimePoint deadline,
+      const ReadHybridTime& read_time,
+      const google::protobuf::RepeatedPtrField<PgsqlReadRequestPB>& pgsql_read_requests,
+      const TransactionMetadataPB& transaction_metadata,
+      std::vector<PgsqlReadRequestResult>* results);
+
   CHECKED_STATUS CreatePagingStateForRead(
       const PgsqlReadRequestPB& pgsql_read_request, const size_t row_count,
       PgsqlResponsePB* response) const override;
@@ -414,6 +443,11 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  // Limiters of the reads and writes of the tablet that the tablet server runs concurrently, so
+  // that a hot tablet does not take all of the RPC workers from the other tablets.
+  ConcurrencyLimiter& read_limiter() { return read_limiter_; }
+  ConcurrencyLimiter& write_limiter() { return write_limiter_; }
+
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
@@ -438,6 +472,13 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // is empty.
   Result<HybridTime> OldestMutableMemtableWriteHybridTime() const;
 
+  // Returns newest mutable memtable write hybrid time in RocksDB or HybridTime::kMin if memtable
+  // is empty.
+  Result<HybridTime> NewestMutableMemtableWriteHybridTime() const;
+
+  // Returns the size in bytes of the mutable memtables in intents and regular db-s.
+  Result<uint64_t> MutableMemtablesSize() const;
+
   // For non-kudu table type fills key-value batch in transaction state request and updates
   // request in state. Due to acquiring locks it can block the thread.
   void AcquireLocksAndPerformDocOperations(std::unique_ptr<WriteOperation> operation);
@@ -496,6 +537,36 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetCurrentVersionSstFilesUncompressedSize() const;
   uint64_t GetCurrentVersionNumSSTFiles() const;
 
+  // Returns the SST file of the regular DB with the most data that expired by the history cutoff,
+  // according to the expiration index of the file, or an empty string if no file has at least
+  // min_expired_ratio of its data expired. Files that are being compacted are skipped.
+  std::string FindFileWithExpiredData(double min_expired_ratio, uint64_t* expired_bytes) const;
+
+  // Compacts the SST file of the regular DB on its own, to drop its expired data.
+  CHECKED_STATUS CompactFile(const std::string& file_name);
+
+  // Returns the total size of the oldest SST files of the regular DB, whose data all expired by
+  // the history cutoff, that DeleteExpiredFiles would delete.
+  uint64_t ExpiredFilesSize() const;
+
+  // Deletes the oldest SST files of the regular DB whose data all expired, from the oldest one,
+  // without compacting them. Newer files are kept even if their data expired, so that deleting a
+  // file could not expose older data.
+  CHECKED_STATUS DeleteExpiredFiles();
+
+  // Returns how close writes to the regular DB are to being stopped by RocksDB, from 0 to 1, see
+  // rocksdb::DB::GetWriteStallPressure.
+  double GetWriteStallPressure() const;
+
+  // Whether the in-memory image of the rows of the table should be built, i.e. the table has the
+  // in_memory_image property, there is no image yet and the table was not written to for
+  // ql_table_image_min_idle_ms.
+  bool ShouldBuildTableImage() const;
+
+  // Builds the in-memory image of the rows of the table as of the safe time, that answers the
+  // reads of single partitions until the next write is applied.
+  CHECKED_STATUS BuildTableImage();
+
   void ListenNumSSTFilesChanged(std::function<void()> listener);
 
   // Returns the number of memtables in intents and regular db-s.
@@ -563,6 +634,18 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return *snapshots_;
   }
 
+  TabletHotKeys& hot_keys() {
+    return *hot_keys_;
+  }
+
+  TabletSlowOps& slow_ops() {
+    return *slow_ops_;
+  }
+
+  const docdb::LsmMetricsListener& lsm_metrics() const {
+    return *lsm_metrics_;
+  }
+
   SnapshotCoordinator* snapshot_coordinator() {
     return snapshot_coordinator_;
   }
@@ -595,6 +678,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS StartDocWriteOperation(WriteOperation* operation);
 
+  // Starts synchronization of the write with the given status, unless the write waits on a conflict
+  // and should be retried.
+  void StartSynchronizationOrWaitOnConflict(
+      std::unique_ptr<WriteOperation> operation, const Status& status);
+
+  // Performs the write again after the backoff of its conflict wait, without blocking the thread.
+  void WaitOnConflict(std::unique_ptr<WriteOperation> operation);
+
   CHECKED_STATUS OpenKeyValueTablet();
   virtual CHECKED_STATUS CreateTabletDirectories(const string& db_dir, FsManager* fs);
 
@@ -614,6 +705,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const boost::optional<TransactionId>& transaction_id,
       bool is_ysql_catalog_table) const;
 
+  // Transaction operation contexts of the reads of one RPC, indexed by whether the read table is a
+  // YSQL catalog table.
+  typedef std::array<boost::optional<TransactionOperationContextOpt>, 2> PgsqlReadTxnContexts;
+
+  // Handles the read under the pending operation started by the caller.
+  CHECKED_STATUS DoHandlePgsqlReadRequest(
+      CoarseTimePoint deadline,
+      const ReadHybridTime& read_time,
+      const PgsqlReadRequestPB& pgsql_read_request,
+      const TransactionMetadataPB& transaction_metadata,
+      PgsqlReadTxnContexts* txn_op_contexts,
+      PgsqlReadRequestResult* result);
+
+  void RecordPgsqlCommitTimeCacheStats(const PgsqlReadTxnContexts& txn_op_contexts);
+
   // Pause any new read/write operations and wait for all pending read/write operations to finish.
   ScopedRWOperationPause PauseReadWriteOperations(Stop stop = Stop::kFalse);
 
@@ -621,6 +727,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS DoEnableCompactions();
 
+  CHECKED_STATUS DoImportData(const std::string& source_dir, rocksdb::UserFrontierPtr frontier);
+
+  // Checks that keys from smallest to largest belong to the key bounds and partition of this
+  // tablet.
+  CHECKED_STATUS CheckKeyRangeBelongsToTablet(const Slice& smallest, const Slice& largest) const;
+
   void PreventCallbacksFromRocksDBs(bool disable_flush_on_shutdown);
 
   std::string LogPrefix() const;
@@ -734,6 +846,18 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<TransactionParticipant> transaction_participant_;
 
+  // Iterators of YSQL scans kept between pages. Cleared when read/write operations are paused.
+  std::unique_ptr<PgsqlReadCursors> pgsql_read_cursors_;
+
+  // The most frequently read and written rows, from a sample of the operations.
+  std::unique_ptr<TabletHotKeys> hot_keys_;
+
+  // The last operations that took longer than tablet_slow_op_threshold_ms.
+  std::unique_ptr<TabletSlowOps> slow_ops_;
+
+  // Health of the LSM tree of the regular DB, updated on its flushes and compactions.
+  std::shared_ptr<docdb::LsmMetricsListener> lsm_metrics_;
+
   std::shared_future<client::YBClient*> client_future_;
 
   // Created only when secondary indexes are present.
@@ -743,6 +867,32 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Created only if it is a unique index tablet.
   boost::optional<Schema> unique_index_key_schema_;
 
+  // Rows written by conditional writes. Created only for non-transactional YCQL tables, when
+  // enabled by ql_conditional_row_cache_size.
+  std::unique_ptr<docdb::ConditionalRowCache> conditional_row_cache_;
+
+  // Whether the reads could be answered from the in-memory image of the rows of the table. Set
+  // only for non-transactional YCQL tables with the in_memory_image property.
+  std::atomic<bool> table_image_enabled_{false};
+
+  // Drops the in-memory image of the table. Called before the written rows are visible to reads.
+  void InvalidateTableImage();
+
+  // Returns the in-memory image of the table, if there is one as of read_ht.
+  std::shared_ptr<const docdb::TableImage> TableImageAt(HybridTime read_ht) const;
+
+  bool TableImageSupported(const Schema& schema) const;
+
+  mutable std::mutex table_image_mutex_;
+  std::shared_ptr<const docdb::TableImage> table_image_ GUARDED_BY(table_image_mutex_);
+  // Incremented on each invalidation, so an image built concurrently with a write is not used.
+  uint64_t table_image_generation_ GUARDED_BY(table_image_mutex_) = 0;
+  // Generation that the last image was built for, kept when the table could not be imaged, so it
+  // is not built again until the table is written to.
+  uint64_t table_image_built_generation_ GUARDED_BY(table_image_mutex_) =
+      std::numeric_limits<uint64_t>::max();
+  CoarseTimePoint table_image_invalidation_time_ GUARDED_BY(table_image_mutex_);
+
   std::atomic<int64_t> last_committed_write_index_{0};
 
   HybridTimeLeaseProvider ht_lease_provider_;
@@ -768,6 +918,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   void CleanupIntentFiles();
   void DoCleanupIntentFiles();
 
+  // Updates the intents DB metrics and compacts it when most of its entries are tombstones.
+  void MaybeCompactIntentsTombstones();
+
   void RegularDbFilesChanged();
 
   HybridTime ApplierSafeTime(HybridTime min_allowed, CoarseTimePoint deadline) override;
@@ -777,7 +930,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   }
 
   template <class Functor>
-  uint64_t GetRegularDbStat(const Functor& functor) const;
+  auto GetRegularDbStat(const Functor& functor) const -> decltype(functor());
+
+  // Whether all the data of the SST file with the given boundary values expired by the history
+  // cutoff, for YCQL tables.
+  bool FileDataExpired(const rocksdb::FileBoundaryValuesBase& smallest,
+                       const rocksdb::FileBoundaryValuesBase& largest) const;
+
+  // Returns the oldest files of the regular DB, that pass FileDataExpired, from the oldest one.
+  std::vector<rocksdb::LiveFileMetaData> OldestExpiredFiles() const;
 
   std::function<rocksdb::MemTableFilter()> mem_table_flush_filter_factory_;
 
@@ -805,6 +966,9 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::shared_ptr<TabletRetentionPolicy> retention_policy_;
 
+  ConcurrencyLimiter read_limiter_;
+  ConcurrencyLimiter write_limiter_;
+
   DISALLOW_COPY_AND_ASSIGN(Tablet);
 };
 
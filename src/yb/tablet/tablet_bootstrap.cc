@@ -31,6 +31,8 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <future>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/log_anchor_registry.h"
@@ -44,6 +46,7 @@
 #include "yb/tablet/tablet_splitter.h"
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/history_cutoff_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
@@ -87,6 +90,11 @@ DEFINE_bool(skip_flushed_entries, true,
 
 DECLARE_int32(retryable_request_timeout_secs);
 
+DEFINE_bool(tablet_bootstrap_prefetch_log_segments, true,
+            "Read and decode the next log segment in background during tablet bootstrap, while "
+            "entries of the current segment are applied.");
+TAG_FLAG(tablet_bootstrap_prefetch_log_segments, advanced);
+
 DEFINE_uint64(transaction_status_tablet_log_segment_size_bytes, 4_MB,
               "The segment size for transaction status tablet log roll-overs, in bytes.");
 
@@ -391,13 +399,17 @@ Status TabletBootstrap::Bootstrap(TabletPtr* rebuilt_tablet,
     VLOG_WITH_PREFIX(1) << "Tablet Metadata: " << super_block.DebugString();
   }
 
+  auto phase_start = MonoTime::Now();
   bool has_blocks = VERIFY_RESULT(OpenTablet());
+  stats_.open_tablet_time = MonoTime::Now() - phase_start;
 
+  phase_start = MonoTime::Now();
   bool needs_recovery;
   RETURN_NOT_OK(PrepareToReplay(&needs_recovery));
   if (needs_recovery && !skip_wal_rewrite_) {
     RETURN_NOT_OK(OpenLogReader());
   }
+  stats_.prepare_time = MonoTime::Now() - phase_start;
 
   // This is a new tablet, nothing left to do.
   if (!has_blocks && !needs_recovery) {
@@ -422,6 +434,7 @@ Status TabletBootstrap::Bootstrap(TabletPtr* rebuilt_tablet,
 
   RETURN_NOT_OK_PREPEND(PlaySegments(consensus_info), "Failed log replay. Reason");
 
+  phase_start = MonoTime::Now();
   if (cmeta_->current_term() < consensus_info->last_id.term()) {
     cmeta_->set_current_term(consensus_info->last_id.term());
   }
@@ -446,6 +459,9 @@ Status TabletBootstrap::Bootstrap(TabletPtr* rebuilt_tablet,
   }
 
   RETURN_NOT_OK(FinishBootstrap("Bootstrap complete.", rebuilt_log, rebuilt_tablet));
+  stats_.finish_time = MonoTime::Now() - phase_start;
+
+  LOG_WITH_PREFIX(INFO) << "Bootstrap finished. " << stats_.ToString();
 
   return Status::OK();
 }
@@ -764,6 +780,9 @@ Status TabletBootstrap::HandleOperation(consensus::OperationType op_type,
     case consensus::SPLIT_OP:
       return PlaySplitOpRequest(replicate);
 
+    case consensus::IMPORT_DATA_OP:
+      return PlayImportDataRequest(replicate);
+
     // Unexpected cases:
     case consensus::UNKNOWN_OP:
       return STATUS(IllegalState, Substitute("Unsupported operation type: $0", op_type));
@@ -787,6 +806,17 @@ Status TabletBootstrap::PlayHistoryCutoffRequest(ReplicateMsg* replicate_msg) {
   return state.Replicated(/* leader_term= */ yb::OpId::kUnknownTerm);
 }
 
+Status TabletBootstrap::PlayImportDataRequest(ReplicateMsg* replicate_msg) {
+  // Imported files are added together with the flushed frontier of the operation, so this is
+  // replayed only when the operation was not applied before the restart.
+  ImportDataOperationState state(tablet_.get(), replicate_msg->mutable_import_data_request());
+  state.mutable_op_id()->CopyFrom(replicate_msg->id());
+  state.set_hybrid_time(HybridTime(replicate_msg->hybrid_time()));
+
+  Status complete_status;
+  return state.Replicated(/* leader_term= */ yb::OpId::kUnknownTerm, &complete_status);
+}
+
 Status TabletBootstrap::PlaySplitOpRequest(ReplicateMsg* replicate_msg) {
   tserver::SplitTabletRequestPB* const split_request = replicate_msg->mutable_split_request();
   RETURN_NOT_OK(replay_state_->UpdateSplitOpId(*replicate_msg, tablet_->tablet_id()));
@@ -960,12 +990,30 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     }
   }
 
+  // Reading of the next segment is started before replaying the current one, so decoding of log
+  // entries is pipelined with applying them to the tablet.
+  const bool prefetch_segments = FLAGS_tablet_bootstrap_prefetch_log_segments;
+  auto start_segment_read = [](const scoped_refptr<ReadableLogSegment>& segment) {
+    return std::async(std::launch::async, [segment] { return segment->ReadEntries(); });
+  };
+  std::future<log::ReadEntriesResult> next_read_result;
+  if (prefetch_segments && iter != segments.end()) {
+    next_read_result = start_segment_read(*iter);
+  }
+
   yb::OpId last_committed_op_id;
   RestartSafeCoarseTimePoint last_entry_time;
   for (; iter != segments.end(); ++iter) {
     const scoped_refptr<ReadableLogSegment>& segment = *iter;
 
-    auto read_result = segment->ReadEntries();
+    auto phase_start = MonoTime::Now();
+    auto read_result = next_read_result.valid() ? next_read_result.get() : segment->ReadEntries();
+    stats_.read_log_time += MonoTime::Now() - phase_start;
+    if (prefetch_segments && std::next(iter) != segments.end()) {
+      next_read_result = start_segment_read(*std::next(iter));
+    }
+
+    phase_start = MonoTime::Now();
     last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
     for (int entry_idx = 0; entry_idx < read_result.entries.size(); ++entry_idx) {
       Status s = HandleEntry(
@@ -982,6 +1030,7 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     if (!read_result.entry_metadata.empty()) {
       last_entry_time = read_result.entry_metadata.back().entry_time;
     }
+    stats_.replay_time += MonoTime::Now() - phase_start;
 
     // If the LogReader failed to read for some reason, we'll still try to replay as many entries as
     // possible, and then fail with Corruption.
@@ -1261,8 +1310,10 @@ void TabletBootstrap::CleanupSnapshots() {
 //  Class TabletBootstrap::Stats.
 // ============================================================================
 string TabletBootstrap::Stats::ToString() const {
-  return Format("Read operations: $0, overwritten operations: $1",
-                ops_read, ops_overwritten);
+  return Format("Read operations: $0, overwritten operations: $1, open tablet time: $2, "
+                "prepare time: $3, read log time: $4, replay time: $5, finish time: $6",
+                ops_read, ops_overwritten, open_tablet_time, prepare_time, read_log_time,
+                replay_time, finish_time);
 }
 
 } // namespace tablet
@@ -128,6 +128,8 @@ class TabletBootstrap {
 
   CHECKED_STATUS PlaySplitOpRequest(consensus::ReplicateMsg* replicate_msg);
 
+  CHECKED_STATUS PlayImportDataRequest(consensus::ReplicateMsg* replicate_msg);
+
   void DumpReplayStateToLog();
 
   // Handlers for each type of message seen in the log during replay.
@@ -178,6 +180,15 @@ class TabletBootstrap {
 
     // Number of REPLICATE messages which were overwritten by later entries.
     int ops_overwritten = 0;
+
+    // Time spent in bootstrap phases.
+    MonoDelta open_tablet_time = MonoDelta::kZero;
+    MonoDelta prepare_time = MonoDelta::kZero;
+    // Time spent waiting for log segments to be read and decoded.
+    MonoDelta read_log_time = MonoDelta::kZero;
+    // Time spent applying log entries to the tablet.
+    MonoDelta replay_time = MonoDelta::kZero;
+    MonoDelta finish_time = MonoDelta::kZero;
   } stats_;
 
   HybridTime rocksdb_last_entry_hybrid_time_ = HybridTime::kMin;
@@ -26,6 +26,7 @@ class AbstractTablet;
 class OperationDriver;
 typedef scoped_refptr<OperationDriver> OperationDriverPtr;
 
+class PgsqlReadCursors;
 class RaftGroupMetadata;
 typedef scoped_refptr<RaftGroupMetadata> RaftGroupMetadataPtr;
 
@@ -38,6 +39,8 @@ typedef std::shared_ptr<TabletPeer> TabletPeerPtr;
 class SnapshotCoordinator;
 class SnapshotOperationState;
 class SplitOperationState;
+class TabletHotKeys;
+class TabletSlowOps;
 class TabletSnapshots;
 class TabletSplitter;
 class TabletStatusPB;
@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/tablet_hot_keys.h"
+
+#include <cmath>
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/random_util.h"
+
+using namespace std::literals;
+
+DEFINE_double(tablet_hot_keys_sample_rate, 0.01,
+              "Fraction of the reads and written rows of a tablet recorded to find its hot keys. "
+              "0 to not track the hot keys.");
+TAG_FLAG(tablet_hot_keys_sample_rate, advanced);
+TAG_FLAG(tablet_hot_keys_sample_rate, runtime);
+
+DEFINE_int32(tablet_hot_keys_window_sec, 300,
+             "The hot keys of a tablet are the ones of the operations in the last one or two "
+             "windows of this length.");
+TAG_FLAG(tablet_hot_keys_window_sec, advanced);
+TAG_FLAG(tablet_hot_keys_window_sec, runtime);
+
+DEFINE_int32(tablet_hot_keys_capacity, 64,
+             "Number of the keys tracked by the sketch of the hot keys of a tablet. The keys "
+             "taking more than 1/capacity of the sampled operations are always found.");
+TAG_FLAG(tablet_hot_keys_capacity, advanced);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+std::string DocKeyToString(Slice encoded_doc_key) {
+  docdb::DocKey doc_key;
+  if (!doc_key.FullyDecodeFrom(encoded_doc_key).ok()) {
+    return encoded_doc_key.ToDebugHexString();
+  }
+  return doc_key.ToString();
+}
+
+} // namespace
+
+TabletHotKeys::TabletHotKeys()
+    : current_(FLAGS_tablet_hot_keys_capacity), previous_(FLAGS_tablet_hot_keys_capacity),
+      current_start_(CoarseMonoClock::Now()), previous_start_(CoarseTimePoint::min()) {
+}
+
+bool TabletHotKeys::ShouldSample() {
+  return RandomActWithProbability(FLAGS_tablet_hot_keys_sample_rate);
+}
+
+void TabletHotKeys::Record(Slice encoded_doc_key) {
+  // Each sampled operation stands for the operations that were not sampled, so changes of the
+  // sample rate do not affect the estimates.
+  const auto sample_rate = FLAGS_tablet_hot_keys_sample_rate;
+  if (sample_rate <= 0) {
+    return;
+  }
+  const auto weight = std::max<uint64_t>(std::llround(1 / sample_rate), 1);
+  std::lock_guard<std::mutex> lock(mutex_);
+  RotateUnlocked(CoarseMonoClock::Now());
+  current_.Add(encoded_doc_key, weight);
+}
+
+void TabletHotKeys::RotateUnlocked(CoarseTimePoint now) {
+  const auto window = std::max(FLAGS_tablet_hot_keys_window_sec, 1) * 1s;
+  if (now < current_start_ + window) {
+    return;
+  }
+  if (now < current_start_ + 2 * window) {
+    std::swap(previous_, current_);
+    previous_start_ = current_start_;
+  } else {
+    // Nothing was recorded in the last window.
+    previous_.Clear();
+    previous_start_ = CoarseTimePoint::min();
+  }
+  current_.Clear();
+  current_start_ = now;
+}
+
+std::vector<TabletHotKeys::HotKey> TabletHotKeys::GetHotKeys(size_t limit) {
+  std::vector<SpaceSavingSketch::Entry> entries;
+  CoarseMonoClock::Duration duration;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = CoarseMonoClock::Now();
+    RotateUnlocked(now);
+    SpaceSavingSketch merged(current_.capacity());
+    merged.Merge(previous_);
+    merged.Merge(current_);
+    entries = merged.TopK(limit);
+    duration = now - (previous_start_ != CoarseTimePoint::min() ? previous_start_
+                                                                : current_start_);
+  }
+  // Rates of a window that just started would be too noisy.
+  const double seconds = std::max(ToSeconds(duration), 1.0);
+  std::vector<HotKey> result;
+  result.reserve(entries.size());
+  for (const auto& entry : entries) {
+    result.push_back(HotKey{
+        DocKeyToString(entry.key), entry.count / seconds, entry.error / seconds});
+  }
+  return result;
+}
+
+} // namespace tablet
+} // namespace yb
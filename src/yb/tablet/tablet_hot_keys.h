@@ -0,0 +1,76 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TABLET_HOT_KEYS_H
+#define YB_TABLET_TABLET_HOT_KEYS_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/slice.h"
+#include "yb/util/space_saving.h"
+
+namespace yb {
+namespace tablet {
+
+// The most frequently read and written rows of a tablet, estimated from a sample of the reads and
+// writes, so the rows that make a tablet hot could be found.
+//
+// Operations are counted in windows of tablet_hot_keys_window_sec, and the hot keys are the ones of
+// the current and the previous window, so they are of the last one or two windows.
+class TabletHotKeys {
+ public:
+  struct HotKey {
+    // DocKey of the row, as a debug string.
+    std::string key;
+    // Estimated rate of the operations on the row, which could exceed the real one by at most
+    // error_ops_per_sec.
+    double ops_per_sec;
+    double error_ops_per_sec;
+  };
+
+  TabletHotKeys();
+
+  // Returns whether the operation should be recorded, for the sample of tablet_hot_keys_sample_rate
+  // of the operations. Cheap, so could be checked on every operation.
+  static bool ShouldSample();
+
+  // Records a sampled operation on the row with the encoded DocKey.
+  void Record(Slice encoded_doc_key);
+
+  // Returns up to limit hottest keys, with the highest rate first.
+  std::vector<HotKey> GetHotKeys(size_t limit);
+
+ private:
+  // Starts a new window when the current one is over.
+  void RotateUnlocked(CoarseTimePoint now) REQUIRES(mutex_);
+
+  std::mutex mutex_;
+  SpaceSavingSketch current_ GUARDED_BY(mutex_);
+  SpaceSavingSketch previous_ GUARDED_BY(mutex_);
+  CoarseTimePoint current_start_ GUARDED_BY(mutex_);
+  // Start of the previous window, or min if there is no previous window.
+  CoarseTimePoint previous_start_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(TabletHotKeys);
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_HOT_KEYS_H
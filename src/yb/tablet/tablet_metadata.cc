@@ -58,6 +58,7 @@
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/pb_util.h"
 #include "yb/util/random.h"
 #include "yb/util/status.h"
@@ -396,7 +397,9 @@ Status RaftGroupMetadata::DeleteTabletData(TabletDataState delete_type,
 
   const auto& rocksdb_dir = kv_store_.rocksdb_dir;
   LOG(INFO) << "Destroying regular db at: " << rocksdb_dir;
-  rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir, rocksdb_options);
+  rocksdb::Options regular_rocksdb_options = rocksdb_options;
+  docdb::InitRocksDBDataPaths(rocksdb_dir, &regular_rocksdb_options);
+  rocksdb::Status status = rocksdb::DestroyDB(rocksdb_dir, regular_rocksdb_options);
 
   if (!status.ok()) {
     LOG(ERROR) << "Failed to destroy regular DB at: " << rocksdb_dir << ": " << status;
@@ -409,6 +412,12 @@ Status RaftGroupMetadata::DeleteTabletData(TabletDataState delete_type,
     LOG_IF(WARNING, !s.ok()) << "Unable to delete rocksdb data directory " << rocksdb_dir;
   }
 
+  const auto cold_dir = docdb::ColdRocksDBDir(rocksdb_dir);
+  if (!cold_dir.empty() && fs_manager_->env()->FileExists(cold_dir)) {
+    auto s = fs_manager_->env()->DeleteRecursively(cold_dir);
+    LOG_IF(WARNING, !s.ok()) << "Unable to delete rocksdb cold data directory " << cold_dir;
+  }
+
   const auto intents_dir = rocksdb_dir + kIntentsDBSuffix;
   if (fs_manager_->env()->FileExists(intents_dir)) {
     status = rocksdb::DestroyDB(intents_dir, rocksdb_options);
@@ -573,18 +582,42 @@ Status RaftGroupMetadata::Flush() {
   TRACE_EVENT1("raft_group", "RaftGroupMetadata::Flush",
                "raft_group_id", raft_group_id_);
 
+  uint64_t flush_index;
+  {
+    std::lock_guard<MutexType> lock(data_mutex_);
+    flush_index = ++flushes_requested_;
+  }
+
   MutexLock l_flush(flush_lock_);
+  if (flushes_written_ >= flush_index) {
+    // The flush that we waited for took the changes made before this call.
+    TRACE("Metadata flushed by concurrent flush");
+    return Status::OK();
+  }
+
   RaftGroupReplicaSuperBlockPB pb;
+  uint64_t flushes_to_write;
   {
     std::lock_guard<MutexType> lock(data_mutex_);
     ToSuperBlockUnlocked(&pb);
+    flushes_to_write = flushes_requested_;
   }
+  auto start = MonoTime::Now();
   RETURN_NOT_OK(ReplaceSuperBlockUnlocked(pb));
+  if (flush_latency_) {
+    flush_latency_->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  }
+  flushes_written_ = flushes_to_write;
   TRACE("Metadata flushed");
 
   return Status::OK();
 }
 
+void RaftGroupMetadata::SetFlushLatencyMetric(scoped_refptr<Histogram> flush_latency) {
+  MutexLock l_flush(flush_lock_);
+  flush_latency_ = std::move(flush_latency);
+}
+
 Status RaftGroupMetadata::ReplaceSuperBlock(const RaftGroupReplicaSuperBlockPB &pb) {
   {
     MutexLock l(flush_lock_);
@@ -803,6 +836,11 @@ void RaftGroupMetadata::set_tablet_data_state(TabletDataState state) {
   tablet_data_state_ = state;
 }
 
+void RaftGroupMetadata::set_rocksdb_dir(const std::string& rocksdb_dir) {
+  std::lock_guard<MutexType> lock(data_mutex_);
+  kv_store_.rocksdb_dir = rocksdb_dir;
+}
+
 string RaftGroupMetadata::LogPrefix() const {
   return consensus::MakeTabletLogPrefix(raft_group_id_, fs_manager_->uuid());
 }
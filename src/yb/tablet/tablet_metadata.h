@@ -60,6 +60,9 @@
 #include "yb/util/status_callback.h"
 
 namespace yb {
+
+class Histogram;
+
 namespace tablet {
 
 extern const int64 kNoDurableMemStore;
@@ -300,6 +303,10 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata> {
   std::string rocksdb_dir() const { return kv_store_.rocksdb_dir; }
   std::string intents_rocksdb_dir() const { return kv_store_.rocksdb_dir + kIntentsDBSuffix; }
 
+  // Changes the directory of the RocksDB of the Raft group, e.g. after its data was moved to
+  // another data root dir. The tablet should not be open.
+  void set_rocksdb_dir(const std::string& rocksdb_dir);
+
   std::string lower_bound_key() const { return kv_store_.lower_bound_key; }
   std::string upper_bound_key() const { return kv_store_.upper_bound_key; }
 
@@ -348,8 +355,13 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata> {
   void set_tablet_data_state(TabletDataState state);
   TabletDataState tablet_data_state() const;
 
+  // Writes the metadata to disk. Concurrent flushes are coalesced, i.e. a flush that waits for
+  // another one to complete returns right away if that one already wrote its changes.
   CHECKED_STATUS Flush();
 
+  // Sets the histogram to record the latency of metadata writes to.
+  void SetFlushLatencyMetric(scoped_refptr<Histogram> flush_latency);
+
   // Mark the superblock to be in state 'delete_type', sync it to disk, and
   // then delete all of the rowsets in this tablet.
   // The metadata (superblock) is not deleted. For that, call DeleteSuperBlock().
@@ -489,6 +501,16 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata> {
   // If taken together with 'data_mutex_', must be acquired first.
   mutable Mutex flush_lock_;
 
+  // Number of Flush calls, protected by 'data_mutex_'.
+  uint64_t flushes_requested_ = 0;
+
+  // Number of Flush calls, whose changes were written by the last successful flush. Protected by
+  // 'flush_lock_'.
+  uint64_t flushes_written_ = 0;
+
+  // Protected by 'flush_lock_'.
+  scoped_refptr<Histogram> flush_latency_;
+
   RaftGroupId raft_group_id_;
   Partition partition_;
 
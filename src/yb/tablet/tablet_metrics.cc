@@ -74,6 +74,21 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, write_conflict_resolution_latency, "Write conflict resolution latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time taken to resolve conflicts of a write operation with other transactions, per attempt",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, docdb_versions_skipped_per_read, "Versions Skipped Per Read", yb::MetricUnit::kEntries,
+    "Number of the versions of the keys the DocDB iterators of a read stepped over, newer than the "
+    "read time or overwritten by newer versions", 1000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, metadata_flush_latency, "Metadata flush latency", yb::MetricUnit::kMicroseconds,
+    "Time taken to write and sync the Raft group metadata of the tablet", 60000000LU, 2);
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -119,6 +134,21 @@ METRIC_DEFINE_counter(tablet, majority_sst_files_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to number of majority SST files.");
 
+METRIC_DEFINE_counter(tablet, write_stall_rejections,
+  "Write Stall Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of RPC requests rejected because RocksDB write stall is expected or in progress.");
+
+METRIC_DEFINE_counter(tablet, read_admission_rejections,
+  "Read Admission Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of read RPC requests rejected because too many reads of the tablet were running.");
+
+METRIC_DEFINE_counter(tablet, write_admission_rejections,
+  "Write Admission Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of write RPC requests rejected because too many writes of the tablet were running.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -129,31 +159,139 @@ METRIC_DEFINE_counter(tablet, expired_transactions,
   yb::MetricUnit::kRequests,
   "Number of expired distributed transactions.");
 
+METRIC_DEFINE_counter(tablet, created_transactions,
+  "Created Distributed Transactions",
+  yb::MetricUnit::kRequests,
+  "Number of distributed transactions that picked this tablet as their status tablet. Shows "
+  "how the transaction load is spread between status tablets.");
+
 METRIC_DEFINE_counter(tablet, restart_read_requests,
   "Read Requests Requiring Restart",
   yb::MetricUnit::kRequests,
   "Number of read requests that require restart.");
 
+METRIC_DEFINE_counter(tablet, read_uncertainty_skipped_requests,
+  "Read Requests Without Uncertainty Window",
+  yb::MetricUnit::kRequests,
+  "Number of single-shard read requests that were served without the clock skew uncertainty "
+  "window, because all the transactions of the tablet were applied before the read time, so they "
+  "could not require restart.");
+
+METRIC_DEFINE_counter(tablet, intent_commit_time_cache_hits,
+  "Intent Commit Time Cache Hits",
+  yb::MetricUnit::kRequests,
+  "Number of transaction commit time lookups made while reading intents that were served by "
+  "the cache shared by the iterators of a read operation.");
+
+METRIC_DEFINE_counter(tablet, intent_commit_time_cache_misses,
+  "Intent Commit Time Cache Misses",
+  yb::MetricUnit::kRequests,
+  "Number of transaction commit time lookups made while reading intents that had to be "
+  "resolved through the transaction participant.");
+
+METRIC_DEFINE_counter(tablet, doc_write_batch_cache_hits,
+  "DocWriteBatch Cache Hits",
+  yb::MetricUnit::kRequests,
+  "Number of RocksDB lookups of existing subdocuments avoided by write operations because the "
+  "subdocument was already read or written by an earlier operation of the same write.");
+
+METRIC_DEFINE_counter(tablet, ql_conditional_row_cache_hits,
+  "QL Conditional Row Cache Hits",
+  yb::MetricUnit::kRequests,
+  "Number of conditional YCQL writes that checked their condition against the row cached by an "
+  "earlier conditional write, instead of reading the row.");
+
+METRIC_DEFINE_counter(tablet, ql_conditional_row_cache_misses,
+  "QL Conditional Row Cache Misses",
+  yb::MetricUnit::kRequests,
+  "Number of conditional YCQL writes that did not find their row in the conditional row cache.");
+
+METRIC_DEFINE_counter(tablet, mvcc_lock_contentions,
+  "MVCC Lock Contentions",
+  yb::MetricUnit::kOperations,
+  "Number of times the MVCC manager mutex was found held by another thread when acquired.");
+
+METRIC_DEFINE_counter(tablet, mvcc_safe_time_waits,
+  "MVCC Safe Time Waits",
+  yb::MetricUnit::kRequests,
+  "Number of safe time requests that had to wait for the safe time to advance.");
+
+METRIC_DEFINE_gauge_uint64(tablet, write_ops_acquiring_locks,
+  "Write Operations Acquiring Locks",
+  yb::MetricUnit::kOperations,
+  "Number of write operations currently acquiring key locks.");
+
+METRIC_DEFINE_gauge_uint64(tablet, write_ops_resolving_conflicts,
+  "Write Operations Resolving Conflicts",
+  yb::MetricUnit::kOperations,
+  "Number of write operations currently resolving conflicts with other transactions.");
+
+METRIC_DEFINE_gauge_uint64(tablet, write_ops_waiting_on_conflicts,
+  "Write Operations Waiting On Conflicts",
+  yb::MetricUnit::kOperations,
+  "Number of write operations currently waiting for a conflicting transaction of higher "
+  "priority before retrying conflict resolution.");
+
+METRIC_DEFINE_counter(tablet, write_conflict_waits,
+  "Write Conflict Waits",
+  yb::MetricUnit::kOperations,
+  "Number of times a write operation was blocked by a conflicting transaction of higher priority "
+  "and scheduled to retry conflict resolution.");
+
+METRIC_DEFINE_gauge_uint64(tablet, intents_db_sst_files_size,
+  "Intents SST Files Size",
+  yb::MetricUnit::kBytes,
+  "Size of the SST files of the intents RocksDB.");
+
+METRIC_DEFINE_gauge_uint64(tablet, intents_db_deleted_keys,
+  "Intents Deleted Keys",
+  yb::MetricUnit::kEntries,
+  "Number of deletion tombstones in the SST files of the intents RocksDB, that are dropped "
+  "once their files are deleted or compacted.");
+
 using strings::Substitute;
 
 namespace yb {
 namespace tablet {
 
 #define MINIT(x) x(METRIC_##x.Instantiate(entity))
+#define GINIT(x) x(METRIC_##x.Instantiate(entity, 0))
 TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
   : MINIT(snapshot_read_inflight_wait_duration),
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
+    MINIT(write_conflict_resolution_latency),
+    MINIT(metadata_flush_latency),
+    MINIT(docdb_versions_skipped_per_read),
     MINIT(write_op_duration_client_propagated_consistency),
     MINIT(not_leader_rejections),
     MINIT(leader_memory_pressure_rejections),
     MINIT(majority_sst_files_rejections),
+    MINIT(write_stall_rejections),
+    MINIT(read_admission_rejections),
+    MINIT(write_admission_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
+    MINIT(created_transactions),
     MINIT(restart_read_requests),
-    MINIT(rows_inserted) {
+    MINIT(read_uncertainty_skipped_requests),
+    MINIT(rows_inserted),
+    MINIT(intent_commit_time_cache_hits),
+    MINIT(intent_commit_time_cache_misses),
+    MINIT(doc_write_batch_cache_hits),
+    MINIT(ql_conditional_row_cache_hits),
+    MINIT(ql_conditional_row_cache_misses),
+    MINIT(mvcc_lock_contentions),
+    MINIT(mvcc_safe_time_waits),
+    MINIT(write_conflict_waits),
+    GINIT(write_ops_acquiring_locks),
+    GINIT(write_ops_resolving_conflicts),
+    GINIT(write_ops_waiting_on_conflicts),
+    GINIT(intents_db_sst_files_size),
+    GINIT(intents_db_deleted_keys) {
 }
+#undef GINIT
 #undef MINIT
 
 ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram> latency)
@@ -57,17 +57,42 @@ struct TabletMetrics {
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
+  scoped_refptr<Histogram> write_conflict_resolution_latency;
+  scoped_refptr<Histogram> metadata_flush_latency;
+  scoped_refptr<Histogram> docdb_versions_skipped_per_read;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
   scoped_refptr<Counter> majority_sst_files_rejections;
+  scoped_refptr<Counter> write_stall_rejections;
+  scoped_refptr<Counter> read_admission_rejections;
+  scoped_refptr<Counter> write_admission_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
+  scoped_refptr<Counter> created_transactions;
   scoped_refptr<Counter> restart_read_requests;
+  scoped_refptr<Counter> read_uncertainty_skipped_requests;
 
   scoped_refptr<Counter> rows_inserted;
+
+  scoped_refptr<Counter> intent_commit_time_cache_hits;
+  scoped_refptr<Counter> intent_commit_time_cache_misses;
+  scoped_refptr<Counter> doc_write_batch_cache_hits;
+  scoped_refptr<Counter> ql_conditional_row_cache_hits;
+  scoped_refptr<Counter> ql_conditional_row_cache_misses;
+  scoped_refptr<Counter> mvcc_lock_contentions;
+  scoped_refptr<Counter> mvcc_safe_time_waits;
+  scoped_refptr<Counter> write_conflict_waits;
+
+  // Number of write operations currently in each stage that precedes replication. Operations that
+  // are being replicated or applied are tracked by write_operations_inflight.
+  scoped_refptr<AtomicGauge<uint64_t>> write_ops_acquiring_locks;
+  scoped_refptr<AtomicGauge<uint64_t>> write_ops_resolving_conflicts;
+  scoped_refptr<AtomicGauge<uint64_t>> write_ops_waiting_on_conflicts;
+  scoped_refptr<AtomicGauge<uint64_t>> intents_db_sst_files_size;
+  scoped_refptr<AtomicGauge<uint64_t>> intents_db_deleted_keys;
 };
 
 class ScopedTabletMetricsTracker {
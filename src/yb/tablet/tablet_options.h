@@ -49,6 +49,8 @@ YB_STRONGLY_TYPED_BOOL(IsDropTable);
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Cache of compressed data blocks, consulted on a block_cache miss before reading the file.
+  std::shared_ptr<rocksdb::Cache> block_cache_compressed;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
   yb::Env* env = Env::Default();
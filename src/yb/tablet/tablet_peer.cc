@@ -73,6 +73,7 @@
 
 #include "yb/tablet/operations/change_metadata_operation.h"
 #include "yb/tablet/operations/history_cutoff_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/operation_driver.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
@@ -81,6 +82,7 @@
 
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/threadpool.h"
@@ -249,6 +251,8 @@ Status TabletPeer::InitTabletPeer(
 
     if (retryable_requests) {
       retryable_requests->SetMetricEntity(tablet->GetMetricEntity());
+      retryable_requests->SetMemTracker(
+          MemTracker::FindOrCreateTracker("RetryableRequests", tablet->mem_tracker()));
     }
 
     consensus_ = RaftConsensus::Create(
@@ -359,6 +363,19 @@ void TabletPeer::MajorityReplicated() {
   if (ht_lease.lease) {
     tablet_->mvcc_manager()->UpdatePropagatedSafeTimeOnLeader(ht_lease);
   }
+
+  if (has_majority_replicated_listener_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(majority_replicated_listener_mutex_);
+    if (majority_replicated_listener_) {
+      majority_replicated_listener_();
+    }
+  }
+}
+
+void TabletPeer::ListenMajorityReplicated(std::function<void()> listener) {
+  std::lock_guard<std::mutex> lock(majority_replicated_listener_mutex_);
+  has_majority_replicated_listener_.store(listener != nullptr, std::memory_order_release);
+  majority_replicated_listener_ = std::move(listener);
 }
 
 void TabletPeer::ChangeConfigReplicated(const RaftConfigPB& config) {
@@ -728,6 +745,9 @@ consensus::OperationType MapOperationTypeToPB(OperationType operation_type) {
     case OperationType::kSplit:
       return consensus::SPLIT_OP;
 
+    case OperationType::kImportData:
+      return consensus::IMPORT_DATA_OP;
+
     case OperationType::kEmpty:
       LOG(FATAL) << "OperationType::kEmpty cannot be converted to consensus::OperationType";
   }
@@ -983,6 +1003,12 @@ std::unique_ptr<Operation> TabletPeer::CreateOperation(consensus::ReplicateMsg*
       return std::make_unique<SplitOperation>(
           std::make_unique<SplitOperationState>(tablet(), raft_consensus(), tablet_splitter_));
 
+    case consensus::IMPORT_DATA_OP:
+      DCHECK(replicate_msg->has_import_data_request()) << "IMPORT_DATA_OP replica"
+          " operation must receive an ImportDataRequestPB";
+      return std::make_unique<ImportDataOperation>(
+          std::make_unique<ImportDataOperationState>(tablet()));
+
     case consensus::UNKNOWN_OP: FALLTHROUGH_INTENDED;
     case consensus::NO_OP: FALLTHROUGH_INTENDED;
     case consensus::CHANGE_CONFIG_OP:
@@ -1098,6 +1124,18 @@ void TabletPeer::RegisterMaintenanceOps(MaintenanceManager* maint_mgr) {
   maint_mgr->RegisterOp(log_gc.get());
   maintenance_ops_.push_back(log_gc.release());
   LOG_WITH_PREFIX(INFO) << "Registered log gc";
+
+  gscoped_ptr<MaintenanceOp> expired_data_compaction(new ExpiredDataCompactionOp(this));
+  maint_mgr->RegisterOp(expired_data_compaction.get());
+  maintenance_ops_.push_back(expired_data_compaction.release());
+
+  gscoped_ptr<MaintenanceOp> idle_tablet_flush(new IdleTabletFlushOp(this));
+  maint_mgr->RegisterOp(idle_tablet_flush.get());
+  maintenance_ops_.push_back(idle_tablet_flush.release());
+
+  gscoped_ptr<MaintenanceOp> table_image_build(new TableImageBuildOp(this));
+  maint_mgr->RegisterOp(table_image_build.get());
+  maintenance_ops_.push_back(table_image_build.release());
 }
 
 void TabletPeer::UnregisterMaintenanceOps() {
@@ -348,6 +348,10 @@ class TabletPeer : public consensus::ConsensusContext,
 
   std::string LogPrefix() const;
 
+  // Sets the function that is called on the leader when more operations are majority replicated,
+  // nullptr to stop calling it. It is called on the replication path, so it should be cheap.
+  void ListenMajorityReplicated(std::function<void()> listener);
+
  protected:
   friend class RefCountedThreadSafe<TabletPeer>;
   friend class TabletPeerTest;
@@ -454,6 +458,11 @@ class TabletPeer : public consensus::ConsensusContext,
 
   TabletSplitter* tablet_splitter_;
 
+  std::atomic<bool> has_majority_replicated_listener_{false};
+  std::mutex majority_replicated_listener_mutex_;
+  std::function<void()> majority_replicated_listener_
+      GUARDED_BY(majority_replicated_listener_mutex_);
+
   DISALLOW_COPY_AND_ASSIGN(TabletPeer);
 };
 
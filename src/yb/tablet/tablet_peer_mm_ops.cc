@@ -53,6 +53,59 @@ METRIC_DEFINE_histogram(tablet, log_gc_duration,
                         "Log GC Duration",
                         yb::MetricUnit::kMilliseconds,
                         "Time spent garbage collecting the logs.", 60000LU, 1);
+METRIC_DEFINE_gauge_uint32(tablet, expired_data_compaction_running,
+                           "Expired Data Compactions Running",
+                           yb::MetricUnit::kOperations,
+                           "Number of compactions of SST files with expired data currently "
+                           "running.");
+METRIC_DEFINE_histogram(tablet, expired_data_compaction_duration,
+                        "Expired Data Compaction Duration",
+                        yb::MetricUnit::kMilliseconds,
+                        "Time spent compacting SST files with expired data.", 60000LU, 1);
+
+METRIC_DEFINE_gauge_uint32(tablet, idle_tablet_flush_running,
+                           "Idle Tablet Flushes Running",
+                           yb::MetricUnit::kOperations,
+                           "Number of flushes of idle tablet memtables currently running.");
+METRIC_DEFINE_histogram(tablet, idle_tablet_flush_duration,
+                        "Idle Tablet Flush Duration",
+                        yb::MetricUnit::kMilliseconds,
+                        "Time spent flushing the memtables of idle tablets.", 60000LU, 1);
+
+METRIC_DEFINE_gauge_uint32(tablet, table_image_build_running,
+                           "Table Image Builds Running",
+                           yb::MetricUnit::kOperations,
+                           "Number of builds of in-memory images of tablet rows currently "
+                           "running.");
+METRIC_DEFINE_histogram(tablet, table_image_build_duration,
+                        "Table Image Build Duration",
+                        yb::MetricUnit::kMilliseconds,
+                        "Time spent building in-memory images of tablet rows.", 60000LU, 1);
+
+DEFINE_double(expired_data_compaction_min_ratio, 0.5,
+              "Part of the data of an SST file, that expired by its TTL or was overwritten by "
+              "newer versions in the same file before the history cutoff, at which the file is "
+              "compacted on its own to drop the expired data. Values above 1 disable these "
+              "compactions.");
+TAG_FLAG(expired_data_compaction_min_ratio, advanced);
+TAG_FLAG(expired_data_compaction_min_ratio, runtime);
+
+DEFINE_int32(expired_data_compaction_check_interval_ms, 60000,
+             "How often a tablet checks the expiration indexes of its SST files, for files to "
+             "compact because of their expired data.");
+TAG_FLAG(expired_data_compaction_check_interval_ms, advanced);
+TAG_FLAG(expired_data_compaction_check_interval_ms, runtime);
+
+DEFINE_int32(idle_tablet_flush_sec, 3600,
+             "Flush the memtables of a tablet that has not been written to for this many "
+             "seconds, to release their memory. 0 to not flush idle tablets.");
+TAG_FLAG(idle_tablet_flush_sec, advanced);
+TAG_FLAG(idle_tablet_flush_sec, runtime);
+
+DEFINE_int32(idle_tablet_flush_check_interval_ms, 60000,
+             "How often a tablet checks whether it is idle, for its memtables to flush.");
+TAG_FLAG(idle_tablet_flush_check_interval_ms, advanced);
+TAG_FLAG(idle_tablet_flush_check_interval_ms, runtime);
 
 namespace yb {
 namespace tablet {
@@ -108,5 +161,202 @@ scoped_refptr<AtomicGauge<uint32_t> > LogGCOp::RunningGauge() const {
   return log_gc_running_;
 }
 
+//
+// ExpiredDataCompactionOp.
+//
+
+ExpiredDataCompactionOp::ExpiredDataCompactionOp(TabletPeer* tablet_peer)
+    : MaintenanceOp(StringPrintf("ExpiredDataCompactionOp(%s)",
+                                 tablet_peer->tablet()->tablet_id().c_str()),
+                    MaintenanceOp::HIGH_IO_USAGE),
+      tablet_peer_(tablet_peer),
+      duration_(METRIC_expired_data_compaction_duration.Instantiate(
+                    tablet_peer->tablet()->GetMetricEntity())),
+      running_(METRIC_expired_data_compaction_running.Instantiate(
+                   tablet_peer->tablet()->GetMetricEntity(), 0)),
+      sem_(1) {}
+
+void ExpiredDataCompactionOp::UpdateStats(MaintenanceOpStats* stats) {
+  if (sem_.GetValue() != 1) {
+    stats->set_runnable(false);
+    return;
+  }
+
+  const auto now = MonoTime::Now();
+  if (!next_check_.Initialized() || now >= next_check_) {
+    auto* tablet = tablet_peer_->tablet();
+    const auto min_ratio = FLAGS_expired_data_compaction_min_ratio;
+    expired_files_bytes_ = tablet->ExpiredFilesSize();
+    file_name_.clear();
+    expired_bytes_ = 0;
+    if (min_ratio <= 1) {
+      file_name_ = tablet->FindFileWithExpiredData(min_ratio, &expired_bytes_);
+    }
+    next_check_ = now + MonoDelta::FromMilliseconds(
+        std::max(FLAGS_expired_data_compaction_check_interval_ms, 0));
+  }
+  const bool runnable = expired_files_bytes_ != 0 || !file_name_.empty();
+  stats->set_runnable(runnable);
+  if (runnable) {
+    stats->set_perf_improvement(std::max(expired_files_bytes_, expired_bytes_));
+  }
+}
+
+bool ExpiredDataCompactionOp::Prepare() {
+  return sem_.try_lock();
+}
+
+void ExpiredDataCompactionOp::Perform() {
+  CHECK(!sem_.try_lock());
+
+  // Deleting the files is cheaper, and could leave nothing for the compaction to drop.
+  if (expired_files_bytes_ != 0) {
+    expired_files_bytes_ = 0;
+    Status s = tablet_peer_->tablet()->DeleteExpiredFiles();
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete SST files with expired data: " << s;
+    }
+  } else {
+    auto file_name = std::move(file_name_);
+    file_name_.clear();
+    Status s = tablet_peer_->tablet()->CompactFile(file_name);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to compact " << file_name << " with expired data: " << s;
+    }
+  }
+  // The files are gone, look for the next ones in the new files right away.
+  next_check_ = MonoTime();
+
+  sem_.unlock();
+}
+
+scoped_refptr<Histogram> ExpiredDataCompactionOp::DurationHistogram() const {
+  return duration_;
+}
+
+scoped_refptr<AtomicGauge<uint32_t> > ExpiredDataCompactionOp::RunningGauge() const {
+  return running_;
+}
+
+//
+// IdleTabletFlushOp.
+//
+
+IdleTabletFlushOp::IdleTabletFlushOp(TabletPeer* tablet_peer)
+    : MaintenanceOp(StringPrintf("IdleTabletFlushOp(%s)",
+                                 tablet_peer->tablet()->tablet_id().c_str()),
+                    MaintenanceOp::LOW_IO_USAGE),
+      tablet_peer_(tablet_peer),
+      duration_(METRIC_idle_tablet_flush_duration.Instantiate(
+                    tablet_peer->tablet()->GetMetricEntity())),
+      running_(METRIC_idle_tablet_flush_running.Instantiate(
+                   tablet_peer->tablet()->GetMetricEntity(), 0)),
+      sem_(1) {}
+
+void IdleTabletFlushOp::UpdateStats(MaintenanceOpStats* stats) {
+  const auto idle_sec = FLAGS_idle_tablet_flush_sec;
+  if (idle_sec <= 0 || sem_.GetValue() != 1) {
+    stats->set_runnable(false);
+    return;
+  }
+
+  const auto now = MonoTime::Now();
+  if (!next_check_.Initialized() || now >= next_check_) {
+    idle_memtables_size_ = 0;
+    auto* tablet = tablet_peer_->tablet();
+    auto newest_write = tablet->NewestMutableMemtableWriteHybridTime();
+    if (newest_write.ok() && *newest_write != HybridTime::kMin &&
+        tablet->clock()->Now().PhysicalDiff(*newest_write) >
+            idle_sec * MonoTime::kMicrosecondsPerSecond) {
+      auto size = tablet->MutableMemtablesSize();
+      if (size.ok()) {
+        idle_memtables_size_ = *size;
+      }
+    }
+    next_check_ = now + MonoDelta::FromMilliseconds(
+        std::max(FLAGS_idle_tablet_flush_check_interval_ms, 0));
+  }
+  stats->set_runnable(idle_memtables_size_ > 0);
+  if (idle_memtables_size_ > 0) {
+    stats->set_ram_anchored(idle_memtables_size_);
+    stats->set_perf_improvement(idle_memtables_size_);
+  }
+}
+
+bool IdleTabletFlushOp::Prepare() {
+  return sem_.try_lock();
+}
+
+void IdleTabletFlushOp::Perform() {
+  CHECK(!sem_.try_lock());
+
+  LOG(INFO) << "Flushing " << idle_memtables_size_ << " bytes of memtables of idle tablet "
+            << tablet_peer_->tablet_id();
+  idle_memtables_size_ = 0;
+  Status s = tablet_peer_->tablet()->Flush(FlushMode::kSync);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to flush idle tablet " << tablet_peer_->tablet_id() << ": " << s;
+  }
+
+  sem_.unlock();
+}
+
+scoped_refptr<Histogram> IdleTabletFlushOp::DurationHistogram() const {
+  return duration_;
+}
+
+scoped_refptr<AtomicGauge<uint32_t> > IdleTabletFlushOp::RunningGauge() const {
+  return running_;
+}
+
+//
+// TableImageBuildOp.
+//
+
+TableImageBuildOp::TableImageBuildOp(TabletPeer* tablet_peer)
+    : MaintenanceOp(StringPrintf("TableImageBuildOp(%s)",
+                                 tablet_peer->tablet()->tablet_id().c_str()),
+                    MaintenanceOp::LOW_IO_USAGE),
+      tablet_peer_(tablet_peer),
+      duration_(METRIC_table_image_build_duration.Instantiate(
+                    tablet_peer->tablet()->GetMetricEntity())),
+      running_(METRIC_table_image_build_running.Instantiate(
+                   tablet_peer->tablet()->GetMetricEntity(), 0)),
+      sem_(1) {}
+
+void TableImageBuildOp::UpdateStats(MaintenanceOpStats* stats) {
+  const bool runnable = sem_.GetValue() == 1 && tablet_peer_->tablet()->ShouldBuildTableImage();
+  stats->set_runnable(runnable);
+  if (runnable) {
+    // Every read of the table benefits from the image, so it is preferred over the ops that only
+    // release memory.
+    stats->set_perf_improvement(1);
+  }
+}
+
+bool TableImageBuildOp::Prepare() {
+  return sem_.try_lock();
+}
+
+void TableImageBuildOp::Perform() {
+  CHECK(!sem_.try_lock());
+
+  Status s = tablet_peer_->tablet()->BuildTableImage();
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to build the in-memory image of tablet " << tablet_peer_->tablet_id()
+                 << ": " << s;
+  }
+
+  sem_.unlock();
+}
+
+scoped_refptr<Histogram> TableImageBuildOp::DurationHistogram() const {
+  return duration_;
+}
+
+scoped_refptr<AtomicGauge<uint32_t> > TableImageBuildOp::RunningGauge() const {
+  return running_;
+}
+
 }  // namespace tablet
 }  // namespace yb
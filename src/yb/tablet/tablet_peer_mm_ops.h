@@ -70,6 +70,96 @@ class LogGCOp : public MaintenanceOp {
   mutable Semaphore sem_;
 };
 
+// Maintenance task that compacts the SST file of the tablet with the most expired data, once enough
+// of the file expired, according to the expiration index of the file. This way data with a TTL is
+// dropped soon after it expires, instead of when its file is compacted for its size. The oldest
+// files, whose data all expired, are deleted instead, without reading them.
+//
+// Only one ExpiredDataCompaction op can run at a time.
+class ExpiredDataCompactionOp : public MaintenanceOp {
+ public:
+  explicit ExpiredDataCompactionOp(TabletPeer* tablet_peer);
+
+  void UpdateStats(MaintenanceOpStats* stats) override;
+
+  bool Prepare() override;
+
+  void Perform() override;
+
+  scoped_refptr<Histogram> DurationHistogram() const override;
+
+  scoped_refptr<AtomicGauge<uint32_t> > RunningGauge() const override;
+
+ private:
+  TabletPeer *const tablet_peer_;
+  scoped_refptr<Histogram> duration_;
+  scoped_refptr<AtomicGauge<uint32_t> > running_;
+  mutable Semaphore sem_;
+
+  // The file indexes are only checked every expired_data_compaction_check_interval_ms, these are
+  // the results of the last check.
+  MonoTime next_check_;
+  std::string file_name_;
+  uint64_t expired_bytes_ = 0;
+  uint64_t expired_files_bytes_ = 0;
+};
+
+// Maintenance task that flushes the memtables of a tablet that has not been written to for
+// idle_tablet_flush_sec, so that idle tablets do not hold memtable memory, and the log they
+// retain, until the global memstore limit is reached.
+//
+// Only one IdleTabletFlush op can run at a time.
+class IdleTabletFlushOp : public MaintenanceOp {
+ public:
+  explicit IdleTabletFlushOp(TabletPeer* tablet_peer);
+
+  void UpdateStats(MaintenanceOpStats* stats) override;
+
+  bool Prepare() override;
+
+  void Perform() override;
+
+  scoped_refptr<Histogram> DurationHistogram() const override;
+
+  scoped_refptr<AtomicGauge<uint32_t> > RunningGauge() const override;
+
+ private:
+  TabletPeer *const tablet_peer_;
+  scoped_refptr<Histogram> duration_;
+  scoped_refptr<AtomicGauge<uint32_t> > running_;
+  mutable Semaphore sem_;
+
+  // The memtables are only checked every idle_tablet_flush_check_interval_ms, this is the size of
+  // the idle memtables found by the last check, 0 if the tablet is not idle.
+  MonoTime next_check_;
+  uint64_t idle_memtables_size_ = 0;
+};
+
+// Maintenance task that builds the in-memory image of the rows of a tablet of a table with the
+// in_memory_image property, once the tablet was not written to for ql_table_image_min_idle_ms.
+//
+// Only one TableImageBuild op can run at a time.
+class TableImageBuildOp : public MaintenanceOp {
+ public:
+  explicit TableImageBuildOp(TabletPeer* tablet_peer);
+
+  void UpdateStats(MaintenanceOpStats* stats) override;
+
+  bool Prepare() override;
+
+  void Perform() override;
+
+  scoped_refptr<Histogram> DurationHistogram() const override;
+
+  scoped_refptr<AtomicGauge<uint32_t> > RunningGauge() const override;
+
+ private:
+  TabletPeer *const tablet_peer_;
+  scoped_refptr<Histogram> duration_;
+  scoped_refptr<AtomicGauge<uint32_t> > running_;
+  mutable Semaphore sem_;
+};
+
 } // namespace tablet
 } // namespace yb
 
@@ -21,6 +21,7 @@
 #include "yb/server/hybrid_clock.h"
 
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/transaction_participant.h"
 
 using namespace std::literals;
 
@@ -30,6 +31,15 @@ DEFINE_int32(timestamp_history_retention_interval_sec, 120,
              "Set this to be higher than the expected maximum duration of any single transaction "
              "in your application.");
 
+DEFINE_int32(timestamp_history_retention_floor_sec, -1,
+             "When non-negative, DocDB history is retained for the pending reads, the transactions "
+             "running at the tablet, and at least for this number of seconds, instead of the fixed "
+             "timestamp_history_retention_interval_sec. Reads of transactions that did not write "
+             "to the tablet are only protected while they are executing, so the floor should "
+             "exceed the longest such transaction. Negative to use the fixed interval.");
+TAG_FLAG(timestamp_history_retention_floor_sec, advanced);
+TAG_FLAG(timestamp_history_retention_floor_sec, runtime);
+
 DEFINE_bool(enable_history_cutoff_propagation, false,
             "Should we use history cutoff propagation (true) or calculate it locally (false).");
 
@@ -60,13 +70,15 @@ HybridTime TabletRetentionPolicy::UpdateCommittedHistoryCutoff(HybridTime value)
 }
 
 HistoryRetentionDirective TabletRetentionPolicy::GetRetentionDirective() {
+  const bool propagation = FLAGS_enable_history_cutoff_propagation;
+  const auto proposed_cutoff = propagation ? HybridTime() : ProposedHistoryCutoff();
   HybridTime history_cutoff;
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (FLAGS_enable_history_cutoff_propagation) {
+    if (propagation) {
       history_cutoff = SanitizeHistoryCutoff(committed_history_cutoff_);
     } else {
-      history_cutoff = EffectiveHistoryCutoff();
+      history_cutoff = SanitizeHistoryCutoff(proposed_cutoff);
       committed_history_cutoff_ = std::max(history_cutoff, committed_history_cutoff_);
     }
   }
@@ -112,6 +124,10 @@ bool TabletRetentionPolicy::ShouldRetainDeleteMarkersInMajorCompaction() const {
 }
 
 HybridTime TabletRetentionPolicy::HistoryCutoffToPropagate(HybridTime last_write_ht) {
+  if (!FLAGS_enable_history_cutoff_propagation) {
+    return HybridTime();
+  }
+  const auto proposed_cutoff = ProposedHistoryCutoff();
   std::lock_guard<std::mutex> lock(mutex_);
 
   auto now = CoarseMonoClock::now();
@@ -119,22 +135,30 @@ HybridTime TabletRetentionPolicy::HistoryCutoffToPropagate(HybridTime last_write
   VLOG_WITH_PREFIX(4) << __func__ << "(" << last_write_ht << "), left to wait: "
                       << MonoDelta(next_history_cutoff_propagation_ - now);
 
-  if (!FLAGS_enable_history_cutoff_propagation || now < next_history_cutoff_propagation_ ||
-      last_write_ht <= committed_history_cutoff_) {
+  if (now < next_history_cutoff_propagation_ || last_write_ht <= committed_history_cutoff_) {
     return HybridTime();
   }
 
   next_history_cutoff_propagation_ = now + FLAGS_history_cutoff_propagation_interval_ms * 1ms;
 
-  return EffectiveHistoryCutoff();
+  return SanitizeHistoryCutoff(proposed_cutoff);
 }
 
-HybridTime TabletRetentionPolicy::EffectiveHistoryCutoff() {
-  auto retention_delta = -FLAGS_timestamp_history_retention_interval_sec * 1s;
+HybridTime TabletRetentionPolicy::ProposedHistoryCutoff() {
   // We try to garbage-collect history older than current time minus the configured retention
   // interval, but we might not be able to do so if there are still read operations reading at an
   // older snapshot.
-  return SanitizeHistoryCutoff(clock_->Now().AddDelta(retention_delta));
+  const auto floor_sec = FLAGS_timestamp_history_retention_floor_sec;
+  if (floor_sec < 0) {
+    return clock_->Now().AddDelta(-FLAGS_timestamp_history_retention_interval_sec * 1s);
+  }
+  // The running transactions read at their start time or later, and keep their read point
+  // between the reads, when it is not registered as a pending read.
+  auto result = clock_->Now().AddDelta(-floor_sec * 1s);
+  if (transaction_participant_) {
+    result = std::min(result, transaction_participant_->MinRunningHybridTime());
+  }
+  return result;
 }
 
 HybridTime TabletRetentionPolicy::SanitizeHistoryCutoff(HybridTime proposed_cutoff) {
@@ -23,11 +23,19 @@ namespace yb {
 namespace tablet {
 
 // History retention policy used by a tablet. It is based on pending reads and a fixed retention
-// interval configured by the user.
+// interval configured by the user. With timestamp_history_retention_floor_sec set, the fixed
+// interval is replaced by the start times of the transactions running at the tablet, and the
+// floor interval.
 class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
  public:
   explicit TabletRetentionPolicy(server::ClockPtr clock, const RaftGroupMetadata* metadata);
 
+  // Sets the participant of the transactional tablet, whose running transactions restrict the
+  // history cutoff. Should be called before the policy is used.
+  void SetTransactionParticipant(const TransactionParticipant* participant) {
+    transaction_participant_ = participant;
+  }
+
   docdb::HistoryRetentionDirective GetRetentionDirective() override;
 
   // Tries to update history cutoff to proposed value, not allowing it to decrease.
@@ -48,7 +56,9 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
 
  private:
   bool ShouldRetainDeleteMarkersInMajorCompaction() const;
-  HybridTime EffectiveHistoryCutoff() REQUIRES(mutex_);
+
+  // Returns the history cutoff we would like to use, before the restrictions of the pending reads.
+  HybridTime ProposedHistoryCutoff() EXCLUDES(mutex_);
 
   // Check proposed history cutoff against other restrictions (for instance min reading timestamp),
   // and returns most close value that satisfy them.
@@ -61,6 +71,7 @@ class TabletRetentionPolicy : public docdb::HistoryRetentionPolicy {
   const server::ClockPtr clock_;
   const RaftGroupMetadata& metadata_;
   const std::string log_prefix_;
+  const TransactionParticipant* transaction_participant_ = nullptr;
 
   mutable std::mutex mutex_;
   // Set of active read timestamps.
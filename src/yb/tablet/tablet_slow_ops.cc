@@ -0,0 +1,64 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tablet/tablet_slow_ops.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/hash_util.h"
+
+DEFINE_int32(tablet_slow_op_threshold_ms, 1000,
+             "Operations of a tablet that take longer than this are recorded in its slow "
+             "operations, see /slow-ops. 0 to not record the slow operations.");
+TAG_FLAG(tablet_slow_op_threshold_ms, advanced);
+TAG_FLAG(tablet_slow_op_threshold_ms, runtime);
+
+DEFINE_int32(tablet_slow_ops_per_tablet, 32,
+             "Number of the last slow operations kept for each tablet.");
+TAG_FLAG(tablet_slow_ops_per_tablet, advanced);
+
+namespace yb {
+namespace tablet {
+
+TabletSlowOps::TabletSlowOps() : ops_(std::max(FLAGS_tablet_slow_ops_per_tablet, 1)) {
+}
+
+bool TabletSlowOps::Enabled() {
+  return FLAGS_tablet_slow_op_threshold_ms > 0;
+}
+
+bool TabletSlowOps::IsSlow(MonoDelta duration) {
+  const auto threshold_ms = FLAGS_tablet_slow_op_threshold_ms;
+  return threshold_ms > 0 && duration.ToMilliseconds() >= threshold_ms;
+}
+
+uint64_t TabletSlowOps::KeyHash(Slice encoded_doc_key) {
+  return HashUtil::MurmurHash2_64(encoded_doc_key.data(), encoded_doc_key.size(), 0);
+}
+
+void TabletSlowOps::Record(SlowOpPB op) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ops_.push_back(std::move(op));
+}
+
+std::vector<SlowOpPB> TabletSlowOps::Get() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::vector<SlowOpPB>(ops_.rbegin(), ops_.rend());
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,62 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TABLET_TABLET_SLOW_OPS_H
+#define YB_TABLET_TABLET_SLOW_OPS_H
+
+#include <mutex>
+#include <vector>
+
+#include <boost/circular_buffer.hpp>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/tablet/tablet.pb.h"
+
+#include "yb/util/monotime.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace tablet {
+
+// The last tablet_slow_ops_per_tablet operations of a tablet that took longer than
+// tablet_slow_op_threshold_ms, with the details of the work they did, so the pathological access
+// patterns could be found without searching the logs.
+class TabletSlowOps {
+ public:
+  TabletSlowOps();
+
+  // Whether the operations should collect the details for the slow operations. Cheap, so could
+  // be checked on every operation.
+  static bool Enabled();
+
+  static bool IsSlow(MonoDelta duration);
+
+  // Hash of the encoded DocKey of a row, that identifies it in the slow operations.
+  static uint64_t KeyHash(Slice encoded_doc_key);
+
+  void Record(SlowOpPB op);
+
+  // Returns the recorded slow operations, the newest first.
+  std::vector<SlowOpPB> Get() const;
+
+ private:
+  mutable std::mutex mutex_;
+  boost::circular_buffer<SlowOpPB> ops_ GUARDED_BY(mutex_);
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TABLET_SLOW_OPS_H
@@ -13,6 +13,10 @@
 
 #include "yb/tablet/tablet_snapshots.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
 #include <boost/algorithm/string/predicate.hpp>
 
 #include "yb/common/snapshot.h"
@@ -20,6 +24,8 @@
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include "yb/gutil/walltime.h"
+
 #include "yb/rocksdb/db.h"
 #include "yb/rocksdb/util/file_util.h"
 
@@ -29,10 +35,32 @@
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/operations/snapshot_operation.h"
 
+#include "yb/util/background_io_limiter.h"
+#include "yb/util/crc.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/operation_counter.h"
+#include "yb/util/path_util.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/scope_exit.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(tablet_snapshot_write_manifest, false,
+            "Write the manifest of the files of a tablet snapshot with their checksums, marking "
+            "the files that are shared with the previous snapshot of the tablet. Checksums of "
+            "the shared files are taken from the previous manifest, so only the new files are "
+            "read.");
+TAG_FLAG(tablet_snapshot_write_manifest, advanced);
+TAG_FLAG(tablet_snapshot_write_manifest, runtime);
+
+DEFINE_int32(tablet_snapshot_max_concurrent_restores_per_disk, 2,
+             "Maximum number of tablets, that have their RocksDB on the same data directory, "
+             "restoring snapshots at the same time. 0 for no limit.");
+TAG_FLAG(tablet_snapshot_max_concurrent_restores_per_disk, advanced);
+TAG_FLAG(tablet_snapshot_max_concurrent_restores_per_disk, runtime);
+
+using namespace yb::size_literals;
+
 namespace yb {
 namespace tablet {
 
@@ -41,8 +69,137 @@ namespace {
 const std::string kSnapshotsDirSuffix = ".snapshots";
 const std::string kTempSnapshotDirSuffix = ".tmp";
 
+typedef std::unordered_map<uint64_t, const SnapshotManifestFilePB*> ManifestFilesByINode;
+
+Result<uint32_t> FileCrc32c(Env* env, const std::string& path) {
+  std::unique_ptr<SequentialFile> file;
+  RETURN_NOT_OK(env->NewSequentialFile(path, &file));
+  constexpr size_t kBufferSize = 1_MB;
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[kBufferSize]);
+  crc::Crc* crc32c = crc::GetCrc32cInstance();
+  uint64_t result = 0;
+  for (;;) {
+    Slice slice;
+    RETURN_NOT_OK(file->Read(kBufferSize, &slice, buffer.get()));
+    if (slice.empty()) {
+      break;
+    }
+    BackgroundIoLimiter::Default().Request(BackgroundIoClass::kBackup, slice.size());
+    crc32c->Compute(slice.data(), slice.size(), &result);
+  }
+  return static_cast<uint32_t>(result);
+}
+
+CHECKED_STATUS AddDirToManifest(
+    Env* env, const std::string& dir, const std::string& prefix,
+    const ManifestFilesByINode& previous_files, SnapshotManifestPB* manifest) {
+  auto files = VERIFY_RESULT_PREPEND(
+      env->GetChildren(dir, ExcludeDots::kTrue), Format("Unable to list directory $0", dir));
+
+  for (const auto& file : files) {
+    const auto path = JoinPathSegments(dir, file);
+    const auto name = prefix.empty() ? file : JoinPathSegments(prefix, file);
+
+    if (VERIFY_RESULT(env->IsDirectory(path))) {
+      RETURN_NOT_OK(AddDirToManifest(env, path, name, previous_files, manifest));
+      continue;
+    }
+    if (name == TabletSnapshots::kSnapshotManifestFileName) {
+      continue;
+    }
+
+    auto& file_pb = *manifest->add_files();
+    file_pb.mutable_file()->set_name(name);
+    file_pb.mutable_file()->set_size_bytes(VERIFY_RESULT(env->GetFileSize(path)));
+    file_pb.mutable_file()->set_inode(VERIFY_RESULT(env->GetFileINode(path)));
+
+    // The previous snapshot still links the inode, so it could not be reused for another file.
+    auto it = previous_files.find(file_pb.file().inode());
+    if (it != previous_files.end() &&
+        it->second->file().size_bytes() == file_pb.file().size_bytes()) {
+      file_pb.set_crc32c(it->second->crc32c());
+      file_pb.set_in_previous_snapshot(true);
+    } else {
+      file_pb.set_crc32c(VERIFY_RESULT(FileCrc32c(env, path)));
+    }
+  }
+
+  return Status::OK();
+}
+
+// Reads the manifest of the latest snapshot in top_snapshots_dir, leaves it empty if there are
+// none.
+void ReadLatestSnapshotManifest(
+    Env* env, const std::string& top_snapshots_dir, SnapshotManifestPB* latest) {
+  auto snapshot_dirs = env->GetChildren(top_snapshots_dir, ExcludeDots::kTrue);
+  if (!snapshot_dirs.ok()) {
+    LOG(WARNING) << "Unable to list directory " << top_snapshots_dir << ": "
+                 << snapshot_dirs.status();
+    return;
+  }
+  for (const auto& snapshot_dir : *snapshot_dirs) {
+    if (TabletSnapshots::IsTempSnapshotDir(snapshot_dir)) {
+      continue;
+    }
+    const auto path = JoinPathSegments(
+        top_snapshots_dir, snapshot_dir, TabletSnapshots::kSnapshotManifestFileName);
+    if (!env->FileExists(path)) {
+      continue;
+    }
+    SnapshotManifestPB manifest;
+    auto status = pb_util::ReadPBContainerFromPath(env, path, &manifest);
+    if (!status.ok()) {
+      LOG(WARNING) << "Unable to read snapshot manifest " << path << ": " << status;
+      continue;
+    }
+    if (manifest.create_time_micros() > latest->create_time_micros()) {
+      *latest = std::move(manifest);
+      latest->set_previous_snapshot_id(snapshot_dir);
+    }
+  }
+}
+
+// Limits the number of tablets restoring snapshots at the same time per data directory. Restores
+// of the tablets of a snapshot arrive at once, and each of them reopens the RocksDB of its tablet,
+// so without the limit they compete for the same disk.
+class RestoreLimiter {
+ public:
+  // Waits while the limit number of restores are running on data_root_dir.
+  void Acquire(const std::string& data_root_dir) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this, &data_root_dir] {
+      const auto limit = FLAGS_tablet_snapshot_max_concurrent_restores_per_disk;
+      return limit <= 0 || running_[data_root_dir] < limit;
+    });
+    ++running_[data_root_dir];
+  }
+
+  void Release(const std::string& data_root_dir) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = running_.find(data_root_dir);
+      if (--it->second == 0) {
+        running_.erase(it);
+      }
+    }
+    cond_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::unordered_map<std::string, int> running_;
+};
+
+RestoreLimiter& GetRestoreLimiter() {
+  static RestoreLimiter limiter;
+  return limiter;
+}
+
 } // namespace
 
+const std::string TabletSnapshots::kSnapshotManifestFileName = "SNAPSHOT_MANIFEST";
+
 TabletSnapshots::TabletSnapshots(Tablet* tablet) : TabletComponent(tablet) {}
 
 std::string TabletSnapshots::SnapshotsDirName(const std::string& rocksdb_dir) {
@@ -151,6 +308,11 @@ Status TabletSnapshots::Create(SnapshotOperationState* tx_state) {
     RETURN_NOT_OK(patcher.SetHybridTimeFilter(snapshot_hybrid_time));
   }
 
+  if (FLAGS_tablet_snapshot_write_manifest) {
+    RETURN_NOT_OK(WriteSnapshotManifest(
+        tmp_snapshot_dir, top_snapshots_dir, BaseName(snapshot_dir)));
+  }
+
   RETURN_NOT_OK_PREPEND(
       env->RenameFile(tmp_snapshot_dir, snapshot_dir),
       Format("Cannot rename temp snapshot dir $0 to $1", tmp_snapshot_dir, snapshot_dir));
@@ -181,6 +343,12 @@ Status TabletSnapshots::Restore(SnapshotOperationState* tx_state) {
   docdb::ConsensusFrontier frontier;
   frontier.set_op_id(tx_state->op_id());
   frontier.set_hybrid_time(tx_state->hybrid_time());
+
+  const std::string data_root_dir = metadata().data_root_dir();
+  GetRestoreLimiter().Acquire(data_root_dir);
+  auto se = ScopeExit([&data_root_dir] {
+    GetRestoreLimiter().Release(data_root_dir);
+  });
   const Status s = RestoreCheckpoint(snapshot_dir, frontier);
   VLOG_WITH_PREFIX(1) << "Complete checkpoint restoring with result " << s << " in folder: "
                       << metadata().rocksdb_dir();
@@ -214,6 +382,13 @@ Status TabletSnapshots::RestoreCheckpoint(
     LOG_WITH_PREFIX(WARNING) << "Copy checkpoint files status: " << s;
     return STATUS(IllegalState, "Unable to copy checkpoint files", s.ToString());
   }
+  // The manifest describes the snapshot, not the restored DB.
+  const auto manifest_path = JoinPathSegments(db_dir, kSnapshotManifestFileName);
+  Env* const env = metadata().fs_manager()->env();
+  if (env->FileExists(manifest_path)) {
+    RETURN_NOT_OK_PREPEND(env->DeleteFile(manifest_path),
+                          "Unable to delete snapshot manifest copy " + manifest_path);
+  }
 
   // Reopen database from copied checkpoint.
   // Note: db_dir == metadata()->rocksdb_dir() is still valid db dir.
@@ -335,6 +510,39 @@ Status TabletSnapshots::CreateCheckpoint(const std::string& dir) {
   return Status::OK();
 }
 
+Status TabletSnapshots::WriteSnapshotManifest(
+    const std::string& dir, const std::string& top_snapshots_dir,
+    const std::string& snapshot_id) {
+  Env* const env = metadata().fs_manager()->env();
+
+  // The latest snapshot manifest, with previous_snapshot_id set to its own snapshot id.
+  SnapshotManifestPB previous;
+  ReadLatestSnapshotManifest(env, top_snapshots_dir, &previous);
+  ManifestFilesByINode previous_files;
+  for (const auto& file : previous.files()) {
+    previous_files.emplace(file.file().inode(), &file);
+  }
+
+  SnapshotManifestPB manifest;
+  if (previous.has_previous_snapshot_id()) {
+    manifest.set_previous_snapshot_id(previous.previous_snapshot_id());
+  }
+  manifest.set_create_time_micros(GetCurrentTimeMicros());
+  RETURN_NOT_OK(AddDirToManifest(env, dir, std::string(), previous_files, &manifest));
+
+  size_t new_files = 0;
+  for (const auto& file : manifest.files()) {
+    new_files += !file.in_previous_snapshot();
+  }
+  LOG_WITH_PREFIX(INFO) << "Snapshot " << snapshot_id << " has " << manifest.files_size()
+                        << " files, " << new_files << " of them not in previous snapshot "
+                        << manifest.previous_snapshot_id();
+
+  return pb_util::WritePBContainerToPath(
+      env, JoinPathSegments(dir, kSnapshotManifestFileName), manifest,
+      pb_util::OVERWRITE, pb_util::SYNC);
+}
+
 Status TabletSnapshots::CreateDirectories(const string& rocksdb_dir, FsManager* fs) {
   const auto top_snapshots_dir = SnapshotsDirName(rocksdb_dir);
   RETURN_NOT_OK_PREPEND(fs->CreateDirIfMissingAndSync(top_snapshots_dir),
@@ -65,6 +65,9 @@ class TabletSnapshots : public TabletComponent {
 
   static bool IsTempSnapshotDir(const std::string& dir);
 
+  // Name of the file with SnapshotManifestPB in the snapshot directory.
+  static const std::string kSnapshotManifestFileName;
+
  private:
   // Restore the RocksDB checkpoint from the provided directory.
   // Only used when table_type_ == YQL_TABLE_TYPE.
@@ -74,6 +77,12 @@ class TabletSnapshots : public TabletComponent {
   // Applies specified snapshot operation.
   CHECKED_STATUS Apply(SnapshotOperationState* tx_state);
 
+  // Writes the manifest of the snapshot that is being created in dir, comparing its files with
+  // the latest other snapshot in top_snapshots_dir.
+  CHECKED_STATUS WriteSnapshotManifest(
+      const std::string& dir, const std::string& top_snapshots_dir,
+      const std::string& snapshot_id);
+
   std::string TEST_last_rocksdb_checkpoint_dir_;
 };
 
@@ -818,9 +818,11 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
  public:
   Impl(const std::string& permanent_uuid,
        TransactionCoordinatorContext* context,
-       Counter* expired_metric)
+       Counter* expired_metric,
+       Counter* created_metric)
       : context_(*context),
         expired_metric_(*expired_metric),
+        created_metric_(*created_metric),
         log_prefix_(consensus::MakeTabletLogPrefix(context->tablet_id(), permanent_uuid)) {
   }
 
@@ -1102,6 +1104,7 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
         if (state.status() == TransactionStatus::CREATED) {
           it = managed_transactions_.emplace(
               this, *id, context_.clock().Now(), log_prefix_).first;
+          created_metric_.Increment();
         } else {
           lock.unlock();
           YB_LOG_HIGHER_SEVERITY_WHEN_TOO_MANY(INFO, WARNING, 1s, 50)
@@ -1123,6 +1126,47 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     ExecutePostponedLeaderActions(&actions);
   }
 
+  void HandleHeartbeats(
+      std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests, int64_t term) {
+    // Requests that should be completed after managed_mutex_ is released.
+    std::vector<std::pair<std::unique_ptr<tablet::UpdateTxnOperationState>, Status>> rejected;
+    PostponedLeaderActions actions;
+    {
+      std::lock_guard<std::mutex> lock(managed_mutex_);
+      postponed_leader_actions_.leader_term = term;
+      for (auto& request : requests) {
+        auto& state = *request->request();
+        DCHECK_EQ(state.status(), TransactionStatus::PENDING);
+        auto id = FullyDecodeTransactionId(state.transaction_id());
+        if (!id.ok()) {
+          rejected.emplace_back(std::move(request), id.status());
+          continue;
+        }
+        auto it = managed_transactions_.find(*id);
+        if (it == managed_transactions_.end()) {
+          rejected.emplace_back(
+              std::move(request),
+              STATUS(Expired, "Transaction expired or aborted by a conflict",
+                     PgsqlError(YBPgErrorCode::YB_PG_T_R_SERIALIZATION_FAILURE)));
+          continue;
+        }
+        managed_transactions_.modify(it, [&request](TransactionState& state) {
+          state.Handle(std::move(request));
+        });
+      }
+      postponed_leader_actions_.Swap(&actions);
+    }
+
+    ExecutePostponedLeaderActions(&actions);
+
+    for (auto& request_and_status : rejected) {
+      VLOG_WITH_PREFIX(1) << "Rejected heartbeat "
+                          << request_and_status.first->request()->ShortDebugString() << ": "
+                          << request_and_status.second;
+      request_and_status.first->CompleteWithStatus(request_and_status.second);
+    }
+  }
+
   int64_t PrepareGC(std::string* details) {
     std::lock_guard<std::mutex> lock(managed_mutex_);
     if (!managed_transactions_.empty()) {
@@ -1357,6 +1401,7 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
 
   TransactionCoordinatorContext& context_;
   Counter& expired_metric_;
+  Counter& created_metric_;
   const std::string log_prefix_;
 
   std::mutex managed_mutex_;
@@ -1375,8 +1420,9 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
 
 TransactionCoordinator::TransactionCoordinator(const std::string& permanent_uuid,
                                                TransactionCoordinatorContext* context,
-                                               Counter* expired_metric)
-    : impl_(new Impl(permanent_uuid, context, expired_metric)) {
+                                               Counter* expired_metric,
+                                               Counter* created_metric)
+    : impl_(new Impl(permanent_uuid, context, expired_metric, created_metric)) {
 }
 
 TransactionCoordinator::~TransactionCoordinator() {
@@ -1403,6 +1449,11 @@ void TransactionCoordinator::Handle(
   impl_->Handle(std::move(request), term);
 }
 
+void TransactionCoordinator::HandleHeartbeats(
+    std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests, int64_t term) {
+  impl_->HandleHeartbeats(std::move(requests), term);
+}
+
 void TransactionCoordinator::Start() {
   impl_->Start();
 }
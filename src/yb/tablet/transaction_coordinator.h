@@ -18,6 +18,7 @@
 
 #include <future>
 #include <memory>
+#include <vector>
 
 #include "yb/client/client_fwd.h"
 
@@ -99,7 +100,8 @@ class TransactionCoordinator {
  public:
   TransactionCoordinator(const std::string& permanent_uuid,
                          TransactionCoordinatorContext* context,
-                         Counter* expired_metric);
+                         Counter* expired_metric,
+                         Counter* created_metric);
   ~TransactionCoordinator();
 
   // Used to pass arguments to ProcessReplicated.
@@ -126,6 +128,10 @@ class TransactionCoordinator {
   // Handles new request for transaction update.
   void Handle(std::unique_ptr<tablet::UpdateTxnOperationState> request, int64_t term);
 
+  // Handles the heartbeats of several pending transactions, that were received in one RPC.
+  void HandleHeartbeats(
+      std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> requests, int64_t term);
+
   // Prepares log garbage collection. Return min index that should be preserved.
   int64_t PrepareGC(std::string* details = nullptr);
 
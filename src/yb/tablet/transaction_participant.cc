@@ -100,6 +100,13 @@ METRIC_DEFINE_simple_gauge_uint64(
     tablet, transactions_running,
     "Total number of transactions running in participant",
     yb::MetricUnit::kTransactions);
+METRIC_DEFINE_histogram(
+    tablet, transaction_apply_lag,
+    "Transaction Apply Lag",
+    yb::MetricUnit::kMicroseconds,
+    "Time between commit of a transaction and application of its intents to the regular "
+    "RocksDB of this tablet.",
+    60000000LU, 2);
 
 namespace yb {
 namespace tablet {
@@ -123,6 +130,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     metric_transactions_running_ = METRIC_transactions_running.Instantiate(entity, 0);
     metric_transaction_load_attempts_ = METRIC_transaction_load_attempts.Instantiate(entity);
     metric_transaction_not_found_ = METRIC_transaction_not_found.Instantiate(entity);
+    metric_transaction_apply_lag_ = METRIC_transaction_apply_lag.Instantiate(entity);
   }
 
   ~Impl() {
@@ -459,6 +467,11 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
 
     CHECK_OK(applier_.ApplyIntents(data));
 
+    auto now = participant_context_.Now();
+    if (now > data.commit_ht) {
+      metric_transaction_apply_lag_->Increment(now.PhysicalDiff(data.commit_ht));
+    }
+
     {
       MinRunningNotifier min_running_notifier(&applier_);
       // We are not trying to cleanup intents here because we don't know whether this transaction
@@ -709,6 +722,14 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return Status::OK();
   }
 
+  HybridTime MaxAppliedCommitTimeIfNoneRunning() const {
+    if (!all_loaded_.load(std::memory_order_acquire) ||
+        num_running_transactions_.load(std::memory_order_acquire) != 0) {
+      return HybridTime::kInvalid;
+    }
+    return max_applied_commit_ht_.load(std::memory_order_acquire);
+  }
+
   size_t TEST_GetNumRunningTransactions() {
     std::lock_guard<std::mutex> lock(mutex_);
     VLOG_WITH_PREFIX(4) << "Transactions: " << yb::ToString(transactions_);
@@ -762,6 +783,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
 
   void TransactionsModifiedUnlocked(MinRunningNotifier* min_running_notifier) {
     metric_transactions_running_->set_value(transactions_.size());
+    num_running_transactions_.store(transactions_.size(), std::memory_order_release);
     if (!all_loaded_.load(std::memory_order_acquire)) {
       return;
     }
@@ -1099,6 +1121,13 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     LOG_IF_WITH_PREFIX(DFATAL, !recently_removed_transactions_.insert(transaction.id()).second)
         << "Transaction removed twice: " << transaction.id();
     VLOG_WITH_PREFIX(4) << "Remove transaction: " << transaction.id();
+    // Published before the number of the running transactions, see
+    // MaxAppliedCommitTimeIfNoneRunning.
+    const auto commit_ht = transaction.local_commit_time();
+    if (commit_ht.is_valid() &&
+        commit_ht > max_applied_commit_ht_.load(std::memory_order_relaxed)) {
+      max_applied_commit_ht_.store(commit_ht, std::memory_order_release);
+    }
     transactions_.erase(it);
     TransactionsModifiedUnlocked(min_running_notifier);
   }
@@ -1276,6 +1305,7 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   scoped_refptr<AtomicGauge<uint64_t>> metric_transactions_running_;
   scoped_refptr<Counter> metric_transaction_load_attempts_;
   scoped_refptr<Counter> metric_transaction_not_found_;
+  scoped_refptr<Histogram> metric_transaction_apply_lag_;
 
   std::thread load_thread_;
   std::condition_variable load_cond_;
@@ -1285,6 +1315,9 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   bool started_ = false;
 
   std::atomic<HybridTime> min_running_ht_{HybridTime::kMax};
+  std::atomic<size_t> num_running_transactions_{0};
+  // The highest commit time of the transactions applied since the tablet was opened.
+  std::atomic<HybridTime> max_applied_commit_ht_{HybridTime::kMin};
   std::atomic<CoarseTimePoint> next_check_min_running_{CoarseTimePoint()};
   HybridTime waiting_for_min_running_ht_ = HybridTime::kMax;
   std::atomic<bool> shutdown_done_{false};
@@ -1403,6 +1436,10 @@ Status TransactionParticipant::ResolveIntents(HybridTime resolve_at, CoarseTimeP
   return impl_->ResolveIntents(resolve_at, deadline);
 }
 
+HybridTime TransactionParticipant::MaxAppliedCommitTimeIfNoneRunning() const {
+  return impl_->MaxAppliedCommitTimeIfNoneRunning();
+}
+
 size_t TransactionParticipant::TEST_GetNumRunningTransactions() const {
   return impl_->TEST_GetNumRunningTransactions();
 }
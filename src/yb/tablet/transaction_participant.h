@@ -212,6 +212,12 @@ class TransactionParticipant : public TransactionStatusManager {
 
   HybridTime MinRunningHybridTime() const;
 
+  // Returns the highest commit time of the transactions applied to this tablet, if there are no
+  // transactions with intents in it, i.e. all the committed data is in the regular DB. Returns an
+  // invalid hybrid time otherwise, and until the transactions are loaded after the tablet is
+  // opened.
+  HybridTime MaxAppliedCommitTimeIfNoneRunning() const;
+
   // When minimal start hybrid time of running transaction will be at least `ht` applier
   // method `MinRunningHybridTimeSatisfied` will be invoked.
   void WaitMinRunningHybridTime(HybridTime ht);
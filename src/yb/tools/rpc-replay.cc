@@ -0,0 +1,250 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+// Replays the calls captured by the service pools of a tablet server, see rpc_capture_dir, against
+// a tablet server of a test cluster having the same tablets, e.g. restored from a snapshot of the
+// captured cluster. The calls are sent at the captured times, scaled by --replay_speed, without
+// waiting for the previous calls. The latencies are measured from the scheduled send times, so
+// the queueing behind slow calls is not hidden.
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/proxy.h"
+#include "yb/rpc/rpc_controller.h"
+#include "yb/rpc/rpc_introspection.pb.h"
+
+#include "yb/tserver/tablet_server.h"
+#include "yb/tserver/tserver_service.proxy.h"
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/env.h"
+#include "yb/util/flags.h"
+#include "yb/util/format.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/logging.h"
+#include "yb/util/net/net_util.h"
+#include "yb/util/pb_util.h"
+#include "yb/util/result.h"
+
+DEFINE_string(server_address, "localhost",
+              "Address of the tablet server to replay the calls against.");
+DEFINE_double(replay_speed, 1.0,
+              "Ratio of the replay rate to the captured rate, e.g. 2 replays the calls twice as "
+              "fast as they were received.");
+DEFINE_int64(timeout_ms, 10 * 1000, "RPC timeout in milliseconds.");
+
+namespace yb {
+namespace tools {
+
+namespace {
+
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+
+Result<std::vector<rpc::CapturedRpcPB>> ReadCaptures(const std::vector<std::string>& paths) {
+  std::vector<rpc::CapturedRpcPB> result;
+  for (const auto& path : paths) {
+    std::unique_ptr<RandomAccessFile> file;
+    RETURN_NOT_OK(Env::Default()->NewRandomAccessFile(path, &file));
+    pb_util::ReadablePBContainerFile reader(std::move(file));
+    RETURN_NOT_OK(reader.Init());
+    for (;;) {
+      rpc::CapturedRpcPB captured;
+      auto status = reader.ReadNextPB(&captured);
+      if (status.IsEndOfFile()) {
+        break;
+      }
+      RETURN_NOT_OK(status);
+      result.push_back(std::move(captured));
+    }
+  }
+  std::stable_sort(
+      result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.received_time_us() < rhs.received_time_us();
+  });
+  return result;
+}
+
+struct MethodStats {
+  // Latencies of the successful calls, in microseconds.
+  HdrHistogram latency_us{kMaxLatencyUs, 3};
+  std::atomic<size_t> calls{0};
+  std::atomic<size_t> errors{0};
+};
+
+template <class Request, class Response>
+struct ReplayedCall {
+  Request request;
+  Response response;
+  rpc::RpcController controller;
+  MonoTime scheduled;
+};
+
+class Replayer {
+ public:
+  ~Replayer() {
+    if (messenger_) {
+      messenger_->Shutdown();
+    }
+  }
+
+  CHECKED_STATUS Init() {
+    HostPort host_port;
+    RETURN_NOT_OK(host_port.ParseString(
+        FLAGS_server_address, tserver::TabletServer::kDefaultPort));
+    messenger_ = VERIFY_RESULT(rpc::MessengerBuilder("yb-rpc-replay").Build());
+    proxy_cache_ = std::make_unique<rpc::ProxyCache>(messenger_.get());
+    proxy_ = std::make_unique<tserver::TabletServerServiceProxy>(proxy_cache_.get(), host_port);
+    return Status::OK();
+  }
+
+  void Run(const std::vector<rpc::CapturedRpcPB>& calls) {
+    CountDownLatch latch(calls.size());
+    start_ = MonoTime::Now();
+    for (const auto& captured : calls) {
+      const auto offset_us = static_cast<int64_t>(
+          (captured.received_time_us() - calls.front().received_time_us()) /
+          FLAGS_replay_speed);
+      const auto scheduled = start_ + MonoDelta::FromMicroseconds(offset_us);
+      SleepFor(scheduled - MonoTime::Now());
+
+      if (captured.method_name() == "Read") {
+        Send<tserver::ReadRequestPB, tserver::ReadResponsePB>(
+            captured, scheduled, &tserver::TabletServerServiceProxy::ReadAsync, &latch);
+      } else if (captured.method_name() == "Write") {
+        Send<tserver::WriteRequestPB, tserver::WriteResponsePB>(
+            captured, scheduled, &tserver::TabletServerServiceProxy::WriteAsync, &latch);
+      } else {
+        ++skipped_;
+        latch.CountDown();
+      }
+    }
+    latch.Wait();
+    finish_ = MonoTime::Now();
+  }
+
+  void Report(std::ostream* out) const {
+    *out << Format("Replayed in $0, skipped $1 calls of other methods\n",
+                   finish_ - start_, skipped_);
+    *out << "method,calls,errors,calls_per_sec,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n";
+    const auto seconds = std::max((finish_ - start_).ToSeconds(), 1e-6);
+    for (const auto& method_and_stats : stats_) {
+      const auto& stats = *method_and_stats.second;
+      const auto& latency = stats.latency_us;
+      *out << Format("$0,$1,$2,$3,$4,$5,$6,$7,$8,$9\n",
+                     method_and_stats.first, stats.calls.load(), stats.errors.load(),
+                     stats.calls.load() / seconds, latency.MeanValue(),
+                     latency.ValueAtPercentile(50), latency.ValueAtPercentile(90),
+                     latency.ValueAtPercentile(99), latency.ValueAtPercentile(99.9),
+                     latency.MaxValue());
+    }
+  }
+
+ private:
+  template <class Request, class Response, class Method>
+  void Send(const rpc::CapturedRpcPB& captured, MonoTime scheduled, Method method,
+            CountDownLatch* latch) {
+    auto& stats = StatsFor(captured.method_name());
+    ++stats.calls;
+    auto call = std::make_shared<ReplayedCall<Request, Response>>();
+    if (!call->request.ParseFromString(captured.request())) {
+      LOG(DFATAL) << "Failed to parse a captured " << captured.method_name() << " request";
+      ++stats.errors;
+      latch->CountDown();
+      return;
+    }
+    call->scheduled = scheduled;
+    call->controller.set_timeout(MonoDelta::FromMilliseconds(FLAGS_timeout_ms));
+    ((*proxy_).*method)(
+        call->request, &call->response, &call->controller, [call, &stats, latch] {
+      if (!call->controller.status().ok() || call->response.has_error()) {
+        ++stats.errors;
+      } else {
+        stats.latency_us.Increment(std::min<int64_t>(
+            (MonoTime::Now() - call->scheduled).ToMicroseconds(), kMaxLatencyUs));
+      }
+      latch->CountDown();
+    });
+  }
+
+  MethodStats& StatsFor(const std::string& method) {
+    auto& result = stats_[method];
+    if (!result) {
+      result = std::make_unique<MethodStats>();
+    }
+    return *result;
+  }
+
+  std::unique_ptr<rpc::Messenger> messenger_;
+  std::unique_ptr<rpc::ProxyCache> proxy_cache_;
+  std::unique_ptr<tserver::TabletServerServiceProxy> proxy_;
+  // Only modified by the thread sending the calls, the stats themselves are updated by the
+  // callbacks.
+  std::map<std::string, std::unique_ptr<MethodStats>> stats_;
+  size_t skipped_ = 0;
+  MonoTime start_;
+  MonoTime finish_;
+};
+
+Status ReplayMain(const std::vector<std::string>& paths) {
+  if (FLAGS_replay_speed <= 0) {
+    return STATUS_FORMAT(InvalidArgument, "Bad replay speed: $0", FLAGS_replay_speed);
+  }
+  auto calls = VERIFY_RESULT(ReadCaptures(paths));
+  if (calls.empty()) {
+    return STATUS(NotFound, "No captured calls");
+  }
+  LOG(INFO) << "Replaying " << calls.size() << " calls captured in "
+            << MonoDelta::FromMicroseconds(
+                   calls.back().received_time_us() - calls.front().received_time_us());
+
+  Replayer replayer;
+  RETURN_NOT_OK(replayer.Init());
+  replayer.Run(calls);
+  replayer.Report(&std::cout);
+  return Status::OK();
+}
+
+} // namespace
+
+} // namespace tools
+} // namespace yb
+
+int main(int argc, char** argv) {
+  google::SetUsageMessage(
+      std::string("Replays the captured tablet server calls.\nUsage: ") + argv[0] +
+      " [--server_address=<host:port>] [--replay_speed=<ratio>] <capture file>...");
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+  if (argc < 2) {
+    std::cerr << google::ProgramUsage() << std::endl;
+    return 2;
+  }
+
+  auto status = yb::tools::ReplayMain(std::vector<std::string>(argv + 1, argv + argc));
+  if (!status.ok()) {
+    std::cerr << status.ToString() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tserver/data_dir_load.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+DataDirLoad Dir(const std::string& dir, uint64_t free_bytes) {
+  DataDirLoad result;
+  result.dir = dir;
+  result.free_bytes = free_bytes;
+  return result;
+}
+
+TabletDataDirLoad Tablet(
+    const TabletId& tablet_id, const std::string& dir, uint64_t sst_bytes, uint64_t io_bytes) {
+  return TabletDataDirLoad{tablet_id, dir, sst_bytes, io_bytes};
+}
+
+} // namespace
+
+class DataDirLoadTest : public YBTest {
+};
+
+TEST_F(DataDirLoadTest, Score) {
+  DataDirLoadTracker tracker(nullptr);
+  ASSERT_TRUE(tracker.PlacementCandidates(0.1).empty());
+  ASSERT_FALSE(tracker.PickMove(0.1));
+
+  auto now = MonoTime::Now();
+  tracker.Update({Dir("/d0", 1000), Dir("/d1", 500)},
+                 {Tablet("t0", "/d0", 100, 0), Tablet("t1", "/d1", 300, 0),
+                  Tablet("t2", "/d1", 100, 0)},
+                 now);
+  auto loads = tracker.loads();
+  ASSERT_EQ(2u, loads.size());
+  ASSERT_EQ(1u, loads[0].num_tablets);
+  ASSERT_EQ(2u, loads[1].num_tablets);
+  ASSERT_EQ(400u, loads[1].tablet_bytes);
+  // No I/O rates before the second update.
+  ASSERT_DOUBLE_EQ(0, loads[0].score);
+  ASSERT_DOUBLE_EQ(0.5, loads[1].score);
+
+  auto candidates = tracker.PlacementCandidates(0.1);
+  ASSERT_EQ(1u, candidates.size());
+  ASSERT_EQ(1u, candidates.count("/d0"));
+  ASSERT_EQ(2u, tracker.PlacementCandidates(0.5).size());
+
+  // Moving t1 brings the scores to 0.1 apart, moving t2 leaves them 0.3 apart.
+  auto move = tracker.PickMove(0.1);
+  ASSERT_TRUE(move);
+  ASSERT_EQ("t1", move->tablet_id);
+  ASSERT_EQ("/d1", move->from);
+  ASSERT_EQ("/d0", move->to);
+  ASSERT_FALSE(tracker.PickMove(0.5));
+
+  // The I/O rates are measured between the updates, and add to the scores.
+  tracker.Update({Dir("/d0", 1000), Dir("/d1", 1000)},
+                 {Tablet("t0", "/d0", 100, 3000), Tablet("t1", "/d1", 300, 1000),
+                  Tablet("t2", "/d1", 100, 0)},
+                 now + MonoDelta::FromSeconds(10));
+  loads = tracker.loads();
+  ASSERT_DOUBLE_EQ(300, loads[0].io_bytes_per_sec);
+  ASSERT_DOUBLE_EQ(100, loads[1].io_bytes_per_sec);
+  ASSERT_DOUBLE_EQ(0.75, loads[0].score);
+  ASSERT_DOUBLE_EQ(0.25, loads[1].score);
+
+  // The counters of a reopened tablet start from zero, so it keeps its previous rate.
+  tracker.Update({Dir("/d0", 1000), Dir("/d1", 1000)},
+                 {Tablet("t0", "/d0", 100, 3000), Tablet("t1", "/d1", 300, 0),
+                  Tablet("t2", "/d1", 100, 0)},
+                 now + MonoDelta::FromSeconds(20));
+  loads = tracker.loads();
+  ASSERT_DOUBLE_EQ(0, loads[0].io_bytes_per_sec);
+  ASSERT_DOUBLE_EQ(100, loads[1].io_bytes_per_sec);
+}
+
+TEST_F(DataDirLoadTest, NoMoveThatOvershoots) {
+  DataDirLoadTracker tracker(nullptr);
+  tracker.Update({Dir("/d0", 1000), Dir("/d1", 800)},
+                 {Tablet("t0", "/d1", 500, 0)},
+                 MonoTime::Now());
+  // Moving t0 would make /d0 more loaded than /d1 is now.
+  ASSERT_FALSE(tracker.PickMove(0.1));
+
+  tracker.Update({Dir("/d0", 1000), Dir("/d1", 800)},
+                 {Tablet("t0", "/d1", 100, 0)},
+                 MonoTime::Now());
+  auto move = tracker.PickMove(0.1);
+  ASSERT_TRUE(move);
+  ASSERT_EQ("t0", move->tablet_id);
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,198 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/tserver/data_dir_load.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "yb/util/flag_tags.h"
+
+METRIC_DEFINE_entity(data_dir);
+
+METRIC_DEFINE_gauge_uint64(data_dir, data_dir_free_bytes, "Data Directory Free Bytes",
+                           yb::MetricUnit::kBytes,
+                           "Free space of the file system of the data directory");
+METRIC_DEFINE_gauge_uint64(data_dir, data_dir_tablets, "Data Directory Tablets",
+                           yb::MetricUnit::kUnits,
+                           "Number of the tablets with their data in the data directory");
+METRIC_DEFINE_gauge_uint64(data_dir, data_dir_tablet_bytes, "Data Directory Tablet Bytes",
+                           yb::MetricUnit::kBytes,
+                           "Size of the SST files of the tablets in the data directory");
+METRIC_DEFINE_gauge_uint64(data_dir, data_dir_io_bytes_per_sec, "Data Directory I/O Rate",
+                           yb::MetricUnit::kBytes,
+                           "Bytes per second written by the flushes and compactions of the "
+                           "tablets in the data directory, recently");
+
+DEFINE_double(data_dir_load_io_weight, 1.0,
+              "Weight of the share of the I/O of a data directory in its load, relative to the "
+              "used part of its free space.");
+TAG_FLAG(data_dir_load_io_weight, advanced);
+TAG_FLAG(data_dir_load_io_weight, runtime);
+
+namespace yb {
+namespace tserver {
+
+DataDirLoadTracker::DataDirLoadTracker(MetricRegistry* metric_registry)
+    : metric_registry_(metric_registry) {
+}
+
+DataDirLoadTracker::~DataDirLoadTracker() {
+}
+
+void DataDirLoadTracker::Update(
+    std::vector<DataDirLoad> dirs, const std::vector<TabletDataDirLoad>& tablets, MonoTime now) {
+  std::unordered_map<std::string, DataDirLoad*> dir_loads;
+  for (auto& dir : dirs) {
+    dir_loads.emplace(dir.dir, &dir);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  const double elapsed_sec = last_update_ ? (now - last_update_).ToSeconds() : 0;
+  std::unordered_map<TabletId, TabletState> new_tablets;
+  for (const auto& tablet : tablets) {
+    TabletState state{tablet.data_root_dir, tablet.sst_bytes, tablet.io_bytes, 0};
+    auto it = tablets_.find(tablet.tablet_id);
+    // The counters start from zero when the tablet is reopened, e.g. after it was moved.
+    if (it != tablets_.end() && elapsed_sec > 0 && tablet.io_bytes >= it->second.io_bytes) {
+      state.io_bytes_per_sec = (tablet.io_bytes - it->second.io_bytes) / elapsed_sec;
+    } else if (it != tablets_.end()) {
+      state.io_bytes_per_sec = it->second.io_bytes_per_sec;
+    }
+    auto dir_it = dir_loads.find(tablet.data_root_dir);
+    if (dir_it != dir_loads.end()) {
+      ++dir_it->second->num_tablets;
+      dir_it->second->tablet_bytes += tablet.sst_bytes;
+      dir_it->second->io_bytes_per_sec += state.io_bytes_per_sec;
+    }
+    new_tablets.emplace(tablet.tablet_id, std::move(state));
+  }
+
+  max_free_bytes_ = 0;
+  total_io_bytes_per_sec_ = 0;
+  for (const auto& dir : dirs) {
+    max_free_bytes_ = std::max(max_free_bytes_, dir.free_bytes);
+    total_io_bytes_per_sec_ += dir.io_bytes_per_sec;
+  }
+  for (auto& dir : dirs) {
+    dir.score = 0;
+    if (max_free_bytes_ > 0) {
+      dir.score += 1 - static_cast<double>(dir.free_bytes) / max_free_bytes_;
+    }
+    if (total_io_bytes_per_sec_ > 0) {
+      dir.score += FLAGS_data_dir_load_io_weight * dir.io_bytes_per_sec / total_io_bytes_per_sec_;
+    }
+    UpdateMetrics(dir);
+  }
+
+  loads_ = std::move(dirs);
+  tablets_ = std::move(new_tablets);
+  last_update_ = now;
+}
+
+void DataDirLoadTracker::UpdateMetrics(const DataDirLoad& load) {
+  if (!metric_registry_) {
+    return;
+  }
+  auto it = metrics_.find(load.dir);
+  if (it == metrics_.end()) {
+    DirMetrics metrics;
+    metrics.entity = METRIC_ENTITY_data_dir.Instantiate(
+        metric_registry_, load.dir, {{"data_dir", load.dir}});
+    metrics.free_bytes = METRIC_data_dir_free_bytes.Instantiate(metrics.entity, 0);
+    metrics.num_tablets = METRIC_data_dir_tablets.Instantiate(metrics.entity, 0);
+    metrics.tablet_bytes = METRIC_data_dir_tablet_bytes.Instantiate(metrics.entity, 0);
+    metrics.io_bytes_per_sec = METRIC_data_dir_io_bytes_per_sec.Instantiate(metrics.entity, 0);
+    it = metrics_.emplace(load.dir, std::move(metrics)).first;
+  }
+  it->second.free_bytes->set_value(load.free_bytes);
+  it->second.num_tablets->set_value(load.num_tablets);
+  it->second.tablet_bytes->set_value(load.tablet_bytes);
+  it->second.io_bytes_per_sec->set_value(static_cast<uint64_t>(load.io_bytes_per_sec));
+}
+
+std::vector<DataDirLoad> DataDirLoadTracker::loads() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return loads_;
+}
+
+std::unordered_set<std::string> DataDirLoadTracker::PlacementCandidates(double threshold) const {
+  std::unordered_set<std::string> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (loads_.empty()) {
+    return result;
+  }
+  const auto min_score = std::min_element(
+      loads_.begin(), loads_.end(), [](const DataDirLoad& lhs, const DataDirLoad& rhs) {
+    return lhs.score < rhs.score;
+  })->score;
+  for (const auto& load : loads_) {
+    if (load.score <= min_score + threshold) {
+      result.insert(load.dir);
+    }
+  }
+  return result;
+}
+
+double DataDirLoadTracker::Contribution(const TabletState& tablet) const {
+  double result = 0;
+  if (max_free_bytes_ > 0) {
+    result += static_cast<double>(tablet.sst_bytes) / max_free_bytes_;
+  }
+  if (total_io_bytes_per_sec_ > 0) {
+    result += FLAGS_data_dir_load_io_weight * tablet.io_bytes_per_sec / total_io_bytes_per_sec_;
+  }
+  return result;
+}
+
+boost::optional<DataDirMove> DataDirLoadTracker::PickMove(double threshold) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (loads_.size() < 2) {
+    return boost::none;
+  }
+  const auto minmax = std::minmax_element(
+      loads_.begin(), loads_.end(), [](const DataDirLoad& lhs, const DataDirLoad& rhs) {
+    return lhs.score < rhs.score;
+  });
+  const auto& least_loaded = *minmax.first;
+  const auto& most_loaded = *minmax.second;
+  const double gap = most_loaded.score - least_loaded.score;
+  if (gap <= threshold) {
+    return boost::none;
+  }
+
+  // Moving a tablet lowers the score of its directory and raises the score of the other one by
+  // about its contribution.
+  const TabletId* best_tablet = nullptr;
+  double best_gap = gap;
+  for (const auto& id_and_tablet : tablets_) {
+    const auto& tablet = id_and_tablet.second;
+    if (tablet.dir != most_loaded.dir || tablet.sst_bytes >= least_loaded.free_bytes) {
+      continue;
+    }
+    const auto contribution = Contribution(tablet);
+    const auto new_gap = std::abs(gap - 2 * contribution);
+    if (contribution > 0 && new_gap < best_gap) {
+      best_tablet = &id_and_tablet.first;
+      best_gap = new_gap;
+    }
+  }
+  if (!best_tablet) {
+    return boost::none;
+  }
+  return DataDirMove{*best_tablet, most_loaded.dir, least_loaded.dir};
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,126 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_TSERVER_DATA_DIR_LOAD_H
+#define YB_TSERVER_DATA_DIR_LOAD_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace tserver {
+
+// Load of a data root directory of the tablet server.
+struct DataDirLoad {
+  std::string dir;
+  uint64_t free_bytes = 0;
+  size_t num_tablets = 0;
+  // Size of the SST files of the tablets in the directory.
+  uint64_t tablet_bytes = 0;
+  // Rate of the bytes written by the flushes and compactions of the tablets in the directory.
+  double io_bytes_per_sec = 0;
+  // The used part of the free space, relative to the directory with the most free space, plus the
+  // share of the I/O of the directory weighted by data_dir_load_io_weight. The higher the more
+  // loaded.
+  double score = 0;
+};
+
+// The tablet data in a data root directory.
+struct TabletDataDirLoad {
+  TabletId tablet_id;
+  std::string data_root_dir;
+  uint64_t sst_bytes = 0;
+  // Total bytes written by the flushes and compactions of the tablet since it was opened.
+  uint64_t io_bytes = 0;
+};
+
+struct DataDirMove {
+  TabletId tablet_id;
+  std::string from;
+  std::string to;
+};
+
+// Tracks the free space and I/O of the data root directories, so the new tablets are not placed
+// in the directories that are much more loaded than the others, and the tablets could be moved
+// from the most to the least loaded directory. The loads are also exported as the metrics of the
+// data_dir entities.
+class DataDirLoadTracker {
+ public:
+  // The metric registry could be null, e.g. in tests, then the loads are not exported.
+  explicit DataDirLoadTracker(MetricRegistry* metric_registry);
+  ~DataDirLoadTracker();
+
+  // Updates the loads of the directories, that have their free space set, from the tablets in
+  // them. The I/O rates are computed from the differences with the previous update.
+  void Update(std::vector<DataDirLoad> dirs, const std::vector<TabletDataDirLoad>& tablets,
+              MonoTime now);
+
+  std::vector<DataDirLoad> loads() const;
+
+  // Returns the directories new tablets could be placed in, i.e. all but those with a score
+  // higher than the lowest one by more than the threshold. Empty before the first update.
+  std::unordered_set<std::string> PlacementCandidates(double threshold) const;
+
+  // Returns the move of a tablet from the most to the least loaded directory that brings their
+  // scores closest, if they differ by more than the threshold.
+  boost::optional<DataDirMove> PickMove(double threshold) const;
+
+ private:
+  struct TabletState {
+    std::string dir;
+    uint64_t sst_bytes;
+    uint64_t io_bytes;
+    double io_bytes_per_sec;
+  };
+
+  struct DirMetrics {
+    scoped_refptr<MetricEntity> entity;
+    scoped_refptr<AtomicGauge<uint64_t>> free_bytes;
+    scoped_refptr<AtomicGauge<uint64_t>> num_tablets;
+    scoped_refptr<AtomicGauge<uint64_t>> tablet_bytes;
+    scoped_refptr<AtomicGauge<uint64_t>> io_bytes_per_sec;
+  };
+
+  // Part of the score of a directory that is due to the tablet.
+  double Contribution(const TabletState& tablet) const REQUIRES(mutex_);
+
+  void UpdateMetrics(const DataDirLoad& load) REQUIRES(mutex_);
+
+  MetricRegistry* const metric_registry_;
+
+  mutable std::mutex mutex_;
+  std::vector<DataDirLoad> loads_ GUARDED_BY(mutex_);
+  std::unordered_map<TabletId, TabletState> tablets_ GUARDED_BY(mutex_);
+  MonoTime last_update_ GUARDED_BY(mutex_);
+  uint64_t max_free_bytes_ GUARDED_BY(mutex_) = 0;
+  double total_io_bytes_per_sec_ GUARDED_BY(mutex_) = 0;
+  std::unordered_map<std::string, DirMetrics> metrics_ GUARDED_BY(mutex_);
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_DATA_DIR_LOAD_H
@@ -365,6 +365,7 @@ Status Heartbeater::Thread::TryHeartbeat() {
 
   req.set_config_index(server_->GetCurrentMasterIndex());
   req.set_cluster_config_version(server_->cluster_config_version());
+  server_->FillTableChangesVersion(&req);
 
   {
     VLOG_WITH_PREFIX(2) << "Sending heartbeat:\n" << req.DebugString();
@@ -443,6 +444,9 @@ Status Heartbeater::Thread::TryHeartbeat() {
     server_->SetYSQLCatalogVersion(last_hb_response_.ysql_catalog_version());
   }
 
+  // Invalidate cached metadata of tables changed since the previous heartbeat.
+  server_->TableChangesReceived(last_hb_response_);
+
   // Update the live tserver list.
   return server_->PopulateLiveTServers(last_hb_response_);
 }
@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/master/sys_catalog_constants.h"
+
+#include "yb/tserver/pg_catalog_cache.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(ysql_node_catalog_cache_size_mb);
+
+using namespace yb::size_literals;
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+ReadRequestPB CatalogRead(const std::string& table_id, uint64_t catalog_version) {
+  ReadRequestPB request;
+  request.set_tablet_id(master::kSysCatalogTabletId);
+  auto* pgsql_read = request.add_pgsql_batch();
+  pgsql_read->set_table_id(table_id);
+  pgsql_read->set_ysql_catalog_version(catalog_version);
+  return request;
+}
+
+ReadResponsePB OkResponse() {
+  ReadResponsePB response;
+  response.add_pgsql_batch()->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
+  return response;
+}
+
+} // namespace
+
+class PgCatalogCacheTest : public YBTest {
+ protected:
+  PgCatalogCache cache_{nullptr};
+};
+
+TEST_F(PgCatalogCacheTest, IsCacheable) {
+  auto request = CatalogRead("pg_class", 1);
+  ASSERT_TRUE(PgCatalogCache::IsCacheable(request));
+
+  auto user_table_read = request;
+  user_table_read.set_tablet_id("user_tablet");
+  ASSERT_FALSE(PgCatalogCache::IsCacheable(user_table_read));
+
+  auto transactional_read = request;
+  transactional_read.mutable_transaction()->set_transaction_id("txn");
+  ASSERT_FALSE(PgCatalogCache::IsCacheable(transactional_read));
+
+  auto next_page_read = request;
+  next_page_read.mutable_pgsql_batch(0)->mutable_paging_state()->set_next_row_key("key");
+  ASSERT_FALSE(PgCatalogCache::IsCacheable(next_page_read));
+
+  ASSERT_FALSE(PgCatalogCache::IsCacheable(CatalogRead("pg_class", 0)));
+}
+
+TEST_F(PgCatalogCacheTest, FindInserted) {
+  auto request = CatalogRead("pg_class", 1);
+  ASSERT_EQ(cache_.Find(request), nullptr);
+
+  auto response = OkResponse();
+  response.mutable_pgsql_batch(0)->set_rows_data_sidecar(3);
+  response.set_propagated_hybrid_time(12345);
+  cache_.Insert(request, response, "rows");
+
+  auto entry = cache_.Find(request);
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(entry->rows_data, "rows");
+  ASSERT_EQ(entry->response.pgsql_batch_size(), 1);
+  ASSERT_FALSE(entry->response.pgsql_batch(0).has_rows_data_sidecar());
+  ASSERT_FALSE(entry->response.has_propagated_hybrid_time());
+
+  ASSERT_EQ(cache_.Find(CatalogRead("pg_attribute", 1)), nullptr);
+}
+
+TEST_F(PgCatalogCacheTest, SkipUncacheableResponses) {
+  auto request = CatalogRead("pg_class", 1);
+
+  auto paged_response = OkResponse();
+  paged_response.mutable_pgsql_batch(0)->mutable_paging_state()->set_next_row_key("key");
+  cache_.Insert(request, paged_response, "rows");
+
+  auto failed_response = OkResponse();
+  failed_response.mutable_pgsql_batch(0)->set_status(
+      PgsqlResponsePB::PGSQL_STATUS_RUNTIME_ERROR);
+  cache_.Insert(request, failed_response, "");
+
+  ASSERT_EQ(cache_.size(), 0);
+}
+
+TEST_F(PgCatalogCacheTest, NewCatalogVersion) {
+  cache_.Insert(CatalogRead("pg_class", 1), OkResponse(), "rows");
+  cache_.Insert(CatalogRead("pg_attribute", 1), OkResponse(), "rows");
+  ASSERT_EQ(cache_.size(), 2);
+
+  // A read at the new version drops entries of the old one.
+  ASSERT_EQ(cache_.Find(CatalogRead("pg_class", 2)), nullptr);
+  ASSERT_EQ(cache_.size(), 0);
+
+  // Responses to reads at the old version are not cached anymore.
+  cache_.Insert(CatalogRead("pg_class", 1), OkResponse(), "rows");
+  ASSERT_EQ(cache_.size(), 0);
+  ASSERT_EQ(cache_.Find(CatalogRead("pg_class", 1)), nullptr);
+
+  cache_.Insert(CatalogRead("pg_class", 2), OkResponse(), "rows");
+  ASSERT_NE(cache_.Find(CatalogRead("pg_class", 2)), nullptr);
+}
+
+TEST_F(PgCatalogCacheTest, Eviction) {
+  FLAGS_ysql_node_catalog_cache_size_mb = 1;
+  const std::string rows_data(400_KB, 'x');
+  for (int i = 0; i != 5; ++i) {
+    cache_.Insert(CatalogRead("table_" + std::to_string(i), 1), OkResponse(), rows_data);
+    ASSERT_LE(cache_.consumption(), 1_MB);
+  }
+  ASSERT_EQ(cache_.size(), 2);
+  ASSERT_EQ(cache_.Find(CatalogRead("table_2", 1)), nullptr);
+  ASSERT_NE(cache_.Find(CatalogRead("table_3", 1)), nullptr);
+  ASSERT_NE(cache_.Find(CatalogRead("table_4", 1)), nullptr);
+
+  // Entries that do not fit in the cache are not cached.
+  cache_.Insert(CatalogRead("huge", 1), OkResponse(), std::string(2_MB, 'x'));
+  ASSERT_EQ(cache_.size(), 2);
+
+  FLAGS_ysql_node_catalog_cache_size_mb = 0;
+  cache_.Insert(CatalogRead("table_5", 1), OkResponse(), "rows");
+  ASSERT_EQ(cache_.Find(CatalogRead("table_5", 1)), nullptr);
+}
+
+} // namespace tserver
+} // namespace yb
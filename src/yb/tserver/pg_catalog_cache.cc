@@ -0,0 +1,167 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/pg_catalog_cache.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/master/sys_catalog_constants.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+DEFINE_int32(ysql_node_catalog_cache_size_mb, 64,
+             "Size of the cache of YSQL system catalog reads shared by all postgres backends of "
+             "the node. 0 to disable caching, the reads are still forwarded to the master.");
+TAG_FLAG(ysql_node_catalog_cache_size_mb, advanced);
+TAG_FLAG(ysql_node_catalog_cache_size_mb, runtime);
+
+METRIC_DEFINE_counter(
+    server, ysql_node_catalog_cache_hits, "YSQL node catalog cache hits",
+    yb::MetricUnit::kRequests,
+    "Number of YSQL system catalog reads served by the node-wide catalog cache");
+METRIC_DEFINE_counter(
+    server, ysql_node_catalog_cache_misses, "YSQL node catalog cache misses",
+    yb::MetricUnit::kRequests,
+    "Number of YSQL system catalog reads that had to be forwarded to the master");
+
+using namespace yb::size_literals;
+
+namespace yb {
+namespace tserver {
+
+PgCatalogCache::PgCatalogCache(const scoped_refptr<MetricEntity>& metric_entity) {
+  if (metric_entity) {
+    hits_ = METRIC_ysql_node_catalog_cache_hits.Instantiate(metric_entity);
+    misses_ = METRIC_ysql_node_catalog_cache_misses.Instantiate(metric_entity);
+  }
+}
+
+PgCatalogCache::~PgCatalogCache() {}
+
+bool PgCatalogCache::IsCacheable(const ReadRequestPB& request) {
+  if (request.tablet_id() != master::kSysCatalogTabletId || request.has_transaction() ||
+      request.pgsql_batch_size() != 1 || request.ql_batch_size() != 0 ||
+      request.redis_batch_size() != 0) {
+    return false;
+  }
+  const auto& pgsql_read = request.pgsql_batch(0);
+  // Only the first page of a scan carries the catalog version.
+  return pgsql_read.ysql_catalog_version() != 0 && !pgsql_read.has_paging_state();
+}
+
+uint64_t PgCatalogCache::CatalogVersion(const ReadRequestPB& request) {
+  return request.pgsql_batch(0).ysql_catalog_version();
+}
+
+std::string PgCatalogCache::RequestKey(const ReadRequestPB& request) {
+  // The key includes the catalog version, but not the read time, so backends reading the catalog
+  // at the same version share the entry.
+  return request.pgsql_batch(0).SerializeAsString();
+}
+
+bool PgCatalogCache::UpdateCatalogVersionUnlocked(uint64_t catalog_version) {
+  if (catalog_version < catalog_version_) {
+    return false;
+  }
+  if (catalog_version > catalog_version_) {
+    VLOG(1) << "Catalog version changed from " << catalog_version_ << " to " << catalog_version
+            << ", dropping " << entries_.size() << " entries";
+    catalog_version_ = catalog_version;
+    EvictUnlocked(0);
+  }
+  return true;
+}
+
+PgCatalogCache::EntryPtr PgCatalogCache::Find(const ReadRequestPB& request) {
+  const auto key = RequestKey(request);
+  EntryPtr result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (UpdateCatalogVersionUnlocked(CatalogVersion(request))) {
+      auto it = entries_.find(key);
+      if (it != entries_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second);
+        result = it->second->entry;
+      }
+    }
+  }
+  const auto& counter = result ? hits_ : misses_;
+  if (counter) {
+    counter->Increment();
+  }
+  return result;
+}
+
+void PgCatalogCache::Insert(const ReadRequestPB& request, const ReadResponsePB& response,
+                            std::string rows_data) {
+  const size_t capacity = std::max(FLAGS_ysql_node_catalog_cache_size_mb, 0) * 1_MB;
+  if (capacity == 0 || response.has_error() || response.pgsql_batch_size() != 1) {
+    return;
+  }
+  const auto& pgsql_response = response.pgsql_batch(0);
+  if (pgsql_response.status() != PgsqlResponsePB::PGSQL_STATUS_OK ||
+      pgsql_response.has_paging_state()) {
+    return;
+  }
+
+  auto entry = std::make_shared<Entry>();
+  *entry->response.add_pgsql_batch() = pgsql_response;
+  entry->response.mutable_pgsql_batch(0)->clear_rows_data_sidecar();
+  entry->rows_data = std::move(rows_data);
+
+  auto key = RequestKey(request);
+  const size_t charge = key.size() + entry->rows_data.size() + entry->response.ByteSizeLong();
+  if (charge > capacity) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!UpdateCatalogVersionUnlocked(CatalogVersion(request))) {
+    return;
+  }
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    consumption_ -= it->second->charge;
+    lru_.erase(it->second);
+    entries_.erase(it);
+  }
+  EvictUnlocked(capacity - charge);
+  lru_.push_front(LruEntry{key, charge, std::move(entry)});
+  entries_.emplace(std::move(key), lru_.begin());
+  consumption_ += charge;
+}
+
+void PgCatalogCache::EvictUnlocked(size_t capacity) {
+  while (consumption_ > capacity && !lru_.empty()) {
+    auto& victim = lru_.back();
+    consumption_ -= victim.charge;
+    entries_.erase(victim.key);
+    lru_.pop_back();
+  }
+}
+
+size_t PgCatalogCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+size_t PgCatalogCache::consumption() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return consumption_;
+}
+
+} // namespace tserver
+} // namespace yb
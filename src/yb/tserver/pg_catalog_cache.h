@@ -0,0 +1,107 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_PG_CATALOG_CACHE_H
+#define YB_TSERVER_PG_CATALOG_CACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/tserver/tserver.pb.h"
+
+#include "yb/util/metrics.h"
+
+namespace yb {
+namespace tserver {
+
+// Node-wide cache of YSQL system catalog reads.
+//
+// Every new postgres backend warms up its catalog caches by reading the same system catalog rows
+// from the master. The backends of a node instead send such reads to the local tablet server,
+// which serves them from this cache and forwards only the misses to the master.
+//
+// Entries are keyed by the read request, including the catalog version it was sent at. When a
+// read at a newer catalog version arrives, all entries of older versions are dropped, so a DDL,
+// which bumps the catalog version, invalidates the whole cache.
+class PgCatalogCache {
+ public:
+  struct Entry {
+    // Response without the fields that are specific to the read that filled the entry, like
+    // used read time and propagated hybrid time.
+    ReadResponsePB response;
+    std::string rows_data;
+  };
+  typedef std::shared_ptr<const Entry> EntryPtr;
+
+  explicit PgCatalogCache(const scoped_refptr<MetricEntity>& metric_entity);
+  ~PgCatalogCache();
+
+  // Returns whether the request is a non-transactional read of the YSQL system catalog, sent at a
+  // known catalog version, which could be served from the cache.
+  static bool IsCacheable(const ReadRequestPB& request);
+
+  // Returns the cached response to the request, or nullptr if there is no such entry.
+  EntryPtr Find(const ReadRequestPB& request);
+
+  // Caches the response to the request. Only successful responses that fit in a single page are
+  // cached.
+  void Insert(const ReadRequestPB& request, const ReadResponsePB& response,
+              std::string rows_data);
+
+  size_t size() const;
+
+  // Returns the total size of the cached responses.
+  size_t consumption() const;
+
+ private:
+  struct LruEntry {
+    std::string key;
+    size_t charge;
+    EntryPtr entry;
+  };
+  typedef std::list<LruEntry> LruList;
+
+  static std::string RequestKey(const ReadRequestPB& request);
+
+  static uint64_t CatalogVersion(const ReadRequestPB& request);
+
+  // Drops all entries if the version is newer than the current one. Returns false if the version
+  // is older than the current one, i.e. the request was sent by a backend that has not yet
+  // noticed a DDL.
+  bool UpdateCatalogVersionUnlocked(uint64_t catalog_version) REQUIRES(mutex_);
+
+  void EvictUnlocked(size_t capacity) REQUIRES(mutex_);
+
+  mutable std::mutex mutex_;
+  uint64_t catalog_version_ GUARDED_BY(mutex_) = 0;
+  size_t consumption_ GUARDED_BY(mutex_) = 0;
+  // Most recently used entries are at the front.
+  LruList lru_ GUARDED_BY(mutex_);
+  std::unordered_map<std::string, LruList::iterator> entries_ GUARDED_BY(mutex_);
+
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(PgCatalogCache);
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_PG_CATALOG_CACHE_H
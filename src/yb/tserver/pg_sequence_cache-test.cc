@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "yb/tserver/pg_sequence_cache.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tserver {
+
+class PgSequenceCacheTest : public YBTest {
+};
+
+TEST_F(PgSequenceCacheTest, TakeValues) {
+  PgSequenceCache::Range range;
+  int64_t next = 1;
+  ASSERT_TRUE(PgSequenceCache::TakeValues(10, 1, 4, &next, &range));
+  ASSERT_EQ(range.first_value, 1);
+  ASSERT_EQ(range.last_value, 4);
+  ASSERT_EQ(next, 5);
+
+  ASSERT_TRUE(PgSequenceCache::TakeValues(10, 1, 4, &next, &range));
+  ASSERT_EQ(range.first_value, 5);
+  ASSERT_EQ(range.last_value, 8);
+
+  // Fewer values than requested are left.
+  ASSERT_FALSE(PgSequenceCache::TakeValues(10, 1, 4, &next, &range));
+  ASSERT_EQ(range.first_value, 9);
+  ASSERT_EQ(range.last_value, 10);
+}
+
+TEST_F(PgSequenceCacheTest, TakeValuesDescending) {
+  PgSequenceCache::Range range;
+  int64_t next = -1;
+  ASSERT_TRUE(PgSequenceCache::TakeValues(-20, -5, 2, &next, &range));
+  ASSERT_EQ(range.first_value, -1);
+  ASSERT_EQ(range.last_value, -6);
+  ASSERT_EQ(next, -11);
+
+  // The last value that fits in the range is -16.
+  ASSERT_FALSE(PgSequenceCache::TakeValues(-20, -5, 3, &next, &range));
+  ASSERT_EQ(range.first_value, -11);
+  ASSERT_EQ(range.last_value, -16);
+}
+
+TEST_F(PgSequenceCacheTest, LeaseRange) {
+  constexpr auto kMin = std::numeric_limits<int64_t>::min();
+  constexpr auto kMax = std::numeric_limits<int64_t>::max();
+
+  auto range = PgSequenceCache::LeaseRange(1, 1, 1, kMax, 100);
+  ASSERT_TRUE(range);
+  ASSERT_EQ(range->first_value, 1);
+  ASSERT_EQ(range->last_value, 100);
+
+  // The range does not overflow near the bounds.
+  range = PgSequenceCache::LeaseRange(kMax - 3, 2, 1, kMax, 100);
+  ASSERT_TRUE(range);
+  ASSERT_EQ(range->first_value, kMax - 3);
+  ASSERT_EQ(range->last_value, kMax - 1);
+
+  range = PgSequenceCache::LeaseRange(kMin + 1, -1, kMin, -1, kMax);
+  ASSERT_TRUE(range);
+  ASSERT_EQ(range->first_value, kMin + 1);
+  ASSERT_EQ(range->last_value, kMin);
+
+  // Start is past the bounds.
+  ASSERT_FALSE(PgSequenceCache::LeaseRange(11, 1, 1, 10, 100));
+  ASSERT_FALSE(PgSequenceCache::LeaseRange(0, -1, 1, 10, 100));
+}
+
+} // namespace tserver
+} // namespace yb
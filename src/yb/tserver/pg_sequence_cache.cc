@@ -0,0 +1,248 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/pg_sequence_cache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <gflags/gflags.h>
+
+#include "yb/client/client.h"
+#include "yb/client/session.h"
+#include "yb/client/table.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/common/entity_ids.h"
+
+#include "yb/util/flag_tags.h"
+
+#include "yb/yql/pggate/util/pg_doc_data.h"
+
+DEFINE_int32(ysql_sequence_cache_lease_multiplier, 32,
+             "Number of times the cache size of a YSQL sequence, that a tablet server leases from "
+             "the sequences data table at once, to hand out to the postgres backends of the node.");
+TAG_FLAG(ysql_sequence_cache_lease_multiplier, advanced);
+TAG_FLAG(ysql_sequence_cache_lease_multiplier, runtime);
+
+DEFINE_int32(ysql_sequence_cache_lease_timeout_ms, 10000,
+             "Timeout of the reads and writes of the sequences data table done to lease a range of "
+             "sequence values.");
+TAG_FLAG(ysql_sequence_cache_lease_timeout_ms, advanced);
+
+namespace yb {
+namespace tserver {
+
+namespace {
+
+// Conditional updates of the sequence, that lost to an update by another node, are retried this
+// number of times.
+constexpr int kMaxLeaseAttempts = 10;
+
+uint64_t Distance(int64_t from, int64_t to) {
+  return static_cast<uint64_t>(to) - static_cast<uint64_t>(from);
+}
+
+} // namespace
+
+PgSequenceCache::PgSequenceCache() {}
+
+PgSequenceCache::~PgSequenceCache() {}
+
+bool PgSequenceCache::TakeValues(
+    int64_t last, int64_t increment, int64_t count, int64_t* next, Range* result) {
+  DCHECK_NE(increment, 0);
+  DCHECK_GT(count, 0);
+  const uint64_t step = increment > 0 ? static_cast<uint64_t>(increment)
+                                      : -static_cast<uint64_t>(increment);
+  // Number of values in the range after *next.
+  const uint64_t left = (increment > 0 ? Distance(*next, last) : Distance(last, *next)) / step;
+  const uint64_t taken = std::min<uint64_t>(count - 1, left);
+  const uint64_t offset = taken * step;
+  result->first_value = *next;
+  const uint64_t first = static_cast<uint64_t>(*next);
+  result->last_value = static_cast<int64_t>(increment > 0 ? first + offset : first - offset);
+  if (taken == left) {
+    return false;
+  }
+  *next = result->last_value + increment;
+  return true;
+}
+
+boost::optional<PgSequenceCache::Range> PgSequenceCache::LeaseRange(
+    int64_t start, int64_t increment, int64_t min_value, int64_t max_value, int64_t count) {
+  if (start < min_value || start > max_value) {
+    return boost::none;
+  }
+  Range result;
+  TakeValues(increment > 0 ? max_value : min_value, increment, count, &start, &result);
+  return result;
+}
+
+std::shared_ptr<PgSequenceCache::Entry> PgSequenceCache::GetEntry(
+    const AllocateSequenceValuesRequestPB& req) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = entries_[SequenceKey(req.db_oid(), req.seq_oid())];
+  if (!entry) {
+    entry = std::make_shared<Entry>();
+  }
+  return entry;
+}
+
+Result<client::YBTablePtr> PgSequenceCache::GetTable(client::YBClient* client) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (table_) {
+      return table_;
+    }
+  }
+  client::YBTablePtr table;
+  RETURN_NOT_OK(client->OpenTable(
+      GetPgsqlTableId(kPgSequencesDataDatabaseOid, kPgSequencesDataTableOid), &table));
+  std::lock_guard<std::mutex> lock(mutex_);
+  table_ = table;
+  return table;
+}
+
+Result<boost::optional<PgSequenceCache::Range>> PgSequenceCache::Allocate(
+    client::YBClient* client, const AllocateSequenceValuesRequestPB& req) {
+  if (req.increment() == 0 || req.count() <= 0 || req.min_value() > req.max_value()) {
+    return STATUS_FORMAT(
+        InvalidArgument, "Invalid sequence parameters: $0", req.ShortDebugString());
+  }
+
+  auto entry = GetEntry(req);
+  std::lock_guard<std::mutex> lock(entry->mutex);
+  // Values leased before a DDL, like ALTER SEQUENCE, are dropped.
+  if (entry->has_values &&
+      (entry->increment != req.increment() || entry->min_value != req.min_value() ||
+       entry->max_value != req.max_value() ||
+       entry->catalog_version < req.ysql_catalog_version())) {
+    VLOG(1) << "Dropping values [" << entry->next_value << ", " << entry->last_value
+            << "] of sequence " << req.seq_oid();
+    entry->has_values = false;
+  }
+  if (!entry->has_values && !VERIFY_RESULT(Lease(client, req, entry.get()))) {
+    return boost::none;
+  }
+
+  Range result;
+  entry->has_values = TakeValues(
+      entry->last_value, entry->increment, req.count(), &entry->next_value, &result);
+  return result;
+}
+
+Result<bool> PgSequenceCache::Lease(
+    client::YBClient* client, const AllocateSequenceValuesRequestPB& req, Entry* entry) {
+  auto table = VERIFY_RESULT(GetTable(client));
+  const auto& schema = table->schema();
+  const auto last_value_column_id = schema.ColumnId(kPgSequenceLastValueColIdx);
+  const auto is_called_column_id = schema.ColumnId(kPgSequenceIsCalledColIdx);
+
+  const int64_t multiplier = std::max(FLAGS_ysql_sequence_cache_lease_multiplier, 1);
+  const int64_t lease_count = req.count() > std::numeric_limits<int64_t>::max() / multiplier
+      ? std::numeric_limits<int64_t>::max() : req.count() * multiplier;
+  const int64_t increment = req.increment();
+
+  auto session = client->NewSession();
+  session->SetTimeout(MonoDelta::FromMilliseconds(FLAGS_ysql_sequence_cache_lease_timeout_ms));
+
+  for (int attempt = 0; attempt != kMaxLeaseAttempts; ++attempt) {
+    std::shared_ptr<client::YBPgsqlReadOp> read_op(table->NewPgsqlSelect());
+    auto* read_request = read_op->mutable_request();
+    read_request->set_ysql_catalog_version(req.ysql_catalog_version());
+    read_request->add_partition_column_values()->mutable_value()->set_int64_value(req.db_oid());
+    read_request->add_partition_column_values()->mutable_value()->set_int64_value(req.seq_oid());
+    read_request->add_targets()->set_column_id(last_value_column_id);
+    read_request->add_targets()->set_column_id(is_called_column_id);
+    read_request->mutable_column_refs()->add_ids(last_value_column_id);
+    read_request->mutable_column_refs()->add_ids(is_called_column_id);
+    RETURN_NOT_OK(session->ReadSync(read_op));
+
+    Slice cursor;
+    int64_t row_count = 0;
+    pggate::PgDocData::LoadCache(read_op->rows_data(), &row_count, &cursor);
+    if (row_count == 0 || pggate::PgDocData::ReadDataHeader(&cursor).is_null()) {
+      return STATUS_FORMAT(NotFound, "Unable to find relation for sequence $0", req.seq_oid());
+    }
+    int64_t last_value;
+    cursor.remove_prefix(pggate::PgDocData::ReadNumber(&cursor, &last_value));
+    if (pggate::PgDocData::ReadDataHeader(&cursor).is_null()) {
+      return STATUS_FORMAT(NotFound, "Unable to find relation for sequence $0", req.seq_oid());
+    }
+    bool is_called;
+    pggate::PgDocData::ReadNumber(&cursor, &is_called);
+
+    int64_t start = last_value;
+    if (is_called) {
+      if (increment > 0 ? last_value > std::numeric_limits<int64_t>::max() - increment
+                        : last_value < std::numeric_limits<int64_t>::min() - increment) {
+        return false;
+      }
+      start += increment;
+    }
+    auto range = LeaseRange(start, increment, req.min_value(), req.max_value(), lease_count);
+    if (!range) {
+      return false;
+    }
+
+    // UPDATE ... SET last_value = range->last_value, is_called = true
+    //     WHERE last_value = last_value AND is_called = is_called
+    std::shared_ptr<client::YBPgsqlWriteOp> write_op(table->NewPgsqlUpdate());
+    auto* write_request = write_op->mutable_request();
+    write_request->set_ysql_catalog_version(req.ysql_catalog_version());
+    write_request->add_partition_column_values()->mutable_value()->set_int64_value(req.db_oid());
+    write_request->add_partition_column_values()->mutable_value()->set_int64_value(req.seq_oid());
+    auto* column_value = write_request->add_column_new_values();
+    column_value->set_column_id(last_value_column_id);
+    column_value->mutable_expr()->mutable_value()->set_int64_value(range->last_value);
+    column_value = write_request->add_column_new_values();
+    column_value->set_column_id(is_called_column_id);
+    column_value->mutable_expr()->mutable_value()->set_bool_value(true);
+
+    auto* where_pb = write_request->mutable_where_expr()->mutable_condition();
+    where_pb->set_op(QL_OP_AND);
+    auto* cond = where_pb->add_operands()->mutable_condition();
+    cond->set_op(QL_OP_EQUAL);
+    cond->add_operands()->set_column_id(last_value_column_id);
+    cond->add_operands()->mutable_value()->set_int64_value(last_value);
+    cond = where_pb->add_operands()->mutable_condition();
+    cond->set_op(QL_OP_EQUAL);
+    cond->add_operands()->set_column_id(is_called_column_id);
+    cond->add_operands()->mutable_value()->set_bool_value(is_called);
+
+    write_request->mutable_column_refs()->add_ids(last_value_column_id);
+    write_request->mutable_column_refs()->add_ids(is_called_column_id);
+    RETURN_NOT_OK(session->ApplyAndFlush(write_op));
+    if (write_op->response().skipped()) {
+      continue;
+    }
+
+    VLOG(2) << "Leased values [" << range->first_value << ", " << range->last_value
+            << "] of sequence " << req.seq_oid();
+    entry->has_values = true;
+    entry->next_value = range->first_value;
+    entry->last_value = range->last_value;
+    entry->increment = increment;
+    entry->min_value = req.min_value();
+    entry->max_value = req.max_value();
+    entry->catalog_version = req.ysql_catalog_version();
+    return true;
+  }
+  return STATUS_FORMAT(
+      TryAgain, "Failed to lease values of sequence $0 in $1 attempts", req.seq_oid(),
+      kMaxLeaseAttempts);
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_PG_SEQUENCE_CACHE_H
+#define YB_TSERVER_PG_SEQUENCE_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/result.h"
+
+namespace yb {
+namespace tserver {
+
+// Node-wide allocator of YSQL sequence values.
+//
+// Every postgres backend refills its cache of sequence values with a read and a conditional
+// update of the sequence row in the sequences data table, so backends inserting into the same
+// table contend on a single row. The backends of a node instead ask the local tablet server for
+// values, which leases ranges of ysql_sequence_cache_lease_multiplier times the cache size of the
+// sequence from the sequences data table, and hands them out to the backends.
+//
+// Values handed out by one node are increasing, but values handed out by different nodes, as well
+// as by different backends of the same node, interleave, as they do with postgres caching.
+class PgSequenceCache {
+ public:
+  struct Range {
+    int64_t first_value;
+    int64_t last_value;
+  };
+
+  PgSequenceCache();
+  ~PgSequenceCache();
+
+  // Allocates up to the requested number of values. Returns none when no values could be leased
+  // without going past the bounds of the sequence, so the caller has to handle the sequence
+  // reaching its bound, or cycling, itself.
+  Result<boost::optional<Range>> Allocate(
+      client::YBClient* client, const AllocateSequenceValuesRequestPB& req);
+
+  // Takes min(count, values left) values of size increment from the range [*next, last], and
+  // advances *next. Returns false when the range is exhausted after that.
+  static bool TakeValues(
+      int64_t last, int64_t increment, int64_t count, int64_t* next, Range* result);
+
+  // Returns the range of up to count values starting at start, that does not go past the bounds
+  // of the sequence, or none if start is past them.
+  static boost::optional<Range> LeaseRange(
+      int64_t start, int64_t increment, int64_t min_value, int64_t max_value, int64_t count);
+
+ private:
+  struct Entry {
+    std::mutex mutex;
+    // Leased values, which are not allocated yet, are [next_value, last_value].
+    bool has_values GUARDED_BY(mutex) = false;
+    int64_t next_value GUARDED_BY(mutex) = 0;
+    int64_t last_value GUARDED_BY(mutex) = 0;
+    // Parameters of the sequence and catalog version the values were leased with.
+    int64_t increment GUARDED_BY(mutex) = 0;
+    int64_t min_value GUARDED_BY(mutex) = 0;
+    int64_t max_value GUARDED_BY(mutex) = 0;
+    uint64_t catalog_version GUARDED_BY(mutex) = 0;
+  };
+
+  typedef std::pair<int64_t, int64_t> SequenceKey;
+
+  std::shared_ptr<Entry> GetEntry(const AllocateSequenceValuesRequestPB& req);
+
+  Result<client::YBTablePtr> GetTable(client::YBClient* client);
+
+  // Leases the next range of values from the sequences data table.
+  Result<bool> Lease(
+      client::YBClient* client, const AllocateSequenceValuesRequestPB& req, Entry* entry)
+      REQUIRES(entry->mutex);
+
+  std::mutex mutex_;
+  client::YBTablePtr table_ GUARDED_BY(mutex_);
+  std::unordered_map<SequenceKey, std::shared_ptr<Entry>, boost::hash<SequenceKey>> entries_
+      GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(PgSequenceCache);
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_PG_SEQUENCE_CACHE_H
@@ -644,14 +644,17 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   DataIdPB data_id;
   data_id.set_type(DataIdPB::ROCKSDB_FILE);
-  for (auto const& file_pb : new_superblock_.kv_store().rocksdb_files()) {
-    auto start = MonoTime::Now();
-    RETURN_NOT_OK(downloader_.DownloadFile(file_pb, rocksdb_dir, &data_id));
-    auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG_WITH_PREFIX(INFO)
-        << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-        << " in " << elapsed.ToSeconds() << " seconds";
+  const auto& files = new_superblock_.kv_store().rocksdb_files();
+  uint64_t total_size = 0;
+  for (const auto& file_pb : files) {
+    total_size += file_pb.size_bytes();
   }
+  auto start = MonoTime::Now();
+  RETURN_NOT_OK(downloader_.DownloadFiles(files, rocksdb_dir, data_id));
+  auto elapsed = MonoTime::Now().GetDeltaSince(start).ToSeconds();
+  LOG_WITH_PREFIX(INFO)
+      << "Downloaded " << files.size() << " files of size " << total_size << " in " << elapsed
+      << " seconds, " << (elapsed > 0 ? total_size / 1_MB / elapsed : 0) << " MB/s";
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
   auto intents_tmp_dir = JoinPathSegments(rocksdb_dir, tablet::kIntentsSubdir);
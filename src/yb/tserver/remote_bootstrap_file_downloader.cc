@@ -13,6 +13,9 @@
 
 #include "yb/tserver/remote_bootstrap_file_downloader.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "yb/common/wire_protocol.h"
 
 #include "yb/fs/fs_manager.h"
@@ -25,6 +28,8 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/thread.h"
+#include "yb/util/background_io_limiter.h"
 #include "yb/util/net/rate_limiter.h"
 
 using namespace yb::size_literals;
@@ -45,6 +50,13 @@ DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 256_MB,
              "the total limit will be 2 * remote_bootstrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of files that a remote bootstrap session downloads at the same time. "
+             "The transmission rate of every download is limited to its share of "
+             "remote_bootstrap_rate_limit_bytes_per_sec.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, runtime);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
@@ -100,16 +112,23 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
   RETURN_NOT_OK(env().CreateDirs(DirName(file_path)));
 
   if (file_pb.inode() != 0) {
-    auto it = inode2file_.find(file_pb.inode());
-    if (it != inode2file_.end()) {
+    std::string linked_file;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = inode2file_.find(file_pb.inode());
+      if (it != inode2file_.end()) {
+        linked_file = it->second;
+      }
+    }
+    if (!linked_file.empty()) {
       VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = env().LinkFile(it->second, file_path);
+                          << " => " << linked_file;
+      auto link_status = env().LinkFile(linked_file, file_path);
       if (link_status.ok()) {
         return Status::OK();
       }
       // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
+      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << linked_file
                              << ": " << link_status;
     }
   }
@@ -126,12 +145,75 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
   return Status::OK();
 }
 
+Status RemoteBootstrapFileDownloader::DownloadFiles(
+    const google::protobuf::RepeatedPtrField<tablet::FilePB>& files, const std::string& dir,
+    const DataIdPB& data_id) {
+  std::vector<const tablet::FilePB*> queue;
+  queue.reserve(files.size());
+  for (const auto& file_pb : files) {
+    queue.push_back(&file_pb);
+  }
+  // The largest files are started first, so that the downloads finish at about the same time.
+  std::stable_sort(queue.begin(), queue.end(), [](const auto* lhs, const auto* rhs) {
+    return lhs->size_bytes() > rhs->size_bytes();
+  });
+
+  std::mutex mutex;
+  size_t next = 0;
+  Status result;
+  auto download = [this, &queue, &dir, &data_id, &mutex, &next, &result] {
+    DataIdPB file_data_id = data_id;
+    for (;;) {
+      const tablet::FilePB* file_pb;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!result.ok() || next == queue.size()) {
+          return;
+        }
+        file_pb = queue[next++];
+      }
+      auto start = MonoTime::Now();
+      auto status = DownloadFile(*file_pb, dir, &file_data_id);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+        return;
+      }
+      LOG_WITH_PREFIX(INFO)
+          << "Downloaded file " << file_pb->name() << " of size " << file_pb->size_bytes()
+          << " in " << MonoTime::Now().GetDeltaSince(start).ToSeconds() << " seconds";
+    }
+  };
+
+  const size_t num_downloads = std::min<size_t>(
+      std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1), queue.size());
+  std::vector<scoped_refptr<Thread>> threads;
+  for (size_t i = 1; i < num_downloads; ++i) {
+    scoped_refptr<Thread> thread;
+    auto status = Thread::Create("remote-bootstrap", "rb-download", download, &thread);
+    if (!status.ok()) {
+      // The files are still downloaded by the threads that were started and this one.
+      LOG_WITH_PREFIX(WARNING) << "Failed to start file download thread: " << status;
+      break;
+    }
+    threads.push_back(std::move(thread));
+  }
+  download();
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+  return result;
+}
+
 template<class Appendable>
 Status RemoteBootstrapFileDownloader::DownloadFile(
     const DataIdPB& data_id, Appendable* appendable) {
@@ -154,8 +236,12 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
                                    << remote_bootstrap_clients_started;
         return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec);
       }
+      // Every session could be downloading several files at a time.
+      const auto max_downloads_per_session =
+          std::max(FLAGS_remote_bootstrap_max_concurrent_file_downloads, 1);
       return static_cast<uint64_t>(
-          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / remote_bootstrap_clients_started);
+          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec /
+          (remote_bootstrap_clients_started * max_downloads_per_session));
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -196,6 +282,8 @@ Status RemoteBootstrapFileDownloader::DownloadFile(
 
     // Write the data.
     RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
+    BackgroundIoLimiter::Default().Request(
+        BackgroundIoClass::kRemoteBootstrap, resp.chunk().data().size());
     VLOG_WITH_PREFIX(3)
         << "resp size: " << resp.ByteSize() << ", chunk size: " << resp.chunk().data().size();
 
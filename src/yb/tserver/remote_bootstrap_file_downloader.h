@@ -15,6 +15,7 @@
 #define YB_TSERVER_REMOTE_BOOTSTRAP_FILE_DOWNLOADER_H
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -48,6 +49,12 @@ class RemoteBootstrapFileDownloader {
   CHECKED_STATUS DownloadFile(
       const tablet::FilePB& file_pb, const std::string& dir, DataIdPB* data_id);
 
+  // Download the files to the directory, up to remote_bootstrap_max_concurrent_file_downloads of
+  // them at a time, largest first. Stops at the first failure and returns it.
+  CHECKED_STATUS DownloadFiles(
+      const google::protobuf::RepeatedPtrField<tablet::FilePB>& files, const std::string& dir,
+      const DataIdPB& data_id);
+
   // Download a single remote file. The block and WAL implementations delegate
   // to this method when downloading files.
   //
@@ -81,6 +88,9 @@ class RemoteBootstrapFileDownloader {
   std::shared_ptr<RemoteBootstrapServiceProxy> proxy_;
   std::string session_id_;
   MonoDelta session_idle_timeout_ = MonoDelta::kZero;
+
+  // Protects inode2file_, since files are downloaded concurrently.
+  std::mutex mutex_;
   std::unordered_map<uint64_t, std::string> inode2file_;
 };
 
@@ -49,6 +49,7 @@
 #include "yb/tserver/remote_bootstrap_snapshots.h"
 #include "yb/tserver/tablet_peer_lookup.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/background_io_limiter.h"
 #include "yb/util/crc.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
@@ -242,11 +243,15 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
     session = it->second.session;
   }
 
-  session->EnsureRateLimiterIsInitialized();
+  int64_t rate_limit;
+  {
+    std::lock_guard<std::mutex> l(session->rate_limiter_mutex());
+    session->EnsureRateLimiterIsInitialized();
 
-  MAYBE_FAULT(FLAGS_fault_crash_on_handle_rb_fetch_data);
+    MAYBE_FAULT(FLAGS_fault_crash_on_handle_rb_fetch_data);
 
-  int64_t rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+    rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  }
   VLOG(3) << " rate limiter max len: " << rate_limit;
   GetDataPieceInfo info = {
     .offset = req->offset(),
@@ -262,7 +267,11 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
   RPC_RETURN_NOT_OK(session->GetDataPiece(data_id, &info),
                     info.error_code, "Unable to get piece of data file");
 
-  session->rate_limiter().UpdateDataSizeAndMaybeSleep(info.data.size());
+  {
+    std::lock_guard<std::mutex> l(session->rate_limiter_mutex());
+    session->rate_limiter().UpdateDataSizeAndMaybeSleep(info.data.size());
+  }
+  BackgroundIoLimiter::Default().Request(BackgroundIoClass::kRemoteBootstrap, info.data.size());
   uint32_t crc32 = Crc32c(info.data.data(), info.data.length());
 
   DataChunkPB* data_chunk = resp->mutable_chunk();
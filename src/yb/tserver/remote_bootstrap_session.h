@@ -33,6 +33,7 @@
 #define YB_TSERVER_REMOTE_BOOTSTRAP_SESSION_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -134,6 +135,10 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
 
   RateLimiter& rate_limiter() { return rate_limiter_; }
 
+  // The peer fetches several files of the session at a time, so the rate limiter is used under
+  // this mutex.
+  std::mutex& rate_limiter_mutex() { return rate_limiter_mutex_; }
+
   static const std::string kCheckpointsDir;
 
   // Get a piece of a RocksDB file.
@@ -217,6 +222,7 @@ class RemoteBootstrapSession : public RefCountedThreadSafe<RemoteBootstrapSessio
   MonoTime start_time_;
 
   // Used to limit the transmission rate.
+  std::mutex rate_limiter_mutex_;
   RateLimiter rate_limiter_;
 
   // Pointer to the counter for of the number of sessions in RemoteBootstrapService. Used to
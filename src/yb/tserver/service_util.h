@@ -140,6 +140,9 @@ Result<std::shared_ptr<tablet::TabletPeer>> LookupTabletPeerOrRespond(
   // Check RUNNING state.
   tablet::RaftGroupStatePB state = result->state();
   if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    if (state == tablet::NOT_STARTED) {
+      tablet_manager->TabletOpenRequested(tablet_id);
+    }
     Status s = STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStateError(state))
         .CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::TABLET_NOT_RUNNING));
     SetupErrorAndRespond(resp->mutable_error(), s, context);
@@ -72,6 +72,10 @@ class TabletPeerLookupIf {
 
   virtual CHECKED_STATUS StartRemoteBootstrap(
       const consensus::StartRemoteBootstrapRequestPB& req) = 0;
+
+  // Called when a request arrives for a tablet that was not started yet, so that it could be
+  // opened before the other tablets that are waiting to be opened.
+  virtual void TabletOpenRequested(const std::string& tablet_id) {}
 };
 
 } // namespace tserver
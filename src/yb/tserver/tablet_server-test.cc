@@ -639,6 +639,36 @@ TEST_F(TabletServerTest, TestDeleteTablet_TabletNotCreated) {
   }
 }
 
+TEST_F(TabletServerTest, TestMultiRaftUpdateConsensus) {
+  consensus::MultiRaftConsensusRequestPB req;
+  consensus::MultiRaftConsensusResponsePB resp;
+  RpcController rpc;
+
+  auto add_request = [&req](const string& dest_uuid, const string& tablet_id) {
+    auto* consensus_req = req.add_consensus_request();
+    consensus_req->set_dest_uuid(dest_uuid);
+    consensus_req->set_tablet_id(tablet_id);
+    consensus_req->set_caller_uuid("fake_leader");
+    consensus_req->set_caller_term(0);
+    consensus_req->mutable_committed_op_id()->set_term(0);
+    consensus_req->mutable_committed_op_id()->set_index(0);
+  };
+
+  const auto& uuid = mini_server_->server()->fs_manager()->uuid();
+  add_request(uuid, kTabletId);
+  add_request(uuid, "NotPresentTabletId");
+  add_request("WrongUuid", kTabletId);
+
+  ASSERT_OK(consensus_proxy_->MultiRaftUpdateConsensus(req, &resp, &rpc));
+  SCOPED_TRACE(resp.DebugString());
+  ASSERT_EQ(req.consensus_request_size(), resp.consensus_response_size());
+  // Request from a stale leader is rejected by consensus of the tablet, not by the service.
+  ASSERT_FALSE(resp.consensus_response(0).has_error());
+  ASSERT_TRUE(resp.consensus_response(0).status().has_error());
+  ASSERT_EQ(TabletServerErrorPB::TABLET_NOT_FOUND, resp.consensus_response(1).error().code());
+  ASSERT_EQ(TabletServerErrorPB::WRONG_SERVER_UUID, resp.consensus_response(2).error().code());
+}
+
 // Test that with concurrent requests to delete the same tablet, one wins and
 // the other fails, with no assertion failures. Regression test for KUDU-345.
 TEST_F(TabletServerTest, TestConcurrentDeleteTablet) {
@@ -51,6 +51,8 @@
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tserver/heartbeater_factory.h"
 #include "yb/tserver/metrics_snapshotter.h"
+#include "yb/tserver/pg_catalog_cache.h"
+#include "yb/tserver/pg_sequence_cache.h"
 #include "yb/tserver/tablet_service.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver-path-handlers.h"
@@ -58,6 +60,7 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/sockaddr.h"
+#include "yb/util/pb_util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/env.h"
@@ -284,7 +287,10 @@ void TabletServer::AutoInitServiceFlags() {
 }
 
 Status TabletServer::RegisterServices() {
-  tablet_server_service_ = new TabletServiceImpl(this);
+  pg_catalog_cache_ = std::make_unique<PgCatalogCache>(metric_entity());
+  pg_sequence_cache_ = std::make_unique<PgSequenceCache>();
+  tablet_server_service_ = new TabletServiceImpl(
+      this, pg_catalog_cache_.get(), pg_sequence_cache_.get());
   LOG(INFO) << "yb::tserver::TabletServiceImpl created at " << tablet_server_service_;
   std::unique_ptr<ServiceIf> ts_service(tablet_server_service_);
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_tablet_server_svc_queue_length,
@@ -370,7 +376,25 @@ Status TabletServer::PopulateLiveTServers(const master::TSHeartbeatResponsePB& h
   // TODO: In the future, we should enhance the logic here to keep track information retrieved
   // from the master and compare it with information stored here. Based on this information, we
   // can only send diff updates CQL clients about whether a node came up or went down.
-  live_tservers_.assign(heartbeat_resp.tservers().begin(), heartbeat_resp.tservers().end());
+  const auto& tservers = heartbeat_resp.tservers();
+  const bool topology_changed =
+      heartbeat_resp.master_instance().permanent_uuid() != ycql_topology_master_uuid_ ||
+      !heartbeat_resp.has_ycql_partitions_version() || !ycql_partitions_version_ ||
+      heartbeat_resp.ycql_partitions_version() != *ycql_partitions_version_ ||
+      !std::equal(live_tservers_.begin(), live_tservers_.end(), tservers.begin(), tservers.end(),
+                  [](const master::TSInformationPB& lhs, const master::TSInformationPB& rhs) {
+                    return pb_util::ArePBsEqual(lhs, rhs, nullptr /* diff_str */);
+                  });
+  if (topology_changed) {
+    ycql_topology_master_uuid_ = heartbeat_resp.master_instance().permanent_uuid();
+    if (heartbeat_resp.has_ycql_partitions_version()) {
+      ycql_partitions_version_ = heartbeat_resp.ycql_partitions_version();
+    } else {
+      ycql_partitions_version_.reset();
+    }
+    ycql_topology_version_.fetch_add(1, std::memory_order_acq_rel);
+  }
+  live_tservers_.assign(tservers.begin(), tservers.end());
   return Status::OK();
 }
 
@@ -464,6 +488,39 @@ void TabletServer::SetYSQLCatalogVersion(uint64_t new_version) {
   }
 }
 
+void TabletServer::AddTableChangesListener(TableChangesListener listener) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  table_changes_listeners_.push_back(std::move(listener));
+}
+
+void TabletServer::FillTableChangesVersion(master::TSHeartbeatRequestPB* req) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (table_changes_version_) {
+    req->set_table_changes_epoch(table_changes_version_->first);
+    req->set_table_changes_version(table_changes_version_->second);
+  }
+}
+
+void TabletServer::TableChangesReceived(const master::TSHeartbeatResponsePB& resp) {
+  if (!resp.has_table_changes_epoch()) {
+    return;
+  }
+  std::vector<TableChangesListener> listeners;
+  {
+    std::lock_guard<simple_spinlock> l(lock_);
+    table_changes_version_.emplace(resp.table_changes_epoch(), resp.table_changes_version());
+    if (resp.table_changes().empty() && !resp.invalidate_all_tables()) {
+      return;
+    }
+    listeners = table_changes_listeners_;
+  }
+  VLOG(1) << "Received " << resp.table_changes().size() << " table changes"
+          << (resp.invalidate_all_tables() ? ", invalidate all tables" : "");
+  for (const auto& listener : listeners) {
+    listener(resp);
+  }
+}
+
 TabletPeerLookupIf* TabletServer::tablet_peer_lookup() {
   return tablet_manager_.get();
 }
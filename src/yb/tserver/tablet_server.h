@@ -32,10 +32,14 @@
 #ifndef YB_TSERVER_TABLET_SERVER_H_
 #define YB_TSERVER_TABLET_SERVER_H_
 
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/consensus/metadata.pb.h"
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/gscoped_ptr.h"
@@ -134,8 +138,17 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
 
   const scoped_refptr<MetricEntity>& MetricEnt() const override { return metric_entity(); }
 
+  // Updates the live tserver list, and the YCQL topology version when the topology in the
+  // heartbeat response is different from the previous one.
   CHECKED_STATUS PopulateLiveTServers(const master::TSHeartbeatResponsePB& heartbeat_resp);
 
+  // Version of the cluster topology that YCQL clients see in system.peers, system.local and
+  // system.partitions. Changes when the master leader, the live tservers, or the tablets of tables
+  // and their replica locations change, as reported by heartbeat responses.
+  uint64_t ycql_topology_version() const {
+    return ycql_topology_version_.load(std::memory_order_acquire);
+  }
+
   CHECKED_STATUS GetLiveTServers(
       std::vector<master::TSInformationPB> *live_tservers) const {
     std::lock_guard<simple_spinlock> l(lock_);
@@ -163,11 +176,11 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
 
   scoped_refptr<Histogram> GetMetricsHistogram(TabletServerServiceIf::RpcMetricIndexes metric);
 
-  void SetPublisher(rpc::Publisher service) {
-    publish_service_ptr_.reset(new rpc::Publisher(std::move(service)));
+  void SetPublisher(Publisher service) {
+    publish_service_ptr_.reset(new Publisher(std::move(service)));
   }
 
-  rpc::Publisher* GetPublisher() override {
+  Publisher* GetPublisher() override {
     return publish_service_ptr_.get();
   }
 
@@ -178,6 +191,18 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
     return ysql_catalog_version_;
   }
 
+  // Listener of table changes received from the master leader with heartbeat responses, used to
+  // invalidate cached table metadata.
+  typedef std::function<void(const master::TSHeartbeatResponsePB&)> TableChangesListener;
+
+  void AddTableChangesListener(TableChangesListener listener);
+
+  // Fills the version of table changes received so far.
+  void FillTableChangesVersion(master::TSHeartbeatRequestPB* req) const;
+
+  // Remembers the version of table changes in the heartbeat response and notifies listeners.
+  void TableChangesReceived(const master::TSHeartbeatResponsePB& resp);
+
   virtual Env* GetEnv();
 
   virtual rocksdb::Env* GetRocksDBEnv();
@@ -220,7 +245,7 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   gscoped_ptr<TSTabletManager> tablet_manager_;
 
   // Used to forward redis pub/sub messages to the redis pub/sub handler
-  yb::AtomicUniquePtr<rpc::Publisher> publish_service_ptr_;
+  yb::AtomicUniquePtr<Publisher> publish_service_ptr_;
 
   // Thread responsible for heartbeating to the master.
   std::unique_ptr<Heartbeater> heartbeater_;
@@ -240,7 +265,13 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   // List of tservers that are alive from the master's perspective.
   std::vector<master::TSInformationPB> live_tservers_;
 
-  // Lock to protect live_tservers_, cluster_uuid_.
+  // Master leader and partitions version of the last heartbeat response.
+  std::string ycql_topology_master_uuid_;
+  boost::optional<uint64_t> ycql_partitions_version_;
+
+  std::atomic<uint64_t> ycql_topology_version_{0};
+
+  // Lock to protect live_tservers_, cluster_uuid_, and the YCQL topology of the last heartbeat.
   mutable simple_spinlock lock_;
 
   // Proxy to call this tablet server locally.
@@ -252,6 +283,11 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   // Latest known version from the YSQL catalog (as reported by last heartbeat response).
   uint64_t ysql_catalog_version_ = 0;
 
+  // Epoch and version of the last table changes received from the master leader.
+  boost::optional<std::pair<uint64_t, uint64_t>> table_changes_version_;
+
+  std::vector<TableChangesListener> table_changes_listeners_;
+
   // An instance to tablet server service. This pointer is no longer valid after RpcAndWebServerBase
   // is shut down.
   TabletServiceImpl* tablet_server_service_;
@@ -268,6 +304,12 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   std::unique_ptr<client::TransactionManager> transaction_manager_holder_;
   std::unique_ptr<client::TransactionPool> transaction_pool_holder_;
 
+  // Cache of YSQL system catalog reads of the postgres backends of this node.
+  std::unique_ptr<PgCatalogCache> pg_catalog_cache_;
+
+  // Allocator of YSQL sequence values to the postgres backends of this node.
+  std::unique_ptr<PgSequenceCache> pg_sequence_cache_;
+
   std::string log_prefix_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletServer);
@@ -14,6 +14,8 @@
 #ifndef YB_TSERVER_TABLET_SERVER_INTERFACE_H
 #define YB_TSERVER_TABLET_SERVER_INTERFACE_H
 
+#include <functional>
+
 #include "yb/client/meta_cache.h"
 #include "yb/server/clock.h"
 #include "yb/util/metrics.h"
@@ -28,9 +30,15 @@ class TSInformationPB;
 
 namespace tserver {
 
+class PublishRequestPB;
+class PublishResponsePB;
 class TabletPeerLookupIf;
 class TSTabletManager;
 
+// Handles a message published through the tablet server, or a notification of new subscribers of
+// another Redis proxy.
+typedef std::function<void(const PublishRequestPB&, PublishResponsePB*)> Publisher;
+
 class TabletServerIf : public LocalTabletServer {
  public:
   virtual ~TabletServerIf() {}
@@ -39,7 +47,7 @@ class TabletServerIf : public LocalTabletServer {
   virtual TabletPeerLookupIf* tablet_peer_lookup() = 0;
 
   virtual server::Clock* Clock() = 0;
-  virtual rpc::Publisher* GetPublisher() = 0;
+  virtual Publisher* GetPublisher() = 0;
 
   virtual uint64_t ysql_catalog_version() const = 0;
 
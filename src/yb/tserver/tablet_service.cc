@@ -34,9 +34,11 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "yb/client/client.h"
 #include "yb/client/transaction.h"
 #include "yb/client/transaction_pool.h"
 
@@ -66,16 +68,20 @@
 #include "yb/tablet/tablet_metrics.h"
 
 #include "yb/tablet/operations/change_metadata_operation.h"
+#include "yb/tablet/operations/import_data_operation.h"
 #include "yb/tablet/operations/split_operation.h"
 #include "yb/tablet/operations/truncate_operation.h"
 #include "yb/tablet/operations/update_txn_operation.h"
 #include "yb/tablet/operations/write_operation.h"
 
+#include "yb/tserver/pg_catalog_cache.h"
+#include "yb/tserver/pg_sequence_cache.h"
 #include "yb/tserver/remote_bootstrap_service.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
 #include "yb/tserver/tserver_error.h"
 #include "yb/tserver/tserver.pb.h"
+#include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/crc.h"
 #include "yb/util/debug/long_operation_tracker.h"
@@ -132,11 +138,20 @@ DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_int32(max_wait_for_session_writes_ms, 50,
+             "Maximum time in milliseconds a follower waits for its safe time to reach the hybrid "
+             "time of the writes of the session sending a CONSISTENT_PREFIX read. The read is "
+             "retried on another replica after that.");
+TAG_FLAG(max_wait_for_session_writes_ms, advanced);
+TAG_FLAG(max_wait_for_session_writes_ms, runtime);
+
 DEFINE_int32(num_concurrent_backfills_allowed, 8,
              "Maximum number of concurrent backfill jobs that is allowed to run.");
 
 DEFINE_test_flag(bool, tserver_noop_read_write, false, "Respond NOOP to read/write.");
 
+DEFINE_test_flag(bool, reject_split_tablet, false, "Reject SplitTablet requests.");
+
 DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from followers, "
              "specify the maximum time a follower can be behind by using the last message received "
              "from the leader. If set to zero, a read can be served by a follower regardless of "
@@ -155,6 +170,12 @@ DEFINE_uint64(sst_files_hard_limit, 48,
               "requests.");
 TAG_FLAG(sst_files_hard_limit, runtime);
 
+DEFINE_bool(reject_writes_on_write_stall_pressure, true,
+            "Whether to reject part of write requests when RocksDB predicts or applies a write "
+            "stall. The closer RocksDB is to stopping writes, the higher probability of "
+            "rejection, so clients back off before writes are stopped.");
+TAG_FLAG(reject_writes_on_write_stall_pressure, runtime);
+
 DEFINE_uint64(min_rejection_delay_ms, 100, ".");
 TAG_FLAG(min_rejection_delay_ms, runtime);
 
@@ -223,6 +244,8 @@ using consensus::GetNodeInstanceResponsePB;
 using consensus::LeaderStepDownRequestPB;
 using consensus::LeaderStepDownResponsePB;
 using consensus::LeaderLeaseStatus;
+using consensus::MultiRaftConsensusRequestPB;
+using consensus::MultiRaftConsensusResponsePB;
 using consensus::RunLeaderElectionRequestPB;
 using consensus::RunLeaderElectionResponsePB;
 using consensus::StartRemoteBootstrapRequestPB;
@@ -280,21 +303,45 @@ Status GetTabletRef(const TabletPeerPtr& tablet_peer,
 // score + (value - lower_bound) / (upper_bound - lower_bound).
 // And it will be >= 1.0 when this function is invoked.
 template<class Resp>
-bool RejectWrite(tablet::TabletPeer* tablet_peer, const std::string& message, double overlimit,
-                 Resp* resp, rpc::RpcContext* context) {
+bool RejectRequest(const TabletId& tablet_id, const std::string& permanent_uuid,
+                   const char* request_type, const std::string& message, double overlimit,
+                   Resp* resp, rpc::RpcContext* context) {
   int64_t delay_ms = fit_bounds<int64_t>((overlimit - 1.0) * FLAGS_max_rejection_delay_ms,
                                          FLAGS_min_rejection_delay_ms,
                                          FLAGS_max_rejection_delay_ms);
   auto status = STATUS(ServiceUnavailable, message, TabletServerDelay(delay_ms * 1ms));
   YB_LOG_EVERY_N_SECS(WARNING, 1)
-      << "T " << tablet_peer->tablet_id() << " P " << tablet_peer->permanent_uuid()
-      << ": Rejecting Write request, " << status << THROTTLE_MSG;
+      << "T " << tablet_id << " P " << permanent_uuid << ": Rejecting " << request_type
+      << " request, " << status << THROTTLE_MSG;
   SetupErrorAndRespond(resp->mutable_error(), status,
                        TabletServerErrorPB::UNKNOWN_ERROR,
                        context);
   return false;
 }
 
+template<class Resp>
+bool RejectWrite(tablet::TabletPeer* tablet_peer, const std::string& message, double overlimit,
+                 Resp* resp, rpc::RpcContext* context) {
+  return RejectRequest(tablet_peer->tablet_id(), tablet_peer->permanent_uuid(), "Write",
+                       message, overlimit, resp, context);
+}
+
+// Admits the request if the limiter has room for it. Otherwise rejects it with a delay that is
+// spread by the rejection score, so that the retries of the clients do not come back at once.
+template<class Resp>
+bool AdmitOrRespond(Tablet* tablet, const char* request_type, ConcurrencyLimiter* limiter,
+                    Counter* rejections, double score, ConcurrencySlot* slot, Resp* resp,
+                    rpc::RpcContext* context) {
+  if (limiter->TryAcquire(slot)) {
+    return true;
+  }
+  rejections->Increment();
+  return RejectRequest(
+      tablet->tablet_id(), tablet->metadata()->fs_manager()->uuid(), request_type,
+      Format("$0 $1 requests are running, score: $2", limiter->running(), request_type, score),
+      1.0 + score, resp, context);
+}
+
 void AdjustYsqlOperationTransactionality(
     size_t ysql_batch_size,
     const TabletPeer* tablet_peer,
@@ -305,6 +352,52 @@ void AdjustYsqlOperationTransactionality(
   }
 }
 
+// Responds to HeartbeatTransactions RPC when the heartbeats of all its transactions complete.
+class HeartbeatTransactionsResponder {
+ public:
+  HeartbeatTransactionsResponder(
+      rpc::RpcContext context, HeartbeatTransactionsResponsePB* resp,
+      const server::ClockPtr& clock, int num_transactions)
+      : context_(std::move(context)), resp_(resp), clock_(clock), remaining_(num_transactions) {
+    for (int i = 0; i != num_transactions; ++i) {
+      resp_->add_status();
+    }
+  }
+
+  void Completed(int idx, const Status& status) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      StatusToPB(status, resp_->mutable_status(idx));
+      if (--remaining_ != 0) {
+        return;
+      }
+    }
+    resp_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+    context_.RespondSuccess();
+  }
+
+ private:
+  rpc::RpcContext context_;
+  HeartbeatTransactionsResponsePB* const resp_;
+  server::ClockPtr clock_;
+  std::mutex mutex_;
+  int remaining_;
+};
+
+class HeartbeatCompletionCallback : public tablet::OperationCompletionCallback {
+ public:
+  HeartbeatCompletionCallback(std::shared_ptr<HeartbeatTransactionsResponder> responder, int idx)
+      : responder_(std::move(responder)), idx_(idx) {}
+
+  void OperationCompleted() override {
+    responder_->Completed(idx_, status_);
+  }
+
+ private:
+  std::shared_ptr<HeartbeatTransactionsResponder> responder_;
+  const int idx_;
+};
+
 } // namespace
 
 template<class Resp>
@@ -348,6 +441,15 @@ bool TabletServiceImpl::CheckWriteThrottlingOrRespond(
     }
   }
 
+  if (FLAGS_reject_writes_on_write_stall_pressure) {
+    const double write_stall_pressure = tablet->GetWriteStallPressure();
+    if (write_stall_pressure > 0 && write_stall_pressure >= 1 - score) {
+      tablet->metrics()->write_stall_rejections->Increment();
+      auto message = Format("Write stall pressure $0, score: $1", write_stall_pressure, score);
+      return RejectWrite(tablet_peer, message, score + write_stall_pressure, resp, context);
+    }
+  }
+
   if (FLAGS_TEST_write_rejection_percentage != 0 &&
       score >= 1.0 - FLAGS_TEST_write_rejection_percentage * 0.01) {
     auto status = Format("TEST: Write request rejected, desired percentage: $0, score: $1",
@@ -369,9 +471,10 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       WriteResponsePB* response,
       tablet::WriteOperationState* state,
       const server::ClockPtr& clock,
-      bool trace = false)
+      bool trace = false,
+      ConcurrencySlot slot = ConcurrencySlot())
       : tablet_peer_(std::move(tablet_peer)), context_(std::move(context)), response_(response),
-        state_(state), clock_(clock), include_trace_(trace) {}
+        state_(state), clock_(clock), include_trace_(trace), slot_(std::move(slot)) {}
 
   void OperationCompleted() override {
     VLOG(1) << __PRETTY_FUNCTION__ << "completing with status " << status_;
@@ -443,6 +546,8 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
   tablet::WriteOperationState* const state_;
   server::ClockPtr clock_;
   const bool include_trace_;
+  // Accounts the write as running in the write limiter of the tablet until it completes.
+  ConcurrencySlot slot_;
 };
 
 // Checksums the scan result.
@@ -481,9 +586,12 @@ class ScanResultChecksummer {
   std::string buffer_;
 };
 
-TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
+TabletServiceImpl::TabletServiceImpl(TabletServerIf* server, PgCatalogCache* pg_catalog_cache,
+                                     PgSequenceCache* pg_sequence_cache)
     : TabletServerServiceIf(server->MetricEnt()),
-      server_(server) {
+      server_(server),
+      pg_catalog_cache_(pg_catalog_cache),
+      pg_sequence_cache_(pg_sequence_cache) {
 }
 
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
@@ -697,8 +805,9 @@ void TabletServiceAdminImpl::BackfillIndex(
     index_ids.push_back(index_map.at(idx.table_id()).table_id());
   }
 
+  size_t number_rows_processed = 0;
   Result<string> resume_from = tablet.peer->tablet()->BackfillIndexes(
-      indexes_to_backfill, req->start_key(), deadline, read_at);
+      indexes_to_backfill, req->start_key(), deadline, read_at, &number_rows_processed);
   DVLOG(1) << "Tablet " << tablet.peer->tablet_id()
            << ". Backfilled indexes for : " << yb::ToString(index_ids)
            << " got " << resume_from.ToString();
@@ -712,6 +821,7 @@ void TabletServiceAdminImpl::BackfillIndex(
   }
 
   resp->set_backfilled_until(*resume_from);
+  resp->set_number_rows_processed(number_rows_processed);
   resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
   context.RespondSuccess();
 }
@@ -862,6 +972,52 @@ void TabletServiceImpl::PerformAtLeader(
   }
 }
 
+void TabletServiceImpl::HeartbeatTransactions(const HeartbeatTransactionsRequestPB* req,
+                                              HeartbeatTransactionsResponsePB* resp,
+                                              rpc::RpcContext context) {
+  TRACE("HeartbeatTransactions");
+
+  VLOG(2) << "HeartbeatTransactions: " << req->tablet_id() << ", transactions: "
+          << req->transaction_id_size();
+  UpdateClock(*req, server_->Clock());
+
+  auto tablet = LookupLeaderTabletOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+  if (!tablet) {
+    return;
+  }
+
+  auto* transaction_coordinator = tablet.peer->tablet()->transaction_coordinator();
+  if (!transaction_coordinator) {
+    SetupErrorAndRespond(
+        resp->mutable_error(),
+        STATUS_FORMAT(InvalidArgument, "No transaction coordinator at tablet $0",
+                      tablet.peer->tablet_id()),
+        TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
+  if (req->transaction_id().empty()) {
+    resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+    context.RespondSuccess();
+    return;
+  }
+
+  auto responder = std::make_shared<HeartbeatTransactionsResponder>(
+      std::move(context), resp, server_->Clock(), req->transaction_id_size());
+  std::vector<std::unique_ptr<tablet::UpdateTxnOperationState>> states;
+  states.reserve(req->transaction_id_size());
+  for (int i = 0; i != req->transaction_id_size(); ++i) {
+    TransactionStatePB state;
+    state.set_transaction_id(req->transaction_id(i));
+    state.set_status(TransactionStatus::PENDING);
+    states.push_back(tablet.peer->CreateUpdateTransactionState(&state));
+    states.back()->set_completion_callback(
+        std::make_unique<HeartbeatCompletionCallback>(responder, i));
+  }
+  transaction_coordinator->HandleHeartbeats(std::move(states), tablet.leader_term);
+}
+
 void TabletServiceImpl::GetTransactionStatus(const GetTransactionStatusRequestPB* req,
                                              GetTransactionStatusResponsePB* resp,
                                              rpc::RpcContext context) {
@@ -967,52 +1123,73 @@ void TabletServiceAdminImpl::CreateTablet(const CreateTabletRequestPB* req,
     return;
   }
   DVLOG(3) << "Received CreateTablet RPC: " << yb::ToString(*req);
+  TabletServerErrorPB::Code code;
+  Status s = DoCreateTablet(*req, &code);
+  if (PREDICT_FALSE(!s.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
+    return;
+  }
+  context.RespondSuccess();
+}
+
+void TabletServiceAdminImpl::CreateTablets(const CreateTabletsRequestPB* req,
+                                           CreateTabletsResponsePB* resp,
+                                           rpc::RpcContext context) {
+  if (!CheckUuidMatchOrRespond(server_->tablet_manager(), "CreateTablets", req, resp, &context)) {
+    return;
+  }
+  DVLOG(3) << "Received CreateTablets RPC for " << req->tablets_size() << " tablets";
+  for (const auto& tablet_req : req->tablets()) {
+    TabletServerErrorPB::Code code;
+    Status s = DoCreateTablet(tablet_req, &code);
+    if (PREDICT_FALSE(!s.ok())) {
+      auto* tablet_error = resp->add_tablet_errors();
+      tablet_error->set_tablet_id(tablet_req.tablet_id());
+      StatusToPB(s, tablet_error->mutable_error()->mutable_status());
+      tablet_error->mutable_error()->set_code(code);
+    }
+  }
+  context.RespondSuccess();
+}
+
+Status TabletServiceAdminImpl::DoCreateTablet(
+    const CreateTabletRequestPB& req, TabletServerErrorPB::Code* code) {
   TRACE_EVENT1("tserver", "CreateTablet",
-               "tablet_id", req->tablet_id());
+               "tablet_id", req.tablet_id());
 
   Schema schema;
-  Status s = SchemaFromPB(req->schema(), &schema);
+  Status s = SchemaFromPB(req.schema(), &schema);
   DCHECK(schema.has_column_ids());
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid Schema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid Schema.");
   }
 
   PartitionSchema partition_schema;
-  s = PartitionSchema::FromPB(req->partition_schema(), schema, &partition_schema);
+  s = PartitionSchema::FromPB(req.partition_schema(), schema, &partition_schema);
   if (!s.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(),
-                         STATUS(InvalidArgument, "Invalid PartitionSchema."),
-                         TabletServerErrorPB::INVALID_SCHEMA, &context);
-    return;
+    *code = TabletServerErrorPB::INVALID_SCHEMA;
+    return STATUS(InvalidArgument, "Invalid PartitionSchema.");
   }
 
   Partition partition;
-  Partition::FromPB(req->partition(), &partition);
+  Partition::FromPB(req.partition(), &partition);
 
-  LOG(INFO) << "Processing CreateTablet for tablet " << req->tablet_id()
-            << " (table=" << req->table_name()
-            << " [id=" << req->table_id() << "]), partition="
+  LOG(INFO) << "Processing CreateTablet for tablet " << req.tablet_id()
+            << " (table=" << req.table_name()
+            << " [id=" << req.table_id() << "]), partition="
             << partition_schema.PartitionDebugString(partition, schema);
-  VLOG(1) << "Full request: " << req->DebugString();
+  VLOG(1) << "Full request: " << req.DebugString();
 
-  s = server_->tablet_manager()->CreateNewTablet(req->table_id(), req->tablet_id(), partition,
-      req->table_name(), req->table_type(), schema, partition_schema,
-      req->has_index_info() ? boost::optional<IndexInfo>(req->index_info()) : boost::none,
-      req->config(), /* tablet_peer */ nullptr, req->colocated());
+  s = server_->tablet_manager()->CreateNewTablet(req.table_id(), req.tablet_id(), partition,
+      req.table_name(), req.table_type(), schema, partition_schema,
+      req.has_index_info() ? boost::optional<IndexInfo>(req.index_info()) : boost::none,
+      req.config(), /* tablet_peer */ nullptr, req.colocated());
   if (PREDICT_FALSE(!s.ok())) {
-    TabletServerErrorPB::Code code;
-    if (s.IsAlreadyPresent()) {
-      code = TabletServerErrorPB::TABLET_ALREADY_EXISTS;
-    } else {
-      code = TabletServerErrorPB::UNKNOWN_ERROR;
-    }
-    SetupErrorAndRespond(resp->mutable_error(), s, code, &context);
-    return;
+    *code = s.IsAlreadyPresent() ? TabletServerErrorPB::TABLET_ALREADY_EXISTS
+                                 : TabletServerErrorPB::UNKNOWN_ERROR;
   }
-  context.RespondSuccess();
+  return s;
 }
 
 void TabletServiceAdminImpl::DeleteTablet(const DeleteTabletRequestPB* req,
@@ -1191,6 +1368,13 @@ void TabletServiceAdminImpl::SplitTablet(
 
   server::UpdateClock(*req, server_->Clock());
 
+  if (FLAGS_reject_split_tablet) {
+    SetupErrorAndRespond(
+        resp->mutable_error(), STATUS(IllegalState, "TEST: SplitTablet request rejected"),
+        TabletServerErrorPB::UNKNOWN_ERROR, &context);
+    return;
+  }
+
   auto leader_tablet_peer =
       LookupLeaderTabletOrRespond(server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
   if (!leader_tablet_peer) {
@@ -1232,6 +1416,15 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
 
+  ConcurrencySlot slot;
+  auto* shared_tablet = tablet.peer->tablet();
+  if (!AdmitOrRespond(
+          shared_tablet, "Write", &shared_tablet->write_limiter(),
+          shared_tablet->metrics()->write_admission_rejections.get(), req->rejection_score(),
+          &slot, resp, &context)) {
+    return;
+  }
+
 #if defined(DUMP_WRITE)
   if (req->has_write_batch() && req->write_batch().has_transaction()) {
     VLOG(1) << "Write with transaction: " << req->write_batch().transaction().ShortDebugString();
@@ -1308,7 +1501,7 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     operation_state->set_completion_callback(
         std::make_unique<WriteOperationCompletionCallback>(
             tablet.peer, context_ptr, resp, operation_state.get(), server_->Clock(),
-            req->include_trace()));
+            req->include_trace(), std::move(slot)));
   }
 
   AdjustYsqlOperationTransactionality(
@@ -1484,11 +1677,44 @@ struct ReadContext {
   // Picks read based for specified read context.
   CHECKED_STATUS PickReadTime(server::Clock* clock) {
     if (!read_time) {
-      safe_ht_to_read = tablet->SafeTime(require_lease);
+      // A strong single-shard read could only miss the writes of the transactions committed by
+      // other servers, whose clocks could be ahead. If all the transactions of the tablet were
+      // applied before the read time, there are no such writes. Checked before picking the safe
+      // time, so a transaction removed after the check was applied below it.
+      HybridTime applied_commit_ht;
+      if (require_lease && !req->has_transaction() && transactional()) {
+        auto* participant = down_cast<Tablet*>(tablet.get())->transaction_participant();
+        if (participant) {
+          applied_commit_ht = participant->MaxAppliedCommitTimeIfNoneRunning();
+        }
+      }
+      if (req->has_min_safe_time() &&
+          req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX) {
+        // Wait for the writes of the session that sent this read to be replicated here, so the
+        // read sees them.
+        const auto deadline = std::min(
+            context->GetClientDeadline(),
+            CoarseMonoClock::now() + FLAGS_max_wait_for_session_writes_ms * 1ms);
+        safe_ht_to_read = tablet->SafeTime(
+            require_lease, HybridTime(req->min_safe_time()), deadline);
+        if (!safe_ht_to_read.is_valid()) {
+          TRACE("Timed out waiting for writes of the session");
+          return STATUS_FORMAT(
+              IllegalState, "Safe time did not reach $0 of the session writes in $1ms",
+              HybridTime(req->min_safe_time()), FLAGS_max_wait_for_session_writes_ms)
+              .CloneAndAddErrorCode(TabletServerError(TabletServerErrorPB::STALE_FOLLOWER));
+        }
+      } else {
+        safe_ht_to_read = tablet->SafeTime(require_lease);
+      }
       // If the read time is not specified, then it is a single-shard read.
       // So we should restart it in server in case of failure.
       read_time.read = safe_ht_to_read;
-      if (transactional()) {
+      if (applied_commit_ht.is_valid() && applied_commit_ht <= read_time.read) {
+        read_time.local_limit = read_time.read;
+        read_time.global_limit = read_time.read;
+        down_cast<Tablet*>(tablet.get())->metrics()->read_uncertainty_skipped_requests->Increment();
+      } else if (transactional()) {
         read_time.local_limit = clock->MaxGlobalNow();
         read_time.global_limit = read_time.local_limit;
 
@@ -1577,6 +1803,68 @@ class ReadOperationCompletionCallback : public OperationCompletionCallback {
   std::shared_ptr<rpc::RpcContext> context_;
 };
 
+namespace {
+
+struct ForwardedCatalogRead {
+  explicit ForwardedCatalogRead(rpc::RpcContext context_) : context(std::move(context_)) {}
+
+  rpc::RpcContext context;
+  std::shared_ptr<TabletServerServiceProxy> proxy;
+  ReadResponsePB response;
+  rpc::RpcController controller;
+};
+
+} // namespace
+
+void TabletServiceImpl::ReadCatalog(const ReadRequestPB* req,
+                                    ReadResponsePB* resp,
+                                    rpc::RpcContext context) {
+  TRACE("Start ReadCatalog");
+  auto entry = pg_catalog_cache_->Find(*req);
+  if (entry) {
+    TRACE("Found in node catalog cache");
+    *resp = entry->response;
+    resp->set_propagated_hybrid_time(server_->Clock()->Now().ToUint64());
+    if (!entry->rows_data.empty()) {
+      resp->mutable_pgsql_batch(0)->set_rows_data_sidecar(
+          context.AddRpcSidecar(entry->rows_data));
+    }
+    context.RespondSuccess();
+    return;
+  }
+
+  // The master replies with an error if it is not the leader, so the backend retries the read and
+  // it is forwarded to the new leader, once the client of this server learns about it.
+  auto& client = server_->tablet_manager()->client();
+  auto forwarded = std::make_shared<ForwardedCatalogRead>(std::move(context));
+  forwarded->proxy = std::make_shared<TabletServerServiceProxy>(
+      &client.proxy_cache(), client.GetMasterLeaderAddress());
+  forwarded->controller.set_deadline(forwarded->context.GetClientDeadline());
+  forwarded->proxy->ReadAsync(
+      *req, &forwarded->response, &forwarded->controller,
+      [this, req, resp, forwarded] {
+        auto& context = forwarded->context;
+        const auto& status = forwarded->controller.status();
+        if (!status.ok()) {
+          context.RespondFailure(status);
+          return;
+        }
+        resp->Swap(&forwarded->response);
+        Slice rows_data;
+        if (resp->pgsql_batch_size() == 1 && resp->pgsql_batch(0).has_rows_data_sidecar()) {
+          auto sidecar = forwarded->controller.GetSidecar(resp->pgsql_batch(0).rows_data_sidecar());
+          if (!sidecar.ok()) {
+            context.RespondFailure(sidecar.status());
+            return;
+          }
+          rows_data = *sidecar;
+          resp->mutable_pgsql_batch(0)->set_rows_data_sidecar(context.AddRpcSidecar(rows_data));
+        }
+        pg_catalog_cache_->Insert(*req, *resp, rows_data.ToBuffer());
+        context.RespondSuccess();
+      });
+}
+
 void TabletServiceImpl::Read(const ReadRequestPB* req,
                              ReadResponsePB* resp,
                              rpc::RpcContext context) {
@@ -1584,6 +1872,10 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     context.RespondSuccess();
     return;
   }
+  if (pg_catalog_cache_ && PgCatalogCache::IsCacheable(*req)) {
+    ReadCatalog(req, resp, std::move(context));
+    return;
+  }
   TRACE("Start Read");
   TRACE_EVENT1("tserver", "TabletServiceImpl::Read",
       "tablet_id", req->tablet_id());
@@ -1657,6 +1949,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
 
   LeaderTabletPeer leader_peer;
   ReadContext read_context = {req, resp, &context};
+  ConcurrencySlot slot;
 
   if (serializable_isolation || has_row_mark) {
     // At this point we expect that we don't have pure read serializable transactions, and
@@ -1676,6 +1969,15 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       return;
     }
     leader_peer.leader_term = yb::OpId::kUnknownTerm;
+    // Serializable reads are replicated as writes, so only the reads that keep the RPC worker
+    // until they are done are limited.
+    auto* tablet = down_cast<Tablet*>(read_context.tablet.get());
+    if (!AdmitOrRespond(
+            tablet, "Read", &tablet->read_limiter(),
+            tablet->metrics()->read_admission_rejections.get(), req->rejection_score(), &slot,
+            resp, &context)) {
+      return;
+    }
   }
 
   if (PREDICT_FALSE(FLAGS_simulate_time_out_failures) && RandomUniformInt(0, 10) < 3) {
@@ -1707,10 +2009,28 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
   if (!serializable_isolation) {
     auto status = read_context.PickReadTime(server_->Clock());
     if (!status.ok()) {
-      SetupErrorAndRespond(
-          resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR, &context);
+      const auto code =
+          TabletServerError(status) == TabletServerError(TabletServerErrorPB::STALE_FOLLOWER)
+              ? TabletServerErrorPB::STALE_FOLLOWER : TabletServerErrorPB::UNKNOWN_ERROR;
+      SetupErrorAndRespond(resp->mutable_error(), status, code, &context);
       return;
     }
+
+    // The read time picked from the safe time of a follower could be too far in the past.
+    if (req->consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+        req->max_staleness_ms() > 0 && read_context.allow_retry) {
+      const int64_t staleness_us =
+          server_->Clock()->Now().GetPhysicalValueMicros() -
+          read_context.safe_ht_to_read.GetPhysicalValueMicros();
+      if (staleness_us > static_cast<int64_t>(req->max_staleness_ms() * 1000)) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(IllegalState, "Stale follower, data is $0ms old, while bound is $1ms",
+                          staleness_us / 1000, req->max_staleness_ms()),
+            TabletServerErrorPB::STALE_FOLLOWER, &context);
+        return;
+      }
+    }
   }
 
   if (transactional) {
@@ -1924,6 +2244,10 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
         ql_read_req.release_remote_endpoint();
         ql_read_req.release_proxy_uuid();
       });
+      // Traced requests also trace the work done by the storage.
+      if (read_context->req->include_trace()) {
+        ql_read_req.set_include_storage_metrics(true);
+      }
 
       tablet::QLReadRequestResult result;
       TRACE("Start HandleQLReadRequest");
@@ -1931,6 +2255,9 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
           read_context->context->GetClientDeadline(), read_tx.read_time(), ql_read_req,
           read_context->req->transaction(), &result));
       TRACE("Done HandleQLReadRequest");
+      if (result.response.has_storage_metrics()) {
+        TRACE("Storage metrics: $0", result.response.storage_metrics().ShortDebugString());
+      }
       if (result.restart_read_ht.is_valid()) {
         DCHECK_GT(result.restart_read_ht, read_context->read_time.read);
         VLOG(1) << "Restart read required at: " << result.restart_read_ht
@@ -1946,14 +2273,14 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
   }
 
   if (!read_context->req->pgsql_batch().empty()) {
-    ReadRequestPB* mutable_req = const_cast<ReadRequestPB*>(read_context->req);
-    for (PgsqlReadRequestPB& pgsql_read_req : *mutable_req->mutable_pgsql_batch()) {
-      tablet::PgsqlReadRequestResult result;
-      TRACE("Start HandlePgsqlReadRequest");
-      RETURN_NOT_OK(read_context->tablet->HandlePgsqlReadRequest(
-          read_context->context->GetClientDeadline(), read_tx.read_time(), pgsql_read_req,
-          read_context->req->transaction(), &result));
-      TRACE("Done HandlePgsqlReadRequest");
+    // Reads of colocated tables that share the tablet are handled together.
+    std::vector<tablet::PgsqlReadRequestResult> results;
+    TRACE("Start HandlePgsqlReadRequests");
+    RETURN_NOT_OK(down_cast<Tablet*>(read_context->tablet.get())->HandlePgsqlReadRequests(
+        read_context->context->GetClientDeadline(), read_tx.read_time(),
+        read_context->req->pgsql_batch(), read_context->req->transaction(), &results));
+    TRACE("Done HandlePgsqlReadRequests");
+    for (auto& result : results) {
       if (result.restart_read_ht.is_valid()) {
         VLOG(1) << "Restart read required at: " << result.restart_read_ht;
         read_context->read_time.read = result.restart_read_ht;
@@ -2022,6 +2349,75 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const MultiRaftConsensusRequestPB* req,
+    MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Raft Consensus Update RPC with "
+           << req->consensus_request_size() << " requests";
+  // See UpdateConsensus for the reason of const_cast.
+  auto* mutable_req = const_cast<MultiRaftConsensusRequestPB*>(req);
+  const auto deadline = context.GetClientDeadline();
+  for (auto& consensus_req : *mutable_req->mutable_consensus_request()) {
+    UpdateConsensusInBatch(&consensus_req, resp->add_consensus_response(), deadline);
+  }
+  context.RespondSuccess();
+}
+
+void ConsensusServiceImpl::UpdateConsensusInBatch(ConsensusRequestPB* req,
+                                                  ConsensusResponsePB* resp,
+                                                  CoarseTimePoint deadline) {
+  auto set_error = [resp](const Status& status, TabletServerErrorPB::Code code) {
+    resp->Clear();
+    StatusToPB(status, resp->mutable_error()->mutable_status());
+    resp->mutable_error()->set_code(code);
+  };
+
+  const string& local_uuid = tablet_manager_->NodeInstance().permanent_uuid();
+  if (PREDICT_FALSE(!req->dest_uuid().empty() && req->dest_uuid() != local_uuid)) {
+    set_error(STATUS_FORMAT(InvalidArgument,
+                            "MultiRaftUpdateConsensus: Wrong destination UUID requested. "
+                            "Local UUID: $0. Requested UUID: $1", local_uuid, req->dest_uuid()),
+              TabletServerErrorPB::WRONG_SERVER_UUID);
+    return;
+  }
+
+  std::shared_ptr<tablet::TabletPeer> tablet_peer;
+  Status s = tablet_manager_->GetTabletPeer(req->tablet_id(), &tablet_peer);
+  if (PREDICT_FALSE(!s.ok())) {
+    set_error(s, s.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                          : TabletServerErrorPB::TABLET_NOT_FOUND);
+    return;
+  }
+
+  tablet::RaftGroupStatePB state = tablet_peer->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    set_error(STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStateError(state)),
+              TabletServerErrorPB::TABLET_NOT_RUNNING);
+    return;
+  }
+
+  auto consensus = tablet_peer->shared_consensus();
+  if (!consensus) {
+    set_error(STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running"),
+              TabletServerErrorPB::TABLET_NOT_RUNNING);
+    return;
+  }
+
+  s = consensus->Update(req, resp, deadline);
+  if (PREDICT_FALSE(!s.ok())) {
+    set_error(s, TabletServerErrorPB::UNKNOWN_ERROR);
+    return;
+  }
+
+  auto tablet = tablet_peer->shared_tablet();
+  if (tablet) {
+    resp->set_num_sst_files(tablet->GetCurrentVersionNumSSTFiles());
+  }
+
+  resp->set_propagated_hybrid_time(tablet_peer->clock().Now().ToUint64());
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -2268,8 +2664,12 @@ void TabletServiceImpl::NoOp(const NoOpRequestPB *req,
 
 void TabletServiceImpl::Publish(
     const PublishRequestPB* req, PublishResponsePB* resp, rpc::RpcContext context) {
-  rpc::Publisher* publisher = server_->GetPublisher();
-  resp->set_num_clients_forwarded_to(publisher ? (*publisher)(req->channel(), req->message()) : 0);
+  Publisher* publisher = server_->GetPublisher();
+  if (publisher) {
+    (*publisher)(*req, resp);
+  } else {
+    resp->set_num_clients_forwarded_to(0);
+  }
   context.RespondSuccess();
 }
 
@@ -2382,6 +2782,26 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
 void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
                                    ImportDataResponsePB* resp,
                                    rpc::RpcContext context) {
+  if (req->replicated()) {
+    UpdateClock(*req, server_->Clock());
+
+    auto tablet = LookupLeaderTabletOrRespond(
+        server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
+    if (!tablet) {
+      return;
+    }
+
+    auto state = std::make_unique<tablet::ImportDataOperationState>(
+        tablet.peer->tablet(), req);
+    state->set_completion_callback(
+        MakeRpcOperationCompletionCallback(std::move(context), resp, server_->Clock()));
+
+    // Submit the import data op. The RPC will be responded to asynchronously.
+    tablet.peer->Submit(
+        std::make_unique<tablet::ImportDataOperation>(std::move(state)), tablet.leader_term);
+    return;
+  }
+
   auto peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
       server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
 
@@ -2437,6 +2857,26 @@ void TabletServiceImpl::TakeTransaction(const TakeTransactionRequestPB* req,
   context.RespondSuccess();
 }
 
+void TabletServiceImpl::AllocateSequenceValues(const AllocateSequenceValuesRequestPB* req,
+                                               AllocateSequenceValuesResponsePB* resp,
+                                               rpc::RpcContext context) {
+  if (!pg_sequence_cache_) {
+    // The backend updates the sequence itself.
+    context.RespondSuccess();
+    return;
+  }
+  auto range = pg_sequence_cache_->Allocate(&server_->tablet_manager()->client(), *req);
+  if (!range.ok()) {
+    context.RespondFailure(range.status());
+    return;
+  }
+  if (*range) {
+    resp->set_first_value((*range)->first_value);
+    resp->set_last_value((*range)->last_value);
+  }
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::Shutdown() {
 }
 
@@ -54,6 +54,8 @@ class HybridTime;
 
 namespace tserver {
 
+class PgCatalogCache;
+class PgSequenceCache;
 class ReadCompletionTask;
 class TabletPeerLookupIf;
 class TabletServer;
@@ -64,7 +66,11 @@ class TabletServiceImpl : public TabletServerServiceIf {
  public:
   typedef std::vector<tablet::TabletPeerPtr> TabletPeers;
 
-  explicit TabletServiceImpl(TabletServerIf* server);
+  // The pg_catalog_cache is used to serve reads of the YSQL system catalog sent by the postgres
+  // backends of this node, and the pg_sequence_cache to allocate them sequence values, nullptr if
+  // such requests are not expected.
+  explicit TabletServiceImpl(TabletServerIf* server, PgCatalogCache* pg_catalog_cache = nullptr,
+                             PgSequenceCache* pg_sequence_cache = nullptr);
 
   void Write(const WriteRequestPB* req, WriteResponsePB* resp, rpc::RpcContext context) override;
 
@@ -104,6 +110,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                          UpdateTransactionResponsePB* resp,
                          rpc::RpcContext context) override;
 
+  void HeartbeatTransactions(const HeartbeatTransactionsRequestPB* req,
+                             HeartbeatTransactionsResponsePB* resp,
+                             rpc::RpcContext context) override;
+
   void GetTransactionStatus(const GetTransactionStatusRequestPB* req,
                             GetTransactionStatusResponsePB* resp,
                             rpc::RpcContext context) override;
@@ -132,6 +142,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                        TakeTransactionResponsePB* resp,
                        rpc::RpcContext context) override;
 
+  void AllocateSequenceValues(const AllocateSequenceValuesRequestPB* req,
+                              AllocateSequenceValuesResponsePB* resp,
+                              rpc::RpcContext context) override;
+
   void Shutdown() override;
 
  private:
@@ -174,7 +188,13 @@ class TabletServiceImpl : public TabletServerServiceIf {
   // Sends response, etc.
   void CompleteRead(ReadContext* read_context);
 
+  // Serves the read of the YSQL system catalog from pg_catalog_cache_, or forwards it to the
+  // master leader and caches its response.
+  void ReadCatalog(const ReadRequestPB* req, ReadResponsePB* resp, rpc::RpcContext context);
+
   TabletServerIf *const server_;
+  PgCatalogCache* const pg_catalog_cache_;
+  PgSequenceCache* const pg_sequence_cache_;
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -186,6 +206,10 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
                     CreateTabletResponsePB* resp,
                     rpc::RpcContext context) override;
 
+  void CreateTablets(const CreateTabletsRequestPB* req,
+                     CreateTabletsResponsePB* resp,
+                     rpc::RpcContext context) override;
+
   void DeleteTablet(const DeleteTabletRequestPB* req,
                     DeleteTabletResponsePB* resp,
                     rpc::RpcContext context) override;
@@ -237,6 +261,9 @@ class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
       rpc::RpcContext context) override;
 
  private:
+  // Creates the tablet of the request, sets code to the error code of the returned error.
+  CHECKED_STATUS DoCreateTablet(const CreateTabletRequestPB& req, TabletServerErrorPB::Code* code);
+
   TabletServer* server_;
 
   // Used to implement wait/signal mechanism for backfill requests.
@@ -258,6 +285,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB* req,
+                                consensus::MultiRaftConsensusResponsePB* resp,
+                                rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -295,6 +326,11 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                     rpc::RpcContext context) override;
 
  private:
+  // Applies a single request of MultiRaftUpdateConsensus, errors are reported in the response.
+  void UpdateConsensusInBatch(consensus::ConsensusRequestPB* req,
+                              consensus::ConsensusResponsePB* resp,
+                              CoarseTimePoint deadline);
+
   TabletPeerLookupIf* tablet_manager_;
 };
 
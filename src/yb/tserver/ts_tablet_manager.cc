@@ -56,6 +56,8 @@
 #include "yb/consensus/raft_consensus.h"
 
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/lsm_metrics.h"
 
 #include "yb/fs/fs_manager.h"
 
@@ -79,8 +81,10 @@
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/tablet_options.h"
+#include "yb/tablet/tablet_snapshots.h"
 #include "yb/tablet/operations/split_operation.h"
 
+#include "yb/tserver/data_dir_load.h"
 #include "yb/tserver/heartbeater.h"
 #include "yb/tserver/remote_bootstrap_client.h"
 #include "yb/tserver/remote_bootstrap_session.h"
@@ -183,12 +187,27 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
 
+DEFINE_bool(global_memstore_flush_by_size_and_age, true,
+            "When the global memstore limit is reached, flush the tablet with the largest product "
+            "of its mutable memtables size and the age of their oldest write, instead of the "
+            "tablet with the oldest write. Flushing larger memtables produces fewer small SST "
+            "files, while old writes still get flushed so that the log of their tablets could be "
+            "garbage collected.");
+TAG_FLAG(global_memstore_flush_by_size_and_age, advanced);
+TAG_FLAG(global_memstore_flush_by_size_and_age, runtime);
+
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
              "This defaults to -1 for system auto-generated default, which would use "
              "FLAGS_db_block_cache_ram_percentage to select a percentage of the total memory as "
              "the default size for the shared block cache. Value of -2 disables block cache.");
 
+DEFINE_int64(db_block_cache_compressed_size_bytes, 0,
+             "Size of cross-tablet shared cache of compressed RocksDB data blocks (in bytes). "
+             "It is consulted on a miss of the block cache before reading the block from the "
+             "file, so more data fits in memory at the cost of decompression. 0 disables it.");
+TAG_FLAG(db_block_cache_compressed_size_bytes, advanced);
+
 DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
@@ -202,6 +221,26 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_int32(data_dir_load_refresh_interval_sec, 60,
+             "How often the free space and I/O of the data directories are refreshed, when there "
+             "are more than one. New tablets are not placed in the data directories more loaded "
+             "than the least loaded one by more than data_dir_load_imbalance_threshold. 0 "
+             "disables the tracking.");
+TAG_FLAG(data_dir_load_refresh_interval_sec, advanced);
+
+DEFINE_double(data_dir_load_imbalance_threshold, 0.1,
+              "Difference of the load scores of the data directories, each between 0 and "
+              "1 + data_dir_load_io_weight, tolerated by the tablet placement and rebalancing.");
+TAG_FLAG(data_dir_load_imbalance_threshold, advanced);
+TAG_FLAG(data_dir_load_imbalance_threshold, runtime);
+
+DEFINE_bool(enable_data_dir_rebalancing, false,
+            "Move a tablet from the most to the least loaded data directory on each refresh of "
+            "their load, if they differ by more than data_dir_load_imbalance_threshold. The "
+            "tablet is unavailable while its files are moved.");
+TAG_FLAG(enable_data_dir_rebalancing, advanced);
+TAG_FLAG(enable_data_dir_rebalancing, runtime);
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -308,7 +347,8 @@ void TSTabletManager::MaybeFlushTablet() {
       LOG(INFO)
           << TabletLogPrefix(tablet_to_flush->tablet_id())
           << "Flushing tablet with oldest memstore write at "
-          << tablet_to_flush->tablet()->OldestMutableMemtableWriteHybridTime();
+          << tablet_to_flush->tablet()->OldestMutableMemtableWriteHybridTime()
+          << ", memstore size: " << tablet_to_flush->tablet()->MutableMemtablesSize();
       WARN_NOT_OK(
           tablet_to_flush->tablet()->Flush(
               tablet::FlushMode::kAsync, tablet::FlushFlags::kAll, flush_tick),
@@ -320,25 +360,93 @@ void TSTabletManager::MaybeFlushTablet() {
   }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all tablet memstores are
-// empty or about to flush.
+// Only called from the data dir load background task.
+void TSTabletManager::UpdateDataDirLoad() {
+  std::vector<DataDirLoad> dirs;
+  for (const auto& dir : fs_manager_->GetDataRootDirs()) {
+    auto free_bytes = fs_manager_->env()->GetFreeSpaceBytes(dir);
+    if (!free_bytes.ok()) {
+      YB_LOG_EVERY_N_SECS(WARNING, 60) << "Failed to get free space of " << dir << ": "
+                                       << free_bytes.status();
+      continue;
+    }
+    DataDirLoad load;
+    load.dir = dir;
+    load.free_bytes = *free_bytes;
+    dirs.push_back(std::move(load));
+  }
+
+  std::vector<TabletDataDirLoad> tablets;
+  for (const auto& peer : GetTabletPeers()) {
+    const auto tablet = peer->shared_tablet();
+    if (!tablet || peer->tablet_metadata()->table_id() == master::kSysCatalogTableId) {
+      continue;
+    }
+    const auto& lsm_metrics = tablet->lsm_metrics();
+    tablets.push_back(TabletDataDirLoad{
+        peer->tablet_id(), peer->tablet_metadata()->data_root_dir(),
+        tablet->GetCurrentVersionSstFilesSize(),
+        lsm_metrics.flushed_bytes() + lsm_metrics.compaction_output_bytes() +
+            lsm_metrics.compaction_input_bytes()});
+  }
+
+  data_dir_load_->Update(std::move(dirs), tablets, MonoTime::Now());
+
+  if (!FLAGS_enable_data_dir_rebalancing) {
+    return;
+  }
+  auto move = data_dir_load_->PickMove(FLAGS_data_dir_load_imbalance_threshold);
+  if (!move) {
+    return;
+  }
+  LOG(INFO) << TabletLogPrefix(move->tablet_id) << "Moving tablet data from " << move->from
+            << " to " << move->to << " to balance the data dir load";
+  WARN_NOT_OK(MoveTabletToDataDir(move->tablet_id, move->to),
+              Format("Failed to move tablet $0 to $1", move->tablet_id, move->to));
+}
+
+// Return the tablet to flush to free memstore memory, or nullptr if all tablet memstores are
+// empty or about to flush. See global_memstore_flush_by_size_and_age for how it is picked.
 TabletPeerPtr TSTabletManager::TabletToFlush() {
+  const bool by_size_and_age = FLAGS_global_memstore_flush_by_size_and_age;
+  const auto now = server_->clock()->Now();
   SharedLock<RWMutex> lock(lock_); // For using the tablet map
   HybridTime oldest_write_in_memstores = HybridTime::kMax;
+  double max_score = 0;
   TabletPeerPtr tablet_to_flush;
   for (const TabletMap::value_type& entry : tablet_map_) {
     const auto tablet = entry.second->shared_tablet();
     if (tablet) {
       const auto ht = tablet->OldestMutableMemtableWriteHybridTime();
-      if (ht.ok()) {
+      if (!ht.ok()) {
+        YB_LOG_EVERY_N_SECS(WARNING, 5) << Format(
+            "Failed to get oldest mutable memtable write ht for tablet $0: $1",
+            tablet->tablet_id(), ht.status());
+        continue;
+      }
+      if (!by_size_and_age) {
         if (*ht < oldest_write_in_memstores) {
           oldest_write_in_memstores = *ht;
           tablet_to_flush = entry.second;
         }
-      } else {
-        YB_LOG_EVERY_N_SECS(WARNING, 5) << Format(
-            "Failed to get oldest mutable memtable write ht for tablet $0: $1",
-            tablet->tablet_id(), ht.status());
+        continue;
+      }
+      if (*ht == HybridTime::kMax) {
+        // The memstores are empty.
+        continue;
+      }
+      const auto size = tablet->MutableMemtablesSize();
+      if (!size.ok()) {
+        continue;
+      }
+      // Writes of the last second weigh the same, so that the largest of the fresh memstores is
+      // picked.
+      const double age_sec = std::max(
+          now.PhysicalDiff(*ht) / static_cast<double>(MonoTime::kMicrosecondsPerSecond), 1.0);
+      const double score = *size * age_sec;
+      if (score > max_score) {
+        max_score = score;
+        tablet_to_flush = entry.second;
       }
     }
   }
@@ -444,17 +552,38 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     block_cache_size_bytes = total_ram_avail * FLAGS_db_block_cache_size_percentage / 100;
   }
 
+  const bool block_cache_enabled = FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled;
+  const int64_t compressed_block_cache_size_bytes =
+      block_cache_enabled ? std::max<int64_t>(FLAGS_db_block_cache_compressed_size_bytes, 0) : 0;
+
+  // Compressed blocks are read with the BlockBasedTable tracker, so its limit covers both caches.
   block_based_table_mem_tracker_ = MemTracker::FindOrCreateTracker(
-      block_cache_size_bytes, "BlockBasedTable", server_->mem_tracker());
+      block_cache_size_bytes + compressed_block_cache_size_bytes, "BlockBasedTable",
+      server_->mem_tracker());
 
-  if (FLAGS_db_block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                       FLAGS_db_block_cache_num_shard_bits);
+  if (block_cache_enabled) {
+    tablet_options_.block_cache = docdb::CreateBlockCache(block_cache_size_bytes,
+                                                         FLAGS_db_block_cache_num_shard_bits);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(tablet_options_.block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
   }
 
+  if (compressed_block_cache_size_bytes > 0) {
+    auto compressed_cache = docdb::CreateBlockCache(compressed_block_cache_size_bytes,
+                                                    FLAGS_db_block_cache_num_shard_bits);
+    tablet_options_.block_cache_compressed = compressed_cache;
+    // Memory of compressed blocks is already consumed from the BlockBasedTable tracker, so this
+    // tracker only reports it and is not added to the parent.
+    compressed_block_cache_mem_tracker_ = MemTracker::CreateTracker(
+        compressed_block_cache_size_bytes, "CompressedBlockCache",
+        [compressed_cache]() -> int64_t { return compressed_cache->GetUsage(); },
+        block_based_table_mem_tracker_, AddToParent::kFalse);
+    compressed_block_cache_gc_ = std::make_shared<LRUCacheGC>(compressed_cache);
+    // Added after the block cache collector, so uncompressed blocks are evicted first.
+    block_based_table_mem_tracker_->AddGarbageCollector(compressed_block_cache_gc_);
+  }
+
   auto log_cache_mem_tracker = consensus::LogCache::GetServerMemTracker(server_->mem_tracker());
   log_cache_gc_ = std::make_shared<FunctorGC>(
       std::bind(&TSTabletManager::LogCacheGC, this, log_cache_mem_tracker.get(), _1));
@@ -486,6 +615,15 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
   }
+
+  if (FLAGS_data_dir_load_refresh_interval_sec > 0 && fs_manager_->GetDataRootDirs().size() > 1) {
+    data_dir_load_ = std::make_unique<DataDirLoadTracker>(metric_registry_);
+    data_dir_load_task_.reset(new BackgroundTask(
+      std::function<void()>([this](){ UpdateDataDirLoad(); }),
+      "tablet manager",
+      "data dir load bgtask",
+      std::chrono::seconds(FLAGS_data_dir_load_refresh_interval_sec)));
+  }
 }
 
 TSTabletManager::~TSTabletManager() {
@@ -554,11 +692,24 @@ Status TSTabletManager::Init() {
         meta->wal_root_dir());
     metas.push_back(meta);
   }
+
+  // Bootstrap tablets that are likely to become leaders first, i.e. the ones where this server
+  // voted for itself in the last known term. So leaders are available as soon as possible, while
+  // the rest of the tablets are still bootstrapping.
+  auto first_other = std::stable_partition(
+      metas.begin(), metas.end(), [this](const RaftGroupMetadataPtr& meta) {
+    std::unique_ptr<ConsensusMetadata> cmeta;
+    auto status = ConsensusMetadata::Load(
+        fs_manager_, meta->raft_group_id(), fs_manager_->uuid(), &cmeta);
+    return status.ok() && cmeta->has_voted_for() && cmeta->voted_for() == fs_manager_->uuid();
+  });
+  LOG(INFO) << "Tablets likely to become leaders: " << (first_other - metas.begin());
   MonoDelta elapsed = MonoTime::Now().GetDeltaSince(start);
   LOG(INFO) << "Loaded metadata for " << tablet_ids.size() << " tablet in "
             << elapsed.ToMilliseconds() << " ms";
 
-  // Now submit the "Open" task for each.
+  // Now submit the "Open" task for each. The tasks open the tablets in the order of
+  // tablets_to_open_, so that the tablets that requests arrive for could be opened first.
   for (const RaftGroupMetadataPtr& meta : metas) {
     scoped_refptr<TransitionInProgressDeleter> deleter;
     {
@@ -568,8 +719,12 @@ Status TSTabletManager::Init() {
     }
 
     TabletPeerPtr tablet_peer = VERIFY_RESULT(CreateAndRegisterTabletPeer(meta, NEW_PEER));
+    {
+      std::lock_guard<std::mutex> lock(tablets_to_open_mutex_);
+      tablets_to_open_.push_back(TabletToOpen{meta, deleter});
+    }
     RETURN_NOT_OK(open_tablet_pool_->SubmitFunc(
-        std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+        std::bind(&TSTabletManager::OpenNextTablet, this)));
   }
 
   {
@@ -581,6 +736,10 @@ Status TSTabletManager::Init() {
     RETURN_NOT_OK(background_task_->Init());
   }
 
+  if (data_dir_load_task_) {
+    RETURN_NOT_OK(data_dir_load_task_->Init());
+  }
+
   return Status::OK();
 }
 
@@ -1287,6 +1446,34 @@ Status TSTabletManager::OpenTabletMeta(const string& tablet_id,
   return Status::OK();
 }
 
+void TSTabletManager::OpenNextTablet() {
+  TabletToOpen tablet;
+  {
+    std::lock_guard<std::mutex> lock(tablets_to_open_mutex_);
+    if (tablets_to_open_.empty()) {
+      return;
+    }
+    tablet = std::move(tablets_to_open_.front());
+    tablets_to_open_.pop_front();
+  }
+  OpenTablet(tablet.meta, tablet.deleter);
+}
+
+void TSTabletManager::TabletOpenRequested(const std::string& tablet_id) {
+  std::lock_guard<std::mutex> lock(tablets_to_open_mutex_);
+  auto it = std::find_if(
+      tablets_to_open_.begin(), tablets_to_open_.end(), [&tablet_id](const TabletToOpen& tablet) {
+    return tablet.meta->raft_group_id() == tablet_id;
+  });
+  if (it == tablets_to_open_.begin() || it == tablets_to_open_.end()) {
+    return;
+  }
+  LOG_WITH_PREFIX(INFO) << "Opening tablet " << tablet_id << " next, because it was requested";
+  auto tablet = std::move(*it);
+  tablets_to_open_.erase(it);
+  tablets_to_open_.push_front(std::move(tablet));
+}
+
 void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
                                  const scoped_refptr<TransitionInProgressDeleter>& deleter) {
   string tablet_id = meta->raft_group_id();
@@ -1410,6 +1597,10 @@ void TSTabletManager::StartShutdown() {
     background_task_->Shutdown();
   }
 
+  if (data_dir_load_task_) {
+    data_dir_load_task_->Shutdown();
+  }
+
   {
     std::lock_guard<RWMutex> lock(lock_);
     switch (state_) {
@@ -1458,6 +1649,10 @@ void TSTabletManager::StartShutdown() {
 
   // Shut down the bootstrap pool, so new tablets are registered after this point.
   open_tablet_pool_->Shutdown();
+  {
+    std::lock_guard<std::mutex> lock(tablets_to_open_mutex_);
+    tablets_to_open_.clear();
+  }
 
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
@@ -1897,6 +2092,12 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   }
   LOG(INFO) << "Get and update data/wal directory assignment map for table: " \
             << table_id << " and tablet " << tablet_id;
+  // Skip the data directories that are much more loaded than the others.
+  std::unordered_set<std::string> data_dir_candidates;
+  if (data_dir_load_) {
+    data_dir_candidates = data_dir_load_->PlacementCandidates(
+        FLAGS_data_dir_load_imbalance_threshold);
+  }
   MutexLock l(dir_assignment_lock_);
   // Initialize the map if the directory mapping does not exist.
   auto data_root_dirs = fs_manager->GetDataRootDirs();
@@ -1914,11 +2115,22 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   string min_dir;
   uint64_t min_dir_count = kuint64max;
   for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
+    if (!data_dir_candidates.empty() && data_dir_candidates.count(it->first) == 0) {
+      continue;
+    }
     if (min_dir_count > it->second.size()) {
       min_dir = it->first;
       min_dir_count = it->second.size();
     }
   }
+  if (min_dir.empty()) {
+    for (auto it = data_assignment_value_map.begin(); it != data_assignment_value_map.end(); ++it) {
+      if (min_dir_count > it->second.size()) {
+        min_dir = it->first;
+        min_dir_count = it->second.size();
+      }
+    }
+  }
   *data_root_dir = min_dir;
   // Increment the count for min_dir.
   auto data_assignment_value_iter = table_data_assignment_map_[table_id].find(min_dir);
@@ -2084,6 +2296,93 @@ void TSTabletManager::UnregisterDataWalDir(const string& table_id,
   }
 }
 
+Status TSTabletManager::MoveTabletToDataDir(
+    const TabletId& tablet_id, const std::string& data_root_dir) {
+  TabletPeerPtr tablet_peer;
+  scoped_refptr<TransitionInProgressDeleter> deleter;
+  {
+    std::lock_guard<RWMutex> lock(lock_);
+    boost::optional<TabletServerErrorPB::Code> error_code;
+    RETURN_NOT_OK(CheckRunningUnlocked(&error_code));
+    if (!LookupTabletUnlocked(tablet_id, &tablet_peer)) {
+      return STATUS(NotFound, "Tablet not found", tablet_id);
+    }
+    RETURN_NOT_OK(StartTabletStateTransitionUnlocked(tablet_id, "moving tablet data", &deleter));
+  }
+
+  const string kLogPrefix = TabletLogPrefix(tablet_id);
+  auto meta = tablet_peer->tablet_metadata();
+  if (tablet_peer->state() != RaftGroupStatePB::RUNNING) {
+    return STATUS_FORMAT(IllegalState, "Tablet is not running: $0",
+                         RaftGroupStatePB_Name(tablet_peer->state()));
+  }
+  const auto old_data_root_dir = meta->data_root_dir();
+  const auto old_rocksdb_dir = meta->rocksdb_dir();
+  if (old_data_root_dir == data_root_dir) {
+    return Status::OK();
+  }
+  if (!HasPrefixString(old_rocksdb_dir, old_data_root_dir)) {
+    return STATUS_FORMAT(IllegalState, "RocksDB dir $0 is not in data root dir $1",
+                         old_rocksdb_dir, old_data_root_dir);
+  }
+  const auto new_rocksdb_dir = data_root_dir + old_rocksdb_dir.substr(old_data_root_dir.size());
+  std::vector<std::pair<std::string, std::string>> dirs = {
+    {old_rocksdb_dir, new_rocksdb_dir},
+    {old_rocksdb_dir + tablet::kIntentsDBSuffix, new_rocksdb_dir + tablet::kIntentsDBSuffix},
+  };
+  auto* env = fs_manager_->env();
+  const auto old_snapshots_dir = tablet::TabletSnapshots::SnapshotsDirName(old_rocksdb_dir);
+  if (env->FileExists(old_snapshots_dir)) {
+    dirs.emplace_back(old_snapshots_dir,
+                      tablet::TabletSnapshots::SnapshotsDirName(new_rocksdb_dir));
+  }
+
+  // The shutdown flushes the tablet, and the writes it could miss are replayed from the log when
+  // the tablet is reopened. The log stays where it is.
+  LOG(INFO) << kLogPrefix << "Moving tablet data from " << old_rocksdb_dir << " to "
+            << new_rocksdb_dir;
+  tablet_peer->Shutdown(tablet::IsDropTable::kFalse);
+
+  auto status = [&]() -> Status {
+    RETURN_NOT_OK(env->CreateDirs(DirName(new_rocksdb_dir)));
+    for (const auto& dir : dirs) {
+      if (!env->FileExists(dir.first)) {
+        continue;
+      }
+      RETURN_NOT_OK_PREPEND(
+          CopyDirectory(env, dir.first, dir.second, UseHardLinks::kTrue, CreateIfMissing::kTrue),
+          Format("Failed to copy $0 to $1", dir.first, dir.second));
+    }
+    RETURN_NOT_OK(env->SyncDir(DirName(new_rocksdb_dir)));
+    meta->set_rocksdb_dir(new_rocksdb_dir);
+    return meta->Flush();
+  }();
+
+  if (!status.ok()) {
+    LOG(WARNING) << kLogPrefix << "Failed to move tablet data, reopening it from "
+                 << old_rocksdb_dir << ": " << status;
+    meta->set_rocksdb_dir(old_rocksdb_dir);
+  }
+  // Delete the partial copy on failure, and the old files on success.
+  for (const auto& dir : dirs) {
+    const auto& dir_to_delete = status.ok() ? dir.first : dir.second;
+    if (env->FileExists(dir_to_delete)) {
+      WARN_NOT_OK(env->DeleteRecursively(dir_to_delete),
+                  kLogPrefix + "Failed to delete " + dir_to_delete);
+    }
+  }
+  if (status.ok()) {
+    const auto wal_root_dir = meta->wal_root_dir();
+    UnregisterDataWalDir(meta->table_id(), tablet_id, old_data_root_dir, wal_root_dir);
+    RegisterDataAndWalDir(fs_manager_, meta->table_id(), tablet_id, data_root_dir, wal_root_dir);
+  }
+
+  TabletPeerPtr new_peer = VERIFY_RESULT(CreateAndRegisterTabletPeer(meta, REPLACEMENT_PEER));
+  RETURN_NOT_OK(
+      open_tablet_pool_->SubmitFunc(std::bind(&TSTabletManager::OpenTablet, this, meta, deleter)));
+  return status;
+}
+
 client::YBClient& TSTabletManager::client() {
   return *async_client_init_->client();
 }
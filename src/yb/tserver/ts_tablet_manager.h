@@ -32,7 +32,9 @@
 #ifndef YB_TSERVER_TS_TABLET_MANAGER_H
 #define YB_TSERVER_TS_TABLET_MANAGER_H
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -86,6 +88,7 @@ class TabletReportPB;
 } // namespace master
 
 namespace tserver {
+class DataDirLoadTracker;
 class TabletServer;
 class TsTabletManagerListener {
  public:
@@ -203,6 +206,8 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
       const std::string& tablet_id,
       std::shared_ptr<tablet::TabletPeer>* tablet_peer) const override;
 
+  void TabletOpenRequested(const std::string& tablet_id) override;
+
   const NodeInstancePB& NodeInstance() const override;
 
   CHECKED_STATUS GetRegistration(ServerRegistrationPB* reg) const override;
@@ -292,6 +297,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
                             const std::string& data_root_dir,
                             const std::string& wal_root_dir);
 
+  // Moves the data of the running tablet to another data root dir. The tablet is shut down while
+  // its files are linked or copied, and then reopened from the new location.
+  CHECKED_STATUS MoveTabletToDataDir(const TabletId& tablet_id, const std::string& data_root_dir);
+
   bool IsTabletInTransition(const std::string& tablet_id) const;
 
   TabletServer* server() { return server_; }
@@ -301,6 +310,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Flush some tablet if the memstore memory limit is exceeded
   void MaybeFlushTablet();
 
+  // Refreshes the load of the data root dirs, and moves a tablet out of the most loaded one if
+  // enable_data_dir_rebalancing is set.
+  void UpdateDataDirLoad();
+
   client::YBClient& client();
 
   tablet::TabletOptions* TEST_tablet_options() { return &tablet_options_; }
@@ -373,6 +386,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   void OpenTablet(const scoped_refptr<tablet::RaftGroupMetadata>& meta,
                   const scoped_refptr<TransitionInProgressDeleter>& deleter);
 
+  // Opens the first of tablets_to_open_.
+  void OpenNextTablet();
+
   // Open a tablet whose metadata has already been loaded.
   void BootstrapAndInitTablet(const scoped_refptr<tablet::RaftGroupMetadata>& meta,
                               std::shared_ptr<tablet::TabletPeer>* peer);
@@ -491,6 +507,17 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Thread pool used to open the tablets async, whether bootstrap is required or not.
   std::unique_ptr<ThreadPool> open_tablet_pool_;
 
+  struct TabletToOpen {
+    scoped_refptr<tablet::RaftGroupMetadata> meta;
+    scoped_refptr<TransitionInProgressDeleter> deleter;
+  };
+
+  // Tablets found on startup that are waiting for open_tablet_pool_ to open them, in the order
+  // they are opened. Tablets that requests arrive for are moved to the front. Protected by
+  // tablets_to_open_mutex_.
+  std::deque<TabletToOpen> tablets_to_open_;
+  std::mutex tablets_to_open_mutex_;
+
   // Thread pool for preparing transactions, shared between all tablets.
   std::unique_ptr<ThreadPool> tablet_prepare_pool_;
 
@@ -509,6 +536,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Tracks the free space and I/O of the data root dirs, when there are more than one.
+  std::unique_ptr<DataDirLoadTracker> data_dir_load_;
+  std::unique_ptr<BackgroundTask> data_dir_load_task_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -517,9 +548,11 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   TabletPeers shutting_down_peers_;
 
   std::shared_ptr<GarbageCollector> block_based_table_gc_;
+  std::shared_ptr<GarbageCollector> compressed_block_cache_gc_;
   std::shared_ptr<GarbageCollector> log_cache_gc_;
 
   std::shared_ptr<MemTracker> block_based_table_mem_tracker_;
+  std::shared_ptr<MemTracker> compressed_block_cache_mem_tracker_;
 
   std::atomic<int32_t> num_tablets_being_remote_bootstrapped_{0};
 
@@ -34,30 +34,41 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include <gflags/gflags.h>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/lsm_metrics.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/rocksdb/statistics.h"
 #include "yb/server/webui_util.h"
 #include "yb/tablet/maintenance_manager.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
+#include "yb/tablet/tablet_hot_keys.h"
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/tablet/tablet_slow_ops.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/timestamp.h"
 #include "yb/util/url-coding.h"
 
+DECLARE_int32(tablet_slow_op_threshold_ms);
+
 namespace {
 
 // A struct representing some information about a tablet peer.
@@ -148,6 +159,9 @@ using namespace std::placeholders;  // NOLINT(build/namespaces)
 
 namespace {
 
+// Number of the hottest keys of each tablet shown on the tablets page.
+constexpr size_t kTabletsPageHotKeys = 3;
+
 bool GetTabletID(const Webserver::WebRequest& req, string* id, std::stringstream *out) {
   if (!FindCopy(req.parsed_args, "id", id)) {
     // TODO: webserver should give a way to return a non-200 response code
@@ -338,6 +352,14 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
   server->RegisterPathHandler(
       "/tablets", "Tablets", std::bind(&TabletServerPathHandlers::HandleTabletsPage, this, _1, _2),
       true /* styled */, true /* is_on_nav_bar */, "fa fa-server");
+  server->RegisterPathHandler(
+      "/tablet-lsm", "",
+      std::bind(&TabletServerPathHandlers::HandleTabletLsmPage, this, _1, _2), true /* styled */,
+      false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/slow-ops", "Slow Operations",
+      std::bind(&TabletServerPathHandlers::HandleSlowOpsPage, this, _1, _2), true /* styled */,
+      false /* is_on_nav_bar */);
   RegisterTabletPathHandler(server, tserver_, "/tablet", &HandleTabletPage);
   server->RegisterPathHandler(
       "/operations", "",
@@ -550,8 +572,8 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
   *output << "<table class='table table-striped'>\n";
   *output << "  <tr><th>Table name</th><th>Table UUID</th><th>Tablet ID</th>"
       "<th>Partition</th>"
-      "<th>State</th><th>Num SST Files</th><th>On-disk size</th><th>RaftConfig</th>"
-      "<th>Last status</th></tr>\n";
+      "<th>State</th><th>Num SST Files</th><th>On-disk size</th><th>Memory</th>"
+      "<th>RaftConfig</th><th>Last status</th><th>Hot keys</th></tr>\n";
   for (const std::shared_ptr<TabletPeer>& peer : peers) {
     TabletStatusPB status;
     peer->GetTabletStatusPB(&status);
@@ -574,14 +596,16 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
 
     auto tablet = peer->shared_tablet();
     uint64_t num_sst_files = (tablet) ? tablet->GetCurrentVersionNumSSTFiles() : 0;
+    // Memory tracked for the tablet, mostly by its memtables.
+    string memory = (tablet)
+        ? HumanReadableNumBytes::ToString(tablet->mem_tracker()->consumption()) : "";
 
-    // TODO: would be nice to include some other stuff like memory usage
     shared_ptr<consensus::Consensus> consensus = peer->shared_consensus();
     (*output) << Substitute(
         // Table name, UUID of table, tablet id, partition
         "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td>"
-        // State, num_sst_files, on-disk size, consensus configuration, last status
-        "<td>$4</td><td>$8</td><td>$5</td><td>$6</td><td>$7</td></tr>\n",
+        // State, num_sst_files, on-disk size, memory, consensus configuration, last status
+        "<td>$4</td><td>$8</td><td>$5</td><td>$9</td><td>$6</td><td>$7</td>",
         EscapeForHtmlToString(table_name),  // $0
         EscapeForHtmlToString(table_id),  // $1
         tablet_id_or_link,  // $2
@@ -590,7 +614,157 @@ void TabletServerPathHandlers::HandleTabletsPage(const Webserver::WebRequest& re
         consensus ? ConsensusStatePBToHtml(consensus->ConsensusState(CONSENSUS_CONFIG_COMMITTED))
                   : "",  // $6
         EscapeForHtmlToString(status.last_status()),  // $7
-        num_sst_files); // $8
+        num_sst_files,  // $8
+        memory);  // $9
+    // The hottest rows, with their estimated operations per second.
+    (*output) << "<td>";
+    if (tablet) {
+      for (const auto& hot_key : tablet->hot_keys().GetHotKeys(kTabletsPageHotKeys)) {
+        (*output) << EscapeForHtmlToString(hot_key.key)
+                  << StringPrintf(": %.1f/s<br>", hot_key.ops_per_sec);
+      }
+    }
+    (*output) << "</td></tr>\n";
+  }
+  *output << "</table>\n";
+}
+
+void TabletServerPathHandlers::HandleTabletLsmPage(const Webserver::WebRequest& req,
+                                                   std::stringstream* output) {
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+  std::sort(peers.begin(), peers.end(), &CompareByTabletId);
+
+  struct TableLsm {
+    size_t num_tablets = 0;
+    uint64_t total_bytes = 0;
+    uint64_t flushed_bytes = 0;
+    uint64_t compaction_output_bytes = 0;
+    size_t max_sorted_runs = 0;
+  };
+  std::map<string, TableLsm> tables;
+
+  *output << "<h1>LSM Trees of Tablets</h1>\n";
+  *output << "<p>A point read consults a file of each sorted run, unless skipped by the bloom "
+             "filter. The write amplification is since the tablet was opened.</p>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablet ID</th><th>Sorted runs</th>"
+             "<th>Shape, newest first</th><th>Size</th><th>Write amplification</th>"
+             "<th>Space amplification</th><th>Compaction read</th><th>Compaction written</th>"
+             "<th>Stall time</th></tr>\n";
+  for (const auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    const auto& lsm = tablet->lsm_metrics();
+    const auto shape = lsm.shape();
+    const auto& statistics = tablet->rocksdb_statistics();
+    const auto stall_micros = statistics ? statistics->getTickerCount(rocksdb::STALL_MICROS) : 0;
+    const auto table_name = peer->tablet_metadata()->table_name();
+
+    *output << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>"
+        "<td>$7</td><td>$8</td><td>$9</td></tr>\n",
+        EscapeForHtmlToString(table_name),
+        TabletLink(peer->tablet_id()),
+        shape.sorted_runs.size(),
+        EscapeForHtmlToString(shape.ToString()),
+        HumanReadableNumBytes::ToString(shape.total_bytes),
+        StringPrintf("%.2f", lsm.WriteAmplification()),
+        StringPrintf("%.2f", shape.SpaceAmplification()),
+        HumanReadableNumBytes::ToString(lsm.compaction_input_bytes()),
+        HumanReadableNumBytes::ToString(lsm.compaction_output_bytes()),
+        HumanReadableElapsedTime::ToShortString(stall_micros * 1e-6));
+
+    auto& table = tables[table_name];
+    ++table.num_tablets;
+    table.total_bytes += shape.total_bytes;
+    table.flushed_bytes += lsm.flushed_bytes();
+    table.compaction_output_bytes += lsm.compaction_output_bytes();
+    table.max_sorted_runs = std::max(table.max_sorted_runs, shape.sorted_runs.size());
+  }
+  *output << "</table>\n";
+
+  *output << "<h2>Tables</h2>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Table name</th><th>Tablets</th><th>Max sorted runs</th><th>Size</th>"
+             "<th>Write amplification</th></tr>\n";
+  for (const auto& name_and_table : tables) {
+    const auto& table = name_and_table.second;
+    const double write_amplification = table.flushed_bytes == 0 ? 1 :
+        static_cast<double>(table.flushed_bytes + table.compaction_output_bytes) /
+            table.flushed_bytes;
+    *output << Substitute(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td></tr>\n",
+        EscapeForHtmlToString(name_and_table.first),
+        table.num_tablets,
+        table.max_sorted_runs,
+        HumanReadableNumBytes::ToString(table.total_bytes),
+        StringPrintf("%.2f", write_amplification));
+  }
+  *output << "</table>\n";
+}
+
+void TabletServerPathHandlers::HandleSlowOpsPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  const size_t limit = std::max(
+      ParseLeadingInt32Value(FindWithDefault(req.parsed_args, "limit", "100").c_str(), 100), 1);
+
+  struct TabletSlowOp {
+    string table_name;
+    string tablet_id;
+    tablet::SlowOpPB op;
+  };
+  vector<TabletSlowOp> ops;
+  vector<std::shared_ptr<TabletPeer>> peers;
+  tserver_->tablet_manager()->GetTabletPeers(&peers);
+  for (const auto& peer : peers) {
+    auto tablet = peer->shared_tablet();
+    if (!tablet) {
+      continue;
+    }
+    const auto table_name = peer->tablet_metadata()->table_name();
+    for (auto& op : tablet->slow_ops().Get()) {
+      ops.push_back(TabletSlowOp{table_name, peer->tablet_id(), std::move(op)});
+    }
+  }
+  std::sort(ops.begin(), ops.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.op.start_time_us() > rhs.op.start_time_us();
+  });
+  if (ops.size() > limit) {
+    ops.resize(limit);
+  }
+
+  const auto micros = [](uint64_t value) {
+    return HumanReadableElapsedTime::ToShortString(value * 1e-6);
+  };
+  *output << "<h1>Slow Operations</h1>\n";
+  *output << Format("<p>The last operations of each tablet that took longer than "
+                    "--tablet_slow_op_threshold_ms, $0 ms. The keys are hashed DocKeys of the "
+                    "first rows.</p>\n", FLAGS_tablet_slow_op_threshold_ms);
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Start time</th><th>Table name</th><th>Tablet ID</th><th>Type</th>"
+             "<th>Duration</th><th>Key hash</th><th>Read time</th><th>Rows returned</th>"
+             "<th>Keys scanned</th><th>Keys skipped</th><th>Intents</th><th>Rows written</th>"
+             "<th>Lock wait</th><th>Replication</th><th>Request size</th></tr>\n";
+  for (const auto& entry : ops) {
+    const auto& op = entry.op;
+    *output << Format(
+        "<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td>",
+        Timestamp(op.start_time_us()).ToFormattedString(),
+        EscapeForHtmlToString(entry.table_name),
+        TabletLink(entry.tablet_id),
+        tablet::SlowOpPB::Type_Name(op.type()),
+        micros(op.duration_us()),
+        op.has_key_hash() ? StringPrintf("%016" PRIx64, op.key_hash()) : "",
+        op.has_read_time_ht() ? HybridTime(op.read_time_ht()).ToString() : "");
+    *output << Format(
+        "<td>$0</td><td>$1</td><td>$2</td><td>$3</td><td>$4</td><td>$5</td><td>$6</td><td>$7</td>"
+        "</tr>\n",
+        op.rows_returned(), op.keys_scanned(), op.keys_skipped(), op.intents(),
+        op.rows_written(), micros(op.lock_wait_us()), micros(op.replication_us()),
+        HumanReadableNumBytes::ToString(op.request_bytes()));
   }
   *output << "</table>\n";
 }
@@ -679,15 +853,17 @@ void TabletServerPathHandlers::HandleMaintenanceManagerPage(const Webserver::Web
 
   *output << "<h3>Recent completed operations</h3>\n";
   *output << "<table class='table table-striped'>\n";
-  *output << "  <tr><th>Name</th><th>Duration</th><th>Time since op started</th></tr>\n";
+  *output << "  <tr><th>Name</th><th>Duration</th><th>Time since op started</th>"
+          << "<th>Reason</th></tr>\n";
   for (int i = 0; i < pb.completed_operations_size(); i++) {
     MaintenanceManagerStatusPB_CompletedOpPB op_pb = pb.completed_operations(i);
-    *output <<  Substitute("<tr><td>$0</td><td>$1</td><td>$2</td></tr>\n",
+    *output <<  Substitute("<tr><td>$0</td><td>$1</td><td>$2</td><td>$3</td></tr>\n",
                            EscapeForHtmlToString(op_pb.name()),
                            HumanReadableElapsedTime::ToShortString(
                                op_pb.duration_millis() / 1000.0),
                            HumanReadableElapsedTime::ToShortString(
-                               op_pb.secs_since_start()));
+                               op_pb.secs_since_start()),
+                           EscapeForHtmlToString(op_pb.reason()));
   }
   *output << "</table>\n";
 
@@ -66,6 +66,10 @@ class TabletServerPathHandlers {
                         std::stringstream* output);
   void HandleTabletsPage(const Webserver::WebRequest& req,
                          std::stringstream* output);
+  void HandleTabletLsmPage(const Webserver::WebRequest& req,
+                           std::stringstream* output);
+  void HandleSlowOpsPage(const Webserver::WebRequest& req,
+                         std::stringstream* output);
   void HandleOperationsPage(const Webserver::WebRequest& req,
                             std::stringstream* output);
   void HandleDashboardsPage(const Webserver::WebRequest& req,
@@ -13,11 +13,16 @@
 
 #include "yb/tserver/tserver_metrics_heartbeat_data_provider.h"
 
+#include <sys/resource.h>
+
 #include "yb/master/master.pb.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_hot_keys.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/ts_tablet_manager.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/mem_tracker.h"
 
@@ -25,6 +30,12 @@ DEFINE_int32(tserver_heartbeat_metrics_interval_ms, 5000,
              "Interval (in milliseconds) at which tserver sends its metrics in a heartbeat to "
              "master.");
 
+DEFINE_int32(tserver_heartbeat_hot_keys_per_tablet, 5,
+             "Number of the hottest keys of each tablet, that is reported to master with the "
+             "load of the tablet.");
+TAG_FLAG(tserver_heartbeat_hot_keys_per_tablet, advanced);
+TAG_FLAG(tserver_heartbeat_hot_keys_per_tablet, runtime);
+
 using namespace std::literals;
 
 namespace yb {
@@ -33,7 +44,7 @@ namespace tserver {
 TServerMetricsHeartbeatDataProvider::TServerMetricsHeartbeatDataProvider(TabletServer* server) :
   PeriodicalHeartbeatDataProvider(server,
       MonoDelta::FromMilliseconds(FLAGS_tserver_heartbeat_metrics_interval_ms)),
-  start_time_(MonoTime::Now()) {}
+  start_time_(MonoTime::Now()), prev_cpu_time_(CpuTime()) {}
 
 void TServerMetricsHeartbeatDataProvider::DoAddData(master::TSHeartbeatRequestPB* req) {
   // Get the total memory used.
@@ -42,19 +53,60 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(master::TSHeartbeatRequestPB
   metrics->set_total_ram_usage(static_cast<int64_t>(mem_usage));
   VLOG_WITH_PREFIX(4) << "Total Memory Usage: " << mem_usage;
 
+  MonoDelta diff = CoarseMonoClock::Now() - prev_run_time();
+  double_t div = diff.ToSeconds();
+
   uint64_t total_file_sizes = 0;
   uint64_t uncompressed_file_sizes = 0;
   uint64_t num_files = 0;
+  std::unordered_map<TabletId, TabletOps> tablet_ops;
   for (const auto& tablet_peer : server().tablet_manager()->GetTabletPeers()) {
     if (tablet_peer) {
       auto tablet = tablet_peer->shared_tablet();
       if (tablet) {
-        total_file_sizes += tablet->GetCurrentVersionSstFilesSize();
+        const auto sst_file_size = tablet->GetCurrentVersionSstFilesSize();
+        total_file_sizes += sst_file_size;
         uncompressed_file_sizes += tablet->GetCurrentVersionSstFilesUncompressedSize();
         num_files += tablet->GetCurrentVersionNumSSTFiles();
+
+        // Report the load of the tablet, so the load balancer could take it into account.
+        const auto* tablet_metrics = tablet->metrics();
+        if (!tablet_metrics) {
+          continue;
+        }
+        auto& ops = tablet_ops[tablet->tablet_id()];
+        ops.reads = tablet_metrics->ql_read_latency->TotalCount() +
+                    tablet_metrics->redis_read_latency->TotalCount();
+        ops.writes = tablet_metrics->write_op_duration_client_propagated_consistency->TotalCount() +
+                     tablet_metrics->write_op_duration_commit_wait_consistency->TotalCount();
+        // The rates of a tablet are known starting from the second time it is seen.
+        auto prev_it = prev_tablet_ops_.find(tablet->tablet_id());
+        if (div <= 0 || prev_it == prev_tablet_ops_.end() ||
+            ops.reads < prev_it->second.reads || ops.writes < prev_it->second.writes) {
+          continue;
+        }
+        const double tablet_rops_per_sec = (ops.reads - prev_it->second.reads) / div;
+        const double tablet_wops_per_sec = (ops.writes - prev_it->second.writes) / div;
+        if (tablet_rops_per_sec == 0 && tablet_wops_per_sec == 0 && sst_file_size == 0) {
+          continue;
+        }
+        auto* tablet_load = metrics->add_tablet_loads();
+        tablet_load->set_tablet_id(tablet->tablet_id());
+        tablet_load->set_read_ops_per_sec(tablet_rops_per_sec);
+        tablet_load->set_write_ops_per_sec(tablet_wops_per_sec);
+        tablet_load->set_sst_file_size(sst_file_size);
+        const auto hot_keys = tablet->hot_keys().GetHotKeys(
+            std::max(FLAGS_tserver_heartbeat_hot_keys_per_tablet, 0));
+        for (const auto& hot_key : hot_keys) {
+          auto* hot_key_pb = tablet_load->add_hot_keys();
+          hot_key_pb->set_key(hot_key.key);
+          hot_key_pb->set_ops_per_sec(hot_key.ops_per_sec);
+          hot_key_pb->set_error_ops_per_sec(hot_key.error_ops_per_sec);
+        }
       }
     }
   }
+  prev_tablet_ops_ = std::move(tablet_ops);
   metrics->set_total_sst_file_size(total_file_sizes);
   metrics->set_uncompressed_sst_file_size(uncompressed_file_sizes);
   metrics->set_num_sst_files(num_files);
@@ -69,9 +121,6 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(master::TSHeartbeatRequestPB
   uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
   // Calculate the read and write ops per second.
-  MonoDelta diff = CoarseMonoClock::Now() - prev_run_time();
-  double_t div = diff.ToSeconds();
-
   double rops_per_sec = (div > 0 && num_reads > 0) ?
       (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
@@ -86,10 +135,26 @@ void TServerMetricsHeartbeatDataProvider::DoAddData(master::TSHeartbeatRequestPB
 
   metrics->set_uptime_seconds(uptime_seconds);
 
+  const auto cpu_time = CpuTime();
+  const double cpu_usage = div > 0 ? (cpu_time - prev_cpu_time_).ToSeconds() / div : 0;
+  prev_cpu_time_ = cpu_time;
+  metrics->set_cpu_usage(cpu_usage);
+
   VLOG_WITH_PREFIX(4) << "Read Ops per second: " << rops_per_sec;
   VLOG_WITH_PREFIX(4) << "Write Ops per second: " << wops_per_sec;
   VLOG_WITH_PREFIX(4) << "Total SST File Sizes: "<< total_file_sizes;
   VLOG_WITH_PREFIX(4) << "Uptime seconds: "<< uptime_seconds;
+  VLOG_WITH_PREFIX(4) << "CPU usage: " << cpu_usage;
+}
+
+MonoDelta TServerMetricsHeartbeatDataProvider::CpuTime() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return MonoDelta::kZero;
+  }
+  return MonoDelta::FromMicroseconds(
+      (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000LL +
+      usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
 }
 
 uint64_t TServerMetricsHeartbeatDataProvider::CalculateUptime() {
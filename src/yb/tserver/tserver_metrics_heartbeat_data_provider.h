@@ -15,6 +15,9 @@
 #define YB_TSERVER_TSERVER_METRICS_HEARTBEAT_DATA_PROVIDER_H
 
 #include <memory>
+#include <unordered_map>
+
+#include "yb/common/entity_ids.h"
 
 #include "yb/tserver/heartbeater.h"
 
@@ -30,11 +33,24 @@ class TServerMetricsHeartbeatDataProvider : public PeriodicalHeartbeatDataProvid
 
   uint64_t CalculateUptime();
 
+  // Returns the CPU time used by this process so far.
+  static MonoDelta CpuTime();
+
   MonoTime start_time_;
 
   // Stores the total read and writes ops for computing iops.
   uint64_t prev_reads_ = 0;
   uint64_t prev_writes_ = 0;
+
+  // Stores the total read and write ops of every tablet for computing their iops.
+  struct TabletOps {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+  };
+  std::unordered_map<TabletId, TabletOps> prev_tablet_ops_;
+
+  // Stores the CPU time used by this process for computing the CPU usage.
+  MonoDelta prev_cpu_time_;
 };
 
 } // namespace tserver
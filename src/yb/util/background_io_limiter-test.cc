@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/background_io_limiter.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+using namespace yb::size_literals;
+
+namespace yb {
+
+class BackgroundIoLimiterTest : public YBTest {
+ protected:
+  static constexpr int64_t kRate = 10_MB;
+  static constexpr int64_t kRequestSize = 64_KB;
+
+  BackgroundIoLimiterOptions Options() {
+    BackgroundIoLimiterOptions result;
+    result.rate_bytes_per_sec = [this] { return rate_.load(); };
+    result.weight = [](BackgroundIoClass io_class) {
+      return io_class == BackgroundIoClass::kCompaction ? 3 : 1;
+    };
+    return result;
+  }
+
+  // Runs a thread per class requesting I/O for the duration, returns the bytes done per class.
+  std::vector<int64_t> Run(BackgroundIoLimiter* limiter,
+                           const std::vector<BackgroundIoClass>& classes,
+                           std::chrono::milliseconds duration) {
+    std::vector<int64_t> result(classes.size());
+    std::vector<std::thread> threads;
+    const auto deadline = CoarseMonoClock::Now() + duration;
+    for (size_t i = 0; i != classes.size(); ++i) {
+      threads.emplace_back([limiter, &classes, &result, deadline, i] {
+        while (CoarseMonoClock::Now() < deadline) {
+          limiter->Request(classes[i], kRequestSize);
+          result[i] += kRequestSize;
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return result;
+  }
+
+  std::atomic<int64_t> rate_{kRate};
+};
+
+TEST_F(BackgroundIoLimiterTest, Disabled) {
+  rate_ = 0;
+  BackgroundIoLimiter limiter(Options());
+  ASSERT_FALSE(limiter.enabled());
+  auto bytes = Run(&limiter, {BackgroundIoClass::kCdc}, 100ms);
+  ASSERT_GT(bytes[0], kRate);
+}
+
+TEST_F(BackgroundIoLimiterTest, Rate) {
+  BackgroundIoLimiter limiter(Options());
+  ASSERT_TRUE(limiter.enabled());
+
+  // A single class takes the whole rate.
+  auto bytes = Run(&limiter, {BackgroundIoClass::kCdc}, 2s);
+  ASSERT_GT(bytes[0], kRate);
+  ASSERT_LT(bytes[0], kRate * 3);
+
+  // Classes share the rate according to their weights.
+  bytes = Run(&limiter, {BackgroundIoClass::kCompaction, BackgroundIoClass::kBackup}, 2s);
+  LOG(INFO) << "Compaction: " << bytes[0] << ", backup: " << bytes[1];
+  ASSERT_LT(bytes[0] + bytes[1], kRate * 3);
+  ASSERT_GT(bytes[0], bytes[1] * 2);
+  ASSERT_LT(bytes[0], bytes[1] * 4);
+}
+
+} // namespace yb
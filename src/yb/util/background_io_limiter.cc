@@ -0,0 +1,156 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/background_io_limiter.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+
+using namespace std::literals;
+
+DEFINE_int64(background_io_rate_limit_bytes_per_sec, 0,
+             "Rate of the background disk and network I/O of the tablet server, shared by "
+             "compactions, remote bootstraps, backups and CDC catch-up reads according to their "
+             "weights. 0 for no limit. Takes effect for compactions of the RocksDB instances "
+             "opened after the limit is set.");
+TAG_FLAG(background_io_rate_limit_bytes_per_sec, advanced);
+TAG_FLAG(background_io_rate_limit_bytes_per_sec, runtime);
+
+DEFINE_int32(background_io_compaction_weight, 4,
+             "Weight of compactions and flushes in background_io_rate_limit_bytes_per_sec.");
+TAG_FLAG(background_io_compaction_weight, advanced);
+TAG_FLAG(background_io_compaction_weight, runtime);
+
+DEFINE_int32(background_io_remote_bootstrap_weight, 2,
+             "Weight of remote bootstraps in background_io_rate_limit_bytes_per_sec.");
+TAG_FLAG(background_io_remote_bootstrap_weight, advanced);
+TAG_FLAG(background_io_remote_bootstrap_weight, runtime);
+
+DEFINE_int32(background_io_backup_weight, 1,
+             "Weight of backups in background_io_rate_limit_bytes_per_sec.");
+TAG_FLAG(background_io_backup_weight, advanced);
+TAG_FLAG(background_io_backup_weight, runtime);
+
+DEFINE_int32(background_io_cdc_weight, 1,
+             "Weight of CDC reads of the log from disk in background_io_rate_limit_bytes_per_sec.");
+TAG_FLAG(background_io_cdc_weight, advanced);
+TAG_FLAG(background_io_cdc_weight, runtime);
+
+namespace yb {
+
+namespace {
+
+constexpr auto kRefillPeriod = 10ms;
+
+// A class that did not request I/O for this long does not take a share of the rate.
+constexpr auto kActivityWindow = 1s;
+
+// Unused share of a class is kept for a burst of at most this long.
+constexpr auto kMaxBurst = 100ms;
+
+int64_t DefaultWeight(BackgroundIoClass io_class) {
+  switch (io_class) {
+    case BackgroundIoClass::kCompaction:
+      return FLAGS_background_io_compaction_weight;
+    case BackgroundIoClass::kRemoteBootstrap:
+      return FLAGS_background_io_remote_bootstrap_weight;
+    case BackgroundIoClass::kBackup:
+      return FLAGS_background_io_backup_weight;
+    case BackgroundIoClass::kCdc:
+      return FLAGS_background_io_cdc_weight;
+  }
+  FATAL_INVALID_ENUM_VALUE(BackgroundIoClass, io_class);
+}
+
+} // namespace
+
+BackgroundIoLimiter::BackgroundIoLimiter(BackgroundIoLimiterOptions options)
+    : options_(std::move(options)) {
+}
+
+BackgroundIoLimiter& BackgroundIoLimiter::Default() {
+  static BackgroundIoLimiter limiter(BackgroundIoLimiterOptions {
+    .rate_bytes_per_sec = [] { return FLAGS_background_io_rate_limit_bytes_per_sec; },
+    .weight = &DefaultWeight,
+  });
+  return limiter;
+}
+
+bool BackgroundIoLimiter::enabled() const {
+  return options_.rate_bytes_per_sec() > 0;
+}
+
+void BackgroundIoLimiter::Request(BackgroundIoClass io_class, int64_t bytes) {
+  const auto rate_bytes_per_sec = options_.rate_bytes_per_sec();
+  if (rate_bytes_per_sec <= 0 || bytes <= 0) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& state = classes_[to_underlying(io_class)];
+  state.last_request_time = CoarseMonoClock::Now();
+  ++state.waiters;
+  for (;;) {
+    Refill(CoarseMonoClock::Now(), rate_bytes_per_sec);
+    if (state.tokens > 0) {
+      break;
+    }
+    cond_.wait_for(lock, kRefillPeriod);
+  }
+  --state.waiters;
+  state.tokens -= bytes;
+}
+
+void BackgroundIoLimiter::Refill(CoarseTimePoint now, int64_t rate_bytes_per_sec) {
+  if (last_refill_time_ == CoarseTimePoint()) {
+    last_refill_time_ = now;
+  }
+  const auto elapsed = now - last_refill_time_;
+  if (elapsed < kRefillPeriod) {
+    return;
+  }
+  last_refill_time_ = now;
+
+  std::array<int64_t, kElementsInBackgroundIoClass> weights;
+  int64_t total_weight = 0;
+  for (auto io_class : kBackgroundIoClassList) {
+    const auto idx = to_underlying(io_class);
+    const auto& state = classes_[idx];
+    const bool active = state.waiters > 0 || now - state.last_request_time < kActivityWindow;
+    weights[idx] = active ? std::max<int64_t>(options_.weight(io_class), 1) : 0;
+    total_weight += weights[idx];
+  }
+  if (total_weight == 0) {
+    return;
+  }
+
+  // After a long pause the classes do not get more than a burst.
+  const double refill_sec =
+      std::chrono::duration<double>(std::min<CoarseDuration>(elapsed, kMaxBurst)).count();
+  const double burst_sec = std::chrono::duration<double>(kMaxBurst).count();
+  for (size_t idx = 0; idx != classes_.size(); ++idx) {
+    if (weights[idx] == 0) {
+      continue;
+    }
+    const double share = static_cast<double>(rate_bytes_per_sec) * weights[idx] / total_weight;
+    auto& tokens = classes_[idx].tokens;
+    tokens = std::min(tokens + static_cast<int64_t>(share * refill_sec),
+                      static_cast<int64_t>(share * burst_sec));
+  }
+  cond_.notify_all();
+}
+
+} // namespace yb
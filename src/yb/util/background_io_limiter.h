@@ -0,0 +1,82 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_BACKGROUND_IO_LIMITER_H
+#define YB_UTIL_BACKGROUND_IO_LIMITER_H
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+YB_DEFINE_ENUM(BackgroundIoClass, (kCompaction)(kRemoteBootstrap)(kBackup)(kCdc));
+
+struct BackgroundIoLimiterOptions {
+  // Rate in bytes per second shared by all the classes, 0 for no limit.
+  std::function<int64_t()> rate_bytes_per_sec;
+
+  // Weight of the class in the rate shared by the classes that do I/O at the same time.
+  std::function<int64_t(BackgroundIoClass)> weight;
+};
+
+// Limits the rate of the disk and network I/O done in the background, so that it leaves
+// foreground reads and writes their share of the disk and network.
+//
+// The rate is shared by the classes that did I/O recently, in proportion to their weights, so a
+// class uses the whole rate when the others are idle. The feature specific limits, like
+// remote_bootstrap_rate_limit_bytes_per_sec, still cap each class on its own.
+class BackgroundIoLimiter {
+ public:
+  explicit BackgroundIoLimiter(BackgroundIoLimiterOptions options);
+
+  // Limiter shared by the process, configured by the background_io_* flags.
+  static BackgroundIoLimiter& Default();
+
+  // Accounts bytes of I/O done, or about to be done, by the class. Sleeps while the class is over
+  // its share of the rate. A single request could be larger than the share, the class then waits
+  // for the following requests until it is paid back.
+  void Request(BackgroundIoClass io_class, int64_t bytes);
+
+  bool enabled() const;
+
+ private:
+  struct ClassState {
+    // Could be negative, when a request took more than the class had.
+    int64_t tokens = 0;
+    size_t waiters = 0;
+    CoarseTimePoint last_request_time;
+  };
+
+  void Refill(CoarseTimePoint now, int64_t rate_bytes_per_sec) REQUIRES(mutex_);
+
+  const BackgroundIoLimiterOptions options_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::array<ClassState, kElementsInBackgroundIoClass> classes_ GUARDED_BY(mutex_);
+  CoarseTimePoint last_refill_time_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundIoLimiter);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_BACKGROUND_IO_LIMITER_H
@@ -0,0 +1,76 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CANCELLATION_TOKEN_H
+#define YB_UTIL_CANCELLATION_TOKEN_H
+
+#include <atomic>
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+
+// Flag that is set when the result of an operation is not needed anymore, for instance because
+// the client that requested it has disconnected. Long running parts of the operation could check
+// it to stop early.
+class CancellationToken {
+ public:
+  CancellationToken() = default;
+
+  void Cancel() {
+    cancelled_.store(true, std::memory_order_release);
+  }
+
+  bool cancelled() const {
+    return cancelled_.load(std::memory_order_acquire);
+  }
+
+  // Returns the token adopted by the current thread, or nullptr if there is no such token.
+  static const CancellationToken* Current() {
+    return threadlocal_token_;
+  }
+
+ private:
+  friend class ScopedAdoptCancellationToken;
+
+  std::atomic<bool> cancelled_{false};
+
+  // The token of the operation executed by this thread, should only be set using
+  // ScopedAdoptCancellationToken.
+  static __thread const CancellationToken* threadlocal_token_;
+
+  DISALLOW_COPY_AND_ASSIGN(CancellationToken);
+};
+
+// Makes the token current for this thread, while this object is alive.
+// The token should outlive the objects that obtained it via CancellationToken::Current().
+class ScopedAdoptCancellationToken {
+ public:
+  explicit ScopedAdoptCancellationToken(const CancellationToken* token)
+      : old_token_(CancellationToken::threadlocal_token_) {
+    CancellationToken::threadlocal_token_ = token;
+  }
+
+  ~ScopedAdoptCancellationToken() {
+    CancellationToken::threadlocal_token_ = old_token_;
+  }
+
+ private:
+  const CancellationToken* old_token_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedAdoptCancellationToken);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_CANCELLATION_TOKEN_H
@@ -16,7 +16,11 @@
 
 #include <openssl/ossl_typ.h>
 
+#include <functional>
 #include <string>
+#include <vector>
+
+#include "yb/gutil/thread_annotations.h"
 
 #include "yb/util/status.h"
 #include "yb/util/result.h"
@@ -40,7 +44,7 @@ class BlockAccessCipherStream {
   explicit BlockAccessCipherStream(EncryptionParamsPtr encryption_params);
   CHECKED_STATUS Init();
 
-  // Encrypt data at an offset.
+  // Encrypt data at an offset. The output could be the input itself, to encrypt in place.
   CHECKED_STATUS Encrypt(
       uint64_t file_offset,
       const Slice& input,
@@ -48,7 +52,7 @@ class BlockAccessCipherStream {
       EncryptionOverflowWorkaround counter_overflow_workaround =
           EncryptionOverflowWorkaround::kFalse);
 
-  // Decrypt data at an offset.
+  // Decrypt data at an offset. The output could be the input itself, to decrypt in place.
   // counter_overflow_workaround indicates whether we should add one to byte 11 of the initilization
   // vector. Used to as a workaround in case of block checksum mismatches when reading data that is
   // affected by https://github.com/yugabyte/yugabyte-db/issues/3707.
@@ -62,19 +66,43 @@ class BlockAccessCipherStream {
   bool UseOpensslCompatibleCounterOverflow();
 
  private:
+  typedef std::unique_ptr<EVP_CIPHER_CTX, std::function<void(EVP_CIPHER_CTX*)>> CipherContextPtr;
+
+  static CipherContextPtr NewContext();
+
+  // Returns a context with the key of the file, that is only used by the caller until released.
+  Result<CipherContextPtr> AcquireContext();
+  void ReleaseContext(CipherContextPtr context);
+
+  // Encrypts the data that starts at the given block.
   CHECKED_STATUS EncryptByBlock(
+      EVP_CIPHER_CTX* context,
       uint64_t block_index,
       const Slice& input,
       void* output,
-      EncryptionOverflowWorkaround counter_overflow_workaround =
-          EncryptionOverflowWorkaround::kFalse);
+      EncryptionOverflowWorkaround counter_overflow_workaround);
+
+  // Starts the key stream of the context at the given block.
+  CHECKED_STATUS SetBlockIndex(
+      EVP_CIPHER_CTX* context, uint64_t block_index,
+      EncryptionOverflowWorkaround counter_overflow_workaround);
+
+  // Encrypts the data with the following bytes of the key stream of the context.
+  CHECKED_STATUS Update(
+      EVP_CIPHER_CTX* context, uint64_t block_index, const uint8_t* input, size_t size,
+      uint8_t* output);
 
   void IncrementCounter(const uint64_t start_idx, uint8_t* iv,
                         EncryptionOverflowWorkaround counter_overflow_workaround);
 
   EncryptionParamsPtr encryption_params_;
-  std::unique_ptr<EVP_CIPHER_CTX, std::function<void(EVP_CIPHER_CTX*)>> encryption_context_;
+  // Has the expanded key of the file, and is copied to the contexts used for the encryption, so
+  // each call only sets the iv.
+  CipherContextPtr encryption_context_;
   mutable simple_spinlock mutex_;
+  // The contexts that are not in use, so the concurrent reads of a file do not wait for each
+  // other, while the contexts are reused.
+  std::vector<CipherContextPtr> free_contexts_ GUARDED_BY(mutex_);
 };
 
 } // namespace enterprise
@@ -0,0 +1,105 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/concurrency_limiter.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+
+class ConcurrencyLimiterTest : public YBTest {
+ protected:
+  ConcurrencyLimiterOptions Options(size_t max_limit) {
+    ConcurrencyLimiterOptions result;
+    result.max_limit = max_limit;
+    result.min_limit = 2;
+    result.latency_tolerance = 10;
+    result.backoff_ratio = 0.5;
+    return result;
+  }
+
+  // Runs an operation that takes the specified time.
+  void Run(ConcurrencyLimiter* limiter, std::chrono::milliseconds duration) {
+    ConcurrencySlot slot;
+    ASSERT_TRUE(limiter->TryAcquire(&slot));
+    std::this_thread::sleep_for(duration);
+  }
+
+  // Acquires slots until the limit is reached, returns their number.
+  size_t Fill(ConcurrencyLimiter* limiter, std::vector<ConcurrencySlot>* slots) {
+    for (;;) {
+      ConcurrencySlot slot;
+      if (!limiter->TryAcquire(&slot)) {
+        return slots->size();
+      }
+      slots->push_back(std::move(slot));
+    }
+  }
+};
+
+TEST_F(ConcurrencyLimiterTest, Disabled) {
+  ConcurrencyLimiter limiter(Options(0));
+  std::vector<ConcurrencySlot> slots(100);
+  for (auto& slot : slots) {
+    ASSERT_TRUE(limiter.TryAcquire(&slot));
+  }
+  ASSERT_EQ(limiter.running(), 0);
+}
+
+TEST_F(ConcurrencyLimiterTest, Limit) {
+  ConcurrencyLimiter limiter(Options(3));
+  std::vector<ConcurrencySlot> slots;
+  ASSERT_EQ(Fill(&limiter, &slots), 3);
+  ASSERT_EQ(limiter.running(), 3);
+
+  slots.back().Release();
+  ConcurrencySlot slot;
+  ASSERT_TRUE(limiter.TryAcquire(&slot));
+  ASSERT_FALSE(limiter.TryAcquire(&slot));
+
+  slots.clear();
+  ASSERT_EQ(limiter.running(), 1);
+  slot.Release();
+  ASSERT_EQ(limiter.running(), 0);
+}
+
+TEST_F(ConcurrencyLimiterTest, Adapt) {
+  ConcurrencyLimiter limiter(Options(8));
+  for (int i = 0; i != 10; ++i) {
+    Run(&limiter, 1ms);
+  }
+  ASSERT_EQ(limiter.limit(), 8);
+
+  // A slow operation halves the limit, but not below the minimal one.
+  Run(&limiter, 100ms);
+  ASSERT_EQ(limiter.limit(), 4);
+  Run(&limiter, 100ms);
+  ASSERT_EQ(limiter.limit(), 2);
+  Run(&limiter, 100ms);
+  ASSERT_EQ(limiter.limit(), 2);
+
+  // Operations that finish in time grow it back.
+  for (int i = 0; i != 100 && limiter.limit() < 8; ++i) {
+    std::vector<ConcurrencySlot> slots;
+    ASSERT_EQ(Fill(&limiter, &slots), limiter.limit());
+  }
+  ASSERT_EQ(limiter.limit(), 8);
+}
+
+} // namespace yb
@@ -0,0 +1,113 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/concurrency_limiter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glog/logging.h>
+
+namespace yb {
+
+namespace {
+
+// Weight of the latest operation in the average latency.
+constexpr double kAverageLatencyWeight = 0.01;
+
+} // namespace
+
+ConcurrencySlot::ConcurrencySlot(ConcurrencyLimiter* limiter, MonoTime start)
+    : limiter_(limiter), start_(start) {
+}
+
+ConcurrencySlot::ConcurrencySlot(ConcurrencySlot&& rhs)
+    : limiter_(rhs.limiter_), start_(rhs.start_) {
+  rhs.limiter_ = nullptr;
+}
+
+ConcurrencySlot& ConcurrencySlot::operator=(ConcurrencySlot&& rhs) {
+  Release();
+  limiter_ = rhs.limiter_;
+  start_ = rhs.start_;
+  rhs.limiter_ = nullptr;
+  return *this;
+}
+
+ConcurrencySlot::~ConcurrencySlot() {
+  Release();
+}
+
+void ConcurrencySlot::Release() {
+  if (limiter_) {
+    limiter_->Release(start_);
+    limiter_ = nullptr;
+  }
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(const ConcurrencyLimiterOptions& options)
+    : options_(options), limit_(options.max_limit) {
+  CHECK_GE(options_.latency_tolerance, 1.0);
+  CHECK_GT(options_.backoff_ratio, 0.0);
+  CHECK_LT(options_.backoff_ratio, 1.0);
+}
+
+bool ConcurrencyLimiter::TryAcquire(ConcurrencySlot* slot) {
+  if (options_.max_limit == 0) {
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ >= limit_) {
+      return false;
+    }
+    ++running_;
+  }
+  *slot = ConcurrencySlot(this, MonoTime::Now());
+  return true;
+}
+
+void ConcurrencyLimiter::Release(MonoTime start) {
+  const auto now = MonoTime::Now();
+  const double latency_us = (now - start).ToMicroseconds();
+  std::lock_guard<std::mutex> lock(mutex_);
+  --running_;
+  if (!next_decrease_time_) {
+    average_latency_us_ = latency_us;
+    next_decrease_time_ = now;
+    return;
+  }
+  if (latency_us > average_latency_us_ * options_.latency_tolerance) {
+    // Operations started before the decrease take effect still finish slowly, so the limit is not
+    // decreased again until they are done.
+    if (now >= next_decrease_time_) {
+      limit_ = std::max<double>(limit_ * options_.backoff_ratio, options_.min_limit);
+      next_decrease_time_ = now + MonoDelta::FromMicroseconds(static_cast<int64_t>(average_latency_us_));
+    }
+  } else {
+    limit_ = std::min<double>(limit_ + 1.0 / limit_, options_.max_limit);
+  }
+  average_latency_us_ += (latency_us - average_latency_us_) * kAverageLatencyWeight;
+}
+
+size_t ConcurrencyLimiter::limit() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<size_t>(std::ceil(limit_));
+}
+
+size_t ConcurrencyLimiter::running() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return running_;
+}
+
+} // namespace yb
@@ -0,0 +1,98 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CONCURRENCY_LIMITER_H
+#define YB_UTIL_CONCURRENCY_LIMITER_H
+
+#include <mutex>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+struct ConcurrencyLimiterOptions {
+  // The limit never gets above max_limit, that it starts from, and below min_limit.
+  // 0 max_limit admits every operation.
+  size_t max_limit = 0;
+  size_t min_limit = 1;
+
+  // An operation that takes this many times longer than the average operation is taken as a sign
+  // of overload, that decreases the limit.
+  double latency_tolerance = 4.0;
+
+  // The limit is multiplied by this when decreased.
+  double backoff_ratio = 0.9;
+};
+
+class ConcurrencyLimiter;
+
+// Operation admitted by ConcurrencyLimiter, that is accounted as running until the slot is
+// destroyed.
+class ConcurrencySlot {
+ public:
+  ConcurrencySlot() = default;
+  ConcurrencySlot(ConcurrencySlot&& rhs);
+  ConcurrencySlot& operator=(ConcurrencySlot&& rhs);
+  ~ConcurrencySlot();
+
+  // Finishes the operation earlier than the slot is destroyed.
+  void Release();
+
+ private:
+  friend class ConcurrencyLimiter;
+
+  ConcurrencySlot(ConcurrencyLimiter* limiter, MonoTime start);
+
+  ConcurrencyLimiter* limiter_ = nullptr;
+  MonoTime start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrencySlot);
+};
+
+// Limits the number of concurrently running operations, adapting the limit to their latency with
+// additive increase and multiplicative decrease. The limit is decreased when an operation
+// finishes much slower than the average one, at most once per average operation latency, and
+// increased by one after the limit number of operations finish in time.
+class ConcurrencyLimiter {
+ public:
+  explicit ConcurrencyLimiter(const ConcurrencyLimiterOptions& options);
+
+  // Returns whether the operation is admitted, in that case fills the slot to hold while it runs.
+  bool TryAcquire(ConcurrencySlot* slot);
+
+  // Returns the number of operations that could run concurrently.
+  size_t limit() const;
+  size_t running() const;
+
+ private:
+  friend class ConcurrencySlot;
+
+  void Release(MonoTime start);
+
+  const ConcurrencyLimiterOptions options_;
+
+  mutable std::mutex mutex_;
+  double limit_ GUARDED_BY(mutex_);
+  size_t running_ GUARDED_BY(mutex_) = 0;
+  double average_latency_us_ GUARDED_BY(mutex_) = 0;
+  MonoTime next_decrease_time_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrencyLimiter);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_CONCURRENCY_LIMITER_H
@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/continuous_profiler.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/thread.h"
+
+using namespace std::literals;
+
+namespace yb {
+
+class ContinuousProfilerTest : public YBTest {};
+
+#if defined(__linux__)
+
+TEST_F(ContinuousProfilerTest, Sampling) {
+  ASSERT_OK(StartContinuousProfiling(1000));
+
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> counter{0};
+  scoped_refptr<Thread> thread;
+  ASSERT_OK(Thread::Create("profiled", "busy", [&stop, &counter] {
+    while (!stop.load(std::memory_order_relaxed)) {
+      counter.fetch_add(1, std::memory_order_relaxed);
+    }
+  }, &thread));
+  SleepFor(1s);
+  stop = true;
+  thread->Join();
+  StopContinuousProfiling();
+
+  ContinuousProfileOptions options;
+  options.category = "profiled";
+  options.by_category = true;
+  std::stringstream by_category;
+  DumpContinuousProfile(options, &by_category);
+  LOG(INFO) << "Samples by category: " << by_category.str();
+  ASSERT_STR_CONTAINS(by_category.str(), "profiled ");
+
+  options.by_category = false;
+  std::stringstream stacks;
+  DumpContinuousProfile(options, &stacks);
+  LOG(INFO) << "Stacks: " << stacks.str();
+  ASSERT_STR_CONTAINS(stacks.str(), "profiled;");
+
+  // Samples taken before the window are not reported.
+  SleepFor(100ms);
+  options.window = 10ms;
+  std::stringstream empty;
+  DumpContinuousProfile(options, &empty);
+  ASSERT_EQ(empty.str(), "");
+}
+
+#endif // defined(__linux__)
+
+} // namespace yb
@@ -0,0 +1,302 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/continuous_profiler.h"
+
+#include <signal.h>
+#include <time.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/port.h"
+#include "yb/gutil/strings/numbers.h"
+
+#include "yb/util/debug-util.h"
+#include "yb/util/errno.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/thread.h"
+
+DEFINE_int32(continuous_profiling_buffer_samples, 16384,
+             "Number of the latest stack samples kept by the continuous profiler. It limits the "
+             "window that could be reported to this number of samples divided by the sampling "
+             "frequency and by the number of busy cores.");
+TAG_FLAG(continuous_profiling_buffer_samples, advanced);
+
+// GLog already implements symbolization. Just import their hidden symbol.
+namespace google {
+bool Symbolize(void *pc, char *out, int out_size);
+}
+
+namespace yb {
+
+namespace {
+
+#if defined(__linux__)
+
+// Realtime signal, so the profiler does not interfere with the gperftools CPU profiler, that
+// uses SIGPROF.
+int ProfilingSignal() {
+  return SIGRTMIN + 4;
+}
+
+// Size of the thread names in Linux, including the terminating zero.
+constexpr size_t kCategorySize = 16;
+
+int64_t CoarseNowNanos() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+struct Sample {
+  // Odd while the sample is written, 0 while it was never written. Used to detect samples
+  // overwritten while they are read.
+  std::atomic<uint64_t> sequence{0};
+  int64_t time_nanos = 0;
+  char category[kCategorySize];
+  StackTrace stack;
+};
+
+// Ring buffer of the samples filled by the signal handlers of all threads. The handler does not
+// take locks or allocate, the samples are claimed by incrementing next_.
+class SampleBuffer {
+ public:
+  explicit SampleBuffer(size_t capacity) : capacity_(capacity), samples_(new Sample[capacity]) {}
+
+  void Add();
+
+  template <class F>
+  void ForEach(const F& f) const;
+
+ private:
+  const size_t capacity_;
+  std::unique_ptr<Sample[]> samples_;
+  std::atomic<uint64_t> next_{0};
+};
+
+// Writing of a sample could race with reading of it, that is detected by the sequence, the same
+// way as with a seqlock.
+ATTRIBUTE_NO_SANITIZE_THREAD
+void SampleBuffer::Add() {
+  const auto index = next_.fetch_add(1, std::memory_order_relaxed);
+  auto& sample = samples_[index % capacity_];
+  sample.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  sample.time_nanos = CoarseNowNanos();
+  auto* thread = Thread::current_thread();
+  if (thread) {
+    strncpy(sample.category, thread->category().c_str(), kCategorySize - 1);
+    sample.category[kCategorySize - 1] = 0;
+  } else if (prctl(PR_GET_NAME, sample.category) != 0) {
+    sample.category[0] = 0;
+  }
+  // Skips Add and the signal handler.
+  sample.stack.Collect(2);
+
+  sample.sequence.store(index * 2 + 2, std::memory_order_release);
+}
+
+template <class F>
+ATTRIBUTE_NO_SANITIZE_THREAD
+void SampleBuffer::ForEach(const F& f) const {
+  Sample copy;
+  for (size_t i = 0; i != capacity_; ++i) {
+    const auto& sample = samples_[i];
+    const auto sequence = sample.sequence.load(std::memory_order_acquire);
+    if (sequence == 0 || (sequence & 1)) {
+      continue;
+    }
+    copy.time_nanos = sample.time_nanos;
+    memcpy(copy.category, sample.category, kCategorySize);
+    copy.stack = sample.stack;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sample.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    f(copy);
+  }
+}
+
+// Never deleted, since a signal could still be handled after the profiler is stopped.
+std::atomic<SampleBuffer*> sample_buffer{nullptr};
+
+std::mutex profiler_mutex;
+timer_t profiler_timer;
+bool profiler_running = false;
+
+void HandleProfilingSignal(int signum) {
+  const int saved_errno = errno;
+  auto* buffer = sample_buffer.load(std::memory_order_acquire);
+  if (buffer) {
+    buffer->Add();
+  }
+  errno = saved_errno;
+}
+
+std::string SymbolizeFrame(void* pc, std::unordered_map<void*, std::string>* cache) {
+  auto it = cache->find(pc);
+  if (it != cache->end()) {
+    return it->second;
+  }
+  // The return address points to the instruction following the call.
+  char buf[1024];
+  std::string symbol;
+  if (google::Symbolize(static_cast<char*>(pc) - 1, buf, sizeof(buf))) {
+    symbol = buf;
+    // Semicolons separate the frames in the folded format.
+    std::replace(symbol.begin(), symbol.end(), ';', ':');
+  } else {
+    char hex[kFastToBufferSize];
+    symbol = std::string("0x") + FastHex64ToBuffer(reinterpret_cast<uintptr_t>(pc), hex);
+  }
+  return cache->emplace(pc, std::move(symbol)).first->second;
+}
+
+#endif // defined(__linux__)
+
+} // namespace
+
+#if defined(__linux__)
+
+Status StartContinuousProfiling(int frequency_hz) {
+  if (frequency_hz <= 0) {
+    return Status::OK();
+  }
+
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  if (profiler_running) {
+    return Status::OK();
+  }
+
+  if (!sample_buffer.load(std::memory_order_acquire)) {
+    struct sigaction old_act;
+    if (sigaction(ProfilingSignal(), nullptr, &old_act) != 0) {
+      return STATUS(RuntimeError, "Unable to query profiling signal handler", Errno(errno));
+    }
+    if (old_act.sa_handler != SIG_DFL && old_act.sa_handler != SIG_IGN) {
+      return STATUS_FORMAT(IllegalState, "Profiling signal $0 is already in use",
+                           ProfilingSignal());
+    }
+    struct sigaction act;
+    memset(&act, 0, sizeof(act));
+    act.sa_handler = &HandleProfilingSignal;
+    act.sa_flags = SA_RESTART;
+    sigemptyset(&act.sa_mask);
+    if (sigaction(ProfilingSignal(), &act, nullptr) != 0) {
+      return STATUS(RuntimeError, "Unable to install profiling signal handler", Errno(errno));
+    }
+
+    // The first backtrace() loads libgcc, that must not happen in the signal handler.
+    StackTrace().Collect();
+    sample_buffer.store(
+        new SampleBuffer(std::max(FLAGS_continuous_profiling_buffer_samples, 1)),
+        std::memory_order_release);
+  }
+
+  // The kernel delivers the signal of the process CPU timer to the thread that was running when
+  // it expired, so the samples are proportional to the CPU used by the threads.
+  struct sigevent event;
+  memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_SIGNAL;
+  event.sigev_signo = ProfilingSignal();
+  if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &event, &profiler_timer) != 0) {
+    return STATUS(RuntimeError, "Unable to create profiling timer", Errno(errno));
+  }
+  const int64_t interval_nanos = 1000000000 / frequency_hz;
+  struct itimerspec spec;
+  spec.it_interval.tv_sec = interval_nanos / 1000000000;
+  spec.it_interval.tv_nsec = interval_nanos % 1000000000;
+  spec.it_value = spec.it_interval;
+  if (timer_settime(profiler_timer, 0, &spec, nullptr) != 0) {
+    const int error = errno;
+    timer_delete(profiler_timer);
+    return STATUS(RuntimeError, "Unable to start profiling timer", Errno(error));
+  }
+  profiler_running = true;
+  LOG(INFO) << "Started continuous profiling at " << frequency_hz << " Hz";
+  return Status::OK();
+}
+
+void StopContinuousProfiling() {
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  if (!profiler_running) {
+    return;
+  }
+  timer_delete(profiler_timer);
+  profiler_running = false;
+}
+
+void DumpContinuousProfile(const ContinuousProfileOptions& options, std::ostream* out) {
+  auto* buffer = sample_buffer.load(std::memory_order_acquire);
+  if (!buffer) {
+    *out << "Continuous profiling is not started, see continuous_profiling_frequency_hz."
+         << std::endl;
+    return;
+  }
+
+  const int64_t min_time_nanos = CoarseNowNanos() - options.window.ToNanoseconds();
+  std::map<std::string, int64_t> counts;
+  std::unordered_map<void*, std::string> symbols;
+  buffer->ForEach([&](const Sample& sample) {
+    if (sample.time_nanos < min_time_nanos ||
+        (!options.category.empty() && options.category != sample.category)) {
+      return;
+    }
+    std::string key = sample.category;
+    if (!options.by_category) {
+      for (int i = sample.stack.num_frames(); i-- > 0;) {
+        key += ';';
+        key += SymbolizeFrame(sample.stack.frame(i), &symbols);
+      }
+    }
+    ++counts[key];
+  });
+
+  for (const auto& p : counts) {
+    *out << p.first << " " << p.second << "\n";
+  }
+}
+
+#else
+
+Status StartContinuousProfiling(int frequency_hz) {
+  if (frequency_hz <= 0) {
+    return Status::OK();
+  }
+  return STATUS(NotSupported, "Continuous profiling is only supported on Linux");
+}
+
+void StopContinuousProfiling() {
+}
+
+void DumpContinuousProfile(const ContinuousProfileOptions& options, std::ostream* out) {
+  *out << "Continuous profiling is only supported on Linux." << std::endl;
+}
+
+#endif // defined(__linux__)
+
+} // namespace yb
@@ -0,0 +1,55 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_CONTINUOUS_PROFILER_H
+#define YB_UTIL_CONTINUOUS_PROFILER_H
+
+#include <iosfwd>
+#include <string>
+
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+struct ContinuousProfileOptions {
+  // Only the samples taken during this last period are reported.
+  MonoDelta window = MonoDelta::FromSeconds(60);
+
+  // When not empty, only the samples of threads of this category are reported.
+  std::string category;
+
+  // Report the number of samples per thread category instead of the stacks.
+  bool by_category = false;
+};
+
+// Starts sampling the stacks of the threads that use CPU, frequency_hz times per second of CPU
+// time used by the process. The samples are kept in a fixed size ring buffer, so the overhead
+// does not depend on how long the profiler runs. Does nothing if frequency_hz is not positive
+// or the profiler is already started.
+//
+// Samples are tagged by the category of the yb::Thread they were taken in, like "rpc_thread" or
+// "raft", or by the system name of the thread for threads not created by yb::Thread.
+CHECKED_STATUS StartContinuousProfiling(int frequency_hz);
+
+// Stops taking samples, the samples taken before are still reported.
+void StopContinuousProfiling();
+
+// Writes the samples of the window to out in the folded format, a line per distinct stack:
+//   <thread category>;<outermost frame>;...;<innermost frame> <number of samples>
+// That is accepted by flamegraph.pl and similar tools.
+void DumpContinuousProfile(const ContinuousProfileOptions& options, std::ostream* out);
+
+} // namespace yb
+
+#endif // YB_UTIL_CONTINUOUS_PROFILER_H
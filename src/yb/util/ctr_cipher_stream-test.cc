@@ -128,6 +128,30 @@ TEST_F(TestCipherStream, ConcurrentEncryption) {
   }
 }
 
+// Encrypting or decrypting a range in place gives the same bytes as into another buffer, at any
+// alignment with the blocks.
+TEST_F(TestCipherStream, InPlace) {
+  InitOpenSSL();
+
+  constexpr int kBufSize = 10000;
+  auto plaintext_bytes = RandomBytes(kBufSize);
+  uint8_t encrypted_bytes[kBufSize];
+  auto cipher_stream = ASSERT_RESULT(BlockAccessCipherStream::FromEncryptionParams(
+      EncryptionParams::NewEncryptionParams()));
+  ASSERT_OK(cipher_stream->Encrypt(0, Slice(plaintext_bytes.data(), kBufSize), encrypted_bytes));
+
+  for (int i = 0; i < kNumRuns; i++) {
+    int start = RandomUniformInt(0, kBufSize);
+    int size = RandomUniformInt(0, kBufSize - start);
+    std::vector<uint8_t> buffer(plaintext_bytes.begin() + start,
+                                plaintext_bytes.begin() + start + size);
+    ASSERT_OK(cipher_stream->Encrypt(start, Slice(buffer.data(), size), buffer.data()));
+    ASSERT_EQ(Slice(encrypted_bytes + start, size), Slice(buffer.data(), size));
+    ASSERT_OK(cipher_stream->Decrypt(start, Slice(buffer.data(), size), buffer.data()));
+    ASSERT_EQ(Slice(plaintext_bytes.data() + start, size), Slice(buffer.data(), size));
+  }
+}
+
 TEST_F(TestCipherStream, Overflow) {
   // Create a cipher stream on a iv about to overflow.
   ASSERT_OK(TestOverFlowWithKeyType(true /* use_openssl_compatible_counter_overflow */ ));
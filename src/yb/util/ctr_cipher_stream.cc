@@ -17,6 +17,7 @@
 #include "yb/util/memory/memory.h"
 #include "yb/util/encryption_util.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/scope_exit.h"
 #include "yb/gutil/endian.h"
 
 namespace yb {
@@ -32,10 +33,14 @@ Result<std::unique_ptr<BlockAccessCipherStream>> BlockAccessCipherStream::FromEn
 BlockAccessCipherStream::BlockAccessCipherStream(
     EncryptionParamsPtr encryption_params) :
     encryption_params_(std::move(encryption_params)),
-    encryption_context_(EVP_CIPHER_CTX_new(), [](EVP_CIPHER_CTX* ctx){
-      EVP_CIPHER_CTX_cleanup(ctx);
-      EVP_CIPHER_CTX_free(ctx);
-    }) {}
+    encryption_context_(NewContext()) {}
+
+BlockAccessCipherStream::CipherContextPtr BlockAccessCipherStream::NewContext() {
+  return CipherContextPtr(EVP_CIPHER_CTX_new(), [](EVP_CIPHER_CTX* ctx){
+    EVP_CIPHER_CTX_cleanup(ctx);
+    EVP_CIPHER_CTX_free(ctx);
+  });
+}
 
 Status BlockAccessCipherStream::Init() {
   EVP_CIPHER_CTX_init(encryption_context_.get());
@@ -55,8 +60,9 @@ Status BlockAccessCipherStream::Init() {
           encryption_params_->key_size);
   }
 
+  // The key is expanded once here, the contexts copied from this one only get the iv of each call.
   const auto encrypt_init_ex_result = EVP_EncryptInit_ex(
-      encryption_context_.get(), cipher, /* impl */ nullptr, /* key */ nullptr,
+      encryption_context_.get(), cipher, /* impl */ nullptr, encryption_params_->key,
       /* iv */ nullptr);
   if (encrypt_init_ex_result != 1) {
     return STATUS_FORMAT(InternalError,
@@ -74,6 +80,28 @@ Status BlockAccessCipherStream::Init() {
   return Status::OK();
 }
 
+Result<BlockAccessCipherStream::CipherContextPtr> BlockAccessCipherStream::AcquireContext() {
+  {
+    std::lock_guard<simple_spinlock> l(mutex_);
+    if (!free_contexts_.empty()) {
+      auto result = std::move(free_contexts_.back());
+      free_contexts_.pop_back();
+      return result;
+    }
+  }
+  auto result = NewContext();
+  const int copy_result = EVP_CIPHER_CTX_copy(result.get(), encryption_context_.get());
+  if (copy_result != 1) {
+    return STATUS_FORMAT(InternalError, "EVP_CIPHER_CTX_copy returned $0", copy_result);
+  }
+  return result;
+}
+
+void BlockAccessCipherStream::ReleaseContext(CipherContextPtr context) {
+  std::lock_guard<simple_spinlock> l(mutex_);
+  free_contexts_.push_back(std::move(context));
+}
+
 Status BlockAccessCipherStream::Encrypt(
     uint64_t file_offset,
     const Slice& input,
@@ -87,26 +115,31 @@ Status BlockAccessCipherStream::Encrypt(
     return Status::OK();
   }
 
+  auto context = VERIFY_RESULT(AcquireContext());
+  auto se = ScopeExit([this, &context] {
+    ReleaseContext(std::move(context));
+  });
+
   uint64_t block_index = file_offset / EncryptionParams::kBlockSize;
   uint64_t block_offset = file_offset % EncryptionParams::kBlockSize;
   size_t first_block_size = 0;
-  // Encrypt the first block alone if it is not byte aligned with the block size.
+  // Encrypt the first block alone if it is not byte aligned with the block size. The key stream
+  // before the offset is skipped, so the data is encrypted as is, without copies.
   if (block_offset > 0) {
     first_block_size = std::min(data_size, EncryptionParams::kBlockSize - block_offset);
-    uint8_t input_buf[EncryptionParams::kBlockSize];
-    uint8_t output_buf[EncryptionParams::kBlockSize];
-    memcpy(input_buf + block_offset, input.data(), first_block_size);
-    RETURN_NOT_OK(EncryptByBlock(
-        block_index, Slice(input_buf, EncryptionParams::kBlockSize), output_buf,
-        counter_overflow_workaround));
-    memcpy(output, output_buf + block_offset, first_block_size);
+    uint8_t skipped[EncryptionParams::kBlockSize] = {0};
+    RETURN_NOT_OK(SetBlockIndex(context.get(), block_index, counter_overflow_workaround));
+    RETURN_NOT_OK(Update(context.get(), block_index, skipped, block_offset, skipped));
+    RETURN_NOT_OK(Update(context.get(), block_index, input.data(), first_block_size,
+                         static_cast<uint8_t*>(output)));
     block_index++;
     data_size -= first_block_size;
   }
 
   // Encrypt the rest of the data.
   if (data_size > 0) {
-    RETURN_NOT_OK(EncryptByBlock(block_index,
+    RETURN_NOT_OK(EncryptByBlock(context.get(),
+                                 block_index,
                                  Slice(input.data() + first_block_size, data_size),
                                  static_cast<uint8_t*>(output) + first_block_size,
                                  counter_overflow_workaround));
@@ -127,19 +160,15 @@ bool BlockAccessCipherStream::UseOpensslCompatibleCounterOverflow() {
 }
 
 Status BlockAccessCipherStream::EncryptByBlock(
-    uint64_t block_index, const Slice& input, void* output,
+    EVP_CIPHER_CTX* context, uint64_t block_index, const Slice& input, void* output,
     EncryptionOverflowWorkaround counter_overflow_workaround) {
-  const uint64_t data_size = input.size();
-  if (data_size == 0) {
-    return Status::OK();
-  }
-  if (data_size > std::numeric_limits<int>::max()) {
-    return STATUS_FORMAT(InternalError,
-                         "Cannot encrypt/decrypt $0 bytes at once (it is more than $1 bytes). "
-                         "Encryption block index: $2.",
-                         data_size, std::numeric_limits<int>::max(), block_index);
-  }
+  RETURN_NOT_OK(SetBlockIndex(context, block_index, counter_overflow_workaround));
+  return Update(context, block_index, input.data(), input.size(), static_cast<uint8_t*>(output));
+}
 
+Status BlockAccessCipherStream::SetBlockIndex(
+    EVP_CIPHER_CTX* context, uint64_t block_index,
+    EncryptionOverflowWorkaround counter_overflow_workaround) {
   // Set the last 4 bytes of the iv based on counter + block_index.
   uint8_t iv[EncryptionParams::kBlockSize];
   memcpy(iv, encryption_params_->nonce, EncryptionParams::kBlockSize - 4);
@@ -147,35 +176,45 @@ Status BlockAccessCipherStream::EncryptByBlock(
   const uint64_t start_index = encryption_params_->counter + block_index;
   IncrementCounter(start_index, iv, counter_overflow_workaround);
 
-  // Lock the encryption op since we modify encryption context.
-  std::lock_guard<simple_spinlock> l(mutex_);
-
+  // Only the iv is set, the context keeps the expanded key.
   const int init_result =
-      EVP_EncryptInit_ex(encryption_context_.get(), /* cipher */ nullptr, /* impl */ nullptr,
-                         encryption_params_->key, iv);
+      EVP_EncryptInit_ex(context, /* cipher */ nullptr, /* impl */ nullptr, /* key */ nullptr,
+                         iv);
   if (init_result != 1) {
     return STATUS_FORMAT(InternalError,
-                         "EVP_EncryptInit_ex returned $0 when encrypting/decrypting $1 bytes "
-                         "at block index $2.",
-                         init_result, data_size, block_index);
+                         "EVP_EncryptInit_ex returned $0 when setting the iv of block index $1.",
+                         init_result, block_index);
+  }
+  return Status::OK();
+}
+
+Status BlockAccessCipherStream::Update(
+    EVP_CIPHER_CTX* context, uint64_t block_index, const uint8_t* input, size_t size,
+    uint8_t* output) {
+  if (size == 0) {
+    return Status::OK();
+  }
+  if (size > std::numeric_limits<int>::max()) {
+    return STATUS_FORMAT(InternalError,
+                         "Cannot encrypt/decrypt $0 bytes at once (it is more than $1 bytes). "
+                         "Encryption block index: $2.",
+                         size, std::numeric_limits<int>::max(), block_index);
   }
 
   // Perform the encryption.
   int bytes_updated = 0;
-  const int update_result = EVP_EncryptUpdate(
-      encryption_context_.get(), static_cast<uint8_t*>(output), &bytes_updated, input.data(),
-      data_size);
+  const int update_result = EVP_EncryptUpdate(context, output, &bytes_updated, input, size);
   if (update_result != 1) {
     return STATUS_FORMAT(InternalError,
                          "EVP_EncryptUpdate returned $0 when encrypting/decrypting $1 bytes "
                          "at block index $2.",
-                         update_result, data_size, block_index);
+                         update_result, size, block_index);
   }
-  if (bytes_updated != data_size) {
+  if (static_cast<size_t>(bytes_updated) != size) {
     return STATUS_FORMAT(InternalError,
                          "EVP_EncryptUpdate had to process $0 bytes but processed $1 bytes "
                          "instead. Encryption block index: $2.",
-                         data_size, bytes_updated, block_index);
+                         size, bytes_updated, block_index);
 
   }
 
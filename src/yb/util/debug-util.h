@@ -165,6 +165,15 @@ class StackTrace {
 
   uint64_t HashCode() const;
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  // Return address of the frame, the innermost frame has index 0.
+  void* frame(int index) const {
+    return frames_[index];
+  }
+
   explicit operator bool() const {
     return num_frames_ != 0;
   }
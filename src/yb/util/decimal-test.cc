@@ -13,6 +13,7 @@
 
 #include "yb/util/decimal.h"
 
+#include "yb/util/random_util.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 
@@ -231,6 +232,61 @@ TEST_F(DecimalTest, TestComparableEncoding) {
   }
 }
 
+TEST_F(DecimalTest, AddComparable) {
+  const std::vector<std::string> values = {
+      "0", "-0", "1", "-1", "0.05", "-0.05", "1.15", "-1.2", "120e0", "99999.99", "-99999.99",
+      "1.2e+10", "-2638.2e-7", "9223372036854775807", "-9223372036854775808",
+      // Values with more than 36 digits, or sums that overflow 128 bits, are added by Decimal.
+      "123456789012345678901234567890123456.7", "-0.00000000000000000000000000000000000001",
+      "99999999999999999999999999999999999", "1e+39", "1.5e+2147483654", "2.25e+2147483653",
+  };
+  for (const auto& lhs_str : values) {
+    for (const auto& rhs_str : values) {
+      SCOPED_TRACE(Format("$0 + $1", lhs_str, rhs_str));
+      Decimal lhs(lhs_str), rhs(rhs_str);
+      if ((lhs_str.find("e+21") == std::string::npos) !=
+          (rhs_str.find("e+21") == std::string::npos)) {
+        // Decimal would materialize billions of digits to align such exponents.
+        continue;
+      }
+      ASSERT_EQ((lhs + rhs).EncodeToComparable(),
+                ASSERT_RESULT(AddComparableDecimals(
+                    lhs.EncodeToComparable(), rhs.EncodeToComparable())));
+    }
+  }
+}
+
+TEST_F(DecimalTest, AddComparablePerf) {
+  constexpr int kNumValues = 100000;
+  std::vector<std::string> prices;
+  prices.reserve(kNumValues);
+  for (int i = 0; i != kNumValues; ++i) {
+    prices.push_back(Decimal(Format("$0.$1", RandomUniformInt(0, 10000000),
+                                    RandomUniformInt(10, 99))).EncodeToComparable());
+  }
+
+  auto start = MonoTime::Now();
+  auto decimal_sum = Decimal().EncodeToComparable();
+  for (const auto& price : prices) {
+    Decimal sum, value;
+    ASSERT_OK(sum.DecodeFromComparable(decimal_sum));
+    ASSERT_OK(value.DecodeFromComparable(price));
+    decimal_sum = (sum + value).EncodeToComparable();
+  }
+  auto decimal_time = MonoTime::Now() - start;
+
+  start = MonoTime::Now();
+  auto comparable_sum = Decimal().EncodeToComparable();
+  for (const auto& price : prices) {
+    comparable_sum = ASSERT_RESULT(AddComparableDecimals(comparable_sum, price));
+  }
+  auto comparable_time = MonoTime::Now() - start;
+
+  LOG(INFO) << "Sum of " << kNumValues << " prices: " << DecimalFromComparable(comparable_sum)
+            << ", by Decimal: " << decimal_time << ", by comparable encoding: " << comparable_time;
+  ASSERT_EQ(decimal_sum, comparable_sum);
+}
+
 TEST_F(DecimalTest, TestBigDecimalEncoding) {
   std::vector<Decimal> test_decimals;
   std::vector<std::string> encoded_strings;
@@ -11,6 +11,7 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <vector>
 #include <limits>
 #include <iomanip>
@@ -543,6 +544,155 @@ Decimal Decimal::operator+(const Decimal& other) const {
   return decimal;
 }
 
+namespace {
+
+// Decimals with at most this number of digits are added as 128 bit integers, without the digit
+// vectors of Decimal. Sum of two such values always fits 128 bits, after the alignment of their
+// exponents it could overflow, then Decimal is used.
+constexpr int kMaxFixedDigits = 36;
+// Larger exponents are left to Decimal, so that adjusting them by the number of digits does not
+// overflow.
+constexpr int64_t kMaxFixedExponent = std::numeric_limits<int32_t>::max();
+// The comparable encoding of the exponents that fit int64 takes at most this number of bytes.
+constexpr size_t kMaxExponentBytes = 10;
+
+// Fixed width form of decimal, its value is mantissa * 10^exponent.
+struct FixedDecimal {
+  __int128 mantissa;
+  int64_t exponent;
+};
+
+// Decodes the comparable encoding directly, returns false when the value does not fit
+// FixedDecimal.
+bool DecodeFixedDecimal(const Slice& slice, FixedDecimal* out) {
+  if (slice.empty()) {
+    return false;
+  }
+  if (slice[0] == 128) {
+    *out = FixedDecimal{0, 0};
+    return true;
+  }
+  const bool negative = slice[0] < 128;
+  uint8_t exponent_buffer[kMaxExponentBytes];
+  const size_t exponent_len = std::min(slice.size(), kMaxExponentBytes);
+  for (size_t i = 0; i != exponent_len; ++i) {
+    exponent_buffer[i] = negative ? static_cast<uint8_t>(~slice[i]) : slice[i];
+  }
+  int64_t exponent;
+  size_t num_exponent_bytes;
+  if (!VarInt::DecodeInt64FromComparable(
+          Slice(exponent_buffer, exponent_len), &exponent, &num_exponent_bytes,
+          /* num_reserved_bits */ 2) ||
+      exponent > kMaxFixedExponent || exponent < -kMaxFixedExponent) {
+    return false;
+  }
+  unsigned __int128 mantissa = 0;
+  int num_digits = 0;
+  for (size_t i = num_exponent_bytes; i < slice.size(); ++i) {
+    uint8_t byte = negative ? static_cast<uint8_t>(~slice[i]) : slice[i];
+    if (num_digits + 2 > kMaxFixedDigits) {
+      return false;
+    }
+    mantissa = mantissa * 100 + byte / 2;
+    num_digits += 2;
+    if (!(byte & 1)) {
+      // The mantissa is 0.d1d2...dk, so the integer formed by its digits is scaled by 10^-k.
+      const auto signed_mantissa = static_cast<__int128>(mantissa);
+      *out = FixedDecimal{negative ? -signed_mantissa : signed_mantissa, exponent - num_digits};
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AddFixedDecimals(FixedDecimal lhs, FixedDecimal rhs, FixedDecimal* out) {
+  if (lhs.mantissa == 0) {
+    *out = rhs;
+    return true;
+  }
+  if (rhs.mantissa == 0) {
+    *out = lhs;
+    return true;
+  }
+  if (lhs.exponent < rhs.exponent) {
+    std::swap(lhs, rhs);
+  }
+  // 10^39 does not fit 128 bits, so there is no reason to try bigger differences.
+  if (lhs.exponent - rhs.exponent > 38) {
+    return false;
+  }
+  for (; lhs.exponent != rhs.exponent; --lhs.exponent) {
+    if (__builtin_mul_overflow(lhs.mantissa, 10, &lhs.mantissa)) {
+      return false;
+    }
+  }
+  if (__builtin_add_overflow(lhs.mantissa, rhs.mantissa, &out->mantissa)) {
+    return false;
+  }
+  out->exponent = rhs.exponent;
+  return true;
+}
+
+// Appends the digits of the positive magnitude without its trailing zeros, starting from the lowest
+// one. Increments exponent by the number of skipped zeros.
+template <class T>
+void AppendDigitsReversed(T magnitude, int64_t* exponent, std::vector<uint8_t>* digits) {
+  while (magnitude % 10 == 0) {
+    magnitude /= 10;
+    ++*exponent;
+  }
+  while (magnitude != 0) {
+    digits->push_back(static_cast<uint8_t>(magnitude % 10));
+    magnitude /= 10;
+  }
+}
+
+// Produces the same encoding as Decimal::EncodeToComparable of the canonical form of the value.
+std::string EncodeFixedDecimal(const FixedDecimal& value) {
+  if (value.mantissa == 0) {
+    return string(1, static_cast<char>(128));
+  }
+  const bool negative = value.mantissa < 0;
+  auto magnitude = negative ? -static_cast<unsigned __int128>(value.mantissa)
+                            : static_cast<unsigned __int128>(value.mantissa);
+  int64_t exponent = value.exponent;
+  std::vector<uint8_t> digits;
+  // 128 bits hold at most 39 decimal digits.
+  digits.reserve(39);
+  if (magnitude <= std::numeric_limits<uint64_t>::max()) {
+    // Division of 128 bit integers is much slower, so it is avoided in the common case.
+    AppendDigitsReversed(static_cast<uint64_t>(magnitude), &exponent, &digits);
+  } else {
+    AppendDigitsReversed(magnitude, &exponent, &digits);
+  }
+  std::reverse(digits.begin(), digits.end());
+  exponent += digits.size();
+
+  string output = VarInt::EncodeInt64ToComparable(exponent, /* num_reserved_bits */ 2) +
+                  EncodeToDigitPairs(digits);
+  output[0] |= 0xc0;
+  if (negative) {
+    for (auto& c : output) {
+      c = ~c;
+    }
+  }
+  return output;
+}
+
+} // namespace
+
+Result<std::string> AddComparableDecimals(const Slice& lhs, const Slice& rhs) {
+  FixedDecimal lhs_fixed, rhs_fixed, sum;
+  if (DecodeFixedDecimal(lhs, &lhs_fixed) && DecodeFixedDecimal(rhs, &rhs_fixed) &&
+      AddFixedDecimals(lhs_fixed, rhs_fixed, &sum)) {
+    return EncodeFixedDecimal(sum);
+  }
+  Decimal lhs_decimal, rhs_decimal;
+  RETURN_NOT_OK(lhs_decimal.DecodeFromComparable(lhs));
+  RETURN_NOT_OK(rhs_decimal.DecodeFromComparable(rhs));
+  return (lhs_decimal + rhs_decimal).EncodeToComparable();
+}
+
 std::ostream& operator<<(ostream& os, const Decimal& d) {
   os << d.ToString();
   return os;
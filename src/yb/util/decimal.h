@@ -173,6 +173,11 @@ class Decimal {
 Decimal DecimalFromComparable(const Slice& slice);
 Decimal DecimalFromComparable(const std::string& string);
 
+// Returns the comparable encoding of the sum of the decimals with comparable encodings lhs and
+// rhs. The values with up to 36 digits are added as 128 bit integers directly from the encoding,
+// the other ones through Decimal.
+Result<std::string> AddComparableDecimals(const Slice& lhs, const Slice& rhs);
+
 std::ostream& operator<<(ostream& os, const Decimal& d);
 
 template <typename T>
@@ -25,6 +25,7 @@
 #include "yb/util/flag_tags.h"
 
 using yb::util::to_char_ptr;
+using yb::util::to_uchar_ptr;
 
 DEFINE_bool(encryption_counter_overflow_read_path_workaround, true,
             "Enable a read-path workaround for the encryption counter overflow bug #3707. "
@@ -51,8 +52,10 @@ Status EncryptedRandomAccessFile::ReadInternal(
   if (!scratch) {
     return STATUS(InvalidArgument, "scratch argument is null.");
   }
-  uint8_t* buf = static_cast<uint8_t*>(EncryptionBuffer::Get()->GetBuffer(n));
-  RETURN_NOT_OK(RandomAccessFileWrapper::Read(offset + header_size_, n, result, buf));
+  // The data is read to the scratch and decrypted in place, unless the file returned it from
+  // elsewhere, e.g. memory mapped.
+  RETURN_NOT_OK(RandomAccessFileWrapper::Read(
+      offset + header_size_, n, result, to_uchar_ptr(scratch)));
   RETURN_NOT_OK(stream_->Decrypt(offset, *result, scratch, counter_overflow_workaround));
   *result = Slice(scratch, result->size());
   return Status::OK();
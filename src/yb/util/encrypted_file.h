@@ -47,6 +47,10 @@ class EncryptedRandomAccessFile : public RandomAccessFileWrapper {
     return header_size_;
   }
 
+  void Readahead(uint64_t offset, size_t n) override {
+    RandomAccessFileWrapper::Readahead(offset + header_size_, n);
+  }
+
   Result<uint64_t> Size() const override {
     return VERIFY_RESULT(RandomAccessFileWrapper::Size()) - header_size_;
   }
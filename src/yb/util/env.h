@@ -185,10 +185,15 @@ class Env {
   // CREATE_IF_NON_EXISTING_TRUNCATE | opens + truncates | creates
   // CREATE_NON_EXISTING             | fails             | creates
   // OPEN_EXISTING                   | opens             | fails
+  // OPEN_EXISTING_OVERWRITE         | opens             | fails
+  //
+  // A writable file opened with OPEN_EXISTING_OVERWRITE starts writing at offset 0 and keeps the
+  // existing data as preallocated space, so the file is truncated to the written size on Close.
   enum CreateMode {
     CREATE_IF_NON_EXISTING_TRUNCATE,
     CREATE_NON_EXISTING,
-    OPEN_EXISTING
+    OPEN_EXISTING,
+    OPEN_EXISTING_OVERWRITE
   };
 
   Env() { }
@@ -239,6 +239,7 @@ static Status DoOpen(const string& filename, Env::CreateMode mode, int* fd, int
       flags |= O_CREAT | O_EXCL;
       break;
     case Env::OPEN_EXISTING:
+    case Env::OPEN_EXISTING_OVERWRITE:
       break;
     default:
       return STATUS(NotSupported, Substitute("Unknown create mode $0", mode));
@@ -270,12 +271,12 @@ Result<uint64_t> GetFileStat(const std::string& fname, const char* event, Extrac
 class PosixWritableFile : public WritableFile {
  public:
   PosixWritableFile(std::string fname, int fd, uint64_t file_size,
-                    bool sync_on_close)
+                    bool sync_on_close, uint64_t pre_allocated_size = 0)
       : filename_(std::move(fname)),
         fd_(fd),
         sync_on_close_(sync_on_close),
         filesize_(file_size),
-        pre_allocated_size_(0),
+        pre_allocated_size_(pre_allocated_size),
         pending_sync_(false) {}
 
   ~PosixWritableFile() {
@@ -1551,6 +1552,18 @@ class PosixFileFactory : public FileFactory {
       file_size = VERIFY_RESULT(GetFileSize(fname));
     }
     PosixWritableFile *posix_writable_file;
+    if (opts.mode == PosixEnv::OPEN_EXISTING_OVERWRITE) {
+      if (opts.o_direct) {
+        close(fd);
+        return STATUS(NotSupported, "Overwriting a file with O_DIRECT is not supported", fname);
+      }
+      // The existing data is treated as preallocated space, so it is truncated on close if not
+      // overwritten.
+      const uint64_t existing_size = VERIFY_RESULT(GetFileSize(fname));
+      result->reset(new PosixWritableFile(
+          fname, fd, 0 /* file_size */, opts.sync_on_close, existing_size));
+      return Status::OK();
+    }
 #if defined(__linux__)
     if (opts.o_direct)
       posix_writable_file = new PosixDirectIOWritableFile(fname, fd, file_size, opts.sync_on_close);
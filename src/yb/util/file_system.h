@@ -37,8 +37,16 @@ struct FileSystemOptions {
 
   // If true, then use mmap to read data.
   bool use_mmap_reads = false;
+
+  // If true, then read data with O_DIRECT, bypassing the OS page cache. Ignored when
+  // use_mmap_reads is set.
+  bool use_direct_reads = false;
 };
 
+// Alignment of file offsets, sizes and memory buffers required for I/O on files opened with
+// O_DIRECT.
+constexpr size_t kDirectIOAlignment = 4096;
+
 // Interface to filesystem.
 class FileSystem {
  public:
@@ -167,6 +175,11 @@ class RandomAccessFile : public FileWithUniqueId {
   // For cases when read-ahead is implemented in the platform dependent layer.
   virtual void EnableReadAhead() {}
 
+  // Returns true if reads of this file bypass the OS page cache.
+  virtual bool UseDirectIO() const {
+    return false;
+  }
+
   // For documentation, refer to FileWithUniqueId::GetUniqueId()
   virtual size_t GetUniqueId(char* id) const override {
     return 0; // Default implementation to prevent issues with backwards compatibility.
@@ -176,6 +189,10 @@ class RandomAccessFile : public FileWithUniqueId {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Asks the file system to asynchronously read n bytes starting at offset into its cache, so that
+  // following reads of this range do not block on the device. This is only a hint.
+  virtual void Readahead(uint64_t offset, size_t n) {}
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -232,12 +249,16 @@ class RandomAccessFileWrapper : public RandomAccessFile {
 
   void EnableReadAhead() override { return target_->EnableReadAhead(); }
 
+  bool UseDirectIO() const override { return target_->UseDirectIO(); }
+
   size_t GetUniqueId(char* id) const override {
     return target_->GetUniqueId(id);
   }
 
   void Hint(AccessPattern pattern) override { return target_->Hint(pattern); }
 
+  void Readahead(uint64_t offset, size_t n) override { return target_->Readahead(offset, n); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return target_->InvalidateCache(offset, length);
   }
@@ -16,6 +16,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -28,6 +30,10 @@
 #include <sys/syscall.h>
 #endif // __linux__
 
+#include <algorithm>
+#include <memory>
+
+#include "yb/util/alignment.h"
 #include "yb/util/coding.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/errno.h"
@@ -159,7 +165,8 @@ Status PosixSequentialFile::InvalidateCache(size_t offset, size_t length) {
 
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const FileSystemOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
+    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer),
+      use_direct_reads_(options.use_direct_reads) {
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
 }
 
@@ -168,6 +175,9 @@ PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
                                    uint8_t* scratch) const {
   ThreadRestrictions::AssertIOAllowed();
+  if (use_direct_reads_) {
+    return ReadDirect(offset, n, result, scratch);
+  }
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -199,6 +209,45 @@ Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
   return s;
 }
 
+Status PosixRandomAccessFile::ReadDirect(uint64_t offset, size_t n, Slice* result,
+                                         uint8_t* scratch) const {
+  const uint64_t aligned_offset = YB_ALIGN_DOWN(offset, kDirectIOAlignment);
+  const size_t prefix = offset - aligned_offset;
+  const size_t aligned_size = align_up(prefix + n, kDirectIOAlignment);
+
+  void* buffer = nullptr;
+  int err = posix_memalign(&buffer, kDirectIOAlignment, aligned_size);
+  if (err != 0) {
+    *result = Slice(scratch, 0);
+    return STATUS_IO_ERROR(filename_, err);
+  }
+  std::unique_ptr<uint8_t, decltype(&free)> buffer_holder(static_cast<uint8_t*>(buffer), &free);
+
+  Status s;
+  size_t read = 0;
+  while (read < aligned_size) {
+    ssize_t r = pread(fd_, buffer_holder.get() + read, aligned_size - read,
+                      static_cast<off_t>(aligned_offset + read));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      s = STATUS_IO_ERROR(filename_, errno);
+      break;
+    }
+    if (r == 0) {
+      // End of file.
+      break;
+    }
+    read += r;
+  }
+
+  const size_t available = read > prefix ? std::min(read - prefix, n) : 0;
+  memcpy(scratch, buffer_holder.get() + prefix, available);
+  *result = Slice(scratch, available);
+  return s;
+}
+
 Result<uint64_t> PosixRandomAccessFile::Size() const {
   TRACE_EVENT1("io", __PRETTY_FUNCTION__, "path", filename_);
   ThreadRestrictions::AssertIOAllowed();
@@ -252,6 +301,14 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+void PosixRandomAccessFile::Readahead(uint64_t offset, size_t n) {
+  if (use_direct_reads_) {
+    // Reads do not go through the page cache, so reading ahead into it would only pollute it.
+    return;
+  }
+  Fadvise(fd_, offset, n, POSIX_FADV_WILLNEED);
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef __linux__
   return Status::OK();
@@ -62,12 +62,20 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual void Readahead(uint64_t offset, size_t n) override;
   virtual CHECKED_STATUS InvalidateCache(size_t offset, size_t length) override;
 
+  bool UseDirectIO() const override { return use_direct_reads_; }
+
  private:
+  // Reads the aligned range covering [offset, offset + n) into a temporary aligned buffer and
+  // copies the requested part to scratch. Used for files opened with O_DIRECT.
+  CHECKED_STATUS ReadDirect(uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const;
+
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  bool use_direct_reads_;
 };
 
 } // namespace yb
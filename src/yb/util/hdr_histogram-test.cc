@@ -29,6 +29,9 @@
 // or implied.  See the License for the specific language governing permissions and limitations
 // under the License.
 //
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "yb/util/hdr_histogram.h"
@@ -125,4 +128,33 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, ConcurrentIncrement) {
+  constexpr int kThreads = 16;
+  constexpr int kIncrements = 100000;
+  HdrHistogram hist(10000, kSigDigits);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kThreads; ++i) {
+    threads.emplace_back([&hist, i] {
+      for (int j = 0; j != kIncrements; ++j) {
+        hist.Increment(i + 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Counters of all threads are summed up when read.
+  ASSERT_EQ(kThreads * kIncrements, hist.TotalCount());
+  ASSERT_EQ(kThreads * kIncrements, hist.CurrentCount());
+  ASSERT_EQ(kIncrements * kThreads * (kThreads + 1) / 2, hist.TotalSum());
+  ASSERT_EQ(1, hist.MinValue());
+  ASSERT_EQ(kThreads, hist.MaxValue());
+
+  hist.ResetPercentiles();
+  ASSERT_EQ(0, hist.CurrentCount());
+  ASSERT_EQ(0, hist.CurrentSum());
+  ASSERT_EQ(kThreads * kIncrements, hist.TotalCount());
+}
+
 } // namespace yb
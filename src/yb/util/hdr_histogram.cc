@@ -32,6 +32,7 @@
 #include "yb/util/hdr_histogram.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
 
@@ -59,10 +60,7 @@ HdrHistogram::HdrHistogram(uint64_t highest_trackable_value, int num_significant
     sub_bucket_half_count_magnitude_(0),
     sub_bucket_half_count_(0),
     sub_bucket_mask_(0),
-    total_count_(0),
-    total_sum_(0),
-    current_count_(0),
-    current_sum_(0),
+    counters_(new Counters[kCounterStripes]),
     min_value_(std::numeric_limits<Atomic64>::max()),
     max_value_(0),
     counts_(nullptr) {
@@ -78,10 +76,7 @@ HdrHistogram::HdrHistogram(const HdrHistogram& other)
     sub_bucket_half_count_magnitude_(0),
     sub_bucket_half_count_(0),
     sub_bucket_mask_(0),
-    total_count_(0),
-    total_sum_(0),
-    current_count_(0),
-    current_sum_(0),
+    counters_(new Counters[kCounterStripes]),
     min_value_(std::numeric_limits<Atomic64>::max()),
     max_value_(0),
     counts_(nullptr) {
@@ -89,8 +84,8 @@ HdrHistogram::HdrHistogram(const HdrHistogram& other)
 
   // Not a consistent snapshot but we try to roughly keep it close.
   // Copy the sum and min first.
-  NoBarrier_Store(&total_sum_, NoBarrier_Load(&other.total_sum_));
-  NoBarrier_Store(&current_sum_, NoBarrier_Load(&other.current_sum_));
+  NoBarrier_Store(&counters_[0].total_sum, other.TotalSum());
+  NoBarrier_Store(&counters_[0].current_sum, other.CurrentSum());
   NoBarrier_Store(&min_value_, NoBarrier_Load(&other.min_value_));
 
   uint64_t total_copied_count = 0;
@@ -103,16 +98,18 @@ HdrHistogram::HdrHistogram(const HdrHistogram& other)
   // Copy the max observed value last.
   NoBarrier_Store(&max_value_, NoBarrier_Load(&other.max_value_));
   // We must ensure the total is consistent with the copied counts.
-  NoBarrier_Store(&total_count_, NoBarrier_Load(&other.total_count_));
-  NoBarrier_Store(&current_count_, total_copied_count);
+  NoBarrier_Store(&counters_[0].total_count, other.TotalCount());
+  NoBarrier_Store(&counters_[0].current_count, total_copied_count);
 }
 
 void HdrHistogram::ResetPercentiles() {
   for (int i = 0; i < counts_array_length_; i++) {
     NoBarrier_Store(&counts_[i], 0);
   }
-  NoBarrier_Store(&current_count_, 0);
-  NoBarrier_Store(&current_sum_, 0);
+  for (size_t i = 0; i != kCounterStripes; ++i) {
+    NoBarrier_Store(&counters_[i].current_count, 0);
+    NoBarrier_Store(&counters_[i].current_sum, 0);
+  }
 
   NoBarrier_Store(&min_value_, std::numeric_limits<Atomic64>::max());
   NoBarrier_Store(&max_value_, 0);
@@ -188,10 +185,11 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
 
   // Increment bucket, total, and sum.
   NoBarrier_AtomicIncrement(&counts_[counts_index], count);
-  NoBarrier_AtomicIncrement(&total_count_, count);
-  NoBarrier_AtomicIncrement(&current_count_, count);
-  NoBarrier_AtomicIncrement(&total_sum_, value * count);
-  NoBarrier_AtomicIncrement(&current_sum_, value * count);
+  auto& counters = ThreadCounters();
+  NoBarrier_AtomicIncrement(&counters.total_count, count);
+  NoBarrier_AtomicIncrement(&counters.current_count, count);
+  NoBarrier_AtomicIncrement(&counters.total_sum, value * count);
+  NoBarrier_AtomicIncrement(&counters.current_sum, value * count);
 
   // Update min, if needed.
   {
@@ -212,6 +210,21 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   }
 }
 
+HdrHistogram::Counters& HdrHistogram::ThreadCounters() {
+  static std::atomic<size_t> next_thread_stripe{0};
+  static thread_local size_t thread_stripe =
+      next_thread_stripe.fetch_add(1, std::memory_order_relaxed) % kCounterStripes;
+  return counters_[thread_stripe];
+}
+
+uint64_t HdrHistogram::SumCounters(Atomic64 Counters::*counter) const {
+  Atomic64 result = 0;
+  for (size_t i = 0; i != kCounterStripes; ++i) {
+    result += NoBarrier_Load(&(counters_[i].*counter));
+  }
+  return result;
+}
+
 void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
                                                  int64_t expected_interval_between_samples) {
   Increment(value);
@@ -61,6 +61,7 @@
 
 #include "yb/gutil/atomicops.h"
 #include "yb/gutil/gscoped_ptr.h"
+#include "yb/gutil/port.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -114,21 +115,21 @@ class HdrHistogram {
   int SubBucketIndex(uint64_t value, int bucket_index) const;
 
   // Count of all events recorded.
-  uint64_t TotalCount() const { return base::subtle::NoBarrier_Load(&total_count_); }
+  uint64_t TotalCount() const { return SumCounters(&Counters::total_count); }
 
   // Count of all events recorded since last Reset. Resets to 0 after
   // ResetPercentiles.
   uint64_t CurrentCount() const {
-    return base::subtle::NoBarrier_Load(&current_count_);
+    return SumCounters(&Counters::current_count);
   }
 
   // Sum of all events recorded.
-  uint64_t TotalSum() const { return base::subtle::NoBarrier_Load(&total_sum_); }
+  uint64_t TotalSum() const { return SumCounters(&Counters::total_sum); }
 
   // Sum of all events recorded since last Reset. Resets to 0 after
   // ResetPercentiles.
   uint64_t CurrentSum() const {
-    return base::subtle::NoBarrier_Load(&current_sum_);
+    return SumCounters(&Counters::current_sum);
   }
 
   // Return number of items at index.
@@ -203,9 +204,24 @@ class HdrHistogram {
   static const int kMinValidNumSignificantDigits = 1;
   static const int kMaxValidNumSignificantDigits = 5;
 
+  // Sums and counts are updated by every Increment() from all threads, so they are kept in
+  // stripes picked by thread, each on its own cache line, and summed up when read.
+  struct Counters {
+    base::subtle::Atomic64 total_count = 0;
+    base::subtle::Atomic64 total_sum = 0;
+    base::subtle::Atomic64 current_count = 0;
+    base::subtle::Atomic64 current_sum = 0;
+    char padding[CACHELINE_SIZE - 4 * sizeof(base::subtle::Atomic64)];
+  };
+
+  static constexpr size_t kCounterStripes = 8;
+
   void Init();
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
 
+  Counters& ThreadCounters();
+  uint64_t SumCounters(base::subtle::Atomic64 Counters::*counter) const;
+
   uint64_t highest_trackable_value_;
   int num_significant_digits_;
   int counts_array_length_;
@@ -218,12 +234,9 @@ class HdrHistogram {
   uint32_t sub_bucket_mask_;
 
   // Also hot.
-  // Non-resetting sum and counts.
-  base::subtle::Atomic64 total_count_;
-  base::subtle::Atomic64 total_sum_;
+  // Non-resetting total sum and count, and the current ones that are reset with percentiles.
+  gscoped_array<Counters> counters_;
   // Resetting values
-  base::subtle::Atomic64 current_count_;
-  base::subtle::Atomic64 current_sum_;
   base::subtle::Atomic64 min_value_;
   base::subtle::Atomic64 max_value_;
   gscoped_array<base::subtle::Atomic64> counts_;
@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/util/mem_attribution.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(mem_attribution_sample_interval_bytes);
+
+namespace yb {
+
+namespace {
+
+uint64_t TaggedBytes(const std::string& tag) {
+  uint64_t result = 0;
+  for (const auto& site : GetAllocationSamples().sites) {
+    if (site.tag && site.tag == tag) {
+      result += site.bytes;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(MemAttributionTest, Tags) {
+  ASSERT_EQ(nullptr, ScopedAllocationTag::Current());
+  {
+    ScopedAllocationTag outer("outer");
+    ASSERT_STREQ("outer", ScopedAllocationTag::Current());
+    {
+      ScopedAllocationTag inner("inner");
+      ASSERT_STREQ("inner", ScopedAllocationTag::Current());
+    }
+    ASSERT_STREQ("outer", ScopedAllocationTag::Current());
+  }
+  ASSERT_EQ(nullptr, ScopedAllocationTag::Current());
+}
+
+#ifdef TCMALLOC_ENABLED
+TEST(MemAttributionTest, SampledAllocations) {
+  constexpr size_t kBlockSize = 1_KB;
+  constexpr size_t kNumBlocks = 1000;
+  FLAGS_mem_attribution_sample_interval_bytes = 4_KB;
+  ASSERT_OK(StartAllocationSampling());
+  ASSERT_TRUE(AllocationSamplingStarted());
+  ResetAllocationSamples();
+
+  std::vector<std::unique_ptr<char[]>> blocks;
+  blocks.reserve(kNumBlocks + 1);
+  {
+    ScopedAllocationTag tag("test");
+    for (size_t i = 0; i != kNumBlocks; ++i) {
+      blocks.emplace_back(new char[kBlockSize]);
+    }
+    // A large allocation accounts for several samples.
+    blocks.emplace_back(new char[100_KB]);
+  }
+
+  const auto tagged_bytes = TaggedBytes("test");
+  const auto allocated_bytes = kNumBlocks * kBlockSize + 100_KB;
+  ASSERT_GE(tagged_bytes, allocated_bytes - 4_KB);
+  ASSERT_LE(tagged_bytes, allocated_bytes + 4_KB);
+
+  ResetAllocationSamples();
+  ASSERT_EQ(0u, TaggedBytes("test"));
+}
+#endif
+
+} // namespace yb
@@ -0,0 +1,207 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/util/mem_attribution.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#ifdef TCMALLOC_ENABLED
+#include <gperftools/malloc_hook.h>
+#endif
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/gutil/port.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/locks.h"
+
+DEFINE_int64(mem_attribution_sample_interval_bytes, 0,
+             "Sample an allocation each this number of allocated bytes, attributing it to the "
+             "subsystem of the allocating thread and to its call site, see "
+             "/mem-trackers/attribution. 0 to disable. Only read when the server is started.");
+TAG_FLAG(mem_attribution_sample_interval_bytes, advanced);
+
+namespace yb {
+
+namespace {
+
+__thread const char* allocation_tag ATTRIBUTE_INITIAL_EXEC = nullptr;
+
+#ifdef TCMALLOC_ENABLED
+
+constexpr int kMaxFrames = 16;
+constexpr size_t kNumSites = 4096;
+constexpr size_t kMaxProbes = 32;
+
+// The sites are kept in a fixed open addressing table, because nothing could be allocated while
+// recording a sample from the allocation hook.
+struct SiteEntry {
+  // 0 if the entry is not used.
+  uint64_t hash;
+  const char* tag;
+  int num_frames;
+  void* frames[kMaxFrames];
+  uint64_t samples;
+};
+
+// Set before the hook is added, 0 if the sampling was not started.
+std::atomic<int64_t> sample_interval{0};
+
+simple_spinlock sites_lock;
+SiteEntry sites[kNumSites] GUARDED_BY(sites_lock);
+uint64_t dropped_samples GUARDED_BY(sites_lock) = 0;
+
+__thread int64_t bytes_until_sample ATTRIBUTE_INITIAL_EXEC = 0;
+__thread bool in_hook ATTRIBUTE_INITIAL_EXEC = false;
+
+uint64_t HashSite(const char* tag, void* const* frames, int num_frames) {
+  uint64_t result = reinterpret_cast<uintptr_t>(tag) ^ 0x9e3779b97f4a7c15ULL;
+  for (int i = 0; i != num_frames; ++i) {
+    result = (result ^ reinterpret_cast<uintptr_t>(frames[i])) * 0x100000001b3ULL;
+  }
+  return result == 0 ? 1 : result;
+}
+
+void RecordSample(uint64_t samples) {
+  void* frames[kMaxFrames];
+  const int num_frames = MallocHook::GetCallerStackTrace(frames, kMaxFrames, 0);
+  const char* tag = allocation_tag;
+  const auto hash = HashSite(tag, frames, num_frames);
+
+  std::lock_guard<simple_spinlock> lock(sites_lock);
+  for (size_t probe = 0; probe != kMaxProbes; ++probe) {
+    auto& site = sites[(hash + probe) % kNumSites];
+    if (site.hash == 0) {
+      site.hash = hash;
+      site.tag = tag;
+      site.num_frames = num_frames;
+      std::copy(frames, frames + num_frames, site.frames);
+      site.samples = samples;
+      return;
+    }
+    if (site.hash == hash && site.tag == tag && site.num_frames == num_frames &&
+        std::equal(frames, frames + num_frames, site.frames)) {
+      site.samples += samples;
+      return;
+    }
+  }
+  dropped_samples += samples;
+}
+
+void NewHook(const void* ptr, size_t size) {
+  if (PREDICT_FALSE(in_hook)) {
+    return;
+  }
+  bytes_until_sample -= static_cast<int64_t>(size);
+  if (PREDICT_TRUE(bytes_until_sample > 0)) {
+    return;
+  }
+  const auto interval = sample_interval.load(std::memory_order_relaxed);
+  // A large allocation accounts for several samples.
+  const int64_t samples = 1 + (-bytes_until_sample) / interval;
+  bytes_until_sample += samples * interval;
+  in_hook = true;
+  RecordSample(samples);
+  in_hook = false;
+}
+
+#endif // TCMALLOC_ENABLED
+
+} // namespace
+
+ScopedAllocationTag::ScopedAllocationTag(const char* tag) : previous_(allocation_tag) {
+  allocation_tag = tag;
+}
+
+ScopedAllocationTag::~ScopedAllocationTag() {
+  allocation_tag = previous_;
+}
+
+const char* ScopedAllocationTag::Current() {
+  return allocation_tag;
+}
+
+Status StartAllocationSampling() {
+  const auto interval = FLAGS_mem_attribution_sample_interval_bytes;
+  if (interval <= 0) {
+    return Status::OK();
+  }
+#ifdef TCMALLOC_ENABLED
+  int64_t expected = 0;
+  if (!sample_interval.compare_exchange_strong(expected, interval)) {
+    return Status::OK();
+  }
+  if (!MallocHook::AddNewHook(&NewHook)) {
+    sample_interval.store(0);
+    return STATUS(RuntimeError, "Failed to add the tcmalloc allocation hook");
+  }
+  LOG(INFO) << "Sampling an allocation each " << interval << " bytes";
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Allocation sampling requires tcmalloc");
+#endif
+}
+
+bool AllocationSamplingStarted() {
+#ifdef TCMALLOC_ENABLED
+  return sample_interval.load() != 0;
+#else
+  return false;
+#endif
+}
+
+AllocationSamples GetAllocationSamples() {
+  AllocationSamples result;
+#ifdef TCMALLOC_ENABLED
+  result.interval_bytes = sample_interval.load();
+  if (result.interval_bytes == 0) {
+    return result;
+  }
+  // Copied under the lock without allocating, since the lock is also taken by the hook.
+  std::unique_ptr<SiteEntry[]> copy(new SiteEntry[kNumSites]);
+  {
+    std::lock_guard<simple_spinlock> lock(sites_lock);
+    std::copy(sites, sites + kNumSites, copy.get());
+    result.dropped_samples = dropped_samples;
+  }
+  for (size_t i = 0; i != kNumSites; ++i) {
+    const auto& entry = copy[i];
+    if (entry.hash == 0) {
+      continue;
+    }
+    AllocationSite site;
+    site.tag = entry.tag;
+    site.frames.assign(entry.frames, entry.frames + entry.num_frames);
+    site.samples = entry.samples;
+    site.bytes = entry.samples * result.interval_bytes;
+    result.sites.push_back(std::move(site));
+  }
+#endif
+  return result;
+}
+
+void ResetAllocationSamples() {
+#ifdef TCMALLOC_ENABLED
+  std::lock_guard<simple_spinlock> lock(sites_lock);
+  std::fill(sites, sites + kNumSites, SiteEntry());
+  dropped_samples = 0;
+#endif
+}
+
+} // namespace yb
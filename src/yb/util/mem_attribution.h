@@ -0,0 +1,72 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_UTIL_MEM_ATTRIBUTION_H
+#define YB_UTIL_MEM_ATTRIBUTION_H
+
+#include <string>
+#include <vector>
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+// Tags the allocations done by the current thread while in scope with a subsystem, so the
+// sampled allocations are attributed to it. The innermost tag wins.
+class ScopedAllocationTag {
+ public:
+  // The tag should have a static storage duration, e.g. be a string literal.
+  explicit ScopedAllocationTag(const char* tag);
+  ~ScopedAllocationTag();
+
+  // The tag of the current thread, null if it has none.
+  static const char* Current();
+
+ private:
+  const char* previous_;
+};
+
+// A call site of the sampled allocations of a subsystem.
+struct AllocationSite {
+  // Null for the allocations done without a tag.
+  const char* tag = nullptr;
+  std::vector<void*> frames;
+  uint64_t samples = 0;
+  // Estimated number of bytes allocated, i.e. the samples times the sampling interval.
+  uint64_t bytes = 0;
+};
+
+struct AllocationSamples {
+  uint64_t interval_bytes = 0;
+  // Samples not attributed because there was no room left for their call sites.
+  uint64_t dropped_samples = 0;
+  std::vector<AllocationSite> sites;
+};
+
+// Starts sampling an allocation each mem_attribution_sample_interval_bytes allocated bytes with
+// tcmalloc hooks, recording the tag of the allocating thread and the call site. Does nothing if
+// the interval is 0.
+CHECKED_STATUS StartAllocationSampling();
+
+bool AllocationSamplingStarted();
+
+// Returns the sampled allocations since the sampling was started or last reset. The bytes are
+// allocated bytes, not the bytes that are still in use.
+AllocationSamples GetAllocationSamples();
+
+void ResetAllocationSamples();
+
+} // namespace yb
+
+#endif // YB_UTIL_MEM_ATTRIBUTION_H
@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -46,6 +47,7 @@
 
 DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int64(mem_tracker_update_consumption_interval_us);
+DECLARE_int64(mem_tracker_consumption_batch_bytes);
 
 namespace yb {
 
@@ -358,4 +360,69 @@ TEST(MemTrackerTest, UnregisterFromParent) {
   shared_ptr<MemTracker> c2 = MemTracker::CreateTracker("child", p);
 }
 
+namespace {
+
+// Consumes and releases memory on the child tracker from many threads, returns the time spent.
+MonoDelta ConcurrentConsumption(const MemTrackerPtr& child) {
+  constexpr int kThreads = 64;
+  constexpr int kIterations = 100000;
+  std::vector<std::thread> threads;
+  const auto start = MonoTime::Now();
+  for (int i = 0; i != kThreads; ++i) {
+    threads.emplace_back([&child] {
+      for (int j = 0; j != kIterations; ++j) {
+        child->Consume(128);
+        child->Release(128);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return MonoTime::Now() - start;
+}
+
+} // namespace
+
+TEST(MemTrackerTest, BatchedConsumption) {
+  constexpr int64_t kBatchBytes = 64_KB;
+
+  MonoDelta unbatched_time;
+  {
+    auto parent = MemTracker::CreateTracker("parent");
+    auto child = MemTracker::CreateTracker("child", parent);
+    unbatched_time = ConcurrentConsumption(child);
+    ASSERT_EQ(child->consumption(), 0);
+    ASSERT_EQ(parent->consumption(), 0);
+  }
+
+  FLAGS_mem_tracker_consumption_batch_bytes = kBatchBytes;
+  auto parent = MemTracker::CreateTracker("parent");
+  auto child = MemTracker::CreateTracker("child", parent);
+
+  // Small changes are not added to the parent until a batch is collected, but are seen by the
+  // tracker itself.
+  child->Consume(1_KB);
+  ASSERT_EQ(child->consumption(), 1_KB);
+  ASSERT_EQ(parent->consumption(), 0);
+  child->Consume(kBatchBytes);
+  ASSERT_EQ(parent->consumption(), 1_KB + kBatchBytes);
+  child->Release(1_KB + kBatchBytes);
+  ASSERT_EQ(child->consumption(), 0);
+  ASSERT_EQ(parent->consumption(), 0);
+
+  const auto batched_time = ConcurrentConsumption(child);
+  LOG(INFO) << "Unbatched: " << unbatched_time << ", batched: " << batched_time;
+  ASSERT_EQ(child->consumption(), 0);
+  // Each of the 16 stripes of the child could hold up to a batch.
+  ASSERT_LE(std::abs(parent->consumption()), kBatchBytes * 16);
+
+  // The pending consumption is added to the ancestors when the tracker is destroyed.
+  child->Consume(1_KB);
+  child.reset();
+  ASSERT_EQ(parent->consumption(), 0);
+
+  FLAGS_mem_tracker_consumption_batch_bytes = 0;
+}
+
 } // namespace yb
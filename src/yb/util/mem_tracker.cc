@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
 #include <limits>
 #include <list>
@@ -103,6 +104,14 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_consumption_batch_bytes, 0,
+             "Consumption changes of a memory tracker are batched per thread up to this many "
+             "bytes before they are added to the tracker and its ancestors, so threads do not "
+             "contend on the shared counters. The consumption of the ancestors could then be off "
+             "by up to 16 batches per descendant tracker, also in limit checks. 0 to add every "
+             "change right away.");
+TAG_FLAG(mem_tracker_consumption_batch_bytes, advanced);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -310,6 +319,10 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id,
   VLOG(1) << "Creating tracker " << ToString();
   UpdateConsumption();
 
+  if (!consumption_functor_ && FLAGS_mem_tracker_consumption_batch_bytes > 0) {
+    pending_consumption_.reset(new PendingConsumptionStripe[kPendingConsumptionStripes]);
+  }
+
   all_trackers_.push_back(this);
   if (has_limit()) {
     limit_trackers_.push_back(this);
@@ -334,6 +347,7 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id,
 
 MemTracker::~MemTracker() {
   VLOG(1) << "Destroying tracker " << ToString();
+  FlushPendingConsumption();
   if (!consumption_functor_) {
     DCHECK_EQ(consumption(), 0) << "Memory tracker " << ToString();
   }
@@ -475,10 +489,60 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  if (pending_consumption_) {
+    bytes = AddPendingConsumption(bytes);
+    if (bytes == 0) {
+      return;
+    }
+  }
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
       IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
+      // Batched releases could be added before the consumptions they release.
+      DCHECK(FLAGS_mem_tracker_consumption_batch_bytes > 0 ||
+             tracker->consumption_.current_value() >= 0);
+    }
+  }
+}
+
+int64_t MemTracker::PendingConsumption() const {
+  if (!pending_consumption_) {
+    return 0;
+  }
+  int64_t result = 0;
+  for (size_t i = 0; i != kPendingConsumptionStripes; ++i) {
+    result += pending_consumption_[i].value.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+int64_t MemTracker::AddPendingConsumption(int64_t delta) {
+  static std::atomic<size_t> next_thread_stripe{0};
+  static thread_local size_t thread_stripe =
+      next_thread_stripe.fetch_add(1, std::memory_order_relaxed) % kPendingConsumptionStripes;
+
+  auto& pending = pending_consumption_[thread_stripe].value;
+  const auto value = pending.fetch_add(delta, std::memory_order_relaxed) + delta;
+  if (std::abs(value) < FLAGS_mem_tracker_consumption_batch_bytes) {
+    return 0;
+  }
+  return pending.exchange(0, std::memory_order_relaxed);
+}
+
+void MemTracker::FlushPendingConsumption() {
+  if (!pending_consumption_) {
+    return;
+  }
+  int64_t delta = 0;
+  for (size_t i = 0; i != kPendingConsumptionStripes; ++i) {
+    delta += pending_consumption_[i].value.exchange(0, std::memory_order_relaxed);
+  }
+  if (delta == 0) {
+    return;
+  }
+  for (auto& tracker : all_trackers_) {
+    if (!tracker->UpdateConsumption()) {
+      IncrementBy(delta, &tracker->consumption_, tracker->metrics_);
     }
   }
 }
@@ -560,16 +624,25 @@ void MemTracker::Release(int64_t bytes) {
     LogUpdate(false, bytes);
   }
 
+  int64_t delta = -bytes;
+  if (pending_consumption_) {
+    delta = AddPendingConsumption(delta);
+    if (delta == 0) {
+      return;
+    }
+  }
+
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
-      IncrementBy(-bytes, &tracker->consumption_, tracker->metrics_);
+      IncrementBy(delta, &tracker->consumption_, tracker->metrics_);
       // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
       // reported amount, the subsequent call to FunctionContext::Free() may cause the
       // process mem tracker to go negative until it is synced back to the tcmalloc
       // metric. Don't blow up in this case. (Note that this doesn't affect non-process
       // trackers since we can enforce that the reported memory usage is internally
       // consistent.)
-      DCHECK_GE(tracker->consumption_.current_value(), 0) << "Tracker: " << tracker->ToString();
+      DCHECK(FLAGS_mem_tracker_consumption_batch_bytes > 0 ||
+             tracker->consumption_.current_value() >= 0) << "Tracker: " << tracker->ToString();
     }
   }
 }
@@ -34,6 +34,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
@@ -46,6 +47,7 @@
 
 #include <boost/optional.hpp>
 
+#include "yb/gutil/port.h"
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/high_water_mark.h"
 #include "yb/util/locks.h"
@@ -320,7 +322,7 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   // Returns the memory consumed in bytes.
   int64_t consumption() const {
-    return consumption_.current_value();
+    return consumption_.current_value() + PendingConsumption();
   }
 
   int64_t GetUpdatedConsumption(bool force = false) {
@@ -430,6 +432,26 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // Consumption of this tracker that is not added to it and its ancestors yet, batched by
+  // stripes picked by thread, so threads updating the same trackers do not contend on
+  // consumption_ of this tracker and its ancestors. Only allocated when
+  // mem_tracker_consumption_batch_bytes is set.
+  struct PendingConsumptionStripe {
+    std::atomic<int64_t> value{0};
+    char padding[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+  };
+  static constexpr size_t kPendingConsumptionStripes = 16;
+  std::unique_ptr<PendingConsumptionStripe[]> pending_consumption_;
+
+  int64_t PendingConsumption() const;
+
+  // Adds delta to the pending consumption of the thread stripe, returns the consumption to add to
+  // the trackers when the stripe reached the batch size, 0 otherwise.
+  int64_t AddPendingConsumption(int64_t delta);
+
+  // Adds the pending consumption of all stripes to the trackers.
+  void FlushPendingConsumption();
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
@@ -441,11 +441,13 @@ class InMemoryEnv : public EnvWrapper {
         case OPEN_EXISTING:
           result->reset(new Type(file_map_[fname]));
           return Status::OK();
+        case OPEN_EXISTING_OVERWRITE:
+          return STATUS(NotSupported, fname, "Overwriting files is not supported by memenv");
         default:
           return STATUS(NotSupported, Substitute("Unknown create mode $0",
                                                  mode));
       }
-    } else if (mode == OPEN_EXISTING) {
+    } else if (mode == OPEN_EXISTING || mode == OPEN_EXISTING_OVERWRITE) {
       return STATUS(IOError, fname, "File not found");
     }
 
@@ -30,6 +30,7 @@
 // under the License.
 //
 
+#include <sstream>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -370,4 +371,39 @@ TEST_F(MetricsTest, TestDumpJsonPrototypes) {
   ASSERT_TRUE(ContainsKey(seen_metrics, "test_hist"));
 }
 
+METRIC_DEFINE_entity(tablet);
+METRIC_DEFINE_counter(tablet, test_tablet_counter, "Test Tablet Counter", MetricUnit::kRequests,
+                      "Counter of a tablet");
+METRIC_DEFINE_histogram(tablet, test_tablet_hist, "Test Tablet Histogram",
+                        MetricUnit::kMilliseconds, "Histogram of a tablet", 1000000, 3);
+
+TEST_F(MetricsTest, PrometheusTableAggregation) {
+  std::vector<scoped_refptr<MetricEntity>> tablets;
+  for (int i = 1; i <= 2; ++i) {
+    MetricEntity::AttributeMap attrs;
+    attrs["table_id"] = "test-table-id";
+    attrs["table_name"] = "test_table";
+    auto tablet = METRIC_ENTITY_tablet.Instantiate(
+        &registry_, Format("test-tablet-$0", i), attrs);
+    METRIC_test_tablet_counter.Instantiate(tablet)->IncrementBy(i);
+    METRIC_test_tablet_hist.Instantiate(tablet)->Increment(10 * i);
+    tablets.push_back(tablet);
+  }
+
+  std::stringstream output;
+  PrometheusWriter writer(&output);
+  ASSERT_OK(registry_.WriteForPrometheus(&writer));
+  const auto text = output.str();
+  LOG(INFO) << "Prometheus output: " << text;
+
+  // Tablets of the same table are exported as a single series, that includes all of them.
+  ASSERT_EQ(text.find("test-tablet-"), std::string::npos);
+  ASSERT_STR_CONTAINS(text, "test_tablet_counter{");
+  ASSERT_STR_CONTAINS(text, "table_id=\"test-table-id\",table_name=\"test_table\"} 3 ");
+  ASSERT_STR_CONTAINS(text, "test_tablet_hist_sum{");
+  ASSERT_STR_CONTAINS(text, "table_name=\"test_table\"} 30 ");
+  ASSERT_STR_CONTAINS(text, "test_tablet_hist_count{");
+  ASSERT_STR_CONTAINS(text, "table_name=\"test_table\"} 2 ");
+}
+
 } // namespace yb
@@ -289,46 +289,47 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 }
 
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
-  // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
-  typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
-  OrderedMetricMap metrics;
-  AttributeMap attrs;
+  const bool is_tablet = strcmp(prototype_->name(), "tablet") == 0;
+  if (!is_tablet && strcmp(prototype_->name(), "server") != 0 &&
+      strcmp(prototype_->name(), "cluster") != 0) {
+    return Status::OK();
+  }
+
+  // Prometheus does not need the metrics to be ordered, so they are just copied to a vector, that
+  // keeps the time under the lock short when there are many tablets.
+  std::vector<scoped_refptr<Metric>> metrics;
+  AttributeMap prometheus_attr;
   std::vector<ExternalPrometheusMetricsCb> external_metrics_cbs;
   {
     // Snapshot the metrics, attributes & external metrics callbacks in this metrics entity. (Note:
     // this is not guaranteed to be a consistent snapshot).
     std::lock_guard<simple_spinlock> l(lock_);
-    attrs = attributes_;
+    // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
+    // We ignore the tablet part to squash at the table level.
+    if (is_tablet) {
+      prometheus_attr["table_id"] = FindWithDefault(attributes_, "table_id", "");
+      prometheus_attr["table_name"] = FindWithDefault(attributes_, "table_name", "");
+    } else {
+      prometheus_attr = attributes_;
+    }
     external_metrics_cbs = external_prometheus_metrics_cbs_;
+    metrics.reserve(metric_map_.size());
     for (const MetricMap::value_type& val : metric_map_) {
-      const MetricPrototype* prototype = val.first;
-      const scoped_refptr<Metric>& metric = val.second;
-
-      InsertOrDie(&metrics, prototype->name(), metric);
+      metrics.push_back(val.second);
     }
   }
-  AttributeMap prometheus_attr;
-  // Per tablet metrics come with tablet_id, as well as table_id and table_name attributes.
-  // We ignore the tablet part to squash at the table level.
-  if (strcmp(prototype_->name(), "tablet") == 0)  {
-    prometheus_attr["table_id"] = attrs["table_id"];
-    prometheus_attr["table_name"] = attrs["table_name"];
-  } else if (strcmp(prototype_->name(), "server") == 0 ||
-      strcmp(prototype_->name(), "cluster") == 0) {
-    prometheus_attr = attrs;
+  if (!is_tablet) {
     // This is tablet_id in the case of tablet, but otherwise names the server type, eg: yb.master
     prometheus_attr["metric_id"] = id_;
-  } else {
-    return Status::OK();
   }
   // This is currently tablet / server / cluster.
   prometheus_attr["metric_type"] = prototype_->name();
   prometheus_attr["exported_instance"] = FLAGS_metric_node_name;
 
-  for (OrderedMetricMap::value_type& val : metrics) {
-    WARN_NOT_OK(val.second->WriteForPrometheus(writer, prometheus_attr),
-                strings::Substitute("Failed to write $0 as Prometheus", val.first));
-
+  for (const auto& metric : metrics) {
+    WARN_NOT_OK(metric->WriteForPrometheus(writer, prometheus_attr),
+                strings::Substitute("Failed to write $0 as Prometheus",
+                                    metric->prototype()->name()));
   }
   // Run the external metrics collection callback if there is one set.
   for (const ExternalPrometheusMetricsCb& cb : external_metrics_cbs) {
@@ -758,7 +759,19 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
     histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
-    export_percentiles_(proto->export_percentiles()) {
+    export_percentiles_(proto->export_percentiles()),
+    sum_metric_name_(std::string(prototype_->name()) + "_sum"),
+    count_metric_name_(std::string(prototype_->name()) + "_count") {
+}
+
+Histogram::Histogram(std::unique_ptr<HistogramPrototype> proto)
+  : Metric(std::move(proto)),
+    histogram_(new HdrHistogram(
+        down_cast<const HistogramPrototype*>(prototype())->max_trackable_value(),
+        down_cast<const HistogramPrototype*>(prototype())->num_sig_digits())),
+    export_percentiles_(down_cast<const HistogramPrototype*>(prototype())->export_percentiles()),
+    sum_metric_name_(std::string(prototype_->name()) + "_sum"),
+    count_metric_name_(std::string(prototype_->name()) + "_count") {
 }
 
 void Histogram::Increment(int64_t value) {
@@ -780,6 +793,17 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
+  // Representing the sum and count require suffixed names.
+  RETURN_NOT_OK(writer->WriteSingleEntry(attr, sum_metric_name_, histogram_->TotalSum()));
+  RETURN_NOT_OK(writer->WriteSingleEntry(attr, count_metric_name_, histogram_->TotalCount()));
+
+  // Copying the whole histogram is only needed for the percentiles, that are not exported for
+  // most of the histograms.
+  if (!export_percentiles_ || !FLAGS_expose_metric_histogram_percentiles) {
+    histogram_->ResetPercentiles();
+    return Status::OK();
+  }
+
   HdrHistogram snapshot(*histogram_);
   // HdrHistogram reports percentiles based on all the data points from the
   // begining of time. We are interested in the percentiles based on just
@@ -787,16 +811,10 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
   // between each invocation.
   histogram_->ResetPercentiles();
 
-  // Representing the sum and count require suffixed names.
-  std::string hist_name = prototype_->name();
-  auto copy_of_attr = attr;
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_sum", snapshot.TotalSum()));
-  RETURN_NOT_OK(writer->WriteSingleEntry(
-        copy_of_attr, hist_name + "_count", snapshot.TotalCount()));
-
+  const std::string hist_name = prototype_->name();
   // Copy the label map to add the quatiles.
-  if (export_percentiles_ && FLAGS_expose_metric_histogram_percentiles) {
+  {
+    auto copy_of_attr = attr;
     copy_of_attr["quantile"] = "p50";
     RETURN_NOT_OK(writer->WriteSingleEntry(copy_of_attr, hist_name,
                                            snapshot.ValueAtPercentile(50)));
@@ -494,6 +494,7 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
   scoped_refptr<Counter> FindOrCreateCounter(const CounterPrototype* proto);
   scoped_refptr<Histogram> FindOrCreateHistogram(const HistogramPrototype* proto);
+  scoped_refptr<Histogram> FindOrCreateHistogram(std::unique_ptr<HistogramPrototype> proto);
 
   template<typename T>
   scoped_refptr<AtomicGauge<T>> FindOrCreateGauge(const GaugePrototype<T>* proto,
@@ -610,14 +611,15 @@ class PrometheusWriter {
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
     auto it = attr.find("table_id");
     if (it != attr.end()) {
-      // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
+      // For tablet level metrics, we roll up on the table level, so a scrape exports a series
+      // per table rather than per tablet.
+      auto table_it = per_table_values_.find(it->second);
+      if (table_it == per_table_values_.end()) {
         // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
+        per_table_attributes_.emplace(it->second, attr);
+        table_it = per_table_values_.emplace(it->second, MetricValues()).first;
       }
+      table_it->second[name] += value;
     } else {
       // For non-tablet level metrics, export them directly.
       RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
@@ -659,10 +661,12 @@ class PrometheusWriter {
     return Status::OK();
   }
 
+  typedef std::map<std::string, double> MetricValues;
+
   // Map from table_id to attributes
   std::map<std::string, MetricEntity::AttributeMap> per_table_attributes_;
   // Map from table_id to map of metric_name to value
-  std::map<std::string, std::map<std::string, double>> per_table_values_;
+  std::map<std::string, MetricValues> per_table_values_;
   // Output stream
   std::stringstream* output_;
   // Timestamp for all metrics belonging to this writer instance.
@@ -1214,6 +1218,12 @@ inline void IncrementCounter(const scoped_refptr<Counter>& counter) {
   }
 }
 
+inline void IncrementCounterBy(const scoped_refptr<Counter>& counter, int64_t amount) {
+  if (counter) {
+    counter->IncrementBy(amount);
+  }
+}
+
 YB_STRONGLY_TYPED_BOOL(ExportPercentiles);
 
 class HistogramPrototype : public MetricPrototype {
@@ -1275,9 +1285,13 @@ class Histogram : public Metric {
   FRIEND_TEST(MetricsTest, ResetHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
+  explicit Histogram(std::unique_ptr<HistogramPrototype> proto);
 
   const gscoped_ptr<HdrHistogram> histogram_;
   const ExportPercentiles export_percentiles_;
+  // Names of the Prometheus sum and count series, built once rather than on every scrape.
+  const std::string sum_metric_name_;
+  const std::string count_metric_name_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
@@ -1342,6 +1356,19 @@ inline scoped_refptr<Histogram> MetricEntity::FindOrCreateHistogram(
   return m;
 }
 
+inline scoped_refptr<Histogram> MetricEntity::FindOrCreateHistogram(
+    std::unique_ptr<HistogramPrototype> proto) {
+  CheckInstantiation(proto.get());
+  std::lock_guard<simple_spinlock> l(lock_);
+  scoped_refptr<Histogram> m = down_cast<Histogram*>(
+      FindPtrOrNull(metric_map_, proto.get()).get());
+  if (!m) {
+    m = new Histogram(std::move(proto));
+    InsertOrDie(&metric_map_, m->prototype(), m);
+  }
+  return m;
+}
+
 template<typename T>
 inline scoped_refptr<AtomicGauge<T> > MetricEntity::FindOrCreateGauge(
     const GaugePrototype<T>* proto,
@@ -1417,6 +1444,23 @@ class OwningGaugePrototype : public OwningMetricCtorArgs, public GaugePrototype<
             flags)) {}
 };
 
+class OwningHistogramPrototype : public OwningMetricCtorArgs, public HistogramPrototype {
+ public:
+  OwningHistogramPrototype(
+      std::string entity_type, std::string name, std::string label, MetricUnit::Type unit,
+      std::string description, uint64_t max_trackable_value, int num_sig_digits,
+      ExportPercentiles export_percentiles = ExportPercentiles::kFalse)
+      : OwningMetricCtorArgs(
+            std::move(entity_type), std::move(name), std::move(label), unit,
+            std::move(description)),
+        HistogramPrototype(
+            MetricPrototype::CtorArgs(
+                OwningMetricCtorArgs::entity_type.c_str(), OwningMetricCtorArgs::name.c_str(),
+                OwningMetricCtorArgs::label.c_str(), unit,
+                OwningMetricCtorArgs::description.c_str(), flags),
+            max_trackable_value, num_sig_digits, export_percentiles) {}
+};
+
 // Replace specific chars with underscore to pass PrometheusNameRegex().
 void EscapeMetricNameForPrometheus(std::string *id);
 
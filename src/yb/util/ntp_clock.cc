@@ -13,6 +13,14 @@
 
 #include "yb/util/ntp_clock.h"
 
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/atomic.h"
+
+DECLARE_uint64(max_clock_skew_usec);
+
 namespace yb {
 
 #if !defined(__APPLE__)
@@ -28,7 +36,8 @@ Result<PhysicalTime> NtpClock::Now() {
 
 MicrosTime NtpClock::MaxGlobalTime(PhysicalTime time) {
   // time_point is original time_point - max_error, so we add max_error twice here.
-  return time.time_point + time.max_error * 2;
+  return time.time_point + time.max_error +
+         std::min<MicrosTime>(time.max_error, GetAtomicFlag(&FLAGS_max_clock_skew_usec));
 }
 
 const std::string& NtpClock::Name() {
@@ -22,10 +22,12 @@ namespace yb {
 // Now and MaxGlobalTime.
 //
 // Now - max_error is subtracted from time_point of original clock.
-// MaxGlobalTime - is calculated as time_point + time.max_error * 2.
+// MaxGlobalTime - is calculated as time_point + time.max_error * 2, but not after the original
+// time_point + max_clock_skew_usec.
 //
 // So it is guaranteed that Now().time_point is never after real current time and
-// MaxGlobalTime is never before real current time.
+// MaxGlobalTime is never before real current time. When all the servers use NtpClock, the read
+// uncertainty window follows the actual clock errors instead of the configured skew.
 //
 // By default NtpClock uses AdjTimeClock.
 class NtpClock : public PhysicalClock {
@@ -30,6 +30,9 @@
 // under the License.
 //
 
+#include <memory>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include "yb/util/object_pool.h"
 
@@ -96,4 +99,28 @@ TEST(TestObjectPool, TestScopedPtr) {
   ASSERT_EQ(0, MyClass::instance_count());
 }
 
+TEST(TestObjectPool, TestPooledAllocator) {
+  MyClass::ResetCount();
+  std::weak_ptr<MyClass> weak;
+  {
+    auto shared = std::allocate_shared<MyClass>(PooledAllocator<MyClass>());
+    weak = shared;
+    ASSERT_EQ(1, MyClass::instance_count());
+  }
+  ASSERT_EQ(0, MyClass::instance_count());
+  ASSERT_TRUE(weak.expired());
+
+  // The memory of destroyed objects is reused for new ones.
+  std::vector<std::shared_ptr<MyClass>> objects;
+  for (int i = 0; i != 100; ++i) {
+    objects.push_back(std::allocate_shared<MyClass>(PooledAllocator<MyClass>()));
+    if (i % 2) {
+      objects.pop_back();
+    }
+  }
+  ASSERT_EQ(50, MyClass::instance_count());
+  objects.clear();
+  ASSERT_EQ(0, MyClass::instance_count());
+}
+
 } // namespace yb
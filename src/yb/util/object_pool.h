@@ -38,6 +38,8 @@
 
 #include <thread>
 #include <functional>
+#include <new>
+#include <type_traits>
 
 #include <boost/container/stable_vector.hpp>
 #include <boost/lockfree/stack.hpp>
@@ -246,6 +248,54 @@ class ThreadSafeObjectPool {
   boost::container::stable_vector<Pool> pools_;
 };
 
+// Allocator that keeps memory blocks of deallocated objects in a ThreadSafeObjectPool, and
+// reuses them for new objects. Intended for std::allocate_shared of objects that are frequently
+// created and destroyed, like RPC calls, so they do not go to the memory allocator each time.
+template <class T>
+class PooledAllocator {
+ public:
+  typedef T value_type;
+
+  PooledAllocator() = default;
+
+  template <class U>
+  PooledAllocator(const PooledAllocator<U>&) {} // NOLINT
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(static_cast<void*>(Pool().Take()));
+  }
+
+  void deallocate(T* p, size_t n) {
+    if (n != 1) {
+      ::operator delete(p);
+      return;
+    }
+    Pool().Release(static_cast<Block*>(static_cast<void*>(p)));
+  }
+
+ private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Block;
+
+  static ThreadSafeObjectPool<Block>& Pool() {
+    // Never destroyed, since objects could be deallocated during shutdown.
+    static auto* pool = new ThreadSafeObjectPool<Block>([] { return new Block; });
+    return *pool;
+  }
+};
+
+template <class T, class U>
+bool operator==(const PooledAllocator<T>&, const PooledAllocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const PooledAllocator<T>&, const PooledAllocator<U>&) {
+  return false;
+}
+
 } // namespace yb
 
 #endif // YB_UTIL_OBJECT_POOL_H
@@ -37,6 +37,14 @@ DEFINE_uint64(max_clock_skew_usec, 50000,
               "Transaction read clock skew in usec. "
               "This is the maximum allowed time delta between servers of a single cluster.");
 
+DEFINE_int32(ntp_clock_error_refresh_interval_usec, 10000,
+             "The NTP clock queries the kernel for the maximum clock error at most once per this "
+             "interval per thread, and reads the time through the vDSO in between. The error "
+             "reported in between is grown by the worst case drift of the clock. 0 to query the "
+             "kernel on each clock read.");
+TAG_FLAG(ntp_clock_error_refresh_interval_usec, advanced);
+TAG_FLAG(ntp_clock_error_refresh_interval_usec, runtime);
+
 namespace yb {
 
 namespace {
@@ -93,10 +101,47 @@ CHECKED_STATUS CallAdjTime(timex* tx) {
   }
 }
 
+// Until the NTP daemon sets it again, the kernel grows the maximum error by the maximum frequency
+// error of the clock, 500 ppm, in steps of 500 microseconds once per second.
+constexpr MicrosTime kMaxErrorGrowthPerSecondUsec = 500;
+constexpr MicrosTime kMicrosPerSecond = 1000000;
+
 class AdjTimeClockImpl : public PhysicalClock {
   Result<PhysicalTime> Now() override {
-    const MicrosTime kMicrosPerSec = 1000000;
+    const auto refresh_interval = GetAtomicFlag(&FLAGS_ntp_clock_error_refresh_interval_usec);
+    if (refresh_interval <= 0) {
+      return CheckClockSyncError(VERIFY_RESULT(QueryKernel()));
+    }
+
+    // ntp_adjtime is a real system call, while clock_gettime is served by the vDSO, so the result
+    // of the former is reused for a while. The cache is per thread, so the clock reads by
+    // different threads do not contend on it.
+    struct CachedTime {
+      PhysicalTime time;
+      bool valid;
+    };
+    static thread_local CachedTime cached = { {0, 0}, false };
+
+    const auto now = static_cast<MicrosTime>(GetCurrentTimeMicros());
+    // The cache is not used if the system time was stepped back since the kernel was queried.
+    if (!cached.valid || now < cached.time.time_point ||
+        now - cached.time.time_point >= static_cast<MicrosTime>(refresh_interval)) {
+      auto time = QueryKernel();
+      if (!time.ok()) {
+        cached.valid = false;
+        return time;
+      }
+      cached = { *time, true };
+      return CheckClockSyncError(*time);
+    }
 
+    // One more step, since a second boundary could have been crossed since the query.
+    const auto steps = (now - cached.time.time_point) / kMicrosPerSecond + 1;
+    return CheckClockSyncError(
+        { now, cached.time.max_error + steps * kMaxErrorGrowthPerSecondUsec });
+  }
+
+  Result<PhysicalTime> QueryKernel() {
     timex tx;
     RETURN_NOT_OK(CallAdjTime(&tx));
 
@@ -105,9 +150,8 @@ class AdjTimeClockImpl : public PhysicalClock {
     }
     DCHECK_LT(tx.time.tv_usec, 1000000);
 
-    return CheckClockSyncError(
-        { tx.time.tv_sec * kMicrosPerSec + tx.time.tv_usec,
-          static_cast<yb::MicrosTime>(tx.maxerror) });
+    return PhysicalTime { tx.time.tv_sec * kMicrosPerSecond + tx.time.tv_usec,
+                          static_cast<yb::MicrosTime>(tx.maxerror) };
   }
 
   MicrosTime MaxGlobalTime(PhysicalTime time) override {
@@ -290,4 +290,40 @@ TEST(PriorityThreadPoolTest, ChangePriority) {
   ASSERT_EQ(running, std::vector<int>({2, 5, 6}));
 }
 
+TEST(PriorityThreadPoolTest, ReservedTasks) {
+  const int kMaxRunningTasks = 3;
+  const int kReservedMinPriority = 10;
+  PriorityThreadPool thread_pool(kMaxRunningTasks, 1 /* reserved_tasks */, kReservedMinPriority);
+  Share share;
+  std::vector<int> running;
+
+  auto se = ScopeExit([&share, &thread_pool] {
+    thread_pool.StartShutdown();
+    share.StopAll();
+    thread_pool.CompleteShutdown();
+  });
+
+  SubmitTask(1, &share, &thread_pool);
+  SubmitTask(2, &share, &thread_pool);
+  SubmitTask(3, &share, &thread_pool);
+
+  // The last slot is reserved, so the lowest priority task is paused in favor of task 3.
+  share.FillRunningTaskPriorities(&running);
+  ASSERT_EQ(running, std::vector<int>({2, 3}));
+
+  // High priority task starts right away in the reserved slot.
+  SubmitTask(kReservedMinPriority, &share, &thread_pool);
+  share.FillRunningTaskPriorities(&running);
+  ASSERT_EQ(running, std::vector<int>({2, 3, kReservedMinPriority}));
+
+  // The reserved slot is not taken by low priority tasks when it is freed.
+  share.Stop(kReservedMinPriority);
+  share.FillRunningTaskPriorities(&running);
+  ASSERT_EQ(running, std::vector<int>({2, 3}));
+
+  share.Stop(3);
+  share.FillRunningTaskPriorities(&running);
+  ASSERT_EQ(running, std::vector<int>({1, 2}));
+}
+
 } // namespace yb
@@ -13,6 +13,7 @@
 
 #include "yb/util/priority_thread_pool.h"
 
+#include <algorithm>
 #include <mutex>
 #include <queue>
 #include <set>
@@ -307,8 +308,14 @@ PriorityThreadPoolTask::PriorityThreadPoolTask()
 // If the queue is empty, the worker is added to the vector of free workers.
 class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
  public:
-  explicit Impl(size_t max_running_tasks) : max_running_tasks_(max_running_tasks) {
+  Impl(size_t max_running_tasks, size_t reserved_tasks, int reserved_min_priority)
+      : max_running_tasks_(max_running_tasks),
+        reserved_tasks_(std::min(reserved_tasks, max_running_tasks - 1)),
+        reserved_min_priority_(reserved_min_priority) {
     CHECK_GE(max_running_tasks, 1);
+    LOG_IF(WARNING, reserved_tasks_ != reserved_tasks)
+        << "Reserved tasks " << reserved_tasks << " adjusted to " << reserved_tasks_
+        << ", so that tasks of any priority could run";
   }
 
   ~Impl() {
@@ -330,7 +337,7 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
         VLOG(3) << (**task).ToString() << " rejected because of shutdown";
         return kShutdownStatus;
       }
-      worker = PickWorker();
+      worker = PickWorker(priority);
       if (worker == nullptr) {
         if (workers_.empty()) {
           // Empty workers here means that we are unable to start even one worker thread.
@@ -447,7 +454,7 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
           ResumeWorker(tasks_.project<PriorityTag>(it));
           break;
         case PriorityThreadPoolTaskState::kNotStarted:
-          higher_pri_worker = PickWorker();
+          higher_pri_worker = PickWorker(it->priority());
           if (!higher_pri_worker) {
             LOG(DFATAL) << Format(
                 "Unable to pick a worker for a higher priority task when trying to pause a lower "
@@ -508,9 +515,11 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
   std::string DoStateToString() REQUIRES(mutex_) {
     return Format(
         "{ max_running_tasks: $0 tasks: $1 workers: $2 paused_workers: $3 free_workers: $4 "
-            "stopping: $5 max_priority_to_defer: $6 }",
+            "stopping: $5 max_priority_to_defer: $6 reserved_tasks: $7 "
+            "reserved_min_priority: $8 }",
         max_running_tasks_, tasks_, workers_, paused_workers_, free_workers_,
-        stopping_.load(), max_priority_to_defer_.load());
+        stopping_.load(), max_priority_to_defer_.load(), reserved_tasks_,
+        reserved_min_priority_);
   }
 
   void AbortTasks(const std::vector<TaskPtr>& tasks, const Status& abort_status) {
@@ -538,6 +547,11 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
     }
 
     auto it = tasks_.get<StateAndPriorityTag>().begin();
+    if (it->state() != PriorityThreadPoolTaskState::kRunning &&
+        !CanStart(it->priority(), RunningTasks() - 1)) {
+      VLOG(4) << "Slots left are reserved, not picking " << it->ToString() << " for " << worker;
+      return false;
+    }
     switch (it->state()) {
       case PriorityThreadPoolTaskState::kPaused:
         VLOG(4) << "Resume other worker after " << worker << " finished";
@@ -579,11 +593,26 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
     it->worker()->Resumed();
   }
 
-  PriorityThreadPoolWorker* PickWorker() REQUIRES(mutex_) {
-    if (workers_.size() - paused_workers_ - free_workers_.size() >= max_running_tasks_) {
+  size_t RunningTasks() REQUIRES(mutex_) {
+    return workers_.size() - paused_workers_ - free_workers_.size();
+  }
+
+  // Returns whether a task with the specified priority could start while running_tasks other
+  // tasks are running.
+  bool CanStart(int priority, size_t running_tasks) const {
+    if (running_tasks >= max_running_tasks_) {
+      return false;
+    }
+    return priority >= reserved_min_priority_ ||
+           running_tasks + reserved_tasks_ < max_running_tasks_;
+  }
+
+  PriorityThreadPoolWorker* PickWorker(int priority) REQUIRES(mutex_) {
+    if (!CanStart(priority, RunningTasks())) {
       VLOG(1) << "We already have " << workers_.size() << " - " << paused_workers_ << " - "
-              << free_workers_.size() << " >= " << max_running_tasks_
-              << " workers running, we could not run a new worker.";
+              << free_workers_.size() << " workers running, we could not run a new worker "
+              << "for priority " << priority << ", max: " << max_running_tasks_
+              << ", reserved: " << reserved_tasks_;
       return nullptr;
     }
     if (!free_workers_.empty()) {
@@ -622,9 +651,22 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
     // We could pause a worker when both of the following conditions are met:
     // 1) Number of active tasks is greater than max_running_tasks_.
     // 2) Priority of the worker's current task is less than top max_running_tasks_ priorities.
-    int priority = tasks_.size() <= max_running_tasks_
-        ? kEmptyQueuePriority
-        : tasks_.nth(max_running_tasks_)->priority();
+    // Tasks below reserved_min_priority_ should also leave reserved_tasks_ slots to other tasks.
+    int priority = kEmptyQueuePriority;
+    if (reserved_tasks_ == 0) {
+      if (tasks_.size() > max_running_tasks_) {
+        priority = tasks_.nth(max_running_tasks_)->priority();
+      }
+    } else {
+      size_t slots = 0;
+      for (const auto& task : tasks_) {
+        if (!CanStart(task.priority(), slots)) {
+          priority = task.priority();
+          break;
+        }
+        ++slots;
+      }
+    }
     max_priority_to_defer_.store(priority, std::memory_order_release);
   }
 
@@ -643,6 +685,8 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
   }
 
   const size_t max_running_tasks_;
+  const size_t reserved_tasks_;
+  const int reserved_min_priority_;
   std::mutex mutex_;
 
   // Number of paused workers.
@@ -690,8 +734,9 @@ class PriorityThreadPool::Impl : public PriorityThreadPoolWorkerContext {
   > tasks_ GUARDED_BY(mutex_);
 };
 
-PriorityThreadPool::PriorityThreadPool(size_t max_running_tasks)
-    : impl_(new Impl(max_running_tasks)) {
+PriorityThreadPool::PriorityThreadPool(
+    size_t max_running_tasks, size_t reserved_tasks, int reserved_min_priority)
+    : impl_(new Impl(max_running_tasks, reserved_tasks, reserved_min_priority)) {
 }
 
 PriorityThreadPool::~PriorityThreadPool() {
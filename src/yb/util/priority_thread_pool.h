@@ -55,9 +55,14 @@ class PriorityThreadPoolTask {
 };
 
 // Tasks submitted to this pool have assigned priority and are picked from queue using it.
+//
+// Tasks with priority lower than reserved_min_priority only start while it leaves reserved_tasks
+// of the max_running_tasks slots free, so that higher priority tasks could start right away
+// instead of waiting for a lower priority task to be paused.
 class PriorityThreadPool {
  public:
-  explicit PriorityThreadPool(size_t max_running_tasks);
+  explicit PriorityThreadPool(
+      size_t max_running_tasks, size_t reserved_tasks = 0, int reserved_min_priority = 0);
   ~PriorityThreadPool();
 
   // Submit task to the pool.
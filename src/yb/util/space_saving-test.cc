@@ -0,0 +1,102 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+
+#include <random>
+#include <set>
+
+#include "yb/util/random_util.h"
+#include "yb/util/space_saving.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SpaceSavingTest : public YBTest {
+};
+
+TEST_F(SpaceSavingTest, Exact) {
+  SpaceSavingSketch sketch(10);
+  for (int i = 0; i != 5; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      sketch.Add(std::to_string(i));
+    }
+  }
+  ASSERT_EQ(15U, sketch.total());
+  auto top = sketch.TopK(3);
+  ASSERT_EQ(3U, top.size());
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_EQ(std::to_string(4 - i), top[i].key);
+    ASSERT_EQ(5U - i, top[i].count);
+    ASSERT_EQ(0U, top[i].error);
+  }
+  sketch.Clear();
+  ASSERT_EQ(0U, sketch.total());
+  ASSERT_TRUE(sketch.TopK(3).empty());
+}
+
+// The frequent keys are found in a stream with many more distinct keys than the capacity, and their
+// counts are within the errors.
+TEST_F(SpaceSavingTest, Frequent) {
+  constexpr int kNumHotKeys = 5;
+  constexpr int kNumKeys = 10000;
+  constexpr int kNumOps = 100000;
+  std::mt19937_64 rng(GetRandomSeed32());
+  SpaceSavingSketch sketch(50);
+  std::vector<uint64_t> counts(kNumKeys);
+  for (int i = 0; i != kNumOps; ++i) {
+    // Half of the operations go to the hot keys.
+    const int key = RandomActWithProbability(0.5, &rng)
+        ? RandomUniformInt(0, kNumHotKeys - 1, &rng)
+        : RandomUniformInt(kNumHotKeys, kNumKeys - 1, &rng);
+    ++counts[key];
+    sketch.Add(std::to_string(key));
+  }
+  ASSERT_EQ(static_cast<uint64_t>(kNumOps), sketch.total());
+
+  auto top = sketch.TopK(kNumHotKeys);
+  ASSERT_EQ(static_cast<size_t>(kNumHotKeys), top.size());
+  std::set<std::string> hot_keys;
+  for (const auto& entry : top) {
+    const auto key = std::stoi(entry.key);
+    ASSERT_LT(key, kNumHotKeys);
+    ASSERT_GE(entry.count, counts[key]);
+    ASSERT_LE(entry.count - entry.error, counts[key]);
+    hot_keys.insert(entry.key);
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumHotKeys), hot_keys.size());
+}
+
+TEST_F(SpaceSavingTest, Merge) {
+  SpaceSavingSketch first(2);
+  SpaceSavingSketch second(2);
+  for (int i = 0; i != 10; ++i) {
+    first.Add("a");
+    second.Add("a");
+  }
+  first.Add("b");
+  second.Add("c", 3);
+
+  first.Merge(second);
+  ASSERT_EQ(24U, first.total());
+  auto top = first.TopK(2);
+  ASSERT_EQ(2U, top.size());
+  ASSERT_EQ("a", top[0].key);
+  ASSERT_EQ(20U, top[0].count);
+  ASSERT_EQ(0U, top[0].error);
+  // c replaced b, so it could have occurred as many times as b.
+  ASSERT_EQ("c", top[1].key);
+  ASSERT_EQ(4U, top[1].count);
+  ASSERT_EQ(1U, top[1].error);
+}
+
+} // namespace yb
@@ -0,0 +1,79 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+
+#include "yb/util/space_saving.h"
+
+#include <algorithm>
+
+namespace yb {
+
+SpaceSavingSketch::SpaceSavingSketch(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+  entries_.reserve(capacity_);
+}
+
+void SpaceSavingSketch::Add(Slice key, uint64_t weight) {
+  total_ += weight;
+  AddToCounts(key, weight, 0);
+}
+
+void SpaceSavingSketch::AddToCounts(Slice key, uint64_t weight, uint64_t error) {
+  std::string key_str = key.ToBuffer();
+  auto it = index_.find(key_str);
+  if (it != index_.end()) {
+    auto& entry = entries_[it->second];
+    entry.count += weight;
+    entry.error += error;
+    return;
+  }
+  if (entries_.size() < capacity_) {
+    index_.emplace(key_str, entries_.size());
+    entries_.push_back(Entry{std::move(key_str), weight, error});
+    return;
+  }
+  // The new key takes the place of the key with the minimal count, and could have occurred as many
+  // times as the replaced key.
+  auto min_it = std::min_element(
+      entries_.begin(), entries_.end(),
+      [](const Entry& lhs, const Entry& rhs) { return lhs.count < rhs.count; });
+  index_.erase(min_it->key);
+  index_.emplace(key_str, min_it - entries_.begin());
+  min_it->error = min_it->count + error;
+  min_it->count += weight;
+  min_it->key = std::move(key_str);
+}
+
+void SpaceSavingSketch::Merge(const SpaceSavingSketch& other) {
+  total_ += other.total_;
+  for (const auto& entry : other.entries_) {
+    AddToCounts(entry.key, entry.count, entry.error);
+  }
+}
+
+std::vector<SpaceSavingSketch::Entry> SpaceSavingSketch::TopK(size_t limit) const {
+  std::vector<Entry> result(entries_);
+  std::sort(result.begin(), result.end(), [](const Entry& lhs, const Entry& rhs) {
+    return lhs.count > rhs.count;
+  });
+  if (result.size() > limit) {
+    result.resize(limit);
+  }
+  return result;
+}
+
+void SpaceSavingSketch::Clear() {
+  entries_.clear();
+  index_.clear();
+  total_ = 0;
+}
+
+} // namespace yb
@@ -0,0 +1,76 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+
+#ifndef YB_UTIL_SPACE_SAVING_H
+#define YB_UTIL_SPACE_SAVING_H
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+// Space-Saving sketch of the most frequent keys of a stream, from "Efficient Computation of
+// Frequent and Top-k Elements in Data Streams" by Metwally et al. Keeps at most capacity keys.
+// Every key occurring more than total / capacity times is kept, and the count of a kept key exceeds
+// its real count by at most its error.
+//
+// Replacing a key looks for the minimal count among the kept keys, so the sketch is meant for a
+// small capacity and a sampled stream. Not thread safe.
+class SpaceSavingSketch {
+ public:
+  struct Entry {
+    std::string key;
+    uint64_t count;
+    uint64_t error;
+  };
+
+  explicit SpaceSavingSketch(size_t capacity);
+
+  void Add(Slice key, uint64_t weight = 1);
+
+  // Adds the keys of the other sketch, with their counts and errors.
+  void Merge(const SpaceSavingSketch& other);
+
+  // Returns up to limit kept keys with the highest counts, in the descending order of the counts.
+  std::vector<Entry> TopK(size_t limit) const;
+
+  void Clear();
+
+  // Total weight of the added keys.
+  uint64_t total() const {
+    return total_;
+  }
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+ private:
+  // Adds the weight and the error to the key, without updating the total.
+  void AddToCounts(Slice key, uint64_t weight, uint64_t error);
+
+  size_t capacity_;
+  std::vector<Entry> entries_;
+  // Index of the entry of each kept key.
+  std::unordered_map<std::string, size_t> index_;
+  uint64_t total_ = 0;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SPACE_SAVING_H
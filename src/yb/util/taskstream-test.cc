@@ -146,4 +146,38 @@ TEST_F(TestTaskStream, TestTwoTaskStreams) {
   taskStream1.Stop();
   thread_pool->Shutdown();
 }
+
+TEST_F(TestTaskStream, TestGroupWait) {
+  gscoped_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(BuildMinMaxTestPool(1, 1, &thread_pool));
+
+  constexpr size_t kGroupSize = 4;
+  std::atomic<int32_t> counter(0);
+  std::atomic<int32_t> groups(0);
+  auto process = [&counter, &groups](int* value) {
+    if (value == nullptr) {
+      ++groups;
+    } else {
+      counter += *value;
+    }
+  };
+  // Keep the group open until it has kGroupSize items.
+  auto group_wait = [](size_t group_size) {
+    return group_size < kGroupSize ? MonoDelta::FromSeconds(10) : MonoDelta::kZero;
+  };
+
+  TaskStream<int> taskStream(process, thread_pool.get(), kTaskstreamQueueMaxSize,
+                             kTaskstreamQueueMaxWait, group_wait);
+  ASSERT_OK(taskStream.Start());
+  int a[kGroupSize] = {10, 9, 8, 7};
+  for (size_t i = 0; i < kGroupSize; i++) {
+    ASSERT_OK(taskStream.Submit(&a[i]));
+    SleepFor(MonoDelta::FromMilliseconds(10));
+  }
+  thread_pool->Wait();
+  ASSERT_EQ(34, counter.load(std::memory_order_acquire));
+  ASSERT_EQ(1, groups.load(std::memory_order_acquire));
+  taskStream.Stop();
+  thread_pool->Shutdown();
+}
 } // namespace yb
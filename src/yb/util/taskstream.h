@@ -41,6 +41,10 @@ class ThreadPoolToken;
 template <typename T>
 class TaskStreamImpl;
 
+// Function returning how long to wait for more items to join the group being processed, given the
+// number of items in the group so far.
+using TaskStreamGroupWait = std::function<MonoDelta(size_t group_size)>;
+
 template <typename T>
 // TaskStream has a thread pool token in the given thread pool.
 // TaskStream does not manage a thread but only submits to the token in the thread pool.
@@ -50,12 +54,15 @@ template <typename T>
 // When the queue is empty, it calls the user-provided function with no parameter,
 // to indicate it needs to process the end of the group of tasks processed.
 // This feature is used for the preparer and appender functionality.
+// If group_wait is set, it is called after the tasks of a group are processed, and the group is
+// kept open while it returns a positive time, so that tasks submitted meanwhile join the group.
 class TaskStream {
  public:
   explicit TaskStream(std::function<void(T*)> process_item,
                       ThreadPool* thread_pool,
                       int32_t queue_max_size,
-                      const MonoDelta& queue_max_wait);
+                      const MonoDelta& queue_max_wait,
+                      TaskStreamGroupWait group_wait = TaskStreamGroupWait());
   ~TaskStream();
 
   CHECKED_STATUS Start();
@@ -79,7 +86,8 @@ class TaskStreamImpl {
   explicit TaskStreamImpl(std::function<void(T*)> process_item,
                           ThreadPool* thread_pool,
                           int32_t queue_max_size,
-                          const MonoDelta& queue_max_wait);
+                          const MonoDelta& queue_max_wait,
+                          TaskStreamGroupWait group_wait);
   ~TaskStreamImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -116,6 +124,8 @@ class TaskStreamImpl {
   // Maximum time to wait for the queue to become non-empty.
   const MonoDelta queue_max_wait_;
 
+  const TaskStreamGroupWait group_wait_;
+
   void Run();
   void ProcessItem(T* item);
 };
@@ -124,11 +134,13 @@ template <typename T>
 TaskStreamImpl<T>::TaskStreamImpl(std::function<void(T*)> process_item,
                                   ThreadPool* thread_pool,
                                   int32_t queue_max_size,
-                                  const MonoDelta& queue_max_wait)
+                                  const MonoDelta& queue_max_wait,
+                                  TaskStreamGroupWait group_wait)
     : queue_(queue_max_size),
       taskstream_pool_token_(thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
       process_item_(process_item),
-      queue_max_wait_(queue_max_wait) {
+      queue_max_wait_(queue_max_wait),
+      group_wait_(std::move(group_wait)) {
 }
 
 template <typename T>
@@ -189,11 +201,27 @@ template <typename T> void TaskStreamImpl<T>::Run() {
     std::vector<T *> group;
     queue_.BlockingDrainTo(&group, wait_timeout_deadline);
     if (!group.empty()) {
-      for (T* item : group) {
-        ProcessItem(item);
+      size_t group_size = 0;
+      for (;;) {
+        for (T* item : group) {
+          ProcessItem(item);
+        }
+        group_size += group.size();
+        group.clear();
+        if (!group_wait_) {
+          break;
+        }
+        const MonoDelta wait = group_wait_(group_size);
+        if (!wait.Initialized() || wait <= MonoDelta::kZero) {
+          break;
+        }
+        // Returns as soon as some tasks are queued, so the wait is repeated until it runs out.
+        if (!queue_.BlockingDrainTo(&group, MonoTime::Now() + wait)) {
+          // The queue is shut down.
+          break;
+        }
       }
       ProcessItem(nullptr);
-      group.clear();
       continue;
     }
     // Not processing and queue empty, return from task.
@@ -225,9 +253,10 @@ template <typename T>
 TaskStream<T>::TaskStream(std::function<void(T *)> process_item,
                           ThreadPool* thread_pool,
                           int32_t queue_max_size,
-                          const MonoDelta& queue_max_wait)
+                          const MonoDelta& queue_max_wait,
+                          TaskStreamGroupWait group_wait)
     : impl_(std::make_unique<TaskStreamImpl<T>>(
-        process_item, thread_pool, queue_max_size, queue_max_wait)) {
+        process_item, thread_pool, queue_max_size, queue_max_wait, std::move(group_wait))) {
 }
 
 template <typename T>
@@ -49,6 +49,7 @@
 #include "yb/util/memory/memory.h"
 #include "yb/util/object_pool.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/trace_span.h"
 
 DEFINE_bool(enable_tracing, false, "Flag to enable/disable tracing across the code.");
 
@@ -349,6 +350,10 @@ void Trace::DumpCurrentTrace() {
   t->Dump(&std::cerr, true);
 }
 
+void Trace::set_span(scoped_refptr<TraceSpan> span) {
+  span_ = std::move(span);
+}
+
 void Trace::AddChildTrace(Trace* child_trace) {
   CHECK_NOTNULL(child_trace);
   {
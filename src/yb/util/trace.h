@@ -101,6 +101,7 @@ DECLARE_bool(enable_tracing);
 namespace yb {
 
 struct TraceEntry;
+class TraceSpan;
 
 // A trace for a request or other process. This supports collecting trace entries
 // from a number of threads, and later dumping the results to a stream.
@@ -157,6 +158,20 @@ class Trace : public RefCountedThreadSafe<Trace> {
   // Attaches the given trace which will get appended at the end when Dumping.
   void AddChildTrace(Trace* child_trace);
 
+  // Span of the distributed trace of a sampled request, that times the part of the request this
+  // trace is for. Spans started while this trace is adopted are its children.
+  // Should be set before the trace is passed to other threads.
+  void set_span(scoped_refptr<TraceSpan> span);
+
+  TraceSpan* span() const {
+    return span_.get();
+  }
+
+  // Returns the span of the trace of the current thread, if there is one.
+  static TraceSpan* CurrentSpan() {
+    return threadlocal_trace_ ? threadlocal_trace_->span() : nullptr;
+  }
+
   // Return the current trace attached to this thread, if there is one.
   static Trace* CurrentTrace() {
     return threadlocal_trace_;
@@ -202,6 +217,8 @@ class Trace : public RefCountedThreadSafe<Trace> {
 
   std::vector<scoped_refptr<Trace> > child_traces_;
 
+  scoped_refptr<TraceSpan> span_;
+
   DISALLOW_COPY_AND_ASSIGN(Trace);
 };
 
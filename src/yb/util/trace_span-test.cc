@@ -0,0 +1,104 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <map>
+#include <string>
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+#include <rapidjson/rapidjson.h>  // NOLINT
+
+#include "yb/util/test_util.h"
+#include "yb/util/trace.h"
+#include "yb/util/trace_span.h"
+
+DECLARE_double(trace_sampling_rate);
+
+namespace yb {
+
+class TraceSpanTest : public YBTest {
+};
+
+TEST_F(TraceSpanTest, ParentAndChild) {
+  auto root = TraceSpan::StartRoot("root");
+  ASSERT_TRUE(root->context());
+  ASSERT_FALSE(TraceSpan::StartChild(TraceSpanContext(), "orphan"));
+
+  scoped_refptr<Trace> trace(new Trace);
+  trace->set_span(root);
+  TraceSpanPtr child;
+  {
+    ADOPT_TRACE(trace.get());
+    child = TraceSpan::StartChild(Trace::CurrentSpan(), "child");
+  }
+  ASSERT_TRUE(child);
+  ASSERT_EQ(root->context().trace_id, child->context().trace_id);
+  ASSERT_NE(root->context().span_id, child->context().span_id);
+
+  child->SetAttribute("key", "value");
+  child->AddEvent("event");
+  child->End();
+  // Already ended, so the attribute is not exported.
+  child->SetAttribute("late", "value");
+  child->End();
+  trace->set_span(nullptr);
+  root->End();
+
+  // A span of another trace, that should be filtered out.
+  TraceSpan::StartRoot("other")->End();
+
+  std::stringstream out;
+  DumpTraceSpansAsOtlpJson("test", root->context().trace_id, &out);
+  LOG(INFO) << out.str();
+
+  rapidjson::Document doc;
+  doc.Parse<0>(out.str().c_str());
+  ASSERT_FALSE(doc.HasParseError());
+  const auto& resource_spans = doc["resourceSpans"][0];
+  ASSERT_STREQ("service.name", resource_spans["resource"]["attributes"][0]["key"].GetString());
+  const auto& spans = resource_spans["scopeSpans"][0]["spans"];
+  ASSERT_EQ(2U, spans.Size());
+
+  std::map<std::string, const rapidjson::Value*> spans_by_name;
+  for (rapidjson::SizeType i = 0; i != spans.Size(); ++i) {
+    const auto& span = spans[i];
+    ASSERT_EQ(32U, strlen(span["traceId"].GetString()));
+    ASSERT_EQ(16U, strlen(span["spanId"].GetString()));
+    spans_by_name[span["name"].GetString()] = &span;
+  }
+  ASSERT_EQ(1U, spans_by_name.count("root"));
+  ASSERT_EQ(1U, spans_by_name.count("child"));
+  const auto& root_json = *spans_by_name["root"];
+  const auto& child_json = *spans_by_name["child"];
+  ASSERT_FALSE(root_json.HasMember("parentSpanId"));
+  ASSERT_STREQ(root_json["spanId"].GetString(), child_json["parentSpanId"].GetString());
+  ASSERT_STREQ(root_json["traceId"].GetString(), child_json["traceId"].GetString());
+  ASSERT_EQ(1U, child_json["attributes"].Size());
+  ASSERT_STREQ("key", child_json["attributes"][0]["key"].GetString());
+  ASSERT_EQ(1U, child_json["events"].Size());
+  ASSERT_STREQ("event", child_json["events"][0]["name"].GetString());
+}
+
+TEST_F(TraceSpanTest, Sampling) {
+  FLAGS_trace_sampling_rate = 0;
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_FALSE(TraceSpan::ShouldSampleRoot());
+  }
+  FLAGS_trace_sampling_rate = 1;
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_TRUE(TraceSpan::ShouldSampleRoot());
+  }
+}
+
+} // namespace yb
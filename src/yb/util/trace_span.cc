@@ -0,0 +1,255 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/trace_span.h"
+
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <mutex>
+
+#include <gflags/gflags.h>
+
+#include "yb/gutil/strings/numbers.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/random_util.h"
+
+DEFINE_double(trace_sampling_rate, 0,
+              "Fraction of the requests, that came without a trace context, for which a "
+              "distributed trace is started. The requests that came with a trace context, from "
+              "a sampled request on another node, are always traced. The spans are shown at "
+              "/tracing/spans.");
+TAG_FLAG(trace_sampling_rate, advanced);
+TAG_FLAG(trace_sampling_rate, runtime);
+
+DEFINE_int32(trace_span_buffer_size, 10000,
+             "Number of the latest ended trace spans kept by the process for export.");
+TAG_FLAG(trace_span_buffer_size, advanced);
+TAG_FLAG(trace_span_buffer_size, runtime);
+
+namespace yb {
+
+namespace {
+
+int64_t UnixNowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t NewId() {
+  return RandomUniformInt<uint64_t>(1, std::numeric_limits<uint64_t>::max());
+}
+
+struct EndedSpan {
+  uint64_t trace_id;
+  uint64_t span_id;
+  uint64_t parent_span_id;
+  std::string name;
+  int64_t start_time_unix_nanos;
+  int64_t end_time_unix_nanos;
+  std::vector<std::pair<std::string, std::string>> attributes;
+  std::vector<std::pair<int64_t, const char*>> events;
+};
+
+class EndedSpans {
+ public:
+  static EndedSpans& Instance() {
+    static EndedSpans instance;
+    return instance;
+  }
+
+  void Add(EndedSpan span) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    spans_.push_back(std::move(span));
+    while (spans_.size() > static_cast<size_t>(std::max(FLAGS_trace_span_buffer_size, 0))) {
+      spans_.pop_front();
+    }
+  }
+
+  std::vector<EndedSpan> Get(uint64_t trace_id) {
+    std::vector<EndedSpan> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& span : spans_) {
+      if (trace_id == 0 || span.trace_id == trace_id) {
+        result.push_back(span);
+      }
+    }
+    return result;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::deque<EndedSpan> spans_;
+};
+
+// OTLP/JSON encodes trace ids as 16 bytes and span ids as 8 bytes in hex.
+std::string HexId(uint64_t id, bool is_trace_id) {
+  char buf[kFastToBufferSize];
+  std::string result = is_trace_id ? std::string(16, '0') : std::string();
+  result += FastHex64ToBuffer(id, buf);
+  return result;
+}
+
+void WriteStringAttribute(const std::string& key, const std::string& value, JsonWriter* writer) {
+  writer->StartObject();
+  writer->String("key");
+  writer->String(key);
+  writer->String("value");
+  writer->StartObject();
+  writer->String("stringValue");
+  writer->String(value);
+  writer->EndObject();
+  writer->EndObject();
+}
+
+} // namespace
+
+TraceSpan::TraceSpan(uint64_t trace_id, uint64_t parent_span_id, std::string name)
+    : trace_id_(trace_id), span_id_(NewId()), parent_span_id_(parent_span_id),
+      name_(std::move(name)), start_time_unix_nanos_(UnixNowNanos()) {
+}
+
+TraceSpan::~TraceSpan() {
+  End();
+}
+
+bool TraceSpan::ShouldSampleRoot() {
+  const auto rate = FLAGS_trace_sampling_rate;
+  return rate > 0 && RandomActWithProbability(rate);
+}
+
+TraceSpanPtr TraceSpan::StartRoot(std::string name) {
+  return TraceSpanPtr(new TraceSpan(NewId(), 0, std::move(name)));
+}
+
+TraceSpanPtr TraceSpan::StartChild(const TraceSpanContext& parent, std::string name) {
+  if (!parent) {
+    return nullptr;
+  }
+  return TraceSpanPtr(new TraceSpan(parent.trace_id, parent.span_id, std::move(name)));
+}
+
+TraceSpanPtr TraceSpan::StartChild(const TraceSpan* parent, std::string name) {
+  if (!parent) {
+    return nullptr;
+  }
+  return StartChild(parent->context(), std::move(name));
+}
+
+void TraceSpan::SetAttribute(std::string key, std::string value) {
+  std::lock_guard<simple_spinlock> lock(lock_);
+  attributes_.emplace_back(std::move(key), std::move(value));
+}
+
+void TraceSpan::AddEvent(const char* name) {
+  const auto now = UnixNowNanos();
+  std::lock_guard<simple_spinlock> lock(lock_);
+  events_.emplace_back(now, name);
+}
+
+void TraceSpan::End() {
+  EndedSpan span;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    if (ended_) {
+      return;
+    }
+    ended_ = true;
+    span.attributes = std::move(attributes_);
+    span.events = std::move(events_);
+  }
+  span.trace_id = trace_id_;
+  span.span_id = span_id_;
+  span.parent_span_id = parent_span_id_;
+  span.name = name_;
+  span.start_time_unix_nanos = start_time_unix_nanos_;
+  span.end_time_unix_nanos = UnixNowNanos();
+  EndedSpans::Instance().Add(std::move(span));
+}
+
+void DumpTraceSpansAsOtlpJson(const std::string& service_name, uint64_t trace_id,
+                              std::stringstream* out) {
+  const auto spans = EndedSpans::Instance().Get(trace_id);
+
+  JsonWriter writer(out, JsonWriter::COMPACT);
+  writer.StartObject();
+  writer.String("resourceSpans");
+  writer.StartArray();
+  writer.StartObject();
+
+  writer.String("resource");
+  writer.StartObject();
+  writer.String("attributes");
+  writer.StartArray();
+  WriteStringAttribute("service.name", service_name, &writer);
+  writer.EndArray();
+  writer.EndObject();
+
+  writer.String("scopeSpans");
+  writer.StartArray();
+  writer.StartObject();
+  writer.String("scope");
+  writer.StartObject();
+  writer.String("name");
+  writer.String("yb");
+  writer.EndObject();
+  writer.String("spans");
+  writer.StartArray();
+  for (const auto& span : spans) {
+    writer.StartObject();
+    writer.String("traceId");
+    writer.String(HexId(span.trace_id, /* is_trace_id= */ true));
+    writer.String("spanId");
+    writer.String(HexId(span.span_id, /* is_trace_id= */ false));
+    if (span.parent_span_id) {
+      writer.String("parentSpanId");
+      writer.String(HexId(span.parent_span_id, /* is_trace_id= */ false));
+    }
+    writer.String("name");
+    writer.String(span.name);
+    // 64 bit integers are strings in OTLP/JSON.
+    writer.String("startTimeUnixNano");
+    writer.String(std::to_string(span.start_time_unix_nanos));
+    writer.String("endTimeUnixNano");
+    writer.String(std::to_string(span.end_time_unix_nanos));
+    writer.String("attributes");
+    writer.StartArray();
+    for (const auto& attribute : span.attributes) {
+      WriteStringAttribute(attribute.first, attribute.second, &writer);
+    }
+    writer.EndArray();
+    writer.String("events");
+    writer.StartArray();
+    for (const auto& event : span.events) {
+      writer.StartObject();
+      writer.String("timeUnixNano");
+      writer.String(std::to_string(event.first));
+      writer.String("name");
+      writer.String(event.second);
+      writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+  writer.EndArray();
+
+  writer.EndObject();
+  writer.EndArray();
+  writer.EndObject();
+}
+
+} // namespace yb
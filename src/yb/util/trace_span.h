@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_TRACE_SPAN_H
+#define YB_UTIL_TRACE_SPAN_H
+
+#include <stdint.h>
+
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/locks.h"
+
+namespace yb {
+
+// Identifies a span of a distributed trace, that is passed to the spans started by it, also on
+// other nodes in the RPC header.
+struct TraceSpanContext {
+  uint64_t trace_id = 0;
+  uint64_t span_id = 0;
+
+  explicit operator bool() const {
+    return trace_id != 0;
+  }
+};
+
+// A timed part of a sampled request, like handling of an RPC, a tablet RPC done by the client or
+// replication of an operation. Spans of a request form a tree, that spans the nodes the request
+// went through, and are exported in the OpenTelemetry format when ended.
+//
+// Spans are attached to the Trace of the part of the request they time, so the spans started
+// while the trace is adopted by a thread become its children. Only sampled requests have spans,
+// so the others do not pay for them.
+//
+// This class is thread-safe.
+class TraceSpan : public RefCountedThreadSafe<TraceSpan> {
+ public:
+  // Returns whether a request that did not come with a trace context should start a new trace,
+  // according to trace_sampling_rate.
+  static bool ShouldSampleRoot();
+
+  // Starts the first span of a new trace.
+  static scoped_refptr<TraceSpan> StartRoot(std::string name);
+
+  // Starts a span that is a child of the span with the given context. Returns null when the
+  // context is empty, i.e. the request is not sampled.
+  static scoped_refptr<TraceSpan> StartChild(const TraceSpanContext& parent, std::string name);
+
+  // Same as above, but for a local parent span, that could be null.
+  static scoped_refptr<TraceSpan> StartChild(const TraceSpan* parent, std::string name);
+
+  TraceSpanContext context() const {
+    return TraceSpanContext{trace_id_, span_id_};
+  }
+
+  void SetAttribute(std::string key, std::string value);
+
+  // Records that something happened at this moment. The name should be a static string.
+  void AddEvent(const char* name);
+
+  // Finishes the span and passes it to the exporter. Only the first call has any effect.
+  void End();
+
+ private:
+  friend class RefCountedThreadSafe<TraceSpan>;
+
+  TraceSpan(uint64_t trace_id, uint64_t parent_span_id, std::string name);
+  ~TraceSpan();
+
+  const uint64_t trace_id_;
+  const uint64_t span_id_;
+  const uint64_t parent_span_id_;
+  const std::string name_;
+  const int64_t start_time_unix_nanos_;
+
+  simple_spinlock lock_;
+  bool ended_ = false;
+  std::vector<std::pair<std::string, std::string>> attributes_;
+  std::vector<std::pair<int64_t, const char*>> events_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceSpan);
+};
+
+typedef scoped_refptr<TraceSpan> TraceSpanPtr;
+
+// Writes the ended spans kept by the process, the latest trace_span_buffer_size of them, as an
+// OpenTelemetry ExportTraceServiceRequest in the OTLP/JSON encoding. When trace_id is not 0 only
+// the spans of that trace are written.
+void DumpTraceSpansAsOtlpJson(const std::string& service_name, uint64_t trace_id,
+                              std::stringstream* out);
+
+} // namespace yb
+
+#endif // YB_UTIL_TRACE_SPAN_H
@@ -146,6 +146,37 @@ TEST_F(VarIntTest, ComparableEncodingWithReserve) {
   }
 }
 
+TEST_F(VarIntTest, Int64ComparableEncoding) {
+  for (size_t num_reserved_bits : {0, 2}) {
+    for (const auto& value : values_) {
+      SCOPED_TRACE(Format("Value: $0, reserved bits: $1", value, num_reserved_bits));
+      auto encoded = value.EncodeToComparable(num_reserved_bits);
+      int64_t decoded = 0;
+      size_t decoded_size = 0;
+      auto int64_value = value.ToInt64();
+      ASSERT_EQ(int64_value.ok(), VarInt::DecodeInt64FromComparable(
+          encoded, &decoded, &decoded_size, num_reserved_bits));
+      if (!int64_value.ok()) {
+        continue;
+      }
+      ASSERT_EQ(*int64_value, decoded);
+      ASSERT_EQ(encoded.size(), decoded_size);
+      ASSERT_EQ(encoded, VarInt::EncodeInt64ToComparable(*int64_value, num_reserved_bits));
+    }
+  }
+}
+
+TEST_F(VarIntTest, AddComparable) {
+  for (const auto& lhs : values_) {
+    for (const auto& rhs : values_) {
+      SCOPED_TRACE(Format("$0 + $1", lhs, rhs));
+      ASSERT_EQ((lhs + rhs).EncodeToComparable(),
+                ASSERT_RESULT(AddComparableVarInts(
+                    lhs.EncodeToComparable(), rhs.EncodeToComparable())));
+    }
+  }
+}
+
 TEST_F(VarIntTest, TestComparableEncoding) {
   std::vector<std::string> expected = {
       "[ 00000000 00000111 11100000 11100001 11110001 11011101 00000001 00110000 "
@@ -13,6 +13,11 @@
 
 #include "yb/util/varint.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+
 #include <openssl/bn.h>
 
 namespace yb {
@@ -193,6 +198,105 @@ Status VarInt::DecodeFromComparable(const Slice &slice, size_t *num_decoded_byte
   return Status::OK();
 }
 
+std::string VarInt::EncodeInt64ToComparable(int64_t value, size_t num_reserved_bits) {
+  DCHECK_LT(num_reserved_bits, 8);
+
+  if (value == 0) {
+    return std::string(1, 0x80 >> num_reserved_bits);
+  }
+
+  // The same layout as in EncodeToComparable, with the magnitude taken from uint64 instead of
+  // BIGNUM.
+  const bool negative = value < 0;
+  const uint64_t magnitude = negative ? -static_cast<uint64_t>(value) : value;
+  const size_t num_bits = 64 - __builtin_clzll(magnitude);
+  const size_t total_num_bits = num_bits + 1 + num_reserved_bits;
+  const size_t num_bytes = (total_num_bits + 6) / 7;
+  const size_t rounding_padding = num_bytes * 7 - total_num_bits;
+  const size_t header_length = 1 + num_bytes + rounding_padding;
+  const size_t num_value_bytes = (num_bits + kBitsPerWord - 1) / kBitsPerWord;
+  const size_t words_count = (num_bits + header_length + kBitsPerWord - 1) / kBitsPerWord;
+  const size_t offset = words_count - num_value_bytes;
+
+  std::string result(words_count, 0);
+  auto data = pointer_cast<unsigned char*>(const_cast<char*>(result.data()));
+  for (size_t i = 0; i != num_value_bytes; ++i) {
+    data[offset + i] = static_cast<unsigned char>(magnitude >> (8 * (num_value_bytes - i - 1)));
+  }
+  size_t idx = 0;
+  size_t num_ones = num_bytes + num_reserved_bits;
+  while (num_ones > 8) {
+    data[idx] = 0xff;
+    num_ones -= 8;
+    ++idx;
+  }
+  data[idx] |= 0xff ^ ((1 << (8 - num_ones)) - 1);
+  if (negative) {
+    FlipBits(data, result.size());
+  }
+  if (num_reserved_bits) {
+    data[0] &= (1 << (8 - num_reserved_bits)) - 1;
+  }
+
+  return result;
+}
+
+bool VarInt::DecodeInt64FromComparable(
+    const Slice& slice, int64_t* value, size_t* num_decoded_bytes, size_t num_reserved_bits) {
+  DCHECK_LT(num_reserved_bits, 8);
+
+  // Encoding of any int64 value takes at most 10 bytes.
+  constexpr size_t kMaxInt64EncodedBytes = 10;
+
+  if (slice.empty()) {
+    return false;
+  }
+  const bool negative = (slice[0] & (0x80 >> num_reserved_bits)) == 0;
+  const size_t len = std::min(slice.size(), kMaxInt64EncodedBytes);
+  uint8_t buffer[kMaxInt64EncodedBytes];
+  memcpy(buffer, slice.data(), len);
+  if (negative) {
+    FlipBits(buffer, len);
+  }
+  if (num_reserved_bits) {
+    buffer[0] |= ~((1 << (8 - num_reserved_bits)) - 1);
+  }
+  size_t idx = 0;
+  size_t num_ones = 0;
+  while (buffer[idx] == 0xff) {
+    ++idx;
+    if (idx >= len) {
+      return false;
+    }
+    num_ones += 8;
+  }
+  uint8_t temp = 0x80;
+  while (buffer[idx] & temp) {
+    buffer[idx] ^= temp;
+    ++num_ones;
+    temp >>= 1;
+  }
+  num_ones -= num_reserved_bits;
+  if (num_ones > len) {
+    return false;
+  }
+  uint64_t magnitude = 0;
+  for (size_t i = idx; i < num_ones; ++i) {
+    if (magnitude >> 56) {
+      return false;
+    }
+    magnitude = (magnitude << 8) | buffer[i];
+  }
+  const uint64_t bound = negative ? static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1
+                                  : std::numeric_limits<int64_t>::max();
+  if (magnitude > bound) {
+    return false;
+  }
+  *value = negative ? static_cast<int64_t>(-magnitude) : static_cast<int64_t>(magnitude);
+  *num_decoded_bytes = num_ones;
+  return true;
+}
+
 Status VarInt::DecodeFromComparable(const Slice& slice) {
   size_t num_decoded_bytes;
   return DecodeFromComparable(slice, &num_decoded_bytes);
@@ -284,5 +388,19 @@ VarInt operator-(const VarInt& lhs, const VarInt& rhs) {
   return VarInt(std::move(temp));
 }
 
+Result<std::string> AddComparableVarInts(const Slice& lhs, const Slice& rhs) {
+  int64_t lhs_value, rhs_value, sum;
+  size_t num_decoded_bytes;
+  if (VarInt::DecodeInt64FromComparable(lhs, &lhs_value, &num_decoded_bytes) &&
+      VarInt::DecodeInt64FromComparable(rhs, &rhs_value, &num_decoded_bytes) &&
+      !__builtin_add_overflow(lhs_value, rhs_value, &sum)) {
+    return VarInt::EncodeInt64ToComparable(sum);
+  }
+  VarInt lhs_varint, rhs_varint;
+  RETURN_NOT_OK(lhs_varint.DecodeFromComparable(lhs, &num_decoded_bytes));
+  RETURN_NOT_OK(rhs_varint.DecodeFromComparable(rhs, &num_decoded_bytes));
+  return (lhs_varint + rhs_varint).EncodeToComparable();
+}
+
 } // namespace util
 } // namespace yb
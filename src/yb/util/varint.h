@@ -189,6 +189,15 @@ class VarInt {
   CHECKED_STATUS DecodeFromComparable(const Slice& string);
   CHECKED_STATUS DecodeFromComparable(const std::string& string);
 
+  // Fast paths of the comparable encoding for the values that fit int64, they do not use BIGNUM.
+  // EncodeInt64ToComparable(value, n) is equal to VarInt(value).EncodeToComparable(n).
+  static std::string EncodeInt64ToComparable(int64_t value, size_t num_reserved_bits = 0);
+
+  // Decodes the value encoded by EncodeToComparable when it fits int64. Returns false when it does
+  // not fit or the encoding is broken, DecodeFromComparable should be used in this case.
+  static bool DecodeInt64FromComparable(
+      const Slice& slice, int64_t* value, size_t* num_decoded_bytes, size_t num_reserved_bits = 0);
+
   // Each byte in the encoding encodes two digits, and a continuation bit in the beginning.
   // The continuation bit is zero if and only if this is the last byte of the encoding.
   std::string EncodeToTwosComplement() const;
@@ -210,6 +219,10 @@ class VarInt {
 
 std::ostream& operator<<(ostream& os, const VarInt& v);
 
+// Returns the comparable encoding of the sum of the varints with comparable encodings lhs and rhs.
+// Uses int64 arithmetic when the values and the sum fit it.
+Result<std::string> AddComparableVarInts(const Slice& lhs, const Slice& rhs);
+
 
 } // namespace util
 } // namespace yb
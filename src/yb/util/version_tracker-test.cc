@@ -0,0 +1,66 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <map>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/locks.h"
+#include "yb/util/test_util.h"
+#include "yb/util/version_tracker.h"
+
+namespace yb {
+
+typedef std::map<int, std::string> TestMap;
+
+class VersionTrackerTest : public YBTest {
+ protected:
+  void Set(int key, const std::string& value) {
+    std::lock_guard<rw_spinlock> lock(lock_);
+    auto checkout = map_.CheckOut();
+    (*checkout)[key] = value;
+  }
+
+  rw_spinlock lock_;
+  VersionTracker<TestMap> map_;
+};
+
+TEST_F(VersionTrackerTest, Snapshot) {
+  size_t version = 0;
+  ASSERT_EQ(map_.LastSnapshot(&version), nullptr);
+
+  Set(1, "one");
+  auto snapshot = map_.Snapshot(&lock_);
+  ASSERT_EQ(snapshot->size(), 1);
+  ASSERT_EQ(snapshot->at(1), "one");
+  // Data was not modified, so the same snapshot is returned.
+  ASSERT_EQ(map_.Snapshot(&lock_), snapshot);
+  ASSERT_EQ(map_.LastSnapshot(&version), snapshot);
+  ASSERT_EQ(version, map_.Version());
+
+  Set(1, "uno");
+  Set(2, "two");
+  // The last snapshot is stale, but it is not changed by writers.
+  ASSERT_EQ(map_.LastSnapshot(&version), snapshot);
+  ASSERT_NE(version, map_.Version());
+  ASSERT_EQ(snapshot->at(1), "one");
+
+  auto fresh = map_.Snapshot(&lock_);
+  ASSERT_NE(fresh, snapshot);
+  ASSERT_EQ(fresh->size(), 2);
+  ASSERT_EQ(fresh->at(1), "uno");
+  ASSERT_EQ(snapshot->size(), 1);
+}
+
+} // namespace yb
@@ -16,6 +16,13 @@
 #ifndef YB_UTIL_VERSION_TRACKER_H
 #define YB_UTIL_VERSION_TRACKER_H
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "yb/util/locks.h"
+#include "yb/util/shared_lock.h"
+
 namespace yb {
 
 template <class Value>
@@ -27,6 +34,11 @@ class VersionTrackerCheckOut;
 // auto checkout = versioned_data.CheckOut();
 // And checkout would provide write access to data.
 // After checkout is destroyed, version is incremented.
+//
+// Readers that should not wait for the external lock could use an immutable snapshot of data:
+// auto snapshot = versioned_data.Snapshot(&lock);
+// The snapshot is copied from data under the shared lock, when data was modified since the last
+// snapshot was taken, so writers should hold that lock exclusively while data is checked out.
 template <class Value>
 class VersionTracker {
  public:
@@ -55,11 +67,29 @@ class VersionTracker {
     return version_.load(std::memory_order_acquire);
   }
 
+  // Returns the snapshot of the current version of data, taking a new one if needed.
+  template <class Lock>
+  std::shared_ptr<const Value> Snapshot(Lock* lock) const;
+
+  // Returns the last taken snapshot and fills its version, without waiting for the lock. The
+  // snapshot could be stale, or null if no snapshot was taken yet.
+  std::shared_ptr<const Value> LastSnapshot(size_t* version) const {
+    std::lock_guard<simple_spinlock> lock(snapshot_mutex_);
+    *version = snapshot_version_;
+    return snapshot_;
+  }
+
  private:
   friend class VersionTrackerCheckOut<Value>;
 
   Value value_;
   std::atomic<size_t> version_{0};
+
+  // Held while a new snapshot is taken, so concurrent readers do not copy the same version of data.
+  mutable std::mutex refresh_mutex_;
+  mutable simple_spinlock snapshot_mutex_;
+  mutable std::shared_ptr<const Value> snapshot_;
+  mutable size_t snapshot_version_ = 0;
 };
 
 template <class Value>
@@ -101,6 +131,36 @@ VersionTrackerCheckOut<Value> VersionTracker<Value>::CheckOut() {
   return VersionTrackerCheckOut<Value>(this);
 }
 
+template <class Value>
+template <class Lock>
+std::shared_ptr<const Value> VersionTracker<Value>::Snapshot(Lock* lock) const {
+  size_t version = 0;
+  auto result = LastSnapshot(&version);
+  if (result && version == Version()) {
+    return result;
+  }
+
+  std::lock_guard<std::mutex> refresh_lock(refresh_mutex_);
+  {
+    SharedLock<Lock> shared_lock(*lock);
+    result = LastSnapshot(&version);
+    if (result && version == Version()) {
+      return result;
+    }
+    result = std::make_shared<const Value>(value_);
+    version = Version();
+  }
+
+  // The previous snapshot is released after the spinlock, it could take a while to destroy.
+  std::shared_ptr<const Value> previous = result;
+  {
+    std::lock_guard<simple_spinlock> snapshot_lock(snapshot_mutex_);
+    snapshot_.swap(previous);
+    snapshot_version_ = version;
+  }
+  return result;
+}
+
 } // namespace yb
 
 #endif // YB_UTIL_VERSION_TRACKER_H
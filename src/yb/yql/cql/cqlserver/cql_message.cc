@@ -27,8 +27,16 @@
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
+DEFINE_int32(cql_response_compression_min_size, 256,
+             "Minimum size of the body of a CQL response to compress, when compression is "
+             "negotiated by the client. Smaller bodies, as well as bodies that do not compress, "
+             "are sent uncompressed, as the compression flag of the response header allows.");
+TAG_FLAG(cql_response_compression_min_size, advanced);
+TAG_FLAG(cql_response_compression_min_size, runtime);
+
 namespace yb {
 namespace cqlserver {
 
@@ -940,41 +948,54 @@ CQLResponse::~CQLResponse() {
 
 void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststring* mesg) const {
   const size_t start_pos = mesg->size(); // save the start position
-  const bool compress = (compression_scheme != CQLMessage::CompressionScheme::kNone);
-  SerializeHeader(compress, mesg);
-  if (compress) {
+  if (compression_scheme == CQLMessage::CompressionScheme::kNone) {
+    SerializeHeader(false /* compress */, mesg);
+    SerializeBody(mesg);
+  } else {
     faststring body;
     SerializeBody(&body);
-    switch (compression_scheme) {
-      case CQLMessage::CompressionScheme::kLz4: {
-        SerializeInt(static_cast<int32_t>(body.size()), mesg);
-        const size_t curr_size = mesg->size();
-        const int max_comp_size = LZ4_compressBound(body.size());
-        mesg->resize(curr_size + max_comp_size);
-        const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
-                                                   to_char_ptr(mesg->data() + curr_size),
-                                                   body.size(),
-                                                   max_comp_size);
-        CHECK_NE(comp_size, 0) << "LZ4 compression failed";
-        mesg->resize(curr_size + comp_size);
-        break;
-      }
-      case CQLMessage::CompressionScheme::kSnappy: {
-        const size_t curr_size = mesg->size();
-        const size_t max_comp_size = MaxCompressedLength(body.size());
-        size_t comp_size = 0;
-        mesg->resize(curr_size + max_comp_size);
-        RawCompress(to_char_ptr(body.data()), body.size(),
-                    to_char_ptr(mesg->data() + curr_size), &comp_size);
-        mesg->resize(curr_size + comp_size);
-        break;
+    // Small bodies are sent uncompressed, which the compression flag of the header allows per
+    // response, because compressing them costs more CPU than the bytes it saves.
+    const bool compress =
+        static_cast<int64_t>(body.size()) >= FLAGS_cql_response_compression_min_size;
+    SerializeHeader(compress, mesg);
+    const size_t body_pos = mesg->size();
+    if (compress) {
+      switch (compression_scheme) {
+        case CQLMessage::CompressionScheme::kLz4: {
+          SerializeInt(static_cast<int32_t>(body.size()), mesg);
+          const size_t curr_size = mesg->size();
+          const int max_comp_size = LZ4_compressBound(body.size());
+          mesg->resize(curr_size + max_comp_size);
+          const int comp_size = LZ4_compress_default(to_char_ptr(body.data()),
+                                                     to_char_ptr(mesg->data() + curr_size),
+                                                     body.size(),
+                                                     max_comp_size);
+          CHECK_NE(comp_size, 0) << "LZ4 compression failed";
+          mesg->resize(curr_size + comp_size);
+          break;
+        }
+        case CQLMessage::CompressionScheme::kSnappy: {
+          const size_t curr_size = mesg->size();
+          const size_t max_comp_size = MaxCompressedLength(body.size());
+          size_t comp_size = 0;
+          mesg->resize(curr_size + max_comp_size);
+          RawCompress(to_char_ptr(body.data()), body.size(),
+                      to_char_ptr(mesg->data() + curr_size), &comp_size);
+          mesg->resize(curr_size + comp_size);
+          break;
+        }
+        case CQLMessage::CompressionScheme::kNone:
+          LOG(FATAL) << "No compression scheme";
+          break;
       }
-      case CQLMessage::CompressionScheme::kNone:
-        LOG(FATAL) << "No compression scheme";
-        break;
     }
-  } else {
-    SerializeBody(mesg);
+    // Send the body uncompressed also if compression does not make it smaller.
+    if (!compress || mesg->size() - body_pos >= body.size()) {
+      mesg->resize(body_pos);
+      mesg->append(body.data(), body.size());
+      SERIALIZE_BYTE(mesg->data(), start_pos + kHeaderPosFlags, flags());
+    }
   }
   SERIALIZE_INT(
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
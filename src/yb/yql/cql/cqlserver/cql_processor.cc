@@ -142,6 +142,7 @@ CQLProcessor::CQLProcessor(CQLServiceImpl* service_impl, const CQLProcessorListP
       statement_executed_cb_(Bind(&CQLProcessor::StatementExecuted, Unretained(this))) {
   IncrementCounter(cql_metrics_->cql_processors_created_);
   IncrementGauge(cql_metrics_->cql_processors_alive_);
+  ql_env_.set_system_table_cache(service_impl->system_table_cache());
 }
 
 CQLProcessor::~CQLProcessor() {
@@ -211,6 +212,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   request_ = nullptr;
   stmts_.clear();
   parse_trees_.clear();
+  unprepared_stmt_ = nullptr;
   SetCurrentSession(nullptr);
   service_impl_->ReturnProcessor(pos_);
 }
@@ -318,8 +320,32 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
-  RunAsync(req.query(), req.params(), statement_executed_cb_);
-  return nullptr;
+  CQLStatementCache* const unprepared_stmts = service_impl_->unprepared_stmts();
+  if (unprepared_stmts == nullptr) {
+    RunAsync(req.query(), req.params(), statement_executed_cb_);
+    return nullptr;
+  }
+
+  // Look up the parse tree of the query in the cache, or parse and analyze the query and cache it,
+  // the same way a prepared statement is. A stale statement is replaced in the cache, so the
+  // retry of a query that failed due to stale metadata parses it again.
+  shared_ptr<CQLStatement> stmt = unprepared_stmts->Allocate(
+      CQLStatement::GetQueryId(ql_env_.CurrentKeyspace(), req.query()),
+      ql_env_.CurrentKeyspace(), req.query());
+  Status s = stmt->Prepare(this, unprepared_stmts->mem_tracker());
+  if (!s.ok()) {
+    unprepared_stmts->Delete(stmt);
+    return ProcessError(s);
+  }
+  // Only DML statements are kept in the cache. Their permissions are checked when they are
+  // executed, while other statements check some of them during the analysis.
+  const Result<const ParseTree&> parse_tree = stmt->GetParseTree();
+  if (!parse_tree || parse_tree->root() == nullptr || !parse_tree->root()->IsDml()) {
+    unprepared_stmts->Delete(stmt);
+  }
+  unprepared_stmt_ = stmt;
+  s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
+  return s.ok() ? nullptr : ProcessError(s);
 }
 
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
@@ -424,6 +450,7 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
       if (++retry_count_ == 1) {
         stmts_.clear();
         parse_trees_.clear();
+        unprepared_stmt_ = nullptr;
         Reschedule(&process_request_task_.Bind(this));
         return nullptr;
       }
@@ -116,6 +116,8 @@ class CQLProcessor : public ql::QLProcessor {
   std::shared_ptr<const CQLRequest> request_;
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
+  // Cached unprepared query being executed.
+  std::shared_ptr<const CQLStatement> unprepared_stmt_;
 
   // Current retry count.
   int retry_count_ = 0;
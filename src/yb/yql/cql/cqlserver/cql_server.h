@@ -53,6 +53,7 @@ class CQLServer : public server::RpcAndWebServerBase {
   void Shutdown();
 
   const tserver::TabletServer* tserver() const { return tserver_; }
+  tserver::TabletServer* tserver() { return tserver_; }
 
  private:
   CQLServerOptions opts_;
@@ -43,6 +43,25 @@ DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 128_MB,
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
+DEFINE_int64(cql_service_max_unprepared_statement_size_bytes, 0,
+             "The maximum amount of memory the CQL proxy should use to cache parsed and analyzed "
+             "unprepared DML queries, so repeated query strings are not parsed and analyzed "
+             "again. 0 or negative means such queries are not cached.");
+
+METRIC_DEFINE_counter(
+    server, cql_prepared_statement_cache_hits, "CQL prepared statement cache hits",
+    yb::MetricUnit::kRequests, "Number of lookups of prepared statements that were cached");
+METRIC_DEFINE_counter(
+    server, cql_prepared_statement_cache_misses, "CQL prepared statement cache misses",
+    yb::MetricUnit::kRequests, "Number of lookups of prepared statements that were not cached");
+METRIC_DEFINE_counter(
+    server, cql_unprepared_statement_cache_hits, "CQL unprepared statement cache hits",
+    yb::MetricUnit::kRequests,
+    "Number of unprepared queries that were found parsed and analyzed in the cache");
+METRIC_DEFINE_counter(
+    server, cql_unprepared_statement_cache_misses, "CQL unprepared statement cache misses",
+    yb::MetricUnit::kRequests,
+    "Number of unprepared queries that had to be parsed and analyzed");
 
 namespace yb {
 namespace cqlserver {
@@ -75,18 +94,32 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts,
   // TODO(ENG-446): Handle metrics for all the methods individually.
   cql_metrics_ = std::make_shared<CQLMetrics>(server->metric_entity());
 
-  // Setup prepared statements' memory tracker. Add garbage-collect function to delete least
-  // recently used statements when limit is hit.
-  prepared_stmts_mem_tracker_ = MemTracker::CreateTracker(
-      FLAGS_cql_service_max_prepared_statement_size_bytes > 0 ?
-      FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
-      "CQL prepared statements", server->mem_tracker());
+  // Setup prepared statements' cache. Its garbage-collect function deletes least recently used
+  // statements when the memory limit is hit.
+  prepared_stmts_ = std::make_shared<CQLStatementCache>(
+      "CQL prepared statements", FLAGS_cql_service_max_prepared_statement_size_bytes,
+      server->mem_tracker(),
+      METRIC_cql_prepared_statement_cache_hits.Instantiate(server->metric_entity()),
+      METRIC_cql_prepared_statement_cache_misses.Instantiate(server->metric_entity()));
+  if (FLAGS_cql_service_max_unprepared_statement_size_bytes > 0) {
+    unprepared_stmts_ = std::make_shared<CQLStatementCache>(
+        "CQL unprepared statements", FLAGS_cql_service_max_unprepared_statement_size_bytes,
+        server->mem_tracker(),
+        METRIC_cql_unprepared_statement_cache_hits.Instantiate(server->metric_entity()),
+        METRIC_cql_unprepared_statement_cache_misses.Instantiate(server->metric_entity()));
+  }
 
   auth_prepared_stmt_ = std::make_shared<ql::Statement>(
       "",
       Substitute("SELECT $0, $1 FROM system_auth.roles WHERE role = ?",
                  kRoleColumnNameSaltedHash, kRoleColumnNameCanLogin));
 
+  if (server->tserver() != nullptr) {
+    auto* tserver = server->tserver();
+    system_table_cache_ = std::make_shared<ql::SystemTableCache>(
+        [tserver] { return tserver->ycql_topology_version(); });
+  }
+
   async_client_init_.Start();
 }
 
@@ -106,6 +139,24 @@ client::YBClient* CQLServiceImpl::client() const {
       // Create and save the metadata cache object.
       metadata_cache_ = std::make_shared<YBMetaDataCache>(client,
                                                           FLAGS_use_cassandra_authentication);
+      // Invalidate cached tables when they are changed, as reported by the master.
+      if (server_->tserver() != nullptr) {
+        std::weak_ptr<YBMetaDataCache> weak_cache = metadata_cache_;
+        server_->tserver()->AddTableChangesListener(
+            [weak_cache](const master::TSHeartbeatResponsePB& resp) {
+          auto cache = weak_cache.lock();
+          if (!cache) {
+            return;
+          }
+          std::vector<TableId> changed_tables;
+          bool table_created = false;
+          for (const auto& change : resp.table_changes()) {
+            changed_tables.push_back(change.table_id());
+            table_created = table_created || change.created();
+          }
+          cache->ProcessTableChanges(changed_tables, table_created, resp.invalidate_all_tables());
+        });
+      }
       is_metadata_initialized_.store(true, std::memory_order_release);
     }
   }
@@ -119,7 +170,10 @@ const std::shared_ptr<client::YBMetaDataCache>& CQLServiceImpl::metadata_cache()
 }
 
 void CQLServiceImpl::CompleteInit() {
-  prepared_stmts_mem_tracker_->AddGarbageCollector(shared_from_this());
+  prepared_stmts_->mem_tracker()->AddGarbageCollector(prepared_stmts_);
+  if (unprepared_stmts_) {
+    unprepared_stmts_->mem_tracker()->AddGarbageCollector(unprepared_stmts_);
+  }
 }
 
 void CQLServiceImpl::Shutdown() {
@@ -167,108 +221,16 @@ void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
 
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
-    // statement to contend on. The statement will then be prepared by one client while the rest
-    // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
-        query_id, std::make_shared<CQLStatement>(
-            keyspace, query, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
-  } else {
-    // Return existing statement if found.
-    stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
-  }
-
-  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
-
-  return stmt;
+  return prepared_stmts_->Allocate(query_id, keyspace, query);
 }
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
-  }
-
-  shared_ptr<CQLStatement> stmt = itr->second;
-
-  // If the statement has not finished preparing, do not return it.
-  if (stmt->unprepared()) {
-    return nullptr;
-  }
-  // If the statement is stale, delete it.
-  if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
-    return nullptr;
-  }
-
-  MoveLruPreparedStatementUnlocked(stmt);
-  return stmt;
+  return prepared_stmts_->Get(query_id);
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
-  // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  DeletePreparedStatementUnlocked(stmt);
-
-  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
-}
-
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
-}
-
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
-}
-
-void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
-  // Remove statement from cache by looking it up by query ID and only when it is same statement
-  // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
-  }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
-  }
-}
-
-void CQLServiceImpl::CollectGarbage(size_t required) {
-  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
-  // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
-  }
-
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+  prepared_stmts_->Delete(stmt);
 }
 
 server::Clock* CQLServiceImpl::clock() {
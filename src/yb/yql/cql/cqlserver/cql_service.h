@@ -27,6 +27,7 @@
 #include "yb/yql/cql/cqlserver/cql_service.service.h"
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
+#include "yb/yql/cql/ql/util/system_table_cache.h"
 
 #include "yb/util/string_case.h"
 
@@ -44,7 +45,6 @@ class CQLProcessor;
 class CQLServer;
 
 class CQLServiceImpl : public CQLServerServiceIf,
-                       public GarbageCollector,
                        public std::enable_shared_from_this<CQLServiceImpl> {
  public:
   // Constructor.
@@ -76,7 +76,12 @@ class CQLServiceImpl : public CQLServerServiceIf,
 
   // Return the memory tracker for prepared statements.
   const MemTrackerPtr& prepared_stmts_mem_tracker() const {
-    return prepared_stmts_mem_tracker_;
+    return prepared_stmts_->mem_tracker();
+  }
+
+  // Return the cache of parsed and analyzed unprepared queries, nullptr if they are not cached.
+  CQLStatementCache* unprepared_stmts() const {
+    return unprepared_stmts_.get();
   }
 
   // Return the YBClient to communicate with either master or tserver.
@@ -97,27 +102,17 @@ class CQLServiceImpl : public CQLServerServiceIf,
     return transaction_pool_provider_;
   }
 
+  // Return the cache of system table reads, or nullptr when not running in a tablet server.
+  const std::shared_ptr<ql::SystemTableCache>& system_table_cache() const {
+    return system_table_cache_;
+  }
+
  private:
   constexpr static int kRpcTimeoutSec = 5;
 
   // Either gets an available processor or creates a new one.
   CQLProcessor *GetProcessor();
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
-
-  // Delete the least recently used prepared statement from the cache to free up memory.
-  void CollectGarbage(size_t required) override;
-
   // CQLServer of this service.
   CQLServer* const server_;
 
@@ -140,19 +135,13 @@ class CQLServiceImpl : public CQLServerServiceIf,
   std::mutex processors_mutex_;
 
   // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
-
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
+  std::shared_ptr<CQLStatementCache> prepared_stmts_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Cache of unprepared queries, so repeated query strings are not parsed and analyzed again.
+  std::shared_ptr<CQLStatementCache> unprepared_stmts_;
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
-  // Tracker to measure and limit memory usage of prepared statements.
-  MemTrackerPtr prepared_stmts_mem_tracker_;
-
   // Metrics to be collected and reported.
   yb::rpc::RpcMethodMetrics metrics_;
 
@@ -161,6 +150,10 @@ class CQLServiceImpl : public CQLServerServiceIf,
   rpc::Messenger* messenger_ = nullptr;
 
   ql::TransactionPoolProvider transaction_pool_provider_;
+
+  // Cache of the rows read from system.peers, system.local and system.partitions, refreshed when
+  // the tablet server reports a new topology version.
+  std::shared_ptr<ql::SystemTableCache> system_table_cache_;
 };
 
 }  // namespace cqlserver
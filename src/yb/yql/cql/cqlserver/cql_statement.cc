@@ -39,5 +39,133 @@ CQLMessage::QueryId CQLStatement::GetQueryId(const string& keyspace, const strin
   return CQLMessage::QueryId(util::to_char_ptr(md5), sizeof(md5));
 }
 
+//------------------------------------------------------------------------------------------------
+CQLStatementCache::CQLStatementCache(
+    const string& name, const int64_t limit, const MemTrackerPtr& parent,
+    scoped_refptr<Counter> hits, scoped_refptr<Counter> misses)
+    : name_(name),
+      mem_tracker_(MemTracker::CreateTracker(limit > 0 ? limit : -1, name, parent)),
+      hits_(std::move(hits)),
+      misses_(std::move(misses)) {
+}
+
+CQLStatementCache::~CQLStatementCache() {
+}
+
+CQLStatementCache::Shard& CQLStatementCache::GetShard(const CQLMessage::QueryId& query_id) {
+  return shards_[std::hash<CQLMessage::QueryId>()(query_id) % kNumShards];
+}
+
+std::shared_ptr<CQLStatement> CQLStatementCache::Allocate(
+    const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
+  auto& shard = GetShard(query_id);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+
+  const auto itr = shard.map.find(query_id);
+  if (itr != shard.map.end()) {
+    if (itr->second->unprepared() || !itr->second->stale()) {
+      // Return existing statement if found.
+      std::shared_ptr<CQLStatement> stmt = itr->second;
+      MoveUnlocked(&shard, stmt);
+      hits_->Increment();
+      return stmt;
+    }
+    DeleteUnlocked(&shard, itr->second);
+  }
+
+  // Allocate the statement placeholder that multiple clients trying to prepare the same statement
+  // contend on. The statement will then be prepared by one client while the rest wait for the
+  // results.
+  std::shared_ptr<CQLStatement> stmt = shard.map.emplace(
+      query_id, std::make_shared<CQLStatement>(keyspace, query, shard.list.end())).first->second;
+  InsertUnlocked(&shard, stmt);
+  misses_->Increment();
+
+  VLOG(1) << name_ << ": allocated statement, shard count = " << shard.map.size() << "/"
+          << shard.list.size() << ", memory usage = " << mem_tracker_->consumption();
+  return stmt;
+}
+
+std::shared_ptr<const CQLStatement> CQLStatementCache::Get(const CQLMessage::QueryId& query_id) {
+  auto& shard = GetShard(query_id);
+  std::lock_guard<std::mutex> guard(shard.mutex);
+
+  const auto itr = shard.map.find(query_id);
+  if (itr == shard.map.end()) {
+    misses_->Increment();
+    return nullptr;
+  }
+
+  std::shared_ptr<CQLStatement> stmt = itr->second;
+
+  // If the statement has not finished preparing, do not return it.
+  if (stmt->unprepared()) {
+    misses_->Increment();
+    return nullptr;
+  }
+  // If the statement is stale, delete it.
+  if (stmt->stale()) {
+    DeleteUnlocked(&shard, stmt);
+    misses_->Increment();
+    return nullptr;
+  }
+
+  MoveUnlocked(&shard, stmt);
+  hits_->Increment();
+  return stmt;
+}
+
+void CQLStatementCache::Delete(const std::shared_ptr<const CQLStatement>& stmt) {
+  auto& shard = GetShard(stmt->query_id());
+  std::lock_guard<std::mutex> guard(shard.mutex);
+
+  DeleteUnlocked(&shard, stmt);
+
+  VLOG(1) << name_ << ": deleted statement, shard count = " << shard.map.size() << "/"
+          << shard.list.size() << ", memory usage = " << mem_tracker_->consumption();
+}
+
+void CQLStatementCache::InsertUnlocked(Shard* shard, const std::shared_ptr<CQLStatement>& stmt) {
+  // Insert the statement at the front of the LRU list.
+  stmt->set_pos(shard->list.insert(shard->list.begin(), stmt));
+}
+
+void CQLStatementCache::MoveUnlocked(Shard* shard, const std::shared_ptr<CQLStatement>& stmt) {
+  // Move the statement to the front of the LRU list.
+  shard->list.splice(shard->list.begin(), shard->list, stmt->pos());
+}
+
+void CQLStatementCache::DeleteUnlocked(
+    Shard* shard, const std::shared_ptr<const CQLStatement> stmt) {
+  // Remove statement from cache by looking it up by query ID and only when it is same statement
+  // object.
+  const auto itr = shard->map.find(stmt->query_id());
+  if (itr != shard->map.end() && itr->second == stmt) {
+    shard->map.erase(itr);
+  }
+  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != shard->list.end()) {
+    shard->list.erase(stmt->pos());
+    stmt->set_pos(shard->list.end());
+  }
+}
+
+void CQLStatementCache::CollectGarbage(size_t required) {
+  // Delete the least recently used statement of the first non-empty shard, starting from the
+  // shard after the one that was collected last time.
+  for (size_t i = 0; i != kNumShards; ++i) {
+    auto& shard = shards_[next_gc_shard_.fetch_add(1, std::memory_order_relaxed) % kNumShards];
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    if (!shard.list.empty()) {
+      DeleteUnlocked(&shard, shard.list.back());
+
+      VLOG(1) << name_ << ": deleted least recently used statement, shard count = "
+              << shard.map.size() << "/" << shard.list.size()
+              << ", memory usage = " << mem_tracker_->consumption();
+      return;
+    }
+  }
+}
+
 }  // namespace cqlserver
 }  // namespace yb
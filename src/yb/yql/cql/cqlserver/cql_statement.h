@@ -19,7 +19,15 @@
 #ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
+#include <array>
+#include <atomic>
 #include <list>
+#include <mutex>
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/ql/statement.h"
@@ -59,6 +67,68 @@ class CQLStatement : public ql::Statement {
   mutable CQLStatementListPos pos_;
 };
 
+// A cache of CQL statements by query id. The statements are split into shards by query id, each
+// with its own map, LRU list and mutex, so lookups of different statements do not contend on a
+// single mutex. The memory of the parse trees is tracked by mem_tracker(). When it reaches its
+// limit, the least recently used statements are deleted from the shards in turn.
+class CQLStatementCache : public GarbageCollector {
+ public:
+  CQLStatementCache(const std::string& name, int64_t limit, const MemTrackerPtr& parent,
+                    scoped_refptr<Counter> hits, scoped_refptr<Counter> misses);
+  ~CQLStatementCache();
+
+  // Allocate a statement. If the statement already exists, return it instead. A stale statement
+  // is replaced by a new one.
+  std::shared_ptr<CQLStatement> Allocate(
+      const CQLMessage::QueryId& query_id, const std::string& keyspace, const std::string& query);
+
+  // Look up a statement by its id. Nullptr will be returned if the statement is not found, has not
+  // finished preparing or is stale.
+  std::shared_ptr<const CQLStatement> Get(const CQLMessage::QueryId& query_id);
+
+  // Delete the statement from the cache.
+  void Delete(const std::shared_ptr<const CQLStatement>& stmt);
+
+  // Delete the least recently used statement of the next shard to free up memory.
+  void CollectGarbage(size_t required) override;
+
+  const MemTrackerPtr& mem_tracker() const {
+    return mem_tracker_;
+  }
+
+ private:
+  static constexpr size_t kNumShards = 16;
+
+  struct Shard {
+    std::mutex mutex;
+    CQLStatementMap map GUARDED_BY(mutex);
+    // LRU list, least recently used statement at the end.
+    CQLStatementList list GUARDED_BY(mutex);
+  };
+
+  Shard& GetShard(const CQLMessage::QueryId& query_id);
+
+  // Insert a statement at the front of the LRU list of the shard.
+  static void InsertUnlocked(Shard* shard, const std::shared_ptr<CQLStatement>& stmt)
+      REQUIRES(shard->mutex);
+
+  // Move a statement to the front of the LRU list of the shard.
+  static void MoveUnlocked(Shard* shard, const std::shared_ptr<CQLStatement>& stmt)
+      REQUIRES(shard->mutex);
+
+  // Delete a statement from the map and the LRU list of the shard. "stmt" is not a reference, so
+  // it is not the very shared_ptr in the map or the list that is deleted.
+  static void DeleteUnlocked(Shard* shard, const std::shared_ptr<const CQLStatement> stmt)
+      REQUIRES(shard->mutex);
+
+  const std::string name_;
+  MemTrackerPtr mem_tracker_;
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+  std::array<Shard, kNumShards> shards_;
+  std::atomic<size_t> next_gc_shard_{0};
+};
+
 }  // namespace cqlserver
 }  // namespace yb
 
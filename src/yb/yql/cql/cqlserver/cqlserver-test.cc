@@ -201,6 +201,26 @@ TEST_F(TestCQLService, OptionsRequest) {
                                "\x00\x02" "\x00\x05" "3.0.0" "\x00\x05" "3.4.2"));
 }
 
+TEST_F(TestCQLService, SmallResponsesNotCompressed) {
+  LOG(INFO) << "Test small CQL responses with compression";
+  // Send STARTUP request with LZ4 compression using version V4
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x01" "\x00\x00\x00\x28"
+                    "\x00\x02" "\x00\x0b" "CQL_VERSION" "\x00\x05" "3.0.0"
+                               "\x00\x0b" "COMPRESSION" "\x00\x03" "lz4"),
+      BINARY_STRING("\x84\x00\x00\x00\x02" "\x00\x00\x00\x00"));
+
+  // The SUPPORTED response is smaller than cql_response_compression_min_size, so it is sent
+  // without the compression flag.
+  SendRequestAndExpectResponse(
+      BINARY_STRING("\x04\x00\x00\x00\x05" "\x00\x00\x00\x00"),
+      BINARY_STRING("\x84\x00\x00\x00\x06" "\x00\x00\x00\x3b"
+                    "\x00\x02" "\x00\x0b" "COMPRESSION"
+                               "\x00\x02" "\x00\x03" "lz4" "\x00\x06" "snappy"
+                               "\x00\x0b" "CQL_VERSION"
+                               "\x00\x02" "\x00\x05" "3.0.0" "\x00\x05" "3.4.2"));
+}
+
 TEST_F(TestCQLService, InvalidRequest) {
   LOG(INFO) << "Test invalid CQL request";
   // Send response (0x84) as request
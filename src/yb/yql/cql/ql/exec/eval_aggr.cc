@@ -143,8 +143,8 @@ Status Executor::EvalSum(const shared_ptr<QLRowBlock>& row_block,
         ql_value->set_int64_value(ql_value->int64_value() + row.column(column_index).int64_value());
         break;
       case DataType::VARINT:
-        ql_value->set_varint_value(ql_value->varint_value() +
-                                   row.column(column_index).varint_value());
+        *ql_value->mutable_varint_value() = VERIFY_RESULT(util::AddComparableVarInts(
+            ql_value->value().varint_value(), row.column(column_index).value().varint_value()));
         break;
       case DataType::FLOAT:
         ql_value->set_float_value(ql_value->float_value() + row.column(column_index).float_value());
@@ -153,14 +153,10 @@ Status Executor::EvalSum(const shared_ptr<QLRowBlock>& row_block,
         ql_value->set_double_value(ql_value->double_value() +
                                    row.column(column_index).double_value());
         break;
-      case DataType::DECIMAL: {
-        Decimal sum, value;
-        RETURN_NOT_OK(sum.DecodeFromComparable(ql_value->decimal_value()));
-        RETURN_NOT_OK(value.DecodeFromComparable(row.column(column_index).decimal_value()));
-        sum = sum + value;
-        ql_value->set_decimal_value(sum.EncodeToComparable());
+      case DataType::DECIMAL:
+        ql_value->set_decimal_value(VERIFY_RESULT(util::AddComparableDecimals(
+            ql_value->decimal_value(), row.column(column_index).decimal_value())));
         break;
-      }
       default:
         return STATUS(RuntimeError, "Unexpected datatype for argument of SUM()");
     }
@@ -236,7 +232,8 @@ Status Executor::EvalAvg(const shared_ptr<QLRowBlock>& row_block,
         sum.set_int64_value(sum.int64_value() + map.values(0).int64_value());
         break;
       case DataType::VARINT:
-        sum.set_varint_value(sum.varint_value() + QLValue(map.values(0)).varint_value());
+        *sum.mutable_varint_value() = VERIFY_RESULT(util::AddComparableVarInts(
+            sum.value().varint_value(), map.values(0).varint_value()));
         break;
       case DataType::FLOAT:
         sum.set_float_value(sum.float_value() + map.values(0).float_value());
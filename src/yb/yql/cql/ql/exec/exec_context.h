@@ -140,6 +140,19 @@ class TnodeContext {
 
   void SetUncoveredSelectOp(const client::YBqlReadOpPtr& select_op);
 
+  // Access functions for the key and topology version of a system table read, whose rows are
+  // cached when it completes.
+  void SetSystemTableCacheKey(std::string key, uint64_t version) {
+    system_table_cache_key_ = std::move(key);
+    system_table_cache_version_ = version;
+  }
+  const std::string& system_table_cache_key() const {
+    return system_table_cache_key_;
+  }
+  uint64_t system_table_cache_version() const {
+    return system_table_cache_version_;
+  }
+
  private:
   // Tree node of the statement being executed.
   const TreeNode* tnode_ = nullptr;
@@ -173,6 +186,10 @@ class TnodeContext {
   // Select op template and primary keys for fetching from indexed table in an uncovered query.
   client::YBqlReadOpPtr uncovered_select_op_;
   std::unique_ptr<QLRowBlock> keys_;
+
+  // Key and topology version of a system table read to cache.
+  std::string system_table_cache_key_;
+  uint64_t system_table_cache_version_ = 0;
 };
 
 // Processing could take a while, we are rescheduling it to our thread pool, if not yet
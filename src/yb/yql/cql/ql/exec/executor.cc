@@ -33,11 +33,22 @@
 
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_int32(cql_max_parallel_partition_reads, 32,
+             "Max number of partitions that a SELECT with IN conditions on the hash columns reads "
+             "in parallel. When one of them is read, the next partition is read in its place.");
+TAG_FLAG(cql_max_parallel_partition_reads, runtime);
+
+DEFINE_bool(cql_merge_batch_row_writes, true,
+            "Whether blind writes of the same row in a batch are merged into one write operation.");
+TAG_FLAG(cql_merge_batch_row_writes, advanced);
+TAG_FLAG(cql_merge_batch_row_writes, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -946,6 +957,24 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
   select_op->set_yb_consistency_level(tnode->is_system() ? YBConsistencyLevel::STRONG
                                                          : params.yb_consistency_level());
 
+  // Drivers read system.peers, system.local and system.partitions on every new connection, so
+  // serve these reads from the cache of this proxy while the topology does not change.
+  SystemTableCache* system_table_cache = ql_env_->system_table_cache();
+  if (system_table_cache != nullptr && tnode->is_system() && !continue_select &&
+      tnode_context->UnreadPartitionsRemaining() == 0 &&
+      SystemTableCache::IsCacheable(table->name())) {
+    std::string key = table->id();
+    req->AppendToString(&key);
+    const uint64_t version = system_table_cache->CurrentVersion();
+    const auto rows_data = system_table_cache->Find(key, version);
+    if (rows_data) {
+      *select_op->mutable_rows_data() = *rows_data;
+      result_ = std::make_shared<RowsResult>(select_op.get());
+      return Status::OK();
+    }
+    tnode_context->SetSystemTableCacheKey(std::move(key), version);
+  }
+
   // If we have several hash partitions (i.e. IN condition on hash columns) we initialize the
   // start partition here, and then iteratively scan the rest in FetchMoreRows.
   // Otherwise, the request will already have the right hashed column values set.
@@ -956,15 +985,26 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
     // We can optimize to run the ops in parallel (rather than serially) if:
     // - the estimated max number of rows is less than req limit (min of page size and CQL limit).
     // - there is no offset (which requires passing skipped rows from one request to the next).
+    // All rows then fit in the page, so they are returned in the order the partitions are read,
+    // and no paging state has to point into a partition. Up to cql_max_parallel_partition_reads
+    // partitions are read at once, an op that finished its partition continues with the next
+    // unread one in FetchMoreRows.
     if (*max_rows_estimate <= req->limit() && !req->has_offset()) {
+      const uint64_t max_parallel_reads = std::max(FLAGS_cql_max_parallel_partition_reads, 1);
       RETURN_NOT_OK(AddOperation(select_op, tnode_context));
-      while (tnode_context->UnreadPartitionsRemaining() > 1) {
+      uint64_t parallel_reads = 1;
+      while (tnode_context->UnreadPartitionsRemaining() > 1 &&
+             parallel_reads < max_parallel_reads) {
         YBqlReadOpPtr op(table->NewQLSelect());
         op->mutable_request()->CopyFrom(select_op->request());
         op->set_yb_consistency_level(select_op->yb_consistency_level());
         tnode_context->AdvanceToNextPartition(op->mutable_request());
         RETURN_NOT_OK(AddOperation(op, tnode_context));
         select_op = op; // Use new op as base for the next one, if any.
+        ++parallel_reads;
+      }
+      if (ql_metrics_ != nullptr) {
+        ql_metrics_->num_parallel_partition_reads_->Increment(parallel_reads);
       }
       return Status::OK();
     }
@@ -1856,6 +1896,15 @@ Result<bool> Executor::ProcessTnodeResults(TnodeContext* tnode_context) {
       continue;
     }
 
+    // Cache the rows of a system table read that fit in one response.
+    if (!tnode_context->system_table_cache_key().empty() &&
+        op->response().status() == QLResponsePB::YQL_STATUS_OK &&
+        !op->response().has_paging_state()) {
+      ql_env_->system_table_cache()->Insert(
+          tnode_context->system_table_cache_key(), tnode_context->system_table_cache_version(),
+          op->rows_data());
+    }
+
     // Append the rows if present.
     if (!op->rows_data().empty()) {
       RETURN_NOT_OK(tnode_context->AppendRowsResult(std::make_shared<RowsResult>(op.get())));
@@ -2109,6 +2158,75 @@ Status Executor::AddIndexWriteOps(const PTDmlStmt *tnode,
 
 //--------------------------------------------------------------------------------------------------
 
+namespace {
+
+bool IsMergeableWrite(const YBqlWriteOp& op) {
+  const QLWriteRequestPB& req = op.request();
+  if ((req.type() != QLWriteRequestPB::QL_STMT_INSERT &&
+       req.type() != QLWriteRequestPB::QL_STMT_UPDATE) ||
+      !op.WritesPrimaryRow() || op.WritesStaticRow() ||
+      op.ReadsPrimaryRow() || op.ReadsStaticRow() ||
+      req.has_where_expr() || req.has_user_timestamp_usec() || req.returns_status() ||
+      req.update_index_ids_size() != 0 || req.has_child_transaction_data() ||
+      req.is_backfilling()) {
+    return false;
+  }
+  // Values of a column set by different writes replace each other only if they are whole values,
+  // not collection elements, json attributes or expressions like counter increments.
+  for (const auto& column_value : req.column_values()) {
+    if (column_value.subscript_args_size() != 0 || column_value.json_args_size() != 0 ||
+        !column_value.expr().has_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes are applied at the same hybrid time in the order they are added, so the values of the
+// later write win.
+bool MergeWriteRequest(const QLWriteRequestPB& from, QLWriteRequestPB* to) {
+  if (from.schema_version() != to->schema_version() || from.has_ttl() != to->has_ttl() ||
+      from.ttl() != to->ttl()) {
+    return false;
+  }
+  for (const auto& column_value : from.column_values()) {
+    auto existing = std::find_if(
+        to->mutable_column_values()->begin(), to->mutable_column_values()->end(),
+        [&column_value](const QLColumnValuePB& value) {
+          return value.column_id() == column_value.column_id();
+        });
+    if (existing != to->mutable_column_values()->end()) {
+      *existing->mutable_expr() = column_value.expr();
+    } else {
+      *to->add_column_values() = column_value;
+    }
+  }
+  // An insert and an update of a row are equivalent to an insert of it with the values of both.
+  if (from.type() == QLWriteRequestPB::QL_STMT_INSERT) {
+    to->set_type(QLWriteRequestPB::QL_STMT_INSERT);
+  }
+  return true;
+}
+
+} // namespace
+
+bool Executor::WriteBatch::Merge(const YBqlWriteOpPtr& op, bool mergeable) {
+  if (!mergeable) {
+    // Writes of the row before and after this one cannot be merged past it.
+    mergeable_ops_.erase(op);
+    return false;
+  }
+  auto it = mergeable_ops_.find(op);
+  if (it != mergeable_ops_.end()) {
+    if (MergeWriteRequest(op->request(), (*it)->mutable_request())) {
+      return true;
+    }
+    mergeable_ops_.erase(it);
+  }
+  mergeable_ops_.insert(op);
+  return false;
+}
+
 bool Executor::WriteBatch::Add(const YBqlWriteOpPtr& op) {
   // Checks if the write operation reads the primary/static row and if another operation that writes
   // the primary/static row by the same primary/hash key already exists.
@@ -2125,6 +2243,7 @@ bool Executor::WriteBatch::Add(const YBqlWriteOpPtr& op) {
 void Executor::WriteBatch::Clear() {
   ops_by_primary_key_.clear();
   ops_by_hash_key_.clear();
+  mergeable_ops_.clear();
 }
 
 bool Executor::WriteBatch::Empty() const {
@@ -2150,6 +2269,15 @@ Status Executor::AddOperation(const YBqlReadOpPtr& op, TnodeContext *tnode_conte
 }
 
 Status Executor::AddOperation(const YBqlWriteOpPtr& op, TnodeContext *tnode_context) {
+  // Writes of the same row by the statements of a batch are merged when possible. The statement of
+  // a merged write completes without operations of its own.
+  const bool mergeable = FLAGS_cql_merge_batch_row_writes && !exec_context_->HasTransaction() &&
+                         op->table()->index_map().empty() && IsMergeableWrite(*op);
+  if (write_batch_.Merge(op, mergeable)) {
+    TRACE("Merged");
+    return Status::OK();
+  }
+
   tnode_context->AddOperation(op);
 
   // Check for inter-dependency in the current write batch before applying the write operation.
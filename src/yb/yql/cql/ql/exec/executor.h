@@ -388,6 +388,12 @@ class Executor : public QLExprExecutor {
     // until the dependent operation has been applied.
     bool Add(const client::YBqlWriteOpPtr& op);
 
+    // Merge a write operation into an earlier one of the same row that has not been flushed yet.
+    // Only blind writes of column values of a primary row, which may be applied as one operation
+    // with the same result, are mergeable. Returns true if the operation is merged, in which case
+    // it needs not be applied.
+    bool Merge(const client::YBqlWriteOpPtr& op, bool mergeable);
+
     // Clear the batch.
     void Clear();
 
@@ -402,6 +408,10 @@ class Executor : public QLExprExecutor {
     std::unordered_set<client::YBqlWriteOpPtr,
                        client::YBqlWriteOp::HashKeyComparator,
                        client::YBqlWriteOp::HashKeyComparator> ops_by_hash_key_;
+    // Mergeable write operations by their primary keys.
+    std::unordered_set<client::YBqlWriteOpPtr,
+                       client::YBqlWriteOp::PrimaryKeyComparator,
+                       client::YBqlWriteOp::PrimaryKeyComparator> mergeable_ops_;
   };
 
   //------------------------------------------------------------------------------------------------
@@ -38,7 +38,8 @@ class ParseContext : public ProcessContext {
   ParseContext(const std::string& stmt,
                bool reparsed = false,
                const MemTrackerPtr& mem_tracker = nullptr,
-               const bool internal = false);
+               const bool internal = false,
+               ArenaPool* arena_pool = nullptr);
   virtual ~ParseContext();
 
   // Read a maximum of 'max_size' bytes from SQL statement of this parsing context into the
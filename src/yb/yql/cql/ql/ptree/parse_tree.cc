@@ -25,26 +25,67 @@ namespace ql {
 
 using std::string;
 
+//--------------------------------------------------------------------------------------------------
+// Arena Pool
+//--------------------------------------------------------------------------------------------------
+
+std::unique_ptr<Arena> ArenaPool::Take() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!arenas_.empty()) {
+      auto arena = std::move(arenas_.back());
+      arenas_.pop_back();
+      return arena;
+    }
+  }
+  return std::make_unique<Arena>(HeapBufferAllocator::Get());
+}
+
+void ArenaPool::Release(std::unique_ptr<Arena> arena) {
+  arena->Reset();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (arenas_.size() < kMaxPooledArenas) {
+    arenas_.push_back(std::move(arena));
+  }
+}
+
+size_t ArenaPool::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return arenas_.size();
+}
+
 //--------------------------------------------------------------------------------------------------
 // Parse Tree
 //--------------------------------------------------------------------------------------------------
 
 ParseTree::ParseTree(const string& stmt, const bool reparsed, const MemTrackerPtr& mem_tracker,
-                     const bool internal)
+                     const bool internal, ArenaPool* arena_pool)
     : stmt_(stmt),
       reparsed_(reparsed),
       buffer_allocator_(mem_tracker ?
                         std::make_shared<MemoryTrackingBufferAllocator>(HeapBufferAllocator::Get(),
                                                                         mem_tracker) :
                         nullptr),
-      ptree_mem_(buffer_allocator_ ? buffer_allocator_.get() : HeapBufferAllocator::Get()),
-      psem_mem_(buffer_allocator_ ? buffer_allocator_.get() : HeapBufferAllocator::Get()),
+      arena_pool_(mem_tracker ? nullptr : arena_pool),
       internal_(internal) {
+  if (arena_pool_) {
+    ptree_mem_ = arena_pool_->Take();
+    psem_mem_ = arena_pool_->Take();
+  } else {
+    BufferAllocator* allocator =
+        buffer_allocator_ ? buffer_allocator_.get() : HeapBufferAllocator::Get();
+    ptree_mem_ = std::make_unique<Arena>(allocator);
+    psem_mem_ = std::make_unique<Arena>(allocator);
+  }
 }
 
 ParseTree::~ParseTree() {
   // Make sure we delete the tree first before deleting the memory pools.
   root_ = nullptr;
+  if (arena_pool_) {
+    arena_pool_->Release(std::move(ptree_mem_));
+    arena_pool_->Release(std::move(psem_mem_));
+  }
 }
 
 CHECKED_STATUS ParseTree::Analyze(SemContext *sem_context) {
@@ -21,6 +21,9 @@
 #ifndef YB_YQL_CQL_QL_PTREE_PARSE_TREE_H_
 #define YB_YQL_CQL_QL_PTREE_PARSE_TREE_H_
 
+#include <mutex>
+#include <vector>
+
 #include "yb/client/yb_table_name.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/yql/cql/ql/ptree/tree_node.h"
@@ -29,6 +32,33 @@
 namespace yb {
 namespace ql {
 
+// Pool of arenas to reuse the memory of parse trees across statements that are parsed, analyzed
+// and executed once. An arena is reset when it is released, which keeps its last buffer, so
+// repeated short statements settle on a single buffer per arena and stop allocating. The parse
+// trees allocated from the pool must be destroyed before the pool.
+class ArenaPool {
+ public:
+  ArenaPool() {}
+
+  // Takes an arena from the pool, or creates a new one when the pool is empty.
+  std::unique_ptr<Arena> Take();
+
+  // Resets the arena and returns it to the pool.
+  void Release(std::unique_ptr<Arena> arena);
+
+  size_t size() const;
+
+ private:
+  // Max number of arenas kept in the pool. A statement takes two, a parse tree arena and a
+  // semantic analysis arena.
+  static constexpr size_t kMaxPooledArenas = 4;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Arena>> arenas_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArenaPool);
+};
+
 // Parse Tree
 class ParseTree {
  public:
@@ -40,9 +70,11 @@ class ParseTree {
   //------------------------------------------------------------------------------------------------
   // Public functions.
 
-  // Constructs a parse tree. The parse tree saves a reference to the statement string.
+  // Constructs a parse tree. The parse tree saves a reference to the statement string. When
+  // arena_pool is given and mem_tracker is not, the memory pools of the parse tree are taken from
+  // arena_pool and returned to it when the parse tree is destructed.
   ParseTree(const std::string& stmt, bool reparsed, const MemTrackerPtr& mem_tracker = nullptr,
-            const bool internal = false);
+            const bool internal = false, ArenaPool* arena_pool = nullptr);
   ~ParseTree();
 
   // Run semantics analysis.
@@ -71,12 +103,12 @@ class ParseTree {
 
   // Access function to ptree_mem_.
   MemoryContext *PTreeMem() const {
-    return &ptree_mem_;
+    return ptree_mem_.get();
   }
 
   // Access function to psem_mem_.
   MemoryContext *PSemMem() const {
-    return &psem_mem_;
+    return psem_mem_.get();
   }
 
   // Access function to stale_.
@@ -113,6 +145,9 @@ class ParseTree {
 
   std::shared_ptr<BufferAllocator> buffer_allocator_;
 
+  // Pool the memory pools below came from, if any.
+  ArenaPool* const arena_pool_;
+
   // Set of tables used during semantic analysis.
   std::unordered_set<client::YBTableName, boost::hash<client::YBTableName>> analyzed_tables_;
 
@@ -123,14 +158,14 @@ class ParseTree {
   // Parse tree memory pool. This pool is used to allocate parse tree and its nodes. This pool
   // should be part of the generated parse tree that is stored within parse_context. Once the
   // parse tree is destructed, it's also gone.
-  mutable Arena ptree_mem_;
+  std::unique_ptr<Arena> ptree_mem_;
 
   // Semantic analysis memory pool. This pool is used to allocate memory for storing semantic
   // analysis results in the parse tree. When a parse tree is analyzed, the parse tree is reset to
   // release the previous analysis result and this pool should be reset to free the associated
   // memory. This pool should be part of the generated parse tree also that is stored within
   // sem_context. Once the parse tree is destructed, it's also gone too.
-  mutable Arena psem_mem_;
+  std::unique_ptr<Arena> psem_mem_;
 
   // Root node of the parse tree.
   TreeNode::SharedPtr root_;
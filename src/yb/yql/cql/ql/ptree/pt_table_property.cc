@@ -480,7 +480,22 @@ Status PTTablePropertyMap::SetTableProperty(yb::TableProperties *table_property)
     return STATUS(InvalidArgument, Substitute("$0 is not a valid table property", lhs_->c_str()));
   }
   switch (iterator->second) {
-    case PropertyMapType::kCaching: FALLTHROUGH_INTENDED;
+    case PropertyMapType::kCaching:
+      for (const auto& subproperty : map_elements_->node_list()) {
+        string subproperty_name;
+        ToLowerCase(subproperty->lhs()->c_str(), &subproperty_name);
+        if (subproperty_name != common::kCachingRowsPerPartition) {
+          continue;
+        }
+        // Caching all the rows of the partitions keeps an in-memory image of the rows of the table
+        // in its tablets, any other value does not cache the rows.
+        string str_val, upper_str_val;
+        if (GetStringValueFromExpr(subproperty->rhs(), true, subproperty_name, &str_val).ok()) {
+          ToUpperCase(str_val, &upper_str_val);
+        }
+        table_property->SetInMemoryImage(upper_str_val == common::kCachingAll);
+      }
+      break;
     case PropertyMapType::kCompaction: FALLTHROUGH_INTENDED;
     case PropertyMapType::kCompression:
       LOG(WARNING) << "Ignoring table property " << table_property_name;
@@ -49,6 +49,10 @@ METRIC_DEFINE_histogram_with_percentiles(
     server, handler_latency_yb_cqlserver_SQLProcessor_NumFlushesToExecute,
     "Number of flushes to successfully execute a SQL query", yb::MetricUnit::kOperations,
     "Number of flushes to successfully execute a SQL query", 60000000LU, 2);
+METRIC_DEFINE_histogram_with_percentiles(
+    server, handler_latency_yb_cqlserver_SQLProcessor_NumParallelPartitionReads,
+    "Number of partitions a multi-partition SELECT reads in parallel", yb::MetricUnit::kOperations,
+    "Number of partitions a multi-partition SELECT reads in parallel", 60000000LU, 2);
 METRIC_DEFINE_histogram_with_percentiles(
     server, handler_latency_yb_cqlserver_SQLProcessor_SelectStmt,
     "Time spent processing a SELECT statement", yb::MetricUnit::kMicroseconds,
@@ -104,6 +108,9 @@ QLMetrics::QLMetrics(const scoped_refptr<yb::MetricEntity> &metric_entity) {
   num_flushes_to_execute_ql_ =
       METRIC_handler_latency_yb_cqlserver_SQLProcessor_NumFlushesToExecute.Instantiate(
           metric_entity);
+  num_parallel_partition_reads_ =
+      METRIC_handler_latency_yb_cqlserver_SQLProcessor_NumParallelPartitionReads.Instantiate(
+          metric_entity);
 
   ql_select_ =
       METRIC_handler_latency_yb_cqlserver_SQLProcessor_SelectStmt.Instantiate(metric_entity);
@@ -137,10 +144,11 @@ QLProcessor::~QLProcessor() {
 
 Status QLProcessor::Parse(const string& stmt, ParseTree::UniPtr* parse_tree,
                           const bool reparsed, const MemTrackerPtr& mem_tracker,
-                          const bool internal) {
+                          const bool internal, const bool use_arena_pool) {
   // Parse the statement and get the generated parse tree.
   const MonoTime begin_time = MonoTime::Now();
-  RETURN_NOT_OK(parser_.Parse(stmt, reparsed, mem_tracker, internal));
+  RETURN_NOT_OK(parser_.Parse(stmt, reparsed, mem_tracker, internal,
+                              use_arena_pool ? &arena_pool_ : nullptr));
   const MonoTime end_time = MonoTime::Now();
   if (ql_metrics_ != nullptr) {
     const MonoDelta elapsed_time = end_time.GetDeltaSince(begin_time);
@@ -168,12 +176,13 @@ Status QLProcessor::Analyze(ParseTree::UniPtr* parse_tree) {
 
 Status QLProcessor::Prepare(const string& stmt, ParseTree::UniPtr* parse_tree,
                             const bool reparsed, const MemTrackerPtr& mem_tracker,
-                            const bool internal) {
-  RETURN_NOT_OK(Parse(stmt, parse_tree, reparsed, mem_tracker, internal));
+                            const bool internal, const bool use_arena_pool) {
+  RETURN_NOT_OK(Parse(stmt, parse_tree, reparsed, mem_tracker, internal, use_arena_pool));
   const Status s = Analyze(parse_tree);
   if (s.IsQLError() && GetErrorCode(s) == ErrorCode::STALE_METADATA && !reparsed) {
     *parse_tree = nullptr;
-    RETURN_NOT_OK(Parse(stmt, parse_tree, true /* reparsed */, mem_tracker));
+    RETURN_NOT_OK(Parse(stmt, parse_tree, true /* reparsed */, mem_tracker, internal,
+                        use_arena_pool));
     return Analyze(parse_tree);
   }
   return s;
@@ -393,7 +402,8 @@ void QLProcessor::ExecuteAsync(const StatementBatch& batch, StatementExecutedCal
 void QLProcessor::RunAsync(const string& stmt, const StatementParameters& params,
                            StatementExecutedCallback cb, const bool reparsed) {
   ParseTree::UniPtr parse_tree;
-  const Status s = Prepare(stmt, &parse_tree, reparsed);
+  const Status s = Prepare(stmt, &parse_tree, reparsed, nullptr /* mem_tracker */,
+                           false /* internal */, true /* use_arena_pool */);
   if (PREDICT_FALSE(!s.ok())) {
     return cb.Run(s, nullptr /* result */);
   }
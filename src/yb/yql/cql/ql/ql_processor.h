@@ -41,6 +41,7 @@ class QLMetrics {
   scoped_refptr<yb::Histogram> num_rounds_to_analyze_ql_;
   scoped_refptr<yb::Histogram> num_retries_to_execute_ql_;
   scoped_refptr<yb::Histogram> num_flushes_to_execute_ql_;
+  scoped_refptr<yb::Histogram> num_parallel_partition_reads_;
 
   scoped_refptr<yb::Histogram> ql_select_;
   scoped_refptr<yb::Histogram> ql_insert_;
@@ -67,10 +68,11 @@ class QLProcessor : public Rescheduler {
   virtual ~QLProcessor();
 
   // Prepare a SQL statement (parse and analyze). A reference to the statement string is saved in
-  // the parse tree.
+  // the parse tree. An untracked parse tree allocates from reusable arenas of this processor when
+  // use_arena_pool is set, and must then be destroyed before the processor.
   CHECKED_STATUS Prepare(const std::string& stmt, ParseTree::UniPtr* parse_tree,
                          bool reparsed = false, const MemTrackerPtr& mem_tracker = nullptr,
-                         const bool internal = false);
+                         const bool internal = false, bool use_arena_pool = false);
 
   // Check whether the current user has the required permissions to execute the statment.
   bool CheckPermissions(const ParseTree& parse_tree, StatementExecutedCallback cb);
@@ -101,6 +103,10 @@ class QLProcessor : public Rescheduler {
   // Environment (YBClient) that processor uses to execute statement.
   QLEnv ql_env_;
 
+  // Arenas reused by the parse trees of the statements run by this processor. Declared before the
+  // processors below, which may hold a parse tree.
+  ArenaPool arena_pool_;
+
   // Parsing processor.
   Parser parser_;
 
@@ -120,7 +126,7 @@ class QLProcessor : public Rescheduler {
   // Parse a SQL statement and generate a parse tree.
   CHECKED_STATUS Parse(const std::string& stmt, ParseTree::UniPtr* parse_tree,
                        bool reparsed = false, const MemTrackerPtr& mem_tracker = nullptr,
-                       const bool internal = false);
+                       const bool internal = false, bool use_arena_pool = false);
 
   // Semantically analyze a parse tree.
   CHECKED_STATUS Analyze(ParseTree::UniPtr* parse_tree);
@@ -323,5 +323,47 @@ TEST_F(QLTestParser, TestExplain) {
   PARSE_INVALID_STMT("EXPLAIN ANALYZE SELECT * FROM t WHERE C1=:c1;");
 }
 
+TEST_F(QLTestParser, TestArenaPool) {
+  const string stmt = "SELECT * FROM t WHERE h1 = 1 AND h2 = 'a' AND r1 > 2 LIMIT 10;";
+  constexpr int kNumIterations = 10000;
+  Parser parser;
+  ArenaPool arena_pool;
+
+  // Memory pools of a parse tree are returned to the pool and reused by the next one.
+  ASSERT_OK(parser.Parse(stmt, false /* reparsed */, nullptr /* mem_tracker */,
+                         false /* internal */, &arena_pool));
+  ParseTree::UniPtr parse_tree = parser.Done();
+  const MemoryContext* ptree_mem = parse_tree->PTreeMem();
+  const MemoryContext* psem_mem = parse_tree->PSemMem();
+  parse_tree = nullptr;
+  ASSERT_EQ(arena_pool.size(), 2);
+  ASSERT_OK(parser.Parse(stmt, false /* reparsed */, nullptr /* mem_tracker */,
+                         false /* internal */, &arena_pool));
+  parse_tree = parser.Done();
+  ASSERT_EQ(arena_pool.size(), 0);
+  ASSERT_TRUE(parse_tree->PTreeMem() == ptree_mem || parse_tree->PTreeMem() == psem_mem);
+  parse_tree = nullptr;
+
+  // Tracked parse trees do not use the pool.
+  ASSERT_OK(parser.Parse(stmt, false /* reparsed */, MemTracker::GetRootTracker(),
+                         false /* internal */, &arena_pool));
+  parse_tree = parser.Done();
+  ASSERT_EQ(arena_pool.size(), 2);
+  parse_tree = nullptr;
+  ASSERT_EQ(arena_pool.size(), 2);
+
+  for (ArenaPool* pool : {static_cast<ArenaPool*>(nullptr), &arena_pool}) {
+    const MonoTime start = MonoTime::Now();
+    for (int i = 0; i < kNumIterations; i++) {
+      ASSERT_OK(parser.Parse(stmt, false /* reparsed */, nullptr /* mem_tracker */,
+                             false /* internal */, pool));
+      parser.Done();
+    }
+    LOG(INFO) << "Parsed " << kNumIterations << " statements " << (pool ? "with" : "without")
+              << " arena pool in " << MonoTime::Now().GetDeltaSince(start).ToMilliseconds()
+              << " ms";
+  }
+}
+
 }  // namespace ql
 }  // namespace yb
@@ -13,6 +13,7 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <atomic>
 #include <thread>
 #include <cmath>
 
@@ -1582,6 +1583,49 @@ TEST_F(TestQLQuery, TestInvalidPeerTableEntries) {
   }
 }
 
+TEST_F(TestQLQuery, TestSystemTableCache) {
+  // Init the simulated cluster and wait for tservers.
+  int num_tservers = 3;
+  ASSERT_NO_FATALS(CreateSimulatedCluster(num_tservers));
+  ASSERT_OK(cluster_->WaitForTabletServerCount(num_tservers));
+
+  std::atomic<uint64_t> topology_version{1};
+  auto cache = std::make_shared<SystemTableCache>([&topology_version] {
+    return topology_version.load();
+  });
+  TestQLProcessor* processor = GetQLProcessor();
+  processor->SetSystemTableCache(cache);
+
+  ASSERT_OK(processor->Run("SELECT * FROM system.peers"));
+  ASSERT_EQ(num_tservers - 1, processor->row_block()->row_count());
+  ASSERT_OK(processor->Run("SELECT * FROM system.local"));
+  ASSERT_EQ(1, processor->row_block()->row_count());
+  ASSERT_EQ(2, cache->size());
+
+  // Register a new tserver. Peers are served from the cache until the topology version changes.
+  NodeInstancePB instance;
+  instance.set_permanent_uuid("test");
+  instance.set_instance_seqno(0);
+  master::TSRegistrationPB registration;
+  auto hostport_pb = registration.mutable_common()->add_private_rpc_addresses();
+  hostport_pb->set_host("127.0.0.100");
+  hostport_pb->set_port(123);
+  auto ts_manager = cluster_->leader_mini_master()->master()->ts_manager();
+  ASSERT_OK(ts_manager->RegisterTS(instance, registration, CloudInfoPB(), nullptr));
+
+  ASSERT_OK(processor->Run("SELECT * FROM system.peers"));
+  ASSERT_EQ(num_tservers - 1, processor->row_block()->row_count());
+
+  ++topology_version;
+  ASSERT_OK(processor->Run("SELECT * FROM system.peers"));
+  ASSERT_EQ(num_tservers, processor->row_block()->row_count());
+  ASSERT_EQ(1, cache->size());
+
+  // Reads of other system tables are not cached.
+  ASSERT_OK(processor->Run("SELECT * FROM system_schema.keyspaces"));
+  ASSERT_EQ(1, cache->size());
+}
+
 TEST_F(TestQLQuery, TestPagination) {
   // Init the simulated cluster.
   ASSERT_NO_FATALS(CreateSimulatedCluster());
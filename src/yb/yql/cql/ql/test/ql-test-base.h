@@ -163,6 +163,10 @@ class TestQLProcessor : public ClockHolder, public QLProcessor {
     return ql_env_.UseKeyspace(keyspace_name);
   }
 
+  void SetSystemTableCache(std::shared_ptr<SystemTableCache> system_table_cache) {
+    ql_env_.set_system_table_cache(std::move(system_table_cache));
+  }
+
   void RemoveCachedTableDesc(const client::YBTableName& table_name) {
     ql_env_.RemoveCachedTableDesc(table_name);
   }
@@ -32,6 +32,7 @@
 #include "yb/util/enums.h"
 #include "yb/yql/cql/ql/ptree/pt_option.h"
 #include "yb/yql/cql/ql/ql_session.h"
+#include "yb/yql/cql/ql/util/system_table_cache.h"
 
 namespace yb {
 namespace ql {
@@ -196,6 +197,14 @@ class QLEnv {
   void set_ql_session(const QLSession::SharedPtr& ql_session) {
     ql_session_ = ql_session;
   }
+  // Cache of system table reads shared by the processors of a CQL proxy, if any.
+  void set_system_table_cache(std::shared_ptr<SystemTableCache> system_table_cache) {
+    system_table_cache_ = std::move(system_table_cache);
+  }
+  SystemTableCache* system_table_cache() const {
+    return system_table_cache_.get();
+  }
+
   const QLSession::SharedPtr& ql_session() const {
     if (!ql_session_) {
       ql_session_.reset(new QLSession());
@@ -221,6 +230,8 @@ class QLEnv {
   TransactionPoolProvider transaction_pool_provider_;
   client::TransactionPool* transaction_pool_ = nullptr;
 
+  std::shared_ptr<SystemTableCache> system_table_cache_;
+
   //------------------------------------------------------------------------------------------------
   // Transient attributes.
   // The following attributes are reset implicitly for every execution.
@@ -191,7 +191,8 @@ Status RowsResult::Append(RowsResult&& other) {
   if (rows_data_.empty()) {
     rows_data_ = std::move(other.rows_data_);
   } else {
-    RETURN_NOT_OK(QLRowBlock::AppendRowsData(other.client_, other.rows_data_, &rows_data_));
+    RETURN_NOT_OK(QLRowBlock::AppendRowsData(
+        other.client_, std::move(other.rows_data_), &rows_data_));
   }
   paging_state_ = std::move(other.paging_state_);
   return Status::OK();
@@ -0,0 +1,108 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/cql/ql/util/system_table_cache.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/master/master_defaults.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(ycql_cache_system_tables, true,
+            "Whether a CQL proxy caches the rows it reads from system.peers, system.local and "
+            "system.partitions until the cluster topology changes.");
+TAG_FLAG(ycql_cache_system_tables, advanced);
+TAG_FLAG(ycql_cache_system_tables, runtime);
+
+DEFINE_int32(ycql_system_table_cache_max_entries, 128,
+             "Maximum number of distinct reads of system tables whose rows a CQL proxy caches. "
+             "All entries are dropped when the limit is reached.");
+TAG_FLAG(ycql_system_table_cache_max_entries, advanced);
+TAG_FLAG(ycql_system_table_cache_max_entries, runtime);
+
+namespace yb {
+namespace ql {
+
+SystemTableCache::SystemTableCache(VersionProvider version_provider)
+    : version_provider_(std::move(version_provider)) {
+}
+
+SystemTableCache::~SystemTableCache() {
+}
+
+bool SystemTableCache::IsCacheable(const client::YBTableName& table_name) {
+  if (!FLAGS_ycql_cache_system_tables ||
+      table_name.namespace_name() != master::kSystemNamespaceName) {
+    return false;
+  }
+  const auto& name = table_name.table_name();
+  return name == master::kSystemPeersTableName || name == master::kSystemLocalTableName ||
+         name == master::kSystemPartitionsTableName;
+}
+
+uint64_t SystemTableCache::CurrentVersion() const {
+  return version_provider_();
+}
+
+SystemTableCache::RowsDataPtr SystemTableCache::Find(
+    const std::string& request_key, uint64_t version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!UpdateVersionUnlocked(version)) {
+    return nullptr;
+  }
+  auto it = entries_.find(request_key);
+  return it != entries_.end() ? it->second : nullptr;
+}
+
+void SystemTableCache::Insert(
+    const std::string& request_key, uint64_t version, std::string rows_data) {
+  // The topology could have changed while the rows were read.
+  if (version != CurrentVersion()) {
+    return;
+  }
+  const auto max_entries =
+      static_cast<size_t>(std::max(FLAGS_ycql_system_table_cache_max_entries, 0));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!UpdateVersionUnlocked(version) || max_entries == 0) {
+    return;
+  }
+  if (entries_.size() >= max_entries) {
+    entries_.clear();
+  }
+  entries_[request_key] = std::make_shared<const std::string>(std::move(rows_data));
+}
+
+size_t SystemTableCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+bool SystemTableCache::UpdateVersionUnlocked(uint64_t version) {
+  if (version < version_) {
+    return false;
+  }
+  if (version > version_) {
+    VLOG(1) << "Topology version changed from " << version_ << " to " << version
+            << ", dropping " << entries_.size() << " cached system table reads";
+    entries_.clear();
+    version_ = version;
+  }
+  return true;
+}
+
+}  // namespace ql
+}  // namespace yb
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_YQL_CQL_QL_UTIL_SYSTEM_TABLE_CACHE_H_
+#define YB_YQL_CQL_QL_UTIL_SYSTEM_TABLE_CACHE_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "yb/client/yb_table_name.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+namespace yb {
+namespace ql {
+
+// Cache of the rows read by a CQL proxy from the system.peers, system.local and system.partitions
+// tables.
+//
+// Drivers read these tables on every new connection and on topology events, and every read is
+// served by the master leader, so a storm of reconnects after a restart of the clients floods the
+// master with them. The rows are the same for all clients of a proxy, so they are cached here,
+// keyed by the read request, and tagged with the topology version the proxy had when the read was
+// sent. The topology version is bumped when the proxy learns from a heartbeat response that the
+// master leader, the live tservers, or the tablets and their replicas changed, and entries of
+// older versions are not used again.
+class SystemTableCache {
+ public:
+  typedef std::function<uint64_t()> VersionProvider;
+  typedef std::shared_ptr<const std::string> RowsDataPtr;
+
+  explicit SystemTableCache(VersionProvider version_provider);
+  ~SystemTableCache();
+
+  // Returns whether reads of the table could be served from the cache.
+  static bool IsCacheable(const client::YBTableName& table_name);
+
+  // Returns the current topology version.
+  uint64_t CurrentVersion() const;
+
+  // Returns the rows cached for the request at the version, or nullptr if there are none.
+  RowsDataPtr Find(const std::string& request_key, uint64_t version);
+
+  // Caches the rows read by the request, that was sent at the version. The rows are not cached
+  // when the topology changed since then.
+  void Insert(const std::string& request_key, uint64_t version, std::string rows_data);
+
+  size_t size() const;
+
+ private:
+  // Drops all entries if the version is different from the version they were cached at. Returns
+  // false if the version is not the current one anymore.
+  bool UpdateVersionUnlocked(uint64_t version) REQUIRES(mutex_);
+
+  const VersionProvider version_provider_;
+
+  mutable std::mutex mutex_;
+  uint64_t version_ GUARDED_BY(mutex_) = 0;
+  std::unordered_map<std::string, RowsDataPtr> entries_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(SystemTableCache);
+};
+
+}  // namespace ql
+}  // namespace yb
+
+#endif  // YB_YQL_CQL_QL_UTIL_SYSTEM_TABLE_CACHE_H_
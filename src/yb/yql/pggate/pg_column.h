@@ -34,6 +34,15 @@ class PgColumn {
   // Initialize hidden columns.
   void Init(PgSystemAttrNum attr_num);
 
+  // Forget the binds and requests of the statement that used this column.
+  void ResetBindings() {
+    bind_pb_ = nullptr;
+    bind_condition_expr_pb_ = nullptr;
+    assign_pb_ = nullptr;
+    read_requested_ = false;
+    write_requested_ = false;
+  }
+
   // Bindings for write requests.
   PgsqlExpressionPB *AllocPrimaryBindPB(PgsqlWriteRequestPB *write_req);
   PgsqlExpressionPB *AllocBindPB(PgsqlWriteRequestPB *write_req);
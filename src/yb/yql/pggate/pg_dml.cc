@@ -58,6 +58,10 @@ PgDml::PgDml(PgSession::ScopedRefPtr pg_session,
 }
 
 PgDml::~PgDml() {
+  // Drop the references the doc op holds, so the table descriptor could be reused.
+  doc_op_.reset();
+  bind_desc_ = nullptr;
+  pg_session_->ReleaseTableDesc(&target_desc_);
 }
 
 Status PgDml::ClearBinds() {
@@ -425,10 +429,7 @@ Result<string> PgDml::BuildYBTupleId(const PgAttrValueDescriptor *attrs, int32_t
           if (hashed_values.empty()) {
             return docdb::DocKey(move(range_components)).Encode().data();
           }
-          string partition_key;
-          const PartitionSchema& partition_schema = target_desc_->table()->partition_schema();
-          RETURN_NOT_OK(partition_schema.EncodeKey(hashed_values, &partition_key));
-          const uint16_t hash = PartitionSchema::DecodeMultiColumnHashValue(partition_key);
+          const uint16_t hash = PartitionSchema::HashColumnValues(hashed_values);
 
           return docdb::DocKey(hash,
               move(hashed_components),
@@ -36,12 +36,13 @@ using std::move;
 namespace yb {
 namespace pggate {
 
-PgDocResult::PgDocResult(string&& data) : data_(move(data)) {
+PgDocResult::PgDocResult(string&& data, ColumnarRowsData columnar)
+    : data_(move(data)), columnar_(columnar) {
   PgDocData::LoadCache(data_, &row_count_, &row_iterator_);
 }
 
 PgDocResult::PgDocResult(string&& data, std::list<int64_t>&& row_orders)
-    : data_(move(data)), row_orders_(move(row_orders)) {
+    : data_(move(data)), row_orders_(move(row_orders)), columnar_(ColumnarRowsData::kFalse) {
   PgDocData::LoadCache(data_, &row_count_, &row_iterator_);
 }
 
@@ -54,6 +55,11 @@ int64_t PgDocResult::NextRowOrder() {
 
 Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *pg_tuple,
                                  int64_t *row_order) {
+  if (columnar_) {
+    *row_order = -1;
+    return WriteColumnarPgTuple(targets, pg_tuple);
+  }
+
   int attr_num = 0;
   for (const PgExpr *target : targets) {
     if (!target->is_colref() && !target->is_aggregate()) {
@@ -79,11 +85,41 @@ Status PgDocResult::WritePgTuple(const std::vector<PgExpr*>& targets, PgTuple *p
   return Status::OK();
 }
 
+Status PgDocResult::WriteColumnarPgTuple(const std::vector<PgExpr*>& targets,
+                                         PgTuple *pg_tuple) {
+  if (chunk_rows_left_ == 0) {
+    RETURN_NOT_OK(PgDocData::ReadColumnarChunk(
+        &row_iterator_, targets.size(), &chunk_rows_left_, &null_bitmaps_, &column_values_));
+    SCHECK_GT(chunk_rows_left_, 0, Corruption, "Empty chunk of columnar rows data");
+    chunk_row_idx_ = 0;
+  }
+
+  int attr_num = 0;
+  for (size_t i = 0; i != targets.size(); ++i) {
+    const PgExpr *target = targets[i];
+    if (!target->is_colref()) {
+      return STATUS(InternalError, "Unexpected expression, only column refs supported here");
+    }
+    attr_num = static_cast<const PgColumnRef *>(target)->attr_num();
+
+    PgWireDataHeader header;
+    if (IsNullInBitmap(null_bitmaps_[i], chunk_row_idx_)) {
+      header.set_null();
+    }
+    target->TranslateData(&column_values_[i], header, attr_num - 1, pg_tuple);
+  }
+
+  ++chunk_row_idx_;
+  --chunk_rows_left_;
+  return Status::OK();
+}
+
 Status PgDocResult::ProcessSystemColumns() {
   if (syscol_processed_) {
     return Status::OK();
   }
   syscol_processed_ = true;
+  SCHECK(!columnar_, InternalError, "System columns are not sent as columnar rows data");
 
   for (int i = 0; i < row_count_; i++) {
     PgWireDataHeader header = PgDocData::ReadDataHeader(&row_iterator_);
@@ -196,7 +232,11 @@ void PgDocReadOp::Initialize(const PgExecParameters *exec_params) {
   PgDocOp::Initialize(exec_params);
 
   can_produce_more_ops_ = true;
+  parallel_scan_ = false;
   template_op_->mutable_request()->set_return_paging_state(true);
+  if (FLAGS_ysql_request_columnar_rows_data) {
+    template_op_->mutable_request()->set_columnar_rows_data(true);
+  }
   SetRequestPrefetchLimit();
   SetRowMark();
 }
@@ -375,7 +415,7 @@ void PgDocReadOp::InitializeNextOps(int num_ops) {
   DCHECK(!read_ops_.empty()) << "read_ops_ should not be empty after setting!";
 }
 
-void PgDocReadOp::InitializeParallelSelectCountOps(int select_parallelism) {
+void PgDocReadOp::InitializeParallelScanOps(int select_parallelism) {
   const auto& partition_keys = table_desc_->table()->GetPartitions();
   for (auto it = partition_keys.cbegin(); it != partition_keys.cend(); ++it) {
     // Construct a new YBPgsqlReadOp.
@@ -403,34 +443,66 @@ void PgDocReadOp::InitializeParallelSelectCountOps(int select_parallelism) {
     }
   }
 
+  if (!template_op_->request().is_aggregate()) {
+    // Split the prefetch limit between the operations, so reading the tablets in parallel does
+    // not buffer more rows than reading them one by one.
+    const int64_t limit = std::max<int64_t>(
+        template_op_->request().limit() / static_cast<int64_t>(read_ops_.size()), 1);
+    for (auto& read_op : read_ops_) {
+      read_op->mutable_request()->set_limit(limit);
+    }
+  }
+
+  parallel_scan_ = true;
   can_produce_more_ops_ = false;
 }
 
+bool PgDocReadOp::IsParallelScanAllowed() const {
+  const auto& request = template_op_->request();
+  // A statement with LIMIT usually does not need rows from all tablets, and range partitioned
+  // tables are expected to return rows in the order of their keys, so those are read one tablet
+  // after another.
+  return FLAGS_ysql_enable_parallel_scan && can_produce_more_ops_ && num_hash_key_columns_ > 0 &&
+         exec_params_.limit_use_default && request.partition_column_values_size() == 0 &&
+         !request.has_ybctid_column_value() && !request.has_paging_state() &&
+         table_desc_->table()->GetPartitions().size() > 1;
+}
+
+Result<int> PgDocReadOp::SelectParallelism() {
+  // Snapshot of flag to avoid handling change of flag value in long running reads.
+  int select_parallelism = FLAGS_ysql_select_parallelism;
+  if (select_parallelism < 0) {
+    // Auto.
+
+    int tserver_count = 0;
+    RETURN_NOT_OK(pg_session_->TabletServerCount(&tserver_count, true /* primary_only */,
+          true /* use_cache */));
+
+    // Establish lower and upper bounds on parallelism.
+    int kMinParSelCountParallelism = 1;
+    int kMaxParSelCountParallelism = 16;
+    select_parallelism = std::min(std::max(tserver_count * 2,
+          kMinParSelCountParallelism), kMaxParSelCountParallelism);
+  }
+  return select_parallelism;
+}
+
 Status PgDocReadOp::SendRequestImpl(bool force_non_bufferable) {
   DCHECK(!read_ops_.empty() || can_produce_more_ops_);
 
-  if (template_op_->request().is_aggregate() && read_ops_.size() == 0) {
-    // Snapshot of flag to avoid handling change of flag value in long running reads.
-    int select_parallelism = FLAGS_ysql_select_parallelism;
-    if (select_parallelism < 0) {
-      // Auto.
-
-      int tserver_count = 0;
-      RETURN_NOT_OK(pg_session_->TabletServerCount(&tserver_count, true /* primary_only */,
-            true /* use_cache */));
-
-      // Establish lower and upper bounds on parallelism.
-      int kMinParSelCountParallelism = 1;
-      int kMaxParSelCountParallelism = 16;
-      select_parallelism = std::min(std::max(tserver_count * 2,
-            kMinParSelCountParallelism), kMaxParSelCountParallelism);
-    }
-
-    InitializeParallelSelectCountOps(select_parallelism);
+  if (read_ops_.empty() &&
+      (template_op_->request().is_aggregate() || IsParallelScanAllowed())) {
+    InitializeParallelScanOps(VERIFY_RESULT(SelectParallelism()));
   } else if (can_produce_more_ops_) {
     InitializeNextOps(FLAGS_ysql_request_limit - read_ops_.size());
   }
 
+  if (pg_session_->storage_metrics_enabled()) {
+    for (const auto& read_op : read_ops_) {
+      read_op->mutable_request()->set_include_storage_metrics(true);
+    }
+  }
+
   response_ =
       VERIFY_RESULT(pg_session_->RunAsync(read_ops_, PgObjectId(), &read_time_,
                                           force_non_bufferable || wait_for_batch_completion_));
@@ -441,12 +513,16 @@ Status PgDocReadOp::SendRequestImpl(bool force_non_bufferable) {
 Status PgDocReadOp::ProcessResponseImpl(const Status& exec_status) {
   for (const auto& read_op : read_ops_) {
     RETURN_NOT_OK(pg_session_->HandleResponse(*read_op, PgObjectId()));
+    if (read_op->response().has_storage_metrics()) {
+      pg_session_->AddStorageMetrics(read_op->response().storage_metrics());
+    }
   }
 
   if (batch_row_orders_.size() == 0) {
     for (auto& read_op : read_ops_) {
       DCHECK(!read_op->rows_data().empty()) << "Read operation should not return empty data";
-      result_cache_.push_back(make_shared<PgDocResult>(read_op->rows_data()));
+      result_cache_.push_back(make_shared<PgDocResult>(
+          read_op->rows_data(), ColumnarRowsData(read_op->response().columnar_rows_data())));
     }
   } else {
     for (int partition = 0; partition < batch_ops_.size(); partition++) {
@@ -483,7 +559,7 @@ Status PgDocReadOp::ProcessResponseImpl(const Status& exec_status) {
 
       // Keep this read-op and resend for the next paging state.
       return false;
-    } else if (template_op_->request().is_aggregate()) {
+    } else if (parallel_scan_) {
       // Mutate into new query for next unqueried tablet.
 
       const auto& partition_keys = table_desc_->table()->GetPartitions();
@@ -18,6 +18,7 @@
 #include <deque>
 
 #include "yb/util/locks.h"
+#include "yb/util/strongly_typed_bool.h"
 #include "yb/client/yb_op.h"
 #include "yb/yql/pggate/pg_session.h"
 
@@ -28,13 +29,15 @@ YB_STRONGLY_TYPED_BOOL(RequestSent);
 
 //--------------------------------------------------------------------------------------------------
 // PgDocResult represents a batch of rows in ONE reply from tablet servers.
+YB_STRONGLY_TYPED_BOOL(ColumnarRowsData);
+
 class PgDocResult {
  public:
   // Public types.
   typedef std::shared_ptr<PgDocResult> SharedPtr;
   typedef std::shared_ptr<const PgDocResult> SharedPtrConst;
 
-  explicit PgDocResult(string&& data);
+  explicit PgDocResult(string&& data, ColumnarRowsData columnar = ColumnarRowsData::kFalse);
   PgDocResult(string&& data, std::list<int64_t>&& row_orders);
   ~PgDocResult();
 
@@ -43,7 +46,7 @@ class PgDocResult {
 
   // End of this batch.
   bool is_eof() const {
-    return row_count_ == 0 || row_iterator_.empty();
+    return row_count_ == 0 || (row_iterator_.empty() && chunk_rows_left_ == 0);
   }
 
   // Get the postgres tuple from this batch.
@@ -67,6 +70,9 @@ class PgDocResult {
   }
 
  private:
+  // Reads the next row of columnar rows data.
+  CHECKED_STATUS WriteColumnarPgTuple(const std::vector<PgExpr*>& targets, PgTuple *pg_tuple);
+
   // Data selected from DocDB.
   string data_;
 
@@ -85,6 +91,14 @@ class PgDocResult {
   // - System columns must be processed before these fields have any meaning.
   vector<Slice> ybctids_;
   bool syscol_processed_ = false;
+
+  // Columnar rows data, see PgsqlResponsePB::columnar_rows_data. For each target column of the
+  // current chunk, column_values_ points to the values of the rows that are not yet read.
+  const ColumnarRowsData columnar_;
+  vector<Slice> null_bitmaps_;
+  vector<Slice> column_values_;
+  size_t chunk_rows_left_ = 0;
+  size_t chunk_row_idx_ = 0;
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -212,7 +226,16 @@ class PgDocReadOp : public PgDocOp {
   // Also updates the value of can_produce_more_ops_.
   void InitializeNextOps(int num_ops);
 
-  void InitializeParallelSelectCountOps(int select_parallelism);
+  // Initialize operations that read up to select_parallelism tablets in parallel, each operation
+  // moving to the next unread tablet once its tablet is exhausted. Used for aggregates and for
+  // full scans of hash partitioned tables, whose rows are not returned in any particular order.
+  void InitializeParallelScanOps(int select_parallelism);
+
+  // Returns whether a full scan of a hash partitioned table could read its tablets in parallel.
+  bool IsParallelScanAllowed() const;
+
+  // Returns the number of tablets to read in parallel.
+  Result<int> SelectParallelism();
 
   // Used internally for InitializeNextOps to keep track of which permutation should be used
   // to construct the next read_op.
@@ -244,6 +267,9 @@ class PgDocReadOp : public PgDocOp {
   // Offset to use for next element in partition_keys.
   int partition_keys_next_to_use_ = 0;
 
+  // Whether read_ops_ were initialized by InitializeParallelScanOps.
+  bool parallel_scan_ = false;
+
   // Operation(s).
   //
   // If there's more than one, partition_column_values will be fully specified on all of them.
@@ -14,6 +14,7 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/pggate/pg_select_index.h"
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
 #include "yb/client/yb_op.h"
 #include "yb/docdb/primitive_value.h"
@@ -79,18 +80,32 @@ Status PgSelectIndex::PrepareQuery(PgsqlReadRequestPB *read_req) {
 Result<bool> PgSelectIndex::FetchYbctidBatch(const vector<Slice> **ybctids) {
   // Clear the current batch.
   ybctid_batch_ = nullptr;
-
-  // Keep reading until we get one batch of ybctids or EOF.
-  while (!VERIFY_RESULT(GetNextYbctidBatch())) {
-    if (!VERIFY_RESULT(FetchDataFromServer())) {
-      // Server returns no more rows.
-      *ybctids = nullptr;
-      return false;
+  ybctid_batches_.clear();
+  ybctids_.clear();
+
+  // Keep reading until the batch is full or EOF. Ybctids are appended in the order of the index
+  // rows, and the base table rows are returned in the order of their ybctids in the batch.
+  const size_t max_batch_size = std::max(FLAGS_ysql_max_ybctid_batch_size, 1);
+  while (ybctids_.size() < max_batch_size) {
+    if (!VERIFY_RESULT(GetNextYbctidBatch())) {
+      if (!VERIFY_RESULT(FetchDataFromServer())) {
+        // Server returns no more rows.
+        break;
+      }
+      continue;
     }
+    const auto& batch_ybctids = ybctid_batch_->ybctids();
+    ybctids_.insert(ybctids_.end(), batch_ybctids.begin(), batch_ybctids.end());
+    ybctid_batches_.push_back(std::move(ybctid_batch_));
+  }
+
+  if (ybctids_.empty()) {
+    *ybctids = nullptr;
+    return false;
   }
 
   // Got the next batch of ybctids.
-  *ybctids = &ybctid_batch_->ybctids();
+  *ybctids = &ybctids_;
   return true;
 }
 
@@ -47,7 +47,9 @@ class PgSelectIndex : public PgDmlRead {
 
   CHECKED_STATUS PrepareQuery(PgsqlReadRequestPB *read_req);
 
-  // The output parameter "ybctids" are pointer to the data buffer in "ybctid_batch_".
+  // The output parameter "ybctids" are pointer to the data buffers in "ybctid_batches_".
+  // Collects ybctids from several pages of index results, up to ysql_max_ybctid_batch_size, so
+  // the base table rows of all of them are read with one request per tablet.
   Result<bool> FetchYbctidBatch(const vector<Slice> **ybctids);
 
   // Get next batch of ybctids from either PgGate::cache or server.
@@ -69,6 +71,10 @@ class PgSelectIndex : public PgDmlRead {
   // ybctid values are in used.
   PgDocResult::SharedPtr ybctid_batch_;
 
+  // Buffers of all ybctid values of the current batch, and the values themselves.
+  std::list<PgDocResult::SharedPtr> ybctid_batches_;
+  std::vector<Slice> ybctids_;
+
   // This secondary query should be executed just one time.
   bool is_executed_ = false;
 };
@@ -39,7 +39,9 @@
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/storage_metrics.h"
 
+#include "yb/tserver/tserver_service.proxy.h"
 #include "yb/tserver/tserver_shared_mem.h"
 
 #include "yb/util/logging.h"
@@ -96,10 +98,8 @@ static constexpr const char* const kPgSequenceDbOidColName = "db_oid";
 static constexpr const char* const kPgSequenceSeqOidColName = "seq_oid";
 
 static constexpr const char* const kPgSequenceLastValueColName = "last_value";
-static constexpr const size_t kPgSequenceLastValueColIdx = 2;
 
 static constexpr const char* const kPgSequenceIsCalledColName = "is_called";
-static constexpr const size_t kPgSequenceIsCalledColIdx = 3;
 
 string GetStatusStringSet(const client::CollectedErrors& errors) {
   std::set<string> status_strings;
@@ -271,17 +271,23 @@ Status PgSession::RunHelper::Apply(std::shared_ptr<client::YBPgsqlOp> op,
     // see the results of first operation on DocDB side.
     // Multiple operations on same row must be performed in context of different RPC.
     // Flush is required in this case.
-    if (PREDICT_FALSE(!buffered_keys.insert(RowIdentifier(wop)).second)) {
+    RowIdentifier row_id(wop);
+    if (PREDICT_FALSE(!buffered_keys.insert(row_id).second)) {
       RETURN_NOT_OK(pg_session_.FlushBufferedOperationsImpl());
-      buffered_keys.insert(RowIdentifier(wop));
+      buffered_keys.insert(row_id);
+    } else if (PREDICT_FALSE(pg_session_.IsInFlight(row_id))) {
+      // Same for the operations of a batch that is still in flight.
+      RETURN_NOT_OK(pg_session_.WaitForInFlightWrites());
     }
     buffered_ops_.push_back({std::move(op), relation_id});
     // Flush buffers in case limit of operations in single RPC exceeded.
     return PREDICT_TRUE(buffered_keys.size() < FLAGS_ysql_session_max_batch_size)
         ? Status::OK()
-        : pg_session_.FlushBufferedOperationsImpl();
+        : pg_session_.FlushFullBuffers();
   }
 
+  // Operations sent to the server should see the results of the writes of previous statements.
+  RETURN_NOT_OK(pg_session_.WaitForInFlightWrites());
   // Flush all buffered operations (if any) before performing non-bufferable operation
   if (!buffered_keys.empty()) {
     RETURN_NOT_OK(pg_session_.FlushBufferedOperationsImpl());
@@ -657,6 +663,45 @@ Status PgSession::ReadSequenceTuple(int64_t db_oid,
   return Status::OK();
 }
 
+Status PgSession::AllocateSequenceValues(int64_t db_oid,
+                                         int64_t seq_oid,
+                                         uint64_t ysql_catalog_version,
+                                         int64_t increment,
+                                         int64_t min_value,
+                                         int64_t max_value,
+                                         int64_t count,
+                                         int64_t *first_value,
+                                         int64_t *last_value,
+                                         bool *allocated) {
+  *allocated = false;
+  if (!FLAGS_ysql_use_tserver_sequence_cache || !tserver_shared_object_) {
+    return Status::OK();
+  }
+  if (!tablet_server_proxy_) {
+    tablet_server_proxy_ = std::make_unique<tserver::TabletServerServiceProxy>(
+        &client_->proxy_cache(), HostPort((**tserver_shared_object_).endpoint()));
+  }
+
+  tserver::AllocateSequenceValuesRequestPB req;
+  req.set_db_oid(db_oid);
+  req.set_seq_oid(seq_oid);
+  req.set_ysql_catalog_version(ysql_catalog_version);
+  req.set_increment(increment);
+  req.set_min_value(min_value);
+  req.set_max_value(max_value);
+  req.set_count(count);
+  tserver::AllocateSequenceValuesResponsePB resp;
+  rpc::RpcController controller;
+  controller.set_timeout(MonoDelta::FromSeconds(10));
+  RETURN_NOT_OK(tablet_server_proxy_->AllocateSequenceValues(req, &resp, &controller));
+  if (resp.has_first_value() && resp.has_last_value()) {
+    *first_value = resp.first_value();
+    *last_value = resp.last_value();
+    *allocated = true;
+  }
+  return Status::OK();
+}
+
 Status PgSession::DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
   pggate::PgObjectId oid(kPgSequencesDataDatabaseOid, kPgSequencesDataTableOid);
   PgTableDesc::ScopedRefPtr t = VERIFY_RESULT(LoadTable(oid));
@@ -739,12 +784,38 @@ Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const PgObjectId& table_i
 
   DCHECK_EQ(table->table_type(), YBTableType::PGSQL_TABLE_TYPE);
 
+  auto released = released_table_descs_.find(yb_table_id);
+  if (released != released_table_descs_.end()) {
+    auto& descs = released->second;
+    while (!descs.empty()) {
+      PgTableDesc::ScopedRefPtr desc = descs.back();
+      descs.pop_back();
+      // Descriptors of an older version of the table, which was reloaded since they were
+      // released, are dropped.
+      if (desc->table() == table) {
+        desc->ResetColumns();
+        return desc;
+      }
+    }
+  }
+
   return make_scoped_refptr<PgTableDesc>(table);
 }
 
 void PgSession::InvalidateTableCache(const PgObjectId& table_id) {
   const TableId yb_table_id = table_id.GetYBTableId();
   table_cache_.erase(yb_table_id);
+  released_table_descs_.erase(yb_table_id);
+}
+
+void PgSession::ReleaseTableDesc(PgTableDesc::ScopedRefPtr* desc) {
+  if (*desc && (*desc)->HasOneRef() && FLAGS_ysql_max_released_table_descs > 0) {
+    auto& descs = released_table_descs_[(*desc)->table()->id()];
+    if (descs.size() < FLAGS_ysql_max_released_table_descs) {
+      descs.push_back(*desc);
+    }
+  }
+  *desc = nullptr;
 }
 
 void PgSession::StartOperationsBuffering() {
@@ -764,10 +835,91 @@ void PgSession::ResetOperationsBuffering() {
 Status PgSession::FlushBufferedOperations() {
   DCHECK(buffering_enabled_);
   buffering_enabled_ = false;
+  if (FLAGS_ysql_pipeline_buffered_writes && buffered_ops_.empty() &&
+      !buffered_txn_ops_.empty()) {
+    return PipelineBufferedTxnOperations();
+  }
   return FlushBufferedOperationsImpl();
 }
 
+Status PgSession::PipelineBufferedTxnOperations() {
+  RETURN_NOT_OK(WaitForInFlightWrites());
+  return PipelineBufferedOperations();
+}
+
+Status PgSession::FlushFullBuffers() {
+  const size_t max_in_flight_batches = std::max(FLAGS_ysql_max_in_flight_write_batches, 0);
+  if (max_in_flight_batches == 0) {
+    return FlushBufferedOperationsImpl();
+  }
+  RETURN_NOT_OK(WaitForInFlightWrites(max_in_flight_batches - 1));
+  return PipelineBufferedOperations();
+}
+
+Status PgSession::PipelineBufferedOperations() {
+  in_flight_ops_.emplace_back();
+  auto& in_flight = in_flight_ops_.back();
+  in_flight.ops = std::move(buffered_ops_);
+  in_flight.txn_ops = std::move(buffered_txn_ops_);
+  // The keys refer to the operations, which are kept alive by the same entry.
+  in_flight.keys = std::move(buffered_keys_);
+  buffered_ops_.clear();
+  buffered_txn_ops_.clear();
+  buffered_keys_.clear();
+  VLOG(2) << "Pipelining " << in_flight.ops.size() << " non-transactional and "
+          << in_flight.txn_ops.size() << " transactional operations";
+  if (!in_flight.ops.empty()) {
+    in_flight.result = VERIFY_RESULT(FlushBufferedOperationsAsync(
+        in_flight.ops, false /* transactional */));
+  }
+  if (!in_flight.txn_ops.empty()) {
+    in_flight.txn_result = VERIFY_RESULT(FlushBufferedOperationsAsync(
+        in_flight.txn_ops, true /* transactional */));
+  }
+  return Status::OK();
+}
+
+bool PgSession::IsInFlight(const RowIdentifier& row_id) const {
+  for (const auto& in_flight : in_flight_ops_) {
+    if (in_flight.keys.count(row_id)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status PgSession::WaitForInFlightWrites(size_t max_in_flight_batches) {
+  Status status;
+  // In case of an error wait for all batches, so that the error is not reported again by a later
+  // statement.
+  while (in_flight_ops_.size() > (status.ok() ? max_in_flight_batches : 0)) {
+    auto& in_flight = in_flight_ops_.front();
+    for (auto* result : {&in_flight.result, &in_flight.txn_result}) {
+      if (result->InProgress()) {
+        auto batch_status = result->GetStatus();
+        if (status.ok()) {
+          status = std::move(batch_status);
+        }
+      }
+    }
+    if (status.ok()) {
+      status = HandleResponses(in_flight.ops);
+    }
+    if (status.ok()) {
+      status = HandleResponses(in_flight.txn_ops);
+    }
+    in_flight_ops_.pop_front();
+  }
+  return status;
+}
+
+void PgSession::DropInFlightWrites() {
+  auto status = WaitForInFlightWrites();
+  VLOG_IF(1, !status.ok()) << "Dropping error of pipelined operations: " << status;
+}
+
 Status PgSession::FlushBufferedOperationsImpl() {
+  RETURN_NOT_OK(WaitForInFlightWrites());
   auto ops = std::move(buffered_ops_);
   auto txn_ops = std::move(buffered_txn_ops_);
   buffered_keys_.clear();
@@ -835,6 +987,13 @@ Result<bool> PgSession::IsInitDbDone() {
 }
 
 Status PgSession::FlushBufferedOperationsImpl(const PgsqlOpBuffer& ops, bool transactional) {
+  auto result = VERIFY_RESULT(FlushBufferedOperationsAsync(ops, transactional));
+  RETURN_NOT_OK(result.GetStatus());
+  return HandleResponses(ops);
+}
+
+Result<PgSessionAsyncRunResult> PgSession::FlushBufferedOperationsAsync(
+    const PgsqlOpBuffer& ops, bool transactional) {
   DCHECK(ops.size() > 0 && ops.size() <= FLAGS_ysql_session_max_batch_size);
   auto session = VERIFY_RESULT(GetSession(transactional, false /* read_only_op */));
   if (session != session_.get()) {
@@ -851,9 +1010,13 @@ Status PgSession::FlushBufferedOperationsImpl(const PgsqlOpBuffer& ops, bool tra
         << ", initdb mode: " << YBCIsInitDbModeEnvVarSet();
     RETURN_NOT_OK(session->Apply(op));
   }
-  const auto status = session->FlushFuture().get();
-  RETURN_NOT_OK(CombineErrorsToStatus(session->GetPendingErrors(), status));
+  auto future_status = MakeFuture<Status>([session](auto callback) {
+    session->FlushAsync([callback](const Status& status) { callback(status); });
+  });
+  return PgSessionAsyncRunResult(std::move(future_status), session->shared_from_this());
+}
 
+Status PgSession::HandleResponses(const PgsqlOpBuffer& ops) {
   for (const auto& buffered_op : ops) {
     RETURN_NOT_OK(HandleResponse(*buffered_op.operation, buffered_op.relation_id));
   }
@@ -924,5 +1087,18 @@ Status PgSession::TabletServerCount(int *tserver_count, bool primary_only, bool
   return client_->TabletServerCount(tserver_count, primary_only, use_cache);
 }
 
+void PgSession::SetStorageMetricsEnabled(bool enabled) {
+  if (enabled) {
+    storage_metrics_.Clear();
+    num_storage_metrics_reads_ = 0;
+  }
+  storage_metrics_enabled_ = enabled;
+}
+
+void PgSession::AddStorageMetrics(const StorageMetricsPB& metrics) {
+  docdb::AddStorageMetrics(metrics, &storage_metrics_);
+  ++num_storage_metrics_reads_;
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -14,11 +14,13 @@
 #ifndef YB_YQL_PGGATE_PG_SESSION_H_
 #define YB_YQL_PGGATE_PG_SESSION_H_
 
+#include <deque>
 #include <unordered_set>
 
 #include <boost/optional.hpp>
 
 #include "yb/client/client_fwd.h"
+#include "yb/common/ql_protocol.pb.h"
 
 #include "yb/gutil/ref_counted.h"
 
@@ -39,6 +41,16 @@ YB_STRONGLY_TYPED_BOOL(OpBuffered);
 
 class PgTxnManager;
 
+}  // namespace pggate
+
+namespace tserver {
+
+class TabletServerServiceProxy;
+
+}  // namespace tserver
+
+namespace pggate {
+
 // Convenience typedefs.
 struct BufferableOperation {
   std::shared_ptr<client::YBPgsqlOp> operation;
@@ -164,6 +176,20 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   CHECKED_STATUS DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid);
 
+  // Allocates values of the sequence from the node-wide cache of the local tablet server. Sets
+  // *allocated to false if the cache is not used or could not allocate values, e.g. because the
+  // sequence reached its bound, in which case the caller updates the sequence itself.
+  CHECKED_STATUS AllocateSequenceValues(int64_t db_oid,
+                                        int64_t seq_oid,
+                                        uint64_t ysql_catalog_version,
+                                        int64_t increment,
+                                        int64_t min_value,
+                                        int64_t max_value,
+                                        int64_t count,
+                                        int64_t *first_value,
+                                        int64_t *last_value,
+                                        bool *allocated);
+
   CHECKED_STATUS DeleteDBSequences(int64_t db_oid);
 
   // API for schema operations.
@@ -181,6 +207,11 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   Result<PgTableDesc::ScopedRefPtr> LoadTable(const PgObjectId& table_id);
   void InvalidateTableCache(const PgObjectId& table_id);
 
+  // Called by a finished statement with its table descriptor. When nothing else references the
+  // descriptor, it is kept for LoadTable to reuse in the next statement on the same table, instead
+  // of building a new one from the table schema. Resets the pointer in any case.
+  void ReleaseTableDesc(PgTableDesc::ScopedRefPtr* desc);
+
   // Start operation buffering. It is possible that previous sql statment raised an error
   // and collected operations has not been flushed. All ot them will be silently ignored.
   void StartOperationsBuffering();
@@ -189,6 +220,15 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // Flush all pending operations.
   CHECKED_STATUS FlushBufferedOperations();
 
+  // Waits for the writes that were flushed without waiting for their responses, i.e. transactional
+  // writes of previous statements and batches flushed while the statement kept buffering, until at
+  // most max_in_flight_batches of them remain. Returns the error they failed with, if any, in which
+  // case all of them are waited for.
+  CHECKED_STATUS WaitForInFlightWrites(size_t max_in_flight_batches = 0);
+  // Waits for the transactional writes of previous statements and ignores their errors, used when
+  // the transaction is aborted or restarted.
+  void DropInFlightWrites();
+
   // Run (apply + flush) the given operation to read and write database content.
   // Template is used here to handle all kind of derived operations
   // (shared_ptr<YBPgsqlReadOp>, shared_ptr<YBPgsqlWriteOp>)
@@ -247,6 +287,7 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   void InvalidateCache() {
     table_cache_.clear();
+    released_table_descs_.clear();
   }
 
   void InvalidateForeignKeyReferenceCache() {
@@ -275,10 +316,51 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   CHECKED_STATUS TabletServerCount(int *tserver_count, bool primary_only = false,
       bool use_cache = false);
 
+  // While enabled, the reads ask the tablet servers for their storage metrics, and the metrics
+  // are summed up, e.g. for EXPLAIN (ANALYZE, DIST). Enabling resets the sums.
+  void SetStorageMetricsEnabled(bool enabled);
+
+  bool storage_metrics_enabled() const {
+    return storage_metrics_enabled_;
+  }
+
+  // Adds the storage metrics of a read response.
+  void AddStorageMetrics(const StorageMetricsPB& metrics);
+
+  const StorageMetricsPB& storage_metrics() const {
+    return storage_metrics_;
+  }
+
+  // Number of the read responses the storage metrics were added from.
+  int64_t num_storage_metrics_reads() const {
+    return num_storage_metrics_reads_;
+  }
+
  private:
   CHECKED_STATUS FlushBufferedOperationsImpl();
   CHECKED_STATUS FlushBufferedOperationsImpl(const PgsqlOpBuffer& ops, bool transactional);
 
+  // Applies the operations to the session and starts flushing them, the result should be
+  // checked with HandleResponses after the flush is complete.
+  Result<PgSessionAsyncRunResult> FlushBufferedOperationsAsync(
+      const PgsqlOpBuffer& ops, bool transactional);
+
+  CHECKED_STATUS HandleResponses(const PgsqlOpBuffer& ops);
+
+  // Starts flushing the buffered transactional operations, without waiting for the responses.
+  CHECKED_STATUS PipelineBufferedTxnOperations();
+
+  // Called when the buffers reached ysql_session_max_batch_size in the middle of a statement, like
+  // a large COPY. Flushes them, or when ysql_max_in_flight_write_batches allows, starts flushing
+  // them and lets the statement continue buffering.
+  CHECKED_STATUS FlushFullBuffers();
+
+  // Starts flushing both buffers, without waiting for the responses.
+  CHECKED_STATUS PipelineBufferedOperations();
+
+  // Returns whether an operation on the row is in flight.
+  bool IsInFlight(const RowIdentifier& row_id) const;
+
   // Helper class to run multiple operations on single session.
   // This class allows to keep implementation of RunAsync template method simple
   // without moving its implementation details into header file.
@@ -350,6 +432,9 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   ObjectIdGenerator rowid_generator_;
 
   std::unordered_map<TableId, std::shared_ptr<client::YBTable>> table_cache_;
+
+  // Table descriptors released by finished statements, see ReleaseTableDesc.
+  std::unordered_map<TableId, std::vector<PgTableDesc::ScopedRefPtr>> released_table_descs_;
   std::unordered_set<PgForeignKeyReference, boost::hash<PgForeignKeyReference>> fk_reference_cache_;
 
   // Should write operations be buffered?
@@ -358,8 +443,27 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   PgsqlOpBuffer buffered_txn_ops_;
   std::unordered_set<RowIdentifier, boost::hash<RowIdentifier>> buffered_keys_;
 
+  // Operations flushed without waiting for the responses, in the order they were flushed, see
+  // WaitForInFlightWrites.
+  struct InFlightOperations {
+    PgsqlOpBuffer ops;
+    PgSessionAsyncRunResult result;
+    PgsqlOpBuffer txn_ops;
+    PgSessionAsyncRunResult txn_result;
+    // Keys of the written rows. Another write of such a row waits for the operations.
+    std::unordered_set<RowIdentifier, boost::hash<RowIdentifier>> keys;
+  };
+  std::deque<InFlightOperations> in_flight_ops_;
+
   const tserver::TServerSharedObject* const tserver_shared_object_;
   const YBCPgCallbacks& pg_callbacks_;
+
+  // Proxy to the local tablet server, created on first use.
+  std::unique_ptr<tserver::TabletServerServiceProxy> tablet_server_proxy_;
+
+  bool storage_metrics_enabled_ = false;
+  StorageMetricsPB storage_metrics_;
+  int64_t num_storage_metrics_reads_ = 0;
 };
 
 }  // namespace pggate
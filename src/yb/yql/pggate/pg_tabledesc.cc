@@ -63,6 +63,13 @@ Result<PgColumn *> PgTableDesc::FindColumn(int attr_num) {
   return STATUS_FORMAT(InvalidArgument, "Invalid column number $0", attr_num);
 }
 
+void PgTableDesc::ResetColumns() {
+  for (auto& column : columns_) {
+    column.ResetBindings();
+  }
+  column_ybctid_.ResetBindings();
+}
+
 Status PgTableDesc::GetColumnInfo(int16_t attr_number, bool *is_primary, bool *is_hash) const {
   const auto itr = attr_num_map_.find(attr_number);
   if (itr != attr_num_map_.end()) {
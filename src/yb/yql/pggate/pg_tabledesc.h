@@ -62,6 +62,10 @@ class PgTableDesc : public RefCountedThreadSafe<PgTableDesc> {
   // Find the column given the postgres attr number.
   Result<PgColumn *> FindColumn(int attr_num);
 
+  // Clears the binds and read/write requests a statement made to the columns, so the descriptor
+  // could be reused by another statement.
+  void ResetColumns();
+
   CHECKED_STATUS GetColumnInfo(int16_t attr_number, bool *is_primary, bool *is_hash) const;
 
   const std::vector<std::string>& GetPartitions() const;
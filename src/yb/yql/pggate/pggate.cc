@@ -34,6 +34,7 @@
 #include "yb/rpc/secure_stream.h"
 #include "yb/server/secure.h"
 
+#include "yb/tserver/tserver_service.proxy.h"
 #include "yb/tserver/tserver_shared_mem.h"
 
 DECLARE_string(rpc_bind_addresses);
@@ -180,6 +181,10 @@ Status PgApiImpl::DestroyEnv(PgEnv *pg_env) {
 Status PgApiImpl::InitSession(const PgEnv *pg_env,
                               const string& database_name) {
   CHECK(!pg_session_);
+  if (FLAGS_ysql_use_node_catalog_cache && tserver_shared_object_) {
+    client()->SetCatalogReadsProxy(std::make_shared<tserver::TabletServerServiceProxy>(
+        &client()->proxy_cache(), HostPort((**tserver_shared_object_).endpoint())));
+  }
   auto session = make_scoped_refptr<PgSession>(client(),
                                                database_name,
                                                pg_txn_manager_,
@@ -246,6 +251,21 @@ Status PgApiImpl::ReadSequenceTuple(int64_t db_oid,
   return pg_session_->ReadSequenceTuple(db_oid, seq_oid, ysql_catalog_version, last_val, is_called);
 }
 
+Status PgApiImpl::AllocateSequenceValues(int64_t db_oid,
+                                         int64_t seq_oid,
+                                         uint64_t ysql_catalog_version,
+                                         int64_t increment,
+                                         int64_t min_value,
+                                         int64_t max_value,
+                                         int64_t count,
+                                         int64_t *first_value,
+                                         int64_t *last_value,
+                                         bool *allocated) {
+  return pg_session_->AllocateSequenceValues(
+      db_oid, seq_oid, ysql_catalog_version, increment, min_value, max_value, count, first_value,
+      last_value, allocated);
+}
+
 Status PgApiImpl::DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
   return pg_session_->DeleteSequenceTuple(db_oid, seq_oid);
 }
@@ -936,16 +956,19 @@ Status PgApiImpl::BeginTransaction() {
 
 Status PgApiImpl::RestartTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  pg_session_->DropInFlightWrites();
   return pg_txn_manager_->RestartTransaction();
 }
 
 Status PgApiImpl::CommitTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  RETURN_NOT_OK(pg_session_->WaitForInFlightWrites());
   return pg_txn_manager_->CommitTransaction();
 }
 
 Status PgApiImpl::AbortTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
+  pg_session_->DropInFlightWrites();
   return pg_txn_manager_->AbortTransaction();
 }
 
@@ -985,5 +1008,29 @@ void PgApiImpl::ClearForeignKeyReferenceCache() {
   pg_session_->InvalidateForeignKeyReferenceCache();
 }
 
+void PgApiImpl::SetStorageMetricsEnabled(bool enabled) {
+  pg_session_->SetStorageMetricsEnabled(enabled);
+}
+
+void PgApiImpl::GetStorageMetrics(YBCPgStorageMetrics* metrics) {
+  const auto& source = pg_session_->storage_metrics();
+  metrics->read_requests = pg_session_->num_storage_metrics_reads();
+  metrics->seeks = source.seeks();
+  metrics->nexts = source.nexts();
+  metrics->prevs = source.prevs();
+  metrics->intents = source.intents();
+  metrics->internal_keys_skipped = source.internal_keys_skipped();
+  metrics->block_cache_hits = source.block_cache_hits();
+  metrics->block_reads = source.block_reads();
+  metrics->block_read_bytes = source.block_read_bytes();
+  metrics->bloom_checks = source.bloom_checks();
+  metrics->bloom_skips = source.bloom_skips();
+  metrics->total_nanos = source.total_nanos();
+  metrics->seek_nanos = source.seek_nanos();
+  metrics->next_nanos = source.next_nanos();
+  metrics->block_read_nanos = source.block_read_nanos();
+  metrics->block_decompress_nanos = source.block_decompress_nanos();
+}
+
 } // namespace pggate
 } // namespace yb
@@ -113,6 +113,17 @@ class PgApiImpl {
                                    int64_t *last_val,
                                    bool *is_called);
 
+  CHECKED_STATUS AllocateSequenceValues(int64_t db_oid,
+                                        int64_t seq_oid,
+                                        uint64_t ysql_catalog_version,
+                                        int64_t increment,
+                                        int64_t min_value,
+                                        int64_t max_value,
+                                        int64_t count,
+                                        int64_t *first_value,
+                                        int64_t *last_value,
+                                        bool *allocated);
+
   CHECKED_STATUS DeleteSequenceTuple(int64_t db_oid, int64_t seq_oid);
 
   // Delete statement.
@@ -411,6 +422,10 @@ class PgApiImpl {
   CHECKED_STATUS DeleteForeignKeyReference(YBCPgOid table_id, std::string&& ybctid);
   void ClearForeignKeyReferenceCache();
 
+  // Storage metrics of the reads, e.g. for EXPLAIN (ANALYZE, DIST).
+  void SetStorageMetricsEnabled(bool enabled);
+  void GetStorageMetrics(YBCPgStorageMetrics* metrics);
+
   struct MessengerHolder {
     std::unique_ptr<rpc::SecureContext> security_context;
     std::unique_ptr<rpc::Messenger> messenger;
@@ -101,3 +101,42 @@ DEFINE_bool(ysql_serializable_isolation_for_ddl_txn, false,
 DEFINE_int32(ysql_select_parallelism, -1,
             "Number of read requests to issue in parallel to tablets of a table "
             "for SELECT.");
+
+DEFINE_int32(ysql_max_ybctid_batch_size, 1024,
+             "Max number of rows found by a secondary index scan, whose base table rows are read "
+             "in a single batch. Rows from several pages of index results are combined, so the "
+             "base table is read with fewer requests.");
+
+DEFINE_bool(ysql_enable_parallel_scan, false,
+            "Whether full scans of hash partitioned tables without LIMIT read up to "
+            "ysql_select_parallelism tablets in parallel, instead of one tablet after another.");
+
+DEFINE_bool(ysql_pipeline_buffered_writes, false,
+            "Whether transactional writes buffered by a statement are flushed at the end of the "
+            "statement without waiting for the responses. Their errors are reported by the next "
+            "statement that sends an operation to the server, or by the commit.");
+
+DEFINE_bool(ysql_use_node_catalog_cache, true,
+            "Whether to send reads of the system catalog to the local tablet server, which serves "
+            "them from a cache shared by all backends of the node, instead of the master.");
+
+DEFINE_bool(ysql_request_columnar_rows_data, false,
+            "Whether scans ask the tablet servers to return plain column selections in the "
+            "columnar format, with the values of each column stored together, instead of row by "
+            "row.");
+
+DEFINE_int32(ysql_max_released_table_descs, 4,
+             "Max number of table descriptors of finished statements a session keeps per table, "
+             "so the next statements on the table reuse them instead of building new ones from "
+             "the table schema. 0 to disable reuse.");
+
+DEFINE_int32(ysql_max_in_flight_write_batches, 0,
+             "Max number of batches of ysql_session_max_batch_size buffered writes, that a "
+             "statement writing many rows, like COPY, keeps in flight while it continues "
+             "buffering. 0 to wait for each batch before buffering the next one.");
+
+DEFINE_bool(ysql_use_tserver_sequence_cache, false,
+            "Whether backends refilling their caches of sequence values ask the local tablet "
+            "server for them. The tablet server leases large ranges of values from the sequences "
+            "data table and hands them out to all backends of the node, instead of each backend "
+            "updating the sequence row.");
@@ -41,5 +41,13 @@ DECLARE_bool(ysql_beta_feature_roles);
 DECLARE_bool(ysql_beta_feature_extension);
 DECLARE_bool(ysql_enable_manual_sys_table_txn_ctl);
 DECLARE_bool(ysql_serializable_isolation_for_ddl_txn);
+DECLARE_int32(ysql_max_ybctid_batch_size);
+DECLARE_bool(ysql_enable_parallel_scan);
+DECLARE_bool(ysql_pipeline_buffered_writes);
+DECLARE_bool(ysql_use_node_catalog_cache);
+DECLARE_bool(ysql_request_columnar_rows_data);
+DECLARE_int32(ysql_max_released_table_descs);
+DECLARE_int32(ysql_max_in_flight_write_batches);
+DECLARE_bool(ysql_use_tserver_sequence_cache);
 
 #endif  // YB_YQL_PGGATE_PGGATE_FLAGS_H
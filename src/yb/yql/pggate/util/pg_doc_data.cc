@@ -38,6 +38,10 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
     return Status::OK();
   }
 
+  return WriteColumnValue(col_value, buffer);
+}
+
+Status WriteColumnValue(const QLValuePB& col_value, faststring *buffer) {
   switch (col_value.value_case()) {
     case InternalType::VALUE_NOT_SET:
       break;
@@ -102,6 +106,17 @@ Status WriteColumn(const QLValuePB& col_value, faststring *buffer) {
   return Status::OK();
 }
 
+void WriteNullBitmap(const std::vector<bool>& nulls, faststring *buffer) {
+  const size_t start = buffer->size();
+  buffer->resize(start + NullBitmapSize(nulls.size()));
+  memset(buffer->data() + start, 0, buffer->size() - start);
+  for (size_t i = 0; i != nulls.size(); ++i) {
+    if (nulls[i]) {
+      buffer->data()[start + i / 8] |= 1 << (i % 8);
+    }
+  }
+}
+
 //--------------------------------------------------------------------------------------------------
 // Read Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
@@ -118,6 +133,30 @@ void PgDocData::LoadCache(const string& cache, int64_t *total_row_count, Slice *
   cursor->remove_prefix(read_size);
 }
 
+Status PgDocData::ReadColumnarChunk(Slice *cursor, size_t num_columns, size_t *num_rows,
+                                    std::vector<Slice> *null_bitmaps,
+                                    std::vector<Slice> *values) {
+  uint32_t chunk_rows;
+  SCHECK_GE(cursor->size(), sizeof(chunk_rows), Corruption, "Truncated columnar rows data");
+  cursor->remove_prefix(ReadNumber(cursor, &chunk_rows));
+  const size_t bitmap_size = NullBitmapSize(chunk_rows);
+
+  null_bitmaps->clear();
+  values->clear();
+  for (size_t i = 0; i != num_columns; ++i) {
+    uint32_t column_size;
+    SCHECK_GE(cursor->size(), sizeof(column_size), Corruption, "Truncated columnar rows data");
+    cursor->remove_prefix(ReadNumber(cursor, &column_size));
+    SCHECK(column_size >= bitmap_size && column_size <= cursor->size(), Corruption,
+           Format("Wrong size of column $0: $1", i, column_size));
+    null_bitmaps->emplace_back(cursor->data(), bitmap_size);
+    values->emplace_back(cursor->data() + bitmap_size, column_size - bitmap_size);
+    cursor->remove_prefix(column_size);
+  }
+  *num_rows = chunk_rows;
+  return Status::OK();
+}
+
 PgWireDataHeader PgDocData::ReadDataHeader(Slice *cursor) {
   // Read for NULL value.
   uint8_t header_data;
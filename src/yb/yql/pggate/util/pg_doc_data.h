@@ -22,10 +22,30 @@ namespace pggate {
 
 CHECKED_STATUS WriteColumn(const QLValuePB& col_value, faststring *buffer);
 
+// Writes the value without the data header, as done for non-null values in columnar rows data.
+CHECKED_STATUS WriteColumnValue(const QLValuePB& col_value, faststring *buffer);
+
+inline size_t NullBitmapSize(size_t num_rows) {
+  return (num_rows + 7) / 8;
+}
+
+// Writes a bitmap, where the bit of the i-th row is set when its value is null.
+void WriteNullBitmap(const std::vector<bool>& nulls, faststring *buffer);
+
+inline bool IsNullInBitmap(const Slice& null_bitmap, size_t row_idx) {
+  return (null_bitmap[row_idx / 8] >> (row_idx % 8)) & 1;
+}
+
 class PgDocData : public PgWire {
  public:
   static void LoadCache(const string& data, int64_t *total_row_count, Slice *cursor);
 
+  // Reads the next chunk of columnar rows data, see PgsqlResponsePB::columnar_rows_data. Returns
+  // the null bitmap and the values of each of num_columns columns.
+  static CHECKED_STATUS ReadColumnarChunk(Slice *cursor, size_t num_columns, size_t *num_rows,
+                                          std::vector<Slice> *null_bitmaps,
+                                          std::vector<Slice> *values);
+
   static PgWireDataHeader ReadDataHeader(Slice *cursor);
 };
 
@@ -228,6 +228,26 @@ typedef struct PgCallbacks {
   void (*FetchUniqueConstraintName)(YBCPgOid, char*, size_t);
 } YBCPgCallbacks;
 
+// Sums of the storage metrics of the reads, collected while enabled, see StorageMetricsPB.
+typedef struct PgStorageMetrics {
+  int64_t read_requests;
+  uint64_t seeks;
+  uint64_t nexts;
+  uint64_t prevs;
+  uint64_t intents;
+  uint64_t internal_keys_skipped;
+  uint64_t block_cache_hits;
+  uint64_t block_reads;
+  uint64_t block_read_bytes;
+  uint64_t bloom_checks;
+  uint64_t bloom_skips;
+  uint64_t total_nanos;
+  uint64_t seek_nanos;
+  uint64_t next_nanos;
+  uint64_t block_read_nanos;
+  uint64_t block_decompress_nanos;
+} YBCPgStorageMetrics;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
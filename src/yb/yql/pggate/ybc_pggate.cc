@@ -236,6 +236,21 @@ YBCStatus YBCReadSequenceTuple(int64_t db_oid,
       db_oid, seq_oid, ysql_catalog_version, last_val, is_called));
 }
 
+YBCStatus YBCAllocateSequenceValues(int64_t db_oid,
+                                    int64_t seq_oid,
+                                    uint64_t ysql_catalog_version,
+                                    int64_t increment,
+                                    int64_t min_value,
+                                    int64_t max_value,
+                                    int64_t count,
+                                    int64_t *first_value,
+                                    int64_t *last_value,
+                                    bool *allocated) {
+  return ToYBCStatus(pgapi->AllocateSequenceValues(
+      db_oid, seq_oid, ysql_catalog_version, increment, min_value, max_value, count, first_value,
+      last_value, allocated));
+}
+
 YBCStatus YBCDeleteSequenceTuple(int64_t db_oid, int64_t seq_oid) {
   return ToYBCStatus(pgapi->DeleteSequenceTuple(db_oid, seq_oid));
 }
@@ -652,6 +667,14 @@ void ClearForeignKeyReferenceCache() {
   pgapi->ClearForeignKeyReferenceCache();
 }
 
+void YBCPgSetStorageMetricsEnabled(bool enabled) {
+  pgapi->SetStorageMetricsEnabled(enabled);
+}
+
+void YBCPgGetStorageMetrics(YBCPgStorageMetrics* metrics) {
+  pgapi->GetStorageMetrics(metrics);
+}
+
 bool YBCIsInitDbModeEnvVarSet() {
   static bool cached_value = false;
   static bool cached = false;
@@ -94,6 +94,19 @@ YBCStatus YBCReadSequenceTuple(int64_t db_oid,
                                int64_t *last_val,
                                bool *is_called);
 
+// Allocates up to count values of the sequence from the node-wide cache of the local tablet
+// server. Sets *allocated to false if the caller has to update the sequence itself.
+YBCStatus YBCAllocateSequenceValues(int64_t db_oid,
+                                    int64_t seq_oid,
+                                    uint64_t ysql_catalog_version,
+                                    int64_t increment,
+                                    int64_t min_value,
+                                    int64_t max_value,
+                                    int64_t count,
+                                    int64_t *first_value,
+                                    int64_t *last_value,
+                                    bool *allocated);
+
 YBCStatus YBCDeleteSequenceTuple(int64_t db_oid, int64_t seq_oid);
 
 // Create database.
@@ -396,6 +409,10 @@ YBCStatus YBCPgDeleteFromForeignKeyReferenceCache(YBCPgOid table_id, uint64_t yb
 
 void ClearForeignKeyReferenceCache();
 
+// Storage metrics of the reads. Enabling resets the metrics collected before.
+void YBCPgSetStorageMetricsEnabled(bool enabled);
+void YBCPgGetStorageMetrics(YBCPgStorageMetrics* metrics);
+
 bool YBCIsInitDbModeEnvVarSet();
 
 // This is called by initdb. Used to customize some behavior.
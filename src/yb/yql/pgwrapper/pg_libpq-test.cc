@@ -757,6 +757,38 @@ TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(InTxnDelete)) {
   ASSERT_NO_FATALS(AssertRows(&conn, 1));
 }
 
+// EXPLAIN (ANALYZE, DIST) shows the work done by the storage for the reads of the query.
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(ExplainAnalyzeDist)) {
+  auto conn = ASSERT_RESULT(Connect());
+
+  ASSERT_OK(conn.Execute("CREATE TABLE t (key INT PRIMARY KEY, value TEXT)"));
+  ASSERT_OK(conn.Execute("INSERT INTO t SELECT i, 'value' FROM generate_series(1, 100) AS i"));
+
+  auto res = ASSERT_RESULT(conn.Fetch("EXPLAIN (ANALYZE, DIST) SELECT * FROM t"));
+  std::map<std::string, int64_t> values;
+  for (int row = 0; row != PQntuples(res.get()); ++row) {
+    auto line = ASSERT_RESULT(GetString(res.get(), row, 0));
+    LOG(INFO) << line;
+    auto pos = line.find(": ");
+    if (pos != std::string::npos && line.find("Storage ") != std::string::npos) {
+      values[line.substr(line.find_first_not_of(' '), pos)] = std::stoll(line.substr(pos + 2));
+    }
+  }
+  ASSERT_GE(values["Storage Read Requests"], 1);
+  ASSERT_GE(values["Storage Seeks"], 1);
+  // Each of the rows is reached either by a seek or a next.
+  ASSERT_GE(values["Storage Seeks"] + values["Storage Nexts"], 100);
+
+  // Without DIST the storage metrics are not requested.
+  res = ASSERT_RESULT(conn.Fetch("EXPLAIN ANALYZE SELECT * FROM t"));
+  for (int row = 0; row != PQntuples(res.get()); ++row) {
+    auto line = ASSERT_RESULT(GetString(res.get(), row, 0));
+    ASSERT_EQ(line.find("Storage "), std::string::npos) << line;
+  }
+
+  ASSERT_NOK(conn.Execute("EXPLAIN (DIST) SELECT * FROM t"));
+}
+
 TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(CompoundKeyColumnOrder)) {
   const string table_name = "test";
   auto conn = ASSERT_RESULT(Connect());
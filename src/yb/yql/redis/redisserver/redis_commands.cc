@@ -13,7 +13,11 @@
 
 #include "yb/yql/redis/redisserver/redis_commands.h"
 
+#include <atomic>
+#include <mutex>
+
 #include <boost/algorithm/string.hpp>
+#include <boost/preprocessor/cat.hpp>
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/preprocessor/stringize.hpp>
 
@@ -33,6 +37,7 @@
 #include "yb/rpc/scheduler.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/redis_util.h"
 #include "yb/util/stol_utils.h"
@@ -40,6 +45,7 @@
 
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
+#include "yb/yql/redis/redisserver/redis_parser.h"
 #include "yb/yql/redis/redisserver/redis_rpc.h"
 
 using namespace std::literals;
@@ -63,6 +69,13 @@ DEFINE_string(redis_passwords_separator, ",", "The character used to separate mu
 DEFINE_int32(redis_keys_threshold, 10000,
              "Maximum number of keys allowed to be in the db before the KEYS operation errors out");
 
+DEFINE_int32(redis_blocking_pop_poll_interval_ms, 100,
+             "How often BLPOP and BRPOP retry to pop from their lists while they wait. Pushes sent "
+             "through this proxy wake them up right away, pushes sent through other proxies are "
+             "only seen when they retry.");
+TAG_FLAG(redis_blocking_pop_poll_interval_ms, advanced);
+TAG_FLAG(redis_blocking_pop_poll_interval_ms, runtime);
+
 __attribute__((unused))
 DEFINE_validator(redis_passwords_separator, &ValidateRedisPasswordSeparator);
 
@@ -71,7 +84,7 @@ namespace redisserver {
 
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, MULTI_READ)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
@@ -90,7 +103,7 @@ namespace redisserver {
     ((zcard, ZCard, 2, READ)) \
     ((rename, Rename, 3, LOCAL)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, MULTI_WRITE)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hincrby, HIncrBy, 4, WRITE)) \
@@ -98,7 +111,7 @@ namespace redisserver {
     ((sadd, SAdd, -3, WRITE)) \
     ((srem, SRem, -3, WRITE)) \
     ((tsadd, TsAdd, -4, WRITE)) \
-    ((tsrangebytime, TsRangeByTime, 4, READ)) \
+    ((tsrangebytime, TsRangeByTime, -4, READ)) \
     ((tsrevrangebytime, TsRevRangeByTime, -4, READ)) \
     ((tslastn, TsLastN, 3, READ)) \
     ((tscard, TsCard, 2, READ)) \
@@ -111,7 +124,7 @@ namespace redisserver {
     ((zadd, ZAdd, -4, WRITE)) \
     ((getset, GetSet, 3, WRITE)) \
     ((append, Append, 3, WRITE)) \
-    ((del, Del, 2, WRITE)) \
+    ((del, Del, -2, MULTI_WRITE)) \
     ((setrange, SetRange, 4, WRITE)) \
     ((incr, Incr, 2, WRITE)) \
     ((incrby, IncrBy, 3, WRITE)) \
@@ -152,6 +165,8 @@ namespace redisserver {
     ((lpush, LPush, -3, WRITE)) \
     ((rpop, RPop, 2, WRITE)) \
     ((rpush, RPush, -3, WRITE)) \
+    ((blpop, BLPop, -3, LOCAL)) \
+    ((brpop, BRPop, -3, LOCAL)) \
     ((llen, LLen, 2, READ)) \
     ((setnx, SetNX, 3, WRITE)) \
     /**/
@@ -166,6 +181,8 @@ BOOST_PP_SEQ_FOR_EACH(DEFINE_HISTOGRAM, ~, REDIS_COMMANDS)
 #define WRITE_OP yb::client::YBRedisWriteOp
 #define LOCAL_OP RedisResponsePB
 #define CLUSTER_OP RedisResponsePB
+#define MULTI_READ_OP RedisResponsePB
+#define MULTI_WRITE_OP RedisResponsePB
 
 #define DO_PARSER_FORWARD(name, cname, arity, type) \
     CHECKED_STATUS BOOST_PP_CAT(Parse, cname)( \
@@ -211,6 +228,158 @@ void Command(
   context->Apply(idx, std::move(op), info.metrics);
 }
 
+// Gathers the responses of the per-key operations, that a multi-key command is split into, and
+// responds to the command when all of them are done.
+class MultiKeyResponses : public std::enable_shared_from_this<MultiKeyResponses> {
+ public:
+  // Builds the response to the command from the successful responses of its parts.
+  typedef void (*Combiner)(std::vector<RedisResponsePB>* parts, RedisResponsePB* response);
+
+  MultiKeyResponses(
+      const RedisCommandInfo& info, size_t idx, BatchContext* context, size_t num_parts,
+      Combiner combiner)
+      : metrics_(info.metrics), idx_(idx), call_(context->call()), parts_(num_parts),
+        parts_left_(num_parts), combiner_(combiner) {
+  }
+
+  PartResponseCallback Callback(size_t part) {
+    return std::bind(&MultiKeyResponses::PartDone, shared_from_this(), part, _1, _2);
+  }
+
+ private:
+  void PartDone(size_t part, const Status& status, RedisResponsePB* response) {
+    parts_[part].Swap(response);
+    if (!status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (status_.ok()) {
+        status_ = status;
+        failed_part_ = part;
+      }
+    }
+    if (parts_left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!status_.ok()) {
+      auto& failed = parts_[failed_part_];
+      if (failed.code() == RedisResponsePB_RedisStatusCode_SERVER_ERROR) {
+        call_->Respond(idx_, false, &failed);
+      } else {
+        call_->RespondFailure(idx_, status_);
+      }
+      return;
+    }
+    RedisResponsePB result;
+    combiner_(&parts_, &result);
+    call_->RespondSuccess(idx_, metrics_, &result);
+  }
+
+  const rpc::RpcMethodMetrics metrics_;
+  const size_t idx_;
+  const std::shared_ptr<RedisInboundCall> call_;
+  std::vector<RedisResponsePB> parts_;
+  std::atomic<size_t> parts_left_;
+  const Combiner combiner_;
+
+  std::mutex mutex_;
+  Status status_;
+  size_t failed_part_ = 0;
+};
+
+// Splits a command over several keys into operations of one key each, that are parsed by the
+// single-key parser from the command name and args_per_key arguments of the key. The operations
+// are added to the batch like the operations of single-key commands, so they are grouped by tablet
+// and the tablets are read or written in parallel.
+template<class Op>
+void MultiKeyCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    BatchContext* context,
+    size_t args_per_key,
+    Parser<Op> parser,
+    MultiKeyResponses::Combiner combiner) {
+  VLOG(1) << "Processing " << info.name << ".";
+
+  auto table = context->table();
+  if (!table) {
+    RespondWithFailure(context->call(), idx, "Could not open YBTable");
+    return;
+  }
+
+  const auto& command = context->command(idx);
+  if ((command.size() - 1) % args_per_key != 0) {
+    RespondWithFailure(context->call(), idx, "wrong number of arguments");
+    return;
+  }
+  const size_t num_keys = (command.size() - 1) / args_per_key;
+  std::vector<std::shared_ptr<Op>> ops;
+  ops.reserve(num_keys);
+  RedisClientCommand part_args;
+  for (size_t i = 0; i != num_keys; ++i) {
+    auto begin = command.begin() + 1 + i * args_per_key;
+    part_args.assign(1, command[0]);
+    part_args.insert(part_args.end(), begin, begin + args_per_key);
+    ops.push_back(std::make_shared<Op>(table));
+    Status s = parser(ops.back().get(), part_args);
+    if (!s.ok()) {
+      RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+      return;
+    }
+  }
+
+  auto responses = std::make_shared<MultiKeyResponses>(info, idx, context, num_keys, combiner);
+  for (size_t i = 0; i != num_keys; ++i) {
+    context->ApplyPart(idx, std::move(ops[i]), info.metrics, responses->Callback(i));
+  }
+}
+
+void CombineMGet(std::vector<RedisResponsePB>* parts, RedisResponsePB* response) {
+  response->set_code(RedisResponsePB_RedisStatusCode_OK);
+  auto* elements = response->mutable_array_response()->mutable_elements();
+  elements->Reserve(parts->size());
+  for (auto& part : *parts) {
+    // Missing keys and keys that are not strings are nil, that is an empty element.
+    auto* element = elements->Add();
+    if (part.code() == RedisResponsePB_RedisStatusCode_OK) {
+      element->swap(*part.mutable_string_response());
+    }
+  }
+}
+
+void CombineMSet(std::vector<RedisResponsePB>* parts, RedisResponsePB* response) {
+  response->set_code(RedisResponsePB_RedisStatusCode_OK);
+}
+
+void CombineDel(std::vector<RedisResponsePB>* parts, RedisResponsePB* response) {
+  response->set_code(RedisResponsePB_RedisStatusCode_OK);
+  // The parts have no count of deleted keys when redis responses are not emulated.
+  if (parts->empty() || !parts->front().has_int_response()) {
+    return;
+  }
+  int64_t deleted = 0;
+  for (const auto& part : *parts) {
+    deleted += part.int_response();
+  }
+  response->set_int_response(deleted);
+}
+
+void HandleMGet(const RedisCommandInfo& info, size_t idx, BatchContext* context) {
+  MultiKeyCommand<client::YBRedisReadOp>(info, idx, context, 1, &ParseGet, &CombineMGet);
+}
+
+void HandleMSet(const RedisCommandInfo& info, size_t idx, BatchContext* context) {
+  MultiKeyCommand<client::YBRedisWriteOp>(info, idx, context, 2, &ParseSet, &CombineMSet);
+}
+
+void HandleDel(const RedisCommandInfo& info, size_t idx, BatchContext* context) {
+  if (context->command(idx).size() == 2) {
+    Command<client::YBRedisWriteOp>(info, idx, &ParseDel, context);
+    return;
+  }
+  MultiKeyCommand<client::YBRedisWriteOp>(info, idx, context, 1, &ParseDel, &CombineDel);
+}
+
 #define READ_COMMAND(cname) \
     Command<yb::client::YBRedisReadOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define WRITE_COMMAND(cname) \
@@ -218,6 +387,8 @@ void Command(
 #define LOCAL_COMMAND(cname) \
     BOOST_PP_CAT(Handle, cname)({info, idx, context});
 #define CLUSTER_COMMAND(cname) ClusterCommand(info, idx, context)
+#define MULTI_READ_COMMAND(cname) BOOST_PP_CAT(Handle, cname)(info, idx, context)
+#define MULTI_WRITE_COMMAND(cname) BOOST_PP_CAT(Handle, cname)(info, idx, context)
 
 #define DO_POPULATE_HANDLER(name, cname, arity, type) \
   { \
@@ -463,24 +634,29 @@ void HandleSubscribeLikeCommand(LocalCommandData data, AsPattern as_pattern) {
 
   // Add to the appenders after the call has been handled (i.e. reponded with "OK").
   vector<string> channels;
-  vector<int> subs;
   for (int idx = 1; idx < data.arg_size(); idx++) {
     channels.emplace_back(data.arg(idx).ToBuffer());
   }
   auto conn = data.call()->connection().get();
-  data.context()->service_data()->AppendToSubscribers(as_pattern, channels, conn, &subs);
-  string encoded_response;
-  for (int idx = 0; idx < channels.size(); idx++) {
-    encoded_response += redisserver::EncodeAsArrayOfEncodedElements(vector<string>{
-        redisserver::EncodeAsBulkString(as_pattern ? "psubscribe" : "subscribe").ToBuffer(),
-        redisserver::EncodeAsBulkString(channels[idx]).ToBuffer(),
-        redisserver::EncodeAsInteger(subs[idx]).ToBuffer()});
-  }
+  auto* service_data = data.context()->service_data();
+  // The subscription is confirmed after the publishers that skipped this proxy know about it, so
+  // that messages published after the confirmation are not missed.
+  service_data->AppendToSubscribers(
+      as_pattern, channels, conn,
+      [data = std::move(data), as_pattern, channels, response](const vector<int>& subs) mutable {
+    string encoded_response;
+    for (int idx = 0; idx < channels.size(); idx++) {
+      encoded_response += redisserver::EncodeAsArrayOfEncodedElements(vector<string>{
+          redisserver::EncodeAsBulkString(as_pattern ? "psubscribe" : "subscribe").ToBuffer(),
+          redisserver::EncodeAsBulkString(channels[idx]).ToBuffer(),
+          redisserver::EncodeAsInteger(subs[idx]).ToBuffer()});
+    }
 
-  VLOG(3) << "In response to [p]Subscribe queueing " << data.arg_size() - 1
-          << " messages : " << encoded_response;
-  response.set_encoded_response(encoded_response);
-  data.Respond(&response);
+    VLOG(3) << "In response to [p]Subscribe queueing " << data.arg_size() - 1
+            << " messages : " << encoded_response;
+    response.set_encoded_response(encoded_response);
+    data.Respond(&response);
+  });
 }
 
 void HandleSubscribe(LocalCommandData data) {
@@ -686,6 +862,7 @@ class RenameData : public std::enable_shared_from_this<RenameData> {
   }
 
   void Respond(RedisResponsePB* response) {
+    data_.context()->service_data()->InvalidateReadCache();
     data_.Respond(response);
     if (src_functor_) {
       src_functor_(Status::OK());
@@ -873,6 +1050,7 @@ class RenameData : public std::enable_shared_from_this<RenameData> {
 
 void HandleRename(LocalCommandData data) {
   VLOG(1) << "0. HandleRename";
+  data.context()->service_data()->InvalidateReadCache();
   std::shared_ptr<RenameData> rename_data = std::make_shared<RenameData>(std::move(data));
   rename_data->Execute();
 }
@@ -1079,6 +1257,7 @@ void FlushDBs(LocalCommandData data, const vector<string> ids) {
   const Status s = FLAGS_yedis_enable_flush
                        ? data.client()->TruncateTables(ids)
                        : STATUS(InvalidArgument, "FLUSHDB and FLUSHALL are not enabled.");
+  data.context()->service_data()->InvalidateReadCache();
 
   if (s.ok()) {
     resp.set_code(RedisResponsePB_RedisStatusCode_OK);
@@ -1201,6 +1380,7 @@ void HandleDeleteDB(LocalCommandData data) {
   const auto table_name = RedisServiceData::GetYBTableNameForRedisDatabase(db_name);
 
   Status s = data.client()->DeleteTable(table_name, /* wait */ true);
+  data.context()->service_data()->InvalidateReadCache();
   if (s.ok()) {
     resp.set_code(RedisResponsePB_RedisStatusCode_OK);
   } else if (s.IsNotFound()) {
@@ -1279,6 +1459,185 @@ void HandleDebugSleep(LocalCommandData data) {
   data.Apply(functor, std::string(), ManualResponse::kFalse);
 }
 
+// Pops from the first of the lists that has elements, or waits for a push to one of them. The pops
+// are sent through the session of the batch, that the command holds while it waits, like Redis
+// blocks the connection.
+class BlockingPop : public std::enable_shared_from_this<BlockingPop> {
+ public:
+  BlockingPop(const LocalCommandData& data, RedisSide side,
+              std::chrono::steady_clock::time_point deadline)
+      : data_(data), side_(side), deadline_(deadline),
+        db_name_(data.call()->connection_context().redis_db_to_use()) {}
+
+  bool Start(client::YBSession* session, const StatusFunctor& callback) {
+    session_ = session;
+    callback_ = callback;
+    Pop(0);
+    return true;
+  }
+
+ private:
+  size_t num_keys() const {
+    // The command is followed by the keys and the timeout.
+    return data_.arg_size() - 2;
+  }
+
+  Slice key(size_t key_idx) const {
+    return data_.arg(key_idx + 1);
+  }
+
+  void Pop(size_t key_idx) {
+    if (data_.call()->aborted()) {
+      Done(STATUS(Aborted, ""));
+      return;
+    }
+    if (key_idx == num_keys()) {
+      Wait();
+      return;
+    }
+
+    auto op = std::make_shared<client::YBRedisWriteOp>(data_.context()->table());
+    op->mutable_request()->mutable_pop_request()->set_side(side_);
+    const auto list_key = key(key_idx);
+    op->mutable_request()->mutable_key_value()->set_key(list_key.cdata(), list_key.size());
+    op->mutable_request()->mutable_key_value()->set_type(REDIS_TYPE_LIST);
+    auto status = session_->Apply(op);
+    if (!status.ok()) {
+      Done(status);
+      return;
+    }
+    session_->FlushAsync([self = shared_from_this(), op, key_idx](const Status& status) {
+      self->Popped(status, op.get(), key_idx);
+    });
+  }
+
+  void Popped(const Status& status, client::YBRedisWriteOp* op, size_t key_idx) {
+    if (!status.ok()) {
+      Done(status);
+      return;
+    }
+    auto& response = *op->mutable_response();
+    switch (response.code()) {
+      case RedisResponsePB_RedisStatusCode_NIL:
+        Pop(key_idx + 1);
+        return;
+      case RedisResponsePB_RedisStatusCode_OK: {
+        RedisResponsePB result;
+        result.set_code(RedisResponsePB_RedisStatusCode_OK);
+        auto* elements = result.mutable_array_response()->mutable_elements();
+        const auto list_key = key(key_idx);
+        elements->Add()->assign(list_key.cdata(), list_key.size());
+        elements->Add()->swap(*response.mutable_string_response());
+        Done(Status::OK(), &result);
+        return;
+      }
+      default:
+        // Like a key that is not a list.
+        Done(Status::OK(), &response);
+        return;
+    }
+  }
+
+  // Waits until a push through this proxy to one of the lists, the poll interval or the timeout.
+  // A push that is done before the waiters are added is seen when retrying after the poll interval.
+  void Wait() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline_) {
+      RedisResponsePB response;
+      response.set_code(RedisResponsePB_RedisStatusCode_NIL);
+      Done(Status::OK(), &response);
+      return;
+    }
+
+    auto self = shared_from_this();
+    const auto round = round_.load(std::memory_order_acquire);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto* service_data = data_.context()->service_data();
+      for (size_t i = 0; i != num_keys(); ++i) {
+        waiter_ids_.push_back(service_data->AddListWaiter(
+            db_name_, key(i).ToBuffer(), [self, round] { self->Wake(round, Status::OK()); }));
+      }
+    }
+    const auto interval = std::max(FLAGS_redis_blocking_pop_poll_interval_ms, 1) * 1ms;
+    data_.context()->client()->messenger()->scheduler().Schedule(
+        [self, round](const Status& status) { self->Wake(round, status); },
+        std::min(deadline_, now + interval));
+  }
+
+  // Retries the pops, once for a round of waiting, that is ended by whatever comes first.
+  void Wake(uint64_t round, const Status& status) {
+    auto expected = round;
+    if (!round_.compare_exchange_strong(expected, round + 1, std::memory_order_acq_rel)) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto* service_data = data_.context()->service_data();
+      for (size_t i = 0; i != waiter_ids_.size(); ++i) {
+        service_data->RemoveListWaiter(db_name_, key(i).ToBuffer(), waiter_ids_[i]);
+      }
+      waiter_ids_.clear();
+    }
+    if (!status.ok()) {
+      Done(status);
+      return;
+    }
+    Pop(0);
+  }
+
+  void Done(const Status& status, RedisResponsePB* response = nullptr) {
+    data_.Respond(status, response);
+    callback_(Status::OK());
+  }
+
+  LocalCommandData data_;
+  const RedisSide side_;
+  const std::chrono::steady_clock::time_point deadline_;
+  const std::string db_name_;
+  client::YBSession* session_ = nullptr;
+  StatusFunctor callback_;
+  std::atomic<uint64_t> round_{0};
+  std::mutex mutex_;
+  std::vector<uint64_t> waiter_ids_;
+};
+
+void HandleBlockingPop(LocalCommandData data, RedisSide side) {
+  auto timeout_sec = CheckedStold(data.arg(data.arg_size() - 1));
+  const char* error = nullptr;
+  if (!timeout_sec.ok()) {
+    error = "timeout is not a float or out of range";
+  } else if (*timeout_sec < 0) {
+    error = "timeout is negative";
+  }
+  if (error) {
+    RedisResponsePB resp;
+    resp.set_code(RedisResponsePB::PARSING_ERROR);
+    resp.set_error_message(error);
+    data.Respond(&resp);
+    return;
+  }
+
+  // Timeouts that are 0, or too long for the clock, block forever.
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  const std::chrono::duration<long double> timeout(*timeout_sec);
+  if (*timeout_sec != 0 && timeout < std::chrono::hours(24 * 365 * 100)) {
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+  }
+
+  auto pop = std::make_shared<BlockingPop>(data, side, deadline);
+  data.Apply(std::bind(&BlockingPop::Start, pop, _1, _2), std::string(), ManualResponse::kTrue);
+}
+
+void HandleBLPop(LocalCommandData data) {
+  HandleBlockingPop(std::move(data), REDIS_SIDE_LEFT);
+}
+
+void HandleBRPop(LocalCommandData data) {
+  HandleBlockingPop(std::move(data), REDIS_SIDE_RIGHT);
+}
+
 } // namespace
 
 void RespondWithFailure(
@@ -1300,6 +1659,22 @@ void RespondWithFailure(
   call->RespondFailure(idx, STATUS_FORMAT(InvalidCommand, "$0 $1: $2", redis_code, cmd, error));
 }
 
+#define READ_COMMAND_NAME_READ(name) BOOST_PP_STRINGIZE(name),
+#define READ_COMMAND_NAME_WRITE(name)
+#define READ_COMMAND_NAME_LOCAL(name)
+#define READ_COMMAND_NAME_CLUSTER(name)
+#define READ_COMMAND_NAME_MULTI_READ(name) BOOST_PP_STRINGIZE(name),
+#define READ_COMMAND_NAME_MULTI_WRITE(name)
+#define DO_READ_COMMAND_NAME(name, cname, arity, type) BOOST_PP_CAT(READ_COMMAND_NAME_, type)(name)
+#define READ_COMMAND_NAME(r, data, elem) DO_READ_COMMAND_NAME elem
+
+bool IsReadCommand(const Slice& name) {
+  static const std::unordered_set<std::string> kReadCommands = {
+    BOOST_PP_SEQ_FOR_EACH(READ_COMMAND_NAME, ~, REDIS_COMMANDS)
+  };
+  return kReadCommands.count(boost::to_lower_copy(name.ToBuffer())) != 0;
+}
+
 void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
                        const std::function<void(const RedisCommandInfo& info)>& setup_method) {
   BOOST_PP_SEQ_FOR_EACH(POPULATE_HANDLER, ~, REDIS_COMMANDS);
@@ -31,6 +31,9 @@
 
 
 namespace yb {
+
+class RedisResponsePB;
+
 namespace redisserver {
 
 typedef boost::function<void(const Status&)> StatusFunctor;
@@ -48,10 +51,12 @@ class RedisServiceData {
   virtual void LogToMonitors(
       const std::string& end, const std::string& db, const RedisClientCommand& cmd) = 0;
 
-  // Used for PubSub.
+  // Used for PubSub. Done is invoked with the number of subscriptions of the connection after every
+  // channel was added, once the proxies that skip this one for the channels, because it had no
+  // subscribers of them, were notified of the new subscribers.
   virtual void AppendToSubscribers(
       AsPattern type, const std::vector<std::string>& channels, rpc::Connection* conn,
-      std::vector<int>* subs) = 0;
+      std::function<void(const std::vector<int>& subs)> done) = 0;
   virtual void RemoveFromSubscribers(
       AsPattern type, const std::vector<std::string>& channels, rpc::Connection* conn,
       std::vector<int>* subs) = 0;
@@ -63,9 +68,20 @@ class RedisServiceData {
   virtual void ForwardToInterestedProxies(
       const std::string& channel, const std::string& message, const IntFunctor& f) = 0;
 
+  // Used for BLPop and BRPop. The waiter is invoked once after a push to the list is done through
+  // this proxy, unless removed by the returned id before that.
+  virtual uint64_t AddListWaiter(
+      const std::string& db_name, const std::string& key, std::function<void()> waiter) = 0;
+  virtual void RemoveListWaiter(
+      const std::string& db_name, const std::string& key, uint64_t id) = 0;
+
   // Used for Auth.
   virtual CHECKED_STATUS GetRedisPasswords(std::vector<std::string>* passwords) = 0;
 
+  // Used for FlushDB, FlushAll, DeleteDB and Rename, that change keys without sending writes of
+  // them through the batch.
+  virtual void InvalidateReadCache() = 0;
+
   // Used for Select.
   virtual yb::Result<std::shared_ptr<client::YBTable>> GetYBTableForDB(
       const std::string& db_name) = 0;
@@ -77,6 +93,9 @@ class RedisServiceData {
 
 YB_STRONGLY_TYPED_BOOL(ManualResponse);
 
+// Invoked with the status and the response of an operation, that is a part of a command.
+typedef std::function<void(const Status&, RedisResponsePB*)> PartResponseCallback;
+
 // Context for batch of Redis commands.
 class BatchContext : public RefCountedThreadSafe<BatchContext> {
  public:
@@ -105,6 +124,21 @@ class BatchContext : public RefCountedThreadSafe<BatchContext> {
       const rpc::RpcMethodMetrics& metrics,
       ManualResponse manual_response) = 0;
 
+  // Applies an operation that is a part of the command with the given index, like one of the keys
+  // of a multi-key command. The callback is invoked with the response of the operation, instead
+  // of responding to the command.
+  virtual void ApplyPart(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      PartResponseCallback callback) = 0;
+
+  virtual void ApplyPart(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      PartResponseCallback callback) = 0;
+
   virtual ~BatchContext() {}
 };
 
@@ -134,6 +168,9 @@ void RespondWithFailure(
     const std::string& error,
     const char* error_code = "ERR");
 
+// Returns whether the command with the given name only reads data.
+bool IsReadCommand(const Slice& name);
+
 void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
                        const std::function<void(const RedisCommandInfo& info)>& setup_method);
 
@@ -166,15 +166,6 @@ CHECKED_STATUS ParseSetNX(YBRedisWriteOp *op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// TODO: support MSET
-CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
-  if (args.size() < 3 || args.size() % 2 == 0) {
-    return STATUS_SUBSTITUTE(InvalidCommand,
-        "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
-  }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
-}
-
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   const auto& key = args[1];
   const auto& subkey = args[2];
@@ -464,7 +455,6 @@ CHECKED_STATUS ParseAppend(YBRedisWriteOp* op, const RedisClientCommand& args) {
   return Status::OK();
 }
 
-// Note: deleting only one key is supported using one command as of now.
 CHECKED_STATUS ParseDel(YBRedisWriteOp* op, const RedisClientCommand& args) {
   const auto& key = args[1];
   op->mutable_request()->mutable_del_request(); // Allocates new RedisDelRequestPB().
@@ -533,10 +523,6 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
 }
 
 // TODO: Support MGET
-CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
-}
-
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
   return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_HGET);
 }
@@ -649,6 +635,38 @@ CHECKED_STATUS ParseTsRangeByTime(YBRedisReadOp* op, const RedisClientCommand& a
       RedisCollectionGetRangeRequestPB_GetRangeRequestType_TSRANGEBYTIME));
 
   op->mutable_request()->mutable_key_value()->set_key(key.ToBuffer());
+
+  // TSRANGEBYTIME key low high [AGGREGATION MIN|MAX|AVG|SUM|COUNT bucket_size]
+  if (args.size() > 4) {
+    if (args.size() != 7) {
+      return STATUS_SUBSTITUTE(InvalidCommand,
+                               "Invalid number of arguments. Command should have 4 or 7 arguments");
+    }
+    string upper_arg;
+    ToUpperCase(args[4].ToBuffer(), &upper_arg);
+    if (upper_arg != "AGGREGATION") {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Invalid argument $0. Expecting $1", args[4].ToBuffer(),
+                               "aggregation");
+    }
+    auto* aggregation =
+        op->mutable_request()->mutable_get_collection_range_request()->mutable_aggregation();
+    ToUpperCase(args[5].ToBuffer(), &upper_arg);
+    RedisTimeSeriesAggregationPB::AggregationType type;
+    if (!RedisTimeSeriesAggregationPB::AggregationType_Parse(upper_arg, &type)) {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "Invalid aggregation $0. Expecting one of MIN, MAX, AVG, SUM, COUNT",
+                               args[5].ToBuffer());
+    }
+    aggregation->set_type(type);
+    auto bucket_size = VERIFY_RESULT(ParseInt64(args[6], "bucket size"));
+    if (bucket_size <= 0) {
+      return STATUS_SUBSTITUTE(InvalidArgument,
+                               "$0 field $1 is not within valid bounds", "bucket size",
+                               args[6].ToDebugString());
+    }
+    aggregation->set_bucket_size(bucket_size);
+  }
   return Status::OK();
 }
 
@@ -36,6 +36,7 @@ constexpr int64_t kNoneTtl = -1;
 
 CHECKED_STATUS ParseSet(client::YBRedisWriteOp *op, const RedisClientCommand& args);
 CHECKED_STATUS ParseGet(client::YBRedisReadOp* op, const RedisClientCommand& args);
+CHECKED_STATUS ParseDel(client::YBRedisWriteOp* op, const RedisClientCommand& args);
 
 // TODO: make additional command support here
 
@@ -0,0 +1,135 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/yql/redis/redisserver/redis_pubsub_registry.h"
+
+#include "yb/util/test_util.h"
+
+DECLARE_int32(redis_pubsub_skip_ttl_ms);
+DECLARE_int32(redis_pubsub_registry_max_entries);
+
+using namespace std::literals;
+
+namespace yb {
+namespace redisserver {
+
+class RedisPubSubRegistryTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_redis_pubsub_skip_ttl_ms = 60000;
+  }
+
+  bool ShouldSkip(const std::string& peer, const std::string& channel) {
+    uint64_t epoch;
+    return registry_.ShouldSkip(peer, channel, &epoch);
+  }
+
+  void Skip(const std::string& peer, const std::string& channel) {
+    uint64_t epoch;
+    ASSERT_FALSE(registry_.ShouldSkip(peer, channel, &epoch));
+    registry_.SkipPeer(peer, channel, epoch);
+  }
+
+  RedisPubSubRegistry registry_;
+};
+
+TEST_F(RedisPubSubRegistryTest, SkipPeers) {
+  ASSERT_NO_FATALS(Skip("p1", "c1"));
+  ASSERT_NO_FATALS(Skip("p1", "c2"));
+  ASSERT_NO_FATALS(Skip("p2", "c1"));
+  ASSERT_EQ(registry_.num_skipped(), 3);
+  ASSERT_TRUE(ShouldSkip("p1", "c1"));
+  ASSERT_TRUE(ShouldSkip("p2", "c1"));
+  ASSERT_FALSE(ShouldSkip("p2", "c2"));
+
+  registry_.PeerSubscribed("p1", {"c1"});
+  ASSERT_FALSE(ShouldSkip("p1", "c1"));
+  ASSERT_TRUE(ShouldSkip("p1", "c2"));
+  ASSERT_TRUE(ShouldSkip("p2", "c1"));
+
+  // A pattern subscription stops skipping the peer for all channels.
+  registry_.PeerSubscribed("p1", {});
+  ASSERT_FALSE(ShouldSkip("p1", "c2"));
+  ASSERT_TRUE(ShouldSkip("p2", "c1"));
+  ASSERT_EQ(registry_.num_skipped(), 1);
+}
+
+TEST_F(RedisPubSubRegistryTest, SubscribedWhileForwarding) {
+  uint64_t epoch;
+  ASSERT_FALSE(registry_.ShouldSkip("p1", "c1", &epoch));
+  // The notification of new subscribers is received before the reply to the message.
+  registry_.PeerSubscribed("p1", {"c1"});
+  registry_.SkipPeer("p1", "c1", epoch);
+  ASSERT_FALSE(ShouldSkip("p1", "c1"));
+}
+
+TEST_F(RedisPubSubRegistryTest, Expiration) {
+  FLAGS_redis_pubsub_skip_ttl_ms = 50;
+  ASSERT_NO_FATALS(Skip("p1", "c1"));
+  ASSERT_TRUE(ShouldSkip("p1", "c1"));
+  std::this_thread::sleep_for(100ms);
+  ASSERT_FALSE(ShouldSkip("p1", "c1"));
+  ASSERT_EQ(registry_.num_skipped(), 0);
+
+  ASSERT_NO_FATALS(Skip("p1", "c1"));
+  FLAGS_redis_pubsub_skip_ttl_ms = 0;
+  ASSERT_FALSE(RedisPubSubRegistry::Enabled());
+  ASSERT_FALSE(ShouldSkip("p1", "c1"));
+}
+
+TEST_F(RedisPubSubRegistryTest, Watchers) {
+  ASSERT_TRUE(registry_.AddWatcher("news.1", "p1"));
+  ASSERT_TRUE(registry_.AddWatcher("news.1", "p2"));
+  ASSERT_TRUE(registry_.AddWatcher("news.2", "p1"));
+  ASSERT_TRUE(registry_.AddWatcher("weather", "p1"));
+  ASSERT_TRUE(registry_.AddWatcher("news.1", "p1"));
+  ASSERT_EQ(registry_.num_watchers(), 4);
+
+  auto publishers = registry_.TakeWatchers("news.1");
+  ASSERT_EQ(publishers, (std::unordered_set<std::string>{"p1", "p2"}));
+  ASSERT_TRUE(registry_.TakeWatchers("news.1").empty());
+
+  auto matching = registry_.TakeWatchersMatching("news.*");
+  ASSERT_EQ(matching.size(), 1);
+  ASSERT_EQ(matching["p1"], std::vector<std::string>{"news.2"});
+  ASSERT_EQ(registry_.num_watchers(), 1);
+}
+
+TEST_F(RedisPubSubRegistryTest, Limits) {
+  FLAGS_redis_pubsub_registry_max_entries = 2;
+  ASSERT_TRUE(registry_.AddWatcher("c1", "p1"));
+  ASSERT_TRUE(registry_.AddWatcher("c2", "p1"));
+  ASSERT_FALSE(registry_.AddWatcher("c3", "p1"));
+
+  ASSERT_NO_FATALS(Skip("p1", "c1"));
+  ASSERT_NO_FATALS(Skip("p1", "c2"));
+  // All skipped peers are forgotten when there is no room for another one.
+  ASSERT_NO_FATALS(Skip("p1", "c3"));
+  ASSERT_EQ(registry_.num_skipped(), 1);
+  ASSERT_FALSE(ShouldSkip("p1", "c1"));
+  ASSERT_TRUE(ShouldSkip("p1", "c3"));
+}
+
+TEST_F(RedisPubSubRegistryTest, StartupWindow) {
+  ASSERT_TRUE(registry_.InStartupWindow());
+  FLAGS_redis_pubsub_skip_ttl_ms = 0;
+  ASSERT_FALSE(registry_.InStartupWindow());
+}
+
+} // namespace redisserver
+} // namespace yb
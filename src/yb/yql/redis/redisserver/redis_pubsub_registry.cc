@@ -0,0 +1,214 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/redis/redisserver/redis_pubsub_registry.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/redis_util.h"
+
+DEFINE_int32(redis_pubsub_skip_ttl_ms, 60000,
+             "For how long a Redis proxy does not forward published messages of a channel to a "
+             "proxy that had no subscribers of it, unless that proxy notifies it of new "
+             "subscribers. 0 to forward every message to all proxies.");
+TAG_FLAG(redis_pubsub_skip_ttl_ms, advanced);
+TAG_FLAG(redis_pubsub_skip_ttl_ms, runtime);
+
+DEFINE_int32(redis_pubsub_registry_max_entries, 100000,
+             "Maximum number of channels and proxies a Redis proxy remembers, both as skipped "
+             "for publishing and as the ones to notify of new subscribers.");
+TAG_FLAG(redis_pubsub_registry_max_entries, advanced);
+TAG_FLAG(redis_pubsub_registry_max_entries, runtime);
+
+using namespace std::literals;
+
+namespace yb {
+namespace redisserver {
+
+namespace {
+
+CoarseMonoClock::Duration SkipTtl() {
+  return std::max(FLAGS_redis_pubsub_skip_ttl_ms, 0) * 1ms;
+}
+
+size_t MaxEntries() {
+  return static_cast<size_t>(std::max(FLAGS_redis_pubsub_registry_max_entries, 0));
+}
+
+} // namespace
+
+RedisPubSubRegistry::RedisPubSubRegistry() : start_time_(CoarseMonoClock::Now()) {
+}
+
+RedisPubSubRegistry::~RedisPubSubRegistry() {
+}
+
+bool RedisPubSubRegistry::Enabled() {
+  return FLAGS_redis_pubsub_skip_ttl_ms > 0 && FLAGS_redis_pubsub_registry_max_entries > 0;
+}
+
+bool RedisPubSubRegistry::ShouldSkip(
+    const std::string& peer, const std::string& channel, uint64_t* epoch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = skipped_.find(channel);
+  if (it != skipped_.end()) {
+    auto peer_it = it->second.find(peer);
+    if (peer_it != it->second.end()) {
+      if (Enabled() && peer_it->second > CoarseMonoClock::Now()) {
+        return true;
+      }
+      it->second.erase(peer_it);
+      --num_skipped_;
+      if (it->second.empty()) {
+        skipped_.erase(it);
+      }
+    }
+  }
+  *epoch = peer_epochs_[peer];
+  return false;
+}
+
+void RedisPubSubRegistry::SkipPeer(
+    const std::string& peer, const std::string& channel, uint64_t epoch) {
+  if (!Enabled()) {
+    return;
+  }
+  const auto now = CoarseMonoClock::Now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (peer_epochs_[peer] != epoch) {
+    return;
+  }
+  if (num_skipped_ >= MaxEntries()) {
+    num_skipped_ = PurgeExpired(now, &skipped_);
+    if (num_skipped_ >= MaxEntries()) {
+      VLOG(1) << "Forgetting " << num_skipped_ << " skipped Redis proxies";
+      skipped_.clear();
+      num_skipped_ = 0;
+    }
+  }
+  if (skipped_[channel].emplace(peer, now + SkipTtl()).second) {
+    ++num_skipped_;
+  }
+}
+
+void RedisPubSubRegistry::PeerSubscribed(
+    const std::string& peer, const std::vector<std::string>& channels) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++peer_epochs_[peer];
+  auto erase = [this, &peer](ChannelMap::iterator it) {
+    num_skipped_ -= it->second.erase(peer);
+    return it->second.empty() ? skipped_.erase(it) : ++it;
+  };
+  if (channels.empty()) {
+    for (auto it = skipped_.begin(); it != skipped_.end();) {
+      it = erase(it);
+    }
+    return;
+  }
+  for (const auto& channel : channels) {
+    auto it = skipped_.find(channel);
+    if (it != skipped_.end()) {
+      erase(it);
+    }
+  }
+}
+
+bool RedisPubSubRegistry::AddWatcher(const std::string& channel, const std::string& publisher) {
+  const auto now = CoarseMonoClock::Now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (num_watchers_ >= MaxEntries()) {
+    num_watchers_ = PurgeExpired(now, &watchers_);
+    if (num_watchers_ >= MaxEntries()) {
+      return false;
+    }
+  }
+  // The publisher starts to skip this proxy after it gets the reply to the message, so the
+  // promise is kept for longer than the publisher skips it.
+  auto& expiration = watchers_[channel][publisher];
+  if (expiration == CoarseTimePoint()) {
+    ++num_watchers_;
+  }
+  expiration = std::max(expiration, now + 2 * SkipTtl());
+  return true;
+}
+
+std::unordered_set<std::string> RedisPubSubRegistry::TakeWatchers(const std::string& channel) {
+  std::unordered_set<std::string> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = watchers_.find(channel);
+  if (it == watchers_.end()) {
+    return result;
+  }
+  for (const auto& entry : it->second) {
+    result.insert(entry.first);
+  }
+  num_watchers_ -= it->second.size();
+  watchers_.erase(it);
+  return result;
+}
+
+std::unordered_map<std::string, std::vector<std::string>>
+    RedisPubSubRegistry::TakeWatchersMatching(const std::string& pattern) {
+  std::unordered_map<std::string, std::vector<std::string>> result;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = watchers_.begin(); it != watchers_.end();) {
+    if (!RedisUtil::RedisPatternMatch(pattern, it->first, /* ignore case */ false)) {
+      ++it;
+      continue;
+    }
+    for (const auto& entry : it->second) {
+      result[entry.first].push_back(it->first);
+    }
+    num_watchers_ -= it->second.size();
+    it = watchers_.erase(it);
+  }
+  return result;
+}
+
+bool RedisPubSubRegistry::InStartupWindow() const {
+  return CoarseMonoClock::Now() < start_time_ + SkipTtl();
+}
+
+size_t RedisPubSubRegistry::num_skipped() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_skipped_;
+}
+
+size_t RedisPubSubRegistry::num_watchers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_watchers_;
+}
+
+size_t RedisPubSubRegistry::PurgeExpired(CoarseTimePoint now, ChannelMap* channels) {
+  size_t result = 0;
+  for (auto it = channels->begin(); it != channels->end();) {
+    auto& entries = it->second;
+    for (auto entry_it = entries.begin(); entry_it != entries.end();) {
+      if (entry_it->second <= now) {
+        entry_it = entries.erase(entry_it);
+      } else {
+        ++entry_it;
+      }
+    }
+    result += entries.size();
+    it = entries.empty() ? channels->erase(it) : ++it;
+  }
+  return result;
+}
+
+} // namespace redisserver
+} // namespace yb
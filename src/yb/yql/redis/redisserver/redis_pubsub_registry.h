@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_YQL_REDIS_REDISSERVER_REDIS_PUBSUB_REGISTRY_H_
+#define YB_YQL_REDIS_REDISSERVER_REDIS_PUBSUB_REGISTRY_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace redisserver {
+
+// Registry of the channels that Redis proxies have no subscribers of, so that a published message
+// is only forwarded to the proxies that could have subscribers of its channel.
+//
+// The registry is spread over the proxies, and every proxy plays two roles in it:
+//  - As a publisher it skips a peer for a channel, after the peer replied to a forwarded message of
+//    the channel that it has no subscribers of it, and promised to notify the publisher once it
+//    gets some. Skipped peers are identified by their tserver uuid, and forwarded to again after
+//    redis_pubsub_skip_ttl_ms, so that notifications lost to failures are bounded in time.
+//  - As a subscriber it remembers the publishers it promised to notify, the watchers of the
+//    channel, and hands them out when a client subscribes to the channel or to a pattern that
+//    matches it.
+// A restarted proxy does not know whom it promised to notify before, so during the first
+// redis_pubsub_skip_ttl_ms after it starts its subscriptions are announced to all proxies.
+class RedisPubSubRegistry {
+ public:
+  RedisPubSubRegistry();
+  ~RedisPubSubRegistry();
+
+  // Returns whether proxies without subscribers are skipped, otherwise every message is forwarded
+  // to all proxies.
+  static bool Enabled();
+
+  // Returns whether messages of the channel should not be forwarded to the peer. Otherwise fills
+  // the epoch of the peer, that should be passed to SkipPeer once the peer replies.
+  bool ShouldSkip(const std::string& peer, const std::string& channel, uint64_t* epoch);
+
+  // Skips the peer for the channel, because it had no subscribers of it when the message that was
+  // forwarded at the epoch reached it. Ignored if the peer got subscribers since then.
+  void SkipPeer(const std::string& peer, const std::string& channel, uint64_t epoch);
+
+  // The peer got subscribers of the channels, or of a pattern when no channels are listed, so it
+  // should not be skipped for them anymore.
+  void PeerSubscribed(const std::string& peer, const std::vector<std::string>& channels);
+
+  // Remembers the promise to notify the publisher when this proxy gets subscribers of the channel.
+  // Returns false if there are too many promises to make another one.
+  bool AddWatcher(const std::string& channel, const std::string& publisher);
+
+  // Returns the publishers to notify of subscribers of the channel, and forgets about them.
+  std::unordered_set<std::string> TakeWatchers(const std::string& channel);
+
+  // Returns the channels that match the pattern to notify every publisher of, and forgets about
+  // them.
+  std::unordered_map<std::string, std::vector<std::string>> TakeWatchersMatching(
+      const std::string& pattern);
+
+  // Returns whether this proxy could have made promises, that it does not remember, before it was
+  // restarted.
+  bool InStartupWindow() const;
+
+  size_t num_skipped() const;
+  size_t num_watchers() const;
+
+ private:
+  // Expiration times of the entries for a channel, keyed by peer or publisher.
+  typedef std::unordered_map<std::string, CoarseTimePoint> ExpirationMap;
+  typedef std::unordered_map<std::string, ExpirationMap> ChannelMap;
+
+  // Drops the expired entries of the map, returns the number of entries left.
+  static size_t PurgeExpired(CoarseTimePoint now, ChannelMap* channels);
+
+  const CoarseTimePoint start_time_;
+
+  mutable std::mutex mutex_;
+  // Incremented when a peer gets subscribers, so that replies to messages forwarded before that
+  // do not make the peer skipped.
+  std::unordered_map<std::string, uint64_t> peer_epochs_ GUARDED_BY(mutex_);
+  ChannelMap skipped_ GUARDED_BY(mutex_);
+  size_t num_skipped_ GUARDED_BY(mutex_) = 0;
+  ChannelMap watchers_ GUARDED_BY(mutex_);
+  size_t num_watchers_ GUARDED_BY(mutex_) = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(RedisPubSubRegistry);
+};
+
+} // namespace redisserver
+} // namespace yb
+
+#endif // YB_YQL_REDIS_REDISSERVER_REDIS_PUBSUB_REGISTRY_H_
@@ -0,0 +1,153 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
+
+#include "yb/util/test_util.h"
+
+DECLARE_int32(redis_read_cache_ttl_ms);
+DECLARE_int32(redis_read_cache_size_mb);
+
+using namespace std::literals;
+
+namespace yb {
+namespace redisserver {
+
+namespace {
+
+RedisReadRequestPB GetRequest(const std::string& key) {
+  RedisReadRequestPB result;
+  result.mutable_key_value()->set_key(key);
+  result.mutable_get_request()->set_request_type(RedisGetRequestPB_GetRequestType_GET);
+  return result;
+}
+
+RedisReadRequestPB HGetRequest(const std::string& key, const std::string& field) {
+  RedisReadRequestPB result;
+  result.mutable_key_value()->set_key(key);
+  result.mutable_key_value()->add_subkey()->set_string_subkey(field);
+  result.mutable_get_request()->set_request_type(RedisGetRequestPB_GetRequestType_HGET);
+  return result;
+}
+
+RedisResponsePB Response(const std::string& value) {
+  RedisResponsePB result;
+  result.set_code(RedisResponsePB_RedisStatusCode_OK);
+  result.set_string_response(value);
+  return result;
+}
+
+} // namespace
+
+class RedisReadCacheTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_redis_read_cache_ttl_ms = 60000;
+  }
+
+  void Fill(const std::string& db_name, const RedisReadRequestPB& request,
+            const std::string& value) {
+    auto version = cache_.KeyVersion(db_name, request.key_value().key());
+    cache_.Insert(db_name, request, version, Response(value));
+  }
+
+  std::string Read(const std::string& db_name, const RedisReadRequestPB& request) {
+    RedisResponsePB response;
+    if (!cache_.Find(db_name, request, &response)) {
+      return "<miss>";
+    }
+    return response.string_response();
+  }
+
+  RedisReadCache cache_{MemTrackerPtr(), nullptr};
+};
+
+TEST_F(RedisReadCacheTest, Cacheable) {
+  ASSERT_TRUE(RedisReadCache::IsCacheable(GetRequest("k")));
+  ASSERT_TRUE(RedisReadCache::IsCacheable(HGetRequest("k", "f")));
+
+  auto request = GetRequest("k");
+  request.mutable_get_request()->set_request_type(RedisGetRequestPB_GetRequestType_HGETALL);
+  ASSERT_FALSE(RedisReadCache::IsCacheable(request));
+
+  FLAGS_redis_read_cache_ttl_ms = 0;
+  ASSERT_FALSE(RedisReadCache::IsCacheable(GetRequest("k")));
+}
+
+TEST_F(RedisReadCacheTest, FindAndInvalidate) {
+  Fill("0", GetRequest("k"), "v");
+  Fill("0", HGetRequest("h", "f1"), "v1");
+  Fill("0", HGetRequest("h", "f2"), "v2");
+  Fill("1", GetRequest("k"), "other db");
+  Fill("0", GetRequest("h2"), "v3");
+  ASSERT_EQ(cache_.size(), 5);
+
+  ASSERT_EQ(Read("0", GetRequest("k")), "v");
+  ASSERT_EQ(Read("1", GetRequest("k")), "other db");
+  ASSERT_EQ(Read("0", HGetRequest("h", "f2")), "v2");
+  ASSERT_EQ(Read("0", HGetRequest("h", "f3")), "<miss>");
+
+  // All fields of the hash are dropped, but not the keys that it is a prefix of.
+  cache_.Invalidate("0", "h");
+  ASSERT_EQ(Read("0", HGetRequest("h", "f1")), "<miss>");
+  ASSERT_EQ(Read("0", HGetRequest("h", "f2")), "<miss>");
+  ASSERT_EQ(Read("0", GetRequest("h2")), "v3");
+  ASSERT_EQ(cache_.size(), 3);
+
+  cache_.InvalidateAll();
+  ASSERT_EQ(cache_.size(), 0);
+  ASSERT_EQ(Read("0", GetRequest("k")), "<miss>");
+}
+
+TEST_F(RedisReadCacheTest, WriteDuringRead) {
+  auto request = GetRequest("k");
+  auto version = cache_.KeyVersion("0", "k");
+  // The key is written while the read is in flight, so its response could be stale.
+  cache_.Invalidate("0", "k");
+  cache_.Insert("0", request, version, Response("old"));
+  ASSERT_EQ(Read("0", request), "<miss>");
+
+  Fill("0", request, "new");
+  ASSERT_EQ(Read("0", request), "new");
+}
+
+TEST_F(RedisReadCacheTest, Expiration) {
+  FLAGS_redis_read_cache_ttl_ms = 50;
+  Fill("0", GetRequest("k"), "v");
+  ASSERT_EQ(Read("0", GetRequest("k")), "v");
+  std::this_thread::sleep_for(100ms);
+  ASSERT_EQ(Read("0", GetRequest("k")), "<miss>");
+  ASSERT_EQ(cache_.size(), 0);
+}
+
+TEST_F(RedisReadCacheTest, Eviction) {
+  FLAGS_redis_read_cache_size_mb = 1;
+  const std::string value(100 * 1024, 'x');
+  for (int i = 0; i != 20; ++i) {
+    Fill("0", GetRequest(std::to_string(i)), value);
+    // Keep the first key recently used.
+    ASSERT_EQ(Read("0", GetRequest("0")), value);
+  }
+  ASSERT_LE(cache_.size(), 10);
+  ASSERT_EQ(Read("0", GetRequest("0")), value);
+  ASSERT_EQ(Read("0", GetRequest("1")), "<miss>");
+  ASSERT_EQ(Read("0", GetRequest("19")), value);
+}
+
+} // namespace redisserver
+} // namespace yb
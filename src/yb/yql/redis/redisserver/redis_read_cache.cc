@@ -0,0 +1,239 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
+
+DEFINE_int32(redis_read_cache_ttl_ms, 0,
+             "For how long a Redis proxy serves GET and HGET commands from the responses it got "
+             "to earlier reads of the same key. Writes done through other proxies could be missed "
+             "for this long. 0 to disable the cache.");
+TAG_FLAG(redis_read_cache_ttl_ms, advanced);
+TAG_FLAG(redis_read_cache_ttl_ms, runtime);
+
+DEFINE_int32(redis_read_cache_size_mb, 64,
+             "Size of the cache of GET and HGET responses of a Redis proxy. The least recently "
+             "used responses are dropped when it is full.");
+TAG_FLAG(redis_read_cache_size_mb, advanced);
+TAG_FLAG(redis_read_cache_size_mb, runtime);
+
+METRIC_DEFINE_counter(
+    server, redis_read_cache_get_hits, "Redis read cache GET hits",
+    yb::MetricUnit::kRequests,
+    "Number of GET commands served from the Redis read cache");
+METRIC_DEFINE_counter(
+    server, redis_read_cache_get_misses, "Redis read cache GET misses",
+    yb::MetricUnit::kRequests,
+    "Number of cacheable GET commands that were sent to the tablet leaders");
+METRIC_DEFINE_counter(
+    server, redis_read_cache_hget_hits, "Redis read cache HGET hits",
+    yb::MetricUnit::kRequests,
+    "Number of HGET commands served from the Redis read cache");
+METRIC_DEFINE_counter(
+    server, redis_read_cache_hget_misses, "Redis read cache HGET misses",
+    yb::MetricUnit::kRequests,
+    "Number of cacheable HGET commands that were sent to the tablet leaders");
+
+using namespace std::literals;
+using namespace yb::size_literals;
+
+namespace yb {
+namespace redisserver {
+
+namespace {
+
+// Rough memory used by an entry besides its key and response, for the map and lru list nodes.
+constexpr size_t kEntryOverhead = 128;
+
+// All cache keys of the reads of a redis key start with this prefix. The lengths make sure that
+// the prefix of one key is not a prefix of the other.
+std::string KeyPrefix(const std::string& db_name, const Slice& key) {
+  std::string result = std::to_string(db_name.size());
+  result += ':';
+  result += db_name;
+  result += std::to_string(key.size());
+  result += ':';
+  result.append(key.cdata(), key.size());
+  return result;
+}
+
+std::string EntryKey(const std::string& db_name, const RedisReadRequestPB& request) {
+  auto result = KeyPrefix(db_name, request.key_value().key());
+  request.AppendToString(&result);
+  return result;
+}
+
+bool IsHGet(const RedisReadRequestPB& request) {
+  return request.get_request().request_type() == RedisGetRequestPB_GetRequestType_HGET;
+}
+
+} // namespace
+
+RedisReadCache::RedisReadCache(const MemTrackerPtr& parent_mem_tracker,
+                               const scoped_refptr<MetricEntity>& metric_entity)
+    : mem_tracker_(MemTracker::FindOrCreateTracker("Redis Read Cache", parent_mem_tracker)) {
+  if (metric_entity) {
+    get_hits_ = METRIC_redis_read_cache_get_hits.Instantiate(metric_entity);
+    get_misses_ = METRIC_redis_read_cache_get_misses.Instantiate(metric_entity);
+    hget_hits_ = METRIC_redis_read_cache_hget_hits.Instantiate(metric_entity);
+    hget_misses_ = METRIC_redis_read_cache_hget_misses.Instantiate(metric_entity);
+  }
+  for (auto& version : key_versions_) {
+    version.store(0, std::memory_order_relaxed);
+  }
+}
+
+RedisReadCache::~RedisReadCache() {
+  mem_tracker_->Release(consumption_);
+}
+
+bool RedisReadCache::Enabled() {
+  return FLAGS_redis_read_cache_ttl_ms > 0 && FLAGS_redis_read_cache_size_mb > 0;
+}
+
+bool RedisReadCache::IsCacheable(const RedisReadRequestPB& request) {
+  if (!Enabled() || !request.has_get_request() || request.has_subkey_range() ||
+      request.has_index_range() || request.has_range_request_limit()) {
+    return false;
+  }
+  switch (request.get_request().request_type()) {
+    case RedisGetRequestPB_GetRequestType_GET:
+      return true;
+    case RedisGetRequestPB_GetRequestType_HGET:
+      return request.key_value().subkey_size() == 1;
+    default:
+      return false;
+  }
+}
+
+std::atomic<uint64_t>& RedisReadCache::KeyVersionSlot(const std::string& key_prefix) const {
+  return key_versions_[std::hash<std::string>()(key_prefix) % kNumKeyVersions];
+}
+
+uint64_t RedisReadCache::KeyVersion(const std::string& db_name, const Slice& key) const {
+  return KeyVersionSlot(KeyPrefix(db_name, key)).load(std::memory_order_acquire);
+}
+
+bool RedisReadCache::Find(const std::string& db_name, const RedisReadRequestPB& request,
+                          RedisResponsePB* response) {
+  const bool hget = IsHGet(request);
+  const auto key = EntryKey(db_name, request);
+  const auto now = CoarseMonoClock::Now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      if (it->second.expiration > now) {
+        lru_.splice(lru_.end(), lru_, it->second.lru_it);
+        response->CopyFrom(it->second.response);
+        auto& hits = hget ? hget_hits_ : get_hits_;
+        if (hits) {
+          hits->Increment();
+        }
+        return true;
+      }
+      EraseUnlocked(it);
+    }
+  }
+  auto& misses = hget ? hget_misses_ : get_misses_;
+  if (misses) {
+    misses->Increment();
+  }
+  return false;
+}
+
+void RedisReadCache::Insert(const std::string& db_name, const RedisReadRequestPB& request,
+                            uint64_t key_version, const RedisResponsePB& response) {
+  if (response.code() != RedisResponsePB_RedisStatusCode_OK &&
+      response.code() != RedisResponsePB_RedisStatusCode_NIL) {
+    return;
+  }
+  const auto ttl_ms = FLAGS_redis_read_cache_ttl_ms;
+  const size_t capacity = static_cast<size_t>(std::max(FLAGS_redis_read_cache_size_mb, 0)) * 1_MB;
+  auto key = EntryKey(db_name, request);
+  const size_t charge = key.size() + response.SpaceUsed() + kEntryOverhead;
+  if (ttl_ms <= 0 || charge > capacity) {
+    return;
+  }
+  const auto& version = KeyVersionSlot(KeyPrefix(db_name, request.key_value().key()));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The key version is checked under the lock, that Invalidate takes after bumping it, so a
+  // response read before a write could not be cached after the write dropped the key entries.
+  if (version.load(std::memory_order_acquire) != key_version) {
+    return;
+  }
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    EraseUnlocked(it);
+  }
+  while (!lru_.empty() && consumption_ + charge > capacity) {
+    EraseUnlocked(entries_.find(*lru_.front()));
+  }
+  it = entries_.emplace(std::move(key), Entry()).first;
+  auto& entry = it->second;
+  entry.response.CopyFrom(response);
+  entry.expiration = CoarseMonoClock::Now() + ttl_ms * 1ms;
+  entry.charge = charge;
+  entry.lru_it = lru_.insert(lru_.end(), &it->first);
+  consumption_ += charge;
+  mem_tracker_->Consume(charge);
+}
+
+void RedisReadCache::Invalidate(const std::string& db_name, const Slice& key) {
+  const auto prefix = KeyPrefix(db_name, key);
+  KeyVersionSlot(prefix).fetch_add(1, std::memory_order_acq_rel);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.lower_bound(prefix);
+  while (it != entries_.end() && Slice(it->first).starts_with(prefix)) {
+    EraseUnlocked(it++);
+  }
+}
+
+void RedisReadCache::InvalidateAll() {
+  for (auto& version : key_versions_) {
+    version.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  VLOG(1) << "Dropping " << entries_.size() << " cached Redis reads";
+  entries_.clear();
+  lru_.clear();
+  mem_tracker_->Release(consumption_);
+  consumption_ = 0;
+}
+
+size_t RedisReadCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+void RedisReadCache::EraseUnlocked(EntryMap::iterator it) {
+  consumption_ -= it->second.charge;
+  mem_tracker_->Release(it->second.charge);
+  lru_.erase(it->second.lru_it);
+  entries_.erase(it);
+}
+
+} // namespace redisserver
+} // namespace yb
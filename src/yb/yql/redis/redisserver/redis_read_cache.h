@@ -0,0 +1,122 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H_
+#define YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H_
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "yb/common/redis_protocol.pb.h"
+
+#include "yb/gutil/macros.h"
+#include "yb/gutil/ref_counted.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/monotime.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class Counter;
+class MetricEntity;
+
+namespace redisserver {
+
+// Cache of the responses to GET and HGET commands, that a Redis proxy serves without sending the
+// reads to the tablet leaders.
+//
+// Every entry is cached for at most redis_read_cache_ttl_ms, that is the lease the proxy has on
+// the value. Writes sent through this proxy drop the cached reads of their key, when they are sent
+// and again when they are done, so that reads of the key that were in flight meanwhile are not
+// cached. Writes sent through other proxies, and expiration of keys with a TTL, are only seen when
+// the lease of the entry is over, so the cache is disabled by default.
+class RedisReadCache {
+ public:
+  RedisReadCache(const MemTrackerPtr& parent_mem_tracker,
+                 const scoped_refptr<MetricEntity>& metric_entity);
+  ~RedisReadCache();
+
+  // Returns whether the cache is enabled.
+  static bool Enabled();
+
+  // Returns whether the response to the read could be cached.
+  static bool IsCacheable(const RedisReadRequestPB& request);
+
+  // Returns the version of the key, that should be passed to Insert for a read of the key that
+  // is about to be sent.
+  uint64_t KeyVersion(const std::string& db_name, const Slice& key) const;
+
+  // Fills the response to the read from the cache. Returns false if there is no live entry.
+  bool Find(const std::string& db_name, const RedisReadRequestPB& request,
+            RedisResponsePB* response);
+
+  // Caches the response to the read, that was sent at the key version. The response is not cached
+  // if the key was written since then.
+  void Insert(const std::string& db_name, const RedisReadRequestPB& request, uint64_t key_version,
+              const RedisResponsePB& response);
+
+  // Drops the cached reads of the key.
+  void Invalidate(const std::string& db_name, const Slice& key);
+
+  // Drops all cached reads, used when whole databases are flushed, deleted or renamed into.
+  void InvalidateAll();
+
+  size_t size() const;
+
+ private:
+  // Keys of the entries, from the least to the most recently used.
+  typedef std::list<const std::string*> LruList;
+
+  struct Entry {
+    RedisResponsePB response;
+    CoarseTimePoint expiration;
+    size_t charge;
+    LruList::iterator lru_it;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+
+  // Number of key versions, the keys are mapped to them by hash.
+  static constexpr size_t kNumKeyVersions = 1024;
+
+  std::atomic<uint64_t>& KeyVersionSlot(const std::string& key_prefix) const;
+
+  void EraseUnlocked(EntryMap::iterator it) REQUIRES(mutex_);
+
+  MemTrackerPtr mem_tracker_;
+  scoped_refptr<Counter> get_hits_;
+  scoped_refptr<Counter> get_misses_;
+  scoped_refptr<Counter> hget_hits_;
+  scoped_refptr<Counter> hget_misses_;
+
+  mutable std::array<std::atomic<uint64_t>, kNumKeyVersions> key_versions_;
+
+  mutable std::mutex mutex_;
+  // Entries ordered by key, so that all reads of a redis key are next to each other.
+  EntryMap entries_ GUARDED_BY(mutex_);
+  LruList lru_ GUARDED_BY(mutex_);
+  size_t consumption_ GUARDED_BY(mutex_) = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(RedisReadCache);
+};
+
+} // namespace redisserver
+} // namespace yb
+
+#endif // YB_YQL_REDIS_REDISSERVER_REDIS_READ_CACHE_H_
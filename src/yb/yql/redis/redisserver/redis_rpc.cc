@@ -14,11 +14,14 @@
 //
 #include "yb/yql/redis/redisserver/redis_rpc.h"
 
+#include <algorithm>
+
 #include "yb/client/client_fwd.h"
 #include "yb/client/meta_cache.h"
 
 #include "yb/common/redis_protocol.pb.h"
 
+#include "yb/yql/redis/redisserver/redis_commands.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
 
@@ -28,7 +31,9 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/trace.h"
 
 #include "yb/util/debug/trace_event.h"
 
@@ -40,9 +45,10 @@ using namespace yb::size_literals;
 
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_int32(rpc_slow_query_threshold_ms);
-DEFINE_uint64(redis_max_concurrent_commands, 1,
-              "Max number of redis commands received from single connection, "
-              "that could be processed concurrently");
+DEFINE_uint64(redis_max_concurrent_commands, 8,
+              "Max number of redis command batches received from single connection, "
+              "that could be processed concurrently. Only batches of read commands are processed "
+              "concurrently, a batch with other commands is processed alone.");
 DEFINE_uint64(redis_max_batch, 500, "Max number of redis commands that forms batch");
 DEFINE_int32(rpcz_max_redis_query_dump_size, 4_KB,
              "The maximum size of the Redis query string in the RPCZ dump.");
@@ -52,6 +58,19 @@ DEFINE_uint64(redis_max_read_buffer_size, 128_MB,
 DEFINE_uint64(redis_max_queued_bytes, 128_MB,
               "Max number of bytes in queued redis commands.");
 
+#define DEFINE_REDIS_STAGE_histogram(name, description) \
+  METRIC_DEFINE_histogram( \
+      server, BOOST_PP_CAT(redis_call_stage_, name), "Redis call " description " time", \
+      yb::MetricUnit::kMicroseconds, \
+      "Microseconds spent by batches of Redis commands in " description, 60000000LU, 2)
+
+DEFINE_REDIS_STAGE_histogram(parse, "parsing");
+DEFINE_REDIS_STAGE_histogram(queue, "the service queue");
+DEFINE_REDIS_STAGE_histogram(prepare, "preparing operations");
+DEFINE_REDIS_STAGE_histogram(tablet_lookup, "tablet lookup");
+DEFINE_REDIS_STAGE_histogram(execute, "execution");
+DEFINE_REDIS_STAGE_histogram(serialize, "serializing responses");
+
 DEFINE_int32(
     redis_connection_soft_limit_grace_period_sec, 60,
     "The duration for which the outbound data needs to exceeed the softlimit "
@@ -186,6 +205,25 @@ void RedisConnectionContext::Shutdown(const Status& status) {
   rpc::ConnectionContextWithQueue::Shutdown(status);
 }
 
+RedisCallStageMetrics::RedisCallStageMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
+  histograms_[to_underlying(RedisCallStage::kParse)] =
+      METRIC_redis_call_stage_parse.Instantiate(metric_entity);
+  histograms_[to_underlying(RedisCallStage::kQueue)] =
+      METRIC_redis_call_stage_queue.Instantiate(metric_entity);
+  histograms_[to_underlying(RedisCallStage::kPrepare)] =
+      METRIC_redis_call_stage_prepare.Instantiate(metric_entity);
+  histograms_[to_underlying(RedisCallStage::kTabletLookup)] =
+      METRIC_redis_call_stage_tablet_lookup.Instantiate(metric_entity);
+  histograms_[to_underlying(RedisCallStage::kExecute)] =
+      METRIC_redis_call_stage_execute.Instantiate(metric_entity);
+  histograms_[to_underlying(RedisCallStage::kSerialize)] =
+      METRIC_redis_call_stage_serialize.Instantiate(metric_entity);
+}
+
+void RedisCallStageMetrics::Increment(RedisCallStage stage, MonoDelta delta) const {
+  histograms_[to_underlying(stage)]->Increment(delta.ToMicroseconds());
+}
+
 RedisInboundCall::RedisInboundCall(rpc::ConnectionPtr conn,
                                    size_t weight_in_bytes,
                                    CallProcessedListener call_processed_listener)
@@ -241,10 +279,45 @@ Status RedisInboundCall::ParseFrom(
                          end_of_command, request_data_.size());
   }
 
+  read_only_ = std::all_of(
+      client_batch_.begin(), client_batch_.end(),
+      [](const RedisClientCommand& command) { return IsReadCommand(command[0]); });
+
   parsed_.store(true, std::memory_order_release);
+  RecordStage(RedisCallStage::kParse);
   return Status::OK();
 }
 
+void RedisInboundCall::SetStageMetrics(const RedisCallStageMetrics* metrics) {
+  std::lock_guard<simple_spinlock> lock(stages_mutex_);
+  stage_metrics_ = metrics;
+  for (size_t i = 0; i != stages_done_; ++i) {
+    if (stage_times_[i].Initialized()) {
+      stage_metrics_->Increment(static_cast<RedisCallStage>(i), stage_times_[i]);
+    }
+  }
+}
+
+void RedisInboundCall::RecordStage(RedisCallStage stage) {
+  const auto now = MonoTime::Now();
+  const size_t index = to_underlying(stage);
+  MonoDelta delta;
+  {
+    std::lock_guard<simple_spinlock> lock(stages_mutex_);
+    if (index < stages_done_) {
+      return;
+    }
+    delta = now - (last_stage_end_.Initialized() ? last_stage_end_ : timing_.time_received);
+    stage_times_[index] = delta;
+    stages_done_ = index + 1;
+    last_stage_end_ = now;
+    if (stage_metrics_) {
+      stage_metrics_->Increment(stage, delta);
+    }
+  }
+  TRACE_TO(trace_, "Redis $0 took $1", redisserver::ToString(stage), delta.ToString());
+}
+
 const std::string& RedisInboundCall::service_name() const {
   static std::string result = "yb.redisserver.RedisServerService"s;
   return result;
@@ -280,9 +353,25 @@ void RedisInboundCall::LogTrace() const {
     GetCallDetails(&call_in_progress_pb);
     LOG(WARNING) << call_in_progress_pb.DebugString() << "Trace: ";
     trace_->Dump(&LOG(WARNING), /* include_time_deltas */ true);
+    LOG(WARNING) << "Stages: " << StagesToString();
   }
 }
 
+std::string RedisInboundCall::StagesToString() const {
+  std::string result;
+  std::lock_guard<simple_spinlock> lock(stages_mutex_);
+  for (size_t i = 0; i != stages_done_; ++i) {
+    if (!stage_times_[i].Initialized()) {
+      continue;
+    }
+    if (!result.empty()) {
+      result += ", ";
+    }
+    result += Format("$0: $1", static_cast<RedisCallStage>(i), stage_times_[i]);
+  }
+  return result;
+}
+
 string RedisInboundCall::ToString() const {
   return Format("Redis Call from $0", connection()->remote());
 }
@@ -361,6 +450,7 @@ RefCntBuffer SerializeResponses(const Collection& responses) {
 
 void RedisInboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) {
   output->push_back(SerializeResponses(responses_));
+  RecordStage(RedisCallStage::kSerialize);
 }
 
 RedisConnectionContext& RedisInboundCall::connection_context() const {
@@ -386,6 +476,7 @@ void RedisInboundCall::Respond(size_t idx, bool is_success, RedisResponsePB* res
     // Did we get all responses and ready to send data.
     size_t responded = ready_count_.fetch_add(1, std::memory_order_release) + 1;
     if (responded == client_batch_.size()) {
+      RecordStage(RedisCallStage::kExecute);
       RecordHandlingCompleted(/* handler_run_time */ nullptr);
       QueueResponse(!had_failures_.load(std::memory_order_acquire));
     }
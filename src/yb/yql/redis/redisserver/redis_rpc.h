@@ -16,6 +16,8 @@
 #ifndef YB_YQL_REDIS_REDISSERVER_REDIS_RPC_H
 #define YB_YQL_REDIS_REDISSERVER_REDIS_RPC_H
 
+#include <array>
+
 #include <boost/container/small_vector.hpp>
 
 #include "yb/yql/redis/redisserver/redis_fwd.h"
@@ -25,9 +27,14 @@
 #include "yb/rpc/growable_buffer.h"
 #include "yb/rpc/rpc_with_queue.h"
 
+#include "yb/util/locks.h"
+#include "yb/util/monotime.h"
+
 namespace yb {
 
+class Histogram;
 class MemTracker;
+class MetricEntity;
 
 namespace redisserver {
 
@@ -35,6 +42,30 @@ class RedisParser;
 
 YB_DEFINE_ENUM(RedisClientMode, (kNormal)(kSubscribed)(kMonitoring));
 
+// Stages of processing of a batch of commands, every stage is timed from the end of the previous
+// one that the batch went through:
+//  - kParse: from receiving the batch to splitting it into commands.
+//  - kQueue: waiting in the service queue for a handler thread.
+//  - kPrepare: building the operations of the commands, until they are sent for tablet lookup.
+//  - kTabletLookup: waiting for the tablets of the operations to be found.
+//  - kExecute: from sending the operations until all commands got a response. This includes the
+//    wait in the batcher and the execution on the tablet servers, that are not told apart from
+//    the proxy.
+//  - kSerialize: encoding the responses for the client.
+// Batches served without the tablets, e.g. local commands, skip kPrepare and kTabletLookup.
+YB_DEFINE_ENUM(RedisCallStage, (kParse)(kQueue)(kPrepare)(kTabletLookup)(kExecute)(kSerialize));
+
+// Histograms of the time spent by batches of commands in every stage.
+class RedisCallStageMetrics {
+ public:
+  explicit RedisCallStageMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+
+  void Increment(RedisCallStage stage, MonoDelta delta) const;
+
+ private:
+  std::array<scoped_refptr<Histogram>, kRedisCallStageMapSize> histograms_;
+};
+
 class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
  public:
   RedisConnectionContext(
@@ -118,6 +149,8 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   void Serialize(boost::container::small_vector_base<RefCntBuffer>* output) override;
   void GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) const;
   void LogTrace() const override;
+  // Returns the time spent in every stage recorded so far.
+  std::string StagesToString() const;
   std::string ToString() const override;
   bool DumpPB(const rpc::DumpRunningRpcsRequestPB& req, rpc::RpcCallInProgressPB* resp) override;
 
@@ -139,6 +172,17 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
                       RedisResponsePB* resp);
   void MarkForClose() { quit_.store(true, std::memory_order_release); }
 
+  // Sets the histograms that stages are reported to, including the ones already recorded.
+  void SetStageMetrics(const RedisCallStageMetrics* metrics);
+
+  // Records the end of the stage. Stages that are recorded after a later stage, e.g. by the second
+  // batch of operations of the call, are ignored.
+  void RecordStage(RedisCallStage stage);
+
+  // Batches of read commands are processed concurrently with other such batches of the
+  // connection, while their replies are still sent in order.
+  bool CouldRunConcurrently() const override { return read_only_; }
+
   size_t ObjectSize() const override { return sizeof(*this); }
 
   size_t DynamicMemoryUsage() const override {
@@ -162,7 +206,17 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   // Atomic bool to indicate if the quit command is present
   std::atomic<bool> quit_ = {false};
 
+  // Whether all commands of the batch are read commands.
+  bool read_only_ = false;
+
   ScopedTrackedConsumption consumption_;
+
+  mutable simple_spinlock stages_mutex_;
+  const RedisCallStageMetrics* stage_metrics_ GUARDED_BY(stages_mutex_) = nullptr;
+  // Number of the stages recorded so far, including the skipped ones.
+  size_t stages_done_ GUARDED_BY(stages_mutex_) = 0;
+  MonoTime last_stage_end_ GUARDED_BY(stages_mutex_);
+  std::array<MonoDelta, kRedisCallStageMapSize> stage_times_ GUARDED_BY(stages_mutex_);
 };
 
 } // namespace redisserver
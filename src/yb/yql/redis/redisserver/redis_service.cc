@@ -14,6 +14,7 @@
 #include "yb/yql/redis/redisserver/redis_service.h"
 
 #include <iostream>
+#include <map>
 #include <thread>
 
 #include <boost/algorithm/string/case_conv.hpp>
@@ -45,6 +46,8 @@
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
+#include "yb/yql/redis/redisserver/redis_pubsub_registry.h"
+#include "yb/yql/redis/redisserver/redis_read_cache.h"
 #include "yb/yql/redis/redisserver/redis_rpc.h"
 
 #include "yb/rpc/connection.h"
@@ -171,13 +174,15 @@ class Operation {
   Operation(const std::shared_ptr<RedisInboundCall>& call,
             size_t index,
             std::shared_ptr<Op> operation,
-            const rpc::RpcMethodMetrics& metrics)
+            const rpc::RpcMethodMetrics& metrics,
+            PartResponseCallback part_callback = PartResponseCallback())
     : type_(std::is_same<Op, YBRedisReadOp>::value ? OperationType::kRead : OperationType::kWrite),
       call_(call),
       index_(index),
       operation_(std::move(operation)),
       metrics_(metrics),
-      manual_response_(ManualResponse::kFalse) {
+      manual_response_(ManualResponse::kFalse),
+      part_callback_(std::move(part_callback)) {
     auto status = operation_->GetPartitionKey(&partition_key_);
     if (!status.ok()) {
       Respond(status);
@@ -297,8 +302,37 @@ class Operation {
     return true;
   }
 
+  // Invoked once the write is done successfully.
+  void SetWrittenCallback(std::function<void()> callback) {
+    written_callback_ = std::move(callback);
+  }
+
+  // Reads fill the cache with their responses, writes drop the cached reads of their key.
+  void SetReadCache(RedisReadCache* read_cache, const std::string* db_name, uint64_t key_version) {
+    read_cache_ = read_cache;
+    db_name_ = db_name;
+    key_version_ = key_version;
+  }
+
   void Respond(const Status& status) {
     responded_.store(true, std::memory_order_release);
+    if (read_cache_) {
+      if (type_ == OperationType::kWrite) {
+        read_cache_->Invalidate(*db_name_, operation_->GetKey());
+      } else if (status.ok()) {
+        read_cache_->Insert(
+            *db_name_, down_cast<YBRedisReadOp*>(operation_.get())->request(), key_version_,
+            response());
+      }
+    }
+    if (written_callback_ && status.ok() &&
+        response().code() == RedisResponsePB_RedisStatusCode_OK) {
+      written_callback_();
+    }
+    if (part_callback_) {
+      part_callback_(status, &response());
+      return;
+    }
     if (manual_response_) {
       return;
     }
@@ -331,8 +365,13 @@ class Operation {
   std::string partition_key_;
   rpc::RpcMethodMetrics metrics_;
   ManualResponse manual_response_;
+  PartResponseCallback part_callback_;
   client::internal::RemoteTabletPtr tablet_;
   std::atomic<bool> responded_{false};
+  std::function<void()> written_callback_;
+  RedisReadCache* read_cache_ = nullptr;
+  const std::string* db_name_ = nullptr;
+  uint64_t key_version_ = 0;
 };
 
 class SessionPool {
@@ -761,7 +800,7 @@ struct RedisServiceImplData : public RedisServiceData {
 
   void AppendToSubscribers(
       AsPattern type, const std::vector<std::string>& channels, rpc::Connection* conn,
-      std::vector<int>* subs) override;
+      std::function<void(const std::vector<int>& subs)> done) override;
   void RemoveFromSubscribers(
       AsPattern type, const std::vector<std::string>& channels, rpc::Connection* conn,
       std::vector<int>* subs) override;
@@ -769,14 +808,34 @@ struct RedisServiceImplData : public RedisServiceData {
   int NumSubscribers(AsPattern type, const std::string& channel) override;
   std::unordered_set<std::string> GetSubscriptions(AsPattern type, rpc::Connection* conn) override;
   std::unordered_set<std::string> GetAllSubscriptions(AsPattern type) override;
-  int Publish(const string& channel, const string& message);
+  void Publish(const tserver::PublishRequestPB& request, tserver::PublishResponsePB* response);
   void ForwardToInterestedProxies(
       const string& channel, const string& message, const IntFunctor& f) override;
   int PublishToLocalClients(IsMonitorMessage mode, const string& channel, const string& message);
-  Result<vector<HostPortPB>> GetServerAddrsForChannel(const string& channel);
+  bool HasLocalSubscribers(const string& channel);
+
+  struct PubSubPeer {
+    std::string uuid;
+    HostPortPB host_port;
+  };
+  Result<vector<PubSubPeer>> GetPubSubPeers();
+  void SendPublishRequest(
+      const HostPortPB& host_port, const tserver::PublishRequestPB& request,
+      std::function<void(const Status&, const tserver::PublishResponsePB&)> callback);
+  // Notifies the peers, keyed by uuid, of the channels they should not skip anymore, or all peers
+  // of all channels when notify_all is set.
+  void NotifySubscribed(
+      const std::unordered_map<std::string, std::vector<std::string>>& notifications,
+      bool notify_all, std::function<void()> done);
   int NumSubscriptionsUnlocked(Connection* conn);
 
+  uint64_t AddListWaiter(
+      const std::string& db_name, const std::string& key, std::function<void()> waiter) override;
+  void RemoveListWaiter(const std::string& db_name, const std::string& key, uint64_t id) override;
+  void NotifyListPush(const std::string& db_name, const Slice& key);
+
   CHECKED_STATUS GetRedisPasswords(vector<string>* passwords) override;
+  void InvalidateReadCache() override;
   CHECKED_STATUS Initialize();
   bool initialized() const { return initialized_.load(std::memory_order_relaxed); }
 
@@ -806,6 +865,12 @@ struct RedisServiceImplData : public RedisServiceData {
 
   std::unordered_set<Connection*> monitoring_clients_;
   scoped_refptr<AtomicGauge<uint64_t>> num_clients_monitoring_;
+  RedisPubSubRegistry pubsub_registry_;
+
+  std::mutex list_waiters_mutex_;
+  // Waiters of BLPop and BRPop, keyed by database and list, then by id.
+  std::unordered_map<std::string, std::map<uint64_t, std::function<void()>>> list_waiters_;
+  uint64_t next_list_waiter_id_ = 0;
 
   std::mutex redis_password_mutex_;
   MonoTime redis_cached_password_validity_expiry_;
@@ -813,6 +878,9 @@ struct RedisServiceImplData : public RedisServiceData {
 
   RedisServer* server_;
 
+  RedisReadCache read_cache_;
+
+  RedisCallStageMetrics call_stage_metrics_;
 };
 
 class BatchContextImpl : public BatchContext {
@@ -870,6 +938,7 @@ class BatchContextImpl : public BatchContext {
     if (operations_.empty()) {
       return;
     }
+    call_->RecordStage(RedisCallStage::kPrepare);
 
     auto table = impl_data_->GetYBTableForDB(db_name_);
     if (!table.ok()) {
@@ -893,14 +962,14 @@ class BatchContextImpl : public BatchContext {
       size_t index,
       std::shared_ptr<client::YBRedisReadOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
-    DoApply(index, std::move(operation), metrics);
+    ApplyRead(index, std::move(operation), metrics, PartResponseCallback());
   }
 
   void Apply(
       size_t index,
       std::shared_ptr<client::YBRedisWriteOp> operation,
       const rpc::RpcMethodMetrics& metrics) override {
-    DoApply(index, std::move(operation), metrics);
+    ApplyWrite(index, std::move(operation), metrics, PartResponseCallback());
   }
 
   void Apply(
@@ -912,19 +981,89 @@ class BatchContextImpl : public BatchContext {
     DoApply(index, std::move(functor), std::move(partition_key), metrics, manual_response);
   }
 
+  void ApplyPart(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      PartResponseCallback callback) override {
+    ApplyRead(index, std::move(operation), metrics, std::move(callback));
+  }
+
+  void ApplyPart(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      PartResponseCallback callback) override {
+    ApplyWrite(index, std::move(operation), metrics, std::move(callback));
+  }
+
   std::string ToString() const {
     return Format("{ tablets: $0 }", tablets_);
   }
 
  private:
+  void ApplyRead(
+      size_t index,
+      std::shared_ptr<client::YBRedisReadOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      PartResponseCallback callback) {
+    auto* read_cache = &impl_data_->read_cache_;
+    if (!RedisReadCache::IsCacheable(operation->request())) {
+      DoApply(index, std::move(operation), metrics, std::move(callback));
+      return;
+    }
+    if (read_cache->Find(db_name_, operation->request(), operation->mutable_response())) {
+      if (callback) {
+        callback(Status::OK(), operation->mutable_response());
+      } else {
+        call_->RespondSuccess(index, metrics, operation->mutable_response());
+      }
+      return;
+    }
+    auto key_version = read_cache->KeyVersion(db_name_, operation->GetKey());
+    if (DoApply(index, std::move(operation), metrics, std::move(callback))) {
+      operations_.back().SetReadCache(read_cache, &db_name_, key_version);
+    }
+  }
+
+  void ApplyWrite(
+      size_t index,
+      std::shared_ptr<client::YBRedisWriteOp> operation,
+      const rpc::RpcMethodMetrics& metrics,
+      PartResponseCallback callback) {
+    std::function<void()> written_callback;
+    if (operation->request().has_push_request()) {
+      written_callback = [impl_data = impl_data_, db_name = db_name_,
+                          key = operation->GetKey().ToBuffer()] {
+        impl_data->NotifyListPush(db_name, key);
+      };
+    }
+    RedisReadCache* read_cache = nullptr;
+    if (RedisReadCache::Enabled()) {
+      read_cache = &impl_data_->read_cache_;
+      read_cache->Invalidate(db_name_, operation->GetKey());
+    }
+    if (!DoApply(index, std::move(operation), metrics, std::move(callback))) {
+      return;
+    }
+    if (read_cache) {
+      operations_.back().SetReadCache(read_cache, &db_name_, 0);
+    }
+    if (written_callback) {
+      operations_.back().SetWrittenCallback(std::move(written_callback));
+    }
+  }
+
+  // Returns whether the operation was added to the batch, it is responded to otherwise.
   template <class... Args>
-  void DoApply(Args&&... args) {
+  bool DoApply(Args&&... args) {
     operations_.emplace_back(call_, std::forward<Args>(args)...);
     if (PREDICT_FALSE(operations_.back().responded())) {
       operations_.pop_back();
-    } else {
-      consumption_.Add(operations_.back().space_used_by_request());
+      return false;
     }
+    consumption_.Add(operations_.back().space_used_by_request());
+    return true;
   }
 
   void LookupDone(
@@ -949,6 +1088,7 @@ class BatchContextImpl : public BatchContext {
       Commit(retries + 1);
       return;
     }
+    call_->RecordStage(RedisCallStage::kTabletLookup);
 
     BatchContextPtr self(this);
     for (auto& operation : operations_) {
@@ -1043,7 +1183,63 @@ class RedisServiceImpl::Impl {
 RedisServiceImplData::RedisServiceImplData(RedisServer* server, string&& yb_tier_master_addresses)
     : yb_tier_master_addresses_(std::move(yb_tier_master_addresses)),
       initialized_(false),
-      server_(server) {}
+      server_(server),
+      read_cache_(server->mem_tracker(), server->metric_entity()),
+      call_stage_metrics_(server->metric_entity()) {}
+
+void RedisServiceImplData::InvalidateReadCache() {
+  read_cache_.InvalidateAll();
+}
+
+namespace {
+
+std::string ListWaitersKey(const std::string& db_name, const Slice& key) {
+  std::string result = std::to_string(db_name.size());
+  result += ':';
+  result += db_name;
+  result.append(key.cdata(), key.size());
+  return result;
+}
+
+} // namespace
+
+uint64_t RedisServiceImplData::AddListWaiter(
+    const std::string& db_name, const std::string& key, std::function<void()> waiter) {
+  std::lock_guard<std::mutex> lock(list_waiters_mutex_);
+  auto id = ++next_list_waiter_id_;
+  list_waiters_[ListWaitersKey(db_name, key)].emplace(id, std::move(waiter));
+  return id;
+}
+
+void RedisServiceImplData::RemoveListWaiter(
+    const std::string& db_name, const std::string& key, uint64_t id) {
+  std::lock_guard<std::mutex> lock(list_waiters_mutex_);
+  auto it = list_waiters_.find(ListWaitersKey(db_name, key));
+  if (it == list_waiters_.end()) {
+    return;
+  }
+  it->second.erase(id);
+  if (it->second.empty()) {
+    list_waiters_.erase(it);
+  }
+}
+
+void RedisServiceImplData::NotifyListPush(const std::string& db_name, const Slice& key) {
+  std::map<uint64_t, std::function<void()>> waiters;
+  {
+    std::lock_guard<std::mutex> lock(list_waiters_mutex_);
+    auto it = list_waiters_.find(ListWaitersKey(db_name, key));
+    if (it == list_waiters_.end()) {
+      return;
+    }
+    waiters.swap(it->second);
+    list_waiters_.erase(it);
+  }
+  // All waiters retry their pops, the ones that lose the race for the new elements wait again.
+  for (const auto& entry : waiters) {
+    entry.second();
+  }
+}
 
 yb::Result<std::shared_ptr<client::YBTable>> RedisServiceImplData::GetYBTableForDB(
     const string& db_name) {
@@ -1085,25 +1281,45 @@ int RedisServiceImplData::NumSubscriptionsUnlocked(Connection* conn) {
 
 void RedisServiceImplData::AppendToSubscribers(
     AsPattern type, const std::vector<std::string>& channels, rpc::Connection* conn,
-    std::vector<int>* subs) {
-  boost::lock_guard<decltype(pubsub_mutex_)> lock(pubsub_mutex_);
-  subs->clear();
+    std::function<void(const std::vector<int>& subs)> done) {
+  std::vector<int> subs;
+  {
+    boost::lock_guard<decltype(pubsub_mutex_)> lock(pubsub_mutex_);
+    for (const auto& channel : channels) {
+      VLOG(3) << "AppendToSubscribers (" << type << ", " << channel << ", " << conn->ToString();
+      if (type == AsPattern::kTrue) {
+        patterns_to_clients_[channel].insert(conn);
+        clients_to_subscriptions_[conn].patterns.insert(channel);
+      } else {
+        channels_to_clients_[channel].insert(conn);
+        clients_to_subscriptions_[conn].channels.insert(channel);
+      }
+      subs.push_back(NumSubscriptionsUnlocked(conn));
+    }
+    auto& context = static_cast<RedisConnectionContext&>(conn->context());
+    if (context.ClientMode() != RedisClientMode::kSubscribed) {
+      context.SetClientMode(RedisClientMode::kSubscribed);
+      context.SetCleanupHook(std::bind(&RedisServiceImplData::CleanUpSubscriptions, this, conn));
+    }
+  }
+
+  // The publishers to notify are taken after the subscriptions were added, while Publish promises
+  // to notify a publisher before it checks for subscribers, so no promise is missed.
+  std::unordered_map<std::string, std::vector<std::string>> notifications;
   for (const auto& channel : channels) {
-    VLOG(3) << "AppendToSubscribers (" << type << ", " << channel << ", " << conn->ToString();
     if (type == AsPattern::kTrue) {
-      patterns_to_clients_[channel].insert(conn);
-      clients_to_subscriptions_[conn].patterns.insert(channel);
+      for (auto& entry : pubsub_registry_.TakeWatchersMatching(channel)) {
+        auto& dest = notifications[entry.first];
+        dest.insert(dest.end(), entry.second.begin(), entry.second.end());
+      }
     } else {
-      channels_to_clients_[channel].insert(conn);
-      clients_to_subscriptions_[conn].channels.insert(channel);
+      for (const auto& publisher : pubsub_registry_.TakeWatchers(channel)) {
+        notifications[publisher].push_back(channel);
+      }
     }
-    subs->push_back(NumSubscriptionsUnlocked(conn));
-  }
-  auto& context = static_cast<RedisConnectionContext&>(conn->context());
-  if (context.ClientMode() != RedisClientMode::kSubscribed) {
-    context.SetClientMode(RedisClientMode::kSubscribed);
-    context.SetCleanupHook(std::bind(&RedisServiceImplData::CleanUpSubscriptions, this, conn));
   }
+  NotifySubscribed(notifications, pubsub_registry_.InStartupWindow(),
+                   [done = std::move(done), subs = std::move(subs)] { done(subs); });
 }
 
 void RedisServiceImplData::RemoveFromSubscribers(
@@ -1176,15 +1392,46 @@ void RedisServiceImplData::LogToMonitors(
   PublishToLocalClients(IsMonitorMessage::kTrue, "", ss.str());
 }
 
-int RedisServiceImplData::Publish(const string& channel, const string& message) {
+void RedisServiceImplData::Publish(
+    const tserver::PublishRequestPB& request, tserver::PublishResponsePB* response) {
+  if (request.subscribed()) {
+    VLOG(3) << "Proxy " << request.publisher_uuid() << " got subscribers of "
+            << request.subscribed_channels_size() << " channels";
+    pubsub_registry_.PeerSubscribed(
+        request.publisher_uuid(),
+        {request.subscribed_channels().begin(), request.subscribed_channels().end()});
+    response->set_num_clients_forwarded_to(0);
+    return;
+  }
+
+  const auto& channel = request.channel();
   VLOG(3) << "Forwarding to clients on channel " << channel;
-  return PublishToLocalClients(IsMonitorMessage::kFalse, channel, message);
+  const int num_clients =
+      PublishToLocalClients(IsMonitorMessage::kFalse, channel, request.message());
+  response->set_num_clients_forwarded_to(num_clients);
+  if (num_clients != 0 || request.publisher_uuid().empty() || !RedisPubSubRegistry::Enabled() ||
+      !pubsub_registry_.AddWatcher(channel, request.publisher_uuid())) {
+    return;
+  }
+  // A client could have subscribed before the promise was made, and taken the publishers to
+  // notify before it, so the promise only holds if there are still no subscribers.
+  response->set_notify_on_subscribe(!HasLocalSubscribers(channel));
+}
+
+bool RedisServiceImplData::HasLocalSubscribers(const string& channel) {
+  SharedLock<decltype(pubsub_mutex_)> rlock(pubsub_mutex_);
+  if (channels_to_clients_.count(channel)) {
+    return true;
+  }
+  for (const auto& entry : patterns_to_clients_) {
+    if (RedisUtil::RedisPatternMatch(entry.first, channel, /* ignore case */ false)) {
+      return true;
+    }
+  }
+  return false;
 }
 
-Result<vector<HostPortPB>> RedisServiceImplData::GetServerAddrsForChannel(
-    const string& channel_unused) {
-  // TODO(Amit): Instead of forwarding  blindly to all servers, figure out the
-  // ones that have a subscription and send it to them only.
+Result<vector<RedisServiceImplData::PubSubPeer>> RedisServiceImplData::GetPubSubPeers() {
   std::vector<master::TSInformationPB> live_tservers;
   Status s = CHECK_NOTNULL(server_->tserver())->GetLiveTServers(&live_tservers);
   if (!s.ok()) {
@@ -1192,7 +1439,7 @@ Result<vector<HostPortPB>> RedisServiceImplData::GetServerAddrsForChannel(
     return s;
   }
 
-  vector<HostPortPB> servers;
+  vector<PubSubPeer> servers;
   const auto cloud_info_pb = server_->MakeCloudInfoPB();
   // Queue NEW_NODE event for all the live tservers.
   for (const master::TSInformationPB& ts_info : live_tservers) {
@@ -1202,7 +1449,7 @@ Result<vector<HostPortPB>> RedisServiceImplData::GetServerAddrsForChannel(
                    << ts_info.DebugString();
       continue;
     }
-    servers.push_back(hostport_pb);
+    servers.push_back(PubSubPeer{ts_info.tserver_instance().permanent_uuid(), hostport_pb});
   }
   return servers;
 }
@@ -1228,36 +1475,110 @@ class PublishResponseHandler {
 
 void RedisServiceImplData::ForwardToInterestedProxies(
     const string& channel, const string& message, const IntFunctor& f) {
-  auto interested_servers = GetServerAddrsForChannel(channel);
-  if (!interested_servers.ok()) {
-    LOG(ERROR) << "Could not get servers to forward to " << interested_servers.status();
+  auto peers = GetPubSubPeers();
+  if (!peers.ok()) {
+    LOG(ERROR) << "Could not get servers to forward to " << peers.status();
+    return;
+  }
+  // Proxies that promised to notify this one of subscribers of the channel are skipped.
+  std::vector<std::pair<const PubSubPeer*, uint64_t>> targets;
+  for (const auto& peer : *peers) {
+    uint64_t epoch = 0;
+    if (!pubsub_registry_.ShouldSkip(peer.uuid, channel, &epoch)) {
+      targets.emplace_back(&peer, epoch);
+    }
+  }
+  if (targets.empty()) {
+    f(0);
     return;
   }
+
+  tserver::PublishRequestPB request;
+  request.set_channel(channel);
+  request.set_message(message);
+  if (RedisPubSubRegistry::Enabled()) {
+    request.set_publisher_uuid(server_->tserver()->permanent_uuid());
+  }
   std::shared_ptr<PublishResponseHandler> resp_handler =
-      std::make_shared<PublishResponseHandler>(interested_servers->size(), f);
-  for (auto& hostport_pb : *interested_servers) {
-    tserver::PublishRequestPB requestPB;
-    requestPB.set_channel(channel);
-    requestPB.set_message(message);
-    std::shared_ptr<tserver::TabletServerServiceProxy> proxy =
-        std::make_shared<tserver::TabletServerServiceProxy>(
-            &client_->proxy_cache(), HostPortFromPB(hostport_pb));
-    std::shared_ptr<tserver::PublishResponsePB> responsePB =
-        std::make_shared<tserver::PublishResponsePB>();
-    std::shared_ptr<yb::rpc::RpcController> rpcController = std::make_shared<rpc::RpcController>();
-    // Hold a copy of the shared ptr in the callback to ensure that the proxy, responsePB and
-    // rpcController are valid.
-    // these self-destruct on the latter of the two events
-    //  (i)  exit this loop, and
-    //  (ii) done with the callback.
-    proxy->PublishAsync(
-        requestPB, responsePB.get(), rpcController.get(),
-        [resp_handler, responsePB, rpcController, proxy]() mutable {
-          resp_handler->HandleResponse(responsePB.get());
-          responsePB.reset();
-          rpcController.reset();
-          proxy.reset();
-          resp_handler.reset();
+      std::make_shared<PublishResponseHandler>(targets.size(), f);
+  for (const auto& target : targets) {
+    SendPublishRequest(
+        target.first->host_port, request,
+        [this, resp_handler, channel, uuid = target.first->uuid, epoch = target.second](
+            const Status& status, const tserver::PublishResponsePB& response) {
+          if (status.ok() && response.num_clients_forwarded_to() == 0 &&
+              response.notify_on_subscribe()) {
+            pubsub_registry_.SkipPeer(uuid, channel, epoch);
+          }
+          resp_handler->HandleResponse(&response);
+        });
+  }
+}
+
+void RedisServiceImplData::SendPublishRequest(
+    const HostPortPB& host_port, const tserver::PublishRequestPB& request,
+    std::function<void(const Status&, const tserver::PublishResponsePB&)> callback) {
+  auto proxy = std::make_shared<tserver::TabletServerServiceProxy>(
+      &client_->proxy_cache(), HostPortFromPB(host_port));
+  auto response = std::make_shared<tserver::PublishResponsePB>();
+  auto controller = std::make_shared<rpc::RpcController>();
+  controller->set_timeout(MonoDelta::FromSeconds(kRpcTimeoutSec));
+  // Hold a copy of the shared ptrs in the callback to ensure that the proxy, response and
+  // controller are valid until the call is done.
+  proxy->PublishAsync(
+      request, response.get(), controller.get(),
+      [proxy, response, controller, callback = std::move(callback)]() {
+        callback(controller->status(), *response);
+      });
+}
+
+void RedisServiceImplData::NotifySubscribed(
+    const std::unordered_map<std::string, std::vector<std::string>>& notifications,
+    bool notify_all, std::function<void()> done) {
+  if (notifications.empty() && !notify_all) {
+    done();
+    return;
+  }
+  auto peers = GetPubSubPeers();
+  if (!peers.ok()) {
+    LOG(WARNING) << "Could not get servers to notify of subscribers " << peers.status();
+    done();
+    return;
+  }
+
+  std::vector<std::pair<const HostPortPB*, tserver::PublishRequestPB>> requests;
+  for (const auto& peer : *peers) {
+    auto it = notifications.find(peer.uuid);
+    if (!notify_all && it == notifications.end()) {
+      continue;
+    }
+    tserver::PublishRequestPB request;
+    request.set_channel("");
+    request.set_message("");
+    request.set_publisher_uuid(server_->tserver()->permanent_uuid());
+    request.set_subscribed(true);
+    // Without channels, the peer stops skipping this proxy for all channels.
+    if (!notify_all) {
+      for (const auto& channel : it->second) {
+        request.add_subscribed_channels(channel);
+      }
+    }
+    requests.emplace_back(&peer.host_port, std::move(request));
+  }
+  if (requests.empty()) {
+    done();
+    return;
+  }
+
+  auto pending = std::make_shared<std::atomic<size_t>>(requests.size());
+  for (const auto& request : requests) {
+    SendPublishRequest(
+        *request.first, request.second,
+        [pending, done](const Status& status, const tserver::PublishResponsePB& response) {
+          LOG_IF(WARNING, !status.ok()) << "Failed to notify of subscribers: " << status;
+          if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            done();
+          }
         });
   }
 }
@@ -1471,6 +1792,8 @@ bool AllowedInClientMode(const RedisCommandInfo* info, RedisClientMode mode) {
 
 void RedisServiceImpl::Impl::Handle(rpc::InboundCallPtr call_ptr) {
   auto call = std::static_pointer_cast<RedisInboundCall>(call_ptr);
+  call->SetStageMetrics(&data_.call_stage_metrics_);
+  call->RecordStage(RedisCallStage::kQueue);
 
   DVLOG(2) << "Asked to handle a call " << call->ToString();
   if (call->serialized_request().size() > FLAGS_redis_max_command_size) {
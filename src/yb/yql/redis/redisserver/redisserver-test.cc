@@ -1300,6 +1300,31 @@ TEST_F_EX(TestRedisService, MixedBatch, TestRedisServicePipelined) {
   }
 }
 
+class TestRedisServiceConcurrentBatches : public TestRedisService {
+ public:
+  void SetUp() override {
+    FLAGS_redis_max_concurrent_commands = 8;
+    FLAGS_redis_max_batch = 1;
+    TestRedisService::SetUp();
+  }
+};
+
+// Reads that are processed concurrently with each other still see the writes received before
+// them, and their replies are sent in order.
+TEST_F_EX(TestRedisService, ConcurrentReadBatches, TestRedisServiceConcurrentBatches) {
+  std::string command, response;
+  for (size_t i = 0; i != 20; ++i) {
+    const std::string value = std::to_string(ValueForKey(i));
+    command += yb::Format("set key $0\r\n", value);
+    response += "+OK\r\n";
+    for (size_t j = 0; j != 5; ++j) {
+      command += "get key\r\n";
+      response += yb::Format("$$$0\r\n$1\r\n", value.length(), value);
+    }
+  }
+  SendCommandAndExpectResponse(__LINE__, command, response);
+}
+
 class TestRedisServiceSafeBatch : public TestRedisService {
  public:
   void SetUp() override {
@@ -3983,6 +4008,49 @@ TEST_F(TestRedisService, TestTsRangeByTime) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestTsRangeByTimeAggregation) {
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_agg",
+      "-50", "1",
+      "-40", "2",
+      "-30", "3",
+      "-20", "4",
+      "-10", "5",
+      "10", "6",
+      "20", "7",
+      "30", "8",
+      "40", "9",
+      "50", "10",
+  });
+  DoRedisTestOk(__LINE__, {"TSADD", "ts_agg_str", "10", "v1"});
+
+  SyncClient();
+  // Buckets start at multiples of the bucket size, also for negative timestamps.
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-55", "55", "AGGREGATION", "SUM", "20"},
+      {"-60", "1", "-40", "5", "-20", "9", "0", "6", "20", "15", "40", "19"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-35", "35", "AGGREGATION", "AVG", "20"},
+      {"-40", "3", "-20", "4.5", "0", "6", "20", "7.5"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-55", "55", "AGGREGATION", "MIN", "50"},
+      {"-50", "1", "0", "6", "50", "10"});
+  DoRedisTestArray(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-55", "55", "AGGREGATION", "MAX", "50"},
+      {"-50", "5", "0", "9", "50", "10"});
+  DoRedisTestArray(__LINE__,
+      {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "COUNT", "1000"},
+      {"-1000", "5", "0", "5"});
+  DoRedisTestArray(__LINE__,
+      {"TSRANGEBYTIME", "ts_agg_str", "-inf", "+inf", "AGGREGATION", "COUNT", "100"},
+      {"0", "1"});
+
+  DoRedisTestExpectError(__LINE__,
+      {"TSRANGEBYTIME", "ts_agg_str", "-inf", "+inf", "AGGREGATION", "SUM", "100"});
+  DoRedisTestExpectError(__LINE__,
+      {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "MEDIAN", "100"});
+  DoRedisTestExpectError(__LINE__,
+      {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION", "SUM", "0"});
+  DoRedisTestExpectError(__LINE__, {"TSRANGEBYTIME", "ts_agg", "-inf", "+inf", "AGGREGATION"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestTsRevRangeByTime) {
   DoRedisTestOk(__LINE__, {"TSADD", "ts_key",
       "-50", "v1",
@@ -4561,6 +4629,49 @@ TEST_F(TestRedisService, TestDel) {
   VerifyCallbacks();
 }
 
+TEST_F(TestRedisService, TestMultiKeyCommands) {
+  // The default value is true, but we explicitly set this here for clarity.
+  FLAGS_emulate_redis_responses = true;
+
+  // Enough keys to be spread over all the tablets of the table.
+  constexpr int kNumKeys = 20;
+  std::vector<std::string> mset = {"MSET"};
+  std::vector<std::string> mget = {"MGET"};
+  std::vector<std::string> del = {"DEL"};
+  std::vector<std::string> values;
+  for (int i = 0; i != kNumKeys; ++i) {
+    mset.push_back(Format("key$0", i));
+    mset.push_back(Format("value$0", i));
+    mget.push_back(Format("key$0", i));
+    values.push_back(Format("value$0", i));
+    if (i % 2 == 0) {
+      del.push_back(Format("key$0", i));
+    }
+  }
+  DoRedisTestOk(__LINE__, mset);
+  SyncClient();
+
+  // Replies are in the order of the keys, missing keys and keys of other types are nil.
+  DoRedisTestInt(__LINE__, {"HSET", "map_key", "subkey", "value"}, 1);
+  SyncClient();
+  mget.push_back("non_existent");
+  mget.push_back("map_key");
+  values.push_back("");
+  values.push_back("");
+  DoRedisTestArray(__LINE__, mget, values);
+  SyncClient();
+
+  DoRedisTestInt(__LINE__, del, kNumKeys / 2);
+  SyncClient();
+  DoRedisTestInt(__LINE__, del, 0);
+  DoRedisTestArray(__LINE__, {"MGET", "key0", "key1"}, {"", "value1"});
+  SyncClient();
+
+  DoRedisTestExpectError(__LINE__, {"MSET", "key0", "value0", "key1"});
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestHDel) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;
@@ -5156,6 +5267,69 @@ TEST_F(TestRedisService, TestListBasic) {
   DoRedisTestNull(__LINE__, {"RPOP", "sierra"});
 }
 
+// Pops start past the elements popped before, from either side, and after pushes to both sides.
+TEST_F(TestRedisService, TestListQueue) {
+  constexpr int kNumElements = 100;
+  for (int i = 0; i != kNumElements; ++i) {
+    DoRedisTestInt(__LINE__, {"RPUSH", "queue", std::to_string(i)}, i + 1);
+  }
+  SyncClient();
+  for (int i = 0; i != kNumElements / 2; ++i) {
+    DoRedisTestBulkString(__LINE__, {"LPOP", "queue"}, std::to_string(i));
+  }
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"LPUSH", "queue", "head"}, kNumElements / 2 + 1);
+  DoRedisTestInt(__LINE__, {"RPUSH", "queue", "tail"}, kNumElements / 2 + 2);
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"LPOP", "queue"}, "head");
+  DoRedisTestBulkString(__LINE__, {"RPOP", "queue"}, "tail");
+  DoRedisTestBulkString(__LINE__, {"RPOP", "queue"}, std::to_string(kNumElements - 1));
+  DoRedisTestBulkString(__LINE__, {"LPOP", "queue"}, std::to_string(kNumElements / 2));
+  SyncClient();
+  for (int i = kNumElements / 2 + 1; i != kNumElements - 1; ++i) {
+    DoRedisTestBulkString(__LINE__, {"LPOP", "queue"}, std::to_string(i));
+  }
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"LLEN", "queue"}, 0);
+  DoRedisTestNull(__LINE__, {"RPOP", "queue"});
+  SyncClient();
+  DoRedisTestInt(__LINE__, {"LPUSH", "queue", "again"}, 1);
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"RPOP", "queue"}, "again");
+  SyncClient();
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestBlockingPop) {
+  DoRedisTestInt(__LINE__, {"RPUSH", "second", "a", "b"}, 2);
+  DoRedisTestOk(__LINE__, {"SET", "string", "value"});
+  SyncClient();
+  DoRedisTestArray(__LINE__, {"BLPOP", "first", "second", "1"}, {"second", "a"});
+  DoRedisTestArray(__LINE__, {"BRPOP", "first", "second", "1"}, {"second", "b"});
+  SyncClient();
+  DoRedisTestNull(__LINE__, {"BLPOP", "first", "second", "0.2"});
+  DoRedisTestExpectError(__LINE__, {"BLPOP", "string", "1"});
+  DoRedisTestExpectError(__LINE__, {"BLPOP", "first", "-1"});
+  DoRedisTestExpectError(__LINE__, {"BLPOP", "first", "soon"});
+  SyncClient();
+
+  // A push through another connection wakes up the waiting pop.
+  auto waiting = std::make_shared<RedisClient>("127.0.0.1", server_port());
+  auto pushing = std::make_shared<RedisClient>("127.0.0.1", server_port());
+  UseClient(waiting);
+  DoRedisTestArray(__LINE__, {"BRPOP", "first", "0"}, {"first", "c"});
+  UseClient(pushing);
+  DoRedisTestInt(__LINE__, {"LPUSH", "first", "c"}, 1);
+  SyncClient();
+  UseClient(waiting);
+  SyncClient();
+  UseClient(pushing);
+  DoRedisTestInt(__LINE__, {"LLEN", "first"}, 0);
+  SyncClient();
+  UseClient(nullptr);
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, Keys) {
   // The default value is true, but we explicitly set this here for clarity.
   FLAGS_emulate_redis_responses = true;